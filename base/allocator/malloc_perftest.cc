@@ -0,0 +1,163 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the throughput of malloc and free, and the memory the process
+// keeps, for allocation patterns like those of the browser process (many
+// threads with short-lived objects of mixed sizes) and of the renderer (one
+// thread building up and tearing down a large tree of small objects).
+//
+// Run with TCMALLOC_HUGEPAGES=1 to compare with the heap backed by
+// transparent huge pages.
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/allocator/allocator_extension.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+namespace {
+
+// Deterministic, so that runs can be compared, and lock free, unlike rand().
+class Random {
+ public:
+  explicit Random(uint32 seed) : state_(seed) {}
+
+  uint32 Next() {
+    state_ = state_ * 1103515245 + 12345;
+    return state_ >> 8;
+  }
+
+ private:
+  uint32 state_;
+};
+
+// Mostly small objects, with a few buffers.
+size_t GetBrowserAllocationSize(Random* random) {
+  uint32 value = random->Next();
+  if (value % 64 == 0)
+    return 16 * 1024 + value % (64 * 1024);
+  return 16 + value % 1024;
+}
+
+size_t GetWorkingSetSize() {
+#if !defined(OS_MACOSX) || defined(OS_IOS)
+  scoped_ptr<ProcessMetrics> metrics(
+      ProcessMetrics::CreateProcessMetrics(GetCurrentProcessHandle()));
+#else
+  scoped_ptr<ProcessMetrics> metrics(
+      ProcessMetrics::CreateProcessMetrics(GetCurrentProcessHandle(), NULL));
+#endif
+  return metrics->GetWorkingSetSize();
+}
+
+void PrintRSS(const std::string& trace) {
+  perf_test::PrintResult("rss", "", trace,
+                         GetWorkingSetSize() / 1024, "KB", true);
+}
+
+// Keeps a window of live objects, replacing a random one at each step.
+class BrowserThread : public DelegateSimpleThread::Delegate {
+ public:
+  static const int kLiveObjects = 4096;
+  static const int kIterations = 1000000;
+
+  explicit BrowserThread(uint32 seed) : random_(seed) {}
+
+  virtual void Run() OVERRIDE {
+    std::vector<void*> live(kLiveObjects, static_cast<void*>(NULL));
+    for (int i = 0; i < kIterations; ++i) {
+      void*& slot = live[random_.Next() % kLiveObjects];
+      free(slot);
+      slot = malloc(GetBrowserAllocationSize(&random_));
+      // Touch the memory, as callers do.
+      static_cast<char*>(slot)[0] = 1;
+    }
+    for (size_t i = 0; i < live.size(); ++i)
+      free(live[i]);
+  }
+
+ private:
+  Random random_;
+
+  DISALLOW_COPY_AND_ASSIGN(BrowserThread);
+};
+
+}  // namespace
+
+TEST(MallocPerfTest, BrowserProfile) {
+  const int kThreadCount = 16;
+  ScopedVector<BrowserThread> delegates;
+  DelegateSimpleThreadPool pool("MallocPerfTest", kThreadCount);
+  for (int i = 0; i < kThreadCount; ++i) {
+    delegates.push_back(new BrowserThread(i + 1));
+    pool.AddWork(delegates.back());
+  }
+
+  TimeTicks start = TimeTicks::Now();
+  pool.Start();
+  pool.JoinAll();
+  TimeDelta elapsed = TimeTicks::Now() - start;
+
+  perf_test::PrintResult(
+      "throughput", "", "browser",
+      kThreadCount * BrowserThread::kIterations / elapsed.InSecondsF(),
+      "ops/s", true);
+  PrintRSS("browser_after_threads_exit");
+  allocator::ReleaseFreeMemory();
+  PrintRSS("browser_after_release");
+}
+
+// Builds a large tree of small objects, frees most of it in no particular
+// order, and measures how much of the memory the heap can give back.
+TEST(MallocPerfTest, RendererProfile) {
+  const int kNodeCount = 2000000;
+  Random random(42);
+  size_t rss_before = GetWorkingSetSize();
+
+  std::vector<void*> nodes(kNodeCount, static_cast<void*>(NULL));
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNodeCount; ++i) {
+    nodes[i] = malloc(24 + random.Next() % 232);
+    static_cast<char*>(nodes[i])[0] = 1;
+  }
+  TimeDelta build_time = TimeTicks::Now() - start;
+  PrintRSS("renderer_built");
+
+  // Free three quarters of the nodes, keeping a scattered quarter alive.
+  start = TimeTicks::Now();
+  for (int i = 0; i < kNodeCount; ++i) {
+    if (random.Next() % 4) {
+      free(nodes[i]);
+      nodes[i] = NULL;
+    }
+  }
+  TimeDelta teardown_time = TimeTicks::Now() - start;
+  allocator::ReleaseFreeMemory();
+  size_t rss_after = GetWorkingSetSize();
+  perf_test::PrintResult("rss_growth", "", "renderer_after_teardown",
+                         (rss_after - std::min(rss_before, rss_after)) / 1024,
+                         "KB", true);
+
+  perf_test::PrintResult("throughput", "", "renderer_build",
+                         kNodeCount / build_time.InSecondsF(), "ops/s", true);
+  perf_test::PrintResult("throughput", "", "renderer_teardown",
+                         kNodeCount * 0.75 / teardown_time.InSecondsF(),
+                         "ops/s", true);
+
+  for (int i = 0; i < kNodeCount; ++i)
+    free(nodes[i]);
+}
+
+}  // namespace base
@@ -0,0 +1,275 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator.h"
+
+#include <stdlib.h>
+
+#include "base/debug/trace_event.h"
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/memory/aligned_memory.h"
+#include "base/strings/stringprintf.h"
+
+namespace base {
+namespace allocator {
+
+namespace {
+
+// Slabs are aligned to their size, so that the slab of an object is found by
+// masking its address.
+const size_t kSlabSize = 64 * 1024;
+
+struct FreeSlot {
+  FreeSlot* next;
+};
+
+struct PartitionList {
+  PartitionList() : first(NULL) {}
+
+  Lock lock;
+  Partition* first;
+};
+
+LazyInstance<PartitionList>::Leaky g_partitions = LAZY_INSTANCE_INITIALIZER;
+
+// Returns whether an object of |size| bytes is allocated with malloc(). All
+// are with the sanitizers, which only see the allocations made by malloc().
+bool UsesMalloc(size_t size) {
+#if defined(ADDRESS_SANITIZER) || defined(MEMORY_SANITIZER) || \
+    defined(THREAD_SANITIZER)
+  return true;
+#else
+  return size > Partition::kMaxSlotSize;
+#endif
+}
+
+}  // namespace
+
+// The header of a slab, which is followed by its slots.
+struct Partition::Slab {
+  Slab* previous;
+  Slab* next;
+  // The free slots which were allocated before.
+  FreeSlot* free_slots;
+  size_t used_slots;
+  // The offset of the first slot which was never allocated.
+  size_t unprovisioned_offset;
+};
+
+Partition::Stats::Stats()
+    : committed_bytes(0),
+      active_bytes(0),
+      large_bytes(0),
+      object_count(0) {
+}
+
+Partition::Partition(const char* name)
+    : name_(name),
+      next_partition_(NULL) {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i].available_slabs = NULL;
+    buckets_[i].empty_slab = NULL;
+  }
+
+  PartitionList* partitions = g_partitions.Pointer();
+  AutoLock lock(partitions->lock);
+  next_partition_ = partitions->first;
+  partitions->first = this;
+}
+
+Partition::~Partition() {
+  {
+    PartitionList* partitions = g_partitions.Pointer();
+    AutoLock lock(partitions->lock);
+    Partition** link = &partitions->first;
+    while (*link != this)
+      link = &(*link)->next_partition_;
+    *link = next_partition_;
+  }
+
+  // The full slabs aren't tracked, so they would leak.
+  DCHECK_EQ(0u, stats_.object_count) << name_;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    Bucket* bucket = &buckets_[i];
+    while (bucket->available_slabs) {
+      Slab* slab = bucket->available_slabs;
+      UnlinkSlab(bucket, slab);
+      AlignedFree(slab);
+    }
+    if (bucket->empty_slab)
+      AlignedFree(bucket->empty_slab);
+  }
+}
+
+void* Partition::Alloc(size_t size) {
+  if (UsesMalloc(size)) {
+    void* result = malloc(size);
+    if (result) {
+      AutoLock lock(lock_);
+      stats_.large_bytes += size;
+      ++stats_.object_count;
+    }
+    return result;
+  }
+
+  size_t bucket_index = size ? (size - 1) / kSlotGranularity : 0;
+  size_t slot_size = GetSlotSize(bucket_index);
+  bool added_slab = false;
+  Stats stats;
+  void* result = NULL;
+  {
+    AutoLock lock(lock_);
+    Bucket* bucket = &buckets_[bucket_index];
+    if (!bucket->available_slabs) {
+      Slab* slab = bucket->empty_slab;
+      if (slab) {
+        bucket->empty_slab = NULL;
+      } else {
+        slab = static_cast<Slab*>(AlignedAlloc(kSlabSize, kSlabSize));
+        slab->free_slots = NULL;
+        slab->used_slots = 0;
+        slab->unprovisioned_offset = GetFirstSlotOffset();
+        stats_.committed_bytes += kSlabSize;
+        added_slab = true;
+      }
+      LinkSlab(bucket, slab);
+    }
+
+    Slab* slab = bucket->available_slabs;
+    if (slab->free_slots) {
+      result = slab->free_slots;
+      slab->free_slots = slab->free_slots->next;
+    } else {
+      result = reinterpret_cast<char*>(slab) + slab->unprovisioned_offset;
+      slab->unprovisioned_offset += slot_size;
+    }
+    ++slab->used_slots;
+    if (IsFull(slab, slot_size))
+      UnlinkSlab(bucket, slab);
+
+    stats_.active_bytes += slot_size;
+    ++stats_.object_count;
+    stats = stats_;
+  }
+
+  if (added_slab)
+    TraceStats(stats);
+  return result;
+}
+
+void Partition::Free(void* ptr, size_t size) {
+  if (!ptr)
+    return;
+
+  if (UsesMalloc(size)) {
+    free(ptr);
+    AutoLock lock(lock_);
+    stats_.large_bytes -= size;
+    --stats_.object_count;
+    return;
+  }
+
+  size_t bucket_index = size ? (size - 1) / kSlotGranularity : 0;
+  size_t slot_size = GetSlotSize(bucket_index);
+  Slab* slab = reinterpret_cast<Slab*>(
+      reinterpret_cast<uintptr_t>(ptr) & ~(kSlabSize - 1));
+  Slab* freed_slab = NULL;
+  Stats stats;
+  {
+    AutoLock lock(lock_);
+    Bucket* bucket = &buckets_[bucket_index];
+    if (IsFull(slab, slot_size))
+      LinkSlab(bucket, slab);
+
+    FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+    slot->next = slab->free_slots;
+    slab->free_slots = slot;
+    DCHECK_GT(slab->used_slots, 0u);
+    --slab->used_slots;
+
+    if (!slab->used_slots) {
+      UnlinkSlab(bucket, slab);
+      if (bucket->empty_slab) {
+        freed_slab = slab;
+        stats_.committed_bytes -= kSlabSize;
+      } else {
+        bucket->empty_slab = slab;
+      }
+    }
+
+    stats_.active_bytes -= slot_size;
+    --stats_.object_count;
+    stats = stats_;
+  }
+
+  if (freed_slab) {
+    AlignedFree(freed_slab);
+    TraceStats(stats);
+  }
+}
+
+Partition::Stats Partition::GetStats() const {
+  AutoLock lock(lock_);
+  return stats_;
+}
+
+// static
+void Partition::DumpAllStats(std::string* output) {
+  PartitionList* partitions = g_partitions.Pointer();
+  AutoLock lock(partitions->lock);
+  for (Partition* partition = partitions->first; partition;
+       partition = partition->next_partition_) {
+    Stats stats = partition->GetStats();
+    StringAppendF(output,
+                  "Partition %-16s %10" PRIuS " objects %10" PRIuS " KB "
+                  "committed %10" PRIuS " KB active %10" PRIuS " KB large\n",
+                  partition->name_, stats.object_count,
+                  stats.committed_bytes / 1024, stats.active_bytes / 1024,
+                  stats.large_bytes / 1024);
+  }
+}
+
+// static
+size_t Partition::GetSlotSize(size_t bucket_index) {
+  return (bucket_index + 1) * kSlotGranularity;
+}
+
+// static
+size_t Partition::GetFirstSlotOffset() {
+  return (sizeof(Slab) + kSlotGranularity - 1) & ~(kSlotGranularity - 1);
+}
+
+// static
+bool Partition::IsFull(const Slab* slab, size_t slot_size) {
+  return slab->used_slots == (kSlabSize - GetFirstSlotOffset()) / slot_size;
+}
+
+void Partition::LinkSlab(Bucket* bucket, Slab* slab) {
+  slab->previous = NULL;
+  slab->next = bucket->available_slabs;
+  if (slab->next)
+    slab->next->previous = slab;
+  bucket->available_slabs = slab;
+}
+
+void Partition::UnlinkSlab(Bucket* bucket, Slab* slab) {
+  if (slab->previous)
+    slab->previous->next = slab->next;
+  else
+    bucket->available_slabs = slab->next;
+  if (slab->next)
+    slab->next->previous = slab->previous;
+  slab->previous = NULL;
+  slab->next = NULL;
+}
+
+void Partition::TraceStats(const Stats& stats) const {
+  TRACE_COUNTER_ID2(TRACE_DISABLED_BY_DEFAULT("memory"), name_, this,
+                    "committed", static_cast<int>(stats.committed_bytes),
+                    "active", static_cast<int>(stats.active_bytes));
+}
+
+}  // namespace allocator
+}  // namespace base
@@ -0,0 +1,161 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ALLOCATOR_PARTITION_ALLOCATOR_H_
+#define BASE_ALLOCATOR_PARTITION_ALLOCATOR_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/debug/leak_annotations.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+namespace allocator {
+
+// A Partition keeps the objects of the types which opt into it in slabs of
+// its own, apart from the rest of the heap. Objects of a few hot types which
+// come and go together then don't leave holes in the size classes of malloc
+// which long lived objects of other types pin, and the memory they use can be
+// told apart in about:tcmalloc and in traces.
+//
+// A type opts into a partition by deriving from PartitionAllocated with a tag
+// naming the partition:
+//
+//   // foo.h
+//   struct FooPartition {
+//     static const char kName[];
+//     static base::allocator::Partition* Get();
+//   };
+//
+//   class Foo : public base::allocator::PartitionAllocated<FooPartition> {
+//     ...
+//   };
+//
+//   // foo.cc
+//   const char FooPartition::kName[] = "foo";
+//
+//   base::LazyInstance<base::allocator::Partition,
+//                      base::allocator::PartitionTraits<FooPartition> >
+//       g_foo_partition = LAZY_INSTANCE_INITIALIZER;
+//
+//   base::allocator::Partition* FooPartition::Get() {
+//     return g_foo_partition.Pointer();
+//   }
+//
+// Get() is defined out of line so that there is one partition per process in
+// component builds too.
+//
+// A partition is thread safe, and must outlive the objects allocated in it.
+class BASE_EXPORT Partition {
+ public:
+  // Objects larger than this are allocated with malloc(), as are all objects
+  // in builds with sanitizers.
+  static const size_t kMaxSlotSize = 1024;
+
+  struct BASE_EXPORT Stats {
+    Stats();
+
+    // The size of the slabs, including their free slots.
+    size_t committed_bytes;
+    // The size of the slots of the objects in the slabs.
+    size_t active_bytes;
+    // The size of the objects allocated with malloc().
+    size_t large_bytes;
+    // The number of objects, including the large ones.
+    size_t object_count;
+  };
+
+  explicit Partition(const char* name);
+  ~Partition();
+
+  // Returns memory for an object of |size| bytes, aligned for any type.
+  void* Alloc(size_t size);
+
+  // Frees the object at |ptr|, which was allocated with the same |size|.
+  void Free(void* ptr, size_t size);
+
+  Stats GetStats() const;
+
+  const char* name() const { return name_; }
+
+  // Appends a line of stats for each partition of the process to |output|.
+  static void DumpAllStats(std::string* output);
+
+ private:
+  struct Slab;
+
+  struct Bucket {
+    // The slabs with free slots, which objects are allocated from.
+    Slab* available_slabs;
+    // One slab without objects is kept so that a single object coming and
+    // going doesn't allocate and free a slab each time.
+    Slab* empty_slab;
+  };
+
+  // The slot sizes are the multiples of this up to kMaxSlotSize.
+  static const size_t kSlotGranularity = 16;
+  static const size_t kBucketCount = kMaxSlotSize / kSlotGranularity;
+
+  static size_t GetSlotSize(size_t bucket_index);
+  static size_t GetFirstSlotOffset();
+  static bool IsFull(const Slab* slab, size_t slot_size);
+
+  void LinkSlab(Bucket* bucket, Slab* slab);
+  void UnlinkSlab(Bucket* bucket, Slab* slab);
+
+  // Records the committed size in traces.
+  void TraceStats(const Stats& stats) const;
+
+  const char* const name_;
+
+  mutable Lock lock_;
+  Bucket buckets_[kBucketCount];
+  Stats stats_;
+
+  // The next partition of the process, for DumpAllStats().
+  Partition* next_partition_;
+
+  DISALLOW_COPY_AND_ASSIGN(Partition);
+};
+
+// LazyInstance traits which create the partition of |Tag| and leak it, as
+// the objects in it may be freed at any time until the process exits.
+template <typename Tag>
+struct PartitionTraits
+    : public base::internal::LeakyLazyInstanceTraits<Partition> {
+  static Partition* New(void* instance) {
+    ANNOTATE_SCOPED_MEMORY_LEAK;
+    return new (instance) Partition(Tag::kName);
+  }
+};
+
+// Allocates the objects of the deriving class, and of its subclasses, in the
+// partition returned by |Tag::Get()|. The class must have a virtual
+// destructor if objects of its subclasses are deleted through it, for the
+// size passed to operator delete to be that of the object.
+template <typename Tag>
+class PartitionAllocated {
+ public:
+  static void* operator new(size_t size) {
+    return Tag::Get()->Alloc(size);
+  }
+
+  static void operator delete(void* ptr, size_t size) {
+    Tag::Get()->Free(ptr, size);
+  }
+
+ protected:
+  PartitionAllocated() {}
+  ~PartitionAllocated() {}
+};
+
+}  // namespace allocator
+}  // namespace base
+
+#endif  // BASE_ALLOCATOR_PARTITION_ALLOCATOR_H_
@@ -0,0 +1,120 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/allocator/partition_allocator.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace allocator {
+
+namespace {
+
+struct TestPartition {
+  static const char kName[];
+  static Partition* Get();
+};
+
+const char TestPartition::kName[] = "test";
+
+LazyInstance<Partition, PartitionTraits<TestPartition> > g_test_partition =
+    LAZY_INSTANCE_INITIALIZER;
+
+Partition* TestPartition::Get() {
+  return g_test_partition.Pointer();
+}
+
+class Small : public PartitionAllocated<TestPartition> {
+ public:
+  Small() { memset(data_, 0, sizeof(data_)); }
+  virtual ~Small() {}
+
+ private:
+  char data_[40];
+};
+
+class Big : public Small {
+ public:
+  Big() { memset(data_, 0, sizeof(data_)); }
+  virtual ~Big() {}
+
+ private:
+  char data_[2000];
+};
+
+}  // namespace
+
+TEST(PartitionAllocatorTest, AllocAndFree) {
+  Partition partition("AllocAndFree");
+  std::vector<void*> objects;
+  for (size_t size = 0; size <= Partition::kMaxSlotSize + 16; ++size) {
+    void* object = partition.Alloc(size);
+    ASSERT_TRUE(object);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(object) % 16) << size;
+    memset(object, 0xab, size);
+    objects.push_back(object);
+  }
+  EXPECT_EQ(objects.size(), partition.GetStats().object_count);
+
+  for (size_t size = 0; size < objects.size(); ++size)
+    partition.Free(objects[size], size);
+  Partition::Stats stats = partition.GetStats();
+  EXPECT_EQ(0u, stats.object_count);
+  EXPECT_EQ(0u, stats.active_bytes);
+  EXPECT_EQ(0u, stats.large_bytes);
+}
+
+TEST(PartitionAllocatorTest, ReusesAndReleasesSlabs) {
+  Partition partition("ReusesAndReleasesSlabs");
+  // Enough objects for several slabs.
+  const size_t kObjectCount = 10000;
+  std::vector<void*> objects;
+  for (size_t i = 0; i < kObjectCount; ++i)
+    objects.push_back(partition.Alloc(32));
+  size_t committed_bytes = partition.GetStats().committed_bytes;
+#if !defined(ADDRESS_SANITIZER) && !defined(MEMORY_SANITIZER) && \
+    !defined(THREAD_SANITIZER)
+  EXPECT_EQ(32 * kObjectCount, partition.GetStats().active_bytes);
+  EXPECT_LT(32 * kObjectCount, committed_bytes);
+#endif
+
+  // The slots freed are allocated again before new slabs are added.
+  for (size_t i = 0; i < kObjectCount; i += 2)
+    partition.Free(objects[i], 32);
+  for (size_t i = 0; i < kObjectCount; i += 2)
+    objects[i] = partition.Alloc(32);
+  EXPECT_EQ(committed_bytes, partition.GetStats().committed_bytes);
+
+  // Only one empty slab is kept.
+  for (size_t i = 0; i < kObjectCount; ++i)
+    partition.Free(objects[i], 32);
+  EXPECT_GE(64u * 1024, partition.GetStats().committed_bytes);
+}
+
+TEST(PartitionAllocatorTest, PartitionAllocated) {
+  Partition* partition = TestPartition::Get();
+  size_t object_count = partition->GetStats().object_count;
+  scoped_ptr<Small> small(new Small);
+  scoped_ptr<Small> big(new Big);
+  EXPECT_EQ(object_count + 2, partition->GetStats().object_count);
+  big.reset();
+  small.reset();
+  EXPECT_EQ(object_count, partition->GetStats().object_count);
+}
+
+TEST(PartitionAllocatorTest, DumpAllStats) {
+  scoped_ptr<Value> value(new DictionaryValue);
+  std::string stats;
+  Partition::DumpAllStats(&stats);
+  EXPECT_NE(std::string::npos, stats.find(ValuePartition::kName));
+}
+
+}  // namespace allocator
+}  // namespace base
@@ -439,6 +439,7 @@
       'type': '<(gtest_target_type)',
       'sources': [
         # Tests.
+        'allocator/partition_allocator_unittest.cc',
         'android/activity_status_unittest.cc',
         'android/jni_android_unittest.cc',
         'android/jni_array_unittest.cc',
@@ -462,6 +463,8 @@
         'callback_unittest.nc',
         'cancelable_callback_unittest.cc',
         'command_line_unittest.cc',
+        'containers/flat_map_unittest.cc',
+        'containers/flat_set_unittest.cc',
         'containers/hash_tables_unittest.cc',
         'containers/linked_list_unittest.cc',
         'containers/mru_cache_unittest.cc',
@@ -471,7 +474,9 @@
         'debug/crash_logging_unittest.cc',
         'debug/leak_tracker_unittest.cc',
         'debug/proc_maps_linux_unittest.cc',
+        'debug/sampling_profiler_unittest.cc',
         'debug/stack_trace_unittest.cc',
+        'debug/trace_event_binary_unittest.cc',
         'debug/trace_event_memory_unittest.cc',
         'debug/trace_event_synthetic_delay_unittest.cc',
         'debug/trace_event_system_stats_monitor_unittest.cc',
@@ -482,11 +487,13 @@
         'environment_unittest.cc',
         'file_util_unittest.cc',
         'file_version_info_unittest.cc',
+        'files/async_file_io_unittest.cc',
         'files/dir_reader_posix_unittest.cc',
         'files/file_path_unittest.cc',
         'files/file_unittest.cc',
         'files/file_util_proxy_unittest.cc',
         'files/important_file_writer_unittest.cc',
+        'files/memory_mapped_file_unittest.cc',
         'files/scoped_temp_dir_unittest.cc',
         'gmock_unittest.cc',
         'guid_unittest.cc',
@@ -522,6 +529,7 @@
         'md5_unittest.cc',
         'memory/aligned_memory_unittest.cc',
         'memory/discardable_memory_allocator_android_unittest.cc',
+        'memory/discardable_memory_allocator_linux_unittest.cc',
         'memory/discardable_memory_unittest.cc',
         'memory/discardable_memory_provider_unittest.cc',
         'memory/linked_ptr_unittest.cc',
@@ -532,6 +540,7 @@
         'memory/scoped_vector_unittest.cc',
         'memory/shared_memory_unittest.cc',
         'memory/singleton_unittest.cc',
+        'memory/thread_local_arena_unittest.cc',
         'memory/weak_ptr_unittest.cc',
         'memory/weak_ptr_unittest.nc',
         'message_loop/message_loop_proxy_impl_unittest.cc',
@@ -540,8 +549,10 @@
         'message_loop/message_pump_glib_unittest.cc',
         'message_loop/message_pump_io_ios_unittest.cc',
         'message_loop/message_pump_libevent_unittest.cc',
+        'message_loop/timer_wheel_unittest.cc',
         'metrics/sample_map_unittest.cc',
         'metrics/sample_vector_unittest.cc',
+        'metrics/shared_histogram_allocator_unittest.cc',
         'metrics/bucket_ranges_unittest.cc',
         'metrics/field_trial_unittest.cc',
         'metrics/histogram_base_unittest.cc',
@@ -551,6 +562,7 @@
         'metrics/sparse_histogram_unittest.cc',
         'metrics/stats_table_unittest.cc',
         'metrics/statistics_recorder_unittest.cc',
+        'metrics/thread_local_samples_unittest.cc',
         'observer_list_unittest.cc',
         'os_compat_android_unittest.cc',
         'path_service_unittest.cc',
@@ -672,6 +684,7 @@
         'third_party/dynamic_annotations/dynamic_annotations.gyp:dynamic_annotations',
         '../testing/gmock.gyp:gmock',
         '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
         '../third_party/icu/icu.gyp:icui18n',
         '../third_party/icu/icu.gyp:icuuc',
       ],
@@ -833,6 +846,39 @@
         'i18n/streaming_utf8_validator_perftest.cc',
       ],
     },
+    {
+      'target_name': 'base_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'test_support_base',
+        'test_support_perf',
+        '../testing/gtest.gyp:gtest',
+        'base',
+      ],
+      'sources': [
+        'containers/flat_map_perftest.cc',
+        'debug/trace_event_perftest.cc',
+        'files/async_file_io_perftest.cc',
+        'json/json_reader_perftest.cc',
+        'memory/discardable_memory_perftest.cc',
+        'strings/utf_string_conversions_perftest.cc',
+      ],
+      'conditions': [
+        ['OS == "linux" or OS == "android"', {
+          'sources': [
+            'files/memory_mapped_file_perftest.cc',
+          ],
+        }],
+        ['OS == "linux" and linux_use_tcmalloc==1', {
+          'sources': [
+            'allocator/malloc_perftest.cc',
+          ],
+          'dependencies': [
+            'allocator/allocator.gyp:allocator',
+          ],
+        }],
+      ],
+    },
     {
       'target_name': 'test_support_base',
       'type': 'static_library',
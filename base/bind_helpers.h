@@ -491,6 +491,28 @@ struct IsWeakMethod<true, WeakPtr<T> > : public true_type {};
 template <typename T>
 struct IsWeakMethod<true, ConstRefWrapper<WeakPtr<T> > > : public true_type {};
 
+// WeakCallCancellation tells whether a weak call has been cancelled, that is,
+// whether the WeakPtr<> it was bound to has been invalidated. Calls that are
+// not weak are never cancelled.
+template <bool IsWeakCall>
+struct WeakCallCancellation {
+  template <typename P1>
+  static bool IsCancelled(const P1& p1) { return false; }
+};
+
+template <>
+struct WeakCallCancellation<true> {
+  template <typename T>
+  static bool IsCancelled(const WeakPtr<T>& receiver) {
+    return !receiver.get();
+  }
+
+  template <typename T>
+  static bool IsCancelled(const ConstRefWrapper<WeakPtr<T> >& receiver) {
+    return !receiver.get().get();
+  }
+};
+
 }  // namespace internal
 
 template <typename T>
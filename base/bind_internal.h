@@ -12,6 +12,7 @@
 
 #include "base/bind_helpers.h"
 #include "base/callback_internal.h"
+#include "base/compiler_specific.h"
 #include "base/memory/raw_scoped_refptr_mismatch_checker.h"
 #include "base/memory/weak_ptr.h"
 #include "base/template_util.h"
@@ -2565,6 +2566,10 @@ struct BindState<Runnable, RunType, void(P1)> : public BindStateBase {
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
 };
@@ -2590,6 +2595,10 @@ struct BindState<Runnable, RunType, void(P1, P2)> : public BindStateBase {
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
@@ -2619,6 +2628,10 @@ struct BindState<Runnable, RunType, void(P1, P2, P3)> : public BindStateBase {
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
@@ -2653,6 +2666,10 @@ struct BindState<Runnable, RunType, void(P1, P2, P3,
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
@@ -2690,6 +2707,10 @@ struct BindState<Runnable, RunType, void(P1, P2, P3, P4,
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
@@ -2730,6 +2751,10 @@ struct BindState<Runnable, RunType, void(P1, P2, P3, P4, P5,
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
@@ -2773,6 +2798,10 @@ struct BindState<Runnable, RunType, void(P1, P2, P3, P4, P5, P6,
   virtual ~BindState() {    MaybeRefcount<HasIsMethodTag<Runnable>::value,
       P1>::Release(p1_);  }
 
+  virtual bool IsCancelled() const OVERRIDE {
+    return WeakCallCancellation<IsWeakCall::value>::IsCancelled(p1_);
+  }
+
   RunnableType runnable_;
   P1 p1_;
   P2 p2_;
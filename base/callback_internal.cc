@@ -20,6 +20,10 @@ void CallbackBase::Reset() {
   bind_state_ = NULL;
 }
 
+bool CallbackBase::IsCancelled() const {
+  return bind_state_.get() && bind_state_->IsCancelled();
+}
+
 bool CallbackBase::Equals(const CallbackBase& other) const {
   return bind_state_.get() == other.bind_state_.get() &&
          polymorphic_invoke_ == other.polymorphic_invoke_;
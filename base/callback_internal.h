@@ -13,6 +13,7 @@
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/thread_local_arena.h"
 
 template <typename T>
 class ScopedVector;
@@ -26,7 +27,22 @@ namespace internal {
 // DoInvoke function to perform the function execution.  This allows
 // us to shield the Callback class from the types of the bound argument via
 // "type erasure."
+//
+// A BindState is allocated for nearly every posted task, so they are
+// recycled through ThreadLocalArena.
 class BindStateBase : public RefCountedThreadSafe<BindStateBase> {
+ public:
+  static void* operator new(size_t size) {
+    return ThreadLocalArena::Allocate(size);
+  }
+  static void operator delete(void* block, size_t size) {
+    ThreadLocalArena::Free(block, size);
+  }
+
+  // Returns true if running the bound function would do nothing because the
+  // WeakPtr<> it was bound to has been invalidated.
+  virtual bool IsCancelled() const { return false; }
+
  protected:
   friend class RefCountedThreadSafe<BindStateBase>;
   virtual ~BindStateBase() {}
@@ -42,6 +58,11 @@ class BASE_EXPORT CallbackBase {
   // Returns the Callback into an uninitialized state.
   void Reset();
 
+  // Returns true if the Callback is bound to a method through a WeakPtr<>
+  // that has been invalidated, so running it would be a no-op. Must be called
+  // on the thread the WeakPtr<> is dereferenced on.
+  bool IsCancelled() const;
+
  protected:
   // In C++, it is safe to cast function pointers to function pointers of
   // another type. It is not okay to use void*. We create a InvokeFuncStorage
@@ -8,6 +8,7 @@
 #include "base/callback_internal.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -124,6 +125,33 @@ TEST_F(CallbackTest, Reset) {
   EXPECT_TRUE(callback_a_.Equals(null_callback_));
 }
 
+class WeakTarget {
+ public:
+  WeakTarget() : weak_factory_(this) {}
+  void Method(int) {}
+
+  WeakPtrFactory<WeakTarget> weak_factory_;
+};
+
+TEST_F(CallbackTest, IsCancelled) {
+  EXPECT_FALSE(null_callback_.IsCancelled());
+  EXPECT_FALSE(callback_a_.IsCancelled());
+
+  WeakTarget target;
+  Closure weak_call =
+      Bind(&WeakTarget::Method, target.weak_factory_.GetWeakPtr(), 1);
+  Callback<void(int)> partial_weak_call =
+      Bind(&WeakTarget::Method, target.weak_factory_.GetWeakPtr());
+  Closure unretained_call = Bind(&WeakTarget::Method, Unretained(&target), 1);
+  EXPECT_FALSE(weak_call.IsCancelled());
+  EXPECT_FALSE(partial_weak_call.IsCancelled());
+
+  target.weak_factory_.InvalidateWeakPtrs();
+  EXPECT_TRUE(weak_call.IsCancelled());
+  EXPECT_TRUE(partial_weak_call.IsCancelled());
+  EXPECT_FALSE(unretained_call.IsCancelled());
+}
+
 struct TestForReentrancy {
   TestForReentrancy()
       : cb_already_run(false),
@@ -0,0 +1,92 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_MAP_H_
+#define BASE_CONTAINERS_FLAT_MAP_H_
+
+#include <functional>
+#include <utility>
+
+#include "base/containers/flat_tree.h"
+#include "base/logging.h"
+
+namespace base {
+
+namespace internal {
+
+struct GetKeyFromValuePairFirst {
+  template <class Key, class Mapped>
+  const Key& operator()(const std::pair<Key, Mapped>& pair) const {
+    return pair.first;
+  }
+};
+
+}  // namespace internal
+
+// A std::map-like container kept as a sorted vector of (key, value) pairs.
+// See flat_set.h for when to use it and how it differs from std::map.
+//
+//   base::flat_map<std::string, int> map(pairs_vector.begin(),
+//                                        pairs_vector.end());
+//   map["foo"] = 12;
+template <class Key, class Mapped, class Compare = std::less<Key> >
+class flat_map
+    : public internal::flat_tree<Key,
+                                 std::pair<Key, Mapped>,
+                                 internal::GetKeyFromValuePairFirst,
+                                 Compare> {
+ private:
+  typedef internal::flat_tree<Key,
+                              std::pair<Key, Mapped>,
+                              internal::GetKeyFromValuePairFirst,
+                              Compare> tree;
+
+ public:
+  typedef Mapped mapped_type;
+  typedef typename tree::value_type value_type;
+  typedef typename tree::iterator iterator;
+  typedef typename tree::const_iterator const_iterator;
+
+  flat_map() {}
+
+  explicit flat_map(const Compare& comp) : tree(comp) {}
+
+  template <class InputIterator>
+  flat_map(InputIterator first,
+           InputIterator last,
+           const Compare& comp = Compare())
+      : tree(first, last, comp) {}
+
+  explicit flat_map(const std::vector<value_type>& items,
+                    const Compare& comp = Compare())
+      : tree(items, comp) {}
+
+  // Returns the value for |key|, inserting a default constructed one first if
+  // there is none. Takes O(size) when it inserts.
+  mapped_type& operator[](const Key& key) {
+    iterator found = tree::lower_bound(key);
+    if (found == tree::end() || tree::key_comp()(key, found->first))
+      found = tree::insert(found, value_type(key, mapped_type()));
+    return found->second;
+  }
+
+  // Returns the value for |key|, which must be in the map.
+  template <class K>
+  const mapped_type& at(const K& key) const {
+    const_iterator found = tree::find(key);
+    CHECK(found != tree::end());
+    return found->second;
+  }
+
+  template <class K>
+  mapped_type& at(const K& key) {
+    iterator found = tree::find(key);
+    CHECK(found != tree::end());
+    return found->second;
+  }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_MAP_H_
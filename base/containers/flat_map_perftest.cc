@@ -0,0 +1,153 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Most lookup tables in Chrome are small. Compare flat_map with std::map,
+// hash_map and SmallMap at those sizes, for building a table from unsorted
+// pairs, looking all of its keys up, and iterating over it.
+
+#include "base/containers/flat_map.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/containers/small_map.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+const size_t kSizes[] = {4, 16, 64, 256};
+
+// About this many elements are handled for each measurement.
+const size_t kElementsPerTest = 2 * 1000 * 1000;
+
+typedef std::vector<std::pair<int, int> > Pairs;
+
+Pairs MakeShuffledPairs(size_t size) {
+  Pairs pairs;
+  for (size_t i = 0; i < size; ++i)
+    pairs.push_back(std::make_pair(static_cast<int>(i * 7919), 1));
+  // A fixed permutation, so that all the runs do the same work.
+  for (size_t i = 1; i < size; ++i)
+    std::swap(pairs[i], pairs[(i * 31) % (i + 1)]);
+  return pairs;
+}
+
+// Builds the map with single insertions, which is what most existing code
+// does, so that all the maps are compared the same way.
+template <class Map>
+void Fill(const Pairs& pairs, Map* map) {
+  for (size_t i = 0; i < pairs.size(); ++i)
+    map->insert(pairs[i]);
+}
+
+template <class Map>
+void RunBuildTest(const char* name, size_t size) {
+  const Pairs pairs = MakeShuffledPairs(size);
+  const size_t times = kElementsPerTest / size;
+  size_t total_size = 0;
+  PerfTimeLogger timer(
+      StringPrintf("Build: %s size=%d", name, static_cast<int>(size)).c_str());
+  for (size_t i = 0; i < times; ++i) {
+    Map map;
+    Fill(pairs, &map);
+    total_size += map.size();
+  }
+  timer.Done();
+  EXPECT_EQ(times * size, total_size);
+}
+
+template <class Map>
+void RunLookupTest(const char* name, size_t size) {
+  const Pairs pairs = MakeShuffledPairs(size);
+  Map map;
+  Fill(pairs, &map);
+  const size_t times = kElementsPerTest / size;
+  int sum = 0;
+  PerfTimeLogger timer(
+      StringPrintf("Lookup: %s size=%d", name, static_cast<int>(size)).c_str());
+  for (size_t i = 0; i < times; ++i) {
+    for (size_t j = 0; j < size; ++j)
+      sum += map.find(pairs[j].first)->second;
+    // A miss every round.
+    sum += map.find(-1) == map.end() ? 0 : 1;
+  }
+  timer.Done();
+  EXPECT_EQ(static_cast<int>(times * size), sum);
+}
+
+template <class Map>
+void RunIterateTest(const char* name, size_t size) {
+  const Pairs pairs = MakeShuffledPairs(size);
+  Map map;
+  Fill(pairs, &map);
+  const size_t times = kElementsPerTest / size;
+  int sum = 0;
+  PerfTimeLogger timer(StringPrintf("Iterate: %s size=%d", name,
+                                    static_cast<int>(size)).c_str());
+  for (size_t i = 0; i < times; ++i) {
+    for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+      sum += it->second;
+  }
+  timer.Done();
+  EXPECT_EQ(static_cast<int>(times * size), sum);
+}
+
+typedef flat_map<int, int> FlatMap;
+typedef std::map<int, int> StdMap;
+typedef hash_map<int, int> HashMap;
+typedef SmallMap<hash_map<int, int> > SmallHashMap;
+
+TEST(FlatMapPerfTest, Build) {
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    RunBuildTest<FlatMap>("flat_map", kSizes[i]);
+    RunBuildTest<StdMap>("std::map", kSizes[i]);
+    RunBuildTest<HashMap>("hash_map", kSizes[i]);
+    RunBuildTest<SmallHashMap>("SmallMap", kSizes[i]);
+  }
+}
+
+// The bulk constructor of flat_map sorts once instead of inserting one by one.
+TEST(FlatMapPerfTest, BuildFromRange) {
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    const Pairs pairs = MakeShuffledPairs(kSizes[i]);
+    const size_t times = kElementsPerTest / kSizes[i];
+    size_t total_size = 0;
+    PerfTimeLogger timer(StringPrintf("BuildFromRange: flat_map size=%d",
+                                      static_cast<int>(kSizes[i])).c_str());
+    for (size_t j = 0; j < times; ++j) {
+      FlatMap map(pairs.begin(), pairs.end());
+      total_size += map.size();
+    }
+    timer.Done();
+    EXPECT_EQ(times * kSizes[i], total_size);
+  }
+}
+
+TEST(FlatMapPerfTest, Lookup) {
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    RunLookupTest<FlatMap>("flat_map", kSizes[i]);
+    RunLookupTest<StdMap>("std::map", kSizes[i]);
+    RunLookupTest<HashMap>("hash_map", kSizes[i]);
+    RunLookupTest<SmallHashMap>("SmallMap", kSizes[i]);
+  }
+}
+
+TEST(FlatMapPerfTest, Iterate) {
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    RunIterateTest<FlatMap>("flat_map", kSizes[i]);
+    RunIterateTest<StdMap>("std::map", kSizes[i]);
+    RunIterateTest<HashMap>("hash_map", kSizes[i]);
+    RunIterateTest<SmallHashMap>("SmallMap", kSizes[i]);
+  }
+}
+
+}  // namespace
+}  // namespace base
@@ -0,0 +1,105 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_map.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string_piece.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+struct StringPieceLess {
+  bool operator()(const StringPiece& left, const StringPiece& right) const {
+    return left < right;
+  }
+};
+
+typedef flat_map<int, std::string> IntStringMap;
+
+}  // namespace
+
+TEST(FlatMap, RangeConstructorKeepsFirstValueOfEachKey) {
+  std::vector<std::pair<int, std::string> > pairs;
+  pairs.push_back(std::make_pair(3, std::string("c")));
+  pairs.push_back(std::make_pair(1, std::string("a")));
+  pairs.push_back(std::make_pair(3, std::string("C")));
+  pairs.push_back(std::make_pair(2, std::string("b")));
+  IntStringMap map(pairs.begin(), pairs.end());
+  ASSERT_EQ(3U, map.size());
+  IntStringMap::const_iterator it = map.begin();
+  EXPECT_EQ(1, it->first);
+  EXPECT_EQ("a", it->second);
+  ++it;
+  EXPECT_EQ(2, it->first);
+  ++it;
+  EXPECT_EQ(3, it->first);
+  EXPECT_EQ("c", it->second);
+}
+
+TEST(FlatMap, SubscriptOperator) {
+  IntStringMap map;
+  map[2] = "b";
+  map[1] = "a";
+  EXPECT_EQ(2U, map.size());
+  EXPECT_EQ("a", map[1]);
+  map[2] += "b";
+  EXPECT_EQ("bb", map[2]);
+  EXPECT_EQ("", map[0]);
+  EXPECT_EQ(3U, map.size());
+  EXPECT_EQ(0, map.begin()->first);
+}
+
+TEST(FlatMap, Insert) {
+  IntStringMap map;
+  EXPECT_TRUE(map.insert(std::make_pair(1, std::string("a"))).second);
+  std::pair<IntStringMap::iterator, bool> result =
+      map.insert(std::make_pair(1, std::string("b")));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("a", result.first->second);
+}
+
+TEST(FlatMap, At) {
+  IntStringMap map;
+  map[1] = "a";
+  const IntStringMap& const_map = map;
+  EXPECT_EQ("a", const_map.at(1));
+  map.at(1) = "b";
+  EXPECT_EQ("b", map[1]);
+}
+
+TEST(FlatMap, Erase) {
+  IntStringMap map;
+  map[1] = "a";
+  map[2] = "b";
+  map[3] = "c";
+  EXPECT_EQ(1U, map.erase(2));
+  EXPECT_EQ(0U, map.erase(2));
+  EXPECT_TRUE(map.find(2) == map.end());
+  map.erase(map.find(1));
+  ASSERT_EQ(1U, map.size());
+  EXPECT_EQ(3, map.begin()->first);
+}
+
+TEST(FlatMap, HeterogeneousLookup) {
+  flat_map<std::string, int, StringPieceLess> map;
+  map["content-type"] = 1;
+  map["content-length"] = 2;
+  const std::string header_line = "content-length: 12";
+  StringPiece name(header_line.data(), header_line.find(':'));
+  flat_map<std::string, int, StringPieceLess>::const_iterator it =
+      map.find(name);
+  ASSERT_TRUE(it != map.end());
+  EXPECT_EQ(2, it->second);
+  EXPECT_EQ(1, map.at(StringPiece("content-type")));
+  EXPECT_EQ(0U, map.count(StringPiece("accept")));
+}
+
+}  // namespace base
@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_SET_H_
+#define BASE_CONTAINERS_FLAT_SET_H_
+
+#include <functional>
+
+#include "base/containers/flat_tree.h"
+
+namespace base {
+
+namespace internal {
+
+struct GetKeyFromValueIdentity {
+  template <class T>
+  const T& operator()(const T& value) const {
+    return value;
+  }
+};
+
+}  // namespace internal
+
+// flat_set and flat_map are associative containers kept as a sorted vector.
+// They offer the std::set and std::map interfaces, without the allocation
+// per element, and with faster lookups and iteration since the elements are
+// contiguous in memory.
+//
+// WHEN TO USE THEM
+// ----------------
+//
+// For tables with up to a few hundred elements that are looked up often and
+// modified rarely, or built all at once: header tables, routing tables,
+// property maps. Building one from an unsorted range sorts it once, which is
+// O(N log N), but inserting or erasing an element moves all the elements
+// after it, which is O(N). Prefer std::set and std::map for large or
+// frequently modified tables, or when iterators and references have to stay
+// valid: every modification invalidates them.
+//
+// See small_map.h for a comparison of the other map types.
+//
+// DIFFERENCES FROM STD::SET AND STD::MAP
+// --------------------------------------
+//
+//  - Every insertion and erasure invalidates all the iterators and references.
+//  - The lookup functions (find, count, lower_bound, upper_bound, equal_range)
+//    take keys of any type |Compare| can compare with the key type, see
+//    flat_tree.h.
+//  - When a range given to the constructor or to insert() has several values
+//    with the same key, the first one is kept.
+//  - The value type of flat_map is std::pair<Key, Mapped>, without const, so
+//    that the elements can be moved around. Changing the key of an element in
+//    place breaks the container.
+//  - reserve(), capacity() and shrink_to_fit() manage the memory of the
+//    underlying vector.
+//
+// USAGE
+// -----
+//
+//   base::flat_set<int> ids(ids_vector.begin(), ids_vector.end());
+//   if (ids.count(42))
+//     ...
+template <class Key, class Compare = std::less<Key> >
+class flat_set : public internal::flat_tree<Key,
+                                            Key,
+                                            internal::GetKeyFromValueIdentity,
+                                            Compare> {
+ private:
+  typedef internal::flat_tree<Key,
+                              Key,
+                              internal::GetKeyFromValueIdentity,
+                              Compare> tree;
+
+ public:
+  flat_set() {}
+
+  explicit flat_set(const Compare& comp) : tree(comp) {}
+
+  template <class InputIterator>
+  flat_set(InputIterator first,
+           InputIterator last,
+           const Compare& comp = Compare())
+      : tree(first, last, comp) {}
+
+  explicit flat_set(const std::vector<Key>& items,
+                    const Compare& comp = Compare())
+      : tree(items, comp) {}
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_SET_H_
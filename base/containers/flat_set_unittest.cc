@@ -0,0 +1,192 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_set.h"
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string_piece.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Compares strings with StringPieces without converting either of them.
+struct StringPieceLess {
+  bool operator()(const StringPiece& left, const StringPiece& right) const {
+    return left < right;
+  }
+};
+
+// Orders ints by their value modulo 10 only, to tell apart elements that
+// compare equivalent.
+struct ModuloTenLess {
+  bool operator()(int left, int right) const {
+    return left % 10 < right % 10;
+  }
+};
+
+std::vector<int> ToVector(const flat_set<int>& set) {
+  return std::vector<int>(set.begin(), set.end());
+}
+
+}  // namespace
+
+TEST(FlatSet, Empty) {
+  flat_set<int> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(0U, set.size());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.find(1) == set.end());
+  EXPECT_EQ(0U, set.count(1));
+}
+
+TEST(FlatSet, RangeConstructorSortsAndRemovesDuplicates) {
+  const int kValues[] = {5, 2, 9, 2, 7, 5, 1};
+  flat_set<int> set(kValues, kValues + arraysize(kValues));
+  const int kExpected[] = {1, 2, 5, 7, 9};
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+}
+
+TEST(FlatSet, RangeConstructorKeepsFirstEquivalentValue) {
+  const int kValues[] = {13, 21, 3, 11, 23};
+  flat_set<int, ModuloTenLess> set(kValues, kValues + arraysize(kValues));
+  ASSERT_EQ(2U, set.size());
+  EXPECT_EQ(21, *set.begin());
+  EXPECT_EQ(13, *(set.begin() + 1));
+}
+
+TEST(FlatSet, VectorConstructor) {
+  std::vector<int> values;
+  values.push_back(3);
+  values.push_back(1);
+  values.push_back(3);
+  flat_set<int> set(values);
+  ASSERT_EQ(2U, set.size());
+  EXPECT_EQ(1, *set.begin());
+  EXPECT_EQ(3, *set.rbegin());
+}
+
+TEST(FlatSet, Insert) {
+  flat_set<int> set;
+  std::pair<flat_set<int>::iterator, bool> result = set.insert(5);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(5, *result.first);
+  result = set.insert(1);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(1, *result.first);
+  result = set.insert(5);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(5, *result.first);
+  const int kExpected[] = {1, 5};
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+}
+
+TEST(FlatSet, InsertWithHint) {
+  flat_set<int> set;
+  set.insert(set.end(), 1);
+  set.insert(set.end(), 3);
+  // A wrong hint still inserts at the right place.
+  set.insert(set.begin(), 4);
+  set.insert(set.begin() + 1, 2);
+  set.insert(set.end(), 2);
+  const int kExpected[] = {1, 2, 3, 4};
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+}
+
+TEST(FlatSet, InsertRange) {
+  const int kInitial[] = {2, 4, 6};
+  flat_set<int> set(kInitial, kInitial + arraysize(kInitial));
+  const int kValues[] = {5, 4, 1, 7, 1};
+  set.insert(kValues, kValues + arraysize(kValues));
+  const int kExpected[] = {1, 2, 4, 5, 6, 7};
+  EXPECT_EQ(std::vector<int>(kExpected, kExpected + arraysize(kExpected)),
+            ToVector(set));
+}
+
+TEST(FlatSet, InsertRangeKeepsExistingEquivalentValue) {
+  flat_set<int, ModuloTenLess> set;
+  set.insert(12);
+  const int kValues[] = {22, 3, 13};
+  set.insert(kValues, kValues + arraysize(kValues));
+  ASSERT_EQ(2U, set.size());
+  EXPECT_EQ(12, *set.begin());
+  EXPECT_EQ(3, *(set.begin() + 1));
+}
+
+TEST(FlatSet, Erase) {
+  const int kValues[] = {1, 2, 3, 4, 5};
+  flat_set<int> set(kValues, kValues + arraysize(kValues));
+  EXPECT_EQ(1U, set.erase(3));
+  EXPECT_EQ(0U, set.erase(3));
+  flat_set<int>::iterator next = set.erase(set.begin());
+  EXPECT_EQ(2, *next);
+  const flat_set<int>& const_set = set;
+  next = set.erase(const_set.begin(), const_set.begin() + 2);
+  EXPECT_EQ(5, *next);
+  EXPECT_EQ(1U, set.size());
+}
+
+TEST(FlatSet, Lookup) {
+  const int kValues[] = {10, 20, 30};
+  const flat_set<int> set(kValues, kValues + arraysize(kValues));
+  EXPECT_EQ(1U, set.count(20));
+  EXPECT_EQ(0U, set.count(25));
+  EXPECT_EQ(20, *set.find(20));
+  EXPECT_TRUE(set.find(25) == set.end());
+  EXPECT_EQ(30, *set.lower_bound(25));
+  EXPECT_EQ(20, *set.lower_bound(20));
+  EXPECT_EQ(30, *set.upper_bound(20));
+  EXPECT_TRUE(set.upper_bound(30) == set.end());
+  std::pair<flat_set<int>::const_iterator, flat_set<int>::const_iterator>
+      range = set.equal_range(20);
+  EXPECT_EQ(1, range.second - range.first);
+  range = set.equal_range(25);
+  EXPECT_TRUE(range.first == range.second);
+}
+
+TEST(FlatSet, HeterogeneousLookup) {
+  const char* const kValues[] = {"foo", "bar", "baz"};
+  flat_set<std::string, StringPieceLess> set(kValues,
+                                             kValues + arraysize(kValues));
+  const std::string buffer = "foobar";
+  EXPECT_EQ(1U, set.count(StringPiece(buffer.data(), 3)));
+  EXPECT_EQ("bar", *set.find(StringPiece(buffer.data() + 3, 3)));
+  EXPECT_TRUE(set.find(StringPiece("qux")) == set.end());
+  EXPECT_EQ("baz", *set.lower_bound(StringPiece("bas")));
+}
+
+TEST(FlatSet, MemoryManagement) {
+  flat_set<int> set;
+  set.reserve(100);
+  EXPECT_LE(100U, set.capacity());
+  set.insert(1);
+  set.shrink_to_fit();
+  EXPECT_EQ(1U, set.size());
+  EXPECT_EQ(1, *set.begin());
+  set.clear();
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(FlatSet, SwapAndCompare) {
+  const int kValues1[] = {1, 2};
+  const int kValues2[] = {3};
+  flat_set<int> set1(kValues1, kValues1 + arraysize(kValues1));
+  flat_set<int> set2(kValues2, kValues2 + arraysize(kValues2));
+  EXPECT_TRUE(set1 < set2);
+  EXPECT_TRUE(set1 != set2);
+  set1.swap(set2);
+  EXPECT_EQ(1U, set1.size());
+  EXPECT_EQ(3, *set1.begin());
+  flat_set<int> copy(set2);
+  EXPECT_TRUE(copy == set2);
+}
+
+}  // namespace base
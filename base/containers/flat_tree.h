@@ -0,0 +1,369 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_TREE_H_
+#define BASE_CONTAINERS_FLAT_TREE_H_
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace base {
+namespace internal {
+
+// Implementation of flat_set and flat_map: an associative container kept as a
+// sorted std::vector of values, where GetKeyFromValue returns the key of a
+// value. See flat_set.h for when to use them.
+//
+// The lookup functions are templates on the type of the key they are given,
+// so that KeyCompare can compare it with key_type directly when it has the
+// overloads for it. A set of std::string with a comparator that also takes
+// StringPiece, for instance, can be searched for a StringPiece without making
+// a string out of it.
+template <class Key, class Value, class GetKeyFromValue, class KeyCompare>
+class flat_tree {
+ private:
+  typedef std::vector<Value> underlying_type;
+
+ public:
+  typedef Key key_type;
+  typedef KeyCompare key_compare;
+  typedef Value value_type;
+
+  // Compares values by their keys.
+  struct value_compare : private key_compare {
+    value_compare(const key_compare& key_comp) : key_compare(key_comp) {}
+
+    bool operator()(const value_type& left, const value_type& right) const {
+      GetKeyFromValue extractor;
+      return key_compare::operator()(extractor(left), extractor(right));
+    }
+  };
+
+  typedef typename underlying_type::pointer pointer;
+  typedef typename underlying_type::const_pointer const_pointer;
+  typedef typename underlying_type::reference reference;
+  typedef typename underlying_type::const_reference const_reference;
+  typedef typename underlying_type::size_type size_type;
+  typedef typename underlying_type::difference_type difference_type;
+  typedef typename underlying_type::iterator iterator;
+  typedef typename underlying_type::const_iterator const_iterator;
+  typedef typename underlying_type::reverse_iterator reverse_iterator;
+  typedef typename underlying_type::const_reverse_iterator
+      const_reverse_iterator;
+
+  // --------------------------------------------------------------------------
+  // Lifetime.
+  //
+  // The constructors taking a range sort it first, which costs O(N log N)
+  // instead of the O(N^2) of inserting the values one at a time. When the
+  // range has several values with the same key, the first one is kept, as
+  // std::map does.
+
+  flat_tree() : impl_(KeyCompare()) {}
+
+  explicit flat_tree(const KeyCompare& comp) : impl_(comp) {}
+
+  template <class InputIterator>
+  flat_tree(InputIterator first,
+            InputIterator last,
+            const KeyCompare& comp = KeyCompare())
+      : impl_(comp, first, last) {
+    sort_and_unique(begin());
+  }
+
+  explicit flat_tree(const std::vector<value_type>& items,
+                     const KeyCompare& comp = KeyCompare())
+      : impl_(comp, items.begin(), items.end()) {
+    sort_and_unique(begin());
+  }
+
+  // Assigns the values of the range, with the same rules as the constructor.
+  template <class InputIterator>
+  void assign(InputIterator first, InputIterator last) {
+    impl_.body_.assign(first, last);
+    sort_and_unique(begin());
+  }
+
+  // --------------------------------------------------------------------------
+  // Memory management.
+  //
+  // Beware that shrink_to_fit() simply forwards the request to the
+  // underlying_type and its implementation is free to optimize otherwise and
+  // leave capacity() to be greater that its size.
+  //
+  // reserve() and shrink_to_fit() invalidate iterators and references.
+
+  void reserve(size_type new_capacity) { impl_.body_.reserve(new_capacity); }
+  size_type capacity() const { return impl_.body_.capacity(); }
+  void shrink_to_fit() { underlying_type(impl_.body_).swap(impl_.body_); }
+
+  // --------------------------------------------------------------------------
+  // Size management.
+  //
+  // clear() leaves the capacity() of the flat_tree unchanged.
+
+  void clear() { impl_.body_.clear(); }
+  size_type size() const { return impl_.body_.size(); }
+  size_type max_size() const { return impl_.body_.max_size(); }
+  bool empty() const { return impl_.body_.empty(); }
+
+  // --------------------------------------------------------------------------
+  // Iterators.
+
+  iterator begin() { return impl_.body_.begin(); }
+  const_iterator begin() const { return impl_.body_.begin(); }
+  iterator end() { return impl_.body_.end(); }
+  const_iterator end() const { return impl_.body_.end(); }
+  reverse_iterator rbegin() { return impl_.body_.rbegin(); }
+  const_reverse_iterator rbegin() const { return impl_.body_.rbegin(); }
+  reverse_iterator rend() { return impl_.body_.rend(); }
+  const_reverse_iterator rend() const { return impl_.body_.rend(); }
+
+  // --------------------------------------------------------------------------
+  // Insert operations.
+  //
+  // Assume that every operation invalidates iterators and references.
+  // Insertion of one element can take O(size). Capacity of flat_tree grows in
+  // an implementation-defined manner.
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    GetKeyFromValue extractor;
+    iterator position = lower_bound(extractor(value));
+    if (position == end() || impl_.get_value_comp()(value, *position))
+      return std::make_pair(impl_.body_.insert(position, value), true);
+    return std::make_pair(position, false);
+  }
+
+  // Inserts |value| at |position| if that keeps the values sorted, which
+  // saves the search.
+  iterator insert(const_iterator position, const value_type& value) {
+    iterator hint = const_cast_it(position);
+    if (hint == end() || impl_.get_value_comp()(value, *hint)) {
+      if (hint == begin() || impl_.get_value_comp()(*(hint - 1), value))
+        return impl_.body_.insert(hint, value);
+    }
+    return insert(value).first;
+  }
+
+  // Inserts the values of the range whose keys are not in the tree yet, in a
+  // single O(N log N + size) pass.
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    const difference_type previous_size = size();
+    impl_.body_.insert(end(), first, last);
+    sort_and_unique(begin() + previous_size);
+  }
+
+  // --------------------------------------------------------------------------
+  // Erase operations.
+  //
+  // Assume that every operation invalidates iterators and references.
+  //
+  // erase(position), erase(first, last) can take O(size).
+  // erase(key) may take O(size) + O(log(size)). Erasing by key does not take
+  // other types than key_type, so that it can't be mistaken for the erasure of
+  // an iterator.
+
+  iterator erase(iterator position) {
+    return impl_.body_.erase(position);
+  }
+
+  iterator erase(const_iterator position) {
+    return impl_.body_.erase(const_cast_it(position));
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return impl_.body_.erase(const_cast_it(first), const_cast_it(last));
+  }
+
+  size_type erase(const key_type& key) {
+    std::pair<iterator, iterator> range = equal_range(key);
+    const size_type count = range.second - range.first;
+    impl_.body_.erase(range.first, range.second);
+    return count;
+  }
+
+  // --------------------------------------------------------------------------
+  // Comparators.
+
+  key_compare key_comp() const { return impl_.get_key_comp(); }
+  value_compare value_comp() const { return impl_.get_value_comp(); }
+
+  // --------------------------------------------------------------------------
+  // Search operations.
+  //
+  // Search operations have O(log(size)) complexity.
+
+  template <class K>
+  size_type count(const K& key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  template <class K>
+  iterator find(const K& key) {
+    iterator position = lower_bound(key);
+    if (position == end() || key_value_compare(impl_.get_key_comp())(
+                                 key, *position)) {
+      return end();
+    }
+    return position;
+  }
+
+  template <class K>
+  const_iterator find(const K& key) const {
+    const_iterator position = lower_bound(key);
+    if (position == end() || key_value_compare(impl_.get_key_comp())(
+                                 key, *position)) {
+      return end();
+    }
+    return position;
+  }
+
+  template <class K>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    iterator lower = lower_bound(key);
+    if (lower == end() ||
+        key_value_compare(impl_.get_key_comp())(key, *lower)) {
+      return std::make_pair(lower, lower);
+    }
+    return std::make_pair(lower, lower + 1);
+  }
+
+  template <class K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    const_iterator lower = lower_bound(key);
+    if (lower == end() ||
+        key_value_compare(impl_.get_key_comp())(key, *lower)) {
+      return std::make_pair(lower, lower);
+    }
+    return std::make_pair(lower, lower + 1);
+  }
+
+  template <class K>
+  iterator lower_bound(const K& key) {
+    return std::lower_bound(begin(), end(), key,
+                            key_value_compare(impl_.get_key_comp()));
+  }
+
+  template <class K>
+  const_iterator lower_bound(const K& key) const {
+    return std::lower_bound(begin(), end(), key,
+                            key_value_compare(impl_.get_key_comp()));
+  }
+
+  template <class K>
+  iterator upper_bound(const K& key) {
+    return std::upper_bound(begin(), end(), key,
+                            key_value_compare(impl_.get_key_comp()));
+  }
+
+  template <class K>
+  const_iterator upper_bound(const K& key) const {
+    return std::upper_bound(begin(), end(), key,
+                            key_value_compare(impl_.get_key_comp()));
+  }
+
+  // --------------------------------------------------------------------------
+  // General operations.
+  //
+  // Assume that swap invalidates iterators and references.
+
+  void swap(flat_tree& other) { impl_.swap(other.impl_); }
+
+  friend bool operator==(const flat_tree& lhs, const flat_tree& rhs) {
+    return lhs.impl_.body_ == rhs.impl_.body_;
+  }
+
+  friend bool operator!=(const flat_tree& lhs, const flat_tree& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const flat_tree& lhs, const flat_tree& rhs) {
+    return lhs.impl_.body_ < rhs.impl_.body_;
+  }
+
+ private:
+  // Compares values and keys of any type KeyCompare can compare, in any
+  // order, as std::lower_bound() and std::upper_bound() need.
+  struct key_value_compare {
+    explicit key_value_compare(const KeyCompare& key_comp)
+        : key_comp(key_comp) {}
+
+    template <class Left, class Right>
+    bool operator()(const Left& left, const Right& right) const {
+      return key_comp(extract(left), extract(right));
+    }
+
+    static const Key& extract(const value_type& value) {
+      return GetKeyFromValue()(value);
+    }
+
+    template <class K>
+    static const K& extract(const K& key) {
+      return key;
+    }
+
+    const KeyCompare& key_comp;
+  };
+
+  iterator const_cast_it(const_iterator c) {
+    const underlying_type& body = impl_.body_;
+    return begin() + (c - body.begin());
+  }
+
+  // Sorts the values from |first| to the end, merges them with the sorted
+  // values before |first|, and removes the values whose key is already
+  // there. The values are stable sorted so that the first one of each key
+  // stays.
+  void sort_and_unique(iterator first) {
+    value_compare comp = value_comp();
+    std::stable_sort(first, end(), comp);
+    std::inplace_merge(begin(), first, end(), comp);
+    impl_.body_.erase(std::unique(begin(), end(), equivalent(comp)), end());
+  }
+
+  // Tells whether two values have equivalent keys.
+  struct equivalent {
+    explicit equivalent(const value_compare& comp) : comp(comp) {}
+
+    bool operator()(const value_type& left, const value_type& right) const {
+      return !comp(left, right) && !comp(right, left);
+    }
+
+    value_compare comp;
+  };
+
+  // The comparator is a base class so that it takes no space when it has no
+  // members, as usual.
+  struct Impl : private key_compare {
+    explicit Impl(const key_compare& key_comp) : key_compare(key_comp) {}
+
+    template <class InputIterator>
+    Impl(const key_compare& key_comp,
+         InputIterator first,
+         InputIterator last)
+        : key_compare(key_comp),
+          body_(first, last) {}
+
+    void swap(Impl& other) {
+      std::swap(static_cast<key_compare&>(*this),
+                static_cast<key_compare&>(other));
+      body_.swap(other.body_);
+    }
+
+    const key_compare& get_key_comp() const { return *this; }
+    value_compare get_value_comp() const {
+      return value_compare(get_key_comp());
+    }
+
+    underlying_type body_;
+  } impl_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_TREE_H_
@@ -0,0 +1,346 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/sampling_profiler.h"
+
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/debug/leak_annotations.h"
+#include "base/debug/stack_trace.h"
+#include "base/debug/trace_event.h"
+#include "base/format_macros.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/tracked_objects.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const char kCategory[] = TRACE_DISABLED_BY_DEFAULT("cpu_profiler");
+
+// Guards |g_sampling_profiler| and the drain threads.
+LazyInstance<Lock>::Leaky g_profiler_lock = LAZY_INSTANCE_INITIALIZER;
+
+// The profiler that is sampling, if any.
+SamplingProfiler* g_sampling_profiler = NULL;
+
+}  // namespace
+
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+
+namespace {
+
+const char kSampleEventName[] = "CpuProfiler::Sample";
+
+// Deeper frames of a stack are left out.
+const int kMaxFrames = 32;
+
+// Frames of StackTrace, the signal handler and the signal trampoline.
+const size_t kSkippedFrames = 3;
+
+// The number of samples the signal handler can record before the drain thread
+// empties their slots. Further samples are dropped.
+const size_t kMaxSamples = 1024;
+
+const int kDrainIntervalMilliseconds = 50;
+
+// States of a slot of |g_samples|. Samples are written into EMPTY slots by the
+// signal handler, and READY slots are CLAIMED by a drain thread, which then
+// empties them.
+enum SlotState {
+  SLOT_EMPTY = 0,
+  SLOT_WRITING,
+  SLOT_READY,
+  SLOT_CLAIMED
+};
+
+struct Sample {
+  subtle::Atomic32 state;
+  int64 timestamp;
+  PlatformThreadId thread_id;
+
+  // From the Location of the task that was running, if any.
+  const char* function_name;
+  const char* file_name;
+  int line_number;
+
+  int num_frames;
+  const void* frames[kMaxFrames];
+};
+
+// Allocated by the first profiler to start sampling and never freed, since a
+// signal may still be handled on another thread after sampling stopped.
+Sample* g_samples = NULL;
+
+// Incremented by the signal handler to pick slots in turn.
+subtle::Atomic32 g_next_sample = 0;
+
+// Whether the signal handler records samples.
+subtle::Atomic32 g_sampling = 0;
+
+void OnProfilingSignal(int signal, siginfo_t* info, void* context) {
+  // NOTE: This code MUST be async-signal safe. NO malloc or stdio is allowed
+  // here.
+  if (!subtle::Acquire_Load(&g_sampling))
+    return;
+  int saved_errno = errno;
+
+  uint32 index = static_cast<uint32>(
+      subtle::NoBarrier_AtomicIncrement(&g_next_sample, 1)) % kMaxSamples;
+  Sample* sample = &g_samples[index];
+  // The sample is dropped if the drain thread hasn't emptied the slot yet.
+  if (subtle::Acquire_CompareAndSwap(&sample->state, SLOT_EMPTY,
+                                     SLOT_WRITING) == SLOT_EMPTY) {
+    sample->timestamp = TimeTicks::NowFromSystemTraceTime().ToInternalValue();
+    sample->thread_id = PlatformThread::CurrentId();
+
+    const tracked_objects::Location* location =
+        tracked_objects::ScopedRunningTask::GetCurrentLocation();
+    sample->function_name = location ? location->function_name() : NULL;
+    sample->file_name = location ? location->file_name() : NULL;
+    sample->line_number = location ? location->line_number() : 0;
+
+    StackTrace stack;
+    size_t count = 0;
+    const void* const* frames = stack.Addresses(&count);
+    int num_frames = 0;
+    for (size_t i = kSkippedFrames; i < count && num_frames < kMaxFrames; ++i)
+      sample->frames[num_frames++] = frames[i];
+    sample->num_frames = num_frames;
+
+    subtle::Release_Store(&sample->state, SLOT_READY);
+  }
+
+  errno = saved_errno;
+}
+
+// Holds the stack of a sample until the tracing system serializes it, as a
+// list of hexadecimal addresses.
+class SampleStack : public ConvertableToTraceFormat {
+ public:
+  SampleStack(const void* const* frames, int num_frames)
+      : frames_(frames, frames + num_frames) {
+  }
+
+  // base::debug::ConvertableToTraceFormat overrides:
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    *out += "[";
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (i > 0)
+        *out += ",";
+      StringAppendF(out, "\"0x%" PRIxPTR "\"",
+                    reinterpret_cast<uintptr_t>(frames_[i]));
+    }
+    *out += "]";
+  }
+
+ private:
+  virtual ~SampleStack() {}
+
+  std::vector<const void*> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampleStack);
+};
+
+void AddSampleEvent(const unsigned char* category_group_enabled,
+                    const Sample& sample) {
+  scoped_refptr<ConvertableToTraceFormat> stack(
+      new SampleStack(sample.frames, sample.num_frames));
+  TimeTicks timestamp = TimeTicks::FromInternalValue(sample.timestamp);
+  int thread_id = static_cast<int>(sample.thread_id);
+  if (!sample.function_name) {
+    trace_event_internal::AddTraceEventWithThreadIdAndTimestamp(
+        TRACE_EVENT_PHASE_SAMPLE, category_group_enabled, kSampleEventName,
+        trace_event_internal::kNoEventId, thread_id, timestamp,
+        TRACE_EVENT_FLAG_NONE, "stack", stack);
+    return;
+  }
+  std::string posted_from = StringPrintf(
+      "%s@%s:%d", sample.function_name, sample.file_name, sample.line_number);
+  trace_event_internal::AddTraceEventWithThreadIdAndTimestamp(
+      TRACE_EVENT_PHASE_SAMPLE, category_group_enabled, kSampleEventName,
+      trace_event_internal::kNoEventId, thread_id, timestamp,
+      TRACE_EVENT_FLAG_NONE, "posted_from", posted_from, "stack", stack);
+}
+
+}  // namespace
+
+// Records the samples taken by the signal handler into the TraceLog. More
+// than one drain thread may be running for a moment after a profiler is
+// stopped and another started.
+class SampleDrainThread : public PlatformThread::Delegate {
+ public:
+  SampleDrainThread() : stop_event_(false, false) {}
+  virtual ~SampleDrainThread() {}
+
+  // Makes the thread record the samples left and delete itself.
+  void Stop() {
+    stop_event_.Signal();
+  }
+
+  // Implementation of PlatformThread::Delegate:
+  virtual void ThreadMain() OVERRIDE {
+    PlatformThread::SetName("CpuProfilerDrainThread");
+    const TimeDelta interval =
+        TimeDelta::FromMilliseconds(kDrainIntervalMilliseconds);
+    while (!stop_event_.TimedWait(interval))
+      DrainSamples();
+    DrainSamples();
+    delete this;
+  }
+
+ private:
+  void DrainSamples() {
+    const unsigned char* category_group_enabled =
+        TraceLog::GetCategoryGroupEnabled(kCategory);
+    for (size_t i = 0; i < kMaxSamples; ++i) {
+      Sample* sample = &g_samples[i];
+      if (subtle::Acquire_CompareAndSwap(&sample->state, SLOT_READY,
+                                         SLOT_CLAIMED) != SLOT_READY) {
+        continue;
+      }
+      // Samples taken while the category is disabled are dropped.
+      if (*category_group_enabled & TraceLog::ENABLED_FOR_RECORDING)
+        AddSampleEvent(category_group_enabled, *sample);
+      subtle::Release_Store(&sample->state, SLOT_EMPTY);
+    }
+  }
+
+  WaitableEvent stop_event_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampleDrainThread);
+};
+
+#endif  // defined(SAMPLING_PROFILER_SUPPORTED)
+
+SamplingProfiler::SamplingProfiler(int samples_per_second)
+    : samples_per_second_(samples_per_second),
+      drain_thread_(NULL) {
+  DCHECK_GT(samples_per_second, 0);
+  // Force the "cpu_profiler" category to show up in the trace viewer.
+  TRACE_EVENT0(kCategory, "init");
+  // Watch for the tracing system being enabled.
+  TraceLog::GetInstance()->AddEnabledStateObserver(this);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  StopSampling();
+  TraceLog::GetInstance()->RemoveEnabledStateObserver(this);
+}
+
+// base::debug::TraceLog::EnabledStateChangedObserver overrides:
+void SamplingProfiler::OnTraceLogEnabled() {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(kCategory, &enabled);
+  if (enabled)
+    StartSampling();
+}
+
+void SamplingProfiler::OnTraceLogDisabled() {
+  // The category is always disabled before OnTraceLogDisabled() is called, so
+  // we cannot tell if it was enabled before. Always try to stop sampling.
+  StopSampling();
+}
+
+bool SamplingProfiler::StartSampling() {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  AutoLock lock(g_profiler_lock.Get());
+  if (g_sampling_profiler)
+    return g_sampling_profiler == this;
+
+  if (!g_samples) {
+    // backtrace() loads the unwinder on its first call, which is not async-
+    // signal safe, so get that done before the signal handler needs it.
+    StackTrace warm_up;
+
+    g_samples = new Sample[kMaxSamples];
+    memset(g_samples, 0, kMaxSamples * sizeof(g_samples[0]));
+    ANNOTATE_LEAKING_OBJECT_PTR(g_samples);
+
+    // The handler stays installed, since a SIGPROF could still be pending
+    // when sampling stops.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &OnProfilingSignal;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, NULL) != 0) {
+      DPLOG(ERROR) << "sigaction";
+      delete[] g_samples;
+      g_samples = NULL;
+      return false;
+    }
+  }
+
+  tracked_objects::ScopedRunningTask::EnableRecording();
+
+  SampleDrainThread* drain_thread = new SampleDrainThread;
+  if (!PlatformThread::CreateNonJoinable(0, drain_thread)) {
+    DLOG(ERROR) << "Failed to create the sample drain thread";
+    delete drain_thread;
+    return false;
+  }
+
+  subtle::Release_Store(&g_sampling, 1);
+  const int64 interval_us =
+      Time::kMicrosecondsPerSecond / samples_per_second_;
+  struct itimerval timer;
+  timer.it_interval.tv_sec = interval_us / Time::kMicrosecondsPerSecond;
+  timer.it_interval.tv_usec = interval_us % Time::kMicrosecondsPerSecond;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+    DPLOG(ERROR) << "setitimer";
+    subtle::Release_Store(&g_sampling, 0);
+    drain_thread->Stop();
+    return false;
+  }
+
+  drain_thread_ = drain_thread;
+  g_sampling_profiler = this;
+  return true;
+#else
+  return false;
+#endif  // defined(SAMPLING_PROFILER_SUPPORTED)
+}
+
+void SamplingProfiler::StopSampling() {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  AutoLock lock(g_profiler_lock.Get());
+  if (g_sampling_profiler != this)
+    return;
+
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, NULL);
+  subtle::Release_Store(&g_sampling, 0);
+
+  drain_thread_->Stop();
+  drain_thread_ = NULL;
+  g_sampling_profiler = NULL;
+#endif  // defined(SAMPLING_PROFILER_SUPPORTED)
+}
+
+bool SamplingProfiler::IsSampling() const {
+  AutoLock lock(g_profiler_lock.Get());
+  return g_sampling_profiler == this;
+}
+
+}  // namespace debug
+}  // namespace base
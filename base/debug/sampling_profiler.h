@@ -0,0 +1,70 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_DEBUG_SAMPLING_PROFILER_H_
+#define BASE_DEBUG_SAMPLING_PROFILER_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/debug/trace_event_impl.h"
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) && !defined(OS_NACL) && !defined(__UCLIBC__)
+#define SAMPLING_PROFILER_SUPPORTED 1
+#endif
+
+namespace base {
+namespace debug {
+
+class SampleDrainThread;
+
+// Samples the stacks of the threads of the process while the
+// "disabled-by-default-cpu_profiler" tracing category is enabled. Samples are
+// taken in a SIGPROF handler, so the more CPU time a thread uses the more it
+// is sampled, and are recorded into the TraceLog as TRACE_EVENT_PHASE_SAMPLE
+// events on the sampled thread. Each sample has the stack unwound with
+// StackTrace, in an argument "stack" of hexadecimal addresses to symbolize
+// offline, and in "posted_from" the tracked_objects::Location of the task
+// that was running, which attributes CPU time to PostTask() call sites.
+//
+// Only one profiler can sample at a time, since SIGPROF and the profiling
+// timer are process wide. Samples are only taken where
+// SAMPLING_PROFILER_SUPPORTED is defined.
+class BASE_EXPORT SamplingProfiler : public TraceLog::EnabledStateObserver {
+ public:
+  // Takes |samples_per_second| samples per second of CPU time used by the
+  // process.
+  explicit SamplingProfiler(int samples_per_second);
+  virtual ~SamplingProfiler();
+
+  // base::debug::TraceLog::EnabledStateObserver overrides:
+  virtual void OnTraceLogEnabled() OVERRIDE;
+  virtual void OnTraceLogDisabled() OVERRIDE;
+
+  // Starts sampling regardless of the tracing categories, though samples are
+  // only recorded while the category is enabled. Returns false if sampling is
+  // not supported or another profiler is sampling.
+  bool StartSampling();
+
+  // Stops sampling. The samples of the last moments before tracing is
+  // disabled may not make it into the trace.
+  void StopSampling();
+
+  bool IsSampling() const;
+
+ private:
+  const int samples_per_second_;
+
+  // Moves samples from the signal handler into the TraceLog while sampling.
+  // Deletes itself once stopped, so that stopping doesn't block on it.
+  // Guarded by a global lock.
+  SampleDrainThread* drain_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(SamplingProfiler);
+};
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_SAMPLING_PROFILER_H_
@@ -0,0 +1,127 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/sampling_profiler.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/json/json_reader.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const char kCategory[] = TRACE_DISABLED_BY_DEFAULT("cpu_profiler");
+
+void OnTraceDataCollected(std::string* json,
+                          const scoped_refptr<RefCountedString>& events_str,
+                          bool has_more_events) {
+  if (!json->empty() && !events_str->data().empty())
+    *json += ",";
+  *json += events_str->data();
+}
+
+// Spins for |duration| of CPU time of the thread, where supported.
+void BurnCpu(TimeDelta duration) {
+  bool use_thread_time = TimeTicks::IsThreadNowSupported();
+  TimeTicks start =
+      use_thread_time ? TimeTicks::ThreadNow() : TimeTicks::HighResNow();
+  volatile int counter = 0;
+  while ((use_thread_time ? TimeTicks::ThreadNow() : TimeTicks::HighResNow()) -
+         start < duration) {
+    ++counter;
+  }
+}
+
+}  // namespace
+
+TEST(SamplingProfilerTest, StartAndStop) {
+  SamplingProfiler profiler(100);
+  SamplingProfiler other_profiler(100);
+  EXPECT_FALSE(profiler.IsSampling());
+
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  EXPECT_TRUE(profiler.StartSampling());
+  EXPECT_TRUE(profiler.IsSampling());
+  EXPECT_TRUE(profiler.StartSampling());
+
+  // Only one profiler can sample at a time.
+  EXPECT_FALSE(other_profiler.StartSampling());
+  EXPECT_FALSE(other_profiler.IsSampling());
+
+  profiler.StopSampling();
+  EXPECT_FALSE(profiler.IsSampling());
+  EXPECT_TRUE(other_profiler.StartSampling());
+  other_profiler.StopSampling();
+#else
+  EXPECT_FALSE(profiler.StartSampling());
+  EXPECT_FALSE(profiler.IsSampling());
+#endif
+}
+
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+
+TEST(SamplingProfilerTest, RecordsSamplesOfRunningTask) {
+  SamplingProfiler profiler(1000);
+  TraceLog* trace_log = TraceLog::GetInstance();
+  {
+    MessageLoop message_loop;
+    trace_log->SetEnabled(CategoryFilter(kCategory),
+                          TraceLog::RECORDING_MODE,
+                          TraceLog::RECORD_UNTIL_FULL);
+    EXPECT_TRUE(profiler.IsSampling());
+
+    message_loop.PostTask(FROM_HERE,
+                          Bind(&BurnCpu, TimeDelta::FromMilliseconds(300)));
+    message_loop.RunUntilIdle();
+
+    // Give the drain thread time to record the samples.
+    PlatformThread::Sleep(TimeDelta::FromMilliseconds(200));
+    trace_log->SetDisabled();
+    EXPECT_FALSE(profiler.IsSampling());
+  }
+
+  std::string json;
+  trace_log->Flush(Bind(&OnTraceDataCollected, Unretained(&json)));
+  scoped_ptr<Value> root(JSONReader::Read("[" + json + "]"));
+  ListValue* events = NULL;
+  ASSERT_TRUE(root.get() && root->GetAsList(&events));
+
+  int num_task_samples = 0;
+  for (size_t i = 0; i < events->GetSize(); ++i) {
+    DictionaryValue* event = NULL;
+    std::string name;
+    std::string phase;
+    std::string posted_from;
+    ListValue* stack = NULL;
+    ASSERT_TRUE(events->GetDictionary(i, &event));
+    if (!event->GetString("name", &name) || name != "CpuProfiler::Sample")
+      continue;
+    EXPECT_TRUE(event->GetString("ph", &phase));
+    EXPECT_EQ("P", phase);
+    EXPECT_TRUE(event->GetList("args.stack", &stack));
+    if (event->GetString("args.posted_from", &posted_from) &&
+        posted_from.find("sampling_profiler_unittest.cc") !=
+            std::string::npos) {
+      ++num_task_samples;
+      EXPECT_GT(stack->GetSize(), 0u);
+    }
+  }
+  EXPECT_GT(num_task_samples, 0);
+}
+
+#endif  // defined(SAMPLING_PROFILER_SUPPORTED)
+
+}  // namespace debug
+}  // namespace base
@@ -0,0 +1,575 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_event_binary.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/debug/trace_event.h"
+#include "base/format_macros.h"
+#include "base/json/string_escape.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread_id_name_manager.h"
+
+// The stream starts with kMagic, the format version and the process id. Then
+// follow records, each starting with a tag byte:
+//   kStringRecord: the length and bytes of the next string in the table.
+//   kEventRecord: phase and flags bytes, the timestamp delta (zigzag), the
+//       thread id, the category group and name string indices, the id if
+//       flags has TRACE_EVENT_FLAG_HAS_ID, and a byte with the number of
+//       arguments, each written as its name string index, the type byte and
+//       the value.
+// Integers are unsigned LEB128 variable-length, except for doubles and
+// booleans which take 8 bytes and 1 byte.
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const char kMagic[] = { 'C', 'R', 'T', 'B' };
+const uint64 kVersion = 1;
+
+const char kStringRecord = 's';
+const char kEventRecord = 'e';
+
+// Records are written out once this many bytes are buffered.
+const size_t kFlushThreshold = 64 * 1024;
+
+// The number of events passed to the output callback at a time by
+// ConvertBinaryTraceToJSON(), as many as TraceLog::Flush() does.
+const size_t kEventsPerBatch = 1000;
+
+// Longer strings make a stream invalid.
+const uint64 kMaxStringLength = 16 * 1024 * 1024;
+
+const char kMetadataCategoryGroup[] = "__metadata";
+const char kThreadNameEventName[] = "thread_name";
+const char kThreadNameArgName[] = "name";
+
+// Guards |g_streaming_writer|, which receives the events while streaming.
+LazyInstance<Lock>::Leaky g_streaming_lock = LAZY_INSTANCE_INITIALIZER;
+TraceBinaryWriter* g_streaming_writer = NULL;
+
+uint64 ZigZagEncode(int64 value) {
+  return (static_cast<uint64>(value) << 1) ^ static_cast<uint64>(value >> 63);
+}
+
+int64 ZigZagDecode(uint64 value) {
+  return static_cast<int64>(value >> 1) ^ -static_cast<int64>(value & 1);
+}
+
+void AppendVarint(uint64 value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendString(const char* string, std::string* out) {
+  size_t length = strlen(string);
+  AppendVarint(length, out);
+  out->append(string, length);
+}
+
+void AppendValue(unsigned char type,
+                 unsigned long long raw_value,
+                 std::string* out) {
+  TraceEvent::TraceValue value;
+  value.as_uint = raw_value;
+  switch (type) {
+    case TRACE_VALUE_TYPE_BOOL:
+      out->push_back(value.as_bool ? 1 : 0);
+      break;
+    case TRACE_VALUE_TYPE_UINT:
+      AppendVarint(value.as_uint, out);
+      break;
+    case TRACE_VALUE_TYPE_INT:
+      AppendVarint(ZigZagEncode(value.as_int), out);
+      break;
+    case TRACE_VALUE_TYPE_DOUBLE:
+      out->append(reinterpret_cast<const char*>(&value.as_double),
+                  sizeof(value.as_double));
+      break;
+    case TRACE_VALUE_TYPE_POINTER:
+      AppendVarint(reinterpret_cast<uintptr_t>(value.as_pointer), out);
+      break;
+    case TRACE_VALUE_TYPE_STRING:
+    case TRACE_VALUE_TYPE_COPY_STRING:
+      AppendString(value.as_string ? value.as_string : "NULL", out);
+      break;
+    default:
+      // TRACE_VALUE_TYPE_CONVERTABLE has no value in the event callback.
+      break;
+  }
+}
+
+// Reads the parts of records written by TraceBinaryWriter.
+class BinaryTraceReader {
+ public:
+  explicit BinaryTraceReader(FILE* file) : file_(file) {}
+
+  bool ReadByte(unsigned char* out) {
+    int c = getc(file_);
+    if (c == EOF)
+      return false;
+    *out = static_cast<unsigned char>(c);
+    return true;
+  }
+
+  bool ReadBytes(size_t length, std::string* out) {
+    out->resize(length);
+    return !length || fread(&(*out)[0], 1, length, file_) == length;
+  }
+
+  bool ReadVarint(uint64* out) {
+    uint64 result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      unsigned char byte;
+      if (!ReadByte(&byte))
+        return false;
+      result |= static_cast<uint64>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        *out = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadVarint32(uint32* out) {
+    uint64 value;
+    if (!ReadVarint(&value) || value > kuint32max)
+      return false;
+    *out = static_cast<uint32>(value);
+    return true;
+  }
+
+  bool ReadString(std::string* out) {
+    uint64 length;
+    return ReadVarint(&length) && length <= kMaxStringLength &&
+        ReadBytes(static_cast<size_t>(length), out);
+  }
+
+ private:
+  FILE* file_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryTraceReader);
+};
+
+// Turns the records of a stream into events in the JSON format of
+// TraceEvent::AppendAsJSON().
+class BinaryTraceConverter {
+ public:
+  BinaryTraceConverter(FILE* file, const TraceLog::OutputCallback& output)
+      : reader_(file),
+        output_(output),
+        process_id_(0),
+        timestamp_(0),
+        batch_(new RefCountedString),
+        batch_size_(0) {
+  }
+
+  bool Convert() {
+    bool result = ReadHeader() && ReadRecords();
+    if (!output_.is_null())
+      output_.Run(batch_, false);
+    return result;
+  }
+
+ private:
+  bool ReadHeader() {
+    std::string magic;
+    uint64 version;
+    uint32 process_id;
+    if (!reader_.ReadBytes(sizeof(kMagic), &magic) ||
+        memcmp(magic.data(), kMagic, sizeof(kMagic)) ||
+        !reader_.ReadVarint(&version) || version != kVersion ||
+        !reader_.ReadVarint32(&process_id)) {
+      return false;
+    }
+    process_id_ = static_cast<int>(process_id);
+    return true;
+  }
+
+  bool ReadRecords() {
+    unsigned char tag;
+    // The stream may only end between records.
+    while (reader_.ReadByte(&tag)) {
+      if (tag == kStringRecord) {
+        strings_.push_back(std::string());
+        if (!reader_.ReadString(&strings_.back()))
+          return false;
+      } else if (tag != kEventRecord || !ReadEvent()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ReadStringIndex(const std::string** out) {
+    uint32 index;
+    if (!reader_.ReadVarint32(&index) || index >= strings_.size())
+      return false;
+    *out = &strings_[index];
+    return true;
+  }
+
+  bool ReadEvent() {
+    unsigned char phase;
+    unsigned char flags;
+    uint64 timestamp_delta;
+    uint32 thread_id;
+    const std::string* category_group;
+    const std::string* name;
+    uint64 id = 0;
+    unsigned char num_args;
+    if (!reader_.ReadByte(&phase) || !reader_.ReadByte(&flags) ||
+        !reader_.ReadVarint(&timestamp_delta) ||
+        !reader_.ReadVarint32(&thread_id) ||
+        !ReadStringIndex(&category_group) || !ReadStringIndex(&name) ||
+        ((flags & TRACE_EVENT_FLAG_HAS_ID) && !reader_.ReadVarint(&id)) ||
+        !reader_.ReadByte(&num_args) || num_args > kTraceMaxNumArgs) {
+      return false;
+    }
+    timestamp_ += ZigZagDecode(timestamp_delta);
+
+    std::string* out = &batch_->data();
+    if (batch_size_)
+      *out += ",";
+    *out += "{\"cat\":";
+    EscapeJSONString(*category_group, true, out);
+    StringAppendF(out,
+        ",\"pid\":%i,\"tid\":%i,\"ts\":%" PRId64 ",\"ph\":",
+        process_id_, static_cast<int>(thread_id), timestamp_);
+    EscapeJSONString(std::string(1, static_cast<char>(phase)), true, out);
+    *out += ",\"name\":";
+    EscapeJSONString(*name, true, out);
+    *out += ",\"args\":{";
+    for (int i = 0; i < num_args; ++i) {
+      if (i > 0)
+        *out += ",";
+      if (!ReadArg(out))
+        return false;
+    }
+    *out += "}";
+
+    // If the id is set, print it out as a hex string so we don't loose any
+    // bits (it might be a 64-bit pointer).
+    if (flags & TRACE_EVENT_FLAG_HAS_ID)
+      StringAppendF(out, ",\"id\":\"0x%" PRIx64 "\"", id);
+
+    // Instant events also output their scope.
+    if (phase == TRACE_EVENT_PHASE_INSTANT) {
+      char scope = '?';
+      switch (flags & TRACE_EVENT_FLAG_SCOPE_MASK) {
+        case TRACE_EVENT_SCOPE_GLOBAL:
+          scope = TRACE_EVENT_SCOPE_NAME_GLOBAL;
+          break;
+
+        case TRACE_EVENT_SCOPE_PROCESS:
+          scope = TRACE_EVENT_SCOPE_NAME_PROCESS;
+          break;
+
+        case TRACE_EVENT_SCOPE_THREAD:
+          scope = TRACE_EVENT_SCOPE_NAME_THREAD;
+          break;
+      }
+      StringAppendF(out, ",\"s\":\"%c\"", scope);
+    }
+
+    *out += "}";
+
+    if (++batch_size_ == kEventsPerBatch) {
+      if (!output_.is_null())
+        output_.Run(batch_, true);
+      batch_ = new RefCountedString;
+      batch_size_ = 0;
+    }
+    return true;
+  }
+
+  bool ReadArg(std::string* out) {
+    const std::string* arg_name;
+    unsigned char type;
+    if (!ReadStringIndex(&arg_name) || !reader_.ReadByte(&type))
+      return false;
+    EscapeJSONString(*arg_name, true, out);
+    *out += ":";
+
+    TraceEvent::TraceValue value;
+    std::string string_value;
+    switch (type) {
+      case TRACE_VALUE_TYPE_BOOL: {
+        unsigned char byte;
+        if (!reader_.ReadByte(&byte))
+          return false;
+        value.as_bool = byte != 0;
+        break;
+      }
+      case TRACE_VALUE_TYPE_UINT:
+        if (!reader_.ReadVarint(
+                reinterpret_cast<uint64*>(&value.as_uint))) {
+          return false;
+        }
+        break;
+      case TRACE_VALUE_TYPE_INT: {
+        uint64 encoded;
+        if (!reader_.ReadVarint(&encoded))
+          return false;
+        value.as_int = ZigZagDecode(encoded);
+        break;
+      }
+      case TRACE_VALUE_TYPE_DOUBLE:
+        if (!reader_.ReadBytes(sizeof(value.as_double), &string_value))
+          return false;
+        memcpy(&value.as_double, string_value.data(), sizeof(value.as_double));
+        break;
+      case TRACE_VALUE_TYPE_POINTER: {
+        uint64 pointer;
+        if (!reader_.ReadVarint(&pointer))
+          return false;
+        value.as_pointer =
+            reinterpret_cast<const void*>(static_cast<uintptr_t>(pointer));
+        break;
+      }
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        if (!reader_.ReadString(&string_value))
+          return false;
+        value.as_string = string_value.c_str();
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE:
+        *out += "null";
+        return true;
+      default:
+        return false;
+    }
+    TraceEvent::AppendValueAsJSON(type, value, out);
+    return true;
+  }
+
+  BinaryTraceReader reader_;
+  TraceLog::OutputCallback output_;
+  int process_id_;
+  int64 timestamp_;
+  std::vector<std::string> strings_;
+
+  scoped_refptr<RefCountedString> batch_;
+  size_t batch_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryTraceConverter);
+};
+
+}  // namespace
+
+TraceBinaryWriter::TraceBinaryWriter(FILE* file)
+    : file_(file),
+      write_failed_(false),
+      num_strings_(0),
+      last_timestamp_(0) {
+  buffer_.append(kMagic, sizeof(kMagic));
+  AppendVarint(kVersion, &buffer_);
+  AppendVarint(static_cast<uint32>(TraceLog::GetInstance()->process_id()),
+               &buffer_);
+}
+
+TraceBinaryWriter::~TraceBinaryWriter() {
+  StopStreaming();
+  Flush();
+}
+
+void TraceBinaryWriter::StartStreaming(const CategoryFilter& category_filter) {
+  {
+    AutoLock lock(g_streaming_lock.Get());
+    DCHECK(!g_streaming_writer) << "Only one writer can stream at a time.";
+    g_streaming_writer = this;
+  }
+  TraceLog::GetInstance()->SetEventCallbackEnabled(
+      category_filter, &TraceBinaryWriter::OnTraceEvent);
+}
+
+void TraceBinaryWriter::StopStreaming() {
+  {
+    AutoLock lock(g_streaming_lock.Get());
+    if (g_streaming_writer != this)
+      return;
+    // Events still passed to OnTraceEvent() are dropped from now on.
+    g_streaming_writer = NULL;
+  }
+  TraceLog::GetInstance()->SetEventCallbackDisabled();
+}
+
+void TraceBinaryWriter::AddEvent(int thread_id,
+                                 TimeTicks timestamp,
+                                 char phase,
+                                 const unsigned char* category_group_enabled,
+                                 const char* name,
+                                 unsigned long long id,
+                                 int num_args,
+                                 const char* const arg_names[],
+                                 const unsigned char arg_types[],
+                                 const unsigned long long arg_values[],
+                                 unsigned char flags) {
+  AutoLock lock(lock_);
+  if (thread_ids_.insert(thread_id).second)
+    AddThreadNameWhileLocked(thread_id, timestamp);
+  AddEventWhileLocked(thread_id, timestamp, phase,
+                      InternCategoryGroupWhileLocked(category_group_enabled),
+                      name, id, num_args, arg_names, arg_types, arg_values,
+                      flags);
+  if (buffer_.size() >= kFlushThreshold)
+    FlushWhileLocked();
+}
+
+bool TraceBinaryWriter::Flush() {
+  AutoLock lock(lock_);
+  return FlushWhileLocked();
+}
+
+// static
+void TraceBinaryWriter::OnTraceEvent(
+    TimeTicks timestamp,
+    char phase,
+    const unsigned char* category_group_enabled,
+    const char* name,
+    unsigned long long id,
+    int num_args,
+    const char* const arg_names[],
+    const unsigned char arg_types[],
+    const unsigned long long arg_values[],
+    unsigned char flags) {
+  AutoLock lock(g_streaming_lock.Get());
+  if (!g_streaming_writer)
+    return;
+  g_streaming_writer->AddEvent(
+      static_cast<int>(PlatformThread::CurrentId()), timestamp, phase,
+      category_group_enabled, name, id, num_args, arg_names, arg_types,
+      arg_values, flags);
+}
+
+uint32 TraceBinaryWriter::InternStringWhileLocked(const char* string,
+                                                  bool copy) {
+  lock_.AssertAcquired();
+  uint32 index = num_strings_;
+  if (copy) {
+    std::pair<hash_map<std::string, uint32>::iterator, bool> result =
+        copied_string_indices_.insert(std::make_pair(string, index));
+    if (!result.second)
+      return result.first->second;
+  } else {
+    std::pair<hash_map<uintptr_t, uint32>::iterator, bool> result =
+        string_indices_.insert(
+            std::make_pair(reinterpret_cast<uintptr_t>(string), index));
+    if (!result.second)
+      return result.first->second;
+  }
+  ++num_strings_;
+  buffer_.push_back(kStringRecord);
+  AppendString(string, &buffer_);
+  return index;
+}
+
+uint32 TraceBinaryWriter::InternCategoryGroupWhileLocked(
+    const unsigned char* category_group_enabled) {
+  lock_.AssertAcquired();
+  uintptr_t key = reinterpret_cast<uintptr_t>(category_group_enabled);
+  hash_map<uintptr_t, uint32>::const_iterator it =
+      category_group_indices_.find(key);
+  if (it != category_group_indices_.end())
+    return it->second;
+  uint32 index = InternStringWhileLocked(
+      TraceLog::GetCategoryGroupName(category_group_enabled), false);
+  category_group_indices_[key] = index;
+  return index;
+}
+
+void TraceBinaryWriter::AddThreadNameWhileLocked(int thread_id,
+                                                 TimeTicks timestamp) {
+  const char* thread_name =
+      ThreadIdNameManager::GetInstance()->GetName(thread_id);
+  if (!thread_name || !*thread_name)
+    return;
+
+  const char* arg_names[] = { kThreadNameArgName };
+  const unsigned char arg_types[] = { TRACE_VALUE_TYPE_STRING };
+  TraceEvent::TraceValue value;
+  value.as_uint = 0;
+  value.as_string = thread_name;
+  const unsigned long long arg_values[] = { value.as_uint };
+  AddEventWhileLocked(thread_id, timestamp, TRACE_EVENT_PHASE_METADATA,
+                      InternStringWhileLocked(kMetadataCategoryGroup, false),
+                      kThreadNameEventName, trace_event_internal::kNoEventId,
+                      1, arg_names, arg_types, arg_values,
+                      TRACE_EVENT_FLAG_NONE);
+}
+
+void TraceBinaryWriter::AddEventWhileLocked(
+    int thread_id,
+    TimeTicks timestamp,
+    char phase,
+    uint32 category_group_index,
+    const char* name,
+    unsigned long long id,
+    int num_args,
+    const char* const arg_names[],
+    const unsigned char arg_types[],
+    const unsigned long long arg_values[],
+    unsigned char flags) {
+  lock_.AssertAcquired();
+  DCHECK_LE(num_args, kTraceMaxNumArgs);
+  num_args = std::min(num_args, kTraceMaxNumArgs);
+
+  // Strings are written before the event that refers to them.
+  bool copy = (flags & TRACE_EVENT_FLAG_COPY) != 0;
+  uint32 name_index = InternStringWhileLocked(name, copy);
+  uint32 arg_name_indices[kTraceMaxNumArgs];
+  for (int i = 0; i < num_args; ++i)
+    arg_name_indices[i] = InternStringWhileLocked(arg_names[i], copy);
+
+  buffer_.push_back(kEventRecord);
+  buffer_.push_back(phase);
+  buffer_.push_back(static_cast<char>(flags));
+  int64 timestamp_value = timestamp.ToInternalValue();
+  AppendVarint(ZigZagEncode(timestamp_value - last_timestamp_), &buffer_);
+  last_timestamp_ = timestamp_value;
+  AppendVarint(static_cast<uint32>(thread_id), &buffer_);
+  AppendVarint(category_group_index, &buffer_);
+  AppendVarint(name_index, &buffer_);
+  if (flags & TRACE_EVENT_FLAG_HAS_ID)
+    AppendVarint(id, &buffer_);
+  buffer_.push_back(static_cast<char>(num_args));
+  for (int i = 0; i < num_args; ++i) {
+    AppendVarint(arg_name_indices[i], &buffer_);
+    buffer_.push_back(static_cast<char>(arg_types[i]));
+    AppendValue(arg_types[i], arg_values[i], &buffer_);
+  }
+}
+
+bool TraceBinaryWriter::FlushWhileLocked() {
+  lock_.AssertAcquired();
+  if (!write_failed_ && !buffer_.empty()) {
+    write_failed_ =
+        fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() ||
+        fflush(file_) != 0;
+  }
+  buffer_.clear();
+  return !write_failed_;
+}
+
+bool ConvertBinaryTraceToJSON(FILE* binary_trace,
+                              const TraceLog::OutputCallback& output) {
+  return BinaryTraceConverter(binary_trace, output).Convert();
+}
+
+}  // namespace debug
+}  // namespace base
@@ -0,0 +1,138 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_DEBUG_TRACE_EVENT_BINARY_H_
+#define BASE_DEBUG_TRACE_EVENT_BINARY_H_
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+namespace debug {
+
+// Writes trace events to a file or pipe as they happen, in a compact binary
+// format, instead of collecting them in the TraceLog and converting all of
+// them to JSON on Flush(). Long traces then need neither the memory for the
+// events nor the time to build the JSON while tracing.
+//
+// Each record is a tag byte followed by variable-length integers. Category
+// groups, event names and argument names are interned: a string is written
+// once and later referred to by its index. Timestamps are deltas from the
+// previous event. ConvertBinaryTraceToJSON() turns a stream back into the
+// format of TraceLog::Flush() for trace-viewer.
+//
+// Events are received through TraceLog's event callback, so COMPLETE events
+// are written as BEGIN and END pairs, and arguments that are convertable to
+// the trace format are written as null.
+class BASE_EXPORT TraceBinaryWriter {
+ public:
+  // Writes the stream header to |file|, which must stay open for the lifetime
+  // of the writer. |file| is not closed by the writer.
+  explicit TraceBinaryWriter(FILE* file);
+
+  // Stops streaming and writes out the buffered events.
+  ~TraceBinaryWriter();
+
+  // Makes this writer receive the events of the categories matching
+  // |category_filter|. This takes over TraceLog's event callback, so only one
+  // writer can stream at a time, and nothing else can use the callback.
+  void StartStreaming(const CategoryFilter& category_filter);
+  void StopStreaming();
+
+  // Adds an event, with the arguments of TraceLog::EventCallback. May be
+  // called on any thread.
+  void AddEvent(int thread_id,
+                TimeTicks timestamp,
+                char phase,
+                const unsigned char* category_group_enabled,
+                const char* name,
+                unsigned long long id,
+                int num_args,
+                const char* const arg_names[],
+                const unsigned char arg_types[],
+                const unsigned long long arg_values[],
+                unsigned char flags);
+
+  // Writes out the buffered events. Returns false if writing to the file
+  // failed, now or before.
+  bool Flush();
+
+ private:
+  // The TraceLog::EventCallback used while streaming.
+  static void OnTraceEvent(TimeTicks timestamp,
+                           char phase,
+                           const unsigned char* category_group_enabled,
+                           const char* name,
+                           unsigned long long id,
+                           int num_args,
+                           const char* const arg_names[],
+                           const unsigned char arg_types[],
+                           const unsigned long long arg_values[],
+                           unsigned char flags);
+
+  // Returns the index of a string, writing it out the first time. Strings of
+  // events with TRACE_EVENT_FLAG_COPY are interned by value, others by
+  // address.
+  uint32 InternStringWhileLocked(const char* string, bool copy);
+  uint32 InternCategoryGroupWhileLocked(
+      const unsigned char* category_group_enabled);
+
+  // Adds the thread name metadata event for a thread seen for the first time.
+  void AddThreadNameWhileLocked(int thread_id, TimeTicks timestamp);
+
+  void AddEventWhileLocked(int thread_id,
+                           TimeTicks timestamp,
+                           char phase,
+                           uint32 category_group_index,
+                           const char* name,
+                           unsigned long long id,
+                           int num_args,
+                           const char* const arg_names[],
+                           const unsigned char arg_types[],
+                           const unsigned long long arg_values[],
+                           unsigned char flags);
+
+  bool FlushWhileLocked();
+
+  // Protects all members below from concurrent AddEvent() calls.
+  Lock lock_;
+
+  FILE* file_;
+  bool write_failed_;
+
+  // Records not written to |file_| yet.
+  std::string buffer_;
+
+  uint32 num_strings_;
+  hash_map<uintptr_t, uint32> string_indices_;
+  hash_map<std::string, uint32> copied_string_indices_;
+  hash_map<uintptr_t, uint32> category_group_indices_;
+  hash_set<int> thread_ids_;
+
+  int64 last_timestamp_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceBinaryWriter);
+};
+
+// Converts a stream written by TraceBinaryWriter into the trace format of
+// TraceLog::Flush(), passing it to |output| in batches the same way. Returns
+// false if |binary_trace| is not a valid stream, after passing on the events
+// read before the error. |output| is always run with |has_more_events| false
+// last.
+BASE_EXPORT bool ConvertBinaryTraceToJSON(
+    FILE* binary_trace,
+    const TraceLog::OutputCallback& output);
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_TRACE_EVENT_BINARY_H_
@@ -0,0 +1,278 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_event_binary.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/json/json_reader.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/platform_thread.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+class TraceBinaryTest : public testing::Test {
+ protected:
+  TraceBinaryTest() : file_(tmpfile()), num_batches_(0), done_(false) {}
+
+  virtual ~TraceBinaryTest() {
+    fclose(file_);
+  }
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(file_);
+  }
+
+  // Converts the stream written to |file_| into |events_|.
+  bool Convert() {
+    rewind(file_);
+    json_.clear();
+    bool result = ConvertBinaryTraceToJSON(
+        file_, Bind(&TraceBinaryTest::OnOutput, Unretained(this)));
+    EXPECT_TRUE(done_);
+
+    scoped_ptr<Value> root(JSONReader::Read("[" + json_ + "]"));
+    ListValue* list = NULL;
+    EXPECT_TRUE(root.get() && root->GetAsList(&list));
+    if (list)
+      list->Swap(&events_);
+    return result;
+  }
+
+  void OnOutput(const scoped_refptr<RefCountedString>& events_str,
+                bool has_more_events) {
+    EXPECT_FALSE(done_);
+    ++num_batches_;
+    done_ = !has_more_events;
+    if (!json_.empty() && !events_str->data().empty())
+      json_ += ",";
+    json_ += events_str->data();
+  }
+
+  const DictionaryValue* FindEvent(const std::string& name) {
+    for (size_t i = 0; i < events_.GetSize(); ++i) {
+      const DictionaryValue* event = NULL;
+      std::string event_name;
+      if (events_.GetDictionary(i, &event) &&
+          event->GetString("name", &event_name) && event_name == name) {
+        return event;
+      }
+    }
+    return NULL;
+  }
+
+  FILE* file_;
+  std::string json_;
+  ListValue events_;
+  int num_batches_;
+  bool done_;
+};
+
+void AddInstantEvent(TraceBinaryWriter* writer,
+                     int64 timestamp_us,
+                     const char* name) {
+  writer->AddEvent(1, TimeTicks::FromInternalValue(timestamp_us),
+                   TRACE_EVENT_PHASE_INSTANT,
+                   TraceLog::GetCategoryGroupEnabled("binary_test"), name,
+                   trace_event_internal::kNoEventId, 0, NULL, NULL, NULL,
+                   TRACE_EVENT_SCOPE_THREAD);
+}
+
+}  // namespace
+
+TEST_F(TraceBinaryTest, RoundTrip) {
+  {
+    TraceBinaryWriter writer(file_);
+    const unsigned char* category =
+        TraceLog::GetCategoryGroupEnabled("binary_test");
+
+    const char* int_arg_names[] = { "int", "uint" };
+    const unsigned char int_arg_types[] = {
+      TRACE_VALUE_TYPE_INT, TRACE_VALUE_TYPE_UINT
+    };
+    const unsigned long long int_arg_values[] = {
+      static_cast<unsigned long long>(-42), 1234567890123ULL
+    };
+    writer.AddEvent(7, TimeTicks::FromInternalValue(1000),
+                    TRACE_EVENT_PHASE_BEGIN, category, "ints",
+                    trace_event_internal::kNoEventId, 2, int_arg_names,
+                    int_arg_types, int_arg_values, TRACE_EVENT_FLAG_NONE);
+
+    TraceEvent::TraceValue values[2];
+    values[0].as_uint = 0;
+    values[0].as_bool = true;
+    values[1].as_double = 2.5;
+    const char* other_arg_names[] = { "bool", "double" };
+    const unsigned char other_arg_types[] = {
+      TRACE_VALUE_TYPE_BOOL, TRACE_VALUE_TYPE_DOUBLE
+    };
+    const unsigned long long other_arg_values[] = {
+      values[0].as_uint, values[1].as_uint
+    };
+    writer.AddEvent(7, TimeTicks::FromInternalValue(900),
+                    TRACE_EVENT_PHASE_ASYNC_BEGIN, category, "others",
+                    0x1234, 2, other_arg_names, other_arg_types,
+                    other_arg_values, TRACE_EVENT_FLAG_HAS_ID);
+
+    std::string copied_name("copied");
+    values[0].as_string = "a \"quoted\" string";
+    const char* copy_arg_names[] = { copied_name.c_str() };
+    const unsigned char copy_arg_types[] = { TRACE_VALUE_TYPE_COPY_STRING };
+    const unsigned long long copy_arg_values[] = { values[0].as_uint };
+    writer.AddEvent(8, TimeTicks::FromInternalValue(2000),
+                    TRACE_EVENT_PHASE_INSTANT, category, copied_name.c_str(),
+                    trace_event_internal::kNoEventId, 1, copy_arg_names,
+                    copy_arg_types, copy_arg_values,
+                    TRACE_EVENT_FLAG_COPY | TRACE_EVENT_SCOPE_PROCESS);
+    EXPECT_TRUE(writer.Flush());
+  }
+  EXPECT_TRUE(Convert());
+  ASSERT_EQ(3u, events_.GetSize());
+
+  const DictionaryValue* ints = FindEvent("ints");
+  ASSERT_TRUE(ints);
+  std::string string_value;
+  int int_value;
+  double double_value;
+  bool bool_value;
+  EXPECT_TRUE(ints->GetString("cat", &string_value));
+  EXPECT_EQ("binary_test", string_value);
+  EXPECT_TRUE(ints->GetString("ph", &string_value));
+  EXPECT_EQ("B", string_value);
+  EXPECT_TRUE(ints->GetInteger("tid", &int_value));
+  EXPECT_EQ(7, int_value);
+  EXPECT_TRUE(ints->GetInteger("ts", &int_value));
+  EXPECT_EQ(1000, int_value);
+  EXPECT_TRUE(ints->GetInteger("args.int", &int_value));
+  EXPECT_EQ(-42, int_value);
+  EXPECT_TRUE(ints->GetDouble("args.uint", &double_value));
+  EXPECT_EQ(1234567890123.0, double_value);
+  EXPECT_FALSE(ints->HasKey("id"));
+
+  const DictionaryValue* others = FindEvent("others");
+  ASSERT_TRUE(others);
+  EXPECT_TRUE(others->GetInteger("ts", &int_value));
+  EXPECT_EQ(900, int_value);
+  EXPECT_TRUE(others->GetString("id", &string_value));
+  EXPECT_EQ("0x1234", string_value);
+  EXPECT_TRUE(others->GetBoolean("args.bool", &bool_value));
+  EXPECT_TRUE(bool_value);
+  EXPECT_TRUE(others->GetDouble("args.double", &double_value));
+  EXPECT_EQ(2.5, double_value);
+
+  const DictionaryValue* copied = FindEvent("copied");
+  ASSERT_TRUE(copied);
+  EXPECT_TRUE(copied->GetInteger("ts", &int_value));
+  EXPECT_EQ(2000, int_value);
+  EXPECT_TRUE(copied->GetString("s", &string_value));
+  EXPECT_EQ("p", string_value);
+  EXPECT_TRUE(copied->GetString("args.copied", &string_value));
+  EXPECT_EQ("a \"quoted\" string", string_value);
+}
+
+TEST_F(TraceBinaryTest, Streaming) {
+  {
+    TraceBinaryWriter writer(file_);
+    writer.StartStreaming(CategoryFilter("binary_test"));
+    {
+      TRACE_EVENT0("binary_test", "scoped");
+      TRACE_EVENT_INSTANT1("binary_test", "instant", TRACE_EVENT_SCOPE_THREAD,
+                           "value", 5);
+      TRACE_EVENT_INSTANT0("not_binary_test", "filtered",
+                           TRACE_EVENT_SCOPE_THREAD);
+    }
+    writer.StopStreaming();
+    TRACE_EVENT_INSTANT0("binary_test", "stopped", TRACE_EVENT_SCOPE_THREAD);
+  }
+  EXPECT_TRUE(Convert());
+  EXPECT_FALSE(FindEvent("filtered"));
+  EXPECT_FALSE(FindEvent("stopped"));
+
+  const DictionaryValue* instant = FindEvent("instant");
+  ASSERT_TRUE(instant);
+  int value;
+  EXPECT_TRUE(instant->GetInteger("args.value", &value));
+  EXPECT_EQ(5, value);
+  EXPECT_TRUE(instant->GetInteger("tid", &value));
+  EXPECT_EQ(static_cast<int>(PlatformThread::CurrentId()), value);
+
+  // The scoped event is reported as a begin and an end event.
+  int num_scoped = 0;
+  for (size_t i = 0; i < events_.GetSize(); ++i) {
+    const DictionaryValue* event = NULL;
+    std::string name;
+    if (events_.GetDictionary(i, &event) &&
+        event->GetString("name", &name) && name == "scoped") {
+      ++num_scoped;
+    }
+  }
+  EXPECT_EQ(2, num_scoped);
+}
+
+TEST_F(TraceBinaryTest, InternsStrings) {
+  TraceBinaryWriter writer(file_);
+  EXPECT_TRUE(writer.Flush());
+  long header_size = ftell(file_);
+  AddInstantEvent(&writer, 10, "interned");
+  EXPECT_TRUE(writer.Flush());
+  long first_size = ftell(file_) - header_size;
+  AddInstantEvent(&writer, 20, "interned");
+  EXPECT_TRUE(writer.Flush());
+  long second_size = ftell(file_) - header_size - first_size;
+  EXPECT_LT(second_size, first_size);
+  EXPECT_LT(second_size, 10);
+
+  EXPECT_TRUE(Convert());
+  EXPECT_EQ(2u, events_.GetSize());
+}
+
+TEST_F(TraceBinaryTest, Batches) {
+  {
+    TraceBinaryWriter writer(file_);
+    for (int i = 0; i < 2500; ++i)
+      AddInstantEvent(&writer, i, "batched");
+  }
+  EXPECT_TRUE(Convert());
+  EXPECT_EQ(2500u, events_.GetSize());
+  EXPECT_EQ(3, num_batches_);
+}
+
+TEST_F(TraceBinaryTest, InvalidStream) {
+  fputs("not a trace", file_);
+  EXPECT_FALSE(Convert());
+  EXPECT_EQ(0u, events_.GetSize());
+}
+
+TEST_F(TraceBinaryTest, TruncatedStream) {
+  {
+    TraceBinaryWriter writer(file_);
+    AddInstantEvent(&writer, 10, "first");
+    AddInstantEvent(&writer, 20, "second");
+  }
+  // Cut the last event short.
+  std::string stream(ftell(file_), '\0');
+  rewind(file_);
+  ASSERT_EQ(stream.size(), fread(&stream[0], 1, stream.size(), file_));
+  fclose(file_);
+  file_ = tmpfile();
+  ASSERT_TRUE(file_);
+  fwrite(stream.data(), 1, stream.size() - 2, file_);
+
+  EXPECT_FALSE(Convert());
+  EXPECT_TRUE(FindEvent("first"));
+  EXPECT_FALSE(FindEvent("second"));
+}
+
+}  // namespace debug
+}  // namespace base
@@ -62,6 +62,10 @@ const int kOverheadReportThresholdInMicroseconds = 50;
 // before throwing them away.
 const size_t kTraceBufferChunkSize = TraceBufferChunk::kTraceBufferChunkSize;
 const size_t kTraceEventVectorBufferChunks = 256000 / kTraceBufferChunkSize;
+// Room past the capacity of TraceBufferVector for the metadata events and the
+// chunks taken while the buffer fills up, before tracing is disabled.
+const size_t kTraceEventVectorBufferHeadroomChunks =
+    kTraceEventVectorBufferChunks / 16;
 const size_t kTraceEventRingBufferChunks = kTraceEventVectorBufferChunks / 4;
 const size_t kTraceEventBatchChunks = 1000 / kTraceBufferChunkSize;
 // Can store results for 30 seconds with 1 ms sampling interval.
@@ -162,6 +166,10 @@ class TraceBufferRingBuffer : public TraceBuffer {
     queue_tail_ = NextQueueIndex(queue_tail_);
   }
 
+  virtual bool IsLockFree() const OVERRIDE {
+    return false;
+  }
+
   virtual bool IsFull() const OVERRIDE {
     return false;
   }
@@ -231,6 +239,7 @@ class TraceBufferRingBuffer : public TraceBuffer {
                              scoped_ptr<TraceBufferChunk>) OVERRIDE {
       NOTIMPLEMENTED();
     }
+    virtual bool IsLockFree() const OVERRIDE { return false; }
     virtual bool IsFull() const OVERRIDE { return false; }
     virtual size_t Size() const OVERRIDE { return 0; }
     virtual size_t Capacity() const OVERRIDE { return 0; }
@@ -284,12 +293,21 @@ class TraceBufferRingBuffer : public TraceBuffer {
   DISALLOW_COPY_AND_ASSIGN(TraceBufferRingBuffer);
 };
 
+// Chunks are put in a fixed array of slots which are taken by atomically
+// incrementing the chunk count and filled once when a chunk is returned, so
+// the buffer is lock-free. Returned chunks are never reused.
 class TraceBufferVector : public TraceBuffer {
  public:
   TraceBufferVector()
-      : in_flight_chunk_count_(0),
+      : chunks_(new subtle::AtomicWord[kMaxChunks]),
+        chunk_count_(0),
         current_iteration_index_(0) {
-    chunks_.reserve(kTraceEventVectorBufferChunks);
+    memset(chunks_.get(), 0, kMaxChunks * sizeof(subtle::AtomicWord));
+  }
+
+  virtual ~TraceBufferVector() {
+    for (size_t i = 0; i < ChunkCount(); ++i)
+      delete ChunkAt(i);
   }
 
   virtual scoped_ptr<TraceBufferChunk> GetChunk(size_t* index) OVERRIDE {
@@ -297,9 +315,18 @@ class TraceBufferVector : public TraceBuffer {
     // AddMetadataEventsWhileLocked(). We can not DECHECK(!IsFull()) because we
     // have to add the metadata events and flush thread-local buffers even if
     // the buffer is full.
-    *index = chunks_.size();
-    chunks_.push_back(NULL);  // Put NULL in the slot of a in-flight chunk.
-    ++in_flight_chunk_count_;
+    subtle::Atomic32 count = subtle::NoBarrier_Load(&chunk_count_);
+    for (;;) {
+      if (static_cast<size_t>(count) >= kMaxChunks)
+        return scoped_ptr<TraceBufferChunk>();
+      subtle::Atomic32 previous_count =
+          subtle::NoBarrier_CompareAndSwap(&chunk_count_, count, count + 1);
+      if (previous_count == count)
+        break;
+      count = previous_count;
+    }
+    // The slot of an in-flight chunk stays NULL.
+    *index = static_cast<size_t>(count);
     // + 1 because zero chunk_seq is not allowed.
     return scoped_ptr<TraceBufferChunk>(
         new TraceBufferChunk(static_cast<uint32>(*index) + 1));
@@ -307,20 +334,23 @@ class TraceBufferVector : public TraceBuffer {
 
   virtual void ReturnChunk(size_t index,
                            scoped_ptr<TraceBufferChunk> chunk) OVERRIDE {
-    DCHECK_GT(in_flight_chunk_count_, 0u);
-    DCHECK_LT(index, chunks_.size());
-    DCHECK(!chunks_[index]);
-    --in_flight_chunk_count_;
-    chunks_[index] = chunk.release();
+    DCHECK_LT(index, ChunkCount());
+    DCHECK(!ChunkAt(index));
+    subtle::Release_Store(&chunks_[index],
+                          reinterpret_cast<subtle::AtomicWord>(chunk.release()));
+  }
+
+  virtual bool IsLockFree() const OVERRIDE {
+    return true;
   }
 
   virtual bool IsFull() const OVERRIDE {
-    return chunks_.size() >= kTraceEventVectorBufferChunks;
+    return ChunkCount() >= kTraceEventVectorBufferChunks;
   }
 
   virtual size_t Size() const OVERRIDE {
     // This is approximate because not all of the chunks are full.
-    return chunks_.size() * kTraceBufferChunkSize;
+    return ChunkCount() * kTraceBufferChunkSize;
   }
 
   virtual size_t Capacity() const OVERRIDE {
@@ -328,18 +358,18 @@ class TraceBufferVector : public TraceBuffer {
   }
 
   virtual TraceEvent* GetEventByHandle(TraceEventHandle handle) OVERRIDE {
-    if (handle.chunk_index >= chunks_.size())
+    if (handle.chunk_index >= ChunkCount())
       return NULL;
-    TraceBufferChunk* chunk = chunks_[handle.chunk_index];
+    TraceBufferChunk* chunk = ChunkAt(handle.chunk_index);
     if (!chunk || chunk->seq() != handle.chunk_seq)
       return NULL;
     return chunk->GetEventAt(handle.event_index);
   }
 
   virtual const TraceBufferChunk* NextChunk() OVERRIDE {
-    while (current_iteration_index_ < chunks_.size()) {
+    while (current_iteration_index_ < ChunkCount()) {
       // Skip in-flight chunks.
-      const TraceBufferChunk* chunk = chunks_[current_iteration_index_++];
+      const TraceBufferChunk* chunk = ChunkAt(current_iteration_index_++);
       if (chunk)
         return chunk;
     }
@@ -352,9 +382,22 @@ class TraceBufferVector : public TraceBuffer {
   }
 
  private:
-  size_t in_flight_chunk_count_;
+  static const size_t kMaxChunks =
+      kTraceEventVectorBufferChunks + kTraceEventVectorBufferHeadroomChunks;
+
+  size_t ChunkCount() const {
+    return static_cast<size_t>(subtle::Acquire_Load(&chunk_count_));
+  }
+
+  TraceBufferChunk* ChunkAt(size_t index) const {
+    return reinterpret_cast<TraceBufferChunk*>(
+        subtle::Acquire_Load(&chunks_[index]));
+  }
+
+  // Each slot holds a TraceBufferChunk* once the chunk is returned.
+  scoped_ptr<subtle::AtomicWord[]> chunks_;
+  subtle::Atomic32 chunk_count_;
   size_t current_iteration_index_;
-  ScopedVector<TraceBufferChunk> chunks_;
 
   DISALLOW_COPY_AND_ASSIGN(TraceBufferVector);
 };
@@ -996,6 +1039,16 @@ class TraceLog::ThreadLocalEventBuffer
 
   void FlushWhileLocked();
 
+  // Without taking TraceLog's lock, get a new |chunk_| from or return it to
+  // |lock_free_buffer_|. A returned chunk is dropped if the buffer is gone.
+  void GetChunkWithoutLock();
+  void ReturnChunkWithoutLock();
+
+  // Brackets the use of |lock_free_buffer_|. Returns false if the buffer may
+  // have been deleted, in which case it must not be used.
+  bool BeginLockFreeHandoff();
+  void EndLockFreeHandoff();
+
   void CheckThisIsCurrentBuffer() const {
     DCHECK(trace_log_->thread_local_event_buffer_.Get() == this);
   }
@@ -1003,6 +1056,8 @@ class TraceLog::ThreadLocalEventBuffer
   // Since TraceLog is a leaky singleton, trace_log_ will always be valid
   // as long as the thread exists.
   TraceLog* trace_log_;
+  // The trace buffer of |generation_| if it is lock-free, otherwise NULL.
+  TraceBuffer* lock_free_buffer_;
   scoped_ptr<TraceBufferChunk> chunk_;
   size_t chunk_index_;
   int event_count_;
@@ -1014,6 +1069,7 @@ class TraceLog::ThreadLocalEventBuffer
 
 TraceLog::ThreadLocalEventBuffer::ThreadLocalEventBuffer(TraceLog* trace_log)
     : trace_log_(trace_log),
+      lock_free_buffer_(NULL),
       chunk_index_(0),
       event_count_(0),
       generation_(trace_log->generation()) {
@@ -1024,6 +1080,11 @@ TraceLog::ThreadLocalEventBuffer::ThreadLocalEventBuffer(TraceLog* trace_log)
 
   AutoLock lock(trace_log->lock_);
   trace_log->thread_message_loops_.insert(message_loop);
+  // If the generation changed since, this buffer is deleted before use.
+  if (trace_log->CheckGeneration(generation_) &&
+      trace_log->logged_events_->IsLockFree()) {
+    lock_free_buffer_ = trace_log->logged_events_.get();
+  }
 }
 
 TraceLog::ThreadLocalEventBuffer::~ThreadLocalEventBuffer() {
@@ -1054,14 +1115,22 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
   CheckThisIsCurrentBuffer();
 
   if (chunk_ && chunk_->IsFull()) {
-    AutoLock lock(trace_log_->lock_);
-    FlushWhileLocked();
+    if (lock_free_buffer_) {
+      ReturnChunkWithoutLock();
+    } else {
+      AutoLock lock(trace_log_->lock_);
+      FlushWhileLocked();
+    }
     chunk_.reset();
   }
   if (!chunk_) {
-    AutoLock lock(trace_log_->lock_);
-    chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
-    trace_log_->CheckIfBufferIsFullWhileLocked();
+    if (lock_free_buffer_) {
+      GetChunkWithoutLock();
+    } else {
+      AutoLock lock(trace_log_->lock_);
+      chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
+      trace_log_->CheckIfBufferIsFullWhileLocked();
+    }
   }
   if (!chunk_)
     return NULL;
@@ -1118,6 +1187,42 @@ void TraceLog::ThreadLocalEventBuffer::FlushWhileLocked() {
   // find the generation mismatch and delete this buffer soon.
 }
 
+void TraceLog::ThreadLocalEventBuffer::GetChunkWithoutLock() {
+  bool buffer_is_full = false;
+  if (BeginLockFreeHandoff()) {
+    chunk_ = lock_free_buffer_->GetChunk(&chunk_index_);
+    buffer_is_full = lock_free_buffer_->IsFull();
+    EndLockFreeHandoff();
+  }
+  // This happens once per thread at most before tracing is disabled.
+  if (buffer_is_full) {
+    AutoLock lock(trace_log_->lock_);
+    trace_log_->CheckIfBufferIsFullWhileLocked();
+  }
+}
+
+void TraceLog::ThreadLocalEventBuffer::ReturnChunkWithoutLock() {
+  if (BeginLockFreeHandoff()) {
+    lock_free_buffer_->ReturnChunk(chunk_index_, chunk_.Pass());
+    EndLockFreeHandoff();
+  }
+}
+
+bool TraceLog::ThreadLocalEventBuffer::BeginLockFreeHandoff() {
+  // Pairs with UseNextTraceBuffer(), which changes the generation before
+  // waiting for |lock_free_chunk_handoffs_| to drop to zero: either this sees
+  // the new generation, or the buffer is kept until this is done with it.
+  subtle::Barrier_AtomicIncrement(&trace_log_->lock_free_chunk_handoffs_, 1);
+  if (trace_log_->CheckGeneration(generation_))
+    return true;
+  EndLockFreeHandoff();
+  return false;
+}
+
+void TraceLog::ThreadLocalEventBuffer::EndLockFreeHandoff() {
+  subtle::Barrier_AtomicIncrement(&trace_log_->lock_free_chunk_handoffs_, -1);
+}
+
 // static
 TraceLog* TraceLog::GetInstance() {
   return Singleton<TraceLog, LeakySingletonTraits<TraceLog> >::get();
@@ -1138,7 +1243,8 @@ TraceLog::TraceLog()
       event_callback_category_filter_(
           CategoryFilter::kDefaultCategoryFilterString),
       thread_shared_chunk_index_(0),
-      generation_(0) {
+      generation_(0),
+      lock_free_chunk_handoffs_(0) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
   // traced or not, so we allow races on the enabled flag to keep the trace
@@ -1709,12 +1815,23 @@ void TraceLog::FlushButLeaveBufferIntact(
 }
 
 void TraceLog::UseNextTraceBuffer() {
+  // Thread-local event buffers stop using the lock-free buffer of the previous
+  // generation once they see the new one. Wait for those already using it to
+  // finish before it is deleted or, in FinishFlush(), read.
+  subtle::Barrier_AtomicIncrement(&generation_, 1);
+  WaitForLockFreeChunkHandoffsWhileLocked();
   logged_events_.reset(CreateTraceBuffer());
-  subtle::NoBarrier_AtomicIncrement(&generation_, 1);
   thread_shared_chunk_.reset();
   thread_shared_chunk_index_ = 0;
 }
 
+void TraceLog::WaitForLockFreeChunkHandoffsWhileLocked() {
+  lock_.AssertAcquired();
+  // A handoff is a few instructions long and never waits for anything.
+  while (subtle::Acquire_Load(&lock_free_chunk_handoffs_))
+    PlatformThread::YieldCurrentThread();
+}
+
 TraceEventHandle TraceLog::AddTraceEvent(
     char phase,
     const unsigned char* category_group_enabled,
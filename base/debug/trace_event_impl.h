@@ -223,6 +223,11 @@ class BASE_EXPORT TraceBuffer {
   virtual void ReturnChunk(size_t index,
                            scoped_ptr<TraceBufferChunk> chunk) = 0;
 
+  // Returns true if GetChunk(), ReturnChunk(), IsFull() and GetEventByHandle()
+  // may be called concurrently from several threads, without TraceLog's lock.
+  // The thread-local event buffers then hand chunks over without locking.
+  virtual bool IsLockFree() const = 0;
+
   virtual bool IsFull() const = 0;
   virtual size_t Size() const = 0;
   virtual size_t Capacity() const = 0;
@@ -604,6 +609,8 @@ class BASE_EXPORT TraceLog {
                            TraceBufferRingBufferHalfIteration);
   FRIEND_TEST_ALL_PREFIXES(TraceEventTestFixture,
                            TraceBufferRingBufferFullIteration);
+  FRIEND_TEST_ALL_PREFIXES(TraceEventTestFixture,
+                           TraceBufferVectorConcurrentGetReturnChunk);
 
   // This allows constructor and destructor to be private and usable only
   // by the Singleton class.
@@ -659,6 +666,9 @@ class BASE_EXPORT TraceLog {
     return generation == this->generation();
   }
   void UseNextTraceBuffer();
+  // Waits for the thread-local event buffers that are handing chunks over to
+  // the trace buffer of a previous generation without the lock to finish.
+  void WaitForLockFreeChunkHandoffsWhileLocked();
 
   TimeTicks OffsetNow() const {
     return OffsetTimestamp(TimeTicks::NowFromSystemTraceTime());
@@ -731,6 +741,11 @@ class BASE_EXPORT TraceLog {
   scoped_refptr<MessageLoopProxy> flush_message_loop_proxy_;
   subtle::AtomicWord generation_;
 
+  // The number of thread-local event buffers getting or returning a chunk of
+  // a lock-free trace buffer. A trace buffer is not deleted or read for a
+  // flush before this drops to zero after |generation_| changes.
+  subtle::Atomic32 lock_free_chunk_handoffs_;
+
   DISALLOW_COPY_AND_ASSIGN(TraceLog);
 };
 
@@ -4,15 +4,22 @@
 
 #include "base/debug/trace_event_memory.h"
 
+#include <math.h>
+
+#include "base/atomicops.h"
 #include "base/debug/leak_annotations.h"
 #include "base/debug/trace_event.h"
+#include "base/json/string_escape.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread_local_storage.h"
+#include "base/time/time.h"
 
 namespace base {
 namespace debug {
@@ -48,7 +55,10 @@ class MemoryDumpHolder : public base::debug::ConvertableToTraceFormat {
 /////////////////////////////////////////////////////////////////////////////
 // Records a stack of TRACE_MEMORY events. One per thread is required.
 struct TraceMemoryStack {
-  TraceMemoryStack() : scope_depth(0) {
+  TraceMemoryStack()
+      : scope_depth(0),
+        bytes_until_sample(0),
+        random_state(0) {
     memset(scope_data, 0, kMaxScopeDepth * sizeof(scope_data[0]));
   }
 
@@ -59,6 +69,14 @@ struct TraceMemoryStack {
 
   // Stack of categories and names.
   ScopedTraceMemory::ScopeData scope_data[kMaxScopeDepth];
+
+  // Bytes left to allocate on this thread before TraceMemorySampler takes the
+  // next sample.
+  int64 bytes_until_sample;
+
+  // State of the random number generator for the sampling intervals, or 0 if
+  // not seeded yet.
+  uint64 random_state;
 };
 
 // Pointer to a TraceMemoryStack per thread.
@@ -139,6 +157,316 @@ int GetPseudoStack(int skip_count_ignored, void** stack_out) {
   return static_cast<int>(count * 2);
 }
 
+// Guards |g_pseudo_stack_users|.
+LazyInstance<Lock>::Leaky g_pseudo_stack_lock = LAZY_INSTANCE_INITIALIZER;
+
+// Number of TraceMemoryController and TraceMemorySampler objects that need
+// the pseudo-stacks of TRACE_EVENT scopes to be recorded.
+int g_pseudo_stack_users = 0;
+
+// Starts recording pseudo-stacks for one more user. Returns false if the
+// thread-local storage could not be initialized.
+bool AcquirePseudoStacks() {
+  AutoLock lock(g_pseudo_stack_lock.Get());
+  if (g_pseudo_stack_users == 0) {
+    if (!InitThreadLocalStorage())
+      return false;
+    ScopedTraceMemory::set_enabled(true);
+  }
+  g_pseudo_stack_users++;
+  return true;
+}
+
+// Stops recording pseudo-stacks once the last user is done with them.
+void ReleasePseudoStacks() {
+  AutoLock lock(g_pseudo_stack_lock.Get());
+  DCHECK_GT(g_pseudo_stack_users, 0);
+  if (--g_pseudo_stack_users > 0)
+    return;
+  ScopedTraceMemory::set_enabled(false);
+  CleanupThreadLocalStorage();
+}
+
+// Returns the name shown by the trace viewer for a TRACE_EVENT scope.
+std::string GetTraceNameForScope(const char* category, const char* name) {
+  // TODO(jamescook): Report the trace category and name separately to the
+  // trace viewer and allow it to decide what decorations to apply. For now
+  // just hard-code a decoration for posted tasks (toplevel).
+  std::string trace_string(name);
+  if (!strcmp(category, "toplevel"))
+    trace_string.append("->PostTask");
+  return trace_string;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Allocation sampling. The allocator hooks below run inside malloc() and
+// free() on every thread, so they must not allocate memory themselves. All
+// their storage is allocated up front, and samples that do not fit are
+// dropped.
+
+const char kSamplingCategory[] = TRACE_DISABLED_BY_DEFAULT("memory.sampling");
+const char kAllocationEventName[] = "memory::Allocation";
+const char kFreeEventName[] = "memory::Free";
+
+// Number of samples that can be taken between two recordings of the samples
+// into the TraceLog.
+const size_t kMaxPendingSamples = 1024;
+
+// Size of the hash table of the sampled allocations that are not freed yet.
+// Must be a power of two. Allocations sampled while the table is 3/4 full have
+// their free go unreported.
+const size_t kLiveSampleTableSize = 16384;
+const size_t kMaxLiveSamples = kLiveSampleTableSize / 4 * 3;
+
+struct AllocationSample {
+  bool is_free;
+  uintptr_t address;
+  size_t size;
+  int64 timestamp;
+  PlatformThreadId thread_id;
+
+  // Pseudo-stack of the allocation, as for GetPseudoStack(). Empty for frees.
+  size_t stack_depth;
+  ScopedTraceMemory::ScopeData stack[kMaxScopeDepth];
+};
+
+struct LiveSample {
+  uintptr_t address;  // 0 for empty slots.
+  size_t size;
+};
+
+struct SamplerState {
+  // The hooks append to one buffer while RecordSamples() reads the other.
+  AllocationSample pending_samples[2][kMaxPendingSamples];
+  size_t pending_buffer;
+  size_t pending_sample_count;
+
+  // Open addressing with linear probing.
+  LiveSample live_samples[kLiveSampleTableSize];
+  size_t live_sample_count;
+
+  // Number of live samples per home slot of |live_samples|, so that frees of
+  // unsampled allocations can be skipped without taking the lock.
+  subtle::Atomic32 live_home_counts[kLiveSampleTableSize];
+};
+
+// Guards |g_sampler_state| other than |live_home_counts|, and
+// |g_active_sampler|.
+LazyInstance<Lock>::Leaky g_sampler_lock = LAZY_INSTANCE_INITIALIZER;
+
+// Allocated by the first sampler to start sampling and never freed, since an
+// allocator hook may still be running on another thread after the hooks are
+// removed.
+SamplerState* g_sampler_state = NULL;
+
+// The sampler that is sampling, if any.
+TraceMemorySampler* g_active_sampler = NULL;
+
+// Whether the hooks take samples, and the mean sampling interval.
+subtle::Atomic32 g_sampling = 0;
+subtle::AtomicWord g_mean_bytes_between_samples = 0;
+
+size_t GetLiveSampleHomeSlot(uintptr_t address) {
+  // Allocations are at least 8-byte aligned, so leave the low bits out of the
+  // hash.
+  uint64 hash = static_cast<uint64>(address >> 3) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<size_t>(hash >> 32) & (kLiveSampleTableSize - 1);
+}
+
+// Must be called with |g_sampler_lock| held.
+void AddLiveSample(uintptr_t address, size_t size) {
+  SamplerState* state = g_sampler_state;
+  if (state->live_sample_count >= kMaxLiveSamples)
+    return;
+  const size_t home = GetLiveSampleHomeSlot(address);
+  size_t slot = home;
+  while (state->live_samples[slot].address &&
+         state->live_samples[slot].address != address) {
+    slot = (slot + 1) & (kLiveSampleTableSize - 1);
+  }
+  if (state->live_samples[slot].address) {
+    // The free of a previous allocation at |address| was missed.
+    state->live_samples[slot].size = size;
+    return;
+  }
+  state->live_samples[slot].address = address;
+  state->live_samples[slot].size = size;
+  state->live_sample_count++;
+  subtle::NoBarrier_AtomicIncrement(&state->live_home_counts[home], 1);
+}
+
+// Removes |address| from the live samples and returns its size in |size|.
+// Returns false if |address| was not sampled. Must be called with
+// |g_sampler_lock| held.
+bool RemoveLiveSample(uintptr_t address, size_t* size) {
+  SamplerState* state = g_sampler_state;
+  const size_t home = GetLiveSampleHomeSlot(address);
+  size_t slot = home;
+  while (state->live_samples[slot].address != address) {
+    if (!state->live_samples[slot].address)
+      return false;
+    slot = (slot + 1) & (kLiveSampleTableSize - 1);
+  }
+  *size = state->live_samples[slot].size;
+  state->live_sample_count--;
+  subtle::NoBarrier_AtomicIncrement(&state->live_home_counts[home], -1);
+
+  // Shift back the entries of the probe sequence that follows, so that no
+  // lookup stops early at the emptied slot.
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & (kLiveSampleTableSize - 1);
+       state->live_samples[next].address;
+       next = (next + 1) & (kLiveSampleTableSize - 1)) {
+    const size_t next_home =
+        GetLiveSampleHomeSlot(state->live_samples[next].address);
+    // Move the entry unless its home slot lies cyclically in (hole, next].
+    const size_t distance_to_home =
+        (next - next_home) & (kLiveSampleTableSize - 1);
+    const size_t distance_to_hole = (next - hole) & (kLiveSampleTableSize - 1);
+    if (distance_to_home >= distance_to_hole) {
+      state->live_samples[hole] = state->live_samples[next];
+      hole = next;
+    }
+  }
+  state->live_samples[hole].address = 0;
+  state->live_samples[hole].size = 0;
+  return true;
+}
+
+// Appends a sample for RecordSamples(). |stack| is NULL for frees. Must be
+// called with |g_sampler_lock| held.
+void AppendPendingSample(bool is_free,
+                         uintptr_t address,
+                         size_t size,
+                         const TraceMemoryStack* stack) {
+  SamplerState* state = g_sampler_state;
+  if (state->pending_sample_count >= kMaxPendingSamples)
+    return;
+  AllocationSample* sample =
+      &state->pending_samples[state->pending_buffer]
+                             [state->pending_sample_count++];
+  sample->is_free = is_free;
+  sample->address = address;
+  sample->size = size;
+  sample->timestamp = TimeTicks::NowFromSystemTraceTime().ToInternalValue();
+  sample->thread_id = PlatformThread::CurrentId();
+  sample->stack_depth =
+      stack ? std::min(stack->scope_depth, kMaxScopeDepth) : 0;
+  if (sample->stack_depth) {
+    memcpy(sample->stack, stack->scope_data,
+           sample->stack_depth * sizeof(stack->scope_data[0]));
+  }
+}
+
+// Returns the number of bytes to allocate until the next sample, drawn from
+// an exponential distribution so that samples form a Poisson process over the
+// bytes allocated.
+int64 GetNextSampleInterval(TraceMemoryStack* stack) {
+  // xorshift64*, seeded per thread.
+  uint64 x = stack->random_state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  stack->random_state = x;
+  // A uniform value in (0, 1].
+  double uniform = (static_cast<double>((x * 2685821657736338717ULL) >> 11) +
+                    1.0) / 9007199254740992.0;
+  double mean = static_cast<double>(
+      subtle::NoBarrier_Load(&g_mean_bytes_between_samples));
+  return static_cast<int64>(-log(uniform) * mean) + 1;
+}
+
+// Replaces MallocHook_NewHook. Only samples threads that have a pseudo-stack,
+// since creating one here would allocate.
+void SampleNewHook(const void* ptr, size_t size) {
+  if (!subtle::Acquire_Load(&g_sampling) || !ptr ||
+      !tls_trace_memory_stack.initialized()) {
+    return;
+  }
+  TraceMemoryStack* stack =
+      static_cast<TraceMemoryStack*>(tls_trace_memory_stack.Get());
+  if (!stack)
+    return;
+  if (!stack->random_state) {
+    stack->random_state =
+        (static_cast<uint64>(reinterpret_cast<uintptr_t>(stack)) ^
+         static_cast<uint64>(TimeTicks::Now().ToInternalValue()) ^
+         (static_cast<uint64>(PlatformThread::CurrentId()) << 32)) | 1;
+    stack->bytes_until_sample = GetNextSampleInterval(stack);
+  }
+  stack->bytes_until_sample -= static_cast<int64>(size);
+  if (stack->bytes_until_sample > 0)
+    return;
+  stack->bytes_until_sample = GetNextSampleInterval(stack);
+
+  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  AutoLock lock(g_sampler_lock.Get());
+  AddLiveSample(address, size);
+  AppendPendingSample(false, address, size, stack);
+}
+
+// Replaces MallocHook_DeleteHook.
+void SampleDeleteHook(const void* ptr) {
+  if (!subtle::Acquire_Load(&g_sampling) || !ptr)
+    return;
+  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  if (!subtle::NoBarrier_Load(
+          &g_sampler_state->live_home_counts[GetLiveSampleHomeSlot(address)])) {
+    return;
+  }
+  AutoLock lock(g_sampler_lock.Get());
+  size_t size = 0;
+  if (RemoveLiveSample(address, &size))
+    AppendPendingSample(true, address, size, NULL);
+}
+
+// Holds the pseudo-stack of an allocation sample until the tracing system
+// serializes it, as a list of trace names from the outermost scope in.
+class SampleStackHolder : public ConvertableToTraceFormat {
+ public:
+  explicit SampleStackHolder(const AllocationSample& sample)
+      : stack_(sample.stack, sample.stack + sample.stack_depth) {
+  }
+
+  // base::debug::ConvertableToTraceFormat overrides:
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    out->append("[");
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      if (i > 0)
+        out->append(",");
+      EscapeJSONString(
+          GetTraceNameForScope(stack_[i].category, stack_[i].name), true, out);
+    }
+    out->append("]");
+  }
+
+ private:
+  virtual ~SampleStackHolder() {}
+
+  std::vector<ScopedTraceMemory::ScopeData> stack_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampleStackHolder);
+};
+
+void AddSampleEvent(const unsigned char* category_group_enabled,
+                    const AllocationSample& sample) {
+  TimeTicks timestamp = TimeTicks::FromInternalValue(sample.timestamp);
+  int thread_id = static_cast<int>(sample.thread_id);
+  unsigned char flags = TRACE_EVENT_FLAG_HAS_ID | TRACE_EVENT_FLAG_MANGLE_ID;
+  uint64 size = sample.size;
+  if (sample.is_free) {
+    trace_event_internal::AddTraceEventWithThreadIdAndTimestamp(
+        TRACE_EVENT_PHASE_SAMPLE, category_group_enabled, kFreeEventName,
+        sample.address, thread_id, timestamp, flags, "size", size);
+    return;
+  }
+  scoped_refptr<ConvertableToTraceFormat> stack(new SampleStackHolder(sample));
+  trace_event_internal::AddTraceEventWithThreadIdAndTimestamp(
+      TRACE_EVENT_PHASE_SAMPLE, category_group_enabled, kAllocationEventName,
+      sample.address, thread_id, timestamp, flags, "size", size,
+      "stack", stack);
+}
+
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////////////
@@ -196,9 +524,8 @@ void TraceMemoryController::StartProfiling() {
   if (dump_timer_.IsRunning())
     return;
   DVLOG(1) << "Starting trace memory";
-  if (!InitThreadLocalStorage())
+  if (!AcquirePseudoStacks())
     return;
-  ScopedTraceMemory::set_enabled(true);
   // Call ::HeapProfilerWithPseudoStackStart().
   heap_profiler_start_function_(&GetPseudoStack);
   const int kDumpIntervalSeconds = 5;
@@ -231,8 +558,7 @@ void TraceMemoryController::StopProfiling() {
     return;
   DVLOG(1) << "Stopping trace memory";
   dump_timer_.Stop();
-  ScopedTraceMemory::set_enabled(false);
-  CleanupThreadLocalStorage();
+  ReleasePseudoStacks();
   // Call ::HeapProfilerStop().
   heap_profiler_stop_function_();
 }
@@ -241,6 +567,144 @@ bool TraceMemoryController::IsTimerRunningForTest() const {
   return dump_timer_.IsRunning();
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+TraceMemorySampler::TraceMemorySampler(
+    scoped_refptr<MessageLoopProxy> message_loop_proxy,
+    size_t mean_bytes_between_samples,
+    AddNewHookFunction add_new_hook_function,
+    RemoveNewHookFunction remove_new_hook_function,
+    AddDeleteHookFunction add_delete_hook_function,
+    RemoveDeleteHookFunction remove_delete_hook_function)
+    : message_loop_proxy_(message_loop_proxy),
+      mean_bytes_between_samples_(mean_bytes_between_samples),
+      add_new_hook_function_(add_new_hook_function),
+      remove_new_hook_function_(remove_new_hook_function),
+      add_delete_hook_function_(add_delete_hook_function),
+      remove_delete_hook_function_(remove_delete_hook_function),
+      weak_factory_(this) {
+  DCHECK_GT(mean_bytes_between_samples, 0u);
+  // Force the "memory.sampling" category to show up in the trace viewer.
+  TRACE_EVENT0(kSamplingCategory, "init");
+  // Watch for the tracing system being enabled.
+  TraceLog::GetInstance()->AddEnabledStateObserver(this);
+}
+
+TraceMemorySampler::~TraceMemorySampler() {
+  if (record_timer_.IsRunning())
+    StopSampling();
+  TraceLog::GetInstance()->RemoveEnabledStateObserver(this);
+}
+
+// base::debug::TraceLog::EnabledStateChangedObserver overrides:
+void TraceMemorySampler::OnTraceLogEnabled() {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(kSamplingCategory, &enabled);
+  if (!enabled)
+    return;
+  message_loop_proxy_->PostTask(
+      FROM_HERE,
+      base::Bind(&TraceMemorySampler::StartSampling,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void TraceMemorySampler::OnTraceLogDisabled() {
+  // The category is always disabled before OnTraceLogDisabled() is called, so
+  // we cannot tell if it was enabled before. Always try to stop sampling.
+  message_loop_proxy_->PostTask(
+      FROM_HERE,
+      base::Bind(&TraceMemorySampler::StopSampling,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void TraceMemorySampler::StartSampling() {
+  // Watch for the tracing framework sending enabling more than once.
+  if (record_timer_.IsRunning())
+    return;
+  DVLOG(1) << "Starting trace memory sampling";
+  {
+    AutoLock lock(g_sampler_lock.Get());
+    DCHECK(!g_active_sampler) << "Only one TraceMemorySampler can sample";
+    if (g_active_sampler)
+      return;
+    if (!g_sampler_state) {
+      g_sampler_state = new SamplerState;
+      ANNOTATE_LEAKING_OBJECT_PTR(g_sampler_state);
+    }
+    memset(g_sampler_state, 0, sizeof(*g_sampler_state));
+    g_active_sampler = this;
+  }
+  if (!AcquirePseudoStacks()) {
+    AutoLock lock(g_sampler_lock.Get());
+    g_active_sampler = NULL;
+    return;
+  }
+  subtle::NoBarrier_Store(
+      &g_mean_bytes_between_samples,
+      static_cast<subtle::AtomicWord>(mean_bytes_between_samples_));
+  subtle::Release_Store(&g_sampling, 1);
+  // Call ::MallocHook_AddNewHook() and ::MallocHook_AddDeleteHook().
+  add_new_hook_function_(&SampleNewHook);
+  add_delete_hook_function_(&SampleDeleteHook);
+  const int kRecordIntervalSeconds = 1;
+  record_timer_.Start(FROM_HERE,
+                      TimeDelta::FromSeconds(kRecordIntervalSeconds),
+                      base::Bind(&TraceMemorySampler::RecordSamples,
+                                 weak_factory_.GetWeakPtr()));
+}
+
+void TraceMemorySampler::RecordSamples() {
+  // Don't sample allocations here in the memory tracing system.
+  INTERNAL_TRACE_MEMORY(TRACE_DISABLED_BY_DEFAULT("memory"),
+                        TRACE_MEMORY_IGNORE);
+
+  const AllocationSample* samples = NULL;
+  size_t sample_count = 0;
+  {
+    AutoLock lock(g_sampler_lock.Get());
+    if (g_active_sampler != this)
+      return;
+    samples = g_sampler_state->pending_samples[g_sampler_state->pending_buffer];
+    sample_count = g_sampler_state->pending_sample_count;
+    g_sampler_state->pending_buffer ^= 1;
+    g_sampler_state->pending_sample_count = 0;
+  }
+  // The hooks fill the other buffer meanwhile. Samples taken while the
+  // category is disabled are dropped.
+  const unsigned char* category_group_enabled =
+      TraceLog::GetCategoryGroupEnabled(kSamplingCategory);
+  if (!(*category_group_enabled & TraceLog::ENABLED_FOR_RECORDING))
+    return;
+  for (size_t i = 0; i < sample_count; ++i)
+    AddSampleEvent(category_group_enabled, samples[i]);
+}
+
+void TraceMemorySampler::StopSampling() {
+  // Watch for the tracing framework sending disabled more than once.
+  if (!record_timer_.IsRunning())
+    return;
+  DVLOG(1) << "Stopping trace memory sampling";
+  record_timer_.Stop();
+  // Call ::MallocHook_RemoveNewHook() and ::MallocHook_RemoveDeleteHook().
+  remove_new_hook_function_(&SampleNewHook);
+  remove_delete_hook_function_(&SampleDeleteHook);
+  subtle::Release_Store(&g_sampling, 0);
+  RecordSamples();
+  ReleasePseudoStacks();
+  AutoLock lock(g_sampler_lock.Get());
+  g_active_sampler = NULL;
+}
+
+bool TraceMemorySampler::IsSamplingForTest() const {
+  return record_timer_.IsRunning();
+}
+
+// static
+size_t TraceMemorySampler::GetPendingSampleCountForTest() {
+  AutoLock lock(g_sampler_lock.Get());
+  return g_sampler_state ? g_sampler_state->pending_sample_count : 0;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 // static
@@ -406,13 +870,8 @@ bool AppendHeapProfileLineAsTraceFormat(const std::string& line,
     const char* trace_category = StringFromHexAddress(tokens[t]);
     DCHECK_LT(t + 1, tokens.size());
     const char* trace_name = StringFromHexAddress(tokens[t + 1]);
-
-    // TODO(jamescook): Report the trace category and name separately to the
-    // trace viewer and allow it to decide what decorations to apply. For now
-    // just hard-code a decoration for posted tasks (toplevel).
-    std::string trace_string(trace_name);
-    if (!strcmp(trace_category, "toplevel"))
-      trace_string.append("->PostTask");
+    std::string trace_string =
+        GetTraceNameForScope(trace_category, trace_name);
 
     // Some trace name strings have double quotes, convert them to single.
     ReplaceChars(trace_string, "\"", kSingleQuote, &trace_string);
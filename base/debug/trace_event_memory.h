@@ -83,6 +83,78 @@ class BASE_EXPORT TraceMemoryController
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Watches for chrome://tracing to enable the "memory.sampling" category, and
+// then samples allocations as they happen instead of taking heap dumps. An
+// allocation is sampled with a probability proportional to its size, as a
+// Poisson process over the bytes allocated by a thread, so the samples can be
+// scaled back up to the allocation volume of each pseudo-stack of TRACE_EVENT
+// scopes. Sampled allocations and their frees stream into the trace as
+// "memory::Allocation" and "memory::Free" sample events, with the pointer as
+// their id.
+class BASE_EXPORT TraceMemorySampler : public TraceLog::EnabledStateObserver {
+ public:
+  // Signatures of tcmalloc's MallocHook_NewHook and MallocHook_DeleteHook.
+  typedef void (*NewHook)(const void* ptr, size_t size);
+  typedef void (*DeleteHook)(const void* ptr);
+  typedef int (*AddNewHookFunction)(NewHook hook);
+  typedef int (*RemoveNewHookFunction)(NewHook hook);
+  typedef int (*AddDeleteHookFunction)(DeleteHook hook);
+  typedef int (*RemoveDeleteHookFunction)(DeleteHook hook);
+
+  // Takes a sample every |mean_bytes_between_samples| bytes allocated, on
+  // average. |message_loop_proxy| must be a proxy to the primary thread for the
+  // client process, where samples are recorded into the TraceLog. The function
+  // pointers must be tcmalloc's MallocHook_{Add,Remove}{New,Delete}Hook(), as
+  // with TraceMemoryController.
+  TraceMemorySampler(
+      scoped_refptr<MessageLoopProxy> message_loop_proxy,
+      size_t mean_bytes_between_samples,
+      AddNewHookFunction add_new_hook_function,
+      RemoveNewHookFunction remove_new_hook_function,
+      AddDeleteHookFunction add_delete_hook_function,
+      RemoveDeleteHookFunction remove_delete_hook_function);
+  virtual ~TraceMemorySampler();
+
+  // base::debug::TraceLog::EnabledStateChangedObserver overrides:
+  virtual void OnTraceLogEnabled() OVERRIDE;
+  virtual void OnTraceLogDisabled() OVERRIDE;
+
+  // Installs the allocator hooks. Only one sampler can sample at a time.
+  void StartSampling();
+
+  // Records the samples taken since the last call into the TraceLog.
+  void RecordSamples();
+
+  // Removes the allocator hooks and records the samples left.
+  void StopSampling();
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(TraceMemoryTest, TraceMemorySampler);
+  FRIEND_TEST_ALL_PREFIXES(TraceMemoryTest, TraceMemorySamplerRate);
+
+  bool IsSamplingForTest() const;
+
+  // Returns the number of samples waiting for RecordSamples().
+  static size_t GetPendingSampleCountForTest();
+
+  scoped_refptr<MessageLoopProxy> message_loop_proxy_;
+  const size_t mean_bytes_between_samples_;
+
+  AddNewHookFunction add_new_hook_function_;
+  RemoveNewHookFunction remove_new_hook_function_;
+  AddDeleteHookFunction add_delete_hook_function_;
+  RemoveDeleteHookFunction remove_delete_hook_function_;
+
+  // Timer to schedule recording the samples.
+  RepeatingTimer<TraceMemorySampler> record_timer_;
+
+  WeakPtrFactory<TraceMemorySampler> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceMemorySampler);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 // A scoped context for memory tracing. Pushes the name onto a stack for
 // recording by tcmalloc heap profiling.
 class BASE_EXPORT ScopedTraceMemory {
@@ -7,8 +7,13 @@
 #include <sstream>
 #include <string>
 
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/debug/trace_event_impl.h"
+#include "base/json/json_reader.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/message_loop/message_loop.h"
+#include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 #if defined(TCMALLOC_TRACE_MEMORY_SUPPORTED)
@@ -118,6 +123,187 @@ TEST_F(TraceMemoryTest, DeepScopeNesting) {
 
 #endif  // defined(TRACE_MEMORY_SUPPORTED)
 
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Stand-ins for the tcmalloc hook registration, so that the tests can call
+// the hooks directly.
+TraceMemorySampler::NewHook g_new_hook = NULL;
+TraceMemorySampler::DeleteHook g_delete_hook = NULL;
+
+int AddNewHookForTest(TraceMemorySampler::NewHook hook) {
+  g_new_hook = hook;
+  return 1;
+}
+
+int RemoveNewHookForTest(TraceMemorySampler::NewHook hook) {
+  EXPECT_EQ(g_new_hook, hook);
+  g_new_hook = NULL;
+  return 1;
+}
+
+int AddDeleteHookForTest(TraceMemorySampler::DeleteHook hook) {
+  g_delete_hook = hook;
+  return 1;
+}
+
+int RemoveDeleteHookForTest(TraceMemorySampler::DeleteHook hook) {
+  EXPECT_EQ(g_delete_hook, hook);
+  g_delete_hook = NULL;
+  return 1;
+}
+
+TraceMemorySampler* CreateSamplerForTest(MessageLoop* message_loop,
+                                         size_t mean_bytes_between_samples) {
+  return new TraceMemorySampler(message_loop->message_loop_proxy(),
+                                mean_bytes_between_samples,
+                                &AddNewHookForTest,
+                                &RemoveNewHookForTest,
+                                &AddDeleteHookForTest,
+                                &RemoveDeleteHookForTest);
+}
+
+void OnTraceDataCollected(std::string* json,
+                          const scoped_refptr<RefCountedString>& events_str,
+                          bool has_more_events) {
+  if (!json->empty() && !events_str->data().empty())
+    *json += ",";
+  *json += events_str->data();
+}
+
+}  // namespace
+
+TEST_F(TraceMemoryTest, TraceMemorySampler) {
+  MessageLoop message_loop;
+  TraceLog* trace_log = TraceLog::GetInstance();
+  EXPECT_EQ(0u, trace_log->GetObserverCountForTest());
+
+  // A mean of one byte samples every allocation.
+  scoped_ptr<TraceMemorySampler> sampler(
+      CreateSamplerForTest(&message_loop, 1));
+  EXPECT_EQ(1u, trace_log->GetObserverCountForTest());
+  EXPECT_FALSE(sampler->IsSamplingForTest());
+
+  // Enabling the category installs the hooks.
+  trace_log->SetEnabled(
+      CategoryFilter(TRACE_DISABLED_BY_DEFAULT("memory.sampling")),
+      TraceLog::RECORDING_MODE,
+      TraceLog::RECORD_UNTIL_FULL);
+  message_loop.RunUntilIdle();
+  EXPECT_TRUE(sampler->IsSamplingForTest());
+  ASSERT_TRUE(g_new_hook);
+  ASSERT_TRUE(g_delete_hook);
+
+  int sampled = 0;
+  int unsampled = 0;
+  {
+    ScopedTraceMemory scope("toplevel", "name1");
+    g_new_hook(&sampled, 100);
+    EXPECT_EQ(1u, TraceMemorySampler::GetPendingSampleCountForTest());
+    g_delete_hook(&sampled);
+    EXPECT_EQ(2u, TraceMemorySampler::GetPendingSampleCountForTest());
+    // Frees of allocations that were not sampled are not reported.
+    g_delete_hook(&unsampled);
+    EXPECT_EQ(2u, TraceMemorySampler::GetPendingSampleCountForTest());
+  }
+  sampler->RecordSamples();
+  EXPECT_EQ(0u, TraceMemorySampler::GetPendingSampleCountForTest());
+
+  // Disabling tracing removes the hooks.
+  trace_log->SetDisabled();
+  message_loop.RunUntilIdle();
+  EXPECT_FALSE(sampler->IsSamplingForTest());
+  EXPECT_FALSE(g_new_hook);
+  EXPECT_FALSE(g_delete_hook);
+
+  std::string json;
+  trace_log->Flush(Bind(&OnTraceDataCollected, Unretained(&json)));
+  // Flushing the thread-local event buffers runs on the message loop.
+  message_loop.RunUntilIdle();
+  scoped_ptr<Value> root(JSONReader::Read("[" + json + "]"));
+  ListValue* events = NULL;
+  ASSERT_TRUE(root.get() && root->GetAsList(&events));
+
+  int num_allocations = 0;
+  int num_frees = 0;
+  std::string allocation_id;
+  std::string free_id;
+  for (size_t i = 0; i < events->GetSize(); ++i) {
+    DictionaryValue* event = NULL;
+    ASSERT_TRUE(events->GetDictionary(i, &event));
+    std::string name;
+    std::string phase;
+    int size = 0;
+    event->GetString("name", &name);
+    event->GetString("ph", &phase);
+    if (name == "memory::Allocation") {
+      ++num_allocations;
+      EXPECT_EQ("P", phase);
+      EXPECT_TRUE(event->GetString("id", &allocation_id));
+      EXPECT_TRUE(event->GetInteger("args.size", &size));
+      EXPECT_EQ(100, size);
+      ListValue* stack = NULL;
+      std::string trace_name;
+      ASSERT_TRUE(event->GetList("args.stack", &stack));
+      ASSERT_EQ(1u, stack->GetSize());
+      EXPECT_TRUE(stack->GetString(0, &trace_name));
+      EXPECT_EQ("name1->PostTask", trace_name);
+    } else if (name == "memory::Free") {
+      ++num_frees;
+      EXPECT_EQ("P", phase);
+      EXPECT_TRUE(event->GetString("id", &free_id));
+      EXPECT_TRUE(event->GetInteger("args.size", &size));
+      EXPECT_EQ(100, size);
+    }
+  }
+  EXPECT_EQ(1, num_allocations);
+  EXPECT_EQ(1, num_frees);
+  EXPECT_EQ(allocation_id, free_id);
+
+  // Deleting the sampler removes it from the TraceLog observer list.
+  sampler.reset();
+  EXPECT_EQ(0u, trace_log->GetObserverCountForTest());
+}
+
+TEST_F(TraceMemoryTest, TraceMemorySamplerRate) {
+  MessageLoop message_loop;
+  const size_t kMeanBytesBetweenSamples = 4096;
+  const size_t kExpectedSamples = 400;
+  scoped_ptr<TraceMemorySampler> sampler(
+      CreateSamplerForTest(&message_loop, kMeanBytesBetweenSamples));
+  sampler->StartSampling();
+  ASSERT_TRUE(g_new_hook);
+
+  {
+    ScopedTraceMemory scope("category", "name");
+    // Allocations of several sizes are sampled in proportion to the bytes
+    // allocated. The addresses are never dereferenced.
+    const size_t kSizes[] = { 16, 100, 1024 };
+    uintptr_t address = 0x10000;
+    for (size_t i = 0; i < arraysize(kSizes); ++i) {
+      size_t bytes = 0;
+      while (bytes < kExpectedSamples / arraysize(kSizes) *
+                 kMeanBytesBetweenSamples) {
+        address += 16;
+        g_new_hook(reinterpret_cast<const void*>(address), kSizes[i]);
+        bytes += kSizes[i];
+      }
+    }
+  }
+
+  // The sample count is Poisson distributed, so allow for 4 standard
+  // deviations.
+  size_t num_samples = TraceMemorySampler::GetPendingSampleCountForTest();
+  EXPECT_GT(num_samples, kExpectedSamples - 80);
+  EXPECT_LT(num_samples, kExpectedSamples + 80);
+
+  sampler->StopSampling();
+  EXPECT_FALSE(sampler->IsSamplingForTest());
+  EXPECT_FALSE(g_new_hook);
+  EXPECT_EQ(0u, TraceMemorySampler::GetPendingSampleCountForTest());
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 TEST_F(TraceMemoryTest, AppendHeapProfileTotalsAsTraceFormat) {
@@ -0,0 +1,114 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the cost of adding a trace event while tracing is enabled, from
+// threads with a message loop, which record into thread-local event buffers.
+// On a plain release build, each event must come in under a budget so that
+// tracing does not change the timing it is used to measure.
+
+#include "base/debug/trace_event.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+namespace debug {
+namespace {
+
+// Keep all the events of a run within the capacity of the trace buffer.
+const int kEventsPerThread = 50000;
+const int kMaxThreads = 4;
+
+#if defined(NDEBUG) && !defined(ADDRESS_SANITIZER) && \
+    !defined(THREAD_SANITIZER)
+const double kMaxNanosecondsPerEvent = 2000;
+#endif
+
+// Uses the CPU time of the thread where supported, so that the threads taking
+// turns on fewer cores don't count against each other.
+TimeTicks Now() {
+  return TimeTicks::IsThreadNowSupported() ?
+      TimeTicks::ThreadNow() : TimeTicks::HighResNow();
+}
+
+void AddEvents(WaitableEvent* start_event,
+               TimeDelta* elapsed,
+               WaitableEvent* task_complete_event) {
+  // Set up the thread-local event buffer before timing.
+  TRACE_EVENT_INSTANT0("perftest", "warmup", TRACE_EVENT_SCOPE_THREAD);
+  start_event->Wait();
+
+  TimeTicks start = Now();
+  for (int i = 0; i < kEventsPerThread; ++i)
+    TRACE_EVENT_INSTANT1("perftest", "event", TRACE_EVENT_SCOPE_THREAD,
+                         "i", i);
+  *elapsed = Now() - start;
+  task_complete_event->Signal();
+}
+
+// Returns the time per event on the slowest of |num_threads| threads adding
+// events at the same time.
+double MeasureNanosecondsPerEvent(int num_threads) {
+  TraceLog* trace_log = TraceLog::GetInstance();
+  trace_log->SetEnabled(CategoryFilter("perftest"),
+                        TraceLog::RECORDING_MODE,
+                        TraceLog::RECORD_UNTIL_FULL);
+
+  WaitableEvent start_event(true, false);
+  ScopedVector<Thread> threads;
+  ScopedVector<WaitableEvent> task_complete_events;
+  std::vector<TimeDelta> elapsed(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new Thread(
+        StringPrintf("TraceEventPerfTest%d", i).c_str()));
+    task_complete_events.push_back(new WaitableEvent(false, false));
+    threads[i]->Start();
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, Bind(&AddEvents, &start_event, &elapsed[i],
+                        task_complete_events[i]));
+  }
+  start_event.Signal();
+
+  TimeDelta max_elapsed;
+  for (int i = 0; i < num_threads; ++i) {
+    task_complete_events[i]->Wait();
+    // Stopping the thread flushes its thread-local event buffer.
+    threads[i]->Stop();
+    max_elapsed = std::max(max_elapsed, elapsed[i]);
+  }
+
+  EXPECT_FALSE(trace_log->BufferIsFull());
+  trace_log->SetDisabled();
+  trace_log->Flush(TraceLog::OutputCallback());
+
+  return max_elapsed.InMillisecondsF() * 1000000 / kEventsPerThread;
+}
+
+TEST(TraceEventPerfTest, ThreadLocalEventBuffers) {
+  for (int num_threads = 1; num_threads <= kMaxThreads; num_threads *= 2) {
+    double ns_per_event = MeasureNanosecondsPerEvent(num_threads);
+    perf_test::PrintResult("trace_event_overhead", "",
+                           StringPrintf("threads_%d", num_threads),
+                           ns_per_event, "ns/event", true);
+#if defined(NDEBUG) && !defined(ADDRESS_SANITIZER) && \
+    !defined(THREAD_SANITIZER)
+    EXPECT_LT(ns_per_event, kMaxNanosecondsPerEvent);
+#endif
+  }
+}
+
+}  // namespace
+}  // namespace debug
+}  // namespace base
@@ -6,6 +6,7 @@
 
 #include <math.h>
 #include <cstdlib>
+#include <set>
 
 #include "base/bind.h"
 #include "base/command_line.h"
@@ -2461,6 +2462,65 @@ TEST_F(TraceEventTestFixture, TraceBufferRingBufferFullIteration) {
   TraceLog::GetInstance()->SetDisabled();
 }
 
+namespace {
+
+void GetAndReturnChunks(TraceBuffer* buffer,
+                        size_t num_chunks,
+                        WaitableEvent* task_complete_event) {
+  for (size_t i = 0; i < num_chunks; ++i) {
+    size_t chunk_index;
+    scoped_ptr<TraceBufferChunk> chunk = buffer->GetChunk(&chunk_index);
+    ASSERT_TRUE(chunk);
+    size_t event_index;
+    chunk->AddTraceEvent(&event_index);
+    buffer->ReturnChunk(chunk_index, chunk.Pass());
+  }
+  task_complete_event->Signal();
+}
+
+}  // namespace
+
+TEST_F(TraceEventTestFixture, TraceBufferVectorConcurrentGetReturnChunk) {
+  // No category is enabled, so that only the chunks below are in the buffer.
+  TraceLog::GetInstance()->SetEnabled(CategoryFilter("-*"),
+                                      base::debug::TraceLog::RECORDING_MODE,
+                                      TraceLog::RECORD_UNTIL_FULL);
+  TraceBuffer* buffer = TraceLog::GetInstance()->trace_buffer();
+  ASSERT_TRUE(buffer->IsLockFree());
+  EXPECT_EQ(0u, buffer->Size());
+
+  const int kNumThreads = 4;
+  const size_t kNumChunksPerThread = 200;
+  Thread* threads[kNumThreads];
+  WaitableEvent* task_complete_events[kNumThreads];
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i] = new Thread(StringPrintf("Thread %d", i).c_str());
+    task_complete_events[i] = new WaitableEvent(false, false);
+    threads[i]->Start();
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&GetAndReturnChunks, buffer,
+                              kNumChunksPerThread, task_complete_events[i]));
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    task_complete_events[i]->Wait();
+    threads[i]->Stop();
+    delete threads[i];
+    delete task_complete_events[i];
+  }
+
+  // Every chunk got its own slot and sequence number.
+  const size_t num_chunks = kNumThreads * kNumChunksPerThread;
+  EXPECT_EQ(num_chunks * TraceBufferChunk::kTraceBufferChunkSize,
+            buffer->Size());
+  std::set<uint32> seqs;
+  while (const TraceBufferChunk* chunk = buffer->NextChunk()) {
+    EXPECT_EQ(1u, chunk->size());
+    EXPECT_TRUE(seqs.insert(chunk->seq()).second);
+  }
+  EXPECT_EQ(num_chunks, seqs.size());
+  TraceLog::GetInstance()->SetDisabled();
+}
+
 // Test the category filter.
 TEST_F(TraceEventTestFixture, CategoryFilter) {
   // Using the default filter.
@@ -0,0 +1,384 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/async_file_io.h"
+
+#include <string.h>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/task_runner.h"
+
+#if defined(OS_LINUX)
+#include <errno.h>
+#include <linux/aio_abi.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <set>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/message_loop/message_loop.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/stl_util.h"
+#endif
+
+#if defined(OS_LINUX) && !defined(RWF_NOWAIT)
+#define RWF_NOWAIT 0x00000008
+#endif
+
+namespace base {
+
+struct AsyncFileIO::Operation {
+  Operation(bool is_write, PlatformFile file, int64 offset, int size)
+      : is_write(is_write),
+        file(file),
+        offset(offset),
+        buffer(new char[size]),
+        size(size),
+        bytes_done(0),
+        error(File::FILE_OK) {
+  }
+
+  // Runs the rest of the operation with blocking calls, the way FileUtilProxy
+  // does.
+  void RunBlocking() {
+    while (bytes_done < size && error == File::FILE_OK) {
+      int result = is_write ?
+          WritePlatformFile(file, offset + bytes_done, buffer.get() + bytes_done,
+                            size - bytes_done) :
+          ReadPlatformFile(file, offset + bytes_done, buffer.get() + bytes_done,
+                           size - bytes_done);
+      if (result < 0)
+        error = File::FILE_ERROR_FAILED;
+      else if (result == 0 && !is_write)
+        break;
+      else
+        bytes_done += result;
+    }
+  }
+
+  const bool is_write;
+  const PlatformFile file;
+  const int64 offset;
+  scoped_ptr<char[]> buffer;
+  const int size;
+  int bytes_done;
+  File::Error error;
+  ReadCallback read_callback;
+  WriteCallback write_callback;
+#if defined(OS_LINUX)
+  struct iocb control_block;
+#endif
+};
+
+#if defined(OS_LINUX)
+
+namespace {
+
+// The maximum number of operations submitted to the kernel at a time. Others
+// run on the blocking task runner.
+const int kMaxOperationsInKernel = 256;
+
+long IoSetup(unsigned nr_events, aio_context_t* context) {
+  return syscall(__NR_io_setup, nr_events, context);
+}
+
+long IoDestroy(aio_context_t context) {
+  return syscall(__NR_io_destroy, context);
+}
+
+long IoSubmit(aio_context_t context, long nr, struct iocb** iocbpp) {
+  return syscall(__NR_io_submit, context, nr, iocbpp);
+}
+
+long IoGetEvents(aio_context_t context,
+                 long min_nr,
+                 long nr,
+                 struct io_event* events,
+                 struct timespec* timeout) {
+  return syscall(__NR_io_getevents, context, min_nr, nr, events, timeout);
+}
+
+// Kernels without RWF_NOWAIT support for AIO, before 4.14, reject the flag
+// with EINVAL. A read of an empty pipe tells them apart from the others, which
+// fail the read with EAGAIN.
+bool ProbeKernelAIO() {
+  aio_context_t context = 0;
+  if (IoSetup(1, &context) != 0)
+    return false;
+  int fds[2];
+  if (pipe(fds) != 0) {
+    IoDestroy(context);
+    return false;
+  }
+  char buffer[1];
+  struct iocb control_block;
+  memset(&control_block, 0, sizeof(control_block));
+  control_block.aio_fildes = fds[0];
+  control_block.aio_lio_opcode = IOCB_CMD_PREAD;
+  control_block.aio_buf = reinterpret_cast<uintptr_t>(buffer);
+  control_block.aio_nbytes = sizeof(buffer);
+  control_block.aio_rw_flags = RWF_NOWAIT;
+  struct iocb* control_blocks[] = { &control_block };
+  bool supported = false;
+  if (IoSubmit(context, 1, control_blocks) == 1) {
+    // Unblocks the read in case the flag was ignored.
+    ignore_result(HANDLE_EINTR(write(fds[1], buffer, sizeof(buffer))));
+    struct io_event event;
+    if (HANDLE_EINTR(IoGetEvents(context, 1, 1, &event, NULL)) == 1)
+      supported = event.res == -EAGAIN;
+  }
+  IoDestroy(context);
+  close(fds[0]);
+  close(fds[1]);
+  return supported;
+}
+
+struct KernelAIOSupport {
+  KernelAIOSupport() : supported(ProbeKernelAIO()) {}
+  const bool supported;
+};
+
+LazyInstance<KernelAIOSupport>::Leaky g_kernel_aio_support =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// Owns the kernel AIO context and the operations submitted to it, and watches
+// the eventfd the kernel signals completions on.
+class AsyncFileIO::KernelContext : public MessageLoopForIO::Watcher {
+ public:
+  explicit KernelContext(AsyncFileIO* owner)
+      : owner_(owner),
+        context_(0),
+        event_fd_(-1) {
+  }
+
+  virtual ~KernelContext() {
+    watcher_.StopWatchingFileDescriptor();
+    if (context_) {
+      // Waits for the operations in flight, so that the kernel is done with
+      // their buffers.
+      IoDestroy(context_);
+    }
+    STLDeleteElements(&operations_);
+    if (event_fd_ >= 0)
+      close(event_fd_);
+  }
+
+  bool Initialize() {
+    if (IoSetup(kMaxOperationsInKernel, &context_) != 0) {
+      DPLOG(ERROR) << "io_setup";
+      context_ = 0;
+      return false;
+    }
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) {
+      DPLOG(ERROR) << "eventfd";
+      return false;
+    }
+    return MessageLoopForIO::current()->WatchFileDescriptor(
+        event_fd_, true, MessageLoopForIO::WATCH_READ, &watcher_, this);
+  }
+
+  // Returns |operation| if the kernel did not take it.
+  scoped_ptr<Operation> Submit(scoped_ptr<Operation> operation) {
+    if (operations_.size() >= static_cast<size_t>(kMaxOperationsInKernel))
+      return operation.Pass();
+    struct iocb* control_block = &operation->control_block;
+    memset(control_block, 0, sizeof(*control_block));
+    control_block->aio_data = reinterpret_cast<uintptr_t>(operation.get());
+    control_block->aio_fildes = operation->file;
+    control_block->aio_lio_opcode =
+        operation->is_write ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+    control_block->aio_buf = reinterpret_cast<uintptr_t>(
+        operation->buffer.get() + operation->bytes_done);
+    control_block->aio_nbytes = operation->size - operation->bytes_done;
+    control_block->aio_offset = operation->offset + operation->bytes_done;
+    control_block->aio_rw_flags = RWF_NOWAIT;
+    control_block->aio_flags = IOCB_FLAG_RESFD;
+    control_block->aio_resfd = event_fd_;
+    if (HANDLE_EINTR(IoSubmit(context_, 1, &control_block)) != 1)
+      return operation.Pass();
+    operations_.insert(operation.release());
+    return scoped_ptr<Operation>();
+  }
+
+  // MessageLoopForIO::Watcher implementation.
+  virtual void OnFileCanReadWithoutBlocking(int fd) OVERRIDE {
+    DCHECK_EQ(event_fd_, fd);
+    uint64 count;
+    if (HANDLE_EINTR(read(event_fd_, &count, sizeof(count))) < 0)
+      return;
+    // Reaps everything first, since a callback can delete the owner.
+    std::vector<std::pair<Operation*, int64> > completions;
+    struct io_event events[32];
+    for (;;) {
+      struct timespec no_wait = { 0, 0 };
+      long result = HANDLE_EINTR(IoGetEvents(context_, 0, arraysize(events),
+                                             events, &no_wait));
+      if (result <= 0)
+        break;
+      for (long i = 0; i < result; ++i) {
+        Operation* operation = reinterpret_cast<Operation*>(events[i].data);
+        operations_.erase(operation);
+        completions.push_back(std::make_pair(operation, events[i].res));
+      }
+    }
+    WeakPtr<AsyncFileIO> owner = owner_->weak_factory_.GetWeakPtr();
+    for (size_t i = 0; i < completions.size(); ++i) {
+      scoped_ptr<Operation> operation(completions[i].first);
+      if (owner)
+        owner->DidCompleteInKernel(operation.Pass(), completions[i].second);
+    }
+  }
+
+  virtual void OnFileCanWriteWithoutBlocking(int fd) OVERRIDE {
+    NOTREACHED();
+  }
+
+ private:
+  AsyncFileIO* owner_;
+  aio_context_t context_;
+  int event_fd_;
+  MessageLoopForIO::FileDescriptorWatcher watcher_;
+  // The operations submitted to the kernel and not reaped yet.
+  std::set<Operation*> operations_;
+
+  DISALLOW_COPY_AND_ASSIGN(KernelContext);
+};
+
+#else
+
+class AsyncFileIO::KernelContext {
+ public:
+  scoped_ptr<Operation> Submit(scoped_ptr<Operation> operation) {
+    return operation.Pass();
+  }
+};
+
+#endif  // defined(OS_LINUX)
+
+AsyncFileIO::AsyncFileIO(const scoped_refptr<TaskRunner>& blocking_task_runner)
+    : blocking_task_runner_(blocking_task_runner),
+      weak_factory_(this) {
+#if defined(OS_LINUX)
+  if (MessageLoopForIO::IsCurrent() && IsKernelAIOSupported()) {
+    kernel_context_.reset(new KernelContext(this));
+    if (!kernel_context_->Initialize())
+      kernel_context_.reset();
+  }
+#endif
+}
+
+AsyncFileIO::~AsyncFileIO() {
+  DCHECK(CalledOnValidThread());
+  // Drops the replies of the operations running on the blocking task runner.
+  weak_factory_.InvalidateWeakPtrs();
+  kernel_context_.reset();
+}
+
+// static
+bool AsyncFileIO::IsKernelAIOSupported() {
+#if defined(OS_LINUX)
+  return g_kernel_aio_support.Get().supported;
+#else
+  return false;
+#endif
+}
+
+bool AsyncFileIO::IsUsingKernelAIO() const {
+  return kernel_context_.get() != NULL;
+}
+
+bool AsyncFileIO::Read(PlatformFile file,
+                       int64 offset,
+                       int bytes_to_read,
+                       const ReadCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (bytes_to_read < 0 || offset < 0)
+    return false;
+  scoped_ptr<Operation> operation(
+      new Operation(false, file, offset, bytes_to_read));
+  operation->read_callback = callback;
+  return Start(operation.Pass());
+}
+
+bool AsyncFileIO::Write(PlatformFile file,
+                        int64 offset,
+                        const char* buffer,
+                        int bytes_to_write,
+                        const WriteCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (bytes_to_write <= 0 || offset < 0 || buffer == NULL)
+    return false;
+  scoped_ptr<Operation> operation(
+      new Operation(true, file, offset, bytes_to_write));
+  memcpy(operation->buffer.get(), buffer, bytes_to_write);
+  operation->write_callback = callback;
+  return Start(operation.Pass());
+}
+
+bool AsyncFileIO::Start(scoped_ptr<Operation> operation) {
+  if (kernel_context_ && operation->size > 0) {
+    operation = kernel_context_->Submit(operation.Pass());
+    if (!operation)
+      return true;
+  }
+  return PostToBlockingTaskRunner(operation.Pass());
+}
+
+bool AsyncFileIO::PostToBlockingTaskRunner(scoped_ptr<Operation> operation) {
+  Operation* raw_operation = operation.get();
+  return blocking_task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      Bind(&Operation::RunBlocking, Unretained(raw_operation)),
+      Bind(&AsyncFileIO::RunCallback,
+           weak_factory_.GetWeakPtr(),
+           Passed(&operation)));
+}
+
+void AsyncFileIO::DidCompleteInKernel(scoped_ptr<Operation> operation,
+                                      int64 result) {
+  DCHECK(CalledOnValidThread());
+#if defined(OS_LINUX)
+  if (result == -EAGAIN || result == -EOPNOTSUPP || result == -EINVAL) {
+    // The kernel would have blocked, or can't do this file asynchronously.
+    ignore_result(PostToBlockingTaskRunner(operation.Pass()));
+    return;
+  }
+  if (result < 0) {
+    operation->error = File::OSErrorToFileError(-result);
+  } else {
+    operation->bytes_done += result;
+    // Partial results, either from the page cache or before the end of the
+    // file, are completed with blocking calls.
+    if (operation->bytes_done < operation->size && result > 0) {
+      ignore_result(PostToBlockingTaskRunner(operation.Pass()));
+      return;
+    }
+  }
+#endif
+  RunCallback(operation.Pass());
+}
+
+void AsyncFileIO::RunCallback(scoped_ptr<Operation> operation) {
+  if (operation->is_write) {
+    if (!operation->write_callback.is_null()) {
+      operation->write_callback.Run(
+          operation->error,
+          operation->error == File::FILE_OK ? operation->bytes_done : -1);
+    }
+  } else if (!operation->read_callback.is_null()) {
+    operation->read_callback.Run(operation->error,
+                                 operation->buffer.get(),
+                                 operation->bytes_done);
+  }
+}
+
+}  // namespace base
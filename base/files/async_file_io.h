@@ -0,0 +1,96 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_ASYNC_FILE_IO_H_
+#define BASE_FILES_ASYNC_FILE_IO_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/files/file_util_proxy.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/platform_file.h"
+#include "base/threading/non_thread_safe.h"
+
+namespace base {
+
+class TaskRunner;
+
+// Reads and writes files asynchronously, with the completion callbacks run on
+// the thread the AsyncFileIO was created on.
+//
+// On Linux, when created on a MessageLoopForIO thread, operations are submitted
+// to the kernel with io_submit() and RWF_NOWAIT, and their completions are
+// delivered through an eventfd watched by the message loop. Reads served from
+// the page cache and writes to O_DIRECT files then complete without a thread
+// hop. Operations the kernel cannot start without blocking the caller, such as
+// buffered reads of uncached data, continue on |blocking_task_runner| the way
+// FileUtilProxy runs them. Everywhere else, all operations run on
+// |blocking_task_runner|.
+//
+// Destroying the AsyncFileIO cancels the callbacks of the pending operations,
+// but the files must stay open until the operations are done, which the
+// destructor waits for in the kernel case only.
+class BASE_EXPORT AsyncFileIO : public NonThreadSafe {
+ public:
+  typedef FileUtilProxy::ReadCallback ReadCallback;
+  typedef FileUtilProxy::WriteCallback WriteCallback;
+
+  explicit AsyncFileIO(const scoped_refptr<TaskRunner>& blocking_task_runner);
+  ~AsyncFileIO();
+
+  // Returns true if the kernel supports asynchronous reads that fail instead
+  // of blocking, which is required to submit operations to the kernel.
+  static bool IsKernelAIOSupported();
+
+  // Returns true if this instance submits operations to the kernel.
+  bool IsUsingKernelAIO() const;
+
+  // Reads up to |bytes_to_read| bytes from |file| at |offset|, stopping early
+  // only at the end of the file. |callback| gets the data, which is valid for
+  // the duration of the call only. Returns false, without running |callback|,
+  // if the operation could not be started.
+  bool Read(PlatformFile file,
+            int64 offset,
+            int bytes_to_read,
+            const ReadCallback& callback);
+
+  // Writes |bytes_to_write| bytes from |buffer| to |file| at |offset|.
+  // |buffer| is copied and can be freed when this returns. Returns false,
+  // without running |callback|, if the operation could not be started.
+  bool Write(PlatformFile file,
+             int64 offset,
+             const char* buffer,
+             int bytes_to_write,
+             const WriteCallback& callback);
+
+ private:
+  struct Operation;
+  class KernelContext;
+
+  // Starts |operation|, taking ownership of it.
+  bool Start(scoped_ptr<Operation> operation);
+
+  // Continues |operation| on |blocking_task_runner_|. The operation is dropped
+  // if it can't be posted.
+  bool PostToBlockingTaskRunner(scoped_ptr<Operation> operation);
+
+  // Called by |kernel_context_| when the kernel is done with |operation|;
+  // |result| is the byte count or a negated errno value.
+  void DidCompleteInKernel(scoped_ptr<Operation> operation, int64 result);
+
+  void RunCallback(scoped_ptr<Operation> operation);
+
+  scoped_refptr<TaskRunner> blocking_task_runner_;
+  scoped_ptr<KernelContext> kernel_context_;
+
+  WeakPtrFactory<AsyncFileIO> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncFileIO);
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_ASYNC_FILE_IO_H_
@@ -0,0 +1,122 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The disk cache and the file systems issue bursts of small reads from the IO
+// thread. Measure how long a burst takes, and how many threads it costs, when
+// the reads go through FileUtilProxy on a worker pool and when they go through
+// AsyncFileIO with the same pool as its blocking task runner.
+
+#include "base/files/async_file_io.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/file_util_proxy.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+namespace {
+
+const int kFileSize = 16 * 1024 * 1024;
+const int kReadSizes[] = {4 * 1024, 64 * 1024};
+const int kReadsPerBurst = 256;
+const int kBursts = 20;
+const size_t kMaxWorkerThreads = 8;
+
+class AsyncFileIOPerfTest : public testing::Test {
+ public:
+  AsyncFileIOPerfTest() : pending_reads_(0) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+    path_ = dir_.path().AppendASCII("data");
+    std::string data(kFileSize, 'a');
+    ASSERT_EQ(kFileSize,
+              file_util::WriteFile(path_, data.data(), data.size()));
+    file_.Initialize(path_, File::FLAG_OPEN | File::FLAG_READ);
+    ASSERT_TRUE(file_.IsValid());
+  }
+
+  void DidRead(File::Error error, const char* data, int bytes_read) {
+    EXPECT_EQ(File::FILE_OK, error);
+    if (--pending_reads_ == 0)
+      MessageLoop::current()->QuitWhenIdle();
+  }
+
+ protected:
+  // Reads |read_size| bytes at spread offsets |kReadsPerBurst| times, either
+  // through |io| or, if null, through FileUtilProxy on |pool|.
+  void RunBurst(AsyncFileIO* io, TaskRunner* pool, int read_size) {
+    pending_reads_ = kReadsPerBurst;
+    for (int i = 0; i < kReadsPerBurst; ++i) {
+      int64 offset = (static_cast<int64>(i) * 4099 * 4096) %
+          (kFileSize - read_size);
+      FileUtilProxy::ReadCallback callback =
+          Bind(&AsyncFileIOPerfTest::DidRead, Unretained(this));
+      if (io) {
+        ASSERT_TRUE(io->Read(file_.GetPlatformFile(), offset, read_size,
+                             callback));
+      } else {
+        ASSERT_TRUE(FileUtilProxy::Read(pool, file_.GetPlatformFile(), offset,
+                                        read_size, callback));
+      }
+    }
+    MessageLoop::current()->Run();
+  }
+
+  void RunTest(bool use_async_file_io) {
+    const char* name = use_async_file_io ? "AsyncFileIO" : "FileUtilProxy";
+    for (size_t i = 0; i < arraysize(kReadSizes); ++i) {
+      scoped_refptr<SequencedWorkerPool> pool(
+          new SequencedWorkerPool(kMaxWorkerThreads, "AsyncFileIOPerfTest"));
+      const int threads_before = GetNumberOfThreads(GetCurrentProcessHandle());
+      scoped_ptr<AsyncFileIO> io;
+      if (use_async_file_io)
+        io.reset(new AsyncFileIO(pool));
+      // Warms up the page cache.
+      RunBurst(io.get(), pool.get(), kReadSizes[i]);
+      PerfTimeLogger timer(StringPrintf("%s: size=%d reads=%d", name,
+                                        kReadSizes[i],
+                                        kReadsPerBurst * kBursts).c_str());
+      for (int j = 0; j < kBursts; ++j)
+        RunBurst(io.get(), pool.get(), kReadSizes[i]);
+      timer.Done();
+      perf_test::PrintResult(
+          "worker_threads", StringPrintf("_%d", kReadSizes[i]), name,
+          static_cast<size_t>(
+              GetNumberOfThreads(GetCurrentProcessHandle()) - threads_before),
+          "threads", true);
+      io.reset();
+      pool->Shutdown();
+    }
+  }
+
+  ScopedTempDir dir_;
+  FilePath path_;
+  File file_;
+  int pending_reads_;
+  MessageLoopForIO message_loop_;
+};
+
+TEST_F(AsyncFileIOPerfTest, FileUtilProxy) {
+  RunTest(false);
+}
+
+TEST_F(AsyncFileIOPerfTest, AsyncFileIO) {
+  if (!AsyncFileIO::IsKernelAIOSupported())
+    LOG(WARNING) << "Kernel AIO is not supported, all reads use the pool";
+  RunTest(true);
+}
+
+}  // namespace
+}  // namespace base
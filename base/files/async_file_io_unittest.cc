@@ -0,0 +1,237 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/async_file_io.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/platform_file.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+std::string MakeData(size_t size) {
+  std::string data(size, 0);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<char>(i * 7 + i / 4096);
+  return data;
+}
+
+void ReadIntoString(std::string* out,
+                    File::Error error,
+                    const char* data,
+                    int bytes_read) {
+  EXPECT_EQ(File::FILE_OK, error);
+  out->assign(data, bytes_read);
+  MessageLoop::current()->QuitWhenIdle();
+}
+
+}  // namespace
+
+class AsyncFileIOTest : public testing::Test {
+ public:
+  AsyncFileIOTest()
+      : file_thread_("AsyncFileIOTestFileThread"),
+        file_(kInvalidPlatformFileValue),
+        error_(File::FILE_OK),
+        bytes_written_(-1),
+        completed_count_(0),
+        expected_count_(1) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(file_thread_.Start());
+  }
+
+  virtual void TearDown() OVERRIDE {
+    if (file_ != kInvalidPlatformFileValue)
+      ClosePlatformFile(file_);
+  }
+
+  void DidRead(File::Error error, const char* data, int bytes_read) {
+    error_ = error;
+    data_.assign(data, bytes_read);
+    DidComplete();
+  }
+
+  void DidWrite(File::Error error, int bytes_written) {
+    error_ = error;
+    bytes_written_ = bytes_written;
+    DidComplete();
+  }
+
+ protected:
+  void DidComplete() {
+    if (++completed_count_ == expected_count_)
+      MessageLoop::current()->QuitWhenIdle();
+  }
+
+  PlatformFile OpenTestFile(int flags) {
+    bool created;
+    PlatformFileError error;
+    file_ = CreatePlatformFile(test_path(), flags, &created, &error);
+    EXPECT_EQ(PLATFORM_FILE_OK, error);
+    return file_;
+  }
+
+  void WriteTestFile(const std::string& data) {
+    ASSERT_EQ(static_cast<int>(data.size()),
+              file_util::WriteFile(test_path(), data.data(), data.size()));
+  }
+
+  scoped_refptr<TaskRunner> file_task_runner() const {
+    return file_thread_.message_loop_proxy();
+  }
+  const FilePath test_path() const { return dir_.path().AppendASCII("test"); }
+
+  MessageLoopForIO message_loop_;
+  Thread file_thread_;
+  ScopedTempDir dir_;
+  PlatformFile file_;
+
+  File::Error error_;
+  std::string data_;
+  int bytes_written_;
+  int completed_count_;
+  int expected_count_;
+};
+
+TEST_F(AsyncFileIOTest, UsesKernelAIOWhenSupported) {
+  AsyncFileIO io(file_task_runner());
+  EXPECT_EQ(AsyncFileIO::IsKernelAIOSupported(), io.IsUsingKernelAIO());
+}
+
+TEST_F(AsyncFileIOTest, Read) {
+  const std::string data = MakeData(64 * 1024);
+  WriteTestFile(data);
+  AsyncFileIO io(file_task_runner());
+  ASSERT_TRUE(io.Read(OpenTestFile(PLATFORM_FILE_OPEN | PLATFORM_FILE_READ),
+                      4096, 16 * 1024,
+                      Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  MessageLoop::current()->Run();
+
+  EXPECT_EQ(File::FILE_OK, error_);
+  EXPECT_EQ(data.substr(4096, 16 * 1024), data_);
+}
+
+TEST_F(AsyncFileIOTest, ReadStopsAtEndOfFile) {
+  const std::string data = MakeData(100);
+  WriteTestFile(data);
+  AsyncFileIO io(file_task_runner());
+  PlatformFile file = OpenTestFile(PLATFORM_FILE_OPEN | PLATFORM_FILE_READ);
+  ASSERT_TRUE(io.Read(file, 60, 128,
+                      Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  MessageLoop::current()->Run();
+  EXPECT_EQ(File::FILE_OK, error_);
+  EXPECT_EQ(data.substr(60), data_);
+
+  completed_count_ = 0;
+  ASSERT_TRUE(io.Read(file, 1000, 128,
+                      Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  MessageLoop::current()->Run();
+  EXPECT_EQ(File::FILE_OK, error_);
+  EXPECT_TRUE(data_.empty());
+}
+
+TEST_F(AsyncFileIOTest, Write) {
+  const std::string data = MakeData(20000);
+  AsyncFileIO io(file_task_runner());
+  ASSERT_TRUE(io.Write(
+      OpenTestFile(PLATFORM_FILE_CREATE | PLATFORM_FILE_WRITE),
+      10, data.data(), data.size(),
+      Bind(&AsyncFileIOTest::DidWrite, Unretained(this))));
+  MessageLoop::current()->Run();
+  EXPECT_EQ(File::FILE_OK, error_);
+  EXPECT_EQ(static_cast<int>(data.size()), bytes_written_);
+
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(test_path(), &contents));
+  EXPECT_EQ(std::string(10, 0) + data, contents);
+}
+
+TEST_F(AsyncFileIOTest, ConcurrentReads) {
+  const int kReadSize = 4096;
+  const int kReadCount = 300;
+  const std::string data = MakeData(kReadSize * 16);
+  WriteTestFile(data);
+  AsyncFileIO io(file_task_runner());
+  PlatformFile file = OpenTestFile(PLATFORM_FILE_OPEN | PLATFORM_FILE_READ);
+  expected_count_ = kReadCount;
+  for (int i = 0; i < kReadCount; ++i) {
+    ASSERT_TRUE(io.Read(file, (i % 16) * kReadSize, kReadSize,
+                        Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  }
+  MessageLoop::current()->Run();
+  EXPECT_EQ(kReadCount, completed_count_);
+  EXPECT_EQ(File::FILE_OK, error_);
+  EXPECT_EQ(data.substr(((kReadCount - 1) % 16) * kReadSize, kReadSize),
+            data_);
+}
+
+TEST_F(AsyncFileIOTest, ReadInvalidFile) {
+  WriteTestFile("data");
+  AsyncFileIO io(file_task_runner());
+  // A file opened for writing only can't be read.
+  ASSERT_TRUE(io.Read(OpenTestFile(PLATFORM_FILE_OPEN | PLATFORM_FILE_WRITE),
+                      0, 4,
+                      Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  MessageLoop::current()->Run();
+  EXPECT_NE(File::FILE_OK, error_);
+}
+
+TEST_F(AsyncFileIOTest, InvalidArguments) {
+  AsyncFileIO io(file_task_runner());
+  PlatformFile file = OpenTestFile(PLATFORM_FILE_CREATE | PLATFORM_FILE_WRITE);
+  EXPECT_FALSE(io.Read(file, 0, -1,
+                       Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  EXPECT_FALSE(io.Read(file, -1, 1,
+                       Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  EXPECT_FALSE(io.Write(file, 0, "a", 0,
+                        Bind(&AsyncFileIOTest::DidWrite, Unretained(this))));
+}
+
+TEST_F(AsyncFileIOTest, DeleteCancelsCallbacks) {
+  WriteTestFile(MakeData(8192));
+  scoped_ptr<AsyncFileIO> io(new AsyncFileIO(file_task_runner()));
+  PlatformFile file = OpenTestFile(PLATFORM_FILE_OPEN | PLATFORM_FILE_READ);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(io->Read(file, 0, 8192,
+                         Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  }
+  io.reset();
+  // Makes sure the operations on the file thread are done.
+  file_thread_.Stop();
+  MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(0, completed_count_);
+}
+
+// Without an IO message loop, everything runs on the blocking task runner.
+TEST(AsyncFileIOWithoutIOLoopTest, Read) {
+  MessageLoop message_loop;
+  Thread file_thread("AsyncFileIOTestFileThread");
+  ASSERT_TRUE(file_thread.Start());
+  ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  FilePath path = dir.path().AppendASCII("test");
+  ASSERT_EQ(4, file_util::WriteFile(path, "data", 4));
+
+  AsyncFileIO io(file_thread.message_loop_proxy());
+  EXPECT_FALSE(io.IsUsingKernelAIO());
+  File file(path, File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(file.IsValid());
+  std::string data;
+  ASSERT_TRUE(io.Read(file.GetPlatformFile(), 1, 10,
+                      Bind(&ReadIntoString, &data)));
+  MessageLoop::current()->Run();
+  EXPECT_EQ("ata", data);
+}
+
+}  // namespace base
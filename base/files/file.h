@@ -261,6 +261,12 @@ class BASE_EXPORT File {
   // Unlock a file previously locked.
   Error Unlock();
 
+  // Returns a new object referencing this file, which can be used and closed
+  // independently, or an invalid object on failure. Both objects share the
+  // file position. On POSIX, closing the duplicate releases the locks taken
+  // with Lock().
+  File Duplicate();
+
 #if defined(OS_WIN)
   static Error OSErrorToFileError(DWORD last_error);
 #elif defined(OS_POSIX)
@@ -439,6 +439,19 @@ File::Error File::Unlock() {
   return CallFctnlFlock(file_, false);
 }
 
+File File::Duplicate() {
+  if (!IsValid())
+    return File();
+
+  PlatformFile other_fd = dup(GetPlatformFile());
+  if (other_fd == -1)
+    return File();
+
+  File other(other_fd);
+  other.async_ = async_;
+  return other.Pass();
+}
+
 // Static.
 File::Error File::OSErrorToFileError(int saved_errno) {
   switch (saved_errno) {
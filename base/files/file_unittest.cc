@@ -375,6 +375,31 @@ TEST(File, ReadFileAtCurrentPosition) {
             std::string(kData));
 }
 
+TEST(File, Duplicate) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath file_path = temp_dir.path().AppendASCII("duplicate_file");
+  File file(file_path,
+            base::File::FLAG_CREATE | base::File::FLAG_READ |
+                base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.IsValid());
+
+  File duplicate = file.Duplicate();
+  ASSERT_TRUE(duplicate.IsValid());
+  EXPECT_NE(file.GetPlatformFile(), duplicate.GetPlatformFile());
+
+  // The duplicate stays usable when the original is closed.
+  const char kData[] = "test";
+  const int kDataSize = arraysize(kData) - 1;
+  EXPECT_EQ(kDataSize, file.Write(0, kData, kDataSize));
+  file.Close();
+  char buffer[kDataSize];
+  EXPECT_EQ(kDataSize, duplicate.Read(0, buffer, kDataSize));
+  EXPECT_EQ(std::string(kData), std::string(buffer, buffer + kDataSize));
+
+  EXPECT_FALSE(file.Duplicate().IsValid());
+}
+
 #if defined(OS_WIN)
 TEST(File, GetInfoForDirectory) {
   base::ScopedTempDir temp_dir;
@@ -288,6 +288,26 @@ File::Error File::Unlock() {
   return FILE_OK;
 }
 
+File File::Duplicate() {
+  if (!IsValid())
+    return File();
+
+  HANDLE other_handle = NULL;
+  if (!::DuplicateHandle(GetCurrentProcess(),  // hSourceProcessHandle
+                         GetPlatformFile(),
+                         GetCurrentProcess(),  // hTargetProcessHandle
+                         &other_handle,
+                         0,  // dwDesiredAccess ignored due to SAME_ACCESS
+                         FALSE,  // !bInheritHandle
+                         DUPLICATE_SAME_ACCESS)) {
+    return File();
+  }
+
+  File other(other_handle);
+  other.async_ = async_;
+  return other.Pass();
+}
+
 // Static.
 File::Error File::OSErrorToFileError(DWORD last_error) {
   switch (last_error) {
@@ -4,11 +4,56 @@
 
 #include "base/files/memory_mapped_file.h"
 
+#include <algorithm>
+#include <limits>
+
+#include "base/bind.h"
 #include "base/files/file_path.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/sys_info.h"
+#include "base/task_runner.h"
 
 namespace base {
 
+namespace {
+
+// The size of the reads of PrefetchInBackground().
+const int kPrefetchChunkSize = 1024 * 1024;
+
+void PrefetchFileRegion(File file, int64 offset, int64 size) {
+  scoped_ptr<char[]> buffer(new char[kPrefetchChunkSize]);
+  while (size > 0) {
+    int chunk_size = static_cast<int>(std::min<int64>(size,
+                                                      kPrefetchChunkSize));
+    int result = file.Read(offset, buffer.get(), chunk_size);
+    if (result <= 0)
+      return;
+    offset += result;
+    size -= result;
+  }
+}
+
+}  // namespace
+
+const MemoryMappedFile::Region MemoryMappedFile::Region::kWholeFile(
+    LINKER_INITIALIZED);
+
+MemoryMappedFile::Region::Region(LinkerInitialized) : offset(0), size(0) {}
+
+MemoryMappedFile::Region::Region(int64 offset, int64 size)
+    : offset(offset),
+      size(size) {
+  DCHECK_GE(offset, 0);
+  DCHECK_GT(size, 0);
+}
+
+bool MemoryMappedFile::Region::operator==(
+    const MemoryMappedFile::Region& other) const {
+  return other.offset == offset && other.size == size;
+}
+
 MemoryMappedFile::~MemoryMappedFile() {
   CloseHandles();
 }
@@ -24,7 +69,7 @@ bool MemoryMappedFile::Initialize(const FilePath& file_name) {
     return false;
   }
 
-  if (!MapFileToMemory()) {
+  if (!MapFileRegionToMemory(Region::kWholeFile)) {
     CloseHandles();
     return false;
   }
@@ -33,12 +78,16 @@ bool MemoryMappedFile::Initialize(const FilePath& file_name) {
 }
 
 bool MemoryMappedFile::Initialize(File file) {
+  return Initialize(file.Pass(), Region::kWholeFile);
+}
+
+bool MemoryMappedFile::Initialize(File file, const Region& region) {
   if (IsValid())
     return false;
 
   file_ = file.Pass();
 
-  if (!MapFileToMemory()) {
+  if (!MapFileRegionToMemory(region)) {
     CloseHandles();
     return false;
   }
@@ -50,4 +99,29 @@ bool MemoryMappedFile::IsValid() const {
   return data_ != NULL;
 }
 
+bool MemoryMappedFile::PrefetchInBackground(TaskRunner* task_runner) {
+  DCHECK(IsValid());
+  File file = file_.Duplicate();
+  if (!file.IsValid())
+    return false;
+  return task_runner->PostTask(
+      FROM_HERE,
+      Bind(&PrefetchFileRegion, Passed(&file), file_offset_,
+           static_cast<int64>(length_)));
+}
+
+// static
+void MemoryMappedFile::CalculateVMAlignedBoundaries(int64 start,
+                                                    int64 size,
+                                                    int64* aligned_start,
+                                                    int64* aligned_size,
+                                                    int32* offset) {
+  // Sadly, on Windows, the mmap alignment is not just equal to the page size.
+  const int64 mask = static_cast<int64>(SysInfo::VMAllocationGranularity()) - 1;
+  DCHECK_LT(mask, std::numeric_limits<int32>::max());
+  *offset = start & mask;
+  *aligned_start = start & ~mask;
+  *aligned_size = (size + *offset + mask) & ~mask;
+}
+
 }  // namespace base
@@ -17,9 +17,41 @@
 namespace base {
 
 class FilePath;
+class TaskRunner;
 
 class BASE_EXPORT MemoryMappedFile {
  public:
+  // Used to hold information about a region [offset + size] of a file.
+  struct BASE_EXPORT Region {
+    static const Region kWholeFile;
+
+    Region(int64 offset, int64 size);
+
+    bool operator==(const Region& other) const;
+
+    // Start of the region (measured in bytes from the beginning of the file).
+    int64 offset;
+
+    // Length of the region in bytes.
+    int64 size;
+
+   private:
+    // This ctor is used only by kWholeFile, to construct a zero-sized Region.
+    explicit Region(LinkerInitialized);
+  };
+
+  // How the mapped data is going to be accessed, see Advise().
+  enum AccessHint {
+    // In no particular order. Reading ahead of the faulting page is useless.
+    ACCESS_RANDOM,
+    // From the start to the end. Reading ahead is more aggressive, and the
+    // pages behind can be dropped early.
+    ACCESS_SEQUENTIAL,
+    // Soon, all of it. Starts reading the data from disk without waiting for
+    // it.
+    ACCESS_WILL_NEED,
+  };
+
   // The default constructor sets all members to invalid/null values.
   MemoryMappedFile();
   ~MemoryMappedFile();
@@ -35,6 +67,10 @@ class BASE_EXPORT MemoryMappedFile {
   // ownership of |file| and closes it when done.
   bool Initialize(File file);
 
+  // As above, but maps only the specified |region| of the file. |region| does
+  // not need to be aligned to pages.
+  bool Initialize(File file, const Region& region);
+
 #if defined(OS_WIN)
   // Opens an existing file and maps it as an image section. Please refer to
   // the Initialize function above for additional information.
@@ -47,10 +83,35 @@ class BASE_EXPORT MemoryMappedFile {
   // Is file_ a valid file handle that points to an open, memory mapped file?
   bool IsValid() const;
 
+  // Tells the OS how the mapping is going to be accessed, which makes it
+  // read the right pages ahead of the faults that need them. A best-effort
+  // hint: unsupported hints are ignored.
+  void Advise(AccessHint hint);
+
+  // Reads the mapped region of the file on |task_runner|, so that the page
+  // faults that follow are served from the page cache instead of the disk.
+  // Unlike ACCESS_WILL_NEED, it is not limited by the readahead window of the
+  // OS, and it works everywhere. The read uses a duplicate of the file handle,
+  // so this object can go away before it is done. Returns false if the task
+  // could not be posted.
+  bool PrefetchInBackground(TaskRunner* task_runner);
+
  private:
+  // Given the arbitrarily aligned memory region [start, size], returns the
+  // boundaries of the region aligned to the granularity specified by the OS,
+  // (a page on Linux, ~32-64 kB on Windows) as follows:
+  // - |aligned_start| is page aligned and <= |start|.
+  // - |aligned_size| is a multiple of the VM granularity and >= |size|.
+  // - |offset| is the displacement of |start| w.r.t |aligned_start|.
+  static void CalculateVMAlignedBoundaries(int64 start,
+                                           int64 size,
+                                           int64* aligned_start,
+                                           int64* aligned_size,
+                                           int32* offset);
+
   // Map the file to memory, set data_ to that memory address. Return true on
   // success, false on any kind of failure. This is a helper for Initialize().
-  bool MapFileToMemory();
+  bool MapFileRegionToMemory(const Region& region);
 
   // Closes all open handles.
   void CloseHandles();
@@ -58,6 +119,11 @@ class BASE_EXPORT MemoryMappedFile {
   File file_;
   uint8* data_;
   size_t length_;
+  // Offset of |data_| from the start of the mapping, when the mapped region
+  // does not start on a VM boundary.
+  int32 data_offset_;
+  // The mapped region of the file, for PrefetchInBackground().
+  int64 file_offset_;
 
 #if defined(OS_WIN)
   win::ScopedHandle file_mapping_;
@@ -0,0 +1,126 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Resource packs, ICU data and V8 snapshots are mapped at startup, when none
+// of them is in the page cache yet. Simulate that by evicting a mapped file
+// from the page cache, then count the major page faults and the time it takes
+// to touch all of it with each of the access hints.
+
+#include "base/files/memory_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+namespace {
+
+const int kFileSize = 64 * 1024 * 1024;
+const size_t kPageSize = 4096;
+
+enum Mode {
+  MODE_NO_HINT,
+  MODE_SEQUENTIAL,
+  MODE_WILL_NEED,
+  MODE_PREFETCH_IN_BACKGROUND,
+};
+
+const char* const kModeNames[] = {
+  "no_hint",
+  "sequential",
+  "will_need",
+  "prefetch_in_background",
+};
+
+long GetMajorFaultCount() {
+  struct rusage usage;
+  CHECK_EQ(0, getrusage(RUSAGE_SELF, &usage));
+  return usage.ru_majflt;
+}
+
+class MemoryMappedFilePerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("data");
+    std::string data(kFileSize, 'a');
+    ASSERT_EQ(kFileSize,
+              file_util::WriteFile(path_, data.data(), data.size()));
+  }
+
+  // Drops the file from the page cache, which works for clean pages only.
+  void EvictFile() {
+    File file(path_, File::FLAG_OPEN | File::FLAG_READ);
+    ASSERT_TRUE(file.IsValid());
+    ASSERT_EQ(0, fdatasync(file.GetPlatformFile()));
+    ASSERT_EQ(0, posix_fadvise(file.GetPlatformFile(), 0, 0,
+                               POSIX_FADV_DONTNEED));
+  }
+
+  void RunTest(Mode mode) {
+    EvictFile();
+    Thread thread("MemoryMappedFilePerfTest");
+    ASSERT_TRUE(thread.Start());
+    const long major_faults_before = GetMajorFaultCount();
+    PerfTimeLogger timer(StringPrintf("MemoryMappedFile: %s size=%d",
+                                      kModeNames[mode], kFileSize).c_str());
+    MemoryMappedFile map;
+    ASSERT_TRUE(map.Initialize(path_));
+    switch (mode) {
+      case MODE_NO_HINT:
+        break;
+      case MODE_SEQUENTIAL:
+        map.Advise(MemoryMappedFile::ACCESS_SEQUENTIAL);
+        break;
+      case MODE_WILL_NEED:
+        map.Advise(MemoryMappedFile::ACCESS_WILL_NEED);
+        break;
+      case MODE_PREFETCH_IN_BACKGROUND:
+        ASSERT_TRUE(map.PrefetchInBackground(
+            thread.message_loop_proxy().get()));
+        break;
+    }
+    int sum = 0;
+    for (size_t i = 0; i < map.length(); i += kPageSize)
+      sum += map.data()[i];
+    timer.Done();
+    EXPECT_EQ(static_cast<int>('a' * (map.length() / kPageSize)), sum);
+    perf_test::PrintResult(
+        "major_faults", "", kModeNames[mode],
+        static_cast<size_t>(GetMajorFaultCount() - major_faults_before),
+        "faults", true);
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+TEST_F(MemoryMappedFilePerfTest, NoHint) {
+  RunTest(MODE_NO_HINT);
+}
+
+TEST_F(MemoryMappedFilePerfTest, Sequential) {
+  RunTest(MODE_SEQUENTIAL);
+}
+
+TEST_F(MemoryMappedFilePerfTest, WillNeed) {
+  RunTest(MODE_WILL_NEED);
+}
+
+TEST_F(MemoryMappedFilePerfTest, PrefetchInBackground) {
+  RunTest(MODE_PREFETCH_IN_BACKGROUND);
+}
+
+}  // namespace
+}  // namespace base
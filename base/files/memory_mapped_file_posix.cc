@@ -8,41 +8,109 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <limits>
+
 #include "base/logging.h"
 #include "base/threading/thread_restrictions.h"
 
 namespace base {
 
-MemoryMappedFile::MemoryMappedFile() : data_(NULL), length_(0) {
+MemoryMappedFile::MemoryMappedFile()
+    : data_(NULL),
+      length_(0),
+      data_offset_(0),
+      file_offset_(0) {
 }
 
-bool MemoryMappedFile::MapFileToMemory() {
+bool MemoryMappedFile::MapFileRegionToMemory(
+    const MemoryMappedFile::Region& region) {
   ThreadRestrictions::AssertIOAllowed();
 
-  struct stat file_stat;
-  if (fstat(file_.GetPlatformFile(), &file_stat) == -1 ) {
-    DPLOG(ERROR) << "fstat " << file_.GetPlatformFile();
-    return false;
+  off_t map_start = 0;
+  size_t map_size = 0;
+  int32 data_offset = 0;
+
+  if (region == MemoryMappedFile::Region::kWholeFile) {
+    struct stat file_stat;
+    if (fstat(file_.GetPlatformFile(), &file_stat) == -1 ) {
+      DPLOG(ERROR) << "fstat " << file_.GetPlatformFile();
+      return false;
+    }
+    map_size = file_stat.st_size;
+    length_ = map_size;
+    file_offset_ = 0;
+  } else {
+    // The region can be arbitrarily aligned. mmap, instead, requires the start
+    // to be page-aligned. Hence, we map here the page-aligned outer region
+    // [|aligned_start|, |region.offset| + |region.size|] and then add up the
+    // |data_offset| displacement.
+    int64 aligned_start = 0;
+    int64 aligned_size = 0;
+    CalculateVMAlignedBoundaries(region.offset,
+                                 region.size,
+                                 &aligned_start,
+                                 &aligned_size,
+                                 &data_offset);
+
+    // Ensure that the casts in the mmap call below are sane.
+    if (aligned_start < 0 || region.size < 0 ||
+        static_cast<uint64>(region.size + data_offset) >
+            std::numeric_limits<size_t>::max() ||
+        static_cast<uint64>(aligned_start) >
+            static_cast<uint64>(std::numeric_limits<off_t>::max())) {
+      DLOG(ERROR) << "Region bounds are not valid for mmap";
+      return false;
+    }
+
+    map_start = static_cast<off_t>(aligned_start);
+    map_size = static_cast<size_t>(region.size + data_offset);
+    length_ = static_cast<size_t>(region.size);
+    file_offset_ = region.offset;
   }
-  length_ = file_stat.st_size;
 
-  data_ = static_cast<uint8*>(
-      mmap(NULL, length_, PROT_READ, MAP_SHARED, file_.GetPlatformFile(), 0));
-  if (data_ == MAP_FAILED)
+  data_ = static_cast<uint8*>(mmap(NULL, map_size, PROT_READ, MAP_SHARED,
+                                   file_.GetPlatformFile(), map_start));
+  if (data_ == MAP_FAILED) {
     DPLOG(ERROR) << "mmap " << file_.GetPlatformFile();
+    data_ = NULL;
+    length_ = 0;
+    return false;
+  }
 
-  return data_ != MAP_FAILED;
+  data_offset_ = data_offset;
+  data_ += data_offset;
+  return true;
+}
+
+void MemoryMappedFile::Advise(AccessHint hint) {
+  DCHECK(IsValid());
+  int advice = MADV_NORMAL;
+  switch (hint) {
+    case ACCESS_RANDOM:
+      advice = MADV_RANDOM;
+      break;
+    case ACCESS_SEQUENTIAL:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case ACCESS_WILL_NEED:
+      advice = MADV_WILLNEED;
+      break;
+  }
+  if (madvise(data_ - data_offset_, length_ + data_offset_, advice) != 0)
+    DPLOG(ERROR) << "madvise";
 }
 
 void MemoryMappedFile::CloseHandles() {
   ThreadRestrictions::AssertIOAllowed();
 
   if (data_ != NULL)
-    munmap(data_, length_);
+    munmap(data_ - data_offset_, length_ + data_offset_);
   file_.Close();
 
   data_ = NULL;
   length_ = 0;
+  data_offset_ = 0;
+  file_offset_ = 0;
 }
 
 }  // namespace base
@@ -0,0 +1,162 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/memory_mapped_file.h"
+
+#include <string.h>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace base {
+
+namespace {
+
+// Create a temporary buffer and fill it with a watermark sequence.
+scoped_ptr<uint8[]> CreateTestBuffer(size_t size, size_t offset) {
+  scoped_ptr<uint8[]> buf(new uint8[size]);
+  for (size_t i = 0; i < size; ++i)
+    buf.get()[i] = static_cast<uint8>((offset + i) % 253);
+  return buf.Pass();
+}
+
+// Check that the watermark sequence is consistent with the |offset| provided.
+bool CheckBufferContents(const uint8* data, size_t size, size_t offset) {
+  scoped_ptr<uint8[]> test_data(CreateTestBuffer(size, offset));
+  return memcmp(test_data.get(), data, size) == 0;
+}
+
+class MemoryMappedFileTest : public PlatformTest {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    temp_file_path_ = temp_dir_.path().AppendASCII("mapped_file");
+  }
+
+  void CreateTemporaryTestFile(size_t size) {
+    File file(temp_file_path_,
+              File::FLAG_CREATE_ALWAYS | File::FLAG_READ | File::FLAG_WRITE);
+    ASSERT_TRUE(file.IsValid());
+
+    scoped_ptr<uint8[]> test_data(CreateTestBuffer(size, 0));
+    size_t bytes_written =
+        file.Write(0, reinterpret_cast<char*>(test_data.get()), size);
+    ASSERT_EQ(size, bytes_written);
+  }
+
+  File OpenTestFile() {
+    return File(temp_file_path_, File::FLAG_OPEN | File::FLAG_READ);
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath temp_file_path_;
+};
+
+TEST_F(MemoryMappedFileTest, MapWholeFileByPath) {
+  const size_t kFileSize = 68 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(temp_file_path_));
+  ASSERT_EQ(kFileSize, map.length());
+  ASSERT_TRUE(map.data() != NULL);
+  EXPECT_TRUE(map.IsValid());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kFileSize, 0));
+}
+
+TEST_F(MemoryMappedFileTest, MapWholeFileUsingRegion) {
+  const size_t kFileSize = 68 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region::kWholeFile));
+  ASSERT_EQ(kFileSize, map.length());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kFileSize, 0));
+}
+
+TEST_F(MemoryMappedFileTest, MapPartialRegionAtBeginning) {
+  const size_t kFileSize = 68 * 1024;
+  const size_t kPartialSize = 4 * 1024 + 32;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region(0, kPartialSize)));
+  ASSERT_EQ(kPartialSize, map.length());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, 0));
+}
+
+TEST_F(MemoryMappedFileTest, MapPartialRegionAtEnd) {
+  const size_t kFileSize = 68 * 1024;
+  const size_t kPartialSize = 16 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  const size_t kOffset = kFileSize - kPartialSize;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region(kOffset, kPartialSize)));
+  ASSERT_EQ(kPartialSize, map.length());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, kOffset));
+}
+
+TEST_F(MemoryMappedFileTest, MapSmallPartialRegionInTheMiddle) {
+  const size_t kFileSize = 68 * 1024;
+  const size_t kOffset = 1024 * 5 + 32;
+  const size_t kPartialSize = 8;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region(kOffset, kPartialSize)));
+  ASSERT_EQ(kPartialSize, map.length());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, kOffset));
+}
+
+TEST_F(MemoryMappedFileTest, MapLargePartialRegionInTheMiddle) {
+  const size_t kFileSize = 157 * 1024;
+  const size_t kOffset = 1024 * 5 + 32;
+  const size_t kPartialSize = 16 * 1024 - 32;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region(kOffset, kPartialSize)));
+  ASSERT_EQ(kPartialSize, map.length());
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, kOffset));
+}
+
+TEST_F(MemoryMappedFileTest, AdviseKeepsContents) {
+  const size_t kFileSize = 68 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  const size_t kOffset = 1024 + 7;
+  const size_t kPartialSize = kFileSize - kOffset;
+  ASSERT_TRUE(map.Initialize(OpenTestFile(),
+                             MemoryMappedFile::Region(kOffset, kPartialSize)));
+  map.Advise(MemoryMappedFile::ACCESS_WILL_NEED);
+  map.Advise(MemoryMappedFile::ACCESS_SEQUENTIAL);
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, kOffset));
+  map.Advise(MemoryMappedFile::ACCESS_RANDOM);
+  ASSERT_TRUE(CheckBufferContents(map.data(), kPartialSize, kOffset));
+}
+
+TEST_F(MemoryMappedFileTest, PrefetchInBackground) {
+  const size_t kFileSize = 3 * 1024 * 1024 + 100;
+  CreateTemporaryTestFile(kFileSize);
+  Thread thread("MemoryMappedFilePrefetch");
+  ASSERT_TRUE(thread.Start());
+  scoped_ptr<MemoryMappedFile> map(new MemoryMappedFile);
+  ASSERT_TRUE(map->Initialize(OpenTestFile(),
+                              MemoryMappedFile::Region(100, kFileSize - 100)));
+  ASSERT_TRUE(map->PrefetchInBackground(thread.message_loop_proxy().get()));
+  ASSERT_TRUE(CheckBufferContents(map->data(), kFileSize - 100, 100));
+  // The prefetch does not depend on the mapping.
+  ASSERT_TRUE(map->PrefetchInBackground(thread.message_loop_proxy().get()));
+  map.reset();
+  thread.Stop();
+}
+
+}  // namespace
+
+}  // namespace base
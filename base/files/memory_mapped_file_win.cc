@@ -4,13 +4,36 @@
 
 #include "base/files/memory_mapped_file.h"
 
+#include <limits>
+
 #include "base/files/file_path.h"
+#include "base/logging.h"
 #include "base/strings/string16.h"
 #include "base/threading/thread_restrictions.h"
 
 namespace base {
 
-MemoryMappedFile::MemoryMappedFile() : data_(NULL), length_(0), image_(false) {
+namespace {
+
+// PrefetchVirtualMemory() is available on Windows 8 and later only.
+struct Win32MemoryRangeEntry {
+  PVOID VirtualAddress;
+  SIZE_T NumberOfBytes;
+};
+typedef BOOL (WINAPI* PrefetchVirtualMemoryFunction)(
+    HANDLE process,
+    ULONG_PTR number_of_entries,
+    Win32MemoryRangeEntry* virtual_addresses,
+    ULONG flags);
+
+}  // namespace
+
+MemoryMappedFile::MemoryMappedFile()
+    : data_(NULL),
+      length_(0),
+      data_offset_(0),
+      file_offset_(0),
+      image_(false) {
 }
 
 bool MemoryMappedFile::InitializeAsImageSection(const FilePath& file_name) {
@@ -18,17 +41,13 @@ bool MemoryMappedFile::InitializeAsImageSection(const FilePath& file_name) {
   return Initialize(file_name);
 }
 
-bool MemoryMappedFile::MapFileToMemory() {
+bool MemoryMappedFile::MapFileRegionToMemory(
+    const MemoryMappedFile::Region& region) {
   ThreadRestrictions::AssertIOAllowed();
 
   if (!file_.IsValid())
     return false;
 
-  int64 len = file_.GetLength();
-  if (len <= 0 || len > kint32max)
-    return false;
-  length_ = static_cast<size_t>(len);
-
   int flags = image_ ? SEC_IMAGE | PAGE_READONLY : PAGE_READONLY;
 
   file_mapping_.Set(::CreateFileMapping(file_.GetPlatformFile(), NULL,
@@ -36,14 +55,74 @@ bool MemoryMappedFile::MapFileToMemory() {
   if (!file_mapping_.IsValid())
     return false;
 
+  LARGE_INTEGER map_start = {};
+  SIZE_T map_size = 0;
+  int32 data_offset = 0;
+
+  if (region == MemoryMappedFile::Region::kWholeFile) {
+    int64 file_len = file_.GetLength();
+    if (file_len <= 0 || file_len > kint32max)
+      return false;
+    length_ = static_cast<size_t>(file_len);
+    file_offset_ = 0;
+  } else {
+    // The region can be arbitrarily aligned. MapViewOfFile, instead, requires
+    // that the start address is aligned to the VM granularity (which is
+    // typically larger than a page size, for instance 32k).
+    // Also, conversely to POSIX's mmap, the |map_size| doesn't have to be
+    // aligned and must be less than or equal the mapped file size.
+    // We map here the outer region [|aligned_start|, |region.offset| +
+    // |region.size|] which contains |region| and then add up the
+    // |data_offset| displacement.
+    int64 aligned_start = 0;
+    int64 ignored = 0;
+    CalculateVMAlignedBoundaries(
+        region.offset, region.size, &aligned_start, &ignored, &data_offset);
+    int64 size = region.size + data_offset;
+
+    // Ensure that the casts below in the MapViewOfFile call are sane.
+    if (aligned_start < 0 || size < 0 ||
+        static_cast<uint64>(size) > std::numeric_limits<SIZE_T>::max()) {
+      DLOG(ERROR) << "Region bounds are not valid for MapViewOfFile";
+      return false;
+    }
+    map_start.QuadPart = aligned_start;
+    map_size = static_cast<SIZE_T>(size);
+    length_ = static_cast<size_t>(region.size);
+    file_offset_ = region.offset;
+  }
+
   data_ = static_cast<uint8*>(::MapViewOfFile(file_mapping_.Get(),
-                                              FILE_MAP_READ, 0, 0, 0));
-  return data_ != NULL;
+                                              FILE_MAP_READ,
+                                              map_start.HighPart,
+                                              map_start.LowPart,
+                                              map_size));
+  if (data_ == NULL)
+    return false;
+  data_offset_ = data_offset;
+  data_ += data_offset;
+  return true;
+}
+
+void MemoryMappedFile::Advise(AccessHint hint) {
+  DCHECK(IsValid());
+  // Windows reads ahead of the faults in mapped files on its own. Only the
+  // explicit prefetch has an API.
+  if (hint != ACCESS_WILL_NEED)
+    return;
+  static PrefetchVirtualMemoryFunction prefetch_virtual_memory =
+      reinterpret_cast<PrefetchVirtualMemoryFunction>(::GetProcAddress(
+          ::GetModuleHandle(L"kernel32.dll"), "PrefetchVirtualMemory"));
+  if (!prefetch_virtual_memory)
+    return;
+  Win32MemoryRangeEntry range = { data_, length_ };
+  if (!prefetch_virtual_memory(::GetCurrentProcess(), 1, &range, 0))
+    DPLOG(ERROR) << "PrefetchVirtualMemory";
 }
 
 void MemoryMappedFile::CloseHandles() {
   if (data_)
-    ::UnmapViewOfFile(data_);
+    ::UnmapViewOfFile(data_ - data_offset_);
   if (file_mapping_.IsValid())
     file_mapping_.Close();
   if (file_.IsValid())
@@ -51,6 +130,8 @@ void MemoryMappedFile::CloseHandles() {
 
   data_ = NULL;
   length_ = 0;
+  data_offset_ = 0;
+  file_offset_ = 0;
 }
 
 }  // namespace base
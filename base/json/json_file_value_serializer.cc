@@ -5,6 +5,7 @@
 #include "base/json/json_file_value_serializer.h"
 
 #include "base/file_util.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/logging.h"
 
@@ -97,3 +98,24 @@ base::Value* JSONFileValueSerializer::Deserialize(int* error_code,
   serializer.set_allow_trailing_comma(allow_trailing_comma_);
   return serializer.Deserialize(error_code, error_str);
 }
+
+bool JSONFileValueSerializer::DeserializeWithDelegate(
+    base::JSONReader::Delegate* delegate,
+    int* error_code,
+    std::string* error_str) {
+  std::string json_string;
+  int error = ReadFileToString(&json_string);
+  if (error != JSON_NO_ERROR) {
+    if (error_code)
+      *error_code = error;
+    if (error_str)
+      *error_str = GetErrorMessageForCode(error);
+    return false;
+  }
+
+  return base::JSONReader::ReadWithDelegate(
+      json_string,
+      allow_trailing_comma_ ? base::JSON_ALLOW_TRAILING_COMMAS
+                            : base::JSON_PARSE_RFC,
+      delegate, error_code, error_str);
+}
@@ -10,6 +10,7 @@
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/files/file_path.h"
+#include "base/json/json_reader.h"
 #include "base/values.h"
 
 class BASE_EXPORT JSONFileValueSerializer : public base::ValueSerializer {
@@ -48,6 +49,14 @@ class BASE_EXPORT JSONFileValueSerializer : public base::ValueSerializer {
   virtual base::Value* Deserialize(int* error_code,
                                    std::string* error_message) OVERRIDE;
 
+  // Like Deserialize(), but reports the contents of the file to |delegate|
+  // instead of building a Value, see base::JSONReader::ReadWithDelegate().
+  // Cheaper for callers that only look at a part of a large file. Returns
+  // false on failure, with |error_code| and |error_message| set as above.
+  bool DeserializeWithDelegate(base::JSONReader::Delegate* delegate,
+                               int* error_code,
+                               std::string* error_message);
+
   // This enum is designed to safely overlap with JSONReader::JsonParseError.
   enum JsonFileError {
     JSON_NO_ERROR = 0,
@@ -66,6 +66,12 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Parses the input string according to the set options and reports its
+  // contents to |delegate|, see JSONReader::ReadWithDelegate(). The input is
+  // not copied. Returns false on error, or if |delegate| stopped parsing.
+  bool ParseWithDelegate(const StringPiece& input,
+                         JSONReader::Delegate* delegate);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -143,6 +149,14 @@ class BASE_EXPORT_PRIVATE JSONParser {
     std::string* string_;
   };
 
+  // Winds the parser to the start of |length| bytes at |start|, skipping a
+  // UTF-8 Byte-Order-Mark.
+  void StartParsing(const char* start, size_t length);
+
+  // Called after the root value was consumed. Returns true if only whitespace
+  // and comments follow it, and reports an error otherwise.
+  bool ConsumeEndOfInput();
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -202,6 +216,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Helper for ConsumeNumber() that validates the number and puts the bytes
+  // making it up into |out|. Returns false on failure with error information
+  // set.
+  bool ConsumeNumberRaw(StringPiece* out);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -209,6 +227,24 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Helper for ConsumeLiteral() that returns T_BOOL_TRUE, T_BOOL_FALSE or
+  // T_NULL for the literal, and T_INVALID_TOKEN with error information set if
+  // it is malformed.
+  Token ConsumeLiteralRaw();
+
+  // The counterparts of the Parse and Consume functions above used by
+  // ParseWithDelegate(). Rather than returning a Value, they report it to
+  // |delegate_| and return false if parsing should stop.
+  bool EmitNextToken();
+  bool EmitToken(Token token);
+  bool EmitDictionary();
+  bool EmitList();
+  bool EmitString();
+  bool EmitNumber();
+  bool EmitLiteral();
+
+  // Reports JSON_PARSE_ABORTED if |delegate_| returned |false| for an event.
+  bool CheckDelegateResult(bool result);
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
@@ -226,6 +262,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // base::JSONParserOptions that control parsing.
   int options_;
 
+  // Receives the events during ParseWithDelegate(). Weak.
+  JSONReader::Delegate* delegate_;
+
   // Pointer to the start of the input data.
   const char* start_pos_;
 
@@ -73,6 +73,7 @@ class BASE_EXPORT JSONReader {
     JSON_UNEXPECTED_DATA_AFTER_ROOT,
     JSON_UNSUPPORTED_ENCODING,
     JSON_UNQUOTED_DICTIONARY_KEY,
+    JSON_PARSE_ABORTED,
     JSON_PARSE_ERROR_COUNT
   };
 
@@ -85,6 +86,33 @@ class BASE_EXPORT JSONReader {
   static const char* kUnexpectedDataAfterRoot;
   static const char* kUnsupportedEncoding;
   static const char* kUnquotedDictionaryKey;
+  static const char* kParseAborted;
+
+  // Receives the contents of a JSON document as it is parsed, without a
+  // Value being built for it; see ReadWithDelegate(). Each method returns
+  // false to stop parsing, which then fails with JSON_PARSE_ABORTED.
+  //
+  // The StringPieces passed to OnString() and OnDictionaryKey() point into
+  // the input when the string has no escape sequences, so most strings
+  // aren't copied. Either way they are only valid during the call.
+  class BASE_EXPORT Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    virtual bool OnNull() = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+    virtual bool OnString(const StringPiece& value) = 0;
+
+    // The key of each entry is reported before its value.
+    virtual bool OnDictionaryBegin() = 0;
+    virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+    virtual bool OnDictionaryEnd() = 0;
+
+    virtual bool OnListBegin() = 0;
+    virtual bool OnListEnd() = 0;
+  };
 
   // Constructs a reader with the default options, JSON_PARSE_RFC.
   JSONReader();
@@ -112,6 +140,17 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Parses |json| like ReadAndReturnError(), but reports its contents to
+  // |delegate| instead of returning a Value. Returns true if the whole input
+  // was parsed. JSON_DETACHABLE_CHILDREN is ignored. On failure, the events
+  // reported so far must be discarded by the delegate; |error_code_out| and
+  // |error_msg_out| are optional and populated as by ReadAndReturnError().
+  static bool ReadWithDelegate(const StringPiece& json,
+                               int options,  // JSONParserOptions
+                               Delegate* delegate,
+                               int* error_code_out,
+                               std::string* error_msg_out);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
@@ -0,0 +1,151 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Profile Preferences files reach several megabytes with many extensions
+// installed, and are parsed on startup. Measure building the Value tree
+// against streaming the document to a delegate that only looks at a part of
+// it, on a synthetic file of the same shape.
+
+#include "base/json/json_reader.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+// About the size of the largest Preferences files seen in the field.
+const size_t kPreferencesSize = 5 * 1024 * 1024;
+
+const int kIterations = 10;
+
+// Returns a Preferences-like document of at least |size| bytes: mostly
+// per-extension dictionaries of strings, numbers, booleans and lists.
+std::string CreatePreferences(size_t size) {
+  std::string json =
+      "{\"browser\": {\"window_placement\": {\"bottom\": 1040, \"left\": 10,"
+      " \"maximized\": false}, \"show_home_button\": true},"
+      " \"extensions\": {\"settings\": {";
+  for (int i = 0; json.size() < size; ++i) {
+    if (i)
+      json += ",";
+    StringAppendF(
+        &json,
+        "\"%032d\": {\"active_permissions\": {\"api\": [\"storage\", \"tabs\","
+        " \"webRequest\"], \"explicit_host\": [\"https://*.example.com/*\"]},"
+        " \"creation_flags\": %d, \"from_webstore\": %s,"
+        " \"install_time\": \"1303746722%07d\", \"location\": 1,"
+        " \"manifest\": {\"description\": \"Extension number %d, with a"
+        " description long enough to be typical.\", \"name\": \"Extension"
+        " %d\", \"version\": \"1.%d.0\", \"icons\": {\"16\": \"icon16.png\","
+        " \"128\": \"icon128.png\"}}, \"path\": \"C:\\\\Users\\\\Default\\\\"
+        "Extensions\\\\%032d\", \"state\": 1, \"was_installed_by_default\":"
+        " false, \"rating\": 4.5}",
+        i, i % 8, i % 2 ? "true" : "false", i, i, i, i % 100, i);
+  }
+  json += "}}, \"uninstall_metrics\": {\"launch_count\": \"11\"},"
+          " \"user_experience_metrics\": {\"reporting_enabled\": true}}";
+  return json;
+}
+
+// Finds the value of one top-level string preference, as a loader picking a
+// few entries out of the file would.
+class FindPreferenceDelegate : public JSONReader::Delegate {
+ public:
+  explicit FindPreferenceDelegate(const std::string& name)
+      : name_(name), depth_(0), at_name_(false) {
+  }
+
+  const std::string& value() const { return value_; }
+
+  virtual bool OnNull() OVERRIDE { return OnScalar(); }
+  virtual bool OnBoolean(bool value) OVERRIDE { return OnScalar(); }
+  virtual bool OnInteger(int value) OVERRIDE { return OnScalar(); }
+  virtual bool OnDouble(double value) OVERRIDE { return OnScalar(); }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    if (at_name_)
+      value.CopyToString(&value_);
+    return OnScalar();
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    ++depth_;
+    at_name_ = false;
+    return true;
+  }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    at_name_ = depth_ == 1 && key == name_;
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    --depth_;
+    return true;
+  }
+  virtual bool OnListBegin() OVERRIDE {
+    ++depth_;
+    at_name_ = false;
+    return true;
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    --depth_;
+    return true;
+  }
+
+ private:
+  bool OnScalar() {
+    at_name_ = false;
+    return true;
+  }
+
+  const std::string name_;
+  int depth_;
+  bool at_name_;
+  std::string value_;
+};
+
+TEST(JSONReaderPerfTest, Preferences) {
+  const std::string json = CreatePreferences(kPreferencesSize);
+  const std::string size_suffix =
+      StringPrintf(" size=%d repeat=%d", static_cast<int>(json.size()),
+                   kIterations);
+
+  {
+    PerfTimeLogger timer(("JSONReader::Read" + size_suffix).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      scoped_ptr<Value> root(JSONReader::Read(json));
+      ASSERT_TRUE(root.get());
+    }
+    timer.Done();
+  }
+
+  {
+    PerfTimeLogger timer(
+        ("JSONReader::Read detachable" + size_suffix).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      scoped_ptr<Value> root(
+          JSONReader::Read(json, JSON_DETACHABLE_CHILDREN));
+      ASSERT_TRUE(root.get());
+    }
+    timer.Done();
+  }
+
+  {
+    PerfTimeLogger timer(
+        ("JSONReader::ReadWithDelegate" + size_suffix).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      FindPreferenceDelegate delegate("nonexistent");
+      ASSERT_TRUE(JSONReader::ReadWithDelegate(json, JSON_PARSE_RFC,
+                                               &delegate, NULL, NULL));
+    }
+    timer.Done();
+  }
+}
+
+}  // namespace
+}  // namespace base
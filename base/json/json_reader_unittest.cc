@@ -9,6 +9,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
@@ -17,6 +18,70 @@
 
 namespace base {
 
+namespace {
+
+// Writes the events it receives in a compact form, and remembers whether
+// the strings pointed into |input|. Stops after |max_events| events.
+class RecordingDelegate : public JSONReader::Delegate {
+ public:
+  explicit RecordingDelegate(const StringPiece& input)
+      : input_(input),
+        max_events_(-1),
+        events_(0),
+        all_strings_borrowed_(true) {
+  }
+
+  const std::string& record() const { return record_; }
+  bool all_strings_borrowed() const { return all_strings_borrowed_; }
+  void set_max_events(int max_events) { max_events_ = max_events; }
+
+  virtual bool OnNull() OVERRIDE { return Record("null"); }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "true" : "false");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record("i" + IntToString(value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record("d" + DoubleToString(value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    CheckBorrowed(value);
+    return Record("'" + value.as_string() + "'");
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    CheckBorrowed(key);
+    return Record(key.as_string() + ":");
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Record("}"); }
+  virtual bool OnListBegin() OVERRIDE { return Record("["); }
+  virtual bool OnListEnd() OVERRIDE { return Record("]"); }
+
+ private:
+  bool Record(const std::string& event) {
+    if (!record_.empty())
+      record_.append(" ");
+    record_.append(event);
+    return ++events_ != max_events_;
+  }
+
+  void CheckBorrowed(const StringPiece& piece) {
+    if (piece.data() < input_.data() ||
+        piece.data() + piece.size() > input_.data() + input_.size()) {
+      all_strings_borrowed_ = false;
+    }
+  }
+
+  StringPiece input_;
+  int max_events_;
+  int events_;
+  bool all_strings_borrowed_;
+  std::string record_;
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   scoped_ptr<Value> root;
@@ -653,4 +718,72 @@ TEST(JSONReaderTest, IllegalTrailingNull) {
   EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, reader.error_code());
 }
 
+TEST(JSONReaderTest, ReadWithDelegate) {
+  const std::string json(
+      "{\"list\": [1, -2.5, true, false, null, \"str\"],"
+      " \"dict\": {\"a\": {}, \"b\": []}, \"big\": 1e10} ");
+  RecordingDelegate delegate(json);
+  EXPECT_TRUE(JSONReader::ReadWithDelegate(json, JSON_PARSE_RFC, &delegate,
+                                           NULL, NULL));
+  EXPECT_EQ("{ list: [ i1 d-2.5 true false null 'str' ] "
+            "dict: { a: { } b: [ ] } big: d1e+10 }",
+            delegate.record());
+  // Nothing was copied.
+  EXPECT_TRUE(delegate.all_strings_borrowed());
+
+  // Scalars can be roots too.
+  RecordingDelegate scalar_delegate("7");
+  EXPECT_TRUE(JSONReader::ReadWithDelegate("7", JSON_PARSE_RFC,
+                                           &scalar_delegate, NULL, NULL));
+  EXPECT_EQ("i7", scalar_delegate.record());
+}
+
+TEST(JSONReaderTest, ReadWithDelegateEscapes) {
+  const std::string json("[\"a\\nb\", \"\\u00e9\", \"plain\"]");
+  RecordingDelegate delegate(json);
+  EXPECT_TRUE(JSONReader::ReadWithDelegate(json, JSON_PARSE_RFC, &delegate,
+                                           NULL, NULL));
+  EXPECT_EQ("[ 'a\nb' '\xc3\xa9' 'plain' ]", delegate.record());
+  // Strings with escapes were decoded into a separate buffer.
+  EXPECT_FALSE(delegate.all_strings_borrowed());
+}
+
+TEST(JSONReaderTest, ReadWithDelegateErrors) {
+  int error_code = 0;
+  std::string error_message;
+
+  RecordingDelegate trailing_comma_delegate("[1,]");
+  EXPECT_FALSE(JSONReader::ReadWithDelegate(
+      "[1,]", JSON_PARSE_RFC, &trailing_comma_delegate, &error_code,
+      &error_message));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, error_code);
+  EXPECT_FALSE(error_message.empty());
+
+  RecordingDelegate allowed_delegate("[1,]");
+  EXPECT_TRUE(JSONReader::ReadWithDelegate(
+      "[1,]", JSON_ALLOW_TRAILING_COMMAS, &allowed_delegate, NULL, NULL));
+  EXPECT_EQ("[ i1 ]", allowed_delegate.record());
+
+  RecordingDelegate garbage_delegate("{} x");
+  EXPECT_FALSE(JSONReader::ReadWithDelegate(
+      "{} x", JSON_PARSE_RFC, &garbage_delegate, &error_code, NULL));
+  EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, error_code);
+
+  RecordingDelegate key_delegate("{1: 2}");
+  EXPECT_FALSE(JSONReader::ReadWithDelegate(
+      "{1: 2}", JSON_PARSE_RFC, &key_delegate, &error_code, NULL));
+  EXPECT_EQ(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, error_code);
+}
+
+TEST(JSONReaderTest, ReadWithDelegateAborted) {
+  const std::string json("[1, [2, 3], 4]");
+  RecordingDelegate delegate(json);
+  delegate.set_max_events(4);
+  int error_code = 0;
+  EXPECT_FALSE(JSONReader::ReadWithDelegate(json, JSON_PARSE_RFC, &delegate,
+                                            &error_code, NULL));
+  EXPECT_EQ(JSONReader::JSON_PARSE_ABORTED, error_code);
+  EXPECT_EQ("[ i1 [ i2", delegate.record());
+}
+
 }  // namespace base
@@ -19,6 +19,7 @@ enum DiscardableMemoryType {
   DISCARDABLE_MEMORY_TYPE_NONE,
   DISCARDABLE_MEMORY_TYPE_ANDROID,
   DISCARDABLE_MEMORY_TYPE_MAC,
+  DISCARDABLE_MEMORY_TYPE_LINUX,
   DISCARDABLE_MEMORY_TYPE_EMULATED,
   DISCARDABLE_MEMORY_TYPE_MALLOC
 };
@@ -55,6 +56,7 @@ enum DiscardableMemoryLockStatus {
 //
 // References:
 //   - Linux: http://lwn.net/Articles/452035/
+//            https://lwn.net/Articles/590991/ (MADV_FREE)
 //   - Mac: http://trac.webkit.org/browser/trunk/Source/WebCore/platform/mac/PurgeableBufferMac.cpp
 //          the comment starting with "vm_object_purgable_control" at
 //            http://www.opensource.apple.com/source/xnu/xnu-792.13.8/osfmk/vm/vm_object.c
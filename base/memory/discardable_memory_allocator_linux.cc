@@ -0,0 +1,344 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/discardable_memory_allocator_linux.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/discardable_memory.h"
+
+// MADV_FREE is only defined by recent system headers. It is supported by
+// Linux >= 4.5.
+#if !defined(MADV_FREE)
+#define MADV_FREE 8
+#endif
+
+// The allocator consists of three parts (classes):
+// - DiscardableMemoryAllocatorLinux: entry point of all allocations (through
+// its Allocate() method) that are dispatched to the Region instances (which it
+// owns).
+// - Region: manages allocations and destructions inside a single large mapping.
+// - Chunk: class implementing the DiscardableMemory interface whose instances
+// are returned to the client, on a subrange of a Region.
+
+namespace base {
+namespace {
+
+const size_t kPageSize = 4096;
+
+const size_t kMinRegionSize = 32 * 1024 * 1024;
+
+// Written to the first word of the pages of unlocked chunks. Pages reclaimed
+// by the kernel read back as zeros instead.
+const subtle::AtomicWord kPageMarker =
+    static_cast<subtle::AtomicWord>(0x5ca1ab1e);
+
+// Returns 0 if the provided size is too high to be aligned.
+size_t AlignToNextPage(size_t size) {
+  DCHECK_EQ(static_cast<int>(kPageSize), getpagesize());
+  if (size > std::numeric_limits<size_t>::max() - kPageSize + 1)
+    return 0;
+  const size_t mask = ~(kPageSize - 1);
+  return (size + kPageSize - 1) & mask;
+}
+
+struct MadvFreeSupport {
+  MadvFreeSupport() : supported(false) {
+    void* page = mmap(NULL, kPageSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED)
+      return;
+    // Older kernels fail with EINVAL.
+    supported = madvise(page, kPageSize, MADV_FREE) == 0;
+    munmap(page, kPageSize);
+  }
+  bool supported;
+};
+
+LazyInstance<MadvFreeSupport>::Leaky g_madv_free_support =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+namespace internal {
+
+class DiscardableMemoryAllocatorLinux::Chunk : public DiscardableMemory {
+ public:
+  // Note that |region| must outlive |this|.
+  Chunk(Region* region, void* address, size_t size)
+      : region_(region),
+        address_(address),
+        size_(size),
+        saved_page_words_(size / kPageSize),
+        locked_(true) {
+  }
+
+  // Implemented below Region since this requires the full definition of
+  // Region.
+  virtual ~Chunk();
+
+  // DiscardableMemory:
+  virtual DiscardableMemoryLockStatus Lock() OVERRIDE {
+    DCHECK(!locked_);
+    locked_ = true;
+    DCHECK_EQ(0, mprotect(address_, size_, PROT_READ | PROT_WRITE));
+    // The exchange writes to the page, which cancels its pending free, and
+    // tells atomically whether the kernel reclaimed it before.
+    bool purged = false;
+    for (size_t i = 0; i < saved_page_words_.size(); ++i) {
+      if (subtle::NoBarrier_AtomicExchange(GetPageWord(i),
+                                           saved_page_words_[i]) !=
+          kPageMarker) {
+        purged = true;
+      }
+    }
+    return purged ? DISCARDABLE_MEMORY_LOCK_STATUS_PURGED
+                  : DISCARDABLE_MEMORY_LOCK_STATUS_SUCCESS;
+  }
+
+  virtual void Unlock() OVERRIDE {
+    DCHECK(locked_);
+    locked_ = false;
+    for (size_t i = 0; i < saved_page_words_.size(); ++i) {
+      subtle::AtomicWord* word = GetPageWord(i);
+      saved_page_words_[i] = subtle::NoBarrier_Load(word);
+      subtle::NoBarrier_Store(word, kPageMarker);
+    }
+    if (madvise(address_, size_, MADV_FREE))
+      DPLOG(ERROR) << "madvise(MADV_FREE) failed";
+    // This allows us to catch accesses to unlocked memory.
+    DCHECK_EQ(0, mprotect(address_, size_, PROT_NONE));
+  }
+
+  virtual void* Memory() const OVERRIDE {
+    DCHECK(locked_);
+    return address_;
+  }
+
+  // Discards the pages of the chunk right away if it is unlocked.
+  void Purge() {
+    if (!locked_ && madvise(address_, size_, MADV_DONTNEED))
+      DPLOG(ERROR) << "madvise(MADV_DONTNEED) failed";
+  }
+
+ private:
+  subtle::AtomicWord* GetPageWord(size_t page) const {
+    return reinterpret_cast<subtle::AtomicWord*>(
+        static_cast<char*>(address_) + page * kPageSize);
+  }
+
+  Region* const region_;
+  void* const address_;
+  const size_t size_;
+  // The first word of each page, while unlocked.
+  std::vector<subtle::AtomicWord> saved_page_words_;
+  bool locked_;
+
+  DISALLOW_COPY_AND_ASSIGN(Chunk);
+};
+
+class DiscardableMemoryAllocatorLinux::Region {
+ public:
+  // Note that |allocator| must outlive |this|.
+  static scoped_ptr<Region> Create(size_t size,
+                                   DiscardableMemoryAllocatorLinux* allocator) {
+    DCHECK_EQ(size, AlignToNextPage(size));
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      DPLOG(ERROR) << "mmap() failed";
+      return scoped_ptr<Region>();
+    }
+    return make_scoped_ptr(new Region(static_cast<char*>(base), size,
+                                      allocator));
+  }
+
+  ~Region() {
+    const int result = munmap(base_, size_);
+    DCHECK_EQ(0, result);
+  }
+
+  // Returns a new chunk of |size| bytes, which must be page aligned, or NULL
+  // if the region has no room for it. The smallest free chunk that is large
+  // enough is reused, and its tail stays free. Otherwise the chunk is taken
+  // from the never allocated end of the region.
+  scoped_ptr<DiscardableMemory> Allocate_Locked(size_t size) {
+    allocator_->lock_.AssertAcquired();
+    std::map<size_t, size_t>::iterator best_fit = free_chunks_.end();
+    for (std::map<size_t, size_t>::iterator it = free_chunks_.begin();
+         it != free_chunks_.end(); ++it) {
+      if (it->second >= size &&
+          (best_fit == free_chunks_.end() || it->second < best_fit->second)) {
+        best_fit = it;
+      }
+    }
+    size_t offset;
+    if (best_fit != free_chunks_.end()) {
+      offset = best_fit->first;
+      const size_t free_size = best_fit->second;
+      free_chunks_.erase(best_fit);
+      if (free_size > size)
+        free_chunks_[offset + size] = free_size - size;
+    } else {
+      if (size_ - end_offset_ < size)
+        return scoped_ptr<DiscardableMemory>();
+      offset = end_offset_;
+      end_offset_ += size;
+    }
+    Chunk* chunk = new Chunk(this, base_ + offset, size);
+    allocator_->AddChunk_Locked(chunk);
+    used_chunk_count_++;
+    return make_scoped_ptr<DiscardableMemory>(chunk);
+  }
+
+  void OnChunkDeletion(Chunk* chunk, void* address, size_t size) {
+    AutoLock auto_lock(allocator_->lock_);
+    allocator_->RemoveChunk_Locked(chunk);
+    DCHECK_GT(used_chunk_count_, 0u);
+    if (--used_chunk_count_ == 0) {
+      // Unmapping the whole region releases its pages immediately.
+      allocator_->DeleteRegion_Locked(this);  // Deletes |this|.
+      return;
+    }
+    // Let the kernel reclaim the pages lazily, as for unlocked chunks.
+    if (madvise(address, size, MADV_FREE))
+      DPLOG(ERROR) << "madvise(MADV_FREE) failed";
+    AddFreeChunk_Locked(static_cast<char*>(address) - base_, size);
+  }
+
+ private:
+  // Note that |allocator| must outlive |this|.
+  Region(char* base, size_t size, DiscardableMemoryAllocatorLinux* allocator)
+      : base_(base),
+        size_(size),
+        allocator_(allocator),
+        end_offset_(0),
+        used_chunk_count_(0) {
+    DCHECK(base);
+    DCHECK(allocator);
+  }
+
+  // Adds the free chunk at |offset|, merged with the contiguous free chunks.
+  void AddFreeChunk_Locked(size_t offset, size_t size) {
+    allocator_->lock_.AssertAcquired();
+    std::map<size_t, size_t>::iterator next = free_chunks_.lower_bound(offset);
+    if (next != free_chunks_.end() && next->first == offset + size) {
+      size += next->second;
+      free_chunks_.erase(next++);
+    }
+    if (next != free_chunks_.begin()) {
+      std::map<size_t, size_t>::iterator previous = next;
+      --previous;
+      if (previous->first + previous->second == offset) {
+        offset = previous->first;
+        size += previous->second;
+        free_chunks_.erase(previous);
+      }
+    }
+    if (offset + size == end_offset_) {
+      // Give the tail back to the never allocated end of the region.
+      end_offset_ = offset;
+      return;
+    }
+    free_chunks_[offset] = size;
+  }
+
+  char* const base_;
+  const size_t size_;
+  DiscardableMemoryAllocatorLinux* const allocator_;
+  // Offset of the end of the highest chunk in the region.
+  size_t end_offset_;
+  size_t used_chunk_count_;
+  // Maps the offset of free chunks below |end_offset_| to their size.
+  std::map<size_t, size_t> free_chunks_;
+
+  DISALLOW_COPY_AND_ASSIGN(Region);
+};
+
+DiscardableMemoryAllocatorLinux::Chunk::~Chunk() {
+  // The region may hand the chunk out again.
+  if (!locked_)
+    DCHECK_EQ(0, mprotect(address_, size_, PROT_READ | PROT_WRITE));
+  region_->OnChunkDeletion(this, address_, size_);
+}
+
+DiscardableMemoryAllocatorLinux::DiscardableMemoryAllocatorLinux(
+    size_t region_size)
+    : region_size_(std::max(kMinRegionSize, AlignToNextPage(region_size))) {
+}
+
+DiscardableMemoryAllocatorLinux::~DiscardableMemoryAllocatorLinux() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK(regions_.empty());
+}
+
+// static
+bool DiscardableMemoryAllocatorLinux::IsSupported() {
+  return g_madv_free_support.Get().supported;
+}
+
+scoped_ptr<DiscardableMemory> DiscardableMemoryAllocatorLinux::Allocate(
+    size_t size) {
+  DCHECK(IsSupported());
+  const size_t aligned_size = AlignToNextPage(size);
+  if (!aligned_size)
+    return scoped_ptr<DiscardableMemory>();
+  AutoLock auto_lock(lock_);
+  for (ScopedVector<Region>::iterator it = regions_.begin();
+       it != regions_.end(); ++it) {
+    scoped_ptr<DiscardableMemory> memory((*it)->Allocate_Locked(aligned_size));
+    if (memory)
+      return memory.Pass();
+  }
+  scoped_ptr<Region> new_region(
+      Region::Create(std::max(region_size_, aligned_size), this));
+  if (!new_region)
+    return scoped_ptr<DiscardableMemory>();
+  regions_.push_back(new_region.release());
+  return regions_.back()->Allocate_Locked(aligned_size);
+}
+
+void DiscardableMemoryAllocatorLinux::PurgeForTesting() {
+  AutoLock auto_lock(lock_);
+  for (std::set<Chunk*>::iterator it = chunks_.begin(); it != chunks_.end();
+       ++it) {
+    (*it)->Purge();
+  }
+}
+
+size_t DiscardableMemoryAllocatorLinux::GetRegionCountForTesting() const {
+  AutoLock auto_lock(lock_);
+  return regions_.size();
+}
+
+void DiscardableMemoryAllocatorLinux::AddChunk_Locked(Chunk* chunk) {
+  lock_.AssertAcquired();
+  chunks_.insert(chunk);
+}
+
+void DiscardableMemoryAllocatorLinux::RemoveChunk_Locked(Chunk* chunk) {
+  lock_.AssertAcquired();
+  chunks_.erase(chunk);
+}
+
+void DiscardableMemoryAllocatorLinux::DeleteRegion_Locked(Region* region) {
+  lock_.AssertAcquired();
+  const ScopedVector<Region>::iterator it = std::find(
+      regions_.begin(), regions_.end(), region);
+  DCHECK(it != regions_.end());
+  std::swap(*it, regions_.back());
+  regions_.pop_back();
+}
+
+}  // namespace internal
+}  // namespace base
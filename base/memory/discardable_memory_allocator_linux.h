@@ -0,0 +1,79 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_DISCARDABLE_MEMORY_ALLOCATOR_LINUX_H_
+#define BASE_MEMORY_DISCARDABLE_MEMORY_ALLOCATOR_LINUX_H_
+
+#include <set>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_checker.h"
+
+namespace base {
+
+class DiscardableMemory;
+
+namespace internal {
+
+// On Linux, discardable memory is implemented with madvise(MADV_FREE), which
+// lets the kernel reclaim the pages of private anonymous memory under memory
+// pressure without unmapping them. Pages that are reclaimed read back as
+// zeros. This allocator maps large regions and returns page aligned chunks of
+// them to the client, so that chunks don't cost a mapping each.
+//
+// Unlocking a chunk saves the first word of each of its pages and replaces it
+// with a marker before the madvise() call. Locking a chunk swaps the saved
+// words back with atomic exchanges, which also cancel the pending free of the
+// pages. A page whose marker is gone was reclaimed, so locking needs no system
+// call.
+//
+// Threading: The allocator must be deleted on the thread it was constructed on
+// although its Allocate() method can be invoked on any thread. See
+// discardable_memory.h for DiscardableMemory's threading guarantees.
+class BASE_EXPORT_PRIVATE DiscardableMemoryAllocatorLinux {
+ public:
+  // |region_size| is the size of the regions chunks are allocated from. Larger
+  // allocations get a region of their own.
+  explicit DiscardableMemoryAllocatorLinux(size_t region_size);
+  ~DiscardableMemoryAllocatorLinux();
+
+  // Returns true if the kernel supports MADV_FREE, which is required to use
+  // the allocator.
+  static bool IsSupported();
+
+  // Note that the allocator must outlive the returned DiscardableMemory
+  // instance.
+  scoped_ptr<DiscardableMemory> Allocate(size_t size);
+
+  // Discards the pages of all the unlocked chunks.
+  void PurgeForTesting();
+
+  size_t GetRegionCountForTesting() const;
+
+ private:
+  class Region;
+  class Chunk;
+
+  void AddChunk_Locked(Chunk* chunk);
+  void RemoveChunk_Locked(Chunk* chunk);
+  void DeleteRegion_Locked(Region* region);
+
+  ThreadChecker thread_checker_;
+  const size_t region_size_;
+  mutable Lock lock_;
+  ScopedVector<Region> regions_;
+  // All the chunks allocated and not deleted yet.
+  std::set<Chunk*> chunks_;
+
+  DISALLOW_COPY_AND_ASSIGN(DiscardableMemoryAllocatorLinux);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_MEMORY_DISCARDABLE_MEMORY_ALLOCATOR_LINUX_H_
@@ -0,0 +1,205 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/discardable_memory_allocator_linux.h"
+
+#include <string.h>
+
+#include <limits>
+
+#include "base/memory/discardable_memory.h"
+#include "base/memory/scoped_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+const size_t kRegionSizeForTesting = 32 * 1024 * 1024;
+const size_t kPageSize = 4096;
+
+const size_t kMaxAllowedAllocationSize =
+    std::numeric_limits<size_t>::max() - kPageSize + 1;
+
+class DiscardableMemoryAllocatorLinuxTest : public testing::Test {
+ protected:
+  DiscardableMemoryAllocatorLinuxTest() : allocator_(kRegionSizeForTesting) {}
+
+  virtual void SetUp() OVERRIDE {
+    supported_ = DiscardableMemoryAllocatorLinux::IsSupported();
+    if (!supported_)
+      LOG(WARNING) << "MADV_FREE is not supported, skipping test";
+  }
+
+  DiscardableMemoryAllocatorLinux allocator_;
+  bool supported_;
+};
+
+void WriteToDiscardableMemory(DiscardableMemory* memory, size_t size) {
+  // Write to the first and the last pages only to avoid paging in up to 64
+  // MBytes.
+  static_cast<char*>(memory->Memory())[0] = 'a';
+  static_cast<char*>(memory->Memory())[size - 1] = 'a';
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, Basic) {
+  if (!supported_)
+    return;
+  const size_t size = 128;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(size));
+  ASSERT_TRUE(memory);
+  WriteToDiscardableMemory(memory.get(), size);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, ZeroAllocationIsNotSupported) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(0));
+  ASSERT_FALSE(memory);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, TooLargeAllocationFails) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory(
+      allocator_.Allocate(kMaxAllowedAllocationSize + 1));
+  // Page-alignment would have caused an overflow resulting in a small
+  // allocation if the input size wasn't checked correctly.
+  ASSERT_FALSE(memory);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, ChunksArePageAligned) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory);
+  EXPECT_EQ(0U, reinterpret_cast<uint64_t>(memory->Memory()) % kPageSize);
+  WriteToDiscardableMemory(memory.get(), kPageSize);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, UnlockAndLockKeepsContents) {
+  if (!supported_)
+    return;
+  const size_t size = 3 * kPageSize;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(size));
+  ASSERT_TRUE(memory);
+  memset(memory->Memory(), 'a', size);
+  memory->Unlock();
+  // Without memory pressure the kernel keeps the pages.
+  ASSERT_EQ(DISCARDABLE_MEMORY_LOCK_STATUS_SUCCESS, memory->Lock());
+  const char* bytes = static_cast<const char*>(memory->Memory());
+  for (size_t i = 0; i < size; ++i)
+    ASSERT_EQ('a', bytes[i]);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, PurgedChunkIsReportedOnLock) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> locked(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(locked);
+  *static_cast<char*>(locked->Memory()) = 'a';
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(2 * kPageSize));
+  ASSERT_TRUE(memory);
+  WriteToDiscardableMemory(memory.get(), 2 * kPageSize);
+  memory->Unlock();
+  allocator_.PurgeForTesting();
+  EXPECT_EQ(DISCARDABLE_MEMORY_LOCK_STATUS_PURGED, memory->Lock());
+  // Locked chunks are left alone.
+  EXPECT_EQ('a', *static_cast<char*>(locked->Memory()));
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, AllocateFreeAllocate) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(kPageSize));
+  // Extra allocation that prevents the region from being deleted when |memory|
+  // gets deleted.
+  scoped_ptr<DiscardableMemory> memory_lock(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory);
+  void* const address = memory->Memory();
+  memory->Unlock();  // Tests that the reused chunk is being locked correctly.
+  memory.reset();
+  memory = allocator_.Allocate(kPageSize);
+  ASSERT_TRUE(memory);
+  // The previously freed chunk should be reused.
+  EXPECT_EQ(address, memory->Memory());
+  WriteToDiscardableMemory(memory.get(), kPageSize);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, FreeingWholeRegionUnmapsIt) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory);
+  EXPECT_EQ(1U, allocator_.GetRegionCountForTesting());
+  memory.reset();
+  EXPECT_EQ(0U, allocator_.GetRegionCountForTesting());
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, AllocateUsesBestFitAlgorithm) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory1(allocator_.Allocate(3 * kPageSize));
+  ASSERT_TRUE(memory1);
+  scoped_ptr<DiscardableMemory> memory2(allocator_.Allocate(2 * kPageSize));
+  ASSERT_TRUE(memory2);
+  scoped_ptr<DiscardableMemory> memory3(allocator_.Allocate(1 * kPageSize));
+  ASSERT_TRUE(memory3);
+  scoped_ptr<DiscardableMemory> memory4(allocator_.Allocate(1 * kPageSize));
+  ASSERT_TRUE(memory4);
+  void* const address_3 = memory3->Memory();
+  memory1.reset();
+  // Don't free |memory2| to avoid merging the 3 blocks together.
+  memory3.reset();
+  memory1 = allocator_.Allocate(1 * kPageSize);
+  ASSERT_TRUE(memory1);
+  // The chunk whose size is closest to the requested size should be reused.
+  EXPECT_EQ(address_3, memory1->Memory());
+  WriteToDiscardableMemory(memory1.get(), kPageSize);
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, MergeFreeChunks) {
+  if (!supported_)
+    return;
+  scoped_ptr<DiscardableMemory> memory1(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory1);
+  scoped_ptr<DiscardableMemory> memory2(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory2);
+  scoped_ptr<DiscardableMemory> memory3(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory3);
+  scoped_ptr<DiscardableMemory> memory4(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory4);
+  void* const memory1_address = memory1->Memory();
+  memory1.reset();
+  memory3.reset();
+  // Freeing |memory2| (located between memory1 and memory3) should merge the
+  // three free blocks together.
+  memory2.reset();
+  memory1 = allocator_.Allocate(3 * kPageSize);
+  ASSERT_TRUE(memory1);
+  EXPECT_EQ(memory1_address, memory1->Memory());
+}
+
+TEST_F(DiscardableMemoryAllocatorLinuxTest, UseMultipleRegions) {
+  if (!supported_)
+    return;
+  // Leave one page untouched at the end of the region.
+  const size_t size = kRegionSizeForTesting - kPageSize;
+  scoped_ptr<DiscardableMemory> memory1(allocator_.Allocate(size));
+  ASSERT_TRUE(memory1);
+  WriteToDiscardableMemory(memory1.get(), size);
+
+  scoped_ptr<DiscardableMemory> memory2(
+      allocator_.Allocate(kRegionSizeForTesting));
+  ASSERT_TRUE(memory2);
+  WriteToDiscardableMemory(memory2.get(), kRegionSizeForTesting);
+  EXPECT_EQ(2U, allocator_.GetRegionCountForTesting());
+  // The last page of the first region should be used for this allocation.
+  scoped_ptr<DiscardableMemory> memory3(allocator_.Allocate(kPageSize));
+  ASSERT_TRUE(memory3);
+  WriteToDiscardableMemory(memory3.get(), kPageSize);
+  EXPECT_EQ(memory3->Memory(), static_cast<char*>(memory1->Memory()) + size);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -4,11 +4,29 @@
 
 #include "base/memory/discardable_memory.h"
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/discardable_memory_allocator_linux.h"
 #include "base/memory/discardable_memory_emulated.h"
 #include "base/memory/discardable_memory_malloc.h"
 
 namespace base {
+namespace {
+
+// The size of the regions the chunks of discardable memory are allocated
+// from.
+const size_t kRegionSize = 32 * 1024 * 1024;
+
+struct DiscardableMemoryAllocatorWrapper {
+  DiscardableMemoryAllocatorWrapper() : allocator(kRegionSize) {}
+
+  internal::DiscardableMemoryAllocatorLinux allocator;
+};
+
+LazyInstance<DiscardableMemoryAllocatorWrapper>::Leaky g_context =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
 
 // static
 void DiscardableMemory::RegisterMemoryPressureListeners() {
@@ -28,6 +46,9 @@ void DiscardableMemory::GetSupportedTypes(
     DISCARDABLE_MEMORY_TYPE_MALLOC
   };
   types->assign(supported_types, supported_types + arraysize(supported_types));
+  // The native type is preferred when the kernel supports it.
+  if (internal::DiscardableMemoryAllocatorLinux::IsSupported())
+    types->insert(types->begin(), DISCARDABLE_MEMORY_TYPE_LINUX);
 }
 
 // static
@@ -38,6 +59,12 @@ scoped_ptr<DiscardableMemory> DiscardableMemory::CreateLockedMemoryWithType(
     case DISCARDABLE_MEMORY_TYPE_ANDROID:
     case DISCARDABLE_MEMORY_TYPE_MAC:
       return scoped_ptr<DiscardableMemory>();
+    case DISCARDABLE_MEMORY_TYPE_LINUX: {
+      if (!internal::DiscardableMemoryAllocatorLinux::IsSupported())
+        return scoped_ptr<DiscardableMemory>();
+
+      return g_context.Pointer()->allocator.Allocate(size);
+    }
     case DISCARDABLE_MEMORY_TYPE_EMULATED: {
       scoped_ptr<internal::DiscardableMemoryEmulated> memory(
           new internal::DiscardableMemoryEmulated(size));
@@ -67,6 +94,8 @@ bool DiscardableMemory::PurgeForTestingSupported() {
 
 // static
 void DiscardableMemory::PurgeForTesting() {
+  if (internal::DiscardableMemoryAllocatorLinux::IsSupported())
+    g_context.Pointer()->allocator.PurgeForTesting();
   internal::DiscardableMemoryEmulated::PurgeForTesting();
 }
 
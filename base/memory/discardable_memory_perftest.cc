@@ -0,0 +1,86 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Image decode caches lock discardable memory before each use of a cached
+// image and unlock it after. Measure the latency of those calls for every
+// supported type, for sizes from a small tile to a large image.
+
+#include "base/memory/discardable_memory.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+const size_t kTestSizes[] = {4 * 1024, 256 * 1024, 4 * 1024 * 1024};
+
+// About this many bytes are locked and unlocked for each test.
+const size_t kBytesPerTest = 1 << 30;
+
+const int kMaxIterations = 100000;
+
+int GetIterations(size_t size) {
+  return static_cast<int>(
+      std::min<size_t>(kMaxIterations, kBytesPerTest / size));
+}
+
+TEST(DiscardableMemoryPerfTest, LockUnlock) {
+  std::vector<DiscardableMemoryType> types;
+  DiscardableMemory::GetSupportedTypes(&types);
+  for (size_t i = 0; i < types.size(); ++i) {
+    for (size_t j = 0; j < arraysize(kTestSizes); ++j) {
+      const size_t size = kTestSizes[j];
+      scoped_ptr<DiscardableMemory> memory(
+          DiscardableMemory::CreateLockedMemoryWithType(types[i], size));
+      ASSERT_TRUE(memory);
+      memset(memory->Memory(), 1, size);
+      memory->Unlock();
+      const int times = GetIterations(size);
+      PerfTimeLogger timer(StringPrintf("LockUnlock: %s size=%d repeat=%d",
+                                        DiscardableMemory::GetTypeName(
+                                            types[i]),
+                                        static_cast<int>(size),
+                                        times).c_str());
+      for (int k = 0; k < times; ++k) {
+        EXPECT_NE(DISCARDABLE_MEMORY_LOCK_STATUS_FAILED, memory->Lock());
+        memory->Unlock();
+      }
+      timer.Done();
+    }
+  }
+}
+
+TEST(DiscardableMemoryPerfTest, CreateAndDelete) {
+  std::vector<DiscardableMemoryType> types;
+  DiscardableMemory::GetSupportedTypes(&types);
+  for (size_t i = 0; i < types.size(); ++i) {
+    for (size_t j = 0; j < arraysize(kTestSizes); ++j) {
+      const size_t size = kTestSizes[j];
+      const int times = GetIterations(size);
+      PerfTimeLogger timer(StringPrintf("CreateAndDelete: %s size=%d repeat=%d",
+                                        DiscardableMemory::GetTypeName(
+                                            types[i]),
+                                        static_cast<int>(size),
+                                        times).c_str());
+      for (int k = 0; k < times; ++k) {
+        scoped_ptr<DiscardableMemory> memory(
+            DiscardableMemory::CreateLockedMemoryWithType(types[i], size));
+        EXPECT_TRUE(memory);
+      }
+      timer.Done();
+    }
+  }
+}
+
+}  // namespace
+}  // namespace base
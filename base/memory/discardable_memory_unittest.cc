@@ -13,6 +13,10 @@
 #include <limits>
 #endif
 
+#if defined(OS_LINUX)
+#include "base/memory/discardable_memory_allocator_linux.h"
+#endif
+
 namespace base {
 namespace {
 
@@ -48,7 +52,8 @@ TEST_P(DiscardableMemoryTest, IsNamed) {
 bool IsNativeType(DiscardableMemoryType type) {
   return
       type == DISCARDABLE_MEMORY_TYPE_ANDROID ||
-      type == DISCARDABLE_MEMORY_TYPE_MAC;
+      type == DISCARDABLE_MEMORY_TYPE_MAC ||
+      type == DISCARDABLE_MEMORY_TYPE_LINUX;
 }
 
 TEST_P(DiscardableMemoryTest, SupportedNatively) {
@@ -58,6 +63,13 @@ TEST_P(DiscardableMemoryTest, SupportedNatively) {
   EXPECT_NE(0, std::count_if(supported_types.begin(),
                              supported_types.end(),
                              IsNativeType));
+#elif defined(OS_LINUX)
+  // Linux decides at runtime, depending on the kernel version.
+  EXPECT_EQ(
+      internal::DiscardableMemoryAllocatorLinux::IsSupported() ? 1 : 0,
+      std::count_if(supported_types.begin(),
+                    supported_types.end(),
+                    IsNativeType));
 #else
   // If we ever have a platform that decides at runtime if it can support
   // discardable memory natively, then we'll have to add a 'never supported
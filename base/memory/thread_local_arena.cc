@@ -0,0 +1,247 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/thread_local_arena.h"
+
+#include <string.h>
+
+#include <new>
+
+#include "base/debug/trace_event.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+const size_t kSizeClassGranularity = 16;
+const size_t kNumSizeClasses =
+    ThreadLocalArena::kMaxBlockSize / kSizeClassGranularity;
+
+// A thread keeps at most this many free blocks per size class before it moves
+// kTransferBatchSize of them to the central list.
+const size_t kMaxThreadListLength = 64;
+const size_t kTransferBatchSize = 32;
+
+// Free blocks beyond this many per size class are returned to the heap.
+const size_t kMaxCentralListLength = 2048;
+
+// The counters are emitted to the trace every this many allocations.
+const uint32 kAllocationsPerTraceSample = 1024;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head;
+  size_t length;
+};
+
+struct ThreadCache {
+  FreeList lists[kNumSizeClasses];
+  ThreadLocalArena::Stats stats;
+  uint32 allocations_until_trace_sample;
+};
+
+void OnThreadExit(void* value);
+
+struct ArenaGlobals {
+  ArenaGlobals() : thread_cache(&OnThreadExit) {
+    memset(central_lists, 0, sizeof(central_lists));
+  }
+
+  ThreadLocalStorage::Slot thread_cache;
+
+  // Protects |central_lists|.
+  Lock lock;
+  FreeList central_lists[kNumSizeClasses];
+};
+
+// Leaky because blocks may be freed on threads that outlive the AtExitManager.
+LazyInstance<ArenaGlobals>::Leaky g_globals = LAZY_INSTANCE_INITIALIZER;
+
+size_t SizeClassIndex(size_t size) {
+  return size ? (size - 1) / kSizeClassGranularity : 0;
+}
+
+size_t SizeClassBytes(size_t index) {
+  return (index + 1) * kSizeClassGranularity;
+}
+
+// Unlinks up to |max_count| blocks from the front of |list| and returns them
+// as a NULL-terminated chain.
+FreeBlock* TakeBlocks(FreeList* list, size_t max_count, size_t* count) {
+  FreeBlock* first = list->head;
+  FreeBlock* last = NULL;
+  *count = 0;
+  for (FreeBlock* block = first; block && *count < max_count;
+       block = block->next) {
+    last = block;
+    ++*count;
+  }
+  if (!last)
+    return NULL;
+  list->head = last->next;
+  list->length -= *count;
+  last->next = NULL;
+  return first;
+}
+
+// Prepends the NULL-terminated chain |blocks| of |count| blocks to |list|.
+void AddBlocks(FreeList* list, FreeBlock* blocks, size_t count) {
+  if (!blocks)
+    return;
+  FreeBlock* last = blocks;
+  while (last->next)
+    last = last->next;
+  last->next = list->head;
+  list->head = blocks;
+  list->length += count;
+}
+
+void FreeChain(FreeBlock* blocks) {
+  while (blocks) {
+    FreeBlock* next = blocks->next;
+    ::operator delete(blocks);
+    blocks = next;
+  }
+}
+
+// Moves up to |max_count| blocks from the front of |list| to the central list
+// of size class |index|, or to the heap when the central list is full.
+void ReleaseToCentral(size_t index, FreeList* list, size_t max_count) {
+  size_t count;
+  FreeBlock* blocks = TakeBlocks(list, max_count, &count);
+  ArenaGlobals* globals = g_globals.Pointer();
+  {
+    AutoLock lock(globals->lock);
+    FreeList* central = &globals->central_lists[index];
+    if (central->length + count <= kMaxCentralListLength) {
+      AddBlocks(central, blocks, count);
+      blocks = NULL;
+    }
+  }
+  FreeChain(blocks);
+}
+
+void RefillFromCentral(size_t index, FreeList* list) {
+  ArenaGlobals* globals = g_globals.Pointer();
+  size_t count;
+  FreeBlock* blocks;
+  {
+    AutoLock lock(globals->lock);
+    blocks = TakeBlocks(&globals->central_lists[index], kTransferBatchSize,
+                        &count);
+  }
+  AddBlocks(list, blocks, count);
+}
+
+void OnThreadExit(void* value) {
+  ThreadCache* cache = static_cast<ThreadCache*>(value);
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    while (cache->lists[i].head)
+      ReleaseToCentral(i, &cache->lists[i], kTransferBatchSize);
+  }
+  delete cache;
+}
+
+ThreadCache* GetThreadCache() {
+  return static_cast<ThreadCache*>(g_globals.Pointer()->thread_cache.Get());
+}
+
+ThreadCache* GetOrCreateThreadCache() {
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    cache = new ThreadCache;
+    memset(cache->lists, 0, sizeof(cache->lists));
+    cache->allocations_until_trace_sample = kAllocationsPerTraceSample;
+    g_globals.Pointer()->thread_cache.Set(cache);
+  }
+  return cache;
+}
+
+void MaybeTraceStats(ThreadCache* cache) {
+  if (--cache->allocations_until_trace_sample)
+    return;
+  // Reset first, adding the trace event may allocate through the arena.
+  cache->allocations_until_trace_sample = kAllocationsPerTraceSample;
+  TRACE_COUNTER_ID2(TRACE_DISABLED_BY_DEFAULT("base.arena"),
+                    "ThreadLocalArena", PlatformThread::CurrentId(),
+                    "hits", cache->stats.hits,
+                    "misses", cache->stats.misses);
+}
+
+}  // namespace
+
+ThreadLocalArena::Stats::Stats() : hits(0), misses(0) {
+}
+
+// static
+void* ThreadLocalArena::Allocate(size_t size) {
+#if defined(ADDRESS_SANITIZER)
+  // Recycling blocks would hide use-after-free bugs from ASan.
+  return ::operator new(size);
+#else
+  if (size > kMaxBlockSize)
+    return ::operator new(size);
+
+  const size_t index = SizeClassIndex(size);
+  ThreadCache* cache = GetOrCreateThreadCache();
+  FreeList* list = &cache->lists[index];
+  if (!list->head)
+    RefillFromCentral(index, list);
+
+  void* block;
+  if (list->head) {
+    block = list->head;
+    list->head = list->head->next;
+    --list->length;
+    ++cache->stats.hits;
+  } else {
+    block = ::operator new(SizeClassBytes(index));
+    ++cache->stats.misses;
+  }
+  MaybeTraceStats(cache);
+  return block;
+#endif
+}
+
+// static
+void ThreadLocalArena::Free(void* block, size_t size) {
+  if (!block)
+    return;
+#if defined(ADDRESS_SANITIZER)
+  ::operator delete(block);
+#else
+  if (size > kMaxBlockSize) {
+    ::operator delete(block);
+    return;
+  }
+
+  // Threads that only free, such as a MessageLoop thread running tasks posted
+  // from elsewhere, still need a cache to hand the blocks back to the
+  // allocating threads through the central list.
+  ThreadCache* cache = GetOrCreateThreadCache();
+  const size_t index = SizeClassIndex(size);
+  FreeList* list = &cache->lists[index];
+  FreeBlock* free_block = static_cast<FreeBlock*>(block);
+  free_block->next = list->head;
+  list->head = free_block;
+  if (++list->length > kMaxThreadListLength)
+    ReleaseToCentral(index, list, kTransferBatchSize);
+#endif
+}
+
+// static
+ThreadLocalArena::Stats ThreadLocalArena::GetStatsForCurrentThread() {
+  ThreadCache* cache = GetThreadCache();
+  return cache ? cache->stats : Stats();
+}
+
+}  // namespace base
@@ -0,0 +1,75 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// ThreadLocalArena recycles small, short-lived heap blocks, such as the bound
+// state of a base::Callback or a task sitting in a MessageLoop's incoming
+// queue, through per-thread free lists so that the common
+// allocate-post-run-free cycle usually doesn't reach malloc.
+//
+// Blocks are grouped into size classes of 16 bytes up to kMaxBlockSize. Each
+// thread keeps a short free list per class. When a list grows too long, a
+// batch of blocks moves to a central list shared by all threads, from which
+// other threads refill theirs. So a block allocated on one thread and freed
+// on another, as posted tasks usually are, still gets reused.
+//
+// Classes opt in by forwarding their operator new and delete:
+//
+//   class Foo {
+//    public:
+//     static void* operator new(size_t size) {
+//       return ThreadLocalArena::Allocate(size);
+//     }
+//     static void operator delete(void* block, size_t size) {
+//       ThreadLocalArena::Free(block, size);
+//     }
+//   };
+//
+// Free() must be given the same size that was passed to Allocate(), which the
+// sized operator delete above does as long as the class has a virtual
+// destructor or is never deleted through a base pointer.
+//
+// Allocation counters are reported under the "base.arena" trace category,
+// which is disabled by default.
+
+#ifndef BASE_MEMORY_THREAD_LOCAL_ARENA_H_
+#define BASE_MEMORY_THREAD_LOCAL_ARENA_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+
+namespace base {
+
+class BASE_EXPORT ThreadLocalArena {
+ public:
+  // Blocks larger than this are passed straight to the heap.
+  static const size_t kMaxBlockSize = 256;
+
+  struct BASE_EXPORT Stats {
+    Stats();
+
+    // Allocations served from a free list.
+    uint64 hits;
+
+    // Allocations that had to go to the heap.
+    uint64 misses;
+  };
+
+  // Returns a block of at least |size| bytes.
+  static void* Allocate(size_t size);
+
+  // Releases |block|, which was returned by Allocate(|size|).
+  static void Free(void* block, size_t size);
+
+  // Returns the counters of the current thread.
+  static Stats GetStatsForCurrentThread();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ThreadLocalArena);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_THREAD_LOCAL_ARENA_H_
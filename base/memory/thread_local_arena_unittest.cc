@@ -0,0 +1,125 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/thread_local_arena.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+void AllocateBlocks(std::vector<void*>* blocks, size_t size, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    void* block = ThreadLocalArena::Allocate(size);
+    memset(block, 0xAB, size);
+    blocks->push_back(block);
+  }
+}
+
+void FreeBlocks(std::vector<void*>* blocks, size_t size) {
+  for (size_t i = 0; i < blocks->size(); ++i)
+    ThreadLocalArena::Free((*blocks)[i], size);
+  blocks->clear();
+}
+
+class ArenaObject {
+ public:
+  ArenaObject() : value_(42) {}
+  virtual ~ArenaObject() {}
+
+  static void* operator new(size_t size) {
+    return ThreadLocalArena::Allocate(size);
+  }
+  static void operator delete(void* block, size_t size) {
+    ThreadLocalArena::Free(block, size);
+  }
+
+  int value() const { return value_; }
+
+ private:
+  int value_;
+};
+
+class LargerArenaObject : public ArenaObject {
+ private:
+  char padding_[100];
+};
+
+}  // namespace
+
+TEST(ThreadLocalArenaTest, AllocateAndFree) {
+  std::vector<void*> blocks;
+  AllocateBlocks(&blocks, 1, 10);
+  AllocateBlocks(&blocks, ThreadLocalArena::kMaxBlockSize, 10);
+  FreeBlocks(&blocks, ThreadLocalArena::kMaxBlockSize);
+
+  // Blocks above the limit go to the heap.
+  AllocateBlocks(&blocks, ThreadLocalArena::kMaxBlockSize + 1, 10);
+  FreeBlocks(&blocks, ThreadLocalArena::kMaxBlockSize + 1);
+
+  ThreadLocalArena::Free(NULL, 16);
+}
+
+TEST(ThreadLocalArenaTest, ClassOperators) {
+  ArenaObject* object = new ArenaObject;
+  EXPECT_EQ(42, object->value());
+  delete object;
+
+  // Deleting through the base pointer passes the size of the derived class.
+  ArenaObject* derived = new LargerArenaObject;
+  EXPECT_EQ(42, derived->value());
+  delete derived;
+}
+
+#if !defined(ADDRESS_SANITIZER)
+TEST(ThreadLocalArenaTest, ReusesFreedBlocks) {
+  const size_t kSize = 48;
+  void* block = ThreadLocalArena::Allocate(kSize);
+  ThreadLocalArena::Free(block, kSize);
+
+  ThreadLocalArena::Stats before = ThreadLocalArena::GetStatsForCurrentThread();
+  // Any size in the same class gets the block back.
+  void* reused = ThreadLocalArena::Allocate(kSize - 10);
+  EXPECT_EQ(block, reused);
+  ThreadLocalArena::Stats after = ThreadLocalArena::GetStatsForCurrentThread();
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  ThreadLocalArena::Free(reused, kSize - 10);
+}
+
+TEST(ThreadLocalArenaTest, BlocksFreedOnOtherThreadAreReused) {
+  // Use a size class nothing else in the test binary is likely to use.
+  const size_t kSize = 232;
+  const size_t kCount = 1000;
+
+  std::vector<void*> blocks;
+  AllocateBlocks(&blocks, kSize, kCount);
+
+  // Freeing on another thread moves most blocks to the central list, the
+  // rest go there when the thread exits.
+  {
+    Thread thread("ThreadLocalArenaTest");
+    ASSERT_TRUE(thread.Start());
+    thread.message_loop()->PostTask(
+        FROM_HERE, Bind(&FreeBlocks, Unretained(&blocks), kSize));
+  }
+  EXPECT_TRUE(blocks.empty());
+
+  ThreadLocalArena::Stats before = ThreadLocalArena::GetStatsForCurrentThread();
+  AllocateBlocks(&blocks, kSize, kCount);
+  ThreadLocalArena::Stats after = ThreadLocalArena::GetStatsForCurrentThread();
+  EXPECT_EQ(before.hits + kCount, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  FreeBlocks(&blocks, kSize);
+}
+#endif  // !defined(ADDRESS_SANITIZER)
+
+}  // namespace base
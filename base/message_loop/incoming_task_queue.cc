@@ -6,15 +6,39 @@
 
 #include "base/debug/trace_event.h"
 #include "base/location.h"
+#include "base/memory/thread_local_arena.h"
 #include "base/message_loop/message_loop.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
 
 namespace base {
 namespace internal {
 
-IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop)
+struct IncomingTaskQueue::LockFreeNode {
+  explicit LockFreeNode(const PendingTask& pending_task)
+      : pending_task(pending_task),
+        next(NULL) {
+  }
+
+  static void* operator new(size_t size) {
+    return ThreadLocalArena::Allocate(size);
+  }
+  static void operator delete(void* block, size_t size) {
+    ThreadLocalArena::Free(block, size);
+  }
+
+  PendingTask pending_task;
+  LockFreeNode* next;
+};
+
+IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop, bool lock_free)
     : message_loop_(message_loop),
-      next_sequence_num_(0) {
+      next_sequence_num_(0),
+      lock_free_(lock_free),
+      lock_free_head_(0),
+      lock_free_posters_(0),
+      lock_free_detached_(0),
+      lock_free_sequence_num_(0) {
 }
 
 bool IncomingTaskQueue::AddToIncomingQueue(
@@ -22,6 +46,9 @@ bool IncomingTaskQueue::AddToIncomingQueue(
     const Closure& task,
     TimeDelta delay,
     bool nestable) {
+  if (lock_free_)
+    return AddToLockFreeQueue(from_here, task, delay, nestable);
+
   AutoLock locked(incoming_queue_lock_);
   PendingTask pending_task(
       from_here, task, CalculateDelayedRuntime(delay), nestable);
@@ -37,6 +64,9 @@ bool IncomingTaskQueue::IsHighResolutionTimerEnabledForTesting() {
 }
 
 bool IncomingTaskQueue::IsIdleForTesting() {
+  if (lock_free_)
+    return !subtle::Acquire_Load(&lock_free_head_);
+
   AutoLock lock(incoming_queue_lock_);
   return incoming_queue_.empty();
 }
@@ -45,6 +75,11 @@ void IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
   // Make sure no tasks are lost.
   DCHECK(work_queue->empty());
 
+  if (lock_free_) {
+    ReloadWorkQueueFromLockFreeQueue(work_queue);
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   AutoLock lock(incoming_queue_lock_);
   if (!incoming_queue_.empty())
@@ -64,6 +99,15 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
   }
 #endif
 
+  if (lock_free_) {
+    // Stop new posters, then wait for the ones that already passed the check
+    // in AddToLockFreeQueue() to finish with |message_loop_|.
+    subtle::NoBarrier_Store(&lock_free_detached_, 1);
+    subtle::MemoryBarrier();
+    while (subtle::Acquire_Load(&lock_free_posters_))
+      PlatformThread::YieldCurrentThread();
+  }
+
   AutoLock lock(incoming_queue_lock_);
   message_loop_ = NULL;
 }
@@ -71,6 +115,16 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
 IncomingTaskQueue::~IncomingTaskQueue() {
   // Verify that WillDestroyCurrentMessageLoop() has been called.
   DCHECK(!message_loop_);
+
+  // Tasks posted after the last ReloadWorkQueue() are deleted without being
+  // run, as the ones left in |incoming_queue_| are.
+  LockFreeNode* node = reinterpret_cast<LockFreeNode*>(
+      subtle::NoBarrier_AtomicExchange(&lock_free_head_, 0));
+  while (node) {
+    LockFreeNode* next = node->next;
+    delete node;
+    node = next;
+  }
 }
 
 TimeTicks IncomingTaskQueue::CalculateDelayedRuntime(TimeDelta delay) {
@@ -144,5 +198,74 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
   return true;
 }
 
+bool IncomingTaskQueue::AddToLockFreeQueue(
+    const tracked_objects::Location& from_here,
+    const Closure& task,
+    TimeDelta delay,
+    bool nestable) {
+  // Announce this poster before checking whether the loop went away. Pairs
+  // with the barrier in WillDestroyCurrentMessageLoop().
+  subtle::Barrier_AtomicIncrement(&lock_free_posters_, 1);
+  if (subtle::Acquire_Load(&lock_free_detached_)) {
+    subtle::Barrier_AtomicIncrement(&lock_free_posters_, -1);
+    return false;
+  }
+
+  LockFreeNode* node = new LockFreeNode(
+      PendingTask(from_here, task, CalculateDelayedRuntime(delay), nestable));
+  // See PostPendingTask() for what the sequence number is used for. Tasks
+  // posted concurrently from different threads may get numbers in a different
+  // order than they are pushed, which only matters for delayed tasks with
+  // identical run times, which have no defined order across threads anyway.
+  node->pending_task.sequence_num =
+      subtle::NoBarrier_AtomicIncrement(&lock_free_sequence_num_, 1) - 1;
+
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "MessageLoop::PostTask",
+      TRACE_ID_MANGLE(message_loop_->GetTaskTraceID(node->pending_task)));
+
+  subtle::AtomicWord head = subtle::NoBarrier_Load(&lock_free_head_);
+  while (true) {
+    node->next = reinterpret_cast<LockFreeNode*>(head);
+    subtle::AtomicWord previous = subtle::Release_CompareAndSwap(
+        &lock_free_head_, head, reinterpret_cast<subtle::AtomicWord>(node));
+    if (previous == head)
+      break;
+    head = previous;
+  }
+
+  // Only the poster that made the list non-empty needs to wake up the pump,
+  // mirroring |was_empty| in PostPendingTask().
+  message_loop_->ScheduleWork(!head);
+
+  subtle::Barrier_AtomicIncrement(&lock_free_posters_, -1);
+  return true;
+}
+
+void IncomingTaskQueue::ReloadWorkQueueFromLockFreeQueue(
+    TaskQueue* work_queue) {
+  // Take every task posted so far with a single exchange.
+  LockFreeNode* node = reinterpret_cast<LockFreeNode*>(
+      subtle::NoBarrier_AtomicExchange(&lock_free_head_, 0));
+  subtle::MemoryBarrier();  // Pairs with Release_CompareAndSwap() above.
+
+  // The list is linked from newest to oldest; reverse it to restore posting
+  // order.
+  LockFreeNode* oldest = NULL;
+  while (node) {
+    LockFreeNode* next = node->next;
+    node->next = oldest;
+    oldest = node;
+    node = next;
+  }
+
+  while (oldest) {
+    LockFreeNode* next = oldest->next;
+    work_queue->push(oldest->pending_task);
+    delete oldest;
+    oldest = next;
+  }
+}
+
 }  // namespace internal
 }  // namespace base
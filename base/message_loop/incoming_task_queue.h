@@ -5,6 +5,7 @@
 #ifndef BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 #define BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
 #include "base/pending_task.h"
@@ -21,10 +22,15 @@ namespace internal {
 // Implements a queue of tasks posted to the message loop running on the current
 // thread. This class takes care of synchronizing posting tasks from different
 // threads and together with MessageLoop ensures clean shutdown.
+//
+// By default posted tasks are appended to a TaskQueue under a lock. If
+// |lock_free| is true, posted tasks are instead pushed onto an intrusive
+// multi-producer single-consumer list with a compare-and-swap, and
+// ReloadWorkQueue() takes the whole batch with a single atomic exchange.
 class BASE_EXPORT IncomingTaskQueue
     : public RefCountedThreadSafe<IncomingTaskQueue> {
  public:
-  explicit IncomingTaskQueue(MessageLoop* message_loop);
+  IncomingTaskQueue(MessageLoop* message_loop, bool lock_free);
 
   // Appends a task to the incoming queue. Posting of all tasks is routed though
   // AddToIncomingQueue() or TryAddToIncomingQueue() to make sure that posting
@@ -56,6 +62,9 @@ class BASE_EXPORT IncomingTaskQueue
   friend class RefCountedThreadSafe<IncomingTaskQueue>;
   virtual ~IncomingTaskQueue();
 
+  // A posted task together with the link to the task posted before it.
+  struct LockFreeNode;
+
   // Calculates the time at which a PendingTask should run.
   TimeTicks CalculateDelayedRuntime(TimeDelta delay);
 
@@ -65,6 +74,13 @@ class BASE_EXPORT IncomingTaskQueue
   // does not retain |pending_task->task| beyond this function call.
   bool PostPendingTask(PendingTask* pending_task);
 
+  // Lock-free counterparts of AddToIncomingQueue() and ReloadWorkQueue().
+  bool AddToLockFreeQueue(const tracked_objects::Location& from_here,
+                          const Closure& task,
+                          TimeDelta delay,
+                          bool nestable);
+  void ReloadWorkQueueFromLockFreeQueue(TaskQueue* work_queue);
+
 #if defined(OS_WIN)
   TimeTicks high_resolution_timer_expiration_;
 #endif
@@ -84,6 +100,25 @@ class BASE_EXPORT IncomingTaskQueue
   // The next sequence number to use for delayed tasks.
   int next_sequence_num_;
 
+  // True if tasks are posted through the lock-free list below rather than
+  // |incoming_queue_|. Doesn't change after construction.
+  const bool lock_free_;
+
+  // The most recently posted LockFreeNode, or 0 if the list is empty. The
+  // list is linked from newest to oldest.
+  subtle::AtomicWord lock_free_head_;
+
+  // The number of threads currently inside AddToLockFreeQueue(), and whether
+  // WillDestroyCurrentMessageLoop() has been called. A poster increments
+  // |lock_free_posters_| before checking |lock_free_detached_|, and the loop
+  // sets |lock_free_detached_| before waiting for |lock_free_posters_| to
+  // drop to zero, so |message_loop_| is never used after it went away.
+  subtle::Atomic32 lock_free_posters_;
+  subtle::Atomic32 lock_free_detached_;
+
+  // The next sequence number to use in lock-free mode.
+  subtle::Atomic32 lock_free_sequence_num_;
+
   DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
 };
 
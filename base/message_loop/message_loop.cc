@@ -115,13 +115,28 @@ MessageLoop::DestructionObserver::~DestructionObserver() {
 
 MessageLoop::MessageLoop(Type type)
     : type_(type),
+      delayed_wakeups_(0),
       nestable_tasks_allowed_(true),
 #if defined(OS_WIN)
       os_modal_loop_(false),
 #endif  // OS_WIN
       message_histogram_(NULL),
       run_loop_(NULL) {
-  Init();
+  Init(INCOMING_QUEUE_LOCKED);
+
+  pump_.reset(CreateMessagePumpForType(type));
+}
+
+MessageLoop::MessageLoop(Type type, IncomingQueueType incoming_queue)
+    : type_(type),
+      delayed_wakeups_(0),
+      nestable_tasks_allowed_(true),
+#if defined(OS_WIN)
+      os_modal_loop_(false),
+#endif  // OS_WIN
+      message_histogram_(NULL),
+      run_loop_(NULL) {
+  Init(incoming_queue);
 
   pump_.reset(CreateMessagePumpForType(type));
 }
@@ -129,6 +144,7 @@ MessageLoop::MessageLoop(Type type)
 MessageLoop::MessageLoop(scoped_ptr<MessagePump> pump)
     : pump_(pump.Pass()),
       type_(TYPE_CUSTOM),
+      delayed_wakeups_(0),
       nestable_tasks_allowed_(true),
 #if defined(OS_WIN)
       os_modal_loop_(false),
@@ -136,7 +152,7 @@ MessageLoop::MessageLoop(scoped_ptr<MessagePump> pump)
       message_histogram_(NULL),
       run_loop_(NULL) {
   DCHECK(pump_.get());
-  Init();
+  Init(INCOMING_QUEUE_LOCKED);
 }
 
 MessageLoop::~MessageLoop() {
@@ -326,6 +342,14 @@ Closure MessageLoop::QuitWhenIdleClosure() {
   return Bind(&QuitCurrentWhenIdle);
 }
 
+void MessageLoop::UseTimerWheel(TimeDelta leeway) {
+  DCHECK_EQ(this, current());
+  DCHECK(delayed_work_queue_.empty());
+  if (!timer_wheel_)
+    timer_wheel_.reset(new internal::TimerWheel);
+  timer_wheel_->set_leeway(leeway);
+}
+
 void MessageLoop::SetNestableTasksAllowed(bool allowed) {
   if (allowed) {
     // Kick the native pump just in case we enter a OS-driven nested message
@@ -370,11 +394,12 @@ bool MessageLoop::IsIdleForTesting() {
 
 //------------------------------------------------------------------------------
 
-void MessageLoop::Init() {
+void MessageLoop::Init(IncomingQueueType incoming_queue) {
   DCHECK(!current()) << "should only have one message loop per thread";
   lazy_tls_ptr.Pointer()->Set(this);
 
-  incoming_task_queue_ = new internal::IncomingTaskQueue(this);
+  incoming_task_queue_ = new internal::IncomingTaskQueue(
+      this, incoming_queue == INCOMING_QUEUE_LOCK_FREE);
   message_loop_proxy_ =
       new internal::MessageLoopProxyImpl(incoming_task_queue_);
   thread_task_runner_handle_.reset(
@@ -444,7 +469,10 @@ void MessageLoop::RunTask(const PendingTask& pending_task) {
 
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
                     WillProcessTask(pending_task));
-  pending_task.task.Run();
+  {
+    tracked_objects::ScopedRunningTask running_task(pending_task.posted_from);
+    pending_task.task.Run();
+  }
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
                     DidProcessTask(pending_task));
 
@@ -470,7 +498,34 @@ bool MessageLoop::DeferOrRunPendingTask(const PendingTask& pending_task) {
 
 void MessageLoop::AddToDelayedWorkQueue(const PendingTask& pending_task) {
   // Move to the delayed work queue.
-  delayed_work_queue_.push(pending_task);
+  if (timer_wheel_)
+    timer_wheel_->Push(pending_task);
+  else
+    delayed_work_queue_.push(pending_task);
+}
+
+bool MessageLoop::DelayedWorkQueueIsEmpty() const {
+  return timer_wheel_ ? timer_wheel_->empty() : delayed_work_queue_.empty();
+}
+
+TimeTicks MessageLoop::NextDelayedWorkTime() const {
+  return timer_wheel_ ? timer_wheel_->NextWakeupTime() :
+                        delayed_work_queue_.top().delayed_run_time;
+}
+
+void MessageLoop::RecordDelayedWorkWakeup() {
+  ++delayed_wakeups_;
+  TimeDelta elapsed = recent_time_ - delayed_wakeups_start_;
+  if (elapsed < TimeDelta::FromSeconds(1))
+    return;
+  if (!delayed_wakeups_start_.is_null()) {
+    TRACE_COUNTER_ID1(TRACE_DISABLED_BY_DEFAULT("base.timers"),
+                      "MessageLoop::DelayedWakeupsPerSecond", this,
+                      static_cast<int>(delayed_wakeups_ /
+                                       elapsed.InSecondsF()));
+  }
+  delayed_wakeups_ = 0;
+  delayed_wakeups_start_ = recent_time_;
 }
 
 bool MessageLoop::DeletePendingTasks() {
@@ -489,7 +544,7 @@ bool MessageLoop::DeletePendingTasks() {
   while (!deferred_non_nestable_work_queue_.empty()) {
     deferred_non_nestable_work_queue_.pop();
   }
-  did_work |= !delayed_work_queue_.empty();
+  did_work |= !DelayedWorkQueueIsEmpty();
 
   // Historically, we always delete the task regardless of valgrind status. It's
   // not completely clear why we want to leak them in the loops above.  This
@@ -499,6 +554,11 @@ bool MessageLoop::DeletePendingTasks() {
   while (!delayed_work_queue_.empty()) {
     delayed_work_queue_.pop();
   }
+  if (timer_wheel_) {
+    PendingTask pending_task(FROM_HERE, Closure());
+    while (!timer_wheel_->empty())
+      timer_wheel_->Pop(&pending_task);
+  }
   return did_work;
 }
 
@@ -567,8 +627,12 @@ bool MessageLoop::DoWork() {
       if (!pending_task.delayed_run_time.is_null()) {
         AddToDelayedWorkQueue(pending_task);
         // If we changed the topmost task, then it is time to reschedule.
-        if (delayed_work_queue_.top().task.Equals(pending_task.task))
+        if (timer_wheel_) {
+          if (timer_wheel_->NextRunTime() == pending_task.delayed_run_time)
+            pump_->ScheduleDelayedWork(timer_wheel_->NextWakeupTime());
+        } else if (delayed_work_queue_.top().task.Equals(pending_task.task)) {
           pump_->ScheduleDelayedWork(pending_task.delayed_run_time);
+        }
       } else {
         if (DeferOrRunPendingTask(pending_task))
           return true;
@@ -581,7 +645,7 @@ bool MessageLoop::DoWork() {
 }
 
 bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
-  if (!nestable_tasks_allowed_ || delayed_work_queue_.empty()) {
+  if (!nestable_tasks_allowed_ || DelayedWorkQueueIsEmpty()) {
     recent_time_ = *next_delayed_work_time = TimeTicks();
     return false;
   }
@@ -593,13 +657,23 @@ bool MessageLoop::DoDelayedWork(TimeTicks* next_delayed_work_time) {
   // fall behind (and have a lot of ready-to-run delayed tasks), the more
   // efficient we'll be at handling the tasks.
 
-  TimeTicks next_run_time = delayed_work_queue_.top().delayed_run_time;
+  TimeTicks next_run_time = timer_wheel_ ?
+      timer_wheel_->NextRunTime() : delayed_work_queue_.top().delayed_run_time;
   if (next_run_time > recent_time_) {
     recent_time_ = TimeTicks::Now();  // Get a better view of Now();
     if (next_run_time > recent_time_) {
-      *next_delayed_work_time = next_run_time;
+      *next_delayed_work_time = NextDelayedWorkTime();
       return false;
     }
+    RecordDelayedWorkWakeup();
+  }
+
+  if (timer_wheel_) {
+    PendingTask pending_task(FROM_HERE, Closure());
+    bool cancelled = !timer_wheel_->Pop(&pending_task);
+    if (!timer_wheel_->empty())
+      *next_delayed_work_time = NextDelayedWorkTime();
+    return !cancelled && DeferOrRunPendingTask(pending_task);
   }
 
   PendingTask pending_task = delayed_work_queue_.top();
@@ -18,6 +18,7 @@
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/message_loop/message_loop_proxy_impl.h"
 #include "base/message_loop/message_pump.h"
+#include "base/message_loop/timer_wheel.h"
 #include "base/observer_list.h"
 #include "base/pending_task.h"
 #include "base/sequenced_task_runner_helpers.h"
@@ -141,9 +142,27 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
 #endif // defined(OS_ANDROID)
   };
 
+  // How tasks posted from other threads are handed to the loop.
+  //
+  // INCOMING_QUEUE_LOCKED
+  //   Posted tasks are appended to a queue under a lock, which is taken again
+  //   when the loop picks them up. This is the default.
+  //
+  // INCOMING_QUEUE_LOCK_FREE
+  //   Posted tasks are pushed onto a lock-free list, and the loop takes all of
+  //   them at once with an atomic exchange. Useful for loops that receive many
+  //   cross-thread posts, such as the IO thread.
+  //
+  enum IncomingQueueType {
+    INCOMING_QUEUE_LOCKED,
+    INCOMING_QUEUE_LOCK_FREE,
+  };
+
   // Normally, it is not necessary to instantiate a MessageLoop.  Instead, it
   // is typical to make use of the current thread's MessageLoop instance.
   explicit MessageLoop(Type type = TYPE_DEFAULT);
+  // Creates a MessageLoop of |type| whose incoming queue is |incoming_queue|.
+  MessageLoop(Type type, IncomingQueueType incoming_queue);
   // Creates a TYPE_CUSTOM MessageLoop with the supplied MessagePump, which must
   // be non-NULL.
   explicit MessageLoop(scoped_ptr<base::MessagePump> pump);
@@ -317,6 +336,16 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
     return message_loop_proxy_;
   }
 
+  // Keeps delayed tasks in a hierarchical timer wheel instead of a heap, see
+  // internal::TimerWheel. This makes posting delayed tasks O(1) and deletes
+  // cancelled tasks before they are due, which helps loops with many idle
+  // timers. A non-zero |leeway| lets tasks due within the same |leeway|
+  // interval run in a single wakeup, at most |leeway| late.
+  //
+  // Must be called on the thread the loop runs on, before any delayed task is
+  // queued.
+  void UseTimerWheel(TimeDelta leeway);
+
   // Enables or disables the recursive task processing. This happens in the case
   // of recursive message loops. Some unwanted message loop may occurs when
   // using common controls or printer functions. By default, recursive task
@@ -432,8 +461,8 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
   friend class internal::IncomingTaskQueue;
   friend class RunLoop;
 
-  // Configures various members for the two constructors.
-  void Init();
+  // Configures various members for the constructors.
+  void Init(IncomingQueueType incoming_queue);
 
   // Invokes the actual run loop using the message pump.
   void RunHandler();
@@ -448,9 +477,20 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
   // cannot be run right now.  Returns true if the task was run.
   bool DeferOrRunPendingTask(const PendingTask& pending_task);
 
-  // Adds the pending task to delayed_work_queue_.
+  // Adds the pending task to delayed_work_queue_ or timer_wheel_.
   void AddToDelayedWorkQueue(const PendingTask& pending_task);
 
+  // Returns true if there are no delayed tasks.
+  bool DelayedWorkQueueIsEmpty() const;
+
+  // Returns the time the pump should next wake up for delayed work. Must not
+  // be called if DelayedWorkQueueIsEmpty().
+  TimeTicks NextDelayedWorkTime() const;
+
+  // Counts a wakeup for delayed work, and reports the rate to the trace once
+  // a second.
+  void RecordDelayedWorkWakeup();
+
   // Delete tasks that haven't run yet without running them.  Used in the
   // destructor to make sure all the task's destructors get called.  Returns
   // true if some work was done.
@@ -494,6 +534,13 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
   // Contains delayed tasks, sorted by their 'delayed_run_time' property.
   DelayedTaskQueue delayed_work_queue_;
 
+  // Replaces |delayed_work_queue_| if UseTimerWheel() was called.
+  scoped_ptr<internal::TimerWheel> timer_wheel_;
+
+  // The number of wakeups for delayed work since |delayed_wakeups_start_|.
+  int delayed_wakeups_;
+  TimeTicks delayed_wakeups_start_;
+
   // A recent snapshot of Time::Now(), used to check delayed_work_queue_.
   TimeTicks recent_time_;
 
@@ -2,13 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <vector>
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/cancelable_callback.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy_impl.h"
 #include "base/message_loop/message_loop_test.h"
@@ -20,7 +23,9 @@
 #include "base/thread_task_runner_handle.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 
 #if defined(OS_WIN)
 #include "base/message_loop/message_pump_win.h"
@@ -958,6 +963,173 @@ TEST(MessageLoopTest, IsType) {
   EXPECT_FALSE(loop.IsType(MessageLoop::TYPE_DEFAULT));
 }
 
+namespace {
+
+const int kIncomingQueuePosters = 4;
+
+// Records on the loop thread that task |index| posted by |poster| ran, and
+// quits the loop once |expected_count| tasks ran in total.
+void RecordIncomingTask(std::vector<std::vector<int> >* order,
+                        int expected_count,
+                        int poster,
+                        int index) {
+  (*order)[poster].push_back(index);
+  int count = 0;
+  for (size_t i = 0; i < order->size(); ++i)
+    count += static_cast<int>((*order)[i].size());
+  if (count == expected_count)
+    MessageLoop::current()->QuitWhenIdle();
+}
+
+void PostIncomingTasks(scoped_refptr<MessageLoopProxy> target,
+                       std::vector<std::vector<int> >* order,
+                       int expected_count,
+                       int poster,
+                       int count) {
+  for (int i = 0; i < count; ++i) {
+    EXPECT_TRUE(target->PostTask(
+        FROM_HERE,
+        Bind(&RecordIncomingTask, order, expected_count, poster, i)));
+  }
+}
+
+// Posts |tasks_per_poster| tasks to the current loop from each of
+// kIncomingQueuePosters threads, runs the loop until all of them ran and
+// returns how long that took. Tasks from each thread must run in posting
+// order.
+TimeDelta RunIncomingQueueTest(int tasks_per_poster) {
+  const int expected_count = kIncomingQueuePosters * tasks_per_poster;
+  std::vector<std::vector<int> > order(kIncomingQueuePosters);
+  ScopedVector<Thread> posters;
+  for (int i = 0; i < kIncomingQueuePosters; ++i) {
+    posters.push_back(new Thread("IncomingQueuePoster"));
+    EXPECT_TRUE(posters.back()->Start());
+  }
+
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kIncomingQueuePosters; ++i) {
+    posters[i]->message_loop()->PostTask(
+        FROM_HERE,
+        Bind(&PostIncomingTasks, MessageLoop::current()->message_loop_proxy(),
+             &order, expected_count, i, tasks_per_poster));
+  }
+  MessageLoop::current()->Run();
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  // Joins the posting threads.
+  posters.clear();
+
+  for (int i = 0; i < kIncomingQueuePosters; ++i) {
+    EXPECT_EQ(static_cast<size_t>(tasks_per_poster), order[i].size());
+    for (size_t j = 0; j < order[i].size(); ++j)
+      EXPECT_EQ(static_cast<int>(j), order[i][j]);
+  }
+  return elapsed;
+}
+
+void RunIncomingQueueThroughputTest(MessageLoop::IncomingQueueType type,
+                                    const std::string& trace) {
+  const int kTasksPerPoster = 50000;
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT, type);
+  const TimeDelta elapsed = RunIncomingQueueTest(kTasksPerPoster);
+  perf_test::PrintResult(
+      "message_loop_incoming_queue_throughput", "", trace,
+      kIncomingQueuePosters * kTasksPerPoster /
+          std::max(elapsed.InSecondsF(), 1e-6),
+      "tasks/s", true);
+}
+
+}  // namespace
+
+TEST(MessageLoopTest, LockFreeIncomingQueue) {
+  MessageLoop loop(MessageLoop::TYPE_DEFAULT,
+                   MessageLoop::INCOMING_QUEUE_LOCK_FREE);
+
+  // Tasks posted from the loop's own thread still run in order.
+  std::vector<std::vector<int> > order(1);
+  PostIncomingTasks(loop.message_loop_proxy(), &order, 3, 0, 3);
+  loop.Run();
+  ASSERT_EQ(3u, order[0].size());
+  EXPECT_EQ(0, order[0][0]);
+  EXPECT_EQ(1, order[0][1]);
+  EXPECT_EQ(2, order[0][2]);
+  EXPECT_TRUE(loop.IsIdleForTesting());
+
+  RunIncomingQueueTest(1000);
+}
+
+TEST(MessageLoopTest, LockFreeIncomingQueuePostAfterDestruction) {
+  scoped_refptr<MessageLoopProxy> proxy;
+  bool task_destroyed = false;
+  bool destruction_observer_called = false;
+  {
+    MessageLoop loop(MessageLoop::TYPE_DEFAULT,
+                     MessageLoop::INCOMING_QUEUE_LOCK_FREE);
+    proxy = loop.message_loop_proxy();
+    // A task that never runs is deleted along with the loop.
+    EXPECT_TRUE(proxy->PostTask(
+        FROM_HERE,
+        Bind(&DestructionObserverProbe::Run,
+             new DestructionObserverProbe(&task_destroyed,
+                                          &destruction_observer_called))));
+  }
+  EXPECT_TRUE(task_destroyed);
+  EXPECT_FALSE(proxy->PostTask(FROM_HERE, Bind(&DoNothing)));
+}
+
+TEST(MessageLoopTest, IncomingQueueThroughput) {
+  RunIncomingQueueThroughputTest(MessageLoop::INCOMING_QUEUE_LOCKED, "locked");
+  RunIncomingQueueThroughputTest(MessageLoop::INCOMING_QUEUE_LOCK_FREE,
+                                 "lock_free");
+}
+
+namespace {
+
+void RecordDelayedTask(std::vector<int>* order, int id) {
+  order->push_back(id);
+}
+
+void RunTimerWheelTest(TimeDelta leeway) {
+  MessageLoop loop;
+  loop.UseTimerWheel(leeway);
+
+  std::vector<int> order;
+  CancelableClosure cancelled(Bind(&RecordDelayedTask, &order, -1));
+  loop.PostDelayedTask(FROM_HERE, Bind(&RecordDelayedTask, &order, 3),
+                       TimeDelta::FromMilliseconds(30));
+  loop.PostDelayedTask(FROM_HERE, Bind(&RecordDelayedTask, &order, 1),
+                       TimeDelta::FromMilliseconds(10));
+  loop.PostDelayedTask(FROM_HERE, cancelled.callback(),
+                       TimeDelta::FromMilliseconds(5));
+  loop.PostDelayedTask(FROM_HERE, Bind(&RecordDelayedTask, &order, 2),
+                       TimeDelta::FromMilliseconds(20));
+  loop.PostTask(FROM_HERE, Bind(&RecordDelayedTask, &order, 0));
+  loop.PostDelayedTask(FROM_HERE, MessageLoop::QuitWhenIdleClosure(),
+                       TimeDelta::FromMilliseconds(40));
+  // Posted far out; deleted with the loop.
+  loop.PostDelayedTask(FROM_HERE, Bind(&RecordDelayedTask, &order, -2),
+                       TimeDelta::FromDays(1));
+  cancelled.Cancel();
+
+  const TimeTicks start = TimeTicks::Now();
+  loop.Run();
+  EXPECT_LE(TimeDelta::FromMilliseconds(40), TimeTicks::Now() - start);
+
+  ASSERT_EQ(4u, order.size());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(i, order[i]);
+}
+
+}  // namespace
+
+TEST(MessageLoopTest, TimerWheel) {
+  RunTimerWheelTest(TimeDelta());
+}
+
+TEST(MessageLoopTest, TimerWheelWithLeeway) {
+  RunTimerWheelTest(TimeDelta::FromMilliseconds(15));
+}
+
 #if defined(OS_WIN)
 void EmptyFunction() {}
 
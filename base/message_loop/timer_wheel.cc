@@ -0,0 +1,206 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/timer_wheel.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Returns the index of the lowest set bit of |bits|, which must not be 0.
+int LowestSetBit(uint64 bits) {
+  DCHECK(bits);
+#if defined(COMPILER_GCC)
+  return __builtin_ctzll(bits);
+#else
+  int index = 0;
+  while (!(bits & 1)) {
+    bits >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+}  // namespace
+
+TimerWheel::Slot::Slot() {
+}
+
+TimerWheel::Slot::~Slot() {
+}
+
+TimerWheel::TimerWheel()
+    : origin_(TimeTicks::Now()),
+      current_tick_(0),
+      size_(0) {
+  for (int level = 0; level < kNumLevels; ++level)
+    occupied_[level] = 0;
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+void TimerWheel::Push(const PendingTask& pending_task) {
+  DCHECK(!pending_task.delayed_run_time.is_null());
+  ++size_;
+  Insert(pending_task);
+}
+
+TimeTicks TimerWheel::NextRunTime() const {
+  DCHECK(!empty());
+  bool found = !ready_tasks_.empty();
+  TimeTicks next_run_time;
+  if (found)
+    next_run_time = ready_tasks_.top().delayed_run_time;
+
+  // The first occupied slot of each level holds that level's earliest tasks.
+  for (int level = 0; level < kNumLevels; ++level) {
+    int slot = NextOccupiedSlot(level);
+    if (slot < 0)
+      continue;
+    TimeTicks min_run_time = slots_[level][slot].min_run_time;
+    if (!found || min_run_time < next_run_time) {
+      next_run_time = min_run_time;
+      found = true;
+    }
+  }
+  DCHECK(found);
+  return next_run_time;
+}
+
+TimeTicks TimerWheel::NextWakeupTime() const {
+  TimeTicks next_run_time = NextRunTime();
+  int64 leeway_us = leeway_.InMicroseconds();
+  int64 offset_us = (next_run_time - origin_).InMicroseconds();
+  if (leeway_us <= 0 || offset_us <= 0)
+    return next_run_time;
+  int64 rounded_us = (offset_us + leeway_us - 1) / leeway_us * leeway_us;
+  return origin_ + TimeDelta::FromMicroseconds(rounded_us);
+}
+
+bool TimerWheel::Pop(PendingTask* pending_task) {
+  // Bring the next task into |ready_tasks_|.
+  const TimeTicks next_run_time = NextRunTime();
+  AdvanceTo(std::max(current_tick_, TickForTime(next_run_time)));
+
+  // The task may have been found cancelled and deleted while cascading. Don't
+  // hand out a later one in its place, it may not be due yet.
+  if (ready_tasks_.empty() ||
+      ready_tasks_.top().delayed_run_time != next_run_time) {
+    return false;
+  }
+
+  const PendingTask& next = ready_tasks_.top();
+  bool cancelled = next.task.IsCancelled();
+  if (!cancelled)
+    *pending_task = next;
+  ready_tasks_.pop();
+  --size_;
+  return !cancelled;
+}
+
+int64 TimerWheel::TickForTime(TimeTicks time) const {
+  if (time <= origin_)
+    return 0;
+  return (time - origin_).InMilliseconds();
+}
+
+void TimerWheel::Insert(const PendingTask& pending_task) {
+  int64 tick = TickForTime(pending_task.delayed_run_time);
+  if (tick <= current_tick_) {
+    ready_tasks_.push(pending_task);
+    return;
+  }
+
+  // Tasks beyond the top level's span wait in its last slot and are filed
+  // again from there.
+  const int kTopLevelShift = kBitsPerLevel * kNumLevels;
+  if ((tick >> kTopLevelShift) != (current_tick_ >> kTopLevelShift))
+    tick = (((current_tick_ >> kTopLevelShift) + 1) << kTopLevelShift) - 1;
+  DCHECK_GT(tick, current_tick_);
+
+  // Use the lowest level whose current span of slots contains |tick|.
+  int level = 0;
+  while ((tick >> (kBitsPerLevel * (level + 1))) !=
+         (current_tick_ >> (kBitsPerLevel * (level + 1)))) {
+    ++level;
+  }
+
+  int slot_index =
+      static_cast<int>((tick >> (kBitsPerLevel * level)) & (kSlotsPerLevel - 1));
+  Slot& slot = slots_[level][slot_index];
+  if (slot.tasks.empty() || pending_task.delayed_run_time < slot.min_run_time)
+    slot.min_run_time = pending_task.delayed_run_time;
+  slot.tasks.push_back(pending_task);
+  occupied_[level] |= GG_UINT64_C(1) << slot_index;
+}
+
+int TimerWheel::NextOccupiedSlot(int level) const {
+  // Every occupied slot of a level comes after the slot |current_tick_| is
+  // in; the ones before were cascaded when |current_tick_| reached them.
+  int current_slot = static_cast<int>(
+      (current_tick_ >> (kBitsPerLevel * level)) & (kSlotsPerLevel - 1));
+  if (current_slot == kSlotsPerLevel - 1)
+    return -1;
+  uint64 later_slots =
+      occupied_[level] & (~GG_UINT64_C(0) << (current_slot + 1));
+  return later_slots ? LowestSetBit(later_slots) : -1;
+}
+
+int64 TimerWheel::SlotStartTick(int level, int slot) const {
+  const int span_shift = kBitsPerLevel * (level + 1);
+  return ((current_tick_ >> span_shift) << span_shift) +
+         (static_cast<int64>(slot) << (kBitsPerLevel * level));
+}
+
+void TimerWheel::AdvanceTo(int64 tick) {
+  while (current_tick_ < tick) {
+    // Jump straight to the next slot that needs cascading, if it comes before
+    // |tick|.
+    int64 next_tick = tick;
+    for (int level = 0; level < kNumLevels; ++level) {
+      int slot = NextOccupiedSlot(level);
+      if (slot >= 0)
+        next_tick = std::min(next_tick, SlotStartTick(level, slot));
+    }
+    current_tick_ = next_tick;
+
+    // Go from the top so that the lower levels have received the tasks of the
+    // higher ones before they are looked at.
+    for (int level = kNumLevels - 1; level >= 0; --level) {
+      const int shift = kBitsPerLevel * level;
+      if (current_tick_ & ((GG_INT64_C(1) << shift) - 1))
+        continue;
+      int slot = static_cast<int>(
+          (current_tick_ >> shift) & (kSlotsPerLevel - 1));
+      if (occupied_[level] & (GG_UINT64_C(1) << slot))
+        CascadeSlot(level, slot);
+    }
+  }
+}
+
+void TimerWheel::CascadeSlot(int level, int slot_index) {
+  Slot& slot = slots_[level][slot_index];
+  std::vector<PendingTask> tasks;
+  tasks.swap(slot.tasks);
+  slot.min_run_time = TimeTicks();
+  occupied_[level] &= ~(GG_UINT64_C(1) << slot_index);
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (tasks[i].task.IsCancelled()) {
+      --size_;
+      continue;
+    }
+    Insert(tasks[i]);
+  }
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,121 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MESSAGE_LOOP_TIMER_WHEEL_H_
+#define BASE_MESSAGE_LOOP_TIMER_WHEEL_H_
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/pending_task.h"
+#include "base/time/time.h"
+
+namespace base {
+namespace internal {
+
+// A hierarchical timer wheel holding delayed PendingTasks, used by MessageLoop
+// in place of a DelayedTaskQueue when many long-lived timers are pending.
+//
+// Time is divided into ticks of one millisecond. Level 0 of the wheel has a
+// slot per tick for the next 64 ticks, level 1 a slot per 64 ticks for the
+// next 64 * 64 ticks, and so on. Adding a task is O(1). As time advances, the
+// tasks in a higher level slot are spread over the lower levels, and the tasks
+// of a level 0 slot are moved to a small heap from which they are run in
+// (delayed_run_time, sequence_num) order, exactly like a DelayedTaskQueue.
+//
+// Tasks whose callback was cancelled (see Callback::IsCancelled()) are deleted
+// whenever the wheel moves them between levels instead of staying around
+// until they expire.
+//
+// If a leeway is set, NextWakeupTime() rounds the next run time up to a
+// multiple of the leeway so that timers due close to each other are run in a
+// single wakeup.
+class BASE_EXPORT TimerWheel {
+ public:
+  TimerWheel();
+  ~TimerWheel();
+
+  void set_leeway(TimeDelta leeway) { leeway_ = leeway; }
+  TimeDelta leeway() const { return leeway_; }
+
+  // Returns true if there are no tasks, including cancelled tasks that
+  // haven't been deleted yet.
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Adds |pending_task|, which must have a non-null delayed_run_time.
+  void Push(const PendingTask& pending_task);
+
+  // Returns the delayed_run_time of the next task. Must not be empty.
+  TimeTicks NextRunTime() const;
+
+  // Returns NextRunTime() rounded up to the leeway.
+  TimeTicks NextWakeupTime() const;
+
+  // Removes the next task, the one due at NextRunTime(). Returns false,
+  // without setting |*pending_task|, if that task turned out to be cancelled;
+  // there may be no task due at NextRunTime() anymore then. Must not be
+  // empty.
+  bool Pop(PendingTask* pending_task);
+
+ private:
+  enum {
+    kBitsPerLevel = 6,
+    kSlotsPerLevel = 1 << kBitsPerLevel,
+    // Covers 2^48 milliseconds, well beyond any delay used in practice.
+    kNumLevels = 8,
+  };
+
+  struct Slot {
+    Slot();
+    ~Slot();
+
+    std::vector<PendingTask> tasks;
+    // The earliest delayed_run_time in |tasks|.
+    TimeTicks min_run_time;
+  };
+
+  int64 TickForTime(TimeTicks time) const;
+
+  // Files |pending_task| into the right slot relative to |current_tick_|, or
+  // into |ready_tasks_| if it is due in the current tick.
+  void Insert(const PendingTask& pending_task);
+
+  // Returns the index of the next non-empty slot of |level| after the one
+  // |current_tick_| falls in, or -1 if there is none.
+  int NextOccupiedSlot(int level) const;
+
+  // Returns the first tick of |slot| at |level|.
+  int64 SlotStartTick(int level, int slot) const;
+
+  // Moves |current_tick_| forward to |tick|, cascading every slot that starts
+  // in between.
+  void AdvanceTo(int64 tick);
+
+  // Empties |slot| of |level| and files its tasks again, dropping cancelled
+  // ones.
+  void CascadeSlot(int level, int slot);
+
+  // Ticks are counted from here.
+  const TimeTicks origin_;
+  int64 current_tick_;
+
+  TimeDelta leeway_;
+  size_t size_;
+
+  Slot slots_[kNumLevels][kSlotsPerLevel];
+  // Bit i is set if slots_[level][i] is not empty.
+  uint64 occupied_[kNumLevels];
+
+  // Tasks due in the current tick or earlier.
+  DelayedTaskQueue ready_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_MESSAGE_LOOP_TIMER_WHEEL_H_
@@ -0,0 +1,185 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/timer_wheel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/weak_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+void RecordRun(std::vector<int>* order, int id) {
+  order->push_back(id);
+}
+
+class Target {
+ public:
+  Target() : weak_factory_(this) {}
+
+  void Run() {}
+
+  WeakPtr<Target> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+  void InvalidateWeakPtrs() { weak_factory_.InvalidateWeakPtrs(); }
+
+ private:
+  WeakPtrFactory<Target> weak_factory_;
+};
+
+class TimerWheelTest : public testing::Test {
+ protected:
+  TimerWheelTest() : start_(TimeTicks::Now()), next_sequence_num_(0) {}
+
+  void Push(TimeDelta delay, const Closure& task) {
+    PendingTask pending_task(FROM_HERE, task, start_ + delay, true);
+    pending_task.sequence_num = next_sequence_num_++;
+    wheel_.Push(pending_task);
+  }
+
+  void PushRecorded(TimeDelta delay, int id) {
+    Push(delay, Bind(&RecordRun, &order_, id));
+  }
+
+  // Pops and runs every task.
+  void RunAll() {
+    TimeTicks last_run_time;
+    while (!wheel_.empty()) {
+      TimeTicks next_run_time = wheel_.NextRunTime();
+      EXPECT_LE(last_run_time, next_run_time);
+      PendingTask pending_task(FROM_HERE, Closure());
+      if (wheel_.Pop(&pending_task)) {
+        EXPECT_EQ(next_run_time, pending_task.delayed_run_time);
+        pending_task.task.Run();
+      }
+      last_run_time = next_run_time;
+    }
+  }
+
+  const TimeTicks start_;
+  int next_sequence_num_;
+  TimerWheel wheel_;
+  std::vector<int> order_;
+};
+
+}  // namespace
+
+TEST_F(TimerWheelTest, RunsInTimeOrder) {
+  // Spread over several levels of the wheel, pushed out of order.
+  const int64 kDelaysMs[] = {
+    5, 1, 63, 64, 65, 4095, 4096, 4097, 300000, 2, 86400000, 1000, 0,
+  };
+  for (size_t i = 0; i < arraysize(kDelaysMs); ++i)
+    PushRecorded(TimeDelta::FromMilliseconds(kDelaysMs[i]), i);
+  EXPECT_EQ(arraysize(kDelaysMs), wheel_.size());
+
+  RunAll();
+
+  std::vector<std::pair<int64, int> > sorted;
+  for (size_t i = 0; i < arraysize(kDelaysMs); ++i)
+    sorted.push_back(std::make_pair(kDelaysMs[i], static_cast<int>(i)));
+  std::sort(sorted.begin(), sorted.end());
+  ASSERT_EQ(sorted.size(), order_.size());
+  for (size_t i = 0; i < sorted.size(); ++i)
+    EXPECT_EQ(sorted[i].second, order_[i]);
+}
+
+TEST_F(TimerWheelTest, SameRunTimeRunsInPostOrder) {
+  const TimeDelta kDelay = TimeDelta::FromMicroseconds(1500);
+  for (int i = 0; i < 10; ++i)
+    PushRecorded(kDelay, i);
+  // Due in the same tick, but earlier.
+  PushRecorded(TimeDelta::FromMicroseconds(1200), 10);
+
+  RunAll();
+
+  ASSERT_EQ(11u, order_.size());
+  EXPECT_EQ(10, order_[0]);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(i, order_[i + 1]);
+}
+
+TEST_F(TimerWheelTest, PushAfterPop) {
+  PushRecorded(TimeDelta::FromMilliseconds(10000), 0);
+  PushRecorded(TimeDelta::FromMilliseconds(100), 1);
+
+  PendingTask pending_task(FROM_HERE, Closure());
+  ASSERT_TRUE(wheel_.Pop(&pending_task));
+  pending_task.task.Run();
+
+  // Tasks added after the wheel advanced, including ones already due, still
+  // come out in order.
+  PushRecorded(TimeDelta::FromMilliseconds(50), 2);
+  PushRecorded(TimeDelta::FromMilliseconds(5000), 3);
+  PushRecorded(TimeDelta::FromMilliseconds(100), 4);
+  RunAll();
+
+  ASSERT_EQ(5u, order_.size());
+  EXPECT_EQ(1, order_[0]);
+  EXPECT_EQ(2, order_[1]);
+  EXPECT_EQ(4, order_[2]);
+  EXPECT_EQ(3, order_[3]);
+  EXPECT_EQ(0, order_[4]);
+}
+
+TEST_F(TimerWheelTest, DropsCancelledTasks) {
+  Target target;
+  Push(TimeDelta::FromMilliseconds(10),
+       Bind(&Target::Run, target.GetWeakPtr()));
+  Push(TimeDelta::FromHours(1), Bind(&Target::Run, target.GetWeakPtr()));
+  PushRecorded(TimeDelta::FromMinutes(1), 0);
+  PushRecorded(TimeDelta::FromHours(2), 1);
+  EXPECT_EQ(4u, wheel_.size());
+
+  target.InvalidateWeakPtrs();
+
+  // The first task was cancelled.
+  PendingTask pending_task(FROM_HERE, Closure());
+  EXPECT_FALSE(wheel_.Pop(&pending_task));
+  EXPECT_EQ(3u, wheel_.size());
+
+  ASSERT_TRUE(wheel_.Pop(&pending_task));
+  pending_task.task.Run();
+  EXPECT_EQ(2u, wheel_.size());
+
+  // The hour long task is deleted when its slot is cascaded, before it is due.
+  EXPECT_EQ(start_ + TimeDelta::FromHours(1), wheel_.NextRunTime());
+  EXPECT_FALSE(wheel_.Pop(&pending_task));
+  EXPECT_EQ(1u, wheel_.size());
+  EXPECT_EQ(start_ + TimeDelta::FromHours(2), wheel_.NextRunTime());
+
+  ASSERT_TRUE(wheel_.Pop(&pending_task));
+  pending_task.task.Run();
+  EXPECT_TRUE(wheel_.empty());
+
+  ASSERT_EQ(2u, order_.size());
+  EXPECT_EQ(0, order_[0]);
+  EXPECT_EQ(1, order_[1]);
+}
+
+TEST_F(TimerWheelTest, Leeway) {
+  PushRecorded(TimeDelta::FromMicroseconds(10300), 0);
+  EXPECT_EQ(wheel_.NextRunTime(), wheel_.NextWakeupTime());
+
+  const TimeDelta kLeeway = TimeDelta::FromMilliseconds(4);
+  wheel_.set_leeway(kLeeway);
+  TimeTicks wakeup = wheel_.NextWakeupTime();
+  EXPECT_LE(wheel_.NextRunTime(), wakeup);
+  EXPECT_GT(wheel_.NextRunTime() + kLeeway, wakeup);
+
+  // A task due a little later shares the wakeup.
+  PushRecorded(TimeDelta::FromMicroseconds(10400), 1);
+  EXPECT_EQ(wakeup, wheel_.NextWakeupTime());
+
+  RunAll();
+  EXPECT_EQ(2u, order_.size());
+}
+
+}  // namespace internal
+}  // namespace base
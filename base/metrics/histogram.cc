@@ -18,7 +18,9 @@
 #include "base/debug/alias.h"
 #include "base/logging.h"
 #include "base/metrics/sample_vector.h"
+#include "base/metrics/shared_histogram_allocator.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/metrics/thread_local_samples.h"
 #include "base/pickle.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -105,6 +107,7 @@ HistogramBase* Histogram::FactoryGet(const string& name,
         new Histogram(name, minimum, maximum, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
+    SharedHistogramAllocator::MoveToGlobalStorage(tentative_histogram);
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -262,7 +265,10 @@ void Histogram::Add(int value) {
     value = kSampleType_MAX - 1;
   if (value < 0)
     value = 0;
-  samples_->Accumulate(value, 1);
+  if (flags() & kThreadLocalSamplesFlag)
+    GetThreadLocalSamples()->Accumulate(value, 1);
+  else
+    samples_->Accumulate(value, 1);
 }
 
 scoped_ptr<HistogramSamples> Histogram::SnapshotSamples() const {
@@ -306,12 +312,15 @@ Histogram::Histogram(const string& name,
   : HistogramBase(name),
     bucket_ranges_(ranges),
     declared_min_(minimum),
-    declared_max_(maximum) {
+    declared_max_(maximum),
+    thread_local_samples_(0) {
   if (ranges)
     samples_.reset(new SampleVector(ranges));
 }
 
 Histogram::~Histogram() {
+  delete reinterpret_cast<ThreadLocalSamples*>(
+      subtle::NoBarrier_Load(&thread_local_samples_));
 }
 
 bool Histogram::PrintEmptyBucket(size_t index) const {
@@ -367,9 +376,32 @@ HistogramBase* Histogram::DeserializeInfoImpl(PickleIterator* iter) {
 scoped_ptr<SampleVector> Histogram::SnapshotSampleVector() const {
   scoped_ptr<SampleVector> samples(new SampleVector(bucket_ranges()));
   samples->Add(*samples_);
+  ThreadLocalSamples* thread_local_samples =
+      reinterpret_cast<ThreadLocalSamples*>(
+          subtle::Acquire_Load(&thread_local_samples_));
+  if (thread_local_samples)
+    thread_local_samples->AddTo(samples.get());
   return samples.Pass();
 }
 
+ThreadLocalSamples* Histogram::GetThreadLocalSamples() {
+  subtle::AtomicWord value = subtle::Acquire_Load(&thread_local_samples_);
+  if (value)
+    return reinterpret_cast<ThreadLocalSamples*>(value);
+
+  ThreadLocalSamples* thread_local_samples =
+      new ThreadLocalSamples(bucket_ranges());
+  value = subtle::Release_CompareAndSwap(
+      &thread_local_samples_, 0,
+      reinterpret_cast<subtle::AtomicWord>(thread_local_samples));
+  if (value) {
+    // Another thread got there first.
+    delete thread_local_samples;
+    return reinterpret_cast<ThreadLocalSamples*>(value);
+  }
+  return thread_local_samples;
+}
+
 void Histogram::WriteAsciiImpl(bool graph_it,
                                const string& newline,
                                string* output) const {
@@ -562,6 +594,7 @@ HistogramBase* LinearHistogram::FactoryGetWithRangeDescription(
     }
 
     tentative_histogram->SetFlags(flags);
+    SharedHistogramAllocator::MoveToGlobalStorage(tentative_histogram);
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -658,6 +691,7 @@ HistogramBase* BooleanHistogram::FactoryGet(const string& name, int32 flags) {
         new BooleanHistogram(name, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
+    SharedHistogramAllocator::MoveToGlobalStorage(tentative_histogram);
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -716,7 +750,7 @@ HistogramBase* CustomHistogram::FactoryGet(const string& name,
         new CustomHistogram(name, registered_ranges);
 
     tentative_histogram->SetFlags(flags);
-
+    SharedHistogramAllocator::MoveToGlobalStorage(tentative_histogram);
     histogram =
         StatisticsRecorder::RegisterOrDeleteDuplicate(tentative_histogram);
   }
@@ -374,6 +374,7 @@ class Lock;
 
 class BucketRanges;
 class SampleVector;
+class ThreadLocalSamples;
 
 class BooleanHistogram;
 class CustomHistogram;
@@ -497,6 +498,7 @@ class BASE_EXPORT Histogram : public HistogramBase {
   FRIEND_TEST_ALL_PREFIXES(HistogramTest, CorruptSampleCounts);
   FRIEND_TEST_ALL_PREFIXES(HistogramTest, NameMatchTest);
 
+  friend class SharedHistogramAllocator;  // To move |samples_|.
   friend class StatisticsRecorder;  // To allow it to delete duplicates.
   friend class StatisticsRecorderTest;
 
@@ -507,6 +509,10 @@ class BASE_EXPORT Histogram : public HistogramBase {
   // Implementation of SnapshotSamples function.
   scoped_ptr<SampleVector> SnapshotSampleVector() const;
 
+  // Returns the per-thread buffers used with kThreadLocalSamplesFlag,
+  // creating them on first use.
+  ThreadLocalSamples* GetThreadLocalSamples();
+
   //----------------------------------------------------------------------------
   // Helpers for emitting Ascii graphic.  Each method appends data to output.
 
@@ -545,6 +551,9 @@ class BASE_EXPORT Histogram : public HistogramBase {
   // sample.
   scoped_ptr<SampleVector> samples_;
 
+  // A ThreadLocalSamples*, set by GetThreadLocalSamples().
+  subtle::AtomicWord thread_local_samples_;
+
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -73,6 +73,16 @@ class BASE_EXPORT HistogramBase {
     // the source histogram!).
     kIPCSerializationSourceFlag = 0x10,
 
+    // Only for Histogram and its sub classes: record samples into a buffer of
+    // the calling thread, which is added to the shared samples when the
+    // histogram is snapshotted. Use for histograms that are updated very
+    // often from several threads; see ThreadLocalSamples.
+    kThreadLocalSamplesFlag = 0x20,
+
+    // Set on histograms whose samples are kept in shared memory, from which
+    // another process reads them directly. See SharedHistogramAllocator.
+    kSharedMemoryFlag = 0x40,
+
     // Only for Histogram and its sub classes: fancy bucket-naming support.
     kHexRangePrintingFlag = 0x8000,
   };
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/bucket_ranges.h"
@@ -15,6 +16,8 @@
 #include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/pickle.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -306,6 +309,45 @@ TEST_F(HistogramTest, BucketPlacementTest) {
     EXPECT_EQ(i + 1, samples->GetCountAtIndex(i));
 }
 
+namespace {
+
+void AddSamples(HistogramBase* histogram, int value, int times) {
+  for (int i = 0; i < times; ++i)
+    histogram->Add(value);
+}
+
+}  // namespace
+
+TEST_F(HistogramTest, ThreadLocalSamples) {
+  Histogram* histogram = static_cast<Histogram*>(
+      Histogram::FactoryGet("ThreadLocal", 1, 64, 8,
+                            HistogramBase::kThreadLocalSamplesFlag));
+  histogram->Add(20);
+
+  Thread thread("HistogramTest");
+  ASSERT_TRUE(thread.Start());
+  thread.message_loop()->PostTask(FROM_HERE,
+                                  Bind(&AddSamples, histogram, 40, 10));
+  WaitableEvent done(false, false);
+  thread.message_loop()->PostTask(
+      FROM_HERE, Bind(&WaitableEvent::Signal, Unretained(&done)));
+  done.Wait();
+
+  scoped_ptr<HistogramSamples> snapshot = histogram->SnapshotSamples();
+  EXPECT_EQ(11, snapshot->TotalCount());
+  EXPECT_EQ(20 + 400, snapshot->sum());
+  EXPECT_EQ(HistogramBase::NO_INCONSISTENCIES,
+            histogram->FindCorruption(*snapshot));
+
+  // Samples added from elsewhere go straight to the shared samples.
+  histogram->AddSamples(*snapshot);
+  thread.Stop();
+  snapshot = histogram->SnapshotSamples();
+  EXPECT_EQ(22, snapshot->TotalCount());
+  EXPECT_EQ(2, snapshot->GetCount(20));
+  EXPECT_EQ(20, snapshot->GetCount(40));
+}
+
 TEST_F(HistogramTest, CorruptSampleCounts) {
   Histogram* histogram = static_cast<Histogram*>(
       Histogram::FactoryGet("Histogram", 1, 64, 8, HistogramBase::kNoFlags));
@@ -0,0 +1,274 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/shared_histogram_allocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+#include "base/memory/shared_memory.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/sample_vector.h"
+#include "base/pickle.h"
+
+namespace base {
+
+namespace {
+
+// Identifies the layout below; change it when the layout changes.
+const int32 kMagic = 0x48697331;  // 'His1'
+
+const size_t kAlignment = 8;
+
+size_t AlignUp(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+SharedHistogramAllocator* g_allocator = NULL;
+
+}  // namespace
+
+// At the start of the memory.
+struct SharedHistogramAllocator::Header {
+  subtle::Atomic32 magic;
+  uint32 size;
+
+  // Offset of the first unallocated byte.
+  subtle::Atomic32 free_offset;
+  uint32 padding;
+};
+
+// Records follow the header and each other. A record is followed by the
+// |bucket_count| counts of the histogram and the |info_size| bytes of its
+// pickled construction arguments, see HistogramBase::SerializeInfo().
+struct SharedHistogramAllocator::RecordHeader {
+  // Set once the rest of the record has been written.
+  subtle::Atomic32 ready;
+  uint32 size;
+  uint32 bucket_count;
+  uint32 info_size;
+
+  HistogramSamples::Metadata meta;
+
+  HistogramBase::AtomicCount* counts() {
+    return reinterpret_cast<HistogramBase::AtomicCount*>(this + 1);
+  }
+  char* info() {
+    return reinterpret_cast<char*>(counts() + bucket_count);
+  }
+};
+
+struct SharedHistogramAllocator::ImportedHistogram {
+  ImportedHistogram(Histogram* histogram, RecordHeader* record)
+      : histogram(histogram),
+        shared_samples(record->counts(), &record->meta,
+                       histogram->bucket_ranges()),
+        logged_samples(histogram->bucket_ranges()) {
+  }
+
+  // The histogram of this process that receives the samples.
+  Histogram* histogram;
+
+  // The samples in the shared memory.
+  SampleVector shared_samples;
+
+  // The part of |shared_samples| already added to |histogram|.
+  SampleVector logged_samples;
+};
+
+SharedHistogramAllocator::SharedHistogramAllocator(
+    scoped_ptr<SharedMemory> shared_memory)
+    : shared_memory_(shared_memory.Pass()),
+      size_(shared_memory_->mapped_size()),
+      next_import_offset_(sizeof(Header)) {
+  DCHECK(shared_memory_->memory());
+  if (size_ < sizeof(Header))
+    return;
+
+  Header* memory_header = header();
+  if (!subtle::Acquire_Load(&memory_header->magic)) {
+    memory_header->size = static_cast<uint32>(size_);
+    subtle::NoBarrier_Store(&memory_header->free_offset, sizeof(Header));
+    subtle::Release_Store(&memory_header->magic, kMagic);
+  }
+  // Another process may have mapped less of the memory.
+  if (subtle::Acquire_Load(&memory_header->magic) == kMagic &&
+      memory_header->size < size_) {
+    size_ = memory_header->size;
+  }
+}
+
+SharedHistogramAllocator::~SharedHistogramAllocator() {
+}
+
+bool SharedHistogramAllocator::IsValid() const {
+  return size_ >= sizeof(Header) &&
+         subtle::Acquire_Load(&header()->magic) == kMagic;
+}
+
+// static
+void SharedHistogramAllocator::SetGlobal(
+    scoped_ptr<SharedHistogramAllocator> allocator) {
+  DCHECK(!g_allocator);
+  g_allocator = allocator.release();
+}
+
+// static
+SharedHistogramAllocator* SharedHistogramAllocator::GetGlobal() {
+  return g_allocator;
+}
+
+// static
+void SharedHistogramAllocator::MoveToGlobalStorage(Histogram* histogram) {
+  // The per-thread buffers couldn't be read from the shared memory.
+  if (!g_allocator ||
+      (histogram->flags() & HistogramBase::kThreadLocalSamplesFlag)) {
+    return;
+  }
+  g_allocator->AllocateStorage(histogram);
+}
+
+bool SharedHistogramAllocator::AllocateStorage(Histogram* histogram) {
+  DCHECK_EQ(0, histogram->samples_->redundant_count());
+  if (!IsValid())
+    return false;
+
+  // As with HistogramDeltaSerialization, the flag tells the reading process
+  // that the samples came from elsewhere.
+  histogram->SetFlags(HistogramBase::kIPCSerializationSourceFlag);
+  Pickle info;
+  if (!histogram->SerializeInfo(&info))
+    return false;
+
+  const uint32 bucket_count = static_cast<uint32>(histogram->bucket_count());
+  const size_t size = sizeof(RecordHeader) +
+                      bucket_count * sizeof(HistogramBase::AtomicCount) +
+                      info.size();
+  RecordHeader* record = AllocateRecord(size);
+  if (!record)
+    return false;
+
+  record->size = static_cast<uint32>(AlignUp(size));
+  record->bucket_count = bucket_count;
+  record->info_size = static_cast<uint32>(info.size());
+  memcpy(record->info(), info.data(), info.size());
+
+  histogram->samples_.reset(new SampleVector(
+      record->counts(), &record->meta, histogram->bucket_ranges()));
+  histogram->SetFlags(HistogramBase::kSharedMemoryFlag);
+  subtle::Release_Store(&record->ready, 1);
+  return true;
+}
+
+void SharedHistogramAllocator::ImportSamples() {
+  if (!IsValid())
+    return;
+
+  const uint32 end = std::min(
+      static_cast<uint32>(subtle::Acquire_Load(&header()->free_offset)),
+      static_cast<uint32>(size_));
+  while (next_import_offset_ + sizeof(RecordHeader) <= end) {
+    RecordHeader* record = reinterpret_cast<RecordHeader*>(
+        static_cast<char*>(shared_memory_->memory()) + next_import_offset_);
+    // Records are written in parallel; later records are looked at once this
+    // one is done.
+    if (!subtle::Acquire_Load(&record->ready))
+      break;
+
+    // Read once, the other process could change them at any time.
+    const uint32 record_size = record->size;
+    const uint32 bucket_count = record->bucket_count;
+    const uint32 info_size = record->info_size;
+    const uint64 min_size =
+        sizeof(RecordHeader) +
+        static_cast<uint64>(bucket_count) *
+            sizeof(HistogramBase::AtomicCount) +
+        info_size;
+    if (record_size % kAlignment || record_size < min_size ||
+        record_size > end - next_import_offset_) {
+      DLOG(ERROR) << "Corrupt shared histogram record";
+      // Nothing after this record can be found anymore.
+      next_import_offset_ = static_cast<uint32>(size_);
+      break;
+    }
+
+    ImportedHistogram* imported =
+        ImportRecord(record, bucket_count, info_size);
+    if (imported)
+      imported_histograms_.push_back(imported);
+    next_import_offset_ += record_size;
+  }
+
+  for (size_t i = 0; i < imported_histograms_.size(); ++i) {
+    ImportedHistogram* imported = imported_histograms_[i];
+    SampleVector delta(imported->histogram->bucket_ranges());
+    delta.Add(imported->shared_samples);
+    delta.Subtract(imported->logged_samples);
+    if (!delta.redundant_count() && !delta.TotalCount())
+      continue;
+    imported->logged_samples.Add(delta);
+    imported->histogram->AddSamples(delta);
+  }
+}
+
+size_t SharedHistogramAllocator::used_size() const {
+  if (!IsValid())
+    return 0;
+  return std::min(
+      static_cast<size_t>(subtle::Acquire_Load(&header()->free_offset)),
+      size_);
+}
+
+SharedHistogramAllocator::RecordHeader*
+SharedHistogramAllocator::AllocateRecord(size_t size) {
+  size = AlignUp(size);
+  Header* memory_header = header();
+  while (true) {
+    subtle::Atomic32 offset =
+        subtle::NoBarrier_Load(&memory_header->free_offset);
+    if (size > size_ || static_cast<size_t>(offset) > size_ - size)
+      return NULL;
+    subtle::Atomic32 new_offset = offset + static_cast<subtle::Atomic32>(size);
+    if (subtle::NoBarrier_CompareAndSwap(&memory_header->free_offset, offset,
+                                         new_offset) == offset) {
+      return reinterpret_cast<RecordHeader*>(
+          static_cast<char*>(shared_memory_->memory()) + offset);
+    }
+  }
+}
+
+SharedHistogramAllocator::ImportedHistogram*
+SharedHistogramAllocator::ImportRecord(RecordHeader* record,
+                                       uint32 bucket_count,
+                                       uint32 info_size) {
+  // Copied so the other process can't change it while it is parsed.
+  const char* info_start =
+      reinterpret_cast<const char*>(record->counts() + bucket_count);
+  std::string info(info_start, info_size);
+  Pickle pickle(info.data(), static_cast<int>(info.size()));
+  PickleIterator iter(pickle);
+  HistogramBase* histogram = DeserializeHistogramInfo(&iter);
+  if (!histogram || histogram->GetHistogramType() == SPARSE_HISTOGRAM)
+    return NULL;
+
+  // The histogram was allocated by this process, as in single process mode.
+  if (histogram->flags() & HistogramBase::kSharedMemoryFlag)
+    return NULL;
+
+  Histogram* local_histogram = static_cast<Histogram*>(histogram);
+  if (local_histogram->bucket_count() != bucket_count)
+    return NULL;
+  return new ImportedHistogram(local_histogram, record);
+}
+
+SharedHistogramAllocator::Header* SharedHistogramAllocator::header() const {
+  return static_cast<Header*>(shared_memory_->memory());
+}
+
+}  // namespace base
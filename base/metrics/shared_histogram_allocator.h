@@ -0,0 +1,103 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SharedHistogramAllocator keeps the samples of histograms in a block of
+// shared memory, so that another process can read them in place instead of
+// receiving pickled deltas over IPC.
+//
+// In the process that records, install an allocator with SetGlobal() before
+// any histogram is created. Histogram and its subclasses then keep their
+// counts, sum and redundant count in the shared memory, along with their
+// pickled construction arguments. Histograms created once the memory is full
+// are kept on the heap as before.
+//
+// In the process that reads, create an allocator over the same memory and
+// call ImportSamples() whenever the histograms should be synchronized. It
+// adds the samples recorded since the last call to the histograms of the same
+// name in the reading process, creating them as needed.
+//
+// Histograms backed by shared memory are marked with
+// HistogramBase::kSharedMemoryFlag and skipped by HistogramDeltaSerialization,
+// so they aren't counted twice.
+
+#ifndef BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
+#define BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+
+namespace base {
+
+class Histogram;
+class SharedMemory;
+
+class BASE_EXPORT SharedHistogramAllocator {
+ public:
+  // Uses |shared_memory|, which must be mapped. Memory that is all zeros is
+  // formatted; otherwise it must have been formatted by another allocator.
+  explicit SharedHistogramAllocator(scoped_ptr<SharedMemory> shared_memory);
+  ~SharedHistogramAllocator();
+
+  // Returns false if the memory is too small or wasn't formatted by an
+  // allocator. Nothing can be allocated or imported then.
+  bool IsValid() const;
+
+  SharedMemory* shared_memory() const { return shared_memory_.get(); }
+
+  // Installs |allocator| for the histograms of this process. It is leaked, as
+  // histograms are. Must be called at most once, before any histogram is
+  // created.
+  static void SetGlobal(scoped_ptr<SharedHistogramAllocator> allocator);
+  static SharedHistogramAllocator* GetGlobal();
+
+  // Moves the storage of |histogram|, which must not have samples yet, to
+  // the global allocator's memory. Does nothing if there is no global
+  // allocator or its memory is full. Used by the histogram factories.
+  static void MoveToGlobalStorage(Histogram* histogram);
+
+  // Moves the storage of |histogram|, which must not have samples yet, to
+  // this allocator's memory. Returns false if the memory is full.
+  bool AllocateStorage(Histogram* histogram);
+
+  // Adds the samples recorded in another process since the last call to the
+  // histograms of the same name in this process. The data is validated, the
+  // other process doesn't need to be trusted.
+  void ImportSamples();
+
+  // Returns the number of bytes used so far.
+  size_t used_size() const;
+
+ private:
+  struct Header;
+  struct RecordHeader;
+  struct ImportedHistogram;
+
+  // Returns |size| bytes, aligned to 8 bytes, or NULL if the memory is full.
+  RecordHeader* AllocateRecord(size_t size);
+
+  // Returns the state for importing |record|, whose validated |bucket_count|
+  // and |info_size| are passed separately, or NULL if it shouldn't be
+  // imported.
+  ImportedHistogram* ImportRecord(RecordHeader* record,
+                                  uint32 bucket_count,
+                                  uint32 info_size);
+
+  Header* header() const;
+
+  scoped_ptr<SharedMemory> shared_memory_;
+  size_t size_;
+
+  // Offset of the first record ImportSamples() hasn't looked at yet.
+  uint32 next_import_offset_;
+
+  ScopedVector<ImportedHistogram> imported_histograms_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedHistogramAllocator);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_SHARED_HISTOGRAM_ALLOCATOR_H_
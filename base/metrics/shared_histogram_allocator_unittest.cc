@@ -0,0 +1,172 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/shared_histogram_allocator.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_delta_serialization.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/process/process_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const size_t kMemorySize = 64 * 1024;
+
+scoped_ptr<SharedMemory> CreateSharedMemory(size_t size) {
+  scoped_ptr<SharedMemory> shared_memory(new SharedMemory);
+  CHECK(shared_memory->CreateAndMapAnonymous(size));
+  return shared_memory.Pass();
+}
+
+// Maps |shared_memory| a second time, as another process would.
+scoped_ptr<SharedMemory> MapAgain(SharedMemory* shared_memory) {
+  SharedMemoryHandle handle;
+  CHECK(shared_memory->ShareToProcess(GetCurrentProcessHandle(), &handle));
+  scoped_ptr<SharedMemory> mapping(new SharedMemory(handle, false));
+  CHECK(mapping->Map(shared_memory->mapped_size()));
+  return mapping.Pass();
+}
+
+}  // namespace
+
+class SharedHistogramAllocatorTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    statistics_recorder_ = new StatisticsRecorder;
+    allocator_.reset(
+        new SharedHistogramAllocator(CreateSharedMemory(kMemorySize)));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    delete statistics_recorder_;
+    statistics_recorder_ = NULL;
+  }
+
+  Histogram* CreateSharedHistogram(const std::string& name) {
+    Histogram* histogram = static_cast<Histogram*>(Histogram::FactoryGet(
+        name, 1, 1000, 10, HistogramBase::kUmaTargetedHistogramFlag));
+    EXPECT_TRUE(allocator_->AllocateStorage(histogram));
+    return histogram;
+  }
+
+  // Forgets all histograms, so that the test continues as if it was another
+  // process. The histograms themselves are leaked, as usual.
+  void SwitchProcess() {
+    TearDown();
+    statistics_recorder_ = new StatisticsRecorder;
+  }
+
+  StatisticsRecorder* statistics_recorder_;
+  scoped_ptr<SharedHistogramAllocator> allocator_;
+};
+
+TEST_F(SharedHistogramAllocatorTest, ImportSamples) {
+  ASSERT_TRUE(allocator_->IsValid());
+  Histogram* histogram = CreateSharedHistogram("SharedHistogram");
+  EXPECT_TRUE(histogram->flags() & HistogramBase::kSharedMemoryFlag);
+  histogram->Add(5);
+  histogram->Add(500);
+  histogram->Add(500);
+
+  HistogramBase* linear_histogram = LinearHistogram::FactoryGet(
+      "SharedLinearHistogram", 1, 100, 10, HistogramBase::kNoFlags);
+  EXPECT_TRUE(allocator_->AllocateStorage(
+      static_cast<Histogram*>(linear_histogram)));
+  linear_histogram->Add(50);
+
+  SharedHistogramAllocator reader(MapAgain(allocator_->shared_memory()));
+  ASSERT_TRUE(reader.IsValid());
+  SwitchProcess();
+  reader.ImportSamples();
+
+  HistogramBase* imported =
+      StatisticsRecorder::FindHistogram("SharedHistogram");
+  ASSERT_TRUE(imported);
+  EXPECT_NE(histogram, imported);
+  EXPECT_EQ(HistogramBase::kUmaTargetedHistogramFlag, imported->flags());
+  scoped_ptr<HistogramSamples> samples = imported->SnapshotSamples();
+  EXPECT_EQ(3, samples->TotalCount());
+  EXPECT_EQ(3, samples->redundant_count());
+  EXPECT_EQ(1005, samples->sum());
+  EXPECT_EQ(2, samples->GetCount(500));
+
+  HistogramBase* imported_linear =
+      StatisticsRecorder::FindHistogram("SharedLinearHistogram");
+  ASSERT_TRUE(imported_linear);
+  EXPECT_EQ(LINEAR_HISTOGRAM, imported_linear->GetHistogramType());
+  EXPECT_EQ(1, imported_linear->SnapshotSamples()->TotalCount());
+
+  // Only new samples are added.
+  histogram->Add(7);
+  reader.ImportSamples();
+  reader.ImportSamples();
+  samples = imported->SnapshotSamples();
+  EXPECT_EQ(4, samples->TotalCount());
+  EXPECT_EQ(1012, samples->sum());
+
+  // As are histograms allocated later.
+  CreateSharedHistogram("LaterSharedHistogram")->Add(1);
+  reader.ImportSamples();
+  ASSERT_TRUE(StatisticsRecorder::FindHistogram("LaterSharedHistogram"));
+  EXPECT_EQ(1, StatisticsRecorder::FindHistogram("LaterSharedHistogram")
+                   ->SnapshotSamples()->TotalCount());
+}
+
+TEST_F(SharedHistogramAllocatorTest, ImportInSameProcess) {
+  Histogram* histogram = CreateSharedHistogram("SharedHistogram");
+  histogram->Add(5);
+
+  // The histogram is found rather than created, and left alone.
+  SharedHistogramAllocator reader(MapAgain(allocator_->shared_memory()));
+  reader.ImportSamples();
+  EXPECT_EQ(histogram, StatisticsRecorder::FindHistogram("SharedHistogram"));
+  EXPECT_EQ(1, histogram->SnapshotSamples()->TotalCount());
+}
+
+TEST_F(SharedHistogramAllocatorTest, NotSerialized) {
+  CreateSharedHistogram("SharedHistogram")->Add(5);
+  Histogram::FactoryGet("HeapHistogram", 1, 1000, 10,
+                        HistogramBase::kNoFlags)->Add(5);
+
+  HistogramDeltaSerialization serializer("SharedHistogramAllocatorTest");
+  std::vector<std::string> deltas;
+  serializer.PrepareAndSerializeDeltas(&deltas);
+  EXPECT_EQ(1u, deltas.size());
+}
+
+TEST_F(SharedHistogramAllocatorTest, MemoryFull) {
+  allocator_.reset(new SharedHistogramAllocator(CreateSharedMemory(256)));
+  ASSERT_TRUE(allocator_->IsValid());
+  Histogram* histogram = static_cast<Histogram*>(Histogram::FactoryGet(
+      "BigHistogram", 1, 1000000, 100, HistogramBase::kNoFlags));
+  EXPECT_FALSE(allocator_->AllocateStorage(histogram));
+  EXPECT_FALSE(histogram->flags() & HistogramBase::kSharedMemoryFlag);
+
+  // The histogram still works from the heap.
+  histogram->Add(5);
+  EXPECT_EQ(1, histogram->SnapshotSamples()->TotalCount());
+  EXPECT_GE(256u, allocator_->used_size());
+}
+
+TEST_F(SharedHistogramAllocatorTest, RejectsUnformattedMemory) {
+  scoped_ptr<SharedMemory> shared_memory = CreateSharedMemory(kMemorySize);
+  memset(shared_memory->memory(), 0xFF, kMemorySize);
+  SharedHistogramAllocator allocator(shared_memory.Pass());
+  EXPECT_FALSE(allocator.IsValid());
+  allocator.ImportSamples();
+  EXPECT_EQ(0u, allocator.used_size());
+}
+
+}  // namespace base
@@ -0,0 +1,137 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/thread_local_samples.h"
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+void OnThreadExit(void* value);
+
+struct Globals {
+  Globals() : thread_buffers(&OnThreadExit), next_index(0) {}
+
+  // Holds the ThreadBuffers of the current thread.
+  ThreadLocalStorage::Slot thread_buffers;
+
+  // Protects the buffer lists of all ThreadLocalSamples and the |owner| of
+  // every Buffer. Never taken when recording into an existing buffer.
+  Lock lock;
+
+  subtle::Atomic32 next_index;
+};
+
+// Leaky because threads may exit after the AtExitManager is gone.
+LazyInstance<Globals>::Leaky g_globals = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+struct ThreadLocalSamples::Buffer {
+  Buffer(ThreadLocalSamples* owner, const BucketRanges* bucket_ranges)
+      : owner(owner),
+        samples(bucket_ranges) {
+  }
+
+  // Hands the samples over to |owner| when the thread exits. Must be called
+  // with the global lock held.
+  void Retire() {
+    g_globals.Get().lock.AssertAcquired();
+    if (!owner)
+      return;
+    owner->retired_samples_.Add(samples);
+    owner->buffers_.erase(
+        std::find(owner->buffers_.begin(), owner->buffers_.end(), this));
+    owner = NULL;
+  }
+
+  // NULL once |owner| has been deleted.
+  ThreadLocalSamples* owner;
+
+  // Only written to on the thread the buffer belongs to.
+  SampleVector samples;
+};
+
+namespace {
+
+// The buffers of one thread, indexed by ThreadLocalSamples::index_.
+typedef std::vector<ThreadLocalSamples::Buffer*> ThreadBuffers;
+
+void OnThreadExit(void* value) {
+  ThreadBuffers* thread_buffers = static_cast<ThreadBuffers*>(value);
+  {
+    AutoLock lock(g_globals.Get().lock);
+    for (size_t i = 0; i < thread_buffers->size(); ++i) {
+      ThreadLocalSamples::Buffer* buffer = (*thread_buffers)[i];
+      if (buffer)
+        buffer->Retire();
+    }
+  }
+  for (size_t i = 0; i < thread_buffers->size(); ++i)
+    delete (*thread_buffers)[i];
+  delete thread_buffers;
+}
+
+}  // namespace
+
+ThreadLocalSamples::ThreadLocalSamples(const BucketRanges* bucket_ranges)
+    : bucket_ranges_(bucket_ranges),
+      index_(subtle::NoBarrier_AtomicIncrement(
+          &g_globals.Get().next_index, 1) - 1),
+      retired_samples_(bucket_ranges) {
+}
+
+ThreadLocalSamples::~ThreadLocalSamples() {
+  // The buffers themselves are deleted when their threads exit.
+  AutoLock lock(g_globals.Get().lock);
+  for (size_t i = 0; i < buffers_.size(); ++i)
+    buffers_[i]->owner = NULL;
+}
+
+void ThreadLocalSamples::Accumulate(HistogramBase::Sample value,
+                                    HistogramBase::Count count) {
+  ThreadBuffers* thread_buffers =
+      static_cast<ThreadBuffers*>(g_globals.Get().thread_buffers.Get());
+  Buffer* buffer = NULL;
+  if (thread_buffers && index_ < thread_buffers->size())
+    buffer = (*thread_buffers)[index_];
+  if (!buffer)
+    buffer = CreateBuffer();
+  buffer->samples.Accumulate(value, count);
+}
+
+void ThreadLocalSamples::AddTo(HistogramSamples* samples) const {
+  AutoLock lock(g_globals.Get().lock);
+  samples->Add(retired_samples_);
+  for (size_t i = 0; i < buffers_.size(); ++i)
+    samples->Add(buffers_[i]->samples);
+}
+
+ThreadLocalSamples::Buffer* ThreadLocalSamples::CreateBuffer() {
+  Globals* globals = g_globals.Pointer();
+  ThreadBuffers* thread_buffers =
+      static_cast<ThreadBuffers*>(globals->thread_buffers.Get());
+  if (!thread_buffers) {
+    thread_buffers = new ThreadBuffers;
+    globals->thread_buffers.Set(thread_buffers);
+  }
+  if (thread_buffers->size() <= index_)
+    thread_buffers->resize(index_ + 1);
+
+  Buffer* buffer = new Buffer(this, bucket_ranges_);
+  (*thread_buffers)[index_] = buffer;
+  AutoLock lock(globals->lock);
+  buffers_.push_back(buffer);
+  return buffer;
+}
+
+}  // namespace base
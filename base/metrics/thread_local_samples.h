@@ -0,0 +1,68 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// ThreadLocalSamples gives a histogram a separate SampleVector for every
+// thread that records into it. Recording only writes to memory owned by the
+// calling thread, so histograms updated from hot loops on several threads
+// don't bounce cache lines between cores. The buffers are added up when the
+// histogram is snapshotted.
+//
+// Histograms opt in with HistogramBase::kThreadLocalSamplesFlag.
+
+#ifndef BASE_METRICS_THREAD_LOCAL_SAMPLES_H_
+#define BASE_METRICS_THREAD_LOCAL_SAMPLES_H_
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/sample_vector.h"
+
+namespace base {
+
+class BucketRanges;
+class HistogramSamples;
+
+class BASE_EXPORT_PRIVATE ThreadLocalSamples {
+ public:
+  explicit ThreadLocalSamples(const BucketRanges* bucket_ranges);
+
+  // Samples recorded by threads that are still running are lost. Registered
+  // histograms are never deleted, so this only matters to tests.
+  ~ThreadLocalSamples();
+
+  // Records |count| occurrences of |value| in the calling thread's buffer.
+  void Accumulate(HistogramBase::Sample value, HistogramBase::Count count);
+
+  // Adds the samples recorded on all threads to |samples|. As with a shared
+  // SampleVector, samples recorded concurrently may or may not be included.
+  void AddTo(HistogramSamples* samples) const;
+
+  // A buffer of one thread, defined in the .cc file.
+  struct Buffer;
+
+ private:
+  // Creates the calling thread's buffer.
+  Buffer* CreateBuffer();
+
+  const BucketRanges* const bucket_ranges_;
+
+  // Position of this object's buffer in each thread's list of buffers.
+  const size_t index_;
+
+  // The following are protected by the global lock.
+
+  // Buffers of threads that are running.
+  std::vector<Buffer*> buffers_;
+
+  // Samples of threads that have exited.
+  SampleVector retired_samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadLocalSamples);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_THREAD_LOCAL_SAMPLES_H_
@@ -0,0 +1,112 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/thread_local_samples.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/sample_vector.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+class ThreadLocalSamplesTest : public testing::Test {
+ protected:
+  ThreadLocalSamplesTest() : ranges_(3) {
+    // Custom buckets: [1, 5) [5, 10)
+    ranges_.set_range(0, 1);
+    ranges_.set_range(1, 5);
+    ranges_.set_range(2, 10);
+  }
+
+  scoped_ptr<SampleVector> Snapshot(const ThreadLocalSamples& samples) {
+    scoped_ptr<SampleVector> snapshot(new SampleVector(&ranges_));
+    samples.AddTo(snapshot.get());
+    return snapshot.Pass();
+  }
+
+  BucketRanges ranges_;
+};
+
+void AccumulateSamples(ThreadLocalSamples* samples,
+                       HistogramBase::Sample value,
+                       int times) {
+  for (int i = 0; i < times; ++i)
+    samples->Accumulate(value, 1);
+}
+
+// Waits for the tasks posted to |thread| so far to have run.
+void WaitForTasks(Thread* thread) {
+  WaitableEvent done(false, false);
+  thread->message_loop()->PostTask(
+      FROM_HERE, Bind(&WaitableEvent::Signal, Unretained(&done)));
+  done.Wait();
+}
+
+TEST_F(ThreadLocalSamplesTest, Accumulate) {
+  ThreadLocalSamples samples(&ranges_);
+  EXPECT_EQ(0, Snapshot(samples)->TotalCount());
+
+  samples.Accumulate(1, 200);
+  samples.Accumulate(6, 10);
+  scoped_ptr<SampleVector> snapshot = Snapshot(samples);
+  EXPECT_EQ(200, snapshot->GetCountAtIndex(0));
+  EXPECT_EQ(10, snapshot->GetCountAtIndex(1));
+  EXPECT_EQ(260, snapshot->sum());
+  EXPECT_EQ(210, snapshot->redundant_count());
+
+  // Snapshots don't consume the samples.
+  EXPECT_EQ(210, Snapshot(samples)->TotalCount());
+}
+
+TEST_F(ThreadLocalSamplesTest, SamplesOfOtherThreads) {
+  ThreadLocalSamples samples(&ranges_);
+  samples.Accumulate(2, 1);
+
+  Thread thread1("ThreadLocalSamplesTest1");
+  Thread thread2("ThreadLocalSamplesTest2");
+  ASSERT_TRUE(thread1.Start());
+  ASSERT_TRUE(thread2.Start());
+  thread1.message_loop()->PostTask(
+      FROM_HERE, Bind(&AccumulateSamples, Unretained(&samples), 3, 100));
+  thread2.message_loop()->PostTask(
+      FROM_HERE, Bind(&AccumulateSamples, Unretained(&samples), 7, 50));
+
+  // Both the exited and the running thread's samples are included.
+  thread1.Stop();
+  thread2.message_loop()->PostTask(
+      FROM_HERE, Bind(&AccumulateSamples, Unretained(&samples), 7, 50));
+  WaitForTasks(&thread2);
+  scoped_ptr<SampleVector> snapshot = Snapshot(samples);
+  EXPECT_EQ(101, snapshot->GetCountAtIndex(0));
+  EXPECT_EQ(100, snapshot->GetCountAtIndex(1));
+
+  thread2.Stop();
+  snapshot = Snapshot(samples);
+  EXPECT_EQ(101, snapshot->GetCountAtIndex(0));
+  EXPECT_EQ(100, snapshot->GetCountAtIndex(1));
+  EXPECT_EQ(2 + 300 + 700, snapshot->sum());
+}
+
+TEST_F(ThreadLocalSamplesTest, DeletedBeforeThreadExits) {
+  Thread thread("ThreadLocalSamplesTest");
+  ASSERT_TRUE(thread.Start());
+
+  ThreadLocalSamples* samples = new ThreadLocalSamples(&ranges_);
+  thread.message_loop()->PostTask(
+      FROM_HERE, Bind(&AccumulateSamples, Unretained(samples), 3, 10));
+  WaitForTasks(&thread);
+  EXPECT_EQ(10, Snapshot(*samples)->TotalCount());
+
+  // The thread's buffer outlives |samples| and is deleted when it exits.
+  delete samples;
+  thread.Stop();
+}
+
+}  // namespace
+}  // namespace base
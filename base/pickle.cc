@@ -5,6 +5,7 @@
 #include "base/pickle.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>  // for max()
 
@@ -211,7 +212,7 @@ Pickle::Pickle(const Pickle& other)
 }
 
 Pickle::~Pickle() {
-  if (capacity_after_header_ != kCapacityReadOnly)
+  if (capacity_after_header_ != kCapacityReadOnly && !UsesInlineStorage())
     free(header_);
 }
 
@@ -225,8 +226,10 @@ Pickle& Pickle::operator=(const Pickle& other) {
     capacity_after_header_ = 0;
   }
   if (header_size_ != other.header_size_) {
-    free(header_);
+    if (!UsesInlineStorage())
+      free(header_);
     header_ = NULL;
+    capacity_after_header_ = 0;
     header_size_ = other.header_size_;
   }
   Resize(other.header_->payload_size);
@@ -284,9 +287,23 @@ void Pickle::Resize(size_t new_capacity) {
   new_capacity = AlignInt(new_capacity, kPayloadUnit);
 
   CHECK_NE(capacity_after_header_, kCapacityReadOnly);
-  void* p = realloc(header_, header_size_ + new_capacity);
-  CHECK(p);
-  header_ = reinterpret_cast<Header*>(p);
+  const size_t new_size = header_size_ + new_capacity;
+  if (!header_ || UsesInlineStorage()) {
+    if (new_size <= kInlineStorageSize) {
+      header_ = inline_storage_.data_as<Header>();
+    } else {
+      // Moving out of |inline_storage_|: keep what was written so far.
+      void* p = malloc(new_size);
+      CHECK(p);
+      if (header_)
+        memcpy(p, header_, header_size_ + write_offset_);
+      header_ = reinterpret_cast<Header*>(p);
+    }
+  } else {
+    void* p = realloc(header_, new_size);
+    CHECK(p);
+    header_ = reinterpret_cast<Header*>(p);
+  }
   capacity_after_header_ = new_capacity;
 }
 
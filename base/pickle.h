@@ -12,6 +12,7 @@
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
+#include "base/memory/aligned_memory.h"
 #include "base/strings/string16.h"
 
 class Pickle;
@@ -116,7 +117,9 @@ class BASE_EXPORT Pickle {
   // padding size is deduced from the data length.
   Pickle(const char* data, int data_len);
 
-  // Initializes a Pickle as a deep copy of another Pickle.
+  // Initializes a Pickle as a deep copy of another Pickle. Only the header and
+  // payload are copied, so copying a Pickle built over a receive buffer with
+  // the constructor above allocates no more than |other| needs.
   Pickle(const Pickle& other);
 
   // Note: There are no virtual methods in this class.  This destructor is
@@ -320,6 +323,16 @@ class BASE_EXPORT Pickle {
  private:
   friend class PickleIterator;
 
+  // Most pickles, like most IPC messages, are small. Up to this many bytes of
+  // header and payload are kept in |inline_storage_| rather than on the heap:
+  // room for two payload units after the largest headers in use.
+  enum { kInlineStorageSize = 160 };
+
+  // Returns true if |header_| points to |inline_storage_|.
+  bool UsesInlineStorage() const {
+    return header_ == inline_storage_.void_data();
+  }
+
   Header* header_;
   size_t header_size_;  // Supports extra data between header and payload.
   // Allocation size of payload (or -1 if allocation is const). Note: this
@@ -339,7 +352,10 @@ class BASE_EXPORT Pickle {
   }
   inline void WriteBytesCommon(const void* data, size_t length);
 
+  base::AlignedMemory<kInlineStorageSize, sizeof(uint64)> inline_storage_;
+
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, InlineStorage);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextOverflow);
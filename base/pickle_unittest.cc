@@ -267,6 +267,56 @@ TEST(PickleTest, Resize) {
   EXPECT_EQ(cur_payload, pickle.payload_size());
 }
 
+TEST(PickleTest, InlineStorage) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.UsesInlineStorage());
+  const void* inline_data = pickle.data();
+
+  // Up to two payload units fit inline.
+  std::string small(Pickle::kPayloadUnit, 'a');
+  EXPECT_TRUE(pickle.WriteString(small));
+  EXPECT_TRUE(pickle.UsesInlineStorage());
+  EXPECT_EQ(inline_data, pickle.data());
+
+  // Growing further moves the contents to the heap.
+  std::string large(Pickle::kPayloadUnit * 4, 'b');
+  EXPECT_TRUE(pickle.WriteString(large));
+  EXPECT_FALSE(pickle.UsesInlineStorage());
+
+  PickleIterator iter(pickle);
+  std::string result;
+  EXPECT_TRUE(pickle.ReadString(&iter, &result));
+  EXPECT_EQ(small, result);
+  EXPECT_TRUE(pickle.ReadString(&iter, &result));
+  EXPECT_EQ(large, result);
+
+  // A small copy of a heap pickle is inline, and vice versa.
+  Pickle small_pickle;
+  EXPECT_TRUE(small_pickle.WriteString(small));
+  Pickle copy(small_pickle);
+  EXPECT_TRUE(copy.UsesInlineStorage());
+  EXPECT_EQ(small_pickle.size(), copy.size());
+  EXPECT_EQ(0, memcmp(small_pickle.data(), copy.data(), copy.size()));
+
+  copy = pickle;
+  EXPECT_FALSE(copy.UsesInlineStorage());
+  EXPECT_EQ(pickle.size(), copy.size());
+  EXPECT_EQ(0, memcmp(pickle.data(), copy.data(), copy.size()));
+
+  Pickle other_copy;
+  other_copy = small_pickle;
+  EXPECT_TRUE(other_copy.UsesInlineStorage());
+  EXPECT_EQ(0, memcmp(small_pickle.data(), other_copy.data(),
+                      other_copy.size()));
+
+  // A read-only Pickle refers to the data it was given.
+  Pickle view(static_cast<const char*>(pickle.data()), pickle.size());
+  EXPECT_EQ(pickle.data(), view.data());
+  PickleIterator view_iter(view);
+  EXPECT_TRUE(view.ReadString(&view_iter, &result));
+  EXPECT_EQ(small, result);
+}
+
 namespace {
 
 struct CustomHeader : Pickle::Header {
@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/file_util.h"
 #include "base/json/json_file_value_serializer.h"
@@ -22,6 +23,70 @@ namespace {
 
 // Some extensions we'll tack on to copies of the Preferences files.
 const base::FilePath::CharType* kBadExtension = FILE_PATH_LITERAL("bad");
+const base::FilePath::CharType* kDeltaExtension = FILE_PATH_LITERAL("delta");
+
+base::FilePath GetDeltaPath(const base::FilePath& path) {
+  return path.AddExtension(kDeltaExtension);
+}
+
+// A delta is a list of [path, value] entries for the prefs set since the file
+// was last written in full, and of [path] entries for those removed.
+void ApplyDelta(const base::ListValue& entries,
+                base::DictionaryValue* prefs) {
+  for (size_t i = 0; i < entries.GetSize(); ++i) {
+    const base::ListValue* entry = NULL;
+    std::string path;
+    if (!entries.GetList(i, &entry) || !entry->GetString(0, &path))
+      continue;
+    const base::Value* value = NULL;
+    if (entry->Get(1, &value))
+      prefs->Set(path, value->DeepCopy());
+    else
+      prefs->RemovePath(path, NULL);
+  }
+}
+
+// Applies the delta left next to |path| by a store which didn't get to
+// compact the file, if there is one, and compacts it. |value| is what was
+// read from |path| and |error| how that went.
+void HandleDeltaFile(const base::FilePath& path,
+                     base::Value* value,
+                     PersistentPrefStore::PrefReadError error) {
+  base::FilePath delta_path = GetDeltaPath(path);
+  switch (error) {
+    case PersistentPrefStore::PREF_READ_ERROR_NONE:
+      break;
+    case PersistentPrefStore::PREF_READ_ERROR_NO_FILE:
+    case PersistentPrefStore::PREF_READ_ERROR_JSON_PARSE:
+    case PersistentPrefStore::PREF_READ_ERROR_JSON_REPEAT:
+      // The file the delta was written after is gone, so it means nothing.
+      base::DeleteFile(delta_path, false);
+      return;
+    default:
+      // The store will be read only; leave the files be.
+      return;
+  }
+  if (!base::PathExists(delta_path))
+    return;
+
+  JSONFileValueSerializer delta_serializer(delta_path);
+  scoped_ptr<base::Value> delta(delta_serializer.Deserialize(NULL, NULL));
+  base::ListValue* entries = NULL;
+  base::DictionaryValue* prefs = NULL;
+  if (delta && delta->GetAsList(&entries) && value->GetAsDictionary(&prefs)) {
+    ApplyDelta(*entries, prefs);
+    std::string data;
+    JSONStringValueSerializer serializer(&data);
+    serializer.set_pretty_print(true);
+    // Keep the delta to apply it again next time if the file can't be
+    // written.
+    if (!serializer.Serialize(*prefs) ||
+        !base::ImportantFileWriter::WriteFileAtomically(path, data)) {
+      return;
+    }
+  }
+  base::DeleteFile(delta_path, false);
+}
 
 // Differentiates file loading between origin thread and passed
 // (aka file) thread.
@@ -70,6 +135,7 @@ class FileThreadDeserializer
     JSONFileValueSerializer serializer(path);
     base::Value* value = serializer.Deserialize(&error_code, &error_msg);
     HandleErrors(value, path, error_code, error_msg, error);
+    HandleDeltaFile(path, value, *error);
     *no_dir = !base::PathExists(path.DirName());
     return value;
   }
@@ -159,6 +225,10 @@ JsonPrefStore::JsonPrefStore(const base::FilePath& filename,
       prefs_(new base::DictionaryValue()),
       read_only_(false),
       writer_(filename, sequenced_task_runner),
+      delta_writer_(GetDeltaPath(filename), sequenced_task_runner),
+      commit_interval_(writer_.commit_interval()),
+      full_file_size_(0),
+      has_delta_file_(false),
       pref_filter_(pref_filter.Pass()),
       initialized_(false),
       read_error_(PREF_READ_ERROR_OTHER) {}
@@ -215,7 +285,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
     if (!read_only_)
-      writer_.ScheduleWrite(this);
+      ScheduleCommit(key);
   }
 }
 
@@ -262,8 +332,12 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
 }
 
 void JsonPrefStore::CommitPendingWrite() {
-  if (writer_.HasPendingWrite() && !read_only_)
-    writer_.DoScheduledWrite();
+  if (read_only_)
+    return;
+  if (commit_timer_.IsRunning() || has_delta_file_) {
+    commit_timer_.Stop();
+    Compact();
+  }
 }
 
 void JsonPrefStore::ReportValueChanged(const std::string& key) {
@@ -273,7 +347,7 @@ void JsonPrefStore::ReportValueChanged(const std::string& key) {
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
 
   if (!read_only_)
-    writer_.ScheduleWrite(this);
+    ScheduleCommit(key);
 }
 
 void JsonPrefStore::OnFileRead(base::Value* value_owned,
@@ -337,3 +411,73 @@ bool JsonPrefStore::SerializeData(std::string* output) {
   serializer.set_pretty_print(true);
   return serializer.Serialize(*prefs_);
 }
+
+void JsonPrefStore::ScheduleCommit(const std::string& key) {
+  changed_paths_.insert(key);
+  if (!commit_timer_.IsRunning()) {
+    commit_timer_.Start(FROM_HERE, commit_interval_, this,
+                        &JsonPrefStore::DoScheduledCommit);
+  }
+}
+
+void JsonPrefStore::DoScheduledCommit() {
+  // The delta is only written on top of a file this store wrote in full, so
+  // the first commit after reading the file writes it too.
+  std::string delta;
+  if (!full_file_size_ || !SerializeDelta(&delta) ||
+      delta.size() > full_file_size_ / 4) {
+    Compact();
+    return;
+  }
+
+  if (pref_filter_)
+    pref_filter_->FilterSerializeData(prefs_.get());
+  delta_writer_.WriteNow(delta);
+  has_delta_file_ = true;
+}
+
+void JsonPrefStore::Compact() {
+  // Bring the delta up to date before writing the file, so that applying it
+  // to the new file, if the delta can't be removed, changes nothing.
+  if (has_delta_file_) {
+    std::string delta;
+    if (SerializeDelta(&delta))
+      delta_writer_.WriteNow(delta);
+  }
+
+  std::string data;
+  if (!SerializeData(&data)) {
+    DLOG(WARNING) << "failed to serialize prefs to be saved in "
+                  << path_.value();
+    return;
+  }
+  writer_.WriteNow(data);
+  full_file_size_ = data.size();
+  changed_paths_.clear();
+
+  if (has_delta_file_) {
+    sequenced_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(base::IgnoreResult(&base::DeleteFile),
+                   delta_writer_.path(), false));
+    has_delta_file_ = false;
+  }
+}
+
+bool JsonPrefStore::SerializeDelta(std::string* output) const {
+  base::ListValue entries;
+  for (std::set<std::string>::const_iterator it = changed_paths_.begin();
+       it != changed_paths_.end(); ++it) {
+    // Every entry holds the current value, so they can be applied in any
+    // order.
+    base::ListValue* entry = new base::ListValue;
+    entry->AppendString(*it);
+    const base::Value* value = NULL;
+    if (prefs_->Get(*it, &value))
+      entry->Append(value->DeepCopy());
+    entries.Append(entry);
+  }
+
+  JSONStringValueSerializer serializer(output);
+  return serializer.Serialize(entries);
+}
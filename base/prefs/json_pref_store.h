@@ -17,6 +17,8 @@
 #include "base/observer_list.h"
 #include "base/prefs/base_prefs_export.h"
 #include "base/prefs/persistent_pref_store.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 
 class PrefFilter;
 
@@ -30,6 +32,14 @@ class Value;
 
 
 // A writable PrefStore implementation that is used for user preferences.
+//
+// Rewriting the whole file on every commit costs as much as the profile is
+// large, so once the file has been written in full the commits scheduled
+// after changes only write the changed prefs, with their current values, to
+// a delta file next to it. The file is compacted, that is written in full
+// again and the delta file removed, when the delta grows to a quarter of it
+// and by CommitPendingWrite(), so that it is whole after a clean shutdown.
+// A delta left by a crash is applied, and compacted, when the file is read.
 class BASE_PREFS_EXPORT JsonPrefStore
     : public PersistentPrefStore,
       public base::ImportantFileWriter::DataSerializer {
@@ -74,12 +84,32 @@ class BASE_PREFS_EXPORT JsonPrefStore
   // (read: do not call it manually).
   void OnFileRead(base::Value* value_owned, PrefReadError error, bool no_dir);
 
+  // Sets the delay after a change before it is committed, 10 seconds by
+  // default.
+  void set_commit_interval_for_testing(const base::TimeDelta& interval) {
+    commit_interval_ = interval;
+  }
+
  private:
   virtual ~JsonPrefStore();
 
   // ImportantFileWriter::DataSerializer overrides:
   virtual bool SerializeData(std::string* output) OVERRIDE;
 
+  // Records that |key| changed and schedules a commit if there is none yet.
+  void ScheduleCommit(const std::string& key);
+
+  // Writes the scheduled changes as a delta, or compacts the file if the
+  // delta has grown too large.
+  void DoScheduledCommit();
+
+  // Writes the file in full and removes the delta file.
+  void Compact();
+
+  // Puts the current value of each of |changed_paths_|, or that it was
+  // removed, in |output|.
+  bool SerializeDelta(std::string* output) const;
+
   base::FilePath path_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
 
@@ -87,8 +117,23 @@ class BASE_PREFS_EXPORT JsonPrefStore
 
   bool read_only_;
 
-  // Helper for safely writing pref data.
+  // Helpers for safely writing pref data, and the changes since it was last
+  // written in full.
   base::ImportantFileWriter writer_;
+  base::ImportantFileWriter delta_writer_;
+
+  base::TimeDelta commit_interval_;
+  base::OneShotTimer<JsonPrefStore> commit_timer_;
+
+  // The prefs changed since the file was last written in full.
+  std::set<std::string> changed_paths_;
+
+  // The size of the file when it was last written in full, or 0 if it hasn't
+  // been written by this store yet.
+  size_t full_file_size_;
+
+  // Whether a delta file was written since the file was last written in full.
+  bool has_delta_file_;
 
   scoped_ptr<PrefFilter> pref_filter_;
   ObserverList<PrefStore::Observer, true> observers_;
@@ -278,6 +278,73 @@ TEST_F(JsonPrefStoreTest, RemoveClearsEmptyParent) {
   EXPECT_FALSE(has_dict);
 }
 
+TEST_F(JsonPrefStoreTest, WritesDeltas) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("delta.json");
+  FilePath delta_file = pref_file.AddExtension(FILE_PATH_LITERAL("delta"));
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy(),
+      scoped_ptr<PrefFilter>());
+  pref_store->set_commit_interval_for_testing(TimeDelta());
+
+  // The first commit writes the file in full.
+  pref_store->SetValue("big", new StringValue(std::string(1000, 'x')));
+  pref_store->SetValue("removed", new FundamentalValue(1));
+  RunLoop().RunUntilIdle();
+  std::string full_contents;
+  ASSERT_TRUE(ReadFileToString(pref_file, &full_contents));
+  EXPECT_FALSE(PathExists(delta_file));
+
+  // Small changes after it only write a delta.
+  pref_store->SetValue(kHomePage, new StringValue("http://www.cnn.com"));
+  pref_store->SetValue("tabs.max_tabs", new FundamentalValue(20));
+  pref_store->RemoveValue("removed");
+  RunLoop().RunUntilIdle();
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(pref_file, &contents));
+  EXPECT_EQ(full_contents, contents);
+  EXPECT_TRUE(PathExists(delta_file));
+
+  // Another store reading the file applies the delta and compacts the file.
+  scoped_refptr<JsonPrefStore> other_pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy(),
+      scoped_ptr<PrefFilter>());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE,
+            other_pref_store->ReadPrefs());
+  EXPECT_FALSE(PathExists(delta_file));
+  const Value* actual = NULL;
+  std::string string_value;
+  EXPECT_TRUE(other_pref_store->GetValue(kHomePage, &actual));
+  EXPECT_TRUE(actual->GetAsString(&string_value));
+  EXPECT_EQ("http://www.cnn.com", string_value);
+  int integer = 0;
+  EXPECT_TRUE(other_pref_store->GetValue("tabs.max_tabs", &actual));
+  EXPECT_TRUE(actual->GetAsInteger(&integer));
+  EXPECT_EQ(20, integer);
+  EXPECT_TRUE(other_pref_store->GetValue("big", NULL));
+  EXPECT_FALSE(other_pref_store->GetValue("removed", NULL));
+  other_pref_store = NULL;
+
+  // A delta larger than a quarter of the file compacts it.
+  pref_store->SetValue("other_big", new StringValue(std::string(1000, 'y')));
+  RunLoop().RunUntilIdle();
+  ASSERT_TRUE(ReadFileToString(pref_file, &contents));
+  EXPECT_NE(std::string::npos, contents.find(std::string(1000, 'y')));
+  EXPECT_FALSE(PathExists(delta_file));
+
+  // So does CommitPendingWrite().
+  pref_store->SetValue(kHomePage, new StringValue("http://www.google.com"));
+  RunLoop().RunUntilIdle();
+  EXPECT_TRUE(PathExists(delta_file));
+  pref_store->CommitPendingWrite();
+  RunLoop().RunUntilIdle();
+  EXPECT_FALSE(PathExists(delta_file));
+  ASSERT_TRUE(ReadFileToString(pref_file, &contents));
+  EXPECT_NE(std::string::npos, contents.find("http://www.google.com"));
+}
+
 // Tests asynchronous reading of the file when there is no file.
 TEST_F(JsonPrefStoreTest, AsyncNonExistingFile) {
   base::FilePath bogus_input_file = data_dir_.AppendASCII("read.txt");
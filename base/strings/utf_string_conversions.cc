@@ -4,14 +4,194 @@
 
 #include "base/strings/utf_string_conversions.h"
 
+#include <string.h>
+
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UTF_CONVERSIONS_USE_SSE2
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && \
+    (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define UTF_CONVERSIONS_USE_NEON
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
 namespace {
 
+// ASCII fast paths ------------------------------------------------------------
+
+// Most text converted by the browser (URLs, HTML, JSON, IPC strings) is
+// largely ASCII, so runs of ASCII characters are scanned and copied a vector
+// at a time instead of going through ReadUnicodeCharacter() and
+// WriteUnicodeCharacter() one code point at a time.
+
+typedef uintptr_t MachineWord;
+const MachineWord kNonASCIIMask8 =
+    static_cast<MachineWord>(0x8080808080808080ULL);
+
+template<typename CHAR>
+inline bool IsASCIIChar(CHAR c) {
+  return static_cast<uint32>(c) < 0x80;
+}
+
+template<>
+inline bool IsASCIIChar(char c) {
+  return !(c & 0x80);
+}
+
+// Returns the number of ASCII characters at the start of |src|.
+template<typename CHAR>
+size_t ASCIIPrefixLength(const CHAR* src, size_t src_len) {
+  size_t i = 0;
+  while (i < src_len && IsASCIIChar(src[i]))
+    ++i;
+  return i;
+}
+
+template<>
+size_t ASCIIPrefixLength(const char* src, size_t src_len) {
+  size_t i = 0;
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+  for (; i + 16 <= src_len; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    int non_ascii = _mm_movemask_epi8(chunk);
+    if (non_ascii) {
+#if defined(COMPILER_GCC)
+      return i + __builtin_ctz(non_ascii);
+#else
+      break;
+#endif
+    }
+  }
+#elif defined(UTF_CONVERSIONS_USE_NEON)
+  for (; i + 16 <= src_len; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    uint8x8_t folded = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+    if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) & kNonASCIIMask8)
+      break;
+  }
+#else
+  for (; i + sizeof(MachineWord) <= src_len; i += sizeof(MachineWord)) {
+    MachineWord word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & kNonASCIIMask8)
+      break;
+  }
+#endif
+  while (i < src_len && IsASCIIChar(src[i]))
+    ++i;
+  return i;
+}
+
+template<>
+size_t ASCIIPrefixLength(const char16* src, size_t src_len) {
+  size_t i = 0;
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+  const __m128i non_ascii_bits = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= src_len; i += 8) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(chunk, non_ascii_bits), zero);
+    if (_mm_movemask_epi8(ascii) != 0xFFFF)
+      break;
+  }
+#elif defined(UTF_CONVERSIONS_USE_NEON)
+  for (; i + 8 <= src_len; i += 8) {
+    uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16*>(src + i));
+    uint16x4_t folded = vorr_u16(vget_low_u16(chunk), vget_high_u16(chunk));
+    if (vget_lane_u64(vreinterpret_u64_u16(folded), 0) &
+        0xFF80FF80FF80FF80ULL) {
+      break;
+    }
+  }
+#endif
+  while (i < src_len && IsASCIIChar(src[i]))
+    ++i;
+  return i;
+}
+
+// Copies the |count| ASCII characters at |src| into |dest|, converting them
+// to the destination character type.
+template<typename SRC_CHAR, typename DEST_CHAR>
+void CopyASCII(const SRC_CHAR* src, size_t count, DEST_CHAR* dest) {
+  for (size_t i = 0; i < count; ++i)
+    dest[i] = static_cast<DEST_CHAR>(src[i]);
+}
+
+template<>
+void CopyASCII(const char* src, size_t count, char16* dest) {
+  size_t i = 0;
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                     _mm_unpackhi_epi8(chunk, zero));
+  }
+#elif defined(UTF_CONVERSIONS_USE_NEON)
+  for (; i + 16 <= count; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    uint16* out = reinterpret_cast<uint16*>(dest + i);
+    vst1q_u16(out, vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16(out + 8, vmovl_u8(vget_high_u8(chunk)));
+  }
+#endif
+  for (; i < count; ++i)
+    dest[i] = static_cast<char16>(src[i]);
+}
+
+template<>
+void CopyASCII(const char16* src, size_t count, char* dest) {
+  size_t i = 0;
+#if defined(UTF_CONVERSIONS_USE_SSE2)
+  for (; i + 16 <= count; i += 16) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    // Exact, as every character is below 0x80.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_packus_epi16(low, high));
+  }
+#elif defined(UTF_CONVERSIONS_USE_NEON)
+  for (; i + 16 <= count; i += 16) {
+    const uint16* in = reinterpret_cast<const uint16*>(src + i);
+    uint8x16_t chunk = vcombine_u8(vmovn_u16(vld1q_u16(in)),
+                                   vmovn_u16(vld1q_u16(in + 8)));
+    vst1q_u8(reinterpret_cast<uint8*>(dest + i), chunk);
+  }
+#endif
+  for (; i < count; ++i)
+    dest[i] = static_cast<char>(src[i]);
+}
+
+// Appends the |count| ASCII characters at |src| to |output|.
+template<typename SRC_CHAR, typename DEST_STRING>
+void AppendASCII(const SRC_CHAR* src, size_t count, DEST_STRING* output) {
+  // Short runs, like the spaces between words of other scripts, are cheaper
+  // to append one character at a time than to resize for.
+  if (count < 16) {
+    for (size_t i = 0; i < count; ++i)
+      output->push_back(static_cast<typename DEST_STRING::value_type>(src[i]));
+    return;
+  }
+  size_t old_size = output->size();
+  output->resize(old_size + count);
+  CopyASCII(src, count, &(*output)[old_size]);
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Converts the given source Unicode character type to the given destination
@@ -26,6 +206,13 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    if (IsASCIIChar(src[i])) {
+      size_t ascii_len = ASCIIPrefixLength(src + i, src_len - i);
+      AppendASCII(src + i, ascii_len, output);
+      i += static_cast<int32>(ascii_len) - 1;
+      continue;
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
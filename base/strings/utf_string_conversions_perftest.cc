@@ -0,0 +1,125 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Conversions between UTF-8 and UTF-16 are done on most strings crossing the
+// IPC, URL, history and omnibox layers. Measure them on text in several
+// scripts; most of the browser's text is largely ASCII.
+
+#include "base/strings/utf_string_conversions.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/strings/string16.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace {
+
+// URLs, markup and JSON.
+const char kASCII[] =
+    "https://www.example.com/search?q=chromium+base&hl=en&source=hp <a href"
+    "=\"/intl/en/about.html\">About</a> {\"id\":42,\"title\":\"Weekly repor"
+    "t\"} ";
+
+// Latin script with diacritics, two-byte sequences.
+const char kEuropean[] =
+    "\xc3\x84rger \xc3\xbc" "ber die Gr\xc3\xb6\xc3\x9f" "e: caf\xc3\xa9, n"
+    "a\xc3\xafve fa\xc3\xa7" "ade, r\xc3\xa9sum\xc3\xa9; \xc5\x81\xc3\xb3"
+    "d\xc5\xba, S\xc3\xa3o Paulo, Malm\xc3\xb6 and Z\xc3\xbcrich. ";
+
+// Cyrillic, mostly two-byte sequences.
+const char kCyrillic[] =
+    "\xd0\x91\xd1\x8b\xd1\x81\xd1\x82\xd1\x80\xd0\xb0\xd1\x8f \xd0\xba\xd0"
+    "\xbe\xd1\x80\xd0\xb8\xd1\x87\xd0\xbd\xd0\xb5\xd0\xb2\xd0\xb0\xd1\x8f "
+    "\xd0\xbb\xd0\xb8\xd1\x81\xd0\xb0 \xd0\xbf\xd1\x80\xd1\x8b\xd0\xb3\xd0"
+    "\xb0\xd0\xb5\xd1\x82 \xd1\x87\xd0\xb5\xd1\x80\xd0\xb5\xd0\xb7 \xd0\xbb"
+    "\xd0\xb5\xd0\xbd\xd0\xb8\xd0\xb2\xd1\x83\xd1\x8e \xd1\x81\xd0\xbe\xd0"
+    "\xb1\xd0\xb0\xd0\xba\xd1\x83. \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2"
+    "\xd0\xb0, \xd0\xa1\xd0\xb0\xd0\xbd\xd0\xba\xd1\x82-\xd0\x9f\xd0\xb5"
+    "\xd1\x82\xd0\xb5\xd1\x80\xd0\xb1\xd1\x83\xd1\x80\xd0\xb3. ";
+
+// Chinese, Japanese and Korean, three-byte sequences.
+const char kCJK[] =
+    "\xe4\xb8\x9c\xe4\xba\xac\xe3\x81\xaf\xe6\x97\xa5\xe6\x9c\xac\xe3\x81"
+    "\xae\xe9\xa6\x96\xe9\x83\xbd\xe3\x81\xa7\xe3\x81\x99\xe3\x80\x82\xe5"
+    "\x8c\x97\xe4\xba\xac\xe6\x98\xaf\xe4\xb8\xad\xe5\x9b\xbd\xe7\x9a\x84"
+    "\xe9\xa6\x96\xe9\x83\xbd\xe3\x80\x82\xec\x84\x9c\xec\x9a\xb8\xec\x9d"
+    "\x80 \xed\x95\x9c\xea\xb5\xad\xec\x9d\x98 \xec\x88\x98\xeb\x8f\x84\xec"
+    "\x9e\x85\xeb\x8b\x88\xeb\x8b\xa4\xe3\x80\x82";
+
+// Markup around text in several scripts, as in a web page.
+const char kMixed[] =
+    "<li><a href=\"https://ja.wikipedia.org/wiki/%E6%9D%B1%E4%BA%AC\">\xe6"
+    "\x9d\xb1\xe4\xba\xac - Wikipedia</a> title=\"\xd0\x9c\xd0\xbe\xd1\x81"
+    "\xd0\xba\xd0\xb2\xd0\xb0\" lang=\"ru\"> Z\xc3\xbcrich, 2014</li>\n";
+
+struct Corpus {
+  const char* name;
+  const char* text;
+};
+
+const Corpus kCorpora[] = {
+  {"ascii", kASCII},
+  {"european", kEuropean},
+  {"cyrillic", kCyrillic},
+  {"cjk", kCJK},
+  {"mixed", kMixed},
+};
+
+// The different lengths of strings to convert, in bytes of UTF-8.
+const size_t kTestLengths[] = {16, 256, 32768, 1 << 20};
+
+// About this many bytes of UTF-8 are converted for each test.
+const size_t kBytesPerTest = 1 << 24;
+
+// Returns |text| repeated until it is at least |length| bytes long.
+std::string RepeatToLength(const std::string& text, size_t length) {
+  std::string output;
+  while (output.length() < length)
+    output += text;
+  return output;
+}
+
+TEST(UTFStringConversionsPerfTest, UTF8ToUTF16) {
+  for (size_t i = 0; i < arraysize(kCorpora); ++i) {
+    for (size_t j = 0; j < arraysize(kTestLengths); ++j) {
+      const std::string utf8 =
+          RepeatToLength(kCorpora[i].text, kTestLengths[j]);
+      const int times = static_cast<int>(kBytesPerTest / utf8.length());
+      string16 utf16;
+      PerfTimeLogger timer(StringPrintf("UTF8ToUTF16: %s length=%d repeat=%d",
+                                        kCorpora[i].name,
+                                        static_cast<int>(utf8.length()),
+                                        times).c_str());
+      for (int k = 0; k < times; ++k)
+        EXPECT_TRUE(UTF8ToUTF16(utf8.data(), utf8.length(), &utf16));
+      timer.Done();
+    }
+  }
+}
+
+TEST(UTFStringConversionsPerfTest, UTF16ToUTF8) {
+  for (size_t i = 0; i < arraysize(kCorpora); ++i) {
+    for (size_t j = 0; j < arraysize(kTestLengths); ++j) {
+      const std::string utf8 =
+          RepeatToLength(kCorpora[i].text, kTestLengths[j]);
+      const string16 utf16 = UTF8ToUTF16(utf8);
+      const int times = static_cast<int>(kBytesPerTest / utf8.length());
+      std::string converted;
+      PerfTimeLogger timer(StringPrintf("UTF16ToUTF8: %s length=%d repeat=%d",
+                                        kCorpora[i].name,
+                                        static_cast<int>(utf8.length()),
+                                        times).c_str());
+      for (int k = 0; k < times; ++k)
+        EXPECT_TRUE(UTF16ToUTF8(utf16.data(), utf16.length(), &converted));
+      timer.Done();
+    }
+  }
+}
+
+}  // namespace
+}  // namespace base
@@ -208,4 +208,55 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// Runs of ASCII are converted in blocks; check the conversion around the
+// block boundaries.
+TEST(UTFStringConversionsTest, ConvertASCIIRuns) {
+  const std::string kNonASCIIUTF8 = "\xe4\xbd\xa0";  // U+4F60
+  const string16 kNonASCIIUTF16(1, 0x4F60);
+  for (size_t length = 0; length < 40; ++length) {
+    for (size_t position = 0; position <= length; ++position) {
+      std::string utf8;
+      string16 utf16;
+      for (size_t i = 0; i < length; ++i) {
+        char c = static_cast<char>('a' + i % 26);
+        if (i == position) {
+          utf8 += kNonASCIIUTF8;
+          utf16 += kNonASCIIUTF16;
+        } else {
+          utf8.push_back(c);
+          utf16.push_back(c);
+        }
+      }
+      EXPECT_EQ(utf16, UTF8ToUTF16(utf8));
+      EXPECT_EQ(utf8, UTF16ToUTF8(utf16));
+      EXPECT_EQ(UTF16ToWide(utf16), UTF8ToWide(utf8));
+      EXPECT_EQ(utf8, WideToUTF8(UTF16ToWide(utf16)));
+    }
+  }
+}
+
+TEST(UTFStringConversionsTest, ConvertInvalidAfterASCIIRun) {
+  // 17 ASCII characters, then an invalid byte, then ASCII again.
+  const std::string kInput = "0123456789abcdefg\xff" "0123456789abcdefg";
+  string16 converted;
+  EXPECT_FALSE(UTF8ToUTF16(kInput.data(), kInput.length(), &converted));
+  string16 expected = ASCIIToUTF16("0123456789abcdefg");
+  expected.push_back(0xFFFD);
+  expected += ASCIIToUTF16("0123456789abcdefg");
+  EXPECT_EQ(expected, converted);
+
+  // An unpaired surrogate after an ASCII run.
+  string16 utf16 = ASCIIToUTF16("0123456789abcdefg");
+  utf16.push_back(0xD800);
+  utf16 += ASCIIToUTF16("xyz");
+  std::string utf8;
+  EXPECT_FALSE(UTF16ToUTF8(utf16.data(), utf16.length(), &utf8));
+  EXPECT_EQ("0123456789abcdefg\xef\xbf\xbdxyz", utf8);
+
+  // Embedded NULs are ASCII too.
+  const std::string kWithNul("abc\0def", 7);
+  EXPECT_EQ(kWithNul, UTF16ToUTF8(UTF8ToUTF16(kWithNul)));
+  EXPECT_EQ(7u, UTF8ToUTF16(kWithNul).length());
+}
+
 }  // base
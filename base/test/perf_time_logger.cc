@@ -4,6 +4,12 @@
 
 #include "base/test/perf_time_logger.h"
 
+#include <math.h>
+
+#include <string>
+
+#include "base/callback.h"
+#include "base/logging.h"
 #include "base/test/perf_log.h"
 
 namespace base {
@@ -24,4 +30,28 @@ void PerfTimeLogger::Done() {
   logged_ = true;
 }
 
+void LogPerfTimeOfRuns(const char* test_name,
+                       const Closure& task,
+                       int warmup_runs,
+                       int runs) {
+  DCHECK_GT(runs, 0);
+  for (int i = 0; i < warmup_runs; ++i)
+    task.Run();
+
+  double sum = 0;
+  double sum_of_squares = 0;
+  for (int i = 0; i < runs; ++i) {
+    ElapsedTimer timer;
+    task.Run();
+    double time = timer.Elapsed().InMillisecondsF();
+    sum += time;
+    sum_of_squares += time * time;
+  }
+  double mean = sum / runs;
+  double variance = sum_of_squares / runs - mean * mean;
+  LogPerfResult(test_name, mean, "ms");
+  LogPerfResult((std::string(test_name) + " (stddev)").c_str(),
+                variance > 0 ? sqrt(variance) : 0, "ms");
+}
+
 }  // namespace base
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
 #include "base/timer/elapsed_timer.h"
 
 namespace base {
@@ -32,6 +33,16 @@ class PerfTimeLogger {
   DISALLOW_COPY_AND_ASSIGN(PerfTimeLogger);
 };
 
+// Runs |task| |warmup_runs| times to warm up the caches, then times |runs|
+// more runs of it, and logs the mean time a run took as |test_name| and the
+// standard deviation of the times as |test_name| followed by " (stddev)".
+// Use it rather than timing a single long loop to tell regressions from
+// noise.
+void LogPerfTimeOfRuns(const char* test_name,
+                       const Closure& task,
+                       int warmup_runs,
+                       int runs);
+
 }  // namespace base
 
 #endif  // BASE_TEST_PERF_TIME_LOGGER_H_
@@ -4,6 +4,8 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -18,6 +20,7 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
@@ -84,6 +87,74 @@ struct SequencedTaskLessThan {
   }
 };
 
+// WorkQueue -----------------------------------------------------------------
+// A FIFO of immediate tasks used in WORK_STEALING mode. Each worker thread
+// owns one of these and steals from the others when its own queue has nothing
+// runnable. All tasks with a given sequence token are routed to the same
+// queue, which lets the queue's lock also guard the set of its sequences that
+// are currently running.
+class WorkQueue {
+ public:
+  WorkQueue() {}
+
+  void Push(const SequencedTask& task) {
+    AutoLock lock(lock_);
+    tasks_.push_back(task);
+  }
+
+  // Removes the oldest task whose sequence is not currently running, copies
+  // it to |task| and marks its sequence as running. Returns false if there is
+  // no such task.
+  //
+  // When |discard_non_blocking| is true, runnable tasks that are not
+  // BLOCK_SHUTDOWN are removed and appended to |discarded| instead of being
+  // returned. The caller should clear |discarded| once it no longer holds any
+  // lock, for the same reason as |delete_these_outside_lock| in
+  // Inner::GetWork().
+  bool Pop(bool discard_non_blocking,
+           SequencedTask* task,
+           std::vector<SequencedTask>* discarded) {
+    AutoLock lock(lock_);
+    std::deque<SequencedTask>::iterator i = tasks_.begin();
+    while (i != tasks_.end()) {
+      if (i->sequence_token_id &&
+          ContainsKey(running_sequences_, i->sequence_token_id)) {
+        ++i;
+        continue;
+      }
+      if (discard_non_blocking &&
+          i->shutdown_behavior != SequencedWorkerPool::BLOCK_SHUTDOWN) {
+        discarded->push_back(*i);
+        i = tasks_.erase(i);
+        continue;
+      }
+      *task = *i;
+      tasks_.erase(i);
+      if (task->sequence_token_id)
+        running_sequences_.insert(task->sequence_token_id);
+      return true;
+    }
+    return false;
+  }
+
+  // Must be called once a task returned by Pop() has finished running.
+  void DidRunTask(const SequencedTask& task) {
+    if (!task.sequence_token_id)
+      return;
+    AutoLock lock(lock_);
+    running_sequences_.erase(task.sequence_token_id);
+  }
+
+ private:
+  Lock lock_;
+  std::deque<SequencedTask> tasks_;
+
+  // Sequence tokens of the tasks from this queue that are currently running.
+  std::set<int> running_sequences_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkQueue);
+};
+
 // SequencedWorkerPoolTaskRunner ---------------------------------------------
 // A TaskRunner which posts tasks to a SequencedWorkerPool with a
 // fixed ShutdownBehavior.
@@ -252,8 +323,11 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_shutdown_behavior_;
   }
 
+  int thread_number() const { return thread_number_; }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
+  const int thread_number_;
   SequenceToken running_sequence_;
   WorkerShutdown running_shutdown_behavior_;
 
@@ -268,6 +342,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulingMode scheduling_mode,
         TestingObserver* observer);
 
   ~Inner();
@@ -389,6 +464,52 @@ class SequencedWorkerPool::Inner {
   // called inside the lock.
   bool CanShutdown() const;
 
+  // WORK_STEALING counterparts of PostTask(), ThreadLoop() and
+  // CleanupForTesting(). See the comment above |work_queues_| for how the
+  // state shared between these is synchronized.
+  bool PostTaskToWorkQueue(const std::string* optional_token_name,
+                           SequencedTask* sequenced,
+                           TimeDelta delay);
+  void WorkStealingThreadLoop(Worker* this_worker);
+  void WorkStealingCleanupForTesting();
+
+  // Returns the queue |task| should be pushed to. Tasks with a sequence token
+  // always map to the same queue. Other tasks go to the queue of the calling
+  // worker, or are spread round-robin when posted from outside the pool.
+  WorkQueue* SelectWorkQueue(const SequencedTask& task);
+
+  // Pushes |task| onto its work queue and wakes up or creates a worker if
+  // none is idle. Must be called outside the lock.
+  void EnqueueToWorkQueue(const SequencedTask& task);
+
+  // Finds a runnable task, starting with the queue of worker |thread_number|
+  // and then stealing from the others. See WorkQueue::Pop() for |discarded|.
+  // On success, |source| is set to the queue the task came from.
+  bool TakeQueuedWork(int thread_number,
+                      bool shutting_down,
+                      SequencedTask* task,
+                      WorkQueue** source,
+                      std::vector<SequencedTask>* discarded);
+
+  // Moves the delayed tasks whose time has come from |pending_tasks_| to the
+  // work queues. Only takes the lock if one may be due.
+  void EnqueueDueDelayedTasks();
+
+  // Called from within the lock, updates |next_delayed_task_ms_| from the
+  // front of |pending_tasks_|.
+  void LockedUpdateNextDelayedTaskTime();
+
+  // Converts between TimeTicks and the 32-bit millisecond offsets from
+  // |creation_time_| used by |next_delayed_task_ms_|.
+  int32 ToDelayedTaskMs(TimeTicks time) const;
+
+  // Wakes up the thread blocked in Shutdown() or FlushForTesting(), if any,
+  // after a WORK_STEALING counter they wait on went down.
+  void SignalWorkStealingCountersChanged();
+
+  // Returns true if the WORK_STEALING counters allow shutdown to complete.
+  bool WorkStealingCanShutdown() const;
+
   SequencedWorkerPool* const worker_pool_;
 
   // The last sequence number used. Managed by GetSequenceToken, since this
@@ -415,6 +536,8 @@ class SequencedWorkerPool::Inner {
 
   const std::string thread_name_prefix_;
 
+  const SchedulingMode scheduling_mode_;
+
   // Associates all known sequence token names with their IDs.
   std::map<std::string, int> named_sequence_tokens_;
 
@@ -471,6 +594,65 @@ class SequencedWorkerPool::Inner {
 
   TestingObserver* const testing_observer_;
 
+  // WORK_STEALING state ------------------------------------------------------
+  //
+  // In WORK_STEALING mode, immediate tasks live in |work_queues_| instead of
+  // |pending_tasks_|, one queue per potential worker thread. Each queue has
+  // its own lock. The counters below are updated with atomic operations so
+  // that posting and running tasks don't need |lock_|. |lock_| still guards
+  // delayed tasks, named tokens, thread creation and the shutdown and cleanup
+  // state, and the condition variables are still waited on with |lock_|
+  // held.
+  //
+  // Whenever a thread waits on a condition that depends on one of these
+  // counters, the thread changing the counter and the waiting thread follow
+  // the same protocol: the waiter publishes that it is waiting, issues a full
+  // barrier and checks the counter while holding |lock_|. The other side
+  // changes the counter, issues a full barrier, checks whether anybody waits
+  // and, if so, takes |lock_| to signal. This guarantees that either the
+  // waiter sees the change or the signal happens once it is waiting.
+  ScopedVector<WorkQueue> work_queues_;
+
+  // Round-robin cursor for tasks posted from outside the pool.
+  AtomicSequenceNumber next_work_queue_;
+
+  // Trace IDs for tasks posted without |lock_|.
+  AtomicSequenceNumber work_queue_trace_id_;
+
+  // Mirrors |shutdown_called_| for readers that don't hold |lock_|.
+  subtle::Atomic32 shutdown_flag_;
+
+  // Number of tasks in |work_queues_|, and how many of them are
+  // BLOCK_SHUTDOWN.
+  subtle::Atomic32 queued_task_count_;
+  subtle::Atomic32 queued_blocking_task_count_;
+
+  // Number of tasks taken out of |work_queues_| that haven't finished yet,
+  // and how many of them are not CONTINUE_ON_SHUTDOWN.
+  subtle::Atomic32 running_task_count_;
+  subtle::Atomic32 running_blocking_task_count_;
+
+  // Incremented after every push to |work_queues_|. A worker that found no
+  // work only goes to sleep if this didn't change since it started looking.
+  subtle::Atomic32 work_generation_;
+
+  // Number of workers that are about to wait or waiting on |has_work_cv_|.
+  subtle::Atomic32 idle_thread_count_;
+
+  // Number of worker threads that were created or are being created.
+  subtle::Atomic32 started_thread_count_;
+
+  // Number of threads waiting in FlushForTesting().
+  subtle::Atomic32 flush_waiter_count_;
+
+  // Time, in milliseconds since |creation_time_|, at which the earliest
+  // delayed task in |pending_tasks_| is due, or kint32max if there is none.
+  subtle::Atomic32 next_delayed_task_ms_;
+  const TimeTicks creation_time_;
+
+  // The work queue of the worker running on the current thread.
+  ThreadLocalPointer<WorkQueue> current_work_queue_;
+
   DISALLOW_COPY_AND_ASSIGN(Inner);
 };
 
@@ -483,6 +665,7 @@ SequencedWorkerPool::Worker::Worker(
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
       worker_pool_(worker_pool),
+      thread_number_(thread_number),
       running_shutdown_behavior_(CONTINUE_ON_SHUTDOWN) {
   Start();
 }
@@ -511,6 +694,7 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
       lock_(),
@@ -518,6 +702,7 @@ SequencedWorkerPool::Inner::Inner(
       can_shutdown_cv_(&lock_),
       max_threads_(max_threads),
       thread_name_prefix_(thread_name_prefix),
+      scheduling_mode_(scheduling_mode),
       thread_being_created_(false),
       waiting_thread_count_(0),
       blocking_shutdown_thread_count_(0),
@@ -529,7 +714,23 @@ SequencedWorkerPool::Inner::Inner(
       cleanup_state_(CLEANUP_DONE),
       cleanup_idlers_(0),
       cleanup_cv_(&lock_),
-      testing_observer_(observer) {}
+      testing_observer_(observer),
+      shutdown_flag_(0),
+      queued_task_count_(0),
+      queued_blocking_task_count_(0),
+      running_task_count_(0),
+      running_blocking_task_count_(0),
+      work_generation_(0),
+      idle_thread_count_(0),
+      started_thread_count_(0),
+      flush_waiter_count_(0),
+      next_delayed_task_ms_(kint32max),
+      creation_time_(TimeTicks::Now()) {
+  if (scheduling_mode_ == WORK_STEALING) {
+    for (size_t i = 0; i < max_threads_; ++i)
+      work_queues_.push_back(new WorkQueue);
+  }
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -575,6 +776,9 @@ bool SequencedWorkerPool::Inner::PostTask(
       base::MakeCriticalClosure(task) : task;
   sequenced.time_to_run = TimeTicks::Now() + delay;
 
+  if (scheduling_mode_ == WORK_STEALING)
+    return PostTaskToWorkQueue(optional_token_name, &sequenced, delay);
+
   int create_thread_id = 0;
   {
     AutoLock lock(lock_);
@@ -637,6 +841,10 @@ bool SequencedWorkerPool::Inner::IsRunningSequenceOnCurrentThread(
 // See https://code.google.com/p/chromium/issues/detail?id=168415
 void SequencedWorkerPool::Inner::CleanupForTesting() {
   DCHECK(!RunsTasksOnCurrentThread());
+  if (scheduling_mode_ == WORK_STEALING) {
+    WorkStealingCleanupForTesting();
+    return;
+  }
   base::ThreadRestrictions::ScopedAllowWait allow_wait;
   AutoLock lock(lock_);
   CHECK_EQ(CLEANUP_DONE, cleanup_state_);
@@ -667,6 +875,11 @@ void SequencedWorkerPool::Inner::Shutdown(
     shutdown_called_ = true;
     max_blocking_tasks_after_shutdown_ = max_new_blocking_tasks_after_shutdown;
 
+    // Pairs with the barriers in PostTaskToWorkQueue() and
+    // WorkStealingThreadLoop(), see the comment above |work_queues_|.
+    subtle::NoBarrier_Store(&shutdown_flag_, 1);
+    subtle::MemoryBarrier();
+
     // Tickle the threads. This will wake up a waiting one so it will know that
     // it can exit, which in turn will wake up any other waiting ones.
     SignalHasWork();
@@ -704,6 +917,10 @@ bool SequencedWorkerPool::Inner::IsShutdownInProgress() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  if (scheduling_mode_ == WORK_STEALING) {
+    WorkStealingThreadLoop(this_worker);
+    return;
+  }
   {
     AutoLock lock(lock_);
     DCHECK(thread_being_created_);
@@ -753,7 +970,10 @@ void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
           tracked_objects::TrackedTime start_time =
               tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
 
-          task.task.Run();
+          {
+            tracked_objects::ScopedRunningTask running_task(task.posted_from);
+            task.task.Run();
+          }
 
           tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
               start_time, tracked_objects::ThreadData::NowForEndOfRun());
@@ -1075,6 +1295,22 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
   // given the workload, but in reality fewer may be created because the
   // sequence of thread creation on the background threads is racing with the
   // shutdown call.
+  if (scheduling_mode_ == WORK_STEALING) {
+    // Idle workers are woken up instead, and the work queues are not
+    // accessible from here, so queued work is approximated by the counter.
+    if (!shutdown_called_ &&
+        !thread_being_created_ &&
+        threads_.size() < max_threads_ &&
+        subtle::Acquire_Load(&idle_thread_count_) == 0 &&
+        (subtle::Acquire_Load(&queued_task_count_) > 0 ||
+         !pending_tasks_.empty())) {
+      thread_being_created_ = true;
+      subtle::NoBarrier_AtomicIncrement(&started_thread_count_, 1);
+      return static_cast<int>(threads_.size() + 1);
+    }
+    return 0;
+  }
+
   if (!shutdown_called_ &&
       !thread_being_created_ &&
       cleanup_state_ == CLEANUP_DONE &&
@@ -1115,7 +1351,376 @@ bool SequencedWorkerPool::Inner::CanShutdown() const {
   // See PrepareToStartAdditionalThreadIfHelpful for how thread creation works.
   return !thread_being_created_ &&
          blocking_shutdown_thread_count_ == 0 &&
-         blocking_shutdown_pending_task_count_ == 0;
+         blocking_shutdown_pending_task_count_ == 0 &&
+         WorkStealingCanShutdown();
+}
+
+bool SequencedWorkerPool::Inner::PostTaskToWorkQueue(
+    const std::string* optional_token_name,
+    SequencedTask* sequenced,
+    TimeDelta delay) {
+  DCHECK_EQ(WORK_STEALING, scheduling_mode_);
+  const bool blocks_shutdown = sequenced->shutdown_behavior == BLOCK_SHUTDOWN;
+
+  if (optional_token_name) {
+    sequenced->sequence_token_id =
+        GetNamedSequenceToken(*optional_token_name).id_;
+  }
+
+  if (delay > TimeDelta()) {
+    // Delayed tasks are SKIP_ON_SHUTDOWN and never block shutdown, so they
+    // don't touch the shutdown counters.
+    int create_thread_id = 0;
+    {
+      AutoLock lock(lock_);
+      if (shutdown_called_)
+        return false;
+      sequenced->trace_id = work_queue_trace_id_.GetNext();
+      TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+          "SequencedWorkerPool::PostTask",
+          TRACE_ID_MANGLE(GetTaskTraceID(*sequenced,
+                                         static_cast<void*>(this))));
+      sequenced->sequence_task_number = LockedGetNextSequenceTaskNumber();
+      pending_tasks_.insert(*sequenced);
+      LockedUpdateNextDelayedTaskTime();
+      create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+    }
+    // Make sure a worker picks up the new wake-up time.
+    if (create_thread_id)
+      FinishStartingAdditionalThread(create_thread_id);
+    else
+      SignalHasWork();
+    return true;
+  }
+
+  // Account for the task before checking for shutdown so that Shutdown()
+  // either sees it or we see Shutdown().
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&queued_blocking_task_count_, 1);
+  if (subtle::Acquire_Load(&shutdown_flag_)) {
+    AutoLock lock(lock_);
+    bool allowed = blocks_shutdown &&
+        LockedCurrentThreadShutdownBehavior() != CONTINUE_ON_SHUTDOWN;
+    if (allowed && max_blocking_tasks_after_shutdown_ <= 0) {
+      DLOG(WARNING) << "BLOCK_SHUTDOWN task disallowed";
+      allowed = false;
+    }
+    if (!allowed) {
+      if (blocks_shutdown) {
+        subtle::Barrier_AtomicIncrement(&queued_blocking_task_count_, -1);
+        can_shutdown_cv_.Signal();
+      }
+      return false;
+    }
+    max_blocking_tasks_after_shutdown_ -= 1;
+  }
+
+  sequenced->trace_id = work_queue_trace_id_.GetNext();
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(*sequenced, static_cast<void*>(this))));
+  EnqueueToWorkQueue(*sequenced);
+  return true;
+}
+
+WorkQueue* SequencedWorkerPool::Inner::SelectWorkQueue(
+    const SequencedTask& task) {
+  const size_t queue_count = work_queues_.size();
+  if (task.sequence_token_id)
+    return work_queues_[static_cast<size_t>(task.sequence_token_id) %
+                        queue_count];
+  WorkQueue* current = current_work_queue_.Get();
+  if (current)
+    return current;
+  return work_queues_[static_cast<size_t>(next_work_queue_.GetNext()) %
+                      queue_count];
+}
+
+void SequencedWorkerPool::Inner::EnqueueToWorkQueue(
+    const SequencedTask& task) {
+  subtle::NoBarrier_AtomicIncrement(&queued_task_count_, 1);
+  SelectWorkQueue(task)->Push(task);
+
+  // Pairs with the barrier a worker issues before deciding to sleep.
+  subtle::Barrier_AtomicIncrement(&work_generation_, 1);
+  if (subtle::Acquire_Load(&idle_thread_count_) > 0) {
+    AutoLock lock(lock_);
+    SignalHasWork();
+    return;
+  }
+
+  // Every worker is busy. Creating threads needs the lock, but once all of
+  // them exist there's nothing left to do.
+  if (static_cast<size_t>(subtle::Acquire_Load(&started_thread_count_)) >=
+      max_threads_) {
+    return;
+  }
+  int create_thread_id = 0;
+  {
+    AutoLock lock(lock_);
+    create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+  }
+  if (create_thread_id)
+    FinishStartingAdditionalThread(create_thread_id);
+}
+
+bool SequencedWorkerPool::Inner::TakeQueuedWork(
+    int thread_number,
+    bool shutting_down,
+    SequencedTask* task,
+    WorkQueue** source,
+    std::vector<SequencedTask>* discarded) {
+  const size_t queue_count = work_queues_.size();
+  const size_t own_index = static_cast<size_t>(thread_number - 1);
+  for (size_t i = 0; i < queue_count; ++i) {
+    WorkQueue* queue = work_queues_[(own_index + i) % queue_count];
+    size_t discarded_before = discarded->size();
+    bool found = queue->Pop(shutting_down, task, discarded);
+    // Count a found task as running before it stops being queued, so that
+    // WorkStealingCleanupForTesting() never sees it in neither counter.
+    if (found)
+      subtle::NoBarrier_AtomicIncrement(&running_task_count_, 1);
+    int removed = static_cast<int>(discarded->size() - discarded_before) +
+        (found ? 1 : 0);
+    if (removed)
+      subtle::Barrier_AtomicIncrement(&queued_task_count_, -removed);
+    if (found) {
+      *source = queue;
+      return true;
+    }
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::EnqueueDueDelayedTasks() {
+  if (ToDelayedTaskMs(TimeTicks::Now()) <
+      subtle::Acquire_Load(&next_delayed_task_ms_)) {
+    return;
+  }
+
+  std::vector<SequencedTask> due_tasks;
+  std::vector<Closure> delete_these_outside_lock;
+  {
+    AutoLock lock(lock_);
+    const TimeTicks current_time = TimeTicks::Now();
+    while (!pending_tasks_.empty() &&
+           pending_tasks_.begin()->time_to_run <= current_time) {
+      // Delayed tasks are SKIP_ON_SHUTDOWN.
+      if (shutdown_called_)
+        delete_these_outside_lock.push_back(pending_tasks_.begin()->task);
+      else
+        due_tasks.push_back(*pending_tasks_.begin());
+      pending_tasks_.erase(pending_tasks_.begin());
+    }
+    LockedUpdateNextDelayedTaskTime();
+  }
+
+  for (size_t i = 0; i < due_tasks.size(); ++i)
+    EnqueueToWorkQueue(due_tasks[i]);
+}
+
+void SequencedWorkerPool::Inner::LockedUpdateNextDelayedTaskTime() {
+  lock_.AssertAcquired();
+  subtle::Release_Store(&next_delayed_task_ms_,
+                        pending_tasks_.empty() ?
+                            kint32max :
+                            ToDelayedTaskMs(
+                                pending_tasks_.begin()->time_to_run));
+}
+
+int32 SequencedWorkerPool::Inner::ToDelayedTaskMs(TimeTicks time) const {
+  int64 ms = (time - creation_time_).InMilliseconds();
+  if (ms >= kint32max)
+    return kint32max - 1;
+  return static_cast<int32>(std::max(ms, static_cast<int64>(0)));
+}
+
+void SequencedWorkerPool::Inner::SignalWorkStealingCountersChanged() {
+  // Pairs with the barriers in Shutdown() and WorkStealingCleanupForTesting().
+  subtle::MemoryBarrier();
+  if (!subtle::NoBarrier_Load(&shutdown_flag_) &&
+      !subtle::NoBarrier_Load(&flush_waiter_count_)) {
+    return;
+  }
+  AutoLock lock(lock_);
+  can_shutdown_cv_.Signal();
+  cleanup_cv_.Broadcast();
+}
+
+bool SequencedWorkerPool::Inner::WorkStealingCanShutdown() const {
+  // A task moves from the queued to the running counter by incrementing the
+  // latter first, so reading the queued counter first can't miss a task that
+  // is in between.
+  if (subtle::Acquire_Load(&queued_blocking_task_count_))
+    return false;
+  return !subtle::Acquire_Load(&running_blocking_task_count_);
+}
+
+void SequencedWorkerPool::Inner::WorkStealingThreadLoop(Worker* this_worker) {
+  const int thread_number = this_worker->thread_number();
+  current_work_queue_.Set(work_queues_[thread_number - 1]);
+  {
+    AutoLock lock(lock_);
+    DCHECK(thread_being_created_);
+    thread_being_created_ = false;
+    std::pair<ThreadMap::iterator, bool> result =
+        threads_.insert(
+            std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
+    DCHECK(result.second);
+  }
+
+  std::vector<Closure> delete_these_outside_lock;
+  while (true) {
+#if defined(OS_MACOSX)
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
+#endif
+
+    EnqueueDueDelayedTasks();
+
+    const subtle::Atomic32 generation =
+        subtle::Acquire_Load(&work_generation_);
+    const bool shutting_down = !!subtle::Acquire_Load(&shutdown_flag_);
+    SequencedTask task;
+    WorkQueue* source = NULL;
+    std::vector<SequencedTask> discarded;
+    bool found =
+        TakeQueuedWork(thread_number, shutting_down, &task, &source,
+                       &discarded);
+    discarded.clear();
+
+    if (found) {
+      const bool blocks_shutdown =
+          task.shutdown_behavior != CONTINUE_ON_SHUTDOWN;
+      if (blocks_shutdown)
+        subtle::Barrier_AtomicIncrement(&running_blocking_task_count_, 1);
+      if (task.shutdown_behavior == BLOCK_SHUTDOWN)
+        subtle::Barrier_AtomicIncrement(&queued_blocking_task_count_, -1);
+
+      // Shutdown() may have started after the queue was searched. Now that
+      // the task is accounted as running, either Shutdown() waits for it or
+      // we see the flag here, so a SKIP_ON_SHUTDOWN task never starts after
+      // Shutdown() returned.
+      bool skip = task.shutdown_behavior == SKIP_ON_SHUTDOWN &&
+          subtle::Acquire_Load(&shutdown_flag_);
+
+      if (!skip) {
+        if (static_cast<size_t>(subtle::Acquire_Load(&started_thread_count_)) <
+                max_threads_ &&
+            subtle::Acquire_Load(&queued_task_count_) > 0) {
+          int new_thread_id = 0;
+          {
+            AutoLock lock(lock_);
+            new_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+          }
+          if (new_thread_id)
+            FinishStartingAdditionalThread(new_thread_id);
+        }
+
+        TRACE_EVENT_FLOW_END0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+            "SequencedWorkerPool::PostTask",
+            TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
+        TRACE_EVENT2("toplevel", "SequencedWorkerPool::ThreadLoop",
+                     "src_file", task.posted_from.file_name(),
+                     "src_func", task.posted_from.function_name());
+
+        this_worker->set_running_task_info(
+            SequenceToken(task.sequence_token_id), task.shutdown_behavior);
+
+        tracked_objects::TrackedTime start_time =
+            tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
+
+        {
+          tracked_objects::ScopedRunningTask running_task(task.posted_from);
+          task.task.Run();
+        }
+
+        tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
+            start_time, tracked_objects::ThreadData::NowForEndOfRun());
+      }
+
+      // As in ThreadLoop(), destroy the closure before resetting the running
+      // task info so that sequence checks in destructors still work.
+      task.task = Closure();
+      this_worker->set_running_task_info(SequenceToken(), CONTINUE_ON_SHUTDOWN);
+
+      source->DidRunTask(task);
+      if (blocks_shutdown)
+        subtle::NoBarrier_AtomicIncrement(&running_blocking_task_count_, -1);
+      subtle::NoBarrier_AtomicIncrement(&running_task_count_, -1);
+      SignalWorkStealingCountersChanged();
+      continue;
+    }
+
+    // There was nothing runnable. Sleep until a task is posted or the next
+    // delayed task is due.
+    AutoLock lock(lock_);
+    if (shutdown_called_ &&
+        !subtle::Acquire_Load(&queued_blocking_task_count_)) {
+      // Delayed tasks are SKIP_ON_SHUTDOWN and may hold references to the
+      // pool, so delete them rather than leaving them for the destructor.
+      for (PendingTaskSet::iterator i = pending_tasks_.begin();
+           i != pending_tasks_.end(); ++i) {
+        delete_these_outside_lock.push_back(i->task);
+      }
+      pending_tasks_.clear();
+      LockedUpdateNextDelayedTaskTime();
+      break;
+    }
+
+    // Publish that we are about to wait before looking at |work_generation_|
+    // a last time. A poster either sees us idle and signals once we wait, or
+    // it pushed before we read the generation and we search again.
+    subtle::Barrier_AtomicIncrement(&idle_thread_count_, 1);
+    if (subtle::Acquire_Load(&work_generation_) == generation) {
+      waiting_thread_count_++;
+      if (pending_tasks_.empty()) {
+        has_work_cv_.Wait();
+      } else {
+        TimeDelta wait_time =
+            pending_tasks_.begin()->time_to_run - TimeTicks::Now();
+        if (wait_time > TimeDelta())
+          has_work_cv_.TimedWait(wait_time);
+      }
+      waiting_thread_count_--;
+    }
+    subtle::Barrier_AtomicIncrement(&idle_thread_count_, -1);
+  }  // Release lock_.
+
+  delete_these_outside_lock.clear();
+
+  // We noticed we should exit. Wake up the next worker so it knows it should
+  // exit as well (because the Shutdown() code only signals once).
+  SignalHasWork();
+
+  // Possibly unblock shutdown.
+  can_shutdown_cv_.Signal();
+}
+
+void SequencedWorkerPool::Inner::WorkStealingCleanupForTesting() {
+  base::ThreadRestrictions::ScopedAllowWait allow_wait;
+  std::vector<Closure> delete_these_outside_lock;
+  {
+    AutoLock lock(lock_);
+    if (shutdown_called_)
+      return;
+
+    // Delayed tasks are deleted rather than run, as in CleanupForTesting().
+    for (PendingTaskSet::iterator i = pending_tasks_.begin();
+         i != pending_tasks_.end(); ++i) {
+      delete_these_outside_lock.push_back(i->task);
+    }
+    pending_tasks_.clear();
+    LockedUpdateNextDelayedTaskTime();
+  }
+  delete_these_outside_lock.clear();
+
+  AutoLock lock(lock_);
+  subtle::Barrier_AtomicIncrement(&flush_waiter_count_, 1);
+  while (subtle::Acquire_Load(&queued_task_count_) ||
+         subtle::Acquire_Load(&running_task_count_)) {
+    cleanup_cv_.Wait();
+  }
+  subtle::Barrier_AtomicIncrement(&flush_waiter_count_, -1);
 }
 
 base::StaticAtomicSequenceNumber
@@ -1140,15 +1745,27 @@ SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, NULL)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(this, max_threads, thread_name_prefix, GLOBAL_QUEUE,
+                       observer)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, observer)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, scheduling_mode,
+                       observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
@@ -142,6 +142,27 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     int id_;
   };
 
+  // Defines how pending tasks are handed to the worker threads.
+  enum SchedulingMode {
+    // All pending tasks are kept in a single time-ordered set guarded by one
+    // lock, which every post and every worker wake-up has to take.
+    GLOBAL_QUEUE,
+
+    // Immediate tasks are pushed onto per-worker queues, each with its own
+    // lock. Workers run tasks from their own queue first and steal from the
+    // other queues when it has nothing runnable. All tasks with the same
+    // sequence token go to the same queue, so a sequence is pinned to a
+    // single queue and at most one worker runs it at a time. Once all worker
+    // threads exist, posting only takes the pool-wide lock when a worker has
+    // to be woken up. Delayed tasks still go through the pool-wide lock until
+    // they are due.
+    //
+    // This reduces contention when many threads post short tasks. Unlike
+    // GLOBAL_QUEUE, a delayed task that becomes due may run after sequenced
+    // tasks that were posted without delay after it was due.
+    WORK_STEALING,
+  };
+
   // Allows tests to perform certain actions.
   class TestingObserver {
    public:
@@ -171,6 +192,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like above, but allows to select how tasks are scheduled. The
+  // constructors above use GLOBAL_QUEUE. |observer| may be NULL.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulingMode scheduling_mode,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are always nonzero.
   SequenceToken GetSequenceToken();
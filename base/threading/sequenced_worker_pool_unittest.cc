@@ -6,10 +6,12 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/synchronization/condition_variable.h"
@@ -19,9 +21,11 @@
 #include "base/test/task_runner_test_template.h"
 #include "base/test/test_timeouts.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/tracked_objects.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 
 namespace base {
 
@@ -176,7 +180,8 @@ class TestTracker : public base::RefCountedThreadSafe<TestTracker> {
   size_t started_events_;
 };
 
-class SequencedWorkerPoolTest : public testing::Test {
+class SequencedWorkerPoolTest
+    : public testing::TestWithParam<SequencedWorkerPool::SchedulingMode> {
  public:
   SequencedWorkerPoolTest()
       : tracker_(new TestTracker) {
@@ -199,7 +204,8 @@ class SequencedWorkerPoolTest : public testing::Test {
   // Destroys the SequencedWorkerPool instance, blocking until it is fully shut
   // down, and creates a new instance.
   void ResetPool() {
-    pool_owner_.reset(new SequencedWorkerPoolOwner(kNumWorkerThreads, "test"));
+    pool_owner_.reset(
+        new SequencedWorkerPoolOwner(kNumWorkerThreads, "test", GetParam()));
   }
 
   void SetWillWaitForShutdownCallback(const Closure& callback) {
@@ -285,7 +291,7 @@ void HoldPoolReference(const scoped_refptr<base::SequencedWorkerPool>& pool,
 }
 
 // Tests that delayed tasks are deleted upon shutdown of the pool.
-TEST_F(SequencedWorkerPoolTest, DelayedTaskDuringShutdown) {
+TEST_P(SequencedWorkerPoolTest, DelayedTaskDuringShutdown) {
   // Post something to verify the pool is started up.
   EXPECT_TRUE(pool()->PostTask(
       FROM_HERE, base::Bind(&TestTracker::FastTask, tracker(), 1)));
@@ -320,7 +326,7 @@ TEST_F(SequencedWorkerPoolTest, DelayedTaskDuringShutdown) {
 }
 
 // Tests that same-named tokens have the same ID.
-TEST_F(SequencedWorkerPoolTest, NamedTokens) {
+TEST_P(SequencedWorkerPoolTest, NamedTokens) {
   const std::string name1("hello");
   SequencedWorkerPool::SequenceToken token1 =
       pool()->GetNamedSequenceToken(name1);
@@ -348,7 +354,7 @@ TEST_F(SequencedWorkerPoolTest, NamedTokens) {
 
 // Tests that posting a bunch of tasks (many more than the number of worker
 // threads) runs them all.
-TEST_F(SequencedWorkerPoolTest, LotsOfTasks) {
+TEST_P(SequencedWorkerPoolTest, LotsOfTasks) {
   pool()->PostWorkerTask(FROM_HERE,
                          base::Bind(&TestTracker::SlowTask, tracker(), 0));
 
@@ -366,9 +372,9 @@ TEST_F(SequencedWorkerPoolTest, LotsOfTasks) {
 // worker threads) to two pools simultaneously runs them all twice.
 // This test is meant to shake out any concurrency issues between
 // pools (like histograms).
-TEST_F(SequencedWorkerPoolTest, LotsOfTasksTwoPools) {
-  SequencedWorkerPoolOwner pool1(kNumWorkerThreads, "test1");
-  SequencedWorkerPoolOwner pool2(kNumWorkerThreads, "test2");
+TEST_P(SequencedWorkerPoolTest, LotsOfTasksTwoPools) {
+  SequencedWorkerPoolOwner pool1(kNumWorkerThreads, "test1", GetParam());
+  SequencedWorkerPoolOwner pool2(kNumWorkerThreads, "test2", GetParam());
 
   base::Closure slow_task = base::Bind(&TestTracker::SlowTask, tracker(), 0);
   pool1.pool()->PostWorkerTask(FROM_HERE, slow_task);
@@ -392,7 +398,7 @@ TEST_F(SequencedWorkerPoolTest, LotsOfTasksTwoPools) {
 
 // Test that tasks with the same sequence token are executed in order but don't
 // affect other tasks.
-TEST_F(SequencedWorkerPoolTest, Sequence) {
+TEST_P(SequencedWorkerPoolTest, Sequence) {
   // Fill all the worker threads except one.
   const size_t kNumBackgroundTasks = kNumWorkerThreads - 1;
   ThreadBlocker background_blocker;
@@ -453,7 +459,7 @@ TEST_F(SequencedWorkerPoolTest, Sequence) {
 
 // Tests that any tasks posted after Shutdown are ignored.
 // Disabled for flakiness.  See http://crbug.com/166451.
-TEST_F(SequencedWorkerPoolTest, DISABLED_IgnoresAfterShutdown) {
+TEST_P(SequencedWorkerPoolTest, DISABLED_IgnoresAfterShutdown) {
   // Start tasks to take all the threads and block them.
   EnsureAllWorkersCreated();
   ThreadBlocker blocker;
@@ -502,7 +508,7 @@ TEST_F(SequencedWorkerPoolTest, DISABLED_IgnoresAfterShutdown) {
   ASSERT_EQ(old_has_work_call_count, has_work_call_count());
 }
 
-TEST_F(SequencedWorkerPoolTest, AllowsAfterShutdown) {
+TEST_P(SequencedWorkerPoolTest, AllowsAfterShutdown) {
   // Test that <n> new blocking tasks are allowed provided they're posted
   // by a running tasks.
   EnsureAllWorkersCreated();
@@ -549,7 +555,7 @@ TEST_F(SequencedWorkerPoolTest, AllowsAfterShutdown) {
 
 // Tests that unrun tasks are discarded properly according to their shutdown
 // mode.
-TEST_F(SequencedWorkerPoolTest, DiscardOnShutdown) {
+TEST_P(SequencedWorkerPoolTest, DiscardOnShutdown) {
   // Start tasks to take all the threads and block them.
   EnsureAllWorkersCreated();
   ThreadBlocker blocker;
@@ -595,7 +601,7 @@ TEST_F(SequencedWorkerPoolTest, DiscardOnShutdown) {
 }
 
 // Tests that CONTINUE_ON_SHUTDOWN tasks don't block shutdown.
-TEST_F(SequencedWorkerPoolTest, ContinueOnShutdown) {
+TEST_P(SequencedWorkerPoolTest, ContinueOnShutdown) {
   scoped_refptr<TaskRunner> runner(pool()->GetTaskRunnerWithShutdownBehavior(
       SequencedWorkerPool::CONTINUE_ON_SHUTDOWN));
   scoped_refptr<SequencedTaskRunner> sequenced_runner(
@@ -643,7 +649,7 @@ TEST_F(SequencedWorkerPoolTest, ContinueOnShutdown) {
 
 // Tests that SKIP_ON_SHUTDOWN tasks that have been started block Shutdown
 // until they stop, but tasks not yet started do not.
-TEST_F(SequencedWorkerPoolTest, SkipOnShutdown) {
+TEST_P(SequencedWorkerPoolTest, SkipOnShutdown) {
   // Start tasks to take all the threads and block them.
   EnsureAllWorkersCreated();
   ThreadBlocker blocker;
@@ -696,7 +702,7 @@ TEST_F(SequencedWorkerPoolTest, SkipOnShutdown) {
 // Ensure all worker threads are created, and then trigger a spurious
 // work signal. This shouldn't cause any other work signals to be
 // triggered. This is a regression test for http://crbug.com/117469.
-TEST_F(SequencedWorkerPoolTest, SpuriousWorkSignal) {
+TEST_P(SequencedWorkerPoolTest, SpuriousWorkSignal) {
   EnsureAllWorkersCreated();
   int old_has_work_call_count = has_work_call_count();
   pool()->SignalHasWorkForTesting();
@@ -721,13 +727,13 @@ void IsRunningOnCurrentThreadTask(
 }
 
 // Verify correctness of the IsRunningSequenceOnCurrentThread method.
-TEST_F(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
+TEST_P(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
   SequencedWorkerPool::SequenceToken token1 = pool()->GetSequenceToken();
   SequencedWorkerPool::SequenceToken token2 = pool()->GetSequenceToken();
   SequencedWorkerPool::SequenceToken unsequenced_token;
 
   scoped_refptr<SequencedWorkerPool> unused_pool =
-      new SequencedWorkerPool(2, "unused_pool");
+      new SequencedWorkerPool(2, "unused_pool", GetParam(), NULL);
 
   EXPECT_FALSE(pool()->RunsTasksOnCurrentThread());
   EXPECT_FALSE(pool()->IsRunningSequenceOnCurrentThread(token1));
@@ -756,7 +762,7 @@ TEST_F(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
 }
 
 // Verify that FlushForTesting works as intended.
-TEST_F(SequencedWorkerPoolTest, FlushForTesting) {
+TEST_P(SequencedWorkerPoolTest, FlushForTesting) {
   // Should be fine to call on a new instance.
   pool()->FlushForTesting();
 
@@ -796,6 +802,126 @@ TEST_F(SequencedWorkerPoolTest, FlushForTesting) {
   pool()->FlushForTesting();
 }
 
+// Checks that tasks of one sequence never overlap and run in posting order.
+class SequenceChecker : public base::RefCountedThreadSafe<SequenceChecker> {
+ public:
+  SequenceChecker() : running_(0), last_task_(-1), failures_(0) {}
+
+  void Run(int task_number) {
+    if (subtle::NoBarrier_AtomicIncrement(&running_, 1) != 1)
+      subtle::NoBarrier_AtomicIncrement(&failures_, 1);
+    if (task_number != last_task_ + 1)
+      subtle::NoBarrier_AtomicIncrement(&failures_, 1);
+    last_task_ = task_number;
+    subtle::NoBarrier_AtomicIncrement(&running_, -1);
+  }
+
+  int last_task() const { return last_task_; }
+  int failures() const { return subtle::NoBarrier_Load(&failures_); }
+
+ private:
+  friend class base::RefCountedThreadSafe<SequenceChecker>;
+  ~SequenceChecker() {}
+
+  subtle::Atomic32 running_;
+  int last_task_;
+  subtle::Atomic32 failures_;
+};
+
+void IncrementCounter(subtle::Atomic32* counter) {
+  subtle::NoBarrier_AtomicIncrement(counter, 1);
+}
+
+// Posts |num_tasks| tasks to |pool|. If |checker| is non-NULL, the tasks are
+// posted with |token| and verified by |checker|, otherwise they increment
+// |counter|.
+void PostTasksFromThread(SequencedWorkerPool* pool,
+                         SequencedWorkerPool::SequenceToken token,
+                         scoped_refptr<SequenceChecker> checker,
+                         subtle::Atomic32* counter,
+                         int num_tasks) {
+  for (int i = 0; i < num_tasks; ++i) {
+    if (checker.get()) {
+      pool->PostSequencedWorkerTask(
+          token, FROM_HERE, base::Bind(&SequenceChecker::Run, checker, i));
+    } else {
+      pool->PostWorkerTask(FROM_HERE, base::Bind(&IncrementCounter, counter));
+    }
+  }
+}
+
+// Posts sequenced tasks from several threads at once and verifies that each
+// sequence still runs in order, one task at a time.
+TEST_P(SequencedWorkerPoolTest, SequencesFromManyThreads) {
+  const size_t kNumSequences = 2 * kNumWorkerThreads;
+  const int kTasksPerSequence = 200;
+
+  ScopedVector<Thread> posters;
+  std::vector<scoped_refptr<SequenceChecker> > checkers;
+  for (size_t i = 0; i < kNumSequences; ++i) {
+    checkers.push_back(new SequenceChecker);
+    posters.push_back(new Thread("SequencePoster"));
+    ASSERT_TRUE(posters.back()->Start());
+    posters.back()->message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&PostTasksFromThread, pool(), pool()->GetSequenceToken(),
+                   checkers.back(), static_cast<subtle::Atomic32*>(NULL),
+                   kTasksPerSequence));
+  }
+  for (size_t i = 0; i < posters.size(); ++i)
+    posters[i]->Stop();
+  pool()->FlushForTesting();
+
+  for (size_t i = 0; i < checkers.size(); ++i) {
+    EXPECT_EQ(0, checkers[i]->failures());
+    EXPECT_EQ(kTasksPerSequence - 1, checkers[i]->last_task());
+  }
+}
+
+// Measures how fast the pool runs short unsequenced tasks posted by several
+// threads at once, to compare the scheduling modes.
+TEST_P(SequencedWorkerPoolTest, PostTaskThroughput) {
+  const int kNumPosters = 4;
+  const int kTasksPerPoster = 10000;
+  EnsureAllWorkersCreated();
+
+  subtle::Atomic32 counter = 0;
+  ScopedVector<Thread> posters;
+  for (int i = 0; i < kNumPosters; ++i) {
+    posters.push_back(new Thread("ThroughputPoster"));
+    ASSERT_TRUE(posters.back()->Start());
+  }
+
+  const TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumPosters; ++i) {
+    posters[i]->message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&PostTasksFromThread, pool(),
+                   SequencedWorkerPool::SequenceToken(),
+                   scoped_refptr<SequenceChecker>(), &counter,
+                   kTasksPerPoster));
+  }
+  for (int i = 0; i < kNumPosters; ++i)
+    posters[i]->Stop();
+  pool()->FlushForTesting();
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  EXPECT_EQ(kNumPosters * kTasksPerPoster, subtle::NoBarrier_Load(&counter));
+  perf_test::PrintResult(
+      "sequenced_worker_pool_throughput", "",
+      GetParam() == SequencedWorkerPool::WORK_STEALING ? "work_stealing"
+                                                       : "global_queue",
+      kNumPosters * kTasksPerPoster / std::max(elapsed.InSecondsF(), 1e-6),
+      "tasks/s", true);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    GlobalQueue, SequencedWorkerPoolTest,
+    testing::Values(SequencedWorkerPool::GLOBAL_QUEUE));
+INSTANTIATE_TEST_CASE_P(
+    WorkStealing, SequencedWorkerPoolTest,
+    testing::Values(SequencedWorkerPool::WORK_STEALING));
+
 TEST(SequencedWorkerPoolRefPtrTest, ShutsDownCleanWithContinueOnShutdown) {
   MessageLoop loop;
   scoped_refptr<SequencedWorkerPool> pool(new SequencedWorkerPool(3, "Pool"));
@@ -808,6 +934,7 @@ TEST(SequencedWorkerPoolRefPtrTest, ShutsDownCleanWithContinueOnShutdown) {
   pool->Shutdown();
 }
 
+template <SequencedWorkerPool::SchedulingMode kSchedulingMode>
 class SequencedWorkerPoolTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerTestDelegate() {}
@@ -816,7 +943,8 @@ class SequencedWorkerPoolTaskRunnerTestDelegate {
 
   void StartTaskRunner() {
     pool_owner_.reset(
-        new SequencedWorkerPoolOwner(10, "SequencedWorkerPoolTaskRunnerTest"));
+        new SequencedWorkerPoolOwner(10, "SequencedWorkerPoolTaskRunnerTest",
+                                     kSchedulingMode));
   }
 
   scoped_refptr<SequencedWorkerPool> GetTaskRunner() {
@@ -837,10 +965,16 @@ class SequencedWorkerPoolTaskRunnerTestDelegate {
   scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
 };
 
+typedef testing::Types<
+    SequencedWorkerPoolTaskRunnerTestDelegate<SequencedWorkerPool::GLOBAL_QUEUE>,
+    SequencedWorkerPoolTaskRunnerTestDelegate<
+        SequencedWorkerPool::WORK_STEALING> >
+    SequencedWorkerPoolTaskRunnerTestDelegates;
 INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPool, TaskRunnerTest,
-    SequencedWorkerPoolTaskRunnerTestDelegate);
+    SequencedWorkerPoolTaskRunnerTestDelegates);
 
+template <SequencedWorkerPool::SchedulingMode kSchedulingMode>
 class SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate() {}
@@ -850,7 +984,8 @@ class SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate {
 
   void StartTaskRunner() {
     pool_owner_.reset(
-        new SequencedWorkerPoolOwner(10, "SequencedWorkerPoolTaskRunnerTest"));
+        new SequencedWorkerPoolOwner(10, "SequencedWorkerPoolTaskRunnerTest",
+                                     kSchedulingMode));
     task_runner_ = pool_owner_->pool()->GetTaskRunnerWithShutdownBehavior(
         SequencedWorkerPool::BLOCK_SHUTDOWN);
   }
@@ -874,10 +1009,17 @@ class SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate {
   scoped_refptr<TaskRunner> task_runner_;
 };
 
+typedef testing::Types<
+    SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate<
+        SequencedWorkerPool::GLOBAL_QUEUE>,
+    SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate<
+        SequencedWorkerPool::WORK_STEALING> >
+    SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegates;
 INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPoolTaskRunner, TaskRunnerTest,
-    SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegate);
+    SequencedWorkerPoolTaskRunnerWithShutdownBehaviorTestDelegates);
 
+template <SequencedWorkerPool::SchedulingMode kSchedulingMode>
 class SequencedWorkerPoolSequencedTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolSequencedTaskRunnerTestDelegate() {}
@@ -887,7 +1029,7 @@ class SequencedWorkerPoolSequencedTaskRunnerTestDelegate {
 
   void StartTaskRunner() {
     pool_owner_.reset(new SequencedWorkerPoolOwner(
-        10, "SequencedWorkerPoolSequencedTaskRunnerTest"));
+        10, "SequencedWorkerPoolSequencedTaskRunnerTest", kSchedulingMode));
     task_runner_ = pool_owner_->pool()->GetSequencedTaskRunner(
         pool_owner_->pool()->GetSequenceToken());
   }
@@ -911,13 +1053,20 @@ class SequencedWorkerPoolSequencedTaskRunnerTestDelegate {
   scoped_refptr<SequencedTaskRunner> task_runner_;
 };
 
+typedef testing::Types<
+    SequencedWorkerPoolSequencedTaskRunnerTestDelegate<
+        SequencedWorkerPool::GLOBAL_QUEUE>,
+    SequencedWorkerPoolSequencedTaskRunnerTestDelegate<
+        SequencedWorkerPool::WORK_STEALING> >
+    SequencedWorkerPoolSequencedTaskRunnerTestDelegates;
+
 INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPoolSequencedTaskRunner, TaskRunnerTest,
-    SequencedWorkerPoolSequencedTaskRunnerTestDelegate);
+    SequencedWorkerPoolSequencedTaskRunnerTestDelegates);
 
 INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPoolSequencedTaskRunner, SequencedTaskRunnerTest,
-    SequencedWorkerPoolSequencedTaskRunnerTestDelegate);
+    SequencedWorkerPoolSequencedTaskRunnerTestDelegates);
 
 }  // namespace
 
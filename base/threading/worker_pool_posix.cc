@@ -98,7 +98,11 @@ void WorkerThread::ThreadMain() {
     TrackedTime start_time =
         tracked_objects::ThreadData::NowForStartOfRun(pending_task.birth_tally);
 
-    pending_task.task.Run();
+    {
+      tracked_objects::ScopedRunningTask running_task(
+          pending_task.posted_from);
+      pending_task.task.Run();
+    }
 
     tracked_objects::ThreadData::TallyRunOnWorkerThreadIfTracking(
         pending_task.birth_tally, TrackedTime(pending_task.time_posted),
@@ -80,6 +80,15 @@ inline bool IsProfilerTimingEnabled() {
   return current_timing_enabled == ENABLED_TIMING;
 }
 
+// Where the task running on each thread was posted from, for
+// ScopedRunningTask. Initialized by ScopedRunningTask::EnableRecording().
+base::ThreadLocalStorage::StaticSlot tls_running_task_location =
+    TLS_INITIALIZER;
+
+// Serializes the initialization of |tls_running_task_location|.
+base::LazyInstance<base::Lock>::Leaky g_running_task_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 //------------------------------------------------------------------------------
@@ -898,4 +907,36 @@ ProcessDataSnapshot::ProcessDataSnapshot()
 ProcessDataSnapshot::~ProcessDataSnapshot() {
 }
 
+//------------------------------------------------------------------------------
+// ScopedRunningTask
+
+ScopedRunningTask::ScopedRunningTask(const Location& posted_from)
+    : recording_(tls_running_task_location.initialized()),
+      previous_location_(NULL) {
+  if (!recording_)
+    return;
+  previous_location_ =
+      static_cast<const Location*>(tls_running_task_location.Get());
+  tls_running_task_location.Set(const_cast<Location*>(&posted_from));
+}
+
+ScopedRunningTask::~ScopedRunningTask() {
+  if (recording_)
+    tls_running_task_location.Set(const_cast<Location*>(previous_location_));
+}
+
+// static
+void ScopedRunningTask::EnableRecording() {
+  base::AutoLock lock(g_running_task_lock.Get());
+  if (!tls_running_task_location.initialized())
+    tls_running_task_location.Initialize(NULL);
+}
+
+// static
+const Location* ScopedRunningTask::GetCurrentLocation() {
+  if (!tls_running_task_location.initialized())
+    return NULL;
+  return static_cast<const Location*>(tls_running_task_location.Get());
+}
+
 }  // namespace tracked_objects
@@ -717,6 +717,36 @@ struct BASE_EXPORT ProcessDataSnapshot {
   int process_id;
 };
 
+//------------------------------------------------------------------------------
+// Makes the Location a task was posted from available while the task runs,
+// so that a sampling profiler can attribute the samples it takes on a thread
+// to the code that posted the task. Scopes nest, for tasks run by nested
+// message loops.
+
+class BASE_EXPORT ScopedRunningTask {
+ public:
+  // |posted_from| must outlive the scope.
+  explicit ScopedRunningTask(const Location& posted_from);
+  ~ScopedRunningTask();
+
+  // Starts recording the running tasks. Until then, scopes only cost a check
+  // of a flag. Recording can't be stopped.
+  static void EnableRecording();
+
+  // Returns where the task running on the current thread was posted from, or
+  // NULL if no task is running or recording is off. Only reads thread-local
+  // storage, so it may be called from a signal handler on the thread.
+  static const Location* GetCurrentLocation();
+
+ private:
+  // Whether this scope set the current location, so that it must restore
+  // |previous_location_|.
+  bool recording_;
+  const Location* previous_location_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedRunningTask);
+};
+
 }  // namespace tracked_objects
 
 #endif  // BASE_TRACKED_OBJECTS_H_
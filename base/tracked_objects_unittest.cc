@@ -581,4 +581,24 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+TEST_F(TrackedObjectsTest, ScopedRunningTask) {
+  const char kFunction[] = "ScopedRunningTask";
+  Location outer(kFunction, kFile, kLineNumber, NULL);
+  Location inner(kFunction, kFile, kLineNumber + 1, NULL);
+
+  ScopedRunningTask::EnableRecording();
+  EXPECT_EQ(NULL, ScopedRunningTask::GetCurrentLocation());
+  {
+    ScopedRunningTask outer_task(outer);
+    EXPECT_EQ(&outer, ScopedRunningTask::GetCurrentLocation());
+    {
+      // A task run by a nested message loop.
+      ScopedRunningTask inner_task(inner);
+      EXPECT_EQ(&inner, ScopedRunningTask::GetCurrentLocation());
+    }
+    EXPECT_EQ(&outer, ScopedRunningTask::GetCurrentLocation());
+  }
+  EXPECT_EQ(NULL, ScopedRunningTask::GetCurrentLocation());
+}
+
 }  // namespace tracked_objects
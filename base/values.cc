@@ -11,6 +11,7 @@
 
 #include "base/float_util.h"
 #include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/move.h"
 #include "base/strings/string_util.h"
@@ -63,6 +64,15 @@ Value* CopyWithoutEmptyChildren(const Value* node) {
   }
 }
 
+// Orders the entries of a DictionaryValue by key, and an entry against a key
+// for std::lower_bound.
+struct EntryKeyLess {
+  bool operator()(const std::pair<std::string, Value*>& entry,
+                  const std::string& key) const {
+    return entry.first < key;
+  }
+};
+
 // A small functor for comparing Values for std::find_if and similar.
 class ValueEquals {
  public:
@@ -79,8 +89,19 @@ class ValueEquals {
   const Value* first_;
 };
 
+LazyInstance<allocator::Partition,
+             allocator::PartitionTraits<ValuePartition> >
+    g_value_partition = LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
+const char ValuePartition::kName[] = "values";
+
+// static
+allocator::Partition* ValuePartition::Get() {
+  return g_value_partition.Pointer();
+}
+
 Value::~Value() {
 }
 
@@ -381,13 +402,13 @@ bool DictionaryValue::GetAsDictionary(const DictionaryValue** out_value) const {
 
 bool DictionaryValue::HasKey(const std::string& key) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator current_entry = dictionary_.find(key);
+  Storage::const_iterator current_entry = Find(key);
   DCHECK((current_entry == dictionary_.end()) || current_entry->second);
   return current_entry != dictionary_.end();
 }
 
 void DictionaryValue::Clear() {
-  ValueMap::iterator dict_iterator = dictionary_.begin();
+  Storage::iterator dict_iterator = dictionary_.begin();
   while (dict_iterator != dictionary_.end()) {
     delete dict_iterator->second;
     ++dict_iterator;
@@ -446,12 +467,19 @@ void DictionaryValue::SetWithoutPathExpansion(const std::string& key,
                                               Value* in_value) {
   // If there's an existing value here, we need to delete it, because
   // we own all our children.
-  std::pair<ValueMap::iterator, bool> ins_res =
-      dictionary_.insert(std::make_pair(key, in_value));
-  if (!ins_res.second) {
-    DCHECK_NE(ins_res.first->second, in_value);  // This would be bogus
-    delete ins_res.first->second;
-    ins_res.first->second = in_value;
+  // Keys are usually added in order, so check the end first.
+  if (dictionary_.empty() || dictionary_.back().first < key) {
+    dictionary_.push_back(Entry(key, in_value));
+    return;
+  }
+
+  Storage::iterator entry = LowerBound(key);
+  if (entry == dictionary_.end() || entry->first != key) {
+    dictionary_.insert(entry, Entry(key, in_value));
+  } else {
+    DCHECK_NE(entry->second, in_value);  // This would be bogus
+    delete entry->second;
+    entry->second = in_value;
   }
 }
 
@@ -628,7 +656,7 @@ bool DictionaryValue::GetList(const std::string& path, ListValue** out_value) {
 bool DictionaryValue::GetWithoutPathExpansion(const std::string& key,
                                               const Value** out_value) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator entry_iterator = dictionary_.find(key);
+  Storage::const_iterator entry_iterator = Find(key);
   if (entry_iterator == dictionary_.end())
     return false;
 
@@ -757,8 +785,8 @@ bool DictionaryValue::Remove(const std::string& path,
 bool DictionaryValue::RemoveWithoutPathExpansion(const std::string& key,
                                                  scoped_ptr<Value>* out_value) {
   DCHECK(IsStringUTF8(key));
-  ValueMap::iterator entry_iterator = dictionary_.find(key);
-  if (entry_iterator == dictionary_.end())
+  Storage::iterator entry_iterator = LowerBound(key);
+  if (entry_iterator == dictionary_.end() || entry_iterator->first != key)
     return false;
 
   Value* entry = entry_iterator->second;
@@ -818,22 +846,43 @@ void DictionaryValue::Swap(DictionaryValue* other) {
 
 DictionaryValue::Iterator::Iterator(const DictionaryValue& target)
     : target_(target),
-      it_(target.dictionary_.begin()) {}
+      index_(0) {}
 
 DictionaryValue::Iterator::~Iterator() {}
 
 DictionaryValue* DictionaryValue::DeepCopy() const {
   DictionaryValue* result = new DictionaryValue;
 
-  for (ValueMap::const_iterator current_entry(dictionary_.begin());
+  result->dictionary_.reserve(dictionary_.size());
+  for (Storage::const_iterator current_entry(dictionary_.begin());
        current_entry != dictionary_.end(); ++current_entry) {
-    result->SetWithoutPathExpansion(current_entry->first,
-                                    current_entry->second->DeepCopy());
+    result->dictionary_.push_back(
+        Entry(current_entry->first, current_entry->second->DeepCopy()));
   }
 
   return result;
 }
 
+DictionaryValue::Storage::iterator DictionaryValue::LowerBound(
+    const std::string& key) {
+  return std::lower_bound(dictionary_.begin(), dictionary_.end(), key,
+                          EntryKeyLess());
+}
+
+DictionaryValue::Storage::const_iterator DictionaryValue::LowerBound(
+    const std::string& key) const {
+  return std::lower_bound(dictionary_.begin(), dictionary_.end(), key,
+                          EntryKeyLess());
+}
+
+DictionaryValue::Storage::const_iterator DictionaryValue::Find(
+    const std::string& key) const {
+  Storage::const_iterator entry = LowerBound(key);
+  if (entry != dictionary_.end() && entry->first != key)
+    return dictionary_.end();
+  return entry;
+}
+
 bool DictionaryValue::Equals(const Value* other) const {
   if (other->GetType() != GetType())
     return false;
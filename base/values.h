@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/allocator/partition_allocator.h"
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
@@ -40,14 +41,21 @@ class StringValue;
 class Value;
 
 typedef std::vector<Value*> ValueVector;
-typedef std::map<std::string, Value*> ValueMap;
+
+// Values are allocated in a partition of their own, as trees of them are
+// built and torn down all the time in the browser.
+struct BASE_EXPORT ValuePartition {
+  static const char kName[];
+  static allocator::Partition* Get();
+};
 
 // The Value class is the base class for Values. A Value can be instantiated
 // via the Create*Value() factory methods, or by directly creating instances of
 // the subclasses.
 //
 // See the file-level comment above for more information.
-class BASE_EXPORT Value {
+class BASE_EXPORT Value
+    : public allocator::PartitionAllocated<ValuePartition> {
  public:
   enum Type {
     TYPE_NULL = 0,
@@ -206,6 +214,12 @@ class BASE_EXPORT BinaryValue: public Value {
 // DictionaryValue provides a key-value dictionary with (optional) "path"
 // parsing for recursive access; see the comment at the top of the file. Keys
 // are |std::string|s and should be UTF-8 encoded.
+//
+// The entries are kept in a vector sorted by key, which takes about half the
+// memory of a std::map and one allocation instead of one per entry. Lookups
+// are binary searches; insertions and removals move the entries after them,
+// but entries added in key order, as by the JSON parser on JSON written by
+// JSONWriter, and by DeepCopy(), are appended.
 class BASE_EXPORT DictionaryValue : public Value {
  public:
   DictionaryValue();
@@ -351,15 +365,15 @@ class BASE_EXPORT DictionaryValue : public Value {
     explicit Iterator(const DictionaryValue& target);
     ~Iterator();
 
-    bool IsAtEnd() const { return it_ == target_.dictionary_.end(); }
-    void Advance() { ++it_; }
+    bool IsAtEnd() const { return index_ == target_.dictionary_.size(); }
+    void Advance() { ++index_; }
 
-    const std::string& key() const { return it_->first; }
-    const Value& value() const { return *it_->second; }
+    const std::string& key() const { return target_.dictionary_[index_].first; }
+    const Value& value() const { return *target_.dictionary_[index_].second; }
 
    private:
     const DictionaryValue& target_;
-    ValueMap::const_iterator it_;
+    size_t index_;
   };
 
   // Overridden from Value:
@@ -367,7 +381,17 @@ class BASE_EXPORT DictionaryValue : public Value {
   virtual bool Equals(const Value* other) const OVERRIDE;
 
  private:
-  ValueMap dictionary_;
+  typedef std::pair<std::string, Value*> Entry;
+  typedef std::vector<Entry> Storage;
+
+  // Returns the entry for |key|, or where it would be inserted.
+  Storage::iterator LowerBound(const std::string& key);
+  Storage::const_iterator LowerBound(const std::string& key) const;
+
+  // Returns the entry for |key|, or dictionary_.end().
+  Storage::const_iterator Find(const std::string& key) const;
+
+  Storage dictionary_;
 
   DISALLOW_COPY_AND_ASSIGN(DictionaryValue);
 };
@@ -5,10 +5,18 @@
 #include <limits>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/strings/string16.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
+#include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <malloc.h>
+#endif
 
 namespace base {
 
@@ -809,4 +817,84 @@ TEST(ValuesTest, DictionaryIterator) {
   EXPECT_TRUE(seen2);
 }
 
+TEST(ValuesTest, DictionaryKeyOrder) {
+  DictionaryValue dict;
+  const char* const keys[] = {"m", "c", "x", "a", "q", "b", "z"};
+  for (size_t i = 0; i < arraysize(keys); ++i)
+    dict.SetInteger(keys[i], static_cast<int>(i));
+  EXPECT_EQ(arraysize(keys), dict.size());
+
+  // Iteration is in key order, whatever the order of insertion.
+  std::string order;
+  for (DictionaryValue::Iterator it(dict); !it.IsAtEnd(); it.Advance())
+    order += it.key();
+  EXPECT_EQ("abcmqxz", order);
+
+  // Replacing doesn't add an entry.
+  dict.SetString("c", "replaced");
+  EXPECT_EQ(arraysize(keys), dict.size());
+  std::string value;
+  EXPECT_TRUE(dict.GetString("c", &value));
+  EXPECT_EQ("replaced", value);
+
+  EXPECT_TRUE(dict.RemoveWithoutPathExpansion("m", NULL));
+  EXPECT_FALSE(dict.RemoveWithoutPathExpansion("m", NULL));
+  EXPECT_FALSE(dict.RemoveWithoutPathExpansion("n", NULL));
+  EXPECT_FALSE(dict.HasKey("m"));
+  int result = 0;
+  EXPECT_TRUE(dict.GetInteger("q", &result));
+  EXPECT_EQ(4, result);
+  EXPECT_TRUE(dict.GetInteger("a", &result));
+  EXPECT_EQ(3, result);
+  EXPECT_TRUE(dict.GetInteger("z", &result));
+  EXPECT_EQ(6, result);
+
+  // Keys that are prefixes of each other are distinct.
+  dict.SetBoolean("ab", true);
+  dict.SetBoolean("", false);
+  order.clear();
+  for (DictionaryValue::Iterator it(dict); !it.IsAtEnd(); it.Advance())
+    order += " " + it.key();
+  EXPECT_EQ("  a ab b c q x z", order);
+  EXPECT_TRUE(dict.HasKey(""));
+  EXPECT_TRUE(dict.HasKey("ab"));
+
+  scoped_ptr<DictionaryValue> copy(dict.DeepCopy());
+  EXPECT_TRUE(dict.Equals(copy.get()));
+}
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+// Reports the heap memory taken by dictionaries of the sizes typical of
+// preferences trees.
+TEST(ValuesTest, DictionaryMemoryUsage) {
+  const size_t kEntryCounts[] = {4, 32, 1000};
+  const size_t kDictionaries = 1000;
+
+  for (size_t i = 0; i < arraysize(kEntryCounts); ++i) {
+    // Keys are created up front, to only account for the dictionaries.
+    std::vector<std::string> keys;
+    for (size_t j = 0; j < kEntryCounts[i]; ++j)
+      keys.push_back(StringPrintf("preference_%d", static_cast<int>(j)));
+
+    const size_t before = mallinfo().uordblks;
+    ScopedVector<DictionaryValue> dictionaries;
+    for (size_t j = 0; j < kDictionaries; ++j) {
+      DictionaryValue* dict = new DictionaryValue;
+      for (size_t k = 0; k < keys.size(); ++k)
+        dict->SetIntegerWithoutPathExpansion(keys[k], static_cast<int>(k));
+      dictionaries.push_back(dict);
+    }
+    const size_t after = mallinfo().uordblks;
+
+    EXPECT_EQ(kEntryCounts[i], dictionaries.back()->size());
+    perf_test::PrintResult(
+        "dictionary_value_memory", "",
+        StringPrintf("%d_entries", static_cast<int>(kEntryCounts[i])),
+        static_cast<double>(after - before) /
+            (kDictionaries * kEntryCounts[i]),
+        "bytes/entry", true);
+  }
+}
+#endif  // defined(OS_LINUX) || defined(OS_ANDROID)
+
 }  // namespace base
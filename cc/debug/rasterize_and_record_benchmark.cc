@@ -22,6 +22,12 @@ namespace {
 
 const int kDefaultRecordRepeatCount = 100;
 
+// Upper bounds of the recording time histogram buckets. Pictures slower than
+// the last bound go into one final overflow bucket.
+const double kRecordTimeHistogramBoundsMs[] = {
+  0.1, 0.25, 0.5, 1, 2, 4, 8, 16
+};
+
 base::TimeTicks Now() {
   return base::TimeTicks::IsThreadNowSupported()
              ? base::TimeTicks::ThreadNow()
@@ -63,6 +69,8 @@ void RasterizeAndRecordBenchmark::DidUpdateLayers(LayerTreeHost* host) {
   results_->SetInteger("pixels_recorded", record_results_.pixels_recorded);
   results_->SetDouble("record_time_ms",
                       record_results_.total_best_time.InMillisecondsF());
+  results_->Set("record_time_histogram",
+                record_results_.TimeHistogramAsValue().release());
   main_thread_benchmark_done_ = true;
 }
 
@@ -131,12 +139,39 @@ void RasterizeAndRecordBenchmark::RunOnLayer(PictureLayer* layer) {
 
   record_results_.pixels_recorded +=
       visible_content_rect.width() * visible_content_rect.height();
-  record_results_.total_best_time += min_time;
+  record_results_.AddPicture(min_time);
 }
 
 RasterizeAndRecordBenchmark::RecordResults::RecordResults()
-    : pixels_recorded(0) {}
+    : pixels_recorded(0),
+      time_histogram(arraysize(kRecordTimeHistogramBoundsMs) + 1, 0) {}
 
 RasterizeAndRecordBenchmark::RecordResults::~RecordResults() {}
 
+void RasterizeAndRecordBenchmark::RecordResults::AddPicture(
+    base::TimeDelta best_time) {
+  total_best_time += best_time;
+
+  double time_ms = best_time.InMillisecondsF();
+  size_t bucket = 0;
+  while (bucket < arraysize(kRecordTimeHistogramBoundsMs) &&
+         time_ms >= kRecordTimeHistogramBoundsMs[bucket])
+    ++bucket;
+  time_histogram[bucket]++;
+}
+
+scoped_ptr<base::ListValue>
+RasterizeAndRecordBenchmark::RecordResults::TimeHistogramAsValue() const {
+  scoped_ptr<base::ListValue> histogram(new base::ListValue);
+  for (size_t i = 0; i < time_histogram.size(); ++i) {
+    scoped_ptr<base::DictionaryValue> bucket(new base::DictionaryValue);
+    // The last bucket has no upper bound.
+    if (i < arraysize(kRecordTimeHistogramBoundsMs))
+      bucket->SetDouble("max_time_ms", kRecordTimeHistogramBoundsMs[i]);
+    bucket->SetInteger("count", time_histogram[i]);
+    histogram->Append(bucket.release());
+  }
+  return histogram.Pass();
+}
+
 }  // namespace cc
@@ -15,6 +15,7 @@
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace cc {
@@ -44,8 +45,14 @@ class RasterizeAndRecordBenchmark : public MicroBenchmark {
     RecordResults();
     ~RecordResults();
 
+    void AddPicture(base::TimeDelta best_time);
+    scoped_ptr<base::ListValue> TimeHistogramAsValue() const;
+
     int pixels_recorded;
     base::TimeDelta total_best_time;
+    // Number of pictures whose best recording time fell in each of the
+    // buckets bounded by kRecordTimeHistogramBoundsMs.
+    std::vector<int> time_histogram;
   };
 
   RecordResults record_results_;
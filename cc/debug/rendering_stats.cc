@@ -33,7 +33,10 @@ void MainThreadRenderingStats::Add(const MainThreadRenderingStats& other) {
 
 ImplThreadRenderingStats::ImplThreadRenderingStats()
     : frame_count(0),
-      rasterized_pixel_count(0) {}
+      rasterized_pixel_count(0),
+      gpu_rasterized_pixel_count(0),
+      etc1_encoded_pixel_count(0),
+      image_rasterized_pixel_count(0) {}
 
 scoped_refptr<base::debug::ConvertableToTraceFormat>
 ImplThreadRenderingStats::AsTraceableData() const {
@@ -41,6 +44,14 @@ ImplThreadRenderingStats::AsTraceableData() const {
   record_data->SetInteger("frame_count", frame_count);
   record_data->SetDouble("rasterize_time", rasterize_time.InSecondsF());
   record_data->SetInteger("rasterized_pixel_count", rasterized_pixel_count);
+  record_data->SetDouble("gpu_rasterize_time", gpu_rasterize_time.InSecondsF());
+  record_data->SetInteger("gpu_rasterized_pixel_count",
+                          gpu_rasterized_pixel_count);
+  record_data->SetDouble("etc1_encode_time", etc1_encode_time.InSecondsF());
+  record_data->SetInteger("etc1_encoded_pixel_count",
+                          etc1_encoded_pixel_count);
+  record_data->SetInteger("image_rasterized_pixel_count",
+                          image_rasterized_pixel_count);
   return TracedValue::FromValue(record_data.release());
 }
 
@@ -49,6 +60,11 @@ void ImplThreadRenderingStats::Add(const ImplThreadRenderingStats& other) {
   rasterize_time += other.rasterize_time;
   analysis_time += other.analysis_time;
   rasterized_pixel_count += other.rasterized_pixel_count;
+  gpu_rasterize_time += other.gpu_rasterize_time;
+  gpu_rasterized_pixel_count += other.gpu_rasterized_pixel_count;
+  etc1_encode_time += other.etc1_encode_time;
+  etc1_encoded_pixel_count += other.etc1_encoded_pixel_count;
+  image_rasterized_pixel_count += other.image_rasterized_pixel_count;
 }
 
 void RenderingStats::Add(const RenderingStats& other) {
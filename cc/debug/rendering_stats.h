@@ -35,6 +35,16 @@ struct CC_EXPORT ImplThreadRenderingStats {
   base::TimeDelta rasterize_time;
   base::TimeDelta analysis_time;
   int64 rasterized_pixel_count;
+  // The part of rasterize_time and rasterized_pixel_count spent on tiles
+  // rasterized with the GPU.
+  base::TimeDelta gpu_rasterize_time;
+  int64 gpu_rasterized_pixel_count;
+  // Time spent compressing rasterized tiles to ETC1, and their pixels.
+  base::TimeDelta etc1_encode_time;
+  int64 etc1_encoded_pixel_count;
+  // Pixels rasterized straight into GPU memory buffers (CHROMIUM_image),
+  // which need no upload through a pixel buffer.
+  int64 image_rasterized_pixel_count;
 
   ImplThreadRenderingStats();
   scoped_refptr<base::debug::ConvertableToTraceFormat> AsTraceableData() const;
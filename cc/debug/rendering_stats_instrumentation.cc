@@ -99,6 +99,16 @@ void RenderingStatsInstrumentation::AddRaster(base::TimeDelta duration,
   impl_stats_.rasterized_pixel_count += pixels;
 }
 
+void RenderingStatsInstrumentation::AddGpuRaster(base::TimeDelta duration,
+                                                 int64 pixels) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_stats_.gpu_rasterize_time += duration;
+  impl_stats_.gpu_rasterized_pixel_count += pixels;
+}
+
 void RenderingStatsInstrumentation::AddAnalysis(base::TimeDelta duration,
                                                 int64 pixels) {
   if (!record_rendering_stats_)
@@ -108,4 +118,22 @@ void RenderingStatsInstrumentation::AddAnalysis(base::TimeDelta duration,
   impl_stats_.analysis_time += duration;
 }
 
+void RenderingStatsInstrumentation::AddETC1Encode(base::TimeDelta duration,
+                                                  int64 pixels) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_stats_.etc1_encode_time += duration;
+  impl_stats_.etc1_encoded_pixel_count += pixels;
+}
+
+void RenderingStatsInstrumentation::AddImageRaster(int64 pixels) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_stats_.image_rasterized_pixel_count += pixels;
+}
+
 }  // namespace cc
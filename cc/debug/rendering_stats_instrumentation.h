@@ -52,7 +52,13 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void AddPaint(base::TimeDelta duration, int64 pixels);
   void AddRecord(base::TimeDelta duration, int64 pixels);
   void AddRaster(base::TimeDelta duration, int64 pixels);
+  // Records GPU rasterization. The same work must also be passed to
+  // AddRaster().
+  void AddGpuRaster(base::TimeDelta duration, int64 pixels);
   void AddAnalysis(base::TimeDelta duration, int64 pixels);
+  void AddETC1Encode(base::TimeDelta duration, int64 pixels);
+  // Records pixels rasterized directly into GPU memory buffers.
+  void AddImageRaster(int64 pixels);
 
  protected:
   RenderingStatsInstrumentation();
@@ -55,6 +55,12 @@ void DelegatedFrameProvider::SetFrameData(
   DCHECK(frame);
   DCHECK_NE(0u, frame->render_pass_list.size());
 
+  // Fill in passes the child left out because they were unchanged, so that
+  // |frame_| is always complete for observers that skipped earlier frames.
+  bool has_all_reused_passes = frame->TakeReusedQuadsFrom(frame_.get());
+  LOG_IF(ERROR, !has_all_reused_passes)
+      << "Frame reuses render passes not found in the previous frame.";
+
   if (frame_) {
     ReturnedResourceArray returned;
     TransferableResource::ReturnResources(frame_->resource_list, &returned);
@@ -61,6 +61,18 @@ class DelegatedFrameProviderTest
     frame->render_pass_list[0]->quad_list.push_back(quad.PassAs<DrawQuad>());
   }
 
+  // Inserts a non-root render pass before the root pass, so that quads added
+  // with AddTextureQuad() go into it.
+  void AddChildRenderPass(DelegatedFrameData* frame,
+                          RenderPass::Id id,
+                          bool reuses_previous_quads) {
+    scoped_ptr<RenderPass> pass(RenderPass::Create());
+    pass->SetNew(id, gfx::Rect(10, 10), gfx::RectF(), gfx::Transform());
+    pass->reuses_previous_quads = reuses_previous_quads;
+    frame->render_pass_list.insert(frame->render_pass_list.begin(),
+                                   pass.Pass());
+  }
+
   virtual void SetUp() OVERRIDE {
     resource_collection_ = new DelegatedFrameResourceCollection;
     resource_collection_->SetClient(this);
@@ -392,5 +404,50 @@ TEST_F(DelegatedFrameProviderTest, NothingReturnedAfterLoss) {
   EXPECT_EQ(0u, resources_.size());
 }
 
+TEST_F(DelegatedFrameProviderTest, ReusedRenderPassQuads) {
+  scoped_ptr<DelegatedFrameData> frame =
+      CreateFrameData(gfx::Rect(5, 5), gfx::Rect(5, 5));
+  AddChildRenderPass(frame.get(), RenderPass::Id(2, 1), false);
+  AddTextureQuad(frame.get(), 444);
+  AddTransferableResource(frame.get(), 444);
+  SetFrameProvider(frame.Pass());
+
+  scoped_refptr<DelegatedRendererLayer> observer =
+      DelegatedRendererLayer::Create(frame_provider_);
+  gfx::RectF damage;
+
+  // The child leaves out the quads of the unchanged pass, but still sends its
+  // resources.
+  frame = CreateFrameData(gfx::Rect(5, 5), gfx::Rect(1, 1));
+  AddChildRenderPass(frame.get(), RenderPass::Id(2, 1), true);
+  AddTransferableResource(frame.get(), 444);
+  frame_provider_->SetFrameData(frame.Pass());
+
+  // Observers always see a complete frame.
+  DelegatedFrameData* frame_data =
+      frame_provider_->GetFrameDataAndRefResources(observer, &damage);
+  ASSERT_EQ(2u, frame_data->render_pass_list.size());
+  RenderPass* pass = frame_data->render_pass_list[0];
+  EXPECT_FALSE(pass->reuses_previous_quads);
+  ASSERT_EQ(1u, pass->quad_list.size());
+  EXPECT_EQ(1u, pass->shared_quad_state_list.size());
+  EXPECT_EQ(pass->shared_quad_state_list[0],
+            pass->quad_list[0]->shared_quad_state);
+  EXPECT_EQ(444u,
+            TextureDrawQuad::MaterialCast(pass->quad_list[0])->resource_id);
+
+  // The resource stayed in use across the frames.
+  EXPECT_FALSE(ReturnAndResetResourcesAvailable());
+
+  // A pass that wasn't in the previous frame is left empty.
+  frame = CreateFrameData(gfx::Rect(5, 5), gfx::Rect(1, 1));
+  AddChildRenderPass(frame.get(), RenderPass::Id(3, 1), true);
+  frame_provider_->SetFrameData(frame.Pass());
+  frame_data = frame_provider_->GetFrameDataAndRefResources(observer, &damage);
+  ASSERT_EQ(2u, frame_data->render_pass_list.size());
+  EXPECT_FALSE(frame_data->render_pass_list[0]->reuses_previous_quads);
+  EXPECT_EQ(0u, frame_data->render_pass_list[0]->quad_list.size());
+}
+
 }  // namespace
 }  // namespace cc
@@ -0,0 +1,61 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/layers/draw_properties_store.h"
+
+#include <algorithm>
+
+#include "cc/layers/layer_impl.h"
+#include "cc/layers/layer_iterator.h"
+
+namespace cc {
+
+DrawPropertiesStore::DrawPropertiesStore() {}
+
+DrawPropertiesStore::~DrawPropertiesStore() {}
+
+void DrawPropertiesStore::Update(
+    const LayerImplList& render_surface_layer_list) {
+  Clear();
+
+  typedef LayerIterator<LayerImpl> LayerIteratorType;
+  LayerImpl* target = NULL;
+  int target_index = -1;
+  LayerIteratorType end = LayerIteratorType::End(&render_surface_layer_list);
+  for (LayerIteratorType it =
+           LayerIteratorType::Begin(&render_surface_layer_list);
+       it != end;
+       ++it) {
+    if (!it.represents_itself())
+      continue;
+
+    // There are far fewer surfaces than layers, and consecutive layers
+    // usually share a target, so only search when the target changes.
+    if (it.target_render_surface_layer() != target) {
+      target = it.target_render_surface_layer();
+      target_index = std::find(render_surface_layer_list.begin(),
+                               render_surface_layer_list.end(),
+                               target) -
+                     render_surface_layer_list.begin();
+    }
+
+    LayerImpl* layer = *it;
+    layers_.push_back(layer);
+    screen_space_transforms_.push_back(layer->screen_space_transform());
+    visible_content_rects_.push_back(layer->visible_content_rect());
+    opacities_.push_back(layer->draw_opacity());
+    render_target_indices_.push_back(target_index);
+  }
+}
+
+void DrawPropertiesStore::Clear() {
+  // clear() keeps the capacity, so rebuilding every frame doesn't reallocate.
+  layers_.clear();
+  screen_space_transforms_.clear();
+  visible_content_rects_.clear();
+  opacities_.clear();
+  render_target_indices_.clear();
+}
+
+}  // namespace cc
@@ -0,0 +1,68 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_LAYERS_DRAW_PROPERTIES_STORE_H_
+#define CC_LAYERS_DRAW_PROPERTIES_STORE_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "cc/layers/layer_lists.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/transform.h"
+
+namespace cc {
+
+class LayerImpl;
+
+// A contiguous copy of the draw properties that per-frame passes read most,
+// for every layer that draws itself into a render surface. Each property is
+// kept in its own array, indexed by the layer's position in the store, so
+// that a pass reading one or two properties for every layer walks memory
+// linearly instead of chasing one LayerImpl pointer per layer.
+//
+// Layers are stored in the order LayerIterator visits them, and only those
+// that represent themselves. The store is a snapshot: it must be rebuilt
+// whenever draw properties are recalculated.
+class CC_EXPORT DrawPropertiesStore {
+ public:
+  DrawPropertiesStore();
+  ~DrawPropertiesStore();
+
+  // Replaces the contents of the store with the layers drawn into the
+  // surfaces of |render_surface_layer_list|.
+  void Update(const LayerImplList& render_surface_layer_list);
+  void Clear();
+
+  size_t size() const { return layers_.size(); }
+  bool empty() const { return layers_.empty(); }
+
+  LayerImpl* layer(size_t index) const { return layers_[index]; }
+  const gfx::Transform& screen_space_transform(size_t index) const {
+    return screen_space_transforms_[index];
+  }
+  const gfx::Rect& visible_content_rect(size_t index) const {
+    return visible_content_rects_[index];
+  }
+  float opacity(size_t index) const { return opacities_[index]; }
+  // The index, in the render surface layer list the store was built from, of
+  // the surface the layer draws into.
+  int render_target_index(size_t index) const {
+    return render_target_indices_[index];
+  }
+
+ private:
+  std::vector<LayerImpl*> layers_;
+  std::vector<gfx::Transform> screen_space_transforms_;
+  std::vector<gfx::Rect> visible_content_rects_;
+  std::vector<float> opacities_;
+  std::vector<int> render_target_indices_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawPropertiesStore);
+};
+
+}  // namespace cc
+
+#endif  // CC_LAYERS_DRAW_PROPERTIES_STORE_H_
@@ -0,0 +1,106 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/layers/draw_properties_store.h"
+
+#include "cc/layers/layer_impl.h"
+#include "cc/test/fake_impl_proxy.h"
+#include "cc/test/fake_layer_tree_host_impl.h"
+#include "cc/test/geometry_test_utils.h"
+#include "cc/trees/layer_tree_host_common.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+scoped_ptr<LayerImpl> CreateDrawingLayer(LayerTreeImpl* tree_impl,
+                                         int id,
+                                         const gfx::PointF& position,
+                                         const gfx::Size& bounds) {
+  scoped_ptr<LayerImpl> layer = LayerImpl::Create(tree_impl, id);
+  layer->SetAnchorPoint(gfx::PointF());
+  layer->SetPosition(position);
+  layer->SetBounds(bounds);
+  layer->SetContentBounds(bounds);
+  layer->SetDrawsContent(true);
+  return layer.Pass();
+}
+
+// Returns the index of |layer| in |store|, or -1 if it isn't there.
+int IndexOf(const DrawPropertiesStore& store, const LayerImpl* layer) {
+  for (size_t i = 0; i < store.size(); ++i) {
+    if (store.layer(i) == layer)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+TEST(DrawPropertiesStoreTest, Empty) {
+  DrawPropertiesStore store;
+  LayerImplList render_surface_layer_list;
+  store.Update(render_surface_layer_list);
+  EXPECT_TRUE(store.empty());
+}
+
+TEST(DrawPropertiesStoreTest, CopiesDrawProperties) {
+  FakeImplProxy proxy;
+  FakeLayerTreeHostImpl host_impl(&proxy);
+  LayerTreeImpl* tree_impl = host_impl.active_tree();
+
+  scoped_ptr<LayerImpl> root =
+      CreateDrawingLayer(tree_impl, 1, gfx::PointF(), gfx::Size(100, 100));
+  scoped_ptr<LayerImpl> surface = CreateDrawingLayer(
+      tree_impl, 2, gfx::PointF(10.f, 10.f), gfx::Size(50, 50));
+  surface->SetForceRenderSurface(true);
+  surface->SetOpacity(0.5f);
+  scoped_ptr<LayerImpl> child = CreateDrawingLayer(
+      tree_impl, 3, gfx::PointF(5.f, 5.f), gfx::Size(20, 20));
+  scoped_ptr<LayerImpl> hidden = CreateDrawingLayer(
+      tree_impl, 4, gfx::PointF(), gfx::Size(10, 10));
+  hidden->SetOpacity(0.f);
+
+  LayerImpl* surface_ptr = surface.get();
+  LayerImpl* child_ptr = child.get();
+  surface->AddChild(child.Pass());
+  root->AddChild(surface.Pass());
+  root->AddChild(hidden.Pass());
+
+  LayerImplList render_surface_layer_list;
+  LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+      root.get(), root->bounds(), &render_surface_layer_list);
+  LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+  ASSERT_EQ(2u, render_surface_layer_list.size());
+
+  DrawPropertiesStore store;
+  store.Update(render_surface_layer_list);
+
+  // Layers that don't draw aren't stored.
+  ASSERT_EQ(3u, store.size());
+
+  int root_index = IndexOf(store, root.get());
+  int surface_index = IndexOf(store, surface_ptr);
+  int child_index = IndexOf(store, child_ptr);
+  ASSERT_NE(-1, root_index);
+  ASSERT_NE(-1, surface_index);
+  ASSERT_NE(-1, child_index);
+
+  EXPECT_EQ(0, store.render_target_index(root_index));
+  EXPECT_EQ(1, store.render_target_index(surface_index));
+  EXPECT_EQ(1, store.render_target_index(child_index));
+
+  for (size_t i = 0; i < store.size(); ++i) {
+    LayerImpl* layer = store.layer(i);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(layer->screen_space_transform(),
+                                    store.screen_space_transform(i));
+    EXPECT_RECT_EQ(layer->visible_content_rect(),
+                   store.visible_content_rect(i));
+    EXPECT_EQ(layer->draw_opacity(), store.opacity(i));
+  }
+
+  store.Clear();
+  EXPECT_TRUE(store.empty());
+}
+
+}  // namespace
+}  // namespace cc
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "base/format_macros.h"
 #include "base/strings/stringprintf.h"
 #include "cc/debug/debug_colors.h"
 #include "cc/debug/debug_rect_history.h"
@@ -457,7 +458,7 @@ SkRect HeadsUpDisplayLayerImpl::DrawMemoryDisplay(SkCanvas* canvas,
   const int kPadding = 4;
   const int kFontHeight = 13;
 
-  const int height = 3 * kFontHeight + 4 * kPadding;
+  const int height = 4 * kFontHeight + 5 * kPadding;
   const int left = bounds().width() - width - right;
   const SkRect area = SkRect::MakeXYWH(left, top, width, height);
 
@@ -471,6 +472,8 @@ SkRect HeadsUpDisplayLayerImpl::DrawMemoryDisplay(SkCanvas* canvas,
                                     top + kPadding + 2 * kFontHeight);
   SkPoint stat2_pos = SkPoint::Make(left + width - kPadding - 1,
                                     top + 2 * kPadding + 3 * kFontHeight);
+  SkPoint stat3_pos = SkPoint::Make(left + width - kPadding - 1,
+                                    top + 3 * kPadding + 4 * kFontHeight);
 
   paint.setColor(DebugColors::MemoryDisplayTextColor());
   DrawText(canvas,
@@ -496,6 +499,13 @@ SkRect HeadsUpDisplayLayerImpl::DrawMemoryDisplay(SkCanvas* canvas,
   }
   DrawText(canvas, &paint, text, SkPaint::kRight_Align, kFontHeight, stat2_pos);
 
+  paint.setColor(DebugColors::MemoryDisplayTextColor());
+  text = base::StringPrintf("%" PRIuS " / %" PRIuS " decodes reused",
+                            memory_entry_.image_decode_reuse_count,
+                            memory_entry_.image_decode_reuse_count +
+                                memory_entry_.image_decode_task_count);
+  DrawText(canvas, &paint, text, SkPaint::kRight_Align, kFontHeight, stat3_pos);
+
   return area;
 }
 
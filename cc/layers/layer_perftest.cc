@@ -4,12 +4,16 @@
 
 #include "cc/layers/layer.h"
 
+#include "cc/layers/draw_properties_store.h"
+#include "cc/layers/layer_impl.h"
+#include "cc/layers/layer_iterator.h"
 #include "cc/resources/layer_painter.h"
 #include "cc/test/fake_impl_proxy.h"
 #include "cc/test/fake_layer_tree_host.h"
 #include "cc/test/fake_layer_tree_host_client.h"
 #include "cc/test/fake_layer_tree_host_impl.h"
 #include "cc/test/lap_timer.h"
+#include "cc/trees/layer_tree_host_common.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
@@ -20,6 +24,7 @@ namespace {
 static const int kTimeLimitMillis = 3000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
+static const int kNumDrawingLayers = 2000;
 
 class MockLayerPainter : public LayerPainter {
  public:
@@ -116,6 +121,81 @@ TEST_F(LayerPerfTest, PushPropertiesTo) {
                          true);
 }
 
+// Reads the per-layer properties a frame's passes need, for every drawing
+// layer, once by walking LayerImpls with a LayerIterator and once from a
+// DrawPropertiesStore.
+TEST_F(LayerPerfTest, ReadDrawProperties) {
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl_.active_tree(), 1);
+  root->SetAnchorPoint(gfx::PointF());
+  root->SetBounds(gfx::Size(1000, 1000));
+  root->SetContentBounds(root->bounds());
+  for (int i = 0; i < kNumDrawingLayers; ++i) {
+    scoped_ptr<LayerImpl> layer =
+        LayerImpl::Create(host_impl_.active_tree(), i + 2);
+    layer->SetAnchorPoint(gfx::PointF());
+    layer->SetPosition(gfx::PointF(i % 100 * 10, i / 100 * 10));
+    layer->SetBounds(gfx::Size(10, 10));
+    layer->SetContentBounds(layer->bounds());
+    layer->SetDrawsContent(true);
+    root->AddChild(layer.Pass());
+  }
+
+  LayerImplList render_surface_layer_list;
+  LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+      root.get(), root->bounds(), &render_surface_layer_list);
+  LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+  typedef LayerIterator<LayerImpl> LayerIteratorType;
+  float total_opacity = 0.f;
+  int total_width = 0;
+  timer_.Reset();
+  do {
+    LayerIteratorType end = LayerIteratorType::End(&render_surface_layer_list);
+    for (LayerIteratorType it =
+             LayerIteratorType::Begin(&render_surface_layer_list);
+         it != end;
+         ++it) {
+      if (!it.represents_itself())
+        continue;
+      if (!it->screen_space_transform().IsIdentityOrTranslation())
+        continue;
+      total_width += it->visible_content_rect().width();
+      total_opacity += it->draw_opacity();
+    }
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  perf_test::PrintResult("read_draw_properties",
+                         "",
+                         "layer_iterator",
+                         timer_.LapsPerSecond(),
+                         "runs/s",
+                         true);
+
+  DrawPropertiesStore store;
+  store.Update(render_surface_layer_list);
+  timer_.Reset();
+  do {
+    for (size_t i = 0; i < store.size(); ++i) {
+      if (!store.screen_space_transform(i).IsIdentityOrTranslation())
+        continue;
+      total_width += store.visible_content_rect(i).width();
+      total_opacity += store.opacity(i);
+    }
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  perf_test::PrintResult("read_draw_properties",
+                         "",
+                         "draw_properties_store",
+                         timer_.LapsPerSecond(),
+                         "runs/s",
+                         true);
+
+  // Keep the reads from being optimized away.
+  EXPECT_LT(0, total_width);
+  EXPECT_LT(0.f, total_opacity);
+}
 
 }  // namespace
 }  // namespace cc
@@ -44,6 +44,16 @@ static gfx::RectF NormalizedRect(float x,
                     height / total_height);
 }
 
+// Maps |rect|, in UV space of the image, into |image_uv_rect|, the image's
+// UV rect within its texture.
+static gfx::RectF MapToTexture(const gfx::RectF& rect,
+                               const gfx::RectF& image_uv_rect) {
+  return gfx::RectF(image_uv_rect.x() + rect.x() * image_uv_rect.width(),
+                    image_uv_rect.y() + rect.y() * image_uv_rect.height(),
+                    rect.width() * image_uv_rect.width(),
+                    rect.height() * image_uv_rect.height());
+}
+
 void NinePatchLayerImpl::SetLayout(const gfx::Rect& aperture,
                                    const gfx::Rect& border,
                                    bool fill_center) {
@@ -214,6 +224,19 @@ void NinePatchLayerImpl::AppendQuads(QuadSink* quad_sink,
                        uv_top.width(),
                        uv_left.height());
 
+  // The image may only be part of the texture.
+  gfx::RectF image_uv_rect =
+      layer_tree_impl()->UVRectForUIResource(ui_resource_id_);
+  uv_top_left = MapToTexture(uv_top_left, image_uv_rect);
+  uv_top_right = MapToTexture(uv_top_right, image_uv_rect);
+  uv_bottom_left = MapToTexture(uv_bottom_left, image_uv_rect);
+  uv_bottom_right = MapToTexture(uv_bottom_right, image_uv_rect);
+  uv_top = MapToTexture(uv_top, image_uv_rect);
+  uv_left = MapToTexture(uv_left, image_uv_rect);
+  uv_right = MapToTexture(uv_right, image_uv_rect);
+  uv_bottom = MapToTexture(uv_bottom, image_uv_rect);
+  uv_center = MapToTexture(uv_center, image_uv_rect);
+
   // Nothing is opaque here.
   // TODO(danakj): Should we look at the SkBitmaps to determine opaqueness?
   gfx::Rect opaque_rect;
@@ -73,8 +73,6 @@ void PaintedScrollbarLayerImpl::AppendQuads(
     AppendQuadsData* append_quads_data) {
   bool premultipled_alpha = true;
   bool flipped = false;
-  gfx::PointF uv_top_left(0.f, 0.f);
-  gfx::PointF uv_bottom_right(1.f, 1.f);
   gfx::Rect bounds_rect(bounds());
   gfx::Rect content_bounds_rect(content_bounds());
 
@@ -92,14 +90,16 @@ void PaintedScrollbarLayerImpl::AppendQuads(
   if (thumb_resource_id && !thumb_quad_rect.IsEmpty()) {
     gfx::Rect opaque_rect;
     const float opacity[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    gfx::RectF uv_rect =
+        layer_tree_impl()->UVRectForUIResource(thumb_ui_resource_id_);
     scoped_ptr<TextureDrawQuad> quad = TextureDrawQuad::Create();
     quad->SetNew(shared_quad_state,
                  thumb_quad_rect,
                  opaque_rect,
                  thumb_resource_id,
                  premultipled_alpha,
-                 uv_top_left,
-                 uv_bottom_right,
+                 uv_rect.origin(),
+                 uv_rect.bottom_right(),
                  SK_ColorTRANSPARENT,
                  opacity,
                  flipped);
@@ -110,14 +110,16 @@ void PaintedScrollbarLayerImpl::AppendQuads(
   if (track_resource_id && !track_quad_rect.IsEmpty()) {
     gfx::Rect opaque_rect(contents_opaque() ? track_quad_rect : gfx::Rect());
     const float opacity[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    gfx::RectF uv_rect =
+        layer_tree_impl()->UVRectForUIResource(track_ui_resource_id_);
     scoped_ptr<TextureDrawQuad> quad = TextureDrawQuad::Create();
     quad->SetNew(shared_quad_state,
                  track_quad_rect,
                  opaque_rect,
                  track_resource_id,
                  premultipled_alpha,
-                 uv_top_left,
-                 uv_bottom_right,
+                 uv_rect.origin(),
+                 uv_rect.bottom_right(),
                  SK_ColorTRANSPARENT,
                  opacity,
                  flipped);
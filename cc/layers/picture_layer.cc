@@ -51,6 +51,10 @@ void PictureLayer::PushPropertiesTo(LayerImpl* base_layer) {
   }
 
   layer_impl->SetIsMask(is_mask_);
+  // Content that is slow to rasterize on the GPU falls back to software.
+  layer_impl->SetShouldUseGpuRasterization(
+      layer_tree_host()->settings().gpu_rasterization &&
+      pile_->is_suitable_for_gpu_rasterization());
   // Unlike other properties, invalidation must always be set on layer_impl.
   // See PictureLayerImpl::PushPropertiesTo for more details.
   layer_impl->invalidation_.Clear();
@@ -67,6 +71,8 @@ void PictureLayer::SetLayerTreeHost(LayerTreeHost* host) {
         host->debug_state().slow_down_raster_scale_factor);
     pile_->set_show_debug_picture_borders(
         host->debug_state().show_picture_borders);
+    pile_->set_analyze_for_gpu_rasterization(
+        host->settings().gpu_rasterization);
   }
 }
 
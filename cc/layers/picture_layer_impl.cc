@@ -91,6 +91,9 @@ void PictureLayerImpl::PushPropertiesTo(LayerImpl* base_layer) {
 
   layer_impl->SetIsMask(is_mask_);
   layer_impl->pile_ = pile_;
+  // Set directly rather than through SetShouldUseGpuRasterization(), as the
+  // tilings swapped in below were created for this mode.
+  layer_impl->should_use_gpu_rasterization_ = should_use_gpu_rasterization_;
 
   // Tilings would be expensive to push, so we swap.  This optimization requires
   // an extra invalidation in SyncFromActiveLayer.
@@ -469,6 +472,12 @@ scoped_refptr<Tile> PictureLayerImpl::CreateTile(PictureLayerTiling* tiling,
     flags |= Tile::USE_LCD_TEXT;
   if (should_use_gpu_rasterization())
     flags |= Tile::USE_GPU_RASTERIZATION;
+  // ETC1 has no alpha, and compressing costs raster time that is only worth
+  // it for content that won't soon be rastered again.
+  if (layer_tree_impl()->settings().use_etc1_tiles &&
+      !should_use_gpu_rasterization() && contents_opaque() &&
+      !pile_->HasRecentInvalidations())
+    flags |= Tile::USE_ETC1_COMPRESSION;
   return layer_tree_impl()->tile_manager()->CreateTile(
       pile_.get(),
       content_rect.size(),
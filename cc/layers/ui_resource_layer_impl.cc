@@ -116,6 +116,16 @@ void UIResourceLayerImpl::AppendQuads(QuadSink* quad_sink,
   bool opaque = layer_tree_impl()->IsUIResourceOpaque(ui_resource_id_) ||
                 contents_opaque();
   gfx::Rect opaque_rect(opaque ? quad_rect : gfx::Rect());
+
+  // The resource's image may only be part of the texture.
+  gfx::RectF image_uv_rect =
+      layer_tree_impl()->UVRectForUIResource(ui_resource_id_);
+  gfx::PointF uv_top_left(
+      image_uv_rect.x() + uv_top_left_.x() * image_uv_rect.width(),
+      image_uv_rect.y() + uv_top_left_.y() * image_uv_rect.height());
+  gfx::PointF uv_bottom_right(
+      image_uv_rect.x() + uv_bottom_right_.x() * image_uv_rect.width(),
+      image_uv_rect.y() + uv_bottom_right_.y() * image_uv_rect.height());
   scoped_ptr<TextureDrawQuad> quad;
 
   quad = TextureDrawQuad::Create();
@@ -124,8 +134,8 @@ void UIResourceLayerImpl::AppendQuads(QuadSink* quad_sink,
                opaque_rect,
                resource,
                premultiplied_alpha,
-               uv_top_left_,
-               uv_bottom_right_,
+               uv_top_left,
+               uv_bottom_right,
                SK_ColorTRANSPARENT,
                vertex_opacity_,
                flipped);
@@ -4,10 +4,46 @@
 
 #include "cc/output/delegated_frame_data.h"
 
+#include "base/containers/hash_tables.h"
+
 namespace cc {
 
 DelegatedFrameData::DelegatedFrameData() {}
 
 DelegatedFrameData::~DelegatedFrameData() {}
 
+bool DelegatedFrameData::TakeReusedQuadsFrom(
+    DelegatedFrameData* previous_frame) {
+  base::hash_map<RenderPass::Id, RenderPass*> previous_passes;
+  if (previous_frame) {
+    for (size_t i = 0; i < previous_frame->render_pass_list.size(); ++i) {
+      RenderPass* pass = previous_frame->render_pass_list[i];
+      previous_passes[pass->id] = pass;
+    }
+  }
+
+  bool found_all = true;
+  for (size_t i = 0; i < render_pass_list.size(); ++i) {
+    RenderPass* pass = render_pass_list[i];
+    if (!pass->reuses_previous_quads)
+      continue;
+    pass->reuses_previous_quads = false;
+    DCHECK(pass->quad_list.empty());
+    DCHECK(pass->shared_quad_state_list.empty());
+
+    base::hash_map<RenderPass::Id, RenderPass*>::iterator it =
+        previous_passes.find(pass->id);
+    if (it == previous_passes.end()) {
+      found_all = false;
+      continue;
+    }
+    // The quads point at their shared quad states by address, so both lists
+    // can move over together without fixing anything up.
+    pass->quad_list.swap(it->second->quad_list);
+    pass->shared_quad_state_list.swap(it->second->shared_quad_state_list);
+    previous_passes.erase(it);
+  }
+  return found_all;
+}
+
 }  // namespace cc
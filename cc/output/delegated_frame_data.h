@@ -18,6 +18,12 @@ class CC_EXPORT DelegatedFrameData {
   DelegatedFrameData();
   ~DelegatedFrameData();
 
+  // Moves the quads of each pass in |previous_frame| into the pass with the
+  // same id in this frame that has |reuses_previous_quads| set, so that this
+  // frame is complete on its own. Returns false if a reused pass isn't found
+  // in |previous_frame|, in which case that pass is left empty.
+  bool TakeReusedQuadsFrom(DelegatedFrameData* previous_frame);
+
   TransferableResourceArray resource_list;
   ScopedPtrVector<RenderPass> render_pass_list;
 
@@ -82,6 +82,10 @@ bool DelegatingRenderer::Initialize() {
 
 DelegatingRenderer::~DelegatingRenderer() {}
 
+DelegatingRenderer::SentRenderPass::SentRenderPass() : num_quads(0) {}
+
+DelegatingRenderer::SentRenderPass::~SentRenderPass() {}
+
 const RendererCapabilitiesImpl& DelegatingRenderer::Capabilities() const {
   return capabilities_;
 }
@@ -113,14 +117,69 @@ void DelegatingRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order,
 
   // Collect all resource ids in the render passes into a ResourceIdArray.
   ResourceProvider::ResourceIdArray resources;
-  DrawQuad::ResourceIteratorCallback append_to_array =
-      base::Bind(&AppendToArray, &resources);
-  for (size_t i = 0; i < out_data.render_pass_list.size(); ++i) {
-    RenderPass* render_pass = out_data.render_pass_list.at(i);
+  CollectResourcesAndOmitUnchangedQuads(&out_data.render_pass_list,
+                                        &resources);
+  resource_provider_->PrepareSendToParent(resources, &out_data.resource_list);
+}
+
+void DelegatingRenderer::CollectResourcesAndOmitUnchangedQuads(
+    RenderPassList* render_passes,
+    ResourceProvider::ResourceIdArray* resources) {
+  if (!settings_->use_incremental_delegated_frames) {
+    DrawQuad::ResourceIteratorCallback append_to_array =
+        base::Bind(&AppendToArray, resources);
+    for (size_t i = 0; i < render_passes->size(); ++i) {
+      RenderPass* render_pass = render_passes->at(i);
+      for (size_t j = 0; j < render_pass->quad_list.size(); ++j)
+        render_pass->quad_list[j]->IterateResources(append_to_array);
+    }
+    return;
+  }
+
+  // The parent only keeps passes from the last frame, and a resize may mean
+  // it starts over with a new frame provider, so only reuse passes when the
+  // frame is the same size.
+  const gfx::Rect& root_output_rect = render_passes->back()->output_rect;
+  if (root_output_rect != sent_root_output_rect_)
+    sent_render_passes_.clear();
+  sent_root_output_rect_ = root_output_rect;
+
+  SentRenderPassMap sent_render_passes;
+  for (size_t i = 0; i < render_passes->size(); ++i) {
+    RenderPass* render_pass = render_passes->at(i);
+    bool is_root = i + 1 == render_passes->size();
+
+    SentRenderPass sent;
+    sent.output_rect = render_pass->output_rect;
+    sent.num_quads = render_pass->quad_list.size();
+    DrawQuad::ResourceIteratorCallback append_to_array =
+        base::Bind(&AppendToArray, &sent.resources);
     for (size_t j = 0; j < render_pass->quad_list.size(); ++j)
       render_pass->quad_list[j]->IterateResources(append_to_array);
+    resources->insert(
+        resources->end(), sent.resources.begin(), sent.resources.end());
+    if (is_root)
+      continue;
+
+    // An undamaged pass can still have had its tiles swapped for others with
+    // the same content, so the quads are only reused when they draw from the
+    // same resources as what was sent last.
+    SentRenderPassMap::const_iterator previous =
+        sent_render_passes_.find(render_pass->id);
+    bool unchanged = render_pass->damage_rect.IsEmpty() &&
+                     render_pass->copy_requests.empty() &&
+                     previous != sent_render_passes_.end() &&
+                     previous->second.output_rect == sent.output_rect &&
+                     previous->second.num_quads == sent.num_quads &&
+                     previous->second.resources == sent.resources;
+    if (unchanged) {
+      render_pass->reuses_previous_quads = true;
+      render_pass->quad_list.clear();
+      render_pass->shared_quad_state_list.clear();
+    }
+    sent_render_passes[render_pass->id] = sent;
   }
-  resource_provider_->PrepareSendToParent(resources, &out_data.resource_list);
+  sent_render_passes_.swap(sent_render_passes);
 }
 
 void DelegatingRenderer::SwapBuffers(const CompositorFrameMetadata& metadata) {
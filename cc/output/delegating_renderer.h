@@ -5,15 +5,18 @@
 #ifndef CC_OUTPUT_DELEGATING_RENDERER_H_
 #define CC_OUTPUT_DELEGATING_RENDERER_H_
 
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/compositor_frame.h"
 #include "cc/output/renderer.h"
+#include "cc/quads/render_pass.h"
+#include "cc/resources/resource_provider.h"
+#include "ui/gfx/rect.h"
 
 namespace cc {
 
 class OutputSurface;
-class ResourceProvider;
 
 class CC_EXPORT DelegatingRenderer : public Renderer {
  public:
@@ -53,17 +56,39 @@ class CC_EXPORT DelegatingRenderer : public Renderer {
                                       size_t bytes_allocated) OVERRIDE;
 
  private:
+  // What was sent for a non-root render pass in the last frame, and so what
+  // the parent has for it.
+  struct SentRenderPass {
+    SentRenderPass();
+    ~SentRenderPass();
+
+    gfx::Rect output_rect;
+    size_t num_quads;
+    ResourceProvider::ResourceIdArray resources;
+  };
+  typedef base::hash_map<RenderPass::Id, SentRenderPass> SentRenderPassMap;
+
   DelegatingRenderer(RendererClient* client,
                      const LayerTreeSettings* settings,
                      OutputSurface* output_surface,
                      ResourceProvider* resource_provider);
   bool Initialize();
 
+  // Appends the ids of all resources used by |render_passes| to |resources|.
+  // When incremental frames are enabled, also leaves the quads out of
+  // non-root passes that are unchanged since the last frame, and marks them
+  // so the parent reuses the quads it already has.
+  void CollectResourcesAndOmitUnchangedQuads(
+      RenderPassList* render_passes,
+      ResourceProvider::ResourceIdArray* resources);
+
   OutputSurface* output_surface_;
   ResourceProvider* resource_provider_;
   RendererCapabilitiesImpl capabilities_;
   scoped_ptr<DelegatedFrameData> delegated_frame_data_;
   bool visible_;
+  SentRenderPassMap sent_render_passes_;
+  gfx::Rect sent_root_output_rect_;
 
   DISALLOW_COPY_AND_ASSIGN(DelegatingRenderer);
 };
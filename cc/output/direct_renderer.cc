@@ -55,6 +55,9 @@ static gfx::Transform window_matrix(int x, int y, int width, int height) {
   return canvas;
 }
 
+// Older back buffers are uncommon, and are drawn in full.
+static const size_t kMaxBufferAge = 4;
+
 namespace cc {
 
 DirectRenderer::DrawingFrame::DrawingFrame()
@@ -133,7 +136,10 @@ DirectRenderer::DirectRenderer(RendererClient* client,
                                ResourceProvider* resource_provider)
     : Renderer(client, settings),
       output_surface_(output_surface),
-      resource_provider_(resource_provider) {}
+      resource_provider_(resource_provider),
+      overlay_processor_(new OverlayProcessor(output_surface)) {
+  overlay_processor_->Initialize();
+}
 
 DirectRenderer::~DirectRenderer() {}
 
@@ -209,17 +215,40 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order,
 
   DrawingFrame frame;
   frame.root_render_pass = root_render_pass;
-  frame.root_damage_rect =
-      Capabilities().using_partial_swap && allow_partial_swap
-          ? root_render_pass->damage_rect
-          : root_render_pass->output_rect;
+  frame.root_damage_rect = root_render_pass->output_rect;
+  bool using_scissor_as_optimization = false;
+  if (allow_partial_swap) {
+    if (Capabilities().using_partial_swap) {
+      frame.root_damage_rect = root_render_pass->damage_rect;
+      using_scissor_as_optimization = true;
+    } else if (GetDamageSinceBufferWasDrawn(output_surface_->GetBufferAge(),
+                                            root_render_pass->damage_rect,
+                                            &frame.root_damage_rect)) {
+      // The whole buffer is still swapped, but only the parts that changed
+      // since it was last drawn into need redrawing.
+      using_scissor_as_optimization = true;
+    }
+  }
   frame.root_damage_rect.Intersect(gfx::Rect(device_viewport_rect.size()));
+
+  // Remember what this frame changes, for drawing later frames into buffers
+  // that don't have it yet. Frames drawn without partial swap may have
+  // changed all of the output.
+  previous_root_damage_rects_.push_front(
+      allow_partial_swap ? root_render_pass->damage_rect
+                         : root_render_pass->output_rect);
+  if (previous_root_damage_rects_.size() > kMaxBufferAge)
+    previous_root_damage_rects_.pop_back();
+
   frame.device_viewport_rect = device_viewport_rect;
   frame.device_clip_rect = device_clip_rect;
   frame.offscreen_context_provider = offscreen_context_provider;
   frame.disable_picture_quad_image_filtering =
       disable_picture_quad_image_filtering;
 
+  overlay_processor_->ProcessForOverlays(render_passes_in_draw_order,
+                                         &frame.overlay_list);
+
   EnsureBackbuffer();
 
   // Only reshape when we know we are going to draw. Otherwise, the reshape
@@ -230,7 +259,7 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order,
   BeginDrawingFrame(&frame);
   for (size_t i = 0; i < render_passes_in_draw_order->size(); ++i) {
     RenderPass* pass = render_passes_in_draw_order->at(i);
-    DrawRenderPass(&frame, pass, allow_partial_swap);
+    DrawRenderPass(&frame, pass, using_scissor_as_optimization);
 
     for (ScopedPtrVector<CopyOutputRequest>::iterator it =
              pass->copy_requests.begin();
@@ -249,6 +278,24 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order,
   render_passes_in_draw_order->clear();
 }
 
+bool DirectRenderer::GetDamageSinceBufferWasDrawn(
+    int buffer_age,
+    const gfx::RectF& current_damage_rect,
+    gfx::RectF* damage_rect) const {
+  // The history includes the current frame only once DrawFrame records it,
+  // so a buffer drawn |buffer_age| frames ago has missed the damage of the
+  // |buffer_age| - 1 most recent frames.
+  if (buffer_age <= 0 ||
+      static_cast<size_t>(buffer_age) - 1 > previous_root_damage_rects_.size())
+    return false;
+
+  gfx::RectF damage = current_damage_rect;
+  for (int i = 0; i < buffer_age - 1; ++i)
+    damage.Union(previous_root_damage_rects_[i]);
+  *damage_rect = damage;
+  return true;
+}
+
 gfx::RectF DirectRenderer::ComputeScissorRectForRenderPass(
     const DrawingFrame* frame) {
   gfx::RectF render_pass_scissor = frame->current_render_pass->output_rect;
@@ -332,13 +379,11 @@ void DirectRenderer::FinishDrawingQuadList() {}
 
 void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
                                     const RenderPass* render_pass,
-                                    bool allow_partial_swap) {
+                                    bool using_scissor_as_optimization) {
   TRACE_EVENT0("cc", "DirectRenderer::DrawRenderPass");
   if (!UseRenderPass(frame, render_pass))
     return;
 
-  bool using_scissor_as_optimization =
-      Capabilities().using_partial_swap && allow_partial_swap;
   gfx::RectF render_pass_scissor;
   bool draw_rect_covers_full_surface = true;
   if (frame->current_render_pass == frame->root_render_pass &&
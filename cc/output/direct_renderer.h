@@ -5,10 +5,14 @@
 #ifndef CC_OUTPUT_DIRECT_RENDERER_H_
 #define CC_OUTPUT_DIRECT_RENDERER_H_
 
+#include <deque>
+
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
+#include "cc/output/overlay_candidate.h"
+#include "cc/output/overlay_processor.h"
 #include "cc/output/renderer.h"
 #include "cc/resources/resource_provider.h"
 #include "cc/resources/scoped_resource.h"
@@ -58,6 +62,10 @@ class CC_EXPORT DirectRenderer : public Renderer {
     ContextProvider* offscreen_context_provider;
 
     bool disable_picture_quad_image_filtering;
+
+    // Quads of the root render pass that are presented in hardware planes
+    // instead of being drawn, preceded by the main surface.
+    OverlayCandidateList overlay_list;
   };
 
   void SetEnlargePassTextureAmountForTesting(const gfx::Vector2d& amount);
@@ -94,7 +102,7 @@ class CC_EXPORT DirectRenderer : public Renderer {
 
   void DrawRenderPass(DrawingFrame* frame,
                       const RenderPass* render_pass,
-                      bool allow_partial_swap);
+                      bool using_scissor_as_optimization);
   bool UseRenderPass(DrawingFrame* frame, const RenderPass* render_pass);
 
   void RunOnDemandRasterTask(internal::Task* on_demand_raster_task);
@@ -126,6 +134,7 @@ class CC_EXPORT DirectRenderer : public Renderer {
   base::ScopedPtrHashMap<RenderPass::Id, ScopedResource> render_pass_textures_;
   OutputSurface* output_surface_;
   ResourceProvider* resource_provider_;
+  scoped_ptr<OverlayProcessor> overlay_processor_;
 
   // For use in coordinate conversion, this stores the output rect, viewport
   // rect (= unflipped version of glViewport rect), and the size of target
@@ -137,8 +146,18 @@ class CC_EXPORT DirectRenderer : public Renderer {
   gfx::Size current_surface_size_;
 
  private:
+  // Computes the part of the root render pass that needs drawing when the
+  // back buffer still holds the frame drawn |buffer_age| frames ago, from the
+  // damage of the frames drawn since. Returns false if that isn't known.
+  bool GetDamageSinceBufferWasDrawn(int buffer_age,
+                                    const gfx::RectF& current_damage_rect,
+                                    gfx::RectF* damage_rect) const;
+
   gfx::Vector2d enlarge_pass_texture_amount_;
 
+  // The damage of the root render pass in recent frames, most recent first.
+  std::deque<gfx::RectF> previous_root_damage_rects_;
+
   internal::NamespaceToken on_demand_task_namespace_;
 
   DISALLOW_COPY_AND_ASSIGN(DirectRenderer);
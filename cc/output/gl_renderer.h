@@ -162,6 +162,12 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   void EnqueueTextureQuad(const DrawingFrame* frame,
                           const TextureDrawQuad* quad);
   void FlushTextureQuadCache();
+  void EnqueueSolidColorQuad(const DrawingFrame* frame,
+                             const SolidColorDrawQuad* quad,
+                             float alpha);
+  void FlushSolidColorQuadCache();
+  // Draws everything queued in either quad cache.
+  void FlushDrawCaches();
   void DrawIOSurfaceQuad(const DrawingFrame* frame,
                          const IOSurfaceDrawQuad* quad);
   void DrawTileQuad(const DrawingFrame* frame, const TileDrawQuad* quad);
@@ -173,6 +179,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   void DrawPictureQuad(const DrawingFrame* frame,
                        const PictureDrawQuad* quad);
 
+  void ScheduleOverlays(DrawingFrame* frame);
+
   void SetShaderOpacity(float opacity, int alpha_location);
   void SetShaderQuadF(const gfx::QuadF& quad, int quad_location);
   void DrawQuadGeometry(const DrawingFrame* frame,
@@ -298,6 +306,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
       SolidColorProgram;
   typedef ProgramBinding<VertexShaderQuadAA, FragmentShaderColorAA>
       SolidColorProgramAA;
+  typedef ProgramBinding<VertexShaderPosColorTransform,
+                         FragmentShaderVaryingColor> SolidColorBatchProgram;
 
   const TileProgram* GetTileProgram(
       TexCoordPrecision precision, SamplerType sampler);
@@ -352,6 +362,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   const DebugBorderProgram* GetDebugBorderProgram();
   const SolidColorProgram* GetSolidColorProgram();
   const SolidColorProgramAA* GetSolidColorProgramAA();
+  const SolidColorBatchProgram* GetSolidColorBatchProgram();
 
   TileProgram tile_program_[NumTexCoordPrecisions][NumSamplerTypes];
   TileProgramOpaque
@@ -395,6 +406,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   DebugBorderProgram debug_border_program_;
   SolidColorProgram solid_color_program_;
   SolidColorProgramAA solid_color_program_aa_;
+  SolidColorBatchProgram solid_color_batch_program_;
 
   gpu::gles2::GLES2Interface* gl_;
   gpu::ContextSupport* context_support_;
@@ -416,6 +428,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   bool blend_shadow_;
   unsigned program_shadow_;
   TexturedQuadDrawCache draw_cache_;
+  SolidColorQuadDrawCache solid_color_draw_cache_;
   int highp_threshold_min_;
   int highp_threshold_cache_;
 
@@ -424,6 +437,13 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
 
   scoped_ptr<ResourceProvider::ScopedWriteLockGL> current_framebuffer_lock_;
 
+  // Resources scheduled as overlays for the next swap stay locked until the
+  // swap after it, when the display controller no longer reads them.
+  typedef ScopedPtrVector<ResourceProvider::ScopedReadLockGL>
+      OverlayResourceLockList;
+  OverlayResourceLockList pending_overlay_resources_;
+  OverlayResourceLockList in_use_overlay_resources_;
+
   scoped_refptr<ResourceProvider::Fence> last_swap_fence_;
 
   SkBitmap on_demand_tile_raster_bitmap_;
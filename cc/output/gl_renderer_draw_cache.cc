@@ -11,4 +11,12 @@ TexturedQuadDrawCache::TexturedQuadDrawCache()
 
 TexturedQuadDrawCache::~TexturedQuadDrawCache() {}
 
+SolidColorQuadDrawCache::SolidColorQuadDrawCache()
+    : program_id(0),
+      needs_blending(false),
+      matrix_location(-1),
+      color_location(-1) {}
+
+SolidColorQuadDrawCache::~SolidColorQuadDrawCache() {}
+
 }  // namespace cc
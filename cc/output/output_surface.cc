@@ -262,6 +262,17 @@ bool OutputSurface::HasExternalStencilTest() const {
   return external_stencil_test_enabled_;
 }
 
+int OutputSurface::GetBufferAge() const { return 0; }
+
+void OutputSurface::ScheduleOverlayPlane(
+    int plane_z_order,
+    OverlayCandidate::OverlayTransform transform,
+    unsigned texture_id,
+    const gfx::Rect& display_bounds,
+    const gfx::RectF& uv_rect) {
+  NOTREACHED();
+}
+
 bool OutputSurface::ForcedDrawToSoftwareDevice() const { return false; }
 
 bool OutputSurface::BindToClient(OutputSurfaceClient* client) {
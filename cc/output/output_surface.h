@@ -14,6 +14,8 @@
 #include "cc/base/cc_export.h"
 #include "cc/base/rolling_time_delta_history.h"
 #include "cc/output/context_provider.h"
+#include "cc/output/overlay_candidate.h"
+#include "cc/output/overlay_candidate_validator.h"
 #include "cc/output/software_output_device.h"
 #include "cc/scheduler/frame_rate_controller.h"
 
@@ -82,6 +84,11 @@ class CC_EXPORT OutputSurface : public FrameRateControllerClient {
 
   virtual bool HasExternalStencilTest() const;
 
+  // Returns how many frames ago the contents of the back buffer that will be
+  // drawn next were presented, as with EGL_EXT_buffer_age, or 0 if its
+  // contents are undefined.
+  virtual int GetBufferAge() const;
+
   // Obtain the 3d context or the software device associated with this output
   // surface. Either of these may return a null pointer, but not both.
   // In the event of a lost context, the entire output surface should be
@@ -124,6 +131,22 @@ class CC_EXPORT OutputSurface : public FrameRateControllerClient {
   // itself).
   virtual void SwapBuffers(CompositorFrame* frame);
 
+  // Get the class capable of informing cc of hardware overlay capability.
+  // Returns NULL if overlays aren't supported.
+  OverlayCandidateValidator* overlay_candidate_validator() const {
+    return overlay_candidate_validator_.get();
+  }
+
+  // Presents the texture |texture_id| in a hardware plane with the next
+  // SwapBuffers(), in place of drawing it into the framebuffer. Only called
+  // for candidates accepted by overlay_candidate_validator().
+  virtual void ScheduleOverlayPlane(
+      int plane_z_order,
+      OverlayCandidate::OverlayTransform transform,
+      unsigned texture_id,
+      const gfx::Rect& display_bounds,
+      const gfx::RectF& uv_rect);
+
   // Notifies frame-rate smoothness preference. If true, all non-critical
   // processing should be stopped, or lowered in priority.
   virtual void UpdateSmoothnessTakesPriority(bool prefer_smoothness) {}
@@ -154,6 +177,7 @@ class CC_EXPORT OutputSurface : public FrameRateControllerClient {
   struct OutputSurface::Capabilities capabilities_;
   scoped_refptr<ContextProvider> context_provider_;
   scoped_ptr<SoftwareOutputDevice> software_device_;
+  scoped_ptr<OverlayCandidateValidator> overlay_candidate_validator_;
   gfx::Size surface_size_;
   float device_scale_factor_;
 
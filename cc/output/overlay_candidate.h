@@ -0,0 +1,53 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_OUTPUT_OVERLAY_CANDIDATE_H_
+#define CC_OUTPUT_OVERLAY_CANDIDATE_H_
+
+#include <vector>
+
+#include "cc/base/cc_export.h"
+#include "cc/resources/resource_format.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
+
+namespace cc {
+
+// A texture that may be presented by the display controller in a hardware
+// plane of its own, rather than drawn into the framebuffer.
+class CC_EXPORT OverlayCandidate {
+ public:
+  enum OverlayTransform {
+    INVALID,
+    NONE,
+    FLIP_HORIZONTAL,
+    FLIP_VERTICAL,
+  };
+
+  OverlayCandidate();
+  ~OverlayCandidate();
+
+  // Transformation to apply to the texture before display.
+  OverlayTransform transform;
+  // Format of the texture.
+  ResourceFormat format;
+  // Rect on the display to position the overlay to.
+  gfx::Rect display_rect;
+  // Crop within the texture to be placed on the display.
+  gfx::RectF uv_rect;
+  // Texture resource to present in an overlay.
+  unsigned resource_id;
+  // Stacking order of the overlay plane relative to the main surface,
+  // which is 0. Planes with a positive z order are on top of it.
+  int plane_z_order;
+
+  // To be set by the validator if this overlay can be supported.
+  bool overlay_handled;
+};
+
+typedef std::vector<OverlayCandidate> OverlayCandidateList;
+
+}  // namespace cc
+
+#endif  // CC_OUTPUT_OVERLAY_CANDIDATE_H_
@@ -0,0 +1,121 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/output/overlay_strategy_single_on_top.h"
+
+#include "cc/base/math_util.h"
+#include "cc/output/overlay_candidate_validator.h"
+#include "cc/output/copy_output_request.h"
+#include "cc/quads/draw_quad.h"
+#include "cc/quads/texture_draw_quad.h"
+#include "ui/gfx/rect_conversions.h"
+#include "ui/gfx/transform.h"
+
+namespace cc {
+
+OverlayStrategySingleOnTop::OverlayStrategySingleOnTop(
+    OverlayCandidateValidator* capability_checker)
+    : capability_checker_(capability_checker) {}
+
+OverlayStrategySingleOnTop::~OverlayStrategySingleOnTop() {}
+
+bool OverlayStrategySingleOnTop::GetCandidateForQuad(
+    const TextureDrawQuad& quad,
+    OverlayCandidate* candidate) {
+  if (quad.background_color != SK_ColorTRANSPARENT)
+    return false;
+  if (quad.opacity() != 1.f)
+    return false;
+  if (quad.shared_quad_state->blend_mode != SkXfermode::kSrcOver_Mode)
+    return false;
+  for (size_t i = 0; i < arraysize(quad.vertex_opacity); ++i) {
+    if (quad.vertex_opacity[i] != 1.f)
+      return false;
+  }
+
+  // Planes can position and flip the texture, but not rotate or skew it.
+  const gfx::Transform& transform = quad.quadTransform();
+  if (!transform.IsPositiveScaleOrTranslation())
+    return false;
+
+  // Planes are positioned in whole pixels.
+  gfx::RectF display_rect = MathUtil::MapClippedRect(transform, quad.rect);
+  if (!gfx::IsNearestRectWithinDistance(display_rect, 0.01f))
+    return false;
+  if (quad.isClipped() &&
+      !quad.clipRect().Contains(gfx::ToNearestRect(display_rect)))
+    return false;
+
+  candidate->transform =
+      quad.flipped ? OverlayCandidate::FLIP_VERTICAL : OverlayCandidate::NONE;
+  candidate->display_rect = gfx::ToNearestRect(display_rect);
+  candidate->uv_rect = BoundingRect(quad.uv_top_left, quad.uv_bottom_right);
+  candidate->resource_id = quad.resource_id;
+  candidate->plane_z_order = 1;
+  return true;
+}
+
+bool OverlayStrategySingleOnTop::Attempt(
+    RenderPassList* render_passes_in_draw_order,
+    OverlayCandidateList* candidate_list) {
+  // Only attempt to handle very simple case for now.
+  if (!capability_checker_ || render_passes_in_draw_order->empty())
+    return false;
+
+  RenderPass* root_render_pass = render_passes_in_draw_order->back();
+  DCHECK(root_render_pass);
+
+  // Readbacks of the root pass need every quad drawn into the framebuffer.
+  if (!root_render_pass->copy_requests.empty())
+    return false;
+
+  // Quads are ordered front to back, so the first texture quad that nothing
+  // in front of it overlaps is the candidate.
+  QuadList& quad_list = root_render_pass->quad_list;
+  QuadList::iterator candidate_it = quad_list.end();
+  for (QuadList::iterator it = quad_list.begin(); it != quad_list.end();
+       ++it) {
+    if ((*it)->material == DrawQuad::TEXTURE_CONTENT) {
+      candidate_it = it;
+      break;
+    }
+  }
+  if (candidate_it == quad_list.end())
+    return false;
+
+  const TextureDrawQuad& quad = *TextureDrawQuad::MaterialCast(*candidate_it);
+  OverlayCandidate candidate;
+  if (!GetCandidateForQuad(quad, &candidate))
+    return false;
+
+  gfx::RectF overlay_rect = gfx::RectF(candidate.display_rect);
+  for (QuadList::iterator it = quad_list.begin(); it != candidate_it; ++it) {
+    const DrawQuad* overlapping_quad = *it;
+    gfx::RectF overlapping_rect = MathUtil::MapClippedRect(
+        overlapping_quad->quadTransform(), overlapping_quad->rect);
+    if (overlay_rect.Intersects(overlapping_rect))
+      return false;
+  }
+
+  // Add the main surface first, then the overlay, and let the platform
+  // decide.
+  OverlayCandidateList candidates;
+  OverlayCandidate main_surface;
+  main_surface.display_rect = root_render_pass->output_rect;
+  main_surface.format = RGBA_8888;
+  candidates.push_back(main_surface);
+  candidates.push_back(candidate);
+
+  capability_checker_->CheckOverlaySupport(&candidates);
+
+  // If the candidate can be handled by an overlay, stop drawing it.
+  if (!candidates[1].overlay_handled)
+    return false;
+
+  quad_list.erase(candidate_it);
+  candidate_list->swap(candidates);
+  return true;
+}
+
+}  // namespace cc
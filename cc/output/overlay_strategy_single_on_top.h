@@ -0,0 +1,42 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_OUTPUT_OVERLAY_STRATEGY_SINGLE_ON_TOP_H_
+#define CC_OUTPUT_OVERLAY_STRATEGY_SINGLE_ON_TOP_H_
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "cc/output/overlay_candidate.h"
+#include "cc/output/overlay_processor.h"
+
+namespace cc {
+class OverlayCandidateValidator;
+class TextureDrawQuad;
+
+// Promotes the topmost texture quad of the root render pass, such as a
+// fullscreen video frame, to a single overlay plane on top of the main
+// surface, provided nothing is drawn over it.
+class CC_EXPORT OverlayStrategySingleOnTop : public OverlayProcessor::Strategy {
+ public:
+  explicit OverlayStrategySingleOnTop(
+      OverlayCandidateValidator* capability_checker);
+  virtual ~OverlayStrategySingleOnTop();
+
+  virtual bool Attempt(RenderPassList* render_passes_in_draw_order,
+                       OverlayCandidateList* candidate_list) OVERRIDE;
+
+ private:
+  // Fills in |candidate| from |quad| and returns true if |quad| can be shown
+  // in a plane without changing how it looks.
+  static bool GetCandidateForQuad(const TextureDrawQuad& quad,
+                                  OverlayCandidate* candidate);
+
+  OverlayCandidateValidator* capability_checker_;
+
+  DISALLOW_COPY_AND_ASSIGN(OverlayStrategySingleOnTop);
+};
+
+}  // namespace cc
+
+#endif  // CC_OUTPUT_OVERLAY_STRATEGY_SINGLE_ON_TOP_H_
@@ -0,0 +1,319 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "cc/base/scoped_ptr_vector.h"
+#include "cc/output/output_surface.h"
+#include "cc/output/output_surface_client.h"
+#include "cc/output/overlay_candidate_validator.h"
+#include "cc/output/overlay_processor.h"
+#include "cc/output/overlay_strategy_single_on_top.h"
+#include "cc/quads/render_pass.h"
+#include "cc/quads/solid_color_draw_quad.h"
+#include "cc/quads/texture_draw_quad.h"
+#include "cc/test/fake_output_surface_client.h"
+#include "cc/test/geometry_test_utils.h"
+#include "cc/test/test_context_provider.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+const gfx::Rect kOverlayRect(0, 0, 128, 128);
+const gfx::PointF kUVTopLeft(0.1f, 0.2f);
+const gfx::PointF kUVBottomRight(1.0f, 1.0f);
+const unsigned kResourceId = 7;
+
+class SingleOverlayValidator : public OverlayCandidateValidator {
+ public:
+  virtual void CheckOverlaySupport(OverlayCandidateList* surfaces) OVERRIDE {
+    ASSERT_EQ(2U, surfaces->size());
+
+    OverlayCandidate& candidate = surfaces->back();
+    EXPECT_EQ(kOverlayRect.ToString(), candidate.display_rect.ToString());
+    EXPECT_EQ(BoundingRect(kUVTopLeft, kUVBottomRight).ToString(),
+              candidate.uv_rect.ToString());
+    candidate.overlay_handled = true;
+  }
+};
+
+class SingleOverlayProcessor : public OverlayProcessor {
+ public:
+  explicit SingleOverlayProcessor(OutputSurface* surface)
+      : OverlayProcessor(surface) {}
+
+  virtual void Initialize() OVERRIDE {
+    OverlayCandidateValidator* candidates =
+        surface_->overlay_candidate_validator();
+    ASSERT_TRUE(candidates != NULL);
+    strategies_.push_back(scoped_ptr<Strategy>(
+        new OverlayStrategySingleOnTop(candidates)));
+  }
+
+  size_t GetStrategyCount() const { return strategies_.size(); }
+};
+
+class OverlayOutputSurface : public OutputSurface {
+ public:
+  explicit OverlayOutputSurface(scoped_refptr<ContextProvider> context_provider)
+      : OutputSurface(context_provider) {}
+
+  void InitWithSingleOverlayValidator() {
+    overlay_candidate_validator_.reset(new SingleOverlayValidator);
+  }
+};
+
+scoped_ptr<RenderPass> CreateRenderPass() {
+  RenderPass::Id id(1, 0);
+  gfx::Rect output_rect(0, 0, 256, 256);
+  bool has_transparent_background = true;
+
+  scoped_ptr<RenderPass> pass = RenderPass::Create();
+  pass->SetAll(id,
+               output_rect,
+               output_rect,
+               gfx::Transform(),
+               has_transparent_background);
+
+  scoped_ptr<SharedQuadState> shared_state = SharedQuadState::Create();
+  shared_state->opacity = 1.f;
+  shared_state->blend_mode = SkXfermode::kSrcOver_Mode;
+  pass->shared_quad_state_list.push_back(shared_state.Pass());
+  return pass.Pass();
+}
+
+scoped_ptr<TextureDrawQuad> CreateCandidateQuad(
+    const SharedQuadState* shared_quad_state) {
+  float vertex_opacity[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  bool premultiplied_alpha = false;
+  bool flipped = false;
+
+  scoped_ptr<TextureDrawQuad> overlay_quad = TextureDrawQuad::Create();
+  overlay_quad->SetNew(shared_quad_state,
+                       kOverlayRect,
+                       kOverlayRect,
+                       kResourceId,
+                       premultiplied_alpha,
+                       kUVTopLeft,
+                       kUVBottomRight,
+                       SK_ColorTRANSPARENT,
+                       vertex_opacity,
+                       flipped);
+  return overlay_quad.Pass();
+}
+
+scoped_ptr<DrawQuad> CreateCheckeredQuad(
+    const SharedQuadState* shared_quad_state,
+    const gfx::Rect& rect) {
+  scoped_ptr<SolidColorDrawQuad> quad = SolidColorDrawQuad::Create();
+  quad->SetNew(shared_quad_state, rect, SK_ColorLTGRAY, false);
+  return quad.PassAs<DrawQuad>();
+}
+
+void CompareRenderPassLists(const RenderPassList& expected_list,
+                            const RenderPassList& actual_list) {
+  EXPECT_EQ(expected_list.size(), actual_list.size());
+  for (size_t i = 0; i < actual_list.size(); ++i) {
+    RenderPass* expected = expected_list[i];
+    RenderPass* actual = actual_list[i];
+
+    EXPECT_EQ(expected->id, actual->id);
+    EXPECT_RECT_EQ(expected->output_rect, actual->output_rect);
+    EXPECT_EQ(expected->quad_list.size(), actual->quad_list.size());
+    for (size_t j = 0;
+         j < std::min(expected->quad_list.size(), actual->quad_list.size());
+         ++j) {
+      EXPECT_EQ(expected->quad_list[j]->material,
+                actual->quad_list[j]->material);
+      EXPECT_RECT_EQ(expected->quad_list[j]->rect,
+                     actual->quad_list[j]->rect);
+    }
+  }
+}
+
+TEST(OverlayTest, NoOverlaysByDefault) {
+  scoped_refptr<TestContextProvider> provider = TestContextProvider::Create();
+  OverlayOutputSurface output_surface(provider);
+  EXPECT_TRUE(output_surface.overlay_candidate_validator() == NULL);
+
+  output_surface.InitWithSingleOverlayValidator();
+  EXPECT_TRUE(output_surface.overlay_candidate_validator() != NULL);
+}
+
+TEST(OverlayTest, OverlaysProcessorHasStrategy) {
+  scoped_refptr<TestContextProvider> provider = TestContextProvider::Create();
+  OverlayOutputSurface output_surface(provider);
+  FakeOutputSurfaceClient client;
+  EXPECT_TRUE(output_surface.BindToClient(&client));
+  output_surface.InitWithSingleOverlayValidator();
+  EXPECT_TRUE(output_surface.overlay_candidate_validator() != NULL);
+
+  OverlayProcessor overlay_processor(&output_surface);
+  overlay_processor.Initialize();
+
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->quad_list.push_back(
+      CreateCandidateQuad(pass->shared_quad_state_list.back())
+          .PassAs<DrawQuad>());
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  OverlayCandidateList candidate_list;
+  overlay_processor.ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(2U, candidate_list.size());
+  EXPECT_EQ(0U, pass_list.back()->quad_list.size());
+}
+
+class SingleOverlayOnTopTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    provider_ = TestContextProvider::Create();
+    output_surface_.reset(new OverlayOutputSurface(provider_));
+    EXPECT_TRUE(output_surface_->BindToClient(&client_));
+    output_surface_->InitWithSingleOverlayValidator();
+    EXPECT_TRUE(output_surface_->overlay_candidate_validator() != NULL);
+
+    overlay_processor_.reset(new SingleOverlayProcessor(output_surface_.get()));
+    overlay_processor_->Initialize();
+    EXPECT_EQ(1U, overlay_processor_->GetStrategyCount());
+  }
+
+  scoped_refptr<TestContextProvider> provider_;
+  scoped_ptr<OverlayOutputSurface> output_surface_;
+  FakeOutputSurfaceClient client_;
+  scoped_ptr<SingleOverlayProcessor> overlay_processor_;
+};
+
+TEST_F(SingleOverlayOnTopTest, SuccessfulOverlay) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  scoped_ptr<TextureDrawQuad> original_quad =
+      CreateCandidateQuad(pass->shared_quad_state_list.back());
+
+  pass->quad_list.push_back(
+      original_quad->Copy(pass->shared_quad_state_list.back()));
+  // Add something behind it.
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      pass->shared_quad_state_list.back(), pass->output_rect));
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      pass->shared_quad_state_list.back(), pass->output_rect));
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  // Check for potential candidates.
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+
+  ASSERT_EQ(1U, pass_list.size());
+  ASSERT_EQ(2U, candidate_list.size());
+
+  RenderPass* main_pass = pass_list.back();
+  // Check that the quad is gone.
+  EXPECT_EQ(2U, main_pass->quad_list.size());
+  const QuadList& quad_list = main_pass->quad_list;
+  for (QuadList::ConstBackToFrontIterator it = quad_list.BackToFrontBegin();
+       it != quad_list.BackToFrontEnd();
+       ++it) {
+    EXPECT_NE(DrawQuad::TEXTURE_CONTENT, (*it)->material);
+  }
+
+  // Check that the right resource id got extracted.
+  EXPECT_EQ(original_quad->resource_id, candidate_list.back().resource_id);
+  EXPECT_EQ(1, candidate_list.back().plane_z_order);
+  EXPECT_EQ(OverlayCandidate::NONE, candidate_list.back().transform);
+}
+
+TEST_F(SingleOverlayOnTopTest, NoCandidates) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      pass->shared_quad_state_list.back(), pass->output_rect));
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      pass->shared_quad_state_list.back(), pass->output_rect));
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  RenderPassList original_pass_list;
+  RenderPass::CopyAll(pass_list, &original_pass_list);
+
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(0U, candidate_list.size());
+  // There should be nothing new here.
+  CompareRenderPassLists(pass_list, original_pass_list);
+}
+
+TEST_F(SingleOverlayOnTopTest, OccludedCandidates) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->quad_list.push_back(CreateCheckeredQuad(
+      pass->shared_quad_state_list.back(), pass->output_rect));
+  pass->quad_list.push_back(
+      CreateCandidateQuad(pass->shared_quad_state_list.back())
+          .PassAs<DrawQuad>());
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  RenderPassList original_pass_list;
+  RenderPass::CopyAll(pass_list, &original_pass_list);
+
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(0U, candidate_list.size());
+  // There should be nothing new here.
+  CompareRenderPassLists(pass_list, original_pass_list);
+}
+
+TEST_F(SingleOverlayOnTopTest, RejectTransparentVertices) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  scoped_ptr<TextureDrawQuad> quad =
+      CreateCandidateQuad(pass->shared_quad_state_list.back());
+  quad->vertex_opacity[1] = 0.5f;
+  pass->quad_list.push_back(quad.PassAs<DrawQuad>());
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(0U, candidate_list.size());
+  EXPECT_EQ(1U, pass_list.back()->quad_list.size());
+}
+
+TEST_F(SingleOverlayOnTopTest, RejectBackgroundColor) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  scoped_ptr<TextureDrawQuad> quad =
+      CreateCandidateQuad(pass->shared_quad_state_list.back());
+  quad->background_color = SK_ColorBLACK;
+  pass->quad_list.push_back(quad.PassAs<DrawQuad>());
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(0U, candidate_list.size());
+  EXPECT_EQ(1U, pass_list.back()->quad_list.size());
+}
+
+TEST_F(SingleOverlayOnTopTest, RejectRotatedQuads) {
+  scoped_ptr<RenderPass> pass = CreateRenderPass();
+  pass->shared_quad_state_list.back()->content_to_target_transform.Rotate(
+      90.f);
+  pass->quad_list.push_back(
+      CreateCandidateQuad(pass->shared_quad_state_list.back())
+          .PassAs<DrawQuad>());
+
+  RenderPassList pass_list;
+  pass_list.push_back(pass.Pass());
+
+  OverlayCandidateList candidate_list;
+  overlay_processor_->ProcessForOverlays(&pass_list, &candidate_list);
+  EXPECT_EQ(0U, candidate_list.size());
+  EXPECT_EQ(1U, pass_list.back()->quad_list.size());
+}
+
+}  // namespace
+}  // namespace cc
@@ -35,14 +35,16 @@ scoped_ptr<RenderPass> RenderPass::Create(size_t num_layers) {
 
 RenderPass::RenderPass()
     : id(Id(-1, -1)),
-      has_transparent_background(true) {
+      has_transparent_background(true),
+      reuses_previous_quads(false) {
   shared_quad_state_list.reserve(kDefaultNumSharedQuadStatesToReserve);
   quad_list.reserve(kDefaultNumQuadsToReserve);
 }
 
 RenderPass::RenderPass(size_t num_layers)
     : id(Id(-1, -1)),
-      has_transparent_background(true) {
+      has_transparent_background(true),
+      reuses_previous_quads(false) {
   // Each layer usually produces one shared quad state, so the number of layers
   // is a good hint for what to reserve here.
   shared_quad_state_list.reserve(num_layers);
@@ -62,6 +64,7 @@ scoped_ptr<RenderPass> RenderPass::Copy(Id new_id) const {
                     damage_rect,
                     transform_to_root_target,
                     has_transparent_background);
+  copy_pass->reuses_previous_quads = reuses_previous_quads;
   return copy_pass.Pass();
 }
 
@@ -81,6 +84,7 @@ void RenderPass::CopyAll(const ScopedPtrVector<RenderPass>& in,
                       source->damage_rect,
                       source->transform_to_root_target,
                       source->has_transparent_background);
+    copy_pass->reuses_previous_quads = source->reuses_previous_quads;
     for (size_t i = 0; i < source->shared_quad_state_list.size(); ++i) {
       copy_pass->shared_quad_state_list.push_back(
           source->shared_quad_state_list[i]->Copy());
@@ -150,6 +154,7 @@ scoped_ptr<base::Value> RenderPass::AsValue() const {
   value->Set("output_rect", MathUtil::AsValue(output_rect).release());
   value->Set("damage_rect", MathUtil::AsValue(damage_rect).release());
   value->SetBoolean("has_transparent_background", has_transparent_background);
+  value->SetBoolean("reuses_previous_quads", reuses_previous_quads);
   value->SetInteger("copy_requests", copy_requests.size());
   scoped_ptr<base::ListValue> shared_states_value(new base::ListValue());
   for (size_t i = 0; i < shared_quad_state_list.size(); ++i) {
@@ -102,6 +102,11 @@ class CC_EXPORT RenderPass {
   // If false, the pixels in the render pass' texture are all opaque.
   bool has_transparent_background;
 
+  // If true, the pass was sent between compositors without its quads, as they
+  // are unchanged from the pass with the same |id| in the previous frame from
+  // the same compositor. The receiver should take the quads from that pass.
+  bool reuses_previous_quads;
+
   // If non-empty, the renderer should produce a copy of the render pass'
   // contents as a bitmap, and give a copy of the bitmap to each callback in
   // this list. This property should not be serialized between compositors, as
@@ -0,0 +1,191 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/etc1_encoder.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace cc {
+
+namespace {
+
+const int kBlockSize = 4;
+const int kBytesPerBlock = 8;
+
+// Intensity modifiers of each table, applied as +small, +large, -small and
+// -large for pixel indices 0 to 3.
+const int kModifierTables[8][2] = {
+  { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+  { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+struct Color {
+  int r;
+  int g;
+  int b;
+};
+
+int Clamp255(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+int Modifier(int table, int index) {
+  int modifier = kModifierTables[table][index & 1];
+  return index & 2 ? -modifier : modifier;
+}
+
+struct Subblock {
+  // Base color quantized to 4 bits per channel.
+  Color base;
+  int table;
+  int error;
+};
+
+// Chooses the base color and modifier table of the subblock made of the
+// pixels of |block| for which |in_subblock| is set, and records each pixel's
+// modifier index in |indices|.
+Subblock EncodeSubblock(const Color block[16],
+                        const bool in_subblock[16],
+                        int indices[16]) {
+  Color sum = { 0, 0, 0 };
+  for (int i = 0; i < 16; ++i) {
+    if (!in_subblock[i])
+      continue;
+    sum.r += block[i].r;
+    sum.g += block[i].g;
+    sum.b += block[i].b;
+  }
+
+  // Each subblock has 8 pixels. Quantize their average to 4 bits.
+  Subblock subblock;
+  subblock.base.r = (sum.r * 15 + 4 * 255) / (8 * 255);
+  subblock.base.g = (sum.g * 15 + 4 * 255) / (8 * 255);
+  subblock.base.b = (sum.b * 15 + 4 * 255) / (8 * 255);
+  Color base = { subblock.base.r * 17, subblock.base.g * 17,
+                 subblock.base.b * 17 };
+
+  subblock.table = 0;
+  subblock.error = std::numeric_limits<int>::max();
+  int table_indices[16];
+  for (int table = 0; table < 8; ++table) {
+    int table_error = 0;
+    for (int i = 0; i < 16 && table_error < subblock.error; ++i) {
+      if (!in_subblock[i])
+        continue;
+      int best_error = std::numeric_limits<int>::max();
+      for (int index = 0; index < 4; ++index) {
+        int modifier = Modifier(table, index);
+        int dr = Clamp255(base.r + modifier) - block[i].r;
+        int dg = Clamp255(base.g + modifier) - block[i].g;
+        int db = Clamp255(base.b + modifier) - block[i].b;
+        int error = dr * dr + dg * dg + db * db;
+        if (error < best_error) {
+          best_error = error;
+          table_indices[i] = index;
+        }
+      }
+      table_error += best_error;
+    }
+    if (table_error >= subblock.error)
+      continue;
+    subblock.error = table_error;
+    subblock.table = table;
+    for (int i = 0; i < 16; ++i) {
+      if (in_subblock[i])
+        indices[i] = table_indices[i];
+    }
+  }
+  return subblock;
+}
+
+// Encodes |block|, whose pixels are in column major order as ETC1 indexes
+// them, into |output|.
+void EncodeBlock(const Color block[16], uint8_t* output) {
+  // Try splitting the block into left and right halves, then into top and
+  // bottom halves, and keep whichever has the smaller error.
+  int best_indices[16];
+  Subblock best_first;
+  Subblock best_second;
+  bool best_flip = false;
+  int best_error = std::numeric_limits<int>::max();
+  for (int flip = 0; flip < 2; ++flip) {
+    bool in_first[16];
+    bool in_second[16];
+    for (int i = 0; i < 16; ++i) {
+      int x = i / kBlockSize;
+      int y = i % kBlockSize;
+      in_first[i] = flip ? y < 2 : x < 2;
+      in_second[i] = !in_first[i];
+    }
+    int indices[16];
+    Subblock first = EncodeSubblock(block, in_first, indices);
+    Subblock second = EncodeSubblock(block, in_second, indices);
+    if (first.error + second.error >= best_error)
+      continue;
+    best_error = first.error + second.error;
+    best_first = first;
+    best_second = second;
+    best_flip = !!flip;
+    std::copy(indices, indices + 16, best_indices);
+  }
+
+  uint32_t high = (best_first.base.r << 28) | (best_second.base.r << 24) |
+                  (best_first.base.g << 20) | (best_second.base.g << 16) |
+                  (best_first.base.b << 12) | (best_second.base.b << 8) |
+                  (best_first.table << 5) | (best_second.table << 2) |
+                  (best_flip ? 1 : 0);
+  uint32_t low = 0;
+  for (int i = 0; i < 16; ++i) {
+    low |= ((best_indices[i] >> 1) & 1) << (i + 16);
+    low |= (best_indices[i] & 1) << i;
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    output[i] = (high >> (24 - 8 * i)) & 0xff;
+    output[4 + i] = (low >> (24 - 8 * i)) & 0xff;
+  }
+}
+
+}  // namespace
+
+size_t ETC1EncodedSizeInBytes(const gfx::Size& size) {
+  DCHECK_EQ(0, size.width() % kBlockSize);
+  DCHECK_EQ(0, size.height() % kBlockSize);
+  return (size.width() / kBlockSize) * (size.height() / kBlockSize) *
+         kBytesPerBlock;
+}
+
+void EncodeETC1(const uint8_t* pixels,
+                const gfx::Size& size,
+                int stride,
+                uint8_t* output) {
+  DCHECK_EQ(0, size.width() % kBlockSize);
+  DCHECK_EQ(0, size.height() % kBlockSize);
+  DCHECK_GE(stride, size.width() * 4);
+
+  for (int block_y = 0; block_y < size.height(); block_y += kBlockSize) {
+    for (int block_x = 0; block_x < size.width(); block_x += kBlockSize) {
+      Color block[16];
+      for (int x = 0; x < kBlockSize; ++x) {
+        for (int y = 0; y < kBlockSize; ++y) {
+          const SkPMColor* row = reinterpret_cast<const SkPMColor*>(
+              pixels + (block_y + y) * stride);
+          SkPMColor pixel = row[block_x + x];
+          Color& color = block[x * kBlockSize + y];
+          color.r = SkGetPackedR32(pixel);
+          color.g = SkGetPackedG32(pixel);
+          color.b = SkGetPackedB32(pixel);
+        }
+      }
+      EncodeBlock(block, output);
+      output += kBytesPerBlock;
+    }
+  }
+}
+
+}  // namespace cc
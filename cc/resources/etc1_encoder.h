@@ -0,0 +1,31 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_ETC1_ENCODER_H_
+#define CC_RESOURCES_ETC1_ENCODER_H_
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "ui/gfx/size.h"
+
+namespace cc {
+
+// Returns the number of bytes of ETC1 data for an image of |size|, which
+// must be a multiple of 4 texels in both dimensions.
+CC_EXPORT size_t ETC1EncodedSizeInBytes(const gfx::Size& size);
+
+// Compresses |size| opaque N32 pixels, |stride| bytes apart per row, into
+// ETC1 blocks written to |output|. Only the individual color mode is used,
+// trading some quality for a fast encode on the raster threads.
+//
+// |output| may be |pixels|: each block is read before it is written, and a
+// block never overwrites pixels of blocks not yet encoded.
+CC_EXPORT void EncodeETC1(const uint8_t* pixels,
+                          const gfx::Size& size,
+                          int stride,
+                          uint8_t* output);
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_ETC1_ENCODER_H_
@@ -0,0 +1,121 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/etc1_encoder.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace cc {
+namespace {
+
+const int kModifierTables[8][2] = {
+  { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+  { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+int Clamp255(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// Decodes the individual mode block at |block| and returns the red, green
+// and blue components of the pixel at |x|, |y|.
+void DecodePixel(const uint8_t* block, int x, int y, int color[3]) {
+  uint32_t high = (block[0] << 24) | (block[1] << 16) | (block[2] << 8) |
+                  block[3];
+  uint32_t low = (block[4] << 24) | (block[5] << 16) | (block[6] << 8) |
+                 block[7];
+  EXPECT_EQ(0u, (high >> 1) & 1);  // Individual mode.
+  bool flip = high & 1;
+  bool second = flip ? y >= 2 : x >= 2;
+  int table = (high >> (second ? 2 : 5)) & 7;
+  int i = x * 4 + y;
+  int index = (((low >> (i + 16)) & 1) << 1) | ((low >> i) & 1);
+  int modifier = kModifierTables[table][index & 1];
+  if (index & 2)
+    modifier = -modifier;
+  for (int c = 0; c < 3; ++c) {
+    int base = (high >> (28 - 8 * c - (second ? 4 : 0))) & 0xf;
+    color[c] = Clamp255(base * 17 + modifier);
+  }
+}
+
+std::vector<uint8_t> CreatePixels(const gfx::Size& size) {
+  std::vector<uint8_t> pixels(size.GetArea() * 4);
+  SkPMColor* colors = reinterpret_cast<SkPMColor*>(&pixels[0]);
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x) {
+      colors[y * size.width() + x] =
+          SkPackARGB32(255, (x * 16) & 0xff, (y * 16) & 0xff, 128);
+    }
+  }
+  return pixels;
+}
+
+TEST(ETC1EncoderTest, EncodedSize) {
+  EXPECT_EQ(8u, ETC1EncodedSizeInBytes(gfx::Size(4, 4)));
+  EXPECT_EQ(256u * 256u / 2, ETC1EncodedSizeInBytes(gfx::Size(256, 256)));
+}
+
+TEST(ETC1EncoderTest, SolidColor) {
+  gfx::Size size(8, 4);
+  std::vector<uint32_t> pixels(size.GetArea(), SkPackARGB32(255, 200, 100, 50));
+  std::vector<uint8_t> output(ETC1EncodedSizeInBytes(size));
+  EncodeETC1(reinterpret_cast<uint8_t*>(&pixels[0]),
+             size,
+             size.width() * 4,
+             &output[0]);
+
+  for (int block = 0; block < 2; ++block) {
+    for (int x = 0; x < 4; ++x) {
+      for (int y = 0; y < 4; ++y) {
+        int color[3];
+        DecodePixel(&output[block * 8], x, y, color);
+        EXPECT_LE(std::abs(color[0] - 200), 4);
+        EXPECT_LE(std::abs(color[1] - 100), 4);
+        EXPECT_LE(std::abs(color[2] - 50), 4);
+      }
+    }
+  }
+}
+
+TEST(ETC1EncoderTest, Gradient) {
+  gfx::Size size(16, 16);
+  std::vector<uint8_t> pixels = CreatePixels(size);
+  std::vector<uint8_t> output(ETC1EncodedSizeInBytes(size));
+  EncodeETC1(&pixels[0], size, size.width() * 4, &output[0]);
+
+  const SkPMColor* colors = reinterpret_cast<const SkPMColor*>(&pixels[0]);
+  int blocks_per_row = size.width() / 4;
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x) {
+      const uint8_t* block = &output[((y / 4) * blocks_per_row + x / 4) * 8];
+      int color[3];
+      DecodePixel(block, x % 4, y % 4, color);
+      SkPMColor expected = colors[y * size.width() + x];
+      EXPECT_LE(std::abs(color[0] - static_cast<int>(SkGetPackedR32(expected))),
+                40);
+      EXPECT_LE(std::abs(color[1] - static_cast<int>(SkGetPackedG32(expected))),
+                40);
+      EXPECT_LE(std::abs(color[2] - static_cast<int>(SkGetPackedB32(expected))),
+                40);
+    }
+  }
+}
+
+TEST(ETC1EncoderTest, InPlace) {
+  gfx::Size size(32, 8);
+  std::vector<uint8_t> pixels = CreatePixels(size);
+  std::vector<uint8_t> expected(ETC1EncodedSizeInBytes(size));
+  EncodeETC1(&pixels[0], size, size.width() * 4, &expected[0]);
+
+  EncodeETC1(&pixels[0], size, size.width() * 4, &pixels[0]);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), pixels.begin()));
+}
+
+}  // namespace
+}  // namespace cc
@@ -6,6 +6,7 @@
 
 #include "base/debug/trace_event.h"
 #include "base/values.h"
+#include "cc/debug/rendering_stats_instrumentation.h"
 #include "cc/debug/traced_value.h"
 #include "cc/resources/resource.h"
 #include "third_party/skia/include/core/SkBitmapDevice.h"
@@ -15,19 +16,23 @@ namespace cc {
 // static
 scoped_ptr<RasterWorkerPool> ImageRasterWorkerPool::Create(
     ResourceProvider* resource_provider,
-    unsigned texture_target) {
+    unsigned texture_target,
+    RenderingStatsInstrumentation* rendering_stats) {
   return make_scoped_ptr<RasterWorkerPool>(
       new ImageRasterWorkerPool(GetTaskGraphRunner(),
                                 resource_provider,
-                                texture_target));
+                                texture_target,
+                                rendering_stats));
 }
 
 ImageRasterWorkerPool::ImageRasterWorkerPool(
     internal::TaskGraphRunner* task_graph_runner,
     ResourceProvider* resource_provider,
-    unsigned texture_target)
+    unsigned texture_target,
+    RenderingStatsInstrumentation* rendering_stats)
     : RasterWorkerPool(task_graph_runner, resource_provider),
       texture_target_(texture_target),
+      rendering_stats_(rendering_stats),
       raster_tasks_pending_(false),
       raster_tasks_required_for_activation_pending_(false) {}
 
@@ -138,6 +143,11 @@ SkCanvas* ImageRasterWorkerPool::AcquireCanvasForRaster(
 void ImageRasterWorkerPool::OnRasterCompleted(
     internal::RasterWorkerPoolTask* task,
     const PicturePileImpl::Analysis& analysis) {
+  // Solid color and canceled tasks don't write to the image.
+  if (rendering_stats_ && !analysis.is_solid_color &&
+      task->HasFinishedRunning()) {
+    rendering_stats_->AddImageRaster(task->resource()->size().GetArea());
+  }
   resource_provider()->UnmapImageRasterBuffer(task->resource()->id());
 }
 
@@ -13,9 +13,12 @@ class CC_EXPORT ImageRasterWorkerPool : public RasterWorkerPool {
  public:
   virtual ~ImageRasterWorkerPool();
 
+  // |rendering_stats|, if not NULL, records the pixels rasterized into
+  // images.
   static scoped_ptr<RasterWorkerPool> Create(
       ResourceProvider* resource_provider,
-      unsigned texture_target);
+      unsigned texture_target,
+      RenderingStatsInstrumentation* rendering_stats);
 
   // Overridden from RasterWorkerPool:
   virtual void ScheduleTasks(RasterTaskQueue* queue) OVERRIDE;
@@ -35,7 +38,8 @@ class CC_EXPORT ImageRasterWorkerPool : public RasterWorkerPool {
  protected:
   ImageRasterWorkerPool(internal::TaskGraphRunner* task_graph_runner,
                         ResourceProvider* resource_provider,
-                        unsigned texture_target);
+                        unsigned texture_target,
+                        RenderingStatsInstrumentation* rendering_stats);
 
  private:
   // Overridden from RasterWorkerPool:
@@ -45,6 +49,7 @@ class CC_EXPORT ImageRasterWorkerPool : public RasterWorkerPool {
   scoped_ptr<base::Value> StateAsValue() const;
 
   const unsigned texture_target_;
+  RenderingStatsInstrumentation* rendering_stats_;
 
   RasterTaskQueue raster_tasks_;
 
@@ -62,6 +62,9 @@ class CC_EXPORT ManagedTileState {
 
     bool contents_swizzled() const {
       DCHECK(resource_);
+      // ETC1 content is encoded from the unpacked color components.
+      if (resource_->format() == ETC1)
+        return false;
       return !PlatformColor::SameComponentOrder(resource_->format());
     }
 
@@ -24,12 +24,18 @@ class MemoryHistory {
         : total_budget_in_bytes(0),
           bytes_allocated(0),
           bytes_unreleasable(0),
-          bytes_over(0) {}
+          bytes_over(0),
+          image_decode_reuse_count(0),
+          image_decode_task_count(0) {}
 
     size_t total_budget_in_bytes;
     size_t bytes_allocated;
     size_t bytes_unreleasable;
     size_t bytes_over;
+    // Number of times a raster task depended on an existing image decode task
+    // rather than a new one, and the number of decode tasks created.
+    size_t image_decode_reuse_count;
+    size_t image_decode_task_count;
     size_t bytes_total() const {
       return bytes_allocated + bytes_unreleasable + bytes_over;
     }
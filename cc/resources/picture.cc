@@ -16,6 +16,7 @@
 #include "cc/debug/traced_picture.h"
 #include "cc/debug/traced_value.h"
 #include "cc/layers/content_layer_client.h"
+#include "skia/ext/analysis_canvas.h"
 #include "skia/ext/pixel_ref_utils.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkData.h"
@@ -32,6 +33,11 @@ namespace cc {
 
 namespace {
 
+// Pictures with more of these are rasterized in software, as Ganesh is
+// slower than the software rasterizer at drawing them.
+const int kMaxSlowPathsForGpuRasterization = 5;
+const int kMaxTextDrawsForGpuRasterization = 200;
+
 SkData* EncodeBitmap(size_t* offset, const SkBitmap& bm) {
   const int kJpegQuality = 80;
   std::vector<unsigned char> data;
@@ -99,7 +105,9 @@ scoped_refptr<Picture> Picture::Create(
 
 Picture::Picture(const gfx::Rect& layer_rect)
   : layer_rect_(layer_rect),
-    cell_size_(layer_rect.size()) {
+    cell_size_(layer_rect.size()),
+    is_suitable_for_gpu_rasterization_(true),
+    analysis_cache_(new PictureAnalysisCache) {
   // Instead of recording a trace event for object creation here, we wait for
   // the picture to be recorded in Picture::Record.
 }
@@ -169,7 +177,9 @@ Picture::Picture(SkPicture* picture,
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(skia::AdoptRef(picture)),
-    cell_size_(layer_rect.size()) {
+    cell_size_(layer_rect.size()),
+    is_suitable_for_gpu_rasterization_(true),
+    analysis_cache_(new PictureAnalysisCache) {
 }
 
 Picture::Picture(const skia::RefPtr<SkPicture>& picture,
@@ -180,7 +190,9 @@ Picture::Picture(const skia::RefPtr<SkPicture>& picture,
     opaque_rect_(opaque_rect),
     picture_(picture),
     pixel_refs_(pixel_refs),
-    cell_size_(layer_rect.size()) {
+    cell_size_(layer_rect.size()),
+    is_suitable_for_gpu_rasterization_(true),
+    analysis_cache_(new PictureAnalysisCache) {
 }
 
 Picture::~Picture() {
@@ -214,6 +226,9 @@ void Picture::CloneForDrawing(int num_threads) {
                       layer_rect_,
                       opaque_rect_,
                       pixel_refs_));
+      // The clones play back the same recording, so their analysis results
+      // apply to this picture too.
+      clone->analysis_cache_ = analysis_cache_;
       clones_.push_back(clone);
 
       clone->EmitTraceSnapshotAlias(this);
@@ -260,6 +275,27 @@ void Picture::Record(ContentLayerClient* painter,
   EmitTraceSnapshot();
 }
 
+void Picture::AnalyzeForGpuRasterization() {
+  TRACE_EVENT2("cc", "Picture::AnalyzeForGpuRasterization",
+               "width", layer_rect_.width(),
+               "height", layer_rect_.height());
+
+  DCHECK(picture_);
+  SkBitmap empty_bitmap;
+  empty_bitmap.setConfig(SkBitmap::kNo_Config,
+                         layer_rect_.width(),
+                         layer_rect_.height());
+  skia::AnalysisDevice device(empty_bitmap);
+  skia::AnalysisCanvas canvas(&device);
+  // Play back without |canvas| as the callback, as that would stop at the
+  // first text draw.
+  picture_->draw(&canvas);
+
+  is_suitable_for_gpu_rasterization_ =
+      canvas.GetSlowPathCount() <= kMaxSlowPathsForGpuRasterization &&
+      canvas.GetTextDrawCount() <= kMaxTextDrawsForGpuRasterization;
+}
+
 void Picture::GatherPixelRefs(
     const SkTileGridPicture::TileGridInfo& tile_grid_info) {
   TRACE_EVENT2("cc", "Picture::GatherPixelRefs",
@@ -19,6 +19,7 @@
 #include "base/threading/thread_checker.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/region.h"
+#include "cc/resources/picture_analysis_cache.h"
 #include "skia/ext/refptr.h"
 #include "third_party/skia/include/core/SkTileGridPicture.h"
 #include "ui/gfx/rect.h"
@@ -113,6 +114,22 @@ class CC_EXPORT Picture
 
   bool WillPlayBackBitmaps() const { return picture_->willPlayBackBitmaps(); }
 
+  // Plays back the recording to find content that is slow to rasterize on
+  // the GPU, such as many anti-aliased concave paths or text runs. Must be
+  // called on the thread that recorded the picture.
+  void AnalyzeForGpuRasterization();
+
+  // False if AnalyzeForGpuRasterization() found the picture should be
+  // rasterized in software. True if it hasn't been analyzed.
+  bool is_suitable_for_gpu_rasterization() const {
+    return is_suitable_for_gpu_rasterization_;
+  }
+
+  // Results of analyzing rects of this picture, shared with its clones.
+  PictureAnalysisCache* analysis_cache() const {
+    return analysis_cache_.get();
+  }
+
  private:
   explicit Picture(const gfx::Rect& layer_rect);
   // This constructor assumes SkPicture is already ref'd and transfers
@@ -150,6 +167,10 @@ class CC_EXPORT Picture
   gfx::Point max_pixel_cell_;
   gfx::Size cell_size_;
 
+  bool is_suitable_for_gpu_rasterization_;
+
+  scoped_refptr<PictureAnalysisCache> analysis_cache_;
+
   scoped_refptr<base::debug::ConvertableToTraceFormat>
     AsTraceableRasterData(float scale) const;
   scoped_refptr<base::debug::ConvertableToTraceFormat>
@@ -0,0 +1,86 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/picture_analysis_cache.h"
+
+#include "cc/base/region.h"
+
+namespace cc {
+
+namespace {
+
+// Bounds the memory and lookup cost per picture. A picture usually covers a
+// single pile cell, which only overlaps a handful of tiles at each scale.
+const size_t kMaxEntries = 64;
+
+}  // namespace
+
+PictureAnalysisCache::PictureAnalysisCache() {}
+
+PictureAnalysisCache::~PictureAnalysisCache() {}
+
+bool PictureAnalysisCache::Lookup(const gfx::Rect& layer_rect,
+                                  bool* is_solid_color,
+                                  SkColor* solid_color,
+                                  bool* has_text) const {
+  base::AutoLock lock(lock_);
+
+  Region solid_region;
+  SkColor color = SK_ColorTRANSPARENT;
+  bool solid_has_text = false;
+  for (std::deque<Entry>::const_iterator it = entries_.begin();
+       it != entries_.end();
+       ++it) {
+    if (!it->layer_rect.Intersects(layer_rect))
+      continue;
+
+    if (!it->is_solid_color) {
+      if (it->layer_rect != layer_rect)
+        continue;
+      *is_solid_color = false;
+      *has_text = it->has_text;
+      return true;
+    }
+
+    // Solid rects of different colors overlapping |layer_rect| mean that it
+    // isn't solid, but say nothing about whether it has text.
+    if (!solid_region.IsEmpty() && it->solid_color != color)
+      return false;
+    color = it->solid_color;
+    solid_has_text |= it->has_text;
+    solid_region.Union(it->layer_rect);
+  }
+
+  if (solid_region.IsEmpty() || !solid_region.Contains(layer_rect))
+    return false;
+
+  *is_solid_color = true;
+  *solid_color = color;
+  *has_text = solid_has_text;
+  return true;
+}
+
+void PictureAnalysisCache::Add(const gfx::Rect& layer_rect,
+                               bool is_solid_color,
+                               SkColor solid_color,
+                               bool has_text) {
+  base::AutoLock lock(lock_);
+
+  if (entries_.size() == kMaxEntries)
+    entries_.pop_front();
+
+  Entry entry;
+  entry.layer_rect = layer_rect;
+  entry.is_solid_color = is_solid_color;
+  entry.solid_color = solid_color;
+  entry.has_text = has_text;
+  entries_.push_back(entry);
+}
+
+size_t PictureAnalysisCache::num_entries() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace cc
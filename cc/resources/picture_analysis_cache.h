@@ -0,0 +1,65 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_PICTURE_ANALYSIS_CACHE_H_
+#define CC_RESOURCES_PICTURE_ANALYSIS_CACHE_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "cc/base/cc_export.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "ui/gfx/rect.h"
+
+namespace cc {
+
+// Remembers the results of analyzing rects of a single Picture, so that tiles
+// covering content that was already analyzed, on another tree or at another
+// contents scale, don't need to be analyzed or rasterized again. Shared by a
+// picture and its clones, and may be used from any thread.
+class CC_EXPORT PictureAnalysisCache
+    : public base::RefCountedThreadSafe<PictureAnalysisCache> {
+ public:
+  PictureAnalysisCache();
+
+  // Returns true if the analysis of |layer_rect| can be derived from earlier
+  // results, and fills in the out parameters. A rect is known to be solid if
+  // it is covered by rects that were found to be solid in the same color.
+  // Results for rects that are not solid are only reused for the exact same
+  // rect.
+  bool Lookup(const gfx::Rect& layer_rect,
+              bool* is_solid_color,
+              SkColor* solid_color,
+              bool* has_text) const;
+
+  void Add(const gfx::Rect& layer_rect,
+           bool is_solid_color,
+           SkColor solid_color,
+           bool has_text);
+
+  size_t num_entries() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<PictureAnalysisCache>;
+  ~PictureAnalysisCache();
+
+  struct Entry {
+    gfx::Rect layer_rect;
+    bool is_solid_color;
+    SkColor solid_color;
+    bool has_text;
+  };
+
+  mutable base::Lock lock_;
+  // Oldest first.
+  std::deque<Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(PictureAnalysisCache);
+};
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_PICTURE_ANALYSIS_CACHE_H_
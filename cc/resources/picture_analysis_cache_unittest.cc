@@ -0,0 +1,80 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/picture_analysis_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+TEST(PictureAnalysisCacheTest, SolidRectsCoverSubrects) {
+  scoped_refptr<PictureAnalysisCache> cache = new PictureAnalysisCache;
+  SkColor red = SkColorSetARGB(255, 255, 0, 0);
+  cache->Add(gfx::Rect(0, 0, 100, 100), true, red, false);
+  cache->Add(gfx::Rect(100, 0, 100, 100), true, red, false);
+
+  bool is_solid_color = false;
+  SkColor solid_color = SK_ColorTRANSPARENT;
+  bool has_text = true;
+  EXPECT_TRUE(cache->Lookup(
+      gfx::Rect(50, 10, 100, 50), &is_solid_color, &solid_color, &has_text));
+  EXPECT_TRUE(is_solid_color);
+  EXPECT_EQ(red, solid_color);
+  EXPECT_FALSE(has_text);
+
+  // Only partially covered.
+  EXPECT_FALSE(cache->Lookup(
+      gfx::Rect(150, 50, 100, 100), &is_solid_color, &solid_color, &has_text));
+}
+
+TEST(PictureAnalysisCacheTest, DifferentColorsAreNotSolid) {
+  scoped_refptr<PictureAnalysisCache> cache = new PictureAnalysisCache;
+  cache->Add(gfx::Rect(0, 0, 100, 100), true, SK_ColorRED, false);
+  cache->Add(gfx::Rect(100, 0, 100, 100), true, SK_ColorBLUE, false);
+
+  bool is_solid_color = false;
+  SkColor solid_color = SK_ColorTRANSPARENT;
+  bool has_text = false;
+  EXPECT_FALSE(cache->Lookup(
+      gfx::Rect(50, 0, 100, 100), &is_solid_color, &solid_color, &has_text));
+  EXPECT_TRUE(cache->Lookup(
+      gfx::Rect(100, 0, 100, 100), &is_solid_color, &solid_color, &has_text));
+  EXPECT_TRUE(is_solid_color);
+  EXPECT_EQ(SK_ColorBLUE, solid_color);
+}
+
+TEST(PictureAnalysisCacheTest, NonSolidOnlyMatchesExactRect) {
+  scoped_refptr<PictureAnalysisCache> cache = new PictureAnalysisCache;
+  cache->Add(gfx::Rect(0, 0, 100, 100), false, SK_ColorTRANSPARENT, true);
+
+  bool is_solid_color = true;
+  SkColor solid_color = SK_ColorTRANSPARENT;
+  bool has_text = false;
+  EXPECT_TRUE(cache->Lookup(
+      gfx::Rect(0, 0, 100, 100), &is_solid_color, &solid_color, &has_text));
+  EXPECT_FALSE(is_solid_color);
+  EXPECT_TRUE(has_text);
+
+  EXPECT_FALSE(cache->Lookup(
+      gfx::Rect(0, 0, 50, 50), &is_solid_color, &solid_color, &has_text));
+}
+
+TEST(PictureAnalysisCacheTest, OldestEntriesAreDropped) {
+  scoped_refptr<PictureAnalysisCache> cache = new PictureAnalysisCache;
+  for (int i = 0; i < 100; ++i)
+    cache->Add(gfx::Rect(i, 0, 1, 1), true, SK_ColorRED, false);
+  EXPECT_GT(100u, cache->num_entries());
+
+  bool is_solid_color = false;
+  SkColor solid_color = SK_ColorTRANSPARENT;
+  bool has_text = false;
+  EXPECT_FALSE(cache->Lookup(
+      gfx::Rect(0, 0, 1, 1), &is_solid_color, &solid_color, &has_text));
+  EXPECT_TRUE(cache->Lookup(
+      gfx::Rect(99, 0, 1, 1), &is_solid_color, &solid_color, &has_text));
+}
+
+}  // namespace
+}  // namespace cc
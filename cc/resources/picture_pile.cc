@@ -141,7 +141,9 @@ float ClusterTiles(const std::vector<gfx::Rect>& invalid_tiles,
 
 namespace cc {
 
-PicturePile::PicturePile() {
+PicturePile::PicturePile()
+    : analyze_for_gpu_rasterization_(false),
+      is_suitable_for_gpu_rasterization_(true) {
 }
 
 PicturePile::~PicturePile() {
@@ -206,8 +208,10 @@ bool PicturePile::Update(
   ClusterTiles(invalid_tiles, &record_rects);
 
   if (record_rects.empty()) {
-    if (invalidated)
+    if (invalidated) {
       UpdateRecordedRegion();
+      UpdateIsSuitableForGpuRasterization();
+    }
     return invalidated;
   }
 
@@ -246,6 +250,9 @@ bool PicturePile::Update(
       stats_instrumentation->AddRecord(best_duration, recorded_pixel_count);
     }
 
+    if (analyze_for_gpu_rasterization_)
+      picture->AnalyzeForGpuRasterization();
+
     for (TilingData::Iterator it(&tiling_, record_rect);
         it; ++it) {
       const PictureMapKey& key = it.index();
@@ -258,7 +265,23 @@ bool PicturePile::Update(
   }
 
   UpdateRecordedRegion();
+  UpdateIsSuitableForGpuRasterization();
   return true;
 }
 
+void PicturePile::UpdateIsSuitableForGpuRasterization() {
+  is_suitable_for_gpu_rasterization_ = true;
+  if (!analyze_for_gpu_rasterization_)
+    return;
+  for (PictureMap::const_iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    Picture* picture = it->second.GetPicture();
+    if (picture && !picture->is_suitable_for_gpu_rasterization()) {
+      is_suitable_for_gpu_rasterization_ = false;
+      return;
+    }
+  }
+}
+
 }  // namespace cc
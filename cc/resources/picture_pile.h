@@ -37,12 +37,29 @@ class CC_EXPORT PicturePile : public PicturePileBase {
     show_debug_picture_borders_ = show;
   }
 
+  // When set, pictures are analyzed as they are recorded, to tell whether
+  // the pile is suitable for GPU rasterization.
+  void set_analyze_for_gpu_rasterization(bool analyze) {
+    analyze_for_gpu_rasterization_ = analyze;
+  }
+
+  // False if any recorded picture is slow to rasterize on the GPU. Only
+  // updated by Update(), and only while analysis is enabled.
+  bool is_suitable_for_gpu_rasterization() const {
+    return is_suitable_for_gpu_rasterization_;
+  }
+
  protected:
   virtual ~PicturePile();
 
  private:
   friend class PicturePileImpl;
 
+  void UpdateIsSuitableForGpuRasterization();
+
+  bool analyze_for_gpu_rasterization_;
+  bool is_suitable_for_gpu_rasterization_;
+
   DISALLOW_COPY_AND_ASSIGN(PicturePile);
 };
 
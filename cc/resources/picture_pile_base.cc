@@ -195,6 +195,16 @@ bool PicturePileBase::CanRaster(float contents_scale,
   return recorded_region_.Contains(layer_rect);
 }
 
+bool PicturePileBase::HasRecentInvalidations() const {
+  for (PictureMap::const_iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    if (it->second.WasRecentlyInvalidated())
+      return true;
+  }
+  return false;
+}
+
 gfx::Rect PicturePileBase::PaddedRect(const PictureMapKey& key) {
   gfx::Rect tile = tiling_.TileBounds(key.first, key.second);
   return PadRect(tile);
@@ -41,6 +41,8 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   gfx::Rect tile_bounds(int x, int y) const { return tiling_.TileBounds(x, y); }
   bool HasRecordingAt(int x, int y);
   bool CanRaster(float contents_scale, const gfx::Rect& content_rect);
+  // Whether any picture was invalidated in the last frames tracked.
+  bool HasRecentInvalidations() const;
 
   static void ComputeTileGridInfo(const gfx::Size& tile_grid_size,
                                   SkTileGridPicture::TileGridInfo* info);
@@ -66,6 +68,10 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
     void SetPicture(scoped_refptr<Picture> picture);
     Picture* GetPicture() const;
 
+    bool WasRecentlyInvalidated() const {
+      return invalidation_history_.any();
+    }
+
     float GetInvalidationFrequencyForTesting() const {
       return GetInvalidationFrequency();
     }
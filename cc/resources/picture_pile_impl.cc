@@ -325,10 +325,15 @@ void PicturePileImpl::AnalyzeInRect(
   DCHECK(analysis);
   TRACE_EVENT0("cc", "PicturePileImpl::AnalyzeInRect");
 
-  gfx::Rect layer_rect = gfx::ScaleToEnclosingRect(
-      content_rect, 1.0f / contents_scale);
-
-  layer_rect.Intersect(gfx::Rect(tiling_.total_size()));
+  gfx::Rect layer_rect = AnalysisLayerRect(content_rect, contents_scale);
+
+  Picture* picture = GetSinglePictureInRect(layer_rect);
+  if (picture &&
+      picture->analysis_cache()->Lookup(layer_rect,
+                                        &analysis->is_solid_color,
+                                        &analysis->solid_color,
+                                        &analysis->has_text))
+    return;
 
   SkBitmap empty_bitmap;
   empty_bitmap.setConfig(SkBitmap::kNo_Config,
@@ -341,6 +346,52 @@ void PicturePileImpl::AnalyzeInRect(
 
   analysis->is_solid_color = canvas.GetColorIfSolid(&analysis->solid_color);
   analysis->has_text = canvas.HasText();
+
+  if (picture) {
+    picture->analysis_cache()->Add(layer_rect,
+                                   analysis->is_solid_color,
+                                   analysis->solid_color,
+                                   analysis->has_text);
+  }
+}
+
+bool PicturePileImpl::GetCachedAnalysis(const gfx::Rect& content_rect,
+                                        float contents_scale,
+                                        Analysis* analysis) const {
+  DCHECK(analysis);
+  gfx::Rect layer_rect = AnalysisLayerRect(content_rect, contents_scale);
+  Picture* picture = GetSinglePictureInRect(layer_rect);
+  if (!picture)
+    return false;
+  return picture->analysis_cache()->Lookup(layer_rect,
+                                           &analysis->is_solid_color,
+                                           &analysis->solid_color,
+                                           &analysis->has_text);
+}
+
+gfx::Rect PicturePileImpl::AnalysisLayerRect(const gfx::Rect& content_rect,
+                                             float contents_scale) const {
+  gfx::Rect layer_rect = gfx::ScaleToEnclosingRect(
+      content_rect, 1.0f / contents_scale);
+  layer_rect.Intersect(gfx::Rect(tiling_.total_size()));
+  return layer_rect;
+}
+
+Picture* PicturePileImpl::GetSinglePictureInRect(
+    const gfx::Rect& layer_rect) const {
+  Picture* single_picture = NULL;
+  for (TilingData::Iterator tile_iter(&tiling_, layer_rect);
+       tile_iter; ++tile_iter) {
+    PictureMap::const_iterator map_iter =
+        picture_map_.find(tile_iter.index());
+    if (map_iter == picture_map_.end())
+      return NULL;
+    Picture* picture = map_iter->second.GetPicture();
+    if (!picture || (single_picture && picture != single_picture))
+      return NULL;
+    single_picture = picture;
+  }
+  return single_picture;
 }
 
 PicturePileImpl::Analysis::Analysis()
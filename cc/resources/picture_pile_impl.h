@@ -80,6 +80,13 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
                      Analysis* analysis,
                      RenderingStatsInstrumentation* stats_instrumentation);
 
+  // Returns true if the analysis of |content_rect| is already known from
+  // earlier calls to AnalyzeInRect() on the same recording, at any scale and
+  // from any pile sharing its pictures.
+  bool GetCachedAnalysis(const gfx::Rect& content_rect,
+                         float contents_scale,
+                         Analysis* analysis) const;
+
   class CC_EXPORT PixelRefIterator {
    public:
     PixelRefIterator(const gfx::Rect& content_rect,
@@ -127,6 +134,14 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
 
   PicturePileImpl(const PicturePileImpl* other, unsigned thread_index);
 
+  // The layer space rect covered by analyzing |content_rect|.
+  gfx::Rect AnalysisLayerRect(const gfx::Rect& content_rect,
+                              float contents_scale) const;
+
+  // Returns the picture that every pile cell overlapping |layer_rect| is
+  // recorded in, or NULL if there isn't exactly one.
+  Picture* GetSinglePictureInRect(const gfx::Rect& layer_rect) const;
+
  private:
   typedef std::map<Picture*, Region> PictureRegionMap;
   void CoalesceRasters(const gfx::Rect& canvas_rect,
@@ -147,6 +147,43 @@ TEST(PicturePileImplTest, AnalyzeIsSolidEmpty) {
   EXPECT_EQ(analysis.solid_color, SkColorSetARGB(0, 0, 0, 0));
 }
 
+TEST(PicturePileImplTest, AnalysisIsCachedAcrossScales) {
+  gfx::Size tile_size(400, 400);
+  gfx::Size layer_bounds(400, 400);
+
+  scoped_refptr<FakePicturePileImpl> pile =
+      FakePicturePileImpl::CreateFilledPile(tile_size, layer_bounds);
+
+  SkColor solid_color = SkColorSetARGB(255, 12, 23, 34);
+  SkPaint solid_paint;
+  solid_paint.setColor(solid_color);
+  pile->add_draw_rect_with_paint(gfx::Rect(0, 0, 400, 400), solid_paint);
+  pile->RerecordPile();
+
+  PicturePileImpl::Analysis analysis;
+  EXPECT_FALSE(
+      pile->GetCachedAnalysis(gfx::Rect(0, 0, 200, 200), 1.f, &analysis));
+
+  pile->AnalyzeInRect(gfx::Rect(0, 0, 200, 200), 1.f, &analysis);
+  pile->AnalyzeInRect(gfx::Rect(200, 0, 200, 200), 1.f, &analysis);
+
+  // A rect at another scale, straddling both analyzed rects.
+  PicturePileImpl::Analysis cached_analysis;
+  EXPECT_TRUE(pile->GetCachedAnalysis(
+      gfx::Rect(200, 0, 400, 200), 2.f, &cached_analysis));
+  EXPECT_TRUE(cached_analysis.is_solid_color);
+  EXPECT_EQ(solid_color, cached_analysis.solid_color);
+
+  // Content that hasn't been analyzed yet.
+  EXPECT_FALSE(pile->GetCachedAnalysis(
+      gfx::Rect(0, 200, 200, 200), 1.f, &cached_analysis));
+
+  // Re-recording replaces the pictures, and with them the results.
+  pile->RerecordPile();
+  EXPECT_FALSE(pile->GetCachedAnalysis(
+      gfx::Rect(0, 0, 200, 200), 1.f, &cached_analysis));
+}
+
 TEST(PicturePileImplTest, PixelRefIteratorEmpty) {
   gfx::Size tile_size(128, 128);
   gfx::Size layer_bounds(256, 256);
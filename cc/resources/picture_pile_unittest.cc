@@ -205,6 +205,48 @@ TEST(PicturePileTest, InvalidateOnTileBoundaryInflated) {
   }
 }
 
+TEST(PicturePileTest, HasRecentInvalidations) {
+  FakeContentLayerClient client;
+  FakeRenderingStatsInstrumentation stats_instrumentation;
+  scoped_refptr<TestPicturePile> pile = new TestPicturePile;
+  SkColor background_color = SK_ColorBLUE;
+
+  gfx::Size layer_size = pile->tiling().max_texture_size();
+  pile->Resize(layer_size);
+  pile->SetTileGridSize(gfx::Size(1000, 1000));
+  pile->SetMinContentsScale(0.125f);
+
+  // Record without invalidating anything.
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(),
+               gfx::Rect(layer_size),
+               1,
+               &stats_instrumentation);
+  EXPECT_FALSE(pile->HasRecentInvalidations());
+
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(10, 10, 1, 1),
+               gfx::Rect(layer_size),
+               2,
+               &stats_instrumentation);
+  EXPECT_TRUE(pile->HasRecentInvalidations());
+
+  // The invalidation ages out once enough frames pass without another.
+  int frame = 3 + TestPicturePile::PictureInfo::INVALIDATION_FRAMES_TRACKED;
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(),
+               gfx::Rect(layer_size),
+               frame,
+               &stats_instrumentation);
+  EXPECT_FALSE(pile->HasRecentInvalidations());
+}
+
 TEST(PicturePileTest, StopRecordingOffscreenInvalidations) {
   FakeContentLayerClient client;
   FakeRenderingStatsInstrumentation stats_instrumentation;
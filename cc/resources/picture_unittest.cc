@@ -416,5 +416,41 @@ TEST(PictureTest, CreateFromSkpValue) {
   EXPECT_EQ(100, one_rect_picture_check->OpaqueRect().width());
   EXPECT_EQ(200, one_rect_picture_check->OpaqueRect().height());
 }
+
+TEST(PictureTest, AnalyzeForGpuRasterization) {
+  gfx::Rect layer_rect(100, 100);
+
+  SkTileGridPicture::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  FakeContentLayerClient content_layer_client;
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  content_layer_client.add_draw_rect(layer_rect, paint);
+
+  scoped_refptr<Picture> picture = Picture::Create(
+      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+  picture->AnalyzeForGpuRasterization();
+  EXPECT_TRUE(picture->is_suitable_for_gpu_rasterization());
+
+  // Many anti-aliased concave paths are slow with the GPU.
+  SkPath path;
+  path.moveTo(0, 0);
+  path.lineTo(50, 10);
+  path.lineTo(100, 0);
+  path.lineTo(50, 100);
+  path.close();
+  for (int i = 0; i < 10; ++i)
+    content_layer_client.add_draw_path(path, paint);
+
+  picture = Picture::Create(
+      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+  EXPECT_TRUE(picture->is_suitable_for_gpu_rasterization());
+  picture->AnalyzeForGpuRasterization();
+  EXPECT_FALSE(picture->is_suitable_for_gpu_rasterization());
+}
+
 }  // namespace
 }  // namespace cc
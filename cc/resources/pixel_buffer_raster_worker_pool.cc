@@ -25,6 +25,14 @@ bool WasCanceled(const internal::RasterWorkerPoolTask* task) {
   return !task->HasFinishedRunning();
 }
 
+// Returns the size of the pixel buffer |resource| is rasterized into. ETC1
+// content is rasterized as N32 pixels before being compressed in place.
+size_t PixelBufferSizeInBytes(const Resource* resource) {
+  if (resource->format() == ETC1)
+    return Resource::MemorySizeBytes(resource->size(), RGBA_8888);
+  return resource->bytes();
+}
+
 }  // namespace
 
 // static
@@ -192,6 +200,15 @@ ResourceFormat PixelBufferRasterWorkerPool::GetResourceFormat() const {
   return resource_provider()->memory_efficient_texture_format();
 }
 
+bool PixelBufferRasterWorkerPool::SupportsResourceFormat(
+    ResourceFormat format) const {
+  // Raster tasks compress ETC1 content themselves, see
+  // ResourceProvider::MapPixelRasterBuffer().
+  if (format == ETC1)
+    return resource_provider()->use_compressed_texture_etc1();
+  return RasterWorkerPool::SupportsResourceFormat(format);
+}
+
 void PixelBufferRasterWorkerPool::CheckForCompletedTasks() {
   TRACE_EVENT0("cc", "PixelBufferRasterWorkerPool::CheckForCompletedTasks");
 
@@ -276,7 +293,7 @@ void PixelBufferRasterWorkerPool::OnRasterCompleted(
   resource_provider()->BeginSetPixels(task->resource()->id());
   has_performed_uploads_since_last_flush_ = true;
 
-  bytes_pending_upload_ += task->resource()->bytes();
+  bytes_pending_upload_ += PixelBufferSizeInBytes(task->resource());
   raster_tasks_with_pending_upload_.push_back(task);
   raster_task_states_[task] = UPLOADING;
 }
@@ -383,7 +400,7 @@ void PixelBufferRasterWorkerPool::CheckForCompletedUploads() {
     // It's now safe to release the pixel buffer and the shared memory.
     resource_provider()->ReleasePixelRasterBuffer(task->resource()->id());
 
-    bytes_pending_upload_ -= task->resource()->bytes();
+    bytes_pending_upload_ -= PixelBufferSizeInBytes(task->resource());
 
     DCHECK(std::find(completed_raster_tasks_.begin(),
                      completed_raster_tasks_.end(),
@@ -533,7 +550,7 @@ void PixelBufferRasterWorkerPool::ScheduleMoreTasks() {
 
     // All raster tasks need to be throttled by bytes of pending uploads.
     size_t new_bytes_pending_upload = bytes_pending_upload;
-    new_bytes_pending_upload += task->resource()->bytes();
+    new_bytes_pending_upload += PixelBufferSizeInBytes(task->resource());
     if (new_bytes_pending_upload > max_bytes_pending_upload_) {
       did_throttle_raster_tasks = true;
       break;
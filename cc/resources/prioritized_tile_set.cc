@@ -42,50 +42,84 @@ namespace {
 
 typedef std::vector<Tile*> TileVector;
 
-void SortBinTiles(ManagedTileBin bin, TileVector* tiles) {
+// Tiles are put in order this many at a time, at least, so that iterating
+// only part of a large bin doesn't sort all of it. The chunk size doubles
+// as more of the bin is consumed, which keeps the cost of ordering the whole
+// bin close to that of a single sort.
+const size_t kMinSortChunkSize = 64;
+
+bool BinNeedsSorting(ManagedTileBin bin) {
   switch (bin) {
     case NOW_AND_READY_TO_DRAW_BIN:
     case NEVER_BIN:
-      break;
+      return false;
     case NOW_BIN:
     case SOON_BIN:
     case EVENTUALLY_AND_ACTIVE_BIN:
     case EVENTUALLY_BIN:
     case AT_LAST_AND_ACTIVE_BIN:
     case AT_LAST_BIN:
-      std::sort(tiles->begin(), tiles->end(), BinComparator());
-      break;
+      return true;
     default:
       NOTREACHED();
+      return false;
   }
 }
 
+// Puts at least the first |count| unsorted tiles of |tiles|, which start at
+// |sorted_count|, in order and returns the new number of sorted tiles.
+size_t SortBinTiles(TileVector* tiles, size_t sorted_count, size_t count) {
+  size_t remaining = tiles->size() - sorted_count;
+  size_t chunk_size =
+      std::max(count, std::max(kMinSortChunkSize, sorted_count));
+
+  TileVector::iterator begin = tiles->begin() + sorted_count;
+  if (chunk_size >= remaining) {
+    std::sort(begin, tiles->end(), BinComparator());
+    return tiles->size();
+  }
+
+  // Move the |chunk_size| highest priority tiles to the front of the
+  // unsorted range, then sort only those.
+  TileVector::iterator chunk_end = begin + chunk_size;
+  std::nth_element(begin, chunk_end, tiles->end(), BinComparator());
+  std::sort(begin, chunk_end, BinComparator());
+  return sorted_count + chunk_size;
+}
+
 }  // namespace
 
 PrioritizedTileSet::PrioritizedTileSet() {
   for (int bin = 0; bin < NUM_BINS; ++bin)
-    bin_sorted_[bin] = true;
+    sorted_count_[bin] = 0;
 }
 
 PrioritizedTileSet::~PrioritizedTileSet() {}
 
 void PrioritizedTileSet::InsertTile(Tile* tile, ManagedTileBin bin) {
   tiles_[bin].push_back(tile);
-  bin_sorted_[bin] = false;
+  sorted_count_[bin] = 0;
 }
 
 void PrioritizedTileSet::Clear() {
   for (int bin = 0; bin < NUM_BINS; ++bin) {
     tiles_[bin].clear();
-    bin_sorted_[bin] = true;
+    sorted_count_[bin] = 0;
   }
 }
 
-void PrioritizedTileSet::SortBinIfNeeded(ManagedTileBin bin) {
-  if (!bin_sorted_[bin]) {
-    SortBinTiles(bin, &tiles_[bin]);
-    bin_sorted_[bin] = true;
+void PrioritizedTileSet::SortBinIfNeeded(ManagedTileBin bin, size_t index) {
+  TileVector& tiles = tiles_[bin];
+  if (index < sorted_count_[bin] || index >= tiles.size())
+    return;
+
+  if (!BinNeedsSorting(bin)) {
+    sorted_count_[bin] = tiles.size();
+    return;
   }
+
+  sorted_count_[bin] =
+      SortBinTiles(&tiles, sorted_count_[bin], index + 1 - sorted_count_[bin]);
 }
 
 PrioritizedTileSet::Iterator::Iterator(
@@ -94,7 +128,7 @@ PrioritizedTileSet::Iterator::Iterator(
       current_bin_(NOW_AND_READY_TO_DRAW_BIN),
       use_priority_ordering_(use_priority_ordering) {
   if (use_priority_ordering_)
-    tile_set_->SortBinIfNeeded(current_bin_);
+    tile_set_->SortBinIfNeeded(current_bin_, 0);
   iterator_ = tile_set->tiles_[current_bin_].begin();
   if (iterator_ == tile_set_->tiles_[current_bin_].end())
     AdvanceList();
@@ -112,8 +146,12 @@ PrioritizedTileSet::Iterator::operator++() {
   DCHECK(iterator_ != tile_set_->tiles_[current_bin_].end());
 
   ++iterator_;
-  if (iterator_ == tile_set_->tiles_[current_bin_].end())
+  if (iterator_ == tile_set_->tiles_[current_bin_].end()) {
     AdvanceList();
+  } else if (use_priority_ordering_) {
+    tile_set_->SortBinIfNeeded(
+        current_bin_, iterator_ - tile_set_->tiles_[current_bin_].begin());
+  }
   return *this;
 }
 
@@ -129,7 +167,7 @@ void PrioritizedTileSet::Iterator::AdvanceList() {
     current_bin_ = static_cast<ManagedTileBin>(current_bin_ + 1);
 
     if (use_priority_ordering_)
-      tile_set_->SortBinIfNeeded(current_bin_);
+      tile_set_->SortBinIfNeeded(current_bin_, 0);
 
     iterator_ = tile_set_->tiles_[current_bin_].begin();
     if (iterator_ != tile_set_->tiles_[current_bin_].end())
@@ -48,10 +48,13 @@ class CC_EXPORT PrioritizedTileSet {
  private:
   friend class Iterator;
 
-  void SortBinIfNeeded(ManagedTileBin bin);
+  // Ensures that the tiles of |bin| up to and including |index| are in
+  // priority order. Tiles past |index| may be left unsorted.
+  void SortBinIfNeeded(ManagedTileBin bin, size_t index);
 
   std::vector<Tile*> tiles_[NUM_BINS];
-  bool bin_sorted_[NUM_BINS];
+  // Number of tiles at the front of each bin that are in priority order.
+  size_t sorted_count_[NUM_BINS];
 };
 
 }  // namespace cc
@@ -634,6 +634,56 @@ TEST_F(PrioritizedTileSetTest, ManyTilesForEachBinDisablePriority) {
   EXPECT_FALSE(it);
 }
 
+TEST_F(PrioritizedTileSetTest, ManyTilesInOneBinSortedIncrementally) {
+  // A bin with more tiles than are sorted at once should still be returned
+  // in sorted order, and disabling priority ordering part way through should
+  // still return every tile exactly once.
+
+  std::vector<scoped_refptr<Tile> > soon_bins;
+
+  PrioritizedTileSet set;
+  PrioritizedTileSet disabled_set;
+  const int kTileCount = 1000;
+  for (int i = 0; i < kTileCount; ++i) {
+    scoped_refptr<Tile> tile = CreateTile();
+    // Spread distances so that insertion order isn't priority order.
+    tile->managed_state().distance_to_visible =
+        static_cast<float>((i * 7919) % kTileCount);
+    soon_bins.push_back(tile);
+    set.InsertTile(tile, SOON_BIN);
+    disabled_set.InsertTile(tile, SOON_BIN);
+  }
+
+  std::sort(soon_bins.begin(), soon_bins.end(), BinComparator());
+
+  PrioritizedTileSet::Iterator it(&set, true);
+  std::vector<scoped_refptr<Tile> >::iterator vector_it;
+  for (vector_it = soon_bins.begin(); vector_it != soon_bins.end();
+       ++vector_it) {
+    EXPECT_TRUE(*vector_it == *it);
+    ++it;
+  }
+  EXPECT_FALSE(it);
+
+  PrioritizedTileSet::Iterator disabled_it(&disabled_set, true);
+  std::vector<Tile*> seen;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(soon_bins[i] == *disabled_it);
+    ++disabled_it;
+  }
+  disabled_it.DisablePriorityOrdering();
+  for (; disabled_it; ++disabled_it)
+    seen.push_back(*disabled_it);
+
+  EXPECT_EQ(static_cast<size_t>(kTileCount - 10), seen.size());
+  std::sort(seen.begin(), seen.end());
+  EXPECT_TRUE(std::unique(seen.begin(), seen.end()) == seen.end());
+  for (vector_it = soon_bins.begin() + 10; vector_it != soon_bins.end();
+       ++vector_it) {
+    EXPECT_TRUE(std::binary_search(seen.begin(), seen.end(), vector_it->get()));
+  }
+}
+
 TEST_F(PrioritizedTileSetTest, TilesForFirstAndLastBins) {
   // Make sure that if we have empty lists between two non-empty lists,
   // we just get two tiles from the iterator.
@@ -14,12 +14,15 @@
 #include "base/values.h"
 #include "cc/debug/devtools_instrumentation.h"
 #include "cc/debug/traced_value.h"
+#include "cc/resources/etc1_encoder.h"
 #include "cc/resources/picture_pile_impl.h"
 #include "cc/resources/resource.h"
 #include "cc/resources/resource_provider.h"
 #include "gpu/command_buffer/client/gles2_interface.h"
 #include "skia/ext/paint_simplifier.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkDevice.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
@@ -106,6 +109,8 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     if (!canvas_ || analysis_.is_solid_color)
       return;
     Raster(picture_pile_->GetCloneForDrawingOnThread(thread_index));
+    if (resource()->format() == ETC1)
+      EncodeETC1InPlace();
   }
 
   // Overridden from internal::WorkerPoolTask:
@@ -129,7 +134,15 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
         base::StringPrintf(
             "Raster-%d-%d-%p", source_frame_number_, layer_id_, tile_id_)
             .c_str());
+    base::TimeTicks start_time = rendering_stats_->StartRecording();
     Raster(picture_pile_);
+    // Tasks only run on the origin thread when rasterizing with the GPU. As
+    // in Raster(), only high resolution tiles are recorded.
+    if (tile_resolution_ == HIGH_RESOLUTION) {
+      rendering_stats_->AddGpuRaster(
+          rendering_stats_->EndRecording(start_time),
+          content_rect_.width() * content_rect_.height());
+    }
     context_provider_->ContextGL()->PopGroupMarkerEXT();
   }
   virtual void CompleteOnOriginThread(internal::WorkerPoolTaskClient* client)
@@ -227,6 +240,33 @@ class RasterWorkerPoolTaskImpl : public internal::RasterWorkerPoolTask {
     }
   }
 
+  // Compresses the N32 pixels rasterized into the pixel buffer backing
+  // |canvas_| to ETC1, as ResourceProvider expects for ETC1 resources.
+  void EncodeETC1InPlace() {
+    TRACE_EVENT1("cc",
+                 "RasterWorkerPoolTaskImpl::EncodeETC1InPlace",
+                 "data",
+                 TracedValue::FromValue(DataAsValue().release()));
+
+    const SkBitmap& bitmap = canvas_->getDevice()->accessBitmap(false);
+    SkAutoLockPixels lock_pixels(bitmap);
+    uint8_t* pixels = static_cast<uint8_t*>(bitmap.getPixels());
+    DCHECK(pixels);
+
+    base::TimeTicks start_time = rendering_stats_->StartRecording();
+    EncodeETC1(pixels, resource()->size(), bitmap.rowBytes(), pixels);
+    base::TimeDelta duration = rendering_stats_->EndRecording(start_time);
+
+    if (rendering_stats_->record_rendering_stats()) {
+      rendering_stats_->AddETC1Encode(duration, resource()->size().GetArea());
+      HISTOGRAM_CUSTOM_COUNTS("Renderer4.ETC1EncodeTimeUS",
+                              duration.InMicroseconds(),
+                              0,
+                              100000,
+                              100);
+    }
+  }
+
   PicturePileImpl::Analysis analysis_;
   scoped_refptr<PicturePileImpl> picture_pile_;
   gfx::Rect content_rect_;
@@ -292,7 +332,7 @@ class ImageDecodeWorkerPoolTaskImpl : public internal::WorkerPoolTask {
   skia::RefPtr<SkPixelRef> pixel_ref_;
   int layer_id_;
   RenderingStatsInstrumentation* rendering_stats_;
-  const base::Callback<void(bool was_canceled)>& reply_;
+  const base::Callback<void(bool was_canceled)> reply_;
 
   DISALLOW_COPY_AND_ASSIGN(ImageDecodeWorkerPoolTaskImpl);
 };
@@ -558,6 +598,10 @@ void RasterWorkerPool::SetClient(RasterWorkerPoolClient* client) {
   client_ = client;
 }
 
+bool RasterWorkerPool::SupportsResourceFormat(ResourceFormat format) const {
+  return format == GetResourceFormat();
+}
+
 void RasterWorkerPool::Shutdown() {
   TRACE_EVENT0("cc", "RasterWorkerPool::Shutdown");
 
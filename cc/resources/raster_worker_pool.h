@@ -188,6 +188,9 @@ class CC_EXPORT RasterWorkerPool : public internal::WorkerPoolTaskClient {
   // Returns the format that needs to be used for raster task resources.
   virtual ResourceFormat GetResourceFormat() const = 0;
 
+  // Returns true if raster task resources may also use |format|.
+  virtual bool SupportsResourceFormat(ResourceFormat format) const;
+
  protected:
   typedef std::vector<scoped_refptr<internal::WorkerPoolTask> > TaskVector;
   typedef std::deque<scoped_refptr<internal::WorkerPoolTask> > TaskDeque;
@@ -115,7 +115,8 @@ class PerfImageRasterWorkerPoolImpl : public ImageRasterWorkerPool {
                                 ResourceProvider* resource_provider)
       : ImageRasterWorkerPool(task_graph_runner,
                               resource_provider,
-                              GL_TEXTURE_2D) {}
+                              GL_TEXTURE_2D,
+                              NULL) {}
 };
 
 class PerfDirectRasterWorkerPoolImpl : public DirectRasterWorkerPool {
@@ -140,7 +140,7 @@ class RasterWorkerPoolTest
         break;
       case RASTER_WORKER_POOL_TYPE_IMAGE:
         raster_worker_pool_ = ImageRasterWorkerPool::Create(
-            resource_provider_.get(), GL_TEXTURE_2D);
+            resource_provider_.get(), GL_TEXTURE_2D, NULL);
         break;
       case RASTER_WORKER_POOL_TYPE_DIRECT:
         raster_worker_pool_ = DirectRasterWorkerPool::Create(
@@ -0,0 +1,197 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/resource_atlas.h"
+
+#include "base/logging.h"
+#include "third_party/khronos/GLES2/gl2.h"
+
+namespace cc {
+
+namespace {
+
+// Texels around each image replicating its edges.
+const int kGutter = 1;
+
+}  // namespace
+
+ResourceAtlas::Allocation::Allocation() : resource_id(0) {}
+
+ResourceAtlas::Texture::Texture()
+    : resource_id(0), next_shelf_y(0), image_count(0) {}
+
+ResourceAtlas::Texture::~Texture() {}
+
+ResourceAtlas::ResourceAtlas(ResourceProvider* resource_provider,
+                             const gfx::Size& texture_size,
+                             ResourceFormat format,
+                             int max_image_dimension)
+    : resource_provider_(resource_provider),
+      texture_size_(texture_size),
+      format_(format),
+      max_image_dimension_(max_image_dimension) {
+  DCHECK(resource_provider_);
+  DCHECK_LE(max_image_dimension_ + 2 * kGutter, texture_size_.width());
+  DCHECK_LE(max_image_dimension_ + 2 * kGutter, texture_size_.height());
+}
+
+ResourceAtlas::~ResourceAtlas() { Clear(); }
+
+bool ResourceAtlas::CanAllocate(const gfx::Size& size) const {
+  return !size.IsEmpty() && size.width() <= max_image_dimension_ &&
+         size.height() <= max_image_dimension_;
+}
+
+bool ResourceAtlas::AddImage(const gfx::Size& size,
+                             const uint8_t* pixels,
+                             Allocation* allocation) {
+  if (!CanAllocate(size))
+    return false;
+
+  gfx::Size padded_size(size.width() + 2 * kGutter,
+                        size.height() + 2 * kGutter);
+  Texture* texture = NULL;
+  gfx::Point origin;
+  for (ScopedPtrVector<Texture>::iterator it = textures_.begin();
+       it != textures_.end();
+       ++it) {
+    // Textures that may still be read from can't be uploaded to, so images
+    // go into a new texture rather than waiting.
+    if (!resource_provider_->CanSetPixels((*it)->resource_id))
+      continue;
+    if (AllocateInTexture(*it, padded_size, &origin)) {
+      texture = *it;
+      break;
+    }
+  }
+
+  if (!texture) {
+    scoped_ptr<Texture> new_texture(new Texture);
+    new_texture->resource_id =
+        resource_provider_->CreateResource(texture_size_,
+                                           GL_CLAMP_TO_EDGE,
+                                           ResourceProvider::TextureUsageAny,
+                                           format_);
+    bool allocated =
+        AllocateInTexture(new_texture.get(), padded_size, &origin);
+    DCHECK(allocated);
+    texture = new_texture.get();
+    textures_.push_back(new_texture.Pass());
+  }
+
+  ++texture->image_count;
+  allocation->resource_id = texture->resource_id;
+  allocation->rect =
+      gfx::Rect(origin + gfx::Vector2d(kGutter, kGutter), size);
+  allocation->uv_rect =
+      gfx::RectF(static_cast<float>(allocation->rect.x()) /
+                     texture_size_.width(),
+                 static_cast<float>(allocation->rect.y()) /
+                     texture_size_.height(),
+                 static_cast<float>(size.width()) / texture_size_.width(),
+                 static_cast<float>(size.height()) / texture_size_.height());
+
+  UploadImage(texture->resource_id, allocation->rect, pixels);
+  return true;
+}
+
+void ResourceAtlas::RemoveImage(ResourceProvider::ResourceId resource_id) {
+  for (ScopedPtrVector<Texture>::iterator it = textures_.begin();
+       it != textures_.end();
+       ++it) {
+    if ((*it)->resource_id != resource_id)
+      continue;
+    DCHECK_GT((*it)->image_count, 0);
+    if (--(*it)->image_count == 0) {
+      resource_provider_->DeleteResource(resource_id);
+      textures_.erase(it);
+    }
+    return;
+  }
+  NOTREACHED();
+}
+
+void ResourceAtlas::Clear() {
+  for (ScopedPtrVector<Texture>::iterator it = textures_.begin();
+       it != textures_.end();
+       ++it)
+    resource_provider_->DeleteResource((*it)->resource_id);
+  textures_.clear();
+}
+
+bool ResourceAtlas::AllocateInTexture(Texture* texture,
+                                      const gfx::Size& padded_size,
+                                      gfx::Point* origin) {
+  // Use the shortest shelf the image fits on, to waste the least height.
+  Shelf* best_shelf = NULL;
+  for (size_t i = 0; i < texture->shelves.size(); ++i) {
+    Shelf* shelf = &texture->shelves[i];
+    if (shelf->height < padded_size.height() ||
+        shelf->next_x + padded_size.width() > texture_size_.width())
+      continue;
+    if (!best_shelf || shelf->height < best_shelf->height)
+      best_shelf = shelf;
+  }
+
+  // Start a new shelf when the image would leave most of the best one's
+  // height unused.
+  bool can_add_shelf =
+      texture->next_shelf_y + padded_size.height() <= texture_size_.height();
+  if (can_add_shelf &&
+      (!best_shelf || best_shelf->height > 2 * padded_size.height())) {
+    Shelf shelf;
+    shelf.y = texture->next_shelf_y;
+    shelf.height = padded_size.height();
+    shelf.next_x = 0;
+    texture->shelves.push_back(shelf);
+    texture->next_shelf_y += shelf.height;
+    best_shelf = &texture->shelves.back();
+  }
+
+  if (!best_shelf)
+    return false;
+
+  *origin = gfx::Point(best_shelf->next_x, best_shelf->y);
+  best_shelf->next_x += padded_size.width();
+  return true;
+}
+
+void ResourceAtlas::UploadImage(ResourceProvider::ResourceId resource_id,
+                                const gfx::Rect& rect,
+                                const uint8_t* pixels) {
+  gfx::Rect image_rect(rect.size());
+  int right = image_rect.width() - 1;
+  int bottom = image_rect.height() - 1;
+
+  // The image itself, then its edge rows, columns and corners copied out
+  // into the gutter.
+  struct {
+    gfx::Rect source_rect;
+    gfx::Vector2d dest_offset;
+  } uploads[] = {
+    { image_rect, gfx::Vector2d(0, 0) },
+    { gfx::Rect(0, 0, image_rect.width(), 1), gfx::Vector2d(0, -kGutter) },
+    { gfx::Rect(0, bottom, image_rect.width(), 1),
+      gfx::Vector2d(0, kGutter) },
+    { gfx::Rect(0, 0, 1, image_rect.height()), gfx::Vector2d(-kGutter, 0) },
+    { gfx::Rect(right, 0, 1, image_rect.height()),
+      gfx::Vector2d(kGutter, 0) },
+    { gfx::Rect(0, 0, 1, 1), gfx::Vector2d(-kGutter, -kGutter) },
+    { gfx::Rect(right, 0, 1, 1), gfx::Vector2d(kGutter, -kGutter) },
+    { gfx::Rect(0, bottom, 1, 1), gfx::Vector2d(-kGutter, kGutter) },
+    { gfx::Rect(right, bottom, 1, 1), gfx::Vector2d(kGutter, kGutter) },
+  };
+  for (size_t i = 0; i < arraysize(uploads); ++i) {
+    gfx::Vector2d dest_offset = rect.OffsetFromOrigin() +
+                                uploads[i].source_rect.OffsetFromOrigin() +
+                                uploads[i].dest_offset;
+    resource_provider_->SetPixels(resource_id,
+                                  pixels,
+                                  image_rect,
+                                  uploads[i].source_rect,
+                                  dest_offset);
+  }
+}
+
+}  // namespace cc
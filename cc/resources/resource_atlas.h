@@ -0,0 +1,110 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RESOURCES_RESOURCE_ATLAS_H_
+#define CC_RESOURCES_RESOURCE_ATLAS_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "cc/base/cc_export.h"
+#include "cc/base/scoped_ptr_vector.h"
+#include "cc/resources/resource_format.h"
+#include "cc/resources/resource_provider.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
+#include "ui/gfx/size.h"
+
+namespace cc {
+
+// Packs small images into shared textures, so that drawing many of them
+// doesn't need a texture per image and consecutive quads can be drawn from
+// the same texture. Each image gets a one texel gutter replicating its edges,
+// so that bilinear filtering at the edges behaves like GL_CLAMP_TO_EDGE.
+//
+// Textures are only written to while nothing may read from them, so images
+// added after a texture was drawn from go into a new texture.
+class CC_EXPORT ResourceAtlas {
+ public:
+  struct Allocation {
+    Allocation();
+
+    ResourceProvider::ResourceId resource_id;
+    // The image's texels within the texture, excluding the gutter.
+    gfx::Rect rect;
+    // |rect| in normalized texture coordinates.
+    gfx::RectF uv_rect;
+  };
+
+  static scoped_ptr<ResourceAtlas> Create(ResourceProvider* resource_provider,
+                                          const gfx::Size& texture_size,
+                                          ResourceFormat format,
+                                          int max_image_dimension) {
+    return make_scoped_ptr(new ResourceAtlas(
+        resource_provider, texture_size, format, max_image_dimension));
+  }
+  ~ResourceAtlas();
+
+  // Whether an image of |size| is small enough to be packed.
+  bool CanAllocate(const gfx::Size& size) const;
+
+  // Finds room for an image of |size| and uploads |pixels| into it. Returns
+  // false if the image isn't packed.
+  bool AddImage(const gfx::Size& size,
+                const uint8_t* pixels,
+                Allocation* allocation);
+
+  // Frees the space of an image added to the texture |resource_id|. Space is
+  // only reused once all images in a texture are removed, at which point the
+  // texture is deleted.
+  void RemoveImage(ResourceProvider::ResourceId resource_id);
+
+  // Deletes all textures, e.g. when their contents were evicted.
+  void Clear();
+
+  size_t num_textures() const { return textures_.size(); }
+
+ private:
+  // A row of images of at most |height| texels, filled left to right.
+  struct Shelf {
+    int y;
+    int height;
+    int next_x;
+  };
+
+  struct Texture {
+    Texture();
+    ~Texture();
+
+    ResourceProvider::ResourceId resource_id;
+    std::vector<Shelf> shelves;
+    int next_shelf_y;
+    int image_count;
+  };
+
+  ResourceAtlas(ResourceProvider* resource_provider,
+                const gfx::Size& texture_size,
+                ResourceFormat format,
+                int max_image_dimension);
+
+  // Finds room in |texture| for a |padded_size| rect including the gutter.
+  bool AllocateInTexture(Texture* texture,
+                         const gfx::Size& padded_size,
+                         gfx::Point* origin);
+  void UploadImage(ResourceProvider::ResourceId resource_id,
+                   const gfx::Rect& rect,
+                   const uint8_t* pixels);
+
+  ResourceProvider* resource_provider_;
+  gfx::Size texture_size_;
+  ResourceFormat format_;
+  int max_image_dimension_;
+  ScopedPtrVector<Texture> textures_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceAtlas);
+};
+
+}  // namespace cc
+
+#endif  // CC_RESOURCES_RESOURCE_ATLAS_H_
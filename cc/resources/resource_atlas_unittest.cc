@@ -0,0 +1,142 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/resource_atlas.h"
+
+#include "cc/output/software_output_device.h"
+#include "cc/test/fake_output_surface.h"
+#include "cc/test/fake_output_surface_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace cc {
+namespace {
+
+class ResourceAtlasTest : public testing::Test {
+ protected:
+  ResourceAtlasTest()
+      : output_surface_(FakeOutputSurface::CreateSoftware(
+            make_scoped_ptr(new SoftwareOutputDevice))) {
+    CHECK(output_surface_->BindToClient(&output_surface_client_));
+    resource_provider_ =
+        ResourceProvider::Create(output_surface_.get(), NULL, 0, false, 1);
+    atlas_ = ResourceAtlas::Create(
+        resource_provider_.get(), gfx::Size(64, 64), RGBA_8888, 16);
+  }
+
+  // Adds a |size| image filled with |color|, with the top left texel set to
+  // |corner_color|.
+  bool AddImage(const gfx::Size& size,
+                uint32_t color,
+                uint32_t corner_color,
+                ResourceAtlas::Allocation* allocation) {
+    std::vector<uint32_t> pixels(size.GetArea(), color);
+    pixels[0] = corner_color;
+    return atlas_->AddImage(
+        size, reinterpret_cast<uint8_t*>(&pixels[0]), allocation);
+  }
+
+  uint32_t TexelAt(ResourceProvider::ResourceId id, int x, int y) {
+    ResourceProvider::ScopedReadLockSoftware lock(resource_provider_.get(),
+                                                  id);
+    return *lock.sk_bitmap()->getAddr32(x, y);
+  }
+
+  FakeOutputSurfaceClient output_surface_client_;
+  scoped_ptr<FakeOutputSurface> output_surface_;
+  scoped_ptr<ResourceProvider> resource_provider_;
+  scoped_ptr<ResourceAtlas> atlas_;
+};
+
+TEST_F(ResourceAtlasTest, PacksImagesIntoOneTexture) {
+  ResourceAtlas::Allocation first;
+  ResourceAtlas::Allocation second;
+  ASSERT_TRUE(AddImage(gfx::Size(8, 4), 0xff0000ff, 0xff0000ff, &first));
+  ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0xff00ff00, 0xff00ff00, &second));
+
+  EXPECT_EQ(1u, atlas_->num_textures());
+  EXPECT_EQ(first.resource_id, second.resource_id);
+  EXPECT_EQ(gfx::Size(8, 4), first.rect.size());
+  EXPECT_EQ(gfx::Size(4, 4), second.rect.size());
+
+  // The images and their gutters don't overlap.
+  gfx::Rect first_padded = first.rect;
+  first_padded.Inset(-1, -1);
+  gfx::Rect second_padded = second.rect;
+  second_padded.Inset(-1, -1);
+  EXPECT_FALSE(first_padded.Intersects(second_padded));
+  EXPECT_TRUE(gfx::Rect(64, 64).Contains(first_padded));
+  EXPECT_TRUE(gfx::Rect(64, 64).Contains(second_padded));
+
+  EXPECT_FLOAT_EQ(first.rect.x() / 64.f, first.uv_rect.x());
+  EXPECT_FLOAT_EQ(first.rect.y() / 64.f, first.uv_rect.y());
+  EXPECT_FLOAT_EQ(8 / 64.f, first.uv_rect.width());
+  EXPECT_FLOAT_EQ(4 / 64.f, first.uv_rect.height());
+}
+
+TEST_F(ResourceAtlasTest, GutterReplicatesEdges) {
+  ResourceAtlas::Allocation allocation;
+  ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0xff00ff00, 0xffff0000, &allocation));
+
+  int x = allocation.rect.x();
+  int y = allocation.rect.y();
+  EXPECT_EQ(0xffff0000u, TexelAt(allocation.resource_id, x, y));
+  EXPECT_EQ(0xffff0000u, TexelAt(allocation.resource_id, x - 1, y - 1));
+  EXPECT_EQ(0xffff0000u, TexelAt(allocation.resource_id, x - 1, y));
+  EXPECT_EQ(0xffff0000u, TexelAt(allocation.resource_id, x, y - 1));
+  EXPECT_EQ(0xff00ff00u, TexelAt(allocation.resource_id, x + 1, y - 1));
+  EXPECT_EQ(0xff00ff00u,
+            TexelAt(allocation.resource_id,
+                    allocation.rect.right(),
+                    allocation.rect.bottom()));
+}
+
+TEST_F(ResourceAtlasTest, LargeImagesAreNotPacked) {
+  ResourceAtlas::Allocation allocation;
+  EXPECT_FALSE(AddImage(gfx::Size(17, 4), 0, 0, &allocation));
+  EXPECT_FALSE(AddImage(gfx::Size(4, 17), 0, 0, &allocation));
+  EXPECT_EQ(0u, atlas_->num_textures());
+}
+
+TEST_F(ResourceAtlasTest, FullTextureStartsAnother) {
+  // Each 16x16 image takes 18x18 texels with its gutter, so only 9 fit.
+  ResourceAtlas::Allocation allocation;
+  for (int i = 0; i < 9; ++i)
+    ASSERT_TRUE(AddImage(gfx::Size(16, 16), 0, 0, &allocation));
+  EXPECT_EQ(1u, atlas_->num_textures());
+
+  ASSERT_TRUE(AddImage(gfx::Size(16, 16), 0, 0, &allocation));
+  EXPECT_EQ(2u, atlas_->num_textures());
+}
+
+TEST_F(ResourceAtlasTest, TexturesInUseAreNotWritten) {
+  ResourceAtlas::Allocation first;
+  ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0, 0, &first));
+
+  ResourceAtlas::Allocation second;
+  {
+    ResourceProvider::ScopedReadLockSoftware lock(resource_provider_.get(),
+                                                  first.resource_id);
+    ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0, 0, &second));
+  }
+  EXPECT_NE(first.resource_id, second.resource_id);
+  EXPECT_EQ(2u, atlas_->num_textures());
+}
+
+TEST_F(ResourceAtlasTest, RemovingAllImagesDeletesTexture) {
+  ResourceAtlas::Allocation first;
+  ResourceAtlas::Allocation second;
+  ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0, 0, &first));
+  ASSERT_TRUE(AddImage(gfx::Size(4, 4), 0, 0, &second));
+  EXPECT_EQ(1u, resource_provider_->num_resources());
+
+  atlas_->RemoveImage(first.resource_id);
+  EXPECT_EQ(1u, atlas_->num_textures());
+  atlas_->RemoveImage(second.resource_id);
+  EXPECT_EQ(0u, atlas_->num_textures());
+  EXPECT_EQ(0u, resource_provider_->num_resources());
+}
+
+}  // namespace
+}  // namespace cc
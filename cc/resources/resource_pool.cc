@@ -37,13 +37,19 @@ ResourcePool::~ResourcePool() {
 
 scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
     const gfx::Size& size) {
+  return AcquireResource(size, format_);
+}
+
+scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
+    const gfx::Size& size,
+    ResourceFormat format) {
   for (ResourceList::iterator it = unused_resources_.begin();
        it != unused_resources_.end();
        ++it) {
     ScopedResource* resource = *it;
     DCHECK(resource_provider_->CanLockForWrite(resource->id()));
 
-    if (resource->size() != size)
+    if (resource->size() != size || resource->format() != format)
       continue;
 
     unused_resources_.erase(it);
@@ -54,7 +60,7 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
   // Create new resource.
   scoped_ptr<ScopedResource> resource =
       ScopedResource::Create(resource_provider_);
-  resource->AllocateManaged(size, target_, format_);
+  resource->AllocateManaged(size, target_, format);
 
   // Extend all read locks on all resources until the resource is
   // finished being used, such that we know when resources are
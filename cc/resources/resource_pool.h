@@ -27,6 +27,9 @@ class CC_EXPORT ResourcePool {
   virtual ~ResourcePool();
 
   scoped_ptr<ScopedResource> AcquireResource(const gfx::Size& size);
+  // Like AcquireResource(), for a format other than the pool's default.
+  scoped_ptr<ScopedResource> AcquireResource(const gfx::Size& size,
+                                             ResourceFormat format);
   void ReleaseResource(scoped_ptr<ScopedResource>);
 
   void SetResourceUsageLimits(size_t max_memory_usage_bytes,
@@ -14,6 +14,7 @@
 #include "base/strings/string_util.h"
 #include "cc/base/util.h"
 #include "cc/output/gl_renderer.h"  // For the GLC() macro.
+#include "cc/resources/etc1_encoder.h"
 #include "cc/resources/platform_color.h"
 #include "cc/resources/returned_resource.h"
 #include "cc/resources/shared_bitmap_manager.h"
@@ -477,6 +478,9 @@ SkCanvas* ResourceProvider::BitmapRasterBuffer::DoLockForWrite() {
       break;
     case RGBA_8888:
     case BGRA_8888:
+    case ETC1:
+      // ETC1 content is rasterized into the pixel buffer, which is large
+      // enough for N32 pixels, and compressed in place by the rasterizer.
       raster_bitmap_.setConfig(SkBitmap::kARGB_8888_Config,
                                resource()->size.width(),
                                resource()->size.height(),
@@ -485,7 +489,6 @@ SkCanvas* ResourceProvider::BitmapRasterBuffer::DoLockForWrite() {
       break;
     case LUMINANCE_8:
     case RGB_565:
-    case ETC1:
       NOTREACHED();
       break;
   }
@@ -498,9 +501,11 @@ SkCanvas* ResourceProvider::BitmapRasterBuffer::DoLockForWrite() {
 void ResourceProvider::BitmapRasterBuffer::DoUnlockForWrite() {
   raster_canvas_.clear();
 
-  SkBitmap::Config buffer_config = SkBitmapConfig(resource()->format);
-  if (mapped_buffer_ && (buffer_config != raster_bitmap_.config()))
-    CopyBitmap(raster_bitmap_, mapped_buffer_, buffer_config);
+  if (mapped_buffer_ && resource()->format != ETC1) {
+    SkBitmap::Config buffer_config = SkBitmapConfig(resource()->format);
+    if (buffer_config != raster_bitmap_.config())
+      CopyBitmap(raster_bitmap_, mapped_buffer_, buffer_config);
+  }
   raster_bitmap_.reset();
 
   UnmapBuffer();
@@ -589,6 +594,14 @@ bool ResourceProvider::IsLost(ResourceId id) {
   return resource->lost;
 }
 
+bool ResourceProvider::CanSetPixels(ResourceId id) {
+  Resource* resource = GetResource(id);
+  return resource->origin == Resource::Internal && !resource->lost &&
+         !resource->locked_for_write && !resource->lock_for_read_count &&
+         !resource->exported_count && !resource->pending_set_pixels &&
+         ReadLockFenceHasPassed(resource);
+}
+
 ResourceProvider::ResourceId ResourceProvider::CreateResource(
     const gfx::Size& size,
     GLint wrap_mode,
@@ -1750,7 +1763,6 @@ void ResourceProvider::AcquirePixelBuffer(Resource* resource) {
   DCHECK(resource->origin == Resource::Internal);
   DCHECK_EQ(resource->exported_count, 0);
   DCHECK(!resource->image_id);
-  DCHECK_NE(ETC1, resource->format);
 
   if (resource->type == GLTexture) {
     GLES2Interface* gl = ContextGL();
@@ -1759,7 +1771,11 @@ void ResourceProvider::AcquirePixelBuffer(Resource* resource) {
       resource->gl_pixel_buffer_id = buffer_id_allocator_->NextId();
     gl->BindBuffer(GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM,
                    resource->gl_pixel_buffer_id);
-    unsigned bytes_per_pixel = BitsPerPixel(resource->format) / 8;
+    // ETC1 content is rasterized as N32 pixels before being compressed in
+    // place, so its buffer needs room for those.
+    unsigned bytes_per_pixel = resource->format == ETC1
+                                   ? BitsPerPixel(RGBA_8888) / 8
+                                   : BitsPerPixel(resource->format) / 8;
     gl->BufferData(GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM,
                    resource->size.height() *
                        RoundUp(bytes_per_pixel * resource->size.width(), 4u),
@@ -1905,7 +1921,18 @@ void ResourceProvider::BeginSetPixels(ResourceId id) {
       gl->GenQueriesEXT(1, &resource->gl_upload_query_id);
     gl->BeginQueryEXT(GL_ASYNC_PIXEL_UNPACK_COMPLETED_CHROMIUM,
                       resource->gl_upload_query_id);
-    if (allocate) {
+    if (resource->format == ETC1) {
+      // There are no asynchronous compressed uploads, and ETC1 does not
+      // support sub-image updates.
+      gl->CompressedTexImage2D(GL_TEXTURE_2D,
+                               0, /* level */
+                               GLInternalFormat(ETC1),
+                               resource->size.width(),
+                               resource->size.height(),
+                               0, /* border */
+                               ETC1EncodedSizeInBytes(resource->size),
+                               NULL);
+    } else if (allocate) {
       gl->AsyncTexImage2DCHROMIUM(GL_TEXTURE_2D,
                                   0, /* level */
                                   GLInternalFormat(resource->format),
@@ -88,6 +88,9 @@ class CC_EXPORT ResourceProvider {
     return use_rgba_4444_texture_format_ ? RGBA_4444 : best_texture_format_;
   }
   ResourceFormat best_texture_format() const { return best_texture_format_; }
+  bool use_compressed_texture_etc1() const {
+    return use_compressed_texture_etc1_;
+  }
   size_t num_resources() const { return resources_.size(); }
 
   // Checks whether a resource is in use by a consumer.
@@ -95,6 +98,10 @@ class CC_EXPORT ResourceProvider {
 
   bool IsLost(ResourceId id);
 
+  // Checks whether SetPixels() may be called on a resource right now, i.e.
+  // nothing is reading from it or may still read from it.
+  bool CanSetPixels(ResourceId id);
+
   // Producer interface.
 
   ResourceType default_resource_type() const { return default_resource_type_; }
@@ -335,6 +342,9 @@ class CC_EXPORT ResourceProvider {
   // The pixel buffer needs to be uploaded to the underlying resource
   // using BeginSetPixels before the resouce can be used for compositing.
   // It is used by PixelRasterWorkerPool.
+  // For ETC1 resources the canvas is an N32 bitmap over the whole pixel
+  // buffer, which the rasterizer must compress in place with EncodeETC1()
+  // before unmapping.
   void AcquirePixelRasterBuffer(ResourceId id);
   void ReleasePixelRasterBuffer(ResourceId id);
   SkCanvas* MapPixelRasterBuffer(ResourceId id);
@@ -14,52 +14,85 @@ namespace cc {
 namespace internal {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
+bool CompareEdgeTask(const TaskGraph::Edge& a, const TaskGraph::Edge& b) {
+  return a.task < b.task;
+}
+
+bool CompareNodeTask(const TaskGraph::Node& a, const TaskGraph::Node& b) {
+  return a.task < b.task;
+}
+
+// Sorts the nodes and edges of |graph| by task, so that the nodes and the
+// dependents of a task can be found with a binary search. This keeps the
+// work done while holding the lock proportional to the number of dependents
+// rather than to the size of the graph.
+void SortTaskGraph(TaskGraph* graph) {
+  std::sort(graph->nodes.begin(), graph->nodes.end(), CompareNodeTask);
+  std::sort(graph->edges.begin(), graph->edges.end(), CompareEdgeTask);
+}
+
+// Returns the node for |task| in |graph|, which must have been sorted by
+// SortTaskGraph(), or NULL if |task| is not part of |graph|.
+TaskGraph::Node* FindNode(TaskGraph* graph, const Task* task) {
+  TaskGraph::Node::Vector::iterator it =
+      std::lower_bound(graph->nodes.begin(),
+                       graph->nodes.end(),
+                       TaskGraph::Node(const_cast<Task*>(task), 0u, 0u),
+                       CompareNodeTask);
+  if (it == graph->nodes.end() || it->task != task)
+    return NULL;
+  return &(*it);
+}
+
+// Helper class for iterating over all dependents of a task. |graph| must
+// have been sorted by SortTaskGraph().
 class DependentIterator {
  public:
   DependentIterator(TaskGraph* graph, const Task* task)
-      : graph_(graph), task_(task), current_index_(-1), current_node_(NULL) {
-    ++(*this);
+      : graph_(graph),
+        task_(task),
+        current_index_(std::lower_bound(graph->edges.begin(),
+                                        graph->edges.end(),
+                                        TaskGraph::Edge(task, NULL),
+                                        CompareEdgeTask) -
+                       graph->edges.begin()),
+        current_node_(NULL) {
+    FindCurrentNode();
   }
 
   TaskGraph::Node& operator->() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
   TaskGraph::Node& operator*() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
-  // Note: Performance can be improved by keeping edges sorted.
   DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
-
-    // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
-
+    DCHECK(*this);
+    ++current_index_;
+    FindCurrentNode();
     return *this;
   }
 
-  operator bool() const { return current_index_ < graph_->edges.size(); }
+  operator bool() const {
+    return current_index_ < graph_->edges.size() &&
+           graph_->edges[current_index_].task == task_;
+  }
 
  private:
+  // Finds the node for the dependent of the current edge.
+  void FindCurrentNode() {
+    if (!*this)
+      return;
+    current_node_ = FindNode(graph_, graph_->edges[current_index_].dependent);
+    DCHECK(current_node_);
+  }
+
   TaskGraph* graph_;
   const Task* task_;
   size_t current_index_;
@@ -223,6 +256,9 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
                       DependencyMismatchComparator(graph)) ==
          graph->nodes.end());
 
+  // Sort before acquiring |lock_|, as it only touches |graph|.
+  SortTaskGraph(graph);
+
   {
     base::AutoLock lock(lock_);
 
@@ -241,25 +277,13 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
+    // Build new "ready to run" queue.
     task_namespace.ready_to_run_tasks.clear();
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left all nodes not present in this graph, which
-      // we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -286,12 +310,17 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
     // Swap task graph.
     task_namespace.graph.Swap(graph);
 
-    // Determine what tasks in old graph need to be canceled.
+    // Determine what tasks in old graph need to be canceled. These are the
+    // tasks that are not present in the new graph.
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
+      // Skip if still part of the new graph.
+      if (FindNode(&task_namespace.graph, node.task))
+        continue;
+
       // Skip if already finished running task.
       if (node.task->HasFinishedRunning())
         continue;
@@ -430,7 +459,10 @@ void TaskGraphRunner::RunTaskWithLockAcquired(int thread_index) {
   task_namespace->num_running_tasks++;
 
   // There may be more work available, so wake up another worker thread.
-  has_ready_to_run_tasks_cv_.Signal();
+  // Waking one up when there is nothing left to take only has it contend
+  // for |lock_| before going back to sleep.
+  if (!ready_to_run_namespaces_.empty())
+    has_ready_to_run_tasks_cv_.Signal();
 
   // Call WillRun() before releasing |lock_| and running task.
   task->WillRun();
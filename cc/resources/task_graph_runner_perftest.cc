@@ -18,6 +18,10 @@ namespace {
 static const int kTimeLimitMillis = 2000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
+// Iterations of busy work done by each task run on worker threads. Enough
+// for the work to be comparable to a small raster task, so that contention
+// in the runner shows up as lost scaling.
+static const int kWorkIterations = 10000;
 
 class PerfTaskImpl : public internal::Task {
  public:
@@ -30,12 +34,34 @@ class PerfTaskImpl : public internal::Task {
 
   void Reset() { did_run_ = false; }
 
- private:
+ protected:
   virtual ~PerfTaskImpl() {}
 
+ private:
   DISALLOW_COPY_AND_ASSIGN(PerfTaskImpl);
 };
 
+class PerfWorkTaskImpl : public PerfTaskImpl {
+ public:
+  PerfWorkTaskImpl() : result_(0) {}
+
+  // Overridden from internal::Task:
+  virtual void RunOnWorkerThread(unsigned thread_index) OVERRIDE {
+    unsigned result = thread_index;
+    for (int i = 0; i < kWorkIterations; ++i)
+      result = result * 1664525u + 1013904223u;
+    result_ = result;
+  }
+
+ private:
+  virtual ~PerfWorkTaskImpl() {}
+
+  // Written so that the work isn't optimized away.
+  volatile unsigned result_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfWorkTaskImpl);
+};
+
 class TaskGraphRunnerPerfTest : public testing::Test {
  public:
   TaskGraphRunnerPerfTest()
@@ -211,6 +237,50 @@ class TaskGraphRunnerPerfTest : public testing::Test {
                            true);
   }
 
+  void RunExecuteTasksOnWorkerThreadsTest(const std::string& test_name,
+                                          size_t num_threads,
+                                          int num_tasks) {
+    internal::TaskGraphRunner task_graph_runner(num_threads, "PerfTest");
+    internal::NamespaceToken namespace_token =
+        task_graph_runner.GetNamespaceToken();
+
+    PerfTaskImpl::Vector tasks;
+    for (int i = 0; i < num_tasks; ++i)
+      tasks.push_back(make_scoped_refptr(new PerfWorkTaskImpl));
+
+    // Avoid unnecessary heap allocations by reusing the same graph and
+    // completed tasks vector.
+    internal::TaskGraph graph;
+    internal::Task::Vector completed_tasks;
+
+    timer_.Reset();
+    do {
+      graph.Reset();
+      unsigned priority = 0u;
+      for (PerfTaskImpl::Vector::const_iterator it = tasks.begin();
+           it != tasks.end();
+           ++it) {
+        graph.nodes.push_back(
+            internal::TaskGraph::Node(it->get(), priority++, 0u));
+      }
+      task_graph_runner.SetTaskGraph(namespace_token, &graph);
+      task_graph_runner.WaitForTasksToFinishRunning(namespace_token);
+      task_graph_runner.CollectCompletedTasks(namespace_token,
+                                              &completed_tasks);
+      DCHECK_EQ(tasks.size(), completed_tasks.size());
+      completed_tasks.clear();
+      ResetTasks(&tasks);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult("execute_tasks_on_worker_threads",
+                           TestModifierString(),
+                           test_name,
+                           timer_.LapsPerSecond() * num_tasks,
+                           "tasks/s",
+                           true);
+  }
+
  private:
   static std::string TestModifierString() {
     return std::string("_task_graph_runner");
@@ -320,5 +390,12 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
 }
 
+TEST_F(TaskGraphRunnerPerfTest, ExecuteTasksOnWorkerThreads) {
+  RunExecuteTasksOnWorkerThreadsTest("1_threads", 1, 256);
+  RunExecuteTasksOnWorkerThreadsTest("2_threads", 2, 256);
+  RunExecuteTasksOnWorkerThreadsTest("4_threads", 4, 256);
+  RunExecuteTasksOnWorkerThreadsTest("8_threads", 8, 256);
+}
+
 }  // namespace
 }  // namespace cc
@@ -71,6 +71,7 @@ scoped_ptr<base::Value> Tile::AsValue() const {
   res->Set("managed_state", managed_state_.AsValue().release());
   res->SetBoolean("can_use_lcd_text", can_use_lcd_text());
   res->SetBoolean("use_gpu_rasterization", use_gpu_rasterization());
+  res->SetBoolean("use_etc1_compression", use_etc1_compression());
   return res.PassAs<base::Value>();
 }
 
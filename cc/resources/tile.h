@@ -23,7 +23,8 @@ class CC_EXPORT Tile : public RefCountedManaged<Tile> {
  public:
   enum TileRasterFlags {
     USE_LCD_TEXT = 1 << 0,
-    USE_GPU_RASTERIZATION = 1 << 1
+    USE_GPU_RASTERIZATION = 1 << 1,
+    USE_ETC1_COMPRESSION = 1 << 2
   };
 
   typedef uint64 Id;
@@ -79,6 +80,12 @@ class CC_EXPORT Tile : public RefCountedManaged<Tile> {
     return !!(flags_ & USE_GPU_RASTERIZATION);
   }
 
+  // Whether the tile's content may be compressed to ETC1 to save memory, which
+  // TileManager does when the tile's size and raster worker pool allow it.
+  bool use_etc1_compression() const {
+    return !!(flags_ & USE_ETC1_COMPRESSION);
+  }
+
   scoped_ptr<base::Value> AsValue() const;
 
   inline bool IsReadyToDraw() const {
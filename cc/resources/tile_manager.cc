@@ -158,8 +158,10 @@ scoped_ptr<TileManager> TileManager::Create(
       client,
       resource_provider,
       context_provider,
-      use_map_image ? ImageRasterWorkerPool::Create(resource_provider,
-                                                    map_image_texture_target)
+      use_map_image ? ImageRasterWorkerPool::Create(
+                          resource_provider,
+                          map_image_texture_target,
+                          rendering_stats_instrumentation)
                     : PixelBufferRasterWorkerPool::Create(
                           resource_provider, max_transfer_buffer_usage_bytes),
       DirectRasterWorkerPool::Create(resource_provider, context_provider),
@@ -197,6 +199,11 @@ TileManager::TileManager(
       rendering_stats_instrumentation_(rendering_stats_instrumentation),
       did_initialize_visible_tile_(false),
       did_check_for_completed_tasks_since_last_schedule_tasks_(true),
+      image_decode_reuse_count_(0),
+      image_decode_task_count_(0),
+      solid_color_tiles_from_cache_count_(0),
+      etc1_raster_task_count_(0),
+      etc1_bytes_saved_(0),
       use_rasterize_on_demand_(use_rasterize_on_demand) {
   RasterWorkerPool* raster_worker_pools[NUM_RASTER_WORKER_POOL_TYPES] = {
       raster_worker_pool_.get(),        // RASTER_WORKER_POOL_TYPE_DEFAULT
@@ -255,7 +262,7 @@ void TileManager::CleanUpReleasedTiles() {
     DCHECK_GT(layer_it->second, 0);
     if (--layer_it->second == 0) {
       used_layer_counts_.erase(layer_it);
-      image_decode_tasks_.erase(tile->layer_id());
+      ReleaseImageDecodeTasksForLayer(tile->layer_id());
     }
 
     delete tile;
@@ -540,6 +547,12 @@ scoped_ptr<base::Value> TileManager::BasicStateAsValue() const {
   state->SetInteger("tile_count", tiles_.size());
   state->Set("global_state", global_state_.AsValue().release());
   state->Set("memory_requirements", GetMemoryRequirementsAsValue().release());
+  state->SetInteger("image_decode_task_count", image_decode_task_count_);
+  state->SetInteger("image_decode_reuse_count", image_decode_reuse_count_);
+  state->SetInteger("solid_color_tiles_from_cache_count",
+                    solid_color_tiles_from_cache_count_);
+  state->SetInteger("etc1_raster_task_count", etc1_raster_task_count_);
+  state->SetInteger("etc1_bytes_saved", etc1_bytes_saved_);
   return state.PassAs<base::Value>();
 }
 
@@ -570,6 +583,15 @@ scoped_ptr<base::Value> TileManager::GetMemoryRequirementsAsValue() const {
   return requirements.PassAs<base::Value>();
 }
 
+ResourceFormat TileManager::ResourceFormatForTile(const Tile* tile) const {
+  // ETC1 encodes blocks of 4x4 texels.
+  if (tile->use_etc1_compression() && !(tile->size().width() % 4) &&
+      !(tile->size().height() % 4) &&
+      raster_worker_pool_->SupportsResourceFormat(ETC1))
+    return ETC1;
+  return raster_worker_pool_->GetResourceFormat();
+}
+
 RasterMode TileManager::DetermineRasterMode(const Tile* tile) const {
   DCHECK(tile);
   DCHECK(tile->picture_pile());
@@ -662,6 +684,13 @@ void TileManager::AssignGpuMemoryToTiles(
       continue;
     }
 
+    // If the content is already known to be a solid color, e.g. from a twin
+    // tile or another tiling of the same recording, neither a resource nor a
+    // raster task is needed.
+    if (!tile_version.resource_ && !tile_version.raster_task_ &&
+        InitializeSolidColorTileFromCachedAnalysis(tile))
+      continue;
+
     const bool tile_uses_hard_limit = mts.bin <= NOW_BIN;
     const size_t bytes_if_allocated = BytesConsumedIfAllocated(tile);
     const size_t raster_bytes_if_rastered = raster_bytes + bytes_if_allocated;
@@ -755,6 +784,10 @@ void TileManager::AssignGpuMemoryToTiles(
   memory_stats_from_last_assign_.bytes_unreleasable =
       hard_bytes_allocatable - bytes_releasable_;
   memory_stats_from_last_assign_.bytes_over = bytes_that_exceeded_memory_budget;
+  memory_stats_from_last_assign_.image_decode_reuse_count =
+      image_decode_reuse_count_;
+  memory_stats_from_last_assign_.image_decode_task_count =
+      image_decode_task_count_;
 }
 
 void TileManager::FreeResourceForTile(Tile* tile, RasterMode mode) {
@@ -852,21 +885,51 @@ scoped_refptr<internal::WorkerPoolTask> TileManager::CreateImageDecodeTask(
       rendering_stats_instrumentation_,
       base::Bind(&TileManager::OnImageDecodeTaskCompleted,
                  base::Unretained(this),
-                 tile->layer_id(),
-                 base::Unretained(pixel_ref)));
+                 pixel_ref->getGenerationID()));
+}
+
+void TileManager::ReleaseImageDecodeTasksForLayer(int layer_id) {
+  LayerPixelRefIdMap::iterator layer_it = layer_pixel_ref_ids_.find(layer_id);
+  if (layer_it == layer_pixel_ref_ids_.end())
+    return;
+
+  const PixelRefIdSet& pixel_ref_ids = layer_it->second;
+  for (PixelRefIdSet::const_iterator it = pixel_ref_ids.begin();
+       it != pixel_ref_ids.end();
+       ++it) {
+    PixelRefLayerCountMap::iterator count_it =
+        pixel_ref_layer_counts_.find(*it);
+    DCHECK(count_it != pixel_ref_layer_counts_.end());
+    DCHECK_GT(count_it->second, 0);
+    if (--count_it->second == 0) {
+      pixel_ref_layer_counts_.erase(count_it);
+      image_decode_tasks_.erase(*it);
+    }
+  }
+
+  layer_pixel_ref_ids_.erase(layer_it);
 }
 
 scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
     Tile* tile) {
   ManagedTileState& mts = tile->managed_state();
 
+  ResourceFormat format = ResourceFormatForTile(tile);
   scoped_ptr<ScopedResource> resource =
-      resource_pool_->AcquireResource(tile->tile_size_.size());
+      resource_pool_->AcquireResource(tile->tile_size_.size(), format);
   const ScopedResource* const_resource = resource.get();
 
+  if (format == ETC1) {
+    ++etc1_raster_task_count_;
+    etc1_bytes_saved_ +=
+        Resource::MemorySizeBytes(tile->size(),
+                                  raster_worker_pool_->GetResourceFormat()) -
+        Resource::MemorySizeBytes(tile->size(), ETC1);
+  }
+
   // Create and queue all image decode tasks that this tile depends on.
   internal::WorkerPoolTask::Vector decode_tasks;
-  PixelRefTaskMap& existing_pixel_refs = image_decode_tasks_[tile->layer_id()];
+  PixelRefIdSet& layer_pixel_ref_ids = layer_pixel_ref_ids_[tile->layer_id()];
   for (PicturePileImpl::PixelRefIterator iter(
            tile->content_rect(), tile->contents_scale(), tile->picture_pile());
        iter;
@@ -874,10 +937,16 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
     SkPixelRef* pixel_ref = *iter;
     uint32_t id = pixel_ref->getGenerationID();
 
-    // Append existing image decode task if available.
-    PixelRefTaskMap::iterator decode_task_it = existing_pixel_refs.find(id);
-    if (decode_task_it != existing_pixel_refs.end()) {
+    // Keep the decode task alive for as long as this layer has tiles.
+    if (layer_pixel_ref_ids.insert(id).second)
+      pixel_ref_layer_counts_[id]++;
+
+    // Append existing image decode task if available. It may have been
+    // created for a tile of another layer.
+    PixelRefTaskMap::iterator decode_task_it = image_decode_tasks_.find(id);
+    if (decode_task_it != image_decode_tasks_.end()) {
       decode_tasks.push_back(decode_task_it->second);
+      ++image_decode_reuse_count_;
       continue;
     }
 
@@ -885,7 +954,8 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
     scoped_refptr<internal::WorkerPoolTask> decode_task =
         CreateImageDecodeTask(tile, pixel_ref);
     decode_tasks.push_back(decode_task);
-    existing_pixel_refs[id] = decode_task;
+    image_decode_tasks_[id] = decode_task;
+    ++image_decode_task_count_;
   }
 
   return RasterWorkerPool::CreateRasterTask(
@@ -908,25 +978,34 @@ scoped_refptr<internal::RasterWorkerPoolTask> TileManager::CreateRasterTask(
       context_provider_);
 }
 
-void TileManager::OnImageDecodeTaskCompleted(int layer_id,
-                                             SkPixelRef* pixel_ref,
+void TileManager::OnImageDecodeTaskCompleted(uint32_t pixel_ref_id,
                                              bool was_canceled) {
   // If the task was canceled, we need to clean it up
   // from |image_decode_tasks_|.
   if (!was_canceled)
     return;
 
-  LayerPixelRefTaskMap::iterator layer_it = image_decode_tasks_.find(layer_id);
+  image_decode_tasks_.erase(pixel_ref_id);
+}
 
-  if (layer_it == image_decode_tasks_.end())
-    return;
+bool TileManager::InitializeSolidColorTileFromCachedAnalysis(Tile* tile) {
+  PicturePileImpl::Analysis analysis;
+  if (!tile->picture_pile()->GetCachedAnalysis(
+          tile->content_rect(), tile->contents_scale(), &analysis) ||
+      !analysis.is_solid_color)
+    return false;
 
-  PixelRefTaskMap& pixel_ref_tasks = layer_it->second;
-  PixelRefTaskMap::iterator task_it =
-      pixel_ref_tasks.find(pixel_ref->getGenerationID());
+  ManagedTileState& mts = tile->managed_state();
+  ManagedTileState::TileVersion& tile_version =
+      mts.tile_versions[mts.raster_mode];
+  tile_version.set_has_text(analysis.has_text);
+  tile_version.set_solid_color(analysis.solid_color);
+  ++solid_color_tiles_from_cache_count_;
 
-  if (task_it != pixel_ref_tasks.end())
-    pixel_ref_tasks.erase(task_it);
+  FreeUnusedResourcesForTile(tile);
+  if (tile->priority(ACTIVE_TREE).distance_to_visible == 0.f)
+    did_initialize_visible_tile_ = true;
+  return true;
 }
 
 void TileManager::OnRasterTaskCompleted(
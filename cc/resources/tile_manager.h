@@ -158,20 +158,22 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
     NUM_RASTER_WORKER_POOL_TYPES
   };
 
-  void OnImageDecodeTaskCompleted(int layer_id,
-                                  SkPixelRef* pixel_ref,
-                                  bool was_canceled);
+  void OnImageDecodeTaskCompleted(uint32_t pixel_ref_id, bool was_canceled);
   void OnRasterTaskCompleted(Tile::Id tile,
                              scoped_ptr<ScopedResource> resource,
                              RasterMode raster_mode,
                              const PicturePileImpl::Analysis& analysis,
                              bool was_canceled);
+  // Returns true if |tile| was initialized to a solid color known from an
+  // earlier analysis of its content.
+  bool InitializeSolidColorTileFromCachedAnalysis(Tile* tile);
 
   inline size_t BytesConsumedIfAllocated(const Tile* tile) const {
-    return Resource::MemorySizeBytes(tile->size(),
-                                     raster_worker_pool_->GetResourceFormat());
+    return Resource::MemorySizeBytes(tile->size(), ResourceFormatForTile(tile));
   }
 
+  ResourceFormat ResourceFormatForTile(const Tile* tile) const;
+
   RasterMode DetermineRasterMode(const Tile* tile) const;
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
@@ -179,6 +181,7 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   scoped_refptr<internal::WorkerPoolTask> CreateImageDecodeTask(
       Tile* tile,
       SkPixelRef* pixel_ref);
+  void ReleaseImageDecodeTasksForLayer(int layer_id);
   scoped_refptr<internal::RasterWorkerPoolTask> CreateRasterTask(Tile* tile);
   scoped_ptr<base::Value> GetMemoryRequirementsAsValue() const;
   void UpdatePrioritizedTileSetIfNeeded();
@@ -215,10 +218,26 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   bool did_initialize_visible_tile_;
   bool did_check_for_completed_tasks_since_last_schedule_tasks_;
 
+  // Image decode tasks are keyed by pixel ref generation id and shared by all
+  // tiles, across layers, that draw the same pixel ref. A task is released
+  // once no layer that used it has tiles left.
   typedef base::hash_map<uint32_t, scoped_refptr<internal::WorkerPoolTask> >
       PixelRefTaskMap;
-  typedef base::hash_map<int, PixelRefTaskMap> LayerPixelRefTaskMap;
-  LayerPixelRefTaskMap image_decode_tasks_;
+  PixelRefTaskMap image_decode_tasks_;
+
+  typedef base::hash_set<uint32_t> PixelRefIdSet;
+  typedef base::hash_map<int, PixelRefIdSet> LayerPixelRefIdMap;
+  LayerPixelRefIdMap layer_pixel_ref_ids_;
+
+  typedef base::hash_map<uint32_t, int> PixelRefLayerCountMap;
+  PixelRefLayerCountMap pixel_ref_layer_counts_;
+
+  size_t image_decode_reuse_count_;
+  size_t image_decode_task_count_;
+  size_t solid_color_tiles_from_cache_count_;
+  size_t etc1_raster_task_count_;
+  // Bytes the ETC1 raster tasks saved over the default format.
+  size_t etc1_bytes_saved_;
 
   typedef base::hash_map<int, int> LayerCountMap;
   LayerCountMap used_layer_counts_;
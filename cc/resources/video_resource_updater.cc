@@ -27,7 +27,8 @@ VideoFrameExternalResources::~VideoFrameExternalResources() {}
 VideoResourceUpdater::VideoResourceUpdater(ContextProvider* context_provider,
                                            ResourceProvider* resource_provider)
     : context_provider_(context_provider),
-      resource_provider_(resource_provider) {
+      resource_provider_(resource_provider),
+      last_frame_generation_(0) {
 }
 
 VideoResourceUpdater::~VideoResourceUpdater() {
@@ -161,7 +162,16 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
   int max_resource_size = resource_provider_->max_texture_size();
   gfx::Size coded_frame_size = video_frame->coded_size();
 
+  // Resources tagged with |last_frame_generation_| only hold the frame's
+  // contents if it is the same frame.
+  bool same_frame = video_frame.get() == last_frame_.get();
+  if (!same_frame) {
+    last_frame_ = video_frame;
+    ++last_frame_generation_;
+  }
+
   std::vector<PlaneResource> plane_resources;
+  std::vector<bool> plane_needs_update;
   bool allocation_success = true;
 
   for (size_t i = 0; i < output_plane_count; ++i) {
@@ -179,21 +189,35 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
 
     ResourceProvider::ResourceId resource_id = 0;
     gpu::Mailbox mailbox;
+    bool needs_update = true;
 
-    // Try recycle a previously-allocated resource.
-    for (size_t i = 0; i < recycled_resources_.size(); ++i) {
+    // Try recycle a previously-allocated resource, preferring one that
+    // already holds this plane.
+    size_t recycled_index = recycled_resources_.size();
+    for (size_t j = 0; j < recycled_resources_.size(); ++j) {
+      const PlaneResource& recycled = recycled_resources_[j];
       bool resource_matches =
-          recycled_resources_[i].resource_format == output_resource_format &&
-          recycled_resources_[i].resource_size == output_plane_resource_size;
+          recycled.resource_format == output_resource_format &&
+          recycled.resource_size == output_plane_resource_size;
       bool not_in_use =
-          !software_compositor || !resource_provider_->InUseByConsumer(
-                                       recycled_resources_[i].resource_id);
-      if (resource_matches && not_in_use) {
-        resource_id = recycled_resources_[i].resource_id;
-        mailbox = recycled_resources_[i].mailbox;
-        recycled_resources_.erase(recycled_resources_.begin() + i);
+          !software_compositor ||
+          !resource_provider_->InUseByConsumer(recycled.resource_id);
+      if (!resource_matches || !not_in_use)
+        continue;
+      if (same_frame &&
+          recycled.frame_generation == last_frame_generation_ &&
+          recycled.plane_index == i) {
+        recycled_index = j;
+        needs_update = false;
         break;
       }
+      if (recycled_index == recycled_resources_.size())
+        recycled_index = j;
+    }
+    if (recycled_index < recycled_resources_.size()) {
+      resource_id = recycled_resources_[recycled_index].resource_id;
+      mailbox = recycled_resources_[recycled_index].mailbox;
+      recycled_resources_.erase(recycled_resources_.begin() + recycled_index);
     }
 
     if (resource_id == 0) {
@@ -233,7 +257,10 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
     plane_resources.push_back(PlaneResource(resource_id,
                                             output_plane_resource_size,
                                             output_resource_format,
-                                            mailbox));
+                                            mailbox,
+                                            last_frame_generation_,
+                                            i));
+    plane_needs_update.push_back(needs_update);
   }
 
   if (!allocation_success) {
@@ -252,7 +279,7 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
     if (!video_renderer_)
       video_renderer_.reset(new media::SkCanvasVideoRenderer);
 
-    {
+    if (plane_needs_update[0]) {
       ResourceProvider::ScopedWriteLockSoftware lock(
           resource_provider_, plane_resources[0].resource_id);
       video_renderer_->Paint(video_frame.get(),
@@ -265,7 +292,9 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
       plane_resources[0].resource_id,
       plane_resources[0].resource_size,
       plane_resources[0].resource_format,
-      gpu::Mailbox()
+      gpu::Mailbox(),
+      plane_resources[0].frame_generation,
+      plane_resources[0].plane_index
     };
     external_resources.software_resources.push_back(
         plane_resources[0].resource_id);
@@ -280,24 +309,28 @@ VideoFrameExternalResources VideoResourceUpdater::CreateForSoftwarePlanes(
     // Update each plane's resource id with its content.
     DCHECK_EQ(plane_resources[i].resource_format, kYUVResourceFormat);
 
-    const uint8_t* input_plane_pixels = video_frame->data(i);
-
-    gfx::Rect image_rect(0,
-                         0,
-                         video_frame->stride(i),
-                         plane_resources[i].resource_size.height());
-    gfx::Rect source_rect(plane_resources[i].resource_size);
-    resource_provider_->SetPixels(plane_resources[i].resource_id,
-                                  input_plane_pixels,
-                                  image_rect,
-                                  source_rect,
-                                  gfx::Vector2d());
+    if (plane_needs_update[i]) {
+      const uint8_t* input_plane_pixels = video_frame->data(i);
+
+      gfx::Rect image_rect(0,
+                           0,
+                           video_frame->stride(i),
+                           plane_resources[i].resource_size.height());
+      gfx::Rect source_rect(plane_resources[i].resource_size);
+      resource_provider_->SetPixels(plane_resources[i].resource_id,
+                                    input_plane_pixels,
+                                    image_rect,
+                                    source_rect,
+                                    gfx::Vector2d());
+    }
 
     RecycleResourceData recycle_data = {
       plane_resources[i].resource_id,
       plane_resources[i].resource_size,
       plane_resources[i].resource_format,
-      plane_resources[i].mailbox
+      plane_resources[i].mailbox,
+      plane_resources[i].frame_generation,
+      plane_resources[i].plane_index
     };
 
     external_resources.mailboxes.push_back(
@@ -387,7 +420,9 @@ void VideoResourceUpdater::RecycleResource(
   PlaneResource recycled_resource(data.resource_id,
                                   data.resource_size,
                                   data.resource_format,
-                                  data.mailbox);
+                                  data.mailbox,
+                                  data.frame_generation,
+                                  data.plane_index);
   updater->recycled_resources_.push_back(recycled_resource);
 }
 
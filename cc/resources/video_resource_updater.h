@@ -78,15 +78,23 @@ class CC_EXPORT VideoResourceUpdater
     gfx::Size resource_size;
     ResourceFormat resource_format;
     gpu::Mailbox mailbox;
+    // The plane of the frame numbered |frame_generation| that the resource
+    // holds, or zero if its contents are unknown.
+    uint64 frame_generation;
+    size_t plane_index;
 
     PlaneResource(unsigned resource_id,
                   const gfx::Size& resource_size,
                   ResourceFormat resource_format,
-                  gpu::Mailbox mailbox)
+                  gpu::Mailbox mailbox,
+                  uint64 frame_generation,
+                  size_t plane_index)
         : resource_id(resource_id),
           resource_size(resource_size),
           resource_format(resource_format),
-          mailbox(mailbox) {}
+          mailbox(mailbox),
+          frame_generation(frame_generation),
+          plane_index(plane_index) {}
   };
 
   void DeleteResource(unsigned resource_id);
@@ -101,6 +109,8 @@ class CC_EXPORT VideoResourceUpdater
     gfx::Size resource_size;
     ResourceFormat resource_format;
     gpu::Mailbox mailbox;
+    uint64 frame_generation;
+    size_t plane_index;
   };
   static void RecycleResource(base::WeakPtr<VideoResourceUpdater> updater,
                               RecycleResourceData data,
@@ -114,6 +124,14 @@ class CC_EXPORT VideoResourceUpdater
   std::vector<unsigned> all_resources_;
   std::vector<PlaneResource> recycled_resources_;
 
+  // The last software frame uploaded, and its number. A frame that is drawn
+  // again, e.g. while the rest of the page animates faster than the video's
+  // frame rate, reuses the resources still holding it instead of uploading
+  // its planes again. The reference keeps |last_frame_| from being recycled
+  // into a different frame at the same address.
+  scoped_refptr<media::VideoFrame> last_frame_;
+  uint64 last_frame_generation_;
+
   DISALLOW_COPY_AND_ASSIGN(VideoResourceUpdater);
 };
 
@@ -15,15 +15,38 @@
 namespace cc {
 namespace {
 
+class UploadCountingContext3D : public TestWebGraphicsContext3D {
+ public:
+  UploadCountingContext3D() : upload_count_(0) {}
+
+  virtual void texSubImage2D(GLenum target,
+                             GLint level,
+                             GLint xoffset,
+                             GLint yoffset,
+                             GLsizei width,
+                             GLsizei height,
+                             GLenum format,
+                             GLenum type,
+                             const void* pixels) OVERRIDE {
+    ++upload_count_;
+  }
+
+  int upload_count() const { return upload_count_; }
+
+ private:
+  int upload_count_;
+};
+
 class VideoResourceUpdaterTest : public testing::Test {
  protected:
   VideoResourceUpdaterTest() {
-    scoped_ptr<TestWebGraphicsContext3D> context3d =
-        TestWebGraphicsContext3D::Create();
+    scoped_ptr<UploadCountingContext3D> context3d(
+        new UploadCountingContext3D);
     context3d_ = context3d.get();
 
     output_surface3d_ =
-        FakeOutputSurface::Create3d(context3d.Pass());
+        FakeOutputSurface::Create3d(
+            context3d.PassAs<TestWebGraphicsContext3D>());
     CHECK(output_surface3d_->BindToClient(&client_));
     resource_provider3d_ =
         ResourceProvider::Create(output_surface3d_.get(), NULL, 0, false, 1);
@@ -51,7 +74,13 @@ class VideoResourceUpdaterTest : public testing::Test {
         base::Closure());         // no_longer_needed_cb
   }
 
-  TestWebGraphicsContext3D* context3d_;
+  static void ReleaseResources(VideoFrameExternalResources* resources) {
+    for (size_t i = 0; i < resources->release_callbacks.size(); ++i)
+      resources->release_callbacks[i].Run(0, false);
+    resources->release_callbacks.clear();
+  }
+
+  UploadCountingContext3D* context3d_;
   FakeOutputSurfaceClient client_;
   scoped_ptr<FakeOutputSurface> output_surface3d_;
   scoped_ptr<ResourceProvider> resource_provider3d_;
@@ -67,5 +96,50 @@ TEST_F(VideoResourceUpdaterTest, SoftwareFrame) {
   EXPECT_EQ(VideoFrameExternalResources::YUV_RESOURCE, resources.type);
 }
 
+TEST_F(VideoResourceUpdaterTest, SameSoftwareFrameIsNotUploadedAgain) {
+  VideoResourceUpdater updater(output_surface3d_->context_provider().get(),
+                               resource_provider3d_.get());
+  scoped_refptr<media::VideoFrame> video_frame = CreateTestYUVVideoFrame();
+
+  VideoFrameExternalResources resources =
+      updater.CreateExternalResourcesFromVideoFrame(video_frame);
+  EXPECT_EQ(VideoFrameExternalResources::YUV_RESOURCE, resources.type);
+  EXPECT_EQ(3, context3d_->upload_count());
+  ReleaseResources(&resources);
+
+  // Drawing the same frame again reuses the planes already uploaded.
+  resources = updater.CreateExternalResourcesFromVideoFrame(video_frame);
+  EXPECT_EQ(VideoFrameExternalResources::YUV_RESOURCE, resources.type);
+  EXPECT_EQ(3u, resources.mailboxes.size());
+  EXPECT_EQ(3, context3d_->upload_count());
+  ReleaseResources(&resources);
+
+  // A new frame is uploaded.
+  resources = updater.CreateExternalResourcesFromVideoFrame(
+      CreateTestYUVVideoFrame());
+  EXPECT_EQ(VideoFrameExternalResources::YUV_RESOURCE, resources.type);
+  EXPECT_EQ(6, context3d_->upload_count());
+  ReleaseResources(&resources);
+}
+
+TEST_F(VideoResourceUpdaterTest, SameSoftwareFrameInUseIsUploadedAgain) {
+  VideoResourceUpdater updater(output_surface3d_->context_provider().get(),
+                               resource_provider3d_.get());
+  scoped_refptr<media::VideoFrame> video_frame = CreateTestYUVVideoFrame();
+
+  VideoFrameExternalResources resources =
+      updater.CreateExternalResourcesFromVideoFrame(video_frame);
+  EXPECT_EQ(3, context3d_->upload_count());
+
+  // The first resources have not been returned yet, so new ones are needed.
+  VideoFrameExternalResources more_resources =
+      updater.CreateExternalResourcesFromVideoFrame(video_frame);
+  EXPECT_EQ(VideoFrameExternalResources::YUV_RESOURCE, more_resources.type);
+  EXPECT_EQ(6, context3d_->upload_count());
+
+  ReleaseResources(&resources);
+  ReleaseResources(&more_resources);
+}
+
 }  // namespace
 }  // namespace cc
@@ -24,6 +24,7 @@ Scheduler::Scheduler(SchedulerClient* client,
       state_machine_(scheduler_settings),
       inside_process_scheduled_actions_(false),
       inside_action_(SchedulerStateMachine::ACTION_NONE),
+      main_frame_deadline_miss_count_(0),
       weak_factory_(this) {
   DCHECK(client_);
   DCHECK(!state_machine_.BeginImplFrameNeeded());
@@ -223,6 +224,19 @@ void Scheduler::BeginImplFrame(const BeginFrameArgs& args) {
             CanCommitAndActivateBeforeDeadline());
   }
 
+  if (settings_.predict_main_frame_deadline_misses) {
+    // Based on the recent commit and activation times, decide whether this
+    // frame's main thread work can land in time. If not, impl-thread updates
+    // are drawn without waiting for it, and the commit is picked up by a
+    // later frame.
+    bool will_miss_deadline = !CanCommitAndActivateBeforeDeadline();
+    state_machine_.SetMainFrameWillMissDeadline(will_miss_deadline);
+    TRACE_COUNTER_ID1("cc",
+                      "MainFramePredictedToMissDeadline",
+                      layer_tree_host_id_,
+                      will_miss_deadline);
+  }
+
   ProcessScheduledActions();
 
   if (!state_machine_.HasInitializedOutputSurface())
@@ -269,6 +283,14 @@ void Scheduler::OnBeginImplFrameDeadline() {
   TRACE_EVENT0("cc", "Scheduler::OnBeginImplFrameDeadline");
   begin_impl_frame_deadline_closure_.Cancel();
 
+  if (state_machine_.MainFrameMissedDeadline()) {
+    main_frame_deadline_miss_count_++;
+    TRACE_COUNTER_ID1("cc",
+                      "MainFrameDeadlineMisses",
+                      layer_tree_host_id_,
+                      main_frame_deadline_miss_count_);
+  }
+
   // We split the deadline actions up into two phases so the state machine
   // has a chance to trigger actions that should occur durring and after
   // the deadline separately. For example:
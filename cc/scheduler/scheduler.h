@@ -102,6 +102,12 @@ class CC_EXPORT Scheduler {
 
   bool WillDrawIfNeeded() const;
 
+  // The number of BeginImplFrame deadlines reached while the BeginMainFrame
+  // sent for that frame was still waiting to commit or activate.
+  int main_frame_deadline_miss_count() const {
+    return main_frame_deadline_miss_count_;
+  }
+
   base::TimeTicks AnticipatedDrawTime();
 
   base::TimeTicks LastBeginImplFrameTime();
@@ -147,6 +153,7 @@ class CC_EXPORT Scheduler {
   SchedulerStateMachine state_machine_;
   bool inside_process_scheduled_actions_;
   SchedulerStateMachine::Action inside_action_;
+  int main_frame_deadline_miss_count_;
 
   base::WeakPtrFactory<Scheduler> weak_factory_;
 
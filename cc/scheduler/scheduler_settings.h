@@ -20,6 +20,7 @@ class CC_EXPORT SchedulerSettings {
   bool using_synchronous_renderer_compositor;
   bool throttle_frame_production;
   bool switch_to_low_latency_if_possible;
+  bool predict_main_frame_deadline_misses;
 };
 
 }  // namespace cc
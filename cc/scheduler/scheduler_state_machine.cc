@@ -43,7 +43,8 @@ SchedulerStateMachine::SchedulerStateMachine(const SchedulerSettings& settings)
       draw_if_possible_failed_(false),
       did_create_and_initialize_first_output_surface_(false),
       smoothness_takes_priority_(false),
-      skip_begin_main_frame_to_reduce_latency_(false) {}
+      skip_begin_main_frame_to_reduce_latency_(false),
+      main_frame_will_miss_deadline_(false) {}
 
 const char* SchedulerStateMachine::OutputSurfaceStateToString(
     OutputSurfaceState state) {
@@ -266,6 +267,8 @@ scoped_ptr<base::Value> SchedulerStateMachine::AsValue() const  {
                           MainThreadIsInHighLatencyMode());
   minor_state->SetBoolean("skip_begin_main_frame_to_reduce_latency",
                           skip_begin_main_frame_to_reduce_latency_);
+  minor_state->SetBoolean("main_frame_will_miss_deadline",
+                          main_frame_will_miss_deadline_);
   state->Set("minor_state", minor_state.release());
 
   return state.PassAs<base::Value>();
@@ -783,6 +786,17 @@ void SchedulerStateMachine::SetSkipBeginMainFrameToReduceLatency(bool skip) {
   skip_begin_main_frame_to_reduce_latency_ = skip;
 }
 
+void SchedulerStateMachine::SetMainFrameWillMissDeadline(bool will_miss) {
+  main_frame_will_miss_deadline_ = will_miss;
+}
+
+bool SchedulerStateMachine::MainFrameMissedDeadline() const {
+  if (!HasSentBeginMainFrameThisFrame())
+    return false;
+  return commit_state_ == COMMIT_STATE_FRAME_IN_PROGRESS ||
+         commit_state_ == COMMIT_STATE_READY_TO_COMMIT || has_pending_tree_;
+}
+
 bool SchedulerStateMachine::BeginImplFrameNeeded() const {
   // Proactive BeginImplFrames are bad for the synchronous compositor because we
   // have to draw when we get the BeginImplFrame and could end up drawing many
@@ -948,6 +962,11 @@ bool SchedulerStateMachine::ShouldTriggerBeginImplFrameDeadlineEarly() const {
   if (smoothness_takes_priority_)
     return true;
 
+  // Don't hold back impl-thread draws for a main frame that isn't expected to
+  // make the deadline anyway; it will be drawn in a later frame instead.
+  if (main_frame_will_miss_deadline_)
+    return true;
+
   return false;
 }
 
@@ -216,6 +216,15 @@ class CC_EXPORT SchedulerStateMachine {
 
   void SetSkipBeginMainFrameToReduceLatency(bool skip);
 
+  // Indicates that the main thread is not expected to commit and activate
+  // before this BeginImplFrame's deadline, so impl-thread draws should not
+  // wait for it.
+  void SetMainFrameWillMissDeadline(bool will_miss);
+
+  // True if a BeginMainFrame was sent during the current BeginImplFrame but
+  // its commit has not yet been activated.
+  bool MainFrameMissedDeadline() const;
+
   // Indicates whether drawing would, at this time, make sense.
   // CanDraw can be used to suppress flashes or checkerboarding
   // when such behavior would be undesirable.
@@ -305,6 +314,7 @@ class CC_EXPORT SchedulerStateMachine {
   bool did_create_and_initialize_first_output_surface_;
   bool smoothness_takes_priority_;
   bool skip_begin_main_frame_to_reduce_latency_;
+  bool main_frame_will_miss_deadline_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(SchedulerStateMachine);
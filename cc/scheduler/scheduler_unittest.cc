@@ -1174,6 +1174,32 @@ TEST(SchedulerTest, NotSkipMainFrameIfHighLatencyAndCanActivateTooLong) {
   MainFrameInHighLatencyMode(1, 10, true);
 }
 
+TEST(SchedulerTest, CountsMainFrameDeadlineMisses) {
+  FakeSchedulerClient client;
+  SchedulerSettings scheduler_settings;
+  scheduler_settings.predict_main_frame_deadline_misses = true;
+  Scheduler* scheduler = client.CreateScheduler(scheduler_settings);
+  scheduler->SetCanStart();
+  scheduler->SetVisible(true);
+  scheduler->SetCanDraw(true);
+  InitializeOutputSurfaceAndFirstCommit(scheduler);
+  EXPECT_EQ(0, scheduler->main_frame_deadline_miss_count());
+
+  // The commit finishes before the deadline.
+  scheduler->SetNeedsCommit();
+  scheduler->BeginImplFrame(BeginFrameArgs::CreateForTesting());
+  scheduler->FinishCommit();
+  scheduler->OnBeginImplFrameDeadline();
+  EXPECT_EQ(0, scheduler->main_frame_deadline_miss_count());
+
+  // The deadline is hit before the commit finishes.
+  scheduler->SetNeedsCommit();
+  scheduler->BeginImplFrame(BeginFrameArgs::CreateForTesting());
+  scheduler->OnBeginImplFrameDeadline();
+  EXPECT_EQ(1, scheduler->main_frame_deadline_miss_count());
+  scheduler->FinishCommit();
+}
+
 void SpinForMillis(int millis) {
   base::RunLoop run_loop;
   base::MessageLoop::current()->PostDelayedTask(
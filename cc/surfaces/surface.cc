@@ -23,6 +23,11 @@ Surface::~Surface() {
 }
 
 void Surface::QueueFrame(scoped_ptr<CompositorFrame> frame) {
+  if (frame->delegated_frame_data) {
+    DelegatedFrameData* previous_frame_data =
+        current_frame_ ? current_frame_->delegated_frame_data.get() : NULL;
+    frame->delegated_frame_data->TakeReusedQuadsFrom(previous_frame_data);
+  }
   current_frame_ = frame.Pass();
 }
 
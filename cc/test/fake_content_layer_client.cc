@@ -37,6 +37,11 @@ void FakeContentLayerClient::PaintContents(SkCanvas* canvas,
       it != draw_bitmaps_.end(); ++it) {
     canvas->drawBitmap(it->bitmap, it->point.x(), it->point.y(), &it->paint);
   }
+
+  for (PathPaintVector::const_iterator it = draw_paths_.begin();
+      it != draw_paths_.end(); ++it) {
+    canvas->drawPath(it->first, it->second);
+  }
 }
 
 }  // namespace cc
@@ -22,6 +22,7 @@ FakeOutputSurface::FakeOutputSurface(
       needs_begin_impl_frame_(false),
       forced_draw_to_software_device_(false),
       has_external_stencil_test_(false),
+      buffer_age_(0),
       fake_weak_ptr_factory_(this) {
   if (delegated_rendering) {
     capabilities_.delegated_rendering = true;
@@ -37,6 +38,7 @@ FakeOutputSurface::FakeOutputSurface(
       num_sent_frames_(0),
       forced_draw_to_software_device_(false),
       has_external_stencil_test_(false),
+      buffer_age_(0),
       fake_weak_ptr_factory_(this) {
   if (delegated_rendering) {
     capabilities_.delegated_rendering = true;
@@ -53,6 +55,7 @@ FakeOutputSurface::FakeOutputSurface(
       num_sent_frames_(0),
       forced_draw_to_software_device_(false),
       has_external_stencil_test_(false),
+      buffer_age_(0),
       fake_weak_ptr_factory_(this) {
   if (delegated_rendering) {
     capabilities_.delegated_rendering = true;
@@ -143,6 +146,10 @@ bool FakeOutputSurface::HasExternalStencilTest() const {
   return has_external_stencil_test_;
 }
 
+int FakeOutputSurface::GetBufferAge() const {
+  return buffer_age_;
+}
+
 void FakeOutputSurface::SetMemoryPolicyToSetAtBind(
     scoped_ptr<ManagedMemoryPolicy> memory_policy_to_set_at_bind) {
   memory_policy_to_set_at_bind_.swap(memory_policy_to_set_at_bind);
@@ -123,6 +123,10 @@ class FakeOutputSurface : public OutputSurface {
     has_external_stencil_test_ = has_test;
   }
 
+  virtual int GetBufferAge() const OVERRIDE;
+
+  void set_buffer_age(int buffer_age) { buffer_age_ = buffer_age; }
+
   void SetMemoryPolicyToSetAtBind(
       scoped_ptr<ManagedMemoryPolicy> memory_policy_to_set_at_bind);
 
@@ -148,6 +152,7 @@ class FakeOutputSurface : public OutputSurface {
   bool needs_begin_impl_frame_;
   bool forced_draw_to_software_device_;
   bool has_external_stencil_test_;
+  int buffer_age_;
   TransferableResourceArray resources_held_by_parent_;
   base::WeakPtrFactory<FakeOutputSurface> fake_weak_ptr_factory_;
   scoped_ptr<ManagedMemoryPolicy> memory_policy_to_set_at_bind_;
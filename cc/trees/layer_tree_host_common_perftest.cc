@@ -13,6 +13,7 @@
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "cc/layers/layer.h"
+#include "cc/layers/layer_impl.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/fake_layer_tree_host_client.h"
 #include "cc/test/lap_timer.h"
@@ -29,12 +30,21 @@ static const int kTimeLimitMillis = 2000;
 static const int kWarmupRuns = 5;
 static const int kTimeCheckInterval = 10;
 
+// Shape of the generated tree used by the scrolling tests: a scroll layer
+// with kNumContainers children, each with kLayersPerContainer drawable
+// children, for a little over 2000 layers.
+static const int kNumContainers = 50;
+static const int kLayersPerContainer = 40;
+static const int kMaxScrollOffset = 100;
+
 class LayerTreeHostCommonPerfTest : public LayerTreeTest {
  public:
   LayerTreeHostCommonPerfTest()
       : timer_(kWarmupRuns,
                base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
-               kTimeCheckInterval) {}
+               kTimeCheckInterval),
+        use_large_scrolling_tree_(false),
+        scroll_layer_id_(0) {}
 
   void ReadTestFile(const std::string& name) {
     base::FilePath test_data_dir;
@@ -43,15 +53,49 @@ class LayerTreeHostCommonPerfTest : public LayerTreeTest {
     ASSERT_TRUE(base::ReadFileToString(json_file, &json_));
   }
 
+  // Builds a large scrolling tree instead of reading one from a file, so
+  // that each lap can scroll it.
+  void UseLargeScrollingTree() { use_large_scrolling_tree_ = true; }
+
   virtual void SetupTree() OVERRIDE {
     gfx::Size viewport = gfx::Size(720, 1038);
     layer_tree_host()->SetViewportSize(viewport);
     scoped_refptr<Layer> root =
-        ParseTreeFromJson(json_, &content_layer_client_);
+        use_large_scrolling_tree_
+            ? BuildLargeScrollingTree(viewport)
+            : ParseTreeFromJson(json_, &content_layer_client_);
     ASSERT_TRUE(root.get());
     layer_tree_host()->SetRootLayer(root);
   }
 
+  scoped_refptr<Layer> BuildLargeScrollingTree(const gfx::Size& viewport) {
+    scoped_refptr<Layer> root = Layer::Create();
+    root->SetBounds(viewport);
+    root->SetMasksToBounds(true);
+
+    scoped_refptr<Layer> scroll_layer = Layer::Create();
+    scroll_layer->SetBounds(gfx::Size(viewport.width(),
+                                      kNumContainers * kLayersPerContainer));
+    scroll_layer->SetScrollClipLayerId(root->id());
+    root->AddChild(scroll_layer);
+    scroll_layer_id_ = scroll_layer->id();
+
+    for (int i = 0; i < kNumContainers; ++i) {
+      scoped_refptr<Layer> container = Layer::Create();
+      container->SetPosition(gfx::PointF(0, i * kLayersPerContainer));
+      container->SetBounds(gfx::Size(viewport.width(), kLayersPerContainer));
+      scroll_layer->AddChild(container);
+      for (int j = 0; j < kLayersPerContainer; ++j) {
+        scoped_refptr<Layer> layer = Layer::Create();
+        layer->SetPosition(gfx::PointF((j % 10) * 10, j));
+        layer->SetBounds(gfx::Size(10, 1));
+        layer->SetIsDrawable(true);
+        container->AddChild(layer);
+      }
+    }
+    return root;
+  }
+
   void SetTestName(const std::string& name) { test_name_ = name; }
 
   virtual void AfterTest() OVERRIDE {
@@ -69,6 +113,9 @@ class LayerTreeHostCommonPerfTest : public LayerTreeTest {
   LapTimer timer_;
   std::string test_name_;
   std::string json_;
+  bool use_large_scrolling_tree_;
+  // The id of the layer scrolled on each lap, or 0 if none.
+  int scroll_layer_id_;
 };
 
 class CalcDrawPropsMainTest : public LayerTreeHostCommonPerfTest {
@@ -79,8 +126,19 @@ class CalcDrawPropsMainTest : public LayerTreeHostCommonPerfTest {
 
   virtual void BeginTest() OVERRIDE {
     timer_.Reset();
+    Layer* scroll_layer =
+        scroll_layer_id_ ? LayerTreeHostCommon::FindLayerInSubtree(
+                               layer_tree_host()->root_layer(),
+                               scroll_layer_id_)
+                         : NULL;
+    int lap = 0;
 
     do {
+      // Scrolling invalidates the draw properties of the whole subtree.
+      if (scroll_layer)
+        scroll_layer->SetScrollOffset(
+            gfx::Vector2d(0, lap++ % kMaxScrollOffset));
+
       bool can_render_to_separate_surface = true;
       int max_texture_size = 8096;
       RenderSurfaceLayerList update_list;
@@ -120,8 +178,15 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
   virtual void DrawLayersOnThread(LayerTreeHostImpl* host_impl) OVERRIDE {
     timer_.Reset();
     LayerTreeImpl* active_tree = host_impl->active_tree();
+    LayerImpl* scroll_layer =
+        scroll_layer_id_ ? active_tree->LayerById(scroll_layer_id_) : NULL;
+    int lap = 0;
 
     do {
+      if (scroll_layer)
+        scroll_layer->SetScrollDelta(
+            gfx::Vector2dF(0, lap++ % kMaxScrollOffset));
+
       bool can_render_to_separate_surface = true;
       int max_texture_size = 8096;
       LayerImplList update_list;
@@ -170,6 +235,12 @@ TEST_F(CalcDrawPropsMainTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsMainTest, LargeScrollingTree) {
+  SetTestName("large_scrolling_tree_main_thread");
+  UseLargeScrollingTree();
+  RunCalcDrawProps();
+}
+
 TEST_F(CalcDrawPropsImplTest, TenTen) {
   SetTestName("10_10");
   ReadTestFile("10_10_layer_tree");
@@ -194,5 +265,11 @@ TEST_F(CalcDrawPropsImplTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsImplTest, LargeScrollingTree) {
+  SetTestName("large_scrolling_tree");
+  UseLargeScrollingTree();
+  RunCalcDrawProps();
+}
+
 }  // namespace
 }  // namespace cc
@@ -47,6 +47,7 @@
 #include "cc/resources/memory_history.h"
 #include "cc/resources/picture_layer_tiling.h"
 #include "cc/resources/prioritized_resource_manager.h"
+#include "cc/resources/resource_atlas.h"
 #include "cc/resources/texture_mailbox_deleter.h"
 #include "cc/resources/ui_resource_bitmap.h"
 #include "cc/scheduler/delay_based_time_source.h"
@@ -64,6 +65,9 @@
 
 namespace {
 
+// Width and height of the textures small UI resources are packed into.
+const int kUIResourceAtlasTextureSize = 512;
+
 void DidVisibilityChange(cc::LayerTreeHostImpl* id, bool visible) {
   if (visible) {
     TRACE_EVENT_ASYNC_BEGIN1("webkit",
@@ -1780,6 +1784,7 @@ bool LayerTreeHostImpl::InitializeRenderer(
   // Note: order is important here.
   renderer_.reset();
   tile_manager_.reset();
+  ui_resource_atlas_.reset();
   resource_provider_.reset();
   output_surface_.reset();
 
@@ -2902,7 +2907,42 @@ void LayerTreeHostImpl::CreateUIResource(UIResourceId uid,
   if (id)
     DeleteUIResource(uid);
 
+  UIResourceData data;
+  data.size = bitmap.GetSize();
+  data.opaque = bitmap.GetOpaque();
+  data.in_atlas = false;
+  data.uv_rect = gfx::RectF(1.f, 1.f);
+
+  AutoLockUIResourceBitmap bitmap_lock(bitmap);
+
+  // Small clamped images are packed together, so that a frame's many small
+  // UI resources don't each need their own texture and the quads drawing
+  // them can share one.
   ResourceFormat format = resource_provider_->best_texture_format();
+  if (settings_.use_ui_resource_atlas &&
+      bitmap.GetFormat() != UIResourceBitmap::ETC1 &&
+      wrap_mode == GL_CLAMP_TO_EDGE) {
+    if (!ui_resource_atlas_) {
+      int texture_dimension = std::min(kUIResourceAtlasTextureSize,
+                                       resource_provider_->max_texture_size());
+      ui_resource_atlas_ = ResourceAtlas::Create(
+          resource_provider_.get(),
+          gfx::Size(texture_dimension, texture_dimension),
+          format,
+          texture_dimension / 4);
+    }
+    ResourceAtlas::Allocation allocation;
+    if (ui_resource_atlas_->AddImage(
+            bitmap.GetSize(), bitmap_lock.GetPixels(), &allocation)) {
+      data.resource_id = allocation.resource_id;
+      data.in_atlas = true;
+      data.uv_rect = allocation.uv_rect;
+      ui_resource_map_[uid] = data;
+      MarkUIResourceNotEvicted(uid);
+      return;
+    }
+  }
+
   if (bitmap.GetFormat() == UIResourceBitmap::ETC1)
     format = ETC1;
   id = resource_provider_->CreateResource(
@@ -2911,14 +2951,9 @@ void LayerTreeHostImpl::CreateUIResource(UIResourceId uid,
       ResourceProvider::TextureUsageAny,
       format);
 
-  UIResourceData data;
   data.resource_id = id;
-  data.size = bitmap.GetSize();
-  data.opaque = bitmap.GetOpaque();
-
   ui_resource_map_[uid] = data;
 
-  AutoLockUIResourceBitmap bitmap_lock(bitmap);
   resource_provider_->SetPixels(id,
                                 bitmap_lock.GetPixels(),
                                 gfx::Rect(bitmap.GetSize()),
@@ -2928,10 +2963,13 @@ void LayerTreeHostImpl::CreateUIResource(UIResourceId uid,
 }
 
 void LayerTreeHostImpl::DeleteUIResource(UIResourceId uid) {
-  ResourceProvider::ResourceId id = ResourceIdForUIResource(uid);
-  if (id) {
-    resource_provider_->DeleteResource(id);
-    ui_resource_map_.erase(uid);
+  UIResourceMap::iterator iter = ui_resource_map_.find(uid);
+  if (iter != ui_resource_map_.end()) {
+    if (iter->second.in_atlas)
+      ui_resource_atlas_->RemoveImage(iter->second.resource_id);
+    else
+      resource_provider_->DeleteResource(iter->second.resource_id);
+    ui_resource_map_.erase(iter);
   }
   MarkUIResourceNotEvicted(uid);
 }
@@ -2944,9 +2982,12 @@ void LayerTreeHostImpl::EvictAllUIResources() {
       iter != ui_resource_map_.end();
       ++iter) {
     evicted_ui_resources_.insert(iter->first);
-    resource_provider_->DeleteResource(iter->second.resource_id);
+    if (!iter->second.in_atlas)
+      resource_provider_->DeleteResource(iter->second.resource_id);
   }
   ui_resource_map_.clear();
+  if (ui_resource_atlas_)
+    ui_resource_atlas_->Clear();
 
   client_->SetNeedsCommitOnImplThread();
   client_->OnCanDrawStateChanged(CanDraw());
@@ -2961,6 +3002,13 @@ ResourceProvider::ResourceId LayerTreeHostImpl::ResourceIdForUIResource(
   return 0;
 }
 
+gfx::RectF LayerTreeHostImpl::UVRectForUIResource(UIResourceId uid) const {
+  UIResourceMap::const_iterator iter = ui_resource_map_.find(uid);
+  if (iter != ui_resource_map_.end())
+    return iter->second.uv_rect;
+  return gfx::RectF(1.f, 1.f);
+}
+
 bool LayerTreeHostImpl::IsUIResourceOpaque(UIResourceId uid) const {
   UIResourceMap::const_iterator iter = ui_resource_map_.find(uid);
   DCHECK(iter != ui_resource_map_.end());
@@ -34,6 +34,7 @@
 #include "skia/ext/refptr.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
 
 namespace cc {
 
@@ -46,6 +47,7 @@ class LayerTreeHostImplTimeSourceAdapter;
 class LayerTreeImpl;
 class PageScaleAnimation;
 class PaintTimeCounter;
+class ResourceAtlas;
 class MemoryHistory;
 class RenderingStatsInstrumentation;
 class RenderPassDrawQuad;
@@ -409,10 +411,18 @@ class CC_EXPORT LayerTreeHostImpl
 
   virtual bool IsUIResourceOpaque(UIResourceId uid) const;
 
+  // The part of ResourceIdForUIResource(uid) holding the UI resource's
+  // contents, in normalized texture coordinates.
+  gfx::RectF UVRectForUIResource(UIResourceId uid) const;
+
   struct UIResourceData {
     ResourceProvider::ResourceId resource_id;
     gfx::Size size;
     bool opaque;
+    // Set when the resource was packed into |ui_resource_atlas_|, in which
+    // case |resource_id| is shared with other UI resources.
+    bool in_atlas;
+    gfx::RectF uv_rect;
   };
 
   void ScheduleMicroBenchmark(scoped_ptr<MicroBenchmarkImpl> benchmark);
@@ -536,6 +546,8 @@ class CC_EXPORT LayerTreeHostImpl
   // |resource_provider_| and |tile_manager_| can be NULL, e.g. when using tile-
   // free rendering - see OutputSurface::ForcedDrawToSoftwareDevice().
   scoped_ptr<ResourceProvider> resource_provider_;
+  // Declared after |resource_provider_|, as it deletes its textures from it.
+  scoped_ptr<ResourceAtlas> ui_resource_atlas_;
   scoped_ptr<TileManager> tile_manager_;
   scoped_ptr<Renderer> renderer_;
 
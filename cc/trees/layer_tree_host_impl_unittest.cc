@@ -5526,6 +5526,48 @@ TEST_F(LayerTreeHostImplTest, CreateETC1UIResource) {
   EXPECT_NE(0u, id1);
 }
 
+TEST_F(LayerTreeHostImplTest, SmallUIResourcesShareAtlasTexture) {
+  LayerTreeSettings settings = DefaultSettings();
+  settings.use_ui_resource_atlas = true;
+  CreateHostImpl(settings,
+                 FakeOutputSurface::Create3d().PassAs<OutputSurface>());
+  ResourceProvider* resource_provider = host_impl_->resource_provider();
+  EXPECT_EQ(0u, resource_provider->num_resources());
+
+  SkBitmap skbitmap;
+  skbitmap.setConfig(SkBitmap::kARGB_8888_Config, 4, 4);
+  skbitmap.allocPixels();
+  skbitmap.setImmutable();
+  UIResourceBitmap bitmap(skbitmap);
+
+  host_impl_->CreateUIResource(1, bitmap);
+  host_impl_->CreateUIResource(2, bitmap);
+  EXPECT_EQ(1u, resource_provider->num_resources());
+  EXPECT_EQ(host_impl_->ResourceIdForUIResource(1),
+            host_impl_->ResourceIdForUIResource(2));
+
+  gfx::RectF uv_rect1 = host_impl_->UVRectForUIResource(1);
+  gfx::RectF uv_rect2 = host_impl_->UVRectForUIResource(2);
+  EXPECT_FALSE(uv_rect1.Intersects(uv_rect2));
+  EXPECT_TRUE(gfx::RectF(1.f, 1.f).Contains(uv_rect1));
+  EXPECT_TRUE(gfx::RectF(1.f, 1.f).Contains(uv_rect2));
+
+  // Repeating resources can't be packed.
+  UIResourceBitmap repeat_bitmap(skbitmap);
+  repeat_bitmap.SetWrapMode(UIResourceBitmap::REPEAT);
+  host_impl_->CreateUIResource(3, repeat_bitmap);
+  EXPECT_EQ(2u, resource_provider->num_resources());
+  EXPECT_EQ(gfx::RectF(1.f, 1.f), host_impl_->UVRectForUIResource(3));
+
+  // The atlas texture is deleted with the last resource in it.
+  host_impl_->DeleteUIResource(1);
+  EXPECT_EQ(2u, resource_provider->num_resources());
+  host_impl_->DeleteUIResource(2);
+  EXPECT_EQ(1u, resource_provider->num_resources());
+  host_impl_->DeleteUIResource(3);
+  EXPECT_EQ(0u, resource_provider->num_resources());
+}
+
 void ShutdownReleasesContext_Callback(scoped_ptr<CopyOutputResult> result) {
 }
 
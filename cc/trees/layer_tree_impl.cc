@@ -438,6 +438,7 @@ void LayerTreeImpl::UpdateDrawProperties() {
 
   needs_update_draw_properties_ = false;
   render_surface_layer_list_.clear();
+  draw_properties_store_.Clear();
 
   // For max_texture_size.
   if (!layer_tree_host_impl_->renderer())
@@ -470,6 +471,7 @@ void LayerTreeImpl::UpdateDrawProperties() {
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    draw_properties_store_.Update(render_surface_layer_list_);
   }
 
   {
@@ -479,18 +481,12 @@ void LayerTreeImpl::UpdateDrawProperties() {
                  IsActiveTree(),
                  "SourceFrameNumber",
                  source_frame_number_);
-    // LayerIterator is used here instead of CallFunctionForSubtree to only
-    // UpdateTilePriorities on layers that will be visible (and thus have valid
-    // draw properties) and not because any ordering is required.
-    typedef LayerIterator<LayerImpl> LayerIteratorType;
-    LayerIteratorType end = LayerIteratorType::End(&render_surface_layer_list_);
-    for (LayerIteratorType it =
-             LayerIteratorType::Begin(&render_surface_layer_list_);
-         it != end;
-         ++it) {
-      if (!it.represents_itself())
-        continue;
-      LayerImpl* layer = *it;
+    // The draw properties store is used here instead of
+    // CallFunctionForSubtree to only UpdateTilePriorities on layers that will
+    // be visible (and thus have valid draw properties) and not because any
+    // ordering is required.
+    for (size_t i = 0; i < draw_properties_store_.size(); ++i) {
+      LayerImpl* layer = draw_properties_store_.layer(i);
 
       layer->UpdateTilePriorities();
       if (layer->mask_layer())
@@ -510,6 +506,12 @@ const LayerImplList& LayerTreeImpl::RenderSurfaceLayerList() const {
   return render_surface_layer_list_;
 }
 
+const DrawPropertiesStore& LayerTreeImpl::draw_properties_store() const {
+  // If this assert triggers, then the store is dirty.
+  DCHECK(!needs_update_draw_properties_);
+  return draw_properties_store_;
+}
+
 gfx::Size LayerTreeImpl::ScrollableSize() const {
   LayerImpl* root_scroll_layer = OuterViewportScrollLayer()
                                      ? OuterViewportScrollLayer()
@@ -917,6 +919,10 @@ ResourceProvider::ResourceId LayerTreeImpl::ResourceIdForUIResource(
   return layer_tree_host_impl_->ResourceIdForUIResource(uid);
 }
 
+gfx::RectF LayerTreeImpl::UVRectForUIResource(UIResourceId uid) const {
+  return layer_tree_host_impl_->UVRectForUIResource(uid);
+}
+
 bool LayerTreeImpl::IsUIResourceOpaque(UIResourceId uid) const {
   return layer_tree_host_impl_->IsUIResourceOpaque(uid);
 }
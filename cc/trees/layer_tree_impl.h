@@ -13,6 +13,7 @@
 #include "base/values.h"
 #include "cc/base/scoped_ptr_vector.h"
 #include "cc/base/swap_promise.h"
+#include "cc/layers/draw_properties_store.h"
 #include "cc/layers/layer_impl.h"
 #include "cc/output/renderer.h"
 #include "cc/resources/ui_resource_client.h"
@@ -182,6 +183,10 @@ class CC_EXPORT LayerTreeImpl {
 
   const LayerImplList& RenderSurfaceLayerList() const;
 
+  // The draw properties of the layers in RenderSurfaceLayerList() that draw
+  // themselves, laid out for linear passes over every layer.
+  const DrawPropertiesStore& draw_properties_store() const;
+
   // These return the size of the root scrollable area and the size of
   // the user-visible scrolling viewport, in CSS layout coordinates.
   gfx::Size ScrollableSize() const;
@@ -239,6 +244,8 @@ class CC_EXPORT LayerTreeImpl {
 
   bool IsUIResourceOpaque(UIResourceId uid) const;
 
+  gfx::RectF UVRectForUIResource(UIResourceId uid) const;
+
   void AddLayerWithCopyOutputRequest(LayerImpl* layer);
   void RemoveLayerWithCopyOutputRequest(LayerImpl* layer);
   const std::vector<LayerImpl*>& LayersWithCopyOutputRequest() const;
@@ -282,6 +289,7 @@ class CC_EXPORT LayerTreeImpl {
   // List of visible or hit-testable layers for the most recently prepared
   // frame. Used for rendering and input event hit testing.
   LayerImplList render_surface_layer_list_;
+  DrawPropertiesStore draw_properties_store_;
 
   bool contents_textures_purged_;
   bool requires_high_res_to_draw_;
@@ -18,6 +18,7 @@ LayerTreeSettings::LayerTreeSettings()
       throttle_frame_production(true),
       begin_impl_frame_scheduling_enabled(false),
       using_synchronous_renderer_compositor(false),
+      predict_main_frame_deadline_misses(false),
       per_tile_painting_enabled(false),
       partial_swap_enabled(false),
       accelerated_animation_enabled(true),
@@ -58,6 +59,9 @@ LayerTreeSettings::LayerTreeSettings()
       use_map_image(false),
       ignore_root_layer_flings(false),
       use_rgba_4444_textures(false),
+      use_ui_resource_atlas(false),
+      use_etc1_tiles(false),
+      use_incremental_delegated_frames(false),
       touch_hit_testing(true),
       texture_id_allocation_chunk_size(64) {}
 
@@ -23,6 +23,7 @@ class CC_EXPORT LayerTreeSettings {
   bool throttle_frame_production;
   bool begin_impl_frame_scheduling_enabled;
   bool using_synchronous_renderer_compositor;
+  bool predict_main_frame_deadline_misses;
   bool per_tile_painting_enabled;
   bool partial_swap_enabled;
   bool accelerated_animation_enabled;
@@ -68,6 +69,9 @@ class CC_EXPORT LayerTreeSettings {
   bool use_map_image;
   bool ignore_root_layer_flings;
   bool use_rgba_4444_textures;
+  bool use_ui_resource_atlas;
+  bool use_etc1_tiles;
+  bool use_incremental_delegated_frames;
   bool touch_hit_testing;
   size_t texture_id_allocation_chunk_size;
 
@@ -1479,6 +1479,8 @@ void ThreadProxy::InitializeImplOnImplThread(CompletionEvent* completion) {
       settings.using_synchronous_renderer_compositor;
   scheduler_settings.throttle_frame_production =
       settings.throttle_frame_production;
+  scheduler_settings.predict_main_frame_deadline_misses =
+      settings.predict_main_frame_deadline_misses;
   impl().scheduler =
       Scheduler::Create(this, scheduler_settings, impl().layer_tree_host_id);
   impl().scheduler->SetVisible(impl().layer_tree_host_impl->visible());
@@ -4,12 +4,15 @@
 
 #include "chrome/browser/autocomplete/autocomplete_controller.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
@@ -42,6 +45,9 @@
 
 namespace {
 
+// Default for AutocompleteController::sync_providers_budget_.
+const int kSyncProvidersBudgetMs = 20;
+
 // Converts the given match to a type (and possibly subtype) based on the AQS
 // specification. For more details, see
 // http://goto.google.com/binary-clients-logging.
@@ -161,10 +167,13 @@ AutocompleteController::AutocompleteController(
       search_provider_(NULL),
       zero_suggest_provider_(NULL),
       stop_timer_duration_(OmniboxFieldTrial::StopTimerFieldTrialDuration()),
+      sync_providers_budget_(
+          base::TimeDelta::FromMilliseconds(kSyncProvidersBudgetMs)),
       done_(true),
       in_start_(false),
       in_zero_suggest_(false),
-      profile_(profile) {
+      profile_(profile),
+      weak_factory_(this) {
   // AND with the disabled providers, if any.
   provider_types &= ~OmniboxFieldTrial::GetDisabledProviderTypes();
   bool use_hqp = !!(provider_types & AutocompleteProvider::TYPE_HISTORY_QUICK);
@@ -253,25 +262,35 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  CancelDeferredProviders();
 
-  // Start the new query.
+  // Start the new query.  The providers which can't be deferred go first, so
+  // that the others can be started asynchronously if they run out of time.
+  // Synchronous queries must still get all their matches from Start().
   in_zero_suggest_ = false;
   in_start_ = true;
   base::TimeTicks start_time = base::TimeTicks::Now();
   for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
        ++i) {
-    // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
-    // are resolved.
-    base::TimeTicks provider_start_time = base::TimeTicks::Now();
-    (*i)->Start(input_, minimal_changes);
-    if (input.matches_requested() != AutocompleteInput::ALL_MATCHES)
-      DCHECK((*i)->done());
-    base::TimeTicks provider_end_time = base::TimeTicks::Now();
-    std::string name = std::string("Omnibox.ProviderTime.") + (*i)->GetName();
-    base::HistogramBase* counter = base::Histogram::FactoryGet(
-        name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
-    counter->Add(static_cast<int>(
-        (provider_end_time - provider_start_time).InMilliseconds()));
+    if (!CanDeferProvider(*i))
+      StartProvider(*i, minimal_changes);
+  }
+  const bool can_defer =
+      input.matches_requested() == AutocompleteInput::ALL_MATCHES;
+  for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
+       ++i) {
+    if (!CanDeferProvider(*i))
+      continue;
+    if (can_defer &&
+        (base::TimeTicks::Now() - start_time > sync_providers_budget_))
+      deferred_providers_.push_back(*i);
+    else
+      StartProvider(*i, minimal_changes);
+  }
+  if (!deferred_providers_.empty()) {
+    UMA_HISTOGRAM_COUNTS_100("Omnibox.DeferredProviderCount",
+                             deferred_providers_.size());
+    PostDeferredProviderTask();
   }
   if (input.matches_requested() == AutocompleteInput::ALL_MATCHES &&
       (input.text().length() < 6)) {
@@ -306,6 +325,7 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
 }
 
 void AutocompleteController::Stop(bool clear_result) {
+  CancelDeferredProviders();
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     (*i)->Stop(clear_result);
@@ -443,8 +463,11 @@ void AutocompleteController::UpdateResult(
   last_result.Swap(&result_);
 
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
-       ++i)
-    result_.AppendMatches((*i)->matches());
+       ++i) {
+    if (std::find(deferred_providers_.begin(), deferred_providers_.end(),
+                  *i) == deferred_providers_.end())
+      result_.AppendMatches((*i)->matches());
+  }
 
   // Sort the matches and trim to a small number of "best" matches.
   result_.SortAndCull(input_, profile_);
@@ -622,6 +645,10 @@ void AutocompleteController::NotifyChanged(bool notify_default_match) {
 }
 
 void AutocompleteController::CheckIfDone() {
+  if (!deferred_providers_.empty()) {
+    done_ = false;
+    return;
+  }
   for (ACProviders::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     if (!(*i)->done()) {
@@ -652,3 +679,61 @@ void AutocompleteController::StartStopTimer() {
                                base::Unretained(this),
                                false));
 }
+
+void AutocompleteController::StartProvider(AutocompleteProvider* provider,
+                                           bool minimal_changes) {
+  // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
+  // are resolved.
+  base::TimeTicks provider_start_time = base::TimeTicks::Now();
+  provider->Start(input_, minimal_changes);
+  if (input_.matches_requested() != AutocompleteInput::ALL_MATCHES)
+    DCHECK(provider->done());
+  base::TimeTicks provider_end_time = base::TimeTicks::Now();
+  std::string name = std::string("Omnibox.ProviderTime.") + provider->GetName();
+  base::HistogramBase* counter = base::Histogram::FactoryGet(
+      name, 1, 5000, 20, base::Histogram::kUmaTargetedHistogramFlag);
+  counter->Add(static_cast<int>(
+      (provider_end_time - provider_start_time).InMilliseconds()));
+}
+
+// static
+bool AutocompleteController::CanDeferProvider(
+    const AutocompleteProvider* provider) {
+  // These only search in-memory data on the UI thread, which can take a while
+  // with large histories or many bookmarks.
+  switch (provider->type()) {
+    case AutocompleteProvider::TYPE_BOOKMARK:
+    case AutocompleteProvider::TYPE_HISTORY_QUICK:
+    case AutocompleteProvider::TYPE_SHORTCUTS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void AutocompleteController::CancelDeferredProviders() {
+  deferred_providers_.clear();
+  weak_factory_.InvalidateWeakPtrs();
+}
+
+void AutocompleteController::PostDeferredProviderTask() {
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&AutocompleteController::StartDeferredProvider,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void AutocompleteController::StartDeferredProvider() {
+  DCHECK(!deferred_providers_.empty());
+  AutocompleteProvider* provider = deferred_providers_.front();
+  deferred_providers_.erase(deferred_providers_.begin());
+  // The provider didn't run on the previous input if that query was
+  // cancelled, so it can't reuse its matches.
+  in_start_ = true;
+  StartProvider(provider, false);
+  in_start_ = false;
+  if (!deferred_providers_.empty())
+    PostDeferredProviderTask();
+  CheckIfDone();
+  UpdateResult(false, false);
+}
@@ -8,6 +8,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
@@ -138,6 +139,8 @@ class AutocompleteController : public AutocompleteProviderListener {
                            RedundantKeywordsIgnoredInResult);
   FRIEND_TEST_ALL_PREFIXES(AutocompleteProviderTest, UpdateAssistedQueryStats);
   FRIEND_TEST_ALL_PREFIXES(AutocompleteProviderTest, GetDestinationURL);
+  FRIEND_TEST_ALL_PREFIXES(AutocompleteProviderTest, DeferProvidersOverBudget);
+  FRIEND_TEST_ALL_PREFIXES(AutocompleteProviderTest, CancelDeferredProviders);
 
   // Updates |result_| to reflect the current provider state and fires
   // notifications.  If |regenerate_result| then we clear the result
@@ -183,6 +186,25 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Starts |stop_timer_|.
   void StartStopTimer();
 
+  // Starts |provider| on |input_|, recording how long that took.
+  void StartProvider(AutocompleteProvider* provider, bool minimal_changes);
+
+  // Returns true if |provider| may be started after Start() returns once the
+  // synchronous providers have used up |sync_providers_budget_|. The providers
+  // which produce the what-you-typed and keyword matches are never deferred.
+  static bool CanDeferProvider(const AutocompleteProvider* provider);
+
+  // Drops the providers left in |deferred_providers_|, e.g. because the user
+  // typed another key.
+  void CancelDeferredProviders();
+
+  // Posts a task to start the first provider of |deferred_providers_|.
+  void PostDeferredProviderTask();
+
+  // Starts the first provider of |deferred_providers_| and merges its matches
+  // into |result_|.
+  void StartDeferredProvider();
+
   AutocompleteControllerDelegate* delegate_;
 
   // A list of all providers.
@@ -228,6 +250,16 @@ class AutocompleteController : public AutocompleteProviderListener {
   // and doesn't expect it to change.
   const base::TimeDelta stop_timer_duration_;
 
+  // How long Start() may spend in the providers which CanDeferProvider() before
+  // starting the rest of them asynchronously, one task each, so that the UI
+  // thread can handle keystrokes in between.
+  base::TimeDelta sync_providers_budget_;
+
+  // The providers that went over |sync_providers_budget_| in Start() and
+  // haven't been started yet. Their matches are stale, so they are left out
+  // of |result_|.
+  ACProviders deferred_providers_;
+
   // True if a query is not currently running.
   bool done_;
 
@@ -240,6 +272,9 @@ class AutocompleteController : public AutocompleteProviderListener {
 
   Profile* profile_;
 
+  // Used to cancel the start of |deferred_providers_|.
+  base::WeakPtrFactory<AutocompleteController> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AutocompleteController);
 };
 
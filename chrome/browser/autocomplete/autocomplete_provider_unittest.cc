@@ -50,7 +50,8 @@ class TestProvider : public AutocompleteProvider {
       : AutocompleteProvider(NULL, profile, AutocompleteProvider::TYPE_SEARCH),
         relevance_(relevance),
         prefix_(prefix),
-        match_keyword_(match_keyword) {
+        match_keyword_(match_keyword),
+        start_count_(0) {
   }
 
   virtual void Start(const AutocompleteInput& input,
@@ -60,6 +61,11 @@ class TestProvider : public AutocompleteProvider {
     listener_ = listener;
   }
 
+  void set_type(Type type) { type_ = type; }
+
+  // The number of times Start() was called.
+  int start_count() const { return start_count_; }
+
  private:
   virtual ~TestProvider() {}
 
@@ -75,10 +81,12 @@ class TestProvider : public AutocompleteProvider {
   int relevance_;
   const base::string16 prefix_;
   const base::string16 match_keyword_;
+  int start_count_;
 };
 
 void TestProvider::Start(const AutocompleteInput& input,
                          bool minimal_changes) {
+  ++start_count_;
   if (minimal_changes)
     return;
 
@@ -469,6 +477,59 @@ TEST_F(AutocompleteProviderTest, Query) {
 }
 
 // Tests assisted query stats.
+// Tests that the providers which can be deferred are started asynchronously
+// once the others have used up the time budget of Start(), and that their
+// matches are merged into the result.
+TEST_F(AutocompleteProviderTest, DeferProvidersOverBudget) {
+  TestProvider* provider1 = NULL;
+  TestProvider* provider2 = NULL;
+  ResetControllerWithTestProviders(false, &provider1, &provider2);
+  provider2->set_type(AutocompleteProvider::TYPE_HISTORY_QUICK);
+  controller_->sync_providers_budget_ = base::TimeDelta::FromMilliseconds(-1);
+
+  controller_->Start(AutocompleteInput(
+      base::ASCIIToUTF16("a"), base::string16::npos, base::string16(), GURL(),
+      AutocompleteInput::INVALID_SPEC, true, false, true,
+      AutocompleteInput::ALL_MATCHES));
+  EXPECT_EQ(1, provider1->start_count());
+  EXPECT_EQ(0, provider2->start_count());
+  EXPECT_FALSE(controller_->done());
+  base::MessageLoop::current()->Run();
+
+  EXPECT_EQ(1, provider2->start_count());
+  EXPECT_EQ(kResultsPerProvider * 2, result_.size());
+  ASSERT_NE(result_.end(), result_.default_match());
+  EXPECT_EQ(provider2, result_.default_match()->provider);
+
+  // Synchronous queries never defer providers.
+  controller_->Start(AutocompleteInput(
+      base::ASCIIToUTF16("b"), base::string16::npos, base::string16(), GURL(),
+      AutocompleteInput::INVALID_SPEC, true, false, true,
+      AutocompleteInput::SYNCHRONOUS_MATCHES));
+  EXPECT_EQ(2, provider2->start_count());
+  EXPECT_TRUE(controller_->done());
+}
+
+// Tests that a new query cancels the start of the providers deferred by the
+// previous one.
+TEST_F(AutocompleteProviderTest, CancelDeferredProviders) {
+  TestProvider* provider1 = NULL;
+  TestProvider* provider2 = NULL;
+  ResetControllerWithTestProviders(false, &provider1, &provider2);
+  provider2->set_type(AutocompleteProvider::TYPE_HISTORY_QUICK);
+  controller_->sync_providers_budget_ = base::TimeDelta::FromMilliseconds(-1);
+
+  controller_->Start(AutocompleteInput(
+      base::ASCIIToUTF16("a"), base::string16::npos, base::string16(), GURL(),
+      AutocompleteInput::INVALID_SPEC, true, false, true,
+      AutocompleteInput::ALL_MATCHES));
+  RunQuery(base::ASCIIToUTF16("ab"));
+
+  EXPECT_EQ(2, provider1->start_count());
+  EXPECT_EQ(1, provider2->start_count());
+  EXPECT_EQ(kResultsPerProvider * 2, result_.size());
+}
+
 TEST_F(AutocompleteProviderTest, AssistedQueryStats) {
   ResetControllerWithTestProviders(false, NULL, NULL);
   RunTest();
@@ -68,7 +68,6 @@
 #include "chrome/common/logging_chrome.h"
 #include "chrome/common/pref_names.h"
 #include "chromeos/chromeos_switches.h"
-#include "chromeos/cryptohome/cryptohome_util.h"
 #include "chromeos/dbus/cryptohome_client.h"
 #include "chromeos/dbus/dbus_method_call_status.h"
 #include "chromeos/dbus/dbus_thread_manager.h"
@@ -99,6 +98,65 @@ base::FilePath GetRlzDisabledFlagPath() {
 }
 #endif
 
+// Owns the TPM device if, for any reason, it has not been done in the EULA
+// wizard screen. The status queries are sent to cryptohome together, rather
+// than one blocking round trip after the other, and no longer hold up the UI
+// thread while the user session starts.
+class TpmOwnershipTaker : public base::RefCounted<TpmOwnershipTaker> {
+ public:
+  TpmOwnershipTaker()
+      : pending_replies_(0),
+        call_failed_(false),
+        enabled_(false),
+        owned_(false),
+        being_owned_(false) {
+  }
+
+  void Start() {
+    BootTimesLoader::Get()->AddLoginTimeMarker("TPMOwn-Start", false);
+    CryptohomeClient* client = DBusThreadManager::Get()->GetCryptohomeClient();
+    pending_replies_ = 3;
+    client->TpmIsEnabled(
+        base::Bind(&TpmOwnershipTaker::OnStatus, this, &enabled_));
+    client->TpmIsOwned(
+        base::Bind(&TpmOwnershipTaker::OnStatus, this, &owned_));
+    client->TpmIsBeingOwned(
+        base::Bind(&TpmOwnershipTaker::OnStatus, this, &being_owned_));
+  }
+
+ private:
+  friend class base::RefCounted<TpmOwnershipTaker>;
+
+  ~TpmOwnershipTaker() {}
+
+  void OnStatus(bool* status, DBusMethodCallStatus call_status, bool result) {
+    if (call_status == DBUS_METHOD_CALL_SUCCESS)
+      *status = result;
+    else
+      call_failed_ = true;
+    if (--pending_replies_ > 0)
+      return;
+
+    if (!call_failed_ && enabled_ && !being_owned_) {
+      CryptohomeClient* client =
+          DBusThreadManager::Get()->GetCryptohomeClient();
+      if (owned_)
+        client->TpmClearStoredPassword(EmptyVoidDBusMethodCallback());
+      else
+        client->TpmCanAttemptOwnership(EmptyVoidDBusMethodCallback());
+    }
+    BootTimesLoader::Get()->AddLoginTimeMarker("TPMOwn-End", false);
+  }
+
+  int pending_replies_;
+  bool call_failed_;
+  bool enabled_;
+  bool owned_;
+  bool being_owned_;
+
+  DISALLOW_COPY_AND_ASSIGN(TpmOwnershipTaker);
+};
+
 }  // namespace
 
 struct DoBrowserLaunchOnLocaleLoadedData;
@@ -618,19 +676,7 @@ void LoginUtilsImpl::RestoreAuthSession(Profile* user_profile,
 }
 
 void LoginUtilsImpl::FinalizePrepareProfile(Profile* user_profile) {
-  BootTimesLoader* btl = BootTimesLoader::Get();
-  // Own TPM device if, for any reason, it has not been done in EULA
-  // wizard screen.
-  CryptohomeClient* client = DBusThreadManager::Get()->GetCryptohomeClient();
-  btl->AddLoginTimeMarker("TPMOwn-Start", false);
-  if (cryptohome_util::TpmIsEnabled() && !cryptohome_util::TpmIsBeingOwned()) {
-    if (cryptohome_util::TpmIsOwned()) {
-      client->CallTpmClearStoredPasswordAndBlock();
-    } else {
-      client->TpmCanAttemptOwnership(EmptyVoidDBusMethodCallback());
-    }
-  }
-  btl->AddLoginTimeMarker("TPMOwn-End", false);
+  make_scoped_refptr(new TpmOwnershipTaker())->Start();
 
   if (UserManager::Get()->IsLoggedInAsRegularUser()) {
     SAMLOfflineSigninLimiter* saml_offline_signin_limiter =
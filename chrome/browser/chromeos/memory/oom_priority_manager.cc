@@ -14,6 +14,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/command_line.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/process/process.h"
@@ -28,6 +29,7 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/browser_process_platform_part_chromeos.h"
 #include "chrome/browser/memory_details.h"
+#include "chrome/browser/memory_purger.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_iterator.h"
 #include "chrome/browser/ui/browser_list.h"
@@ -80,6 +82,12 @@ const int kSuspendThresholdSeconds = kAdjustmentIntervalSeconds * 4;
 // a little while before doing the adjustment.
 const int kFocusedTabScoreAdjustIntervalMs = 500;
 
+// The low memory signal repeats (every 750 ms) for as long as memory is low.
+// The first signal purges the background renderers; signals within this
+// interval of the purge mean it didn't free enough memory, and discard tabs.
+// Later signals are treated as a new low memory event, and purge again.
+const int kPurgeEffectiveIntervalSeconds = 60;
+
 // Returns a unique ID for a WebContents.  Do not cast back to a pointer, as
 // the WebContents could be deleted if the user closed the tab.
 int64 IdFromWebContents(WebContents* web_contents) {
@@ -409,6 +417,36 @@ void OomPriorityManager::PurgeBrowserMemory() {
   // TODO(jamescook): Are there other things we could flush? Drive metadata?
 }
 
+void OomPriorityManager::PurgeBackgroundRenderers() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  last_purge_time_ = TimeTicks::Now();
+  PurgeBrowserMemory();
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+
+  // Leave the renderers of the selected tabs alone, purging them would make
+  // the tab the user is looking at jank.
+  std::set<base::ProcessHandle> selected_renderers;
+  TabStatsList stats = GetTabStatsOnUIThread();
+  for (TabStatsList::const_iterator it = stats.begin(); it != stats.end();
+       ++it) {
+    if (it->is_selected)
+      selected_renderers.insert(it->renderer_handle);
+  }
+  int purged_count = 0;
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    content::RenderProcessHost* host = it.GetCurrentValue();
+    if (!host->HasConnection() ||
+        selected_renderers.count(host->GetHandle()))
+      continue;
+    MemoryPurger::PurgeRendererForHost(host);
+    ++purged_count;
+  }
+  UMA_HISTOGRAM_COUNTS_100("Tabs.Purge.RendererCount", purged_count);
+}
+
 int OomPriorityManager::GetTabCount() const {
   int tab_count = 0;
   for (chrome::BrowserIterator it; !it.done(); it.Next())
@@ -652,6 +690,17 @@ void OomPriorityManager::AdjustOomPrioritiesOnFileThread(
 
 void OomPriorityManager::OnMemoryLow() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  TimeDelta time_since_purge = TimeTicks::Now() - last_purge_time_;
+  if (last_purge_time_.is_null() ||
+      time_since_purge >
+          TimeDelta::FromSeconds(kPurgeEffectiveIntervalSeconds)) {
+    PurgeBackgroundRenderers();
+    return;
+  }
+  // The purge didn't free enough memory. Comparing the number of purges
+  // (Tabs.Purge.RendererCount) to that of discards shows how many discards
+  // purging avoided.
+  UMA_HISTOGRAM_MEDIUM_TIMES("Tabs.Discard.TimeSincePurge", time_since_purge);
   LogMemoryAndDiscardTab();
 }
 
@@ -104,6 +104,12 @@ class OomPriorityManager : public content::NotificationObserver,
   // Purges data structures in the browser that can be easily recomputed.
   void PurgeBrowserMemory();
 
+  // Asks the renderers which only host background tabs to free their caches
+  // and collect garbage, and the browser's own memory pressure listeners to
+  // free what they can. This is the first response to low memory; tabs are
+  // only discarded if memory is still low after it.
+  void PurgeBackgroundRenderers();
+
   // Returns the number of tabs open in all browser instances.
   int GetTabCount() const;
 
@@ -157,6 +163,9 @@ class OomPriorityManager : public content::NotificationObserver,
   // times for discontinuities caused by suspend/resume.
   base::TimeTicks last_adjust_time_;
 
+  // Time of the last PurgeBackgroundRenderers(), or 0 if there was none.
+  base::TimeTicks last_purge_time_;
+
   // Number of times we have discarded a tab, for statistics.
   int discard_count_;
 
@@ -21,6 +21,7 @@
 #include "chrome/common/extensions/extension_l10n_util.h"
 #include "chrome/common/extensions/manifest_url_handler.h"
 #include "chrome/common/pref_names.h"
+#include "components/startup_metric_utils/startup_metric_utils.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/user_metrics.h"
 #include "extensions/browser/extension_prefs.h"
@@ -186,12 +187,16 @@ void InstalledLoader::LoadAllExtensions() {
   CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
   base::TimeTicks start_time = base::TimeTicks::Now();
+  startup_metric_utils::ScopedSlowStartupUMA
+      scoped_timer("Startup.SlowStartupExtensionsLoadAll");
 
   scoped_ptr<ExtensionPrefs::ExtensionsInfo> extensions_info(
       extension_prefs_->GetInstalledExtensionsInfo());
 
   std::vector<int> reload_reason_counts(NUM_MANIFEST_RELOAD_REASONS, 0);
-  bool should_write_prefs = false;
+  // The manifests in the prefs only need to be written back for the
+  // extensions whose manifest was reloaded from disk.
+  std::vector<bool> manifest_reloaded(extensions_info->size(), false);
 
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     ExtensionInfo* info = extensions_info->at(i).get();
@@ -232,14 +237,14 @@ void InstalledLoader::LoadAllExtensions() {
       extensions_info->at(i)->extension_manifest.reset(
           static_cast<base::DictionaryValue*>(
               extension->manifest()->value()->DeepCopy()));
-      should_write_prefs = true;
+      manifest_reloaded[i] = true;
     }
   }
 
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     if (extensions_info->at(i)->extension_location == Manifest::COMMAND_LINE)
       continue;
-    Load(*extensions_info->at(i), should_write_prefs);
+    Load(*extensions_info->at(i), manifest_reloaded[i]);
   }
 
   extension_service_->OnLoadedInstalledExtensions();
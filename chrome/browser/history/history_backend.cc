@@ -83,6 +83,10 @@ const int kSegmentDataRetention = 90;
 // How long we'll wait to do a commit, so that things are batched together.
 const int kCommitIntervalSeconds = 10;
 
+// How long after a commit we checkpoint the history database, so that it
+// usually happens while nothing is being written.
+const int kCheckpointDelaySeconds = 30;
+
 // The amount of time before we re-fetch the favicon.
 const int kFaviconRefetchDays = 7;
 
@@ -152,6 +156,11 @@ class CommitLaterTask : public base::RefCounted<CommitLaterTask> {
       history_backend_->Commit();
   }
 
+  void RunCheckpoint() {
+    if (history_backend_.get())
+      history_backend_->CheckpointDatabase();
+  }
+
  private:
   friend class base::RefCounted<CommitLaterTask>;
 
@@ -179,6 +188,7 @@ HistoryBackend::HistoryBackend(const base::FilePath& history_dir,
 
 HistoryBackend::~HistoryBackend() {
   DCHECK(!scheduled_commit_.get()) << "Deleting without cleanup";
+  DCHECK(!scheduled_checkpoint_.get()) << "Deleting without cleanup";
   ReleaseDBTasks();
 
 #if defined(OS_ANDROID)
@@ -224,6 +234,7 @@ void HistoryBackend::Closing() {
   // Any scheduled commit will have a reference to us, we must make it
   // release that reference before we can be destroyed.
   CancelScheduledCommit();
+  CancelScheduledCheckpoint();
 
   // Release our reference to the delegate, this reference will be keeping the
   // history service alive.
@@ -278,8 +289,8 @@ SegmentID HistoryBackend::GetLastSegmentID(VisitID from_visit) {
 
 SegmentID HistoryBackend::UpdateSegments(
     const GURL& url,
+    URLID url_id,
     VisitID from_visit,
-    VisitID visit_id,
     content::PageTransition transition_type,
     const Time ts) {
   if (!db_)
@@ -311,10 +322,6 @@ SegmentID HistoryBackend::UpdateSegments(
       (transition_type & content::PAGE_TRANSITION_FORWARD_BACK) == 0) {
     // If so, create or get the segment.
     std::string segment_name = db_->ComputeSegmentName(url);
-    URLID url_id = db_->GetRowForURL(url, NULL);
-    if (!url_id)
-      return 0;
-
     if (!(segment_id = db_->GetSegmentNamed(segment_name))) {
       if (!(segment_id = db_->CreateSegment(url_id, segment_name))) {
         NOTREACHED();
@@ -335,12 +342,6 @@ SegmentID HistoryBackend::UpdateSegments(
       return 0;
   }
 
-  // Set the segment in the visit.
-  if (!db_->SetSegmentID(visit_id, segment_id)) {
-    NOTREACHED();
-    return 0;
-  }
-
   // Finally, increase the counter for that segment / day.
   if (!db_->IncreaseSegmentVisitCount(segment_id, ts, 1)) {
     NOTREACHED();
@@ -362,20 +363,20 @@ void HistoryBackend::UpdateVisitDuration(VisitID visit_id, const Time end_ts) {
   if (!db_)
     return;
 
-  // Get the starting visit_time for visit_id.
-  VisitRow visit_row;
-  if (db_->GetRowForVisit(visit_id, &visit_row)) {
-    // We should never have a negative duration time even when time is skewed.
-    visit_row.visit_duration = end_ts > visit_row.visit_time ?
-        end_ts - visit_row.visit_time : TimeDelta::FromMicroseconds(0);
-    db_->UpdateVisitRow(visit_row);
-  }
+  // We should never have a negative duration time even when time is skewed,
+  // which the database clamps for us.
+  if (visit_id)
+    db_->UpdateVisitDuration(visit_id, end_ts);
 }
 
 void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   if (!db_)
     return;
 
+  // The time this task keeps the history thread busy for a page load, during
+  // which the other history requests wait.
+  base::TimeTicks start_time = base::TimeTicks::Now();
+
   // Will be filled with the URL ID and the visit ID of the last addition.
   std::pair<URLID, VisitID> last_ids(0, tracker_.GetLastVisit(
       request.id_scope, request.page_id, request.referrer));
@@ -433,20 +434,17 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
         content::PAGE_TRANSITION_CHAIN_START |
         content::PAGE_TRANSITION_CHAIN_END);
 
-    // No redirect case (one element means just the page itself).
-    last_ids = AddPageVisit(request.url, request.time,
-                            last_ids.second, t, request.visit_source);
-
-    // Update the segment for this visit. KEYWORD_GENERATED visits should not
+    // No redirect case (one element means just the page itself). Also
+    // update the segment for this visit. KEYWORD_GENERATED visits should not
     // result in changing most visited, so we don't update segments (most
     // visited db).
-    if (!is_keyword_generated) {
-      UpdateSegments(request.url, from_visit_id, last_ids.second, t,
-                     request.time);
+    last_ids = AddPageVisitImpl(request.url, request.time,
+                                last_ids.second, t, request.visit_source,
+                                !is_keyword_generated);
 
-      // Update the referrer's duration.
+    // Update the referrer's duration.
+    if (!is_keyword_generated)
       UpdateVisitDuration(from_visit_id, request.time);
-    }
   } else {
     // Redirect case. Add the redirect chain.
 
@@ -508,15 +506,13 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
 
       // Record all redirect visits with the same timestamp. We don't display
       // them anyway, and if we ever decide to, we can reconstruct their order
-      // from the redirect chain.
-      last_ids = AddPageVisit(redirects[redirect_index],
-                              request.time, last_ids.second,
-                              t, request.visit_source);
-      if (t & content::PAGE_TRANSITION_CHAIN_START) {
-        // Update the segment for this visit.
-        UpdateSegments(redirects[redirect_index],
-                       from_visit_id, last_ids.second, t, request.time);
-
+      // from the redirect chain. The visit starting the chain also updates
+      // its segment; it comes from |from_visit_id|.
+      bool chain_start = (t & content::PAGE_TRANSITION_CHAIN_START) != 0;
+      last_ids = AddPageVisitImpl(redirects[redirect_index],
+                                  request.time, last_ids.second,
+                                  t, request.visit_source, chain_start);
+      if (chain_start) {
         // Update the visit_details for this visit.
         UpdateVisitDuration(from_visit_id, request.time);
       }
@@ -546,6 +542,9 @@ void HistoryBackend::AddPage(const HistoryAddPageArgs& request) {
   }
 
   ScheduleCommit();
+
+  UMA_HISTOGRAM_TIMES("History.AddPageTime",
+                      base::TimeTicks::Now() - start_time);
 }
 
 void HistoryBackend::InitImpl(const std::string& languages) {
@@ -712,6 +711,17 @@ std::pair<URLID, VisitID> HistoryBackend::AddPageVisit(
     VisitID referring_visit,
     content::PageTransition transition,
     VisitSource visit_source) {
+  return AddPageVisitImpl(url, time, referring_visit, transition, visit_source,
+                          false);
+}
+
+std::pair<URLID, VisitID> HistoryBackend::AddPageVisitImpl(
+    const GURL& url,
+    Time time,
+    VisitID referring_visit,
+    content::PageTransition transition,
+    VisitSource visit_source,
+    bool update_segments) {
   // Top-level frame navigations are visible, everything else is hidden
   bool new_hidden = !content::PageTransitionIsMainFrame(transition);
 
@@ -769,8 +779,12 @@ std::pair<URLID, VisitID> HistoryBackend::AddPageVisit(
     url_info.id_ = url_id;
   }
 
+  SegmentID segment_id = 0;
+  if (update_segments)
+    segment_id = UpdateSegments(url, url_id, referring_visit, transition, time);
+
   // Add the visit with the time to the database.
-  VisitRow visit_info(url_id, time, referring_visit, transition, 0);
+  VisitRow visit_info(url_id, time, referring_visit, transition, segment_id);
   VisitID visit_id = db_->AddVisit(&visit_info, visit_source);
   NotifyVisitObservers(visit_info);
 
@@ -2453,6 +2467,7 @@ void HistoryBackend::Commit() {
   db_->CommitTransaction();
   DCHECK(db_->transaction_nesting() == 0) << "Somebody left a transaction open";
   db_->BeginTransaction();
+  ScheduleCheckpoint();
 
   if (thumbnail_db_) {
     thumbnail_db_->CommitTransaction();
@@ -2484,6 +2499,36 @@ void HistoryBackend::CancelScheduledCommit() {
   }
 }
 
+void HistoryBackend::ScheduleCheckpoint() {
+  if (scheduled_checkpoint_.get())
+    return;
+  scheduled_checkpoint_ = new CommitLaterTask(this);
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&CommitLaterTask::RunCheckpoint, scheduled_checkpoint_.get()),
+      base::TimeDelta::FromSeconds(kCheckpointDelaySeconds));
+}
+
+void HistoryBackend::CancelScheduledCheckpoint() {
+  if (scheduled_checkpoint_.get()) {
+    scheduled_checkpoint_->Cancel();
+    scheduled_checkpoint_ = NULL;
+  }
+}
+
+void HistoryBackend::CheckpointDatabase() {
+  CancelScheduledCheckpoint();
+  if (!db_)
+    return;
+
+  // A checkpoint can't run while the connection reads or writes in a
+  // transaction, and the long-running one usually does.
+  db_->CommitTransaction();
+  DCHECK(db_->transaction_nesting() == 0) << "Somebody left a transaction open";
+  db_->CheckpointWAL();
+  db_->BeginTransaction();
+}
+
 void HistoryBackend::ProcessDBTaskImpl() {
   if (!db_) {
     // db went away, release all the refs.
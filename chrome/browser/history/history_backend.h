@@ -592,6 +592,17 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
                                          content::PageTransition transition,
                                          VisitSource visit_source);
 
+  // Like AddPageVisit, but also updates the segment of the visit when
+  // |update_segments| is true. The segment is computed before the visit is
+  // added so that it is written along with the visit, without a second
+  // update of the new row.
+  std::pair<URLID, VisitID> AddPageVisitImpl(const GURL& url,
+                                             base::Time time,
+                                             VisitID referring_visit,
+                                             content::PageTransition transition,
+                                             VisitSource visit_source,
+                                             bool update_segments);
+
   // Returns a redirect chain in |redirects| for the VisitID
   // |cur_visit|. |cur_visit| is assumed to be valid. Assumes that
   // this HistoryBackend object has been Init()ed successfully.
@@ -640,17 +651,31 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // does nothing.
   void CancelScheduledCommit();
 
+  // Schedules a checkpoint of the history database's write-ahead log. If
+  // there is already a checkpoint scheduled, this will do nothing.
+  void ScheduleCheckpoint();
+
+  // Cancels the scheduled checkpoint, if any.
+  void CancelScheduledCheckpoint();
+
+  // Copies the write-ahead log into the history database. This ends the
+  // long-running transaction for the duration of the checkpoint.
+  void CheckpointDatabase();
+
   // Segments ------------------------------------------------------------------
 
   // Walks back a segment chain to find the last visit with a non null segment
   // id and returns it. If there is none found, returns 0.
   SegmentID GetLastSegmentID(VisitID from_visit);
 
-  // Update the segment information. This is called internally when a page is
-  // added. Return the segment id of the segment that has been updated.
+  // Update the segment information for a visit to |url|, which has the ID
+  // |url_id|. This is called internally when a page is added, before its visit
+  // is added. Return the segment id of the segment that has been updated,
+  // which the caller stores in the visit, or 0 if the visit doesn't count
+  // toward any segment.
   SegmentID UpdateSegments(const GURL& url,
+                           URLID url_id,
                            VisitID from_visit,
-                           VisitID visit_id,
                            content::PageTransition transition_type,
                            const base::Time ts);
 
@@ -845,6 +870,9 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // scheduled commit at a time (see ScheduleCommit).
   scoped_refptr<CommitLaterTask> scheduled_commit_;
 
+  // Same as |scheduled_commit_|, for the checkpoint of the history database.
+  scoped_refptr<CommitLaterTask> scheduled_checkpoint_;
+
   // Maps recent redirect destination pages to the chain of redirects that
   // brought us to there. Pages that did not have redirects or were not the
   // final redirect in a chain will not be in this list, as well as pages that
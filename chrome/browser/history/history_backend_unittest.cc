@@ -713,6 +713,38 @@ TEST_F(HistoryBackendTest, URLsNoLongerBookmarked) {
                                                          NULL));
 }
 
+// Tests that the segment of a typed redirect chain is written with the visit
+// starting the chain.
+TEST_F(HistoryBackendTest, AddPageSetsVisitSegment) {
+  ASSERT_TRUE(backend_.get());
+
+  GURL url1("http://google.net");
+  GURL url2("http://google.com");
+  history::RedirectList redirects;
+  redirects.push_back(url1);
+  redirects.push_back(url2);
+  HistoryAddPageArgs request(url2, Time::Now(), NULL, 0, GURL(), redirects,
+                             content::PAGE_TRANSITION_TYPED,
+                             history::SOURCE_BROWSED, false);
+  backend_->AddPage(request);
+
+  SegmentID segment_id = backend_->db()->GetSegmentNamed(
+      VisitSegmentDatabase::ComputeSegmentName(url1));
+  ASSERT_NE(0, segment_id);
+
+  URLID url_id1 = backend_->db()->GetRowForURL(url1, NULL);
+  VisitVector visits;
+  ASSERT_TRUE(backend_->db()->GetVisitsForURL(url_id1, &visits));
+  ASSERT_EQ(1U, visits.size());
+  EXPECT_EQ(segment_id, visits[0].segment_id);
+
+  // The redirect is part of the segment through the visit it comes from.
+  URLID url_id2 = backend_->db()->GetRowForURL(url2, NULL);
+  ASSERT_TRUE(backend_->db()->GetVisitsForURL(url_id2, &visits));
+  ASSERT_EQ(1U, visits.size());
+  EXPECT_EQ(0, visits[0].segment_id);
+}
+
 // Tests a handful of assertions for a navigation with a type of
 // KEYWORD_GENERATED.
 TEST_F(HistoryBackendTest, KeywordGenerated) {
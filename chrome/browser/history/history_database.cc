@@ -58,6 +58,14 @@ sql::InitStatus HistoryDatabase::Init(const base::FilePath& history_name) {
   // TODO(brettw) scale this value to the amount of available memory.
   db_.set_cache_size(1000);
 
+  // Map the start of the file, which holds most of the hot URL and visit
+  // pages, so that reads don't have to be copied into the page cache.
+  db_.set_mmap_size(32 * 1024 * 1024);
+
+  // Commit to a write-ahead log, so that commits don't wait for the disk.
+  // HistoryBackend checkpoints the log once it has been idle for a while.
+  db_.set_wal_mode();
+
   // Note that we don't set exclusive locking here. That's done by
   // BeginExclusiveMode below which is called later (we have to be in shared
   // mode to start out for the in-memory backend to read the data).
@@ -204,6 +212,10 @@ void HistoryDatabase::RollbackTransaction() {
   db_.RollbackTransaction();
 }
 
+void HistoryDatabase::CheckpointWAL() {
+  ignore_result(db_.CheckpointWAL());
+}
+
 bool HistoryDatabase::RecreateAllTablesButURL() {
   if (!DropVisitTable())
     return false;
@@ -108,6 +108,10 @@ class HistoryDatabase : public DownloadDatabase,
   }
   void RollbackTransaction();
 
+  // Copies the write-ahead log into the database file. This must be called
+  // outside of any transaction to have an effect.
+  void CheckpointWAL();
+
   // Drops all tables except the URL, and download tables, and recreates them
   // from scratch. This is done to rapidly clean up stuff when deleting all
   // history. It is faster and less likely to have problems that deleting all
@@ -15,6 +15,7 @@
 #include "chrome/browser/history/history_service.h"
 #include "chrome/browser/history/history_service_factory.h"
 #include "chrome/browser/history/url_database.h"
+#include "chrome/browser/history/url_index_posting_lists.h"
 #include "chrome/browser/history/url_index_private_data.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/url_constants.h"
@@ -32,6 +33,8 @@ namespace history {
 void DeleteCacheFile(const base::FilePath& path) {
   DCHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
   base::DeleteFile(path, false);
+  for (int i = 0; i < URLIndexPostingLists::kFileCount; ++i)
+    base::DeleteFile(URLIndexPostingLists::GetFilePath(path, i), false);
 }
 
 // Initializes a whitelist of URL schemes.
@@ -0,0 +1,119 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <set>
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "chrome/browser/history/history_database.h"
+#include "chrome/browser/history/url_index_private_data.h"
+#include "sql/init_status.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace history {
+
+namespace {
+
+const int kURLCount = 100000;
+
+const char* const kWords[] = {
+  "news", "google", "weather", "mail", "maps", "video", "sports", "music",
+  "photos", "shopping", "travel", "finance", "recipes", "movies", "books",
+  "games", "health", "science", "jobs", "cars",
+};
+
+}  // namespace
+
+// Measures the time the omnibox takes to score the history quick provider's
+// candidates as a query is typed, over a synthetic history.
+class InMemoryURLIndexPerfTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_EQ(sql::INIT_OK,
+              history_db_.Init(temp_dir_.path().AppendASCII("History")));
+    PopulateHistory();
+    std::set<std::string> scheme_whitelist;
+    scheme_whitelist.insert("http");
+    scheme_whitelist.insert("https");
+    base::TimeTicks start = base::TimeTicks::Now();
+    private_data_ = URLIndexPrivateData::RebuildFromHistory(
+        &history_db_, "en", scheme_whitelist);
+    ASSERT_TRUE(private_data_.get());
+    perf_test::PrintResult("rebuild_time", "", "history_100k",
+                           (base::TimeTicks::Now() - start).InMillisecondsF(),
+                           "ms", true);
+  }
+
+ protected:
+  void PopulateHistory() {
+    const size_t kWordCount = arraysize(kWords);
+    base::Time now = base::Time::Now();
+    history_db_.BeginTransaction();
+    for (int i = 0; i < kURLCount; ++i) {
+      const char* first = kWords[i % kWordCount];
+      const char* second = kWords[(i / kWordCount) % kWordCount];
+      URLRow row(GURL(base::StringPrintf(
+          "http://www.%s%d.com/%s/page%d.html", first, i % 997, second, i)));
+      row.set_title(base::UTF8ToUTF16(base::StringPrintf(
+          "%s %s - Page %d", first, second, i)));
+      row.set_visit_count(1 + i % 10);
+      row.set_typed_count(i % 3);
+      row.set_last_visit(now - base::TimeDelta::FromHours(i % 2000));
+      URLID url_id = history_db_.AddURL(row);
+      ASSERT_TRUE(url_id);
+      VisitRow visit(url_id, row.last_visit(), 0,
+                     content::PAGE_TRANSITION_LINK, 0);
+      history_db_.AddVisit(&visit, SOURCE_BROWSED);
+    }
+    history_db_.CommitTransaction();
+  }
+
+  // Types |query| one character at a time and reports the mean and the
+  // worst latency of the keystrokes.
+  void RunKeystrokeBenchmark(const std::string& trace,
+                             const std::string& query) {
+    base::string16 query16 = base::UTF8ToUTF16(query);
+    base::TimeDelta total;
+    base::TimeDelta worst;
+    for (size_t length = 1; length <= query16.length(); ++length) {
+      base::TimeTicks start = base::TimeTicks::Now();
+      private_data_->HistoryItemsForTerms(query16.substr(0, length),
+                                          base::string16::npos, "en", NULL);
+      base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+      total += elapsed;
+      worst = std::max(worst, elapsed);
+    }
+    perf_test::PrintResult("keystroke_time", "_mean", trace,
+                           total.InMillisecondsF() / query16.length(), "ms",
+                           true);
+    perf_test::PrintResult("keystroke_time", "_max", trace,
+                           worst.InMillisecondsF(), "ms", true);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  HistoryDatabase history_db_;
+  scoped_refptr<URLIndexPrivateData> private_data_;
+};
+
+TEST_F(InMemoryURLIndexPerfTest, TypeCommonWord) {
+  // The first characters match most of the history.
+  RunKeystrokeBenchmark("common_word", "news");
+}
+
+TEST_F(InMemoryURLIndexPerfTest, TypeTwoTerms) {
+  RunKeystrokeBenchmark("two_terms", "google maps");
+}
+
+TEST_F(InMemoryURLIndexPerfTest, TypeHost) {
+  RunKeystrokeBenchmark("host", "www.weather42.com");
+}
+
+}  // namespace history
@@ -56,14 +56,16 @@ base::string16 CleanUpTitleForMatching(const base::string16& title) {
 TermMatches MatchTermInString(const base::string16& term,
                               const base::string16& cleaned_string,
                               int term_num) {
+  // Only matches within the first kMaxCompareLength characters count. Bound
+  // the search rather than copying that prefix for each candidate.
   const size_t kMaxCompareLength = 2048;
-  const base::string16& short_string =
-      (cleaned_string.length() > kMaxCompareLength) ?
-      cleaned_string.substr(0, kMaxCompareLength) : cleaned_string;
   TermMatches matches;
-  for (size_t location = short_string.find(term);
-       location != base::string16::npos;
-       location = short_string.find(term, location + 1))
+  if (term.length() > kMaxCompareLength)
+    return matches;
+  const size_t max_location = kMaxCompareLength - term.length();
+  for (size_t location = cleaned_string.find(term);
+       location != base::string16::npos && location <= max_location;
+       location = cleaned_string.find(term, location + 1))
     matches.push_back(TermMatch(term_num, location, term.length()));
   return matches;
 }
@@ -182,6 +184,8 @@ RowWordStarts::~RowWordStarts() {}
 void RowWordStarts::Clear() {
   url_word_starts_.clear();
   title_word_starts_.clear();
+  cleaned_url_.clear();
+  cleaned_title_.clear();
 }
 
 }  // namespace history
@@ -177,11 +177,18 @@ struct RowWordStarts {
   RowWordStarts();
   ~RowWordStarts();
 
-  // Clears both url_word_starts_ and title_word_starts_.
+  // Clears the word starts and the cleaned up URL and title.
   void Clear();
 
   WordStarts url_word_starts_;
   WordStarts title_word_starts_;
+
+  // The URL and page title as cleaned up by CleanUpUrlForMatching() and
+  // CleanUpTitleForMatching(), which the word starts are offsets into. They
+  // are kept so that scoring the row doesn't have to clean them up again on
+  // every keystroke, and aren't saved in the cache file.
+  base::string16 cleaned_url_;
+  base::string16 cleaned_title_;
 };
 typedef std::map<HistoryID, RowWordStarts> WordStartsMap;
 
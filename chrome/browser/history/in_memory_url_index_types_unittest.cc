@@ -121,6 +121,14 @@ TEST_F(InMemoryURLIndexTypesTest, StaticFunctions) {
   ASSERT_EQ(arraysize(expected_offsets), matches_g.size());
   for (size_t i = 0; i < arraysize(expected_offsets); ++i)
     EXPECT_EQ(expected_offsets[i], matches_g[i].offset);
+
+  // Only the start of very long strings is searched.
+  base::string16 long_string(2045, 'a');
+  long_string += UTF8ToUTF16("xyzxyz");
+  TermMatches matches_h =
+      MatchTermInString(UTF8ToUTF16("xyz"), long_string, 0);
+  ASSERT_EQ(1u, matches_h.size());
+  EXPECT_EQ(2045u, matches_h[0].offset);
 }
 
 TEST_F(InMemoryURLIndexTypesTest, OffsetsAndTermMatches) {
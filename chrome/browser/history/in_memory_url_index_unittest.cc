@@ -337,16 +337,39 @@ void ExpectMapOfContainersIdentical(const T& expected, const T& actual) {
   }
 }
 
+// Builds the HistoryID to WordIDs mapping matching |word_id_history_map|.
+void InvertWordIDHistoryMap(const WordIDHistoryMap& word_id_history_map,
+                            HistoryIDWordMap* history_id_word_map) {
+  for (WordIDHistoryMap::const_iterator iter = word_id_history_map.begin();
+       iter != word_id_history_map.end(); ++iter) {
+    for (HistoryIDSet::const_iterator id_iter = iter->second.begin();
+         id_iter != iter->second.end(); ++id_iter)
+      (*history_id_word_map)[*id_iter].insert(iter->first);
+  }
+}
+
 void InMemoryURLIndexTest::ExpectPrivateDataEqual(
     const URLIndexPrivateData& expected,
     const URLIndexPrivateData& actual) {
   EXPECT_EQ(expected.word_list_.size(), actual.word_list_.size());
   EXPECT_EQ(expected.word_map_.size(), actual.word_map_.size());
   EXPECT_EQ(expected.char_word_map_.size(), actual.char_word_map_.size());
-  EXPECT_EQ(expected.word_id_history_map_.size(),
-            actual.word_id_history_map_.size());
-  EXPECT_EQ(expected.history_id_word_map_.size(),
-            actual.history_id_word_map_.size());
+  WordIDHistoryMap expected_word_id_history_map;
+  expected.GetWordIDHistoryMap(&expected_word_id_history_map);
+  WordIDHistoryMap actual_word_id_history_map;
+  actual.GetWordIDHistoryMap(&actual_word_id_history_map);
+  EXPECT_EQ(expected_word_id_history_map.size(),
+            actual_word_id_history_map.size());
+  // The restored data may hold its words in posting lists, so compare the
+  // merged mappings, the reverse one being derived from the forward one.
+  HistoryIDWordMap expected_history_id_word_map;
+  InvertWordIDHistoryMap(expected_word_id_history_map,
+                         &expected_history_id_word_map);
+  HistoryIDWordMap actual_history_id_word_map;
+  InvertWordIDHistoryMap(actual_word_id_history_map,
+                         &actual_history_id_word_map);
+  EXPECT_EQ(expected_history_id_word_map.size(),
+            actual_history_id_word_map.size());
   EXPECT_EQ(expected.history_info_map_.size(), actual.history_info_map_.size());
   EXPECT_EQ(expected.word_starts_map_.size(), actual.word_starts_map_.size());
   // WordList must be index-by-index equal.
@@ -356,10 +379,10 @@ void InMemoryURLIndexTest::ExpectPrivateDataEqual(
 
   ExpectMapOfContainersIdentical(expected.char_word_map_,
                                  actual.char_word_map_);
-  ExpectMapOfContainersIdentical(expected.word_id_history_map_,
-                                 actual.word_id_history_map_);
-  ExpectMapOfContainersIdentical(expected.history_id_word_map_,
-                                 actual.history_id_word_map_);
+  ExpectMapOfContainersIdentical(expected_word_id_history_map,
+                                 actual_word_id_history_map);
+  ExpectMapOfContainersIdentical(expected_history_id_word_map,
+                                 actual_history_id_word_map);
 
   for (HistoryInfoMap::const_iterator expected_info =
       expected.history_info_map_.begin();
@@ -1058,6 +1081,9 @@ TEST_F(InMemoryURLIndexTest, CacheSaveRestore) {
   // a cache version.)  Also, the rebuild time should not have changed.
   EXPECT_GT(new_data.restored_cache_version_, 0);
   EXPECT_EQ(rebuild_time, new_data.last_time_rebuilt_from_history_);
+  // The word/history item mappings should have been mapped from a file.
+  EXPECT_TRUE(new_data.posting_lists_.get());
+  EXPECT_TRUE(new_data.word_id_history_map_.empty());
 
   // Compare the captured and restored for equality.
   ExpectPrivateDataEqual(*old_data.get(), new_data);
@@ -64,9 +64,18 @@ ScoredHistoryMatch::ScoredHistoryMatch(const URLRow& row,
     return;
 
   // Figure out where each search term appears in the URL and/or page title
-  // so that we can score as well as provide autocomplete highlighting.
-  base::string16 url = CleanUpUrlForMatching(gurl, languages);
-  base::string16 title = CleanUpTitleForMatching(row.title());
+  // so that we can score as well as provide autocomplete highlighting. The
+  // index keeps the cleaned up URL and title of its rows, so only clean them
+  // up here if |word_starts| doesn't hold them.
+  const bool cleaned_up = !word_starts.cleaned_url_.empty();
+  const base::string16 cleaned_url = cleaned_up ?
+      base::string16() : CleanUpUrlForMatching(gurl, languages);
+  const base::string16 cleaned_title = cleaned_up ?
+      base::string16() : CleanUpTitleForMatching(row.title());
+  const base::string16& url =
+      cleaned_up ? word_starts.cleaned_url_ : cleaned_url;
+  const base::string16& title =
+      cleaned_up ? word_starts.cleaned_title_ : cleaned_title;
   int term_num = 0;
   for (String16Vector::const_iterator iter = terms.begin(); iter != terms.end();
        ++iter, ++term_num) {
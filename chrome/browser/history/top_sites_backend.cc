@@ -16,6 +16,12 @@ using content::BrowserThread;
 
 namespace history {
 
+TopSitesBackend::ThumbnailUpdate::ThumbnailUpdate() : url_rank(0) {
+}
+
+TopSitesBackend::ThumbnailUpdate::~ThumbnailUpdate() {
+}
+
 TopSitesBackend::TopSitesBackend()
     : db_(new TopSitesDatabase()) {
 }
@@ -62,6 +68,13 @@ void TopSitesBackend::SetPageThumbnail(const MostVisitedURL& url,
                  url_rank, thumbnail));
 }
 
+void TopSitesBackend::SetPageThumbnails(const ThumbnailUpdates& updates) {
+  BrowserThread::PostTask(
+      BrowserThread::DB, FROM_HERE,
+      base::Bind(&TopSitesBackend::SetPageThumbnailsOnDBThread, this,
+                 updates));
+}
+
 void TopSitesBackend::ResetDatabase() {
   BrowserThread::PostTask(
       BrowserThread::DB, FROM_HERE,
@@ -128,6 +141,19 @@ void TopSitesBackend::SetPageThumbnailOnDBThread(const MostVisitedURL& url,
   db_->SetPageThumbnail(url, url_rank, thumbnail);
 }
 
+void TopSitesBackend::SetPageThumbnailsOnDBThread(
+    const ThumbnailUpdates& updates) {
+  if (!db_)
+    return;
+
+  db_->BeginTransaction();
+  for (size_t i = 0; i < updates.size(); ++i) {
+    db_->SetPageThumbnail(updates[i].url, updates[i].url_rank,
+                          updates[i].thumbnail);
+  }
+  db_->CommitTransaction();
+}
+
 void TopSitesBackend::ResetDatabaseOnDBThread(const base::FilePath& file_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
   db_.reset(NULL);
@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_HISTORY_TOP_SITES_BACKEND_H_
 #define CHROME_BROWSER_HISTORY_TOP_SITES_BACKEND_H_
 
+#include <vector>
+
 #include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
@@ -30,6 +32,17 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
   typedef base::Callback<void(const scoped_refptr<MostVisitedThumbnails>&)>
       GetMostVisitedThumbnailsCallback;
 
+  // A thumbnail update for SetPageThumbnails().
+  struct ThumbnailUpdate {
+    ThumbnailUpdate();
+    ~ThumbnailUpdate();
+
+    MostVisitedURL url;
+    int url_rank;
+    Images thumbnail;
+  };
+  typedef std::vector<ThumbnailUpdate> ThumbnailUpdates;
+
   TopSitesBackend();
 
   void Init(const base::FilePath& path);
@@ -50,6 +63,9 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
                         int url_rank,
                         const Images& thumbnail);
 
+  // Sets several thumbnails in one transaction.
+  void SetPageThumbnails(const ThumbnailUpdates& updates);
+
   // Deletes the database and recreates it.
   void ResetDatabase();
 
@@ -82,6 +98,9 @@ class TopSitesBackend : public base::RefCountedThreadSafe<TopSitesBackend> {
                                   int url_rank,
                                   const Images& thumbnail);
 
+  // Sets the thumbnails.
+  void SetPageThumbnailsOnDBThread(const ThumbnailUpdates& updates);
+
   // Resets the database.
   void ResetDatabaseOnDBThread(const base::FilePath& file_path);
 
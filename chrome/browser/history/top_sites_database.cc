@@ -715,6 +715,14 @@ bool TopSitesDatabase::RemoveURL(const MostVisitedURL& url) {
   return transaction.Commit();
 }
 
+void TopSitesDatabase::BeginTransaction() {
+  db_->BeginTransaction();
+}
+
+void TopSitesDatabase::CommitTransaction() {
+  db_->CommitTransaction();
+}
+
 sql::Connection* TopSitesDatabase::CreateDB(const base::FilePath& db_name) {
   scoped_ptr<sql::Connection> db(new sql::Connection());
   // Settings copied from ThumbnailDatabase.
@@ -57,6 +57,10 @@ class TopSitesDatabase {
   // Remove the record for this URL. Returns true iff removed successfully.
   bool RemoveURL(const MostVisitedURL& url);
 
+  // Transactions on the database, to make several changes in one write.
+  void BeginTransaction();
+  void CommitTransaction();
+
  private:
   FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, Version1);
   FRIEND_TEST_ALL_PREFIXES(TopSitesDatabaseTest, Version2);
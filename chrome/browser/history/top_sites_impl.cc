@@ -94,6 +94,12 @@ static const int64 kUpdateIntervalSecs = 15;
 static const int64 kMinUpdateIntervalMinutes = 1;
 static const int64 kMaxUpdateIntervalMinutes = 60;
 
+// Thumbnails set within this long of each other, as when the user switches
+// through tabs, are written to the db together once things calm down.
+static const int64 kThumbnailWriteDelaySecs = 3;
+// The longest a thumbnail write is held back.
+static const int64 kMaxThumbnailWriteDelaySecs = 30;
+
 // Use 100 quality (highest quality) because we're very sensitive to
 // artifacts for these small sized, highly detailed images.
 static const int kTopSitesImageQuality = 100;
@@ -382,6 +388,7 @@ void TopSitesImpl::Shutdown() {
   // invoked Shutdown (this could happen if we have a pending request and
   // Shutdown is invoked).
   history_consumer_.CancelAllRequests();
+  WritePendingThumbnails();
   backend_->Shutdown();
 }
 
@@ -527,11 +534,7 @@ bool TopSitesImpl::SetPageThumbnailEncoded(
     return false;
 
   size_t index = cache_->GetURLIndex(url);
-  int url_rank = index - cache_->GetNumForcedURLs();
-  const MostVisitedURL& most_visited = cache_->top_sites()[index];
-  backend_->SetPageThumbnail(most_visited,
-                             url_rank < 0 ? -1 : url_rank,
-                             *(cache_->GetImage(most_visited.url)));
+  ScheduleThumbnailWrite(cache_->top_sites()[index].url);
   return true;
 }
 
@@ -580,6 +583,55 @@ void TopSitesImpl::TimerFired() {
   StartQueryForMostVisited();
 }
 
+void TopSitesImpl::ScheduleThumbnailWrite(const GURL& url) {
+  if (pending_thumbnail_writes_.empty())
+    first_pending_thumbnail_write_time_ = base::TimeTicks::Now();
+  pending_thumbnail_writes_.insert(url);
+  PostponeThumbnailWrites();
+}
+
+void TopSitesImpl::PostponeThumbnailWrites() {
+  if (pending_thumbnail_writes_.empty())
+    return;
+
+  base::TimeDelta delay =
+      base::TimeDelta::FromSeconds(kThumbnailWriteDelaySecs);
+  base::TimeDelta max_delay =
+      base::TimeDelta::FromSeconds(kMaxThumbnailWriteDelaySecs) -
+      (base::TimeTicks::Now() - first_pending_thumbnail_write_time_);
+  if (max_delay < delay)
+    delay = std::max(max_delay, base::TimeDelta());
+  thumbnail_write_timer_.Start(FROM_HERE, delay, this,
+                               &TopSitesImpl::WritePendingThumbnails);
+}
+
+void TopSitesImpl::WritePendingThumbnails() {
+  thumbnail_write_timer_.Stop();
+  if (pending_thumbnail_writes_.empty())
+    return;
+
+  TopSitesBackend::ThumbnailUpdates updates;
+  for (std::set<GURL>::const_iterator it = pending_thumbnail_writes_.begin();
+       it != pending_thumbnail_writes_.end(); ++it) {
+    // The URL may have dropped out of the top sites since.
+    if (!cache_->IsKnownURL(*it))
+      continue;
+    size_t index = cache_->GetURLIndex(*it);
+    int url_rank = index - cache_->GetNumForcedURLs();
+    TopSitesBackend::ThumbnailUpdate update;
+    update.url = cache_->top_sites()[index];
+    update.url_rank = url_rank < 0 ? -1 : url_rank;
+    update.thumbnail = *(cache_->GetImage(update.url.url));
+    updates.push_back(update);
+  }
+  pending_thumbnail_writes_.clear();
+
+  UMA_HISTOGRAM_COUNTS_100("TopSites.ThumbnailWriteBatchSize",
+                           static_cast<int>(updates.size()));
+  if (!updates.empty())
+    backend_->SetPageThumbnails(updates);
+}
+
 // static
 int TopSitesImpl::GetRedirectDistanceForURL(const MostVisitedURL& most_visited,
                                             const GURL& url) {
@@ -772,6 +824,9 @@ void TopSitesImpl::Observe(int type,
         content::Source<NavigationController>(source).ptr();
     Profile* profile = Profile::FromBrowserContext(
         controller->GetWebContents()->GetBrowserContext());
+    // Keep the thumbnail writes out of the way of the navigation.
+    if (profile == profile_)
+      PostponeThumbnailWrites();
     if (profile == profile_ && !IsNonForcedFull()) {
       content::LoadCommittedDetails* load_details =
           content::Details<content::LoadCommittedDetails>(details).ptr();
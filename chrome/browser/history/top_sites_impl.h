@@ -148,6 +148,17 @@ class TopSitesImpl : public TopSites {
   // Called by our timer. Starts the query for the most visited sites.
   void TimerFired();
 
+  // Queues the thumbnail of |url| to be written to the db along with the
+  // others set soon after it.
+  void ScheduleThumbnailWrite(const GURL& url);
+
+  // Holds the queued thumbnail writes back while the user is busy, up to
+  // kMaxThumbnailWriteDelaySecs after the first of them.
+  void PostponeThumbnailWrites();
+
+  // Writes the queued thumbnails to the db in one transaction.
+  void WritePendingThumbnails();
+
   // Finds the given URL in the redirect chain for the given TopSite, and
   // returns the distance from the destination in hops that the given URL is.
   // The URL is assumed to be in the list. The destination is 0.
@@ -246,6 +257,14 @@ class TopSitesImpl : public TopSites {
   // The time we started |timer_| at. Only valid if |timer_| is running.
   base::TimeTicks timer_start_time_;
 
+  // The URLs whose thumbnails are yet to be written to the db, and the timer
+  // which writes them.
+  std::set<GURL> pending_thumbnail_writes_;
+  base::OneShotTimer<TopSitesImpl> thumbnail_write_timer_;
+
+  // When the first of |pending_thumbnail_writes_| was queued.
+  base::TimeTicks first_pending_thumbnail_write_time_;
+
   content::NotificationRegistrar registrar_;
 
   // The number of URLs changed on the last update.
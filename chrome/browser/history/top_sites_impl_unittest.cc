@@ -310,6 +310,10 @@ class TopSitesImplTest : public HistoryUnitTestBase {
 
   size_t last_num_urls_changed() { return top_sites()->last_num_urls_changed_; }
 
+  size_t pending_thumbnail_writes() {
+    return top_sites()->pending_thumbnail_writes_.size();
+  }
+
   base::TimeDelta GetUpdateDelay() {
     return top_sites()->GetUpdateDelay();
   }
@@ -581,6 +585,38 @@ TEST_F(TopSitesImplTest, ThumbnailRemoved) {
   EXPECT_FALSE(top_sites()->GetPageThumbnail(url, false, &result));
 }
 
+// Tests that thumbnails set together are written to the db together, and
+// before TopSites shuts down.
+TEST_F(TopSitesImplTest, BatchThumbnailWrites) {
+  GURL asdf_url("http://asdf.com");
+  GURL google_url("http://google.com");
+  AddPageToHistory(asdf_url, base::ASCIIToUTF16("ASDF"));
+  AddPageToHistory(google_url, base::ASCIIToUTF16("Google"));
+  StartQueryForMostVisited();
+  WaitForHistory();
+
+  gfx::Image red_bitmap(CreateBitmap(SK_ColorRED));
+  gfx::Image blue_bitmap(CreateBitmap(SK_ColorBLUE));
+  base::Time now = base::Time::Now();
+  ASSERT_TRUE(top_sites()->SetPageThumbnail(
+      asdf_url, red_bitmap, ThumbnailScore(0.5, true, true, now)));
+  ASSERT_TRUE(top_sites()->SetPageThumbnail(
+      google_url, red_bitmap, ThumbnailScore(0.5, true, true, now)));
+  // A better thumbnail replaces the pending one.
+  ASSERT_TRUE(top_sites()->SetPageThumbnail(
+      asdf_url, blue_bitmap, ThumbnailScore(0.0, true, true, now)));
+  EXPECT_EQ(2u, pending_thumbnail_writes());
+
+  RecreateTopSitesAndBlock();
+  EXPECT_EQ(0u, pending_thumbnail_writes());
+
+  scoped_refptr<base::RefCountedMemory> read_data;
+  EXPECT_TRUE(top_sites()->GetPageThumbnail(asdf_url, false, &read_data));
+  EXPECT_TRUE(ThumbnailEqualsBytes(blue_bitmap, read_data.get()));
+  EXPECT_TRUE(top_sites()->GetPageThumbnail(google_url, false, &read_data));
+  EXPECT_TRUE(ThumbnailEqualsBytes(red_bitmap, read_data.get()));
+}
+
 // Tests GetPageThumbnail.
 TEST_F(TopSitesImplTest, GetPageThumbnail) {
   MostVisitedURLList url_list;
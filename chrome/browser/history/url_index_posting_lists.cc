@@ -0,0 +1,302 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/url_index_posting_lists.h"
+
+#include <string.h>
+
+#include <map>
+
+#include "base/logging.h"
+
+namespace history {
+
+namespace {
+
+const uint32 kMagic = 0x4c504955;  // "UIPL"
+const uint32 kVersion = 1;
+
+const base::FilePath::CharType* const kFileExtensions[] = {
+  FILE_PATH_LITERAL("postings0"),
+  FILE_PATH_LITERAL("postings1"),
+};
+COMPILE_ASSERT(arraysize(kFileExtensions) == URLIndexPostingLists::kFileCount,
+               file_extensions_dont_match_file_count);
+
+// Layout of the buffer, in host byte order:
+//   Header
+//   TableEntry[word_count]     by WordID
+//   TableEntry[history_count]  by HistoryID
+//   The lists, each being the varint-coded differences between consecutive
+//   IDs, starting from 0.
+struct Header {
+  uint32 magic;
+  uint32 version;
+  int64 stamp;
+  uint32 word_count;
+  uint32 history_count;
+  uint32 lists_size;
+  uint32 reserved;
+};
+
+template <typename T>
+void AppendPod(const T& value, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendVarint(uint64 value, std::string* data) {
+  while (value >= 0x80) {
+    data->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data->push_back(static_cast<char>(value));
+}
+
+// Appends the sorted |ids| to |lists| as deltas.
+void AppendList(const std::vector<int64>& ids, std::string* lists) {
+  int64 previous = 0;
+  for (std::vector<int64>::const_iterator iter = ids.begin();
+       iter != ids.end(); ++iter) {
+    DCHECK_GE(*iter, previous);
+    AppendVarint(static_cast<uint64>(*iter - previous), lists);
+    previous = *iter;
+  }
+}
+
+}  // namespace
+
+// static
+base::FilePath URLIndexPostingLists::GetFilePath(
+    const base::FilePath& cache_file_path,
+    int file_index) {
+  DCHECK_GE(file_index, 0);
+  DCHECK_LT(file_index, kFileCount);
+  return cache_file_path.AddExtension(kFileExtensions[file_index]);
+}
+
+// static
+std::string URLIndexPostingLists::Serialize(
+    const WordIDHistoryMap& word_id_history_map,
+    int64 stamp) {
+  std::string lists;
+  std::vector<TableEntry> word_table;
+  std::map<HistoryID, std::vector<int64> > history_words;
+  for (WordIDHistoryMap::const_iterator iter = word_id_history_map.begin();
+       iter != word_id_history_map.end(); ++iter) {
+    const HistoryIDSet& history_ids = iter->second;
+    if (history_ids.empty())
+      continue;
+    TableEntry entry = { static_cast<int64>(iter->first),
+                         static_cast<uint32>(lists.size()),
+                         static_cast<uint32>(history_ids.size()) };
+    word_table.push_back(entry);
+    AppendList(std::vector<int64>(history_ids.begin(), history_ids.end()),
+               &lists);
+    // The words are visited in order, so the lists built here are sorted.
+    for (HistoryIDSet::const_iterator id_iter = history_ids.begin();
+         id_iter != history_ids.end(); ++id_iter)
+      history_words[*id_iter].push_back(static_cast<int64>(iter->first));
+  }
+
+  std::vector<TableEntry> history_table;
+  for (std::map<HistoryID, std::vector<int64> >::const_iterator iter =
+           history_words.begin();
+       iter != history_words.end(); ++iter) {
+    TableEntry entry = { iter->first,
+                         static_cast<uint32>(lists.size()),
+                         static_cast<uint32>(iter->second.size()) };
+    history_table.push_back(entry);
+    AppendList(iter->second, &lists);
+  }
+
+  Header header = { kMagic,
+                    kVersion,
+                    stamp,
+                    static_cast<uint32>(word_table.size()),
+                    static_cast<uint32>(history_table.size()),
+                    static_cast<uint32>(lists.size()),
+                    0 };
+  std::string data;
+  data.reserve(sizeof(header) +
+               (word_table.size() + history_table.size()) *
+                   sizeof(TableEntry) +
+               lists.size());
+  AppendPod(header, &data);
+  for (size_t i = 0; i < word_table.size(); ++i)
+    AppendPod(word_table[i], &data);
+  for (size_t i = 0; i < history_table.size(); ++i)
+    AppendPod(history_table[i], &data);
+  data.append(lists);
+  return data;
+}
+
+// static
+scoped_refptr<URLIndexPostingLists> URLIndexPostingLists::CreateFromString(
+    const std::string& data,
+    int64 stamp) {
+  scoped_refptr<URLIndexPostingLists> posting_lists(new URLIndexPostingLists);
+  posting_lists->owned_data_ = data;
+  if (!posting_lists->Init(
+          reinterpret_cast<const uint8*>(posting_lists->owned_data_.data()),
+          posting_lists->owned_data_.size(), stamp))
+    return NULL;
+  return posting_lists;
+}
+
+// static
+scoped_refptr<URLIndexPostingLists> URLIndexPostingLists::CreateFromFile(
+    const base::FilePath& file_path,
+    int64 stamp) {
+  scoped_refptr<URLIndexPostingLists> posting_lists(new URLIndexPostingLists);
+  if (!posting_lists->file_.Initialize(file_path)) {
+    LOG(WARNING) << "Failed to map " << file_path.value();
+    return NULL;
+  }
+  if (!posting_lists->Init(posting_lists->file_.data(),
+                           posting_lists->file_.length(), stamp)) {
+    LOG(WARNING) << "Invalid posting lists in " << file_path.value();
+    return NULL;
+  }
+  return posting_lists;
+}
+
+void URLIndexPostingLists::GetHistoryIDs(WordID word_id,
+                                         HistoryIDSet* history_ids) const {
+  DCHECK(history_ids);
+  TableEntry entry;
+  if (!FindEntry(word_table_, word_count_, static_cast<int64>(word_id),
+                 &entry))
+    return;
+  std::vector<int64> ids;
+  DecodeList(entry, &ids);
+  for (std::vector<int64>::const_iterator iter = ids.begin();
+       iter != ids.end(); ++iter)
+    history_ids->insert(history_ids->end(), *iter);
+}
+
+void URLIndexPostingLists::GetWordIDs(HistoryID history_id,
+                                      WordIDSet* word_ids) const {
+  DCHECK(word_ids);
+  TableEntry entry;
+  if (!FindEntry(history_table_, history_count_, history_id, &entry))
+    return;
+  std::vector<int64> ids;
+  DecodeList(entry, &ids);
+  for (std::vector<int64>::const_iterator iter = ids.begin();
+       iter != ids.end(); ++iter)
+    word_ids->insert(word_ids->end(), static_cast<WordID>(*iter));
+}
+
+bool URLIndexPostingLists::HasHistoryID(HistoryID history_id) const {
+  TableEntry entry;
+  return FindEntry(history_table_, history_count_, history_id, &entry);
+}
+
+void URLIndexPostingLists::AddToWordIDHistoryMap(
+    WordIDHistoryMap* word_id_history_map) const {
+  DCHECK(word_id_history_map);
+  for (size_t i = 0; i < word_count_; ++i) {
+    TableEntry entry = ReadEntry(word_table_, i);
+    std::vector<int64> ids;
+    DecodeList(entry, &ids);
+    HistoryIDSet& history_ids =
+        (*word_id_history_map)[static_cast<WordID>(entry.key)];
+    history_ids.insert(ids.begin(), ids.end());
+  }
+}
+
+URLIndexPostingLists::URLIndexPostingLists()
+    : data_(NULL),
+      size_(0),
+      word_table_(0),
+      history_table_(0),
+      lists_(0),
+      word_count_(0),
+      history_count_(0) {
+}
+
+URLIndexPostingLists::~URLIndexPostingLists() {
+}
+
+bool URLIndexPostingLists::Init(const uint8* data, size_t size, int64 stamp) {
+  Header header;
+  if (size < sizeof(header))
+    return false;
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.stamp != stamp)
+    return false;
+  uint64 expected_size =
+      sizeof(header) +
+      (static_cast<uint64>(header.word_count) + header.history_count) *
+          sizeof(TableEntry) +
+      header.lists_size;
+  if (expected_size != size)
+    return false;
+
+  data_ = data;
+  size_ = size;
+  word_count_ = header.word_count;
+  history_count_ = header.history_count;
+  word_table_ = sizeof(header);
+  history_table_ = word_table_ + word_count_ * sizeof(TableEntry);
+  lists_ = history_table_ + history_count_ * sizeof(TableEntry);
+  return true;
+}
+
+bool URLIndexPostingLists::FindEntry(size_t table,
+                                     size_t entry_count,
+                                     int64 key,
+                                     TableEntry* entry) const {
+  size_t low = 0;
+  size_t high = entry_count;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    TableEntry middle_entry = ReadEntry(table, middle);
+    if (middle_entry.key < key) {
+      low = middle + 1;
+    } else if (key < middle_entry.key) {
+      high = middle;
+    } else {
+      *entry = middle_entry;
+      return true;
+    }
+  }
+  return false;
+}
+
+URLIndexPostingLists::TableEntry URLIndexPostingLists::ReadEntry(
+    size_t table,
+    size_t index) const {
+  // The buffer doesn't have to be aligned when it is copied from a string.
+  TableEntry entry;
+  memcpy(&entry, data_ + table + index * sizeof(TableEntry), sizeof(entry));
+  return entry;
+}
+
+void URLIndexPostingLists::DecodeList(const TableEntry& entry,
+                                      std::vector<int64>* ids) const {
+  size_t position = lists_ + entry.offset;
+  ids->reserve(entry.count);
+  int64 previous = 0;
+  for (uint32 i = 0; i < entry.count; ++i) {
+    uint64 delta = 0;
+    int shift = 0;
+    while (true) {
+      if (position >= size_ || shift > 63) {
+        LOG(ERROR) << "Truncated posting list.";
+        return;
+      }
+      uint8 byte = data_[position++];
+      delta |= static_cast<uint64>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        break;
+      shift += 7;
+    }
+    previous += static_cast<int64>(delta);
+    ids->push_back(previous);
+  }
+}
+
+}  // namespace history
@@ -0,0 +1,119 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_HISTORY_URL_INDEX_POSTING_LISTS_H_
+#define CHROME_BROWSER_HISTORY_URL_INDEX_POSTING_LISTS_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "chrome/browser/history/in_memory_url_index_types.h"
+
+namespace history {
+
+// Holds the word/history item mappings of the InMemoryURLIndex in a flat,
+// read-only buffer, so that a restored index can map them from a file rather
+// than rebuild a set node for every (word, item) pair. For each WordID it
+// holds the sorted HistoryIDs of the items containing the word and, for each
+// HistoryID, the sorted WordIDs of the item's words. Both kinds of lists are
+// stored as varint-coded deltas.
+//
+// The lists never change once written: URLIndexPrivateData keeps the updates
+// made since in an overlay, and writes new lists when it saves its cache.
+class URLIndexPostingLists
+    : public base::RefCountedThreadSafe<URLIndexPostingLists> {
+ public:
+  // The number of posting lists files which go with a cache file. Saving
+  // alternates between them, so that a file can be written while the other
+  // one is still mapped.
+  static const int kFileCount = 2;
+
+  // Returns the path of the posting lists file |file_index| for the cache
+  // file at |cache_file_path|.
+  static base::FilePath GetFilePath(const base::FilePath& cache_file_path,
+                                    int file_index);
+
+  // Encodes |word_id_history_map| into a buffer tagged with |stamp|, to be
+  // written to a posting lists file.
+  static std::string Serialize(const WordIDHistoryMap& word_id_history_map,
+                               int64 stamp);
+
+  // Returns the lists encoded in |data|, or NULL if |data| is invalid or isn't
+  // tagged with |stamp|.
+  static scoped_refptr<URLIndexPostingLists> CreateFromString(
+      const std::string& data,
+      int64 stamp);
+
+  // Maps the lists in the file at |file_path|. Returns NULL if the file can't
+  // be mapped, is invalid or isn't tagged with |stamp|. Should be run on the
+  // file thread.
+  static scoped_refptr<URLIndexPostingLists> CreateFromFile(
+      const base::FilePath& file_path,
+      int64 stamp);
+
+  // Adds the HistoryIDs of the items containing |word_id| to |history_ids|.
+  void GetHistoryIDs(WordID word_id, HistoryIDSet* history_ids) const;
+
+  // Adds the WordIDs of the words of the item |history_id| to |word_ids|.
+  void GetWordIDs(HistoryID history_id, WordIDSet* word_ids) const;
+
+  // Returns true if the lists hold words for the item |history_id|.
+  bool HasHistoryID(HistoryID history_id) const;
+
+  // Adds all of the word/history item mappings to |word_id_history_map|.
+  void AddToWordIDHistoryMap(WordIDHistoryMap* word_id_history_map) const;
+
+  size_t word_count() const { return word_count_; }
+  size_t history_count() const { return history_count_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<URLIndexPostingLists>;
+
+  // An entry of the tables that locate the lists, which are sorted by key.
+  struct TableEntry {
+    int64 key;
+    uint32 offset;  // From the start of the lists.
+    uint32 count;
+  };
+
+  URLIndexPostingLists();
+  ~URLIndexPostingLists();
+
+  // Points |data_| at |data| and checks its header. Returns false if |data|
+  // doesn't hold lists tagged with |stamp|.
+  bool Init(const uint8* data, size_t size, int64 stamp);
+
+  // Looks |key| up in the table of |entry_count| entries at |table|.
+  bool FindEntry(size_t table, size_t entry_count, int64 key,
+                 TableEntry* entry) const;
+  TableEntry ReadEntry(size_t table, size_t index) const;
+
+  // Decodes the list located by |entry| into |ids|. Stops at the end of the
+  // buffer if the list is truncated.
+  void DecodeList(const TableEntry& entry, std::vector<int64>* ids) const;
+
+  // Holds the buffer if it was copied from a string rather than mapped.
+  std::string owned_data_;
+  base::MemoryMappedFile file_;
+
+  const uint8* data_;
+  size_t size_;
+
+  // Offsets of the tables and the lists from |data_|.
+  size_t word_table_;
+  size_t history_table_;
+  size_t lists_;
+  size_t word_count_;
+  size_t history_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLIndexPostingLists);
+};
+
+}  // namespace history
+
+#endif  // CHROME_BROWSER_HISTORY_URL_INDEX_POSTING_LISTS_H_
@@ -0,0 +1,110 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/url_index_posting_lists.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace history {
+
+namespace {
+
+const int64 kStamp = 12345;
+
+WordIDHistoryMap CreateWordIDHistoryMap() {
+  WordIDHistoryMap word_id_history_map;
+  word_id_history_map[0].insert(1);
+  word_id_history_map[0].insert(300);
+  word_id_history_map[0].insert(GG_INT64_C(0x100000000));
+  word_id_history_map[2].insert(300);
+  word_id_history_map[7].insert(1);
+  word_id_history_map[7].insert(2);
+  return word_id_history_map;
+}
+
+}  // namespace
+
+TEST(URLIndexPostingListsTest, RoundTrip) {
+  WordIDHistoryMap expected = CreateWordIDHistoryMap();
+  scoped_refptr<URLIndexPostingLists> posting_lists =
+      URLIndexPostingLists::CreateFromString(
+          URLIndexPostingLists::Serialize(expected, kStamp), kStamp);
+  ASSERT_TRUE(posting_lists.get());
+  EXPECT_EQ(3u, posting_lists->word_count());
+  EXPECT_EQ(4u, posting_lists->history_count());
+
+  for (WordIDHistoryMap::const_iterator iter = expected.begin();
+       iter != expected.end(); ++iter) {
+    HistoryIDSet history_ids;
+    posting_lists->GetHistoryIDs(iter->first, &history_ids);
+    EXPECT_TRUE(iter->second == history_ids);
+  }
+  HistoryIDSet history_ids;
+  posting_lists->GetHistoryIDs(1, &history_ids);
+  EXPECT_TRUE(history_ids.empty());
+
+  WordIDSet word_ids;
+  posting_lists->GetWordIDs(300, &word_ids);
+  ASSERT_EQ(2u, word_ids.size());
+  EXPECT_EQ(1u, word_ids.count(0));
+  EXPECT_EQ(1u, word_ids.count(2));
+  EXPECT_TRUE(posting_lists->HasHistoryID(GG_INT64_C(0x100000000)));
+  EXPECT_FALSE(posting_lists->HasHistoryID(3));
+
+  WordIDHistoryMap actual;
+  posting_lists->AddToWordIDHistoryMap(&actual);
+  EXPECT_TRUE(expected == actual);
+}
+
+TEST(URLIndexPostingListsTest, Empty) {
+  scoped_refptr<URLIndexPostingLists> posting_lists =
+      URLIndexPostingLists::CreateFromString(
+          URLIndexPostingLists::Serialize(WordIDHistoryMap(), kStamp), kStamp);
+  ASSERT_TRUE(posting_lists.get());
+  EXPECT_EQ(0u, posting_lists->word_count());
+  HistoryIDSet history_ids;
+  posting_lists->GetHistoryIDs(0, &history_ids);
+  EXPECT_TRUE(history_ids.empty());
+}
+
+TEST(URLIndexPostingListsTest, RejectsInvalidData) {
+  std::string data =
+      URLIndexPostingLists::Serialize(CreateWordIDHistoryMap(), kStamp);
+  // A stale file.
+  EXPECT_FALSE(URLIndexPostingLists::CreateFromString(data, kStamp + 1).get());
+  // A truncated one.
+  EXPECT_FALSE(URLIndexPostingLists::CreateFromString(
+      data.substr(0, data.size() - 1), kStamp).get());
+  std::string corrupt = data;
+  corrupt[0] = ~corrupt[0];
+  EXPECT_FALSE(URLIndexPostingLists::CreateFromString(corrupt, kStamp).get());
+  EXPECT_FALSE(URLIndexPostingLists::CreateFromString(std::string(),
+                                                      kStamp).get());
+}
+
+TEST(URLIndexPostingListsTest, CreateFromFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath cache_path = temp_dir.path().AppendASCII("cache");
+  base::FilePath path = URLIndexPostingLists::GetFilePath(cache_path, 1);
+  EXPECT_NE(path, URLIndexPostingLists::GetFilePath(cache_path, 0));
+  EXPECT_FALSE(URLIndexPostingLists::CreateFromFile(path, kStamp).get());
+
+  WordIDHistoryMap expected = CreateWordIDHistoryMap();
+  std::string data = URLIndexPostingLists::Serialize(expected, kStamp);
+  ASSERT_EQ(static_cast<int>(data.size()),
+            file_util::WriteFile(path, data.data(), data.size()));
+  scoped_refptr<URLIndexPostingLists> posting_lists =
+      URLIndexPostingLists::CreateFromFile(path, kStamp);
+  ASSERT_TRUE(posting_lists.get());
+  WordIDHistoryMap actual;
+  posting_lists->AddToWordIDHistoryMap(&actual);
+  EXPECT_TRUE(expected == actual);
+}
+
+}  // namespace history
@@ -14,8 +14,10 @@
 
 #include "base/basictypes.h"
 #include "base/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/i18n/case_conversion.h"
 #include "base/metrics/histogram.h"
+#include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
@@ -53,11 +55,6 @@ typedef imui::InMemoryURLIndexCacheItem_WordMapItem WordMapItem;
 typedef imui::InMemoryURLIndexCacheItem_CharWordMapItem CharWordMapItem;
 typedef imui::InMemoryURLIndexCacheItem_CharWordMapItem_CharWordMapEntry
     CharWordMapEntry;
-typedef imui::InMemoryURLIndexCacheItem_WordIDHistoryMapItem
-    WordIDHistoryMapItem;
-typedef imui::
-    InMemoryURLIndexCacheItem_WordIDHistoryMapItem_WordIDHistoryMapEntry
-    WordIDHistoryMapEntry;
 typedef imui::InMemoryURLIndexCacheItem_HistoryInfoMapItem HistoryInfoMapItem;
 typedef imui::InMemoryURLIndexCacheItem_HistoryInfoMapItem_HistoryInfoMapEntry
     HistoryInfoMapEntry;
@@ -145,6 +142,7 @@ UpdateRecentVisitsFromHistoryDBTask::~UpdateRecentVisitsFromHistoryDBTask() {
 URLIndexPrivateData::URLIndexPrivateData()
     : restored_cache_version_(0),
       saved_cache_version_(kCurrentCacheFileVersion),
+      posting_lists_file_index_(0),
       pre_filter_item_count_(0),
       post_filter_item_count_(0),
       post_scoring_item_count_(0) {
@@ -413,13 +411,13 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RestoreFromFile(
     return restored_data;
   }
 
-  if (!restored_data->RestorePrivateData(index_cache, languages))
+  if (!restored_data->RestorePrivateData(index_cache, file_path, languages))
     return NULL;
 
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexRestoreCacheTime",
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
-                       restored_data->history_id_word_map_.size());
+                       restored_data->history_info_map_.size());
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLCacheSize", data.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
                              restored_data->word_map_.size());
@@ -454,7 +452,7 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::RebuildFromHistory(
   UMA_HISTOGRAM_TIMES("History.InMemoryURLIndexingTime",
                       base::TimeTicks::Now() - beginning_time);
   UMA_HISTOGRAM_COUNTS("History.InMemoryURLHistoryItems",
-                       rebuilt_data->history_id_word_map_.size());
+                       rebuilt_data->history_info_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLWords",
                              rebuilt_data->word_map_.size());
   UMA_HISTOGRAM_COUNTS_10000("History.InMemoryURLChars",
@@ -482,6 +480,11 @@ scoped_refptr<URLIndexPrivateData> URLIndexPrivateData::Duplicate() const {
   data_copy->available_words_ = available_words_;
   data_copy->word_map_ = word_map_;
   data_copy->char_word_map_ = char_word_map_;
+  // The posting lists are immutable, so the copy can share them.
+  data_copy->posting_lists_ = posting_lists_;
+  data_copy->history_ids_removed_from_posting_lists_ =
+      history_ids_removed_from_posting_lists_;
+  data_copy->posting_lists_file_index_ = posting_lists_file_index_;
   data_copy->word_id_history_map_ = word_id_history_map_;
   data_copy->history_id_word_map_ = history_id_word_map_;
   data_copy->history_info_map_ = history_info_map_;
@@ -504,6 +507,9 @@ void URLIndexPrivateData::Clear() {
   available_words_.clear();
   word_map_.clear();
   char_word_map_.clear();
+  posting_lists_ = NULL;
+  history_ids_removed_from_posting_lists_.clear();
+  posting_lists_file_index_ = 0;
   word_id_history_map_.clear();
   history_id_word_map_.clear();
   history_info_map_.clear();
@@ -638,15 +644,8 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
   HistoryIDSet history_id_set;
   if (!word_id_set.empty()) {
     for (WordIDSet::iterator word_id_iter = word_id_set.begin();
-         word_id_iter != word_id_set.end(); ++word_id_iter) {
-      WordID word_id = *word_id_iter;
-      WordIDHistoryMap::iterator word_iter = word_id_history_map_.find(word_id);
-      if (word_iter != word_id_history_map_.end()) {
-        HistoryIDSet& word_history_id_set(word_iter->second);
-        history_id_set.insert(word_history_id_set.begin(),
-                              word_history_id_set.end());
-      }
-    }
+         word_id_iter != word_id_set.end(); ++word_id_iter)
+      AddHistoryIDsForWord(*word_id_iter, &history_id_set);
   }
 
   // Record a new cache entry for this word if the term is longer than
@@ -657,6 +656,64 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
   return history_id_set;
 }
 
+void URLIndexPrivateData::AddHistoryIDsForWord(
+    WordID word_id,
+    HistoryIDSet* history_ids) const {
+  if (posting_lists_.get()) {
+    HistoryIDSet restored_ids;
+    posting_lists_->GetHistoryIDs(word_id, &restored_ids);
+    std::set_difference(restored_ids.begin(), restored_ids.end(),
+                        history_ids_removed_from_posting_lists_.begin(),
+                        history_ids_removed_from_posting_lists_.end(),
+                        std::inserter(*history_ids, history_ids->end()));
+  }
+  WordIDHistoryMap::const_iterator word_iter =
+      word_id_history_map_.find(word_id);
+  if (word_iter != word_id_history_map_.end())
+    history_ids->insert(word_iter->second.begin(), word_iter->second.end());
+}
+
+WordIDSet URLIndexPrivateData::WordIDsForHistoryID(
+    HistoryID history_id) const {
+  WordIDSet word_ids;
+  if (posting_lists_.get() &&
+      !ContainsKey(history_ids_removed_from_posting_lists_, history_id))
+    posting_lists_->GetWordIDs(history_id, &word_ids);
+  HistoryIDWordMap::const_iterator history_iter =
+      history_id_word_map_.find(history_id);
+  if (history_iter != history_id_word_map_.end())
+    word_ids.insert(history_iter->second.begin(), history_iter->second.end());
+  return word_ids;
+}
+
+bool URLIndexPrivateData::IsWordInUse(WordID word_id) const {
+  HistoryIDSet history_ids;
+  AddHistoryIDsForWord(word_id, &history_ids);
+  return !history_ids.empty();
+}
+
+void URLIndexPrivateData::GetWordIDHistoryMap(
+    WordIDHistoryMap* word_id_history_map) const {
+  DCHECK(word_id_history_map);
+  if (posting_lists_.get()) {
+    posting_lists_->AddToWordIDHistoryMap(word_id_history_map);
+    for (WordIDHistoryMap::iterator iter = word_id_history_map->begin();
+         iter != word_id_history_map->end();) {
+      iter->second = base::STLSetDifference<HistoryIDSet>(
+          iter->second, history_ids_removed_from_posting_lists_);
+      if (iter->second.empty())
+        word_id_history_map->erase(iter++);
+      else
+        ++iter;
+    }
+  }
+  for (WordIDHistoryMap::const_iterator iter = word_id_history_map_.begin();
+       iter != word_id_history_map_.end(); ++iter) {
+    (*word_id_history_map)[iter->first].insert(iter->second.begin(),
+                                               iter->second.end());
+  }
+}
+
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
     const Char16Set& term_chars) {
   WordIDSet word_id_set;
@@ -761,6 +818,10 @@ void URLIndexPrivateData::AddRowWordsToIndex(const URLRow& row,
   const base::string16& title = CleanUpTitleForMatching(row.title());
   String16Set title_words = String16SetFromString16(title,
       word_starts ? &word_starts->title_word_starts_ : NULL);
+  if (word_starts) {
+    word_starts->cleaned_url_ = url;
+    word_starts->cleaned_title_ = title;
+  }
   String16Set words;
   std::set_union(url_words.begin(), url_words.end(),
                  title_words.begin(), title_words.end(),
@@ -820,10 +881,10 @@ void URLIndexPrivateData::AddWordHistory(const base::string16& term,
 
 void URLIndexPrivateData::UpdateWordHistory(WordID word_id,
                                             HistoryID history_id) {
-  WordIDHistoryMap::iterator history_pos = word_id_history_map_.find(word_id);
-  DCHECK(history_pos != word_id_history_map_.end());
-  HistoryIDSet& history_id_set(history_pos->second);
-  history_id_set.insert(history_id);
+  // Words restored from the cache may only be in |posting_lists_|.
+  DCHECK(posting_lists_.get() ||
+         word_id_history_map_.find(word_id) != word_id_history_map_.end());
+  word_id_history_map_[word_id].insert(history_id);
   AddToHistoryIDWordMap(history_id, word_id);
 }
 
@@ -851,15 +912,23 @@ void URLIndexPrivateData::RemoveRowWordsFromIndex(const URLRow& row) {
   // Remove the entries in history_id_word_map_ and word_id_history_map_ for
   // this row.
   HistoryID history_id = static_cast<HistoryID>(row.id());
-  WordIDSet word_id_set = history_id_word_map_[history_id];
+  WordIDSet word_id_set = WordIDsForHistoryID(history_id);
   history_id_word_map_.erase(history_id);
+  if (posting_lists_.get() && posting_lists_->HasHistoryID(history_id))
+    history_ids_removed_from_posting_lists_.insert(history_id);
 
   // Reconcile any changes to word usage.
   for (WordIDSet::iterator word_id_iter = word_id_set.begin();
        word_id_iter != word_id_set.end(); ++word_id_iter) {
     WordID word_id = *word_id_iter;
-    word_id_history_map_[word_id].erase(history_id);
-    if (!word_id_history_map_[word_id].empty())
+    WordIDHistoryMap::iterator history_pos =
+        word_id_history_map_.find(word_id);
+    if (history_pos != word_id_history_map_.end()) {
+      history_pos->second.erase(history_id);
+      if (history_pos->second.empty())
+        word_id_history_map_.erase(history_pos);
+    }
+    if (IsWordInUse(word_id))
       continue;  // The word is still in use.
 
     // The word is no longer in use. Reconcile any changes to character usage.
@@ -874,7 +943,6 @@ void URLIndexPrivateData::RemoveRowWordsFromIndex(const URLRow& row) {
     }
 
     // Complete the removal of references to the word.
-    word_id_history_map_.erase(word_id);
     word_map_.erase(word);
     word_list_[word_id] = base::string16();
     available_words_.insert(word_id);
@@ -891,6 +959,8 @@ bool URLIndexPrivateData::SaveToFile(const base::FilePath& file_path) {
   base::TimeTicks beginning_time = base::TimeTicks::Now();
   InMemoryURLIndexCacheItem index_cache;
   SavePrivateData(&index_cache);
+  if (!SavePostingLists(file_path, &index_cache))
+    return false;
   std::string data;
   if (!index_cache.SerializeToString(&data)) {
     LOG(WARNING) << "Failed to serialize the InMemoryURLIndex cache.";
@@ -907,6 +977,29 @@ bool URLIndexPrivateData::SaveToFile(const base::FilePath& file_path) {
   return true;
 }
 
+bool URLIndexPrivateData::SavePostingLists(
+    const base::FilePath& file_path,
+    InMemoryURLIndexCacheItem* cache) const {
+  WordIDHistoryMap word_id_history_map;
+  GetWordIDHistoryMap(&word_id_history_map);
+  if (word_id_history_map.empty())
+    return true;
+  // Don't overwrite the file |posting_lists_| is mapped from.
+  int file_index = posting_lists_.get() ? 1 - posting_lists_file_index_ : 0;
+  int64 stamp = base::Time::Now().ToInternalValue();
+  base::FilePath posting_lists_path =
+      URLIndexPostingLists::GetFilePath(file_path, file_index);
+  if (!base::ImportantFileWriter::WriteFileAtomically(
+          posting_lists_path,
+          URLIndexPostingLists::Serialize(word_id_history_map, stamp))) {
+    LOG(WARNING) << "Failed to write " << posting_lists_path.value();
+    return false;
+  }
+  cache->set_posting_lists_stamp(stamp);
+  cache->set_posting_lists_file_index(file_index);
+  return true;
+}
+
 void URLIndexPrivateData::SavePrivateData(
     InMemoryURLIndexCacheItem* cache) const {
   DCHECK(cache);
@@ -919,7 +1012,6 @@ void URLIndexPrivateData::SavePrivateData(
   SaveWordList(cache);
   SaveWordMap(cache);
   SaveCharWordMap(cache);
-  SaveWordIDHistoryMap(cache);
   SaveHistoryInfoMap(cache);
   SaveWordStartsMap(cache);
 }
@@ -965,25 +1057,6 @@ void URLIndexPrivateData::SaveCharWordMap(
   }
 }
 
-void URLIndexPrivateData::SaveWordIDHistoryMap(
-    InMemoryURLIndexCacheItem* cache) const {
-  if (word_id_history_map_.empty())
-    return;
-  WordIDHistoryMapItem* map_item = cache->mutable_word_id_history_map();
-  map_item->set_item_count(word_id_history_map_.size());
-  for (WordIDHistoryMap::const_iterator iter = word_id_history_map_.begin();
-       iter != word_id_history_map_.end(); ++iter) {
-    WordIDHistoryMapEntry* map_entry =
-        map_item->add_word_id_history_map_entry();
-    map_entry->set_word_id(iter->first);
-    const HistoryIDSet& history_id_set(iter->second);
-    map_entry->set_item_count(history_id_set.size());
-    for (HistoryIDSet::const_iterator set_iter = history_id_set.begin();
-         set_iter != history_id_set.end(); ++set_iter)
-      map_entry->add_history_id(*set_iter);
-  }
-}
-
 void URLIndexPrivateData::SaveHistoryInfoMap(
     InMemoryURLIndexCacheItem* cache) const {
   if (history_info_map_.empty())
@@ -1042,6 +1115,7 @@ void URLIndexPrivateData::SaveWordStartsMap(
 
 bool URLIndexPrivateData::RestorePrivateData(
     const InMemoryURLIndexCacheItem& cache,
+    const base::FilePath& file_path,
     const std::string& languages) {
   last_time_rebuilt_from_history_ =
       base::Time::FromInternalValue(cache.last_rebuild_timestamp());
@@ -1066,7 +1140,7 @@ bool URLIndexPrivateData::RestorePrivateData(
     restored_cache_version_ = cache.version();
   }
   return RestoreWordList(cache) && RestoreWordMap(cache) &&
-      RestoreCharWordMap(cache) && RestoreWordIDHistoryMap(cache) &&
+      RestoreCharWordMap(cache) && RestoreWordIDHistoryMap(cache, file_path) &&
       RestoreHistoryInfoMap(cache) && RestoreWordStartsMap(cache, languages);
 }
 
@@ -1131,32 +1205,20 @@ bool URLIndexPrivateData::RestoreCharWordMap(
 }
 
 bool URLIndexPrivateData::RestoreWordIDHistoryMap(
-    const InMemoryURLIndexCacheItem& cache) {
-  if (!cache.has_word_id_history_map())
+    const InMemoryURLIndexCacheItem& cache,
+    const base::FilePath& file_path) {
+  if (!cache.has_posting_lists_stamp() ||
+      !cache.has_posting_lists_file_index())
     return false;
-  const WordIDHistoryMapItem& list_item(cache.word_id_history_map());
-  uint32 expected_item_count = list_item.item_count();
-  uint32 actual_item_count = list_item.word_id_history_map_entry_size();
-  if (actual_item_count == 0 || actual_item_count != expected_item_count)
+  int file_index = cache.posting_lists_file_index();
+  if (file_index < 0 || file_index >= URLIndexPostingLists::kFileCount)
     return false;
-  const RepeatedPtrField<WordIDHistoryMapEntry>&
-      entries(list_item.word_id_history_map_entry());
-  for (RepeatedPtrField<WordIDHistoryMapEntry>::const_iterator iter =
-       entries.begin(); iter != entries.end(); ++iter) {
-    expected_item_count = iter->item_count();
-    actual_item_count = iter->history_id_size();
-    if (actual_item_count == 0 || actual_item_count != expected_item_count)
-      return false;
-    WordID word_id = iter->word_id();
-    HistoryIDSet history_id_set;
-    const RepeatedField<int64>& history_ids(iter->history_id());
-    for (RepeatedField<int64>::const_iterator jiter = history_ids.begin();
-         jiter != history_ids.end(); ++jiter) {
-      history_id_set.insert(*jiter);
-      AddToHistoryIDWordMap(*jiter, word_id);
-    }
-    word_id_history_map_[word_id] = history_id_set;
-  }
+  posting_lists_ = URLIndexPostingLists::CreateFromFile(
+      URLIndexPostingLists::GetFilePath(file_path, file_index),
+      cache.posting_lists_stamp());
+  if (!posting_lists_.get())
+    return false;
+  posting_lists_file_index_ = file_index;
   return true;
 }
 
@@ -1229,18 +1291,22 @@ bool URLIndexPrivateData::RestoreWordStartsMap(
         word_starts.title_word_starts_.push_back(*jiter);
       word_starts_map_[history_id] = word_starts;
     }
-  } else {
-    // Since the cache did not contain any word starts we must rebuild then from
-    // the URL and page titles.
-    for (HistoryInfoMap::const_iterator iter = history_info_map_.begin();
-         iter != history_info_map_.end(); ++iter) {
-      RowWordStarts word_starts;
-      const URLRow& row(iter->second.url_row);
-      const base::string16& url = CleanUpUrlForMatching(row.url(), languages);
-      String16VectorFromString16(url, false, &word_starts.url_word_starts_);
-      const base::string16& title = CleanUpTitleForMatching(row.title());
-      String16VectorFromString16(title, false, &word_starts.title_word_starts_);
-      word_starts_map_[iter->first] = word_starts;
+  }
+  // The cleaned up URLs and page titles aren't saved in the cache, so clean
+  // them up again. If the cache did not contain any word starts we must
+  // rebuild them from those too.
+  const bool rebuild_word_starts = !cache.has_word_starts_map();
+  for (HistoryInfoMap::const_iterator iter = history_info_map_.begin();
+       iter != history_info_map_.end(); ++iter) {
+    RowWordStarts& word_starts = word_starts_map_[iter->first];
+    const URLRow& row(iter->second.url_row);
+    word_starts.cleaned_url_ = CleanUpUrlForMatching(row.url(), languages);
+    word_starts.cleaned_title_ = CleanUpTitleForMatching(row.title());
+    if (rebuild_word_starts) {
+      String16VectorFromString16(word_starts.cleaned_url_, false,
+                                 &word_starts.url_word_starts_);
+      String16VectorFromString16(word_starts.cleaned_title_, false,
+                                 &word_starts.title_word_starts_);
     }
   }
   return true;
@@ -16,6 +16,7 @@
 #include "chrome/browser/history/in_memory_url_index_cache.pb.h"
 #include "chrome/browser/history/in_memory_url_index_types.h"
 #include "chrome/browser/history/scored_history_match.h"
+#include "chrome/browser/history/url_index_posting_lists.h"
 #include "content/public/browser/notification_details.h"
 
 class BookmarkService;
@@ -34,7 +35,7 @@ class InMemoryURLIndex;
 class RefCountedBool;
 
 // Current version of the cache file.
-static const int kCurrentCacheFileVersion = 4;
+static const int kCurrentCacheFileVersion = 5;
 
 // A structure private to InMemoryURLIndex describing its internal data and
 // providing for restoring, rebuilding and updating that internal data. As
@@ -244,6 +245,21 @@ class URLIndexPrivateData
   // Given a set of Char16s, finds words containing those characters.
   WordIDSet WordIDSetForTermChars(const Char16Set& term_chars);
 
+  // Adds the HistoryIDs of the items containing |word_id| to |history_ids|,
+  // from both |posting_lists_| and |word_id_history_map_|.
+  void AddHistoryIDsForWord(WordID word_id, HistoryIDSet* history_ids) const;
+
+  // Returns the WordIDs of the words of the item |history_id|, from both
+  // |posting_lists_| and |history_id_word_map_|.
+  WordIDSet WordIDsForHistoryID(HistoryID history_id) const;
+
+  // Returns true if any indexed item still contains |word_id|.
+  bool IsWordInUse(WordID word_id) const;
+
+  // Fills |word_id_history_map| with the mappings of |posting_lists_| and
+  // |word_id_history_map_| merged.
+  void GetWordIDHistoryMap(WordIDHistoryMap* word_id_history_map) const;
+
   // Indexes one URL history item as described by |row|. Returns true if the
   // row was actually indexed. |languages| gives a list of language encodings by
   // which the URLs and page titles are broken down into words and characters.
@@ -297,24 +313,30 @@ class URLIndexPrivateData
   // directory.  Called by WritePrivateDataToCacheFileTask.
   bool SaveToFile(const base::FilePath& file_path);
 
+  // Writes the word/history item mappings to a posting lists file next to
+  // the cache file at |file_path|, and records which one in |cache|.
+  bool SavePostingLists(const base::FilePath& file_path,
+                        imui::InMemoryURLIndexCacheItem* cache) const;
+
   // Encode a data structure into the protobuf |cache|.
   void SavePrivateData(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveWordList(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveWordMap(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveCharWordMap(imui::InMemoryURLIndexCacheItem* cache) const;
-  void SaveWordIDHistoryMap(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveHistoryInfoMap(imui::InMemoryURLIndexCacheItem* cache) const;
   void SaveWordStartsMap(imui::InMemoryURLIndexCacheItem* cache) const;
 
-  // Decode a data structure from the protobuf |cache|. Return false if there
-  // is any kind of failure. |languages| will be used to break URLs and page
-  // titles into words
+  // Decode a data structure from the protobuf |cache|, read from the file at
+  // |file_path|. Return false if there is any kind of failure. |languages|
+  // will be used to break URLs and page titles into words
   bool RestorePrivateData(const imui::InMemoryURLIndexCacheItem& cache,
+                          const base::FilePath& file_path,
                           const std::string& languages);
   bool RestoreWordList(const imui::InMemoryURLIndexCacheItem& cache);
   bool RestoreWordMap(const imui::InMemoryURLIndexCacheItem& cache);
   bool RestoreCharWordMap(const imui::InMemoryURLIndexCacheItem& cache);
-  bool RestoreWordIDHistoryMap(const imui::InMemoryURLIndexCacheItem& cache);
+  bool RestoreWordIDHistoryMap(const imui::InMemoryURLIndexCacheItem& cache,
+                               const base::FilePath& file_path);
   bool RestoreHistoryInfoMap(const imui::InMemoryURLIndexCacheItem& cache);
   bool RestoreWordStartsMap(const imui::InMemoryURLIndexCacheItem& cache,
                             const std::string& languages);
@@ -362,6 +384,18 @@ class URLIndexPrivateData
   // containing that character.
   CharWordIDMap char_word_map_;
 
+  // The mappings between words and history items restored from the cache,
+  // if any. They are mapped from a file and can't change, so the items
+  // indexed since are kept in |word_id_history_map_| and
+  // |history_id_word_map_|, and the items removed since are listed in
+  // |history_ids_removed_from_posting_lists_|, whose IDs are ignored when
+  // read from |posting_lists_|.
+  scoped_refptr<URLIndexPostingLists> posting_lists_;
+  HistoryIDSet history_ids_removed_from_posting_lists_;
+
+  // Which of the posting lists files |posting_lists_| was mapped from.
+  int posting_lists_file_index_;
+
   // A one-to-many mapping from a WordID to all HistoryIDs (the row_id as
   // used in the history database) of history items in which the word occurs.
   WordIDHistoryMap word_id_history_map_;
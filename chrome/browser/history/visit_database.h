@@ -53,6 +53,12 @@ class VisitDatabase {
   // VisitID as the key. The visit must exist. Returns true on success.
   bool UpdateVisitRow(const VisitRow& visit);
 
+  // Sets the duration of the given visit to the time from its start to
+  // |end_time|, or to 0 if |end_time| is before its start. This is cheaper
+  // than reading the row and writing all of it back with UpdateVisitRow.
+  // Returns true on success, which includes the visit not existing.
+  bool UpdateVisitDuration(VisitID visit_id, base::Time end_time);
+
   // Fills in the given vector with all of the visits for the given page ID,
   // sorted in ascending order of date. Returns true on success (although there
   // may still be no matches).
@@ -155,6 +155,27 @@ TEST_F(VisitDatabaseTest, Update) {
   EXPECT_TRUE(IsVisitInfoEqual(modification, final));
 }
 
+TEST_F(VisitDatabaseTest, UpdateVisitDuration) {
+  Time start_time = Time::Now();
+  VisitRow original(1, start_time, 23, content::PageTransitionFromInt(0), 19);
+  AddVisit(&original, SOURCE_BROWSED);
+
+  EXPECT_TRUE(UpdateVisitDuration(original.visit_id,
+                                  start_time + TimeDelta::FromSeconds(30)));
+  VisitRow final;
+  ASSERT_TRUE(GetRowForVisit(original.visit_id, &final));
+  EXPECT_EQ(TimeDelta::FromSeconds(30), final.visit_duration);
+
+  // The rest of the row is left as it was.
+  EXPECT_TRUE(IsVisitInfoEqual(original, final));
+
+  // An end before the start of the visit doesn't make a negative duration.
+  EXPECT_TRUE(UpdateVisitDuration(original.visit_id,
+                                  start_time - TimeDelta::FromSeconds(30)));
+  ASSERT_TRUE(GetRowForVisit(original.visit_id, &final));
+  EXPECT_EQ(TimeDelta(), final.visit_duration);
+}
+
 // TODO(brettw) write test for GetMostRecentVisitForURL!
 
 namespace {
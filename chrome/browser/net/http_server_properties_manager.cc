@@ -234,6 +234,19 @@ HttpServerPropertiesManager::GetServerNetworkStats(
   return http_server_properties_impl_->GetServerNetworkStats(host_port_pair);
 }
 
+void HttpServerPropertiesManager::SetConcurrentConnectionDemand(
+    const net::HostPortPair& host_port_pair,
+    int num_connections) {
+  http_server_properties_impl_->SetConcurrentConnectionDemand(host_port_pair,
+                                                              num_connections);
+}
+
+int HttpServerPropertiesManager::GetConcurrentConnectionDemand(
+    const net::HostPortPair& host_port_pair) {
+  return http_server_properties_impl_->GetConcurrentConnectionDemand(
+      host_port_pair);
+}
+
 net::HttpPipelinedHostCapability
 HttpServerPropertiesManager::GetPipelineCapability(
     const net::HostPortPair& origin) {
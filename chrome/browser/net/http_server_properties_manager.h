@@ -147,6 +147,13 @@ class HttpServerPropertiesManager
   virtual const NetworkStats* GetServerNetworkStats(
       const net::HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetConcurrentConnectionDemand(
+      const net::HostPortPair& host_port_pair,
+      int num_connections) OVERRIDE;
+
+  virtual int GetConcurrentConnectionDemand(
+      const net::HostPortPair& host_port_pair) OVERRIDE;
+
   virtual net::HttpPipelinedHostCapability GetPipelineCapability(
       const net::HostPortPair& origin) OVERRIDE;
 
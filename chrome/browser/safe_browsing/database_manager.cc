@@ -42,6 +42,17 @@ namespace {
 // Timeout for match checks, e.g. download URLs, hashes.
 const int kCheckTimeoutMs = 10000;
 
+// How long, and how many, browse URLs found safe are remembered.  The cache
+// is cleared by database updates too, this only bounds its staleness and size
+// between them.
+const int kSafeUrlCacheSeconds = 60;
+const size_t kMaxSafeUrlCacheSize = 1000;
+
+void GetBrowseExpectedThreats(std::vector<SBThreatType>* expected_threats) {
+  expected_threats->push_back(SB_THREAT_TYPE_URL_MALWARE);
+  expected_threats->push_back(SB_THREAT_TYPE_URL_PHISHING);
+}
+
 // Records disposition information about the check.  |hit| should be
 // |true| if there were any prefix hits in |full_hashes|.
 void RecordGetHashCheckStatus(
@@ -354,9 +365,11 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
   if (!CanCheckUrl(url))
     return true;
 
+  if (IsSafeUrlCached(url))
+    return true;
+
   std::vector<SBThreatType> expected_threats;
-  expected_threats.push_back(SB_THREAT_TYPE_URL_MALWARE);
-  expected_threats.push_back(SB_THREAT_TYPE_URL_PHISHING);
+  GetBrowseExpectedThreats(&expected_threats);
 
   const base::TimeTicks start = base::TimeTicks::Now();
   if (!MakeDatabaseAvailable()) {
@@ -379,26 +392,65 @@ bool SafeBrowsingDatabaseManager::CheckBrowseUrl(const GURL& url,
 
   UMA_HISTOGRAM_TIMES("SB2.FilterCheck", base::TimeTicks::Now() - start);
 
-  if (!prefix_match)
+  if (!prefix_match) {
+    CacheSafeUrl(url);
     return true;  // URL is okay.
+  }
 
-  // Needs to be asynchronous, since we could be in the constructor of a
-  // ResourceDispatcherHost event handler which can't pause there.
-  SafeBrowsingCheck* check = new SafeBrowsingCheck(std::vector<GURL>(1, url),
-                                                   std::vector<SBFullHash>(),
-                                                   client,
-                                                   safe_browsing_util::MALWARE,
-                                                   expected_threats);
-  check->need_get_hash = full_hits.empty();
-  check->prefix_hits.swap(prefix_hits);
-  check->full_hits.swap(full_hits);
-  checks_.insert(check);
+  StartBrowseCheck(url, client, expected_threats, &prefix_hits, &full_hits);
+  return false;
+}
 
-  BrowserThread::PostTask(
-      BrowserThread::IO, FROM_HERE,
-      base::Bind(&SafeBrowsingDatabaseManager::OnCheckDone, this, check));
+size_t SafeBrowsingDatabaseManager::CheckBrowseUrls(
+    const std::vector<GURL>& urls,
+    Client* client) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!enabled_)
+    return 0;
 
-  return false;
+  std::vector<GURL> urls_to_check;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    if (CanCheckUrl(urls[i]) && !IsSafeUrlCached(urls[i]))
+      urls_to_check.push_back(urls[i]);
+  }
+  if (urls_to_check.empty())
+    return 0;
+
+  std::vector<SBThreatType> expected_threats;
+  GetBrowseExpectedThreats(&expected_threats);
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  if (!MakeDatabaseAvailable()) {
+    for (size_t i = 0; i < urls_to_check.size(); ++i) {
+      QueuedCheck queued_check(safe_browsing_util::MALWARE,  // or PHISH
+                               client,
+                               urls_to_check[i],
+                               expected_threats,
+                               start);
+      queued_checks_.push_back(queued_check);
+    }
+    return urls_to_check.size();
+  }
+
+  std::vector<SafeBrowsingDatabase::BrowseUrlHits> hits;
+  database_->ContainsBrowseUrls(urls_to_check,
+                                sb_service_->protocol_manager()->last_update(),
+                                &hits);
+
+  UMA_HISTOGRAM_TIMES("SB2.FilterCheckBatch", base::TimeTicks::Now() - start);
+  UMA_HISTOGRAM_COUNTS_100("SB2.FilterCheckBatchSize", urls_to_check.size());
+
+  size_t pending_count = 0;
+  for (size_t i = 0; i < urls_to_check.size(); ++i) {
+    if (!hits[i].match) {
+      CacheSafeUrl(urls_to_check[i]);
+      continue;
+    }
+    StartBrowseCheck(urls_to_check[i], client, expected_threats,
+                     &hits[i].prefix_hits, &hits[i].full_hits);
+    ++pending_count;
+  }
+  return pending_count;
 }
 
 void SafeBrowsingDatabaseManager::CancelCheck(Client* client) {
@@ -499,12 +551,14 @@ void SafeBrowsingDatabaseManager::UpdateFinished(bool update_succeeded) {
 void SafeBrowsingDatabaseManager::ResetDatabase() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK(enabled_);
+  ClearSafeUrlCache();
   safe_browsing_thread_->message_loop()->PostTask(FROM_HERE, base::Bind(
       &SafeBrowsingDatabaseManager::OnResetDatabase, this));
 }
 
 void SafeBrowsingDatabaseManager::PurgeMemory() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  ClearSafeUrlCache();
   CloseDatabase();
 }
 
@@ -614,6 +668,7 @@ void SafeBrowsingDatabaseManager::DoStopOnIOThread() {
   STLDeleteElements(&checks_);
 
   gethash_requests_.clear();
+  ClearSafeUrlCache();
 }
 
 bool SafeBrowsingDatabaseManager::DatabaseAvailable() const {
@@ -750,6 +805,57 @@ void SafeBrowsingDatabaseManager::OnCheckDone(SafeBrowsingCheck* check) {
   }
 }
 
+void SafeBrowsingDatabaseManager::StartBrowseCheck(
+    const GURL& url,
+    Client* client,
+    const std::vector<SBThreatType>& expected_threats,
+    std::vector<SBPrefix>* prefix_hits,
+    std::vector<SBFullHashResult>* full_hits) {
+  // Needs to be asynchronous, since we could be in the constructor of a
+  // ResourceDispatcherHost event handler which can't pause there.
+  SafeBrowsingCheck* check = new SafeBrowsingCheck(std::vector<GURL>(1, url),
+                                                   std::vector<SBFullHash>(),
+                                                   client,
+                                                   safe_browsing_util::MALWARE,
+                                                   expected_threats);
+  check->need_get_hash = full_hits->empty();
+  check->prefix_hits.swap(*prefix_hits);
+  check->full_hits.swap(*full_hits);
+  checks_.insert(check);
+
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&SafeBrowsingDatabaseManager::OnCheckDone, this, check));
+}
+
+bool SafeBrowsingDatabaseManager::IsSafeUrlCached(const GURL& url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  SafeUrlCache::iterator it = safe_url_cache_.find(url.spec());
+  if (it == safe_url_cache_.end())
+    return false;
+  if (it->second <= base::TimeTicks::Now()) {
+    safe_url_cache_.erase(it);
+    return false;
+  }
+  return true;
+}
+
+void SafeBrowsingDatabaseManager::CacheSafeUrl(const GURL& url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  // Start over rather than track the age of the entries, the cache only has
+  // to hold the urls of the few pages being loaded.
+  if (safe_url_cache_.size() >= kMaxSafeUrlCacheSize)
+    safe_url_cache_.clear();
+  safe_url_cache_[url.spec()] =
+      base::TimeTicks::Now() +
+      base::TimeDelta::FromSeconds(kSafeUrlCacheSeconds);
+}
+
+void SafeBrowsingDatabaseManager::ClearSafeUrlCache() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  safe_url_cache_.clear();
+}
+
 void SafeBrowsingDatabaseManager::GetAllChunksFromDatabase(
     GetChunksCallback callback) {
   DCHECK_EQ(base::MessageLoop::current(),
@@ -876,6 +982,10 @@ void SafeBrowsingDatabaseManager::DatabaseUpdateFinished(
   GetDatabase()->UpdateFinished(update_succeeded);
   DCHECK(database_update_in_progress_);
   database_update_in_progress_ = false;
+  // Urls found safe until now may not be safe with the new data.
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&SafeBrowsingDatabaseManager::ClearSafeUrlCache, this));
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(&SafeBrowsingDatabaseManager::NotifyDatabaseUpdateFinished,
@@ -133,6 +133,12 @@ class SafeBrowsingDatabaseManager
   // result when it is ready.
   virtual bool CheckBrowseUrl(const GURL& url, Client* client);
 
+  // Called on the IO thread to check many urls at once, such as the
+  // subresources of a page, with a single lookup in the database.  Returns the
+  // number of urls which couldn't be determined safe synchronously, which is
+  // the number of calls "client" gets asynchronously, one for each of them.
+  virtual size_t CheckBrowseUrls(const std::vector<GURL>& urls, Client* client);
+
   // Check if the prefix for |url| is in safebrowsing download add lists.
   // Result will be passed to callback in |client|.
   virtual bool CheckDownloadUrl(const std::vector<GURL>& url_chain,
@@ -227,6 +233,9 @@ class SafeBrowsingDatabaseManager
   typedef std::set<SafeBrowsingCheck*> CurrentChecks;
   typedef std::vector<SafeBrowsingCheck*> GetHashRequestors;
   typedef base::hash_map<SBPrefix, GetHashRequestors> GetHashRequests;
+  // Maps the specs of urls found safe to the time until which they can be
+  // considered safe without checking them again.
+  typedef base::hash_map<std::string, base::TimeTicks> SafeUrlCache;
 
   // Clients that we've queued up for checking later once the database is ready.
   struct QueuedCheck {
@@ -273,6 +282,21 @@ class SafeBrowsingDatabaseManager
   // Called on the IO thread with the check result.
   void OnCheckDone(SafeBrowsingCheck* info);
 
+  // Starts the asynchronous check of a browse |url| which has prefix hits in
+  // the database.  Takes the contents of |prefix_hits| and |full_hits|.
+  void StartBrowseCheck(const GURL& url,
+                        Client* client,
+                        const std::vector<SBThreatType>& expected_threats,
+                        std::vector<SBPrefix>* prefix_hits,
+                        std::vector<SBFullHashResult>* full_hits);
+
+  // Called on the IO thread to look up and record browse urls found safe, so
+  // that the subresources which pages have in common are checked once per
+  // database update.
+  bool IsSafeUrlCached(const GURL& url);
+  void CacheSafeUrl(const GURL& url);
+  void ClearSafeUrlCache();
+
   // Called on the database thread to retrieve chunks.
   void GetAllChunksFromDatabase(GetChunksCallback callback);
 
@@ -419,6 +443,9 @@ class SafeBrowsingDatabaseManager
 
   std::deque<QueuedCheck> queued_checks_;
 
+  // Browse urls recently found safe.  Cleared when the database changes.
+  SafeUrlCache safe_url_cache_;
+
   // Timeout to use for safe browsing checks.
   base::TimeDelta check_timeout_;
 
@@ -53,6 +53,19 @@ class SafeBrowsingDatabaseManagerTest : public PlatformTest {
                      const std::vector<SBThreatType>& expected_threats,
                      const std::string& result_list);
 
+  bool IsSafeUrlCached(SafeBrowsingDatabaseManager* db_manager,
+                       const GURL& url) {
+    return db_manager->IsSafeUrlCached(url);
+  }
+
+  void CacheSafeUrl(SafeBrowsingDatabaseManager* db_manager, const GURL& url) {
+    db_manager->CacheSafeUrl(url);
+  }
+
+  void ClearSafeUrlCache(SafeBrowsingDatabaseManager* db_manager) {
+    db_manager->ClearSafeUrlCache();
+  }
+
  private:
   TestBrowserThreadBundle thread_bundle_;
   TestSafeBrowsingServiceFactory factory_;
@@ -111,3 +124,20 @@ TEST_F(SafeBrowsingDatabaseManagerTest, CheckCorrespondsListType) {
                             multiple_threats,
                             safe_browsing_util::kMalwareList));
 }
+
+TEST_F(SafeBrowsingDatabaseManagerTest, SafeUrlCache) {
+  scoped_refptr<SafeBrowsingService> sb_service(
+      SafeBrowsingService::CreateSafeBrowsingService());
+  scoped_refptr<SafeBrowsingDatabaseManager> db_manager(
+      new SafeBrowsingDatabaseManager(sb_service));
+
+  const GURL url("http://www.example.com/script.js");
+  EXPECT_FALSE(IsSafeUrlCached(db_manager.get(), url));
+  CacheSafeUrl(db_manager.get(), url);
+  EXPECT_TRUE(IsSafeUrlCached(db_manager.get(), url));
+  EXPECT_FALSE(IsSafeUrlCached(db_manager.get(),
+                               GURL("http://www.example.com/other.js")));
+
+  ClearSafeUrlCache(db_manager.get());
+  EXPECT_FALSE(IsSafeUrlCached(db_manager.get(), url));
+}
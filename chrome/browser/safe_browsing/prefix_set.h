@@ -45,16 +45,22 @@
 //     n * 8 byte |&index_[0]..&index_[n]|
 //     m * 2 byte |&deltas_[0]..&deltas_[m]|
 //        16 byte digest
+//
+// The index and deltas are naturally aligned in this format, so
+// |LoadFile()| maps the file and uses them in place rather than
+// copying them into the heap.
 
 #ifndef CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 #define CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/safe_browsing/safe_browsing_util.h"
 
 namespace base {
 class FilePath;
+class MemoryMappedFile;
 }
 
 namespace safe_browsing {
@@ -67,7 +73,8 @@ class PrefixSet {
   // |true| if |prefix| was in |prefixes| passed to the constructor.
   bool Exists(SBPrefix prefix) const;
 
-  // Persist the set on disk.
+  // Persist the set on disk.  A loaded set maps |filter_name|, so the
+  // file must not be rewritten or deleted until the set is destroyed.
   static PrefixSet* LoadFile(const base::FilePath& filter_name);
   bool WriteFile(const base::FilePath& filter_name) const;
 
@@ -90,6 +97,21 @@ class PrefixSet {
   // |deltas| using |swap()|.
   PrefixSet(IndexVector* index, std::vector<uint16>* deltas);
 
+  // Helper for |LoadFile()|.  Uses the |index_size| pairs at |index|
+  // and the |deltas_size| deltas at |deltas|, which point into the
+  // mapping of |file|.
+  PrefixSet(scoped_ptr<base::MemoryMappedFile> file,
+            const IndexPair* index, size_t index_size,
+            const uint16* deltas, size_t deltas_size);
+
+  // Points the data members at |index_| and |deltas_|.
+  void UseVectors();
+
+  // Returns |true| if |prefix| is one of the prefixes which start at
+  // |current| and are encoded by the deltas in [|begin|, |end|).
+  bool ScanDeltas(SBPrefix prefix, SBPrefix current,
+                  size_t begin, size_t end) const;
+
   // Top-level index of prefix to offset in |deltas_|.  Each pair
   // indicates a base prefix and where the deltas from that prefix
   // begin in |deltas_|.  The deltas for a pair end at the next pair's
@@ -101,6 +123,17 @@ class PrefixSet {
   // |index_|, or the end of |deltas_| for the last |index_| pair.
   std::vector<uint16> deltas_;
 
+  // The mapped file when the set was loaded from disk, in which case
+  // |index_| and |deltas_| are empty.
+  scoped_ptr<base::MemoryMappedFile> file_;
+
+  // The index and deltas in use, which are either the contents of
+  // |index_| and |deltas_| or live in |file_|.
+  const IndexPair* index_data_;
+  size_t index_size_;
+  const uint16* deltas_data_;
+  size_t deltas_size_;
+
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
 
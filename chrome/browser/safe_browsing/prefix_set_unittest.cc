@@ -13,7 +13,9 @@
 #include "base/md5.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/rand_util.h"
+#include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "testing/platform_test.h"
 
 namespace {
@@ -533,4 +535,54 @@ TEST_F(PrefixSetTest, SizeTRecovery) {
   EXPECT_EQ(prefixes_copy[3], 100065);
 }
 
+// Test that an index offset beyond the deltas is caught even when the
+// checksum is valid, since the loaded set reads the file in place.
+TEST_F(PrefixSetTest, CorruptionIndexOffset) {
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+
+  // The offset of the first index pair.
+  ModifyAndCleanChecksum(filename, kPayloadOffset + sizeof(uint32), 1000000);
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_FALSE(prefix_set.get());
+}
+
+// Time lookups of prefixes in and out of the set, for a set built in
+// memory and for one mapped from a file.
+TEST_F(PrefixSetTest, LookupPerformance) {
+  std::vector<SBPrefix> lookups;
+  for (size_t i = 0; i < shared_prefixes_.size(); ++i) {
+    lookups.push_back(shared_prefixes_[i]);
+    lookups.push_back(static_cast<SBPrefix>(base::RandUint64()));
+  }
+
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+  safe_browsing::PrefixSet built_set(shared_prefixes_);
+  scoped_ptr<safe_browsing::PrefixSet>
+      mapped_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(mapped_set.get());
+
+  const safe_browsing::PrefixSet* sets[] = { &built_set, mapped_set.get() };
+  const char* kTraces[] = { "built", "mapped" };
+  const int kIterations = 50;
+  for (size_t i = 0; i < arraysize(sets); ++i) {
+    size_t found = 0;
+    const base::TimeTicks start = base::TimeTicks::Now();
+    for (int j = 0; j < kIterations; ++j) {
+      for (size_t k = 0; k < lookups.size(); ++k) {
+        if (sets[i]->Exists(lookups[k]))
+          ++found;
+      }
+    }
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    EXPECT_GE(found, kIterations * shared_prefixes_.size());
+    perf_test::PrintResult(
+        "prefix_set_lookups", "", kTraces[i],
+        kIterations * lookups.size() / std::max(elapsed.InSecondsF(), 1e-6),
+        "lookups/s", true);
+  }
+}
+
 }  // namespace
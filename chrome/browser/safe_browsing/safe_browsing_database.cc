@@ -335,6 +335,26 @@ int64 GetFileSizeOrZero(const base::FilePath& file_path) {
   return size_64;
 }
 
+// Returns true if |prefix_set| holds exactly the prefixes of the sorted
+// |prefixes|, which may repeat some of them.
+bool PrefixSetMatches(const safe_browsing::PrefixSet* prefix_set,
+                      const std::vector<SBPrefix>& prefixes) {
+  if (!prefix_set)
+    return false;
+
+  std::vector<SBPrefix> current;
+  prefix_set->GetPrefixes(&current);
+  size_t ci = 0;
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    if (i > 0 && prefixes[i] == prefixes[i - 1])
+      continue;
+    if (ci == current.size() || current[ci] != prefixes[i])
+      return false;
+    ++ci;
+  }
+  return ci == current.size();
+}
+
 }  // namespace
 
 // The default SafeBrowsingDatabaseFactory.
@@ -389,9 +409,33 @@ SafeBrowsingDatabase* SafeBrowsingDatabase::Create(
       enable_ip_blacklist);
 }
 
+SafeBrowsingDatabase::BrowseUrlHits::BrowseUrlHits() : match(false) {
+}
+
+SafeBrowsingDatabase::BrowseUrlHits::~BrowseUrlHits() {
+}
+
 SafeBrowsingDatabase::~SafeBrowsingDatabase() {
 }
 
+bool SafeBrowsingDatabase::ContainsBrowseUrls(
+    const std::vector<GURL>& urls,
+    base::Time last_update,
+    std::vector<BrowseUrlHits>* hits) {
+  hits->clear();
+  hits->resize(urls.size());
+  bool any_match = false;
+  std::string matching_list;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    BrowseUrlHits& url_hits = (*hits)[i];
+    url_hits.match = ContainsBrowseUrl(urls[i], &matching_list,
+                                       &url_hits.prefix_hits,
+                                       &url_hits.full_hits, last_update);
+    any_match |= url_hits.match;
+  }
+  return any_match;
+}
+
 // static
 base::FilePath SafeBrowsingDatabase::BrowseDBFilename(
     const base::FilePath& db_base_filename) {
@@ -655,6 +699,14 @@ void SafeBrowsingDatabaseNew::Init(const base::FilePath& filename_base) {
 bool SafeBrowsingDatabaseNew::ResetDatabase() {
   DCHECK_EQ(creation_loop_, base::MessageLoop::current());
 
+  // The prefix sets map their files, which can't be deleted while they
+  // are mapped on some platforms.
+  {
+    base::AutoLock locked(lookup_lock_);
+    browse_prefix_set_.reset();
+    side_effect_free_whitelist_prefix_set_.reset();
+  }
+
   // Delete files on disk.
   // TODO(shess): Hard to see where one might want to delete without a
   // reset.  Perhaps inline |Delete()|?
@@ -667,8 +719,6 @@ bool SafeBrowsingDatabaseNew::ResetDatabase() {
     full_browse_hashes_.clear();
     pending_browse_hashes_.clear();
     prefix_miss_cache_.clear();
-    browse_prefix_set_.reset();
-    side_effect_free_whitelist_prefix_set_.reset();
     ip_blacklist_.clear();
   }
   // Wants to acquire the lock itself.
@@ -697,6 +747,44 @@ bool SafeBrowsingDatabaseNew::ContainsBrowseUrl(
   // This function is called on the I/O thread, prevent changes to
   // filter and caches.
   base::AutoLock locked(lookup_lock_);
+  return ContainsBrowseHashes(full_hashes, prefix_hits, full_hits,
+                              last_update);
+}
+
+bool SafeBrowsingDatabaseNew::ContainsBrowseUrls(
+    const std::vector<GURL>& urls,
+    base::Time last_update,
+    std::vector<BrowseUrlHits>* hits) {
+  hits->clear();
+  hits->resize(urls.size());
+
+  // Hash the URLs before taking the lock, so that the update thread isn't
+  // kept waiting for it longer than needed.
+  std::vector<std::vector<SBFullHash> > full_hashes(urls.size());
+  for (size_t i = 0; i < urls.size(); ++i)
+    BrowseFullHashesToCheck(urls[i], false, &full_hashes[i]);
+
+  // See ContainsBrowseUrl().
+  base::AutoLock locked(lookup_lock_);
+  bool any_match = false;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    if (full_hashes[i].empty())
+      continue;
+    BrowseUrlHits& url_hits = (*hits)[i];
+    url_hits.match = ContainsBrowseHashes(full_hashes[i],
+                                          &url_hits.prefix_hits,
+                                          &url_hits.full_hits, last_update);
+    any_match |= url_hits.match;
+  }
+  return any_match;
+}
+
+bool SafeBrowsingDatabaseNew::ContainsBrowseHashes(
+    const std::vector<SBFullHash>& full_hashes,
+    std::vector<SBPrefix>* prefix_hits,
+    std::vector<SBFullHashResult>* full_hits,
+    base::Time last_update) {
+  lookup_lock_.AssertAcquired();
 
   // |browse_prefix_set_| is empty until it is either read from disk, or the
   // first update populates it.  Bail out without a hit if not yet
@@ -1440,8 +1528,16 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
   }
 
   std::sort(prefixes.begin(), prefixes.end());
-  scoped_ptr<safe_browsing::PrefixSet>
-      prefix_set(new safe_browsing::PrefixSet(prefixes));
+
+  // Most updates leave the prefixes as they were, in which case the
+  // current set is kept, and so is its file.
+  scoped_ptr<safe_browsing::PrefixSet> prefix_set;
+  const bool prefixes_unchanged =
+      PrefixSetMatches(browse_prefix_set_.get(), prefixes) &&
+      base::PathExists(browse_prefix_set_filename_);
+  UMA_HISTOGRAM_BOOLEAN("SB2.PrefixSetUnchanged", prefixes_unchanged);
+  if (!prefixes_unchanged)
+    prefix_set.reset(new safe_browsing::PrefixSet(prefixes));
 
   // This needs to be in sorted order by prefix for efficient access.
   std::sort(add_full_hashes.begin(), add_full_hashes.end(),
@@ -1459,9 +1555,13 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     // hash will be fetched again).
     pending_browse_hashes_.clear();
     prefix_miss_cache_.clear();
-    browse_prefix_set_.swap(prefix_set);
+    if (!prefixes_unchanged)
+      browse_prefix_set_.swap(prefix_set);
   }
 
+  // The old set may map the file which is about to be rewritten.
+  prefix_set.reset();
+
   DVLOG(1) << "SafeBrowsingDatabaseImpl built prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds()
            << " ms total.  prefix count: " << add_prefixes.size();
@@ -1469,7 +1569,8 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
 
   // Persist the prefix set to disk.  Since only this thread changes
   // |browse_prefix_set_|, there is no need to lock.
-  WritePrefixSet();
+  if (!prefixes_unchanged)
+    WritePrefixSet();
 
   // Gather statistics.
   if (got_counters && metric->GetIOCounters(&io_after)) {
@@ -1533,6 +1634,9 @@ void SafeBrowsingDatabaseNew::UpdateSideEffectFreeWhitelistStore() {
     side_effect_free_whitelist_prefix_set_.swap(prefix_set);
   }
 
+  // The old set may map the file which is about to be rewritten.
+  prefix_set.reset();
+
   const base::TimeTicks before = base::TimeTicks::Now();
   const bool write_ok = side_effect_free_whitelist_prefix_set_->WriteFile(
       side_effect_free_whitelist_prefix_set_filename_);
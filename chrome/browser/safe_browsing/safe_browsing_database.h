@@ -62,6 +62,17 @@ class SafeBrowsingDatabaseFactory {
 // thread that it was created on.
 class SafeBrowsingDatabase {
  public:
+  // Results of looking a URL up in the browse database, as returned by
+  // ContainsBrowseUrls().
+  struct BrowseUrlHits {
+    BrowseUrlHits();
+    ~BrowseUrlHits();
+
+    bool match;
+    std::vector<SBPrefix> prefix_hits;
+    std::vector<SBFullHashResult> full_hits;
+  };
+
   // Factory method for obtaining a SafeBrowsingDatabase implementation.
   // It is not thread safe.
   // |enable_download_protection| is used to control the download database
@@ -104,6 +115,15 @@ class SafeBrowsingDatabase {
                                  std::vector<SBFullHashResult>* full_hits,
                                  base::Time last_update) = 0;
 
+  // Looks each of |urls| up the way ContainsBrowseUrl() does, and fills
+  // |hits| with a result for each of them, in the same order.  Returns true if
+  // any of them is in the browse database.  This lets the IO thread check all
+  // the URLs it has at hand at once rather than one at a time.  This function
+  // is safe to call from threads other than the creation thread.
+  virtual bool ContainsBrowseUrls(const std::vector<GURL>& urls,
+                                  base::Time last_update,
+                                  std::vector<BrowseUrlHits>* hits);
+
   // Returns false if none of |urls| are in Download database. If it returns
   // true, |prefix_hits| should contain the prefixes for the URLs that were in
   // the database.  This function could ONLY be accessed from creation thread.
@@ -299,6 +319,9 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
                                  std::vector<SBPrefix>* prefix_hits,
                                  std::vector<SBFullHashResult>* full_hits,
                                  base::Time last_update) OVERRIDE;
+  virtual bool ContainsBrowseUrls(const std::vector<GURL>& urls,
+                                  base::Time last_update,
+                                  std::vector<BrowseUrlHits>* hits) OVERRIDE;
   virtual bool ContainsDownloadUrl(const std::vector<GURL>& urls,
                                    std::vector<SBPrefix>* prefix_hits) OVERRIDE;
   virtual bool ContainsDownloadHashPrefix(const SBPrefix& prefix) OVERRIDE;
@@ -338,6 +361,13 @@ class SafeBrowsingDatabaseNew : public SafeBrowsingDatabase {
   // IPv6 IP prefix using SHA-1.
   typedef std::map<std::string, base::hash_set<std::string> > IPBlacklist;
 
+  // Looks the browse |full_hashes| of a URL up for ContainsBrowseUrl() and
+  // ContainsBrowseUrls().  |lookup_lock_| must be held.
+  bool ContainsBrowseHashes(const std::vector<SBFullHash>& full_hashes,
+                            std::vector<SBPrefix>* prefix_hits,
+                            std::vector<SBFullHashResult>* full_hits,
+                            base::Time last_update);
+
   // Returns true if the whitelist is disabled or if any of the given hashes
   // matches the whitelist.
   bool ContainsWhitelistedHashes(const SBWhitelist& whitelist,
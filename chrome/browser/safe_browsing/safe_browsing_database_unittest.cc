@@ -597,6 +597,27 @@ TEST_F(SafeBrowsingDatabaseTest, BrowseDatabase) {
       &matching_list, &prefix_hits,
       &full_hashes, now));
 
+  // Checking the URLs at once gives the same results.
+  std::vector<GURL> urls;
+  urls.push_back(GURL("http://www.evil.com/phishing.html"));
+  urls.push_back(GURL("http://www.evil.com/robots.txt"));
+  urls.push_back(GURL("http://192.168.0.1/malware.html"));
+  std::vector<SafeBrowsingDatabase::BrowseUrlHits> hits;
+  EXPECT_TRUE(database_->ContainsBrowseUrls(urls, now, &hits));
+  ASSERT_EQ(urls.size(), hits.size());
+  EXPECT_TRUE(hits[0].match);
+  ASSERT_EQ(1U, hits[0].prefix_hits.size());
+  EXPECT_EQ(Sha256Prefix("www.evil.com/phishing.html"),
+            hits[0].prefix_hits[0]);
+  EXPECT_FALSE(hits[1].match);
+  EXPECT_TRUE(hits[2].match);
+
+  urls.erase(urls.begin() + 2);
+  urls.erase(urls.begin());
+  EXPECT_FALSE(database_->ContainsBrowseUrls(urls, now, &hits));
+  ASSERT_EQ(1U, hits.size());
+  EXPECT_FALSE(hits[0].match);
+
   // Attempt to re-add the first chunk (should be a no-op).
   // see bug: http://code.google.com/p/chromium/issues/detail?id=4522
   chunk.hosts.clear();
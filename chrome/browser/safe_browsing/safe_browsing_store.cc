@@ -103,6 +103,17 @@ void RemoveMatchingPrefixes(const AddsT& removes, HashesT* full_hashes) {
   full_hashes->erase(out, hash_iter);
 }
 
+// Sort |items| using |less|, unless they are sorted already.
+template <typename ItemsT, typename LessT>
+void SortIfNeeded(ItemsT* items, LessT less) {
+  for (size_t i = 1; i < items->size(); ++i) {
+    if (less((*items)[i], (*items)[i - 1])) {
+      std::sort(items->begin(), items->end(), less);
+      return;
+    }
+  }
+}
+
 // Remove deleted items (|chunk_id| in |del_set|) from the container.
 template <typename ItemsT>
 void RemoveDeleted(ItemsT* items, const base::hash_set<int32>& del_set) {
@@ -134,14 +145,12 @@ void SBProcessSubs(SBAddPrefixes* add_prefixes,
   // clear how things are working.
 
   // Sort the inputs by the SBAddPrefix bits.
-  std::sort(add_prefixes->begin(), add_prefixes->end(),
-            SBAddPrefixLess<SBAddPrefix,SBAddPrefix>);
-  std::sort(sub_prefixes->begin(), sub_prefixes->end(),
-            SBAddPrefixLess<SBSubPrefix,SBSubPrefix>);
-  std::sort(add_full_hashes->begin(), add_full_hashes->end(),
-            SBAddPrefixHashLess<SBAddFullHash,SBAddFullHash>);
-  std::sort(sub_full_hashes->begin(), sub_full_hashes->end(),
-            SBAddPrefixHashLess<SBSubFullHash,SBSubFullHash>);
+  SortIfNeeded(add_prefixes, SBAddPrefixLess<SBAddPrefix,SBAddPrefix>);
+  SortIfNeeded(sub_prefixes, SBAddPrefixLess<SBSubPrefix,SBSubPrefix>);
+  SortIfNeeded(add_full_hashes,
+               SBAddPrefixHashLess<SBAddFullHash,SBAddFullHash>);
+  SortIfNeeded(sub_full_hashes,
+               SBAddPrefixHashLess<SBSubFullHash,SBSubFullHash>);
 
   // Factor out the prefix subs.
   SBAddPrefixes removed_adds;
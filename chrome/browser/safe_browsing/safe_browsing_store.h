@@ -136,9 +136,9 @@ bool SBAddPrefixHashLess(const T& a, const U& b) {
 // TODO(shess): Since the prefixes are uniformly-distributed hashes,
 // there aren't many ways to organize the inputs for efficient
 // processing.  For this reason, the vectors are sorted and processed
-// in parallel.  At this time this code does the sorting internally,
-// but it might make sense to make sorting an API requirement so that
-// the storage can optimize for it.
+// in parallel.  This code sorts the vectors which aren't sorted
+// already, so storage which keeps its data sorted only pays for a
+// check.
 void SBProcessSubs(SBAddPrefixes* add_prefixes,
                    SBSubPrefixes* sub_prefixes,
                    std::vector<SBAddFullHash>* add_full_hashes,
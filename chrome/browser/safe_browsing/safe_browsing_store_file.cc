@@ -4,6 +4,8 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
 
@@ -129,6 +131,16 @@ void DeleteChunksFromSet(const base::hash_set<int32>& deleted,
   }
 }
 
+// Sort the items of |items| which follow the first |sorted_count|,
+// which are sorted already, and merge the two runs.
+template <typename ItemsT, typename LessT>
+void MergeSortedRun(ItemsT* items, size_t sorted_count, LessT less) {
+  DCHECK_LE(sorted_count, items->size());
+  const typename ItemsT::iterator middle = items->begin() + sorted_count;
+  std::sort(middle, items->end(), less);
+  std::inplace_merge(items->begin(), middle, items->end(), less);
+}
+
 // Sanity-check the header against the file's size to make sure our
 // vectors aren't gigantic.  This doubles as a cheap way to detect
 // corruption without having to checksum the entire file.
@@ -488,6 +500,10 @@ bool SafeBrowsingStoreFile::DoUpdate(
   std::vector<SBAddFullHash> add_full_hashes;
   std::vector<SBSubFullHash> sub_full_hashes;
 
+  // The chunk counts of |file_|.
+  size_t stored_add_chunk_count = 0;
+  size_t stored_sub_chunk_count = 0;
+
   // Read original data into the vectors.
   if (!empty_) {
     DCHECK(file_.get());
@@ -502,6 +518,8 @@ bool SafeBrowsingStoreFile::DoUpdate(
     FileHeader header;
     if (!ReadAndVerifyHeader(filename_, file_.get(), &header, &context))
       return OnCorruptDatabase();
+    stored_add_chunk_count = header.add_chunk_count;
+    stored_sub_chunk_count = header.sub_chunk_count;
 
     // Re-read the chunks-seen data to get to the later data in the
     // file and calculate the checksum.  No new elements should be
@@ -541,6 +559,29 @@ bool SafeBrowsingStoreFile::DoUpdate(
   }
   DCHECK(!file_.get());
 
+  // The data of |file_| was written sorted, and so are these prefixes
+  // of the vectors.
+  const size_t stored_add_prefix_count = add_prefixes.size();
+  const size_t stored_sub_prefix_count = sub_prefixes.size();
+  const size_t stored_add_hash_count = add_full_hashes.size();
+  const size_t stored_sub_hash_count = sub_full_hashes.size();
+
+  // Updates which bring nothing new are common.  The file already holds
+  // the processed data then, so there is no need to rewrite it.
+  const bool unchanged = !empty_ && !chunks_written_ && pending_adds.empty() &&
+      add_del_cache_.empty() && sub_del_cache_.empty() &&
+      add_chunks_cache_.size() == stored_add_chunk_count &&
+      sub_chunks_cache_.size() == stored_sub_chunk_count;
+  UMA_HISTOGRAM_BOOLEAN("SB2.DatabaseUpdateUnchanged", unchanged);
+  if (unchanged) {
+    new_file_.reset();
+    base::DeleteFile(TemporaryFileForFilename(filename_), false);
+
+    add_prefixes_result->swap(add_prefixes);
+    add_full_hashes_result->swap(add_full_hashes);
+    return true;
+  }
+
   // Rewind the temporary storage.
   if (!FileRewind(new_file_.get()))
     return false;
@@ -577,13 +618,6 @@ bool SafeBrowsingStoreFile::DoUpdate(
     if (expected_size > size)
       return false;
 
-    // TODO(shess): If the vectors were kept sorted, then this code
-    // could use std::inplace_merge() to merge everything together in
-    // sorted order.  That might still be slower than just sorting at
-    // the end if there were a large number of chunks.  In that case
-    // some sort of recursive binary merge might be in order (merge
-    // chunks pairwise, merge those chunks pairwise, and so on, then
-    // merge the result with the main list).
     if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
                          new_file_.get(), NULL) ||
         !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
@@ -599,6 +633,18 @@ bool SafeBrowsingStoreFile::DoUpdate(
   add_full_hashes.insert(add_full_hashes.end(),
                          pending_adds.begin(), pending_adds.end());
 
+  // Only sort the items of this update, which are usually few, and
+  // merge them into the sorted data of |file_|, so that
+  // |SBProcessSubs()| finds everything in order.
+  MergeSortedRun(&add_prefixes, stored_add_prefix_count,
+                 SBAddPrefixLess<SBAddPrefix,SBAddPrefix>);
+  MergeSortedRun(&sub_prefixes, stored_sub_prefix_count,
+                 SBAddPrefixLess<SBSubPrefix,SBSubPrefix>);
+  MergeSortedRun(&add_full_hashes, stored_add_hash_count,
+                 SBAddPrefixHashLess<SBAddFullHash,SBAddFullHash>);
+  MergeSortedRun(&sub_full_hashes, stored_sub_hash_count,
+                 SBAddPrefixHashLess<SBSubFullHash,SBSubFullHash>);
+
   // Knock the subs from the adds and process deleted chunks.
   SBProcessSubs(&add_prefixes, &sub_prefixes,
                 &add_full_hashes, &sub_full_hashes,
@@ -53,6 +53,10 @@
 // }
 // MD5Digest checksum;      // Checksum over preceeding data.
 //
+// The prefix and hash arrays are sorted by SBAddPrefixLess() and
+// SBAddPrefixHashLess() respectively, so that updates only sort their
+// own data and merge it in.
+//
 // During the course of an update, uncommitted data is stored in a
 // temporary file (which is later re-used to commit).  This is an
 // array of chunks, with the count kept in memory until the end of the
@@ -91,7 +95,10 @@
 // - Write new chunks to the temp file.
 // - When the transaction is finished:
 //   - Read the rest of the original file's data into buffers.
-//   - Rewind the temp file and merge the new data into buffers.
+//   - If the update brought nothing new, stop there and keep the
+//     original file.
+//   - Rewind the temp file, sort the new data and merge it into the
+//     buffers.
 //   - Process buffers for deletions and apply subs.
 //   - Rewind and write the buffers out to temp file.
 //   - Delete original file.
@@ -187,4 +187,79 @@ TEST_F(SafeBrowsingStoreFileTest, CheckValidityChecksum) {
   EXPECT_TRUE(store_->CancelUpdate());
 }
 
+// Test that an update which brings nothing new leaves the file alone.
+TEST_F(SafeBrowsingStoreFileTest, UnchangedUpdateKeepsFile) {
+  SafeBrowsingStoreTestStorePrefix(store_.get());
+  const base::Time old_time =
+      base::Time::Now() - base::TimeDelta::FromDays(1);
+  ASSERT_TRUE(base::TouchFile(filename_, old_time, old_time));
+  base::File::Info before_info;
+  ASSERT_TRUE(base::GetFileInfo(filename_, &before_info));
+
+  std::vector<SBAddFullHash> pending_adds;
+  SBAddPrefixes add_prefixes;
+  std::vector<SBAddFullHash> add_hashes;
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, &add_prefixes, &add_hashes));
+  EXPECT_EQ(2U, add_prefixes.size());
+  EXPECT_EQ(1U, add_hashes.size());
+
+  base::File::Info after_info;
+  ASSERT_TRUE(base::GetFileInfo(filename_, &after_info));
+  EXPECT_EQ(before_info.last_modified, after_info.last_modified);
+  EXPECT_FALSE(base::PathExists(
+      SafeBrowsingStoreFile::TemporaryFileForFilename(filename_)));
+
+  // Seeing a new chunk, even an empty one, rewrites the file.
+  ASSERT_TRUE(store_->BeginUpdate());
+  store_->SetAddChunk(100);
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, &add_prefixes, &add_hashes));
+  ASSERT_TRUE(base::GetFileInfo(filename_, &after_info));
+  EXPECT_NE(before_info.last_modified, after_info.last_modified);
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->CheckAddChunk(100));
+  EXPECT_TRUE(store_->CancelUpdate());
+}
+
+// Test that the data of an update is merged in order into the data
+// already stored.
+TEST_F(SafeBrowsingStoreFileTest, MergesUpdateInOrder) {
+  std::vector<SBAddFullHash> pending_adds;
+  SBAddPrefixes add_prefixes;
+  std::vector<SBAddFullHash> add_hashes;
+
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(5);
+  EXPECT_TRUE(store_->WriteAddPrefix(5, 30));
+  EXPECT_TRUE(store_->WriteAddPrefix(5, 10));
+  EXPECT_TRUE(store_->FinishChunk());
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, &add_prefixes, &add_hashes));
+
+  ASSERT_TRUE(store_->BeginUpdate());
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(7);
+  EXPECT_TRUE(store_->WriteAddPrefix(7, 1));
+  EXPECT_TRUE(store_->FinishChunk());
+  EXPECT_TRUE(store_->BeginChunk());
+  store_->SetAddChunk(3);
+  EXPECT_TRUE(store_->WriteAddPrefix(3, 50));
+  EXPECT_TRUE(store_->WriteAddPrefix(3, 20));
+  EXPECT_TRUE(store_->FinishChunk());
+  EXPECT_TRUE(store_->FinishUpdate(pending_adds, &add_prefixes, &add_hashes));
+
+  const SBAddPrefix kExpected[] = {
+    SBAddPrefix(3, 20),
+    SBAddPrefix(3, 50),
+    SBAddPrefix(5, 10),
+    SBAddPrefix(5, 30),
+    SBAddPrefix(7, 1),
+  };
+  ASSERT_EQ(arraysize(kExpected), add_prefixes.size());
+  for (size_t i = 0; i < arraysize(kExpected); ++i) {
+    EXPECT_EQ(kExpected[i].chunk_id, add_prefixes[i].chunk_id);
+    EXPECT_EQ(kExpected[i].prefix, add_prefixes[i].prefix);
+  }
+}
+
 }  // namespace
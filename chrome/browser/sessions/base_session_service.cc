@@ -135,7 +135,14 @@ void BaseSessionService::Save() {
   if (pending_reset_) {
     commands_since_reset_ = 0;
     pending_reset_ = false;
+  } else if (!pending_compaction_.is_null()) {
+    RunTaskOnBackendThread(
+        FROM_HERE,
+        base::Bind(&SessionBackend::CompactCurrentSession, backend(),
+                   pending_compaction_));
+    commands_since_reset_ = 0;
   }
+  pending_compaction_.Reset();
 }
 
 SessionCommand* BaseSessionService::CreateUpdateTabNavigationCommand(
@@ -57,6 +57,11 @@ class BaseSessionService : public CancelableRequestProvider {
   typedef base::Callback<void(ScopedVector<SessionCommand>)>
       InternalGetCommandsCallback;
 
+  // Removes, and deletes, the commands of |commands| which don't change what
+  // they restore to. Run on the backend thread to compact the current file.
+  typedef base::Callback<void(std::vector<SessionCommand*>* commands)>
+      CompactCommandsCallback;
+
  protected:
   virtual ~BaseSessionService();
 
@@ -74,7 +79,17 @@ class BaseSessionService : public CancelableRequestProvider {
   void set_pending_reset(bool value) { pending_reset_ = value; }
   bool pending_reset() const { return pending_reset_; }
 
-  // Returns the number of commands sent down since the last reset.
+  // Whether the next save compacts the file after writing to it, by reading
+  // its commands back on the backend thread and rewriting what |compact|
+  // leaves of them. This bounds the size of the file like a reset does,
+  // without building the state to write on the UI thread.
+  void set_pending_compaction(const CompactCommandsCallback& compact) {
+    pending_compaction_ = compact;
+  }
+  bool pending_compaction() const { return !pending_compaction_.is_null(); }
+
+  // Returns the number of commands sent down since the last reset or
+  // compaction.
   int commands_since_reset() const { return commands_since_reset_; }
 
   // Schedules a command. This adds |command| to pending_commands_ and
@@ -182,6 +197,10 @@ class BaseSessionService : public CancelableRequestProvider {
   // over the commands.
   bool pending_reset_;
 
+  // If not null, the backend file is compacted with it after the commands are
+  // next sent over.
+  CompactCommandsCallback pending_compaction_;
+
   // The number of commands sent to the backend before doing a reset.
   int commands_since_reset_;
 
@@ -304,6 +304,41 @@ bool SessionBackend::ReadCurrentSessionCommandsImpl(
   return file_reader.Read(type_, commands);
 }
 
+void SessionBackend::CompactCurrentSession(
+    const BaseSessionService::CompactCommandsCallback& compact) {
+  Init();
+  if (empty_file_ || !current_session_file_.get() ||
+      !current_session_file_->IsOpen()) {
+    return;
+  }
+
+  // The file is opened for exclusive access, so close it to read it back.
+  current_session_file_.reset(NULL);
+  TimeTicks start_time = TimeTicks::Now();
+  ScopedVector<SessionCommand> commands;
+  size_t command_count = 0;
+  if (ReadCurrentSessionCommandsImpl(&(commands.get()))) {
+    command_count = commands.size();
+    compact.Run(&(commands.get()));
+  }
+  if (commands.size() == command_count) {
+    // Nothing to drop, or the file couldn't be read. Keep appending to it.
+    current_session_file_.reset(OpenForAppend(GetCurrentSessionPath()));
+    return;
+  }
+
+  ResetFile();
+  if (current_session_file_.get() && current_session_file_->IsOpen() &&
+      !AppendCommandsToFile(current_session_file_.get(), commands.get())) {
+    current_session_file_.reset(NULL);
+  }
+  empty_file_ = commands.empty();
+  if (type_ == BaseSessionService::SESSION_RESTORE) {
+    UMA_HISTOGRAM_TIMES("SessionRestore.compact_session_file_time",
+                        TimeTicks::Now() - start_time);
+  }
+}
+
 bool SessionBackend::AppendCommandsToFile(net::FileStream* file,
     const std::vector<SessionCommand*>& commands) {
   for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
@@ -388,6 +423,17 @@ net::FileStream* SessionBackend::OpenAndWriteHeader(
   return file.release();
 }
 
+net::FileStream* SessionBackend::OpenForAppend(const base::FilePath& path) {
+  scoped_ptr<net::FileStream> file(new net::FileStream(NULL));
+  if (file->OpenSync(path, base::PLATFORM_FILE_OPEN |
+      base::PLATFORM_FILE_WRITE | base::PLATFORM_FILE_EXCLUSIVE_WRITE |
+      base::PLATFORM_FILE_EXCLUSIVE_READ) != net::OK ||
+      file->SeekSync(net::FROM_END, 0) < 0) {
+    return NULL;
+  }
+  return file.release();
+}
+
 base::FilePath SessionBackend::GetLastSessionPath() {
   base::FilePath path = path_to_dir_;
   if (type_ == BaseSessionService::TAB_RESTORE)
@@ -90,6 +90,12 @@ class SessionBackend : public base::RefCountedThreadSafe<SessionBackend> {
   // caller to delete the commands.
   bool ReadCurrentSessionCommandsImpl(std::vector<SessionCommand*>* commands);
 
+  // Reads the commands back from the current file and, if |compact| removes
+  // some of them, rewrites the file with the rest. Commands appended later
+  // go after them.
+  void CompactCurrentSession(
+      const BaseSessionService::CompactCommandsCallback& compact);
+
  private:
   friend class base::RefCountedThreadSafe<SessionBackend>;
 
@@ -107,6 +113,10 @@ class SessionBackend : public base::RefCountedThreadSafe<SessionBackend> {
   // the file is returned.
   net::FileStream* OpenAndWriteHeader(const base::FilePath& path);
 
+  // Opens the existing file at |path| to append commands to it. On success a
+  // handle to the file is returned.
+  net::FileStream* OpenForAppend(const base::FilePath& path);
+
   // Appends the specified commands to the specified file.
   bool AppendCommandsToFile(net::FileStream* file,
                             const std::vector<SessionCommand*>& commands);
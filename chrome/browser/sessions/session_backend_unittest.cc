@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/stl_util.h"
@@ -28,6 +29,18 @@ SessionCommand* CreateCommandFromData(const TestData& data) {
   return command;
 }
 
+// Removes, and deletes, the commands with an id of 1.
+void RemoveFirstKind(SessionCommands* commands) {
+  SessionCommands kept_commands;
+  for (size_t i = 0; i < commands->size(); ++i) {
+    if ((*commands)[i]->id() == 1)
+      delete (*commands)[i];
+    else
+      kept_commands.push_back((*commands)[i]);
+  }
+  commands->swap(kept_commands);
+}
+
 }  // namespace
 
 class SessionBackendTest : public testing::Test {
@@ -201,3 +214,37 @@ TEST_F(SessionBackendTest, Truncate) {
 
   STLDeleteElements(&commands);
 }
+
+// Compacts the current file, then appends to it, making sure both the
+// commands left by the compaction and the ones after it are read back.
+TEST_F(SessionBackendTest, Compact) {
+  scoped_refptr<SessionBackend> backend(
+      new SessionBackend(BaseSessionService::SESSION_RESTORE, path_));
+  struct TestData data[] = {
+    { 1,  "a" },
+    { 2,  "b" },
+    { 1,  "c" },
+    { 3,  "d" },
+  };
+  std::vector<SessionCommand*> commands;
+  for (size_t i = 0; i < 3; ++i)
+    commands.push_back(CreateCommandFromData(data[i]));
+  backend->AppendCommands(new SessionCommands(commands), false);
+  commands.clear();
+
+  backend->CompactCurrentSession(base::Bind(&RemoveFirstKind));
+  commands.push_back(CreateCommandFromData(data[3]));
+  backend->AppendCommands(new SessionCommands(commands), false);
+  commands.clear();
+
+  // Nothing to remove, so this keeps the file as it is.
+  backend->CompactCurrentSession(base::Bind(&RemoveFirstKind));
+
+  backend = NULL;
+  backend = new SessionBackend(BaseSessionService::SESSION_RESTORE, path_);
+  backend->ReadLastSessionCommandsImpl(&commands);
+  ASSERT_EQ(2U, commands.size());
+  AssertCommandEqualsData(data[1], commands[0]);
+  AssertCommandEqualsData(data[3], commands[1]);
+  STLDeleteElements(&commands);
+}
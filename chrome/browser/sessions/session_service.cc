@@ -5,6 +5,7 @@
 #include "chrome/browser/sessions/session_service.h"
 
 #include <algorithm>
+#include <limits>
 #include <set>
 #include <utility>
 #include <vector>
@@ -83,7 +84,7 @@ static const SessionCommand::id_type kCommandSetTabUserAgentOverride = 18;
 static const SessionCommand::id_type kCommandSessionStorageAssociated = 19;
 static const SessionCommand::id_type kCommandSetActiveWindow = 20;
 
-// Every kWritesPerReset commands triggers recreating the file.
+// Every kWritesPerReset commands triggers compacting the file.
 static const int kWritesPerReset = 250;
 
 namespace {
@@ -179,6 +180,234 @@ bool MigrateClosedPayload(const SessionCommand& command,
 #endif
 }
 
+// What a command changes, for CompactSessionCommands().
+struct CommandTarget {
+  enum Type {
+    // Set a field of a tab, of a window or of the session, which the next
+    // command of the same kind for it sets again.
+    SET_TAB_FIELD,
+    SET_WINDOW_FIELD,
+    SET_SESSION_FIELD,
+    // Sets the navigation at |index| of a tab, until a prune from the front
+    // moves the navigations of the tab.
+    UPDATE_NAVIGATION,
+    PRUNE_NAVIGATIONS_FROM_BACK,
+    PRUNE_NAVIGATIONS_FROM_FRONT,
+    CLOSE_TAB,
+    CLOSE_WINDOW,
+  };
+
+  Type type;
+  // The kind of field set, for the SET_ types.
+  SessionCommand::id_type field;
+  // The tab or window.
+  SessionID::id_type id;
+  int index;
+};
+
+// Reads the id at the start of the pickled payload of |command|, and checks
+// that a string follows it if |has_string|.
+bool ReadPickledId(const SessionCommand& command,
+                   bool has_string,
+                   SessionID::id_type* id) {
+  scoped_ptr<Pickle> pickle(command.PayloadAsPickle());
+  PickleIterator iterator(*pickle);
+  std::string value;
+  return pickle->ReadInt(&iterator, id) &&
+      (!has_string || pickle->ReadString(&iterator, &value));
+}
+
+// Fills in |target| for |command|, reading it like CreateTabsAndWindows().
+// Returns false if the command can't be read.
+bool GetCommandTarget(const SessionCommand& command, CommandTarget* target) {
+  const SessionCommand::id_type kCommandSetWindowBounds2 = 10;
+
+  target->field = command.id();
+  target->index = 0;
+  switch (command.id()) {
+    case kCommandSetTabWindow: {
+      SessionID::id_type payload[2];
+      if (!command.GetPayload(payload, sizeof(payload)))
+        return false;
+      target->type = CommandTarget::SET_TAB_FIELD;
+      target->id = payload[1];
+      return true;
+    }
+
+    case kCommandSetWindowBounds2: {
+      WindowBoundsPayload2 payload;
+      if (!command.GetPayload(&payload, sizeof(payload)))
+        return false;
+      // Both kinds of bounds set the same fields.
+      target->type = CommandTarget::SET_WINDOW_FIELD;
+      target->field = kCommandSetWindowBounds3;
+      target->id = payload.window_id;
+      return true;
+    }
+
+    case kCommandSetWindowBounds3: {
+      WindowBoundsPayload3 payload;
+      if (!command.GetPayload(&payload, sizeof(payload)))
+        return false;
+      target->type = CommandTarget::SET_WINDOW_FIELD;
+      target->id = payload.window_id;
+      return true;
+    }
+
+    case kCommandTabClosedObsolete:
+    case kCommandWindowClosedObsolete:
+    case kCommandTabClosed:
+    case kCommandWindowClosed: {
+      ClosedPayload payload;
+      if (!command.GetPayload(&payload, sizeof(payload)) &&
+          !MigrateClosedPayload(command, &payload)) {
+        return false;
+      }
+      target->type = (command.id() == kCommandTabClosed ||
+                      command.id() == kCommandTabClosedObsolete) ?
+          CommandTarget::CLOSE_TAB : CommandTarget::CLOSE_WINDOW;
+      target->id = payload.id;
+      return true;
+    }
+
+    case kCommandSetTabIndexInWindow:
+    case kCommandTabNavigationPathPrunedFromBack:
+    case kCommandTabNavigationPathPrunedFromFront:
+    case kCommandSetSelectedNavigationIndex:
+    case kCommandSetSelectedTabInIndex:
+    case kCommandSetWindowType: {
+      IDAndIndexPayload payload;
+      if (!command.GetPayload(&payload, sizeof(payload)))
+        return false;
+      target->id = payload.id;
+      target->index = payload.index;
+      if (command.id() == kCommandTabNavigationPathPrunedFromBack) {
+        target->type = CommandTarget::PRUNE_NAVIGATIONS_FROM_BACK;
+      } else if (command.id() == kCommandTabNavigationPathPrunedFromFront) {
+        target->type = CommandTarget::PRUNE_NAVIGATIONS_FROM_FRONT;
+        return payload.index > 0;
+      } else if (command.id() == kCommandSetSelectedTabInIndex ||
+                 command.id() == kCommandSetWindowType) {
+        target->type = CommandTarget::SET_WINDOW_FIELD;
+      } else {
+        target->type = CommandTarget::SET_TAB_FIELD;
+      }
+      return true;
+    }
+
+    case kCommandUpdateTabNavigation: {
+      scoped_ptr<Pickle> pickle(command.PayloadAsPickle());
+      PickleIterator iterator(*pickle);
+      if (!pickle->ReadInt(&iterator, &target->id) ||
+          !pickle->ReadInt(&iterator, &target->index)) {
+        return false;
+      }
+      target->type = CommandTarget::UPDATE_NAVIGATION;
+      return true;
+    }
+
+    case kCommandSetPinnedState: {
+      PinnedStatePayload payload;
+      if (!command.GetPayload(&payload, sizeof(payload)))
+        return false;
+      target->type = CommandTarget::SET_TAB_FIELD;
+      target->id = payload.tab_id;
+      return true;
+    }
+
+    case kCommandSetWindowAppName:
+      target->type = CommandTarget::SET_WINDOW_FIELD;
+      return ReadPickledId(command, true, &target->id);
+
+    case kCommandSetExtensionAppID:
+    case kCommandSetTabUserAgentOverride:
+    case kCommandSessionStorageAssociated:
+      target->type = CommandTarget::SET_TAB_FIELD;
+      return ReadPickledId(command, true, &target->id);
+
+    case kCommandSetActiveWindow: {
+      ActiveWindowPayload payload;
+      if (!command.GetPayload(&payload, sizeof(payload)))
+        return false;
+      target->type = CommandTarget::SET_SESSION_FIELD;
+      target->id = 0;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+// Removes, and deletes, the commands which don't change what |commands|
+// restore to, because a later command sets again what they set, or closes
+// the tab or window they are about. The rest keep their order. Runs on the
+// backend thread.
+void CompactSessionCommands(std::vector<SessionCommand*>* commands) {
+  std::vector<CommandTarget> targets(commands->size());
+  for (size_t i = 0; i < commands->size(); ++i) {
+    // Restoring stops at the first command it can't read, so dropping
+    // commands before one could change what is restored.
+    if (!GetCommandTarget(*(*commands)[i], &targets[i]))
+      return;
+  }
+
+  // Walking back from the last command, what the commands seen so far set.
+  typedef std::pair<SessionCommand::id_type, SessionID::id_type> Field;
+  typedef std::pair<SessionID::id_type, int> Navigation;
+  std::set<Field> set_fields;
+  std::set<Navigation> set_navigations;
+  std::set<SessionID::id_type> closed_tabs;
+  std::set<SessionID::id_type> closed_windows;
+
+  std::vector<SessionCommand*> kept_commands;
+  for (size_t i = commands->size(); i-- > 0;) {
+    const CommandTarget& target = targets[i];
+    bool keep = false;
+    switch (target.type) {
+      case CommandTarget::SET_TAB_FIELD:
+        keep = !closed_tabs.count(target.id) &&
+            set_fields.insert(Field(target.field, target.id)).second;
+        break;
+      case CommandTarget::SET_WINDOW_FIELD:
+        keep = !closed_windows.count(target.id) &&
+            set_fields.insert(Field(target.field, target.id)).second;
+        break;
+      case CommandTarget::SET_SESSION_FIELD:
+        keep = set_fields.insert(Field(target.field, target.id)).second;
+        break;
+      case CommandTarget::UPDATE_NAVIGATION:
+        keep = !closed_tabs.count(target.id) &&
+            set_navigations.insert(Navigation(target.id, target.index)).second;
+        break;
+      case CommandTarget::PRUNE_NAVIGATIONS_FROM_BACK:
+        keep = !closed_tabs.count(target.id);
+        break;
+      case CommandTarget::PRUNE_NAVIGATIONS_FROM_FRONT:
+        keep = !closed_tabs.count(target.id);
+        // The navigations set before this had other indices.
+        set_navigations.erase(
+            set_navigations.lower_bound(
+                Navigation(target.id, std::numeric_limits<int>::min())),
+            set_navigations.upper_bound(
+                Navigation(target.id, std::numeric_limits<int>::max())));
+        break;
+      case CommandTarget::CLOSE_TAB:
+        // Nothing before the close is left of the tab for it to remove.
+        closed_tabs.insert(target.id);
+        break;
+      case CommandTarget::CLOSE_WINDOW:
+        closed_windows.insert(target.id);
+        break;
+    }
+    if (keep)
+      kept_commands.push_back((*commands)[i]);
+    else
+      delete (*commands)[i];
+  }
+  commands->assign(kept_commands.rbegin(), kept_commands.rend());
+}
+
 }  // namespace
 
 // SessionService -------------------------------------------------------------
@@ -1480,11 +1709,12 @@ void SessionService::ScheduleCommand(SessionCommand* command) {
   BaseSessionService::ScheduleCommand(command);
   // Don't schedule a reset on tab closed/window closed. Otherwise we may
   // lose tabs/windows we want to restore from if we exit right after this.
-  if (!pending_reset() && pending_window_close_ids_.empty() &&
+  if (!pending_reset() && !pending_compaction() &&
+      pending_window_close_ids_.empty() &&
       commands_since_reset() >= kWritesPerReset &&
       (command->id() != kCommandTabClosed &&
        command->id() != kCommandWindowClosed)) {
-    ScheduleReset();
+    set_pending_compaction(base::Bind(&CompactSessionCommands));
   }
 }
 
@@ -254,6 +254,47 @@ TEST_F(SessionServiceTest, ClosingTabStaysClosed) {
   helper_.AssertNavigationEquals(nav1, tab->navigations[0]);
 }
 
+// Makes sure the file is compacted after enough commands, and restores to
+// the same windows and tabs once it has been.
+TEST_F(SessionServiceTest, CompactsFile) {
+  SessionID tab_id;
+  SessionID tab2_id;
+  SerializedNavigationEntry nav1 =
+      SerializedNavigationEntryTestHelper::CreateNavigation(
+          "http://google.com", "abc");
+  SerializedNavigationEntry nav2 =
+      SerializedNavigationEntryTestHelper::CreateNavigation(
+          "http://google2.com", "abcd");
+
+  helper_.PrepareTabInWindow(window_id, tab_id, 0, true);
+  UpdateNavigation(window_id, tab_id, nav1, true);
+
+  helper_.PrepareTabInWindow(window_id, tab2_id, 1, false);
+  UpdateNavigation(window_id, tab2_id, nav2, true);
+  service()->TabClosed(window_id, tab2_id, false);
+
+  // Each of these is a command, which the last one overwrites.
+  for (int i = 0; i < 300; ++i)
+    service()->SetPinnedState(window_id, tab_id, i % 2 == 1);
+
+  ScopedVector<SessionWindow> windows;
+  ReadWindows(&(windows.get()), NULL);
+
+  ASSERT_EQ(1U, windows.size());
+  ASSERT_EQ(1U, windows[0]->tabs.size());
+  SessionTab* tab = windows[0]->tabs[0];
+  helper_.AssertTabEquals(window_id, tab_id, 0, 0, 1, *tab);
+  helper_.AssertNavigationEquals(nav1, tab->navigations[0]);
+  EXPECT_TRUE(tab->pinned);
+
+  // Only the last of the pinned states is left, and nothing of the closed
+  // tab.
+  ScopedVector<SessionCommand> commands;
+  ASSERT_TRUE(
+      helper_.backend()->ReadLastSessionCommandsImpl(&(commands.get())));
+  EXPECT_GT(20U, commands.size());
+}
+
 TEST_F(SessionServiceTest, Pruning) {
   SessionID tab_id;
 
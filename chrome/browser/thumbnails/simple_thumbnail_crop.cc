@@ -4,7 +4,9 @@
 
 #include "chrome/browser/thumbnails/simple_thumbnail_crop.h"
 
+#include "base/bind.h"
 #include "base/metrics/histogram.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "skia/ext/platform_canvas.h"
 #include "ui/gfx/color_utils.h"
@@ -16,6 +18,13 @@
 
 namespace {
 static const char kThumbnailHistogramName[] = "Thumbnail.ComputeMS";
+
+void CallbackInvocationAdapter(
+    const thumbnails::ThumbnailingAlgorithm::ConsumerCallback& callback,
+    scoped_refptr<thumbnails::ThumbnailingContext> context,
+    const SkBitmap& thumbnail) {
+  callback.Run(*context.get(), thumbnail);
+}
 }
 
 namespace thumbnails {
@@ -45,18 +54,20 @@ void SimpleThumbnailCrop::ProcessBitmap(
   if (bitmap.isNull() || bitmap.empty())
     return;
 
-  SkBitmap thumbnail = CreateThumbnail(
-      bitmap,
-      ComputeTargetSizeAtMaximumScale(target_size_),
-      &context->clip_result);
-
-  context->score.boring_score = CalculateBoringScore(thumbnail);
-  context->score.good_clipping =
-      (context->clip_result == CLIP_RESULT_WIDER_THAN_TALL ||
-       context->clip_result == CLIP_RESULT_TALLER_THAN_WIDE ||
-       context->clip_result == CLIP_RESULT_NOT_CLIPPED);
-
-  callback.Run(*context.get(), thumbnail);
+  // Downscaling the copy takes long enough to be felt when switching tabs,
+  // so it is done on the blocking pool.
+  if (!content::BrowserThread::GetBlockingPool()->
+          PostWorkerTaskWithShutdownBehavior(
+              FROM_HERE,
+              base::Bind(&SimpleThumbnailCrop::ProcessBitmapOnWorker,
+                         context,
+                         callback,
+                         bitmap,
+                         ComputeTargetSizeAtMaximumScale(target_size_)),
+              base::SequencedWorkerPool::SKIP_ON_SHUTDOWN)) {
+    LOG(WARNING) << "PostWorkerTask failed. The thumbnail for "
+                 << context->url << " will not be created.";
+  }
 }
 
 double SimpleThumbnailCrop::CalculateBoringScore(const SkBitmap& bitmap) {
@@ -193,6 +204,27 @@ SimpleThumbnailCrop::~SimpleThumbnailCrop() {
 
 // Creates a downsampled thumbnail from the given bitmap.
 // store. The returned bitmap will be isNull if there was an error creating it.
+// static
+void SimpleThumbnailCrop::ProcessBitmapOnWorker(
+    scoped_refptr<ThumbnailingContext> context,
+    const ConsumerCallback& callback,
+    const SkBitmap& bitmap,
+    const gfx::Size& desired_size) {
+  SkBitmap thumbnail =
+      CreateThumbnail(bitmap, desired_size, &context->clip_result);
+
+  context->score.boring_score = CalculateBoringScore(thumbnail);
+  context->score.good_clipping =
+      (context->clip_result == CLIP_RESULT_WIDER_THAN_TALL ||
+       context->clip_result == CLIP_RESULT_TALLER_THAN_WIDE ||
+       context->clip_result == CLIP_RESULT_NOT_CLIPPED);
+
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI,
+      FROM_HERE,
+      base::Bind(&CallbackInvocationAdapter, callback, context, thumbnail));
+}
+
 SkBitmap SimpleThumbnailCrop::CreateThumbnail(const SkBitmap& bitmap,
                                               const gfx::Size& desired_size,
                                               ClipResult* clip_result) {
@@ -60,6 +60,13 @@ class SimpleThumbnailCrop : public ThumbnailingAlgorithm {
   virtual ~SimpleThumbnailCrop();
 
  private:
+  // Creates the thumbnail and scores it, then runs |callback| with it on the
+  // UI thread.
+  static void ProcessBitmapOnWorker(scoped_refptr<ThumbnailingContext> context,
+                                    const ConsumerCallback& callback,
+                                    const SkBitmap& bitmap,
+                                    const gfx::Size& desired_size);
+
   static SkBitmap CreateThumbnail(const SkBitmap& bitmap,
                                   const gfx::Size& desired_size,
                                   ClipResult* clip_result);
@@ -31,6 +31,13 @@ class ThumbnailService : public RefcountedBrowserContextKeyedService {
   virtual bool SetPageThumbnail(const ThumbnailingContext& context,
                                 const gfx::Image& thumbnail) = 0;
 
+  // Like SetPageThumbnail(), but for a thumbnail which is already JPEG
+  // encoded, so that callers can encode it away from the UI thread.
+  virtual bool SetPageThumbnailToJPEGBytes(
+      const GURL& url,
+      const base::RefCountedMemory* thumbnail,
+      const ThumbnailScore& score) = 0;
+
   // Returns the ThumbnailingAlgorithm used for processing thumbnails.
   // It is always a new instance, the caller owns it. It will encapsulate the
   // process of creating a thumbnail from tab contents. The lifetime of these
@@ -61,6 +61,17 @@ bool ThumbnailServiceImpl::SetPageThumbnail(const ThumbnailingContext& context,
   return local_ptr->SetPageThumbnail(context.url, thumbnail, context.score);
 }
 
+bool ThumbnailServiceImpl::SetPageThumbnailToJPEGBytes(
+    const GURL& url,
+    const base::RefCountedMemory* thumbnail,
+    const ThumbnailScore& score) {
+  scoped_refptr<history::TopSites> local_ptr(top_sites_);
+  if (local_ptr.get() == NULL)
+    return false;
+
+  return local_ptr->SetPageThumbnailToJPEGBytes(url, thumbnail, score);
+}
+
 bool ThumbnailServiceImpl::GetPageThumbnail(
     const GURL& url,
     bool prefix_match,
@@ -25,6 +25,10 @@ class ThumbnailServiceImpl : public ThumbnailService {
   // Implementation of ThumbnailService.
   virtual bool SetPageThumbnail(const ThumbnailingContext& context,
                                 const gfx::Image& thumbnail) OVERRIDE;
+  virtual bool SetPageThumbnailToJPEGBytes(
+      const GURL& url,
+      const base::RefCountedMemory* thumbnail,
+      const ThumbnailScore& score) OVERRIDE;
   virtual ThumbnailingAlgorithm* GetThumbnailingAlgorithm() const OVERRIDE;
   virtual bool GetPageThumbnail(
       const GURL& url,
@@ -4,6 +4,11 @@
 
 #include "chrome/browser/thumbnails/thumbnail_tab_helper.h"
 
+#include "base/memory/ref_counted_memory.h"
+#include "base/metrics/histogram.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/time/time.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/thumbnails/thumbnail_service.h"
@@ -15,6 +20,8 @@
 #include "content/public/browser/notification_types.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host_view.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/color_utils.h"
 #include "ui/gfx/size_conversions.h"
 #include "ui/gfx/screen.h"
@@ -52,13 +59,58 @@ using thumbnails::ThumbnailingAlgorithm;
 
 namespace {
 
-// Feed the constructed thumbnail to the thumbnail service.
+// The quality TopSites encodes thumbnails with.
+const int kThumbnailQuality = 100;
+
+// Runs on the blocking pool, which keeps the encode from janking the UI
+// thread when a tab is switched away from.
+scoped_refptr<base::RefCountedBytes> EncodeThumbnail(
+    const SkBitmap& thumbnail) {
+  base::TimeTicks begin_encode = base::TimeTicks::Now();
+  scoped_refptr<base::RefCountedBytes> data(new base::RefCountedBytes);
+  SkAutoLockPixels lock(thumbnail);
+  bool encoded = gfx::JPEGCodec::Encode(
+      reinterpret_cast<const unsigned char*>(thumbnail.getAddr32(0, 0)),
+      gfx::JPEGCodec::FORMAT_SkBitmap,
+      thumbnail.width(),
+      thumbnail.height(),
+      static_cast<int>(thumbnail.rowBytes()),
+      kThumbnailQuality,
+      &data->data());
+  // The time the UI thread used to be blocked for.
+  UMA_HISTOGRAM_TIMES("Thumbnail.EncodeOffUIThreadTime",
+                      base::TimeTicks::Now() - begin_encode);
+  if (!encoded)
+    return scoped_refptr<base::RefCountedBytes>();
+  return data;
+}
+
+void SetEncodedThumbnail(scoped_refptr<thumbnails::ThumbnailService> service,
+                         const GURL& url,
+                         const ThumbnailScore& score,
+                         scoped_refptr<base::RefCountedBytes> thumbnail) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  if (!thumbnail.get())
+    return;
+  service->SetPageThumbnailToJPEGBytes(url, thumbnail.get(), score);
+  VLOG(1) << "Thumbnail taken for " << url << ": " << score.ToString();
+}
+
+// Feed the constructed thumbnail to the thumbnail service, once encoded.
 void UpdateThumbnail(const ThumbnailingContext& context,
                      const SkBitmap& thumbnail) {
-  gfx::Image image = gfx::Image::CreateFrom1xBitmap(thumbnail);
-  context.service->SetPageThumbnail(context, image);
-  VLOG(1) << "Thumbnail taken for " << context.url << ": "
-          << context.score.ToString();
+  if (thumbnail.isNull() || thumbnail.empty())
+    return;
+  base::PostTaskAndReplyWithResult(
+      content::BrowserThread::GetBlockingPool()->
+          GetTaskRunnerWithShutdownBehavior(
+              base::SequencedWorkerPool::SKIP_ON_SHUTDOWN).get(),
+      FROM_HERE,
+      base::Bind(&EncodeThumbnail, thumbnail),
+      base::Bind(&SetEncodedThumbnail,
+                 context.service,
+                 context.url,
+                 context.score));
 }
 
 void ProcessCapturedBitmap(scoped_refptr<ThumbnailingContext> context,
@@ -4,12 +4,16 @@
 
 #include "chrome/installer/util/uninstall_metrics.h"
 
+#include <algorithm>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/json/json_reader.h"
 #include "base/logging.h"
-#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/common/pref_names.h"
 #include "chrome/installer/util/util_constants.h"
@@ -18,32 +22,145 @@ namespace installer {
 
 namespace {
 
-// Given a DictionaryValue containing a set of uninstall metrics,
-// this builds a URL parameter list of all the contained metrics.
-// Returns true if at least one uninstall metric was found in
-// uninstall_metrics_dict, false otherwise.
+// Uninstall metrics by name. Metrics that aren't strings have empty values.
+typedef std::map<std::string, std::string> UninstallMetricsMap;
+
+// Given a set of uninstall metrics, this builds a URL parameter list of all
+// the contained metrics. Returns true if at least one uninstall metric was
+// found in uninstall_metrics_map, false otherwise.
 bool BuildUninstallMetricsString(
-    const base::DictionaryValue* uninstall_metrics_dict,
+    const UninstallMetricsMap& uninstall_metrics_map,
     base::string16* metrics) {
   DCHECK(NULL != metrics);
   bool has_values = false;
 
-  for (base::DictionaryValue::Iterator iter(*uninstall_metrics_dict);
-       !iter.IsAtEnd();
-       iter.Advance()) {
+  for (UninstallMetricsMap::const_iterator iter =
+           uninstall_metrics_map.begin();
+       iter != uninstall_metrics_map.end();
+       ++iter) {
     has_values = true;
     metrics->append(L"&");
-    metrics->append(base::UTF8ToWide(iter.key()));
+    metrics->append(base::UTF8ToWide(iter->first));
     metrics->append(L"=");
-
-    std::string value;
-    iter.value().GetAsString(&value);
-    metrics->append(base::UTF8ToWide(value));
+    metrics->append(base::UTF8ToWide(iter->second));
   }
 
   return has_values;
 }
 
+// Picks the uninstall metrics and whether metrics reporting is enabled out of
+// a preferences file as it is parsed, instead of building the Values for the
+// whole file. Follows the semantics of the DictionaryValue lookups done by
+// ExtractUninstallMetrics(), down to later duplicate keys winning.
+class UninstallMetricsReader : public base::JSONReader::Delegate {
+ public:
+  UninstallMetricsReader()
+      : list_depth_(0),
+        metrics_reporting_enabled_(false),
+        has_uninstall_metrics_(false) {
+    base::SplitString(prefs::kMetricsReportingEnabled, '.',
+                      &metrics_reporting_enabled_path_);
+  }
+
+  bool metrics_reporting_enabled() const { return metrics_reporting_enabled_; }
+  bool has_uninstall_metrics() const { return has_uninstall_metrics_; }
+  const UninstallMetricsMap& uninstall_metrics() const {
+    return uninstall_metrics_;
+  }
+
+  // base::JSONReader::Delegate:
+  virtual bool OnNull() OVERRIDE {
+    OnValue(false, base::StringPiece());
+    return true;
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    OnValue(value, base::StringPiece());
+    return true;
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    OnValue(false, base::StringPiece());
+    return true;
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    OnValue(false, base::StringPiece());
+    return true;
+  }
+  virtual bool OnString(const base::StringPiece& value) OVERRIDE {
+    OnValue(false, value);
+    return true;
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    if (list_depth_) {
+      ++list_depth_;
+      return true;
+    }
+    OnValue(false, base::StringPiece());
+    if (path_.size() == 1 && path_[0] == kUninstallMetricsName)
+      has_uninstall_metrics_ = true;
+    path_.push_back(std::string());
+    return true;
+  }
+  virtual bool OnDictionaryKey(const base::StringPiece& key) OVERRIDE {
+    if (!list_depth_)
+      key.CopyToString(&path_.back());
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    if (list_depth_)
+      --list_depth_;
+    else
+      path_.pop_back();
+    return true;
+  }
+  virtual bool OnListBegin() OVERRIDE {
+    if (!list_depth_)
+      OnValue(false, base::StringPiece());
+    ++list_depth_;
+    return true;
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    --list_depth_;
+    return true;
+  }
+
+ private:
+  // Called for each value outside of lists, with |path_| leading to it.
+  // |boolean_value| is true for a true boolean, and |string_value| is the
+  // value of a string.
+  void OnValue(bool boolean_value, const base::StringPiece& string_value) {
+    if (list_depth_)
+      return;
+    // A value on the way to the preference replaces it, too.
+    if (path_.size() <= metrics_reporting_enabled_path_.size() &&
+        std::equal(path_.begin(), path_.end(),
+                   metrics_reporting_enabled_path_.begin())) {
+      metrics_reporting_enabled_ = boolean_value;
+    }
+    if (path_.size() == 1 && path_[0] == kUninstallMetricsName) {
+      // Replaces the metrics seen so far; OnDictionaryBegin() sets
+      // |has_uninstall_metrics_| again if this is a dictionary.
+      has_uninstall_metrics_ = false;
+      uninstall_metrics_.clear();
+    }
+    if (path_.size() == 2 && path_[0] == kUninstallMetricsName)
+      string_value.CopyToString(&uninstall_metrics_[path_[1]]);
+  }
+
+  // The keys of the dictionaries enclosing the current value.
+  std::vector<std::string> path_;
+
+  // The number of lists, and of the dictionaries within them, that enclose
+  // the current value. Nothing inside a list is looked at.
+  int list_depth_;
+
+  std::vector<std::string> metrics_reporting_enabled_path_;
+  bool metrics_reporting_enabled_;
+  bool has_uninstall_metrics_;
+  UninstallMetricsMap uninstall_metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(UninstallMetricsReader);
+};
+
 }  // namespace
 
 bool ExtractUninstallMetrics(const base::DictionaryValue& root,
@@ -64,7 +181,14 @@ bool ExtractUninstallMetrics(const base::DictionaryValue& root,
     return false;
   }
 
-  if (!BuildUninstallMetricsString(uninstall_metrics_dict,
+  UninstallMetricsMap uninstall_metrics_map;
+  for (base::DictionaryValue::Iterator iter(*uninstall_metrics_dict);
+       !iter.IsAtEnd();
+       iter.Advance()) {
+    iter.value().GetAsString(&uninstall_metrics_map[iter.key()]);
+  }
+
+  if (!BuildUninstallMetricsString(uninstall_metrics_map,
                                    uninstall_metrics_string)) {
     return false;
   }
@@ -74,20 +198,19 @@ bool ExtractUninstallMetrics(const base::DictionaryValue& root,
 
 bool ExtractUninstallMetricsFromFile(const base::FilePath& file_path,
                                      base::string16* uninstall_metrics_string) {
+  // Local State can be large, and only a few entries are needed from it.
   JSONFileValueSerializer json_serializer(file_path);
-
-  std::string json_error_string;
-  scoped_ptr<base::Value> root(json_serializer.Deserialize(NULL, NULL));
-  if (!root.get())
+  UninstallMetricsReader reader;
+  if (!json_serializer.DeserializeWithDelegate(&reader, NULL, NULL))
     return false;
 
-  // Preferences should always have a dictionary root.
-  if (!root->IsType(base::Value::TYPE_DICTIONARY))
+  // Preferences should always have a dictionary root; otherwise nothing is
+  // found.
+  if (!reader.metrics_reporting_enabled() || !reader.has_uninstall_metrics())
     return false;
 
-  return ExtractUninstallMetrics(
-      *static_cast<base::DictionaryValue*>(root.get()),
-      uninstall_metrics_string);
+  return BuildUninstallMetricsString(reader.uninstall_metrics(),
+                                     uninstall_metrics_string);
 }
 
 }  // namespace installer
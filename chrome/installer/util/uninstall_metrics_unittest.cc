@@ -4,8 +4,13 @@
 
 #include "chrome/installer/util/uninstall_metrics.h"
 
+#include <string.h>
+
 #include <string>
 
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
@@ -13,36 +18,41 @@
 
 namespace installer {
 
-TEST(UninstallMetricsTest, TestExtractUninstallMetrics) {
-  // A make-believe JSON preferences file.
-  std::string pref_string(
-      "{ \n"
-      "  \"foo\": \"bar\",\n"
-      "  \"uninstall_metrics\": { \n"
-      "    \"last_launch_time_sec\": \"1235341118\","
-      "    \"last_observed_running_time_sec\": \"1235341183\","
-      "    \"launch_count\": \"11\","
-      "    \"page_load_count\": \"68\","
-      "    \"uptime_sec\": \"809\","
-      "    \"installation_date2\": \"1235341141\"\n"
-      "  },\n"
-      "  \"blah\": {\n"
-      "    \"this_sentence_is_true\": false\n"
-      "  },\n"
-      "  \"user_experience_metrics\": { \n"
-      "    \"client_id_timestamp\": \"1234567890\","
-      "    \"reporting_enabled\": true\n"
-      "  }\n"
-      "} \n");
-
-  // The URL string we expect to be generated from said make-believe file.
-  base::string16 expected_url_string(
-      L"&installation_date2=1235341141"
-      L"&last_launch_time_sec=1235341118"
-      L"&last_observed_running_time_sec=1235341183"
-      L"&launch_count=11&page_load_count=68"
-      L"&uptime_sec=809");
+namespace {
+
+// A make-believe JSON preferences file.
+const char kPrefString[] =
+    "{ \n"
+    "  \"foo\": \"bar\",\n"
+    "  \"uninstall_metrics\": { \n"
+    "    \"last_launch_time_sec\": \"1235341118\","
+    "    \"last_observed_running_time_sec\": \"1235341183\","
+    "    \"launch_count\": \"11\","
+    "    \"page_load_count\": \"68\","
+    "    \"uptime_sec\": \"809\","
+    "    \"installation_date2\": \"1235341141\"\n"
+    "  },\n"
+    "  \"blah\": {\n"
+    "    \"this_sentence_is_true\": false\n"
+    "  },\n"
+    "  \"user_experience_metrics\": { \n"
+    "    \"client_id_timestamp\": \"1234567890\","
+    "    \"reporting_enabled\": true\n"
+    "  }\n"
+    "} \n";
 
+// The URL string we expect to be generated from said make-believe file.
+const wchar_t kExpectedURLString[] =
+    L"&installation_date2=1235341141"
+    L"&last_launch_time_sec=1235341118"
+    L"&last_observed_running_time_sec=1235341183"
+    L"&launch_count=11&page_load_count=68"
+    L"&uptime_sec=809";
+
+}  // namespace
+
+TEST(UninstallMetricsTest, TestExtractUninstallMetrics) {
+  std::string pref_string(kPrefString);
   JSONStringValueSerializer json_deserializer(pref_string);
   std::string error_message;
 
@@ -54,7 +64,35 @@ TEST(UninstallMetricsTest, TestExtractUninstallMetrics) {
   EXPECT_TRUE(
       ExtractUninstallMetrics(*static_cast<base::DictionaryValue*>(root.get()),
                               &uninstall_metrics_string));
-  EXPECT_EQ(expected_url_string, uninstall_metrics_string);
+  EXPECT_EQ(base::string16(kExpectedURLString), uninstall_metrics_string);
+}
+
+TEST(UninstallMetricsTest, TestExtractUninstallMetricsFromFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath local_state_path =
+      temp_dir.path().AppendASCII("Local State");
+  const int pref_size = static_cast<int>(strlen(kPrefString));
+  ASSERT_EQ(pref_size,
+            file_util::WriteFile(local_state_path, kPrefString, pref_size));
+
+  base::string16 uninstall_metrics_string;
+  EXPECT_TRUE(ExtractUninstallMetricsFromFile(local_state_path,
+                                              &uninstall_metrics_string));
+  EXPECT_EQ(base::string16(kExpectedURLString), uninstall_metrics_string);
+
+  // Nothing is reported once the user opted out.
+  const char kOptedOutPrefString[] =
+      "{ \"uninstall_metrics\": { \"launch_count\": \"11\" },"
+      "  \"user_experience_metrics\": { \"reporting_enabled\": false } }";
+  const int opted_out_size = static_cast<int>(strlen(kOptedOutPrefString));
+  ASSERT_EQ(opted_out_size,
+            file_util::WriteFile(local_state_path, kOptedOutPrefString,
+                                 opted_out_size));
+  uninstall_metrics_string.clear();
+  EXPECT_FALSE(ExtractUninstallMetricsFromFile(local_state_path,
+                                               &uninstall_metrics_string));
+  EXPECT_TRUE(uninstall_metrics_string.empty());
 }
 
 }  // namespace installer
@@ -17,6 +17,7 @@
 #include "chrome/renderer/extensions/console.h"
 #include "chrome/renderer/extensions/safe_builtins.h"
 #include "content/public/renderer/render_view.h"
+#include "gin/script_cache.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebScopedMicrotaskSuppression.h"
 
@@ -492,12 +493,13 @@ v8::Handle<v8::Value> ModuleSystem::RunString(v8::Handle<v8::String> code,
   blink::WebScopedMicrotaskSuppression suppression;
   v8::TryCatch try_catch;
   try_catch.SetCaptureMessage(true);
-  v8::Handle<v8::Script> script(
-      v8::Script::New(code,
-                      v8::String::NewFromUtf8(GetIsolate(),
-                                              internal_name.c_str(),
-                                              v8::String::kNormalString,
-                                              internal_name.size())));
+  // The bindings are compiled again in each context, so keep their preparse
+  // data.
+  v8::Handle<v8::Script> script(gin::ScriptCache::GetInstance()->Compile(
+      GetIsolate(), code,
+      v8::String::NewFromUtf8(GetIsolate(), internal_name.c_str(),
+                              v8::String::kNormalString,
+                              internal_name.size())));
   if (try_catch.HasCaught()) {
     HandleException(try_catch);
     return v8::Undefined(GetIsolate());
@@ -143,6 +143,7 @@ void UserScriptSlave::GetActiveExtensions(
 
 bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
   scripts_.clear();
+  script_index_.Clear();
 
   bool only_inject_incognito =
       ChromeRenderProcessObserver::is_incognito_process();
@@ -202,6 +203,9 @@ bool UserScriptSlave::UpdateScripts(base::SharedMemoryHandle shared_memory) {
     }
   }
 
+  for (size_t i = 0; i < scripts_.size(); ++i)
+    script_index_.AddPatterns(scripts_[i]->url_patterns(), i);
+
   // Push user styles down into WebCore
   RenderThread::Get()->EnsureWebKitInitialized();
   WebView::removeInjectedStyleSheets();
@@ -270,6 +274,10 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
 
   ExecutingScriptsMap extensions_executing_scripts;
 
+  // Scripts with url patterns can only run if one of them matches.
+  std::set<URLPatternIndex::ItemID> matching_scripts;
+  script_index_.GetMatchingItems(data_source_url, &matching_scripts);
+
   for (size_t i = 0; i < scripts_.size(); ++i) {
     std::vector<WebScriptSource> sources;
     UserScript* script = scripts_[i];
@@ -277,6 +285,10 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
     if (frame->parent() && !script->match_all_frames())
       continue;  // Only match subframes if the script declared it wanted to.
 
+    if (!script->url_patterns().is_empty() &&
+        matching_scripts.find(i) == matching_scripts.end())
+      continue;
+
     const Extension* extension = extensions_->GetByID(script->extension_id());
 
     // Since extension info is sent separately from user script info, they can
@@ -14,6 +14,7 @@
 #include "base/memory/shared_memory.h"
 #include "base/stl_util.h"
 #include "base/strings/string_piece.h"
+#include "extensions/common/url_pattern_index.h"
 #include "extensions/common/user_script.h"
 #include "third_party/WebKit/public/web/WebScriptSource.h"
 
@@ -74,6 +75,9 @@ class UserScriptSlave {
   std::vector<UserScript*> scripts_;
   STLElementDeleter<std::vector<UserScript*> > script_deleter_;
 
+  // The url patterns of |scripts_|, by index in |scripts_|.
+  URLPatternIndex script_index_;
+
   // Greasemonkey API source that is injected with the scripts.
   base::StringPiece api_js_;
 
@@ -1146,6 +1146,7 @@ bool PrintWebViewHelper::FinalizePrintReadyDocument() {
     return false;
   }
   is_print_ready_metafile_sent_ = true;
+  print_preview_context_.ReleasePrintReadyMetafile();
 
   Send(new PrintHostMsg_MetafileReadyForPrinting(routing_id(), preview_params));
   return true;
@@ -1893,6 +1894,11 @@ void PrintWebViewHelper::PrintPreviewContext::FinalizePrintReadyDocument() {
                              total_time / pages_to_render_.size());
 }
 
+void PrintWebViewHelper::PrintPreviewContext::ReleasePrintReadyMetafile() {
+  DCHECK(IsRendering());
+  metafile_.reset();
+}
+
 void PrintWebViewHelper::PrintPreviewContext::Finished() {
   DCHECK_EQ(DONE, state_);
   state_ = INITIALIZED;
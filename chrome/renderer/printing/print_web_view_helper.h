@@ -379,6 +379,10 @@ class PrintWebViewHelper
     // Finalizes the print ready preview document.
     void FinalizePrintReadyDocument();
 
+    // Frees the print ready metafile once it has been copied to the browser.
+    // The pages rendered after it go to draft metafiles of their own.
+    void ReleasePrintReadyMetafile();
+
     // Cleanup after print preview finishes.
     void Finished();
 
@@ -9,6 +9,7 @@
 
 #include "base/gtest_prod_util.h"
 #include "base/prefs/pref_member.h"
+#include "base/time/time.h"
 #include "components/autofill/core/browser/webdata/autofill_webdata_service.h"
 #include "components/webdata/common/web_data_service_consumer.h"
 
@@ -73,6 +74,7 @@ class AutocompleteHistoryManager : public WebDataServiceConsumer {
   // queried on another thread, we record the query handle until we get called
   // back.  We also store the autofill results so we can send them together.
   WebDataServiceBase::Handle pending_query_handle_;
+  base::TimeTicks pending_query_start_time_;
   int query_id_;
   std::vector<base::string16> autofill_values_;
   std::vector<base::string16> autofill_labels_;
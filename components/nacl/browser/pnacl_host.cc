@@ -22,7 +22,8 @@ using content::BrowserThread;
 namespace {
 static const base::FilePath::CharType kTranslationCacheDirectoryName[] =
     FILE_PATH_LITERAL("PnaclTranslationCache");
-// Delay to wait for initialization of the cache backend
+// Delay before retrying a request if the cache backend failed to (or could
+// not start to) initialize.
 static const int kTranslationCacheInitializationDelayMs = 20;
 }
 
@@ -84,15 +85,46 @@ static base::FilePath GetCachePath() {
 void PnaclHost::OnCacheInitialized(int net_error) {
   DCHECK(thread_checker_.CalledOnValidThread());
   // If the cache was cleared before the load completed, ignore.
-  if (cache_state_ == CacheReady)
+  if (cache_state_ != CacheReady) {
+    if (net_error != net::OK) {
+      // This will cause the cache to attempt to re-init on the next call to
+      // GetNexeFd.
+      cache_state_ = CacheUninitialized;
+    } else {
+      cache_state_ = CacheReady;
+    }
+  }
+  // Post the waiting requests rather than running them here, since this may
+  // be called from within Init().
+  std::vector<base::Closure> requests;
+  requests.swap(requests_waiting_for_cache_);
+  for (size_t i = 0; i < requests.size(); ++i) {
+    if (cache_state_ == CacheReady) {
+      BrowserThread::PostTask(BrowserThread::IO, FROM_HERE, requests[i]);
+    } else {
+      BrowserThread::PostDelayedTask(
+          BrowserThread::IO,
+          FROM_HERE,
+          requests[i],
+          base::TimeDelta::FromMilliseconds(
+              kTranslationCacheInitializationDelayMs));
+    }
+  }
+}
+
+void PnaclHost::RunWhenCacheReady(const base::Closure& request) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  DCHECK_NE(CacheReady, cache_state_);
+  if (cache_state_ == CacheInitializing) {
+    requests_waiting_for_cache_.push_back(request);
     return;
-  if (net_error != net::OK) {
-    // This will cause the cache to attempt to re-init on the next call to
-    // GetNexeFd.
-    cache_state_ = CacheUninitialized;
-  } else {
-    cache_state_ = CacheReady;
   }
+  BrowserThread::PostDelayedTask(
+      BrowserThread::IO,
+      FROM_HERE,
+      request,
+      base::TimeDelta::FromMilliseconds(
+          kTranslationCacheInitializationDelayMs));
 }
 
 void PnaclHost::Init() {
@@ -190,19 +222,15 @@ void PnaclHost::GetNexeFd(int render_process_id,
     Init();
   }
   if (cache_state_ != CacheReady) {
-    // If the backend hasn't yet initialized, try the request again later.
-    BrowserThread::PostDelayedTask(BrowserThread::IO,
-                                   FROM_HERE,
-                                   base::Bind(&PnaclHost::GetNexeFd,
-                                              weak_factory_.GetWeakPtr(),
-                                              render_process_id,
-                                              render_view_id,
-                                              pp_instance,
-                                              is_incognito,
-                                              cache_info,
-                                              cb),
-                                   base::TimeDelta::FromMilliseconds(
-                                       kTranslationCacheInitializationDelayMs));
+    // If the backend hasn't yet initialized, make the request once it has.
+    RunWhenCacheReady(base::Bind(&PnaclHost::GetNexeFd,
+                                 weak_factory_.GetWeakPtr(),
+                                 render_process_id,
+                                 render_view_id,
+                                 pp_instance,
+                                 is_incognito,
+                                 cache_info,
+                                 cb));
     return;
   }
 
@@ -579,17 +607,13 @@ void PnaclHost::ClearTranslationCacheEntriesBetween(
     Init();
   }
   if (cache_state_ == CacheInitializing) {
-    // If the backend hasn't yet initialized, try the request again later.
-    BrowserThread::PostDelayedTask(
-        BrowserThread::IO,
-        FROM_HERE,
+    // If the backend hasn't yet initialized, make the request once it has.
+    RunWhenCacheReady(
         base::Bind(&PnaclHost::ClearTranslationCacheEntriesBetween,
                    weak_factory_.GetWeakPtr(),
                    initial_time,
                    end_time,
-                   callback),
-        base::TimeDelta::FromMilliseconds(
-            kTranslationCacheInitializationDelayMs));
+                   callback));
     return;
   }
   pending_backend_operations_++;
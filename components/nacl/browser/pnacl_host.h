@@ -6,8 +6,9 @@
 #define COMPONENTS_NACL_BROWSER_PNACL_HOST_H_
 
 #include <map>
+#include <vector>
 
-#include "base/callback_forward.h"
+#include "base/callback.h"
 #include "base/memory/singleton.h"
 #include "base/memory/weak_ptr.h"
 #include "base/threading/thread_checker.h"
@@ -132,6 +133,10 @@ class PnaclHost {
 
   void InitForTest(base::FilePath temp_dir, bool in_memory);
   void OnCacheInitialized(int net_error);
+  // Runs |request| once the backend is ready. Requests made while it is
+  // initializing are queued and run as soon as it finishes; otherwise they
+  // are retried after a delay.
+  void RunWhenCacheReady(const base::Closure& request);
 
   static void DoCreateTemporaryFile(base::FilePath temp_dir_,
                                     TempFileCallback cb);
@@ -170,6 +175,8 @@ class PnaclHost {
   base::FilePath temp_dir_;
   scoped_ptr<pnacl::PnaclTranslationCache> disk_cache_;
   PendingTranslationMap pending_translations_;
+  // Requests waiting for the backend to finish initializing.
+  std::vector<base::Closure> requests_waiting_for_cache_;
   base::ThreadChecker thread_checker_;
   base::WeakPtrFactory<PnaclHost> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(PnaclHost);
@@ -452,4 +452,19 @@ TEST_F(PnaclHostTestDisk, DeInitWhileInitializing) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST_F(PnaclHostTestDisk, GetNexeFdWhileInitializing) {
+  // The request waits for the backend rather than failing or being dropped,
+  // and is made as soon as the backend is ready.
+  GET_NEXE_FD(0, 0, false, GetTestCacheInfo(), false);
+  EXPECT_EQ(0U, host_->pending_translations());
+  while (!CacheIsInitialized())
+    FlushQueues();
+  FlushQueues();
+  EXPECT_EQ(1U, host_->pending_translations());
+  EXPECT_EQ(1, temp_callback_count_);
+  host_->TranslationFinished(0, 0, true);
+  FlushQueues();
+  EXPECT_EQ(0U, host_->pending_translations());
+}
+
 }  // namespace pnacl
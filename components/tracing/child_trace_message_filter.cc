@@ -12,10 +12,22 @@ using base::debug::TraceLog;
 
 namespace tracing {
 
+#if defined(__native_client__)
+namespace {
+
+// The number of round trips made to estimate the trace clock offset. The
+// estimate of the shortest is kept, as its latency is the least likely to be
+// lopsided.
+const int kClockSyncRounds = 5;
+
+}  // namespace
+#endif
+
 ChildTraceMessageFilter::ChildTraceMessageFilter(
     base::MessageLoopProxy* ipc_message_loop)
     : channel_(NULL),
-      ipc_message_loop_(ipc_message_loop) {}
+      ipc_message_loop_(ipc_message_loop),
+      clock_sync_rounds_left_(0) {}
 
 void ChildTraceMessageFilter::OnFilterAdded(IPC::Channel* channel) {
   channel_ = channel;
@@ -39,6 +51,7 @@ bool ChildTraceMessageFilter::OnMessageReceived(const IPC::Message& message) {
                         OnGetTraceBufferPercentFull)
     IPC_MESSAGE_HANDLER(TracingMsg_SetWatchEvent, OnSetWatchEvent)
     IPC_MESSAGE_HANDLER(TracingMsg_CancelWatchEvent, OnCancelWatchEvent)
+    IPC_MESSAGE_HANDLER(TracingMsg_ClockSyncReply, OnClockSyncReply)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -53,10 +66,13 @@ void ChildTraceMessageFilter::OnBeginTracing(
 #if defined(__native_client__)
   // NaCl and system times are offset by a bit, so subtract some time from
   // the captured timestamps. The value might be off by a bit due to messaging
-  // latency.
+  // latency, so it is refined by the clock sync round trips made below.
   base::TimeDelta time_offset = base::TimeTicks::NowFromSystemTraceTime() -
       browser_time;
   TraceLog::GetInstance()->SetTimeOffset(time_offset);
+  clock_sync_rounds_left_ = kClockSyncRounds;
+  shortest_clock_sync_round_trip_ = base::TimeDelta();
+  SendClockSyncRequest();
 #endif
 
   TraceLog::GetInstance()->SetEnabled(
@@ -127,6 +143,28 @@ void ChildTraceMessageFilter::OnWatchEventMatched() {
   channel_->Send(new TracingHostMsg_WatchEventMatched);
 }
 
+void ChildTraceMessageFilter::OnClockSyncReply(base::TimeTicks child_time,
+                                               base::TimeTicks browser_time) {
+  base::TimeTicks now = base::TimeTicks::NowFromSystemTraceTime();
+  base::TimeDelta round_trip = now - child_time;
+  if (shortest_clock_sync_round_trip_ == base::TimeDelta() ||
+      round_trip < shortest_clock_sync_round_trip_) {
+    shortest_clock_sync_round_trip_ = round_trip;
+    // The browser read its clock about halfway through the round trip.
+    base::TimeTicks midpoint = child_time + round_trip / 2;
+    TraceLog::GetInstance()->SetTimeOffset(midpoint - browser_time);
+  }
+  SendClockSyncRequest();
+}
+
+void ChildTraceMessageFilter::SendClockSyncRequest() {
+  if (!channel_ || clock_sync_rounds_left_ <= 0)
+    return;
+  --clock_sync_rounds_left_;
+  channel_->Send(new TracingHostMsg_ClockSyncRequest(
+      base::TimeTicks::NowFromSystemTraceTime()));
+}
+
 void ChildTraceMessageFilter::OnTraceDataCollected(
     const scoped_refptr<base::RefCountedString>& events_str_ptr,
     bool has_more_events) {
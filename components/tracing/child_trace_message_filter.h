@@ -7,6 +7,7 @@
 
 #include "base/bind.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
 #include "ipc/ipc_channel_proxy.h"
 
 namespace base {
@@ -44,6 +45,11 @@ class ChildTraceMessageFilter : public IPC::ChannelProxy::MessageFilter {
                        const std::string& event_name);
   void OnCancelWatchEvent();
   void OnWatchEventMatched();
+  void OnClockSyncReply(base::TimeTicks child_time,
+                        base::TimeTicks browser_time);
+
+  // Asks the browser for its trace clock, |clock_sync_rounds_left_| times.
+  void SendClockSyncRequest();
 
   // Callback from trace subsystem.
   void OnTraceDataCollected(
@@ -57,6 +63,11 @@ class ChildTraceMessageFilter : public IPC::ChannelProxy::MessageFilter {
   IPC::Channel* channel_;
   base::MessageLoopProxy* ipc_message_loop_;
 
+  // The clock sync rounds yet to be made, and the shortest round trip seen
+  // so far, whose offset estimate is the one in use.
+  int clock_sync_rounds_left_;
+  base::TimeDelta shortest_clock_sync_round_trip_;
+
   DISALLOW_COPY_AND_ASSIGN(ChildTraceMessageFilter);
 };
 
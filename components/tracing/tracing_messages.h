@@ -47,6 +47,11 @@ IPC_MESSAGE_CONTROL2(TracingMsg_SetWatchEvent,
 // Sent to all child processes to clear watch event.
 IPC_MESSAGE_CONTROL0(TracingMsg_CancelWatchEvent)
 
+// Reply to TracingHostMsg_ClockSyncRequest.
+IPC_MESSAGE_CONTROL2(TracingMsg_ClockSyncReply,
+                     base::TimeTicks /* child_time */,
+                     base::TimeTicks /* browser_time */)
+
 // Sent everytime when a watch event is matched.
 IPC_MESSAGE_CONTROL0(TracingHostMsg_WatchEventMatched);
 
@@ -73,3 +78,8 @@ IPC_MESSAGE_CONTROL1(TracingHostMsg_MonitoringTraceDataCollected,
 IPC_MESSAGE_CONTROL1(TracingHostMsg_TraceBufferPercentFullReply,
                      float /*trace buffer percent full*/)
 
+// Sent by child processes whose trace clock differs from the browser's, to
+// estimate the offset between them from the round trip.
+IPC_MESSAGE_CONTROL1(TracingHostMsg_ClockSyncRequest,
+                     base::TimeTicks /* child_time */)
+
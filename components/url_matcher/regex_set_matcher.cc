@@ -10,9 +10,25 @@
 #include "components/url_matcher/substring_set_matcher.h"
 #include "third_party/re2/re2/filtered_re2.h"
 #include "third_party/re2/re2/re2.h"
+#include "third_party/re2/re2/set.h"
 
 namespace url_matcher {
 
+namespace {
+
+// The largest number of regexes compiled into an RE2::Set. The automaton of a
+// set grows with the number of regexes, and RE2 gives up on matching with it
+// once it runs out of memory, whereas FilteredRE2 only ever builds the
+// automata of the regexes which pass its pre-filter.
+const size_t kMaxRE2SetSize = 128;
+
+}  // namespace
+
+class RegexSetMatcher::RE2Set : public RE2::Set {
+ public:
+  RE2Set() : RE2::Set(RE2::DefaultOptions, RE2::UNANCHORED) {}
+};
+
 RegexSetMatcher::RegexSetMatcher() {}
 
 RegexSetMatcher::~RegexSetMatcher() {
@@ -40,6 +56,13 @@ bool RegexSetMatcher::Match(const std::string& text,
   size_t old_number_of_matches = matches->size();
   if (regexes_.empty())
     return false;
+  if (re2_set_.get()) {
+    std::vector<RE2ID> re2_ids;
+    re2_set_->Match(text, &re2_ids);
+    for (size_t i = 0; i < re2_ids.size(); ++i)
+      matches->insert(re2_id_map_[re2_ids[i]]);
+    return old_number_of_matches != matches->size();
+  }
   if (!filtered_re2_.get()) {
     LOG(ERROR) << "RegexSetMatcher was not initialized";
     return false;
@@ -73,10 +96,16 @@ std::vector<RegexSetMatcher::RE2ID> RegexSetMatcher::FindSubstringMatches(
 
 void RegexSetMatcher::RebuildMatcher() {
   re2_id_map_.clear();
+  re2_set_.reset();
   filtered_re2_.reset(new re2::FilteredRE2());
+  substring_matcher_.reset();
+  DeleteSubstringPatterns();
   if (regexes_.empty())
     return;
 
+  if (regexes_.size() <= kMaxRE2SetSize && BuildRE2Set())
+    return;
+
   for (RegexMap::iterator it = regexes_.begin(); it != regexes_.end(); ++it) {
     RE2ID re2_id;
     RE2::ErrorCode error = filtered_re2_->Add(
@@ -96,7 +125,6 @@ void RegexSetMatcher::RebuildMatcher() {
   filtered_re2_->Compile(&strings_to_match);
 
   substring_matcher_.reset(new SubstringSetMatcher);
-  DeleteSubstringPatterns();
   // Build SubstringSetMatcher from |strings_to_match|.
   // SubstringSetMatcher doesn't own its strings.
   for (size_t i = 0; i < strings_to_match.size(); ++i) {
@@ -106,6 +134,28 @@ void RegexSetMatcher::RebuildMatcher() {
   substring_matcher_->RegisterPatterns(substring_patterns_);
 }
 
+bool RegexSetMatcher::BuildRE2Set() {
+  scoped_ptr<RE2Set> re2_set(new RE2Set);
+  for (RegexMap::iterator it = regexes_.begin(); it != regexes_.end(); ++it) {
+    RE2ID re2_id = re2_set->Add(it->second->pattern(), NULL);
+    if (re2_id >= 0) {
+      DCHECK_EQ(static_cast<RE2ID>(re2_id_map_.size()), re2_id);
+      re2_id_map_.push_back(it->first);
+    } else {
+      // Unparseable regexes should have been rejected already in
+      // URLMatcherFactory::CreateURLMatchesCondition.
+      LOG(ERROR) << "Could not parse regex (id=" << it->first << ", "
+                 << it->second->pattern() << ")";
+    }
+  }
+  if (re2_id_map_.empty() || !re2_set->Compile()) {
+    re2_id_map_.clear();
+    return false;
+  }
+  re2_set_.swap(re2_set);
+  return true;
+}
+
 void RegexSetMatcher::DeleteSubstringPatterns() {
   STLDeleteElements(&substring_patterns_);
 }
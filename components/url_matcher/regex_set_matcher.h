@@ -21,10 +21,12 @@ class FilteredRE2;
 
 namespace url_matcher {
 
-// Efficiently matches URLs against a collection of regular expressions,
-// using FilteredRE2 to reduce the number of regexes that must be matched
-// by pre-filtering with substring matching. See:
-// http://swtch.com/~rsc/regexp/regexp3.html#analysis
+// Efficiently matches URLs against a collection of regular expressions.
+// Small collections are compiled into a single RE2::Set automaton, which
+// matches all of them in one pass over the text. Larger ones, whose automaton
+// could outgrow the memory RE2 gives it, use FilteredRE2 to reduce the number
+// of regexes that must be matched by pre-filtering with substring matching.
+// See: http://swtch.com/~rsc/regexp/regexp3.html#analysis
 class URL_MATCHER_EXPORT RegexSetMatcher {
  public:
   RegexSetMatcher();
@@ -47,6 +49,10 @@ class URL_MATCHER_EXPORT RegexSetMatcher {
   bool IsEmpty() const;
 
  private:
+  // An RE2::Set for unanchored matches. RE2::Set is a nested class, so it
+  // can't be forward-declared.
+  class RE2Set;
+
   typedef int RE2ID;
   typedef std::map<StringPattern::ID, const StringPattern*> RegexMap;
   typedef std::vector<StringPattern::ID> RE2IDMap;
@@ -55,21 +61,27 @@ class URL_MATCHER_EXPORT RegexSetMatcher {
   // match the |text|.
   std::vector<RE2ID> FindSubstringMatches(const std::string& text) const;
 
-  // Rebuild FilteredRE2 from scratch. Needs to be called whenever
-  // our set of regexes changes.
+  // Rebuild the RE2::Set or FilteredRE2 from scratch. Needs to be called
+  // whenever our set of regexes changes.
   // TODO(yoz): investigate if it could be done incrementally;
   // apparently not supported by FilteredRE2.
   void RebuildMatcher();
 
+  // Compiles |regexes_| into |re2_set_|. Returns false, leaving |re2_set_|
+  // empty, if they can't all be compiled together.
+  bool BuildRE2Set();
+
   // Clean up StringPatterns in |substring_patterns_|.
   void DeleteSubstringPatterns();
 
   // Mapping of regex StringPattern::IDs to regexes.
   RegexMap regexes_;
-  // Mapping of RE2IDs from FilteredRE2 (which are assigned in order)
-  // to regex StringPattern::IDs.
+  // Mapping of RE2IDs from RE2::Set or FilteredRE2 (which are assigned in
+  // order) to regex StringPattern::IDs.
   RE2IDMap re2_id_map_;
 
+  // Only one of these is used, see RebuildMatcher().
+  scoped_ptr<RE2Set> re2_set_;
   scoped_ptr<re2::FilteredRE2> filtered_re2_;
   scoped_ptr<SubstringSetMatcher> substring_matcher_;
 
@@ -111,20 +111,21 @@ bool SubstringSetMatcher::Match(const std::string& text,
   const size_t old_number_of_matches = matches->size();
 
   // Handle patterns matching the empty string.
-  matches->insert(tree_[0].matches().begin(), tree_[0].matches().end());
+  matches->insert(matches_.begin() + nodes_[0].matches,
+                  matches_.begin() + nodes_[1].matches);
 
   uint32 current_node = 0;
   for (std::string::const_iterator i = text.begin(); i != text.end(); ++i) {
-    uint32 edge_from_current = tree_[current_node].GetEdge(*i);
+    uint32 edge_from_current = GetEdge(current_node, *i);
     while (edge_from_current == AhoCorasickNode::kNoSuchEdge &&
            current_node != 0) {
-      current_node = tree_[current_node].failure();
-      edge_from_current = tree_[current_node].GetEdge(*i);
+      current_node = nodes_[current_node].failure;
+      edge_from_current = GetEdge(current_node, *i);
     }
     if (edge_from_current != AhoCorasickNode::kNoSuchEdge) {
       current_node = edge_from_current;
-      matches->insert(tree_[current_node].matches().begin(),
-                      tree_[current_node].matches().end());
+      matches->insert(matches_.begin() + nodes_[current_node].matches,
+                      matches_.begin() + nodes_[current_node + 1].matches);
     } else {
       DCHECK_EQ(0u, current_node);
     }
@@ -134,8 +135,8 @@ bool SubstringSetMatcher::Match(const std::string& text,
 }
 
 bool SubstringSetMatcher::IsEmpty() const {
-  // An empty tree consists of only the root node.
-  return patterns_.empty() && tree_.size() == 1u;
+  // An empty tree consists of only the root node and the sentinel.
+  return patterns_.empty() && nodes_.size() == 2u;
 }
 
 void SubstringSetMatcher::RebuildAhoCorasickTree(
@@ -155,6 +156,7 @@ void SubstringSetMatcher::RebuildAhoCorasickTree(
   }
 
   CreateFailureEdges();
+  CompileAhoCorasickTree();
 }
 
 void SubstringSetMatcher::InsertPatternIntoAhoCorasickTree(
@@ -229,6 +231,64 @@ void SubstringSetMatcher::CreateFailureEdges() {
   }
 }
 
+void SubstringSetMatcher::CompileAhoCorasickTree() {
+  typedef AhoCorasickNode::Edges Edges;
+  typedef AhoCorasickNode::Matches Matches;
+
+  nodes_.clear();
+  edges_.clear();
+  matches_.clear();
+  nodes_.reserve(tree_.size() + 1);
+  // Every node but the root is the end of one edge.
+  edges_.reserve(tree_.size() - 1);
+
+  for (std::vector<AhoCorasickNode>::const_iterator i = tree_.begin();
+       i != tree_.end(); ++i) {
+    CompiledNode node = { static_cast<uint32>(edges_.size()),
+                          i->failure(),
+                          static_cast<uint32>(matches_.size()) };
+    nodes_.push_back(node);
+    for (Edges::const_iterator e = i->edges().begin(); e != i->edges().end();
+         ++e) {
+      Edge edge = { e->first, e->second };
+      edges_.push_back(edge);
+    }
+    for (Matches::const_iterator m = i->matches().begin();
+         m != i->matches().end(); ++m)
+      matches_.push_back(*m);
+  }
+  CompiledNode sentinel = { static_cast<uint32>(edges_.size()),
+                            AhoCorasickNode::kNoSuchEdge,
+                            static_cast<uint32>(matches_.size()) };
+  nodes_.push_back(sentinel);
+
+  std::fill(root_edges_, root_edges_ + arraysize(root_edges_),
+            AhoCorasickNode::kNoSuchEdge);
+  const Edges& root_edges = tree_[0].edges();
+  for (Edges::const_iterator e = root_edges.begin(); e != root_edges.end();
+       ++e)
+    root_edges_[static_cast<unsigned char>(e->first)] = e->second;
+
+  // Only the compiled tree is used for matching.
+  std::vector<AhoCorasickNode>().swap(tree_);
+}
+
+uint32 SubstringSetMatcher::GetEdge(uint32 node, char c) const {
+  if (node == 0)
+    return root_edges_[static_cast<unsigned char>(c)];
+
+  // Past the first levels of the tree, nodes have one edge or a few, which
+  // are quicker to scan than to search.
+  std::vector<Edge>::const_iterator i = edges_.begin() + nodes_[node].edges;
+  std::vector<Edge>::const_iterator end =
+      edges_.begin() + nodes_[node + 1].edges;
+  for (; i != end; ++i) {
+    if (i->label == c)
+      return i->node;
+  }
+  return AhoCorasickNode::kNoSuchEdge;
+}
+
 const uint32 SubstringSetMatcher::AhoCorasickNode::kNoSuchEdge = ~0;
 
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode()
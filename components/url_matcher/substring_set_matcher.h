@@ -120,19 +120,52 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // |sorted_patterns| is a copy of |patterns_| sorted by the pattern string.
   void RebuildAhoCorasickTree(const SubstringPatternVector& sorted_patterns);
 
+  // The tree is built out of AhoCorasickNodes, which are easy to extend, and
+  // then flattened into arrays for matching. Each node of the arrays has its
+  // edges and matches stored right after those of the previous node, so
+  // following an edge reads a couple of cache lines instead of walking the
+  // nodes of a std::map and a std::set.
+  struct Edge {
+    char label;
+    uint32 node;
+  };
+  struct CompiledNode {
+    uint32 edges;  // Index of the first edge of the node in |edges_|.
+    uint32 failure;
+    uint32 matches;  // Index of the first match of the node in |matches_|.
+  };
+
   // Inserts a path for |pattern->pattern()| into the tree and adds
   // |pattern->id()| to the set of matches. Ownership of |pattern| remains with
   // the caller.
   void InsertPatternIntoAhoCorasickTree(const StringPattern* pattern);
   void CreateFailureEdges();
 
+  // Flattens |tree_| into |nodes_|, |edges_|, |matches_| and |root_edges_|,
+  // and frees |tree_|.
+  void CompileAhoCorasickTree();
+
+  // Returns the node that the edge labeled |c| of |node| leads to, or
+  // AhoCorasickNode::kNoSuchEdge.
+  uint32 GetEdge(uint32 node, char c) const;
+
   // Set of all registered StringPatterns. Used to regenerate the
   // Aho-Corasick tree in case patterns are registered or unregistered.
   SubstringPatternMap patterns_;
 
-  // The nodes of a Aho-Corasick tree.
+  // The nodes of a Aho-Corasick tree, while it is being built.
   std::vector<AhoCorasickNode> tree_;
 
+  // The nodes of the compiled tree, followed by a sentinel which ends the
+  // edges and matches of the last node.
+  std::vector<CompiledNode> nodes_;
+  std::vector<Edge> edges_;
+  std::vector<StringPattern::ID> matches_;
+
+  // The edges of the root, by label. The root is where matching returns after
+  // every character which doesn't continue a pattern, so it gets a table.
+  uint32 root_edges_[256];
+
   DISALLOW_COPY_AND_ASSIGN(SubstringSetMatcher);
 };
 
@@ -0,0 +1,97 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/url_matcher/url_matcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace url_matcher {
+
+namespace {
+
+// One rule in this many also has a regex condition, like the few
+// declarative rules which need one.
+const int kRegexRuleInterval = 100;
+
+const int kURLCount = 10000;
+
+// Adds |rule_count| rules shaped like those of declarative WebRequest and
+// content settings: a host suffix and a path prefix or a query, and a regex
+// now and then.
+void AddRules(int rule_count, URLMatcher* matcher) {
+  URLMatcherConditionFactory* factory = matcher->condition_factory();
+  URLMatcherConditionSet::Vector condition_sets;
+  for (int i = 0; i < rule_count; ++i) {
+    std::string host = base::StringPrintf("site%d.example.com", i);
+    URLMatcherConditionSet::Conditions conditions;
+    conditions.insert(factory->CreateHostSuffixCondition(host));
+    if (i % 2) {
+      conditions.insert(factory->CreatePathPrefixCondition(
+          base::StringPrintf("/ads/%d/", i % 97)));
+    } else {
+      conditions.insert(factory->CreateQueryContainsCondition(
+          base::StringPrintf("id=%d", i)));
+    }
+    if (i % kRegexRuleInterval == 0) {
+      conditions.insert(factory->CreateURLMatchesCondition(
+          base::StringPrintf("site%d\\.example\\.com/.*[0-9]+\\.js$", i)));
+    }
+    condition_sets.push_back(
+        make_scoped_refptr(new URLMatcherConditionSet(i, conditions)));
+  }
+  matcher->AddConditionSets(condition_sets);
+}
+
+// Returns URLs of the hosts of the rules, of which some match a rule, and of
+// other hosts.
+std::vector<GURL> CreateURLs(int rule_count) {
+  std::vector<GURL> urls;
+  for (int i = 0; i < kURLCount; ++i) {
+    int site = (i * 7919) % (2 * rule_count);
+    urls.push_back(GURL(base::StringPrintf(
+        "http://www.site%d.example.com/ads/%d/script%d.js?id=%d",
+        site, i % 97, i, i % 13)));
+  }
+  return urls;
+}
+
+void RunBenchmark(int rule_count) {
+  URLMatcher matcher;
+  {
+    base::PerfTimeLogger timer(
+        base::StringPrintf("URLMatcher_add_%d_rules", rule_count).c_str());
+    AddRules(rule_count, &matcher);
+    timer.Done();
+  }
+
+  std::vector<GURL> urls = CreateURLs(rule_count);
+  size_t match_count = 0;
+  {
+    base::PerfTimeLogger timer(
+        base::StringPrintf("URLMatcher_match_%d_urls_%d_rules", kURLCount,
+                           rule_count).c_str());
+    for (size_t i = 0; i < urls.size(); ++i)
+      match_count += matcher.MatchURL(urls[i]).size();
+    timer.Done();
+  }
+  EXPECT_LT(0u, match_count);
+}
+
+}  // namespace
+
+TEST(URLMatcherPerfTest, TenThousandRules) {
+  RunBenchmark(10000);
+}
+
+TEST(URLMatcherPerfTest, HundredThousandRules) {
+  RunBenchmark(100000);
+}
+
+}  // namespace url_matcher
@@ -43,7 +43,7 @@ class VisitedLinkUpdater {
       : reset_needed_(false), render_process_id_(render_process_id) {
   }
 
-  // Informs the renderer about a new visited link table.
+  // Informs the renderer about a new shard of the visited link table.
   void SendVisitedLinkTable(base::SharedMemory* table_memory) {
     content::RenderProcessHost* process =
         content::RenderProcessHost::FromID(render_process_id_);
@@ -185,13 +185,15 @@ void VisitedLinkEventListener::Observe(
         return;
 
       // Happens on browser start up.
-      if (!master_->shared_memory())
+      if (!master_->shared_memory(0))
         return;
 
       updaters_[process->GetID()] =
           make_linked_ptr(new VisitedLinkUpdater(process->GetID()));
-      updaters_[process->GetID()]->SendVisitedLinkTable(
-          master_->shared_memory());
+      for (int i = 0; i < VisitedLinkCommon::kShardCount; i++) {
+        updaters_[process->GetID()]->SendVisitedLinkTable(
+            master_->shared_memory(i));
+      }
       break;
     }
     case content::NOTIFICATION_RENDERER_PROCESS_TERMINATED: {
@@ -18,6 +18,7 @@
 #include "base/containers/stack_container.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "base/rand_util.h"
@@ -36,20 +37,23 @@ namespace visitedlink {
 
 const int32 VisitedLinkMaster::kFileHeaderSignatureOffset = 0;
 const int32 VisitedLinkMaster::kFileHeaderVersionOffset = 4;
-const int32 VisitedLinkMaster::kFileHeaderLengthOffset = 8;
-const int32 VisitedLinkMaster::kFileHeaderUsedOffset = 12;
+const int32 VisitedLinkMaster::kFileHeaderShardCountOffset = 8;
 const int32 VisitedLinkMaster::kFileHeaderSaltOffset = 16;
 
-const int32 VisitedLinkMaster::kFileCurrentVersion = 3;
+const int32 VisitedLinkMaster::kFileShardLengthOffset = 0;
+const int32 VisitedLinkMaster::kFileShardUsedOffset = 4;
+
+const int32 VisitedLinkMaster::kFileCurrentVersion = 4;
 
 // the signature at the beginning of the URL table = "VLnk" (visited links)
 const int32 VisitedLinkMaster::kFileSignature = 0x6b6e4c56;
 const size_t VisitedLinkMaster::kFileHeaderSize =
     kFileHeaderSaltOffset + LINK_SALT_LENGTH;
+const size_t VisitedLinkMaster::kFileShardHeaderSize = 8;
 
 // This value should also be the same as the smallest size in the lookup
 // table in NewTableSizeForCount (prime number).
-const unsigned VisitedLinkMaster::kDefaultTableSize = 16381;
+const unsigned VisitedLinkMaster::kDefaultTableSize = 1021;
 
 const size_t VisitedLinkMaster::kBigDeleteThreshold = 64;
 
@@ -219,9 +223,11 @@ VisitedLinkMaster::~VisitedLinkMaster() {
 
 void VisitedLinkMaster::InitMembers() {
   file_ = NULL;
-  shared_memory_ = NULL;
+  for (int i = 0; i < kShardCount; i++) {
+    shared_memory_[i] = NULL;
+    used_items_[i] = 0;
+  }
   shared_memory_serial_ = 0;
-  used_items_ = 0;
   table_size_override_ = 0;
   suppress_rebuild_ = false;
   sequence_token_ = BrowserThread::GetBlockingPool()->GetSequenceToken();
@@ -244,7 +250,8 @@ bool VisitedLinkMaster::Init() {
   return InitFromScratch(suppress_rebuild_);
 }
 
-VisitedLinkMaster::Hash VisitedLinkMaster::TryToAddURL(const GURL& url) {
+VisitedLinkMaster::Hash VisitedLinkMaster::TryToAddURL(const GURL& url,
+                                                       int* shard) {
   // Extra check that we are not incognito. This should not happen.
   // TODO(boliu): Move this check to HistoryService when IsOffTheRecord is
   // removed from BrowserContext.
@@ -275,8 +282,9 @@ VisitedLinkMaster::Hash VisitedLinkMaster::TryToAddURL(const GURL& url) {
   // This can happen if we get thousands of new URLs and something causes
   // the table resizing to fail. This check prevents a hang in that case. Note
   // that this is *not* the resize limit, this is just a sanity check.
-  if (used_items_ / 8 > table_length_ / 10)
-    return null_hash_;  // Table is more than 80% full.
+  *shard = ShardForFingerprint(fingerprint);
+  if (used_items_[*shard] / 8 > shards_[*shard].length / 10)
+    return null_hash_;  // Shard is more than 80% full.
 
   return AddFingerprint(fingerprint, true);
 }
@@ -289,23 +297,26 @@ void VisitedLinkMaster::PostIOTask(const tracked_objects::Location& from_here,
 }
 
 void VisitedLinkMaster::AddURL(const GURL& url) {
-  Hash index = TryToAddURL(url);
+  int shard = 0;
+  Hash index = TryToAddURL(url, &shard);
   if (!table_builder_.get() && index != null_hash_) {
     // Not rebuilding, so we want to keep the file on disk up-to-date.
     if (persist_to_disk_) {
-      WriteUsedItemCountToFile();
-      WriteHashRangeToFile(index, index);
+      WriteUsedItemCountToFile(shard);
+      WriteHashRangeToFile(shard, index, index);
     }
-    ResizeTableIfNecessary();
+    if (ResizeShardIfNecessary(shard) && persist_to_disk_)
+      WriteTableFromShard(shard);
   }
 }
 
 void VisitedLinkMaster::AddURLs(const std::vector<GURL>& url) {
   for (std::vector<GURL>::const_iterator i = url.begin();
        i != url.end(); ++i) {
-    Hash index = TryToAddURL(*i);
+    int shard = 0;
+    Hash index = TryToAddURL(*i, &shard);
     if (!table_builder_.get() && index != null_hash_)
-      ResizeTableIfNecessary();
+      ResizeShardIfNecessary(shard);
   }
 
   // Keeps the file on disk up-to-date.
@@ -319,12 +330,15 @@ void VisitedLinkMaster::DeleteAllURLs() {
   deleted_since_rebuild_.clear();
 
   // Clear the hash table.
-  used_items_ = 0;
-  memset(hash_table_, 0, this->table_length_ * sizeof(Fingerprint));
+  for (int i = 0; i < kShardCount; i++) {
+    used_items_[i] = 0;
+    memset(shards_[i].hash_table, 0, shards_[i].length * sizeof(Fingerprint));
+  }
 
-  // Resize it if it is now too empty. Resize may write the new table out for
-  // us, otherwise, schedule writing the new table to disk ourselves.
-  if (!ResizeTableIfNecessary() && persist_to_disk_)
+  // Resize the shards that are now too empty, and schedule writing the new
+  // table to disk.
+  ResizeShardsIfNecessary();
+  if (persist_to_disk_)
     WriteFullTable();
 
   listener_->Reset();
@@ -382,7 +396,9 @@ void VisitedLinkMaster::DeleteURLs(URLIterator* urls) {
 VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
     Fingerprint fingerprint,
     bool send_notifications) {
-  if (!hash_table_ || table_length_ == 0) {
+  int shard = ShardForFingerprint(fingerprint);
+  Fingerprint* hash_table = shards_[shard].hash_table;
+  if (!hash_table || shards_[shard].length == 0) {
     NOTREACHED();  // Not initialized.
     return null_hash_;
   }
@@ -390,14 +406,14 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
   Hash cur_hash = HashFingerprint(fingerprint);
   Hash first_hash = cur_hash;
   while (true) {
-    Fingerprint cur_fingerprint = FingerprintAt(cur_hash);
+    Fingerprint cur_fingerprint = FingerprintAt(shard, cur_hash);
     if (cur_fingerprint == fingerprint)
       return null_hash_;  // This fingerprint is already in there, do nothing.
 
     if (cur_fingerprint == null_fingerprint_) {
       // End of probe sequence found, insert here.
-      hash_table_[cur_hash] = fingerprint;
-      used_items_++;
+      hash_table[cur_hash] = fingerprint;
+      used_items_[shard]++;
       // If allowed, notify listener that a new visited link was added.
       if (send_notifications)
         listener_->Add(fingerprint);
@@ -405,7 +421,7 @@ VisitedLinkMaster::Hash VisitedLinkMaster::AddFingerprint(
     }
 
     // Advance in the probe sequence.
-    cur_hash = IncrementHash(cur_hash);
+    cur_hash = IncrementHash(shard, cur_hash);
     if (cur_hash == first_hash) {
       // This means that we've wrapped around and are about to go into an
       // infinite loop. Something was wrong with the hashtable resizing
@@ -425,18 +441,22 @@ void VisitedLinkMaster::DeleteFingerprintsFromCurrentTable(
        i != fingerprints.end(); ++i)
     DeleteFingerprint(*i, !bulk_write);
 
-  // These deleted fingerprints may make us shrink the table.
-  if (ResizeTableIfNecessary())
-    return;  // The resize function wrote the new table to disk for us.
+  // These deleted fingerprints may make us shrink some shards.
+  int first_resized_shard = ResizeShardsIfNecessary();
+  if (!persist_to_disk_)
+    return;
 
-  // Nobody wrote this out for us, write the full file to disk.
-  if (bulk_write && persist_to_disk_)
+  if (bulk_write)
     WriteFullTable();
+  else if (first_resized_shard < kShardCount)
+    WriteTableFromShard(first_resized_shard);
 }
 
 bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
                                           bool update_file) {
-  if (!hash_table_ || table_length_ == 0) {
+  int shard = ShardForFingerprint(fingerprint);
+  Fingerprint* hash_table = shards_[shard].hash_table;
+  if (!hash_table || shards_[shard].length == 0) {
     NOTREACHED();  // Not initialized.
     return false;
   }
@@ -444,9 +464,9 @@ bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
     return false;  // Not in the database to delete.
 
   // First update the header used count.
-  used_items_--;
+  used_items_[shard]--;
   if (update_file && persist_to_disk_)
-    WriteUsedItemCountToFile();
+    WriteUsedItemCountToFile(shard);
 
   Hash deleted_hash = HashFingerprint(fingerprint);
 
@@ -456,10 +476,10 @@ bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
   // item up until an empty item could be affected.
   Hash end_range = deleted_hash;
   while (true) {
-    Hash next_hash = IncrementHash(end_range);
+    Hash next_hash = IncrementHash(shard, end_range);
     if (next_hash == deleted_hash)
       break;  // We wrapped around and the whole table is full.
-    if (!hash_table_[next_hash])
+    if (!hash_table[next_hash])
       break;  // Found the last spot.
     end_range = next_hash;
   }
@@ -469,17 +489,18 @@ bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
   // This will mean there's a small window of time where the affected links
   // won't be marked visited.
   base::StackVector<Fingerprint, 32> shuffled_fingerprints;
-  Hash stop_loop = IncrementHash(end_range);  // The end range is inclusive.
-  for (Hash i = deleted_hash; i != stop_loop; i = IncrementHash(i)) {
-    if (hash_table_[i] != fingerprint) {
+  // The end range is inclusive.
+  Hash stop_loop = IncrementHash(shard, end_range);
+  for (Hash i = deleted_hash; i != stop_loop; i = IncrementHash(shard, i)) {
+    if (hash_table[i] != fingerprint) {
       // Don't save the one we're deleting!
-      shuffled_fingerprints->push_back(hash_table_[i]);
+      shuffled_fingerprints->push_back(hash_table[i]);
 
       // This will balance the increment of this value in AddFingerprint below
       // so there is no net change.
-      used_items_--;
+      used_items_[shard]--;
     }
-    hash_table_[i] = null_fingerprint_;
+    hash_table[i] = null_fingerprint_;
   }
 
   if (!shuffled_fingerprints->empty()) {
@@ -490,12 +511,16 @@ bool VisitedLinkMaster::DeleteFingerprint(Fingerprint fingerprint,
 
   // Write the affected range to disk [deleted_hash, end_range].
   if (update_file && persist_to_disk_)
-    WriteHashRangeToFile(deleted_hash, end_range);
+    WriteHashRangeToFile(shard, deleted_hash, end_range);
 
   return true;
 }
 
 void VisitedLinkMaster::WriteFullTable() {
+  WriteTableFromShard(0);
+}
+
+void VisitedLinkMaster::WriteTableFromShard(int first_shard) {
   // This function can get called when the file is open, for example, when we
   // resize the table. We must handle this case and not try to reopen the file,
   // since there may be write operations pending on the file I/O thread.
@@ -521,14 +546,25 @@ void VisitedLinkMaster::WriteFullTable() {
   int32 header[4];
   header[0] = kFileSignature;
   header[1] = kFileCurrentVersion;
-  header[2] = table_length_;
-  header[3] = used_items_;
+  header[2] = kShardCount;
+  header[3] = 0;
   WriteToFile(file_, 0, header, sizeof(header));
   WriteToFile(file_, sizeof(header), salt_, LINK_SALT_LENGTH);
 
+  // Write the header of every shard, since the lengths of those after
+  // |first_shard| may have changed.
+  int32 shard_headers[kShardCount * 2];
+  for (int i = 0; i < kShardCount; i++) {
+    shard_headers[i * 2] = shards_[i].length;
+    shard_headers[i * 2 + 1] = used_items_[i];
+  }
+  WriteToFile(file_, kFileHeaderSize, shard_headers, sizeof(shard_headers));
+
   // Write the hash data.
-  WriteToFile(file_, kFileHeaderSize,
-              hash_table_, table_length_ * sizeof(Fingerprint));
+  for (int i = first_shard; i < kShardCount; i++) {
+    WriteToFile(file_, ShardFileOffset(i),
+                shards_[i].hash_table, shards_[i].length * sizeof(Fingerprint));
+  }
 
   // The hash table may have shrunk, so make sure this is the end.
   PostIOTask(FROM_HERE, base::Bind(&AsyncTruncate, file_));
@@ -544,19 +580,26 @@ bool VisitedLinkMaster::InitFromFile() {
   if (!file_closer.get())
     return false;
 
-  int32 num_entries, used_count;
-  if (!ReadFileHeader(file_closer.get(), &num_entries, &used_count, salt_))
+  int32 num_entries[kShardCount], used_count[kShardCount];
+  if (!ReadFileHeader(file_closer.get(), num_entries, used_count, salt_))
     return false;  // Header isn't valid.
 
-  // Allocate and read the table.
-  if (!CreateURLTable(num_entries, false))
-    return false;
-  if (!ReadFromFile(file_closer.get(), kFileHeaderSize,
-                    hash_table_, num_entries * sizeof(Fingerprint))) {
-    FreeURLTable();
-    return false;
+  // Allocate and read the shards.
+  for (int i = 0; i < kShardCount; i++) {
+    base::SharedMemory* shared_memory = CreateShardMemory(i, num_entries[i]);
+    if (!shared_memory) {
+      FreeURLTable();
+      return false;
+    }
+    SetShard(i, shared_memory);
+    if (!ReadFromFile(file_closer.get(), ShardFileOffset(i),
+                      shards_[i].hash_table,
+                      num_entries[i] * sizeof(Fingerprint))) {
+      FreeURLTable();
+      return false;
+    }
+    used_items_[i] = used_count[i];
   }
-  used_items_ = used_count;
 
 #ifndef NDEBUG
   DebugValidate();
@@ -575,8 +618,14 @@ bool VisitedLinkMaster::InitFromScratch(bool suppress_rebuild) {
   // The salt must be generated before the table so that it can be copied to
   // the shared memory.
   GenerateSalt(salt_);
-  if (!CreateURLTable(table_size, true))
-    return false;
+  for (int i = 0; i < kShardCount; i++) {
+    base::SharedMemory* shared_memory = CreateShardMemory(i, table_size);
+    if (!shared_memory) {
+      FreeURLTable();
+      return false;
+    }
+    SetShard(i, shared_memory);
+  }
 
 #ifndef NDEBUG
   DebugValidate();
@@ -598,8 +647,8 @@ bool VisitedLinkMaster::InitFromScratch(bool suppress_rebuild) {
 }
 
 bool VisitedLinkMaster::ReadFileHeader(FILE* file,
-                                       int32* num_entries,
-                                       int32* used_count,
+                                       int32 num_entries[kShardCount],
+                                       int32 used_count[kShardCount],
                                        uint8 salt[LINK_SALT_LENGTH]) {
   DCHECK(persist_to_disk_);
 
@@ -611,7 +660,9 @@ bool VisitedLinkMaster::ReadFileHeader(FILE* file,
     return false;
   size_t file_size = ftell(file);
 
-  if (file_size <= kFileHeaderSize)
+  const size_t headers_size = kFileHeaderSize +
+                              kShardCount * kFileShardHeaderSize;
+  if (file_size <= headers_size)
     return false;
 
   uint8 header[kFileHeaderSize];
@@ -632,15 +683,35 @@ bool VisitedLinkMaster::ReadFileHeader(FILE* file,
   if (version != kFileCurrentVersion)
     return false;  // Bad version.
 
-  // Read the table size and make sure it matches the file size.
-  memcpy(num_entries, &header[kFileHeaderLengthOffset], sizeof(*num_entries));
-  if (*num_entries * sizeof(Fingerprint) + kFileHeaderSize != file_size)
-    return false;  // Bad size.
+  int32 shard_count;
+  memcpy(&shard_count, &header[kFileHeaderShardCountOffset],
+         sizeof(shard_count));
+  if (shard_count != kShardCount)
+    return false;  // Bad shard count.
+
+  uint8 shard_headers[kShardCount * kFileShardHeaderSize];
+  if (!ReadFromFile(file, kFileHeaderSize, &shard_headers,
+                    sizeof(shard_headers)))
+    return false;
 
-  // Read the used item count.
-  memcpy(used_count, &header[kFileHeaderUsedOffset], sizeof(*used_count));
-  if (*used_count > *num_entries)
-    return false;  // Bad used item count;
+  // Read the shard sizes and make sure they match the file size.
+  uint64 total_entries = 0;
+  for (int i = 0; i < kShardCount; i++) {
+    const uint8* shard_header = &shard_headers[i * kFileShardHeaderSize];
+    memcpy(&num_entries[i], &shard_header[kFileShardLengthOffset],
+           sizeof(num_entries[i]));
+    if (num_entries[i] <= 0)
+      return false;  // Bad size.
+    total_entries += num_entries[i];
+
+    // Read the used item count.
+    memcpy(&used_count[i], &shard_header[kFileShardUsedOffset],
+           sizeof(used_count[i]));
+    if (used_count[i] < 0 || used_count[i] > num_entries[i])
+      return false;  // Bad used item count;
+  }
+  if (total_entries * sizeof(Fingerprint) + headers_size != file_size)
+    return false;  // Bad size.
 
   // Read the salt.
   memcpy(salt, &header[kFileHeaderSaltOffset], LINK_SALT_LENGTH);
@@ -664,64 +735,44 @@ bool VisitedLinkMaster::GetDatabaseFileName(base::FilePath* filename) {
   return true;
 }
 
-// Initializes the shared memory structure. The salt should already be filled
-// in so that it can be written to the shared memory
-bool VisitedLinkMaster::CreateURLTable(int32 num_entries, bool init_to_empty) {
-  // The table is the size of the table followed by the entries.
+base::SharedMemory* VisitedLinkMaster::CreateShardMemory(int shard,
+                                                         int32 num_entries) {
+  // The shard is its header followed by the entries.
   uint32 alloc_size = num_entries * sizeof(Fingerprint) + sizeof(SharedHeader);
 
   // Create the shared memory object.
-  shared_memory_ = new base::SharedMemory();
-  if (!shared_memory_)
-    return false;
-
-  if (!shared_memory_->CreateAndMapAnonymous(alloc_size)) {
-    delete shared_memory_;
-    shared_memory_ = NULL;
-    return false;
-  }
-
-  if (init_to_empty) {
-    memset(shared_memory_->memory(), 0, alloc_size);
-    used_items_ = 0;
-  }
-  table_length_ = num_entries;
+  scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory());
+  if (!shared_memory->CreateAndMapAnonymous(alloc_size))
+    return NULL;
+  memset(shared_memory->memory(), 0, alloc_size);
 
   // Save the header for other processes to read.
-  SharedHeader* header = static_cast<SharedHeader*>(shared_memory_->memory());
-  header->length = table_length_;
+  SharedHeader* header = static_cast<SharedHeader*>(shared_memory->memory());
+  header->length = num_entries;
+  header->shard = shard;
   memcpy(header->salt, salt_, LINK_SALT_LENGTH);
-
-  // Our table pointer is just the data immediately following the size.
-  hash_table_ = reinterpret_cast<Fingerprint*>(
-      static_cast<char*>(shared_memory_->memory()) + sizeof(SharedHeader));
-
-  return true;
+  return shared_memory.release();
 }
 
-bool VisitedLinkMaster::BeginReplaceURLTable(int32 num_entries) {
-  base::SharedMemory *old_shared_memory = shared_memory_;
-  Fingerprint* old_hash_table = hash_table_;
-  int32 old_table_length = table_length_;
-  if (!CreateURLTable(num_entries, true)) {
-    // Try to put back the old state.
-    shared_memory_ = old_shared_memory;
-    hash_table_ = old_hash_table;
-    table_length_ = old_table_length;
-    return false;
-  }
-
-#ifndef NDEBUG
-  DebugValidate();
-#endif
-
-  return true;
+void VisitedLinkMaster::SetShard(int shard,
+                                 base::SharedMemory* shared_memory) {
+  SharedHeader* header = static_cast<SharedHeader*>(shared_memory->memory());
+  DCHECK_EQ(static_cast<uint32>(shard), header->shard);
+  shared_memory_[shard] = shared_memory;
+  used_items_[shard] = 0;
+
+  // Our table pointer is just the data immediately following the header.
+  shards_[shard].length = header->length;
+  shards_[shard].hash_table = reinterpret_cast<Fingerprint*>(
+      static_cast<char*>(shared_memory->memory()) + sizeof(SharedHeader));
 }
 
 void VisitedLinkMaster::FreeURLTable() {
-  if (shared_memory_) {
-    delete shared_memory_;
-    shared_memory_ = NULL;
+  for (int i = 0; i < kShardCount; i++) {
+    delete shared_memory_[i];
+    shared_memory_[i] = NULL;
+    shards_[i] = Shard();
+    used_items_[i] = 0;
   }
   if (!persist_to_disk_ || !file_)
     return;
@@ -730,8 +781,8 @@ void VisitedLinkMaster::FreeURLTable() {
   file_ = NULL;
 }
 
-bool VisitedLinkMaster::ResizeTableIfNecessary() {
-  DCHECK(table_length_ > 0) << "Must have a table";
+bool VisitedLinkMaster::ResizeShardIfNecessary(int shard) {
+  DCHECK(shards_[shard].length > 0) << "Must have a table";
 
   // Load limits for good performance/space. We are pretty conservative about
   // keeping the table not very full. This is because we use linear probing
@@ -740,65 +791,75 @@ bool VisitedLinkMaster::ResizeTableIfNecessary() {
   const float max_table_load = 0.5f;  // Grow when we're > this full.
   const float min_table_load = 0.2f;  // Shrink when we're < this full.
 
-  float load = ComputeTableLoad();
+  float load = ComputeTableLoad(shard);
   if (load < max_table_load &&
-      (table_length_ <= static_cast<float>(kDefaultTableSize) ||
+      (shards_[shard].length <= static_cast<float>(kDefaultTableSize) ||
        load > min_table_load))
     return false;
 
-  // Table needs to grow or shrink.
-  int new_size = NewTableSizeForCount(used_items_);
-  DCHECK(new_size > used_items_);
-  DCHECK(load <= min_table_load || new_size > table_length_);
-  ResizeTable(new_size);
+  // Shard needs to grow or shrink.
+  int new_size = NewTableSizeForCount(used_items_[shard]);
+  DCHECK(new_size > used_items_[shard]);
+  DCHECK(load <= min_table_load || new_size > shards_[shard].length);
+  ResizeShard(shard, new_size);
   return true;
 }
 
-void VisitedLinkMaster::ResizeTable(int32 new_size) {
-  DCHECK(shared_memory_ && shared_memory_->memory() && hash_table_);
+int VisitedLinkMaster::ResizeShardsIfNecessary() {
+  int first_resized_shard = kShardCount;
+  for (int i = kShardCount - 1; i >= 0; i--) {
+    if (ResizeShardIfNecessary(i))
+      first_resized_shard = i;
+  }
+  return first_resized_shard;
+}
+
+void VisitedLinkMaster::ResizeShard(int shard, int32 new_size) {
+  DCHECK(shared_memory_[shard] && shared_memory_[shard]->memory() &&
+         shards_[shard].hash_table);
   shared_memory_serial_++;
 
 #ifndef NDEBUG
   DebugValidate();
 #endif
 
-  base::SharedMemory* old_shared_memory = shared_memory_;
-  Fingerprint* old_hash_table = hash_table_;
-  int32 old_table_length = table_length_;
-  if (!BeginReplaceURLTable(new_size))
+  base::SharedMemory* new_shared_memory = CreateShardMemory(shard, new_size);
+  if (!new_shared_memory)
     return;
 
-  // Now we have two tables, our local copy which is the old one, and the new
+  // The new shard is filled on the side: the slaves keep reading the old one,
+  // which is left untouched, until they are sent the new one.
+  scoped_ptr<base::SharedMemory> old_shared_memory(shared_memory_[shard]);
+  Shard old_shard = shards_[shard];
+  SetShard(shard, new_shared_memory);
+
+  // Now we have two shards, our local copy which is the old one, and the new
   // one loaded into this object where we need to copy the data.
-  for (int32 i = 0; i < old_table_length; i++) {
-    Fingerprint cur = old_hash_table[i];
+  for (int32 i = 0; i < old_shard.length; i++) {
+    Fingerprint cur = old_shard.hash_table[i];
     if (cur)
       AddFingerprint(cur, false);
   }
 
-  // On error unmapping, just forget about it since we can't do anything
-  // else to release it.
-  delete old_shared_memory;
-
   // Send an update notification to all child processes so they read the new
-  // table.
-  listener_->NewTable(shared_memory_);
+  // shard. The other shards are unchanged, so they are not sent again.
+  listener_->NewTable(shared_memory_[shard]);
 
 #ifndef NDEBUG
   DebugValidate();
 #endif
-
-  // The new table needs to be written to disk.
-  if (persist_to_disk_)
-    WriteFullTable();
 }
 
 uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) const {
   // These table sizes are selected to be the maximum prime number less than
   // a "convenient" multiple of 1K.
   static const int table_sizes[] = {
-      16381,    // 16K  = 16384   <- don't shrink below this table size
+      1021,     // 1K   = 1024    <- don't shrink below this table size
                 //                   (should be == default_table_size)
+      2039,     // 2K   = 2048
+      4093,     // 4K   = 4096
+      8191,     // 8K   = 8192
+      16381,    // 16K  = 16384
       32767,    // 32K  = 32768
       65521,    // 64K  = 65536
       130051,   // 128K = 131072
@@ -843,15 +904,33 @@ void VisitedLinkMaster::OnTableRebuildComplete(
     // Replace the old table with a new blank one.
     shared_memory_serial_++;
 
-    // We are responsible for freeing it AFTER it has been replaced if
-    // replacement succeeds.
-    base::SharedMemory* old_shared_memory = shared_memory_;
+    // Size each shard for the fingerprints that will go into it.
+    int32 shard_counts[kShardCount] = { 0 };
+    for (size_t i = 0; i < fingerprints.size(); i++)
+      shard_counts[ShardForFingerprint(fingerprints[i])]++;
+    for (std::set<Fingerprint>::iterator i = added_since_rebuild_.begin();
+         i != added_since_rebuild_.end(); ++i)
+      shard_counts[ShardForFingerprint(*i)]++;
+
+    // Allocate all the new shards before freeing the old ones, so that the
+    // old table is kept whole if an allocation fails.
+    base::SharedMemory* new_shared_memory[kShardCount];
+    bool allocated = true;
+    for (int i = 0; i < kShardCount; i++) {
+      new_shared_memory[i] = allocated ?
+          CreateShardMemory(i, NewTableSizeForCount(shard_counts[i])) : NULL;
+      allocated = allocated && new_shared_memory[i] != NULL;
+    }
 
-    int new_table_size = NewTableSizeForCount(
-        static_cast<int>(fingerprints.size() + added_since_rebuild_.size()));
-    if (BeginReplaceURLTable(new_table_size)) {
+    if (!allocated) {
+      for (int i = 0; i < kShardCount; i++)
+        delete new_shared_memory[i];
+    } else {
       // Free the old table.
-      delete old_shared_memory;
+      for (int i = 0; i < kShardCount; i++) {
+        delete shared_memory_[i];
+        SetShard(i, new_shared_memory[i]);
+      }
 
       // Add the stored fingerprints to the hash table.
       for (size_t i = 0; i < fingerprints.size(); i++)
@@ -869,7 +948,8 @@ void VisitedLinkMaster::OnTableRebuildComplete(
       deleted_since_rebuild_.clear();
 
       // Send an update notification to all child processes.
-      listener_->NewTable(shared_memory_);
+      for (int i = 0; i < kShardCount; i++)
+        listener_->NewTable(shared_memory_[i]);
 
       if (persist_to_disk_)
         WriteFullTable();
@@ -897,31 +977,45 @@ void VisitedLinkMaster::WriteToFile(FILE** file,
                  std::string(static_cast<const char*>(data), data_size)));
 }
 
-void VisitedLinkMaster::WriteUsedItemCountToFile() {
+off_t VisitedLinkMaster::ShardFileOffset(int shard) const {
+  off_t offset = kFileHeaderSize + kShardCount * kFileShardHeaderSize;
+  for (int i = 0; i < shard; i++)
+    offset += shards_[i].length * sizeof(Fingerprint);
+  return offset;
+}
+
+void VisitedLinkMaster::WriteUsedItemCountToFile(int shard) {
   DCHECK(persist_to_disk_);
   if (!file_)
     return;  // See comment on the file_ variable for why this might happen.
-  WriteToFile(file_, kFileHeaderUsedOffset, &used_items_, sizeof(used_items_));
+  WriteToFile(file_,
+              kFileHeaderSize + shard * kFileShardHeaderSize +
+                  kFileShardUsedOffset,
+              &used_items_[shard], sizeof(used_items_[shard]));
 }
 
-void VisitedLinkMaster::WriteHashRangeToFile(Hash first_hash, Hash last_hash) {
+void VisitedLinkMaster::WriteHashRangeToFile(int shard,
+                                             Hash first_hash,
+                                             Hash last_hash) {
   DCHECK(persist_to_disk_);
 
   if (!file_)
     return;  // See comment on the file_ variable for why this might happen.
+  off_t shard_offset = ShardFileOffset(shard);
+  Fingerprint* hash_table = shards_[shard].hash_table;
   if (last_hash < first_hash) {
-    // Handle wraparound at 0. This first write is first_hash->EOF
-    WriteToFile(file_, first_hash * sizeof(Fingerprint) + kFileHeaderSize,
-                &hash_table_[first_hash],
-                (table_length_ - first_hash + 1) * sizeof(Fingerprint));
+    // Handle wraparound at 0. This first write is first_hash->end of shard.
+    WriteToFile(file_, first_hash * sizeof(Fingerprint) + shard_offset,
+                &hash_table[first_hash],
+                (shards_[shard].length - first_hash) * sizeof(Fingerprint));
 
     // Now do 0->last_lash.
-    WriteToFile(file_, kFileHeaderSize, hash_table_,
+    WriteToFile(file_, shard_offset, hash_table,
                 (last_hash + 1) * sizeof(Fingerprint));
   } else {
     // Normal case, just write the range.
-    WriteToFile(file_, first_hash * sizeof(Fingerprint) + kFileHeaderSize,
-                &hash_table_[first_hash],
+    WriteToFile(file_, first_hash * sizeof(Fingerprint) + shard_offset,
+                &hash_table[first_hash],
                 (last_hash - first_hash + 1) * sizeof(Fingerprint));
   }
 }
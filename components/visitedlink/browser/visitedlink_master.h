@@ -47,8 +47,9 @@ class VisitedLinkMaster : public VisitedLinkCommon {
    public:
     virtual ~Listener() {}
 
-    // Called when link coloring database has been created or replaced. The
-    // argument is the new table handle.
+    // Called when a shard of the link coloring database has been created or
+    // replaced. The argument is the new shard handle, whose header tells which
+    // shard it is.
     virtual void NewTable(base::SharedMemory*) = 0;
 
     // Called when new link has been added. The argument is the fingerprint
@@ -67,8 +68,8 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // In unit test mode, we allow the caller to optionally specify the database
   // filename so that it can be run from a unit test. The directory where this
   // file resides must exist in this mode. You can also specify the default
-  // table size to test table resizing. If this parameter is 0, we will use the
-  // defaults.
+  // size of each shard to test table resizing. If this parameter is 0, we will
+  // use the defaults.
   //
   // In the unit test mode, we also allow the caller to provide a history
   // service pointer (the history service can't be fetched from the browser
@@ -92,7 +93,10 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // object won't work.
   bool Init();
 
-  base::SharedMemory* shared_memory() { return shared_memory_; }
+  // Returns the shared memory of the given shard.
+  base::SharedMemory* shared_memory(int shard) {
+    return shared_memory_[shard];
+  }
 
   // Adds a URL to the table.
   void AddURL(const GURL& url);
@@ -140,7 +144,10 @@ class VisitedLinkMaster : public VisitedLinkCommon {
 
   // returns the number of items in the table for testing verification
   int32 GetUsedCount() const {
-    return used_items_;
+    int32 used_count = 0;
+    for (int i = 0; i < kShardCount; i++)
+      used_count += used_items_[i];
+    return used_count;
   }
 
   // Returns the listener.
@@ -159,6 +166,7 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, Delete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigDelete);
   FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, BigImport);
+  FRIEND_TEST_ALL_PREFIXES(VisitedLinkTest, ResizeOneShard);
 
   // Object to rebuild the table on the history thread (see the .cc file).
   class TableBuilder;
@@ -166,10 +174,14 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // Byte offsets of values in the header.
   static const int32 kFileHeaderSignatureOffset;
   static const int32 kFileHeaderVersionOffset;
-  static const int32 kFileHeaderLengthOffset;
-  static const int32 kFileHeaderUsedOffset;
+  static const int32 kFileHeaderShardCountOffset;
   static const int32 kFileHeaderSaltOffset;
 
+  // Byte offsets of values in the header of each shard, which follow the file
+  // header in shard order.
+  static const int32 kFileShardLengthOffset;
+  static const int32 kFileShardUsedOffset;
+
   // The signature at the beginning of a file.
   static const int32 kFileSignature;
 
@@ -179,7 +191,10 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // Bytes in the file header, including the salt.
   static const size_t kFileHeaderSize;
 
-  // When creating a fresh new table, we use this many entries.
+  // Bytes in the header of each shard.
+  static const size_t kFileShardHeaderSize;
+
+  // When creating a fresh new table, we use this many entries in each shard.
   static const unsigned kDefaultTableSize;
 
   // When the user is deleting a boatload of URLs, we don't really want to do
@@ -192,8 +207,9 @@ class VisitedLinkMaster : public VisitedLinkCommon {
 
   // If a rebuild is in progress, we save the URL in the temporary list.
   // Otherwise, we add this to the table. Returns the index of the
-  // inserted fingerprint or null_hash_ on failure.
-  Hash TryToAddURL(const GURL& url);
+  // inserted fingerprint in the shard put in |shard|, or null_hash_ on
+  // failure.
+  Hash TryToAddURL(const GURL& url, int* shard);
 
   // File I/O functions
   // ------------------
@@ -207,6 +223,15 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // the handle to it will be stored in file_.
   void WriteFullTable();
 
+  // Writes the headers and the shards from |first_shard| on to disk. The
+  // shards before it must be unchanged on disk since the last write. Used
+  // when |first_shard| is resized, since this moves the shards after it in
+  // the file.
+  void WriteTableFromShard(int first_shard);
+
+  // Returns the offset of the given shard in the file.
+  off_t ShardFileOffset(int shard) const;
+
   // Try to load the table from the database file. If the file doesn't exist or
   // is corrupt, this will return failure.
   bool InitFromFile();
@@ -215,10 +240,12 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // file pointer is at the beginning of the file and that there are no pending
   // asynchronous I/O operations.
   //
-  // Returns true on success and places the size of the table in num_entries
-  // and the number of nonzero fingerprints in used_count. This will fail if
+  // Returns true on success and places the size of each shard in num_entries
+  // and its number of nonzero fingerprints in used_count. This will fail if
   // the version of the file is not the current version of the database.
-  bool ReadFileHeader(FILE* hfile, int32* num_entries, int32* used_count,
+  bool ReadFileHeader(FILE* hfile,
+                      int32 num_entries[kShardCount],
+                      int32 used_count[kShardCount],
                       uint8 salt[LINK_SALT_LENGTH]);
 
   // Fills *filename with the name of the link database filename
@@ -228,14 +255,14 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // the write to a background thread.
   void WriteToFile(FILE** hfile, off_t offset, void* data, int32 data_size);
 
-  // Helper function to schedule and asynchronous write of the used count to
-  // disk (this is a common operation).
-  void WriteUsedItemCountToFile();
+  // Helper function to schedule and asynchronous write of the used count of a
+  // shard to disk (this is a common operation).
+  void WriteUsedItemCountToFile(int shard);
 
   // Helper function to schedule an asynchronous write of the given range of
-  // hash functions to disk. The range is inclusive on both ends. The range can
-  // wrap around at 0 and this function will handle it.
-  void WriteHashRangeToFile(Hash first_hash, Hash last_hash);
+  // hash functions of a shard to disk. The range is inclusive on both ends.
+  // The range can wrap around at 0 and this function will handle it.
+  void WriteHashRangeToFile(int shard, Hash first_hash, Hash last_hash);
 
   // Synchronous read from the file. Assumes there are no pending asynchronous
   // I/O functions. Returns true if the entire buffer was successfully filled.
@@ -269,43 +296,44 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // database and for unit tests.
   bool InitFromScratch(bool suppress_rebuild);
 
-  // Allocates the Fingerprint structure and length. When init_to_empty is set,
-  // the table will be filled with 0s and used_items_ will be set to 0 as well.
-  // If the flag is not set, these things are untouched and it is the
-  // responsibility of the caller to fill them (like when we are reading from
-  // a file).
-  bool CreateURLTable(int32 num_entries, bool init_to_empty);
-
-  // A wrapper for CreateURLTable, this will allocate a new table, initialized
-  // to empty. The caller is responsible for saving the shared memory pointer
-  // and handles before this call (they will be replaced with new ones) and
-  // releasing them later. This is designed for callers that make a new table
-  // and then copy values from the old table to the new one, then release the
-  // old table.
-  //
-  // Returns true on success. On failure, the old table will be restored. The
-  // caller should not attemp to release the pointer/handle in this case.
-  bool BeginReplaceURLTable(int32 num_entries);
+  // Allocates the shared memory for an empty shard of |num_entries| entries,
+  // with its header filled in. The salt should already be filled in. Returns
+  // NULL on failure.
+  base::SharedMemory* CreateShardMemory(int shard, int32 num_entries);
+
+  // Makes |shared_memory|, as returned by CreateShardMemory, the given shard,
+  // with no used items. The caller is responsible for releasing the previous
+  // shared memory of the shard. This is designed for callers that make a new
+  // shard and then copy values from the old shard to the new one, then
+  // release the old shard, which the slaves keep reading until they get the
+  // new one.
+  void SetShard(int shard, base::SharedMemory* shared_memory);
 
   // unallocates the Fingerprint table
   void FreeURLTable();
 
-  // For growing the table. ResizeTableIfNecessary will check to see if the
-  // table should be resized and calls ResizeTable if needed. Returns true if
-  // we decided to resize the table.
-  bool ResizeTableIfNecessary();
+  // For growing the table. ResizeShardIfNecessary will check to see if the
+  // shard should be resized and calls ResizeShard if needed. Returns true if
+  // we decided to resize the shard. The caller is responsible for writing the
+  // resized shard to disk.
+  bool ResizeShardIfNecessary(int shard);
+
+  // Calls ResizeShardIfNecessary for all the shards. Returns the first shard
+  // which was resized, or kShardCount if none was.
+  int ResizeShardsIfNecessary();
 
-  // Resizes the table (growing or shrinking) as necessary to accomodate the
-  // current count.
-  void ResizeTable(int32 new_size);
+  // Resizes the shard (growing or shrinking) as necessary to accomodate its
+  // current count, and sends it to the listener.
+  void ResizeShard(int shard, int32 new_size);
 
-  // Returns the desired table size for |item_count| URLs.
+  // Returns the desired shard size for |item_count| URLs.
   uint32 NewTableSizeForCount(int32 item_count) const;
 
-  // Computes the table load as fraction. For example, if 1/4 of the entries are
-  // full, this value will be 0.25
-  float ComputeTableLoad() const {
-    return static_cast<float>(used_items_) / static_cast<float>(table_length_);
+  // Computes the shard load as fraction. For example, if 1/4 of the entries
+  // are full, this value will be 0.25
+  float ComputeTableLoad(int shard) const {
+    return static_cast<float>(used_items_[shard]) /
+           static_cast<float>(shards_[shard].length);
   }
 
   // Initializes a rebuild of the visited link database based on the browser
@@ -324,16 +352,16 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   void OnTableRebuildComplete(bool success,
                               const std::vector<Fingerprint>& fingerprints);
 
-  // Increases or decreases the given hash value by one, wrapping around as
-  // necessary. Used for probing.
-  inline Hash IncrementHash(Hash hash) {
-    if (hash >= table_length_ - 1)
+  // Increases or decreases the given hash value of a shard by one, wrapping
+  // around as necessary. Used for probing.
+  inline Hash IncrementHash(int shard, Hash hash) {
+    if (hash >= shards_[shard].length - 1)
       return 0;  // Wrap around.
     return hash + 1;
   }
-  inline Hash DecrementHash(Hash hash) {
+  inline Hash DecrementHash(int shard, Hash hash) {
     if (hash <= 0)
-      return table_length_ - 1;  // Wrap around.
+      return shards_[shard].length - 1;  // Wrap around.
     return hash - 1;
   }
 
@@ -390,15 +418,15 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // VisitedLinkDelegate::RebuildTable if there are disk corruptions.
   bool persist_to_disk_;
 
-  // Shared memory consists of a SharedHeader followed by the table.
-  base::SharedMemory *shared_memory_;
+  // Each shared memory consists of a SharedHeader followed by a shard.
+  base::SharedMemory* shared_memory_[kShardCount];
 
-  // When we generate new tables, we increment the serial number of the
+  // When we generate new shards, we increment the serial number of the
   // shared memory object.
   int32 shared_memory_serial_;
 
-  // Number of non-empty items in the table, used to compute fullness.
-  int32 used_items_;
+  // Number of non-empty items in each shard, used to compute fullness.
+  int32 used_items_[kShardCount];
 
   // Testing values -----------------------------------------------------------
   //
@@ -411,7 +439,7 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // Overridden database file name for testing
   base::FilePath database_name_override_;
 
-  // When nonzero, overrides the table size for new databases for testing
+  // When nonzero, overrides the shard size for new databases for testing
   int32 table_size_override_;
 
   // When set, indicates the task that should be run after the next rebuild from
@@ -431,12 +459,14 @@ class VisitedLinkMaster : public VisitedLinkCommon {
 
 #if defined(UNIT_TEST) || defined(PERF_TEST) || !defined(NDEBUG)
 inline void VisitedLinkMaster::DebugValidate() {
-  int32 used_count = 0;
-  for (int32 i = 0; i < table_length_; i++) {
-    if (hash_table_[i])
-      used_count++;
+  for (int shard = 0; shard < kShardCount; shard++) {
+    int32 used_count = 0;
+    for (int32 i = 0; i < shards_[shard].length; i++) {
+      if (shards_[shard].hash_table[i])
+        used_count++;
+    }
+    DCHECK_EQ(used_count, used_items_[shard]);
   }
-  DCHECK_EQ(used_count, used_items_);
 }
 #endif
 
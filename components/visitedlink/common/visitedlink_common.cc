@@ -15,9 +15,7 @@ namespace visitedlink {
 const VisitedLinkCommon::Fingerprint VisitedLinkCommon::null_fingerprint_ = 0;
 const VisitedLinkCommon::Hash VisitedLinkCommon::null_hash_ = -1;
 
-VisitedLinkCommon::VisitedLinkCommon()
-    : hash_table_(NULL),
-      table_length_(0) {
+VisitedLinkCommon::VisitedLinkCommon() {
   memset(salt_, 0, sizeof(salt_));
 }
 
@@ -30,8 +28,6 @@ bool VisitedLinkCommon::IsVisited(const char* canonical_url,
                                   size_t url_len) const {
   if (url_len == 0)
     return false;
-  if (!hash_table_ || table_length_ == 0)
-    return false;
   return IsVisited(ComputeURLFingerprint(canonical_url, url_len));
 }
 
@@ -43,10 +39,14 @@ bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
   // Go through the table until we find the item or an empty spot (meaning it
   // wasn't found). This loop will terminate as long as the table isn't full,
   // which should be enforced by AddFingerprint.
-  Hash first_hash = HashFingerprint(fingerprint);
+  int shard = ShardForFingerprint(fingerprint);
+  int32 table_length = shards_[shard].length;
+  if (!shards_[shard].hash_table || table_length == 0)
+    return false;
+  Hash first_hash = HashFingerprint(fingerprint, table_length);
   Hash cur_hash = first_hash;
   while (true) {
-    Fingerprint cur_fingerprint = FingerprintAt(cur_hash);
+    Fingerprint cur_fingerprint = FingerprintAt(shard, cur_hash);
     if (cur_fingerprint == null_fingerprint_)
       return false;  // End of probe sequence found.
     if (cur_fingerprint == fingerprint)
@@ -55,7 +55,7 @@ bool VisitedLinkCommon::IsVisited(Fingerprint fingerprint) const {
     // This spot was taken, but not by the item we're looking for, search in
     // the next position.
     cur_hash++;
-    if (cur_hash == table_length_)
+    if (cur_hash == table_length)
       cur_hash = 0;
     if (cur_hash == first_hash) {
       // Wrapped around and didn't find an empty space, this means we're in an
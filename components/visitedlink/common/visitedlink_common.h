@@ -21,7 +21,7 @@ namespace visitedlink {
 // VisitedLinkMaster), while all other processes should be read-only
 // (implemented by VisitedLinkSlave). These other processes add links by calling
 // the writer process to add them for it. The writer may also notify the readers
-// to replace their table when the table is resized.
+// to replace a shard of their table when the shard is resized.
 //
 // IPC is not implemented in these classes. This is done through callback
 // functions supplied by the creator of these objects to allow more flexibility,
@@ -35,6 +35,10 @@ namespace visitedlink {
 // master does a lot of work to manage the table, reading and writing it to and
 // from disk, and resizing it when it gets too full.
 //
+// The table is split into kShardCount shards, selected by the top bits of the
+// fingerprints. Each shard lives in its own shared memory, so that resizing
+// one only rehashes and resends that shard while the others stay mapped.
+//
 // To ask whether a page is in history, we compute a 64-bit fingerprint of the
 // URL. This URL is hashed and we see if it is in the URL hashtable. If it is,
 // we consider it visited. Otherwise, it is unvisited. Note that it is possible
@@ -55,6 +59,11 @@ class VisitedLinkCommon {
   static const Fingerprint null_fingerprint_;
   static const Hash null_hash_;
 
+  // The number of shards of the table, selected by the top kShardBits bits
+  // of the fingerprints.
+  static const int kShardBits = 4;
+  static const int kShardCount = 1 << kShardBits;
+
   VisitedLinkCommon();
   virtual ~VisitedLinkCommon();
 
@@ -72,11 +81,12 @@ class VisitedLinkCommon {
   bool IsVisited(Fingerprint fingerprint) const;
 
 #ifdef UNIT_TEST
-  // Returns statistics about DB usage
-  void GetUsageStatistics(int32* table_size,
+  // Returns statistics about DB usage for the given shard.
+  void GetUsageStatistics(int shard,
+                          int32* table_size,
                           VisitedLinkCommon::Fingerprint** fingerprints) {
-    *table_size = table_length_;
-    *fingerprints = hash_table_;
+    *table_size = shards_[shard].length;
+    *fingerprints = shards_[shard].hash_table;
   }
 #endif
 
@@ -84,20 +94,39 @@ class VisitedLinkCommon {
   // This structure is at the beginning of the shared memory so that the slaves
   // can get stats on the table
   struct SharedHeader {
-    // see goes into table_length_
+    // goes into the length of the shard
     uint32 length;
 
+    // the index of the shard that follows this header
+    uint32 shard;
+
     // goes into salt_
     uint8 salt[LINK_SALT_LENGTH];
   };
 
-  // Returns the fingerprint at the given index into the URL table. This
+  // One shard of the table.
+  struct Shard {
+    Shard() : hash_table(NULL), length(0) {}
+
+    // pointer to the first item
+    Fingerprint* hash_table;
+
+    // the number of items in the hash table
+    int32 length;
+  };
+
+  // Returns the shard holding the given fingerprint.
+  static int ShardForFingerprint(Fingerprint fingerprint) {
+    return static_cast<int>(fingerprint >> (64 - kShardBits));
+  }
+
+  // Returns the fingerprint at the given index into the given shard. This
   // function should be called instead of accessing the table directly to
   // contain endian issues.
-  Fingerprint FingerprintAt(int32 table_offset) const {
-    if (!hash_table_)
+  Fingerprint FingerprintAt(int shard, int32 table_offset) const {
+    if (!shards_[shard].hash_table)
       return null_fingerprint_;
-    return hash_table_[table_offset];
+    return shards_[shard].hash_table[table_offset];
   }
 
   // Computes the fingerprint of the given canonical URL. It is static so the
@@ -115,16 +144,13 @@ class VisitedLinkCommon {
       return null_hash_;
     return static_cast<Hash>(fingerprint % table_length);
   }
-  // Uses the current hashtable.
+  // Uses the current shard of the fingerprint.
   Hash HashFingerprint(Fingerprint fingerprint) const {
-    return HashFingerprint(fingerprint, table_length_);
+    return HashFingerprint(fingerprint,
+                           shards_[ShardForFingerprint(fingerprint)].length);
   }
 
-  // pointer to the first item
-  VisitedLinkCommon::Fingerprint* hash_table_;
-
-  // the number of items in the hash table
-  int32 table_length_;
+  Shard shards_[kShardCount];
 
   // salt used for each URL when computing the fingerprint
   uint8 salt_[LINK_SALT_LENGTH];
@@ -12,9 +12,10 @@
 
 #define IPC_MESSAGE_START VisitedLinkMsgStart
 
-// History system notification that the visited link database has been
-// replaced. It has one SharedMemoryHandle argument consisting of the table
-// handle. This handle is valid in the context of the renderer
+// History system notification that a shard of the visited link database has
+// been replaced. It has one SharedMemoryHandle argument consisting of the
+// shard handle, whose header tells which shard it is. This handle is valid in
+// the context of the renderer
 IPC_MESSAGE_CONTROL1(ChromeViewMsg_VisitedLink_NewTable,
                      base::SharedMemoryHandle)
 
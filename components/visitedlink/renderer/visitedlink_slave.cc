@@ -5,6 +5,7 @@
 #include "components/visitedlink/renderer/visitedlink_slave.h"
 
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "components/visitedlink/common/visitedlink_messages.h"
 #include "third_party/WebKit/public/web/WebView.h"
@@ -13,7 +14,10 @@ using blink::WebView;
 
 namespace visitedlink {
 
-VisitedLinkSlave::VisitedLinkSlave() : shared_memory_(NULL) {}
+VisitedLinkSlave::VisitedLinkSlave() {
+  for (int i = 0; i < kShardCount; i++)
+    shared_memory_[i] = NULL;
+}
 
 VisitedLinkSlave::~VisitedLinkSlave() {
   FreeTable();
@@ -31,43 +35,47 @@ bool VisitedLinkSlave::OnControlMessageReceived(const IPC::Message& message) {
   return handled;
 }
 
-// This function's job is to initialize the table with the given
-// shared memory handle. This memory is mapped into the process.
+// This function's job is to initialize a shard of the table with the given
+// shared memory handle. This memory is mapped into the process. The other
+// shards stay mapped, so the links they hold keep being colored.
 void VisitedLinkSlave::OnUpdateVisitedLinks(base::SharedMemoryHandle table) {
   DCHECK(base::SharedMemory::IsHandleValid(table)) << "Bad table handle";
-  // since this function may be called again to change the table, we may need
-  // to free old objects
-  FreeTable();
-  DCHECK(shared_memory_ == NULL && hash_table_ == NULL);
 
   // create the shared memory object
-  shared_memory_ = new base::SharedMemory(table, true);
-  if (!shared_memory_)
-    return;
+  scoped_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(table, true));
 
-  // map the header into our process so we can see how long the rest is,
-  // and set the salt
-  if (!shared_memory_->Map(sizeof(SharedHeader)))
+  // map the header into our process so we can see which shard this is and
+  // how long the rest is, and set the salt
+  if (!shared_memory->Map(sizeof(SharedHeader)))
     return;
   SharedHeader* header =
-    static_cast<SharedHeader*>(shared_memory_->memory());
+    static_cast<SharedHeader*>(shared_memory->memory());
   DCHECK(header);
   int32 table_len = header->length;
+  uint32 shard = header->shard;
   memcpy(salt_, header->salt, sizeof(salt_));
-  shared_memory_->Unmap();
-
-  // now do the whole table because we know the length
-  if (!shared_memory_->Map(sizeof(SharedHeader) +
-                          table_len * sizeof(Fingerprint))) {
-    shared_memory_->Close();
+  shared_memory->Unmap();
+  if (shard >= static_cast<uint32>(kShardCount)) {
+    NOTREACHED() << "Bad shard index";
     return;
   }
 
+  // since this function may be called again to change the shard, we may need
+  // to free old objects
+  FreeShard(shard);
+
+  // now do the whole shard because we know the length
+  if (!shared_memory->Map(sizeof(SharedHeader) +
+                          table_len * sizeof(Fingerprint)))
+    return;
+
   // commit the data
-  DCHECK(shared_memory_->memory());
-  hash_table_ = reinterpret_cast<Fingerprint*>(
-      static_cast<char*>(shared_memory_->memory()) + sizeof(SharedHeader));
-  table_length_ = table_len;
+  DCHECK(shared_memory->memory());
+  shards_[shard].hash_table = reinterpret_cast<Fingerprint*>(
+      static_cast<char*>(shared_memory->memory()) + sizeof(SharedHeader));
+  shards_[shard].length = table_len;
+  shared_memory_[shard] = shared_memory.release();
 }
 
 void VisitedLinkSlave::OnAddVisitedLinks(
@@ -81,12 +89,17 @@ void VisitedLinkSlave::OnResetVisitedLinks() {
 }
 
 void VisitedLinkSlave::FreeTable() {
-  if (shared_memory_) {
-    delete shared_memory_;
-    shared_memory_ = NULL;
+  for (int i = 0; i < kShardCount; i++)
+    FreeShard(i);
+}
+
+void VisitedLinkSlave::FreeShard(int shard) {
+  if (shared_memory_[shard]) {
+    delete shared_memory_[shard];
+    shared_memory_[shard] = NULL;
   }
-  hash_table_ = NULL;
-  table_length_ = 0;
+  shards_[shard].hash_table = NULL;
+  shards_[shard].length = 0;
 }
 
 }  // namespace visitedlink
@@ -30,9 +30,10 @@ class VisitedLinkSlave : public VisitedLinkCommon,
 
  private:
   void FreeTable();
+  void FreeShard(int shard);
 
-  // shared memory consists of a SharedHeader followed by the table
-  base::SharedMemory* shared_memory_;
+  // each shared memory consists of a SharedHeader followed by a shard
+  base::SharedMemory* shared_memory_[kShardCount];
 
   DISALLOW_COPY_AND_ASSIGN(VisitedLinkSlave);
 };
@@ -44,6 +44,25 @@ class DummyVisitedLinkEventListener : public VisitedLinkMaster::Listener {
   virtual void Reset() OVERRIDE {}
 };
 
+// Counts the table bytes that would be sent to each renderer.
+class CountingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
+ public:
+  CountingVisitedLinkEventListener() : new_table_count_(0), sent_bytes_(0) {}
+  virtual void NewTable(base::SharedMemory* table) OVERRIDE {
+    new_table_count_++;
+    sent_bytes_ += table->mapped_size();
+  }
+  virtual void Add(VisitedLinkCommon::Fingerprint) OVERRIDE {}
+  virtual void Reset() OVERRIDE {}
+
+  int new_table_count() const { return new_table_count_; }
+  size_t sent_bytes() const { return sent_bytes_; }
+
+ private:
+  int new_table_count_;
+  size_t sent_bytes_;
+};
+
 
 // this checks IsVisited for the URLs starting with the given prefix and
 // within the given range
@@ -198,4 +217,33 @@ TEST_F(VisitedLink, TestLoad) {
       "Visited_link_hot_load_time", hot_sum / hot_load_times.size(), "ms");
 }
 
+// Tests how long adding a URL can block while the table grows, and how much
+// of the table has to be sent again to each renderer because of the growth.
+TEST_F(VisitedLink, TestGrowth) {
+  CountingVisitedLinkEventListener* listener =
+      new CountingVisitedLinkEventListener();
+  VisitedLinkMaster master(listener, NULL, false, true, db_path_, 0);
+  ASSERT_TRUE(master.Init());
+  int initial_new_table_count = listener->new_table_count();
+  size_t initial_sent_bytes = listener->sent_bytes();
+
+  base::PerfTimeLogger timer("Visited_link_growth");
+  TimeDelta max_add_time;
+  for (int i = 0; i < load_test_add_count; i++) {
+    base::ElapsedTimer add_timer;
+    master.AddURL(TestURL(added_prefix, i));
+    max_add_time = std::max(max_add_time, add_timer.Elapsed());
+  }
+  timer.Done();
+
+  base::LogPerfResult("Visited_link_growth_max_add_time",
+                      max_add_time.InMillisecondsF(), "ms");
+  base::LogPerfResult("Visited_link_growth_new_tables",
+                      listener->new_table_count() - initial_new_table_count,
+                      "tables");
+  base::LogPerfResult("Visited_link_growth_sent_bytes",
+                      static_cast<double>(listener->sent_bytes() -
+                                          initial_sent_bytes) / 1024, "kb");
+}
+
 }  // namespace visitedlink
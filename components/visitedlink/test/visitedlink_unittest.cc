@@ -107,9 +107,11 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
  public:
   TrackingVisitedLinkEventListener()
       : reset_count_(0),
-        add_count_(0) {}
+        add_count_(0),
+        new_table_count_(0) {}
 
   virtual void NewTable(base::SharedMemory* table) OVERRIDE {
+    new_table_count_++;
     if (table) {
       for (std::vector<VisitedLinkSlave>::size_type i = 0;
            i < g_slaves.size(); i++) {
@@ -125,14 +127,17 @@ class TrackingVisitedLinkEventListener : public VisitedLinkMaster::Listener {
   void SetUp() {
     reset_count_ = 0;
     add_count_ = 0;
+    new_table_count_ = 0;
   }
 
   int reset_count() const { return reset_count_; }
   int add_count() const { return add_count_; }
+  int new_table_count() const { return new_table_count_; }
 
  private:
   int reset_count_;
   int add_count_;
+  int new_table_count_;
 };
 
 class VisitedLinkTest : public testing::Test {
@@ -152,6 +157,16 @@ class VisitedLinkTest : public testing::Test {
     return master_->Init();
   }
 
+  // Maps all the shards of the master into |slave|.
+  void ShareTable(VisitedLinkSlave* slave) {
+    for (int i = 0; i < VisitedLinkCommon::kShardCount; i++) {
+      base::SharedMemoryHandle new_handle = base::SharedMemory::NULLHandle();
+      master_->shared_memory(i)->ShareToProcess(
+          base::GetCurrentProcessHandle(), &new_handle);
+      slave->OnUpdateVisitedLinks(new_handle);
+    }
+  }
+
   // May be called multiple times (some tests will do this to clear things,
   // and TearDown will do this to make sure eveything is shiny before quitting.
   void ClearDB() {
@@ -178,10 +193,7 @@ class VisitedLinkTest : public testing::Test {
 
     // Create a slave database.
     VisitedLinkSlave slave;
-    base::SharedMemoryHandle new_handle = base::SharedMemory::NULLHandle();
-    master_->shared_memory()->ShareToProcess(
-        base::GetCurrentProcessHandle(), &new_handle);
-    slave.OnUpdateVisitedLinks(new_handle);
+    ShareTable(&slave);
     g_slaves.push_back(&slave);
 
     bool found;
@@ -248,7 +260,7 @@ TEST_F(VisitedLinkTest, Delete) {
   ASSERT_TRUE(InitVisited(kInitialSize, true));
 
   // Add a cluster from 14-17 wrapping around to 0. These will all hash to the
-  // same value.
+  // same value, in the first shard.
   const VisitedLinkCommon::Fingerprint kFingerprint0 = kInitialSize * 0 + 14;
   const VisitedLinkCommon::Fingerprint kFingerprint1 = kInitialSize * 1 + 14;
   const VisitedLinkCommon::Fingerprint kFingerprint2 = kInitialSize * 2 + 14;
@@ -262,11 +274,12 @@ TEST_F(VisitedLinkTest, Delete) {
 
   // Deleting 14 should move the next value up one slot (we do not specify an
   // order).
-  EXPECT_EQ(kFingerprint3, master_->hash_table_[0]);
+  VisitedLinkCommon::Fingerprint* hash_table = master_->shards_[0].hash_table;
+  EXPECT_EQ(kFingerprint3, hash_table[0]);
   master_->DeleteFingerprint(kFingerprint3, false);
   VisitedLinkCommon::Fingerprint zero_fingerprint = 0;
-  EXPECT_EQ(zero_fingerprint, master_->hash_table_[1]);
-  EXPECT_NE(zero_fingerprint, master_->hash_table_[0]);
+  EXPECT_EQ(zero_fingerprint, hash_table[1]);
+  EXPECT_NE(zero_fingerprint, hash_table[0]);
 
   // Deleting the other four should leave the table empty.
   master_->DeleteFingerprint(kFingerprint0, false);
@@ -274,9 +287,9 @@ TEST_F(VisitedLinkTest, Delete) {
   master_->DeleteFingerprint(kFingerprint2, false);
   master_->DeleteFingerprint(kFingerprint4, false);
 
-  EXPECT_EQ(0, master_->used_items_);
+  EXPECT_EQ(0, master_->used_items_[0]);
   for (int i = 0; i < kInitialSize; i++)
-    EXPECT_EQ(zero_fingerprint, master_->hash_table_[i]) <<
+    EXPECT_EQ(zero_fingerprint, hash_table[i]) <<
         "Hash table has values in it.";
 }
 
@@ -311,10 +324,7 @@ TEST_F(VisitedLinkTest, DeleteAll) {
 
   {
     VisitedLinkSlave slave;
-    base::SharedMemoryHandle new_handle = base::SharedMemory::NULLHandle();
-    master_->shared_memory()->ShareToProcess(
-        base::GetCurrentProcessHandle(), &new_handle);
-    slave.OnUpdateVisitedLinks(new_handle);
+    ShareTable(&slave);
     g_slaves.push_back(&slave);
 
     // Add the test URLs.
@@ -358,10 +368,7 @@ TEST_F(VisitedLinkTest, Resizing) {
 
   // ...and a slave
   VisitedLinkSlave slave;
-  base::SharedMemoryHandle new_handle = base::SharedMemory::NULLHandle();
-  master_->shared_memory()->ShareToProcess(
-      base::GetCurrentProcessHandle(), &new_handle);
-  slave.OnUpdateVisitedLinks(new_handle);
+  ShareTable(&slave);
   g_slaves.push_back(&slave);
 
   int32 used_count = master_->GetUsedCount();
@@ -374,24 +381,28 @@ TEST_F(VisitedLinkTest, Resizing) {
   }
 
   // Verify that the table got resized sufficiently.
-  int32 table_size;
-  VisitedLinkCommon::Fingerprint* table;
-  master_->GetUsageStatistics(&table_size, &table);
+  int32 table_size = 0;
+  for (int shard = 0; shard < VisitedLinkCommon::kShardCount; shard++) {
+    int32 shard_size;
+    VisitedLinkCommon::Fingerprint* table;
+    master_->GetUsageStatistics(shard, &shard_size, &table);
+    table_size += shard_size;
+
+    // Verify that the slave got the resize message and has the same
+    // shard information.
+    int32 child_shard_size;
+    VisitedLinkCommon::Fingerprint* child_table;
+    slave.GetUsageStatistics(shard, &child_shard_size, &child_table);
+    ASSERT_EQ(shard_size, child_shard_size);
+    for (int32 i = 0; i < shard_size; i++) {
+      ASSERT_EQ(table[i], child_table[i]);
+    }
+  }
   used_count = master_->GetUsedCount();
   ASSERT_GT(table_size, used_count);
   ASSERT_EQ(used_count, g_test_count) <<
                 "table count doesn't match the # of things we added";
 
-  // Verify that the slave got the resize message and has the same
-  // table information.
-  int32 child_table_size;
-  VisitedLinkCommon::Fingerprint* child_table;
-  slave.GetUsageStatistics(&child_table_size, &child_table);
-  ASSERT_EQ(table_size, child_table_size);
-  for (int32 i = 0; i < table_size; i++) {
-    ASSERT_EQ(table[i], child_table[i]);
-  }
-
   master_->DebugValidate();
   g_slaves.clear();
 
@@ -400,6 +411,57 @@ TEST_F(VisitedLinkTest, Resizing) {
   Reload();
 }
 
+// Tests that growing a shard only replaces that shard, in the slaves and on
+// disk.
+TEST_F(VisitedLinkTest, ResizeOneShard) {
+  const int32 initial_size = 17;
+  ASSERT_TRUE(InitVisited(initial_size, true));
+  TrackingVisitedLinkEventListener* listener =
+      static_cast<TrackingVisitedLinkEventListener*>(master_->GetListener());
+
+  VisitedLinkSlave slave;
+  ShareTable(&slave);
+  g_slaves.push_back(&slave);
+  listener->SetUp();
+
+  // Add enough URLs falling in a shard in the middle of the table to make it
+  // grow.
+  const int kResizedShard = VisitedLinkCommon::kShardCount / 2;
+  URLs urls;
+  for (int i = 0; urls.size() < static_cast<size_t>(initial_size); i++) {
+    GURL url(TestURL(i));
+    VisitedLinkCommon::Fingerprint fingerprint =
+        master_->ComputeURLFingerprint(url.spec().data(), url.spec().size());
+    if (VisitedLinkMaster::ShardForFingerprint(fingerprint) != kResizedShard)
+      continue;
+    master_->AddURL(url);
+    urls.push_back(url);
+  }
+  master_->DebugValidate();
+
+  EXPECT_EQ(1, listener->new_table_count());
+  for (int shard = 0; shard < VisitedLinkCommon::kShardCount; shard++) {
+    int32 shard_size;
+    VisitedLinkCommon::Fingerprint* table;
+    slave.GetUsageStatistics(shard, &shard_size, &table);
+    if (shard == kResizedShard)
+      EXPECT_LT(initial_size, shard_size);
+    else
+      EXPECT_EQ(initial_size, shard_size);
+  }
+  for (size_t i = 0; i < urls.size(); i++)
+    EXPECT_TRUE(slave.IsVisited(urls[i]));
+  g_slaves.clear();
+
+  // The shards after the resized one moved in the file.
+  ClearDB();
+  ASSERT_TRUE(InitVisited(0, true));
+  master_->DebugValidate();
+  EXPECT_EQ(static_cast<int32>(urls.size()), master_->GetUsedCount());
+  for (size_t i = 0; i < urls.size(); i++)
+    EXPECT_TRUE(master_->IsVisited(urls[i]));
+}
+
 // Tests that if the database doesn't exist, it will be rebuilt from history.
 TEST_F(VisitedLinkTest, Rebuild) {
   // Add half of our URLs to history. This needs to be done before we
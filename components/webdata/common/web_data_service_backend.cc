@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/location.h"
+#include "base/time/time.h"
 #include "components/webdata/common/web_data_request_manager.h"
 #include "components/webdata/common/web_database.h"
 #include "components/webdata/common/web_database_table.h"
@@ -13,6 +14,14 @@
 using base::Bind;
 using base::FilePath;
 
+namespace {
+
+// How long the commit following a write waits for more writes to batch with
+// it. Short enough that little is lost if the browser crashes.
+const int kCommitDelayMs = 100;
+
+}  // namespace
+
 WebDataServiceBackend::WebDataServiceBackend(
     const FilePath& path,
     Delegate* delegate,
@@ -22,7 +31,10 @@ WebDataServiceBackend::WebDataServiceBackend(
       request_manager_(new WebDataRequestManager()),
       init_status_(sql::INIT_FAILURE),
       init_complete_(false),
-      delegate_(delegate) {
+      delegate_(delegate),
+      db_thread_(db_thread),
+      commit_pending_(false),
+      commit_factory_(this) {
 }
 
 void WebDataServiceBackend::AddTable(scoped_ptr<WebDatabaseTable> table) {
@@ -62,6 +74,8 @@ sql::InitStatus WebDataServiceBackend::LoadDatabaseIfNecessary() {
 }
 
 void WebDataServiceBackend::ShutdownDatabase(bool should_reinit) {
+  commit_factory_.InvalidateWeakPtrs();
+  commit_pending_ = false;
   if (db_ && init_status_ == sql::INIT_OK)
     db_->CommitTransaction();
   db_.reset(NULL);
@@ -87,7 +101,7 @@ void WebDataServiceBackend::ExecuteWriteTask(
   if (db_ && init_status_ == sql::INIT_OK) {
     WebDatabase::State state = task.Run(db_.get());
     if (state == WebDatabase::COMMIT_NEEDED)
-      Commit();
+      ScheduleCommit();
   }
 }
 
@@ -115,6 +129,7 @@ WebDataServiceBackend::~WebDataServiceBackend() {
 }
 
 void WebDataServiceBackend::Commit() {
+  commit_pending_ = false;
   if (db_ && init_status_ == sql::INIT_OK) {
     db_->CommitTransaction();
     db_->BeginTransaction();
@@ -122,3 +137,13 @@ void WebDataServiceBackend::Commit() {
     NOTREACHED() << "Commit scheduled after Shutdown()";
   }
 }
+
+void WebDataServiceBackend::ScheduleCommit() {
+  if (commit_pending_)
+    return;
+  commit_pending_ = true;
+  db_thread_->PostDelayedTask(
+      FROM_HERE,
+      Bind(&WebDataServiceBackend::Commit, commit_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kCommitDelayMs));
+}
@@ -13,6 +13,7 @@
 #include "base/memory/ref_counted_delete_on_message_loop.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
 #include "components/webdata/common/web_database_service.h"
 #include "components/webdata/common/webdata_export.h"
 
@@ -95,6 +96,12 @@ class WEBDATA_EXPORT WebDataServiceBackend
   // Commit the current transaction.
   void Commit();
 
+  // Makes sure a commit is posted to run shortly. All the writes made until
+  // it runs share its transaction, which saves a sync of the database file for
+  // each write when many are made in a row, such as while syncing, and keeps
+  // the reads queued behind them from waiting on the disk.
+  void ScheduleCommit();
+
   // Path to database file.
   base::FilePath db_path_;
 
@@ -124,6 +131,16 @@ class WEBDATA_EXPORT WebDataServiceBackend
   // Delegate. See the class definition above for more information.
   scoped_ptr<Delegate> delegate_;
 
+  // The DB thread, where the commits scheduled after writes are posted.
+  scoped_refptr<base::MessageLoopProxy> db_thread_;
+
+  // True if a commit is posted and has yet to run.
+  bool commit_pending_;
+
+  // Used to drop the scheduled commit when the database is shut down, which
+  // commits by itself. Only used on the DB thread.
+  base::WeakPtrFactory<WebDataServiceBackend> commit_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(WebDataServiceBackend);
 };
 
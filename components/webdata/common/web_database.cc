@@ -79,6 +79,7 @@ sql::InitStatus WebDatabase::Init(const base::FilePath& db_name) {
   // We shouldn't have much data and what access we currently have is quite
   // infrequent. So we go with a small cache size.
   db_.set_cache_size(32);
+  db_.set_mmap_size(4 * 1024 * 1024);
 
   // Run the database in exclusive mode. Nobody else should be accessing the
   // database while we're running, and this will give somewhat improved perf.
@@ -111,6 +111,7 @@
 
 #if defined(TCMALLOC_TRACE_MEMORY_SUPPORTED)
 #include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
+#include "third_party/tcmalloc/chromium/src/gperftools/malloc_hook_c.h"
 #endif
 
 #if defined(USE_X11)
@@ -528,6 +529,14 @@ void BrowserMainLoop::MainMessageLoopStart() {
       ::HeapProfilerWithPseudoStackStart,
       ::HeapProfilerStop,
       ::GetHeapProfile));
+  const size_t kMeanBytesBetweenSamples = 128 * 1024;
+  trace_memory_sampler_.reset(new base::debug::TraceMemorySampler(
+      base::MessageLoop::current()->message_loop_proxy(),
+      kMeanBytesBetweenSamples,
+      ::MallocHook_AddNewHook,
+      ::MallocHook_RemoveNewHook,
+      ::MallocHook_AddDeleteHook,
+      ::MallocHook_RemoveDeleteHook));
 #endif
 }
 
@@ -751,6 +760,7 @@ void BrowserMainLoop::ShutdownThreadsAndCleanUp() {
   }
 
   trace_memory_controller_.reset();
+  trace_memory_sampler_.reset();
   system_stats_monitor_.reset();
 
 #if !defined(OS_IOS)
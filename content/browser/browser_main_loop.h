@@ -21,6 +21,7 @@ class PowerMonitor;
 class SystemMonitor;
 namespace debug {
 class TraceMemoryController;
+class TraceMemorySampler;
 class TraceEventSystemStatsMonitor;
 }  // namespace debug
 }  // namespace base
@@ -177,6 +178,7 @@ class CONTENT_EXPORT BrowserMainLoop {
   scoped_ptr<base::Thread> indexed_db_thread_;
   scoped_ptr<MemoryObserver> memory_observer_;
   scoped_ptr<base::debug::TraceMemoryController> trace_memory_controller_;
+  scoped_ptr<base::debug::TraceMemorySampler> trace_memory_sampler_;
   scoped_ptr<base::debug::TraceEventSystemStatsMonitor> system_stats_monitor_;
 
   bool is_tracing_startup_;
@@ -13,6 +13,7 @@
 #include "content/browser/dom_storage/dom_storage_namespace.h"
 #include "content/browser/dom_storage/dom_storage_task_runner.h"
 #include "content/browser/dom_storage/local_storage_database_adapter.h"
+#include "content/browser/dom_storage/local_storage_leveldb_adapter.h"
 #include "content/browser/dom_storage/session_storage_database.h"
 #include "content/browser/dom_storage/session_storage_database_adapter.h"
 #include "content/common/dom_storage/dom_storage_map.h"
@@ -57,6 +58,7 @@ GURL DOMStorageArea::OriginFromDatabaseFileName(const base::FilePath& name) {
 
 DOMStorageArea::DOMStorageArea(
     const GURL& origin, const base::FilePath& directory,
+    LocalStorageDatabase* local_storage_database,
     DOMStorageTaskRunner* task_runner)
     : namespace_id_(kLocalStorageNamespaceId), origin_(origin),
       directory_(directory),
@@ -68,7 +70,12 @@ DOMStorageArea::DOMStorageArea(
       commit_batches_in_flight_(0) {
   if (!directory.empty()) {
     base::FilePath path = directory.Append(DatabaseFileNameFromOrigin(origin_));
-    backing_.reset(new LocalStorageDatabaseAdapter(path));
+    if (local_storage_database) {
+      backing_.reset(new LocalStorageLevelDBAdapter(local_storage_database,
+                                                    origin_, path));
+    } else {
+      backing_.reset(new LocalStorageDatabaseAdapter(path));
+    }
     is_initial_import_done_ = false;
   }
 }
@@ -262,7 +269,8 @@ void DOMStorageArea::PurgeMemory() {
                            kPerStorageAreaOverQuotaAllowance);
 
   // Recreate the database object, this frees up the open sqlite connection
-  // and its page cache.
+  // and its page cache. Areas in the LocalStorageDatabase have nothing to
+  // free, and will be read again lazily.
   backing_->Reset();
 }
 
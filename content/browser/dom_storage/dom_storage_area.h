@@ -20,6 +20,7 @@ namespace content {
 class DOMStorageDatabaseAdapter;
 class DOMStorageMap;
 class DOMStorageTaskRunner;
+class LocalStorageDatabase;
 class SessionStorageDatabase;
 
 // Container for a per-origin Map of key/value pairs potentially
@@ -33,9 +34,12 @@ class CONTENT_EXPORT DOMStorageArea
   static base::FilePath DatabaseFileNameFromOrigin(const GURL& origin);
   static GURL OriginFromDatabaseFileName(const base::FilePath& file_name);
 
-  // Local storage. Backed on disk if directory is nonempty.
+  // Local storage. Backed on disk if directory is nonempty, in
+  // |local_storage_database| if it is not NULL and in a database file of the
+  // origin in |directory| otherwise.
   DOMStorageArea(const GURL& origin,
                  const base::FilePath& directory,
+                 LocalStorageDatabase* local_storage_database,
                  DOMStorageTaskRunner* task_runner);
 
   // Session storage. Backed on disk if |session_storage_backing| is not NULL.
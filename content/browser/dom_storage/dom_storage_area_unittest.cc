@@ -133,7 +133,7 @@ TEST_F(DOMStorageAreaTest, BackingDatabaseOpened) {
   // No directory, backing should be null.
   {
     scoped_refptr<DOMStorageArea> area(
-        new DOMStorageArea(kOrigin, base::FilePath(), NULL));
+        new DOMStorageArea(kOrigin, base::FilePath(), NULL, NULL));
     EXPECT_EQ(NULL, area->backing_.get());
     EXPECT_TRUE(area->is_initial_import_done_);
     EXPECT_FALSE(base::PathExists(kExpectedOriginFilePath));
@@ -162,6 +162,7 @@ TEST_F(DOMStorageAreaTest, BackingDatabaseOpened) {
     scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
         kOrigin,
         temp_dir.path(),
+        NULL,
         new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
 
     EXPECT_TRUE(area->backing_.get());
@@ -209,6 +210,7 @@ TEST_F(DOMStorageAreaTest, CommitTasks) {
   scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
       kOrigin,
       temp_dir.path(),
+      NULL,
       new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
   // Inject an in-memory db to speed up the test.
   area->backing_.reset(new LocalStorageDatabaseAdapter());
@@ -287,6 +289,7 @@ TEST_F(DOMStorageAreaTest, CommitChangesAtShutdown) {
   scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
       kOrigin,
       temp_dir.path(),
+      NULL,
       new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
 
   // Inject an in-memory db to speed up the test and also to verify
@@ -314,6 +317,7 @@ TEST_F(DOMStorageAreaTest, DeleteOrigin) {
   scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
       kOrigin,
       temp_dir.path(),
+      NULL,
       new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
 
   // This test puts files on disk.
@@ -375,6 +379,7 @@ TEST_F(DOMStorageAreaTest, PurgeMemory) {
   scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
       kOrigin,
       temp_dir.path(),
+      NULL,
       new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
 
   // Inject an in-memory db to speed up the test.
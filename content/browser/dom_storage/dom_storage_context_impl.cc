@@ -15,6 +15,7 @@
 #include "content/browser/dom_storage/dom_storage_database.h"
 #include "content/browser/dom_storage/dom_storage_namespace.h"
 #include "content/browser/dom_storage/dom_storage_task_runner.h"
+#include "content/browser/dom_storage/local_storage_database.h"
 #include "content/browser/dom_storage/session_storage_database.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "content/public/browser/dom_storage_context.h"
@@ -26,6 +27,10 @@ namespace content {
 
 static const int kSessionStoraceScavengingSeconds = 60;
 
+// Directory of the LocalStorageDatabase, inside the localStorage directory.
+static const base::FilePath::CharType kLocalStorageDatabaseDirectory[] =
+    FILE_PATH_LITERAL("leveldb");
+
 DOMStorageContextImpl::DOMStorageContextImpl(
     const base::FilePath& localstorage_directory,
     const base::FilePath& sessionstorage_directory,
@@ -58,6 +63,17 @@ DOMStorageContextImpl::~DOMStorageContextImpl() {
         base::Bind(&SessionStorageDatabase::Release,
                    base::Unretained(to_release)));
   }
+  if (local_storage_database_.get()) {
+    // Same as above.
+    LocalStorageDatabase* to_release = local_storage_database_.get();
+    to_release->AddRef();
+    local_storage_database_ = NULL;
+    task_runner_->PostShutdownBlockingTask(
+        FROM_HERE,
+        DOMStorageTaskRunner::COMMIT_SEQUENCE,
+        base::Bind(&LocalStorageDatabase::Release,
+                   base::Unretained(to_release)));
+  }
 }
 
 DOMStorageNamespace* DOMStorageContextImpl::GetStorageNamespace(
@@ -72,10 +88,12 @@ DOMStorageNamespace* DOMStorageContextImpl::GetStorageNamespace(
           LOG(ERROR) << "Failed to create 'Local Storage' directory,"
                         " falling back to in-memory only.";
           localstorage_directory_ = base::FilePath();
+          local_storage_database_ = NULL;
         }
       }
-      DOMStorageNamespace* local =
-          new DOMStorageNamespace(localstorage_directory_, task_runner_.get());
+      DOMStorageNamespace* local = new DOMStorageNamespace(
+          localstorage_directory_, local_storage_database_.get(),
+          task_runner_.get());
       namespaces_[kLocalStorageNamespaceId] = local;
       return local;
     }
@@ -104,6 +122,20 @@ void DOMStorageContextImpl::GetLocalStorageUsage(
       infos->push_back(info);
     }
   }
+  if (!local_storage_database_.get())
+    return;
+
+  // Origins whose data hasn't been moved to the LocalStorageDatabase yet
+  // were listed above.
+  std::set<GURL> file_origins;
+  for (size_t i = 0; i < infos->size(); ++i)
+    file_origins.insert((*infos)[i].origin);
+  std::vector<LocalStorageUsageInfo> database_infos;
+  local_storage_database_->ReadUsage(&database_infos);
+  for (size_t i = 0; i < database_infos.size(); ++i) {
+    if (file_origins.find(database_infos[i].origin) == file_origins.end())
+      infos->push_back(database_infos[i]);
+  }
 }
 
 void DOMStorageContextImpl::GetSessionStorageUsage(
@@ -160,7 +192,8 @@ void DOMStorageContextImpl::DeleteSessionStorage(
     NotifyAreaCleared(area, usage_info.origin);
 }
 
-void DOMStorageContextImpl::PurgeMemory() {
+void DOMStorageContextImpl::PurgeMemory(
+    DOMStorageNamespace::PurgeOption purge_option) {
   // We can only purge memory from the local storage namespace
   // which is backed by disk.
   // TODO(marja): Purge sessionStorage, too. (Requires changes to the FastClear
@@ -168,7 +201,7 @@ void DOMStorageContextImpl::PurgeMemory() {
   StorageNamespaceMap::iterator found =
       namespaces_.find(kLocalStorageNamespaceId);
   if (found != namespaces_.end())
-    found->second->PurgeMemory(DOMStorageNamespace::PURGE_AGGRESSIVE);
+    found->second->PurgeMemory(purge_option);
 }
 
 void DOMStorageContextImpl::Shutdown() {
@@ -366,6 +399,8 @@ void DOMStorageContextImpl::ClearSessionOnlyOrigins() {
       base::FilePath database_file_path = localstorage_directory_.Append(
           DOMStorageArea::DatabaseFileNameFromOrigin(origin));
       sql::Connection::Delete(database_file_path);
+      if (local_storage_database_.get())
+        local_storage_database_->DeleteArea(origin);
     }
   }
   if (session_storage_database_.get()) {
@@ -391,6 +426,14 @@ void DOMStorageContextImpl::SetSaveSessionStorageOnDisk() {
   }
 }
 
+void DOMStorageContextImpl::SetUseLocalStorageDatabase() {
+  DCHECK(namespaces_.empty());
+  if (!localstorage_directory_.empty()) {
+    local_storage_database_ = new LocalStorageDatabase(
+        localstorage_directory_.Append(kLocalStorageDatabaseDirectory));
+  }
+}
+
 void DOMStorageContextImpl::StartScavengingUnusedSessionStorage() {
   if (session_storage_database_.get()) {
     task_runner_->PostDelayedTask(
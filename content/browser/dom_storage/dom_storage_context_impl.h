@@ -36,6 +36,7 @@ namespace content {
 class DOMStorageArea;
 class DOMStorageSession;
 class DOMStorageTaskRunner;
+class LocalStorageDatabase;
 class SessionStorageDatabase;
 struct LocalStorageUsageInfo;
 struct SessionStorageUsageInfo;
@@ -117,7 +118,7 @@ class CONTENT_EXPORT DOMStorageContextImpl
   void GetSessionStorageUsage(std::vector<SessionStorageUsageInfo>* infos);
   void DeleteLocalStorage(const GURL& origin);
   void DeleteSessionStorage(const SessionStorageUsageInfo& usage_info);
-  void PurgeMemory();
+  void PurgeMemory(DOMStorageNamespace::PurgeOption purge_option);
 
   // Used by content settings to alter the behavior around
   // what data to keep and what data to discard at shutdown.
@@ -176,6 +177,12 @@ class CONTENT_EXPORT DOMStorageContextImpl
   // after DOMStorageContextImpl is created, before it's used.
   void SetSaveSessionStorageOnDisk();
 
+  // Stores localStorage in a LocalStorageDatabase for all origins instead of
+  // a database file per origin, moving the data of each origin over the first
+  // time its area is used. This function must be called right after
+  // DOMStorageContextImpl is created, before it's used.
+  void SetUseLocalStorageDatabase();
+
   // Deletes all namespaces which don't have an associated DOMStorageNamespace
   // alive. This function is used for deleting possible leftover data after an
   // unclean exit.
@@ -234,6 +241,7 @@ class CONTENT_EXPORT DOMStorageContextImpl
   bool force_keep_session_state_;
   scoped_refptr<quota::SpecialStoragePolicy> special_storage_policy_;
   scoped_refptr<SessionStorageDatabase> session_storage_database_;
+  scoped_refptr<LocalStorageDatabase> local_storage_database_;
 
   // For cleaning up unused namespaces gradually.
   bool scavenging_started_;
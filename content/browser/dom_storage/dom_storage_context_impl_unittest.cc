@@ -82,7 +82,7 @@ TEST_F(DOMStorageContextImplTest, Basics) {
   EXPECT_EQ(temp_dir_.path(), context_->localstorage_directory());
   EXPECT_EQ(base::FilePath(), context_->sessionstorage_directory());
   EXPECT_EQ(storage_policy_.get(), context_->special_storage_policy_.get());
-  context_->PurgeMemory();
+  context_->PurgeMemory(DOMStorageNamespace::PURGE_AGGRESSIVE);
   context_->DeleteLocalStorage(GURL("http://chromium.org/"));
   const int kFirstSessionStorageNamespaceId = 1;
   EXPECT_TRUE(context_->GetStorageNamespace(kLocalStorageNamespaceId));
@@ -128,6 +128,49 @@ TEST_F(DOMStorageContextImplTest, UsageInfo) {
   EXPECT_NE(base::Time(), infos[0].last_modified);
 }
 
+TEST_F(DOMStorageContextImplTest, LocalStorageDatabase) {
+  // Store data in the database file of the origin.
+  base::NullableString16 old_value;
+  EXPECT_TRUE(context_->GetStorageNamespace(kLocalStorageNamespaceId)->
+      OpenStorageArea(kOrigin)->SetItem(kKey, kValue, &old_value));
+  context_->Shutdown();
+  context_ = NULL;
+  base::MessageLoop::current()->RunUntilIdle();
+  base::FilePath file_path =
+      temp_dir_.path().Append(DOMStorageArea::DatabaseFileNameFromOrigin(
+          kOrigin));
+  EXPECT_TRUE(base::PathExists(file_path));
+
+  // The data is moved to the LocalStorageDatabase when the area is used.
+  context_ = new DOMStorageContextImpl(temp_dir_.path(), base::FilePath(),
+                                       NULL, task_runner_.get());
+  context_->SetUseLocalStorageDatabase();
+  DOMStorageNamespace* local =
+      context_->GetStorageNamespace(kLocalStorageNamespaceId);
+  DOMStorageArea* area = local->OpenStorageArea(kOrigin);
+  EXPECT_EQ(kValue, area->GetItem(kKey).string());
+  EXPECT_FALSE(base::PathExists(file_path));
+  std::vector<LocalStorageUsageInfo> infos;
+  context_->GetLocalStorageUsage(&infos, kDoIncludeFileInfo);
+  ASSERT_EQ(1u, infos.size());
+  EXPECT_EQ(kOrigin, infos[0].origin);
+  EXPECT_NE(base::Time(), infos[0].last_modified);
+
+  // Purged areas are read again from the database.
+  local->CloseStorageArea(area);
+  context_->PurgeMemory(DOMStorageNamespace::PURGE_UNOPENED);
+  EXPECT_EQ(0u, local->CountInMemoryAreas());
+  area = local->OpenStorageArea(kOrigin);
+  EXPECT_EQ(kValue, area->GetItem(kKey).string());
+  local->CloseStorageArea(area);
+
+  context_->DeleteLocalStorage(kOrigin);
+  infos.clear();
+  context_->GetLocalStorageUsage(&infos, kDontIncludeFileInfo);
+  EXPECT_TRUE(infos.empty());
+  context_->Shutdown();
+}
+
 TEST_F(DOMStorageContextImplTest, SessionOnly) {
   const GURL kSessionOnlyOrigin("http://www.sessiononly.com/");
   storage_policy_->AddSessionOnly(kSessionOnlyOrigin);
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "content/browser/dom_storage/dom_storage_area.h"
@@ -15,6 +16,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/local_storage_usage_info.h"
 #include "content/public/browser/session_storage_usage_info.h"
+#include "content/public/common/content_switches.h"
 
 namespace content {
 namespace {
@@ -78,6 +80,14 @@ DOMStorageContextWrapper::DOMStorageContextWrapper(
           worker_pool->GetNamedSequenceToken("dom_storage_commit"),
           BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO)
               .get()));
+  if (!data_path.empty() &&
+      CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableLevelDBLocalStorage)) {
+    context_->SetUseLocalStorageDatabase();
+  }
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&DOMStorageContextWrapper::OnMemoryPressure,
+                 base::Unretained(this))));
 }
 
 DOMStorageContextWrapper::~DOMStorageContextWrapper() {
@@ -151,7 +161,23 @@ void DOMStorageContextWrapper::PurgeMemory() {
   context_->task_runner()->PostShutdownBlockingTask(
       FROM_HERE,
       DOMStorageTaskRunner::PRIMARY_SEQUENCE,
-      base::Bind(&DOMStorageContextImpl::PurgeMemory, context_));
+      base::Bind(&DOMStorageContextImpl::PurgeMemory, context_,
+                 DOMStorageNamespace::PURGE_AGGRESSIVE));
+}
+
+void DOMStorageContextWrapper::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  DCHECK(context_.get());
+  DOMStorageNamespace::PurgeOption purge_option =
+      DOMStorageNamespace::PURGE_UNOPENED;
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL) {
+    purge_option = DOMStorageNamespace::PURGE_AGGRESSIVE;
+  }
+  context_->task_runner()->PostShutdownBlockingTask(
+      FROM_HERE,
+      DOMStorageTaskRunner::PRIMARY_SEQUENCE,
+      base::Bind(&DOMStorageContextImpl::PurgeMemory, context_, purge_option));
 }
 
 void DOMStorageContextWrapper::SetForceKeepSessionState() {
@@ -164,6 +190,7 @@ void DOMStorageContextWrapper::SetForceKeepSessionState() {
 
 void DOMStorageContextWrapper::Shutdown() {
   DCHECK(context_.get());
+  memory_pressure_listener_.reset();
   context_->task_runner()->PostShutdownBlockingTask(
       FROM_HERE,
       DOMStorageTaskRunner::PRIMARY_SEQUENCE,
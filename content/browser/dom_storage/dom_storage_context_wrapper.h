@@ -5,7 +5,9 @@
 #ifndef CONTENT_BROWSER_DOM_STORAGE_DOM_STORAGE_CONTEXT_WRAPPER_H_
 #define CONTENT_BROWSER_DOM_STORAGE_DOM_STORAGE_CONTEXT_WRAPPER_H_
 
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/dom_storage_context.h"
 
@@ -64,7 +66,13 @@ class CONTENT_EXPORT DOMStorageContextWrapper :
   virtual ~DOMStorageContextWrapper();
   DOMStorageContextImpl* context() const { return context_.get(); }
 
+  // Purges the localStorage areas that aren't in use, and on critical
+  // pressure the cached values of those that are too.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   scoped_refptr<DOMStorageContextImpl> context_;
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(DOMStorageContextWrapper);
 };
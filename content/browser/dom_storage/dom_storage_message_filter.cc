@@ -23,7 +23,8 @@ namespace content {
 DOMStorageMessageFilter::DOMStorageMessageFilter(
     int render_process_id,
     DOMStorageContextWrapper* context)
-    : render_process_id_(render_process_id),
+    : BrowserMessageFilter(DOMStorageMsgStart),
+      render_process_id_(render_process_id),
       context_(context->context()),
       connection_dispatching_message_for_(0) {
 }
@@ -79,9 +80,8 @@ bool DOMStorageMessageFilter::OnMessageReceived(const IPC::Message& message,
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_OpenStorageArea, OnOpenStorageArea)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_CloseStorageArea, OnCloseStorageArea)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_LoadStorageArea, OnLoadStorageArea)
-    IPC_MESSAGE_HANDLER(DOMStorageHostMsg_SetItem, OnSetItem)
+    IPC_MESSAGE_HANDLER(DOMStorageHostMsg_ApplyMutations, OnApplyMutations)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_LogGetItem, OnLogGetItem)
-    IPC_MESSAGE_HANDLER(DOMStorageHostMsg_RemoveItem, OnRemoveItem)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_Clear, OnClear)
     IPC_MESSAGE_HANDLER(DOMStorageHostMsg_FlushMessages, OnFlushMessages)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -115,16 +115,29 @@ void DOMStorageMessageFilter::OnLoadStorageArea(int connection_id,
   Send(new DOMStorageMsg_AsyncOperationComplete(true));
 }
 
-void DOMStorageMessageFilter::OnSetItem(
-    int connection_id, const base::string16& key,
-    const base::string16& value, const GURL& page_url) {
+void DOMStorageMessageFilter::OnApplyMutations(
+    int connection_id, const DOMStorageValuesMap& mutations,
+    const GURL& page_url) {
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::IO));
   DCHECK_EQ(0, connection_dispatching_message_for_);
   base::AutoReset<int> auto_reset(&connection_dispatching_message_for_,
                             connection_id);
-  base::NullableString16 not_used;
-  bool success = host_->SetAreaItem(connection_id, key, value,
-                                    page_url, &not_used);
+  // The renderer resets its cache if any item fails to be set, so the other
+  // changes are still applied.
+  bool success = true;
+  for (DOMStorageValuesMap::const_iterator it = mutations.begin();
+       it != mutations.end(); ++it) {
+    if (it->second.is_null()) {
+      base::string16 not_used;
+      host_->RemoveAreaItem(connection_id, it->first, page_url, &not_used);
+    } else {
+      base::NullableString16 not_used;
+      if (!host_->SetAreaItem(connection_id, it->first, it->second.string(),
+                              page_url, &not_used)) {
+        success = false;
+      }
+    }
+  }
   Send(new DOMStorageMsg_AsyncOperationComplete(success));
 }
 
@@ -135,18 +148,6 @@ void DOMStorageMessageFilter::OnLogGetItem(
   host_->LogGetAreaItem(connection_id, key, value);
 }
 
-void DOMStorageMessageFilter::OnRemoveItem(
-    int connection_id, const base::string16& key,
-    const GURL& page_url) {
-  DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::IO));
-  DCHECK_EQ(0, connection_dispatching_message_for_);
-  base::AutoReset<int> auto_reset(&connection_dispatching_message_for_,
-                            connection_id);
-  base::string16 not_used;
-  host_->RemoveAreaItem(connection_id, key, page_url, &not_used);
-  Send(new DOMStorageMsg_AsyncOperationComplete(true));
-}
-
 void DOMStorageMessageFilter::OnClear(
     int connection_id, const GURL& page_url) {
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -53,12 +53,11 @@ class DOMStorageMessageFilter
   void OnCloseStorageArea(int connection_id);
   void OnLoadStorageArea(int connection_id, DOMStorageValuesMap* map,
                          bool* send_log_get_messages);
-  void OnSetItem(int connection_id, const base::string16& key,
-                 const base::string16& value, const GURL& page_url);
+  void OnApplyMutations(int connection_id,
+                        const DOMStorageValuesMap& mutations,
+                        const GURL& page_url);
   void OnLogGetItem(int connection_id, const base::string16& key,
                     const base::NullableString16& value);
-  void OnRemoveItem(int connection_id, const base::string16& key,
-                    const GURL& page_url);
   void OnClear(int connection_id, const GURL& page_url);
   void OnFlushMessages();
 
@@ -15,6 +15,7 @@
 #include "content/browser/dom_storage/dom_storage_area.h"
 #include "content/browser/dom_storage/dom_storage_context_impl.h"
 #include "content/browser/dom_storage/dom_storage_task_runner.h"
+#include "content/browser/dom_storage/local_storage_database.h"
 #include "content/browser/dom_storage/session_storage_database.h"
 #include "content/common/dom_storage/dom_storage_types.h"
 #include "content/public/common/child_process_host.h"
@@ -29,9 +30,11 @@ static const unsigned int kMaxTransactionLogEntries = 8 * 1024;
 
 DOMStorageNamespace::DOMStorageNamespace(
     const base::FilePath& directory,
+    LocalStorageDatabase* local_storage_database,
     DOMStorageTaskRunner* task_runner)
     : namespace_id_(kLocalStorageNamespaceId),
       directory_(directory),
+      local_storage_database_(local_storage_database),
       task_runner_(task_runner),
       num_aliases_(0),
       old_master_for_close_area_(NULL),
@@ -71,7 +74,8 @@ DOMStorageArea* DOMStorageNamespace::OpenStorageArea(const GURL& origin) {
   }
   DOMStorageArea* area;
   if (namespace_id_ == kLocalStorageNamespaceId) {
-    area = new DOMStorageArea(origin, directory_, task_runner_.get());
+    area = new DOMStorageArea(origin, directory_, local_storage_database_.get(),
+                              task_runner_.get());
   } else {
     area = new DOMStorageArea(
         namespace_id_, persistent_namespace_id_, origin,
@@ -173,7 +177,8 @@ void DOMStorageNamespace::DeleteLocalStorageOrigin(const GURL& origin) {
   }
   if (!directory_.empty()) {
     scoped_refptr<DOMStorageArea> area =
-        new DOMStorageArea(origin, directory_, task_runner_.get());
+        new DOMStorageArea(origin, directory_, local_storage_database_.get(),
+                           task_runner_.get());
     area->DeleteOrigin();
   }
 }
@@ -21,6 +21,7 @@ namespace content {
 class DOMStorageArea;
 class DOMStorageContextImpl;
 class DOMStorageTaskRunner;
+class LocalStorageDatabase;
 class SessionStorageDatabase;
 
 // Container for the set of per-origin Areas.
@@ -39,8 +40,10 @@ class CONTENT_EXPORT DOMStorageNamespace
   };
 
   // Constructor for a LocalStorage namespace with id of 0
-  // and an optional backing directory on disk.
+  // and an optional backing directory on disk. The areas are stored in
+  // |local_storage_database| if it is not NULL.
   DOMStorageNamespace(const base::FilePath& directory,  // may be empty
+                      LocalStorageDatabase* local_storage_database,
                       DOMStorageTaskRunner* task_runner);
 
   // Constructor for a SessionStorage namespace with a non-zero id and an
@@ -158,6 +161,7 @@ class CONTENT_EXPORT DOMStorageNamespace
   int64 namespace_id_;
   std::string persistent_namespace_id_;
   base::FilePath directory_;
+  scoped_refptr<LocalStorageDatabase> local_storage_database_;
   AreaMap areas_;
   scoped_refptr<DOMStorageTaskRunner> task_runner_;
   scoped_refptr<SessionStorageDatabase> session_storage_database_;
@@ -0,0 +1,307 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/dom_storage/local_storage_database.h"
+
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "content/public/browser/local_storage_usage_info.h"
+#include "third_party/leveldatabase/env_chromium.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+#include "third_party/leveldatabase/src/include/leveldb/iterator.h"
+#include "third_party/leveldatabase/src/include/leveldb/options.h"
+#include "third_party/leveldatabase/src/include/leveldb/write_batch.h"
+#include "url/gurl.h"
+
+namespace {
+
+const char local_storage_uma_name[] = "LocalStorageDatabase.Open";
+
+enum LocalStorageUMA {
+  LOCAL_STORAGE_UMA_SUCCESS,
+  LOCAL_STORAGE_UMA_RECREATED,
+  LOCAL_STORAGE_UMA_FAIL,
+  LOCAL_STORAGE_UMA_MAX
+};
+
+// Separates the origin from the key in the keys of an area. Origin specs
+// never contain it.
+const char kAreaKeySeparator = '\x00';
+
+}  // namespace
+
+// Layout of the database:
+// | key                            | value                              |
+// -----------------------------------------------------------------------
+// | area-origin1\x00a              | b (a = b in the area of origin1)   |
+// | ...                            |                                    |
+// | origin-origin1                 | time of the last commit to origin1 |
+// | origin-origin2                 | ...                                |
+// Origins are stored as their spec, storage keys and values as raw UTF-16.
+// The keys of an area are "area-<origin>\x00" followed by the storage key,
+// which may be empty.
+
+namespace content {
+
+LocalStorageDatabase::LocalStorageDatabase(const base::FilePath& file_path)
+    : file_path_(file_path),
+      db_error_(false) {
+}
+
+LocalStorageDatabase::~LocalStorageDatabase() {
+}
+
+bool LocalStorageDatabase::HasArea(const GURL& origin) {
+  if (!LazyOpen(false))
+    return false;
+  std::string dummy;
+  leveldb::Status s =
+      db_->Get(leveldb::ReadOptions(), OriginKey(origin.spec()), &dummy);
+  DatabaseErrorCheck(s.ok() || s.IsNotFound());
+  return s.ok();
+}
+
+void LocalStorageDatabase::ReadAreaValues(const GURL& origin,
+                                          DOMStorageValuesMap* result) {
+  // We don't create a database if it doesn't exist. In that case, there is
+  // nothing to be added to the result.
+  if (!LazyOpen(false))
+    return;
+  ReadArea(origin.spec(), leveldb::ReadOptions(), result, false);
+}
+
+bool LocalStorageDatabase::CommitAreaChanges(
+    const GURL& origin,
+    bool clear_all_first,
+    const DOMStorageValuesMap& changes) {
+  if (!LazyOpen(!changes.empty())) {
+    // Clearing or deleting keys of an origin in a database that doesn't exist
+    // is trivially done.
+    return !db_error_;
+  }
+
+  const std::string origin_spec = origin.spec();
+  leveldb::WriteBatch batch;
+  if (clear_all_first && !ClearArea(origin_spec, &batch))
+    return false;
+
+  bool has_values = false;
+  for (DOMStorageValuesMap::const_iterator it = changes.begin();
+       it != changes.end(); ++it) {
+    std::string key = AreaKey(origin_spec, it->first);
+    if (it->second.is_null()) {
+      batch.Delete(key);
+    } else {
+      // Convert the raw data stored in base::string16 to raw data stored in
+      // std::string.
+      const base::string16& value = it->second.string();
+      batch.Put(key, leveldb::Slice(reinterpret_cast<const char*>(value.data()),
+                                    value.size() * sizeof(base::char16)));
+      has_values = true;
+    }
+  }
+  std::string origin_key = OriginKey(origin_spec);
+  if (has_values) {
+    batch.Put(origin_key,
+              base::Int64ToString(base::Time::Now().ToInternalValue()));
+  }
+  leveldb::Status s = db_->Write(leveldb::WriteOptions(), &batch);
+  if (!DatabaseErrorCheck(s.ok()))
+    return false;
+  if (has_values)
+    return true;
+
+  // Only keys were removed. Forget the origin if its area is now empty, so
+  // that it is no longer reported in the usage.
+  DOMStorageValuesMap remaining;
+  if (!ReadArea(origin_spec, leveldb::ReadOptions(), &remaining, true))
+    return false;
+  if (!remaining.empty())
+    return true;
+  s = db_->Delete(leveldb::WriteOptions(), origin_key);
+  return DatabaseErrorCheck(s.ok());
+}
+
+bool LocalStorageDatabase::DeleteArea(const GURL& origin) {
+  if (!LazyOpen(false)) {
+    // No need to create the database if it doesn't exist.
+    return !db_error_;
+  }
+  const std::string origin_spec = origin.spec();
+  leveldb::WriteBatch batch;
+  if (!ClearArea(origin_spec, &batch))
+    return false;
+  batch.Delete(OriginKey(origin_spec));
+  leveldb::Status s = db_->Write(leveldb::WriteOptions(), &batch);
+  return DatabaseErrorCheck(s.ok());
+}
+
+bool LocalStorageDatabase::ReadUsage(
+    std::vector<LocalStorageUsageInfo>* infos) {
+  if (!LazyOpen(false))
+    return !db_error_;
+
+  const std::string origin_prefix = OriginPrefix();
+  scoped_ptr<leveldb::Iterator> it(db_->NewIterator(leveldb::ReadOptions()));
+  for (it->Seek(origin_prefix); it->Valid(); it->Next()) {
+    std::string key = it->key().ToString();
+    if (key.find(origin_prefix) != 0) {
+      // Iterated past the "origin-" keys.
+      break;
+    }
+    std::string origin_spec = key.substr(origin_prefix.length());
+    int64 last_modified = 0;
+    base::StringToInt64(it->value().ToString(), &last_modified);
+
+    // The size is that of the tables and logs that hold the area, so it is
+    // only an estimate.
+    std::string area_start_key = AreaStartKey(origin_spec);
+    std::string area_limit_key = area_start_key;
+    ++area_limit_key[area_limit_key.size() - 1];
+    leveldb::Range range(area_start_key, area_limit_key);
+    uint64_t size = 0;
+    db_->GetApproximateSizes(&range, 1, &size);
+
+    LocalStorageUsageInfo info;
+    info.origin = GURL(origin_spec);
+    info.data_size = static_cast<size_t>(size);
+    info.last_modified = base::Time::FromInternalValue(last_modified);
+    infos->push_back(info);
+  }
+  return DatabaseErrorCheck(it->status().ok());
+}
+
+bool LocalStorageDatabase::LazyOpen(bool create_if_needed) {
+  base::AutoLock auto_lock(db_lock_);
+  if (db_error_) {
+    // Don't try to open a database that we know has failed already.
+    return false;
+  }
+  if (db_.get())
+    return true;
+
+  if (!create_if_needed &&
+      (!base::PathExists(file_path_) || base::IsDirectoryEmpty(file_path_))) {
+    // Wait until there is something to put onto disk before creating the
+    // database.
+    return false;
+  }
+
+  leveldb::DB* db;
+  leveldb::Status s = TryToOpen(&db);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to open leveldb in " << file_path_.value()
+                 << ", error: " << s.ToString();
+    DCHECK(db == NULL);
+
+    // Clear the directory and try again.
+    base::DeleteFile(file_path_, true);
+    s = TryToOpen(&db);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to open leveldb in " << file_path_.value()
+                   << ", error: " << s.ToString();
+      UMA_HISTOGRAM_ENUMERATION(local_storage_uma_name,
+                                LOCAL_STORAGE_UMA_FAIL,
+                                LOCAL_STORAGE_UMA_MAX);
+      DCHECK(db == NULL);
+      db_error_ = true;
+      return false;
+    }
+    UMA_HISTOGRAM_ENUMERATION(local_storage_uma_name,
+                              LOCAL_STORAGE_UMA_RECREATED,
+                              LOCAL_STORAGE_UMA_MAX);
+  } else {
+    UMA_HISTOGRAM_ENUMERATION(local_storage_uma_name,
+                              LOCAL_STORAGE_UMA_SUCCESS,
+                              LOCAL_STORAGE_UMA_MAX);
+  }
+  db_.reset(db);
+  return true;
+}
+
+leveldb::Status LocalStorageDatabase::TryToOpen(leveldb::DB** db) {
+  leveldb::Options options;
+  options.max_open_files = 0;  // Use minimum.
+  options.create_if_missing = true;
+  options.block_cache = leveldb_env::SharedBlockCache();
+  options.filter_policy = leveldb_env::BloomFilterPolicy();
+  return leveldb::DB::Open(options, file_path_.AsUTF8Unsafe(), db);
+}
+
+bool LocalStorageDatabase::DatabaseErrorCheck(bool ok) {
+  if (ok)
+    return true;
+  base::AutoLock auto_lock(db_lock_);
+  db_error_ = true;
+  return false;
+}
+
+bool LocalStorageDatabase::ReadArea(const std::string& origin,
+                                    const leveldb::ReadOptions& options,
+                                    DOMStorageValuesMap* result,
+                                    bool only_keys) {
+  std::string area_start_key = AreaStartKey(origin);
+  scoped_ptr<leveldb::Iterator> it(db_->NewIterator(options));
+  for (it->Seek(area_start_key); it->Valid(); it->Next()) {
+    leveldb::Slice key = it->key();
+    if (!key.starts_with(area_start_key)) {
+      // Iterated past the keys in this area.
+      break;
+    }
+    // Key is of the form "area-<origin>\x00<key>".
+    key.remove_prefix(area_start_key.size());
+    base::string16 key16(reinterpret_cast<const base::char16*>(key.data()),
+                         key.size() / sizeof(base::char16));
+    if (only_keys) {
+      (*result)[key16] = base::NullableString16();
+    } else {
+      // Convert the raw data stored in std::string (it->value()) to raw data
+      // stored in base::string16.
+      size_t len = it->value().size() / sizeof(base::char16);
+      const base::char16* data_ptr =
+          reinterpret_cast<const base::char16*>(it->value().data());
+      (*result)[key16] =
+          base::NullableString16(base::string16(data_ptr, len), false);
+    }
+  }
+  return DatabaseErrorCheck(it->status().ok());
+}
+
+bool LocalStorageDatabase::ClearArea(const std::string& origin,
+                                     leveldb::WriteBatch* batch) {
+  DOMStorageValuesMap values;
+  if (!ReadArea(origin, leveldb::ReadOptions(), &values, true))
+    return false;
+  for (DOMStorageValuesMap::const_iterator it = values.begin();
+       it != values.end(); ++it)
+    batch->Delete(AreaKey(origin, it->first));
+  return true;
+}
+
+std::string LocalStorageDatabase::OriginKey(const std::string& origin) {
+  return OriginPrefix() + origin;
+}
+
+const char* LocalStorageDatabase::OriginPrefix() {
+  return "origin-";
+}
+
+std::string LocalStorageDatabase::AreaStartKey(const std::string& origin) {
+  std::string key = "area-" + origin;
+  key.push_back(kAreaKeySeparator);
+  return key;
+}
+
+std::string LocalStorageDatabase::AreaKey(const std::string& origin,
+                                          const base::string16& key) {
+  std::string area_key = AreaStartKey(origin);
+  area_key.append(reinterpret_cast<const char*>(key.data()),
+                  key.size() * sizeof(base::char16));
+  return area_key;
+}
+
+}  // namespace content
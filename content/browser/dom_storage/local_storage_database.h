@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_DATABASE_H_
+#define CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_DATABASE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "content/common/content_export.h"
+#include "content/common/dom_storage/dom_storage_types.h"
+#include "third_party/leveldatabase/src/include/leveldb/status.h"
+
+class GURL;
+
+namespace leveldb {
+class DB;
+struct ReadOptions;
+class WriteBatch;
+}  // namespace leveldb
+
+namespace content {
+
+struct LocalStorageUsageInfo;
+
+// LocalStorageDatabase holds the localStorage data of all the origins of a
+// profile in one LevelDB database, instead of a DOMStorageDatabase per origin.
+// Commits only write the keys that changed, and the areas are read lazily,
+// one origin at a time.
+//
+// The public functions can be called on any thread. Callers must not commit
+// changes to the same origin from several threads at once.
+class CONTENT_EXPORT LocalStorageDatabase :
+    public base::RefCountedThreadSafe<LocalStorageDatabase> {
+ public:
+  explicit LocalStorageDatabase(const base::FilePath& file_path);
+
+  // Returns true if the database holds data for |origin|. Doesn't create the
+  // database if it doesn't exist.
+  bool HasArea(const GURL& origin);
+
+  // Reads the (key, value) pairs for |origin| into |result|, overwriting
+  // duplicate keys. Doesn't create the database if it doesn't exist.
+  void ReadAreaValues(const GURL& origin, DOMStorageValuesMap* result);
+
+  // Updates the data for |origin|. Removes all its keys first if
+  // |clear_all_first| is set, then removes the keys of |changes| mapped to a
+  // null NullableString16 and inserts or updates the others.
+  bool CommitAreaChanges(const GURL& origin,
+                         bool clear_all_first,
+                         const DOMStorageValuesMap& changes);
+
+  // Deletes the data for |origin|.
+  bool DeleteArea(const GURL& origin);
+
+  // Appends the origins that have data to |infos|, with the approximate size
+  // of their data and the time of their last commit.
+  bool ReadUsage(std::vector<LocalStorageUsageInfo>* infos);
+
+ private:
+  friend class base::RefCountedThreadSafe<LocalStorageDatabase>;
+
+  ~LocalStorageDatabase();
+
+  // Opens the database at |file_path_|, creating it if |create_if_needed| is
+  // true. Returns false if the database couldn't be opened, or doesn't exist
+  // and |create_if_needed| is false.
+  bool LazyOpen(bool create_if_needed);
+  leveldb::Status TryToOpen(leveldb::DB** db);
+
+  // Returns |ok|, and makes further operations fail if it's false.
+  bool DatabaseErrorCheck(bool ok);
+
+  // Reads the keys of the area for |origin| into |result| with null values if
+  // |only_keys| is true, and the values too otherwise.
+  bool ReadArea(const std::string& origin,
+                const leveldb::ReadOptions& options,
+                DOMStorageValuesMap* result,
+                bool only_keys);
+
+  // Adds the deletion of all the keys of |origin| to |batch|.
+  bool ClearArea(const std::string& origin, leveldb::WriteBatch* batch);
+
+  // Helper functions for creating the keys needed for the schema.
+  static std::string OriginKey(const std::string& origin);
+  static const char* OriginPrefix();
+  static std::string AreaStartKey(const std::string& origin);
+  static std::string AreaKey(const std::string& origin,
+                             const base::string16& key);
+
+  scoped_ptr<leveldb::DB> db_;
+  base::FilePath file_path_;
+
+  // Protects the opening of the database, and |db_error_|.
+  base::Lock db_lock_;
+
+  // True if an error has occurred, which makes further operations fail
+  // until the next run.
+  bool db_error_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalStorageDatabase);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_DATABASE_H_
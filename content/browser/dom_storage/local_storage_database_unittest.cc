@@ -0,0 +1,158 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/dom_storage/local_storage_database.h"
+
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/utf_string_conversions.h"
+#include "content/common/dom_storage/dom_storage_types.h"
+#include "content/public/browser/local_storage_usage_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using base::ASCIIToUTF16;
+
+namespace content {
+
+class LocalStorageDatabaseTest : public testing::Test {
+ public:
+  LocalStorageDatabaseTest()
+      : kOrigin1("http://www.origin1.com"),
+        kOrigin2("http://www.origin2.com"),
+        kKey1(ASCIIToUTF16("key1")),
+        kKey2(ASCIIToUTF16("key2")),
+        kValue1(ASCIIToUTF16("value1"), false),
+        kValue2(ASCIIToUTF16("value2"), false) {
+  }
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ResetDatabase();
+  }
+
+ protected:
+  base::FilePath DatabasePath() const {
+    return temp_dir_.path().AppendASCII("leveldb");
+  }
+
+  void ResetDatabase() {
+    db_ = new LocalStorageDatabase(DatabasePath());
+  }
+
+  size_t CountOrigins() {
+    std::vector<LocalStorageUsageInfo> infos;
+    EXPECT_TRUE(db_->ReadUsage(&infos));
+    return infos.size();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  scoped_refptr<LocalStorageDatabase> db_;
+
+  const GURL kOrigin1;
+  const GURL kOrigin2;
+  const base::string16 kKey1;
+  const base::string16 kKey2;
+  const base::NullableString16 kValue1;
+  const base::NullableString16 kValue2;
+};
+
+TEST_F(LocalStorageDatabaseTest, EmptyDatabase) {
+  DOMStorageValuesMap values;
+  db_->ReadAreaValues(kOrigin1, &values);
+  EXPECT_TRUE(values.empty());
+  EXPECT_FALSE(db_->HasArea(kOrigin1));
+  EXPECT_EQ(0u, CountOrigins());
+  // Reading doesn't create the database.
+  EXPECT_FALSE(base::PathExists(DatabasePath()));
+}
+
+TEST_F(LocalStorageDatabaseTest, WriteAndReadAreas) {
+  DOMStorageValuesMap changes;
+  changes[kKey1] = kValue1;
+  changes[kKey2] = kValue2;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+  changes.clear();
+  changes[kKey1] = kValue2;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin2, false, changes));
+
+  // The values survive reopening the database.
+  ResetDatabase();
+  DOMStorageValuesMap values;
+  db_->ReadAreaValues(kOrigin1, &values);
+  ASSERT_EQ(2u, values.size());
+  EXPECT_EQ(kValue1, values[kKey1]);
+  EXPECT_EQ(kValue2, values[kKey2]);
+  values.clear();
+  db_->ReadAreaValues(kOrigin2, &values);
+  ASSERT_EQ(1u, values.size());
+  EXPECT_EQ(kValue2, values[kKey1]);
+  EXPECT_EQ(2u, CountOrigins());
+}
+
+TEST_F(LocalStorageDatabaseTest, IncrementalChanges) {
+  DOMStorageValuesMap changes;
+  changes[kKey1] = kValue1;
+  changes[kKey2] = kValue2;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+
+  // Only the keys in |changes| are touched.
+  changes.clear();
+  changes[kKey1] = base::NullableString16();
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+  DOMStorageValuesMap values;
+  db_->ReadAreaValues(kOrigin1, &values);
+  ASSERT_EQ(1u, values.size());
+  EXPECT_EQ(kValue2, values[kKey2]);
+
+  // Removing the last key forgets the origin.
+  changes.clear();
+  changes[kKey2] = base::NullableString16();
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+  EXPECT_FALSE(db_->HasArea(kOrigin1));
+  EXPECT_EQ(0u, CountOrigins());
+}
+
+TEST_F(LocalStorageDatabaseTest, ClearAndDeleteAreas) {
+  DOMStorageValuesMap changes;
+  changes[kKey1] = kValue1;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin2, false, changes));
+
+  changes.clear();
+  changes[kKey2] = kValue2;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, true, changes));
+  DOMStorageValuesMap values;
+  db_->ReadAreaValues(kOrigin1, &values);
+  ASSERT_EQ(1u, values.size());
+  EXPECT_EQ(kValue2, values[kKey2]);
+
+  EXPECT_TRUE(db_->DeleteArea(kOrigin1));
+  EXPECT_FALSE(db_->HasArea(kOrigin1));
+  EXPECT_TRUE(db_->HasArea(kOrigin2));
+  values.clear();
+  db_->ReadAreaValues(kOrigin1, &values);
+  EXPECT_TRUE(values.empty());
+  EXPECT_EQ(1u, CountOrigins());
+}
+
+TEST_F(LocalStorageDatabaseTest, UnusualKeys) {
+  // Keys with unpaired surrogates aren't valid UTF-8, but are kept intact.
+  base::string16 key;
+  key.push_back(0xd800);
+  key.push_back('a');
+  DOMStorageValuesMap changes;
+  changes[key] = kValue1;
+  changes[base::string16()] = kValue2;
+  EXPECT_TRUE(db_->CommitAreaChanges(kOrigin1, false, changes));
+  DOMStorageValuesMap values;
+  db_->ReadAreaValues(kOrigin1, &values);
+  ASSERT_EQ(2u, values.size());
+  EXPECT_EQ(kValue1, values[key]);
+  EXPECT_EQ(kValue2, values[base::string16()]);
+}
+
+}  // namespace content
@@ -0,0 +1,65 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/dom_storage/local_storage_leveldb_adapter.h"
+
+#include "base/file_util.h"
+#include "base/metrics/histogram.h"
+#include "content/browser/dom_storage/dom_storage_database.h"
+#include "content/browser/dom_storage/local_storage_database.h"
+
+namespace content {
+
+LocalStorageLevelDBAdapter::LocalStorageLevelDBAdapter(
+    LocalStorageDatabase* db,
+    const GURL& origin,
+    const base::FilePath& legacy_path)
+    : db_(db),
+      origin_(origin),
+      legacy_path_(legacy_path),
+      migrated_(false) {
+}
+
+LocalStorageLevelDBAdapter::~LocalStorageLevelDBAdapter() { }
+
+void LocalStorageLevelDBAdapter::ReadAllValues(DOMStorageValuesMap* result) {
+  MigrateIfNeeded();
+  db_->ReadAreaValues(origin_, result);
+}
+
+bool LocalStorageLevelDBAdapter::CommitChanges(
+    bool clear_all_first, const DOMStorageValuesMap& changes) {
+  // Changes may be committed without reading the area first, e.g. when it
+  // is cleared, so migrate here too lest the old data come back later.
+  MigrateIfNeeded();
+  return db_->CommitAreaChanges(origin_, clear_all_first, changes);
+}
+
+void LocalStorageLevelDBAdapter::DeleteFiles() {
+  db_->DeleteArea(origin_);
+  sql::Connection::Delete(legacy_path_);
+}
+
+void LocalStorageLevelDBAdapter::MigrateIfNeeded() {
+  base::AutoLock auto_lock(migration_lock_);
+  if (migrated_)
+    return;
+  migrated_ = true;
+  if (legacy_path_.empty() || !base::PathExists(legacy_path_))
+    return;
+
+  // Data committed to |db_| already is more recent than the file's.
+  bool success = true;
+  if (!db_->HasArea(origin_)) {
+    DOMStorageValuesMap values;
+    DOMStorageDatabase(legacy_path_).ReadAllValues(&values);
+    success = db_->CommitAreaChanges(origin_, true, values);
+  }
+  UMA_HISTOGRAM_BOOLEAN("LocalStorage.MigratedToLevelDB", success);
+  // Keep the file to try again on the next run if the data couldn't be moved.
+  if (success)
+    sql::Connection::Delete(legacy_path_);
+}
+
+}  // namespace content
@@ -0,0 +1,52 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_LEVELDB_ADAPTER_H_
+#define CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_LEVELDB_ADAPTER_H_
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "content/browser/dom_storage/dom_storage_database_adapter.h"
+#include "content/common/content_export.h"
+#include "url/gurl.h"
+
+namespace content {
+
+class LocalStorageDatabase;
+
+// Stores the localStorage of an origin in the LocalStorageDatabase of the
+// profile. The first use of the area moves its data out of the per-origin
+// DOMStorageDatabase at |legacy_path|, if there is one.
+class CONTENT_EXPORT LocalStorageLevelDBAdapter :
+      public DOMStorageDatabaseAdapter {
+ public:
+  LocalStorageLevelDBAdapter(LocalStorageDatabase* db,
+                             const GURL& origin,
+                             const base::FilePath& legacy_path);
+  virtual ~LocalStorageLevelDBAdapter();
+  virtual void ReadAllValues(DOMStorageValuesMap* result) OVERRIDE;
+  virtual bool CommitChanges(bool clear_all_first,
+                             const DOMStorageValuesMap& changes) OVERRIDE;
+  virtual void DeleteFiles() OVERRIDE;
+
+ private:
+  // Moves the data of the DOMStorageDatabase at |legacy_path_| into |db_|,
+  // and deletes its file.
+  void MigrateIfNeeded();
+
+  scoped_refptr<LocalStorageDatabase> db_;
+  GURL origin_;
+  base::FilePath legacy_path_;
+
+  // Reads and commits are on different sequences. Guards |migrated_|.
+  base::Lock migration_lock_;
+  bool migrated_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalStorageLevelDBAdapter);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_DOM_STORAGE_LOCAL_STORAGE_LEVELDB_ADAPTER_H_
@@ -4,13 +4,17 @@
 
 #include "content/browser/download/base_file.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/threading/worker_pool.h"
 #include "content/browser/download/download_interrupt_reasons_impl.h"
 #include "content/browser/download/download_net_log_parameters.h"
 #include "content/browser/download/download_stats.h"
@@ -22,6 +26,28 @@
 
 namespace content {
 
+namespace {
+
+// Downloads smaller than this aren't preallocated.
+const int64 kMinPreallocationBytes = 1024 * 1024;
+
+// The most space reserved past the end of the file at a time.
+const int64 kMaxPreallocationBytes = 64 * 1024 * 1024;
+
+// Data is hashed in chunks of this size, each on the worker pool while the
+// next one is written.
+const size_t kHashChunkBytes = 256 * 1024;
+
+void UpdateHash(crypto::SecureHash* secure_hash,
+                const char* data,
+                size_t data_len,
+                base::WaitableEvent* done) {
+  secure_hash->Update(data, data_len);
+  done->Signal();
+}
+
+}  // namespace
+
 // This will initialize the entire array to zero.
 const unsigned char BaseFile::kEmptySha256Hash[] = { 0 };
 
@@ -38,6 +64,7 @@ BaseFile::BaseFile(const base::FilePath& full_path,
       referrer_url_(referrer_url),
       file_stream_(file_stream.Pass()),
       bytes_so_far_(received_bytes),
+      preallocated_bytes_(received_bytes),
       start_tick_(base::TimeTicks::Now()),
       calculate_hash_(calculate_hash),
       detached_(false),
@@ -111,12 +138,57 @@ DownloadInterruptReason BaseFile::AppendDataToFile(const char* data,
   if (data_len == 0)
     return DOWNLOAD_INTERRUPT_REASON_NONE;
 
-  // The Write call below is not guaranteed to write all the data.
+  PreallocateIfNeeded(data_len);
+
+  // Each chunk is hashed on the worker pool once it has been written, while
+  // the next one is written.
   size_t write_count = 0;
+  const char* unhashed_data = NULL;
+  size_t unhashed_len = 0;
+  for (size_t offset = 0; offset < data_len; offset += kHashChunkBytes) {
+    size_t chunk_len = std::min(kHashChunkBytes, data_len - offset);
+    base::WaitableEvent hash_done(false, false);
+    bool hashing_in_parallel = false;
+    if (unhashed_len) {
+      hashing_in_parallel = base::WorkerPool::PostTask(
+          FROM_HERE,
+          base::Bind(&UpdateHash, secure_hash_.get(), unhashed_data,
+                     unhashed_len, &hash_done),
+          false);
+      if (!hashing_in_parallel)
+        secure_hash_->Update(unhashed_data, unhashed_len);
+      unhashed_len = 0;
+    }
+
+    DownloadInterruptReason reason =
+        WriteChunk(data + offset, chunk_len, &write_count);
+    if (hashing_in_parallel)
+      hash_done.Wait();
+    if (reason != DOWNLOAD_INTERRUPT_REASON_NONE)
+      return reason;
+
+    if (calculate_hash_) {
+      unhashed_data = data + offset;
+      unhashed_len = chunk_len;
+    }
+  }
+  if (unhashed_len)
+    secure_hash_->Update(unhashed_data, unhashed_len);
+
+  RecordDownloadWriteSize(data_len);
+  RecordDownloadWriteLoopCount(write_count);
+
+  return DOWNLOAD_INTERRUPT_REASON_NONE;
+}
+
+DownloadInterruptReason BaseFile::WriteChunk(const char* data,
+                                             size_t data_len,
+                                             size_t* write_count) {
+  // The Write call below is not guaranteed to write all the data.
   size_t len = data_len;
   const char* current_data = data;
   while (len > 0) {
-    write_count++;
+    (*write_count)++;
     int write_result =
         file_stream_->WriteSync(current_data, len);
     DCHECK_NE(0, write_result);
@@ -138,16 +210,24 @@ DownloadInterruptReason BaseFile::AppendDataToFile(const char* data,
     current_data += write_size;
     bytes_so_far_ += write_size;
   }
-
-  RecordDownloadWriteSize(data_len);
-  RecordDownloadWriteLoopCount(write_count);
-
-  if (calculate_hash_)
-    secure_hash_->Update(data, data_len);
-
   return DOWNLOAD_INTERRUPT_REASON_NONE;
 }
 
+void BaseFile::PreallocateIfNeeded(size_t data_len) {
+  int64 end = bytes_so_far_ + static_cast<int64>(data_len);
+  if (end <= preallocated_bytes_ || end < kMinPreallocationBytes)
+    return;
+
+  // Reserve about as much again as has been written, which stays a small
+  // fraction of the disk for downloads which end up smaller than that.
+  int64 length = std::min(std::max(end, kMinPreallocationBytes),
+                          kMaxPreallocationBytes);
+  if (PreallocateSpace(bytes_so_far_, end - bytes_so_far_ + length))
+    preallocated_bytes_ = end + length;
+  else
+    preallocated_bytes_ = kint64max;  // Don't try again.
+}
+
 DownloadInterruptReason BaseFile::Rename(const base::FilePath& new_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
   DownloadInterruptReason rename_result = DOWNLOAD_INTERRUPT_REASON_NONE;
@@ -208,6 +288,12 @@ void BaseFile::Finish() {
   if (calculate_hash_)
     secure_hash_->Finish(sha256_hash_, crypto::kSHA256Length);
 
+  // Give back the space reserved past the end of the file.
+  if (file_stream_ && preallocated_bytes_ > bytes_so_far_ &&
+      preallocated_bytes_ != kint64max) {
+    file_stream_->Truncate(bytes_so_far_);
+  }
+
   Close();
 }
 
@@ -222,6 +308,12 @@ DownloadInterruptReason BaseFile::AnnotateWithSourceInformation() {
 }
 #endif
 
+#if !defined(OS_LINUX)
+bool BaseFile::PreallocateSpace(int64 offset, int64 length) {
+  return false;
+}
+#endif
+
 bool BaseFile::GetHash(std::string* hash) {
   DCHECK(!detached_);
   hash->assign(reinterpret_cast<const char*>(sha256_hash_),
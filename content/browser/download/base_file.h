@@ -115,6 +115,22 @@ class CONTENT_EXPORT BaseFile {
   // Resets file_stream_.
   void ClearStream();
 
+  // Writes |data_len| bytes of |data| to the file, adding the number of
+  // writes it took to |write_count|.
+  DownloadInterruptReason WriteChunk(const char* data,
+                                     size_t data_len,
+                                     size_t* write_count);
+
+  // Reserves disk space ahead of the end of the file before a write of
+  // |data_len| bytes would run past what was reserved, so that large
+  // downloads aren't fragmented and run out of space early, if at all.
+  void PreallocateIfNeeded(size_t data_len);
+
+  // Platform specific method that reserves |length| bytes of disk space at
+  // |offset| in the file without changing its size. Returns false if the
+  // platform or the file system can't.
+  bool PreallocateSpace(int64 offset, int64 length);
+
   // Platform specific method that moves a file to a new path and adjusts the
   // security descriptor / permissions on the file to match the defaults for the
   // new directory.
@@ -157,6 +173,9 @@ class CONTENT_EXPORT BaseFile {
   // Amount of data received up so far, in bytes.
   int64 bytes_so_far_;
 
+  // The size of the file including the space reserved past its end.
+  int64 preallocated_bytes_;
+
   // Start time for calculating speed.
   base::TimeTicks start_tick_;
 
@@ -4,6 +4,10 @@
 
 #include "content/browser/download/base_file.h"
 
+#include <fcntl.h>
+#include <linux/falloc.h>
+
+#include "base/posix/eintr_wrapper.h"
 #include "content/browser/download/file_metadata_linux.h"
 #include "content/public/browser/browser_thread.h"
 
@@ -17,4 +21,17 @@ DownloadInterruptReason BaseFile::AnnotateWithSourceInformation() {
   return DOWNLOAD_INTERRUPT_REASON_NONE;
 }
 
+bool BaseFile::PreallocateSpace(int64 offset, int64 length) {
+  // The file stream has no handle to hand out, so the space is reserved
+  // through a descriptor of its own. FALLOC_FL_KEEP_SIZE leaves the size of
+  // the file, and so where a resumed download appends, alone.
+  int fd = HANDLE_EINTR(open(full_path_.value().c_str(), O_WRONLY | O_CLOEXEC));
+  if (fd < 0)
+    return false;
+  bool result = HANDLE_EINTR(fallocate(fd, FALLOC_FL_KEEP_SIZE, offset,
+                                       length)) == 0;
+  IGNORE_EINTR(close(fd));
+  return result;
+}
+
 }  // namespace content
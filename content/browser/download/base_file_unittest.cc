@@ -366,6 +366,31 @@ TEST_F(BaseFileTest, MultipleWritesWithHash) {
   EXPECT_EQ(expected_hash_hex, base::HexEncode(hash.data(), hash.size()));
 }
 
+// Write data large enough to be preallocated and hashed in several chunks.
+TEST_F(BaseFileTest, LargeWritesWithHash) {
+  std::string data;
+  for (int i = 0; data.size() < 3 * 1024 * 1024 + 17; ++i)
+    data += base::IntToString(i);
+  ResetHash();
+  UpdateHash(data.data(), data.size());
+  UpdateHash(kTestData1, kTestDataLength1);
+  std::string expected_hash = GetFinalHash();
+
+  MakeFileWithHash();
+  ASSERT_TRUE(InitializeFile());
+  ASSERT_TRUE(AppendDataToFile(data));
+  ASSERT_TRUE(AppendDataToFile(kTestData1));
+  base_file_->Finish();
+
+  std::string hash;
+  EXPECT_TRUE(base_file_->GetHash(&hash));
+  EXPECT_EQ(base::HexEncode(expected_hash.data(), expected_hash.size()),
+            base::HexEncode(hash.data(), hash.size()));
+  int64 file_size = 0;
+  EXPECT_TRUE(base::GetFileSize(base_file_->full_path(), &file_size));
+  EXPECT_EQ(static_cast<int64>(data.size()) + kTestDataLength1, file_size);
+}
+
 // Write data to the file multiple times, interrupt it, and continue using
 // another file.  Calculate the resulting combined sha256 hash.
 TEST_F(BaseFileTest, MultipleWritesInterruptedWithHash) {
@@ -26,6 +26,9 @@ namespace content {
 const int kUpdatePeriodMs = 500;
 const int kMaxTimeBlockingFileThreadMs = 1000;
 
+// Buffers are gathered into writes of at least this size.
+const size_t kCoalescedWriteBytes = 256 * 1024;
+
 int DownloadFile::number_active_objects_ = 0;
 
 DownloadFileImpl::DownloadFileImpl(
@@ -103,6 +106,18 @@ DownloadInterruptReason DownloadFileImpl::AppendDataToFile(
   return file_.AppendDataToFile(data, data_len);
 }
 
+DownloadInterruptReason DownloadFileImpl::WritePendingData() {
+  if (pending_data_.empty())
+    return DOWNLOAD_INTERRUPT_REASON_NONE;
+
+  base::TimeTicks write_start(base::TimeTicks::Now());
+  DownloadInterruptReason reason =
+      AppendDataToFile(&pending_data_[0], pending_data_.size());
+  disk_writes_time_ += (base::TimeTicks::Now() - write_start);
+  pending_data_.clear();
+  return reason;
+}
+
 void DownloadFileImpl::RenameAndUniquify(
     const base::FilePath& full_path,
     const RenameCompletionCallback& callback) {
@@ -226,18 +241,22 @@ void DownloadFileImpl::StreamActive() {
       case ByteStreamReader::STREAM_HAS_DATA:
         {
           ++num_buffers;
-          base::TimeTicks write_start(base::TimeTicks::Now());
-          reason = AppendDataToFile(
-              incoming_data.get()->data(), incoming_data_size);
-          disk_writes_time_ += (base::TimeTicks::Now() - write_start);
+          const char* data = incoming_data.get()->data();
+          pending_data_.insert(pending_data_.end(), data,
+                               data + incoming_data_size);
+          if (pending_data_.size() >= kCoalescedWriteBytes)
+            reason = WritePendingData();
           bytes_seen_ += incoming_data_size;
           total_incoming_data_size += incoming_data_size;
         }
         break;
       case ByteStreamReader::STREAM_COMPLETE:
         {
-          reason = static_cast<DownloadInterruptReason>(
-              stream_reader_->GetStatus());
+          reason = WritePendingData();
+          if (reason == DOWNLOAD_INTERRUPT_REASON_NONE) {
+            reason = static_cast<DownloadInterruptReason>(
+                stream_reader_->GetStatus());
+          }
           SendUpdate();
           base::TimeTicks close_start(base::TimeTicks::Now());
           file_.Finish();
@@ -257,6 +276,11 @@ void DownloadFileImpl::StreamActive() {
            reason == DOWNLOAD_INTERRUPT_REASON_NONE &&
            now - start <= delta);
 
+  // Write what's left so that the progress sent to the observer is on disk.
+  if (reason == DOWNLOAD_INTERRUPT_REASON_NONE)
+    reason = WritePendingData();
+  now = base::TimeTicks::Now();
+
   // If we're stopping to yield the thread, post a task so we come back.
   if (state == ByteStreamReader::STREAM_HAS_DATA &&
       now - start > delta) {
@@ -7,6 +7,8 @@
 
 #include "content/browser/download/download_file.h"
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -78,6 +80,9 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
   // handled.
   void StreamActive();
 
+  // Writes the data gathered from the stream to the file.
+  DownloadInterruptReason WritePendingData();
+
   // The base file instance.
   BaseFile file_;
 
@@ -90,6 +95,11 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
   // with DownloadFile and get rid of BaseFile.
   scoped_ptr<ByteStreamReader> stream_reader_;
 
+  // Data read from the stream but not yet written, so that the many small
+  // buffers of a fast stream are written with a few large writes. It is
+  // always written before StreamActive() returns.
+  std::vector<char> pending_data_;
+
   // Used to trigger progress updates.
   scoped_ptr<base::RepeatingTimer<DownloadFileImpl> > update_timer_;
 
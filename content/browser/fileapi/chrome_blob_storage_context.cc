@@ -5,6 +5,7 @@
 #include "content/browser/fileapi/chrome_blob_storage_context.h"
 
 #include "base/bind.h"
+#include "base/files/file_path.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "webkit/browser/blob/blob_storage_context.h"
@@ -16,6 +17,10 @@ namespace content {
 
 static const char* kBlobStorageContextKeyName = "content_blob_storage_context";
 
+// The directory of the profile in which the bytes of large blobs are spilled.
+static const base::FilePath::CharType kBlobStorageDirectory[] =
+    FILE_PATH_LITERAL("Blob Storage");
+
 ChromeBlobStorageContext::ChromeBlobStorageContext() {}
 
 ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
@@ -26,11 +31,16 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
     context->SetUserData(
         kBlobStorageContextKeyName,
         new UserDataAdapter<ChromeBlobStorageContext>(blob.get()));
+    // Blob data of incognito profiles must not reach the disk.
+    base::FilePath spill_directory;
+    if (!context->IsOffTheRecord())
+      spill_directory = context->GetPath().Append(kBlobStorageDirectory);
     // Check first to avoid memory leak in unittests.
     if (BrowserThread::IsMessageLoopValid(BrowserThread::IO)) {
       BrowserThread::PostTask(
           BrowserThread::IO, FROM_HERE,
-          base::Bind(&ChromeBlobStorageContext::InitializeOnIOThread, blob));
+          base::Bind(&ChromeBlobStorageContext::InitializeOnIOThread, blob,
+                     spill_directory));
     }
   }
 
@@ -38,9 +48,17 @@ ChromeBlobStorageContext* ChromeBlobStorageContext::GetFor(
       context, kBlobStorageContextKeyName);
 }
 
-void ChromeBlobStorageContext::InitializeOnIOThread() {
+void ChromeBlobStorageContext::InitializeOnIOThread(
+    const base::FilePath& spill_directory) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   context_.reset(new BlobStorageContext());
+  // The blob readers use the file thread too.
+  if (!spill_directory.empty() &&
+      BrowserThread::IsMessageLoopValid(BrowserThread::FILE)) {
+    context_->EnableDiskSpilling(
+        spill_directory,
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get());
+  }
 }
 
 ChromeBlobStorageContext::~ChromeBlobStorageContext() {}
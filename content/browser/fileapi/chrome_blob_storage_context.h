@@ -10,6 +10,10 @@
 #include "base/sequenced_task_runner_helpers.h"
 #include "content/common/content_export.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace webkit_blob {
 class BlobStorageContext;
 }
@@ -34,7 +38,8 @@ class CONTENT_EXPORT ChromeBlobStorageContext
   static ChromeBlobStorageContext* GetFor(
       BrowserContext* browser_context);
 
-  void InitializeOnIOThread();
+  // Bytes of large blobs are spilled to |spill_directory| unless it's empty.
+  void InitializeOnIOThread(const base::FilePath& spill_directory);
 
   webkit_blob::BlobStorageContext* context() const {
     return context_.get();
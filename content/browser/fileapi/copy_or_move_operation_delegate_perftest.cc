@@ -0,0 +1,154 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webkit/browser/blob/file_stream_reader.h"
+#include "webkit/browser/fileapi/copy_or_move_operation_delegate.h"
+#include "webkit/browser/fileapi/file_stream_writer.h"
+
+using fileapi::CopyOrMoveOperationDelegate;
+using fileapi::FileStreamWriter;
+
+namespace content {
+
+namespace {
+
+const int kDefaultBufferSize = 32768;
+const int kMaxBufferSize = 1024 * 1024;
+
+void IgnoreProgress(int64 size) {}
+
+void AssignAndQuit(base::RunLoop* run_loop,
+                   base::File::Error* result_out,
+                   base::File::Error result) {
+  *result_out = result;
+  run_loop->Quit();
+}
+
+}  // namespace
+
+// Copies synthetic trees of files the way CopyOrMoveOperationDelegate does
+// across file systems, to compare the stream buffer sizes with a native copy.
+class CopyOrMoveOperationDelegatePerfTest : public testing::Test {
+ public:
+  CopyOrMoveOperationDelegatePerfTest() : file_thread_("file_thread") {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(file_thread_.Start());
+  }
+
+  virtual void TearDown() OVERRIDE {
+    file_thread_.Stop();
+  }
+
+ protected:
+  // Creates |directory_count| directories holding |files_per_directory| files
+  // of |file_size| bytes each.
+  void CreateTree(int directory_count,
+                  int files_per_directory,
+                  size_t file_size) {
+    std::string data(file_size, 'x');
+    base::FilePath src_root = temp_dir_.path().AppendASCII("src");
+    for (int i = 0; i < directory_count; ++i) {
+      base::FilePath dir =
+          src_root.AppendASCII(base::StringPrintf("dir%d", i));
+      ASSERT_TRUE(base::CreateDirectory(dir));
+      for (int j = 0; j < files_per_directory; ++j) {
+        base::FilePath path = dir.AppendASCII(base::StringPrintf("%d", j));
+        ASSERT_EQ(static_cast<int>(file_size),
+                  file_util::WriteFile(path, data.data(), data.size()));
+        src_files_.push_back(path);
+      }
+    }
+  }
+
+  base::FilePath DestPath(size_t index, const std::string& suffix) {
+    return temp_dir_.path().AppendASCII(
+        base::StringPrintf("dest_%s_%d", suffix.c_str(),
+                           static_cast<int>(index)));
+  }
+
+  void StreamCopyTree(int max_buffer_size, const std::string& suffix) {
+    for (size_t i = 0; i < src_files_.size(); ++i) {
+      base::FilePath dest_path = DestPath(i, suffix);
+      // LocalFileWriter requires the file exists.
+      ASSERT_EQ(0, file_util::WriteFile(dest_path, "", 0));
+      CopyOrMoveOperationDelegate::StreamCopyHelper helper(
+          make_scoped_ptr(webkit_blob::FileStreamReader::CreateForLocalFile(
+              file_thread_.message_loop_proxy().get(), src_files_[i], 0,
+              base::Time())),
+          make_scoped_ptr(FileStreamWriter::CreateForLocalFile(
+              file_thread_.message_loop_proxy().get(), dest_path, 0)),
+          false,  // don't need flush
+          kDefaultBufferSize,
+          max_buffer_size,
+          base::Bind(&IgnoreProgress),
+          base::TimeDelta::FromMilliseconds(50));
+      base::File::Error error = base::File::FILE_ERROR_FAILED;
+      base::RunLoop run_loop;
+      helper.Run(base::Bind(&AssignAndQuit, &run_loop, &error));
+      run_loop.Run();
+      ASSERT_EQ(base::File::FILE_OK, error);
+    }
+  }
+
+  void NativeCopyTree(const std::string& suffix) {
+    for (size_t i = 0; i < src_files_.size(); ++i)
+      ASSERT_TRUE(base::CopyFile(src_files_[i], DestPath(i, suffix)));
+  }
+
+  void RunBenchmark(int directory_count,
+                    int files_per_directory,
+                    size_t file_size) {
+    CreateTree(directory_count, files_per_directory, file_size);
+    std::string suffix = base::StringPrintf(
+        " %d files of %d bytes", directory_count * files_per_directory,
+        static_cast<int>(file_size));
+    {
+      base::PerfTimeLogger timer(("Stream copy, fixed buffer" + suffix)
+                                     .c_str());
+      StreamCopyTree(kDefaultBufferSize, "fixed");
+      timer.Done();
+    }
+    {
+      base::PerfTimeLogger timer(("Stream copy, growing buffer" + suffix)
+                                     .c_str());
+      StreamCopyTree(kMaxBufferSize, "growing");
+      timer.Done();
+    }
+    {
+      base::PerfTimeLogger timer(("Native copy" + suffix).c_str());
+      NativeCopyTree("native");
+      timer.Done();
+    }
+  }
+
+  base::MessageLoopForIO message_loop_;
+  base::Thread file_thread_;
+  base::ScopedTempDir temp_dir_;
+  std::vector<base::FilePath> src_files_;
+};
+
+TEST_F(CopyOrMoveOperationDelegatePerfTest, ManySmallFiles) {
+  RunBenchmark(50, 20, 4 * 1024);
+}
+
+TEST_F(CopyOrMoveOperationDelegatePerfTest, FewLargeFiles) {
+  RunBenchmark(2, 5, 16 * 1024 * 1024);
+}
+
+}  // namespace content
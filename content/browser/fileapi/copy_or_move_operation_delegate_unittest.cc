@@ -745,6 +745,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper) {
       reader.Pass(), writer.Pass(),
       false,  // don't need flush
       10,  // buffer size
+      10,  // max buffer size
       base::Bind(&RecordFileProgressCallback, base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
 
@@ -766,6 +767,61 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper) {
   EXPECT_EQ(kTestData, content);
 }
 
+TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperGrowsBuffer) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath source_path = temp_dir.path().AppendASCII("source");
+  const char kTestData[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+  file_util::WriteFile(source_path, kTestData,
+                       arraysize(kTestData) - 1);  // Exclude trailing '\0'.
+
+  base::FilePath dest_path = temp_dir.path().AppendASCII("dest");
+  // LocalFileWriter requires the file exists. So create an empty file here.
+  file_util::WriteFile(dest_path, "", 0);
+
+  base::MessageLoopForIO message_loop;
+  base::Thread file_thread("file_thread");
+  ASSERT_TRUE(file_thread.Start());
+  ScopedThreadStopper thread_stopper(&file_thread);
+  ASSERT_TRUE(thread_stopper.is_valid());
+
+  scoped_refptr<base::MessageLoopProxy> task_runner =
+      file_thread.message_loop_proxy();
+
+  scoped_ptr<webkit_blob::FileStreamReader> reader(
+      webkit_blob::FileStreamReader::CreateForLocalFile(
+          task_runner.get(), source_path, 0, base::Time()));
+
+  scoped_ptr<FileStreamWriter> writer(
+      FileStreamWriter::CreateForLocalFile(task_runner.get(), dest_path, 0));
+
+  std::vector<int64> progress;
+  CopyOrMoveOperationDelegate::StreamCopyHelper helper(
+      reader.Pass(), writer.Pass(),
+      false,  // don't need flush
+      10,  // buffer size
+      40,  // max buffer size
+      base::Bind(&RecordFileProgressCallback, base::Unretained(&progress)),
+      base::TimeDelta());  // For testing, we need all the progress.
+
+  base::File::Error error = base::File::FILE_ERROR_FAILED;
+  base::RunLoop run_loop;
+  helper.Run(base::Bind(&AssignAndQuit, &run_loop, &error));
+  run_loop.Run();
+
+  // The reads are 10, 20 and then the remaining 6 bytes.
+  EXPECT_EQ(base::File::FILE_OK, error);
+  ASSERT_EQ(4U, progress.size());
+  EXPECT_EQ(0, progress[0]);
+  EXPECT_EQ(10, progress[1]);
+  EXPECT_EQ(30, progress[2]);
+  EXPECT_EQ(36, progress[3]);
+
+  std::string content;
+  ASSERT_TRUE(base::ReadFileToString(dest_path, &content));
+  EXPECT_EQ(kTestData, content);
+}
+
 TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperWithFlush) {
   // Testing the same configuration as StreamCopyHelper, but with |need_flush|
   // parameter set to true. Since it is hard to test that the flush is indeed
@@ -803,6 +859,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperWithFlush) {
       reader.Pass(), writer.Pass(),
       true,  // need flush
       10,  // buffer size
+      10,  // max buffer size
       base::Bind(&RecordFileProgressCallback, base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
 
@@ -857,6 +914,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper_Cancel) {
       reader.Pass(), writer.Pass(),
       false,  // need_flush
       10,  // buffer size
+      10,  // max buffer size
       base::Bind(&RecordFileProgressCallback, base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
 
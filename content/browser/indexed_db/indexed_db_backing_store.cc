@@ -7,6 +7,7 @@
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -41,6 +42,23 @@ static base::FilePath ComputeFileName(const GURL& origin_url) {
       .AddExtension(FILE_PATH_LITERAL(".indexeddb.leveldb"));
 }
 
+// Spilled values live next to the LevelDB files, so that they are counted
+// and deleted together with them.
+const base::FilePath::CharType kSpillDirectoryName[] =
+    FILE_PATH_LITERAL("spill");
+
+// Values smaller than this stay in LevelDB.
+const size_t kSpillThreshold = 64 * 1024;
+
+base::FilePath GetSpillFilePath(const base::FilePath& spill_path,
+                                int64 database_id,
+                                int64 object_store_id,
+                                int64 file_number) {
+  return spill_path.AppendASCII(base::Int64ToString(database_id))
+      .AppendASCII(base::Int64ToString(object_store_id))
+      .AppendASCII(base::Int64ToString(file_number));
+}
+
 }  // namespace
 
 static const int64 kKeyGeneratorInitialNumber =
@@ -69,6 +87,8 @@ enum IndexedDBBackingStoreErrorSource {
   DELETE_DATABASE,
   TRANSACTION_COMMIT_METHOD,  // TRANSACTION_COMMIT is a WinNT.h macro
   GET_DATABASE_NAMES,
+  SPILL_VALUE,
+  RELEASE_SPILLED_VALUE,
   INTERNAL_ERROR_MAX,
 };
 
@@ -223,7 +243,9 @@ class Comparator : public LevelDBComparator {
 // 0 - Initial version.
 // 1 - Adds UserIntVersion to DatabaseMetaData.
 // 2 - Adds DataVersion to to global metadata.
-static const int64 kLatestKnownSchemaVersion = 2;
+// 3 - Adds spilled value entries and LastSpillFileNumber to
+//     ObjectStoreMetaData.
+static const int64 kLatestKnownSchemaVersion = 3;
 WARN_UNUSED_RESULT static bool IsSchemaKnown(LevelDBDatabase* db, bool* known) {
   int64 db_schema_version = 0;
   bool found = false;
@@ -323,6 +345,10 @@ WARN_UNUSED_RESULT static bool SetUpMetadata(
       db_data_version = blink::kSerializedScriptValueVersion;
       PutInt(transaction.get(), data_version_key, db_data_version);
     }
+    if (db_schema_version < 3) {
+      db_schema_version = 3;
+      PutInt(transaction.get(), schema_version_key, db_schema_version);
+    }
   }
 
   // All new values will be written using this serialization version.
@@ -608,6 +634,7 @@ scoped_refptr<IndexedDBBackingStore> IndexedDBBackingStore::Open(
       return scoped_refptr<IndexedDBBackingStore>();
     }
 
+    base::DeleteFile(file_path.Append(kSpillDirectoryName), true);
     LOG(ERROR) << "IndexedDB backing store cleanup succeeded, reopening";
     leveldb_factory->OpenLevelDB(file_path, comparator.get(), &db, NULL);
     if (!db) {
@@ -627,7 +654,11 @@ scoped_refptr<IndexedDBBackingStore> IndexedDBBackingStore::Open(
     return scoped_refptr<IndexedDBBackingStore>();
   }
 
-  return Create(origin_url, db.Pass(), comparator.Pass());
+  scoped_refptr<IndexedDBBackingStore> backing_store =
+      Create(origin_url, db.Pass(), comparator.Pass());
+  if (backing_store.get())
+    backing_store->spill_path_ = file_path.Append(kSpillDirectoryName);
+  return backing_store;
 }
 
 // static
@@ -863,6 +894,10 @@ leveldb::Status IndexedDBBackingStore::DeleteDatabase(
     INTERNAL_WRITE_ERROR(DELETE_DATABASE);
     return s;
   }
+  if (!spill_path_.empty()) {
+    base::DeleteFile(
+        spill_path_.AppendASCII(base::Int64ToString(metadata.id)), true);
+  }
   db_->Compact(start_key, stop_key);
   return s;
 }
@@ -1034,6 +1069,15 @@ leveldb::Status IndexedDBBackingStore::GetObjectStores(
       it->Next();
     }
 
+    // [optional] last spill file number, only used when spilling values.
+    if (CheckObjectStoreAndMetaDataType(
+            it.get(),
+            stop_key,
+            object_store_id,
+            ObjectStoreMetaDataKey::LAST_SPILL_FILE_NUMBER)) {
+      it->Next();
+    }
+
     IndexedDBObjectStoreMetadata metadata(object_store_name,
                                           object_store_id,
                                           key_path,
@@ -1165,16 +1209,62 @@ leveldb::Status IndexedDBBackingStore::DeleteObjectStore(
   return ClearObjectStore(transaction, database_id, object_store_id);
 }
 
-leveldb::Status IndexedDBBackingStore::GetRecord(
-    IndexedDBBackingStore::Transaction* transaction,
+// Reads a value that was spilled to a file into |value|. Only values that
+// are empty in their object store data entry can have been spilled.
+template <typename DBOrTransaction>
+WARN_UNUSED_RESULT static leveldb::Status LoadSpilledValue(
+    DBOrTransaction* transaction,
+    const base::FilePath& spill_path,
+    int64 database_id,
+    int64 object_store_id,
+    const std::string& spilled_value_key,
+    std::string* value) {
+  if (spill_path.empty() || !value->empty())
+    return leveldb::Status::OK();
+  int64 file_number = 0;
+  bool found = false;
+  leveldb::Status s =
+      GetVarInt(transaction, spilled_value_key, &file_number, &found);
+  if (!s.ok() || !found)
+    return s;
+  if (!base::ReadFileToString(
+          GetSpillFilePath(
+              spill_path, database_id, object_store_id, file_number),
+          value)) {
+    return leveldb::Status::IOError("Unable to read spilled value");
+  }
+  return s;
+}
+
+// Reads a LevelDBTransaction as it was when it began, for reads on other
+// threads.
+class CommittedReader {
+ public:
+  explicit CommittedReader(const LevelDBTransaction* transaction)
+      : transaction_(transaction) {}
+
+  leveldb::Status Get(const StringPiece& key,
+                      std::string* value,
+                      bool* found) {
+    return transaction_->GetCommitted(key, value, found);
+  }
+
+ private:
+  const LevelDBTransaction* transaction_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommittedReader);
+};
+
+template <typename DBOrTransaction>
+WARN_UNUSED_RESULT static leveldb::Status ReadRecord(
+    DBOrTransaction* leveldb_transaction,
+    const base::FilePath& spill_path,
     int64 database_id,
     int64 object_store_id,
     const IndexedDBKey& key,
     std::string* record) {
-  IDB_TRACE("IndexedDBBackingStore::GetRecord");
   if (!KeyPrefix::ValidIds(database_id, object_store_id))
     return InvalidDBKeyStatus();
-  LevelDBTransaction* leveldb_transaction = transaction->transaction();
 
   const std::string leveldb_key =
       ObjectStoreDataKey::Encode(database_id, object_store_id, key);
@@ -1203,9 +1293,45 @@ leveldb::Status IndexedDBBackingStore::GetRecord(
   }
 
   *record = slice.as_string();
+  s = LoadSpilledValue(
+      leveldb_transaction,
+      spill_path,
+      database_id,
+      object_store_id,
+      SpilledValueKey::Encode(database_id, object_store_id, key),
+      record);
+  if (!s.ok())
+    INTERNAL_READ_ERROR(GET_RECORD);
   return s;
 }
 
+leveldb::Status IndexedDBBackingStore::GetRecord(
+    IndexedDBBackingStore::Transaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const IndexedDBKey& key,
+    std::string* record) {
+  IDB_TRACE("IndexedDBBackingStore::GetRecord");
+  return ReadRecord(transaction->transaction(),
+                    spill_path_,
+                    database_id,
+                    object_store_id,
+                    key,
+                    record);
+}
+
+leveldb::Status IndexedDBBackingStore::GetCommittedRecord(
+    const LevelDBTransaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const IndexedDBKey& key,
+    std::string* record) {
+  IDB_TRACE("IndexedDBBackingStore::GetCommittedRecord");
+  CommittedReader reader(transaction);
+  return ReadRecord(
+      &reader, spill_path_, database_id, object_store_id, key, record);
+}
+
 WARN_UNUSED_RESULT static leveldb::Status GetNewVersionNumber(
     LevelDBTransaction* transaction,
     int64 database_id,
@@ -1262,7 +1388,27 @@ leveldb::Status IndexedDBBackingStore::PutRecord(
 
   std::string v;
   EncodeVarInt(version, &v);
-  v.append(value);
+  if (!spill_path_.empty()) {
+    const std::string spilled_value_key =
+        SpilledValueKey::Encode(database_id, object_store_id, key);
+    s = ReleaseSpilledValue(
+        transaction, database_id, object_store_id, spilled_value_key);
+    if (!s.ok())
+      return s;
+    if (value.size() >= kSpillThreshold) {
+      s = SpillValue(transaction,
+                     database_id,
+                     object_store_id,
+                     spilled_value_key,
+                     value);
+      if (!s.ok())
+        return s;
+    } else {
+      v.append(value);
+    }
+  } else {
+    v.append(value);
+  }
 
   leveldb_transaction->Put(object_storedata_key, &v);
 
@@ -1290,6 +1436,26 @@ leveldb::Status IndexedDBBackingStore::ClearObjectStore(
   const std::string stop_key =
       KeyPrefix(database_id, object_store_id + 1).Encode();
 
+  if (!spill_path_.empty()) {
+    const std::string spill_stop_key =
+        SpilledValueKey::Encode(database_id, object_store_id, MaxIDBKey());
+    scoped_ptr<LevelDBIterator> it =
+        transaction->transaction()->CreateIterator();
+    for (it->Seek(SpilledValueKey::Encode(
+             database_id, object_store_id, MinIDBKey()));
+         it->IsValid() && CompareKeys(it->Key(), spill_stop_key) < 0;
+         it->Next()) {
+      StringPiece slice(it->Value());
+      int64 file_number = 0;
+      if (!DecodeVarInt(&slice, &file_number)) {
+        INTERNAL_READ_ERROR(RELEASE_SPILLED_VALUE);
+        continue;
+      }
+      transaction->AddReleasedFile(GetSpillFilePath(
+          spill_path_, database_id, object_store_id, file_number));
+    }
+  }
+
   DeleteRange(transaction->transaction(), start_key, stop_key);
   return leveldb::Status::OK();
 }
@@ -1311,7 +1477,79 @@ leveldb::Status IndexedDBBackingStore::DeleteRecord(
   const std::string exists_entry_key = ExistsEntryKey::Encode(
       database_id, object_store_id, record_identifier.primary_key());
   leveldb_transaction->Remove(exists_entry_key);
-  return leveldb::Status::OK();
+
+  if (spill_path_.empty())
+    return leveldb::Status::OK();
+  return ReleaseSpilledValue(
+      transaction,
+      database_id,
+      object_store_id,
+      SpilledValueKey::Encode(
+          database_id, object_store_id, record_identifier.primary_key()));
+}
+
+leveldb::Status IndexedDBBackingStore::SpillValue(
+    IndexedDBBackingStore::Transaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const std::string& spilled_value_key,
+    const std::string& value) {
+  IDB_TRACE("IndexedDBBackingStore::SpillValue");
+  DCHECK(!spill_path_.empty());
+  LevelDBTransaction* leveldb_transaction = transaction->transaction();
+
+  // Transactions that write to the same object store don't overlap, so file
+  // numbers are allocated per object store.
+  const std::string last_file_number_key = ObjectStoreMetaDataKey::Encode(
+      database_id,
+      object_store_id,
+      ObjectStoreMetaDataKey::LAST_SPILL_FILE_NUMBER);
+  int64 file_number = 0;
+  bool found = false;
+  leveldb::Status s = GetVarInt(
+      leveldb_transaction, last_file_number_key, &file_number, &found);
+  if (!s.ok()) {
+    INTERNAL_READ_ERROR(SPILL_VALUE);
+    return s;
+  }
+  ++file_number;
+
+  const base::FilePath path =
+      GetSpillFilePath(spill_path_, database_id, object_store_id, file_number);
+  if (!base::CreateDirectory(path.DirName()) ||
+      file_util::WriteFile(path, value.data(), value.size()) !=
+          static_cast<int>(value.size())) {
+    base::DeleteFile(path, false);
+    INTERNAL_WRITE_ERROR(SPILL_VALUE);
+    return leveldb::Status::IOError("Unable to write spilled value");
+  }
+  transaction->AddWrittenFile(path);
+
+  PutVarInt(leveldb_transaction, last_file_number_key, file_number);
+  PutVarInt(leveldb_transaction, spilled_value_key, file_number);
+  return s;
+}
+
+leveldb::Status IndexedDBBackingStore::ReleaseSpilledValue(
+    IndexedDBBackingStore::Transaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const std::string& spilled_value_key) {
+  LevelDBTransaction* leveldb_transaction = transaction->transaction();
+  int64 file_number = 0;
+  bool found = false;
+  leveldb::Status s = GetVarInt(
+      leveldb_transaction, spilled_value_key, &file_number, &found);
+  if (!s.ok()) {
+    INTERNAL_READ_ERROR(RELEASE_SPILLED_VALUE);
+    return s;
+  }
+  if (!found)
+    return s;
+  leveldb_transaction->Remove(spilled_value_key);
+  transaction->AddReleasedFile(
+      GetSpillFilePath(spill_path_, database_id, object_store_id, file_number));
+  return s;
 }
 
 leveldb::Status IndexedDBBackingStore::GetKeyGeneratorCurrentNumber(
@@ -2163,6 +2401,19 @@ bool ObjectStoreCursorImpl::LoadCurrentRow() {
   record_identifier_.Reset(encoded_key, version);
 
   current_value_ = slice.as_string();
+  leveldb::Status s = LoadSpilledValue(
+      transaction_,
+      cursor_options_.spill_path,
+      cursor_options_.database_id,
+      cursor_options_.object_store_id,
+      SpilledValueKey::Encode(cursor_options_.database_id,
+                              cursor_options_.object_store_id,
+                              encoded_key),
+      &current_value_);
+  if (!s.ok()) {
+    INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
+    return false;
+  }
   return true;
 }
 
@@ -2378,6 +2629,18 @@ bool IndexCursorImpl::LoadCurrentRow() {
   }
 
   current_value_ = slice.as_string();
+  s = LoadSpilledValue(transaction_,
+                       cursor_options_.spill_path,
+                       index_data_key.DatabaseId(),
+                       index_data_key.ObjectStoreId(),
+                       SpilledValueKey::Encode(index_data_key.DatabaseId(),
+                                               index_data_key.ObjectStoreId(),
+                                               *primary_key_),
+                       &current_value_);
+  if (!s.ok()) {
+    INTERNAL_READ_ERROR(LOAD_CURRENT_ROW);
+    return false;
+  }
   return true;
 }
 
@@ -2534,6 +2797,7 @@ IndexedDBBackingStore::OpenObjectStoreCursor(
                                 direction,
                                 &cursor_options))
     return scoped_ptr<IndexedDBBackingStore::Cursor>();
+  cursor_options.spill_path = spill_path_;
   scoped_ptr<ObjectStoreCursorImpl> cursor(
       new ObjectStoreCursorImpl(leveldb_transaction, cursor_options));
   if (!cursor->FirstSeek())
@@ -2613,6 +2877,7 @@ IndexedDBBackingStore::OpenIndexCursor(
                           direction,
                           &cursor_options))
     return scoped_ptr<IndexedDBBackingStore::Cursor>();
+  cursor_options.spill_path = spill_path_;
   scoped_ptr<IndexCursorImpl> cursor(
       new IndexCursorImpl(leveldb_transaction, cursor_options));
   if (!cursor->FirstSeek())
@@ -2640,6 +2905,10 @@ leveldb::Status IndexedDBBackingStore::Transaction::Commit() {
   transaction_ = NULL;
   if (!s.ok())
     INTERNAL_WRITE_ERROR(TRANSACTION_COMMIT_METHOD);
+  // Files are only deleted once nothing in LevelDB points at them anymore.
+  DeleteFiles(s.ok() ? released_files_ : written_files_);
+  written_files_.clear();
+  released_files_.clear();
   return s;
 }
 
@@ -2648,6 +2917,17 @@ void IndexedDBBackingStore::Transaction::Rollback() {
   DCHECK(transaction_.get());
   transaction_->Rollback();
   transaction_ = NULL;
+  DeleteFiles(written_files_);
+  written_files_.clear();
+  released_files_.clear();
+}
+
+void IndexedDBBackingStore::Transaction::DeleteFiles(
+    const std::vector<base::FilePath>& files) {
+  for (std::vector<base::FilePath>::const_iterator it = files.begin();
+       it != files.end();
+       ++it)
+    base::DeleteFile(*it, false);
 }
 
 }  // namespace content
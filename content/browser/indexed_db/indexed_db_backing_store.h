@@ -45,6 +45,7 @@ class CONTENT_EXPORT IndexedDBBackingStore
   class CONTENT_EXPORT Transaction;
 
   const GURL& origin_url() const { return origin_url_; }
+  bool is_on_disk() const { return !spill_path_.empty(); }
   base::OneShotTimer<IndexedDBBackingStore>* close_timer() {
     return &close_timer_;
   }
@@ -127,6 +128,14 @@ class CONTENT_EXPORT IndexedDBBackingStore
       int64 object_store_id,
       const IndexedDBKey& key,
       std::string* record) WARN_UNUSED_RESULT;
+  // Like GetRecord(), but reads |transaction| as it was when it began, and
+  // may be called on any thread. The caller keeps the backing store and
+  // |transaction| alive meanwhile.
+  leveldb::Status GetCommittedRecord(const LevelDBTransaction* transaction,
+                                     int64 database_id,
+                                     int64 object_store_id,
+                                     const IndexedDBKey& key,
+                                     std::string* record) WARN_UNUSED_RESULT;
   virtual leveldb::Status PutRecord(
       IndexedDBBackingStore::Transaction* transaction,
       int64 database_id,
@@ -220,6 +229,8 @@ class CONTENT_EXPORT IndexedDBBackingStore
       bool high_open;
       bool forward;
       bool unique;
+      // Where values spilled to files are read from, if anywhere.
+      base::FilePath spill_path;
     };
 
     const IndexedDBKey& key() const { return *current_key_; }
@@ -299,9 +310,22 @@ class CONTENT_EXPORT IndexedDBBackingStore
 
     LevelDBTransaction* transaction() { return transaction_; }
 
+    // Spill files written by the transaction are deleted if it doesn't
+    // commit, and the ones it released only once it commits.
+    void AddWrittenFile(const base::FilePath& path) {
+      written_files_.push_back(path);
+    }
+    void AddReleasedFile(const base::FilePath& path) {
+      released_files_.push_back(path);
+    }
+
    private:
+    static void DeleteFiles(const std::vector<base::FilePath>& files);
+
     IndexedDBBackingStore* backing_store_;
     scoped_refptr<LevelDBTransaction> transaction_;
+    std::vector<base::FilePath> written_files_;
+    std::vector<base::FilePath> released_files_;
   };
 
  protected:
@@ -317,6 +341,20 @@ class CONTENT_EXPORT IndexedDBBackingStore
       scoped_ptr<LevelDBDatabase> db,
       scoped_ptr<LevelDBComparator> comparator);
 
+  // Writes |value| to a new file and points |spilled_value_key| at it.
+  leveldb::Status SpillValue(IndexedDBBackingStore::Transaction* transaction,
+                             int64 database_id,
+                             int64 object_store_id,
+                             const std::string& spilled_value_key,
+                             const std::string& value) WARN_UNUSED_RESULT;
+  // Removes |spilled_value_key|, if present, and deletes the file it points
+  // at once |transaction| commits.
+  leveldb::Status ReleaseSpilledValue(
+      IndexedDBBackingStore::Transaction* transaction,
+      int64 database_id,
+      int64 object_store_id,
+      const std::string& spilled_value_key) WARN_UNUSED_RESULT;
+
   leveldb::Status FindKeyInIndex(
       IndexedDBBackingStore::Transaction* transaction,
       int64 database_id,
@@ -340,6 +378,11 @@ class CONTENT_EXPORT IndexedDBBackingStore
   // provides for future flexibility.
   const std::string origin_identifier_;
 
+  // Values at least kSpillThreshold bytes large are written to files in
+  // this directory instead of LevelDB, so that compactions don't keep
+  // rewriting them. Empty for in-memory backing stores, which never spill.
+  base::FilePath spill_path_;
+
   scoped_ptr<LevelDBDatabase> db_;
   scoped_ptr<LevelDBComparator> comparator_;
   base::OneShotTimer<IndexedDBBackingStore> close_timer_;
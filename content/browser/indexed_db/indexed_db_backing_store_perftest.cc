@@ -0,0 +1,165 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/indexed_db/indexed_db_backing_store.h"
+
+#include "base/files/file_enumerator.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "content/common/indexed_db/indexed_db_key_range.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/WebKit/public/platform/WebIDBTypes.h"
+#include "url/gurl.h"
+
+namespace content {
+
+namespace {
+
+const int64 kDatabaseId = 1;
+const int64 kObjectStoreId = 1;
+
+IndexedDBKey KeyForIndex(int i) {
+  return IndexedDBKey(i, blink::WebIDBKeyTypeNumber);
+}
+
+}  // namespace
+
+class IndexedDBBackingStorePerfTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    blink::WebIDBDataLoss data_loss = blink::WebIDBDataLossNone;
+    std::string data_loss_message;
+    bool disk_full = false;
+    backing_store_ = IndexedDBBackingStore::Open(GURL("http://localhost:81"),
+                                                 temp_dir_.path(),
+                                                 &data_loss,
+                                                 &data_loss_message,
+                                                 &disk_full);
+    ASSERT_TRUE(backing_store_.get());
+  }
+
+  // Writes |record_count| records of |value_size| bytes in one transaction.
+  void PutRecords(int record_count, size_t value_size) {
+    std::string value(value_size, 'x');
+    IndexedDBBackingStore::Transaction transaction(backing_store_);
+    transaction.Begin();
+    for (int i = 0; i < record_count; ++i) {
+      IndexedDBBackingStore::RecordIdentifier record;
+      ASSERT_TRUE(backing_store_->PutRecord(&transaction,
+                                            kDatabaseId,
+                                            kObjectStoreId,
+                                            KeyForIndex(i),
+                                            value,
+                                            &record).ok());
+    }
+    ASSERT_TRUE(transaction.Commit().ok());
+  }
+
+  void GetRecords(int record_count) {
+    IndexedDBBackingStore::Transaction transaction(backing_store_);
+    transaction.Begin();
+    std::string value;
+    for (int i = 0; i < record_count; ++i) {
+      ASSERT_TRUE(backing_store_->GetRecord(&transaction,
+                                            kDatabaseId,
+                                            kObjectStoreId,
+                                            KeyForIndex(i),
+                                            &value).ok());
+    }
+    ASSERT_TRUE(transaction.Commit().ok());
+  }
+
+  // Iterates over all records, reading the values like a prefetching
+  // IndexedDBCursor does.
+  void IterateRecords(int record_count) {
+    IndexedDBBackingStore::Transaction transaction(backing_store_);
+    transaction.Begin();
+    scoped_ptr<IndexedDBBackingStore::Cursor> cursor =
+        backing_store_->OpenObjectStoreCursor(&transaction,
+                                              kDatabaseId,
+                                              kObjectStoreId,
+                                              IndexedDBKeyRange(),
+                                              indexed_db::CURSOR_NEXT);
+    ASSERT_TRUE(cursor.get());
+    int count = 0;
+    std::string value;
+    do {
+      value.swap(*cursor->value());
+      ++count;
+    } while (cursor->Continue());
+    EXPECT_EQ(record_count, count);
+    ASSERT_TRUE(transaction.Commit().ok());
+  }
+
+  // Returns the size of the LevelDB files, which compactions rewrite, leaving
+  // out the values spilled to files of their own.
+  int64 LevelDBSize() {
+    int64 size = 0;
+    base::FileEnumerator enumerator(
+        temp_dir_.path(), true, base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      if (path.DirName().Extension() == FILE_PATH_LITERAL(".leveldb"))
+        size += enumerator.GetInfo().GetSize();
+    }
+    return size;
+  }
+
+  void RunBenchmark(int record_count, size_t value_size) {
+    std::string suffix = base::StringPrintf(" %d records of %d bytes",
+                                            record_count,
+                                            static_cast<int>(value_size));
+    {
+      base::PerfTimeLogger timer(("Put" + suffix).c_str());
+      PutRecords(record_count, value_size);
+      timer.Done();
+    }
+    {
+      base::PerfTimeLogger timer(("Get" + suffix).c_str());
+      GetRecords(record_count);
+      timer.Done();
+    }
+    {
+      base::PerfTimeLogger timer(("Cursor" + suffix).c_str());
+      IterateRecords(record_count);
+      timer.Done();
+    }
+    {
+      // Overwriting makes LevelDB compact away the old values.
+      base::PerfTimeLogger timer(("Overwrite" + suffix).c_str());
+      PutRecords(record_count, value_size);
+      timer.Done();
+    }
+    perf_test::PrintResult("leveldb_size",
+                           "",
+                           base::StringPrintf("%d_records_of_%d_bytes",
+                                              record_count,
+                                              static_cast<int>(value_size)),
+                           static_cast<size_t>(LevelDBSize()),
+                           "bytes",
+                           true);
+  }
+
+ protected:
+  base::ScopedTempDir temp_dir_;
+  scoped_refptr<IndexedDBBackingStore> backing_store_;
+};
+
+TEST_F(IndexedDBBackingStorePerfTest, SmallRecords) {
+  RunBenchmark(10000, 100);
+}
+
+TEST_F(IndexedDBBackingStorePerfTest, LargeRecords) {
+  RunBenchmark(10000, 10 * 1024);
+}
+
+// These are spilled to files instead of being stored in LevelDB.
+TEST_F(IndexedDBBackingStorePerfTest, SpilledRecords) {
+  RunBenchmark(500, 256 * 1024);
+}
+
+}  // namespace content
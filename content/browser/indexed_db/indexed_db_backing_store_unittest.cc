@@ -4,6 +4,8 @@
 
 #include "content/browser/indexed_db/indexed_db_backing_store.h"
 
+#include "base/files/file_enumerator.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
@@ -48,6 +50,20 @@ class IndexedDBBackingStoreTest : public testing::Test {
   DISALLOW_COPY_AND_ASSIGN(IndexedDBBackingStoreTest);
 };
 
+// Counts the files values were spilled to, which live in
+// spill/<database id>/<object store id>/ below the LevelDB directory.
+int CountSpillFiles(const base::FilePath& path) {
+  int count = 0;
+  base::FileEnumerator enumerator(path, true, base::FileEnumerator::FILES);
+  for (base::FilePath file = enumerator.Next(); !file.empty();
+       file = enumerator.Next()) {
+    if (file.DirName().DirName().DirName().BaseName().value() ==
+        FILE_PATH_LITERAL("spill"))
+      ++count;
+  }
+  return count;
+}
+
 TEST_F(IndexedDBBackingStoreTest, PutGetConsistency) {
   {
     IndexedDBBackingStore::Transaction transaction1(backing_store_);
@@ -318,6 +334,94 @@ TEST_F(IndexedDBBackingStoreTest, CreateDatabase) {
   }
 }
 
+// Large values are written to files that live as long as the records
+// pointing at them.
+TEST(IndexedDBBackingStoreSpillTest, SpilledValues) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  blink::WebIDBDataLoss data_loss = blink::WebIDBDataLossNone;
+  std::string data_loss_message;
+  bool disk_full = false;
+  scoped_refptr<IndexedDBBackingStore> backing_store =
+      IndexedDBBackingStore::Open(GURL("http://localhost:81"),
+                                  temp_dir.path(),
+                                  &data_loss,
+                                  &data_loss_message,
+                                  &disk_full);
+  ASSERT_TRUE(backing_store.get());
+
+  const IndexedDBKey key(ASCIIToUTF16("key"));
+  const std::string large_value(256 * 1024, 'x');
+  const std::string small_value("small");
+  IndexedDBBackingStore::RecordIdentifier record;
+
+  {
+    IndexedDBBackingStore::Transaction transaction(backing_store);
+    transaction.Begin();
+    EXPECT_TRUE(backing_store->PutRecord(
+        &transaction, 1, 1, key, large_value, &record).ok());
+    EXPECT_EQ(1, CountSpillFiles(temp_dir.path()));
+    transaction.Rollback();
+    EXPECT_EQ(0, CountSpillFiles(temp_dir.path()));
+  }
+
+  {
+    IndexedDBBackingStore::Transaction transaction(backing_store);
+    transaction.Begin();
+    EXPECT_TRUE(backing_store->PutRecord(
+        &transaction, 1, 1, key, large_value, &record).ok());
+    EXPECT_TRUE(transaction.Commit().ok());
+    EXPECT_EQ(1, CountSpillFiles(temp_dir.path()));
+  }
+
+  {
+    IndexedDBBackingStore::Transaction transaction(backing_store);
+    transaction.Begin();
+    std::string result_value;
+    EXPECT_TRUE(backing_store->GetRecord(
+        &transaction, 1, 1, key, &result_value).ok());
+    EXPECT_EQ(large_value, result_value);
+
+    scoped_ptr<IndexedDBBackingStore::Cursor> cursor =
+        backing_store->OpenObjectStoreCursor(&transaction,
+                                             1,
+                                             1,
+                                             IndexedDBKeyRange(),
+                                             indexed_db::CURSOR_NEXT);
+    ASSERT_TRUE(cursor.get());
+    EXPECT_EQ(large_value, *cursor->value());
+    EXPECT_TRUE(transaction.Commit().ok());
+  }
+
+  {
+    // The old file is still needed until the overwrite commits.
+    IndexedDBBackingStore::Transaction transaction(backing_store);
+    transaction.Begin();
+    EXPECT_TRUE(backing_store->PutRecord(
+        &transaction, 1, 1, key, small_value, &record).ok());
+    EXPECT_EQ(1, CountSpillFiles(temp_dir.path()));
+    EXPECT_TRUE(transaction.Commit().ok());
+    EXPECT_EQ(0, CountSpillFiles(temp_dir.path()));
+
+    transaction.Begin();
+    std::string result_value;
+    EXPECT_TRUE(backing_store->GetRecord(
+        &transaction, 1, 1, key, &result_value).ok());
+    EXPECT_EQ(small_value, result_value);
+    EXPECT_TRUE(transaction.Commit().ok());
+  }
+
+  {
+    IndexedDBBackingStore::Transaction transaction(backing_store);
+    transaction.Begin();
+    EXPECT_TRUE(backing_store->PutRecord(
+        &transaction, 1, 1, key, large_value, &record).ok());
+    EXPECT_TRUE(backing_store->ClearObjectStore(&transaction, 1, 1).ok());
+    EXPECT_TRUE(transaction.Commit().ok());
+    EXPECT_EQ(0, CountSpillFiles(temp_dir.path()));
+  }
+}
+
 }  // namespace
 
 }  // namespace content
@@ -320,8 +320,10 @@ void IndexedDBContextImpl::DeleteForOrigin(const GURL& origin_url) {
     // LevelDB does not delete empty directories; work around this.
     // TODO(jsbell): Remove when upstream bug is fixed.
     // https://code.google.com/p/leveldb/issues/detail?id=209
-    const bool kNonRecursive = false;
-    base::DeleteFile(idb_directory, kNonRecursive);
+    // The directory also holds the values the backing store spilled to
+    // files, which LevelDB doesn't know about.
+    const bool kRecursive = true;
+    base::DeleteFile(idb_directory, kRecursive);
   }
 
   QueryDiskAndUpdateQuotaUsage(origin_url);
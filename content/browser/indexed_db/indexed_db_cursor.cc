@@ -4,6 +4,8 @@
 
 #include "content/browser/indexed_db/indexed_db_cursor.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "content/browser/indexed_db/indexed_db_callbacks.h"
@@ -13,6 +15,18 @@
 
 namespace content {
 
+namespace {
+
+// Upper bound on the size of a prefetch response.
+const size_t kMaxPrefetchSizeEstimate = 10 * 1024 * 1024;
+
+// Records past the number requested are only read while the response is
+// smaller than this, and there are at most this many records in total.
+const size_t kExtendedPrefetchSizeEstimate = 256 * 1024;
+const int kMaxExtendedPrefetchAmount = 1000;
+
+}  // namespace
+
 IndexedDBCursor::IndexedDBCursor(
     scoped_ptr<IndexedDBBackingStore::Cursor> cursor,
     indexed_db::CursorType cursor_type,
@@ -22,6 +36,7 @@ IndexedDBCursor::IndexedDBCursor(
       cursor_type_(cursor_type),
       transaction_(transaction),
       cursor_(cursor.Pass()),
+      full_prefetches_(0),
       closed_(false) {
   transaction_->RegisterOpenCursor(this);
 }
@@ -59,6 +74,7 @@ void IndexedDBCursor::CursorAdvanceOperation(
     scoped_refptr<IndexedDBCallbacks> callbacks,
     IndexedDBTransaction* /*transaction*/) {
   IDB_TRACE("IndexedDBCursor::CursorAdvanceOperation");
+  full_prefetches_ = 0;
   if (!cursor_ || !cursor_->Advance(count)) {
     cursor_.reset();
     callbacks->OnSuccess(static_cast<std::string*>(NULL));
@@ -74,6 +90,7 @@ void IndexedDBCursor::CursorIterationOperation(
     scoped_refptr<IndexedDBCallbacks> callbacks,
     IndexedDBTransaction* /*transaction*/) {
   IDB_TRACE("IndexedDBCursor::CursorIterationOperation");
+  full_prefetches_ = 0;
   if (!cursor_ ||
       !cursor_->Continue(
            key.get(), primary_key.get(), IndexedDBBackingStore::Cursor::SEEK)) {
@@ -104,15 +121,35 @@ void IndexedDBCursor::CursorPrefetchIterationOperation(
     IndexedDBTransaction* /*transaction*/) {
   IDB_TRACE("IndexedDBCursor::CursorPrefetchIterationOperation");
 
+  // The previous prefetch wasn't reset, so all of its results were used.
+  // Each batch costs a task and an IPC round trip, so while that keeps
+  // happening, read up to twice as far ahead each time, as long as the
+  // records are small.
+  if (saved_cursor_)
+    full_prefetches_ = std::min(full_prefetches_ + 1, 4);
+  else
+    full_prefetches_ = 0;
+  int max_to_fetch = number_to_fetch;
+  if (full_prefetches_ > 0) {
+    max_to_fetch = std::max(
+        number_to_fetch,
+        std::min(number_to_fetch << full_prefetches_,
+                 kMaxExtendedPrefetchAmount));
+  }
+
   std::vector<IndexedDBKey> found_keys;
   std::vector<IndexedDBKey> found_primary_keys;
   std::vector<std::string> found_values;
+  found_keys.reserve(number_to_fetch);
+  found_primary_keys.reserve(number_to_fetch);
+  found_values.reserve(number_to_fetch);
 
   saved_cursor_.reset();
-  const size_t max_size_estimate = 10 * 1024 * 1024;
   size_t size_estimate = 0;
 
-  for (int i = 0; i < number_to_fetch; ++i) {
+  for (int i = 0; i < max_to_fetch; ++i) {
+    if (i >= number_to_fetch && size_estimate > kExtendedPrefetchSizeEstimate)
+      break;
     if (!cursor_ || !cursor_->Continue()) {
       cursor_.reset();
       break;
@@ -131,20 +168,19 @@ void IndexedDBCursor::CursorPrefetchIterationOperation(
       case indexed_db::CURSOR_KEY_ONLY:
         found_values.push_back(std::string());
         break;
-      case indexed_db::CURSOR_KEY_AND_VALUE: {
-        std::string value;
-        value.swap(*cursor_->value());
-        size_estimate += value.size();
-        found_values.push_back(value);
+      case indexed_db::CURSOR_KEY_AND_VALUE:
+        // Take the value without copying it.
+        found_values.push_back(std::string());
+        found_values.back().swap(*cursor_->value());
+        size_estimate += found_values.back().size();
         break;
-      }
       default:
         NOTREACHED();
     }
     size_estimate += cursor_->key().size_estimate();
     size_estimate += cursor_->primary_key().size_estimate();
 
-    if (size_estimate > max_size_estimate)
+    if (size_estimate > kMaxPrefetchSizeEstimate)
       break;
   }
 
@@ -162,6 +198,7 @@ void IndexedDBCursor::PrefetchReset(int used_prefetches,
   IDB_TRACE("IndexedDBCursor::PrefetchReset");
   cursor_.swap(saved_cursor_);
   saved_cursor_.reset();
+  full_prefetches_ = 0;
 
   if (closed_)
     return;
@@ -68,6 +68,10 @@ class CONTENT_EXPORT IndexedDBCursor
   // Must be destroyed before transaction_.
   scoped_ptr<IndexedDBBackingStore::Cursor> saved_cursor_;
 
+  // Number of prefetches in a row whose results were all used, which lets
+  // prefetches of small records read further ahead than requested.
+  int full_prefetches_;
+
   bool closed_;
 };
 
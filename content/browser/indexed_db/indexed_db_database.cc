@@ -13,6 +13,7 @@
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/worker_pool.h"
 #include "content/browser/indexed_db/indexed_db_connection.h"
 #include "content/browser/indexed_db/indexed_db_cursor.h"
 #include "content/browser/indexed_db/indexed_db_factory.h"
@@ -514,6 +515,22 @@ void IndexedDBDatabase::Get(int64 transaction_id,
       callbacks));
 }
 
+struct IndexedDBDatabase::CommittedRecord {
+  leveldb::Status status;
+  std::string value;
+};
+
+static void GetCommittedRecordOnWorker(
+    IndexedDBBackingStore* backing_store,
+    const LevelDBTransaction* transaction,
+    int64 database_id,
+    int64 object_store_id,
+    const IndexedDBKey& key,
+    IndexedDBDatabase::CommittedRecord* record) {
+  record->status = backing_store->GetCommittedRecord(
+      transaction, database_id, object_store_id, key, &record->value);
+}
+
 void IndexedDBDatabase::GetOperation(
     int64 object_store_id,
     int64 index_id,
@@ -528,6 +545,37 @@ void IndexedDBDatabase::GetOperation(
   const IndexedDBObjectStoreMetadata& object_store_metadata =
       metadata_.object_stores[object_store_id];
 
+  // Read-only transactions look up records on a worker thread, against the
+  // snapshot their LevelDB transaction took, so that several of them can
+  // wait on the disk at once. Everything else stays on this thread.
+  if (transaction->mode() == indexed_db::TRANSACTION_READ_ONLY &&
+      index_id == IndexedDBIndexMetadata::kInvalidId &&
+      key_range->IsOnlyKey() && backing_store_->is_on_disk()) {
+    scoped_refptr<LevelDBTransaction> leveldb_transaction =
+        transaction->BackingStoreTransaction()->transaction();
+    CommittedRecord* record = new CommittedRecord;
+    transaction->AddPendingRead();
+    base::WorkerPool::PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&GetCommittedRecordOnWorker,
+                   base::Unretained(backing_store_.get()),
+                   base::Unretained(leveldb_transaction.get()),
+                   id(),
+                   object_store_id,
+                   key_range->lower(),
+                   base::Unretained(record)),
+        base::Bind(&IndexedDBDatabase::DidGetCommittedRecord,
+                   this,
+                   object_store_id,
+                   key_range->lower(),
+                   callbacks,
+                   make_scoped_refptr(transaction),
+                   leveldb_transaction,
+                   base::Owned(record)),
+        false);
+    return;
+  }
+
   const IndexedDBKey* key;
 
   scoped_ptr<IndexedDBBackingStore::Cursor> backing_store_cursor;
@@ -653,6 +701,36 @@ void IndexedDBDatabase::GetOperation(
   callbacks->OnSuccess(&value);
 }
 
+void IndexedDBDatabase::DidGetCommittedRecord(
+    int64 object_store_id,
+    const IndexedDBKey& key,
+    scoped_refptr<IndexedDBCallbacks> callbacks,
+    scoped_refptr<IndexedDBTransaction> transaction,
+    scoped_refptr<LevelDBTransaction> leveldb_transaction,
+    CommittedRecord* record) {
+  IDB_TRACE("IndexedDBDatabase::DidGetCommittedRecord");
+  // |leveldb_transaction| was only held on to for the snapshot the worker
+  // read from. Requests of aborted transactions don't complete.
+  if (transaction->state() != IndexedDBTransaction::FINISHED) {
+    const IndexedDBObjectStoreMetadata& object_store_metadata =
+        metadata_.object_stores[object_store_id];
+    if (!record->status.ok()) {
+      callbacks->OnError(
+          IndexedDBDatabaseError(blink::WebIDBDatabaseExceptionUnknownError,
+                                 "Internal error in GetRecord."));
+    } else if (record->value.empty()) {
+      callbacks->OnSuccess();
+    } else if (object_store_metadata.auto_increment &&
+               !object_store_metadata.key_path.IsNull()) {
+      callbacks->OnSuccess(
+          &record->value, key, object_store_metadata.key_path);
+    } else {
+      callbacks->OnSuccess(&record->value);
+    }
+  }
+  transaction->DidCompletePendingRead();
+}
+
 static scoped_ptr<IndexedDBKey> GenerateKey(
     IndexedDBBackingStore* backing_store,
     IndexedDBTransaction* transaction,
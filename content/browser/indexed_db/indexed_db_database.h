@@ -210,6 +210,14 @@ class CONTENT_EXPORT IndexedDBDatabase
                     indexed_db::CursorType cursor_type,
                     scoped_refptr<IndexedDBCallbacks> callbacks,
                     IndexedDBTransaction* transaction);
+  struct CommittedRecord;
+  void DidGetCommittedRecord(
+      int64 object_store_id,
+      const IndexedDBKey& key,
+      scoped_refptr<IndexedDBCallbacks> callbacks,
+      scoped_refptr<IndexedDBTransaction> transaction,
+      scoped_refptr<LevelDBTransaction> leveldb_transaction,
+      CommittedRecord* record);
   struct PutOperationParams;
   void PutOperation(scoped_ptr<PutOperationParams> params,
                     IndexedDBTransaction* transaction);
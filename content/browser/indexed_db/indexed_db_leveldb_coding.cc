@@ -133,6 +133,15 @@
 // <database id, object store id, 2, user key> => "version"
 //
 //
+// Spilled value entry: [SpilledValueKey]
+// --------------------------------------
+// The prefix is followed by a type byte and the encoded IDB primary key. The
+// value of a record spilled to a file is left empty in its object store data
+// entry, and this entry holds the number of the file.
+//
+// <database id, object store id, 3, user key> => file number (var int)
+//
+//
 // Index data
 // ----------
 // The prefix is followed by a type byte, the encoded IDB index key, a
@@ -181,6 +190,7 @@ static const unsigned char kIndexedDBKeyPathTypeCodedByte2 = 0;
 
 static const unsigned char kObjectStoreDataIndexId = 1;
 static const unsigned char kExistsEntryIndexId = 2;
+static const unsigned char kSpilledValueIndexId = 3;
 
 static const unsigned char kSchemaVersionTypeByte = 0;
 static const unsigned char kMaxDatabaseIdTypeByte = 1;
@@ -869,6 +879,16 @@ int CompareSuffix<ExistsEntryKey>(StringPiece* slice_a,
   return CompareEncodedIDBKeys(slice_a, slice_b, ok);
 }
 
+template <>
+int CompareSuffix<SpilledValueKey>(StringPiece* slice_a,
+                                   StringPiece* slice_b,
+                                   bool only_compare_index_keys,
+                                   bool* ok) {
+  DCHECK(!slice_a->empty());
+  DCHECK(!slice_b->empty());
+  return CompareEncodedIDBKeys(slice_a, slice_b, ok);
+}
+
 template <>
 int CompareSuffix<ObjectStoreDataKey>(StringPiece* slice_a,
                                       StringPiece* slice_b,
@@ -1038,6 +1058,15 @@ int Compare(const StringPiece& a,
           &slice_a, &slice_b, /*only_compare_index_keys*/ false, ok);
     }
 
+    case KeyPrefix::SPILLED_VALUE: {
+      // Provide a stable ordering for invalid data.
+      if (slice_a.empty() || slice_b.empty())
+        return CompareSizes(slice_a.size(), slice_b.size());
+
+      return CompareSuffix<SpilledValueKey>(
+          &slice_a, &slice_b, /*only_compare_index_keys*/ false, ok);
+    }
+
     case KeyPrefix::INDEX_DATA: {
       // Provide a stable ordering for invalid data.
       if (slice_a.empty() || slice_b.empty())
@@ -1239,6 +1268,8 @@ KeyPrefix::Type KeyPrefix::type() const {
     return OBJECT_STORE_DATA;
   if (index_id_ == kExistsEntryIndexId)
     return EXISTS_ENTRY;
+  if (index_id_ == kSpilledValueIndexId)
+    return SPILLED_VALUE;
   if (index_id_ >= kMinimumIndexId)
     return INDEX_DATA;
 
@@ -1747,6 +1778,26 @@ scoped_ptr<IndexedDBKey> ExistsEntryKey::user_key() const {
 
 const int64 ExistsEntryKey::kSpecialIndexNumber = kExistsEntryIndexId;
 
+std::string SpilledValueKey::Encode(int64 database_id,
+                                    int64 object_store_id,
+                                    const std::string& encoded_key) {
+  KeyPrefix prefix(KeyPrefix::CreateWithSpecialIndex(
+      database_id, object_store_id, kSpecialIndexNumber));
+  std::string ret = prefix.Encode();
+  ret.append(encoded_key);
+  return ret;
+}
+
+std::string SpilledValueKey::Encode(int64 database_id,
+                                    int64 object_store_id,
+                                    const IndexedDBKey& user_key) {
+  std::string encoded_key;
+  EncodeIDBKey(user_key, &encoded_key);
+  return Encode(database_id, object_store_id, encoded_key);
+}
+
+const int64 SpilledValueKey::kSpecialIndexNumber = kSpilledValueIndexId;
+
 IndexDataKey::IndexDataKey()
     : database_id_(-1),
       object_store_id_(-1),
@@ -97,6 +97,7 @@ class KeyPrefix {
     DATABASE_METADATA,
     OBJECT_STORE_DATA,
     EXISTS_ENTRY,
+    SPILLED_VALUE,
     INDEX_DATA,
     INVALID_TYPE
   };
@@ -229,7 +230,8 @@ class ObjectStoreMetaDataKey {
     LAST_VERSION = 4,
     MAX_INDEX_ID = 5,
     HAS_KEY_PATH = 6,
-    KEY_GENERATOR_CURRENT_NUMBER = 7
+    KEY_GENERATOR_CURRENT_NUMBER = 7,
+    LAST_SPILL_FILE_NUMBER = 8
   };
 
   ObjectStoreMetaDataKey();
@@ -384,6 +386,18 @@ class ExistsEntryKey {
   DISALLOW_COPY_AND_ASSIGN(ExistsEntryKey);
 };
 
+class SpilledValueKey {
+ public:
+  CONTENT_EXPORT static std::string Encode(int64 database_id,
+                                           int64 object_store_id,
+                                           const std::string& encoded_key);
+  static std::string Encode(int64 database_id,
+                            int64 object_store_id,
+                            const IndexedDBKey& user_key);
+
+  static const int64 kSpecialIndexNumber;
+};
+
 class IndexDataKey {
  public:
   IndexDataKey();
@@ -871,6 +871,9 @@ TEST(IndexedDBLevelDBCodingTest, ComparisonTest) {
   keys.push_back(ExistsEntryKey::Encode(1, 1, std::string()));
   keys.push_back(ExistsEntryKey::Encode(1, 1, MinIDBKey()));
   keys.push_back(ExistsEntryKey::Encode(1, 1, MaxIDBKey()));
+  keys.push_back(SpilledValueKey::Encode(1, 1, std::string()));
+  keys.push_back(SpilledValueKey::Encode(1, 1, MinIDBKey()));
+  keys.push_back(SpilledValueKey::Encode(1, 1, MaxIDBKey()));
   keys.push_back(IndexDataKey::Encode(1, 1, 30, MinIDBKey(), std::string(), 0));
   keys.push_back(IndexDataKey::Encode(1, 1, 30, MinIDBKey(), MinIDBKey(), 0));
   keys.push_back(IndexDataKey::Encode(1, 1, 30, MinIDBKey(), MinIDBKey(), 1));
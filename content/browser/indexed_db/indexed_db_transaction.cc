@@ -68,7 +68,8 @@ IndexedDBTransaction::IndexedDBTransaction(
       transaction_(backing_store_transaction),
       backing_store_transaction_begun_(false),
       should_process_queue_(false),
-      pending_preemptive_events_(0) {
+      pending_preemptive_events_(0),
+      pending_reads_(0) {
   database_->transaction_coordinator().DidCreateTransaction(this);
 
   diagnostics_.tasks_scheduled = 0;
@@ -187,7 +188,27 @@ bool IndexedDBTransaction::IsTaskQueueEmpty() const {
 }
 
 bool IndexedDBTransaction::HasPendingTasks() const {
-  return pending_preemptive_events_ || !IsTaskQueueEmpty();
+  return pending_preemptive_events_ || pending_reads_ || !IsTaskQueueEmpty();
+}
+
+void IndexedDBTransaction::DidCompletePendingRead() {
+  pending_reads_--;
+  DCHECK_GE(pending_reads_, 0);
+  if (state_ == FINISHED || pending_reads_)
+    return;
+
+  if (!IsTaskQueueEmpty()) {
+    RunTasksIfStarted();
+    return;
+  }
+  if (commit_pending_) {
+    Commit();
+    return;
+  }
+  timeout_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromSeconds(kInactivityTimeoutPeriodSeconds),
+      base::Bind(&IndexedDBTransaction::Timeout, this));
 }
 
 void IndexedDBTransaction::RegisterOpenCursor(IndexedDBCursor* cursor) {
@@ -292,7 +313,7 @@ void IndexedDBTransaction::ProcessTaskQueue() {
 
   TaskQueue* task_queue =
       pending_preemptive_events_ ? &preemptive_task_queue_ : &task_queue_;
-  while (!task_queue->empty() && state_ != FINISHED) {
+  while (!task_queue->empty() && state_ != FINISHED && !pending_reads_) {
     DCHECK_EQ(STARTED, state_);
     Operation task(task_queue->pop());
     task.Run(this);
@@ -306,6 +327,10 @@ void IndexedDBTransaction::ProcessTaskQueue() {
         pending_preemptive_events_ ? &preemptive_task_queue_ : &task_queue_;
   }
 
+  // Processing resumes when the reads complete.
+  if (pending_reads_)
+    return;
+
   // If there are no pending tasks, we haven't already committed/aborted,
   // and the front-end requested a commit, it is now safe to do so.
   if (!HasPendingTasks() && state_ != FINISHED && commit_pending_) {
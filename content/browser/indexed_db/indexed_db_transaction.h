@@ -58,6 +58,10 @@ class CONTENT_EXPORT IndexedDBTransaction
     pending_preemptive_events_--;
     DCHECK_GE(pending_preemptive_events_, 0);
   }
+  // Reads running on another thread hold up the rest of the task queue, so
+  // that requests still complete in order.
+  void AddPendingRead() { pending_reads_++; }
+  void DidCompletePendingRead();
   IndexedDBBackingStore::Transaction* BackingStoreTransaction() {
     return transaction_.get();
   }
@@ -142,6 +146,7 @@ class CONTENT_EXPORT IndexedDBTransaction
 
   bool should_process_queue_;
   int pending_preemptive_events_;
+  int pending_reads_;
 
   std::set<IndexedDBCursor*> open_cursors_;
 
@@ -29,6 +29,12 @@ class IndexedDBTransactionTest : public testing::Test {
 
   void RunPostedTasks() { message_loop_.RunUntilIdle(); }
   void DummyOperation(IndexedDBTransaction* transaction) {}
+  void CountOperation(int* count, IndexedDBTransaction* transaction) {
+    ++*count;
+  }
+  void PendingReadOperation(IndexedDBTransaction* transaction) {
+    transaction->AddPendingRead();
+  }
 
  protected:
   scoped_refptr<IndexedDBFakeBackingStore> backing_store_;
@@ -120,6 +126,41 @@ TEST_F(IndexedDBTransactionTest, AbortTasks) {
   EXPECT_TRUE(observer.abort_task_called());
 }
 
+TEST_F(IndexedDBTransactionTest, PendingReads) {
+  const int64 id = 0;
+  const std::set<int64> scope;
+  const bool commit_success = true;
+  scoped_refptr<IndexedDBTransaction> transaction = new IndexedDBTransaction(
+      id,
+      new MockIndexedDBDatabaseCallbacks(),
+      scope,
+      indexed_db::TRANSACTION_READ_ONLY,
+      db_,
+      new IndexedDBFakeBackingStore::FakeTransaction(commit_success));
+  db_->TransactionCreated(transaction);
+
+  int count = 0;
+  transaction->ScheduleTask(
+      base::Bind(&IndexedDBTransactionTest::PendingReadOperation,
+                 base::Unretained(this)));
+  transaction->ScheduleTask(
+      base::Bind(&IndexedDBTransactionTest::CountOperation,
+                 base::Unretained(this),
+                 &count));
+  RunPostedTasks();
+
+  // The read holds up the next task and the commit.
+  EXPECT_EQ(0, count);
+  EXPECT_FALSE(transaction->IsTimeoutTimerRunning());
+  transaction->Commit();
+  EXPECT_EQ(IndexedDBTransaction::STARTED, transaction->state());
+
+  transaction->DidCompletePendingRead();
+  RunPostedTasks();
+  EXPECT_EQ(1, count);
+  EXPECT_EQ(IndexedDBTransaction::FINISHED, transaction->state());
+}
+
 }  // namespace
 
 }  // namespace content
@@ -85,6 +85,10 @@ LevelDBSnapshot::~LevelDBSnapshot() { db_->ReleaseSnapshot(snapshot_); }
 LevelDBDatabase::LevelDBDatabase() {}
 
 LevelDBDatabase::~LevelDBDatabase() {
+  if (db_.get()) {
+    UMA_HISTOGRAM_COUNTS_100("WebCore.IndexedDB.LevelDB.ReadAmplification",
+                             leveldb_env::GetReadAmplification(db_.get()));
+  }
   // db_'s destructor uses comparator_adapter_; order of deletion is important.
   db_.reset();
   comparator_adapter_.reset();
@@ -105,6 +109,10 @@ static leveldb::Status OpenDB(leveldb::Comparator* comparator,
   // https://code.google.com/p/chromium/issues/detail?id=227313#c11
   options.max_open_files = 80;
   options.env = env;
+  options.block_cache = leveldb_env::SharedBlockCache();
+  options.write_buffer_size = leveldb_env::kLargeWriteBufferSize;
+  // No Bloom filters: the comparator decodes keys, and keys with different
+  // bytes can compare equal, e.g. the numbers 0 and -0.
 
   // ChromiumEnv assumes UTF8, converts back to FilePath before using.
   return leveldb::DB::Open(options, path.AsUTF8Unsafe(), db);
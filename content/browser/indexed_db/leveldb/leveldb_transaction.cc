@@ -85,6 +85,16 @@ leveldb::Status LevelDBTransaction::Get(const StringPiece& key,
   return s;
 }
 
+leveldb::Status LevelDBTransaction::GetCommitted(const StringPiece& key,
+                                                 std::string* value,
+                                                 bool* found) const {
+  *found = false;
+  leveldb::Status s = db_->Get(key, value, found, &snapshot_);
+  if (!s.ok())
+    DCHECK(!*found);
+  return s;
+}
+
 leveldb::Status LevelDBTransaction::Commit() {
   DCHECK(!finished_);
 
@@ -30,6 +30,11 @@ class CONTENT_EXPORT LevelDBTransaction
   leveldb::Status Get(const base::StringPiece& key,
                       std::string* value,
                       bool* found);
+  // Reads |key| as it was when the transaction began, without the writes
+  // made since. Unlike the other methods, this may be called on any thread.
+  leveldb::Status GetCommitted(const base::StringPiece& key,
+                               std::string* value,
+                               bool* found) const;
   leveldb::Status Commit();
   void Rollback();
 
@@ -4,6 +4,8 @@
 
 #include "content/browser/loader/resource_scheduler.h"
 
+#include <algorithm>
+
 #include "base/stl_util.h"
 #include "content/common/resource_messages.h"
 #include "content/browser/loader/resource_message_delegate.h"
@@ -13,6 +15,7 @@
 #include "ipc/ipc_message_macros.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/load_flags.h"
+#include "net/base/load_timing_info.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_server_properties.h"
 #include "net/url_request/url_request.h"
@@ -23,6 +26,25 @@ namespace content {
 static const size_t kMaxNumDelayableRequestsPerClient = 10;
 static const size_t kMaxNumDelayableRequestsPerHost = 6;
 
+// The bounds of the delayable request budget of a client whose network has
+// been measured.
+static const size_t kMinNumAdaptiveDelayableRequestsPerClient = 2;
+static const size_t kMaxNumAdaptiveDelayableRequestsPerClient = 20;
+
+// The throughput each delayable request in flight is given on slow links.
+static const int64 kBytesPerSecondPerDelayableRequest = 16 * 1024;
+
+// The size of a typical delayable response, for the number of requests
+// needed to fill the bandwidth-delay product.
+static const int64 kTypicalDelayableResponseBytes = 32 * 1024;
+
+// Responses smaller than this take about a round trip whatever the
+// throughput, so they don't measure it.
+static const int64 kMinThroughputSampleBytes = 16 * 1024;
+
+// The weight of a new sample in the moving averages of the estimates.
+static const double kNetworkEstimateSampleWeight = 0.25;
+
 // A thin wrapper around net::PriorityQueue that deals with
 // ScheduledResourceRequests instead of PriorityQueue::Pointers.
 class ResourceScheduler::RequestQueue {
@@ -132,6 +154,7 @@ class ResourceScheduler::ScheduledResourceRequest
   void Start() {
     TRACE_EVENT_ASYNC_STEP_PAST0("net", "URLRequest", request_, "Queued");
     ready_ = true;
+    start_time_ = base::TimeTicks::Now();
     if (deferred_ && request_->status().is_success()) {
       deferred_ = false;
       controller()->Resume();
@@ -141,6 +164,7 @@ class ResourceScheduler::ScheduledResourceRequest
   const ClientId& client_id() const { return client_id_; }
   net::URLRequest* url_request() { return request_; }
   const net::URLRequest* url_request() const { return request_; }
+  base::TimeTicks start_time() const { return start_time_; }
 
  private:
   // ResourceMessageDelegate interface:
@@ -171,6 +195,7 @@ class ResourceScheduler::ScheduledResourceRequest
   net::URLRequest* request_;
   bool ready_;
   bool deferred_;
+  base::TimeTicks start_time_;
   ResourceScheduler* scheduler_;
 
   DISALLOW_COPY_AND_ASSIGN(ScheduledResourceRequest);
@@ -178,13 +203,26 @@ class ResourceScheduler::ScheduledResourceRequest
 
 // Each client represents a tab.
 struct ResourceScheduler::Client {
-  Client() : has_body(false), using_spdy_proxy(false) {}
+  Client()
+      : has_body(false),
+        using_spdy_proxy(false),
+        bytes_per_second(0),
+        max_delayable_requests(kMaxNumDelayableRequestsPerClient) {}
   ~Client() {}
 
   bool has_body;
   bool using_spdy_proxy;
   RequestQueue pending_requests;
   RequestSet in_flight_requests;
+
+  // Moving averages of what the requests of the client measured, or zero
+  // until one measured it.
+  int64 bytes_per_second;
+  base::TimeDelta round_trip_time;
+
+  // The budget of delayable requests for the network, which is the default
+  // one until both estimates are known.
+  size_t max_delayable_requests;
 };
 
 ResourceScheduler::ResourceScheduler() {
@@ -245,6 +283,8 @@ void ResourceScheduler::RemoveRequest(ScheduledResourceRequest* request) {
     size_t erased = client->in_flight_requests.erase(request);
     DCHECK(erased);
 
+    UpdateNetworkEstimate(request, client);
+
     // Removing this request may have freed up another to load.
     LoadAnyStartablePendingRequests(client);
   }
@@ -329,6 +369,107 @@ void ResourceScheduler::OnReceivedSpdyProxiedHttpResponse(
   }
 }
 
+void ResourceScheduler::SetNetworkEstimateForTesting(
+    int child_id,
+    int route_id,
+    int64 bytes_per_second,
+    base::TimeDelta round_trip_time) {
+  DCHECK(CalledOnValidThread());
+  ClientMap::iterator client_it =
+      client_map_.find(MakeClientId(child_id, route_id));
+  if (client_it == client_map_.end())
+    return;
+
+  Client* client = client_it->second;
+  client->bytes_per_second = bytes_per_second;
+  client->round_trip_time = round_trip_time;
+  client->max_delayable_requests =
+      GetMaxDelayableRequestsForNetwork(bytes_per_second, round_trip_time);
+  LoadAnyStartablePendingRequests(client);
+}
+
+// static
+size_t ResourceScheduler::GetMaxDelayableRequestsForNetwork(
+    int64 bytes_per_second,
+    base::TimeDelta round_trip_time) {
+  if (bytes_per_second <= 0 || round_trip_time <= base::TimeDelta())
+    return kMaxNumDelayableRequestsPerClient;
+
+  int64 bandwidth_budget =
+      bytes_per_second / kBytesPerSecondPerDelayableRequest;
+  int64 bandwidth_delay_budget =
+      bytes_per_second * round_trip_time.InMilliseconds() /
+      (base::Time::kMillisecondsPerSecond * kTypicalDelayableResponseBytes);
+  int64 budget = std::min(
+      bandwidth_budget,
+      std::max(static_cast<int64>(kMaxNumDelayableRequestsPerClient),
+               bandwidth_delay_budget));
+  budget = std::max(
+      budget, static_cast<int64>(kMinNumAdaptiveDelayableRequestsPerClient));
+  budget = std::min(
+      budget, static_cast<int64>(kMaxNumAdaptiveDelayableRequestsPerClient));
+  return static_cast<size_t>(budget);
+}
+
+void ResourceScheduler::UpdateNetworkEstimate(
+    ScheduledResourceRequest* request,
+    Client* client) {
+  const net::URLRequest* url_request = request->url_request();
+  if (!url_request->status().is_success() || url_request->was_cached())
+    return;
+
+  bool updated = false;
+  net::LoadTimingInfo load_timing;
+  url_request->GetLoadTimingInfo(&load_timing);
+  if (!load_timing.send_start.is_null() &&
+      !load_timing.receive_headers_end.is_null()) {
+    base::TimeDelta round_trip_time =
+        load_timing.receive_headers_end - load_timing.send_start;
+    if (client->round_trip_time == base::TimeDelta()) {
+      client->round_trip_time = round_trip_time;
+    } else {
+      client->round_trip_time = base::TimeDelta::FromMicroseconds(
+          static_cast<int64>(
+              kNetworkEstimateSampleWeight * round_trip_time.InMicroseconds() +
+              (1 - kNetworkEstimateSampleWeight) *
+                  client->round_trip_time.InMicroseconds()));
+    }
+    updated = true;
+  }
+
+  int64 received_bytes = url_request->GetTotalReceivedBytes();
+  base::TimeDelta duration = base::TimeTicks::Now() - request->start_time();
+  if (received_bytes >= kMinThroughputSampleBytes &&
+      duration > base::TimeDelta()) {
+    int64 bytes_per_second = static_cast<int64>(
+        received_bytes / duration.InSecondsF());
+    if (client->bytes_per_second == 0) {
+      client->bytes_per_second = bytes_per_second;
+    } else {
+      client->bytes_per_second = static_cast<int64>(
+          kNetworkEstimateSampleWeight * bytes_per_second +
+          (1 - kNetworkEstimateSampleWeight) * client->bytes_per_second);
+    }
+    updated = true;
+  }
+
+  if (updated) {
+    client->max_delayable_requests = GetMaxDelayableRequestsForNetwork(
+        client->bytes_per_second, client->round_trip_time);
+  }
+}
+
+// static
+bool ResourceScheduler::IsMultiplexed(
+    const net::HttpServerProperties& properties,
+    const net::HostPortPair& host_port_pair) {
+  if (properties.SupportsSpdy(host_port_pair))
+    return true;
+  return properties.HasAlternateProtocol(host_port_pair) &&
+         properties.GetAlternateProtocol(host_port_pair).protocol ==
+             net::QUIC;
+}
+
 void ResourceScheduler::StartRequest(ScheduledResourceRequest* request,
                                      Client* client) {
   client->in_flight_requests.insert(request);
@@ -429,7 +570,7 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
       const net::HttpServerProperties& http_server_properties =
           *(*it)->url_request()->context()->http_server_properties();
 
-      if (!http_server_properties.SupportsSpdy(host_port_pair)) {
+      if (!IsMultiplexed(http_server_properties, host_port_pair)) {
         ++total_delayable_count;
       }
     }
@@ -446,7 +587,7 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
 //
 //   * Higher priority requests (>= net::LOW).
 //   * Synchronous requests.
-//   * Requests to SPDY-capable origin servers.
+//   * Requests to SPDY or QUIC capable origin servers.
 //   * Non-HTTP[S] requests.
 //
 // 2. The remainder are delayable requests, which follow these rules:
@@ -454,7 +595,8 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
 //   * If no high priority requests are in flight, start loading low priority
 //     requests.
 //   * Once the renderer has a <body>, start loading delayable requests.
-//   * Never exceed 10 delayable requests in flight per client.
+//   * Never exceed 10 delayable requests in flight per client, or the
+//     budget for the network of the client once it has been measured.
 //   * Never exceed 6 delayable requests for a given host.
 //   * Prior to <body>, allow one delayable request to load at a time.
 ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
@@ -486,7 +628,7 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
   // TODO(willchan): We should really improve this algorithm as described in
   // crbug.com/164101. Also, theoretically we should not count a SPDY request
   // against the delayable requests limit.
-  if (http_server_properties.SupportsSpdy(host_port_pair)) {
+  if (IsMultiplexed(http_server_properties, host_port_pair)) {
     return START_REQUEST;
   }
 
@@ -496,7 +638,7 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
                                   &num_delayable_requests_in_flight,
                                   &num_requests_in_flight_for_host);
 
-  if (num_delayable_requests_in_flight >= kMaxNumDelayableRequestsPerClient) {
+  if (num_delayable_requests_in_flight >= client->max_delayable_requests) {
     return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
   }
 
@@ -12,12 +12,14 @@
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "net/base/priority_queue.h"
 #include "net/base/request_priority.h"
 
 namespace net {
 class HostPortPair;
+class HttpServerProperties;
 class URLRequest;
 }
 
@@ -84,6 +86,22 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // from a proxy using SPDY.
   void OnReceivedSpdyProxiedHttpResponse(int child_id, int route_id);
 
+  // Sets the throughput and round trip time the client measured, as if its
+  // requests had, so that tests can simulate networks.
+  void SetNetworkEstimateForTesting(int child_id,
+                                    int route_id,
+                                    int64 bytes_per_second,
+                                    base::TimeDelta round_trip_time);
+
+  // Returns how many delayable requests a client on a network with the
+  // given throughput and round trip time may have in flight. The budget
+  // shrinks on slow links, where delayable requests compete with the ones
+  // needed for first paint, and grows on links with a large bandwidth-delay
+  // product, which need more requests in flight to be kept busy.
+  static size_t GetMaxDelayableRequestsForNetwork(
+      int64 bytes_per_second,
+      base::TimeDelta round_trip_time);
+
  private:
   class RequestQueue;
   class ScheduledResourceRequest;
@@ -112,6 +130,15 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // results of ShouldStartRequest().
   void LoadAnyStartablePendingRequests(Client* client);
 
+  // Updates the network estimate of |client| from |request|, which finished.
+  void UpdateNetworkEstimate(ScheduledResourceRequest* request,
+                             Client* client);
+
+  // Returns true if requests to |host_port_pair| share a connection, as SPDY
+  // and QUIC ones do, so that they don't count against the limits.
+  static bool IsMultiplexed(const net::HttpServerProperties& properties,
+                            const net::HostPortPair& host_port_pair);
+
   // Returns the number of requests with priority < LOW that are currently in
   // flight.
   void GetNumDelayableRequestsInFlight(
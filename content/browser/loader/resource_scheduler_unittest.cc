@@ -478,6 +478,65 @@ TEST_F(ResourceSchedulerTest, SpdyProxySchedulesImmediately) {
   EXPECT_TRUE(after->started());
 }
 
+TEST_F(ResourceSchedulerTest, QuicSchedulesImmediately) {
+  http_server_properties_.SetAlternateProtocol(
+      net::HostPortPair("quichost", 80), 443, net::QUIC);
+  scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
+  scoped_ptr<TestRequest> low(NewRequest("http://host/low", net::LOWEST));
+  scoped_ptr<TestRequest> low_quic(
+      NewRequest("http://quichost/low", net::LOWEST));
+  scoped_ptr<TestRequest> low2(NewRequest("http://host/low2", net::LOWEST));
+  EXPECT_TRUE(low->started());
+  EXPECT_TRUE(low_quic->started());
+  EXPECT_FALSE(low2->started());
+}
+
+TEST_F(ResourceSchedulerTest, DelayableBudgetForSimulatedNetworks) {
+  struct {
+    const char* name;
+    int64 bytes_per_second;
+    int round_trip_time_ms;
+    size_t expected_budget;
+  } kNetworks[] = {
+    { "unmeasured", 0, 0, 10 },
+    { "2G", 30 * 1024, 800, 2 },
+    { "slow 3G", 96 * 1024, 400, 6 },
+    { "cable", 640 * 1024, 40, 10 },
+    { "LTE", 1024 * 1024, 300, 10 },
+    { "satellite", 1280 * 1024, 600, 20 },
+  };
+  for (size_t i = 0; i < arraysize(kNetworks); ++i) {
+    EXPECT_EQ(kNetworks[i].expected_budget,
+              ResourceScheduler::GetMaxDelayableRequestsForNetwork(
+                  kNetworks[i].bytes_per_second,
+                  base::TimeDelta::FromMilliseconds(
+                      kNetworks[i].round_trip_time_ms)))
+        << kNetworks[i].name;
+  }
+}
+
+TEST_F(ResourceSchedulerTest, SlowNetworkLimitsDelayableRequests) {
+  scheduler_.OnWillInsertBody(kChildId, kRouteId);
+  // A slow 3G link, which gets 6 delayable requests.
+  scheduler_.SetNetworkEstimateForTesting(
+      kChildId, kRouteId, 96 * 1024, base::TimeDelta::FromMilliseconds(400));
+
+  const size_t kExpectedBudget = 6;
+  ScopedVector<TestRequest> lows;
+  for (size_t i = 0; i < kExpectedBudget + 2; ++i) {
+    // Each on its own host, so that the per host limit doesn't apply.
+    string url = "http://host" + base::IntToString(i) + "/low";
+    lows.push_back(NewRequest(url.c_str(), net::LOWEST));
+    EXPECT_EQ(i < kExpectedBudget, lows[i]->started()) << i;
+  }
+
+  // A faster network lets the others start.
+  scheduler_.SetNetworkEstimateForTesting(
+      kChildId, kRouteId, 640 * 1024, base::TimeDelta::FromMilliseconds(40));
+  for (size_t i = 0; i < lows.size(); ++i)
+    EXPECT_TRUE(lows[i]->started()) << i;
+}
+
 }  // unnamed namespace
 
 }  // namespace content
@@ -196,6 +196,9 @@ class SQLitePersistentCookieStore::Backend
   // Batch a cookie operation (add or delete)
   void BatchOperation(PendingOperation::OperationType op,
                       const net::CanonicalCookie& cc);
+  // Drops the operations in |ops| that later ones for the same cookie make
+  // redundant, so that Commit() writes less.
+  static void CoalesceOperations(std::list<PendingOperation*>* ops);
   // Commit our pending operations to the database.
   void Commit();
   // Close() executed on the background runner.
@@ -572,6 +575,8 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
 
   db_.reset(new sql::Connection);
   db_->set_histogram_tag("Cookie");
+  // The whole database is read at startup, and is small enough to be mapped.
+  db_->set_mmap_size(4 * 1024 * 1024);
 
   // Unretained to avoid a ref loop with |db_|.
   db_->set_error_callback(
@@ -966,6 +971,10 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   if (!db_.get() || ops.empty())
     return;
 
+  CoalesceOperations(&ops);
+  if (ops.empty())
+    return;
+
   sql::Statement add_smt(db_->GetCachedStatement(SQL_FROM_HERE,
       "INSERT INTO cookies (creation_utc, host_key, name, value, "
       "encrypted_value, path, expires_utc, secure, httponly, last_access_utc, "
@@ -1053,6 +1062,70 @@ void SQLitePersistentCookieStore::Backend::Commit() {
                             succeeded ? 0 : 1, 2);
 }
 
+// static
+void SQLitePersistentCookieStore::Backend::CoalesceOperations(
+    PendingOperationsList* ops) {
+  // Cookies are identified by their creation time, as in the database.  For
+  // each cookie, remember its add and its last access time update which are
+  // still pending, that is, which no delete has followed yet.
+  typedef std::map<int64, PendingOperationsList::iterator> PendingOperationMap;
+  PendingOperationMap pending_adds;
+  PendingOperationMap pending_updates;
+  size_t num_ops = ops->size();
+
+  for (PendingOperationsList::iterator it = ops->begin(); it != ops->end(); ) {
+    int64 creation_utc = (*it)->cc().CreationDate().ToInternalValue();
+    PendingOperationMap::iterator update = pending_updates.find(creation_utc);
+    PendingOperationMap::iterator add = pending_adds.find(creation_utc);
+    bool drop = false;
+    switch ((*it)->op()) {
+      case PendingOperation::COOKIE_ADD:
+        pending_adds[creation_utc] = it;
+        if (update != pending_updates.end())
+          pending_updates.erase(update);
+        break;
+
+      case PendingOperation::COOKIE_UPDATEACCESS:
+        // Only the last access time written last matters.
+        if (update != pending_updates.end()) {
+          delete *update->second;
+          ops->erase(update->second);
+        }
+        pending_updates[creation_utc] = it;
+        break;
+
+      case PendingOperation::COOKIE_DELETE:
+        if (update != pending_updates.end()) {
+          delete *update->second;
+          ops->erase(update->second);
+          pending_updates.erase(update);
+        }
+        // A cookie added and deleted within the batch never needs to reach
+        // the database.
+        if (add != pending_adds.end()) {
+          delete *add->second;
+          ops->erase(add->second);
+          pending_adds.erase(add);
+          drop = true;
+        }
+        break;
+
+      default:
+        NOTREACHED();
+        break;
+    }
+    if (drop) {
+      delete *it;
+      it = ops->erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  UMA_HISTOGRAM_COUNTS_10000("Cookie.CoalescedOperations",
+                             num_ops - ops->size());
+}
+
 void SQLitePersistentCookieStore::Backend::Flush(
     const base::Closure& callback) {
   DCHECK(!background_task_runner_->RunsTasksOnCurrentThread());
@@ -332,6 +332,43 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   STLDeleteElements(&cookies_);
 }
 
+// Test that operations made redundant within a batch are dropped without
+// changing what ends up in the database.
+TEST_F(SQLitePersistentCookieStoreTest, TestCoalesceOperations) {
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  AddCookie("A", "B", "foo.bar", "/", t);
+  base::Time t2 = t + base::TimeDelta::FromInternalValue(10);
+  AddCookie("C", "D", "foo.bar", "/", t2);
+  Flush();
+
+  base::Time t3 = t + base::TimeDelta::FromInternalValue(20);
+  AddCookie("E", "F", "foo.bar", "/", t3);
+  for (int i = 1; i <= 3; ++i) {
+    store_->UpdateCookieAccessTime(net::CanonicalCookie(
+        GURL(), "A", "B", "foo.bar", "/", t,
+        t, t + base::TimeDelta::FromSeconds(i), false, false,
+        net::COOKIE_PRIORITY_DEFAULT));
+  }
+  store_->UpdateCookieAccessTime(net::CanonicalCookie(
+      GURL(), "C", "D", "foo.bar", "/", t2, t2, t2, false, false,
+      net::COOKIE_PRIORITY_DEFAULT));
+  store_->DeleteCookie(net::CanonicalCookie(
+      GURL(), "C", "D", "foo.bar", "/", t2, t2, t2, false, false,
+      net::COOKIE_PRIORITY_DEFAULT));
+  store_->DeleteCookie(net::CanonicalCookie(
+      GURL(), "E", "F", "foo.bar", "/", t3, t3, t3, false, false,
+      net::COOKIE_PRIORITY_DEFAULT));
+  DestroyStore();
+
+  CanonicalCookieVector cookies;
+  CreateAndLoad(false, false, &cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("A", cookies[0]->Name());
+  EXPECT_EQ(t + base::TimeDelta::FromSeconds(3), cookies[0]->LastAccessDate());
+  STLDeleteElements(&cookies);
+}
+
 // Test that we can force the database to be written by calling Flush().
 TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   InitializeStore(false, false);
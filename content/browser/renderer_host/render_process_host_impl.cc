@@ -163,6 +163,12 @@ static const char* kSiteProcessMapKeyName = "content_site_process_map";
 namespace content {
 namespace {
 
+#if defined(OS_POSIX)
+// Size of the ring renderer messages go through with
+// --enable-ipc-message-ring.
+const size_t kRendererMessageRingCapacity = 256 * 1024;
+#endif
+
 void CacheShaderInfo(int32 id, base::FilePath path) {
   ShaderCacheFactory::GetInstance()->SetCacheInfo(id, path);
 }
@@ -521,6 +527,13 @@ bool RenderProcessHostImpl::Init() {
                                 this,
                                 BrowserThread::GetMessageLoopProxyForThread(
                                     BrowserThread::IO).get()));
+#if defined(OS_POSIX)
+  // Input events and compositor acks make this the busiest channel.
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableIPCMessageRing)) {
+    channel_->EnableMessageRing(kRendererMessageRingCapacity);
+  }
+#endif
 
   // Call the embedder first so that their IPC filters have priority.
   GetContentClient()->browser()->RenderProcessWillLaunch(this);
@@ -1026,6 +1039,7 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     switches::kEnableHTMLImports,
     switches::kEnableInbandTextTracks,
     switches::kEnableLayerSquashing,
+    switches::kEnableLocalStorageLazyLoad,
     switches::kEnableLogging,
     switches::kEnableMP3StreamParser,
     switches::kEnableMemoryBenchmarking,
@@ -5,6 +5,7 @@
 #include "content/browser/tcmalloc_internals_request_job.h"
 
 #include "base/allocator/allocator_extension.h"
+#include "base/allocator/partition_allocator.h"
 #include "content/common/child_process_messages.h"
 #include "content/public/browser/browser_child_process_host_iterator.h"
 #include "content/public/browser/browser_thread.h"
@@ -91,8 +92,10 @@ void AboutTcmalloc(std::string* data) {
   // and send off requests to all the renderer processes.
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
+  std::string browser_stats(buffer);
+  base::allocator::Partition::DumpAllStats(&browser_stats);
   std::string browser("Browser");
-  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, buffer);
+  AboutTcmallocOutputs::GetInstance()->SetOutput(browser, browser_stats);
 
   for (BrowserChildProcessHostIterator iter; !iter.Done(); ++iter) {
     iter.Send(new ChildProcessMsg_GetTcmallocStats);
@@ -51,6 +51,7 @@ bool TraceMessageFilter::OnMessageReceived(const IPC::Message& message,
                         OnWatchEventMatched)
     IPC_MESSAGE_HANDLER(TracingHostMsg_TraceBufferPercentFullReply,
                         OnTraceBufferPercentFullReply)
+    IPC_MESSAGE_HANDLER(TracingHostMsg_ClockSyncRequest, OnClockSyncRequest)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP_EX()
   return handled;
@@ -157,6 +158,11 @@ void TraceMessageFilter::OnWatchEventMatched() {
   TracingControllerImpl::GetInstance()->OnWatchEventMatched();
 }
 
+void TraceMessageFilter::OnClockSyncRequest(base::TimeTicks child_time) {
+  Send(new TracingMsg_ClockSyncReply(
+      child_time, base::TimeTicks::NowFromSystemTraceTime()));
+}
+
 void TraceMessageFilter::OnTraceBufferPercentFullReply(float percent_full) {
   if (is_awaiting_buffer_percent_full_ack_) {
     is_awaiting_buffer_percent_full_ack_ = false;
@@ -47,6 +47,7 @@ class TraceMessageFilter : public BrowserMessageFilter {
   void OnCaptureMonitoringSnapshotAcked();
   void OnWatchEventMatched();
   void OnTraceBufferPercentFullReply(float percent_full);
+  void OnClockSyncRequest(base::TimeTicks child_time);
   void OnTraceDataCollected(const std::string& data);
   void OnMonitoringTraceDataCollected(const std::string& data);
 
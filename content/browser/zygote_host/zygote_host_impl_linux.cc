@@ -108,6 +108,7 @@ void ZygoteHostImpl::Init(const std::string& sandbox_cmd) {
     switches::kVModule,
     switches::kRegisterPepperPlugins,
     switches::kDisableSeccompFilterSandbox,
+    switches::kRendererPoolSize,
 
     // Zygote process needs to know what resources to have loaded when it
     // becomes a renderer process.
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/allocator/allocator_extension.h"
+#include "base/allocator/partition_allocator.h"
 #include "base/base_switches.h"
 #include "base/basictypes.h"
 #include "base/command_line.h"
@@ -50,6 +51,7 @@
 
 #if defined(TCMALLOC_TRACE_MEMORY_SUPPORTED)
 #include "third_party/tcmalloc/chromium/src/gperftools/heap-profiler.h"
+#include "third_party/tcmalloc/chromium/src/gperftools/malloc_hook_c.h"
 #endif
 
 using tracked_objects::ThreadData;
@@ -297,6 +299,14 @@ void ChildThread::Init() {
       ::HeapProfilerWithPseudoStackStart,
       ::HeapProfilerStop,
       ::GetHeapProfile));
+  const size_t kMeanBytesBetweenSamples = 128 * 1024;
+  trace_memory_sampler_.reset(new base::debug::TraceMemorySampler(
+      message_loop_->message_loop_proxy(),
+      kMeanBytesBetweenSamples,
+      ::MallocHook_AddNewHook,
+      ::MallocHook_RemoveNewHook,
+      ::MallocHook_AddDeleteHook,
+      ::MallocHook_RemoveDeleteHook));
 #endif
 }
 
@@ -489,6 +499,7 @@ void ChildThread::OnGetTcmallocStats() {
   char buffer[1024 * 32];
   base::allocator::GetStats(buffer, sizeof(buffer));
   result.append(buffer);
+  base::allocator::Partition::DumpAllStats(&result);
   Send(new ChildProcessHostMsg_TcmallocStats(result));
 }
 #endif
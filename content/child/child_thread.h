@@ -23,6 +23,7 @@ class MessageLoop;
 
 namespace debug {
 class TraceMemoryController;
+class TraceMemorySampler;
 }  // namespace debug
 }  // namespace base
 
@@ -225,6 +226,10 @@ class CONTENT_EXPORT ChildThread : public IPC::Listener, public IPC::Sender {
   // starts profiling the tcmalloc heap.
   scoped_ptr<base::debug::TraceMemoryController> trace_memory_controller_;
 
+  // Observes the trace event system. When tracing is enabled, optionally
+  // samples tcmalloc allocations.
+  scoped_ptr<base::debug::TraceMemorySampler> trace_memory_sampler_;
+
   scoped_ptr<base::PowerMonitor> power_monitor_;
 
   bool in_browser_process_;
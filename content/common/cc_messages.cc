@@ -283,6 +283,149 @@ void ParamTraits<gfx::Transform>::Log(
   l->append(") ");
 }
 
+namespace {
+
+// Tile and solid color quads make up almost all of the quads in large frames,
+// so they are written as a single fixed-layout record each instead of field
+// by field. The record is validated while it is still in the message buffer
+// and then copied into the quad. Bump the version whenever a record changes.
+const int kPackedQuadFormatVersion = 1;
+
+struct PackedDrawQuad {
+  int32 rect[4];
+  int32 opaque_rect[4];
+  int32 visible_rect[4];
+  uint32 needs_blending;
+};
+
+struct PackedTileDrawQuad {
+  PackedDrawQuad base;
+  uint32 resource_id;
+  float tex_coord_rect[4];
+  int32 texture_size[2];
+  uint32 swizzle_contents;
+};
+
+struct PackedSolidColorDrawQuad {
+  PackedDrawQuad base;
+  uint32 color;
+  uint32 force_anti_aliasing_off;
+};
+
+COMPILE_ASSERT(sizeof(PackedDrawQuad) == 13 * 4, packed_draw_quad_has_padding);
+COMPILE_ASSERT(sizeof(PackedTileDrawQuad) == sizeof(PackedDrawQuad) + 8 * 4,
+               packed_tile_draw_quad_has_padding);
+COMPILE_ASSERT(sizeof(PackedSolidColorDrawQuad) ==
+                   sizeof(PackedDrawQuad) + 2 * 4,
+               packed_solid_color_draw_quad_has_padding);
+
+void PackRect(const gfx::Rect& rect, int32* out) {
+  out[0] = rect.x();
+  out[1] = rect.y();
+  out[2] = rect.width();
+  out[3] = rect.height();
+}
+
+bool UnpackRect(const int32* in, gfx::Rect* rect) {
+  if (in[2] < 0 || in[3] < 0)
+    return false;
+  rect->SetRect(in[0], in[1], in[2], in[3]);
+  return true;
+}
+
+bool UnpackBool(uint32 in, bool* out) {
+  if (in > 1)
+    return false;
+  *out = !!in;
+  return true;
+}
+
+void PackDrawQuad(const cc::DrawQuad& quad, PackedDrawQuad* out) {
+  PackRect(quad.rect, out->rect);
+  PackRect(quad.opaque_rect, out->opaque_rect);
+  PackRect(quad.visible_rect, out->visible_rect);
+  out->needs_blending = quad.needs_blending;
+}
+
+bool UnpackDrawQuad(const PackedDrawQuad& in,
+                    cc::DrawQuad::Material material,
+                    cc::DrawQuad* quad) {
+  quad->material = material;
+  return UnpackRect(in.rect, &quad->rect) &&
+         UnpackRect(in.opaque_rect, &quad->opaque_rect) &&
+         UnpackRect(in.visible_rect, &quad->visible_rect) &&
+         UnpackBool(in.needs_blending, &quad->needs_blending);
+}
+
+void WritePackedQuad(Message* m, const cc::TileDrawQuad& quad) {
+  PackedTileDrawQuad packed;
+  PackDrawQuad(quad, &packed.base);
+  packed.resource_id = quad.resource_id;
+  packed.tex_coord_rect[0] = quad.tex_coord_rect.x();
+  packed.tex_coord_rect[1] = quad.tex_coord_rect.y();
+  packed.tex_coord_rect[2] = quad.tex_coord_rect.width();
+  packed.tex_coord_rect[3] = quad.tex_coord_rect.height();
+  packed.texture_size[0] = quad.texture_size.width();
+  packed.texture_size[1] = quad.texture_size.height();
+  packed.swizzle_contents = quad.swizzle_contents;
+  WriteParam(m, quad.material);
+  m->WriteBytes(&packed, sizeof(packed));
+}
+
+void WritePackedQuad(Message* m, const cc::SolidColorDrawQuad& quad) {
+  PackedSolidColorDrawQuad packed;
+  PackDrawQuad(quad, &packed.base);
+  packed.color = quad.color;
+  packed.force_anti_aliasing_off = quad.force_anti_aliasing_off;
+  WriteParam(m, quad.material);
+  m->WriteBytes(&packed, sizeof(packed));
+}
+
+scoped_ptr<cc::DrawQuad> ReadPackedTileDrawQuad(const Message* m,
+                                                PickleIterator* iter) {
+  cc::DrawQuad::Material material;
+  const char* data;
+  if (!ReadParam(m, iter, &material) ||
+      !m->ReadBytes(iter, &data, sizeof(PackedTileDrawQuad)))
+    return scoped_ptr<cc::DrawQuad>();
+  PackedTileDrawQuad packed;
+  memcpy(&packed, data, sizeof(packed));
+
+  scoped_ptr<cc::TileDrawQuad> quad = cc::TileDrawQuad::Create();
+  if (!UnpackDrawQuad(packed.base, material, quad.get()) ||
+      !UnpackBool(packed.swizzle_contents, &quad->swizzle_contents) ||
+      packed.texture_size[0] < 0 || packed.texture_size[1] < 0)
+    return scoped_ptr<cc::DrawQuad>();
+  quad->resource_id = packed.resource_id;
+  quad->tex_coord_rect.SetRect(packed.tex_coord_rect[0],
+                               packed.tex_coord_rect[1],
+                               packed.tex_coord_rect[2],
+                               packed.tex_coord_rect[3]);
+  quad->texture_size.SetSize(packed.texture_size[0], packed.texture_size[1]);
+  return quad.PassAs<cc::DrawQuad>();
+}
+
+scoped_ptr<cc::DrawQuad> ReadPackedSolidColorDrawQuad(const Message* m,
+                                                      PickleIterator* iter) {
+  cc::DrawQuad::Material material;
+  const char* data;
+  if (!ReadParam(m, iter, &material) ||
+      !m->ReadBytes(iter, &data, sizeof(PackedSolidColorDrawQuad)))
+    return scoped_ptr<cc::DrawQuad>();
+  PackedSolidColorDrawQuad packed;
+  memcpy(&packed, data, sizeof(packed));
+
+  scoped_ptr<cc::SolidColorDrawQuad> quad = cc::SolidColorDrawQuad::Create();
+  if (!UnpackDrawQuad(packed.base, material, quad.get()) ||
+      !UnpackBool(packed.force_anti_aliasing_off,
+                  &quad->force_anti_aliasing_off))
+    return scoped_ptr<cc::DrawQuad>();
+  quad->color = packed.color;
+  return quad.PassAs<cc::DrawQuad>();
+}
+
+}  // namespace
+
 void ParamTraits<cc::RenderPass>::Write(
     Message* m, const param_type& p) {
   WriteParam(m, p.id);
@@ -290,6 +433,8 @@ void ParamTraits<cc::RenderPass>::Write(
   WriteParam(m, p.damage_rect);
   WriteParam(m, p.transform_to_root_target);
   WriteParam(m, p.has_transparent_background);
+  WriteParam(m, p.reuses_previous_quads);
+  WriteParam(m, kPackedQuadFormatVersion);
   WriteParam(m, p.shared_quad_state_list.size());
   WriteParam(m, p.quad_list.size());
 
@@ -325,13 +470,13 @@ void ParamTraits<cc::RenderPass>::Write(
         WriteParam(m, *cc::RenderPassDrawQuad::MaterialCast(quad));
         break;
       case cc::DrawQuad::SOLID_COLOR:
-        WriteParam(m, *cc::SolidColorDrawQuad::MaterialCast(quad));
+        WritePackedQuad(m, *cc::SolidColorDrawQuad::MaterialCast(quad));
         break;
       case cc::DrawQuad::SURFACE_CONTENT:
         WriteParam(m, *cc::SurfaceDrawQuad::MaterialCast(quad));
         break;
       case cc::DrawQuad::TILED_CONTENT:
-        WriteParam(m, *cc::TileDrawQuad::MaterialCast(quad));
+        WritePackedQuad(m, *cc::TileDrawQuad::MaterialCast(quad));
         break;
       case cc::DrawQuad::STREAM_VIDEO_CONTENT:
         WriteParam(m, *cc::StreamVideoDrawQuad::MaterialCast(quad));
@@ -405,6 +550,8 @@ bool ParamTraits<cc::RenderPass>::Read(
   gfx::RectF damage_rect;
   gfx::Transform transform_to_root_target;
   bool has_transparent_background;
+  bool reuses_previous_quads;
+  int packed_quad_format_version;
   size_t shared_quad_state_list_size;
   size_t quad_list_size;
 
@@ -413,15 +560,20 @@ bool ParamTraits<cc::RenderPass>::Read(
       !ReadParam(m, iter, &damage_rect) ||
       !ReadParam(m, iter, &transform_to_root_target) ||
       !ReadParam(m, iter, &has_transparent_background) ||
+      !ReadParam(m, iter, &reuses_previous_quads) ||
+      !ReadParam(m, iter, &packed_quad_format_version) ||
       !ReadParam(m, iter, &shared_quad_state_list_size) ||
       !ReadParam(m, iter, &quad_list_size))
     return false;
+  if (packed_quad_format_version != kPackedQuadFormatVersion)
+    return false;
 
   p->SetAll(id,
             output_rect,
             damage_rect,
             transform_to_root_target,
             has_transparent_background);
+  p->reuses_previous_quads = reuses_previous_quads;
 
   size_t last_shared_quad_state_index = kuint32max;
   for (size_t i = 0; i < quad_list_size; ++i) {
@@ -454,10 +606,10 @@ bool ParamTraits<cc::RenderPass>::Read(
         draw_quad = ReadDrawQuad<cc::RenderPassDrawQuad>(m, iter);
         break;
       case cc::DrawQuad::SOLID_COLOR:
-        draw_quad = ReadDrawQuad<cc::SolidColorDrawQuad>(m, iter);
+        draw_quad = ReadPackedSolidColorDrawQuad(m, iter);
         break;
       case cc::DrawQuad::TILED_CONTENT:
-        draw_quad = ReadDrawQuad<cc::TileDrawQuad>(m, iter);
+        draw_quad = ReadPackedTileDrawQuad(m, iter);
         break;
       case cc::DrawQuad::STREAM_VIDEO_CONTENT:
         draw_quad = ReadDrawQuad<cc::StreamVideoDrawQuad>(m, iter);
@@ -523,6 +675,8 @@ void ParamTraits<cc::RenderPass>::Log(
   l->append(", ");
   LogParam(p.has_transparent_background, l);
   l->append(", ");
+  LogParam(p.reuses_previous_quads, l);
+  l->append(", ");
 
   l->append("[");
   for (size_t i = 0; i < p.shared_quad_state_list.size(); ++i) {
@@ -17,6 +17,7 @@ using cc::DrawQuad;
 using cc::PictureDrawQuad;
 using cc::RenderPass;
 using cc::SharedQuadState;
+using cc::TileDrawQuad;
 
 namespace content {
 namespace {
@@ -79,6 +80,29 @@ TEST_F(CCMessagesPerfTest, DelegatedFrame_ManyQuads_1_4000) {
   RunTest("DelegatedFrame_ManyQuads_1_4000", *frame);
 }
 
+TEST_F(CCMessagesPerfTest, DelegatedFrame_ManyTileQuads_1_4000) {
+  scoped_ptr<CompositorFrame> frame(new CompositorFrame);
+
+  scoped_ptr<RenderPass> render_pass = RenderPass::Create();
+  render_pass->shared_quad_state_list.push_back(SharedQuadState::Create());
+  for (int i = 0; i < 4000; ++i) {
+    scoped_ptr<TileDrawQuad> quad = TileDrawQuad::Create();
+    quad->SetNew(render_pass->shared_quad_state_list.back(),
+                 gfx::Rect(256, 256),
+                 gfx::Rect(256, 256),
+                 i + 1,
+                 gfx::RectF(256.f, 256.f),
+                 gfx::Size(256, 256),
+                 false);
+    render_pass->quad_list.push_back(quad.PassAs<DrawQuad>());
+  }
+
+  frame->delegated_frame_data.reset(new DelegatedFrameData);
+  frame->delegated_frame_data->render_pass_list.push_back(render_pass.Pass());
+
+  RunTest("DelegatedFrame_ManyTileQuads_1_4000", *frame);
+}
+
 TEST_F(CCMessagesPerfTest, DelegatedFrame_ManyQuads_1_100000) {
   scoped_ptr<CompositorFrame> frame(new CompositorFrame);
 
@@ -47,6 +47,7 @@ class CCMessagesTest : public testing::Test {
     EXPECT_EQ(a->damage_rect.ToString(), b->damage_rect.ToString());
     EXPECT_EQ(a->transform_to_root_target, b->transform_to_root_target);
     EXPECT_EQ(a->has_transparent_background, b->has_transparent_background);
+    EXPECT_EQ(a->reuses_previous_quads, b->reuses_previous_quads);
   }
 
   void Compare(const SharedQuadState* a, const SharedQuadState* b) {
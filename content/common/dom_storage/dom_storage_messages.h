@@ -80,12 +80,12 @@ IPC_SYNC_MESSAGE_CONTROL1_2(DOMStorageHostMsg_LoadStorageArea,
                             content::DOMStorageValuesMap,
                             bool /* send_log_get_messages */)
 
-// Set a value that's associated with a key in a storage area.
+// Set the values associated with keys in a storage area, removing the keys
+// mapped to a null value. Carries the changes a page made during a task.
 // A completion notification is sent in response.
-IPC_MESSAGE_CONTROL4(DOMStorageHostMsg_SetItem,
+IPC_MESSAGE_CONTROL3(DOMStorageHostMsg_ApplyMutations,
                      int /* connection_id */,
-                     base::string16 /* key */,
-                     base::string16 /* value */,
+                     content::DOMStorageValuesMap /* mutations */,
                      GURL /* page_url */)
 
 // Logs that a get operation was performed on a key/value pair.
@@ -94,13 +94,6 @@ IPC_MESSAGE_CONTROL3(DOMStorageHostMsg_LogGetItem,
                      base::string16 /* key */,
                      base::NullableString16 /* value */)
 
-// Remove the value associated with a key in a storage area.
-// A completion notification is sent in response.
-IPC_MESSAGE_CONTROL3(DOMStorageHostMsg_RemoveItem,
-                     int /* connection_id */,
-                     base::string16 /* key */,
-                     GURL /* page_url */)
-
 // Clear the storage area. A completion notification is sent in response.
 IPC_MESSAGE_CONTROL2(DOMStorageHostMsg_Clear,
                      int /* connection_id */,
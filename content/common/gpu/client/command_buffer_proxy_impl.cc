@@ -21,6 +21,13 @@
 
 namespace content {
 
+namespace {
+
+// Sync points reserved at once when InsertSyncPoint() runs out of them.
+const uint32 kSyncPointsToReserve = 16;
+
+}  // namespace
+
 CommandBufferProxyImpl::CommandBufferProxyImpl(
     GpuChannelHost* channel,
     int route_id)
@@ -462,8 +469,23 @@ uint32 CommandBufferProxyImpl::InsertSyncPoint() {
   if (last_state_.error != gpu::error::kNoError)
     return 0;
 
-  uint32 sync_point = 0;
-  Send(new GpuCommandBufferMsg_InsertSyncPoint(route_id_, &sync_point));
+  // Only the reservation needs a round trip. Inserting a reserved sync point
+  // is asynchronous, and the service retires it once all the commands
+  // flushed before it have been processed.
+  if (reserved_sync_points_.empty()) {
+    std::vector<uint32> sync_points;
+    Send(new GpuCommandBufferMsg_ReserveSyncPoints(
+        route_id_, kSyncPointsToReserve, &sync_points));
+    reserved_sync_points_.insert(reserved_sync_points_.end(),
+                                 sync_points.begin(),
+                                 sync_points.end());
+    if (reserved_sync_points_.empty())
+      return 0;
+  }
+
+  uint32 sync_point = reserved_sync_points_.front();
+  reserved_sync_points_.pop_front();
+  Send(new GpuCommandBufferMsg_InsertReservedSyncPoint(route_id_, sync_point));
   return sync_point;
 }
 
@@ -5,6 +5,7 @@
 #ifndef CONTENT_COMMON_GPU_CLIENT_COMMAND_BUFFER_PROXY_IMPL_H_
 #define CONTENT_COMMON_GPU_CLIENT_COMMAND_BUFFER_PROXY_IMPL_H_
 
+#include <deque>
 #include <map>
 #include <queue>
 #include <string>
@@ -199,6 +200,10 @@ class CommandBufferProxyImpl
   uint32 next_signal_id_;
   SignalTaskMap signal_tasks_;
 
+  // Sync points reserved from the GPU process, handed out by
+  // InsertSyncPoint() without waiting for a reply.
+  std::deque<uint32> reserved_sync_points_;
+
   // Local cache of id to gpu memory buffer mapping.
   GpuMemoryBufferMap gpu_memory_buffers_;
 
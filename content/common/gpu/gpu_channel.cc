@@ -8,7 +8,9 @@
 
 #include "content/common/gpu/gpu_channel.h"
 
+#include <algorithm>
 #include <queue>
+#include <set>
 #include <vector>
 
 #include "base/bind.h"
@@ -57,6 +59,10 @@ const int64 kMaxPreemptTimeMs = kVsyncIntervalMs;
 // below this threshold.
 const int64 kStopPreemptThresholdMs = kVsyncIntervalMs;
 
+// Most sync points a command buffer can reserve with one
+// GpuCommandBufferMsg_ReserveSyncPoints message.
+const uint32 kMaxReservedSyncPoints = 64;
+
 }  // anonymous namespace
 
 // This filter does three things:
@@ -75,12 +81,14 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
   // Takes ownership of gpu_channel (see below).
   GpuChannelMessageFilter(base::WeakPtr<GpuChannel>* gpu_channel,
                           scoped_refptr<SyncPointManager> sync_point_manager,
-                          scoped_refptr<base::MessageLoopProxy> message_loop)
+                          scoped_refptr<base::MessageLoopProxy> message_loop,
+                          scoped_refptr<gpu::PreemptionFlag> high_priority_flag)
       : preemption_state_(IDLE),
         gpu_channel_(gpu_channel),
         channel_(NULL),
         sync_point_manager_(sync_point_manager),
         message_loop_(message_loop),
+        high_priority_flag_(high_priority_flag),
         messages_forwarded_to_channel_(0),
         a_stub_is_descheduled_(false) {
   }
@@ -108,6 +116,10 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
 
     // All other messages get processed by the GpuChannel.
     if (!handled) {
+      // Preempt lower priority stubs right away, rather than once the message
+      // gets to the main thread.
+      if (high_priority_routes_.count(message.routing_id()))
+        high_priority_flag_->Set();
       messages_forwarded_to_channel_++;
       if (preempting_flag_.get())
         pending_messages_.push(PendingMessage(messages_forwarded_to_channel_));
@@ -127,6 +139,28 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
           sync_point));
       handled = true;
     }
+
+    if (message.type() == GpuCommandBufferMsg_ReserveSyncPoints::ID) {
+      GpuCommandBufferMsg_ReserveSyncPoints::SendParam param;
+      std::vector<uint32> sync_points;
+      if (GpuCommandBufferMsg_ReserveSyncPoints::ReadSendParam(&message,
+                                                               &param)) {
+        uint32 count = std::min(param.a, kMaxReservedSyncPoints);
+        for (uint32 i = 0; i < count; ++i)
+          sync_points.push_back(sync_point_manager_->GenerateSyncPoint());
+      }
+      IPC::Message* reply = IPC::SyncMessage::GenerateReply(&message);
+      GpuCommandBufferMsg_ReserveSyncPoints::WriteReplyParams(reply,
+                                                              sync_points);
+      Send(reply);
+      message_loop_->PostTask(FROM_HERE, base::Bind(
+          &GpuChannelMessageFilter::ReserveSyncPointsOnMainThread,
+          gpu_channel_,
+          sync_point_manager_,
+          message.routing_id(),
+          sync_points));
+      handled = true;
+    }
     return handled;
   }
 
@@ -144,6 +178,13 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
     a_stub_is_descheduled_ = a_stub_is_descheduled;
   }
 
+  void SetRouteHighPriority(int32 route_id, bool high_priority) {
+    if (high_priority)
+      high_priority_routes_.insert(route_id);
+    else
+      high_priority_routes_.erase(route_id);
+  }
+
   void UpdateStubSchedulingState(bool a_stub_is_descheduled) {
     a_stub_is_descheduled_ = a_stub_is_descheduled;
     UpdatePreemptionState();
@@ -362,6 +403,26 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
     manager->RetireSyncPoint(sync_point);
   }
 
+  static void ReserveSyncPointsOnMainThread(
+      base::WeakPtr<GpuChannel>* gpu_channel,
+      scoped_refptr<SyncPointManager> manager,
+      int32 routing_id,
+      const std::vector<uint32>& sync_points) {
+    // As in InsertSyncPointOnMainThread(), the sync points must be retired
+    // right away if there is no stub to hand them to.
+    if (gpu_channel->get()) {
+      gpu_channel->get()->MessageProcessed();
+      GpuCommandBufferStub* stub = gpu_channel->get()->LookupCommandBuffer(
+          routing_id);
+      if (stub) {
+        stub->AddReservedSyncPoints(sync_points);
+        return;
+      }
+    }
+    for (size_t i = 0; i < sync_points.size(); ++i)
+      manager->RetireSyncPoint(sync_points[i]);
+  }
+
   static void DeleteWeakPtrOnMainThread(
       base::WeakPtr<GpuChannel>* gpu_channel) {
     delete gpu_channel;
@@ -375,6 +436,10 @@ class GpuChannelMessageFilter : public IPC::ChannelProxy::MessageFilter {
   scoped_refptr<SyncPointManager> sync_point_manager_;
   scoped_refptr<base::MessageLoopProxy> message_loop_;
   scoped_refptr<gpu::PreemptionFlag> preempting_flag_;
+  scoped_refptr<gpu::PreemptionFlag> high_priority_flag_;
+
+  // A copy of GpuChannel::high_priority_routes_ for the IO thread.
+  std::set<int32> high_priority_routes_;
 
   std::queue<PendingMessage> pending_messages_;
 
@@ -394,6 +459,7 @@ GpuChannel::GpuChannel(GpuChannelManager* gpu_channel_manager,
                        bool software)
     : gpu_channel_manager_(gpu_channel_manager),
       messages_processed_(0),
+      high_priority_flag_(new gpu::PreemptionFlag),
       client_id_(client_id),
       share_group_(share_group ? share_group : new gfx::GLShareGroup),
       mailbox_manager_(mailbox ? mailbox : new gpu::gles2::MailboxManager),
@@ -433,7 +499,8 @@ bool GpuChannel::Init(base::MessageLoopProxy* io_message_loop,
   filter_ = new GpuChannelMessageFilter(
       weak_ptr,
       gpu_channel_manager_->sync_point_manager(),
-      base::MessageLoopProxy::current());
+      base::MessageLoopProxy::current(),
+      high_priority_flag_);
   io_message_loop_ = io_message_loop;
   channel_->AddFilter(filter_.get());
 
@@ -487,6 +554,12 @@ bool GpuChannel::OnMessageReceived(const IPC::Message& message) {
     deferred_messages_.push_back(new IPC::Message(message));
   }
 
+  if (high_priority_routes_.count(message.routing_id())) {
+    if (high_priority_waiting_since_.is_null())
+      high_priority_waiting_since_ = base::TimeTicks::Now();
+    high_priority_flag_->Set();
+  }
+
   OnScheduled();
 
   return true;
@@ -600,6 +673,7 @@ void GpuChannel::CreateViewCommandBuffer(
     stub->SetPreemptByFlag(preempted_flag_);
   router_.AddRoute(*route_id, stub.get());
   stubs_.AddWithID(stub.release(), *route_id);
+  SetStubHighPriority(*route_id);
 }
 
 GpuCommandBufferStub* GpuChannel::LookupCommandBuffer(int32 route_id) {
@@ -689,6 +763,18 @@ void GpuChannel::SetPreemptByFlag(
   }
 }
 
+void GpuChannel::SetStubHighPriority(int32 route_id) {
+  GpuCommandBufferStub* stub = stubs_.Lookup(route_id);
+  DCHECK(stub);
+  if (!high_priority_routes_.insert(route_id).second)
+    return;
+  stub->SetPreemptByHigherPriorityFlag(NULL);
+  io_message_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&GpuChannelMessageFilter::SetRouteHighPriority,
+                 filter_, route_id, true));
+}
+
 GpuChannel::~GpuChannel() {
   if (preempting_flag_.get())
     preempting_flag_->Reset();
@@ -725,7 +811,8 @@ void GpuChannel::HandleMessage() {
     return;
 
   bool should_fast_track_ack = false;
-  IPC::Message* m = deferred_messages_.front();
+  std::deque<IPC::Message*>::iterator next = NextMessageToHandle();
+  IPC::Message* m = *next;
   GpuCommandBufferStub* stub = stubs_.Lookup(m->routing_id());
 
   do {
@@ -739,7 +826,7 @@ void GpuChannel::HandleMessage() {
     }
 
     scoped_ptr<IPC::Message> message(m);
-    deferred_messages_.pop_front();
+    deferred_messages_.erase(next);
     bool message_processed = true;
 
     processed_get_state_fast_ =
@@ -779,7 +866,8 @@ void GpuChannel::HandleMessage() {
     // possible, avoiding scheduling other channels in the meantime.
     should_fast_track_ack = false;
     if (!deferred_messages_.empty()) {
-      m = deferred_messages_.front();
+      next = deferred_messages_.begin();
+      m = *next;
       stub = stubs_.Lookup(m->routing_id());
       should_fast_track_ack =
           (m->type() == GpuCommandBufferMsg_Echo::ID) &&
@@ -792,6 +880,32 @@ void GpuChannel::HandleMessage() {
   }
 }
 
+std::deque<IPC::Message*>::iterator GpuChannel::NextMessageToHandle() {
+  if (!high_priority_routes_.empty()) {
+    for (std::deque<IPC::Message*>::iterator it = deferred_messages_.begin();
+         it != deferred_messages_.end(); ++it) {
+      if (!high_priority_routes_.count((*it)->routing_id()))
+        continue;
+      GpuCommandBufferStub* stub = stubs_.Lookup((*it)->routing_id());
+      if (!stub || !stub->IsScheduled())
+        break;
+      base::TimeTicks now = base::TimeTicks::Now();
+      if (!high_priority_waiting_since_.is_null()) {
+        TRACE_COUNTER_ID1(
+            "gpu", "GpuChannel::HighPrioritySchedulingLatencyUs", this,
+            (now - high_priority_waiting_since_).InMicroseconds());
+      }
+      high_priority_waiting_since_ = now;
+      return it;
+    }
+  }
+
+  // No high priority message can run now, so stop preempting for them.
+  high_priority_flag_->Reset();
+  high_priority_waiting_since_ = base::TimeTicks();
+  return deferred_messages_.begin();
+}
+
 void GpuChannel::OnCreateOffscreenCommandBuffer(
     const gfx::Size& size,
     const GPUCreateCommandBufferConfig& init_params,
@@ -819,6 +933,7 @@ void GpuChannel::OnCreateOffscreenCommandBuffer(
       init_params.active_url));
   if (preempted_flag_.get())
     stub->SetPreemptByFlag(preempted_flag_);
+  stub->SetPreemptByHigherPriorityFlag(high_priority_flag_);
   router_.AddRoute(*route_id, stub.get());
   stubs_.AddWithID(stub.release(), *route_id);
   TRACE_EVENT1("gpu", "GpuChannel::OnCreateOffscreenCommandBuffer",
@@ -835,6 +950,12 @@ void GpuChannel::OnDestroyCommandBuffer(int32 route_id) {
   bool need_reschedule = (stub && !stub->IsScheduled());
   router_.RemoveRoute(route_id);
   stubs_.Remove(route_id);
+  if (high_priority_routes_.erase(route_id)) {
+    io_message_loop_->PostTask(
+        FROM_HERE,
+        base::Bind(&GpuChannelMessageFilter::SetRouteHighPriority,
+                   filter_, route_id, false));
+  }
   // In case the renderer is currently blocked waiting for a sync reply from the
   // stub, we need to make sure to reschedule the GpuChannel here.
   if (need_reschedule) {
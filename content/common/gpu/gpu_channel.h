@@ -6,6 +6,7 @@
 #define CONTENT_COMMON_GPU_GPU_CHANNEL_H_
 
 #include <deque>
+#include <set>
 #include <string>
 
 #include "base/id_map.h"
@@ -14,6 +15,7 @@
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/process/process.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/gpu_command_buffer_stub.h"
 #include "content/common/gpu/gpu_memory_manager.h"
@@ -142,6 +144,14 @@ class GpuChannel : public IPC::Listener,
   void SetPreemptByFlag(
       scoped_refptr<gpu::PreemptionFlag> preemption_flag);
 
+  // Makes the stub with |route_id| high priority. Messages for high priority
+  // stubs are handled ahead of those for other stubs on this channel, and
+  // other stubs are preempted between commands while they wait. Ordering is
+  // only kept between messages of the same priority, so clients must use
+  // sync points to order work across them. Onscreen (compositor) stubs and
+  // stubs that decode video are high priority.
+  void SetStubHighPriority(int32 route_id);
+
   void CacheShader(const std::string& key, const std::string& shader);
 
   void AddFilter(IPC::ChannelProxy::MessageFilter* filter);
@@ -174,6 +184,10 @@ class GpuChannel : public IPC::Listener,
   // Decrement the count of unhandled IPC messages and defer preemption.
   void MessageProcessed();
 
+  // Returns the first message for a high priority stub if it can run now,
+  // and the first message otherwise.
+  std::deque<IPC::Message*>::iterator NextMessageToHandle();
+
   // The lifetime of objects of this class is managed by a GpuChannelManager.
   // The GpuChannelManager destroy all the GpuChannels that they own when they
   // are destroyed. So a raw pointer is safe.
@@ -193,6 +207,18 @@ class GpuChannel : public IPC::Listener,
 
   std::deque<IPC::Message*> deferred_messages_;
 
+  // Routes of the high priority stubs.
+  std::set<int32> high_priority_routes_;
+
+  // Set while messages for high priority stubs are waiting, to preempt the
+  // other stubs on this channel. Also set on the IO thread as soon as such a
+  // message arrives.
+  scoped_refptr<gpu::PreemptionFlag> high_priority_flag_;
+
+  // When the high priority messages started waiting, for tracing how long
+  // they are kept from running.
+  base::TimeTicks high_priority_waiting_since_;
+
   // The id of the client who is on the other side of the channel.
   int client_id_;
 
@@ -8,6 +8,7 @@
 #include "base/debug/trace_event.h"
 #include "base/hash.h"
 #include "base/memory/shared_memory.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/devtools_gpu_instrumentation.h"
@@ -25,9 +26,11 @@
 #include "gpu/command_buffer/common/constants.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/common/mailbox.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 #include "gpu/command_buffer/service/gl_context_virtual.h"
 #include "gpu/command_buffer/service/gl_state_restorer_impl.h"
 #include "gpu/command_buffer/service/gpu_control_service.h"
+#include "gpu/command_buffer/service/gpu_switches.h"
 #include "gpu/command_buffer/service/image_manager.h"
 #include "gpu/command_buffer/service/logger.h"
 #include "gpu/command_buffer/service/memory_tracking.h"
@@ -130,6 +133,8 @@ GpuCommandBufferStub::GpuCommandBufferStub(
       software_(software),
       last_flush_count_(0),
       last_memory_allocation_valid_(false),
+      last_frontbuffer_suggestion_valid_(false),
+      last_frontbuffer_suggestion_(false),
       watchdog_(watchdog),
       sync_point_wait_count_(0),
       delayed_work_scheduled_(false),
@@ -176,6 +181,7 @@ bool GpuCommandBufferStub::OnMessageReceived(const IPC::Message& message) {
       message.type() != GpuCommandBufferMsg_Echo::ID &&
       message.type() != GpuCommandBufferMsg_GetStateFast::ID &&
       message.type() != GpuCommandBufferMsg_RetireSyncPoint::ID &&
+      message.type() != GpuCommandBufferMsg_InsertReservedSyncPoint::ID &&
       message.type() != GpuCommandBufferMsg_SetLatencyInfo::ID) {
     if (!MakeCurrent())
       return false;
@@ -210,6 +216,8 @@ bool GpuCommandBufferStub::OnMessageReceived(const IPC::Message& message) {
                         OnSetSurfaceVisible)
     IPC_MESSAGE_HANDLER(GpuCommandBufferMsg_RetireSyncPoint,
                         OnRetireSyncPoint)
+    IPC_MESSAGE_HANDLER(GpuCommandBufferMsg_InsertReservedSyncPoint,
+                        OnInsertReservedSyncPoint)
     IPC_MESSAGE_HANDLER(GpuCommandBufferMsg_SignalSyncPoint,
                         OnSignalSyncPoint)
     IPC_MESSAGE_HANDLER(GpuCommandBufferMsg_SignalQuery,
@@ -354,6 +362,8 @@ void GpuCommandBufferStub::Destroy() {
 
   while (!sync_points_.empty())
     OnRetireSyncPoint(sync_points_.front());
+  while (!reserved_sync_points_.empty())
+    OnInsertReservedSyncPoint(*reserved_sync_points_.begin());
 
   if (decoder_)
     decoder_->set_engine(NULL);
@@ -406,6 +416,15 @@ void GpuCommandBufferStub::OnInitialize(
     return;
   }
 
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kCaptureGpuCommandBuffers)) {
+    base::FilePath path = command_line->GetSwitchValuePath(
+        switches::kCaptureGpuCommandBuffers).AppendASCII(base::StringPrintf(
+            "%d_%d.gpucap", static_cast<int>(channel_->renderer_pid()),
+            route_id_));
+    command_buffer_->SetRecorder(gpu::CommandBufferRecorder::Create(path));
+  }
+
   decoder_.reset(::gpu::gles2::GLES2Decoder::Create(context_group_.get()));
 
   scheduler_.reset(new gpu::GpuScheduler(command_buffer_.get(),
@@ -413,6 +432,9 @@ void GpuCommandBufferStub::OnInitialize(
                                          decoder_.get()));
   if (preemption_flag_.get())
     scheduler_->SetPreemptByFlag(preemption_flag_);
+  if (higher_priority_preemption_flag_.get())
+    scheduler_->SetPreemptByHigherPriorityFlag(
+        higher_priority_preemption_flag_);
 
   decoder_->set_engine(scheduler_.get());
 
@@ -756,6 +778,9 @@ void GpuCommandBufferStub::OnCreateVideoDecoder(
   GpuVideoDecodeAccelerator* decoder = new GpuVideoDecodeAccelerator(
       decoder_route_id, this, channel_->io_message_loop());
   decoder->Initialize(profile, reply_message);
+  // Video frames are presented as they are decoded, so keep them from being
+  // stuck behind other work on the channel.
+  channel_->SetStubHighPriority(route_id_);
   // decoder is registered as a DestructionObserver of this stub and will
   // self-delete during destruction of this stub.
 }
@@ -770,6 +795,22 @@ void GpuCommandBufferStub::AddSyncPoint(uint32 sync_point) {
   sync_points_.push_back(sync_point);
 }
 
+void GpuCommandBufferStub::AddReservedSyncPoints(
+    const std::vector<uint32>& sync_points) {
+  reserved_sync_points_.insert(sync_points.begin(), sync_points.end());
+}
+
+void GpuCommandBufferStub::OnInsertReservedSyncPoint(uint32 sync_point) {
+  // Messages are handled in order, so this retires the sync point after all
+  // the commands flushed before it.
+  if (!reserved_sync_points_.erase(sync_point)) {
+    DLOG(ERROR) << "Sync point " << sync_point << " was not reserved";
+    return;
+  }
+  GpuChannelManager* manager = channel_->gpu_channel_manager();
+  manager->sync_point_manager()->RetireSyncPoint(sync_point);
+}
+
 void GpuCommandBufferStub::OnRetireSyncPoint(uint32 sync_point) {
   DCHECK(!sync_points_.empty() && sync_points_.front() == sync_point);
   sync_points_.pop_front();
@@ -917,6 +958,14 @@ void GpuCommandBufferStub::SetPreemptByFlag(
     scheduler_->SetPreemptByFlag(preemption_flag_);
 }
 
+void GpuCommandBufferStub::SetPreemptByHigherPriorityFlag(
+    scoped_refptr<gpu::PreemptionFlag> flag) {
+  higher_priority_preemption_flag_ = flag;
+  if (scheduler_)
+    scheduler_->SetPreemptByHigherPriorityFlag(
+        higher_priority_preemption_flag_);
+}
+
 bool GpuCommandBufferStub::GetTotalGpuMemory(uint64* bytes) {
   *bytes = total_gpu_memory_;
   return !!total_gpu_memory_;
@@ -946,10 +995,19 @@ void GpuCommandBufferStub::SetMemoryAllocation(
 
 void GpuCommandBufferStub::SuggestHaveFrontBuffer(
     bool suggest_have_frontbuffer) {
+  // The memory manager makes this suggestion to every client each time it
+  // reassigns memory, usually without a change.
+  if (last_frontbuffer_suggestion_valid_ &&
+      last_frontbuffer_suggestion_ == suggest_have_frontbuffer)
+    return;
+
   // This can be called outside of OnMessageReceived, so the context needs
   // to be made current before calling methods on the surface.
-  if (surface_.get() && MakeCurrent())
+  if (surface_.get() && MakeCurrent()) {
     surface_->SetFrontbufferAllocation(suggest_have_frontbuffer);
+    last_frontbuffer_suggestion_valid_ = true;
+    last_frontbuffer_suggestion_ = suggest_have_frontbuffer;
+  }
 }
 
 bool GpuCommandBufferStub::CheckContextLost() {
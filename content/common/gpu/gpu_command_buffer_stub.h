@@ -6,6 +6,7 @@
 #define CONTENT_COMMON_GPU_GPU_COMMAND_BUFFER_STUB_H_
 
 #include <deque>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -137,8 +138,16 @@ class GpuCommandBufferStub
   // retire all sync points that haven't been previously retired.
   void AddSyncPoint(uint32 sync_point);
 
+  // Associates sync points reserved by the client to this stub. They are
+  // retired once the client inserts them, or when the stub is destroyed.
+  void AddReservedSyncPoints(const std::vector<uint32>& sync_points);
+
   void SetPreemptByFlag(scoped_refptr<gpu::PreemptionFlag> flag);
 
+  // Preempts this stub between commands while |flag| is set, to let higher
+  // priority stubs on the same channel run.
+  void SetPreemptByHigherPriorityFlag(scoped_refptr<gpu::PreemptionFlag> flag);
+
   void SetLatencyInfoCallback(const LatencyInfoCallback& callback);
 
   void MarkContextLost();
@@ -178,6 +187,7 @@ class GpuCommandBufferStub
   void OnEnsureBackbuffer();
 
   void OnRetireSyncPoint(uint32 sync_point);
+  void OnInsertReservedSyncPoint(uint32 sync_point);
   bool OnWaitSyncPoint(uint32 sync_point);
   void OnSyncPointRetired();
   void OnSignalSyncPoint(uint32 sync_point, uint32 id);
@@ -244,6 +254,10 @@ class GpuCommandBufferStub
   // elide redundant work).
   bool last_memory_allocation_valid_;
   gpu::MemoryAllocation last_memory_allocation_;
+  // The last front buffer suggestion applied to the surface (used to avoid
+  // making the context current when it hasn't changed).
+  bool last_frontbuffer_suggestion_valid_;
+  bool last_frontbuffer_suggestion_;
 
   GpuWatchdog* watchdog_;
 
@@ -251,6 +265,8 @@ class GpuCommandBufferStub
 
   // A queue of sync points associated with this stub.
   std::deque<uint32> sync_points_;
+  // Sync points reserved by the client and not inserted yet.
+  std::set<uint32> reserved_sync_points_;
   int sync_point_wait_count_;
 
   bool delayed_work_scheduled_;
@@ -258,6 +274,7 @@ class GpuCommandBufferStub
   base::TimeTicks last_idle_time_;
 
   scoped_refptr<gpu::PreemptionFlag> preemption_flag_;
+  scoped_refptr<gpu::PreemptionFlag> higher_priority_preemption_flag_;
 
   LatencyInfoCallback latency_info_callback_;
 
@@ -389,6 +389,9 @@ void GpuMemoryManager::GetVideoMemoryUsageStats(
 }
 
 void GpuMemoryManager::Manage() {
+  TRACE_EVENT2("gpu", "GpuMemoryManager::Manage",
+               "visible_clients", clients_visible_mru_.size(),
+               "nonvisible_clients", clients_nonvisible_mru_.size());
   manage_immediate_scheduled_ = false;
   delayed_manage_callback_.Cancel();
 
@@ -654,10 +657,19 @@ void GpuMemoryManager::AssignSurfacesAllocations() {
   clients.insert(clients.end(),
                  clients_nonvisible_mru_.begin(),
                  clients_nonvisible_mru_.end());
+  uint64 bytes_allocated_visible = 0;
   for (ClientStateList::const_iterator it = clients.begin();
        it != clients.end();
        ++it) {
     GpuMemoryManagerClientState* client_state = *it;
+    if (client_state->visible_)
+      bytes_allocated_visible += client_state->bytes_allocation_when_visible_;
+    TRACE_COUNTER_ID2("gpu", "GpuMemoryManager::ClientAllocation",
+                      client_state,
+                      "allocation",
+                      client_state->bytes_allocation_when_visible_,
+                      "nice_to_have",
+                      client_state->managed_memory_stats_.bytes_nice_to_have);
 
     // Re-assign memory limits to this client when its "nice to have" bucket
     // grows or shrinks by 1/4.
@@ -676,6 +688,8 @@ void GpuMemoryManager::AssignSurfacesAllocations() {
     client_state->client_->SetMemoryAllocation(allocation);
     client_state->client_->SuggestHaveFrontBuffer(!client_state->hibernated_);
   }
+  TRACE_COUNTER1("gpu", "GpuMemoryManagerVisibleAllocation",
+                 bytes_allocated_visible);
 }
 
 void GpuMemoryManager::AssignNonSurfacesAllocations() {
@@ -725,6 +739,11 @@ void GpuMemoryManager::SetClientsHibernatedState() const {
       client_state->tracking_group_->hibernated_ = false;
       non_hibernated_clients++;
     } else {
+      if (!client_state->hibernated_) {
+        TRACE_EVENT_INSTANT1("gpu", "GpuMemoryManager::HibernateClient",
+                             TRACE_EVENT_SCOPE_THREAD,
+                             "client", static_cast<void*>(client_state));
+      }
       client_state->hibernated_ = true;
     }
   }
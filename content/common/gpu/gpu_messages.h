@@ -610,6 +610,21 @@ IPC_MESSAGE_ROUTED1(
 IPC_SYNC_MESSAGE_ROUTED0_1(GpuCommandBufferMsg_InsertSyncPoint,
                            uint32 /* sync_point */)
 
+// Reserves up to |count| sync points for this command buffer. Like
+// GpuCommandBufferMsg_InsertSyncPoint this is handled on the IO thread. The
+// sync points can then be inserted with
+// GpuCommandBufferMsg_InsertReservedSyncPoint, without waiting for a reply.
+// Waits on them block until they are inserted and retired, or until the
+// command buffer is destroyed.
+IPC_SYNC_MESSAGE_ROUTED1_1(GpuCommandBufferMsg_ReserveSyncPoints,
+                           uint32 /* count */,
+                           std::vector<uint32> /* sync_points */)
+
+// Inserts a sync point reserved with GpuCommandBufferMsg_ReserveSyncPoints.
+// It is retired in order with respect to the other calls.
+IPC_MESSAGE_ROUTED1(GpuCommandBufferMsg_InsertReservedSyncPoint,
+                    uint32 /* sync_point */)
+
 // Retires the sync point. Note: this message is not sent explicitly by the
 // renderer, but is synthesized by the GPU process.
 IPC_MESSAGE_ROUTED1(GpuCommandBufferMsg_RetireSyncPoint,
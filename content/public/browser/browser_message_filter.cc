@@ -91,6 +91,14 @@ class BrowserMessageFilter::Internal : public IPC::ChannelProxy::MessageFilter {
     return rv;
   }
 
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (filter_->message_classes_to_filter_.empty())
+      return false;
+    *supported_message_classes = filter_->message_classes_to_filter_;
+    return true;
+  }
+
   scoped_refptr<BrowserMessageFilter> filter_;
 
   DISALLOW_COPY_AND_ASSIGN(Internal);
@@ -104,6 +112,29 @@ BrowserMessageFilter::BrowserMessageFilter()
       peer_pid_(base::kNullProcessId) {
 }
 
+BrowserMessageFilter::BrowserMessageFilter(uint32 message_class_to_filter)
+    : internal_(NULL), channel_(NULL),
+#if defined(OS_WIN)
+      peer_handle_(base::kNullProcessHandle),
+#endif
+      peer_pid_(base::kNullProcessId),
+      message_classes_to_filter_(1, message_class_to_filter) {
+}
+
+BrowserMessageFilter::BrowserMessageFilter(
+    const uint32* message_classes_to_filter,
+    size_t num_message_classes_to_filter)
+    : internal_(NULL), channel_(NULL),
+#if defined(OS_WIN)
+      peer_handle_(base::kNullProcessHandle),
+#endif
+      peer_pid_(base::kNullProcessId),
+      message_classes_to_filter_(
+          message_classes_to_filter,
+          message_classes_to_filter + num_message_classes_to_filter) {
+  DCHECK(num_message_classes_to_filter);
+}
+
 base::ProcessHandle BrowserMessageFilter::PeerHandle() {
 #if defined(OS_WIN)
   base::AutoLock lock(peer_handle_lock_);
@@ -5,6 +5,8 @@
 #ifndef CONTENT_PUBLIC_BROWSER_BROWSER_MESSAGE_FILTER_H_
 #define CONTENT_PUBLIC_BROWSER_BROWSER_MESSAGE_FILTER_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/process/process.h"
 #include "content/common/content_export.h"
@@ -30,6 +32,11 @@ class CONTENT_EXPORT BrowserMessageFilter
       public IPC::Sender {
  public:
   BrowserMessageFilter();
+  // Filters that only handle messages of some classes (IPC_MESSAGE_START)
+  // should pass them here, so that they aren't offered every message.
+  explicit BrowserMessageFilter(uint32 message_class_to_filter);
+  BrowserMessageFilter(const uint32* message_classes_to_filter,
+                       size_t num_message_classes_to_filter);
 
   // These match the corresponding IPC::ChannelProxy::MessageFilter methods and
   // are always called on the IO thread.
@@ -117,6 +124,10 @@ class CONTENT_EXPORT BrowserMessageFilter
   IPC::Channel* channel_;
   base::ProcessId peer_pid_;
 
+  // Message classes this filter handles, or empty if it has to see every
+  // message.
+  std::vector<uint32> message_classes_to_filter_;
+
 #if defined(OS_WIN)
   base::Lock peer_handle_lock_;
   base::ProcessHandle peer_handle_;
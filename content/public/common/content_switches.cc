@@ -471,6 +471,18 @@ extern const char kEnableHTMLImports[]      = "enable-html-imports";
 // Enables support for inband text tracks in media content.
 const char kEnableInbandTextTracks[]        = "enable-inband-text-tracks";
 
+// Sends messages from the browser to renderers through a shared memory ring
+// rather than the IPC socket where possible. POSIX only.
+const char kEnableIPCMessageRing[]          = "enable-ipc-message-ring";
+
+// Stores localStorage in one LevelDB database for all origins, instead of a
+// SQLite database per origin.
+const char kEnableLevelDBLocalStorage[]     = "enable-leveldb-local-storage";
+
+// Lets localStorage writes skip loading the area into the renderer, leaving
+// the quota checks to the browser.
+const char kEnableLocalStorageLazyLoad[]    = "enable-local-storage-lazy-load";
+
 // Force logging to be enabled.  Logging is disabled by default in release
 // builds.
 const char kEnableLogging[]                 = "enable-logging";
@@ -786,6 +798,10 @@ const char kRendererAssertTest[]            = "renderer-assert-test";
 // command line. Useful values might be "valgrind" or "xterm -e gdb --args".
 const char kRendererCmdPrefix[]             = "renderer-cmd-prefix";
 
+// On Linux only: the number of renderers the zygote keeps forked ahead of
+// time, so that a new renderer starts without waiting for a fork.
+const char kRendererPoolSize[]              = "renderer-pool-size";
+
 // Causes the process to run as renderer instead of as browser.
 const char kRendererProcess[]               = "renderer";
 
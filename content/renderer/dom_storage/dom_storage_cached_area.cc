@@ -4,7 +4,10 @@
 
 #include "content/renderer/dom_storage/dom_storage_cached_area.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/time/time.h"
 #include "content/common/dom_storage/dom_storage_map.h"
@@ -26,9 +29,27 @@ DOMStorageCachedArea::DOMStorageCachedArea(int64 namespace_id,
       origin_(origin),
       proxy_(proxy),
       remaining_log_get_messages_(0),
+      lazy_load_(false),
+      flush_scheduled_(false),
+      messages_in_window_(0),
+      peak_messages_per_second_(0),
       weak_factory_(this) {}
 
-DOMStorageCachedArea::~DOMStorageCachedArea() {}
+DOMStorageCachedArea::~DOMStorageCachedArea() {
+  if (namespace_id_ == kLocalStorageNamespaceId &&
+      peak_messages_per_second_ > 0) {
+    UMA_HISTOGRAM_COUNTS_10000("LocalStorage.RendererPeakIPCsPerSecond",
+                               peak_messages_per_second_);
+  }
+}
+
+DOMStorageCachedArea::PendingMutations::PendingMutations(
+    int connection_id, const GURL& page_url)
+    : connection_id(connection_id),
+      page_url(page_url),
+      mutation_count(0) {}
+
+DOMStorageCachedArea::PendingMutations::~PendingMutations() {}
 
 unsigned DOMStorageCachedArea::GetLength(int connection_id) {
   PrimeIfNeeded(connection_id);
@@ -62,43 +83,41 @@ bool DOMStorageCachedArea::SetItem(int connection_id,
   if (key.length() + value.length() > kPerStorageAreaQuota)
     return false;
 
-  PrimeIfNeeded(connection_id);
-  base::NullableString16 unused;
-  if (!map_->SetItem(key, value, &unused))
-    return false;
+  if (map_.get() || !lazy_load_) {
+    PrimeIfNeeded(connection_id);
+    base::NullableString16 unused;
+    if (!map_->SetItem(key, value, &unused))
+      return false;
+  }
 
-  // Ignore mutations to 'key' until OnSetItemComplete.
-  ignore_key_mutations_[key]++;
-  proxy_->SetItem(
-      connection_id, key, value, page_url,
-      base::Bind(&DOMStorageCachedArea::OnSetItemComplete,
-                 weak_factory_.GetWeakPtr(), key));
+  AddPendingMutation(connection_id, key,
+                     base::NullableString16(value, false), page_url);
   return true;
 }
 
 void DOMStorageCachedArea::RemoveItem(int connection_id,
                                       const base::string16& key,
                                       const GURL& page_url) {
-  PrimeIfNeeded(connection_id);
-  base::string16 unused;
-  if (!map_->RemoveItem(key, &unused))
-    return;
+  if (map_.get() || !lazy_load_) {
+    PrimeIfNeeded(connection_id);
+    base::string16 unused;
+    if (!map_->RemoveItem(key, &unused))
+      return;
+  }
 
-  // Ignore mutations to 'key' until OnRemoveItemComplete.
-  ignore_key_mutations_[key]++;
-  proxy_->RemoveItem(
-      connection_id, key, page_url,
-      base::Bind(&DOMStorageCachedArea::OnRemoveItemComplete,
-                 weak_factory_.GetWeakPtr(), key));
+  AddPendingMutation(connection_id, key, base::NullableString16(), page_url);
 }
 
 void DOMStorageCachedArea::Clear(int connection_id, const GURL& page_url) {
-  // No need to prime the cache in this case.
+  // No need to prime the cache in this case, nor to send the changes that
+  // the clear overwrites.
+  pending_mutations_.clear();
   Reset();
   map_ = new DOMStorageMap(kPerStorageAreaQuota);
 
   // Ignore all mutations until OnClearComplete time.
   ignore_all_mutations_ = true;
+  CountMessageSent();
   proxy_->ClearArea(connection_id,
                     page_url,
                     base::Bind(&DOMStorageCachedArea::OnClearComplete,
@@ -155,6 +174,68 @@ size_t DOMStorageCachedArea::MemoryBytesUsedByCache() const {
   return map_.get() ? map_->bytes_used() : 0;
 }
 
+void DOMStorageCachedArea::FlushPendingMutations() {
+  flush_scheduled_ = false;
+  std::vector<PendingMutations> pending;
+  pending.swap(pending_mutations_);
+  for (std::vector<PendingMutations>::const_iterator it = pending.begin();
+       it != pending.end(); ++it) {
+    std::vector<base::string16> keys;
+    for (DOMStorageValuesMap::const_iterator mutation = it->mutations.begin();
+         mutation != it->mutations.end(); ++mutation) {
+      keys.push_back(mutation->first);
+    }
+    if (namespace_id_ == kLocalStorageNamespaceId) {
+      UMA_HISTOGRAM_CUSTOM_COUNTS("LocalStorage.RendererMutationsPerIPC",
+                                  it->mutation_count, 1, 10000, 50);
+    }
+    CountMessageSent();
+    proxy_->ApplyMutations(
+        it->connection_id, it->mutations, it->page_url,
+        base::Bind(&DOMStorageCachedArea::OnApplyMutationsComplete,
+                   weak_factory_.GetWeakPtr(), keys));
+  }
+}
+
+void DOMStorageCachedArea::AddPendingMutation(
+    int connection_id,
+    const base::string16& key,
+    const base::NullableString16& value,
+    const GURL& page_url) {
+  if (pending_mutations_.empty() ||
+      pending_mutations_.back().connection_id != connection_id ||
+      pending_mutations_.back().page_url != page_url) {
+    pending_mutations_.push_back(PendingMutations(connection_id, page_url));
+  }
+  PendingMutations& pending = pending_mutations_.back();
+
+  // Ignore mutations to 'key' until OnApplyMutationsComplete. Later changes
+  // to the key in the same batch replace the earlier ones.
+  if (pending.mutations.find(key) == pending.mutations.end())
+    ignore_key_mutations_[key]++;
+  pending.mutations[key] = value;
+  pending.mutation_count++;
+
+  if (flush_scheduled_)
+    return;
+  flush_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&DOMStorageCachedArea::FlushPendingMutations,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void DOMStorageCachedArea::CountMessageSent() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (now - message_window_start_ >= base::TimeDelta::FromSeconds(1)) {
+    message_window_start_ = now;
+    messages_in_window_ = 0;
+  }
+  ++messages_in_window_;
+  peak_messages_per_second_ =
+      std::max(peak_messages_per_second_, messages_in_window_);
+}
+
 void DOMStorageCachedArea::Prime(int connection_id) {
   DCHECK(!map_.get());
 
@@ -164,11 +245,16 @@ void DOMStorageCachedArea::Prime(int connection_id) {
   // from ipc stream out of order, mutations in front if it need
   // to be ignored.
 
+  // Changes made without priming are sent first, so that the loaded values
+  // include them.
+  FlushPendingMutations();
+
   // Ignore all mutations until OnLoadComplete time.
   ignore_all_mutations_ = true;
   DOMStorageValuesMap values;
   bool send_log_get_messages = false;
   base::TimeTicks before = base::TimeTicks::Now();
+  CountMessageSent();
   proxy_->LoadArea(connection_id,
                    &values,
                    &send_log_get_messages,
@@ -207,6 +293,8 @@ void DOMStorageCachedArea::Prime(int connection_id) {
 }
 
 void DOMStorageCachedArea::Reset() {
+  // The changes made so far must still reach the browser.
+  FlushPendingMutations();
   map_ = NULL;
   weak_factory_.InvalidateWeakPtrs();
   ignore_key_mutations_.clear();
@@ -219,27 +307,22 @@ void DOMStorageCachedArea::OnLoadComplete(bool success) {
   ignore_all_mutations_ = false;
 }
 
-void DOMStorageCachedArea::OnSetItemComplete(const base::string16& key,
-                                             bool success) {
+void DOMStorageCachedArea::OnApplyMutationsComplete(
+    const std::vector<base::string16>& keys,
+    bool success) {
+  // A set item operation of the batch went over the quota.
   if (!success) {
     Reset();
     return;
   }
-  std::map<base::string16, int>::iterator found =
-      ignore_key_mutations_.find(key);
-  DCHECK(found != ignore_key_mutations_.end());
-  if (--found->second == 0)
-    ignore_key_mutations_.erase(found);
-}
-
-void DOMStorageCachedArea::OnRemoveItemComplete(const base::string16& key,
-                                                bool success) {
-  DCHECK(success);
-  std::map<base::string16, int>::iterator found =
-      ignore_key_mutations_.find(key);
-  DCHECK(found != ignore_key_mutations_.end());
-  if (--found->second == 0)
-    ignore_key_mutations_.erase(found);
+  for (std::vector<base::string16>::const_iterator key = keys.begin();
+       key != keys.end(); ++key) {
+    std::map<base::string16, int>::iterator found =
+        ignore_key_mutations_.find(*key);
+    DCHECK(found != ignore_key_mutations_.end());
+    if (--found->second == 0)
+      ignore_key_mutations_.erase(found);
+  }
 }
 
 void DOMStorageCachedArea::OnClearComplete(bool success) {
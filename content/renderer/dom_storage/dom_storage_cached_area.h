@@ -6,11 +6,14 @@
 #define CONTENT_RENDERER_DOM_STORAGE_DOM_STORAGE_CACHED_AREA_H_
 
 #include <map>
+#include <vector>
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/strings/nullable_string16.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
+#include "content/common/dom_storage/dom_storage_types.h"
 #include "url/gurl.h"
 
 namespace content {
@@ -24,6 +27,11 @@ class DOMStorageProxy;
 // first access and changes are written to the backend thru the |proxy|.
 // Mutations originating in other processes are applied to the cache via
 // the ApplyMutation method.
+//
+// The changes made during a task are batched, with repeated changes to a key
+// coalesced, and sent in one message when the task ends. In lazy load mode,
+// changes are also made without priming the cache, so pages that only write
+// never load the area.
 class CONTENT_EXPORT DOMStorageCachedArea
     : public base::RefCounted<DOMStorageCachedArea> {
  public:
@@ -34,6 +42,10 @@ class CONTENT_EXPORT DOMStorageCachedArea
   int64 namespace_id() const { return namespace_id_; }
   const GURL& origin() const { return origin_; }
 
+  // In lazy load mode, the quota is only enforced by the browser until the
+  // cache is primed.
+  void set_lazy_load(bool lazy_load) { lazy_load_ = lazy_load; }
+
   unsigned GetLength(int connection_id);
   base::NullableString16 GetKey(int connection_id, unsigned index);
   base::NullableString16 GetItem(int connection_id, const base::string16& key);
@@ -51,6 +63,10 @@ class CONTENT_EXPORT DOMStorageCachedArea
 
   size_t MemoryBytesUsedByCache() const;
 
+  // Sends the changes batched so far, instead of at the end of the task.
+  // Must be called before a connection with batched changes is closed.
+  void FlushPendingMutations();
+
   // Resets the object back to its newly constructed state.
   void Reset();
 
@@ -59,6 +75,28 @@ class CONTENT_EXPORT DOMStorageCachedArea
   friend class base::RefCounted<DOMStorageCachedArea>;
   ~DOMStorageCachedArea();
 
+  // The changes made thru one connection to one page, in the order they
+  // were made. Null values are removals.
+  struct PendingMutations {
+    PendingMutations(int connection_id, const GURL& page_url);
+    ~PendingMutations();
+
+    int connection_id;
+    GURL page_url;
+    DOMStorageValuesMap mutations;
+    int mutation_count;
+  };
+
+  // Adds a change to the batch, and schedules the batch to be sent if it
+  // isn't already.
+  void AddPendingMutation(int connection_id,
+                          const base::string16& key,
+                          const base::NullableString16& value,
+                          const GURL& page_url);
+
+  // Tracks the peak rate of the messages sent to the browser.
+  void CountMessageSent();
+
   // Primes the cache, loading all values for the area.
   void Prime(int connection_id);
   void PrimeIfNeeded(int connection_id) {
@@ -71,9 +109,9 @@ class CONTENT_EXPORT DOMStorageCachedArea
   // mutation events from other processes from overwriting local
   // changes made after the mutation.
   void OnLoadComplete(bool success);
-  void OnSetItemComplete(const base::string16& key, bool success);
+  void OnApplyMutationsComplete(const std::vector<base::string16>& keys,
+                                bool success);
   void OnClearComplete(bool success);
-  void OnRemoveItemComplete(const base::string16& key, bool success);
 
   bool should_ignore_key_mutation(const base::string16& key) const {
     return ignore_key_mutations_.find(key) != ignore_key_mutations_.end();
@@ -91,6 +129,16 @@ class CONTENT_EXPORT DOMStorageCachedArea
   // of gets. Here, we keep track of how many remaining get log messages we
   // need to send.
   int remaining_log_get_messages_;
+
+  bool lazy_load_;
+  std::vector<PendingMutations> pending_mutations_;
+  bool flush_scheduled_;
+
+  // The peak number of messages sent to the browser within a second.
+  base::TimeTicks message_window_start_;
+  int messages_in_window_;
+  int peak_messages_per_second_;
+
   base::WeakPtrFactory<DOMStorageCachedArea> weak_factory_;
 };
 
@@ -7,6 +7,7 @@
 #include <list>
 
 #include "base/bind.h"
+#include "base/message_loop/message_loop.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/renderer/dom_storage/dom_storage_proxy.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -34,16 +35,14 @@ class MockProxy : public DOMStorageProxy {
     *send_log_get_messages = false;
   }
 
-  virtual void SetItem(int connection_id,
-                       const base::string16& key,
-                       const base::string16& value,
-                       const GURL& page_url,
-                       const CompletionCallback& callback) OVERRIDE {
+  virtual void ApplyMutations(int connection_id,
+                              const DOMStorageValuesMap& mutations,
+                              const GURL& page_url,
+                              const CompletionCallback& callback) OVERRIDE {
     pending_callbacks_.push_back(callback);
-    observed_set_item_ = true;
+    observed_apply_mutations_count_++;
     observed_connection_id_ = connection_id;
-    observed_key_ = key;
-    observed_value_ = value;
+    observed_mutations_ = mutations;
     observed_page_url_ = page_url;
   }
 
@@ -52,17 +51,6 @@ class MockProxy : public DOMStorageProxy {
                           const base::NullableString16& value) OVERRIDE {
   }
 
-  virtual void RemoveItem(int connection_id,
-                          const base::string16& key,
-                          const GURL& page_url,
-                          const CompletionCallback& callback) OVERRIDE {
-    pending_callbacks_.push_back(callback);
-    observed_remove_item_ = true;
-    observed_connection_id_ = connection_id;
-    observed_key_ = key;
-    observed_page_url_ = page_url;
-  }
-
   virtual void ClearArea(int connection_id,
                          const GURL& page_url,
                          const CompletionCallback& callback) OVERRIDE {
@@ -76,12 +64,10 @@ class MockProxy : public DOMStorageProxy {
 
   void ResetObservations() {
     observed_load_area_ = false;
-    observed_set_item_ = false;
-    observed_remove_item_ = false;
+    observed_apply_mutations_count_ = 0;
     observed_clear_area_ = false;
     observed_connection_id_ = 0;
-    observed_key_.clear();
-    observed_value_.clear();
+    observed_mutations_.clear();
     observed_page_url_ = GURL();
   }
 
@@ -101,12 +87,10 @@ class MockProxy : public DOMStorageProxy {
   DOMStorageValuesMap load_area_return_values_;
   CallbackList pending_callbacks_;
   bool observed_load_area_;
-  bool observed_set_item_;
-  bool observed_remove_item_;
+  int observed_apply_mutations_count_;
   bool observed_clear_area_;
   int observed_connection_id_;
-  base::string16 observed_key_;
-  base::string16 observed_value_;
+  DOMStorageValuesMap observed_mutations_;
   GURL observed_page_url_;
 
  private:
@@ -121,6 +105,7 @@ class DOMStorageCachedAreaTest : public testing::Test {
     : kNamespaceId(10),
       kOrigin("http://dom_storage/"),
       kKey(base::ASCIIToUTF16("key")),
+      kKey2(base::ASCIIToUTF16("key2")),
       kValue(base::ASCIIToUTF16("value")),
       kPageUrl("http://dom_storage/page") {
   }
@@ -128,6 +113,7 @@ class DOMStorageCachedAreaTest : public testing::Test {
   const int64 kNamespaceId;
   const GURL kOrigin;
   const base::string16 kKey;
+  const base::string16 kKey2;
   const base::string16 kValue;
   const GURL kPageUrl;
 
@@ -158,7 +144,13 @@ class DOMStorageCachedAreaTest : public testing::Test {
     cached_area->Reset();
   }
 
+  // Runs the end of the task, which sends the batched changes.
+  void RunPendingTasks() {
+    message_loop_.RunUntilIdle();
+  }
+
  protected:
+  base::MessageLoop message_loop_;
   scoped_refptr<MockProxy> mock_proxy_;
 };
 
@@ -227,17 +219,19 @@ TEST_F(DOMStorageCachedAreaTest, Setters) {
   scoped_refptr<DOMStorageCachedArea> cached_area =
       new DOMStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_.get());
 
-  // SetItem, we expect a call to load followed by a call to set item
-  // in the proxy.
+  // SetItem, we expect a call to load followed by a call to apply the
+  // mutations in the proxy at the end of the task.
   EXPECT_FALSE(IsPrimed(cached_area.get()));
   EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
   EXPECT_TRUE(IsPrimed(cached_area.get()));
   EXPECT_TRUE(mock_proxy_->observed_load_area_);
-  EXPECT_TRUE(mock_proxy_->observed_set_item_);
+  EXPECT_EQ(0, mock_proxy_->observed_apply_mutations_count_);
+  RunPendingTasks();
+  EXPECT_EQ(1, mock_proxy_->observed_apply_mutations_count_);
   EXPECT_EQ(kConnectionId, mock_proxy_->observed_connection_id_);
   EXPECT_EQ(kPageUrl, mock_proxy_->observed_page_url_);
-  EXPECT_EQ(kKey, mock_proxy_->observed_key_);
-  EXPECT_EQ(kValue, mock_proxy_->observed_value_);
+  ASSERT_EQ(1u, mock_proxy_->observed_mutations_.size());
+  EXPECT_EQ(kValue, mock_proxy_->observed_mutations_[kKey].string());
   EXPECT_EQ(2u, mock_proxy_->pending_callbacks_.size());
 
   // Clear, we expect a just the one call to clear in the proxy since
@@ -257,12 +251,13 @@ TEST_F(DOMStorageCachedAreaTest, Setters) {
   cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
   EXPECT_TRUE(IsPrimed(cached_area.get()));
   EXPECT_TRUE(mock_proxy_->observed_load_area_);
-  EXPECT_FALSE(mock_proxy_->observed_remove_item_);
+  RunPendingTasks();
+  EXPECT_EQ(0, mock_proxy_->observed_apply_mutations_count_);
   EXPECT_EQ(kConnectionId, mock_proxy_->observed_connection_id_);
   EXPECT_EQ(1u, mock_proxy_->pending_callbacks_.size());
 
   // RemoveItem with something to remove, expect a call to load followed
-  // by a call to remove.
+  // by a call to apply the removal.
   ResetAll(cached_area.get());
   mock_proxy_->load_area_return_values_[kKey] =
       base::NullableString16(kValue, false);
@@ -270,13 +265,96 @@ TEST_F(DOMStorageCachedAreaTest, Setters) {
   cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
   EXPECT_TRUE(IsPrimed(cached_area.get()));
   EXPECT_TRUE(mock_proxy_->observed_load_area_);
-  EXPECT_TRUE(mock_proxy_->observed_remove_item_);
+  RunPendingTasks();
+  EXPECT_EQ(1, mock_proxy_->observed_apply_mutations_count_);
   EXPECT_EQ(kConnectionId, mock_proxy_->observed_connection_id_);
   EXPECT_EQ(kPageUrl, mock_proxy_->observed_page_url_);
-  EXPECT_EQ(kKey, mock_proxy_->observed_key_);
+  ASSERT_EQ(1u, mock_proxy_->observed_mutations_.size());
+  EXPECT_TRUE(mock_proxy_->observed_mutations_[kKey].is_null());
   EXPECT_EQ(2u, mock_proxy_->pending_callbacks_.size());
 }
 
+TEST_F(DOMStorageCachedAreaTest, MutationsAreBatchedPerTask) {
+  const int kConnectionId = 7;
+  const int kOtherConnectionId = 8;
+  scoped_refptr<DOMStorageCachedArea> cached_area =
+      new DOMStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_.get());
+  EXPECT_EQ(0u, cached_area->GetLength(kConnectionId));
+  mock_proxy_->CompleteAllPendingCallbacks();
+
+  // The changes to a key replace each other, and the keys share a message.
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey2, kValue, kPageUrl));
+  RunPendingTasks();
+  EXPECT_EQ(1, mock_proxy_->observed_apply_mutations_count_);
+  ASSERT_EQ(2u, mock_proxy_->observed_mutations_.size());
+  EXPECT_TRUE(mock_proxy_->observed_mutations_[kKey].is_null());
+  EXPECT_EQ(kValue, mock_proxy_->observed_mutations_[kKey2].string());
+  mock_proxy_->CompleteAllPendingCallbacks();
+  EXPECT_FALSE(IsIgnoringKeyMutations(cached_area.get(), kKey));
+  EXPECT_FALSE(IsIgnoringKeyMutations(cached_area.get(), kKey2));
+
+  // Changes thru another connection are sent in their own message, and
+  // flushing sends them before the end of the task.
+  mock_proxy_->ResetObservations();
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  EXPECT_TRUE(cached_area->SetItem(kOtherConnectionId, kKey, kValue,
+                                   kPageUrl));
+  cached_area->FlushPendingMutations();
+  EXPECT_EQ(2, mock_proxy_->observed_apply_mutations_count_);
+  EXPECT_EQ(kOtherConnectionId, mock_proxy_->observed_connection_id_);
+  RunPendingTasks();
+  EXPECT_EQ(2, mock_proxy_->observed_apply_mutations_count_);
+  mock_proxy_->CompleteOnePendingCallback(true);
+  EXPECT_TRUE(IsIgnoringKeyMutations(cached_area.get(), kKey));
+  mock_proxy_->CompleteOnePendingCallback(true);
+  EXPECT_FALSE(IsIgnoringKeyMutations(cached_area.get(), kKey));
+
+  // A clear drops the changes it overwrites.
+  mock_proxy_->ResetObservations();
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  cached_area->Clear(kConnectionId, kPageUrl);
+  RunPendingTasks();
+  EXPECT_EQ(0, mock_proxy_->observed_apply_mutations_count_);
+  EXPECT_TRUE(mock_proxy_->observed_clear_area_);
+}
+
+TEST_F(DOMStorageCachedAreaTest, LazyLoad) {
+  const int kConnectionId = 7;
+  scoped_refptr<DOMStorageCachedArea> cached_area =
+      new DOMStorageCachedArea(kNamespaceId, kOrigin, mock_proxy_.get());
+  cached_area->set_lazy_load(true);
+
+  // Writing doesn't load the area.
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  cached_area->RemoveItem(kConnectionId, kKey2, kPageUrl);
+  EXPECT_FALSE(IsPrimed(cached_area.get()));
+  RunPendingTasks();
+  EXPECT_FALSE(mock_proxy_->observed_load_area_);
+  EXPECT_EQ(1, mock_proxy_->observed_apply_mutations_count_);
+  EXPECT_EQ(2u, mock_proxy_->observed_mutations_.size());
+  mock_proxy_->CompleteAllPendingCallbacks();
+
+  // Reading does, after sending the changes made so far.
+  mock_proxy_->ResetObservations();
+  EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey2, kValue, kPageUrl));
+  mock_proxy_->load_area_return_values_[kKey2] =
+      base::NullableString16(kValue, false);
+  EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey2).string());
+  EXPECT_TRUE(IsPrimed(cached_area.get()));
+  EXPECT_TRUE(mock_proxy_->observed_load_area_);
+  EXPECT_EQ(1, mock_proxy_->observed_apply_mutations_count_);
+  EXPECT_EQ(2u, mock_proxy_->pending_callbacks_.size());
+
+  // Once primed, the cache is used as usual.
+  mock_proxy_->CompleteAllPendingCallbacks();
+  mock_proxy_->ResetObservations();
+  cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
+  RunPendingTasks();
+  EXPECT_EQ(0, mock_proxy_->observed_apply_mutations_count_);
+}
+
 TEST_F(DOMStorageCachedAreaTest, MutationsAreIgnoredUntilLoadCompletion) {
   const int kConnectionId = 7;
   scoped_refptr<DOMStorageCachedArea> cached_area =
@@ -335,18 +413,22 @@ TEST_F(DOMStorageCachedAreaTest, KeyMutationsAreIgnoredUntilCompletion) {
   cached_area->ApplyMutation(base::NullableString16(kKey, false),
                              base::NullableString16());
   EXPECT_EQ(kValue, cached_area->GetItem(kConnectionId, kKey).string());
+  RunPendingTasks();
   mock_proxy_->CompleteOnePendingCallback(true);  // set completion
   EXPECT_FALSE(IsIgnoringKeyMutations(cached_area.get(), kKey));
 
   // RemoveItem
   cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
   EXPECT_TRUE(IsIgnoringKeyMutations(cached_area.get(), kKey));
+  RunPendingTasks();
   mock_proxy_->CompleteOnePendingCallback(true);  // remove completion
   EXPECT_FALSE(IsIgnoringKeyMutations(cached_area.get(), kKey));
 
-  // Multiple mutations to the same key.
+  // Multiple mutations to the same key in different tasks.
   EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
+  RunPendingTasks();
   cached_area->RemoveItem(kConnectionId, kKey, kPageUrl);
+  RunPendingTasks();
   EXPECT_TRUE(IsIgnoringKeyMutations(cached_area.get(), kKey));
   mock_proxy_->CompleteOnePendingCallback(true);  // set completion
   EXPECT_TRUE(IsIgnoringKeyMutations(cached_area.get(), kKey));
@@ -356,6 +438,7 @@ TEST_F(DOMStorageCachedAreaTest, KeyMutationsAreIgnoredUntilCompletion) {
   // A failed set item operation should Reset the cache.
   EXPECT_TRUE(cached_area->SetItem(kConnectionId, kKey, kValue, kPageUrl));
   EXPECT_TRUE(IsIgnoringKeyMutations(cached_area.get(), kKey));
+  RunPendingTasks();
   mock_proxy_->CompleteOnePendingCallback(false);
   EXPECT_FALSE(IsPrimed(cached_area.get()));
 }
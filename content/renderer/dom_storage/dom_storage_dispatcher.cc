@@ -7,10 +7,12 @@
 #include <list>
 #include <map>
 
+#include "base/command_line.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/synchronization/lock.h"
 #include "content/common/dom_storage/dom_storage_messages.h"
 #include "content/common/dom_storage/dom_storage_types.h"
+#include "content/public/common/content_switches.h"
 #include "content/renderer/dom_storage/dom_storage_cached_area.h"
 #include "content/renderer/dom_storage/dom_storage_proxy.h"
 #include "content/renderer/dom_storage/webstoragearea_impl.h"
@@ -60,8 +62,7 @@ void MessageThrottlingFilter::SendThrottled(IPC::Message* message) {
   // Should only be used for sending of messages which will be acknowledged
   // with a separate DOMStorageMsg_AsyncOperationComplete message.
   DCHECK(message->type() == DOMStorageHostMsg_LoadStorageArea::ID ||
-         message->type() == DOMStorageHostMsg_SetItem::ID ||
-         message->type() == DOMStorageHostMsg_RemoveItem::ID ||
+         message->type() == DOMStorageHostMsg_ApplyMutations::ID ||
          message->type() == DOMStorageHostMsg_Clear::ID);
   DCHECK(sender_);
   if (!sender_) {
@@ -111,14 +112,12 @@ class DomStorageDispatcher::ProxyImpl : public DOMStorageProxy {
   virtual void LoadArea(int connection_id, DOMStorageValuesMap* values,
                         bool* send_log_get_messages,
                         const CompletionCallback& callback) OVERRIDE;
-  virtual void SetItem(int connection_id, const base::string16& key,
-                       const base::string16& value, const GURL& page_url,
-                       const CompletionCallback& callback) OVERRIDE;
+  virtual void ApplyMutations(int connection_id,
+                              const DOMStorageValuesMap& mutations,
+                              const GURL& page_url,
+                              const CompletionCallback& callback) OVERRIDE;
   virtual void LogGetItem(int connection_id, const base::string16& key,
                           const base::NullableString16& value) OVERRIDE;
-  virtual void RemoveItem(int connection_id, const base::string16& key,
-                          const GURL& page_url,
-                          const CompletionCallback& callback) OVERRIDE;
   virtual void ClearArea(int connection_id,
                         const GURL& page_url,
                         const CompletionCallback& callback) OVERRIDE;
@@ -172,11 +171,14 @@ class DomStorageDispatcher::ProxyImpl : public DOMStorageProxy {
   CachedAreaMap cached_areas_;
   CallbackList pending_callbacks_;
   scoped_refptr<MessageThrottlingFilter> throttling_filter_;
+  bool lazy_load_;
 };
 
 DomStorageDispatcher::ProxyImpl::ProxyImpl(RenderThreadImpl* sender)
     : sender_(sender),
-      throttling_filter_(new MessageThrottlingFilter(sender)) {
+      throttling_filter_(new MessageThrottlingFilter(sender)),
+      lazy_load_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableLocalStorageLazyLoad)) {
   sender_->AddFilter(throttling_filter_.get());
 }
 
@@ -189,6 +191,7 @@ DOMStorageCachedArea* DomStorageDispatcher::ProxyImpl::OpenCachedArea(
   }
   scoped_refptr<DOMStorageCachedArea> area =
       new DOMStorageCachedArea(namespace_id, origin, this);
+  area->set_lazy_load(lazy_load_);
   cached_areas_[key] = CachedAreaHolder(area.get(), 1, namespace_id);
   return area.get();
 }
@@ -243,13 +246,12 @@ void DomStorageDispatcher::ProxyImpl::LoadArea(
       connection_id, values, send_log_get_messages));
 }
 
-void DomStorageDispatcher::ProxyImpl::SetItem(
-    int connection_id, const base::string16& key,
-    const base::string16& value, const GURL& page_url,
-    const CompletionCallback& callback) {
+void DomStorageDispatcher::ProxyImpl::ApplyMutations(
+    int connection_id, const DOMStorageValuesMap& mutations,
+    const GURL& page_url, const CompletionCallback& callback) {
   PushPendingCallback(callback);
-  throttling_filter_->SendThrottled(new DOMStorageHostMsg_SetItem(
-      connection_id, key, value, page_url));
+  throttling_filter_->SendThrottled(new DOMStorageHostMsg_ApplyMutations(
+      connection_id, mutations, page_url));
 }
 
 void DomStorageDispatcher::ProxyImpl::LogGetItem(
@@ -258,14 +260,6 @@ void DomStorageDispatcher::ProxyImpl::LogGetItem(
   sender_->Send(new DOMStorageHostMsg_LogGetItem(connection_id, key, value));
 }
 
-void DomStorageDispatcher::ProxyImpl::RemoveItem(
-    int connection_id, const base::string16& key,  const GURL& page_url,
-    const CompletionCallback& callback) {
-  PushPendingCallback(callback);
-  throttling_filter_->SendThrottled(new DOMStorageHostMsg_RemoveItem(
-      connection_id, key, page_url));
-}
-
 void DomStorageDispatcher::ProxyImpl::ClearArea(int connection_id,
                       const GURL& page_url,
                       const CompletionCallback& callback) {
@@ -294,6 +288,8 @@ scoped_refptr<DOMStorageCachedArea> DomStorageDispatcher::OpenCachedArea(
 
 void DomStorageDispatcher::CloseCachedArea(
     int connection_id, DOMStorageCachedArea* area) {
+  // The browser drops the changes sent thru a closed connection.
+  area->FlushPendingMutations();
   RenderThreadImpl::current()->Send(
       new DOMStorageHostMsg_CloseStorageArea(connection_id));
   proxy_->CloseCachedArea(area);
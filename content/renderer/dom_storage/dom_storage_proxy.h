@@ -24,21 +24,17 @@ class DOMStorageProxy : public base::RefCounted<DOMStorageProxy> {
                         bool* send_log_get_messages,
                         const CompletionCallback& callback) = 0;
 
-  virtual void SetItem(int connection_id,
-                       const base::string16& key,
-                       const base::string16& value,
-                       const GURL& page_url,
-                       const CompletionCallback& callback) = 0;
+  // Sets the keys of |mutations| to their values, removing those whose
+  // value is null.
+  virtual void ApplyMutations(int connection_id,
+                              const DOMStorageValuesMap& mutations,
+                              const GURL& page_url,
+                              const CompletionCallback& callback) = 0;
 
   virtual void LogGetItem(int connection_id,
                           const base::string16& key,
                           const base::NullableString16& value) = 0;
 
-  virtual void RemoveItem(int connection_id,
-                          const base::string16& key,
-                          const GURL& page_url,
-                          const CompletionCallback& callback) = 0;
-
   virtual void ClearArea(int connection_id,
                          const GURL& page_url,
                          const CompletionCallback& callback) = 0;
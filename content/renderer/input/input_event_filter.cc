@@ -108,7 +108,33 @@ InputEventFilter::~InputEventFilter() {
 }
 
 void InputEventFilter::ForwardToMainListener(const IPC::Message& message) {
-  main_listener_->OnMessageReceived(message);
+  DCHECK(target_loop_->BelongsToCurrentThread());
+
+  {
+    base::AutoLock locked(main_listener_messages_lock_);
+    main_listener_messages_.push_back(message);
+    if (main_listener_messages_.size() > 1)
+      return;
+  }
+
+  main_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&InputEventFilter::DeliverMainListenerMessages, this));
+}
+
+void InputEventFilter::DeliverMainListenerMessages() {
+  DCHECK(main_loop_->BelongsToCurrentThread());
+
+  std::deque<IPC::Message> messages;
+  {
+    base::AutoLock locked(main_listener_messages_lock_);
+    messages.swap(main_listener_messages_);
+  }
+
+  TRACE_EVENT1("input", "InputEventFilter::DeliverMainListenerMessages",
+               "count", messages.size());
+  for (size_t i = 0; i < messages.size(); ++i)
+    main_listener_->OnMessageReceived(messages[i]);
 }
 
 void InputEventFilter::ForwardToHandler(const IPC::Message& message) {
@@ -116,10 +142,7 @@ void InputEventFilter::ForwardToHandler(const IPC::Message& message) {
   DCHECK(target_loop_->BelongsToCurrentThread());
 
   if (message.type() != InputMsg_HandleInputEvent::ID) {
-    main_loop_->PostTask(
-        FROM_HERE,
-        base::Bind(&InputEventFilter::ForwardToMainListener,
-                   this, message));
+    ForwardToMainListener(message);
     return;
   }
 
@@ -136,12 +159,8 @@ void InputEventFilter::ForwardToHandler(const IPC::Message& message) {
 
   if (ack == INPUT_EVENT_ACK_STATE_NOT_CONSUMED) {
     TRACE_EVENT0("input", "InputEventFilter::ForwardToHandler");
-    IPC::Message new_msg = InputMsg_HandleInputEvent(
-        routing_id, event, latency_info, is_keyboard_shortcut);
-    main_loop_->PostTask(
-        FROM_HERE,
-        base::Bind(&InputEventFilter::ForwardToMainListener,
-                   this, new_msg));
+    ForwardToMainListener(InputMsg_HandleInputEvent(
+        routing_id, event, latency_info, is_keyboard_shortcut));
     return;
   }
 
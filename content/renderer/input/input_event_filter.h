@@ -5,6 +5,7 @@
 #ifndef CONTENT_RENDERER_INPUT_INPUT_EVENT_FILTER_H_
 #define CONTENT_RENDERER_INPUT_INPUT_EVENT_FILTER_H_
 
+#include <deque>
 #include <queue>
 #include <set>
 
@@ -61,7 +62,12 @@ class CONTENT_EXPORT InputEventFilter
   friend class IPC::ChannelProxy::MessageFilter;
   virtual ~InputEventFilter();
 
+  // Queues |message| for the main thread. The messages queued before the
+  // main thread gets to them are delivered together, so that input which
+  // arrives while it is busy isn't spread out behind the tasks posted to it
+  // meanwhile.
   void ForwardToMainListener(const IPC::Message& message);
+  void DeliverMainListenerMessages();
   void ForwardToHandler(const IPC::Message& message);
   void SendACK(blink::WebInputEvent::Type type,
                InputEventAckState ack_result,
@@ -87,6 +93,13 @@ class CONTENT_EXPORT InputEventFilter
   // Indicates the routing_ids for which input events should be filtered.
   std::set<int> routes_;
 
+  // Protects access to main_listener_messages_.
+  base::Lock main_listener_messages_lock_;
+
+  // The messages waiting to be delivered to main_listener_, in order. A task
+  // to deliver them is posted to main_loop_ whenever this isn't empty.
+  std::deque<IPC::Message> main_listener_messages_;
+
   // Specifies whether overscroll notifications are forwarded to the host.
   bool overscroll_notifications_enabled_;
 };
@@ -119,6 +119,16 @@ void AddEventsToFilter(IPC::ChannelProxy::MessageFilter* message_filter,
   AddMessagesToFilter(message_filter, messages);
 }
 
+void RecordMessageCount(const IPCMessageRecorder* recorder, size_t* count) {
+  *count = recorder->message_count();
+}
+
+void PostRecordMessageCount(const IPCMessageRecorder* recorder,
+                            size_t* count) {
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&RecordMessageCount, recorder, count));
+}
+
 }  // namespace
 
 class InputEventFilterTest : public testing::Test {
@@ -300,4 +310,34 @@ TEST_F(InputEventFilterTest, PreserveRelativeOrder) {
   }
 }
 
+TEST_F(InputEventFilterTest, DeliverQueuedMessagesTogether) {
+  filter_->DidAddInputHandler(kTestRoutingID, NULL);
+  event_recorder_.set_send_to_widget(true);
+
+  WebMouseEvent mouse_move =
+      SyntheticWebMouseEventBuilder::Build(WebMouseEvent::MouseMove, 10, 10, 0);
+  WebMouseEvent mouse_down =
+      SyntheticWebMouseEventBuilder::Build(WebMouseEvent::MouseDown);
+
+  // The mouse down is queued for the main thread after another task was
+  // posted to it, while the mouse move still waits to be delivered. It is
+  // delivered along with the mouse move rather than after that task.
+  size_t message_count = 0;
+  filter_->OnMessageReceived(InputMsg_HandleInputEvent(
+      kTestRoutingID, &mouse_move, ui::LatencyInfo(), false));
+  message_loop_.PostTask(
+      FROM_HERE,
+      base::Bind(&PostRecordMessageCount, &message_recorder_, &message_count));
+  filter_->OnMessageReceived(InputMsg_HandleInputEvent(
+      kTestRoutingID, &mouse_down, ui::LatencyInfo(), false));
+  message_loop_.RunUntilIdle();
+
+  EXPECT_EQ(2U, message_count);
+  ASSERT_EQ(2U, message_recorder_.message_count());
+  EXPECT_EQ(InputMsg_HandleInputEvent::ID,
+            message_recorder_.message_at(0).type());
+  EXPECT_EQ(InputMsg_HandleInputEvent::ID,
+            message_recorder_.message_at(1).type());
+}
+
 }  // namespace content
@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/memory/shared_memory.h"
 #include "base/message_loop/message_loop.h"
 #include "cc/resources/texture_mailbox.h"
 #include "content/public/renderer/render_thread.h"
@@ -619,9 +620,26 @@ int32_t PepperGraphics2DHost::OnHostMsgReadImageData(
   return ReadImageData(image, &top_left) ? PP_OK : PP_ERROR_FAILED;
 }
 
-void ReleaseCallback(scoped_ptr<base::SharedMemory> memory,
-                     uint32 sync_point,
-                     bool lost_resource) {}
+// static
+void PepperGraphics2DHost::ReleaseBitmap(
+    base::WeakPtr<PepperGraphics2DHost> host,
+    const gfx::Size& size,
+    scoped_ptr<base::SharedMemory> memory,
+    uint32 sync_point,
+    bool lost_resource) {
+  if (!host)
+    return;
+  BitmapStaleRects::iterator it =
+      host->bitmaps_in_compositor_.find(memory.get());
+  DCHECK(it != host->bitmaps_in_compositor_.end());
+  gfx::Rect stale_rect = it->second;
+  host->bitmaps_in_compositor_.erase(it);
+  if (lost_resource)
+    return;
+  host->cached_bitmap_ = memory.Pass();
+  host->cached_bitmap_size_ = size;
+  host->cached_bitmap_stale_rect_ = stale_rect;
+}
 
 bool PepperGraphics2DHost::PrepareTextureMailbox(
     cc::TextureMailbox* mailbox,
@@ -630,18 +648,55 @@ bool PepperGraphics2DHost::PrepareTextureMailbox(
     return false;
   // TODO(jbauman): Send image_data_ through mailbox to avoid copy.
   gfx::Size pixel_image_size(image_data_->width(), image_data_->height());
-  int buffer_size = pixel_image_size.GetArea() * 4;
-  scoped_ptr<base::SharedMemory> memory =
-      RenderThread::Get()->HostAllocateSharedMemoryBuffer(buffer_size);
-  if (!memory || !memory->Map(buffer_size))
-    return false;
-  void* src = image_data_->Map();
-  memcpy(memory->memory(), src, buffer_size);
-  image_data_->Unmap();
+  gfx::Rect damage = gfx::IntersectRects(damage_since_last_mailbox_,
+                                         gfx::Rect(pixel_image_size));
+  damage_since_last_mailbox_ = gfx::Rect();
+  for (BitmapStaleRects::iterator it = bitmaps_in_compositor_.begin();
+       it != bitmaps_in_compositor_.end(); ++it)
+    it->second.Union(damage);
+  cached_bitmap_stale_rect_.Union(damage);
+
+  // Reusing the bitmap the compositor gave back saves allocating one, which
+  // is a synchronous IPC to the browser, and only the parts painted since it
+  // was filled need to be copied into it.
+  scoped_ptr<base::SharedMemory> memory;
+  gfx::Rect copy_rect(pixel_image_size);
+  if (cached_bitmap_ && cached_bitmap_size_ == pixel_image_size) {
+    memory = cached_bitmap_.Pass();
+    copy_rect = cached_bitmap_stale_rect_;
+  } else {
+    int buffer_size = pixel_image_size.GetArea() * 4;
+    memory = RenderThread::Get()->HostAllocateSharedMemoryBuffer(buffer_size);
+    if (!memory || !memory->Map(buffer_size))
+      return false;
+  }
+  cached_bitmap_.reset();
+  cached_bitmap_stale_rect_ = gfx::Rect();
+
+  if (!copy_rect.IsEmpty()) {
+    int row_bytes = pixel_image_size.width() * 4;
+    int offset = copy_rect.y() * row_bytes + copy_rect.x() * 4;
+    const uint8* src = static_cast<const uint8*>(image_data_->Map()) + offset;
+    uint8* dest = static_cast<uint8*>(memory->memory()) + offset;
+    if (copy_rect.width() == pixel_image_size.width()) {
+      memcpy(dest, src, copy_rect.height() * row_bytes);
+    } else {
+      for (int y = 0; y < copy_rect.height(); ++y) {
+        memcpy(dest, src, copy_rect.width() * 4);
+        src += row_bytes;
+        dest += row_bytes;
+      }
+    }
+    image_data_->Unmap();
+  }
 
+  bitmaps_in_compositor_[memory.get()] = gfx::Rect();
   *mailbox = cc::TextureMailbox(memory.get(), pixel_image_size);
   *release_callback = cc::SingleReleaseCallback::Create(
-      base::Bind(&ReleaseCallback, base::Passed(&memory)));
+      base::Bind(&PepperGraphics2DHost::ReleaseBitmap,
+                 AsWeakPtr(),
+                 pixel_image_size,
+                 base::Passed(&memory)));
   texture_mailbox_modified_ = false;
   return true;
 }
@@ -690,6 +745,7 @@ int32_t PepperGraphics2DHost::Flush(PP_Resource* old_image_data,
         op_rect = gfx::Rect(image_data_->width(), image_data_->height());
         break;
     }
+    damage_since_last_mailbox_.Union(op_rect);
 
     op_rect.Offset(plugin_offset_.x(), plugin_offset_.y());
 
@@ -5,10 +5,12 @@
 #ifndef CONTENT_RENDERER_PEPPER_PEPPER_GRAPHICS_2D_HOST_H_
 #define CONTENT_RENDERER_PEPPER_PEPPER_GRAPHICS_2D_HOST_H_
 
+#include <map>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "content/common/content_export.h"
 #include "ppapi/c/dev/ppb_graphics_2d_dev.h"
@@ -17,17 +19,18 @@
 #include "ppapi/host/resource_host.h"
 #include "third_party/WebKit/public/platform/WebCanvas.h"
 #include "ui/gfx/point.h"
+#include "ui/gfx/rect.h"
 #include "ui/gfx/size.h"
 
+namespace base {
+class SharedMemory;
+}
+
 namespace cc {
 class SingleReleaseCallback;
 class TextureMailbox;
 }
 
-namespace gfx {
-class Rect;
-}
-
 namespace ppapi {
 struct ViewData;
 }
@@ -168,6 +171,14 @@ class CONTENT_EXPORT PepperGraphics2DHost
                                      gfx::Rect* op_rect,
                                      gfx::Point* delta);
 
+  // Called when the compositor is done with a bitmap made by
+  // PrepareTextureMailbox, which keeps it for the next one.
+  static void ReleaseBitmap(base::WeakPtr<PepperGraphics2DHost> host,
+                            const gfx::Size& size,
+                            scoped_ptr<base::SharedMemory> memory,
+                            uint32 sync_point,
+                            bool lost_resource);
+
   RendererPpapiHost* renderer_ppapi_host_;
 
   scoped_refptr<PPB_ImageData_Impl> image_data_;
@@ -204,6 +215,21 @@ class CONTENT_EXPORT PepperGraphics2DHost
   bool texture_mailbox_modified_;
   bool is_using_texture_layer_;
 
+  // The part of |image_data_| painted since the last PrepareTextureMailbox
+  // call, in image coordinates.
+  gfx::Rect damage_since_last_mailbox_;
+
+  // The bitmaps the compositor holds, each mapped to the part of it which is
+  // out of date with |image_data_|.
+  typedef std::map<base::SharedMemory*, gfx::Rect> BitmapStaleRects;
+  BitmapStaleRects bitmaps_in_compositor_;
+
+  // The bitmap last given back by the compositor, which the next mailbox
+  // reuses if it is still the right size.
+  scoped_ptr<base::SharedMemory> cached_bitmap_;
+  gfx::Size cached_bitmap_size_;
+  gfx::Rect cached_bitmap_stale_rect_;
+
   // The offset into the plugin area at which to draw the contents of the
   // graphics context.
   gfx::Point plugin_offset_;
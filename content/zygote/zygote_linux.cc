@@ -7,6 +7,7 @@
 #include <fcntl.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/sysinfo.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
@@ -20,11 +21,13 @@
 #include "base/posix/global_descriptors.h"
 #include "base/posix/unix_domain_socket_linux.h"
 #include "base/process/kill.h"
+#include "base/strings/string_number_conversions.h"
 #include "content/common/child_process_sandbox_support_impl_linux.h"
 #include "content/common/sandbox_linux/sandbox_linux.h"
 #include "content/common/set_process_title.h"
 #include "content/common/zygote_commands_linux.h"
 #include "content/public/common/content_descriptors.h"
+#include "content/public/common/content_switches.h"
 #include "content/public/common/result_codes.h"
 #include "content/public/common/sandbox_linux.h"
 #include "content/public/common/zygote_fork_delegate_linux.h"
@@ -49,6 +52,24 @@ int LookUpFd(const base::GlobalDescriptors::Mapping& fd_mapping, uint32_t key) {
   return -1;
 }
 
+// The number of renderers kept forked ahead of time, unless overridden by
+// --renderer-pool-size.
+const size_t kDefaultRendererPoolSize = 1;
+
+// Pooled renderers aren't forked while less memory than this is available.
+const uint64 kMinAvailableMemoryForPool = 256 * 1024 * 1024;
+
+// Returns whether there is enough memory for one more pooled renderer. This
+// asks the kernel directly, as /proc may not be visible in the sandbox.
+bool HasMemoryForPooledRenderer() {
+  struct sysinfo info;
+  if (sysinfo(&info) != 0)
+    return false;
+  uint64 available = (static_cast<uint64>(info.freeram) + info.bufferram) *
+                     info.mem_unit;
+  return available >= kMinAvailableMemoryForPool;
+}
+
 }  // namespace
 
 Zygote::Zygote(int sandbox_flags,
@@ -56,12 +77,21 @@ Zygote::Zygote(int sandbox_flags,
     : sandbox_flags_(sandbox_flags),
       helper_(helper),
       initial_uma_sample_(0),
-      initial_uma_boundary_value_(0) {
+      initial_uma_boundary_value_(0),
+      renderer_pool_size_(kDefaultRendererPoolSize) {
   if (helper_) {
     helper_->InitialUMA(&initial_uma_name_,
                         &initial_uma_sample_,
                         &initial_uma_boundary_value_);
   }
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switches::kRendererPoolSize) &&
+      !base::StringToSizeT(
+          command_line.GetSwitchValueASCII(switches::kRendererPoolSize),
+          &renderer_pool_size_)) {
+    LOG(WARNING) << "Invalid --" << switches::kRendererPoolSize;
+    renderer_pool_size_ = kDefaultRendererPoolSize;
+  }
 }
 
 Zygote::~Zygote() {
@@ -100,7 +130,9 @@ bool Zygote::ProcessRequests() {
   }
 
   for (;;) {
-    // This function call can return multiple times, once per fork().
+    // These function calls can return multiple times, once per fork().
+    if (FillRendererPool())
+      return true;
     if (HandleRequestFromBrowser(kZygoteSocketPairFd))
       return true;
   }
@@ -428,49 +460,77 @@ int Zygote::ForkWithRealPid(const std::string& process_type,
   return -1;
 }
 
-base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
-                                        PickleIterator iter,
-                                        std::vector<int>& fds,
-                                        std::string* uma_name,
-                                        int* uma_sample,
-                                        int* uma_boundary_value) {
-  std::vector<std::string> args;
+bool Zygote::ReadArgs(const Pickle& pickle,
+                      PickleIterator iter,
+                      const std::vector<int>& fds,
+                      std::string* process_type,
+                      std::vector<std::string>* args,
+                      base::GlobalDescriptors::Mapping* mapping,
+                      std::string* channel_id) {
   int argc = 0;
   int numfds = 0;
-  base::GlobalDescriptors::Mapping mapping;
-  std::string process_type;
-  std::string channel_id;
   const std::string channel_id_prefix = std::string("--")
       + switches::kProcessChannelID + std::string("=");
 
-  if (!pickle.ReadString(&iter, &process_type))
-    return -1;
+  if (!pickle.ReadString(&iter, process_type))
+    return false;
   if (!pickle.ReadInt(&iter, &argc))
-    return -1;
+    return false;
 
   for (int i = 0; i < argc; ++i) {
     std::string arg;
     if (!pickle.ReadString(&iter, &arg))
-      return -1;
-    args.push_back(arg);
+      return false;
+    args->push_back(arg);
     if (arg.compare(0, channel_id_prefix.length(), channel_id_prefix) == 0)
-      channel_id = arg;
+      *channel_id = arg;
   }
 
   if (!pickle.ReadInt(&iter, &numfds))
-    return -1;
+    return false;
   if (numfds != static_cast<int>(fds.size()))
-    return -1;
+    return false;
 
   for (int i = 0; i < numfds; ++i) {
     base::GlobalDescriptors::Key key;
     if (!pickle.ReadUInt32(&iter, &key))
-      return -1;
-    mapping.push_back(std::make_pair(key, fds[i]));
+      return false;
+    mapping->push_back(std::make_pair(key, fds[i]));
   }
 
-  mapping.push_back(std::make_pair(
+  mapping->push_back(std::make_pair(
       static_cast<uint32_t>(kSandboxIPCChannel), GetSandboxFD()));
+  return true;
+}
+
+void Zygote::SetUpChild(const std::vector<std::string>& args,
+                        const base::GlobalDescriptors::Mapping& mapping) {
+  base::GlobalDescriptors::GetInstance()->Reset(mapping);
+
+  // Reset the process-wide command line to our new command line.
+  CommandLine::Reset();
+  CommandLine::Init(0, NULL);
+  CommandLine::ForCurrentProcess()->InitFromArgv(args);
+
+  // Update the process title. The argv was already cached by the call to
+  // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
+  // (we don't have the original argv at this point).
+  SetProcessTitleFromCommandLine(NULL);
+}
+
+base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
+                                        PickleIterator iter,
+                                        std::vector<int>& fds,
+                                        std::string* uma_name,
+                                        int* uma_sample,
+                                        int* uma_boundary_value) {
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string process_type;
+  std::string channel_id;
+  if (!ReadArgs(pickle, iter, fds, &process_type, &args, &mapping,
+                &channel_id))
+    return -1;
 
   // Returns twice, once per process.
   base::ProcessId child_pid = ForkWithRealPid(process_type, mapping, channel_id,
@@ -482,20 +542,14 @@ base::ProcessId Zygote::ReadArgsAndFork(const Pickle& pickle,
     close(kZygoteSocketPairFd);  // Our socket from the browser.
     if (UsingSUIDSandbox())
       close(kZygoteIdFd);  // Another socket from the browser.
-    base::GlobalDescriptors::GetInstance()->Reset(mapping);
-
-    // Reset the process-wide command line to our new command line.
-    CommandLine::Reset();
-    CommandLine::Init(0, NULL);
-    CommandLine::ForCurrentProcess()->InitFromArgv(args);
-
-    // Update the process title. The argv was already cached by the call to
-    // SetProcessTitleFromCommandLine in ChromeMain, so we can pass NULL here
-    // (we don't have the original argv at this point).
-    SetProcessTitleFromCommandLine(NULL);
+    // The sockets of the pooled renderers.
+    for (size_t i = 0; i < renderer_pool_.size(); ++i)
+      close(renderer_pool_[i].fd);
+    renderer_pool_.clear();
+    SetUpChild(args, mapping);
   } else if (child_pid < 0) {
     LOG(ERROR) << "Zygote could not fork: process_type " << process_type
-        << " numfds " << numfds << " child_pid " << child_pid;
+        << " numfds " << fds.size() << " child_pid " << child_pid;
   }
   return child_pid;
 }
@@ -507,9 +561,17 @@ bool Zygote::HandleForkRequest(int fd,
   std::string uma_name;
   int uma_sample;
   int uma_boundary_value;
-  base::ProcessId child_pid = ReadArgsAndFork(pickle, iter, fds,
-                                              &uma_name, &uma_sample,
-                                              &uma_boundary_value);
+  base::ProcessId child_pid = -1;
+  std::string process_type;
+  PickleIterator process_type_iter(iter);
+  if (pickle.ReadString(&process_type_iter, &process_type) &&
+      process_type == switches::kRendererProcess) {
+    child_pid = TakePooledRenderer(pickle, fds);
+  }
+  if (child_pid < 0) {
+    child_pid = ReadArgsAndFork(pickle, iter, fds, &uma_name, &uma_sample,
+                                &uma_boundary_value);
+  }
   if (child_pid == 0)
     return true;
   for (std::vector<int>::const_iterator
@@ -549,4 +611,92 @@ bool Zygote::HandleGetSandboxStatus(int fd,
   return false;
 }
 
+bool Zygote::FillRendererPool() {
+  while (renderer_pool_.size() < renderer_pool_size_ &&
+         HasMemoryForPooledRenderer()) {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != 0) {
+      PLOG(ERROR) << "socketpair";
+      return false;
+    }
+
+    // Renderers aren't forked by the helper, so there is no UMA report.
+    std::string uma_name;
+    int uma_sample;
+    int uma_boundary_value;
+    base::ProcessId real_pid = ForkWithRealPid(
+        switches::kRendererProcess, base::GlobalDescriptors::Mapping(),
+        std::string(), &uma_name, &uma_sample, &uma_boundary_value);
+    if (real_pid == 0) {
+      close(sockets[0]);
+      WaitForRendererRequest(sockets[1]);
+      return true;
+    }
+    close(sockets[1]);
+    if (real_pid < 0) {
+      close(sockets[0]);
+      return false;
+    }
+    PooledRenderer renderer = { real_pid, sockets[0] };
+    renderer_pool_.push_back(renderer);
+  }
+  return false;
+}
+
+void Zygote::WaitForRendererRequest(int fd) {
+  // Close the sockets of the zygote, so that the renderer can't act as it,
+  // and so that their numbers are free for the descriptors it will get.
+  close(kZygoteSocketPairFd);
+  if (UsingSUIDSandbox())
+    close(kZygoteIdFd);
+  for (size_t i = 0; i < renderer_pool_.size(); ++i)
+    close(renderer_pool_[i].fd);
+  renderer_pool_.clear();
+
+  std::vector<int> fds;
+  char buf[kZygoteMaxMessageLength];
+  const ssize_t len = UnixDomainSocket::RecvMsg(fd, buf, sizeof(buf), &fds);
+  if (len <= 0) {
+    // The zygote exited without handing out this renderer.
+    _exit(0);
+  }
+  close(fd);
+
+  Pickle pickle(buf, len);
+  PickleIterator iter(pickle);
+  int kind;
+  std::string process_type;
+  std::vector<std::string> args;
+  base::GlobalDescriptors::Mapping mapping;
+  std::string channel_id;
+  if (!pickle.ReadInt(&iter, &kind) || kind != kZygoteCommandFork ||
+      !ReadArgs(pickle, iter, fds, &process_type, &args, &mapping,
+                &channel_id)) {
+    LOG(FATAL) << "Invalid fork request for pooled renderer";
+  }
+  DCHECK_EQ(switches::kRendererProcess, process_type);
+  SetUpChild(args, mapping);
+}
+
+base::ProcessId Zygote::TakePooledRenderer(const Pickle& pickle,
+                                           const std::vector<int>& fds) {
+  while (!renderer_pool_.empty()) {
+    PooledRenderer renderer = renderer_pool_.front();
+    renderer_pool_.erase(renderer_pool_.begin());
+    bool sent = UnixDomainSocket::SendMsg(renderer.fd, pickle.data(),
+                                          pickle.size(), fds);
+    close(renderer.fd);
+    if (sent)
+      return renderer.real_pid;
+
+    // The renderer died in the pool, and the browser never heard of it.
+    LOG(WARNING) << "Pooled renderer " << renderer.real_pid << " is gone";
+    base::TerminationStatus status;
+    int exit_code;
+    GetTerminationStatus(renderer.real_pid, true /* known_dead */, &status,
+                         &exit_code);
+  }
+  return -1;
+}
+
 }  // namespace content
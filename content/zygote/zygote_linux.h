@@ -42,6 +42,15 @@ class Zygote {
   typedef base::SmallMap< std::map<base::ProcessHandle, ZygoteProcessInfo> >
       ZygoteProcessMap;
 
+  // A renderer forked ahead of time, which waits for the fork request it
+  // is handed on its own socket.
+  struct PooledRenderer {
+    // Pid as it appears outside of the sandbox.
+    base::ProcessId real_pid;
+    // The zygote's end of the socket.
+    int fd;
+  };
+
   // Retrieve a ZygoteProcessInfo from the process_info_map_.
   // Returns true and write to process_info if |pid| can be found, return
   // false otherwise.
@@ -84,6 +93,21 @@ class Zygote {
                       int* uma_sample,
                       int* uma_boundary_value);
 
+  // Unpacks the arguments of a fork request from |pickle|, and the mapping
+  // of |fds| to their keys. Returns false if the request is malformed.
+  bool ReadArgs(const Pickle& pickle,
+                PickleIterator iter,
+                const std::vector<int>& fds,
+                std::string* process_type,
+                std::vector<std::string>* args,
+                base::GlobalDescriptors::Mapping* mapping,
+                std::string* channel_id);
+
+  // In a newly forked process, installs |mapping| and the command line of
+  // |args|, once the sockets of the zygote are closed.
+  void SetUpChild(const std::vector<std::string>& args,
+                  const base::GlobalDescriptors::Mapping& mapping);
+
   // Unpacks process type and arguments from |pickle| and forks a new process.
   // Returns -1 on error, otherwise returns twice, returning 0 to the child
   // process and the child process ID to the parent process, like fork().
@@ -107,6 +131,24 @@ class Zygote {
                               const Pickle& pickle,
                               PickleIterator iter);
 
+  // ---------------------------------------------------------------------------
+  // The pool of renderers forked ahead of time, which takes the fork out of
+  // the time it takes to start a renderer.
+
+  // Forks renderers until the pool is full, or memory is short. Returns true
+  // in a pooled renderer once it got its fork request, and thus needs to
+  // unwind back into ChromeMain.
+  bool FillRendererPool();
+
+  // In a pooled renderer, waits for the fork request on |fd| and sets up the
+  // process for it. Exits if the zygote exits first.
+  void WaitForRendererRequest(int fd);
+
+  // Hands the fork request in |pickle|, with its |fds|, to a pooled renderer.
+  // Returns the PID of the renderer, or -1 if there is none.
+  base::ProcessId TakePooledRenderer(const Pickle& pickle,
+                                     const std::vector<int>& fds);
+
   // The Zygote needs to keep some information about each process. Most
   // notably what the PID of the process is inside the PID namespace of
   // the Zygote and whether or not a process was started by the
@@ -121,6 +163,10 @@ class Zygote {
   std::string initial_uma_name_;
   int initial_uma_sample_;
   int initial_uma_boundary_value_;
+
+  // The pooled renderers, oldest first, and how many to keep.
+  std::vector<PooledRenderer> renderer_pool_;
+  size_t renderer_pool_size_;
 };
 
 }  // namespace content
@@ -141,6 +141,34 @@
       # TODO(jschuh): crbug.com/167187 fix size_t to int truncations.
       'msvs_disabled_warnings': [4267, ],
     },
+    {
+      'target_name': 'courgette_perftests',
+      'type': 'executable',
+      'sources': [
+        'base_test_unittest.cc',
+        'base_test_unittest.h',
+        'ensemble_create_perftest.cc',
+      ],
+      'dependencies': [
+        'courgette_lib',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'conditions': [
+        [ 'toolkit_uses_gtk == 1', {
+          'dependencies': [
+            # Workaround for gyp bug 69.
+            # Needed to handle the #include chain:
+            #   base/test_suite.h
+            #   gtk/gtk.h
+            '../build/linux/system.gyp:gtk',
+          ],
+        }],
+      ],
+      # TODO(jschuh): crbug.com/167187 fix size_t to int truncations.
+      'msvs_disabled_warnings': [4267, ],
+    },
     {
       'target_name': 'courgette_fuzz',
       'type': 'executable',
@@ -10,10 +10,15 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/format_macros.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "build/build_config.h"
 #include "courgette/courgette.h"
 #include "courgette/streams.h"
 #include "courgette/third_party/bsdiff.h"
@@ -70,6 +75,23 @@ void WriteSinkToFile(const courgette::SinkStream *sink,
     Problem("Incomplete write.");
 }
 
+// Prints the peak working set of the process, as the installer would see it
+// while applying a patch.  Not all platforms report it.
+void PrintPeakMemory() {
+#if !defined(OS_MACOSX) || defined(OS_IOS)
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+#else
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle(), NULL));
+#endif
+  size_t peak = metrics->GetPeakWorkingSetSize();
+  if (peak)
+    printf("Peak working set: %" PRIuS " KB\n", peak / 1024);
+}
+
 void Disassemble(const base::FilePath& input_file,
                  const base::FilePath& output_file) {
   std::string buffer = ReadOrFail(input_file, "input");
@@ -339,8 +361,10 @@ void ApplyEnsemblePatch(const base::FilePath& old_file,
                                     patch_file.value().c_str(),
                                     new_file.value().c_str());
 
-  if (status == courgette::C_OK)
+  if (status == courgette::C_OK) {
+    PrintPeakMemory();
     return;
+  }
 
   // Diagnose the error.
   switch (status) {
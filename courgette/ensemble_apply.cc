@@ -216,6 +216,10 @@ Status EnsemblePatchApplication::TransformUp(
 
   if (!parameters->Empty())
     return C_STREAM_NOT_CONSUMED;
+  // We have totally consumed parameters, so can free the storage to which it
+  // referred before the transformed elements are patched.
+  corrected_parameters_storage_.Retire();
+
   return C_OK;
 }
 
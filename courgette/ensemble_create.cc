@@ -14,11 +14,15 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 
 #include "courgette/crc.h"
@@ -238,6 +242,69 @@ void FreeGenerators(std::vector<TransformationPatchGenerator*>* generators) {
   generators->clear();
 }
 
+namespace {
+
+// The most elements transformed at once.  Each transformation holds the
+// disassembled old and new programs, so this bounds the memory used as well
+// as the threads.
+const int kMaxTransformThreads = 4;
+
+// Transforms one element with its corrected parameters.  The elements of an
+// ensemble don't share any state, so they can be transformed on different
+// threads.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformTask(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_OK) {
+  }
+
+  virtual void Run() OVERRIDE {
+    status_ = generator_->Transform(&parameters_,
+                                    &predicted_transformed_element_,
+                                    &corrected_transformed_element_);
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted_transformed_element() {
+    return &predicted_transformed_element_;
+  }
+  SinkStreamSet* corrected_transformed_element() {
+    return &corrected_transformed_element_;
+  }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_transformed_element_;
+  SinkStreamSet corrected_transformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Runs |tasks| on up to kMaxTransformThreads threads, and returns once they
+// are all done.
+void RunTransformTasks(const std::vector<TransformTask*>& tasks) {
+  int thread_count = std::min(base::SysInfo::NumberOfProcessors(),
+                              kMaxTransformThreads);
+  thread_count = std::min(thread_count, static_cast<int>(tasks.size()));
+  if (thread_count <= 1) {
+    for (size_t i = 0;  i < tasks.size();  ++i)
+      tasks[i]->Run();
+    return;
+  }
+
+  base::DelegateSimpleThreadPool pool("CourgetteTransform", thread_count);
+  for (size_t i = 0;  i < tasks.size();  ++i)
+    pool.AddWork(tasks[i]);
+  pool.Start();
+  pool.JoinAll();
+}
+
+}  // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Status GenerateEnsemblePatch(SourceStream* base,
@@ -335,30 +402,36 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
+  ScopedVector<TransformTask> transform_tasks;
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
+    TransformTask* task = new TransformTask(generators[i]);
+    transform_tasks.push_back(task);
+    if (!corrected_parameters_source_set.ReadSet(task->parameters()))
       return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+  }
+
+  if (!corrected_parameters_source_set.Empty())
+    return C_STREAM_NOT_CONSUMED;
+
+  base::Time start_transform_time = base::Time::Now();
+  RunTransformTasks(transform_tasks.get());
+  VLOG(1) << "done Transform "
+          << (base::Time::Now() - start_transform_time).InSecondsF() << "s";
+
+  for (size_t i = 0;  i < number_of_transformations;  ++i) {
+    TransformTask* task = transform_tasks[i];
+    if (task->status() != C_OK)
+      return task->status();
+    if (!task->parameters()->Empty())
       return C_STREAM_NOT_CONSUMED;
     if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
+            task->predicted_transformed_element()))
       return C_STREAM_ERROR;
     if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
+            task->corrected_transformed_element()))
       return C_STREAM_ERROR;
   }
-
-  if (!corrected_parameters_source_set.Empty())
-    return C_STREAM_NOT_CONSUMED;
+  transform_tasks.clear();
 
   SinkStream linearized_predicted_transformed_elements;
   SinkStream linearized_corrected_transformed_elements;
@@ -0,0 +1,58 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <list>
+#include <string>
+
+#include "base/test/perf_time_logger.h"
+#include "courgette/base_test_unittest.h"
+#include "courgette/courgette.h"
+#include "courgette/streams.h"
+
+class EnsembleCreatePerfTest : public BaseTest {
+ public:
+  // Times the generation of the patch from |src_files| to |tgt_files|, which
+  // are concatenated into ensembles as an installer archive would be.
+  void TimeEnsemblePatch(const char* name,
+                         const std::list<std::string>& src_files,
+                         const std::list<std::string>& tgt_files) const {
+    std::string src_bytes = "aaabbbccc" + FilesContents(src_files) +
+        "dddeeefff";
+    std::string tgt_bytes = "aaagggccc" + FilesContents(tgt_files) +
+        "dddeeefff";
+
+    courgette::SourceStream source;
+    courgette::SourceStream target;
+    source.Init(src_bytes);
+    target.Init(tgt_bytes);
+    courgette::SinkStream patch_sink;
+
+    base::PerfTimeLogger timer(name);
+    EXPECT_EQ(courgette::C_OK,
+              courgette::GenerateEnsemblePatch(&source, &target, &patch_sink));
+    timer.Done();
+  }
+};
+
+TEST_F(EnsembleCreatePerfTest, PE) {
+  std::list<std::string> src_files;
+  std::list<std::string> tgt_files;
+  src_files.push_back("en-US.dll");
+  src_files.push_back("setup1.exe");
+  tgt_files.push_back("en-US.dll");
+  tgt_files.push_back("setup2.exe");
+  TimeEnsemblePatch("GenerateEnsemblePatch_PE", src_files, tgt_files);
+}
+
+TEST_F(EnsembleCreatePerfTest, PE64) {
+  std::list<std::string> src_files;
+  std::list<std::string> tgt_files;
+  src_files.push_back("en-US-64.dll");
+  src_files.push_back("chrome64_1.exe");
+  src_files.push_back("pe-64.exe");
+  tgt_files.push_back("en-US-64.dll");
+  tgt_files.push_back("chrome64_2.exe");
+  tgt_files.push_back("pe-64.exe");
+  TimeEnsemblePatch("GenerateEnsemblePatch_PE64", src_files, tgt_files);
+}
@@ -0,0 +1,88 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "extensions/common/url_pattern_index.h"
+
+#include "content/public/common/url_constants.h"
+#include "extensions/common/url_pattern_set.h"
+#include "url/gurl.h"
+
+namespace extensions {
+
+URLPatternIndex::Entry::Entry(const URLPattern& pattern, ItemID id)
+    : pattern(pattern), id(id) {
+}
+
+URLPatternIndex::Entry::~Entry() {
+}
+
+URLPatternIndex::URLPatternIndex() {
+}
+
+URLPatternIndex::~URLPatternIndex() {
+}
+
+void URLPatternIndex::AddPatterns(const URLPatternSet& patterns, ItemID id) {
+  for (URLPatternSet::const_iterator pattern = patterns.begin();
+       pattern != patterns.end(); ++pattern) {
+    Entry entry(*pattern, id);
+    // The host of file patterns is ignored, see URLPattern::MatchesURL().
+    if (pattern->match_all_urls() ||
+        pattern->scheme() == content::kFileScheme ||
+        (pattern->match_subdomains() && pattern->host().empty())) {
+      any_host_.push_back(entry);
+    } else if (pattern->match_subdomains()) {
+      domains_[pattern->host()].push_back(entry);
+    } else {
+      hosts_[pattern->host()].push_back(entry);
+    }
+  }
+}
+
+void URLPatternIndex::Clear() {
+  hosts_.clear();
+  domains_.clear();
+  any_host_.clear();
+}
+
+void URLPatternIndex::GetMatchingItems(const GURL& url,
+                                       std::set<ItemID>* ids) const {
+  MatchEntries(any_host_, url, ids);
+
+  // Hosts are matched against the inner URL of filesystem URLs.
+  const GURL& host_url = url.inner_url() ? *url.inner_url() : url;
+  const std::string& host = host_url.host();
+
+  HostMap::const_iterator it = hosts_.find(host);
+  if (it != hosts_.end())
+    MatchEntries(it->second, url, ids);
+
+  if (domains_.empty())
+    return;
+  it = domains_.find(host);
+  if (it != domains_.end())
+    MatchEntries(it->second, url, ids);
+  // Subdomains of IP addresses aren't matched, see URLPattern::MatchesHost().
+  if (host_url.HostIsIPAddress())
+    return;
+  for (size_t dot = host.find('.'); dot != std::string::npos;
+       dot = host.find('.', dot + 1)) {
+    it = domains_.find(host.substr(dot + 1));
+    if (it != domains_.end())
+      MatchEntries(it->second, url, ids);
+  }
+}
+
+// static
+void URLPatternIndex::MatchEntries(const Entries& entries,
+                                   const GURL& url,
+                                   std::set<ItemID>* ids) {
+  for (Entries::const_iterator entry = entries.begin();
+       entry != entries.end(); ++entry) {
+    if (ids->count(entry->id) == 0 && entry->pattern.MatchesURL(url))
+      ids->insert(entry->id);
+  }
+}
+
+}  // namespace extensions
@@ -0,0 +1,74 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef EXTENSIONS_COMMON_URL_PATTERN_INDEX_H_
+#define EXTENSIONS_COMMON_URL_PATTERN_INDEX_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace extensions {
+
+class URLPatternSet;
+
+// Indexes the URLPatternSets of many items, such as the content scripts of all
+// the installed extensions, by host. Finding the items with a pattern that
+// matches a URL then only tests the patterns for the URL's host and its parent
+// domains, and the patterns which match any host, rather than every pattern
+// of every item.
+class URLPatternIndex {
+ public:
+  // Identifies the item that a set of patterns belongs to.
+  typedef int ItemID;
+
+  URLPatternIndex();
+  ~URLPatternIndex();
+
+  // Adds the patterns of the item |id|.
+  void AddPatterns(const URLPatternSet& patterns, ItemID id);
+
+  void Clear();
+
+  // Adds to |ids| the IDs of the items having a pattern that matches |url|,
+  // as URLPatternSet::MatchesURL() would.
+  void GetMatchingItems(const GURL& url, std::set<ItemID>* ids) const;
+
+ private:
+  struct Entry {
+    Entry(const URLPattern& pattern, ItemID id);
+    ~Entry();
+
+    URLPattern pattern;
+    ItemID id;
+  };
+  typedef std::vector<Entry> Entries;
+  typedef base::hash_map<std::string, Entries> HostMap;
+
+  // Adds to |ids| the items of the |entries| whose pattern matches |url|.
+  static void MatchEntries(const Entries& entries,
+                           const GURL& url,
+                           std::set<ItemID>* ids);
+
+  // Patterns for a single host, by host.
+  HostMap hosts_;
+
+  // Patterns for a domain and its subdomains, by domain.
+  HostMap domains_;
+
+  // Patterns which aren't restricted to a host, like <all_urls> and file ones.
+  Entries any_host_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternIndex);
+};
+
+}  // namespace extensions
+
+#endif  // EXTENSIONS_COMMON_URL_PATTERN_INDEX_H_
@@ -0,0 +1,100 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "extensions/common/url_pattern_index.h"
+
+#include "extensions/common/url_pattern_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace extensions {
+
+namespace {
+
+URLPatternSet Patterns(const std::string& pattern) {
+  URLPatternSet set;
+  set.AddPattern(URLPattern(URLPattern::SCHEME_ALL, pattern));
+  return set;
+}
+
+std::set<URLPatternIndex::ItemID> Match(const URLPatternIndex& index,
+                                        const std::string& url) {
+  std::set<URLPatternIndex::ItemID> ids;
+  index.GetMatchingItems(GURL(url), &ids);
+  return ids;
+}
+
+}  // namespace
+
+TEST(URLPatternIndexTest, Empty) {
+  URLPatternIndex index;
+  EXPECT_TRUE(Match(index, "http://www.google.com/").empty());
+}
+
+TEST(URLPatternIndexTest, MatchesLikeURLPatternSet) {
+  const char* kPatterns[] = {
+    "http://www.google.com/*",
+    "*://*.google.com/foo*",
+    "http://*/*",
+    "<all_urls>",
+    "file:///tmp/*",
+    "http://127.0.0.1/*",
+    "*://*.0.0.1/*",
+    "https://mail.google.com:443/*",
+  };
+  const char* kURLs[] = {
+    "http://www.google.com/",
+    "http://www.google.com/foo",
+    "https://google.com/foobar",
+    "https://mail.google.com/",
+    "https://mail.google.com/foo",
+    "http://notgoogle.com/foo",
+    "ftp://www.google.com/foo",
+    "file:///tmp/file.txt",
+    "http://127.0.0.1/",
+    "filesystem:http://www.google.com/temporary/foo",
+    "chrome://settings/",
+    "about:blank",
+  };
+
+  URLPatternIndex index;
+  std::vector<URLPatternSet> sets;
+  for (size_t i = 0; i < arraysize(kPatterns); ++i) {
+    sets.push_back(Patterns(kPatterns[i]));
+    index.AddPatterns(sets.back(), i);
+  }
+
+  for (size_t i = 0; i < arraysize(kURLs); ++i) {
+    GURL url(kURLs[i]);
+    std::set<URLPatternIndex::ItemID> expected;
+    for (size_t j = 0; j < sets.size(); ++j) {
+      if (sets[j].MatchesURL(url))
+        expected.insert(j);
+    }
+    EXPECT_EQ(expected, Match(index, kURLs[i])) << kURLs[i];
+  }
+}
+
+TEST(URLPatternIndexTest, ItemWithManyPatterns) {
+  URLPatternSet patterns;
+  patterns.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "http://a.com/*"));
+  patterns.AddPattern(URLPattern(URLPattern::SCHEME_ALL, "http://*.b.com/*"));
+  URLPatternIndex index;
+  index.AddPatterns(patterns, 7);
+  index.AddPatterns(Patterns("http://*.a.com/*"), 8);
+
+  std::set<URLPatternIndex::ItemID> ids = Match(index, "http://a.com/");
+  EXPECT_EQ(2u, ids.size());
+  EXPECT_EQ(1u, ids.count(7));
+  EXPECT_EQ(1u, ids.count(8));
+  ids = Match(index, "http://x.y.b.com/");
+  EXPECT_EQ(1u, ids.size());
+  EXPECT_EQ(1u, ids.count(7));
+  EXPECT_TRUE(Match(index, "http://ca.com/").empty());
+
+  index.Clear();
+  EXPECT_TRUE(Match(index, "http://a.com/").empty());
+}
+
+}  // namespace extensions
@@ -58,6 +58,8 @@
         'public/wrapper_info.h',
         'runner.cc',
         'runner.h',
+        'script_cache.cc',
+        'script_cache.h',
         'try_catch.cc',
         'try_catch.h',
         'wrappable.cc',
@@ -118,6 +120,7 @@
         'test/run_all_unittests.cc',
         'test/run_js_tests.cc',
         'runner_unittest.cc',
+        'script_cache_unittest.cc',
         'wrappable_unittest.cc',
       ],
     },
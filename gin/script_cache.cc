@@ -0,0 +1,125 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/script_cache.h"
+
+#include "base/hash.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/pickle.h"
+#include "gin/converter.h"
+
+namespace gin {
+
+namespace {
+
+base::LazyInstance<ScriptCache>::Leaky g_script_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+uint32 HashSource(v8::Handle<v8::String> source) {
+  v8::String::Utf8Value utf8(source);
+  return base::Hash(*utf8, utf8.length());
+}
+
+}  // namespace
+
+ScriptCache::ScriptCache() {
+}
+
+ScriptCache::~ScriptCache() {
+}
+
+// static
+ScriptCache* ScriptCache::GetInstance() {
+  return g_script_cache.Pointer();
+}
+
+v8::Handle<v8::Script> ScriptCache::Compile(
+    v8::Isolate* isolate,
+    v8::Handle<v8::String> source,
+    v8::Handle<v8::String> resource_name) {
+  v8::ScriptOrigin origin(resource_name);
+  if (source->Length() < kMinPreparseLength)
+    return v8::Script::New(source, &origin);
+
+  std::string name = V8ToString(resource_name);
+  uint32 source_hash = HashSource(source);
+  scoped_ptr<v8::ScriptData> preparse_data;
+  {
+    base::AutoLock lock(lock_);
+    EntryMap::const_iterator it = entries_.find(name);
+    if (it != entries_.end() && it->second.source_hash == source_hash) {
+      preparse_data.reset(v8::ScriptData::New(
+          it->second.preparse_data.data(),
+          static_cast<int>(it->second.preparse_data.size())));
+    }
+  }
+
+  if (!preparse_data) {
+    preparse_data.reset(v8::ScriptData::PreCompile(source));
+    // Let the compile below report the syntax error.
+    if (preparse_data->HasError())
+      return v8::Script::New(source, &origin);
+
+    Entry entry;
+    entry.source_hash = source_hash;
+    entry.preparse_data.assign(preparse_data->Data(),
+                               preparse_data->Length());
+    base::AutoLock lock(lock_);
+    entries_[name] = entry;
+  }
+
+  return v8::Script::New(source, &origin, preparse_data.get());
+}
+
+void ScriptCache::Serialize(std::string* data) const {
+  Pickle pickle;
+  pickle.WriteString(v8::V8::GetVersion());
+  {
+    base::AutoLock lock(lock_);
+    pickle.WriteUInt64(entries_.size());
+    for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+         ++it) {
+      pickle.WriteString(it->first);
+      pickle.WriteUInt32(it->second.source_hash);
+      pickle.WriteString(it->second.preparse_data);
+    }
+  }
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+bool ScriptCache::Deserialize(const std::string& data) {
+  Pickle pickle(data.data(), static_cast<int>(data.size()));
+  PickleIterator iter(pickle);
+  std::string version;
+  uint64 count = 0;
+  if (!pickle.ReadString(&iter, &version) ||
+      version != v8::V8::GetVersion() ||
+      !pickle.ReadUInt64(&iter, &count))
+    return false;
+
+  EntryMap entries;
+  for (uint64 i = 0; i < count; ++i) {
+    std::string name;
+    Entry entry;
+    if (!pickle.ReadString(&iter, &name) ||
+        !pickle.ReadUInt32(&iter, &entry.source_hash) ||
+        !pickle.ReadString(&iter, &entry.preparse_data))
+      return false;
+    entries[name] = entry;
+  }
+
+  base::AutoLock lock(lock_);
+  for (EntryMap::const_iterator it = entries.begin(); it != entries.end();
+       ++it)
+    entries_[it->first] = it->second;
+  return true;
+}
+
+size_t ScriptCache::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace gin
@@ -0,0 +1,70 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GIN_SCRIPT_CACHE_H_
+#define GIN_SCRIPT_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "gin/gin_export.h"
+#include "v8/include/v8.h"
+
+namespace gin {
+
+// ScriptCache keeps the preparse data of the scripts the embedder bundles,
+// such as those of the extension bindings, which are compiled again in each
+// context. Later compiles of a script then skip over its inner functions
+// instead of parsing them to find where they end.
+//
+// Entries are keyed by resource name, and are only used for the same source
+// and V8 version they were made for. The cache is shared by the isolates of
+// the process. Serialize() and Deserialize() let an embedder keep it on disk
+// or hand it to other processes.
+class GIN_EXPORT ScriptCache {
+ public:
+  // Scripts shorter than this are compiled without preparse data, which
+  // would cost more to look up than it saves.
+  static const int kMinPreparseLength = 1024;
+
+  ScriptCache();
+  ~ScriptCache();
+
+  // Returns the cache of the process.
+  static ScriptCache* GetInstance();
+
+  // Compiles |source| in the current context of |isolate|, using the
+  // preparse data of |resource_name| if there is some, and adding it
+  // otherwise.
+  v8::Handle<v8::Script> Compile(v8::Isolate* isolate,
+                                 v8::Handle<v8::String> source,
+                                 v8::Handle<v8::String> resource_name);
+
+  // Writes the entries and the V8 version to |data|.
+  void Serialize(std::string* data) const;
+
+  // Adds the entries from |data|. Returns false, and adds none, if |data| is
+  // malformed or was written by another version of V8.
+  bool Deserialize(const std::string& data);
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    uint32 source_hash;
+    std::string preparse_data;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
+  mutable base::Lock lock_;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptCache);
+};
+
+}  // namespace gin
+
+#endif  // GIN_SCRIPT_CACHE_H_
@@ -0,0 +1,101 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/script_cache.h"
+
+#include <string>
+
+#include "base/strings/stringprintf.h"
+#include "gin/converter.h"
+#include "gin/public/isolate_holder.h"
+#include "gin/test/v8_test.h"
+
+namespace gin {
+
+namespace {
+
+// Returns a script long enough to have preparse data, which evaluates to the
+// sum of its functions' results.
+std::string CreateSource(int function_count) {
+  std::string source;
+  for (int i = 0; i < function_count; ++i) {
+    base::StringAppendF(&source,
+                        "function f%d(a, b) { var c = a * b; return c + %d; }"
+                        "\n",
+                        i, i);
+  }
+  source.append("var sum = 0;\n");
+  for (int i = 0; i < function_count; ++i)
+    base::StringAppendF(&source, "sum += f%d(1, 0);\n", i);
+  source.append("sum;\n");
+  return source;
+}
+
+}  // namespace
+
+typedef V8Test ScriptCacheTest;
+
+TEST_F(ScriptCacheTest, CompileTwice) {
+  v8::Isolate* isolate = instance_->isolate();
+  v8::HandleScope handle_scope(isolate);
+  ScriptCache cache;
+  std::string source = CreateSource(100);
+  ASSERT_LE(ScriptCache::kMinPreparseLength, static_cast<int>(source.size()));
+
+  for (int i = 0; i < 2; ++i) {
+    v8::Handle<v8::Script> script = cache.Compile(
+        isolate, StringToV8(isolate, source), StringToV8(isolate, "sum.js"));
+    ASSERT_FALSE(script.IsEmpty());
+    EXPECT_EQ(99 * 100 / 2, script->Run()->Int32Value());
+    EXPECT_EQ(1u, cache.size());
+  }
+}
+
+TEST_F(ScriptCacheTest, ShortScriptsAreNotCached) {
+  v8::Isolate* isolate = instance_->isolate();
+  v8::HandleScope handle_scope(isolate);
+  ScriptCache cache;
+  v8::Handle<v8::Script> script = cache.Compile(
+      isolate, StringToV8(isolate, "1 + 1"), StringToV8(isolate, "short.js"));
+  EXPECT_EQ(2, script->Run()->Int32Value());
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST_F(ScriptCacheTest, ChangedSource) {
+  v8::Isolate* isolate = instance_->isolate();
+  v8::HandleScope handle_scope(isolate);
+  ScriptCache cache;
+  cache.Compile(isolate, StringToV8(isolate, CreateSource(100)),
+                StringToV8(isolate, "sum.js"));
+  // The same resource with another source mustn't use the old entry.
+  v8::Handle<v8::Script> script = cache.Compile(
+      isolate, StringToV8(isolate, CreateSource(101)),
+      StringToV8(isolate, "sum.js"));
+  EXPECT_EQ(100 * 101 / 2, script->Run()->Int32Value());
+  EXPECT_EQ(1u, cache.size());
+}
+
+TEST_F(ScriptCacheTest, SerializeAndDeserialize) {
+  v8::Isolate* isolate = instance_->isolate();
+  v8::HandleScope handle_scope(isolate);
+  ScriptCache cache;
+  cache.Compile(isolate, StringToV8(isolate, CreateSource(100)),
+                StringToV8(isolate, "sum.js"));
+  std::string data;
+  cache.Serialize(&data);
+
+  ScriptCache other_cache;
+  EXPECT_TRUE(other_cache.Deserialize(data));
+  EXPECT_EQ(1u, other_cache.size());
+  v8::Handle<v8::Script> script = other_cache.Compile(
+      isolate, StringToV8(isolate, CreateSource(100)),
+      StringToV8(isolate, "sum.js"));
+  EXPECT_EQ(99 * 100 / 2, script->Run()->Int32Value());
+
+  ScriptCache bad_cache;
+  EXPECT_FALSE(bad_cache.Deserialize(data.substr(0, data.size() / 2)));
+  EXPECT_EQ(0u, bad_cache.size());
+}
+
+}  // namespace gin
@@ -21,6 +21,7 @@
 #include "google_apis/gcm/base/mcs_message.h"
 #include "google_apis/gcm/base/mcs_util.h"
 #include "google_apis/gcm/protocol/mcs.pb.h"
+#include "third_party/leveldatabase/env_chromium.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
 
 namespace gcm {
@@ -140,7 +141,12 @@ GCMStoreImpl::Backend::Backend(
     scoped_refptr<base::SequencedTaskRunner> foreground_task_runner)
     : path_(path), foreground_task_runner_(foreground_task_runner) {}
 
-GCMStoreImpl::Backend::~Backend() {}
+GCMStoreImpl::Backend::~Backend() {
+  if (db_.get()) {
+    UMA_HISTOGRAM_COUNTS_100("GCM.LevelDBReadAmplification",
+                             leveldb_env::GetReadAmplification(db_.get()));
+  }
+}
 
 void GCMStoreImpl::Backend::Load(const LoadCallback& callback) {
   scoped_ptr<LoadResult> result(new LoadResult());
@@ -154,6 +160,9 @@ void GCMStoreImpl::Backend::Load(const LoadCallback& callback) {
 
   leveldb::Options options;
   options.create_if_missing = true;
+  options.block_cache = leveldb_env::SharedBlockCache();
+  options.filter_policy = leveldb_env::BloomFilterPolicy();
+  options.write_buffer_size = leveldb_env::kLargeWriteBufferSize;
   leveldb::DB* db;
   leveldb::Status status =
       leveldb::DB::Open(options, path_.AsUTF8Unsafe(), &db);
@@ -67,8 +67,7 @@ void CommandBufferHelper::CalcImmediateEntries(int waiting_count) {
         total_entry_count_ /
         ((curr_get == last_put_sent_) ? kAutoFlushSmall : kAutoFlushBig);
 
-    int32 pending =
-        (put_ + total_entry_count_ - last_put_sent_) % total_entry_count_;
+    int32 pending = PendingEntries();
 
     if (pending > 0 && pending >= limit) {
       // Time to force flush.
@@ -176,7 +175,16 @@ void CommandBufferHelper::Flush() {
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
 void CommandBufferHelper::PeriodicFlushCheck() {
   clock_t current_time = clock();
-  if (current_time - last_flush_time_ > kPeriodicFlushDelay * CLOCKS_PER_SEC)
+  if (current_time - last_flush_time_ <= kPeriodicFlushDelay * CLOCKS_PER_SEC)
+    return;
+
+  // Each flush wakes up the service, which is only worth it if it would
+  // otherwise run out of work, or if enough new work has piled up. Otherwise
+  // keep batching; the fill level limits in CalcImmediateEntries() and the
+  // explicit flushes at frame boundaries still bound the delay.
+  bool service_idle = get_offset() == last_put_sent_;
+  if (service_idle ||
+      PendingEntries() >= total_entry_count_ / kPeriodicFlushBusy)
     Flush();
 }
 #endif
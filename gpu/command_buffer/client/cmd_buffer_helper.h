@@ -21,6 +21,9 @@ namespace gpu {
 #define CMD_HELPER_PERIODIC_FLUSH_CHECK
 const int kCommandsPerFlushCheck = 100;
 const float kPeriodicFlushDelay = 1.0f / (5.0f * 60.0f);
+// While the service is still busy with earlier commands, periodic flushes wait
+// for this fraction of the buffer to be pending.
+const int kPeriodicFlushBusy = 8;  // 1/8 of the buffer
 #endif
 
 const int kAutoFlushSmall = 16;  // 1/16 of the buffer
@@ -280,6 +283,11 @@ class GPU_EXPORT CommandBufferHelper {
     return (get_offset() - put_ - 1 + total_entry_count_) % total_entry_count_;
   }
 
+  // Returns the number of entries added since the last flush.
+  int32 PendingEntries() const {
+    return (put_ + total_entry_count_ - last_put_sent_) % total_entry_count_;
+  }
+
   void CalcImmediateEntries(int waiting_count);
   bool AllocateRingBuffer();
   void FreeResources();
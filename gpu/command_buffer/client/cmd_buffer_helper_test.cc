@@ -233,6 +233,16 @@ class CommandBufferHelperTest : public testing::Test {
 
   CommandBufferOffset get_helper_put() { return helper_->put_; }
 
+  int32 GetHelperLastPutSent() { return helper_->last_put_sent_; }
+
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+  // Runs a periodic flush check as if the flush delay had passed.
+  void PeriodicFlushCheckAfterDelay() {
+    helper_->last_flush_time_ = clock() - CLOCKS_PER_SEC;
+    helper_->PeriodicFlushCheck();
+  }
+#endif
+
 #if defined(OS_MACOSX)
   base::mac::ScopedNSAutoreleasePool autorelease_pool_;
 #endif
@@ -409,6 +419,38 @@ TEST_F(CommandBufferHelperTest, TestCalcImmediateEntriesOverFlushLimit) {
   EXPECT_EQ(error::kNoError, GetError());
 }
 
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+// Checks that periodic flushes are batched while the service is busy.
+TEST_F(CommandBufferHelperTest, TestPeriodicFlushWhileBusy) {
+  // Lock internal flushing, so the service never catches up.
+  command_buffer_->LockFlush();
+
+  // The service is idle, so even a small command is flushed.
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  PeriodicFlushCheckAfterDelay();
+  EXPECT_EQ(2, GetHelperLastPutSent());
+
+  // The service is busy with the first command, so a small command waits.
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  PeriodicFlushCheckAfterDelay();
+  EXPECT_EQ(2, GetHelperLastPutSent());
+
+  // Until enough of the buffer is pending.
+  AddUniqueCommandWithExpect(
+      error::kNoError, kTotalNumCommandEntries / kPeriodicFlushBusy - 2);
+  PeriodicFlushCheckAfterDelay();
+  EXPECT_EQ(GetHelperPutOffset(), GetHelperLastPutSent());
+
+  command_buffer_->UnlockFlush();
+  helper_->Finish();
+  // Check that the commands did happen.
+  Mock::VerifyAndClearExpectations(api_mock_.get());
+
+  // Check the error status.
+  EXPECT_EQ(error::kNoError, GetError());
+}
+#endif
+
 // Checks that commands in the buffer are properly executed, and that the
 // status/error stay valid.
 TEST_F(CommandBufferHelperTest, TestCommandProcessing) {
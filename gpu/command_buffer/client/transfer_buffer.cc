@@ -25,6 +25,8 @@ TransferBuffer::TransferBuffer(
       alignment_(0),
       size_to_flush_(0),
       bytes_since_last_flush_(0),
+      allocations_since_shrink_check_(0),
+      largest_recent_allocation_(0),
       buffer_id_(-1),
       result_buffer_(NULL),
       result_shm_offset_(0),
@@ -100,6 +102,8 @@ void TransferBuffer::AllocateRingBuffer(unsigned int size) {
       buffer_id_ = id;
       result_buffer_ = buffer_.ptr;
       result_shm_offset_ = 0;
+      allocations_since_shrink_check_ = 0;
+      largest_recent_allocation_ = 0;
       return;
     }
     // we failed so don't try larger than this.
@@ -140,12 +144,16 @@ static unsigned int ComputePOTSize(unsigned int dimension) {
   return (dimension == 0) ? 0 : 1 << Log2Ceiling(dimension);
 }
 
-void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
-  // What size buffer would we ask for if we needed a new one?
+unsigned int TransferBuffer::ComputeNeededBufferSize(unsigned int size) const {
   unsigned int needed_buffer_size = ComputePOTSize(size + result_size_);
   needed_buffer_size = std::max(needed_buffer_size, min_buffer_size_);
   needed_buffer_size = std::max(needed_buffer_size, default_buffer_size_);
-  needed_buffer_size = std::min(needed_buffer_size, max_buffer_size_);
+  return std::min(needed_buffer_size, max_buffer_size_);
+}
+
+void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
+  // What size buffer would we ask for if we needed a new one?
+  unsigned int needed_buffer_size = ComputeNeededBufferSize(size);
 
   if (usable_ && (!HaveBuffer() || needed_buffer_size > buffer_.size)) {
     if (HaveBuffer()) {
@@ -155,10 +163,33 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size) {
   }
 }
 
+void TransferBuffer::ShrinkRingBufferIfOversized(unsigned int size) {
+  largest_recent_allocation_ = std::max(largest_recent_allocation_, size);
+  if (++allocations_since_shrink_check_ < kAllocationsBeforeShrink)
+    return;
+
+  unsigned int needed_buffer_size =
+      ComputeNeededBufferSize(largest_recent_allocation_);
+  allocations_since_shrink_check_ = 0;
+  largest_recent_allocation_ = 0;
+
+  // Large uploads are streamed through AllocUpTo() in chunks, so a smaller
+  // buffer keeps the same throughput. Only shrink by half or more so that
+  // occasional spikes don't make us reallocate over and over, since
+  // freeing the buffer has to wait for the service to be done with it.
+  if (HaveBuffer() && needed_buffer_size <= buffer_.size / 2) {
+    TRACE_EVENT1("gpu", "TransferBuffer::Shrink",
+                 "size", needed_buffer_size);
+    Free();
+    AllocateRingBuffer(needed_buffer_size);
+  }
+}
+
 void* TransferBuffer::AllocUpTo(
     unsigned int size, unsigned int* size_allocated) {
   DCHECK(size_allocated);
 
+  ShrinkRingBufferIfOversized(size);
   ReallocateRingBuffer(size);
 
   if (!HaveBuffer()) {
@@ -172,6 +203,7 @@ void* TransferBuffer::AllocUpTo(
 }
 
 void* TransferBuffer::Alloc(unsigned int size) {
+  ShrinkRingBufferIfOversized(size);
   ReallocateRingBuffer(size);
 
   if (!HaveBuffer()) {
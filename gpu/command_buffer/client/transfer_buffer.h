@@ -87,6 +87,10 @@ class GPU_EXPORT TransferBufferInterface {
 // Class that manages the transfer buffer.
 class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
  public:
+  // Number of allocations after which the buffer is shrunk back if none of
+  // them needed its current size.
+  static const unsigned int kAllocationsBeforeShrink = 256;
+
   TransferBuffer(CommandBufferHelper* helper);
   virtual ~TransferBuffer();
 
@@ -119,6 +123,13 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
 
   void AllocateRingBuffer(unsigned int size);
 
+  // Returns the buffer size to ask for if an allocation of size is needed.
+  unsigned int ComputeNeededBufferSize(unsigned int size) const;
+
+  // Shrinks the ring buffer if it grew for a past spike of large allocations
+  // and the recent ones, including this one of size, fit in half of it.
+  void ShrinkRingBufferIfOversized(unsigned int size);
+
   CommandBufferHelper* helper_;
   scoped_ptr<AlignedRingBuffer> ring_buffer_;
 
@@ -143,6 +154,12 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   // Number of bytes since we last flushed.
   unsigned int bytes_since_last_flush_;
 
+  // Number of allocations since the buffer size was last checked.
+  unsigned int allocations_since_shrink_check_;
+
+  // Largest allocation since the buffer size was last checked.
+  unsigned int largest_recent_allocation_;
+
   // the current buffer.
   gpu::Buffer buffer_;
 
@@ -358,6 +358,57 @@ TEST_F(TransferBufferExpandContractTest, Expand) {
   transfer_buffer_->FreePendingToken(ptr, 1);
 }
 
+TEST_F(TransferBufferExpandContractTest, ShrinksAfterSpike) {
+  const unsigned int kAllocationsBeforeShrink =
+      TransferBuffer::kAllocationsBeforeShrink;
+
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kMaxTransferBufferSize, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+
+  // Grow to the max size.
+  const size_t kSize = kMaxTransferBufferSize - kStartingOffset;
+  unsigned int size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(kSize, &size_allocated);
+  ASSERT_TRUE(ptr != NULL);
+  EXPECT_EQ(kSize, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, 1);
+
+  // The large allocation was recent, so it should not shrink yet.
+  for (unsigned int i = 1; i < kAllocationsBeforeShrink; ++i) {
+    ptr = transfer_buffer_->AllocUpTo(0, &size_allocated);
+    ASSERT_TRUE(ptr != NULL);
+    transfer_buffer_->FreePendingToken(ptr, 1);
+  }
+  EXPECT_EQ(kSize, transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+
+  // After a full interval of small allocations it should shrink back to the
+  // default size.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kStartTransferBufferSize, _))
+      .WillOnce(Invoke(
+          command_buffer(),
+          &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  for (unsigned int i = 0; i < kAllocationsBeforeShrink; ++i) {
+    ptr = transfer_buffer_->AllocUpTo(0, &size_allocated);
+    ASSERT_TRUE(ptr != NULL);
+    transfer_buffer_->FreePendingToken(ptr, 1);
+  }
+  EXPECT_EQ(
+      kStartTransferBufferSize - kStartingOffset,
+      transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
+}
+
 TEST_F(TransferBufferExpandContractTest, Contract) {
   // Check it starts at starting size.
   EXPECT_EQ(
@@ -0,0 +1,115 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+
+#include "base/debug/trace_event.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+
+namespace gpu {
+
+// static
+scoped_ptr<CommandBufferRecorder> CommandBufferRecorder::Create(
+    const base::FilePath& path) {
+  base::File file(path, base::File::FLAG_CREATE_ALWAYS |
+                        base::File::FLAG_WRITE);
+  if (!file.IsValid()) {
+    LOG(ERROR) << "Failed to open " << path.value()
+               << " to record the command buffer.";
+    return scoped_ptr<CommandBufferRecorder>();
+  }
+  return make_scoped_ptr(new CommandBufferRecorder(file.Pass()));
+}
+
+CommandBufferRecorder::CommandBufferRecorder(base::File file)
+    : file_(file.Pass()) {
+  WriteData(reinterpret_cast<const char*>(&kCommandBufferRecordingMagic),
+            sizeof(kCommandBufferRecordingMagic));
+  WriteData(reinterpret_cast<const char*>(&kCommandBufferRecordingVersion),
+            sizeof(kCommandBufferRecordingVersion));
+}
+
+CommandBufferRecorder::~CommandBufferRecorder() {
+}
+
+void CommandBufferRecorder::RecordRegisterTransferBuffer(
+    int32 id, const Buffer& buffer) {
+  DCHECK(buffer.ptr);
+  WriteRecord(CommandBufferRecord::kRegisterTransferBuffer, id, 0,
+              buffer.size);
+
+  // The client may have written to the buffer already.
+  TrackedBuffer& tracked = buffers_[id];
+  tracked.buffer = buffer;
+  tracked.contents.assign(static_cast<const char*>(buffer.ptr), buffer.size);
+  WriteRecord(CommandBufferRecord::kTransferBufferData, id, 0, buffer.size);
+  WriteData(tracked.contents.data(), buffer.size);
+}
+
+void CommandBufferRecorder::RecordDestroyTransferBuffer(int32 id) {
+  TrackedBufferMap::iterator it = buffers_.find(id);
+  if (it == buffers_.end())
+    return;
+  // Commands already flushed may still read the final contents.
+  RecordChanges(id, &it->second);
+  buffers_.erase(it);
+  WriteRecord(CommandBufferRecord::kDestroyTransferBuffer, id, 0, 0);
+}
+
+void CommandBufferRecorder::RecordSetGetBuffer(int32 id) {
+  WriteRecord(CommandBufferRecord::kSetGetBuffer, id, 0, 0);
+}
+
+void CommandBufferRecorder::RecordFlush(int32 put_offset) {
+  TRACE_EVENT0("gpu", "CommandBufferRecorder::RecordFlush");
+  for (TrackedBufferMap::iterator it = buffers_.begin();
+       it != buffers_.end(); ++it) {
+    RecordChanges(it->first, &it->second);
+  }
+  WriteRecord(CommandBufferRecord::kFlush, 0, put_offset, 0);
+}
+
+void CommandBufferRecorder::RecordChanges(int32 id, TrackedBuffer* tracked) {
+  const char* data = static_cast<const char*>(tracked->buffer.ptr);
+  std::string& contents = tracked->contents;
+  size_t size = contents.size();
+
+  size_t begin = 0;
+  while (begin < size && data[begin] == contents[begin])
+    ++begin;
+  if (begin == size)
+    return;
+  size_t end = size;
+  while (end > begin && data[end - 1] == contents[end - 1])
+    --end;
+
+  contents.replace(begin, end - begin, data + begin, end - begin);
+  WriteRecord(CommandBufferRecord::kTransferBufferData, id, begin,
+              end - begin);
+  WriteData(contents.data() + begin, end - begin);
+}
+
+void CommandBufferRecorder::WriteRecord(CommandBufferRecord::Type type,
+                                        int32 id,
+                                        uint32 offset,
+                                        uint32 size) {
+  CommandBufferRecord record;
+  record.type = type;
+  record.id = id;
+  record.offset = offset;
+  record.size = size;
+  WriteData(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+void CommandBufferRecorder::WriteData(const char* data, uint32 size) {
+  if (!file_.IsValid())
+    return;
+  if (file_.WriteAtCurrentPos(data, size) != static_cast<int>(size)) {
+    LOG(ERROR) << "Failed to write the command buffer recording.";
+    file_.Close();
+  }
+}
+
+}  // namespace gpu
@@ -0,0 +1,100 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+#define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file.h"
+#include "base/memory/scoped_ptr.h"
+#include "gpu/command_buffer/common/buffer.h"
+#include "gpu/gpu_export.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace gpu {
+
+// A recording starts with kCommandBufferRecordingMagic and
+// kCommandBufferRecordingVersion, each a uint32, followed by a sequence of
+// CommandBufferRecords. Only kTransferBufferData records are followed by
+// data, |size| bytes of it.
+const uint32 kCommandBufferRecordingMagic = 0x43425247;  // "GRBC"
+const uint32 kCommandBufferRecordingVersion = 1;
+
+struct CommandBufferRecord {
+  enum Type {
+    // A transfer buffer |id| of |size| bytes was registered.
+    kRegisterTransferBuffer,
+    // |size| bytes of transfer buffer |id| at |offset| changed.
+    kTransferBufferData,
+    // Transfer buffer |id| was destroyed.
+    kDestroyTransferBuffer,
+    // Transfer buffer |id| became the ring buffer.
+    kSetGetBuffer,
+    // The put offset was set to |offset|.
+    kFlush,
+  };
+
+  uint32 type;
+  int32 id;
+  uint32 offset;
+  uint32 size;
+};
+
+// Writes the raw command stream received by a CommandBufferService, and the
+// contents of its transfer buffers, to a file that can be replayed against a
+// decoder. The ring buffer is a transfer buffer too, so the commands are
+// recorded as its data.
+//
+// Transfer buffers are compared with a copy of their contents at each flush,
+// and only the changed range is written. This makes recording slow and
+// memory hungry, so it is only meant for capturing benchmark streams.
+class GPU_EXPORT CommandBufferRecorder {
+ public:
+  // Returns NULL if |path| can't be written.
+  static scoped_ptr<CommandBufferRecorder> Create(const base::FilePath& path);
+
+  ~CommandBufferRecorder();
+
+  void RecordRegisterTransferBuffer(int32 id, const Buffer& buffer);
+  void RecordDestroyTransferBuffer(int32 id);
+  void RecordSetGetBuffer(int32 id);
+
+  // Records the transfer buffer contents that changed since the last flush,
+  // then the flush itself.
+  void RecordFlush(int32 put_offset);
+
+ private:
+  struct TrackedBuffer {
+    Buffer buffer;
+    // Contents of |buffer| as of the last recorded flush.
+    std::string contents;
+  };
+  typedef std::map<int32, TrackedBuffer> TrackedBufferMap;
+
+  explicit CommandBufferRecorder(base::File file);
+
+  void WriteRecord(CommandBufferRecord::Type type,
+                   int32 id,
+                   uint32 offset,
+                   uint32 size);
+  void WriteData(const char* data, uint32 size);
+
+  // Records the range of |tracked| that changed, and updates its copy.
+  void RecordChanges(int32 id, TrackedBuffer* tracked);
+
+  base::File file_;
+  TrackedBufferMap buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecorder);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
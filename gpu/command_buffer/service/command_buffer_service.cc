@@ -10,6 +10,7 @@
 #include "base/debug/trace_event.h"
 #include "gpu/command_buffer/common/cmd_buffer_common.h"
 #include "gpu/command_buffer/common/command_buffer_shared.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 #include "gpu/command_buffer/service/transfer_buffer_manager.h"
 
 using ::base::SharedMemory;
@@ -73,6 +74,8 @@ CommandBufferService::State CommandBufferService::FlushSync(
   }
 
   put_offset_ = put_offset;
+  if (recorder_)
+    recorder_->RecordFlush(put_offset);
 
   if (!put_offset_change_callback_.is_null())
     put_offset_change_callback_.Run();
@@ -87,6 +90,8 @@ void CommandBufferService::Flush(int32 put_offset) {
   }
 
   put_offset_ = put_offset;
+  if (recorder_)
+    recorder_->RecordFlush(put_offset);
 
   if (!put_offset_change_callback_.is_null())
     put_offset_change_callback_.Run();
@@ -98,6 +103,8 @@ void CommandBufferService::SetGetBuffer(int32 transfer_buffer_id) {
   ring_buffer_ = GetTransferBuffer(transfer_buffer_id);
   DCHECK(ring_buffer_.ptr);
   ring_buffer_id_ = transfer_buffer_id;
+  if (recorder_)
+    recorder_->RecordSetGetBuffer(transfer_buffer_id);
   num_entries_ = ring_buffer_.size / sizeof(CommandBufferEntry);
   put_offset_ = 0;
   SetGetOffset(0);
@@ -146,6 +153,8 @@ Buffer CommandBufferService::CreateTransferBuffer(size_t size,
 }
 
 void CommandBufferService::DestroyTransferBuffer(int32 id) {
+  if (recorder_)
+    recorder_->RecordDestroyTransferBuffer(id);
   transfer_buffer_manager_->DestroyTransferBuffer(id);
   if (id == ring_buffer_id_) {
     ring_buffer_id_ = -1;
@@ -164,9 +173,19 @@ bool CommandBufferService::RegisterTransferBuffer(
     int32 id,
     base::SharedMemory* shared_memory,
     size_t size) {
-  return transfer_buffer_manager_->RegisterTransferBuffer(id,
-                                                          shared_memory,
-                                                          size);
+  if (!transfer_buffer_manager_->RegisterTransferBuffer(id,
+                                                       shared_memory,
+                                                       size)) {
+    return false;
+  }
+  if (recorder_)
+    recorder_->RecordRegisterTransferBuffer(id, GetTransferBuffer(id));
+  return true;
+}
+
+void CommandBufferService::SetRecorder(
+    scoped_ptr<CommandBufferRecorder> recorder) {
+  recorder_ = recorder.Pass();
 }
 
 void CommandBufferService::SetToken(int32 token) {
@@ -6,12 +6,14 @@
 #define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_SERVICE_H_
 
 #include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "gpu/command_buffer/common/command_buffer.h"
 #include "gpu/command_buffer/common/command_buffer_shared.h"
 
 namespace gpu {
 
+class CommandBufferRecorder;
 class TransferBufferManagerInterface;
 
 // An object that implements a shared memory command buffer and a synchronous
@@ -66,6 +68,11 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
                               base::SharedMemory* shared_memory,
                               size_t size);
 
+  // Records everything this command buffer receives from now on with
+  // |recorder|, so that it can be replayed later. Must be called before the
+  // first transfer buffer is registered.
+  void SetRecorder(scoped_ptr<CommandBufferRecorder> recorder);
+
  private:
   int32 ring_buffer_id_;
   Buffer ring_buffer_;
@@ -82,6 +89,7 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   uint32 generation_;
   error::Error error_;
   error::ContextLostReason context_lost_reason_;
+  scoped_ptr<CommandBufferRecorder> recorder_;
 
   DISALLOW_COPY_AND_ASSIGN(CommandBufferService);
 };
@@ -69,6 +69,22 @@ struct GPU_EXPORT TextureUnit {
     return NULL;
   }
 
+  TextureRef* GetInfoForTarget(GLenum target) const {
+    switch (target) {
+      case GL_TEXTURE_2D:
+        return bound_texture_2d.get();
+      case GL_TEXTURE_CUBE_MAP:
+        return bound_texture_cube_map.get();
+      case GL_TEXTURE_EXTERNAL_OES:
+        return bound_texture_external_oes.get();
+      case GL_TEXTURE_RECTANGLE_ARB:
+        return bound_texture_rectangle_arb.get();
+    }
+
+    NOTREACHED();
+    return NULL;
+  }
+
   void Unbind(TextureRef* texture) {
     if (bound_texture_2d.get() == texture) {
       bound_texture_2d = NULL;
@@ -79,6 +95,9 @@ struct GPU_EXPORT TextureUnit {
     if (bound_texture_external_oes.get() == texture) {
       bound_texture_external_oes = NULL;
     }
+    if (bound_texture_rectangle_arb.get() == texture) {
+      bound_texture_rectangle_arb = NULL;
+    }
   }
 };
 
@@ -134,7 +134,8 @@ FeatureInfo::FeatureFlags::FeatureFlags()
       is_angle(false),
       is_swiftshader(false),
       angle_texture_usage(false),
-      ext_texture_storage(false) {
+      ext_texture_storage(false),
+      skip_redundant_bindings(false) {
 }
 
 FeatureInfo::Workarounds::Workarounds() :
@@ -165,6 +166,9 @@ void FeatureInfo::InitializeBasicState(const CommandLine& command_line) {
   feature_flags_.is_swiftshader =
       (command_line.GetSwitchValueASCII(switches::kUseGL) == "swiftshader");
 
+  feature_flags_.skip_redundant_bindings =
+      command_line.HasSwitch(switches::kSkipRedundantGLBindings);
+
   static const GLenum kAlphaTypes[] = {
       GL_UNSIGNED_BYTE,
   };
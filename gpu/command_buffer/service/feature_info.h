@@ -65,6 +65,8 @@ class GPU_EXPORT FeatureInfo : public base::RefCounted<FeatureInfo> {
     bool is_swiftshader;
     bool angle_texture_usage;
     bool ext_texture_storage;
+    // Don't call into GL for binds that would not change the bound object.
+    bool skip_redundant_bindings;
   };
 
   struct Workarounds {
@@ -3632,6 +3632,10 @@ void GLES2DecoderImpl::DoActiveTexture(GLenum texture_unit) {
         "glActiveTexture", texture_unit, "texture_unit");
     return;
   }
+  if (features().skip_redundant_bindings &&
+      texture_index == state_.active_texture_unit) {
+    return;
+  }
   state_.active_texture_unit = texture_index;
   glActiveTexture(texture_unit);
 }
@@ -3668,6 +3672,13 @@ void GLES2DecoderImpl::DoBindBuffer(GLenum target, GLuint client_id) {
     }
     service_id = buffer->service_id();
   }
+  if (features().skip_redundant_bindings) {
+    Buffer* bound_buffer = target == GL_ARRAY_BUFFER ?
+        state_.bound_array_buffer.get() :
+        state_.vertex_attrib_manager->element_array_buffer();
+    if (bound_buffer == buffer)
+      return;
+  }
   switch (target) {
     case GL_ARRAY_BUFFER:
       state_.bound_array_buffer = buffer;
@@ -3943,9 +3954,15 @@ void GLES2DecoderImpl::DoBindTexture(GLenum target, GLuint client_id) {
   if (texture->target() == 0) {
     texture_manager()->SetTarget(texture_ref, target);
   }
-  glBindTexture(target, texture->service_id());
 
   TextureUnit& unit = state_.texture_units[state_.active_texture_unit];
+  if (features().skip_redundant_bindings &&
+      unit.GetInfoForTarget(target) == texture_ref) {
+    unit.bind_target = target;
+    return;
+  }
+  glBindTexture(target, texture->service_id());
+
   unit.bind_target = target;
   switch (target) {
     case GL_TEXTURE_2D:
@@ -5903,6 +5920,10 @@ void GLES2DecoderImpl::DoUseProgram(GLuint program_id) {
     }
     service_id = program->service_id();
   }
+  if (features().skip_redundant_bindings &&
+      state_.current_program.get() == program) {
+    return;
+  }
   if (state_.current_program.get()) {
     program_manager()->UnuseProgram(shader_manager(),
                                     state_.current_program.get());
@@ -8924,6 +8945,7 @@ void GLES2DecoderImpl::DoSwapBuffers() {
   {
     TRACE_EVENT_SYNTHETIC_DELAY("gpu.SwapBuffers");
   }
+  gpu_tracer_->EndFrame();
 
   bool is_tracing;
   TRACE_EVENT_CATEGORY_GROUP_ENABLED(TRACE_DISABLED_BY_DEFAULT("gpu.debug"),
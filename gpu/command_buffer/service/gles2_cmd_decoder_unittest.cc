@@ -6025,6 +6025,51 @@ TEST_F(
   EXPECT_EQ(error::kNoError, ExecuteCmd(cmd));
 }
 
+TEST_F(GLES2DecoderManualInitTest, SkipRedundantBindings) {
+  CommandLine command_line(0, NULL);
+  command_line.AppendSwitch(switches::kSkipRedundantGLBindings);
+  InitDecoderWithCommandLine(
+      "",     // extensions
+      "3.0",  // gl version
+      false,  // has alpha
+      false,  // has depth
+      false,  // has stencil
+      false,  // request alpha
+      false,  // request depth
+      false,  // request stencil
+      true,   // bind generates resource
+      &command_line);
+  DoBindTexture(GL_TEXTURE_2D, client_texture_id_, kServiceTextureId);
+  DoBindBuffer(GL_ARRAY_BUFFER, client_buffer_id_, kServiceBufferId);
+
+  // Binding the same objects again should not reach GL.
+  EXPECT_CALL(*gl_, ActiveTexture(_))
+      .Times(0);
+  EXPECT_CALL(*gl_, BindTexture(_, _))
+      .Times(0);
+  EXPECT_CALL(*gl_, BindBuffer(_, _))
+      .Times(0);
+  ActiveTexture active_texture_cmd;
+  active_texture_cmd.Init(GL_TEXTURE0);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(active_texture_cmd));
+  BindTexture bind_texture_cmd;
+  bind_texture_cmd.Init(GL_TEXTURE_2D, client_texture_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(bind_texture_cmd));
+  BindBuffer bind_buffer_cmd;
+  bind_buffer_cmd.Init(GL_ARRAY_BUFFER, client_buffer_id_);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(bind_buffer_cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+
+  // Binding a different object still does.
+  EXPECT_CALL(*gl_, BindTexture(GL_TEXTURE_2D,
+                                TestHelper::kServiceDefaultTexture2dId))
+      .Times(1)
+      .RetiresOnSaturation();
+  bind_texture_cmd.Init(GL_TEXTURE_2D, 0);
+  EXPECT_EQ(error::kNoError, ExecuteCmd(bind_texture_cmd));
+  EXPECT_EQ(GL_NO_ERROR, GetGLError());
+}
+
 TEST_F(GLES2DecoderTest, TexSubImage2DClearsAfterTexImage2DWithDataThenNULL) {
   DoBindTexture(GL_TEXTURE_2D, client_texture_id_, kServiceTextureId);
   // Put in data (so it should be marked as cleared)
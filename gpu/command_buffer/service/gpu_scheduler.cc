@@ -266,18 +266,20 @@ bool GpuScheduler::PollUnscheduleFences() {
 }
 
 bool GpuScheduler::IsPreempted() {
-  if (!preemption_flag_.get())
-    return false;
+  bool preempted =
+      (preemption_flag_.get() && preemption_flag_->IsSet()) ||
+      (higher_priority_preemption_flag_.get() &&
+       higher_priority_preemption_flag_->IsSet());
 
-  if (!was_preempted_ && preemption_flag_->IsSet()) {
+  if (!was_preempted_ && preempted) {
     TRACE_COUNTER_ID1("gpu", "GpuScheduler::Preempted", this, 1);
     was_preempted_ = true;
-  } else if (was_preempted_ && !preemption_flag_->IsSet()) {
+  } else if (was_preempted_ && !preempted) {
     TRACE_COUNTER_ID1("gpu", "GpuScheduler::Preempted", this, 0);
     was_preempted_ = false;
   }
 
-  return preemption_flag_->IsSet();
+  return preempted;
 }
 
 bool GpuScheduler::HasMoreIdleWork() {
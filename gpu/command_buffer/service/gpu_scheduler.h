@@ -64,6 +64,12 @@ class GPU_EXPORT GpuScheduler
     preemption_flag_ = flag;
   }
 
+  // Also preempts this scheduler while higher priority work on the same
+  // channel is waiting.
+  void SetPreemptByHigherPriorityFlag(scoped_refptr<PreemptionFlag> flag) {
+    higher_priority_preemption_flag_ = flag;
+  }
+
   // Sets whether commands should be processed by this scheduler. Setting to
   // false unschedules. Setting to true reschedules. Whether or not the
   // scheduler is currently scheduled is "reference counted". Every call with
@@ -158,6 +164,8 @@ class GPU_EXPORT GpuScheduler
 
   // If non-NULL and |preemption_flag_->IsSet()|, exit PutChanged early.
   scoped_refptr<PreemptionFlag> preemption_flag_;
+  // Same as above, for higher priority work on the same channel.
+  scoped_refptr<PreemptionFlag> higher_priority_preemption_flag_;
   bool was_preempted_;
 
   DISALLOW_COPY_AND_ASSIGN(GpuScheduler);
@@ -7,6 +7,10 @@
 
 namespace switches {
 
+// Records the command buffers to files in the given directory, to be
+// replayed by gpu_perftests. Requires --no-sandbox.
+const char kCaptureGpuCommandBuffers[]      = "capture-gpu-command-buffers";
+
 // Always return success when compiling a shader. Linking will still fail.
 const char kCompileShaderAlwaysSucceeds[]   = "compile-shader-always-succeeds";
 
@@ -57,6 +61,9 @@ const char kGpuDriverBugWorkarounds[] = "gpu-driver-bug-workarounds";
 // Sets the maximum size of the in-memory gpu program cache, in kb
 const char kGpuProgramCacheSizeKb[]         = "gpu-program-cache-size-kb";
 
+// Skips binds of textures, buffers and programs that are already bound.
+const char kSkipRedundantGLBindings[]       = "skip-redundant-gl-bindings";
+
 // Disables the GPU shader on disk cache.
 const char kDisableGpuShaderDiskCache[]     = "disable-gpu-shader-disk-cache";
 
@@ -65,6 +72,7 @@ const char kEnableShareGroupAsyncTextureUpload[] =
     "enable-share-group-async-texture-upload";
 
 const char* kGpuSwitches[] = {
+  kCaptureGpuCommandBuffers,
   kCompileShaderAlwaysSucceeds,
   kDisableGLErrorLimit,
   kDisableGLSLTranslator,
@@ -80,6 +88,7 @@ const char* kGpuSwitches[] = {
   kForceSynchronousGLReadPixels,
   kGpuDriverBugWorkarounds,
   kGpuProgramCacheSizeKb,
+  kSkipRedundantGLBindings,
   kDisableGpuShaderDiskCache,
   kEnableShareGroupAsyncTextureUpload,
 };
@@ -11,6 +11,7 @@
 
 namespace switches {
 
+GPU_EXPORT extern const char kCaptureGpuCommandBuffers[];
 GPU_EXPORT extern const char kCompileShaderAlwaysSucceeds[];
 GPU_EXPORT extern const char kDisableGLErrorLimit[];
 GPU_EXPORT extern const char kDisableGLSLTranslator[];
@@ -26,6 +27,7 @@ GPU_EXPORT extern const char kForceGpuMemAvailableMb[];
 GPU_EXPORT extern const char kForceSynchronousGLReadPixels[];
 GPU_EXPORT extern const char kGpuDriverBugWorkarounds[];
 GPU_EXPORT extern const char kGpuProgramCacheSizeKb[];
+GPU_EXPORT extern const char kSkipRedundantGLBindings[];
 GPU_EXPORT extern const char kDisableGpuShaderDiskCache[];
 GPU_EXPORT extern const char kEnableShareGroupAsyncTextureUpload[];
 
@@ -93,12 +93,14 @@ class GPUTracerImpl
         gpu_trace_dev_category(TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(
             TRACE_DISABLED_BY_DEFAULT("gpu.device"))),
         gpu_executing_(false),
-        process_posted_(false) {}
+        process_posted_(false),
+        decodings_in_frame_(0) {}
   virtual ~GPUTracerImpl() {}
 
   // Implementation of gpu::gles2::GPUTracer
   virtual bool BeginDecoding() OVERRIDE;
   virtual bool EndDecoding() OVERRIDE;
+  virtual void EndFrame() OVERRIDE;
   virtual bool Begin(const std::string& name, GpuTracerSource source) OVERRIDE;
   virtual bool End(GpuTracerSource source) OVERRIDE;
   virtual const std::string& CurrentName() const OVERRIDE;
@@ -126,6 +128,7 @@ class GPUTracerImpl
 
   bool gpu_executing_;
   bool process_posted_;
+  int decodings_in_frame_;
 
   DISALLOW_COPY_AND_ASSIGN(GPUTracerImpl);
 };
@@ -218,6 +221,7 @@ bool GPUTracerImpl::BeginDecoding() {
     return false;
 
   gpu_executing_ = true;
+  ++decodings_in_frame_;
 
   if (IsTracing()) {
     // Begin a Trace for all active markers
@@ -250,6 +254,12 @@ bool GPUTracerImpl::EndDecoding() {
   return true;
 }
 
+void GPUTracerImpl::EndFrame() {
+  TRACE_COUNTER_ID1("gpu", "GPUTracer::FlushesPerFrame", this,
+                    decodings_in_frame_);
+  decodings_in_frame_ = 0;
+}
+
 bool GPUTracerImpl::Begin(const std::string& name, GpuTracerSource source) {
   if (!gpu_executing_)
     return false;
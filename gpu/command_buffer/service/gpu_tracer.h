@@ -40,6 +40,10 @@ class GPUTracer {
   // Scheduled processing in decoder ends.
   virtual bool EndDecoding() = 0;
 
+  // Called when the decoder swaps buffers, to trace how many times it was
+  // scheduled, and so how many flushes it took, to produce the frame.
+  virtual void EndFrame() = 0;
+
   // Begin a trace marker.
   virtual bool Begin(const std::string& name, GpuTracerSource source) = 0;
 
@@ -4,8 +4,11 @@
 
 #include "gpu/command_buffer/service/memory_program_cache.h"
 
+#include <algorithm>
+
 #include "base/base64.h"
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/metrics/histogram.h"
 #include "base/sha1.h"
 #include "base/strings/string_number_conversions.h"
@@ -148,7 +151,18 @@ ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
   if (found == store_.end()) {
     return PROGRAM_LOAD_FAILURE;
   }
+  if (found->second->is_serialized()) {
+    // Erase the serialized value first, as its destructor evicts the hash.
+    const std::string serialized_program = found->second->serialized_program();
+    store_.Erase(found);
+    if (!DecodeProgram(serialized_program))
+      return PROGRAM_LOAD_FAILURE;
+    found = store_.Get(sha_string);
+    if (found == store_.end())
+      return PROGRAM_LOAD_FAILURE;
+  }
   const scoped_refptr<ProgramCacheValue> value = found->second;
+  base::TimeTicks before_time = base::TimeTicks::HighResNow();
   glProgramBinary(program,
                   value->format(),
                   static_cast<const GLvoid*>(value->data()),
@@ -158,6 +172,20 @@ ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
   if (success == GL_FALSE) {
     return PROGRAM_LOAD_FAILURE;
   }
+  // Programs cached before link times were recorded have none.
+  if (value->link_time() > base::TimeDelta()) {
+    base::TimeDelta time_saved =
+        value->link_time() - (base::TimeTicks::HighResNow() - before_time);
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        "GPU.ProgramCache.LinkTimeSaved",
+        std::max(static_cast<int64>(0), time_saved.InMicroseconds()),
+        0,
+        base::TimeDelta::FromSeconds(10).InMicroseconds(),
+        50);
+    link_time_saved_ += time_saved;
+    TRACE_COUNTER_ID1("gpu", "MemoryProgramCache::LinkTimeSavedMs", this,
+                      link_time_saved_.InMilliseconds());
+  }
   shader_a->set_attrib_map(value->attrib_map_0());
   shader_a->set_uniform_map(value->uniform_map_0());
   shader_a->set_varying_map(value->varying_map_0());
@@ -173,6 +201,7 @@ ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
     proto->set_sha(sha, kHashLength);
     proto->set_format(value->format());
     proto->set_program(value->data(), value->length());
+    proto->set_link_time_us(value->link_time().InMicroseconds());
 
     FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a);
     FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b);
@@ -189,6 +218,7 @@ void MemoryProgramCache::SaveLinkedProgram(
     const Shader* shader_b,
     const ShaderTranslatorInterface* translator_b,
     const LocationMap* bind_attrib_location_map,
+    base::TimeDelta link_time,
     const ShaderCacheCallback& shader_callback) {
   GLenum format;
   GLsizei length = 0;
@@ -242,6 +272,7 @@ void MemoryProgramCache::SaveLinkedProgram(
     proto->set_sha(sha, kHashLength);
     proto->set_format(format);
     proto->set_program(binary.get(), length);
+    proto->set_link_time_us(link_time.InMicroseconds());
 
     FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a);
     FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b);
@@ -261,6 +292,7 @@ void MemoryProgramCache::SaveLinkedProgram(
                                    shader_b->attrib_map(),
                                    shader_b->uniform_map(),
                                    shader_b->varying_map(),
+                                   link_time,
                                    this));
 
   UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
@@ -268,6 +300,26 @@ void MemoryProgramCache::SaveLinkedProgram(
 }
 
 void MemoryProgramCache::LoadProgram(const std::string& program) {
+  GpuProgramHashProto hash_proto;
+  if (!hash_proto.ParseFromString(program) ||
+      hash_proto.sha().size() != kHashLength) {
+    LOG(ERROR) << "Failed to parse proto file.";
+    return;
+  }
+
+  // The same program may be in the disk caches of several profiles, and the
+  // copy already in memory is at least as recent.
+  if (store_.Peek(hash_proto.sha()) != store_.end())
+    return;
+
+  store_.Put(hash_proto.sha(),
+             new ProgramCacheValue(hash_proto.sha(), program, this));
+
+  UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
+                       curr_size_bytes_ / 1024);
+}
+
+bool MemoryProgramCache::DecodeProgram(const std::string& program) {
   scoped_ptr<GpuProgramProto> proto(GpuProgramProto::default_instance().New());
   if (proto->ParseFromString(program)) {
     ShaderTranslator::VariableMap vertex_attribs;
@@ -321,13 +373,13 @@ void MemoryProgramCache::LoadProgram(const std::string& program) {
                                      fragment_attribs,
                                      fragment_uniforms,
                                      fragment_varyings,
+                                     base::TimeDelta::FromMicroseconds(
+                                         proto->link_time_us()),
                                      this));
-
-    UMA_HISTOGRAM_COUNTS("GPU.ProgramCache.MemorySizeAfterKb",
-                         curr_size_bytes_ / 1024);
-  } else {
-    LOG(ERROR) << "Failed to parse proto file.";
+    return true;
   }
+  LOG(ERROR) << "Failed to parse proto file.";
+  return false;
 }
 
 MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
@@ -343,6 +395,7 @@ MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
     const ShaderTranslator::VariableMap& attrib_map_1,
     const ShaderTranslator::VariableMap& uniform_map_1,
     const ShaderTranslator::VariableMap& varying_map_1,
+    base::TimeDelta link_time,
     MemoryProgramCache* program_cache)
     : length_(length),
       format_(format),
@@ -356,7 +409,22 @@ MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
       attrib_map_1_(attrib_map_1),
       uniform_map_1_(uniform_map_1),
       varying_map_1_(varying_map_1),
+      link_time_(link_time),
+      program_cache_(program_cache) {
+  program_cache_->curr_size_bytes_ += length_;
+  program_cache_->LinkedProgramCacheSuccess(program_hash);
+}
+
+MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
+    const std::string& program_hash,
+    const std::string& serialized_program,
+    MemoryProgramCache* program_cache)
+    : length_(serialized_program.size()),
+      format_(0),
+      program_hash_(program_hash),
+      serialized_program_(serialized_program),
       program_cache_(program_cache) {
+  DCHECK(!serialized_program_.empty());
   program_cache_->curr_size_bytes_ += length_;
   program_cache_->LinkedProgramCacheSuccess(program_hash);
 }
@@ -12,6 +12,7 @@
 #include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
 #include "gpu/command_buffer/service/program_cache.h"
 #include "gpu/command_buffer/service/shader_translator.h"
@@ -19,7 +20,9 @@
 namespace gpu {
 namespace gles2 {
 
-// Program cache that stores binaries completely in-memory
+// Program cache that stores binaries completely in-memory.  Programs given to
+// LoadProgram() are kept serialized until first used, since most of those read
+// back from the disk cache at startup are never asked for.
 class GPU_EXPORT MemoryProgramCache : public ProgramCache {
  public:
   MemoryProgramCache();
@@ -41,6 +44,7 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
       const Shader* shader_b,
       const ShaderTranslatorInterface* translator_b,
       const LocationMap* bind_attrib_location_map,
+      base::TimeDelta link_time,
       const ShaderCacheCallback& shader_callback) OVERRIDE;
 
   virtual void LoadProgram(const std::string& program) OVERRIDE;
@@ -48,6 +52,9 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
  private:
   virtual void ClearBackend() OVERRIDE;
 
+  // Parses a serialized GpuProgramProto into the cache.
+  bool DecodeProgram(const std::string& program);
+
   class ProgramCacheValue : public base::RefCounted<ProgramCacheValue> {
    public:
     ProgramCacheValue(GLsizei length,
@@ -62,8 +69,22 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
                       const ShaderTranslator::VariableMap& attrib_map_1,
                       const ShaderTranslator::VariableMap& uniform_map_1,
                       const ShaderTranslator::VariableMap& varying_map_1,
+                      base::TimeDelta link_time,
+                      MemoryProgramCache* program_cache);
+
+    // Creates a value that holds |serialized_program| until it is decoded.
+    ProgramCacheValue(const std::string& program_hash,
+                      const std::string& serialized_program,
                       MemoryProgramCache* program_cache);
 
+    bool is_serialized() const {
+      return !serialized_program_.empty();
+    }
+
+    const std::string& serialized_program() const {
+      return serialized_program_;
+    }
+
     GLsizei length() const {
       return length_;
     }
@@ -108,6 +129,10 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
       return varying_map_1_;
     }
 
+    base::TimeDelta link_time() const {
+      return link_time_;
+    }
+
    private:
     friend class base::RefCounted<ProgramCacheValue>;
 
@@ -125,6 +150,8 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
     const ShaderTranslator::VariableMap attrib_map_1_;
     const ShaderTranslator::VariableMap uniform_map_1_;
     const ShaderTranslator::VariableMap varying_map_1_;
+    const base::TimeDelta link_time_;
+    const std::string serialized_program_;
     MemoryProgramCache* const program_cache_;
 
     DISALLOW_COPY_AND_ASSIGN(ProgramCacheValue);
@@ -139,6 +166,9 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
   size_t curr_size_bytes_;
   ProgramMRUCache store_;
 
+  // Link time saved by loading cached binaries, for tracing.
+  base::TimeDelta link_time_saved_;
+
   DISALLOW_COPY_AND_ASSIGN(MemoryProgramCache);
 };
 
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
+#include "gpu/command_buffer/service/disk_cache_proto.pb.h"
 #include "gpu/command_buffer/service/gl_utils.h"
 #include "gpu/command_buffer/service/shader_manager.h"
 #include "gpu/command_buffer/service/shader_translator.h"
@@ -203,7 +204,7 @@ TEST_F(MemoryProgramCacheTest, CacheSave) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -228,7 +229,7 @@ TEST_F(MemoryProgramCacheTest, LoadProgram) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -251,7 +252,7 @@ TEST_F(MemoryProgramCacheTest, LoadProgram) {
       NULL));
 }
 
-TEST_F(MemoryProgramCacheTest, CacheLoadMatchesSave) {
+TEST_F(MemoryProgramCacheTest, SaveRecordsLinkTime) {
   const GLenum kFormat = 1;
   const int kProgramId = 10;
   const int kBinaryLength = 20;
@@ -264,6 +265,39 @@ TEST_F(MemoryProgramCacheTest, CacheLoadMatchesSave) {
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
                             fragment_shader_, NULL, NULL,
+                            base::TimeDelta::FromMilliseconds(5),
+                            base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                                       base::Unretained(this)));
+  EXPECT_EQ(1, shader_cache_count());
+
+  GpuProgramProto proto;
+  ASSERT_TRUE(proto.ParseFromString(shader_cache_shader()));
+  EXPECT_EQ(5000, proto.link_time_us());
+}
+
+TEST_F(MemoryProgramCacheTest, LoadProgramIgnoresInvalidProgram) {
+  cache_->LoadProgram("not a program");
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, cache_->GetLinkedProgramStatus(
+      *vertex_shader_->signature_source(),
+      NULL,
+      *fragment_shader_->signature_source(),
+      NULL,
+      NULL));
+}
+
+TEST_F(MemoryProgramCacheTest, CacheLoadMatchesSave) {
+  const GLenum kFormat = 1;
+  const int kProgramId = 10;
+  const int kBinaryLength = 20;
+  char test_binary[kBinaryLength];
+  for (int i = 0; i < kBinaryLength; ++i) {
+    test_binary[i] = i;
+  }
+  ProgramBinaryEmulator emulator(kBinaryLength, kFormat, test_binary);
+
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
   EXPECT_EQ(1, shader_cache_count());
@@ -318,7 +352,7 @@ TEST_F(MemoryProgramCacheTest, LoadProgramMatchesSave) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
   EXPECT_EQ(1, shader_cache_count());
@@ -376,7 +410,7 @@ TEST_F(MemoryProgramCacheTest, LoadFailOnLinkFalse) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -404,7 +438,7 @@ TEST_F(MemoryProgramCacheTest, LoadFailOnDifferentSource) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -456,6 +490,7 @@ TEST_F(MemoryProgramCacheTest, LoadFailOnDifferentMap) {
                             fragment_shader_,
                             NULL,
                             &binding_map,
+                            base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -494,7 +529,7 @@ TEST_F(MemoryProgramCacheTest, MemoryProgramCacheEviction) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator1);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -523,6 +558,7 @@ TEST_F(MemoryProgramCacheTest, MemoryProgramCacheEviction) {
                             fragment_shader_,
                             NULL,
                             NULL,
+                            base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -553,7 +589,7 @@ TEST_F(MemoryProgramCacheTest, SaveCorrectProgram) {
   vertex_shader_->UpdateSource("different!");
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator1);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -577,7 +613,7 @@ TEST_F(MemoryProgramCacheTest, LoadCorrectProgram) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -614,7 +650,7 @@ TEST_F(MemoryProgramCacheTest, OverwriteOnNewSave) {
 
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -626,7 +662,7 @@ TEST_F(MemoryProgramCacheTest, OverwriteOnNewSave) {
   ProgramBinaryEmulator emulator2(kBinaryLength, kFormat, test_binary2);
   SetExpectationsForSaveLinkedProgram(kProgramId, &emulator2);
   cache_->SaveLinkedProgram(kProgramId, vertex_shader_, NULL,
-                            fragment_shader_, NULL, NULL,
+                            fragment_shader_, NULL, NULL, base::TimeDelta(),
                             base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
                                        base::Unretained(this)));
 
@@ -110,13 +110,14 @@ class MockProgramCache : public ProgramCache {
       const LocationMap* bind_attrib_location_map,
       const ShaderCacheCallback& callback));
 
-  MOCK_METHOD7(SaveLinkedProgram, void(
+  MOCK_METHOD8(SaveLinkedProgram, void(
       GLuint program,
       const Shader* shader_a,
       const ShaderTranslatorInterface* translator_a,
       const Shader* shader_b,
       const ShaderTranslatorInterface* translator_b,
       const LocationMap* bind_attrib_location_map,
+      base::TimeDelta link_time,
       const ShaderCacheCallback& callback));
   MOCK_METHOD1(LoadProgram, void(const std::string&));
 
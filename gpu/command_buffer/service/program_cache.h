@@ -10,6 +10,7 @@
 
 #include "base/containers/hash_tables.h"
 #include "base/sha1.h"
+#include "base/time/time.h"
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
 #include "gpu/command_buffer/service/shader_manager.h"
@@ -59,7 +60,8 @@ class GPU_EXPORT ProgramCache {
       const ShaderCacheCallback& shader_callback) = 0;
 
   // Saves the program into the cache.  If successful, the implementation should
-  // call LinkedProgramCacheSuccess.
+  // call LinkedProgramCacheSuccess.  |link_time| is how long linking the
+  // program took, so that loads can report the time they save.
   virtual void SaveLinkedProgram(
       GLuint program,
       const Shader* shader_a,
@@ -67,8 +69,11 @@ class GPU_EXPORT ProgramCache {
       const Shader* shader_b,
       const ShaderTranslatorInterface* translator_b,
       const LocationMap* bind_attrib_location_map,
+      base::TimeDelta link_time,
       const ShaderCacheCallback& shader_callback) = 0;
 
+  // Adds a program previously passed to a ShaderCacheCallback, e.g. one read
+  // back from the disk cache.
   virtual void LoadProgram(const std::string& program) = 0;
 
   // clears the cache
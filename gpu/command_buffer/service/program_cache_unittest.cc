@@ -32,6 +32,7 @@ class NoBackendProgramCache : public ProgramCache {
       const Shader* /* shader_b */,
       const ShaderTranslatorInterface* /* translator_b */,
       const LocationMap* /* bind_attrib_location_map */,
+      base::TimeDelta /* link_time */,
       const ShaderCacheCallback& /* callback */) OVERRIDE { }
 
   virtual void LoadProgram(const std::string& /* program */) OVERRIDE {}
@@ -608,6 +608,7 @@ bool Program::Link(ShaderManager* manager,
                                  attached_shaders_[1].get(),
                                  fragment_translator,
                                  &bind_attrib_location_map_,
+                                 TimeTicks::HighResNow() - before_time,
                                  shader_callback);
       }
       UMA_HISTOGRAM_CUSTOM_COUNTS(
@@ -1647,6 +1647,7 @@ class ProgramManagerWithCacheTest : public testing::Test {
         fragment_shader,
         NULL,
         &program->bind_attrib_location_map(),
+        _,
         _)).Times(1);
   }
 
@@ -1667,6 +1668,7 @@ class ProgramManagerWithCacheTest : public testing::Test {
         fragment_shader,
         NULL,
         &program->bind_attrib_location_map(),
+        _,
         _)).Times(0);
   }
 
@@ -10,12 +10,16 @@
 #include "base/at_exit.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/sha1.h"
 #include "base/strings/string_number_conversions.h"
 
 namespace {
 
 using gpu::gles2::ShaderTranslator;
 
+// Number of translations each translator keeps results for.
+const size_t kMaxCachedTranslations = 128;
+
 void FinalizeShaderTranslator(void* /* dummy */) {
   TRACE_EVENT0("gpu", "ShFinalize");
   ShFinalize();
@@ -84,6 +88,15 @@ void GetVariableInfo(ShHandle compiler, ShShaderInfo var_type,
   }
 }
 
+// Returns a NULL terminated copy of |str|, or NULL if it is empty.
+char* CopyToCharArray(const std::string& str) {
+  if (str.empty())
+    return NULL;
+  char* copy = new char[str.size() + 1];
+  memcpy(copy, str.c_str(), str.size() + 1);
+  return copy;
+}
+
 void GetNameHashingInfo(
     ShHandle compiler, ShaderTranslator::NameMap* name_map) {
   ANGLEGetInfoType hashed_names_count = 0;
@@ -115,10 +128,18 @@ ShaderTranslator::DestructionObserver::DestructionObserver() {
 ShaderTranslator::DestructionObserver::~DestructionObserver() {
 }
 
+ShaderTranslator::TranslationResult::TranslationResult()
+    : success(false) {
+}
+
+ShaderTranslator::TranslationResult::~TranslationResult() {
+}
+
 ShaderTranslator::ShaderTranslator()
     : compiler_(NULL),
       implementation_is_glsl_es_(false),
-      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)) {
+      driver_bug_workarounds_(static_cast<ShCompileOptions>(0)),
+      result_cache_(kMaxCachedTranslations) {
 }
 
 bool ShaderTranslator::Init(
@@ -169,6 +190,14 @@ bool ShaderTranslator::Translate(const char* shader) {
   DCHECK(shader != NULL);
   ClearResults();
 
+  const std::string source_hash = base::SHA1HashString(shader);
+  ResultCache::iterator cached = result_cache_.Get(source_hash);
+  if (cached != result_cache_.end()) {
+    TRACE_EVENT0("gpu", "ShaderTranslator::Translate cached");
+    RestoreResults(*cached->second);
+    return cached->second->success;
+  }
+
   bool success = false;
   {
     TRACE_EVENT0("gpu", "ShCompile");
@@ -200,6 +229,7 @@ bool ShaderTranslator::Translate(const char* shader) {
     info_log_.reset();
   }
 
+  CacheResults(source_hash, success);
   return success;
 }
 
@@ -306,6 +336,30 @@ ShaderTranslator::~ShaderTranslator() {
     ShDestruct(compiler_);
 }
 
+void ShaderTranslator::CacheResults(const std::string& source_hash,
+                                    bool success) {
+  TranslationResult* result = new TranslationResult;
+  result->success = success;
+  if (translated_shader_)
+    result->translated_shader = translated_shader_.get();
+  if (info_log_)
+    result->info_log = info_log_.get();
+  result->attrib_map = attrib_map_;
+  result->uniform_map = uniform_map_;
+  result->varying_map = varying_map_;
+  result->name_map = name_map_;
+  result_cache_.Put(source_hash, result);
+}
+
+void ShaderTranslator::RestoreResults(const TranslationResult& result) {
+  translated_shader_.reset(CopyToCharArray(result.translated_shader));
+  info_log_.reset(CopyToCharArray(result.info_log));
+  attrib_map_ = result.attrib_map;
+  uniform_map_ = result.uniform_map;
+  varying_map_ = result.varying_map;
+  name_map_ = result.name_map;
+}
+
 void ShaderTranslator::ClearResults() {
   translated_shader_.reset();
   info_log_.reset();
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
@@ -96,7 +97,11 @@ class ShaderTranslatorInterface {
   virtual ~ShaderTranslatorInterface() {}
 };
 
-// Implementation of ShaderTranslatorInterface
+// Implementation of ShaderTranslatorInterface.  The results of recent
+// translations are kept, keyed by a hash of the source, so translating the
+// same source again does not run ANGLE.  Since ShaderTranslatorCache shares
+// translators between decoders with the same options and resources, this
+// also covers identical shaders compiled by different contexts.
 class GPU_EXPORT ShaderTranslator
     : public base::RefCounted<ShaderTranslator>,
       NON_EXPORTED_BASE(public ShaderTranslatorInterface) {
@@ -144,10 +149,32 @@ class GPU_EXPORT ShaderTranslator
  private:
   friend class base::RefCounted<ShaderTranslator>;
 
+  // The results of one translation.
+  struct TranslationResult {
+    TranslationResult();
+    ~TranslationResult();
+
+    bool success;
+    // Empty where the corresponding accessor returns NULL.
+    std::string translated_shader;
+    std::string info_log;
+    VariableMap attrib_map;
+    VariableMap uniform_map;
+    VariableMap varying_map;
+    NameMap name_map;
+  };
+
+  typedef base::OwningMRUCache<std::string, TranslationResult*> ResultCache;
+
   virtual ~ShaderTranslator();
   void ClearResults();
   int GetCompileOptions() const;
 
+  // Keeps the results of the last translation under |source_hash|.
+  void CacheResults(const std::string& source_hash, bool success);
+  // Makes |result| the results of the last translation.
+  void RestoreResults(const TranslationResult& result);
+
   ShHandle compiler_;
   ShBuiltInResources compiler_options_;
   scoped_ptr<char[]> translated_shader_;
@@ -158,6 +185,7 @@ class GPU_EXPORT ShaderTranslator
   NameMap name_map_;
   bool implementation_is_glsl_es_;
   ShCompileOptions driver_bug_workarounds_;
+  ResultCache result_cache_;
   ObserverList<DestructionObserver> destruction_observers_;
 
   DISALLOW_COPY_AND_ASSIGN(ShaderTranslator);
@@ -131,6 +131,40 @@ TEST_F(ShaderTranslatorTest, InvalidFragmentShader) {
   EXPECT_TRUE(fragment_translator_->uniform_map().empty());
 }
 
+TEST_F(ShaderTranslatorTest, TranslateSameSourceAgain) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "void main() {\n"
+      "  gl_Position = vPosition;\n"
+      "}";
+  const char* bad_shader = "foo-bar";
+
+  EXPECT_TRUE(vertex_translator_->Translate(shader));
+  ASSERT_TRUE(vertex_translator_->translated_shader() != NULL);
+  std::string translated_shader(vertex_translator_->translated_shader());
+  ShaderTranslator::VariableMap attrib_map(vertex_translator_->attrib_map());
+  EXPECT_EQ(1u, attrib_map.size());
+
+  EXPECT_FALSE(vertex_translator_->Translate(bad_shader));
+  ASSERT_TRUE(vertex_translator_->info_log() != NULL);
+  std::string info_log(vertex_translator_->info_log());
+
+  // The cached results must match those of the first translations.
+  EXPECT_TRUE(vertex_translator_->Translate(shader));
+  ASSERT_TRUE(vertex_translator_->translated_shader() != NULL);
+  EXPECT_EQ(translated_shader, vertex_translator_->translated_shader());
+  EXPECT_TRUE(vertex_translator_->info_log() == NULL);
+  EXPECT_EQ(1u, vertex_translator_->attrib_map().size());
+  EXPECT_TRUE(vertex_translator_->attrib_map().find("vPosition") !=
+              vertex_translator_->attrib_map().end());
+
+  EXPECT_FALSE(vertex_translator_->Translate(bad_shader));
+  EXPECT_TRUE(vertex_translator_->translated_shader() == NULL);
+  ASSERT_TRUE(vertex_translator_->info_log() != NULL);
+  EXPECT_EQ(info_log, vertex_translator_->info_log());
+  EXPECT_TRUE(vertex_translator_->attrib_map().empty());
+}
+
 TEST_F(ShaderTranslatorTest, GetAttributes) {
   const char* shader =
       "attribute vec4 vPosition;\n"
@@ -0,0 +1,273 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays command buffers recorded with --capture-gpu-command-buffers
+// against GLES2DecoderImpl and reports how long the decoder spent on each
+// command. Recordings are read from the directory passed with
+// --command-buffer-recordings.
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/command_buffer/service/cmd_parser.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+#include "gpu/command_buffer/service/context_group.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/gpu_scheduler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "ui/gfx/size.h"
+#include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gl_surface.h"
+
+namespace gpu {
+
+namespace {
+
+const char kRecordingsSwitch[] = "command-buffer-recordings";
+const base::FilePath::CharType kRecordingPattern[] =
+    FILE_PATH_LITERAL("*.gpucap");
+
+struct CommandStats {
+  CommandStats() : count(0) {}
+
+  size_t count;
+  base::TimeDelta time;
+};
+
+// Forwards commands to the decoder, timing each of them.
+class TimingCommandHandler : public AsyncAPIInterface {
+ public:
+  typedef std::map<unsigned int, CommandStats> StatsMap;
+
+  explicit TimingCommandHandler(AsyncAPIInterface* handler)
+      : handler_(handler) {
+  }
+  virtual ~TimingCommandHandler() {
+  }
+
+  // AsyncAPIInterface implementation:
+  virtual error::Error DoCommand(unsigned int command,
+                                 unsigned int arg_count,
+                                 const void* cmd_data) OVERRIDE {
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    error::Error result = handler_->DoCommand(command, arg_count, cmd_data);
+    CommandStats& stats = stats_[command];
+    ++stats.count;
+    stats.time += base::TimeTicks::HighResNow() - start;
+    return result;
+  }
+  virtual const char* GetCommandName(unsigned int command_id) const OVERRIDE {
+    return handler_->GetCommandName(command_id);
+  }
+
+  const StatsMap& stats() const { return stats_; }
+
+ private:
+  AsyncAPIInterface* handler_;
+  StatsMap stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimingCommandHandler);
+};
+
+// Reads the records of a recording in order.
+class RecordingReader {
+ public:
+  explicit RecordingReader(const std::string& data)
+      : data_(data),
+        position_(0) {
+  }
+
+  bool ReadHeader() {
+    uint32 magic = 0;
+    uint32 version = 0;
+    return Read(&magic, sizeof(magic)) &&
+           magic == kCommandBufferRecordingMagic &&
+           Read(&version, sizeof(version)) &&
+           version == kCommandBufferRecordingVersion;
+  }
+
+  bool AtEnd() const { return position_ == data_.size(); }
+
+  // Returns false if the recording is truncated. |payload| points into the
+  // recording for kTransferBufferData records, and is NULL otherwise.
+  bool ReadRecord(CommandBufferRecord* record, const char** payload) {
+    if (!Read(record, sizeof(*record)))
+      return false;
+    *payload = NULL;
+    if (record->type != CommandBufferRecord::kTransferBufferData)
+      return true;
+    if (data_.size() - position_ < record->size)
+      return false;
+    *payload = data_.data() + position_;
+    position_ += record->size;
+    return true;
+  }
+
+ private:
+  bool Read(void* out, size_t size) {
+    if (data_.size() - position_ < size)
+      return false;
+    memcpy(out, data_.data() + position_, size);
+    position_ += size;
+    return true;
+  }
+
+  const std::string& data_;
+  size_t position_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingReader);
+};
+
+class CommandBufferReplayTest : public testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    gfx::GLSurface::InitializeOneOff();
+  }
+
+  virtual void SetUp() OVERRIDE {
+    surface_ = gfx::GLSurface::CreateOffscreenGLSurface(gfx::Size(1, 1));
+    ASSERT_TRUE(surface_.get());
+    context_ = gfx::GLContext::CreateGLContext(NULL, surface_.get(),
+                                               gfx::PreferDiscreteGpu);
+    ASSERT_TRUE(context_.get());
+    ASSERT_TRUE(context_->MakeCurrent(surface_.get()));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    context_ = NULL;
+    surface_ = NULL;
+  }
+
+  // Replays the recording at |path| in a new context, and prints the time
+  // spent in each command.
+  void Replay(const base::FilePath& path);
+
+  base::MessageLoop message_loop_;
+  scoped_refptr<gfx::GLSurface> surface_;
+  scoped_refptr<gfx::GLContext> context_;
+};
+
+void CommandBufferReplayTest::Replay(const base::FilePath& path) {
+  std::string data;
+  ASSERT_TRUE(base::ReadFileToString(path, &data)) << path.value();
+  RecordingReader reader(data);
+  ASSERT_TRUE(reader.ReadHeader()) << path.value();
+
+  scoped_refptr<gles2::ContextGroup> group(
+      new gles2::ContextGroup(NULL, NULL, NULL, NULL, true));
+  scoped_ptr<gles2::GLES2Decoder> decoder(
+      gles2::GLES2Decoder::Create(group.get()));
+  CommandBufferService command_buffer(group->transfer_buffer_manager());
+  ASSERT_TRUE(command_buffer.Initialize());
+  TimingCommandHandler handler(decoder.get());
+  GpuScheduler scheduler(&command_buffer, &handler, decoder.get());
+  decoder->set_engine(&scheduler);
+
+  std::vector<int32> attribs;
+  gles2::ContextCreationAttribHelper attrib_helper;
+  attrib_helper.Serialize(&attribs);
+  ASSERT_TRUE(decoder->Initialize(surface_,
+                                  context_,
+                                  true,
+                                  gfx::Size(1, 1),
+                                  gles2::DisallowedFeatures(),
+                                  attribs));
+  command_buffer.SetPutOffsetChangeCallback(
+      base::Bind(&GpuScheduler::PutChanged, base::Unretained(&scheduler)));
+  command_buffer.SetGetBufferChangeCallback(
+      base::Bind(&GpuScheduler::SetGetBuffer, base::Unretained(&scheduler)));
+
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  while (!reader.AtEnd()) {
+    CommandBufferRecord record;
+    const char* payload = NULL;
+    ASSERT_TRUE(reader.ReadRecord(&record, &payload)) << path.value();
+    switch (record.type) {
+      case CommandBufferRecord::kRegisterTransferBuffer: {
+        base::SharedMemory shared_memory;
+        ASSERT_TRUE(shared_memory.CreateAnonymous(record.size));
+        ASSERT_TRUE(command_buffer.RegisterTransferBuffer(
+            record.id, &shared_memory, record.size));
+        break;
+      }
+      case CommandBufferRecord::kTransferBufferData: {
+        Buffer buffer = command_buffer.GetTransferBuffer(record.id);
+        ASSERT_TRUE(buffer.ptr);
+        ASSERT_LE(record.offset, buffer.size);
+        ASSERT_LE(record.size, buffer.size - record.offset);
+        memcpy(static_cast<char*>(buffer.ptr) + record.offset, payload,
+               record.size);
+        break;
+      }
+      case CommandBufferRecord::kDestroyTransferBuffer:
+        command_buffer.DestroyTransferBuffer(record.id);
+        break;
+      case CommandBufferRecord::kSetGetBuffer:
+        command_buffer.SetGetBuffer(record.id);
+        break;
+      case CommandBufferRecord::kFlush:
+        command_buffer.Flush(record.offset);
+        ASSERT_EQ(error::kNoError, command_buffer.GetState().error)
+            << path.value();
+        break;
+      default:
+        FAIL() << "Unknown record type " << record.type;
+    }
+  }
+  decoder->MakeCurrent();
+  glFinish();
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+
+  std::string trace = path.BaseName().MaybeAsASCII();
+  perf_test::PrintResult("replay_time", "", trace,
+                         elapsed.InMillisecondsF(), "ms", true);
+  const TimingCommandHandler::StatsMap& stats = handler.stats();
+  for (TimingCommandHandler::StatsMap::const_iterator it = stats.begin();
+       it != stats.end(); ++it) {
+    std::string name = handler.GetCommandName(it->first);
+    perf_test::PrintResult("command_time", "_" + name, trace,
+                           it->second.time.InMillisecondsF(), "ms", false);
+    perf_test::PrintResult("command_count", "_" + name, trace,
+                           it->second.count, "count", false);
+  }
+
+  decoder->Destroy(true);
+}
+
+TEST_F(CommandBufferReplayTest, ReplayRecordings) {
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (!command_line->HasSwitch(kRecordingsSwitch)) {
+    LOG(INFO) << "No recordings to replay, pass --" << kRecordingsSwitch;
+    return;
+  }
+
+  base::FileEnumerator enumerator(
+      command_line->GetSwitchValuePath(kRecordingsSwitch),
+      false,
+      base::FileEnumerator::FILES,
+      kRecordingPattern);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    Replay(path);
+  }
+}
+
+}  // namespace
+
+}  // namespace gpu
@@ -48,6 +48,8 @@
         'ipc_channel_posix_unittest.cc',
         'ipc_channel_unittest.cc',
         'ipc_fuzzing_tests.cc',
+        'ipc_message_filter_router_unittest.cc',
+        'ipc_message_ring_unittest.cc',
         'ipc_message_unittest.cc',
         'ipc_message_utils_unittest.cc',
         'ipc_send_fds_test.cc',
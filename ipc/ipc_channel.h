@@ -90,7 +90,14 @@ class IPC_EXPORT Channel : public Sender {
     // The client will return the message with hops = 1, *after* it
     // has received the message that contains the FD. When we
     // receive it again on the sender side, we close the FD.
-    CLOSE_FD_MESSAGE_TYPE = HELLO_MESSAGE_TYPE - 1
+    CLOSE_FD_MESSAGE_TYPE = HELLO_MESSAGE_TYPE - 1,
+    // The MESSAGE_RING_MESSAGE_TYPE hands the peer a shared memory ring that
+    // this side will send some of its messages through, see
+    // EnableMessageRing(). It carries the ring's capacity and handle.
+    MESSAGE_RING_MESSAGE_TYPE = CLOSE_FD_MESSAGE_TYPE - 1,
+    // The MESSAGE_RING_WAKEUP_MESSAGE_TYPE tells the peer, which had stopped
+    // polling the ring, that there are new messages in it.
+    MESSAGE_RING_WAKEUP_MESSAGE_TYPE = MESSAGE_RING_MESSAGE_TYPE - 1
   };
 
   // The maximum message size in bytes. Attempting to receive a message of this
@@ -180,6 +187,14 @@ class IPC_EXPORT Channel : public Sender {
   // Closes any currently connected socket, and returns to a listening state
   // for more connections.
   void ResetToAcceptingConnectionState();
+
+  // Sends messages without file descriptors through a shared memory ring of
+  // |capacity| bytes rather than the socket, once connected. The peer only
+  // has to be woken up over the socket when it has stopped polling the ring,
+  // which saves a syscall per message for chatty channels. The ring is
+  // handed to the peer on each connection. Returns false if |capacity| isn't
+  // a valid MessageRing capacity.
+  bool EnableMessageRing(size_t capacity);
 #endif  // defined(OS_POSIX) && !defined(OS_NACL)
 
   // Returns true if a named server channel is initialized on the given channel
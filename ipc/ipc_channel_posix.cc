@@ -10,13 +10,10 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
-#if defined(OS_OPENBSD)
-#include <sys/uio.h>
-#endif
-
 #include <map>
 #include <string>
 
@@ -38,6 +35,8 @@
 #include "ipc/ipc_descriptors.h"
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_macros.h"
+#include "ipc/ipc_message_ring.h"
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_switches.h"
 #include "ipc/unix_domain_socket_util.h"
@@ -158,6 +157,9 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// Most queued messages written with one writev() or sendmsg().
+const size_t kMaxMessagesPerWrite = 16;
+
 }  // namespace
 //------------------------------------------------------------------------------
 
@@ -181,6 +183,10 @@ Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
       remote_fd_pipe_(-1),
 #endif  // IPC_USES_READWRITE
       pipe_name_(channel_handle.name),
+      message_ring_capacity_(0),
+      socket_messages_sent_(0),
+      socket_messages_received_(0),
+      incoming_ring_failed_(false),
       must_unlink_(false) {
   memset(input_cmsg_buf_, 0, sizeof(input_cmsg_buf_));
   if (!CreatePipe(channel_handle)) {
@@ -382,6 +388,24 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
   while (!output_queue_.empty()) {
     Message* msg = output_queue_.front();
 
+    // Send runs of small messages without descriptors in one system call.
+    if (output_queue_.size() > 1 && msg->file_descriptor_set()->empty()) {
+      bool blocked = false;
+      if (!WriteMessageBatch(&blocked))
+        return false;
+      if (blocked) {
+        is_blocked_on_write_ = true;
+        base::MessageLoopForIO::current()->WatchFileDescriptor(
+            pipe_,
+            false,  // One shot
+            base::MessageLoopForIO::WATCH_WRITE,
+            &write_watcher_,
+            this);
+        return true;
+      }
+      continue;
+    }
+
     size_t amt_to_write = msg->size() - message_send_bytes_written_;
     DCHECK_NE(0U, amt_to_write);
     const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
@@ -508,12 +532,73 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       DVLOG(2) << "sent message @" << msg << " on channel @" << this
                << " with type " << msg->type() << " on fd " << pipe_;
       delete output_queue_.front();
-      output_queue_.pop();
+      output_queue_.pop_front();
     }
   }
   return true;
 }
 
+bool Channel::ChannelImpl::WriteMessageBatch(bool* blocked) {
+  struct iovec iov[kMaxMessagesPerWrite];
+  size_t iov_count = 0;
+  size_t amt_to_write = 0;
+  for (std::deque<Message*>::const_iterator it = output_queue_.begin();
+       it != output_queue_.end() && iov_count < kMaxMessagesPerWrite; ++it) {
+    const Message* msg = *it;
+    if (!msg->file_descriptor_set()->empty())
+      break;
+    size_t offset = iov_count == 0 ? message_send_bytes_written_ : 0;
+    iov[iov_count].iov_base =
+        const_cast<char*>(reinterpret_cast<const char*>(msg->data())) +
+        offset;
+    iov[iov_count].iov_len = msg->size() - offset;
+    amt_to_write += iov[iov_count].iov_len;
+    ++iov_count;
+  }
+  DCHECK_NE(0U, iov_count);
+
+#if defined(IPC_USES_READWRITE)
+  ssize_t bytes_written = HANDLE_EINTR(writev(pipe_, iov, iov_count));
+#else
+  struct msghdr msgh = {0};
+  msgh.msg_iov = iov;
+  msgh.msg_iovlen = iov_count;
+  ssize_t bytes_written = HANDLE_EINTR(sendmsg(pipe_, &msgh, MSG_DONTWAIT));
+#endif  // IPC_USES_READWRITE
+
+  if (bytes_written < 0 && !SocketWriteErrorIsRecoverable()) {
+    // As in ProcessOutgoingMessages(), the caller closes the pipe.
+#if defined(OS_MACOSX)
+    if (errno == EPERM)
+      return false;
+#endif  // OS_MACOSX
+    if (errno == EPIPE)
+      return false;
+    PLOG(ERROR) << "pipe error on " << pipe_
+                << " Currently writing " << iov_count << " messages of size: "
+                << amt_to_write;
+    return false;
+  }
+
+  *blocked = static_cast<size_t>(bytes_written) != amt_to_write;
+  size_t bytes_left = bytes_written > 0 ? bytes_written : 0;
+  while (bytes_left > 0) {
+    Message* msg = output_queue_.front();
+    size_t msg_bytes_left = msg->size() - message_send_bytes_written_;
+    if (bytes_left < msg_bytes_left) {
+      message_send_bytes_written_ += bytes_left;
+      break;
+    }
+    bytes_left -= msg_bytes_left;
+    message_send_bytes_written_ = 0;
+    DVLOG(2) << "sent message @" << msg << " on channel @" << this
+             << " with type " << msg->type() << " on fd " << pipe_;
+    delete msg;
+    output_queue_.pop_front();
+  }
+  return true;
+}
+
 bool Channel::ChannelImpl::Send(Message* message) {
   DVLOG(2) << "sending message @" << message << " on channel @" << this
            << " with type " << message->type()
@@ -524,7 +609,19 @@ bool Channel::ChannelImpl::Send(Message* message) {
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
   message->TraceMessageBegin();
-  output_queue_.push(message);
+  bool wake_reader = false;
+  if (outgoing_ring_ && !message->HasFileDescriptors() &&
+      !IsInternalMessage(*message) &&
+      outgoing_ring_->Write(*message, socket_messages_sent_, &wake_reader)) {
+    delete message;
+    if (!wake_reader)
+      return true;
+    QueueMessage(new Message(MSG_ROUTING_NONE,
+                             MESSAGE_RING_WAKEUP_MESSAGE_TYPE,
+                             IPC::Message::PRIORITY_NORMAL));
+  } else {
+    QueueMessage(message);
+  }
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -594,10 +691,15 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
+  // The next connection gets rings of its own.
+  outgoing_ring_.reset();
+  incoming_ring_.reset();
+  incoming_ring_failed_ = false;
+
   // Close any outstanding, received file descriptors.
   ClearInputFDs();
 
@@ -613,6 +715,23 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 #endif
 }
 
+bool Channel::ChannelImpl::EnableMessageRing(size_t capacity) {
+  if (!MessageRing::IsValidCapacity(capacity))
+    return false;
+  message_ring_capacity_ = capacity;
+
+  // Otherwise the ring is set up once the peer's hello message arrives, after
+  // ours has been queued.
+  if (pipe_ == -1 || peer_pid_ == base::kNullProcessId || outgoing_ring_)
+    return true;
+  SetUpOutgoingMessageRing();
+  if (!is_blocked_on_write_ && !waiting_connect_ &&
+      !ProcessOutgoingMessages()) {
+    ClosePipeOnError();
+  }
+  return true;
+}
+
 // static
 bool Channel::ChannelImpl::IsNamedServerInitialized(
     const std::string& channel_id) {
@@ -764,7 +883,7 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  QueueMessage(msg.release());
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -851,6 +970,16 @@ bool Channel::ChannelImpl::ReadFileDescriptorsFromFDPipe() {
 // This will read from the input_fds_ (READWRITE mode only) and read more
 // handles from the FD pipe if necessary.
 bool Channel::ChannelImpl::WillDispatchInputMessage(Message* msg) {
+  if (incoming_ring_failed_)
+    return false;
+  if (incoming_ring_) {
+    // Messages that went through the ring before this one was sent come
+    // first.
+    if (!DispatchRingMessages(socket_messages_received_))
+      return false;
+    ++socket_messages_received_;
+  }
+
   uint16 header_fds = msg->header()->num_fds;
   if (!header_fds)
     return true;  // Nothing to do.
@@ -891,6 +1020,11 @@ bool Channel::ChannelImpl::WillDispatchInputMessage(Message* msg) {
 }
 
 bool Channel::ChannelImpl::DidEmptyInputBuffers() {
+  if (incoming_ring_failed_)
+    return false;
+  if (incoming_ring_ && !DispatchRingMessages(socket_messages_received_))
+    return false;
+
   // When the input data buffer is empty, the fds should be too. If this is
   // not the case, we probably have a rogue renderer which is trying to fill
   // our descriptor table.
@@ -949,7 +1083,7 @@ void Channel::ChannelImpl::QueueCloseFDMessage(int fd, int hops) {
         NOTREACHED() << "Unable to pickle close fd.";
       }
       // Send(msg.release());
-      output_queue_.push(msg.release());
+      QueueMessage(msg.release());
       break;
     }
 
@@ -959,6 +1093,76 @@ void Channel::ChannelImpl::QueueCloseFDMessage(int fd, int hops) {
   }
 }
 
+void Channel::ChannelImpl::QueueMessage(Message* message) {
+  output_queue_.push_back(message);
+  if (outgoing_ring_)
+    ++socket_messages_sent_;
+}
+
+void Channel::ChannelImpl::SetUpOutgoingMessageRing() {
+  DCHECK(!outgoing_ring_);
+  scoped_ptr<MessageRing> ring(MessageRing::Create(message_ring_capacity_));
+  if (!ring) {
+    LOG(WARNING) << "Unable to create message ring, using the socket only";
+    return;
+  }
+
+  scoped_ptr<Message> msg(new Message(MSG_ROUTING_NONE,
+                                      MESSAGE_RING_MESSAGE_TYPE,
+                                      IPC::Message::PRIORITY_NORMAL));
+  if (!msg->WriteInt(static_cast<int>(ring->capacity())) ||
+      !msg->WriteFileDescriptor(base::FileDescriptor(ring->handle().fd,
+                                                     false))) {
+    NOTREACHED() << "Unable to pickle message ring";
+    return;
+  }
+  outgoing_ring_ = ring.Pass();
+  socket_messages_sent_ = 0;
+  QueueMessage(msg.release());
+}
+
+bool Channel::ChannelImpl::DispatchRingMessages(uint32 max_sequence) {
+  while (true) {
+    switch (incoming_ring_->Read(max_sequence, &ring_message_buf_)) {
+      case MessageRing::READ_MESSAGE:
+        break;
+      case MessageRing::READ_EMPTY:
+        // Ask to be woken up for the next message, unless it beat us to it.
+        if (incoming_ring_->SetReaderIdle())
+          return true;
+        continue;
+      case MessageRing::READ_LATER:
+        // The next message waits for one on the socket, which wakes us up.
+        return true;
+      case MessageRing::READ_ERROR:
+        LOG(ERROR) << "Message ring is corrupt"
+                   << " channel:" << this;
+        return false;
+    }
+
+    const char* data = ring_message_buf_.data();
+    const char* end = data + ring_message_buf_.size();
+    if (Message::FindNext(data, end) != end) {
+      LOG(ERROR) << "Invalid message in message ring"
+                 << " channel:" << this;
+      return false;
+    }
+    Message m(data, static_cast<int>(ring_message_buf_.size()));
+    if (m.header()->num_fds || IsInternalMessage(m)) {
+      LOG(WARNING) << "Message ring carries a socket-only message"
+                   << " channel:" << this
+                   << " message-type:" << m.type();
+      return false;
+    }
+
+    TRACE_EVENT2("toplevel", "ChannelImpl::DispatchRingMessages",
+                 "class", IPC_MESSAGE_ID_CLASS(m.type()),
+                 "line", IPC_MESSAGE_ID_LINE(m.type()));
+    m.TraceMessageEnd();
+    listener()->OnMessageReceived(m);
+  }
+}
+
 void Channel::ChannelImpl::HandleInternalMessage(const Message& msg) {
   // The Hello message contains only the process id.
   PickleIterator iter(msg);
@@ -988,9 +1192,33 @@ void Channel::ChannelImpl::HandleInternalMessage(const Message& msg) {
       }
 #endif  // IPC_USES_READWRITE
       peer_pid_ = pid;
+      if (message_ring_capacity_ && !outgoing_ring_)
+        SetUpOutgoingMessageRing();
       listener()->OnChannelConnected(pid);
       break;
 
+    case Channel::MESSAGE_RING_MESSAGE_TYPE: {
+      int capacity;
+      base::FileDescriptor descriptor;
+      if (!msg.ReadInt(&iter, &capacity) ||
+          !msg.ReadFileDescriptor(&iter, &descriptor)) {
+        incoming_ring_failed_ = true;
+        break;
+      }
+      incoming_ring_ = MessageRing::Open(descriptor, capacity);
+      if (!incoming_ring_) {
+        incoming_ring_failed_ = true;
+        break;
+      }
+      // The hand-off message itself was the first socket message.
+      socket_messages_received_ = 1;
+      break;
+    }
+
+    case Channel::MESSAGE_RING_WAKEUP_MESSAGE_TYPE:
+      // The ring has been drained up to here before this was dispatched.
+      break;
+
 #if defined(OS_MACOSX)
     case Channel::CLOSE_FD_MESSAGE_TYPE:
       int fd, hops;
@@ -1086,6 +1314,10 @@ void Channel::ResetToAcceptingConnectionState() {
   channel_impl_->ResetToAcceptingConnectionState();
 }
 
+bool Channel::EnableMessageRing(size_t capacity) {
+  return channel_impl_->EnableMessageRing(capacity);
+}
+
 // static
 bool Channel::IsNamedServerInitialized(const std::string& channel_id) {
   return ChannelImpl::IsNamedServerInitialized(channel_id);
@@ -9,11 +9,12 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/process/process.h"
 #include "ipc/file_descriptor_set_posix.h"
@@ -49,6 +50,8 @@
 
 namespace IPC {
 
+class MessageRing;
+
 class Channel::ChannelImpl : public internal::ChannelReader,
                              public base::MessageLoopForIO::Watcher {
  public:
@@ -66,6 +69,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   bool HasAcceptedConnection() const;
   bool GetPeerEuid(uid_t* peer_euid) const;
   void ResetToAcceptingConnectionState();
+  bool EnableMessageRing(size_t capacity);
   base::ProcessId peer_pid() const { return peer_pid_; }
   static bool IsNamedServerInitialized(const std::string& channel_id);
 #if defined(OS_LINUX)
@@ -77,6 +81,12 @@ class Channel::ChannelImpl : public internal::ChannelReader,
 
   bool ProcessOutgoingMessages();
 
+  // Writes the messages at the front of the queue that carry no file
+  // descriptors with a single writev() or sendmsg(), as far as the socket
+  // buffer allows. Sets |*blocked| if not all of them could be written.
+  // Returns false on a channel error.
+  bool WriteMessageBatch(bool* blocked);
+
   bool AcceptConnection();
   void ClosePipeOnError();
   int GetHelloMessageProcId();
@@ -84,6 +94,17 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   void CloseFileDescriptors(Message* msg);
   void QueueCloseFDMessage(int fd, int hops);
 
+  // Adds |message| to the output queue, counting it for the message ring.
+  void QueueMessage(Message* message);
+
+  // Creates the outgoing message ring and queues the message that hands it
+  // to the peer.
+  void SetUpOutgoingMessageRing();
+
+  // Dispatches the messages in the incoming ring that were sent before the
+  // socket message after |max_sequence|. Returns false on a channel error.
+  bool DispatchRingMessages(uint32 max_sequence);
+
   // ChannelReader implementation.
   virtual ReadState ReadData(char* buffer,
                              int buffer_len,
@@ -157,7 +178,7 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   std::string pipe_name_;
 
   // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  std::deque<Message*> output_queue_;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
@@ -179,6 +200,30 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // recvmsg.
   char input_cmsg_buf_[kMaxReadFDBuffer];
 
+  // Capacity of the outgoing message ring, 0 if EnableMessageRing() wasn't
+  // called.
+  size_t message_ring_capacity_;
+
+  // The rings messages are sent through and received from on this connection.
+  // Only messages without file descriptors go through them, so each entry is
+  // stamped with the number of socket messages sent before it, which lets
+  // the reader keep both in order.
+  scoped_ptr<MessageRing> outgoing_ring_;
+  scoped_ptr<MessageRing> incoming_ring_;
+
+  // Socket messages sent since |outgoing_ring_| was handed to the peer, and
+  // received since |incoming_ring_| was handed to us, including the hand-off
+  // message itself.
+  uint32 socket_messages_sent_;
+  uint32 socket_messages_received_;
+
+  // True if the peer handed us a ring we couldn't map, so the messages it
+  // sends through it would be lost.
+  bool incoming_ring_failed_;
+
+  // Message read from |incoming_ring_| that is being dispatched.
+  std::string ring_message_buf_;
+
   // File descriptors extracted from messages coming off of the channel. The
   // handles may span messages and come off different channels from the message
   // data (in the case of READWRITE), and are processed in FIFO here.
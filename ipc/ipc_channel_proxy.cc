@@ -13,6 +13,7 @@
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_filter_router.h"
 #include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
 
@@ -36,6 +37,11 @@ bool ChannelProxy::MessageFilter::OnMessageReceived(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::MessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  return false;
+}
+
 ChannelProxy::MessageFilter::~MessageFilter() {}
 
 //------------------------------------------------------------------------------
@@ -45,6 +51,7 @@ ChannelProxy::Context::Context(Listener* listener,
     : listener_task_runner_(base::ThreadTaskRunnerHandle::Get()),
       listener_(listener),
       ipc_task_runner_(ipc_task_runner),
+      message_filter_router_(new MessageFilterRouter()),
       channel_connected_called_(false),
       peer_pid_(base::kNullProcessId) {
   DCHECK(ipc_task_runner_.get());
@@ -71,14 +78,12 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
-  for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i]->OnMessageReceived(message)) {
+  if (message_filter_router_->TryFilters(message)) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
-      if (logger->Enabled())
-        logger->OnPostDispatchMessage(message, channel_id_);
+    if (logger->Enabled())
+      logger->OnPostDispatchMessage(message, channel_id_);
 #endif
-      return true;
-    }
+    return true;
   }
   return false;
 }
@@ -156,6 +161,7 @@ void ChannelProxy::Context::OnChannelClosed() {
   }
 
   // We don't need the filters anymore.
+  message_filter_router_->Clear();
   filters_.clear();
 
   channel_.reset();
@@ -189,6 +195,7 @@ void ChannelProxy::Context::OnAddFilter() {
 
   for (size_t i = 0; i < new_filters.size(); ++i) {
     filters_.push_back(new_filters[i]);
+    message_filter_router_->AddFilter(new_filters[i].get());
 
     // If the channel has already been created, then we need to send this
     // message so that the filter gets access to the Channel.
@@ -208,6 +215,7 @@ void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   for (size_t i = 0; i < filters_.size(); ++i) {
     if (filters_[i].get() == filter) {
       filter->OnFilterRemoved();
+      message_filter_router_->RemoveFilter(filter);
       filters_.erase(filters_.begin() + i);
       return;
     }
@@ -216,6 +224,17 @@ void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   NOTREACHED() << "filter to be removed not found";
 }
 
+#if defined(OS_POSIX) && !defined(OS_NACL)
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::OnEnableMessageRing(size_t capacity) {
+  if (!channel_.get())
+    return;  // The channel has been closed.
+
+  bool valid = channel_->EnableMessageRing(capacity);
+  DCHECK(valid) << "Invalid message ring capacity " << capacity;
+}
+#endif  // defined(OS_POSIX) && !defined(OS_NACL)
+
 // Called on the listener's thread
 void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
   base::AutoLock auto_lock(pending_filters_lock_);
@@ -413,6 +432,14 @@ bool ChannelProxy::GetPeerEuid(uid_t* peer_euid) const {
   DCHECK(channel) << context_.get()->channel_id_;
   return channel->GetPeerEuid(peer_euid);
 }
+
+void ChannelProxy::EnableMessageRing(size_t capacity) {
+  DCHECK(CalledOnValidThread());
+
+  context_->ipc_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&Context::OnEnableMessageRing, context_.get(),
+                            capacity));
+}
 #endif
 
 //-----------------------------------------------------------------------------
@@ -22,6 +22,7 @@ class SingleThreadTaskRunner;
 
 namespace IPC {
 
+class MessageFilterRouter;
 class SendCallbackHelper;
 
 //-----------------------------------------------------------------------------
@@ -88,6 +89,13 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Filters that only handle messages of some classes (IPC_MESSAGE_START)
+    // should return true and fill |supported_message_classes|, so that they
+    // are only offered those messages, rather than every message on the
+    // channel. Called once, when the filter is added.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
    protected:
     virtual ~MessageFilter();
 
@@ -155,6 +163,11 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
   int GetClientFileDescriptor();
   int TakeClientFileDescriptor();
   bool GetPeerEuid(uid_t* peer_euid) const;
+
+  // Sends messages through a shared memory ring, see
+  // Channel::EnableMessageRing(). Meant for channels with a high rate of
+  // small messages, like input events.
+  void EnableMessageRing(size_t capacity);
 #endif  // defined(OS_POSIX)
 
  protected:
@@ -214,6 +227,9 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     void OnSendMessage(scoped_ptr<Message> message_ptr);
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
+#if defined(OS_POSIX) && !defined(OS_NACL)
+    void OnEnableMessageRing(size_t capacity);
+#endif
 
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
@@ -225,6 +241,8 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
 
     // List of filters.  This is only accessed on the IPC thread.
     std::vector<scoped_refptr<MessageFilter> > filters_;
+    // Picks the filters in |filters_| that a message is offered to.
+    scoped_ptr<MessageFilterRouter> message_filter_router_;
     scoped_refptr<base::SingleThreadTaskRunner> ipc_task_runner_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
@@ -21,6 +21,32 @@ ChannelReader::~ChannelReader() {
 bool ChannelReader::ProcessIncomingMessages() {
   while (true) {
     int bytes_read = 0;
+#if !defined(OS_WIN)
+    // Read the rest of a large message straight into the overflow buffer,
+    // rather than copying it over from |input_buf_| a page at a time. Reads
+    // on Windows complete asynchronously into |input_buf_|, so they can't.
+    size_t remaining = GetRemainingOverflowMessageSize();
+    if (remaining > Channel::kReadBufferSize) {
+      size_t offset = input_overflow_buf_.size();
+      input_overflow_buf_.resize(offset + remaining);
+      ReadState read_state = ReadData(&input_overflow_buf_[offset],
+                                      static_cast<int>(remaining),
+                                      &bytes_read);
+      input_overflow_buf_.resize(
+          offset + (read_state == READ_SUCCEEDED ? bytes_read : 0));
+      if (read_state == READ_FAILED)
+        return false;
+      if (read_state == READ_PENDING)
+        return true;
+
+      DCHECK(bytes_read > 0);
+      const char* data = input_overflow_buf_.data();
+      if (!DispatchMessages(data, data + input_overflow_buf_.size(), true))
+        return false;
+      continue;
+    }
+#endif
+
     ReadState read_state = ReadData(input_buf_, Channel::kReadBufferSize,
                                     &bytes_read);
     if (read_state == READ_FAILED)
@@ -40,7 +66,7 @@ bool ChannelReader::AsyncReadComplete(int bytes_read) {
 
 bool ChannelReader::IsInternalMessage(const Message& m) const {
   return m.routing_id() == MSG_ROUTING_NONE &&
-      m.type() >= Channel::CLOSE_FD_MESSAGE_TYPE &&
+      m.type() >= Channel::MESSAGE_RING_WAKEUP_MESSAGE_TYPE &&
       m.type() <= Channel::HELLO_MESSAGE_TYPE;
 }
 
@@ -51,25 +77,24 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
 
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
-  const char* p;
-  const char* end;
-
-  // Possibly combine with the overflow buffer to make a larger buffer.
-  if (input_overflow_buf_.empty()) {
-    p = input_data;
-    end = input_data + input_data_len;
-  } else {
-    if (input_overflow_buf_.size() + input_data_len >
-        Channel::kMaximumMessageSize) {
-      input_overflow_buf_.clear();
-      LOG(ERROR) << "IPC message is too big";
-      return false;
-    }
-    input_overflow_buf_.append(input_data, input_data_len);
-    p = input_overflow_buf_.data();
-    end = p + input_overflow_buf_.size();
+  if (input_overflow_buf_.empty())
+    return DispatchMessages(input_data, input_data + input_data_len, false);
+
+  // Combine with the overflow buffer to make a larger buffer.
+  if (input_overflow_buf_.size() + input_data_len >
+      Channel::kMaximumMessageSize) {
+    input_overflow_buf_.clear();
+    LOG(ERROR) << "IPC message is too big";
+    return false;
   }
+  input_overflow_buf_.append(input_data, input_data_len);
+  const char* data = input_overflow_buf_.data();
+  return DispatchMessages(data, data + input_overflow_buf_.size(), true);
+}
 
+bool ChannelReader::DispatchMessages(const char* p,
+                                     const char* end,
+                                     bool in_overflow_buf) {
   // Dispatch all complete messages in the data buffer.
   while (p < end) {
     const char* message_tail = Message::FindNext(p, end);
@@ -102,14 +127,41 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer. If it is already there,
+  // only drop the messages that were dispatched, so that a large message
+  // isn't copied again on every read.
+  if (in_overflow_buf) {
+    input_overflow_buf_.erase(0, p - input_overflow_buf_.data());
+  } else {
+    input_overflow_buf_.assign(p, end - p);
+  }
+
+  // Make room for the whole partial message up front, so that appending to
+  // it doesn't reallocate repeatedly.
+  size_t message_size = Message::GetMessageSize(
+      input_overflow_buf_.data(),
+      input_overflow_buf_.data() + input_overflow_buf_.size());
+  if (message_size > input_overflow_buf_.capacity() &&
+      message_size <= Channel::kMaximumMessageSize) {
+    input_overflow_buf_.reserve(message_size);
+  }
 
   if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
     return false;
   return true;
 }
 
+size_t ChannelReader::GetRemainingOverflowMessageSize() const {
+  size_t buffered = input_overflow_buf_.size();
+  size_t message_size = Message::GetMessageSize(
+      input_overflow_buf_.data(), input_overflow_buf_.data() + buffered);
+  if (message_size <= buffered ||
+      message_size > Channel::kMaximumMessageSize) {
+    return 0;
+  }
+  return message_size - buffered;
+}
+
 
 }  // namespace internal
 }  // namespace IPC
@@ -90,6 +90,15 @@ class ChannelReader {
   // Returns true on success. False means channel error.
   bool DispatchInputData(const char* input_data, int input_data_len);
 
+  // Dispatches the complete messages in [p, end). The partial message left,
+  // if any, is kept in the overflow buffer. |in_overflow_buf| is true if the
+  // range is the contents of the overflow buffer itself.
+  bool DispatchMessages(const char* p, const char* end, bool in_overflow_buf);
+
+  // Returns how many bytes of the partial message in the overflow buffer
+  // are still to be read, or 0 if unknown.
+  size_t GetRemainingOverflowMessageSize() const;
+
   Listener* listener_;
 
   // We read from the pipe into this buffer. Managed by DispatchInputData, do
@@ -97,7 +106,9 @@ class ChannelReader {
   char input_buf_[Channel::kReadBufferSize];
 
   // Large messages that span multiple pipe buffers, get built-up using
-  // this buffer.
+  // this buffer. It is sized for the whole message as soon as its header has
+  // been read, and where reads are synchronous the rest of the message is
+  // read straight into it.
   std::string input_overflow_buf_;
 
   DISALLOW_COPY_AND_ASSIGN(ChannelReader);
@@ -67,6 +67,15 @@ Message::Message(const char* data, int data_len) : Pickle(data, data_len) {
   InitLoggingVariables();
 }
 
+// static
+size_t Message::GetMessageSize(const char* range_start,
+                               const char* range_end) {
+  if (static_cast<size_t>(range_end - range_start) < sizeof(Header))
+    return 0;
+  const Header* header = reinterpret_cast<const Header*>(range_start);
+  return sizeof(Header) + static_cast<size_t>(header->payload_size);
+}
+
 Message::Message(const Message& other) : Pickle(other) {
   InitLoggingVariables();
 #if defined(OS_POSIX)
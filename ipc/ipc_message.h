@@ -179,6 +179,10 @@ class IPC_EXPORT Message : public Pickle {
     return Pickle::FindNext(sizeof(Header), range_start, range_end);
   }
 
+  // Returns the total size of the message that starts at range_start, or 0
+  // if the range is too short to hold its header.
+  static size_t GetMessageSize(const char* range_start, const char* range_end);
+
 #if defined(OS_POSIX)
   // On POSIX, a message supports reading / writing FileDescriptor objects.
   // This is used to pass a file descriptor to the peer of an IPC channel.
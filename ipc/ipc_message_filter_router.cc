@@ -0,0 +1,78 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_filter_router.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "ipc/ipc_message_macros.h"
+
+namespace IPC {
+
+namespace {
+
+bool TryFiltersImpl(const std::vector<MessageFilterRouter::MessageFilter*>&
+                        filters,
+                    const Message& message) {
+  for (size_t i = 0; i < filters.size(); ++i) {
+    if (filters[i]->OnMessageReceived(message))
+      return true;
+  }
+  return false;
+}
+
+void RemoveFilterImpl(std::vector<MessageFilterRouter::MessageFilter*>* filters,
+                      MessageFilterRouter::MessageFilter* filter) {
+  filters->erase(std::remove(filters->begin(), filters->end(), filter),
+                 filters->end());
+}
+
+}  // namespace
+
+MessageFilterRouter::MessageFilterRouter() {}
+
+MessageFilterRouter::~MessageFilterRouter() {}
+
+void MessageFilterRouter::AddFilter(MessageFilter* filter) {
+  std::vector<uint32> supported_message_classes;
+  if (!filter->GetSupportedMessageClasses(&supported_message_classes)) {
+    global_filters_.push_back(filter);
+    return;
+  }
+
+  for (size_t i = 0; i < supported_message_classes.size(); ++i) {
+    uint32 message_class = supported_message_classes[i];
+    if (message_class >= LastIPCMsgStart) {
+      NOTREACHED() << "Invalid message class " << message_class;
+      continue;
+    }
+    MessageFilters& filters = message_class_filters_[message_class];
+    if (std::find(filters.begin(), filters.end(), filter) == filters.end())
+      filters.push_back(filter);
+  }
+}
+
+void MessageFilterRouter::RemoveFilter(MessageFilter* filter) {
+  RemoveFilterImpl(&global_filters_, filter);
+  for (size_t i = 0; i < arraysize(message_class_filters_); ++i)
+    RemoveFilterImpl(&message_class_filters_[i], filter);
+}
+
+void MessageFilterRouter::Clear() {
+  global_filters_.clear();
+  for (size_t i = 0; i < arraysize(message_class_filters_); ++i)
+    message_class_filters_[i].clear();
+}
+
+bool MessageFilterRouter::TryFilters(const Message& message) {
+  uint32 message_class = IPC_MESSAGE_CLASS(message);
+  if (message_class < LastIPCMsgStart &&
+      TryFiltersImpl(message_class_filters_[message_class], message)) {
+    return true;
+  }
+  return TryFiltersImpl(global_filters_, message);
+}
+
+}  // namespace IPC
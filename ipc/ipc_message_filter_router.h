@@ -0,0 +1,51 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_MESSAGE_FILTER_ROUTER_H_
+#define IPC_IPC_MESSAGE_FILTER_ROUTER_H_
+
+#include <vector>
+
+#include "ipc/ipc_channel_proxy.h"
+#include "ipc/ipc_message_start.h"
+
+namespace IPC {
+
+// Finds the filters a message should be offered to without walking all of
+// them. Filters that report the message classes they handle through
+// MessageFilter::GetSupportedMessageClasses() only see messages of those
+// classes, and are tried before the filters that see every message. Within
+// each group, filters are tried in the order they were added.
+//
+// The router doesn't hold references, the owner must remove filters before
+// releasing them.
+class IPC_EXPORT MessageFilterRouter {
+ public:
+  typedef ChannelProxy::MessageFilter MessageFilter;
+
+  MessageFilterRouter();
+  ~MessageFilterRouter();
+
+  void AddFilter(MessageFilter* filter);
+  void RemoveFilter(MessageFilter* filter);
+  void Clear();
+
+  // Returns true if a filter handled |message|.
+  bool TryFilters(const Message& message);
+
+ private:
+  typedef std::vector<MessageFilter*> MessageFilters;
+
+  // Filters that see every message.
+  MessageFilters global_filters_;
+
+  // Filters that only see messages of a given class, indexed by class.
+  MessageFilters message_class_filters_[LastIPCMsgStart];
+
+  DISALLOW_COPY_AND_ASSIGN(MessageFilterRouter);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_MESSAGE_FILTER_ROUTER_H_
@@ -0,0 +1,102 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_filter_router.h"
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "ipc/ipc_message.h"
+#include "ipc/ipc_message_start.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace {
+
+class CountingFilter : public ChannelProxy::MessageFilter {
+ public:
+  // An empty |message_classes| makes a filter that sees every message.
+  CountingFilter(const std::vector<uint32>& message_classes, bool handle)
+      : message_classes_(message_classes),
+        handle_(handle),
+        messages_received_(0) {
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    ++messages_received_;
+    return handle_;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (message_classes_.empty())
+      return false;
+    *supported_message_classes = message_classes_;
+    return true;
+  }
+
+  int messages_received() const { return messages_received_; }
+
+ private:
+  virtual ~CountingFilter() {}
+
+  std::vector<uint32> message_classes_;
+  bool handle_;
+  int messages_received_;
+};
+
+Message CreateMessage(uint32 message_class) {
+  return Message(0, message_class << 16, Message::PRIORITY_NORMAL);
+}
+
+TEST(MessageFilterRouterTest, RoutesByMessageClass) {
+  std::vector<uint32> view_classes(1, ViewMsgStart);
+  std::vector<uint32> input_classes(1, InputMsgStart);
+  scoped_refptr<CountingFilter> view_filter(
+      new CountingFilter(view_classes, true));
+  scoped_refptr<CountingFilter> input_filter(
+      new CountingFilter(input_classes, false));
+  scoped_refptr<CountingFilter> global_filter(
+      new CountingFilter(std::vector<uint32>(), false));
+
+  MessageFilterRouter router;
+  router.AddFilter(global_filter.get());
+  router.AddFilter(view_filter.get());
+  router.AddFilter(input_filter.get());
+
+  // Class filters go first, even if added later.
+  EXPECT_TRUE(router.TryFilters(CreateMessage(ViewMsgStart)));
+  EXPECT_EQ(1, view_filter->messages_received());
+  EXPECT_EQ(0, global_filter->messages_received());
+
+  EXPECT_FALSE(router.TryFilters(CreateMessage(InputMsgStart)));
+  EXPECT_EQ(1, input_filter->messages_received());
+  EXPECT_EQ(1, global_filter->messages_received());
+
+  EXPECT_FALSE(router.TryFilters(CreateMessage(PluginMsgStart)));
+  EXPECT_EQ(1, view_filter->messages_received());
+  EXPECT_EQ(1, input_filter->messages_received());
+  EXPECT_EQ(2, global_filter->messages_received());
+}
+
+TEST(MessageFilterRouterTest, RemoveFilter) {
+  std::vector<uint32> classes;
+  classes.push_back(ViewMsgStart);
+  classes.push_back(InputMsgStart);
+  scoped_refptr<CountingFilter> filter(new CountingFilter(classes, true));
+
+  MessageFilterRouter router;
+  router.AddFilter(filter.get());
+  EXPECT_TRUE(router.TryFilters(CreateMessage(ViewMsgStart)));
+  EXPECT_TRUE(router.TryFilters(CreateMessage(InputMsgStart)));
+  EXPECT_EQ(2, filter->messages_received());
+
+  router.RemoveFilter(filter.get());
+  EXPECT_FALSE(router.TryFilters(CreateMessage(ViewMsgStart)));
+  EXPECT_FALSE(router.TryFilters(CreateMessage(InputMsgStart)));
+  EXPECT_EQ(2, filter->messages_received());
+}
+
+}  // namespace
+}  // namespace IPC
@@ -0,0 +1,210 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_ring.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+
+namespace {
+
+// Entries start on this boundary.
+const uint32 kEntryAlignment = 8;
+
+// An entry of this size fills the rest of the ring up to its end, when the
+// next message doesn't fit there. Real messages are never empty.
+const uint32 kPaddingEntrySize = 0;
+
+uint32 AlignEntrySize(uint32 size) {
+  return (size + kEntryAlignment - 1) & ~(kEntryAlignment - 1);
+}
+
+}  // namespace
+
+// Both positions count bytes ever written or read, modulo 2^32, and only
+// ever grow by whole entries.
+struct MessageRing::Header {
+  // Updated by the writer only.
+  base::subtle::Atomic32 write_position;
+  // Updated by the reader only.
+  base::subtle::Atomic32 read_position;
+  // Non-zero while the reader waits to be woken up.
+  base::subtle::Atomic32 reader_idle;
+  int32 padding;
+};
+
+struct MessageRing::EntryHeader {
+  uint32 size;
+  uint32 sequence;
+};
+
+const size_t MessageRing::kMinimumCapacity;
+const size_t MessageRing::kMaximumCapacity;
+
+// static
+bool MessageRing::IsValidCapacity(size_t capacity) {
+  return capacity >= kMinimumCapacity && capacity <= kMaximumCapacity &&
+         (capacity & (capacity - 1)) == 0;
+}
+
+// static
+scoped_ptr<MessageRing> MessageRing::Create(size_t capacity) {
+  DCHECK(IsValidCapacity(capacity));
+  scoped_ptr<MessageRing> ring(
+      new MessageRing(base::SharedMemory::NULLHandle(), capacity));
+  if (!ring->shared_memory_.CreateAndMapAnonymous(sizeof(Header) + capacity))
+    return scoped_ptr<MessageRing>();
+  ring->SetUpPointers();
+  memset(ring->header_, 0, sizeof(Header));
+  // Nobody reads the ring until the peer gets it, so the first message has
+  // to wake it up.
+  base::subtle::Release_Store(&ring->header_->reader_idle, 1);
+  return ring.Pass();
+}
+
+// static
+scoped_ptr<MessageRing> MessageRing::Open(base::SharedMemoryHandle handle,
+                                          size_t capacity) {
+  scoped_ptr<MessageRing> ring(new MessageRing(handle, capacity));
+  if (!IsValidCapacity(capacity)) {
+    DLOG(ERROR) << "Invalid message ring capacity " << capacity;
+    return scoped_ptr<MessageRing>();
+  }
+  if (!ring->shared_memory_.Map(sizeof(Header) + capacity))
+    return scoped_ptr<MessageRing>();
+  // The mapping stays valid without the handle.
+  ring->shared_memory_.Close();
+  ring->SetUpPointers();
+  ring->position_ = static_cast<uint32>(
+      base::subtle::Acquire_Load(&ring->header_->read_position));
+  return ring.Pass();
+}
+
+MessageRing::MessageRing(base::SharedMemoryHandle handle, size_t capacity)
+    : shared_memory_(handle, false),
+      capacity_(static_cast<uint32>(capacity)),
+      header_(NULL),
+      entries_(NULL),
+      position_(0) {
+}
+
+MessageRing::~MessageRing() {
+}
+
+bool MessageRing::ShareToProcess(base::ProcessHandle process,
+                                 base::SharedMemoryHandle* new_handle) {
+  return shared_memory_.ShareToProcess(process, new_handle);
+}
+
+void MessageRing::SetUpPointers() {
+  header_ = static_cast<Header*>(shared_memory_.memory());
+  entries_ = reinterpret_cast<char*>(header_ + 1);
+}
+
+MessageRing::EntryHeader* MessageRing::EntryAt(uint32 position) const {
+  return reinterpret_cast<EntryHeader*>(entries_ +
+                                        (position & (capacity_ - 1)));
+}
+
+bool MessageRing::Write(const Message& message,
+                        uint32 sequence,
+                        bool* wake_reader) {
+  *wake_reader = false;
+  if (message.size() > max_message_size())
+    return false;
+
+  uint32 message_size = static_cast<uint32>(message.size());
+  uint32 entry_size = AlignEntrySize(sizeof(EntryHeader) + message_size);
+  uint32 used = position_ - static_cast<uint32>(
+      base::subtle::Acquire_Load(&header_->read_position));
+  if (used > capacity_)
+    return false;
+
+  // Entries never wrap around, so skip to the start of the ring if there is
+  // no room until its end.
+  uint32 until_end = capacity_ - (position_ & (capacity_ - 1));
+  uint32 padding = entry_size > until_end ? until_end : 0;
+  if (capacity_ - used < padding + entry_size)
+    return false;
+  if (padding) {
+    EntryAt(position_)->size = kPaddingEntrySize;
+    position_ += padding;
+  }
+
+  EntryHeader* entry = EntryAt(position_);
+  entry->size = message_size;
+  entry->sequence = sequence;
+  memcpy(entry + 1, message.data(), message_size);
+  position_ += entry_size;
+  base::subtle::Release_Store(&header_->write_position,
+                              static_cast<base::subtle::Atomic32>(position_));
+
+  // Pairs with the barrier in SetReaderIdle(), so that either the reader
+  // sees the message or the writer sees that the reader is idle.
+  base::subtle::MemoryBarrier();
+  *wake_reader =
+      base::subtle::NoBarrier_CompareAndSwap(&header_->reader_idle, 1, 0) == 1;
+  return true;
+}
+
+MessageRing::ReadResult MessageRing::Read(uint32 max_sequence,
+                                          std::string* data) {
+  while (true) {
+    uint32 available = static_cast<uint32>(
+        base::subtle::Acquire_Load(&header_->write_position)) - position_;
+    if (!available)
+      return READ_EMPTY;
+    if (available > capacity_ || available % kEntryAlignment)
+      return READ_ERROR;
+
+    // Copy the entry header, the writer could change it under us.
+    uint32 until_end = capacity_ - (position_ & (capacity_ - 1));
+    EntryHeader entry = *EntryAt(position_);
+    if (entry.size == kPaddingEntrySize) {
+      if (available < until_end)
+        return READ_ERROR;
+      position_ += until_end;
+      base::subtle::Release_Store(
+          &header_->read_position,
+          static_cast<base::subtle::Atomic32>(position_));
+      continue;
+    }
+
+    if (static_cast<int32>(entry.sequence - max_sequence) > 0)
+      return READ_LATER;
+    if (entry.size > max_message_size())
+      return READ_ERROR;
+    uint32 entry_size = AlignEntrySize(sizeof(EntryHeader) + entry.size);
+    if (entry_size > std::min(available, until_end))
+      return READ_ERROR;
+
+    data->assign(reinterpret_cast<const char*>(EntryAt(position_) + 1),
+                 entry.size);
+    position_ += entry_size;
+    base::subtle::Release_Store(
+        &header_->read_position,
+        static_cast<base::subtle::Atomic32>(position_));
+    return READ_MESSAGE;
+  }
+}
+
+bool MessageRing::SetReaderIdle() {
+  base::subtle::NoBarrier_Store(&header_->reader_idle, 1);
+  base::subtle::MemoryBarrier();
+  if (static_cast<uint32>(base::subtle::NoBarrier_Load(
+          &header_->write_position)) == position_) {
+    return true;
+  }
+  base::subtle::NoBarrier_Store(&header_->reader_idle, 0);
+  return false;
+}
+
+}  // namespace IPC
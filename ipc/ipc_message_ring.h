@@ -0,0 +1,114 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_MESSAGE_RING_H_
+#define IPC_IPC_MESSAGE_RING_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+#include "ipc/ipc_export.h"
+
+namespace IPC {
+
+class Message;
+
+// A single-producer, single-consumer ring of serialized messages in shared
+// memory, so that messages can be passed between processes without a
+// syscall each. One side creates the ring and writes to it, the other opens
+// it and reads from it; each side must only call its own methods.
+//
+// Every message is stamped with a sequence number chosen by the writer. The
+// channel uses it to keep the ring in order with messages that still have to
+// go over the socket, such as those carrying file descriptors.
+//
+// The reader marks itself idle when it finds the ring empty, and the writer
+// reports that it must be woken up only for the first message written after
+// that, so a busy reader costs the writer nothing.
+//
+// The peer can scribble over the shared memory at any time, so the reader
+// validates everything it reads and copies messages out before use.
+class IPC_EXPORT MessageRing {
+ public:
+  enum ReadResult {
+    READ_MESSAGE,
+    // The ring is empty.
+    READ_EMPTY,
+    // The oldest message has a sequence number after the given one.
+    READ_LATER,
+    // The ring is corrupt.
+    READ_ERROR,
+  };
+
+  // The capacity must be a power of two in this range.
+  static const size_t kMinimumCapacity = 4 * 1024;
+  static const size_t kMaximumCapacity = 16 * 1024 * 1024;
+
+  static bool IsValidCapacity(size_t capacity);
+
+  // Creates a ring with |capacity| bytes for messages, to be written to.
+  // Returns NULL on failure.
+  static scoped_ptr<MessageRing> Create(size_t capacity);
+
+  // Maps a ring created by the peer, to be read from. Takes ownership of
+  // |handle|. Returns NULL on failure.
+  static scoped_ptr<MessageRing> Open(base::SharedMemoryHandle handle,
+                                      size_t capacity);
+
+  ~MessageRing();
+
+  size_t capacity() const { return capacity_; }
+  base::SharedMemoryHandle handle() const { return shared_memory_.handle(); }
+
+  // Duplicates the handle of a ring created with Create() for |process|.
+  bool ShareToProcess(base::ProcessHandle process,
+                      base::SharedMemoryHandle* new_handle);
+
+  // Largest message that is ever written to the ring. Larger ones have to go
+  // over the socket.
+  size_t max_message_size() const { return capacity_ / 4; }
+
+  // Writer side. Copies |message| into the ring stamped with |sequence|.
+  // Returns false if there isn't room for it. Sets |wake_reader| to true if
+  // the reader is idle and must be told there is a new message.
+  bool Write(const Message& message, uint32 sequence, bool* wake_reader);
+
+  // Reader side. Copies the oldest message into |data| and removes it from
+  // the ring, unless its sequence number is after |max_sequence|.
+  ReadResult Read(uint32 max_sequence, std::string* data);
+
+  // Reader side. Marks the reader as idle, so that the writer asks for it to
+  // be woken up on the next message. Returns false, leaving the reader busy,
+  // if a message arrived in the meantime.
+  bool SetReaderIdle();
+
+ private:
+  struct Header;
+  struct EntryHeader;
+
+  MessageRing(base::SharedMemoryHandle handle, size_t capacity);
+
+  // Points |header_| and |entries_| into the mapped memory.
+  void SetUpPointers();
+
+  EntryHeader* EntryAt(uint32 position) const;
+
+  base::SharedMemory shared_memory_;
+  uint32 capacity_;
+  Header* header_;
+  char* entries_;
+
+  // This side's copy of the position it updates, so that the peer can't
+  // make it jump around.
+  uint32 position_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageRing);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_MESSAGE_RING_H_
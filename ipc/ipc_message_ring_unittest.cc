@@ -0,0 +1,144 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_ring.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace {
+
+class MessageRingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    writer_ = MessageRing::Create(MessageRing::kMinimumCapacity);
+    ASSERT_TRUE(writer_);
+    base::SharedMemoryHandle handle;
+    ASSERT_TRUE(writer_->ShareToProcess(base::GetCurrentProcessHandle(),
+                                        &handle));
+    reader_ = MessageRing::Open(handle, MessageRing::kMinimumCapacity);
+    ASSERT_TRUE(reader_);
+  }
+
+  // Returns the message |id| with a payload of |payload_size| bytes.
+  static Message* CreateMessage(int id, size_t payload_size) {
+    Message* message = new Message(id, 1, Message::PRIORITY_NORMAL);
+    message->WriteString(std::string(payload_size, 'x'));
+    return message;
+  }
+
+  // Reads the next message, which must be there, and returns its routing id.
+  int ReadRoutingId(uint32 max_sequence) {
+    std::string data;
+    EXPECT_EQ(MessageRing::READ_MESSAGE, reader_->Read(max_sequence, &data));
+    Message message(data.data(), static_cast<int>(data.size()));
+    return message.routing_id();
+  }
+
+  scoped_ptr<MessageRing> writer_;
+  scoped_ptr<MessageRing> reader_;
+};
+
+TEST_F(MessageRingTest, Capacity) {
+  EXPECT_TRUE(MessageRing::IsValidCapacity(MessageRing::kMinimumCapacity));
+  EXPECT_TRUE(MessageRing::IsValidCapacity(MessageRing::kMaximumCapacity));
+  EXPECT_FALSE(MessageRing::IsValidCapacity(MessageRing::kMinimumCapacity / 2));
+  EXPECT_FALSE(MessageRing::IsValidCapacity(MessageRing::kMaximumCapacity * 2));
+  EXPECT_FALSE(MessageRing::IsValidCapacity(MessageRing::kMinimumCapacity + 1));
+}
+
+TEST_F(MessageRingTest, WriteAndRead) {
+  std::string data;
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(0, &data));
+
+  scoped_ptr<Message> message(CreateMessage(7, 10));
+  bool wake_reader = false;
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  ASSERT_EQ(MessageRing::READ_MESSAGE, reader_->Read(0, &data));
+  ASSERT_EQ(message->size(), data.size());
+  EXPECT_EQ(0, memcmp(message->data(), data.data(), data.size()));
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(0, &data));
+}
+
+TEST_F(MessageRingTest, TooLarge) {
+  scoped_ptr<Message> message(
+      CreateMessage(1, writer_->max_message_size()));
+  bool wake_reader = false;
+  EXPECT_FALSE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_FALSE(wake_reader);
+}
+
+TEST_F(MessageRingTest, FullAndWrapAround) {
+  const size_t kPayloadSize = writer_->max_message_size() / 3;
+  bool wake_reader = false;
+  int written = 0;
+  int read = 0;
+  // Fill the ring, then keep reading and writing so that messages have to
+  // skip to the start of the ring.
+  for (int round = 0; round < 10; ++round) {
+    while (true) {
+      scoped_ptr<Message> message(CreateMessage(written, kPayloadSize));
+      if (!writer_->Write(*message, 0, &wake_reader))
+        break;
+      ++written;
+    }
+    EXPECT_GT(written, read);
+    EXPECT_EQ(read, ReadRoutingId(0));
+    ++read;
+  }
+  while (read < written) {
+    EXPECT_EQ(read, ReadRoutingId(0));
+    ++read;
+  }
+  std::string data;
+  EXPECT_EQ(MessageRing::READ_EMPTY, reader_->Read(0, &data));
+}
+
+TEST_F(MessageRingTest, Sequence) {
+  bool wake_reader = false;
+  scoped_ptr<Message> first(CreateMessage(1, 0));
+  scoped_ptr<Message> second(CreateMessage(2, 0));
+  ASSERT_TRUE(writer_->Write(*first, 3, &wake_reader));
+  ASSERT_TRUE(writer_->Write(*second, 4, &wake_reader));
+
+  std::string data;
+  EXPECT_EQ(MessageRing::READ_LATER, reader_->Read(2, &data));
+  EXPECT_EQ(1, ReadRoutingId(3));
+  EXPECT_EQ(MessageRing::READ_LATER, reader_->Read(3, &data));
+  EXPECT_EQ(2, ReadRoutingId(4));
+}
+
+TEST_F(MessageRingTest, WakesIdleReaderOnce) {
+  scoped_ptr<Message> message(CreateMessage(1, 0));
+  bool wake_reader = false;
+
+  // A new ring hasn't been read yet.
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_TRUE(wake_reader);
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_FALSE(wake_reader);
+
+  // The reader can't go idle while there are messages.
+  EXPECT_FALSE(reader_->SetReaderIdle());
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_FALSE(wake_reader);
+
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(1, ReadRoutingId(0));
+  EXPECT_TRUE(reader_->SetReaderIdle());
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_TRUE(wake_reader);
+  ASSERT_TRUE(writer_->Write(*message, 0, &wake_reader));
+  EXPECT_FALSE(wake_reader);
+}
+
+}  // namespace
+}  // namespace IPC
@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 
 namespace media {
 
@@ -20,7 +21,11 @@ AudioRendererMixer::AudioRendererMixer(
       pause_delay_(base::TimeDelta::FromSeconds(kPauseDelaySeconds)),
       last_play_time_(base::TimeTicks::Now()),
       // Initialize |playing_| to true since Start() results in an auto-play.
-      playing_(true) {
+      playing_(true),
+      buffer_duration_(output_params.GetBufferDuration()),
+      render_count_(0),
+      contended_render_count_(0),
+      overrun_render_count_(0) {
   audio_sink_->Initialize(output_params, this);
   audio_sink_->Start();
 }
@@ -29,6 +34,13 @@ AudioRendererMixer::~AudioRendererMixer() {
   // AudioRendererSinks must be stopped before being destructed.
   audio_sink_->Stop();
 
+  if (render_count_ > 0) {
+    UMA_HISTOGRAM_COUNTS("Media.AudioRendererMixer.ContendedRenders",
+                         contended_render_count_);
+    UMA_HISTOGRAM_COUNTS("Media.AudioRendererMixer.OverrunRenders",
+                         overrun_render_count_);
+  }
+
   // Ensures that all mixer inputs have stopped themselves prior to destruction
   // and have called RemoveMixerInput().
   DCHECK_EQ(mixer_inputs_.size(), 0U);
@@ -60,7 +72,17 @@ void AudioRendererMixer::RemoveMixerInput(
 
 int AudioRendererMixer::Render(AudioBus* audio_bus,
                                int audio_delay_milliseconds) {
-  base::AutoLock auto_lock(mixer_inputs_lock_);
+  const base::TimeTicks render_start = base::TimeTicks::Now();
+  ++render_count_;
+
+  // Adding and removing inputs only holds the lock briefly, but a preempted
+  // render thread waiting here is what turns into a glitch, so count it.
+  if (!mixer_inputs_lock_.Try()) {
+    ++contended_render_count_;
+    mixer_inputs_lock_.Acquire();
+  }
+  base::AutoLock auto_lock(mixer_inputs_lock_,
+                           base::AutoLock::AlreadyAcquired());
 
   // If there are no mixer inputs and we haven't seen one for a while, pause the
   // sink to avoid wasting resources when media elements are present but remain
@@ -75,6 +97,9 @@ int AudioRendererMixer::Render(AudioBus* audio_bus,
 
   audio_converter_.ConvertWithDelay(
       base::TimeDelta::FromMilliseconds(audio_delay_milliseconds), audio_bus);
+
+  if (base::TimeTicks::Now() - render_start > buffer_duration_)
+    ++overrun_render_count_;
   return audio_bus->frames();
 }
 
@@ -59,6 +59,15 @@ class MEDIA_EXPORT AudioRendererMixer
   base::TimeTicks last_play_time_;
   bool playing_;
 
+  // Glitch statistics, only touched on the audio thread until the sink is
+  // stopped. A render is contended if it had to wait for |mixer_inputs_lock_|
+  // and overran if it took longer than |buffer_duration_|, which causes an
+  // audible glitch.
+  base::TimeDelta buffer_duration_;
+  int render_count_;
+  int contended_render_count_;
+  int overrun_render_count_;
+
   DISALLOW_COPY_AND_ASSIGN(AudioRendererMixer);
 };
 
@@ -6,10 +6,14 @@
 #include "base/bind.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "media/base/media.h"
 #include "media/base/media_log.h"
 #include "media/base/test_data_util.h"
+#include "media/filters/blocking_url_protocol.h"
 #include "media/filters/ffmpeg_demuxer.h"
 #include "media/filters/file_data_source.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -19,6 +23,10 @@ namespace media {
 
 static const int kBenchmarkIterations = 500;
 
+// Reads happen in FFmpeg's AVIO buffer size.
+static const int kUrlProtocolReadSize = 32 * 1024;
+static const int kUrlProtocolIterations = 50;
+
 class DemuxerHostImpl : public media::DemuxerHost {
  public:
   DemuxerHostImpl() {}
@@ -211,6 +219,97 @@ static void RunDemuxerBenchmark(const std::string& filename) {
                          true);
 }
 
+// Completes reads from a file on another thread after a delay, the way
+// BufferedDataSource completes them on the render thread.
+class DelayedDataSource : public DataSource {
+ public:
+  DelayedDataSource(FileDataSource* file_data_source, base::TimeDelta delay)
+      : file_data_source_(file_data_source),
+        delay_(delay),
+        thread_("DelayedDataSource") {
+    CHECK(thread_.Start());
+  }
+  virtual ~DelayedDataSource() {}
+
+  // DataSource implementation.
+  virtual void Read(int64 position, int size, uint8* data,
+                    const DataSource::ReadCB& read_cb) OVERRIDE {
+    thread_.message_loop()->PostTask(FROM_HERE, base::Bind(
+        &DelayedDataSource::ReadOnThread, base::Unretained(this), position,
+        size, data, read_cb));
+  }
+  virtual void Stop(const base::Closure& callback) OVERRIDE {
+    thread_.Stop();
+    callback.Run();
+  }
+  virtual bool GetSize(int64* size_out) OVERRIDE {
+    return file_data_source_->GetSize(size_out);
+  }
+  virtual bool IsStreaming() OVERRIDE { return false; }
+  virtual void SetBitrate(int bitrate) OVERRIDE {}
+
+ private:
+  void ReadOnThread(int64 position, int size, uint8* data,
+                    const DataSource::ReadCB& read_cb) {
+    base::PlatformThread::Sleep(delay_);
+    file_data_source_->Read(position, size, data, read_cb);
+  }
+
+  FileDataSource* file_data_source_;
+  base::TimeDelta delay_;
+  base::Thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(DelayedDataSource);
+};
+
+static void OnUrlProtocolError() {
+  LOG(FATAL) << "Read error.";
+}
+
+// Reads |filename| from start to end through BlockingUrlProtocol over a data
+// source that takes |delay| per read, prefetching |prefetch_size| bytes.
+static void RunUrlProtocolBenchmark(const std::string& filename,
+                                    base::TimeDelta delay,
+                                    int prefetch_size) {
+  base::FilePath file_path(GetTestDataFilePath(filename));
+  FileDataSource file_data_source;
+  ASSERT_TRUE(file_data_source.Initialize(file_path));
+  DelayedDataSource data_source(&file_data_source, delay);
+
+  scoped_ptr<uint8[]> buffer(new uint8[kUrlProtocolReadSize]);
+  base::TimeDelta total_time;
+  for (int i = 0; i < kUrlProtocolIterations; ++i) {
+    BlockingUrlProtocol url_protocol(&data_source,
+                                     base::Bind(&OnUrlProtocolError));
+    url_protocol.set_prefetch_size(prefetch_size);
+
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    while (url_protocol.Read(kUrlProtocolReadSize, buffer.get()) > 0) {
+    }
+    total_time += base::TimeTicks::HighResNow() - start;
+  }
+
+  base::WaitableEvent stop_event(false, false);
+  data_source.Stop(base::Bind(&base::WaitableEvent::Signal,
+                              base::Unretained(&stop_event)));
+  stop_event.Wait();
+
+  perf_test::PrintResult("url_protocol_read",
+                         "_prefetch_" + base::IntToString(prefetch_size),
+                         filename,
+                         total_time.InMillisecondsF() / kUrlProtocolIterations,
+                         "ms",
+                         true);
+}
+
+TEST(DemuxerPerfTest, UrlProtocolPrefetch) {
+  // Roughly the cost of a hop to the render thread and back.
+  base::TimeDelta delay = base::TimeDelta::FromMilliseconds(1);
+  RunUrlProtocolBenchmark("bear-640x360.webm", delay, 0);
+  RunUrlProtocolBenchmark("bear-640x360.webm", delay, 64 * 1024);
+  RunUrlProtocolBenchmark("bear-640x360.webm", delay, 256 * 1024);
+}
+
 TEST(DemuxerPerfTest, Demuxer) {
   RunDemuxerBenchmark("bear.ogv");
   RunDemuxerBenchmark("bear-640x360.webm");
@@ -0,0 +1,145 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+
+namespace media {
+
+// These follow the MMX versions: each pixel's contributions are looked up in
+// kCoefficientsRgbY, added with signed saturation, shifted and packed.  Using
+// the same table keeps the output bit identical to the C versions (and makes
+// the pixel layout match the platform's, see yuv_to_rgb_table.cc), and NEON
+// does the arithmetic for two pixels at a time.
+
+// Returns the saturated sum of the U and V contributions, which are shared by
+// a pair of pixels.
+static inline int16x4_t LoadUVContribution(uint8 u, uint8 v) {
+  return vqadd_s16(vld1_s16(kCoefficientsRgbY[256 + u]),
+                   vld1_s16(kCoefficientsRgbY[512 + v]));
+}
+
+// Converts two pixels with luma |y0| and |y1| to 8 bytes of ARGB.
+static inline uint8x8_t ConvertPixelPair(uint8 y0,
+                                         uint8 y1,
+                                         int16x4_t uv) {
+  int16x8_t rgb = vcombine_s16(vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y0])),
+                               vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y1])));
+  return vqmovun_s16(vshrq_n_s16(rgb, 6));
+}
+
+// Stores the pair of pixels in |rgb|, or only the first one if |store_both| is
+// false.
+static inline void StorePixelPair(uint8x8_t rgb,
+                                  bool store_both,
+                                  uint8* rgb_buf) {
+  if (store_both) {
+    vst1_u8(rgb_buf, rgb);
+  } else {
+    vst1_lane_u32(reinterpret_cast<uint32*>(rgb_buf),
+                  vreinterpret_u32_u8(rgb), 0);
+  }
+}
+
+void ConvertYUVToRGB32Row_NEON(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               ptrdiff_t width) {
+  for (int x = 0; x < width; x += 2) {
+    int16x4_t uv = LoadUVContribution(u_buf[x >> 1], v_buf[x >> 1]);
+    bool store_both = (x + 1) < width;
+    uint8 y1 = store_both ? y_buf[x + 1] : y_buf[x];
+    StorePixelPair(ConvertPixelPair(y_buf[x], y1, uv), store_both, rgb_buf);
+    rgb_buf += 8;  // Advance 2 pixels.
+  }
+}
+
+void ScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             ptrdiff_t width,
+                             ptrdiff_t source_dx) {
+  int x = 0;
+  for (int i = 0; i < width; i += 2) {
+    int16x4_t uv = LoadUVContribution(u_buf[x >> 17], v_buf[x >> 17]);
+    uint8 y0 = y_buf[x >> 16];
+    x += source_dx;
+    bool store_both = (i + 1) < width;
+    uint8 y1 = y0;
+    if (store_both) {
+      y1 = y_buf[x >> 16];
+      x += source_dx;
+    }
+    StorePixelPair(ConvertPixelPair(y0, y1, uv), store_both, rgb_buf);
+    rgb_buf += 8;
+  }
+}
+
+void LinearScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                                   const uint8* u_buf,
+                                   const uint8* v_buf,
+                                   uint8* rgb_buf,
+                                   ptrdiff_t width,
+                                   ptrdiff_t source_dx) {
+  // Avoid point-sampling for down-scaling by > 2:1.
+  int x = 0;
+  if (source_dx >= 0x20000)
+    x += 0x8000;
+
+  // The interpolation is the same as LinearScaleYUVToRGB32RowWithRange_C().
+  for (int i = 0; i < width; i += 2) {
+    int uv_frac = ((x >> 1) & 65535);
+    int u = (uv_frac * u_buf[(x >> 17) + 1] +
+             (uv_frac ^ 65535) * u_buf[x >> 17]) >> 16;
+    int v = (uv_frac * v_buf[(x >> 17) + 1] +
+             (uv_frac ^ 65535) * v_buf[x >> 17]) >> 16;
+    int16x4_t uv = LoadUVContribution(u, v);
+
+    int y_frac = (x & 65535);
+    int y0 = (y_frac * y_buf[(x >> 16) + 1] +
+              (y_frac ^ 65535) * y_buf[x >> 16]) >> 16;
+    x += source_dx;
+    bool store_both = (i + 1) < width;
+    int y1 = y0;
+    if (store_both) {
+      y_frac = (x & 65535);
+      y1 = (y_frac * y_buf[(x >> 16) + 1] +
+            (y_frac ^ 65535) * y_buf[x >> 16]) >> 16;
+      x += source_dx;
+    }
+    StorePixelPair(ConvertPixelPair(y0, y1, uv), store_both, rgb_buf);
+    rgb_buf += 8;
+  }
+}
+
+void ConvertYUVToRGB32_NEON(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_NEON(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
@@ -6,6 +6,7 @@
 #define MEDIA_BASE_SIMD_FILTER_YUV_H_
 
 #include "base/basictypes.h"
+#include "build/build_config.h"
 #include "media/base/media_export.h"
 
 namespace media {
@@ -31,6 +32,14 @@ MEDIA_EXPORT void FilterYUVRows_SSE2(uint8* ybuf,
                                      int source_width,
                                      int source_y_fraction);
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+MEDIA_EXPORT void FilterYUVRows_NEON(uint8* ybuf,
+                                     const uint8* y0_ptr,
+                                     const uint8* y1_ptr,
+                                     int source_width,
+                                     int source_y_fraction);
+#endif
+
 }  // namespace media
 
 #endif  // MEDIA_BASE_SIMD_FILTER_YUV_H_
@@ -0,0 +1,41 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "media/base/simd/filter_yuv.h"
+
+namespace media {
+
+void FilterYUVRows_NEON(uint8* dest,
+                        const uint8* src0,
+                        const uint8* src1,
+                        int width,
+                        int fraction) {
+  // The weights are 16 bits wide since 256 - |fraction| may not fit in 8 bits;
+  // the weighted sums still fit, the largest is 255 * 256.
+  const uint16x8_t src1_fraction = vdupq_n_u16(fraction);
+  const uint16x8_t src0_fraction = vdupq_n_u16(256 - fraction);
+
+  // Unlike the SSE2 version, this never writes past |dest| + |width|.
+  int pixel = 0;
+  for (; pixel + 16 <= width; pixel += 16) {
+    uint8x16_t src0_x16 = vld1q_u8(src0 + pixel);
+    uint8x16_t src1_x16 = vld1q_u8(src1 + pixel);
+    uint16x8_t low = vmulq_u16(vmovl_u8(vget_low_u8(src0_x16)), src0_fraction);
+    uint16x8_t high =
+        vmulq_u16(vmovl_u8(vget_high_u8(src0_x16)), src0_fraction);
+    low = vmlaq_u16(low, vmovl_u8(vget_low_u8(src1_x16)), src1_fraction);
+    high = vmlaq_u16(high, vmovl_u8(vget_high_u8(src1_x16)), src1_fraction);
+    vst1q_u8(dest + pixel,
+             vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8)));
+  }
+
+  for (; pixel < width; ++pixel) {
+    dest[pixel] = (src0[pixel] * (256 - fraction) +
+                   src1[pixel] * fraction) >> 8;
+  }
+}
+
+}  // namespace media
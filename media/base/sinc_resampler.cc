@@ -106,27 +106,32 @@ static double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
-// If we know the minimum architecture at compile time, avoid CPU detection.
+// On ARM the minimum architecture is known at compile time, so there is no
+// CPU detection.
 // Force NaCl code to use C routines since (at present) nothing there uses these
 // methods and plumbing the -msse built library is non-trivial.
 #if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
-#if defined(__SSE__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
 // X86 CPU detection required.  Functions will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// InitializeCPUSpecificFeatures().  When SSE is the compile time baseline, it
+// is used until then, and AVX is only picked up at run time.
 #define CONVOLVE_FUNC g_convolve_proc_
 
 typedef float (*ConvolveProc)(const float*, const float*, const float*, double);
+#if defined(__SSE__)
+static ConvolveProc g_convolve_proc_ = SincResampler::Convolve_SSE;
+#else
 static ConvolveProc g_convolve_proc_ = NULL;
+#endif
 
 void SincResampler::InitializeCPUSpecificFeatures() {
-  CHECK(!g_convolve_proc_);
-  g_convolve_proc_ = base::CPU().has_sse() ? Convolve_SSE : Convolve_C;
+  base::CPU cpu;
+  if (cpu.has_avx())
+    g_convolve_proc_ = Convolve_AVX;
+  else if (cpu.has_sse())
+    g_convolve_proc_ = Convolve_SSE;
+  else
+    g_convolve_proc_ = Convolve_C;
 }
-#endif
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -179,6 +179,13 @@ void InitializeCPUSpecificYUVConversions() {
     // TODO(hclam): Add ConvertRGB32ToYUV_SSSE3 when the cyan problem is solved.
     // See: crbug.com/100462
   }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  // NEON support is chosen at compile time, like in vector_math.cc.
+  g_filter_yuv_rows_proc_ = FilterYUVRows_NEON;
+  g_convert_yuv_to_rgb32_row_proc_ = ConvertYUVToRGB32Row_NEON;
+  g_scale_yuv_to_rgb32_row_proc_ = ScaleYUVToRGB32Row_NEON;
+  g_linear_scale_yuv_to_rgb32_row_proc_ = LinearScaleYUVToRGB32Row_NEON;
+  g_convert_yuv_to_rgb32_proc_ = ConvertYUVToRGB32_NEON;
 #endif
 }
 
@@ -0,0 +1,172 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/base_paths.h"
+#include "base/cpu.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/path_service.h"
+#include "base/time/time.h"
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/filter_yuv.h"
+#include "media/base/yuv_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace media {
+
+static const int kSourceWidth = 640;
+static const int kSourceHeight = 360;
+static const int kSourceYSize = kSourceWidth * kSourceHeight;
+static const int kSourceUOffset = kSourceYSize;
+static const int kSourceVOffset = kSourceYSize * 5 / 4;
+static const int kYUV12Size = kSourceYSize * 12 / 8;
+static const int kBpp = 4;
+static const int kRGBSize = kSourceYSize * kBpp;
+
+// A scale down, as used for rendering video into a smaller window.
+static const int kSourceDx = 80000;
+
+static const int kPerfTestIterations = 2000;
+
+typedef void (*ConvertRowProc)(const uint8*,
+                               const uint8*,
+                               const uint8*,
+                               uint8*,
+                               ptrdiff_t);
+typedef void (*ScaleRowProc)(const uint8*,
+                             const uint8*,
+                             const uint8*,
+                             uint8*,
+                             ptrdiff_t,
+                             ptrdiff_t);
+typedef void (*FilterRowsProc)(uint8*, const uint8*, const uint8*, int, int);
+
+class YUVConvertPerfTest : public testing::Test {
+ public:
+  YUVConvertPerfTest()
+      : yuv_bytes_(new uint8[kYUV12Size]),
+        rgb_bytes_converted_(new uint8[kRGBSize]) {
+    base::FilePath path;
+    CHECK(PathService::Get(base::DIR_SOURCE_ROOT, &path));
+    path = path.Append(FILE_PATH_LITERAL("media"))
+               .Append(FILE_PATH_LITERAL("test"))
+               .Append(FILE_PATH_LITERAL("data"))
+               .Append(FILE_PATH_LITERAL("bali_640x360_P420.yuv"));
+    CHECK_EQ(kYUV12Size,
+             base::ReadFile(path,
+                            reinterpret_cast<char*>(yuv_bytes_.get()),
+                            kYUV12Size));
+  }
+
+  // Converts every row of the test frame |kPerfTestIterations| times.
+  void RunConvertRowBenchmark(ConvertRowProc proc,
+                              const std::string& trace_name) {
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int i = 0; i < kPerfTestIterations; ++i) {
+      for (int row = 0; row < kSourceHeight; ++row) {
+        proc(yuv_bytes_.get() + row * kSourceWidth,
+             yuv_bytes_.get() + kSourceUOffset + (row / 2) * kSourceWidth / 2,
+             yuv_bytes_.get() + kSourceVOffset + (row / 2) * kSourceWidth / 2,
+             rgb_bytes_converted_.get(),
+             kSourceWidth);
+      }
+    }
+    EmptyRegisterState();
+    PrintResult("yuv_convert_row", trace_name, start);
+  }
+
+  // Scales every row of the test frame |kPerfTestIterations| times.
+  void RunScaleRowBenchmark(ScaleRowProc proc,
+                            const std::string& test_name,
+                            const std::string& trace_name) {
+    const int kDestWidth = kSourceWidth * 65536 / kSourceDx;
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int i = 0; i < kPerfTestIterations; ++i) {
+      for (int row = 0; row < kSourceHeight; ++row) {
+        proc(yuv_bytes_.get() + row * kSourceWidth,
+             yuv_bytes_.get() + kSourceUOffset + (row / 2) * kSourceWidth / 2,
+             yuv_bytes_.get() + kSourceVOffset + (row / 2) * kSourceWidth / 2,
+             rgb_bytes_converted_.get(),
+             kDestWidth,
+             kSourceDx);
+      }
+    }
+    EmptyRegisterState();
+    PrintResult(test_name, trace_name, start);
+  }
+
+  // Filters every pair of rows of the test frame |kPerfTestIterations| times.
+  void RunFilterRowsBenchmark(FilterRowsProc proc,
+                              const std::string& trace_name) {
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    for (int i = 0; i < kPerfTestIterations; ++i) {
+      for (int row = 0; row < kSourceHeight - 1; ++row) {
+        proc(rgb_bytes_converted_.get(),
+             yuv_bytes_.get() + row * kSourceWidth,
+             yuv_bytes_.get() + (row + 1) * kSourceWidth,
+             kSourceWidth,
+             128);
+      }
+    }
+    EmptyRegisterState();
+    PrintResult("yuv_filter_rows", trace_name, start);
+  }
+
+ private:
+  void PrintResult(const std::string& test_name,
+                   const std::string& trace_name,
+                   base::TimeTicks start) {
+    double total_time_seconds =
+        (base::TimeTicks::HighResNow() - start).InSecondsF();
+    perf_test::PrintResult(test_name, "", trace_name,
+                           kPerfTestIterations / total_time_seconds,
+                           "frames/s", true);
+  }
+
+  scoped_ptr<uint8[]> yuv_bytes_;
+  scoped_ptr<uint8[]> rgb_bytes_converted_;
+
+  DISALLOW_COPY_AND_ASSIGN(YUVConvertPerfTest);
+};
+
+TEST_F(YUVConvertPerfTest, ConvertYUVToRGB32Row) {
+  RunConvertRowBenchmark(ConvertYUVToRGB32Row_C, "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_sse())
+    RunConvertRowBenchmark(ConvertYUVToRGB32Row_SSE, "sse");
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunConvertRowBenchmark(ConvertYUVToRGB32Row_NEON, "neon");
+#endif
+}
+
+TEST_F(YUVConvertPerfTest, ScaleYUVToRGB32Row) {
+  RunScaleRowBenchmark(ScaleYUVToRGB32Row_C, "yuv_scale_row", "c");
+  RunScaleRowBenchmark(
+      LinearScaleYUVToRGB32Row_C, "yuv_linear_scale_row", "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_sse()) {
+    RunScaleRowBenchmark(ScaleYUVToRGB32Row_SSE, "yuv_scale_row", "sse");
+    RunScaleRowBenchmark(
+        LinearScaleYUVToRGB32Row_SSE, "yuv_linear_scale_row", "sse");
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunScaleRowBenchmark(ScaleYUVToRGB32Row_NEON, "yuv_scale_row", "neon");
+  RunScaleRowBenchmark(
+      LinearScaleYUVToRGB32Row_NEON, "yuv_linear_scale_row", "neon");
+#endif
+}
+
+TEST_F(YUVConvertPerfTest, FilterYUVRows) {
+  RunFilterRowsBenchmark(FilterYUVRows_C, "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_sse2())
+    RunFilterRowsBenchmark(FilterYUVRows_SSE2, "sse2");
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunFilterRowsBenchmark(FilterYUVRows_NEON, "neon");
+#endif
+}
+
+}  // namespace media
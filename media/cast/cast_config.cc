@@ -49,6 +49,7 @@ VideoReceiverConfig::VideoReceiverConfig()
       rtcp_mode(kRtcpReducedSize),
       rtp_max_delay_ms(kDefaultRtpMaxDelayMs),
       rtp_payload_type(0),
+      adaptive_playout_delay(false),
       use_external_decoder(false),
       max_frame_rate(kDefaultMaxFrameRate),
       decoder_faster_than_max_frame_rate(true) {}
@@ -107,6 +107,10 @@ struct VideoReceiverConfig {
   int rtp_max_delay_ms;
   int rtp_payload_type;
 
+  // Play out with a delay driven by the measured frame arrival jitter,
+  // instead of always waiting |rtp_max_delay_ms|.
+  bool adaptive_playout_delay;
+
   bool use_external_decoder;
   int max_frame_rate;
 
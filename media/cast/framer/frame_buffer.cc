@@ -45,14 +45,10 @@ void FrameBuffer::InsertPacket(const uint8* payload_data,
     return;
   }
 
-  std::vector<uint8> data;
-  std::pair<PacketMap::iterator, bool> retval =
-      packets_.insert(make_pair(rtp_header.packet_id, data));
-
-  // Insert the packet.
-  retval.first->second.resize(payload_size);
-  std::copy(
-      payload_data, payload_data + payload_size, retval.first->second.begin());
+  // Insert the packet; the payload is copied straight into the new entry,
+  // without zero-filling it first.
+  packets_[rtp_header.packet_id].assign(payload_data,
+                                        payload_data + payload_size);
 
   ++num_packets_received_;
   total_data_size_ += payload_size;
@@ -56,6 +56,7 @@ std::string CastLoggingToString(CastLoggingEvent event) {
     ENUM_TO_STRING(VideoFrameReceived);
     ENUM_TO_STRING(VideoFrameSentToEncoder);
     ENUM_TO_STRING(VideoFrameEncoded);
+    ENUM_TO_STRING(VideoFrameDropped);
     ENUM_TO_STRING(VideoFrameDecoded);
     ENUM_TO_STRING(VideoRenderDelay);
     ENUM_TO_STRING(PacketSentToPacer);
@@ -100,6 +101,7 @@ EventMediaType GetEventMediaType(CastLoggingEvent event) {
     case kVideoFrameReceived:
     case kVideoFrameSentToEncoder:
     case kVideoFrameEncoded:
+    case kVideoFrameDropped:
     case kVideoFrameDecoded:
     case kVideoRenderDelay:
     case kVideoPacketReceived:
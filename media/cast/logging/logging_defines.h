@@ -59,6 +59,7 @@ enum CastLoggingEvent {
   kVideoFrameReceived,
   kVideoFrameSentToEncoder,
   kVideoFrameEncoded,
+  kVideoFrameDropped,
   // Video receiver.
   kVideoFrameDecoded,
   kVideoRenderDelay,
@@ -28,8 +28,8 @@ PacedSender::PacedSender(
       transport_task_runner_(transport_task_runner),
       burst_size_(1),
       packets_sent_in_burst_(0),
+      send_scheduled_(false),
       weak_factory_(this) {
-  ScheduleNextSend();
 }
 
 PacedSender::~PacedSender() {}
@@ -68,6 +68,13 @@ bool PacedSender::SendPacketsToTransport(const PacketList& packets,
   packets_not_sent->insert(
       packets_not_sent->end(), first_to_store_it, packets.end());
   packets_sent_in_burst_ = packets_to_send.size();
+
+  // Packets sent while no burst was scheduled start a new pacing interval.
+  if (!send_scheduled_ && !packets_to_send.empty())
+    time_last_process_ = clock_->NowTicks();
+  if (!packets_not_sent->empty())
+    ScheduleNextSend();
+
   if (packets_to_send.empty())
     return true;
 
@@ -80,6 +87,10 @@ bool PacedSender::SendRtcpPacket(const Packet& packet) {
 }
 
 void PacedSender::ScheduleNextSend() {
+  if (send_scheduled_)
+    return;
+  send_scheduled_ = true;
+
   base::TimeDelta time_to_next =
       time_last_process_ - clock_->NowTicks() +
       base::TimeDelta::FromMilliseconds(kPacingIntervalMs);
@@ -93,9 +104,11 @@ void PacedSender::ScheduleNextSend() {
 }
 
 void PacedSender::SendNextPacketBurst() {
+  send_scheduled_ = false;
   SendStoredPackets();
   time_last_process_ = clock_->NowTicks();
-  ScheduleNextSend();
+  if (!packet_list_.empty() || !resend_packet_list_.empty())
+    ScheduleNextSend();
 }
 
 void PacedSender::SendStoredPackets() {
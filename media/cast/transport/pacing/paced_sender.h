@@ -58,7 +58,8 @@ class PacedSender : public PacedPacketSender,
 
  protected:
   // Schedule a delayed task on the main cast thread when it's time to send the
-  // next packet burst.
+  // next packet burst, unless one is already scheduled. Nothing is scheduled
+  // while there are no stored packets, so an idle sender doesn't wake up.
   void ScheduleNextSend();
 
   // Process any pending packets in the queue(s).
@@ -80,6 +81,7 @@ class PacedSender : public PacedPacketSender,
   size_t burst_size_;
   size_t packets_sent_in_burst_;
   base::TimeTicks time_last_process_;
+  bool send_scheduled_;
   // Note: We can't combine the |packet_list_| and the |resend_packet_list_|
   // since then we might get reordering of the retransmitted packets.
   PacketList packet_list_;
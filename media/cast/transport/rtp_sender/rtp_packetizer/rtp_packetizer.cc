@@ -105,12 +105,17 @@ void RtpPacketizer::Cast(bool is_key,
   size_t payload_length = (data.size() + num_packets) / num_packets;
   DCHECK_LE(payload_length, max_length) << "Invalid argument";
 
+  // Build the packets in place, each sized for its header and payload up
+  // front, rather than growing and then copying them into the list.
   PacketList packets;
+  packets.reserve(num_packets);
 
   size_t remaining_size = data.size();
   std::string::const_iterator data_iter = data.begin();
   while (remaining_size > 0) {
-    Packet packet;
+    packets.push_back(Packet());
+    Packet& packet = packets.back();
+    packet.reserve(rtp_header_length + payload_length);
 
     if (remaining_size < payload_length) {
       payload_length = remaining_size;
@@ -140,7 +145,6 @@ void RtpPacketizer::Cast(bool is_key,
     // Update stats.
     ++send_packets_count_;
     send_octet_count_ += payload_length;
-    packets.push_back(packet);
   }
   DCHECK(packet_id_ == num_packets) << "Invalid state";
 
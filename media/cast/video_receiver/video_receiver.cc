@@ -21,6 +21,9 @@ static const int64 kMinSchedulingDelayMs = 1;
 static const int64 kMinTimeBetweenOffsetUpdatesMs = 2000;
 static const int kTimeOffsetFilter = 8;
 static const int64_t kMinProcessIntervalMs = 5;
+// The adaptive playout delay covers this many times the frame jitter.
+static const int kJitterMultiplier = 4;
+static const int kJitterFilter = 16;
 
 }  // namespace
 
@@ -110,6 +113,9 @@ VideoReceiver::VideoReceiver(scoped_refptr<CastEnvironment> cast_environment,
       decryptor_(),
       time_incoming_packet_updated_(false),
       incoming_rtp_timestamp_(0),
+      adaptive_playout_delay_(video_config.adaptive_playout_delay),
+      max_target_delay_(target_delay_delta_),
+      last_frame_complete_rtp_timestamp_(0),
       weak_factory_(this) {
   int max_unacked_frames =
       video_config.rtp_max_delay_ms * video_config.max_frame_rate / 1000;
@@ -391,6 +397,38 @@ base::TimeTicks VideoReceiver::GetRenderTime(base::TimeTicks now,
   return render_time;
 }
 
+void VideoReceiver::UpdateTargetDelay(base::TimeTicks now,
+                                      uint32 rtp_timestamp) {
+  DCHECK(cast_environment_->CurrentlyOn(CastEnvironment::MAIN));
+  if (!last_frame_complete_time_.is_null()) {
+    // Interarrival jitter as in RFC 3550, but measured on complete frames so
+    // that it includes the time spent waiting for retransmissions.
+    int64 rtp_delta = static_cast<int32>(
+        rtp_timestamp - last_frame_complete_rtp_timestamp_);
+    base::TimeDelta deviation =
+        (now - last_frame_complete_time_) -
+        base::TimeDelta::FromMicroseconds(rtp_delta * 1000000 /
+                                          kVideoFrequency);
+    if (deviation < base::TimeDelta())
+      deviation = -deviation;
+    frame_jitter_ += (deviation - frame_jitter_) / kJitterFilter;
+  }
+  last_frame_complete_time_ = now;
+  last_frame_complete_rtp_timestamp_ = rtp_timestamp;
+
+  base::TimeDelta target_delay = std::min(
+      max_target_delay_, frame_delay_ + kJitterMultiplier * frame_jitter_);
+  if (target_delay > target_delay_delta_) {
+    // Grow right away to avoid missing the render time of the next frames.
+    target_delay_delta_ = target_delay;
+  } else {
+    // Shrink slowly; render times never go backwards, so the frames already
+    // scheduled are rendered at the same time as the last one meanwhile.
+    target_delay_delta_ -=
+        (target_delay_delta_ - target_delay) / kTimeOffsetFilter;
+  }
+}
+
 void VideoReceiver::IncomingPacket(scoped_ptr<Packet> packet) {
   DCHECK(cast_environment_->CurrentlyOn(CastEnvironment::MAIN));
   if (Rtcp::IsRtcpPacket(&packet->front(), packet->size())) {
@@ -443,6 +481,8 @@ void VideoReceiver::IncomingParsedRtpPacket(const uint8* payload_data,
   }
   if (!complete)
     return;  // Video frame not complete; wait for more packets.
+  if (adaptive_playout_delay_)
+    UpdateTargetDelay(now, rtp_header.webrtc.header.timestamp);
   if (queued_encoded_callbacks_.empty())
     return;  // No pending callback.
 
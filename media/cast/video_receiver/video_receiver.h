@@ -52,6 +52,9 @@ class VideoReceiver : public base::NonThreadSafe,
   // Insert a RTP packet to the video receiver.
   void IncomingPacket(scoped_ptr<Packet> packet);
 
+  // The delay added to the capture time of frames to schedule their render.
+  base::TimeDelta target_delay() const { return target_delay_delta_; }
+
  protected:
   void IncomingParsedRtpPacket(const uint8* payload_data,
                                size_t payload_size,
@@ -84,6 +87,10 @@ class VideoReceiver : public base::NonThreadSafe,
   // Returns Render time based on current time and the rtp timestamp.
   base::TimeTicks GetRenderTime(base::TimeTicks now, uint32 rtp_timestamp);
 
+  // Updates the frame arrival jitter with a frame completed at |now|, and
+  // adapts |target_delay_delta_| to it.
+  void UpdateTargetDelay(base::TimeTicks now, uint32 rtp_timestamp);
+
   void InitializeTimers();
 
   // Schedule timing for the next cast message.
@@ -122,6 +129,13 @@ class VideoReceiver : public base::NonThreadSafe,
   uint32 incoming_rtp_timestamp_;
   base::TimeTicks last_render_time_;
 
+  // Adaptive playout delay state.
+  const bool adaptive_playout_delay_;
+  const base::TimeDelta max_target_delay_;
+  base::TimeDelta frame_jitter_;
+  base::TimeTicks last_frame_complete_time_;
+  uint32 last_frame_complete_rtp_timestamp_;
+
   base::WeakPtrFactory<VideoReceiver> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(VideoReceiver);
@@ -164,6 +164,42 @@ TEST_F(VideoReceiverTest, GetOnePacketRawframe) {
   EXPECT_EQ(video_receiver_callback_->number_times_called(), 0);
 }
 
+TEST_F(VideoReceiverTest, AdaptivePlayoutDelay) {
+  EXPECT_CALL(mock_transport_, SendRtcpPacket(_))
+      .WillRepeatedly(testing::Return(true));
+  config_.adaptive_playout_delay = true;
+  receiver_.reset(
+      new PeerVideoReceiver(cast_environment_, config_, &mock_transport_));
+  const base::TimeDelta max_delay =
+      base::TimeDelta::FromMilliseconds(config_.rtp_max_delay_ms);
+  EXPECT_EQ(max_delay, receiver_->target_delay());
+
+  // Frames arriving exactly on time shrink the delay.
+  for (int i = 0; i < 30; ++i) {
+    receiver_->IncomingParsedRtpPacket(
+        payload_.data(), payload_.size(), rtp_header_);
+    testing_clock_->Advance(base::TimeDelta::FromMilliseconds(33));
+    rtp_header_.webrtc.header.timestamp += 33 * 90;
+    ++rtp_header_.webrtc.header.sequenceNumber;
+    ++rtp_header_.frame_id;
+    rtp_header_.is_key_frame = false;
+  }
+  base::TimeDelta steady_delay = receiver_->target_delay();
+  EXPECT_LT(steady_delay, max_delay);
+
+  // Frames arriving in bursts grow it again.
+  for (int i = 0; i < 10; ++i) {
+    receiver_->IncomingParsedRtpPacket(
+        payload_.data(), payload_.size(), rtp_header_);
+    testing_clock_->Advance(base::TimeDelta::FromMilliseconds(i % 2 ? 6 : 60));
+    rtp_header_.webrtc.header.timestamp += 33 * 90;
+    ++rtp_header_.webrtc.header.sequenceNumber;
+    ++rtp_header_.frame_id;
+  }
+  EXPECT_GT(receiver_->target_delay(), steady_delay);
+  EXPECT_LE(receiver_->target_delay(), max_delay);
+}
+
 // TODO(pwestin): add encoded frames.
 
 }  // namespace cast
@@ -181,11 +181,32 @@ void VideoSender::InsertRawVideoFrame(
       GetVideoRtpTimestamp(capture_time),
       kFrameIdUnknown);
 
-  if (!video_encoder_->EncodeVideoFrame(
-           video_frame,
-           capture_time,
-           base::Bind(&VideoSender::SendEncodedVideoFrameMainThread,
-                      weak_factory_.GetWeakPtr()))) {
+  while (!frames_in_encoder_.empty() &&
+         capture_time - frames_in_encoder_.front() > rtp_max_delay_) {
+    frames_in_encoder_.pop_front();
+  }
+
+  // Each frame waiting in the encoder delays this one by about a frame
+  // interval. Once more frames are queued than can be unacked within
+  // |rtp_max_delay_|, this one would reach the receiver too late to be
+  // played, so drop it now rather than spend encoder time on it.
+  if (frames_in_encoder_.size() >= max_unacked_frames_) {
+    VLOG(1) << "Dropping frame, " << frames_in_encoder_.size()
+            << " frames in the encoder";
+    cast_environment_->Logging()->InsertFrameEvent(
+        now,
+        kVideoFrameDropped,
+        GetVideoRtpTimestamp(capture_time),
+        kFrameIdUnknown);
+    return;
+  }
+
+  if (video_encoder_->EncodeVideoFrame(
+          video_frame,
+          capture_time,
+          base::Bind(&VideoSender::SendEncodedVideoFrameMainThread,
+                     weak_factory_.GetWeakPtr()))) {
+    frames_in_encoder_.push_back(capture_time);
   }
 }
 
@@ -193,6 +214,11 @@ void VideoSender::SendEncodedVideoFrameMainThread(
     scoped_ptr<transport::EncodedVideoFrame> encoded_frame,
     const base::TimeTicks& capture_time) {
   DCHECK(cast_environment_->CurrentlyOn(CastEnvironment::MAIN));
+  while (!frames_in_encoder_.empty() &&
+         frames_in_encoder_.front() <= capture_time) {
+    frames_in_encoder_.pop_front();
+  }
+
   last_send_time_ = cast_environment_->Clock()->NowTicks();
   if (encoded_frame->key_frame) {
     VLOG(1) << "Send encoded key frame; frame_id:"
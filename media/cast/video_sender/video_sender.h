@@ -5,6 +5,8 @@
 #ifndef MEDIA_CAST_VIDEO_SENDER_VIDEO_SENDER_H_
 #define MEDIA_CAST_VIDEO_SENDER_VIDEO_SENDER_H_
 
+#include <deque>
+
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -129,6 +131,12 @@ class VideoSender : public base::NonThreadSafe,
   int last_skip_count_;
   CongestionControl congestion_control_;
 
+  // Capture times of the frames handed to |video_encoder_| that haven't
+  // come back encoded yet, oldest first. Encoders may drop frames without
+  // telling us, so entries for frames older than one that came back, or
+  // older than |rtp_max_delay_|, are discarded.
+  std::deque<base::TimeTicks> frames_in_encoder_;
+
   bool initialized_;
   base::WeakPtrFactory<VideoSender> weak_factory_;
 
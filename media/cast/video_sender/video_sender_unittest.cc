@@ -9,6 +9,7 @@
 #include "base/test/simple_test_tick_clock.h"
 #include "media/base/video_frame.h"
 #include "media/cast/cast_environment.h"
+#include "media/cast/logging/simple_event_subscriber.h"
 #include "media/cast/test/fake_gpu_video_accelerator_factories.h"
 #include "media/cast/test/fake_single_thread_task_runner.h"
 #include "media/cast/test/utility/video_utility.h"
@@ -90,7 +91,7 @@ class VideoSenderTest : public ::testing::Test {
                             task_runner_,
                             task_runner_,
                             task_runner_,
-                            GetDefaultCastSenderLoggingConfig());
+                            GetLoggingConfigWithRawEventsAndStatsEnabled());
     transport::CastTransportConfig transport_config;
     transport_sender_.reset(new transport::CastTransportSenderImpl(
         testing_clock_,
@@ -225,6 +226,39 @@ TEST_F(VideoSenderTest, RtcpTimer) {
   EXPECT_GE(transport_.number_of_rtcp_packets(), 1);
 }
 
+TEST_F(VideoSenderTest, DropsFramesWhenEncoderFallsBehind) {
+  InitEncoder(false);
+  SimpleEventSubscriber event_subscriber;
+  cast_environment_->Logging()->AddRawEventSubscriber(&event_subscriber);
+
+  // None of the frames are encoded until the tasks run, so the queue of
+  // frames in the encoder keeps growing until frames are dropped.
+  const int kNumFrames = 20;
+  base::TimeTicks capture_time;
+  for (int i = 0; i < kNumFrames; ++i)
+    video_sender_->InsertRawVideoFrame(GetNewVideoFrame(), capture_time);
+
+  std::vector<FrameEvent> frame_events;
+  event_subscriber.GetFrameEventsAndReset(&frame_events);
+  int dropped_frames = 0;
+  for (size_t i = 0; i < frame_events.size(); ++i) {
+    if (frame_events[i].type == kVideoFrameDropped)
+      ++dropped_frames;
+  }
+  EXPECT_GT(dropped_frames, 0);
+  EXPECT_LT(dropped_frames, kNumFrames);
+
+  // Once the encoder has caught up, frames are accepted again.
+  task_runner_->RunTasks();
+  event_subscriber.GetFrameEventsAndReset(&frame_events);
+  video_sender_->InsertRawVideoFrame(GetNewVideoFrame(), capture_time);
+  event_subscriber.GetFrameEventsAndReset(&frame_events);
+  for (size_t i = 0; i < frame_events.size(); ++i)
+    EXPECT_NE(kVideoFrameDropped, frame_events[i].type);
+
+  cast_environment_->Logging()->RemoveRawEventSubscriber(&event_subscriber);
+}
+
 TEST_F(VideoSenderTest, ResendTimer) {
   InitEncoder(false);
 
@@ -4,6 +4,10 @@
 
 #include "media/filters/blocking_url_protocol.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/bind.h"
 #include "media/base/data_source.h"
 #include "media/ffmpeg/ffmpeg_common.h"
@@ -18,10 +22,22 @@ BlockingUrlProtocol::BlockingUrlProtocol(
       aborted_(true, false),  // We never want to reset |aborted_|.
       read_complete_(false, false),
       last_read_bytes_(0),
-      read_position_(0) {
+      read_position_(0),
+      prefetch_size_(0),
+      prefetch_pending_(false) {
+}
+
+BlockingUrlProtocol::~BlockingUrlProtocol() {
+  // The prefetch writes into |next_window_|, so it must not outlive us.
+  if (prefetch_pending_) {
+    base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
+    base::WaitableEvent::WaitMany(events, arraysize(events));
+  }
 }
 
-BlockingUrlProtocol::~BlockingUrlProtocol() {}
+BlockingUrlProtocol::Window::Window() : position(0), size(0) {}
+
+BlockingUrlProtocol::Window::~Window() {}
 
 void BlockingUrlProtocol::Abort() {
   aborted_.Signal();
@@ -38,25 +54,37 @@ int BlockingUrlProtocol::Read(int size, uint8* data) {
   if (data_source_->GetSize(&file_size) && read_position_ >= file_size)
     return 0;
 
+  // Move on to the prefetched window once the current one is used up, or
+  // after a seek, since the data source can't take another read before the
+  // prefetch completes anyway.
+  if (prefetch_pending_ && !current_window_.Contains(read_position_)) {
+    prefetch_pending_ = false;
+    if (!WaitForRead())
+      return AVERROR(EIO);
+    current_window_.data.swap(next_window_.data);
+    current_window_.position = next_window_.position;
+    current_window_.size = last_read_bytes_;
+  }
+
+  if (current_window_.Contains(read_position_)) {
+    int offset = static_cast<int>(read_position_ - current_window_.position);
+    int bytes = std::min(size, current_window_.size - offset);
+    memcpy(data, &current_window_.data[offset], bytes);
+    read_position_ += bytes;
+    StartPrefetch(current_window_.position + current_window_.size);
+    return bytes;
+  }
+
   // Blocking read from data source until either:
   //   1) |last_read_bytes_| is set and |read_complete_| is signalled
   //   2) |aborted_| is signalled
   data_source_->Read(read_position_, size, data, base::Bind(
       &BlockingUrlProtocol::SignalReadCompleted, base::Unretained(this)));
-
-  base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
-  size_t index = base::WaitableEvent::WaitMany(events, arraysize(events));
-
-  if (events[index] == &aborted_)
+  if (!WaitForRead())
     return AVERROR(EIO);
 
-  if (last_read_bytes_ == DataSource::kReadError) {
-    aborted_.Signal();
-    error_cb_.Run();
-    return AVERROR(EIO);
-  }
-
   read_position_ += last_read_bytes_;
+  StartPrefetch(read_position_);
   return last_read_bytes_;
 }
 
@@ -89,4 +117,36 @@ void BlockingUrlProtocol::SignalReadCompleted(int size) {
   read_complete_.Signal();
 }
 
+bool BlockingUrlProtocol::WaitForRead() {
+  base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
+  size_t index = base::WaitableEvent::WaitMany(events, arraysize(events));
+
+  if (events[index] == &aborted_)
+    return false;
+
+  if (last_read_bytes_ == DataSource::kReadError) {
+    aborted_.Signal();
+    error_cb_.Run();
+    return false;
+  }
+  return true;
+}
+
+void BlockingUrlProtocol::StartPrefetch(int64 position) {
+  if (!prefetch_size_ || prefetch_pending_)
+    return;
+
+  int64 file_size;
+  if (data_source_->GetSize(&file_size) && position >= file_size)
+    return;
+
+  next_window_.data.resize(prefetch_size_);
+  next_window_.position = position;
+  next_window_.size = 0;
+  prefetch_pending_ = true;
+  data_source_->Read(position, prefetch_size_, &next_window_.data[0],
+                     base::Bind(&BlockingUrlProtocol::SignalReadCompleted,
+                                base::Unretained(this)));
+}
+
 }  // namespace media
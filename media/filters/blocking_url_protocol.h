@@ -5,6 +5,8 @@
 #ifndef MEDIA_FILTERS_BLOCKING_URL_PROTOCOL_H_
 #define MEDIA_FILTERS_BLOCKING_URL_PROTOCOL_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/synchronization/waitable_event.h"
@@ -16,6 +18,10 @@ class DataSource;
 
 // An implementation of FFmpegURLProtocol that blocks until the underlying
 // asynchronous DataSource::Read() operation completes.
+//
+// If a prefetch size is set, every read is followed by an asynchronous read
+// of the next |prefetch_size| bytes, so that sequential reads are served from
+// memory while the data source fetches the following window.
 class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
  public:
   // Implements FFmpegURLProtocol using the given |data_source|. |error_cb| is
@@ -30,6 +36,10 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   // returns all subsequent calls to Read() will immediately fail.
   void Abort();
 
+  // Sets the size of the window read ahead of the current position. Zero,
+  // the default, disables prefetching. Must be called before the first Read().
+  void set_prefetch_size(int prefetch_size) { prefetch_size_ = prefetch_size; }
+
   // FFmpegURLProtocol implementation.
   virtual int Read(int size, uint8* data) OVERRIDE;
   virtual bool GetPosition(int64* position_out) OVERRIDE;
@@ -38,10 +48,32 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   virtual bool IsStreaming() OVERRIDE;
 
  private:
+  // Data read from the data source at |position|.
+  struct Window {
+    Window();
+    ~Window();
+
+    bool Contains(int64 offset) const {
+      return offset >= position && offset < position + size;
+    }
+
+    std::vector<uint8> data;
+    int64 position;
+    int size;
+  };
+
   // Sets |last_read_bytes_| and signals the blocked thread that the read
   // has completed.
   void SignalReadCompleted(int size);
 
+  // Waits for the outstanding DataSource::Read() to complete. Returns false
+  // if the read failed or the protocol was aborted.
+  bool WaitForRead();
+
+  // Starts reading |prefetch_size_| bytes at |position| into |next_window_|,
+  // unless a prefetch is already outstanding.
+  void StartPrefetch(int64 position);
+
   DataSource* data_source_;
   base::Closure error_cb_;
 
@@ -55,6 +87,16 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   // Cached position within the data source.
   int64 read_position_;
 
+  int prefetch_size_;
+
+  // |current_window_| is served to Read(), while |next_window_| is filled
+  // by the outstanding prefetch if |prefetch_pending_| is true. The data
+  // source only supports one read at a time, so a read that misses
+  // |current_window_| waits for the prefetch first.
+  Window current_window_;
+  Window next_window_;
+  bool prefetch_pending_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(BlockingUrlProtocol);
 };
 
@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+
 #include "base/bind.h"
+#include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/waitable_event.h"
 #include "media/base/test_data_util.h"
@@ -83,6 +86,33 @@ TEST_F(BlockingUrlProtocolTest, ReadError) {
   EXPECT_EQ(AVERROR(EIO), url_protocol_.Read(32, buffer));
 }
 
+TEST_F(BlockingUrlProtocolTest, ReadWithPrefetch) {
+  std::string expected;
+  ASSERT_TRUE(base::ReadFileToString(GetTestDataFilePath("bear-320x240.webm"),
+                                     &expected));
+
+  // Reads straddle the prefetched windows, which may return them short.
+  url_protocol_.set_prefetch_size(100);
+  EXPECT_TRUE(url_protocol_.SetPosition(0));
+  std::string actual;
+  uint8 buffer[32];
+  int bytes_read;
+  while ((bytes_read = url_protocol_.Read(32, buffer)) > 0)
+    actual.append(reinterpret_cast<char*>(buffer), bytes_read);
+  EXPECT_EQ(0, bytes_read);
+  EXPECT_TRUE(expected == actual);
+
+  // Seeking back within and before the prefetched data reads the right bytes.
+  int64 size = 0;
+  EXPECT_TRUE(url_protocol_.GetSize(&size));
+  EXPECT_TRUE(url_protocol_.SetPosition(size - 16));
+  EXPECT_EQ(16, url_protocol_.Read(32, buffer));
+  EXPECT_EQ(0, memcmp(buffer, &expected[size - 16], 16));
+  EXPECT_TRUE(url_protocol_.SetPosition(64));
+  EXPECT_EQ(32, url_protocol_.Read(32, buffer));
+  EXPECT_EQ(0, memcmp(buffer, &expected[64], 32));
+}
+
 TEST_F(BlockingUrlProtocolTest, GetSetPosition) {
   int64 size;
   int64 position;
@@ -145,6 +145,10 @@ class SourceState {
   // Returns TimeDelta() if none of the streams contain buffered data.
   TimeDelta GetMaxBufferedDuration() const;
 
+  // Returns the number of bytes of media data buffered across all streams
+  // managed by this object.
+  int GetMemoryUsage() const;
+
   // Helper methods that call methods with similar names on all the
   // ChunkDemuxerStreams managed by this object.
   void StartReturningData();
@@ -304,6 +308,9 @@ class ChunkDemuxerStream : public DemuxerStream {
   // Returns TimeDelta() if the stream has no buffered data.
   TimeDelta GetBufferedDuration() const;
 
+  // Returns the number of bytes of media data buffered in this stream.
+  int GetMemoryUsage() const;
+
   // Signal to the stream that buffers handed in through subsequent calls to
   // Append() belong to a media segment that starts at |start_timestamp|.
   void OnNewMediaSegment(TimeDelta start_timestamp);
@@ -485,6 +492,23 @@ TimeDelta SourceState::GetMaxBufferedDuration() const {
   return max_duration;
 }
 
+int SourceState::GetMemoryUsage() const {
+  int memory_usage = 0;
+
+  if (audio_)
+    memory_usage += audio_->GetMemoryUsage();
+
+  if (video_)
+    memory_usage += video_->GetMemoryUsage();
+
+  for (TextStreamMap::const_iterator itr = text_stream_map_.begin();
+       itr != text_stream_map_.end(); ++itr) {
+    memory_usage += itr->second->GetMemoryUsage();
+  }
+
+  return memory_usage;
+}
+
 void SourceState::StartReturningData() {
   if (audio_)
     audio_->StartReturningData();
@@ -1053,6 +1077,11 @@ TimeDelta ChunkDemuxerStream::GetBufferedDuration() const {
   return stream_->GetBufferedDuration();
 }
 
+int ChunkDemuxerStream::GetMemoryUsage() const {
+  base::AutoLock auto_lock(lock_);
+  return stream_->GetMemoryUsage();
+}
+
 void ChunkDemuxerStream::OnNewMediaSegment(TimeDelta start_timestamp) {
   DVLOG(2) << "ChunkDemuxerStream::OnNewMediaSegment("
            << start_timestamp.InSecondsF() << ")";
@@ -1407,6 +1436,16 @@ Ranges<TimeDelta> ChunkDemuxer::GetBufferedRanges(const std::string& id) const {
   return itr->second->GetBufferedRanges(duration_, state_ == ENDED);
 }
 
+int ChunkDemuxer::GetMemoryUsage(const std::string& id) const {
+  base::AutoLock auto_lock(lock_);
+  DCHECK(!id.empty());
+
+  SourceStateMap::const_iterator itr = source_state_map_.find(id);
+
+  DCHECK(itr != source_state_map_.end());
+  return itr->second->GetMemoryUsage();
+}
+
 void ChunkDemuxer::AppendData(const std::string& id,
                               const uint8* data,
                               size_t length) {
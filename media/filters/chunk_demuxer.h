@@ -98,6 +98,11 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
   // Gets the currently buffered ranges for the specified ID.
   Ranges<base::TimeDelta> GetBufferedRanges(const std::string& id) const;
 
+  // Returns the number of bytes of media data buffered for the specified ID.
+  // Played data stays buffered until it is removed, or until the memory limit
+  // is reached and it is garbage collected.
+  int GetMemoryUsage(const std::string& id) const;
+
   // Appends media data to the source buffer associated with |id|.
   void AppendData(const std::string& id, const uint8* data, size_t length);
 
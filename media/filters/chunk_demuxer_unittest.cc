@@ -2883,6 +2883,21 @@ TEST_F(ChunkDemuxerTest, CanceledSeekDuringInitialPreroll) {
   AppendCluster(seek_time.InMilliseconds(), 10);
 }
 
+TEST_F(ChunkDemuxerTest, GetMemoryUsage) {
+  ASSERT_TRUE(InitDemuxer(HAS_AUDIO));
+  EXPECT_EQ(0, demuxer_->GetMemoryUsage(kSourceId));
+
+  AppendSingleStreamCluster(kSourceId, kAudioTrackNum, 0, 5);
+  EXPECT_EQ(5 * kBlockSize, demuxer_->GetMemoryUsage(kSourceId));
+
+  CheckExpectedRanges(kSourceId, "{ [0,115) }");
+
+  demuxer_->Remove(kSourceId, base::TimeDelta(),
+                   base::TimeDelta::FromMilliseconds(115));
+  CheckExpectedRanges(kSourceId, "{ }");
+  EXPECT_EQ(0, demuxer_->GetMemoryUsage(kSourceId));
+}
+
 TEST_F(ChunkDemuxerTest, GCDuringSeek) {
   ASSERT_TRUE(InitDemuxer(HAS_AUDIO));
 
@@ -360,6 +360,11 @@ base::TimeDelta FFmpegDemuxerStream::ConvertStreamTimestamp(
 //
 // FFmpegDemuxer
 //
+
+// Size of the window BlockingUrlProtocol reads ahead of FFmpeg, so that the
+// demuxer parses one window while the data source fetches the next.
+static const int kPrefetchSize = 64 * 1024;
+
 FFmpegDemuxer::FFmpegDemuxer(
     const scoped_refptr<base::SingleThreadTaskRunner>& task_runner,
     DataSource* data_source,
@@ -445,6 +450,7 @@ void FFmpegDemuxer::Initialize(DemuxerHost* host,
 
   url_protocol_.reset(new BlockingUrlProtocol(data_source_, BindToCurrentLoop(
       base::Bind(&FFmpegDemuxer::OnDataSourceError, base::Unretained(this)))));
+  url_protocol_->set_prefetch_size(kPrefetchSize);
   glue_.reset(new FFmpegGlue(url_protocol_.get()));
   AVFormatContext* format_context = glue_->format_context();
 
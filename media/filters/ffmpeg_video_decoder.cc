@@ -13,9 +13,11 @@
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
+#include "media/base/media_log.h"
 #include "media/base/media_switches.h"
 #include "media/base/pipeline.h"
 #include "media/base/video_decoder_config.h"
@@ -38,16 +40,36 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetThreadCount(AVCodecID codec_id) {
+// Frames at least this large get more decode threads than kDecodeThreads,
+// up to the number of cores.
+static const int kFourThreadArea = 1280 * 720;
+static const int kEightThreadArea = 1920 * 1080;
+
+// The average decode time is reported to the MediaLog once per this many
+// decoded frames.
+static const int kDecodeTimeReportInterval = 30;
+
+// Returns the number of threads to decode |config| with. The more pixels a
+// frame has, the more threads it can keep busy, but there's no point in
+// having more threads than cores. Also inspects the command line for a valid
+// --video-threads flag.
+static int GetThreadCount(const VideoDecoderConfig& config) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
 
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
-  if (threads.empty() || !base::StringToInt(threads, &decode_threads))
-    return decode_threads;
+  if (threads.empty() || !base::StringToInt(threads, &decode_threads)) {
+    int area = config.coded_size().GetArea();
+    int wanted_threads = kDecodeThreads;
+    if (area >= kEightThreadArea)
+      wanted_threads = 8;
+    else if (area >= kFourThreadArea)
+      wanted_threads = 4;
+    return std::max(kDecodeThreads,
+                    std::min(wanted_threads,
+                             base::SysInfo::NumberOfProcessors()));
+  }
 
   decode_threads = std::max(decode_threads, 0);
   decode_threads = std::min(decode_threads, kMaxDecodeThreads);
@@ -55,10 +77,14 @@ static int GetThreadCount(AVCodecID codec_id) {
 }
 
 FFmpegVideoDecoder::FFmpegVideoDecoder(
-    const scoped_refptr<base::SingleThreadTaskRunner>& task_runner)
+    const scoped_refptr<base::SingleThreadTaskRunner>& task_runner,
+    const scoped_refptr<MediaLog>& media_log)
     : task_runner_(task_runner),
+      media_log_(media_log),
       weak_factory_(this),
-      state_(kUninitialized) {
+      state_(kUninitialized),
+      low_delay_(false),
+      frames_since_report_(0) {
 }
 
 int FFmpegVideoDecoder::GetVideoBuffer(AVCodecContext* codec_context,
@@ -309,10 +335,14 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   }
 
   int frame_decoded = 0;
+  base::TimeTicks decode_start = base::TimeTicks::HighResNow();
   int result = avcodec_decode_video2(codec_context_.get(),
                                      av_frame_.get(),
                                      &frame_decoded,
                                      &packet);
+  // With frame threading, a call may return a frame decoded during earlier
+  // calls, so the time is averaged over all the calls.
+  decode_time_since_report_ += base::TimeTicks::HighResNow() - decode_start;
   // Log the problem if we can't decode a video frame and exit early.
   if (result < 0) {
     LOG(ERROR) << "Error decoding video: " << buffer->AsHumanReadableString();
@@ -349,9 +379,20 @@ bool FFmpegVideoDecoder::FFmpegDecode(
   (*video_frame)->SetTimestamp(
       base::TimeDelta::FromMicroseconds(av_frame_->reordered_opaque));
 
+  if (++frames_since_report_ == kDecodeTimeReportInterval)
+    ReportDecodeTime();
+
   return true;
 }
 
+void FFmpegVideoDecoder::ReportDecodeTime() {
+  media_log_->SetDoubleProperty(
+      "video_decode_time_ms",
+      decode_time_since_report_.InMillisecondsF() / frames_since_report_);
+  frames_since_report_ = 0;
+  decode_time_since_report_ = base::TimeDelta();
+}
+
 void FFmpegVideoDecoder::ReleaseFFmpegResources() {
   codec_context_.reset();
   av_frame_.reset();
@@ -368,7 +409,16 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   // Enable motion vector search (potentially slow), strong deblocking filter
   // for damaged macroblocks, and set our error detection sensitivity.
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_count = GetThreadCount(config_);
+  // Frame threading delays the output by one frame per thread, which
+  // buffered playback absorbs but realtime playback can't afford. Slice
+  // threading adds no delay, where the codec and stream support it.
+  if (low_delay_) {
+    codec_context_->thread_type = FF_THREAD_SLICE;
+    codec_context_->flags |= CODEC_FLAG_LOW_DELAY;
+  } else {
+    codec_context_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+  }
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
   codec_context_->get_buffer = GetVideoBufferImpl;
@@ -381,6 +431,13 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   }
 
   av_frame_.reset(av_frame_alloc());
+
+  media_log_->SetStringProperty("video_decoder", "ffmpeg");
+  media_log_->SetIntegerProperty("video_decode_threads",
+                                 codec_context_->thread_count);
+  media_log_->SetBooleanProperty("video_decode_low_delay", low_delay_);
+  frames_since_report_ = 0;
+  decode_time_since_report_ = base::TimeDelta();
   return true;
 }
 
@@ -10,6 +10,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "media/base/video_decoder.h"
 #include "media/base/video_decoder_config.h"
 #include "media/base/video_frame_pool.h"
@@ -24,15 +25,22 @@ class SingleThreadTaskRunner;
 namespace media {
 
 class DecoderBuffer;
+class MediaLog;
 class ScopedPtrAVFreeContext;
 class ScopedPtrAVFreeFrame;
 
 class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
  public:
-  explicit FFmpegVideoDecoder(
-      const scoped_refptr<base::SingleThreadTaskRunner>& task_runner);
+  FFmpegVideoDecoder(
+      const scoped_refptr<base::SingleThreadTaskRunner>& task_runner,
+      const scoped_refptr<MediaLog>& media_log);
   virtual ~FFmpegVideoDecoder();
 
+  // Realtime sources should set this before Initialize(), so that frames are
+  // not held back by frame threading. Buffered playback tolerates the delay
+  // and decodes faster without it.
+  void set_low_delay(bool low_delay) { low_delay_ = low_delay; }
+
   // VideoDecoder implementation.
   virtual void Initialize(const VideoDecoderConfig& config,
                           const PipelineStatusCB& status_cb) OVERRIDE;
@@ -71,7 +79,11 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // Reset decoder and call |reset_cb_|.
   void DoReset();
 
+  // Logs the average time spent decoding the frames since the last report.
+  void ReportDecodeTime();
+
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+  scoped_refptr<MediaLog> media_log_;
   base::WeakPtrFactory<FFmpegVideoDecoder> weak_factory_;
   base::WeakPtr<FFmpegVideoDecoder> weak_this_;
 
@@ -88,6 +100,12 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
 
   VideoFramePool frame_pool_;
 
+  bool low_delay_;
+
+  // Decode time accumulated for the MediaLog.
+  int frames_since_report_;
+  base::TimeDelta decode_time_since_report_;
+
   DISALLOW_COPY_AND_ASSIGN(FFmpegVideoDecoder);
 };
 
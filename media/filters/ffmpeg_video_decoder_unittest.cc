@@ -13,6 +13,7 @@
 #include "media/base/decoder_buffer.h"
 #include "media/base/gmock_callback_support.h"
 #include "media/base/limits.h"
+#include "media/base/media_log.h"
 #include "media/base/mock_filters.h"
 #include "media/base/test_data_util.h"
 #include "media/base/test_helpers.h"
@@ -46,7 +47,8 @@ ACTION_P(ReturnBuffer, buffer) {
 class FFmpegVideoDecoderTest : public testing::Test {
  public:
   FFmpegVideoDecoderTest()
-      : decoder_(new FFmpegVideoDecoder(message_loop_.message_loop_proxy())),
+      : decoder_(new FFmpegVideoDecoder(message_loop_.message_loop_proxy(),
+                                        new MediaLog())),
         decode_cb_(base::Bind(&FFmpegVideoDecoderTest::FrameReady,
                               base::Unretained(this))) {
     FFmpegGlue::InitializeFFmpeg();
@@ -364,6 +366,21 @@ TEST_F(FFmpegVideoDecoderTest, DecodeFrame_Normal) {
   EXPECT_FALSE(video_frame->end_of_stream());
 }
 
+TEST_F(FFmpegVideoDecoderTest, DecodeFrame_LowDelay) {
+  decoder_->set_low_delay(true);
+  Initialize();
+
+  // Without frame threading, the frame comes back for the buffer that was
+  // just decoded, without waiting for more input.
+  VideoDecoder::Status status;
+  scoped_refptr<VideoFrame> video_frame;
+  Decode(i_frame_buffer_, &status, &video_frame);
+
+  EXPECT_EQ(VideoDecoder::kOk, status);
+  ASSERT_TRUE(video_frame.get());
+  EXPECT_FALSE(video_frame->end_of_stream());
+}
+
 // Verify current behavior for 0 byte frames. FFmpeg simply ignores
 // the 0 byte frames.
 TEST_F(FFmpegVideoDecoderTest, DecodeFrame_0ByteFrame) {
@@ -768,10 +768,7 @@ void SourceBufferStream::SetConfigIds(const BufferQueue& buffers) {
 }
 
 void SourceBufferStream::GarbageCollectIfNeeded() {
-  // Compute size of |ranges_|.
-  int ranges_size = 0;
-  for (RangeList::iterator itr = ranges_.begin(); itr != ranges_.end(); ++itr)
-    ranges_size += (*itr)->size_in_bytes();
+  int ranges_size = GetMemoryUsage();
 
   // Return if we're under or at the memory limit.
   if (ranges_size <= memory_limit_)
@@ -1279,6 +1276,15 @@ base::TimeDelta SourceBufferStream::GetBufferedDuration() const {
   return ranges_.back()->GetBufferedEndTimestamp();
 }
 
+int SourceBufferStream::GetMemoryUsage() const {
+  int ranges_size = 0;
+  for (RangeList::const_iterator itr = ranges_.begin(); itr != ranges_.end();
+       ++itr) {
+    ranges_size += (*itr)->size_in_bytes();
+  }
+  return ranges_size;
+}
+
 void SourceBufferStream::MarkEndOfStream() {
   DCHECK(!end_of_stream_);
   end_of_stream_ = true;
@@ -113,6 +113,9 @@ class MEDIA_EXPORT SourceBufferStream {
   // then base::TimeDelta() is returned.
   base::TimeDelta GetBufferedDuration() const;
 
+  // Returns the number of bytes of media data buffered in this stream.
+  int GetMemoryUsage() const;
+
   // Notifies this object that end of stream has been signalled.
   void MarkEndOfStream();
 
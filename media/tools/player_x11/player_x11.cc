@@ -121,7 +121,8 @@ void InitPipeline(
   collection->SetDemuxer(demuxer);
 
   ScopedVector<media::VideoDecoder> video_decoders;
-  video_decoders.push_back(new media::FFmpegVideoDecoder(task_runner));
+  video_decoders.push_back(
+      new media::FFmpegVideoDecoder(task_runner, new media::MediaLog()));
   scoped_ptr<media::VideoRenderer> video_renderer(new media::VideoRendererImpl(
       task_runner,
       video_decoders.Pass(),
@@ -24,6 +24,13 @@ class WaiterList;
 // Its subclasses implement the three cases: local producer and consumer, local
 // producer and remote consumer, and remote producer and local consumer. This
 // class is thread-safe.
+//
+// Only the local case exists so far: handles can't be sent to another process
+// yet (see |Channel::OnReadMessageForDownstream()|). Once they can, the remote
+// cases should keep the circular buffer in shared memory mapped by both
+// processes, with only the read and write positions going over the channel,
+// so that two-phase reads and writes hand out pointers into the shared buffer
+// rather than copying each chunk into a |MessageInTransit|.
 class MOJO_SYSTEM_IMPL_EXPORT DataPipe :
     public base::RefCountedThreadSafe<DataPipe> {
  public:
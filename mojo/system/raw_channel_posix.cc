@@ -6,6 +6,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -32,6 +33,10 @@ namespace {
 
 const size_t kReadSize = 4096;
 
+// Maximum number of queued messages handed to a single |writev()|. This is well
+// below |IOV_MAX|, which is at least 1024 on the platforms we care about.
+const size_t kMaxMessagesPerWrite = 64;
+
 class RawChannelPosix : public RawChannel,
                         public base::MessageLoopForIO::Watcher {
  public:
@@ -57,11 +62,13 @@ class RawChannelPosix : public RawChannel,
   // thread WITHOUT |write_lock_| held.
   void CallOnFatalError(Delegate::FatalError fatal_error);
 
-  // Writes the message at the front of |write_message_queue_|, starting at
-  // |write_message_offset_|. It removes and destroys if the write completes and
-  // otherwise updates |write_message_offset_|. Returns true on success. Must be
-  // called under |write_lock_|.
-  bool WriteFrontMessageNoLock();
+  // Writes as many messages from the front of |write_message_queue_| as
+  // possible (up to |kMaxMessagesPerWrite|) in a single |writev()|, starting at
+  // |write_message_offset_| in the front message. It removes and destroys the
+  // messages whose writes complete and updates |write_message_offset_| for a
+  // partially-written one. Returns true on success. Must be called under
+  // |write_lock_|.
+  bool WriteQueuedMessagesNoLock();
 
   // Cancels all pending writes and destroys the contents of
   // |write_message_queue_|. Should only be called if |write_stopped_| is false;
@@ -176,7 +183,7 @@ bool RawChannelPosix::WriteMessage(MessageInTransit* message) {
 
   write_message_queue_.push_front(message);
   DCHECK_EQ(write_message_offset_, 0u);
-  bool result = WriteFrontMessageNoLock();
+  bool result = WriteQueuedMessagesNoLock();
   DCHECK(result || write_message_queue_.empty());
 
   if (!result) {
@@ -321,7 +328,7 @@ void RawChannelPosix::OnFileCanWriteWithoutBlocking(int fd) {
       return;
     }
 
-    bool result = WriteFrontMessageNoLock();
+    bool result = WriteQueuedMessagesNoLock();
     DCHECK(result || write_message_queue_.empty());
 
     if (!result) {
@@ -351,23 +358,33 @@ void RawChannelPosix::CallOnFatalError(Delegate::FatalError fatal_error) {
   delegate()->OnFatalError(fatal_error);
 }
 
-bool RawChannelPosix::WriteFrontMessageNoLock() {
+bool RawChannelPosix::WriteQueuedMessagesNoLock() {
   write_lock_.AssertAcquired();
 
   DCHECK(!write_stopped_);
   DCHECK(!write_message_queue_.empty());
 
-  MessageInTransit* message = write_message_queue_.front();
-  DCHECK_LT(write_message_offset_, message->main_buffer_size());
-  size_t bytes_to_write = message->main_buffer_size() - write_message_offset_;
+  // Gather the front of the queue, so that a burst of small messages costs a
+  // single system call.
+  size_t num_messages =
+      std::min(write_message_queue_.size(), kMaxMessagesPerWrite);
+  struct iovec iov[kMaxMessagesPerWrite];
+  size_t bytes_to_write = 0;
+  for (size_t i = 0; i < num_messages; i++) {
+    MessageInTransit* message = write_message_queue_[i];
+    size_t offset = (i == 0) ? write_message_offset_ : 0;
+    DCHECK_LT(offset, message->main_buffer_size());
+    iov[i].iov_base =
+        static_cast<char*>(const_cast<void*>(message->main_buffer())) + offset;
+    iov[i].iov_len = message->main_buffer_size() - offset;
+    bytes_to_write += iov[i].iov_len;
+  }
+
   ssize_t bytes_written = HANDLE_EINTR(
-      write(fd_.get().fd,
-            static_cast<const char*>(message->main_buffer()) +
-                write_message_offset_,
-            bytes_to_write));
+      writev(fd_.get().fd, iov, static_cast<int>(num_messages)));
   if (bytes_written < 0) {
     if (errno != EAGAIN && errno != EWOULDBLOCK) {
-      PLOG(ERROR) << "write of size " << bytes_to_write;
+      PLOG(ERROR) << "writev of size " << bytes_to_write;
       CancelPendingWritesNoLock();
       return false;
     }
@@ -378,12 +395,20 @@ bool RawChannelPosix::WriteFrontMessageNoLock() {
   }
 
   DCHECK_GE(bytes_written, 0);
-  if (static_cast<size_t>(bytes_written) < bytes_to_write) {
-    // Partial (or no) write.
-    write_message_offset_ += static_cast<size_t>(bytes_written);
-  } else {
+  DCHECK_LE(static_cast<size_t>(bytes_written), bytes_to_write);
+  // Destroy the messages that were completely written, and remember how far
+  // we got into the first one that wasn't.
+  size_t bytes_remaining = static_cast<size_t>(bytes_written);
+  for (size_t i = 0; i < num_messages && bytes_remaining > 0; i++) {
+    if (bytes_remaining < iov[i].iov_len) {
+      // Partial write.
+      write_message_offset_ += bytes_remaining;
+      break;
+    }
+
     // Complete write.
-    DCHECK_EQ(static_cast<size_t>(bytes_written), bytes_to_write);
+    bytes_remaining -= iov[i].iov_len;
+    MessageInTransit* message = write_message_queue_.front();
     write_message_queue_.pop_front();
     write_message_offset_ = 0;
     message->Destroy();
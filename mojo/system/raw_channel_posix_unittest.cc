@@ -224,6 +224,34 @@ TEST_F(RawChannelPosixTest, WriteMessage) {
                                    base::Unretained(rc.get())));
 }
 
+// Tests queueing many small messages, which get written in batches (and
+// verifies reading using our own custom reader).
+TEST_F(RawChannelPosixTest, WriteManySmallMessages) {
+  WriteOnlyRawChannelDelegate delegate;
+  scoped_ptr<RawChannel> rc(RawChannel::Create(handles[0].Pass(),
+                                               &delegate,
+                                               io_thread_message_loop()));
+
+  TestMessageReaderAndChecker checker(handles[1].get());
+
+  test::PostTaskAndWait(io_thread_task_runner(),
+                        FROM_HERE,
+                        base::Bind(&InitOnIOThread, rc.get()));
+
+  // Queue enough to fill the socket buffer, so that later writes are batched
+  // and some of them are partial.
+  const uint32_t kNumMessages = 10000;
+  for (uint32_t i = 0; i < kNumMessages; i++)
+    EXPECT_TRUE(rc->WriteMessage(MakeTestMessage(i % 100 + 1)));
+  for (uint32_t i = 0; i < kNumMessages; i++)
+    EXPECT_TRUE(checker.ReadAndCheckNextMessage(i % 100 + 1)) << i;
+
+  test::PostTaskAndWait(io_thread_task_runner(),
+                        FROM_HERE,
+                        base::Bind(&RawChannel::Shutdown,
+                                   base::Unretained(rc.get())));
+}
+
 // RawChannelPosixTest.OnReadMessage -------------------------------------------
 
 class ReadCheckerRawChannelDelegate : public RawChannel::Delegate {
@@ -0,0 +1,107 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/bounded_net_log_observer.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/values.h"
+
+namespace net {
+
+namespace {
+
+// Returns a copy of |params|, to replay stored parameters through
+// NetLog::Entry::ToValue().
+base::Value* CopyParametersCallback(const base::Value* params,
+                                    NetLog::LogLevel /* log_level */) {
+  return params->DeepCopy();
+}
+
+}  // namespace
+
+struct BoundedNetLogObserver::StoredEntry {
+  StoredEntry(const NetLog::Entry& entry, base::TimeTicks time)
+      : type(entry.type()),
+        source(entry.source()),
+        phase(entry.phase()),
+        time(time),
+        params(entry.ParametersToValue()) {
+  }
+
+  NetLog::EventType type;
+  NetLog::Source source;
+  NetLog::EventPhase phase;
+  base::TimeTicks time;
+  scoped_ptr<base::Value> params;
+};
+
+BoundedNetLogObserver::BoundedNetLogObserver(size_t max_entries)
+    : max_entries_(max_entries),
+      num_dropped_(0) {
+  DCHECK_GT(max_entries_, 0u);
+}
+
+BoundedNetLogObserver::~BoundedNetLogObserver() {
+  STLDeleteElements(&entries_);
+}
+
+void BoundedNetLogObserver::StartObserving(NetLog* net_log,
+                                           NetLog::LogLevel log_level) {
+  net_log->AddThreadSafeObserver(this, log_level);
+}
+
+void BoundedNetLogObserver::StopObserving() {
+  net_log()->RemoveThreadSafeObserver(this);
+}
+
+base::ListValue* BoundedNetLogObserver::GetEntriesAsValue() const {
+  base::ListValue* list = new base::ListValue();
+  base::AutoLock lock(lock_);
+  for (std::deque<StoredEntry*>::const_iterator it = entries_.begin();
+       it != entries_.end(); ++it) {
+    const StoredEntry* stored = *it;
+    NetLog::ParametersCallback callback;
+    if (stored->params)
+      callback = base::Bind(&CopyParametersCallback, stored->params.get());
+    NetLog::Entry entry(stored->type, stored->source, stored->phase,
+                        stored->time,
+                        stored->params ? &callback : NULL,
+                        NetLog::LOG_ALL);
+    list->Append(entry.ToValue());
+  }
+  return list;
+}
+
+size_t BoundedNetLogObserver::GetSize() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+size_t BoundedNetLogObserver::num_dropped() const {
+  base::AutoLock lock(lock_);
+  return num_dropped_;
+}
+
+void BoundedNetLogObserver::Clear() {
+  base::AutoLock lock(lock_);
+  STLDeleteElements(&entries_);
+  num_dropped_ = 0;
+}
+
+void BoundedNetLogObserver::OnAddEntry(const NetLog::Entry& entry) {
+  // Build the parameters before taking the lock, as they may be expensive.
+  StoredEntry* stored = new StoredEntry(entry, base::TimeTicks::Now());
+
+  base::AutoLock lock(lock_);
+  if (entries_.size() == max_entries_) {
+    delete entries_.front();
+    entries_.pop_front();
+    ++num_dropped_;
+  }
+  entries_.push_back(stored);
+}
+
+}  // namespace net
@@ -0,0 +1,80 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_BOUNDED_NET_LOG_OBSERVER_H_
+#define NET_BASE_BOUNDED_NET_LOG_OBSERVER_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/base/net_log.h"
+
+namespace base {
+class ListValue;
+class Value;
+}
+
+namespace net {
+
+// BoundedNetLogObserver keeps the most recent NetLog entries in memory, up to
+// a fixed number, so that capturing can be left on cheaply and the log only
+// dumped when needed.
+//
+// Event parameters are still built when each entry is added, since the
+// parameter callbacks may refer to objects that don't outlive the call, but
+// entries are only converted to the NetLog JSON format, and serialized, when
+// dumped.
+class NET_EXPORT BoundedNetLogObserver : public NetLog::ThreadSafeObserver {
+ public:
+  // |max_entries| is the number of entries kept. Older entries are dropped
+  // first.
+  explicit BoundedNetLogObserver(size_t max_entries);
+  virtual ~BoundedNetLogObserver();
+
+  // Starts observing |net_log| with |log_level|.  Must not already be
+  // watching a NetLog.
+  void StartObserving(NetLog* net_log, NetLog::LogLevel log_level);
+
+  // Stops observing net_log().  Must already be watching.
+  void StopObserving();
+
+  // Returns the entries kept, oldest first, each in the format of
+  // NetLog::Entry::ToValue().  Caller takes ownership.
+  base::ListValue* GetEntriesAsValue() const;
+
+  // Returns the number of entries kept.
+  size_t GetSize() const;
+
+  // Returns the number of entries dropped because the buffer was full.
+  size_t num_dropped() const;
+
+  void Clear();
+
+  // NetLog::ThreadSafeObserver implementation:
+  virtual void OnAddEntry(const NetLog::Entry& entry) OVERRIDE;
+
+ private:
+  struct StoredEntry;
+
+  const size_t max_entries_;
+
+  // Protects all members below, since entries may be added on any thread.
+  mutable base::Lock lock_;
+
+  // Owned.
+  std::deque<StoredEntry*> entries_;
+
+  size_t num_dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundedNetLogObserver);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_BOUNDED_NET_LOG_OBSERVER_H_
@@ -0,0 +1,86 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/bounded_net_log_observer.h"
+
+#include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+void AddEntry(BoundedNetLogObserver* observer, uint32 source_id) {
+  NetLog::ParametersCallback callback =
+      NetLog::IntegerCallback("source_id", source_id);
+  NetLog::Entry entry(NetLog::TYPE_PROXY_SERVICE,
+                      NetLog::Source(NetLog::SOURCE_SPDY_SESSION, source_id),
+                      NetLog::PHASE_BEGIN,
+                      base::TimeTicks::Now(),
+                      &callback,
+                      NetLog::LOG_BASIC);
+  observer->OnAddEntry(entry);
+}
+
+TEST(BoundedNetLogObserverTest, KeepsMostRecentEntries) {
+  BoundedNetLogObserver observer(2);
+  AddEntry(&observer, 1);
+  AddEntry(&observer, 2);
+  AddEntry(&observer, 3);
+  EXPECT_EQ(2u, observer.GetSize());
+  EXPECT_EQ(1u, observer.num_dropped());
+
+  scoped_ptr<base::ListValue> entries(observer.GetEntriesAsValue());
+  ASSERT_EQ(2u, entries->GetSize());
+  for (size_t i = 0; i < entries->GetSize(); ++i) {
+    base::DictionaryValue* entry = NULL;
+    ASSERT_TRUE(entries->GetDictionary(i, &entry));
+    int id = 0;
+    EXPECT_TRUE(entry->GetInteger("source.id", &id));
+    EXPECT_EQ(static_cast<int>(i + 2), id);
+    int param = 0;
+    EXPECT_TRUE(entry->GetInteger("params.source_id", &param));
+    EXPECT_EQ(id, param);
+  }
+
+  observer.Clear();
+  EXPECT_EQ(0u, observer.GetSize());
+  EXPECT_EQ(0u, observer.num_dropped());
+}
+
+TEST(BoundedNetLogObserverTest, EntriesWithoutParameters) {
+  BoundedNetLogObserver observer(1);
+  NetLog::Entry entry(NetLog::TYPE_PROXY_SERVICE,
+                      NetLog::Source(NetLog::SOURCE_SPDY_SESSION, 1),
+                      NetLog::PHASE_END,
+                      base::TimeTicks::Now(),
+                      NULL,
+                      NetLog::LOG_BASIC);
+  observer.OnAddEntry(entry);
+
+  scoped_ptr<base::ListValue> entries(observer.GetEntriesAsValue());
+  ASSERT_EQ(1u, entries->GetSize());
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(entries->GetDictionary(0, &dict));
+  EXPECT_FALSE(dict->HasKey("params"));
+}
+
+TEST(BoundedNetLogObserverTest, ObservesNetLog) {
+  NetLog net_log;
+  BoundedNetLogObserver observer(10);
+  observer.StartObserving(&net_log, NetLog::LOG_ALL_BUT_BYTES);
+  BoundNetLog bound_net_log =
+      BoundNetLog::Make(&net_log, NetLog::SOURCE_URL_REQUEST);
+  bound_net_log.BeginEvent(NetLog::TYPE_REQUEST_ALIVE);
+  bound_net_log.EndEvent(NetLog::TYPE_REQUEST_ALIVE);
+  observer.StopObserving();
+
+  EXPECT_EQ(2u, observer.GetSize());
+}
+
+}  // namespace
+
+}  // namespace net
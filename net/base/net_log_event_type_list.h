@@ -451,6 +451,16 @@ EVENT_TYPE(SOCKS_UNKNOWN_ADDRESS_TYPE)
 // The start/end of an SSL "connect" (aka client handshake).
 EVENT_TYPE(SSL_CONNECT)
 
+// The SSL session cache was checked for a session to resume.
+// The following parameters are attached to the event:
+//   {
+//     "cache_key": <The session cache key, as host:port/shard>,
+//     "hit": <Whether a session to resume was found>,
+//     "lookups": <Number of lookups made so far for this key>,
+//     "hits": <Number of those lookups which found a session>,
+//   }
+EVENT_TYPE(SSL_SESSION_CACHE_LOOKUP)
+
 // The start/end of an SSL server handshake (aka "accept").
 EVENT_TYPE(SSL_SERVER_HANDSHAKE)
 
@@ -817,6 +827,14 @@ EVENT_TYPE(HTTP_CACHE_WRITE_INFO)
 EVENT_TYPE(HTTP_CACHE_READ_DATA)
 EVENT_TYPE(HTTP_CACHE_WRITE_DATA)
 
+// Emitted when a stale response is served while it is revalidated in the
+// background.
+EVENT_TYPE(HTTP_CACHE_ASYNC_VALIDATION)
+
+// Emitted when a background revalidation is not started, because too many
+// of them are in progress.
+EVENT_TYPE(HTTP_CACHE_ASYNC_VALIDATION_DROPPED)
+
 // ------------------------------------------------------------------------
 // Disk Cache / Memory Cache
 // ------------------------------------------------------------------------
@@ -73,11 +73,16 @@ namespace net {
 namespace {
 
 // The default value of max_cache_entries_.
-const unsigned kMaxCacheEntries = 256;
+const unsigned kMaxCacheEntries = 1024;
 
 // The number of seconds for which we'll cache a cache entry.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// Returns the sequence number of |crl_set|, or zero if there is none.
+uint32 GetCRLSetSequence(const CRLSet* crl_set) {
+  return crl_set ? crl_set->sequence() : 0;
+}
+
 }  // namespace
 
 MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
@@ -257,6 +262,7 @@ class CertVerifierWorker {
         cert_verifier_->HandleResult(cert_.get(),
                                      hostname_,
                                      flags_,
+                                     crl_set_.get(),
                                      additional_trust_anchors_,
                                      error_,
                                      verify_result_);
@@ -433,7 +439,8 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
           trust_anchor_provider_->GetAdditionalTrustAnchors() : empty_cert_list;
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
-                          hostname, flags, additional_trust_anchors);
+                          hostname, flags, GetCRLSetSequence(crl_set),
+                          additional_trust_anchors);
   const CertVerifierCache::value_type* cached_entry =
       cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
   if (cached_entry) {
@@ -494,9 +501,11 @@ MultiThreadedCertVerifier::RequestParams::RequestParams(
     const SHA1HashValue& ca_fingerprint_arg,
     const std::string& hostname_arg,
     int flags_arg,
+    uint32 crl_set_sequence_arg,
     const CertificateList& additional_trust_anchors)
     : hostname(hostname_arg),
-      flags(flags_arg) {
+      flags(flags_arg),
+      crl_set_sequence(crl_set_sequence_arg) {
   hash_values.reserve(2 + additional_trust_anchors.size());
   hash_values.push_back(cert_fingerprint_arg);
   hash_values.push_back(ca_fingerprint_arg);
@@ -513,6 +522,8 @@ bool MultiThreadedCertVerifier::RequestParams::operator<(
   // memory and string comparisons.
   if (flags != other.flags)
     return flags < other.flags;
+  if (crl_set_sequence != other.crl_set_sequence)
+    return crl_set_sequence < other.crl_set_sequence;
   if (hostname != other.hostname)
     return hostname < other.hostname;
   return std::lexicographical_compare(
@@ -527,13 +538,15 @@ void MultiThreadedCertVerifier::HandleResult(
     X509Certificate* cert,
     const std::string& hostname,
     int flags,
+    CRLSet* crl_set,
     const CertificateList& additional_trust_anchors,
     int error,
     const CertVerifyResult& verify_result) {
   DCHECK(CalledOnValidThread());
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
-                          hostname, flags, additional_trust_anchors);
+                          hostname, flags, GetCRLSetSequence(crl_set),
+                          additional_trust_anchors);
 
   CachedResult cached_result;
   cached_result.error = error;
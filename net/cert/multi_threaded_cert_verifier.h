@@ -85,6 +85,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
                   const SHA1HashValue& ca_fingerprint_arg,
                   const std::string& hostname_arg,
                   int flags_arg,
+                  uint32 crl_set_sequence_arg,
                   const CertificateList& additional_trust_anchors);
     ~RequestParams();
 
@@ -92,6 +93,9 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
 
     std::string hostname;
     int flags;
+    // The sequence number of the CRLSet used, or zero if there was none, so
+    // that results are not reused once a newer CRLSet is available.
+    uint32 crl_set_sequence;
     std::vector<SHA1HashValue> hash_values;
   };
 
@@ -132,6 +136,7 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
+                    CRLSet* crl_set,
                     const CertificateList& additional_trust_anchors,
                     int error,
                     const CertVerifyResult& verify_result);
@@ -126,6 +126,11 @@ typedef std::vector<CanonicalCookie*> CanonicalCookieVector;
 // will update it again.
 const int kDefaultAccessUpdateThresholdSeconds = 60;
 
+// Number of CookieMap keys whose lookups the lookup cache remembers, and how
+// many lookups it remembers for each.
+const size_t kLookupCacheSize = 50;
+const size_t kMaxLookupsPerKey = 20;
+
 // Comparator to sort cookies from highest creation date to lowest
 // creation date.
 struct OrderByCreationTimeDesc {
@@ -306,6 +311,17 @@ std::string BuildCookieLine(const CanonicalCookieVector& cookies) {
   return cookie_line;
 }
 
+// Returns the key under which the lookup cache remembers the cookies for
+// |url| and |options|.  It holds everything that
+// CanonicalCookie::IncludeForRequestURL() looks at.
+std::string GetLookupCacheKey(const GURL& url, const CookieOptions& options) {
+  std::string lookup_key(options.exclude_httponly() ? "h" : "-");
+  lookup_key += url.SchemeIsSecure() ? "s" : "-";
+  lookup_key += url.host();
+  lookup_key += url.path();
+  return lookup_key;
+}
+
 }  // namespace
 
 CookieMonster::CookieMonster(PersistentCookieStore* store,
@@ -317,6 +333,7 @@ CookieMonster::CookieMonster(PersistentCookieStore* store,
           TimeDelta::FromSeconds(kDefaultAccessUpdateThresholdSeconds)),
       delegate_(delegate),
       last_statistic_record_time_(Time::Now()),
+      lookup_cache_(kLookupCacheSize),
       keep_expired_cookies_(false),
       persist_session_cookies_(false) {
   InitializeHistograms();
@@ -333,12 +350,17 @@ CookieMonster::CookieMonster(PersistentCookieStore* store,
           last_access_threshold_milliseconds)),
       delegate_(delegate),
       last_statistic_record_time_(base::Time::Now()),
+      lookup_cache_(kLookupCacheSize),
       keep_expired_cookies_(false),
       persist_session_cookies_(false) {
   InitializeHistograms();
   SetDefaultCookieableSchemes();
 }
 
+CookieMonster::CachedLookup::CachedLookup() {}
+
+CookieMonster::CachedLookup::~CachedLookup() {}
+
 
 // Task classes for queueing the coming request.
 
@@ -1317,8 +1339,15 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
   TimeTicks start_time(TimeTicks::Now());
 
   std::vector<CanonicalCookie*> cookies;
-  FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
+  const Time current_time(CurrentTime());
+  const std::string key(GetKey(url.host()));
+  if (!FindCookiesInLookupCache(key, url, options, current_time, &cookies)) {
+    // As FindCookiesForHostAndDomain().
+    RecordPeriodicStats(current_time);
+    FindCookiesForKey(key, url, options, current_time, true, &cookies);
+    std::sort(cookies.begin(), cookies.end(), CookieSorter);
+    AddToLookupCache(key, url, options, cookies);
+  }
 
   std::string cookie_line = BuildCookieLine(cookies);
 
@@ -1726,6 +1755,73 @@ void CookieMonster::FindCookiesForKey(const std::string& key,
   }
 }
 
+bool CookieMonster::FindCookiesInLookupCache(
+    const std::string& key,
+    const GURL& url,
+    const CookieOptions& options,
+    const Time& current,
+    std::vector<CanonicalCookie*>* cookies) {
+  lock_.AssertAcquired();
+
+  LookupCache::iterator key_it = lookup_cache_.Get(key);
+  if (key_it == lookup_cache_.end())
+    return false;
+  CachedLookupMap* lookups = &key_it->second;
+  CachedLookupMap::iterator it = lookups->find(GetLookupCacheKey(url, options));
+  if (it == lookups->end())
+    return false;
+  const CachedLookup& lookup = it->second;
+  if (!keep_expired_cookies_ && !lookup.expiry.is_null() &&
+      current >= lookup.expiry) {
+    // Let FindCookiesForKey() delete the expired cookies.
+    lookups->erase(it);
+    return false;
+  }
+
+  RecordPeriodicStats(current);
+  for (std::vector<CanonicalCookie*>::const_iterator cookie_it =
+           lookup.cookies.begin();
+       cookie_it != lookup.cookies.end(); ++cookie_it) {
+    InternalUpdateCookieAccessTime(*cookie_it, current);
+  }
+  *cookies = lookup.cookies;
+  return true;
+}
+
+void CookieMonster::AddToLookupCache(
+    const std::string& key,
+    const GURL& url,
+    const CookieOptions& options,
+    const std::vector<CanonicalCookie*>& cookies) {
+  lock_.AssertAcquired();
+
+  LookupCache::iterator key_it = lookup_cache_.Get(key);
+  if (key_it == lookup_cache_.end())
+    key_it = lookup_cache_.Put(key, CachedLookupMap());
+  CachedLookupMap* lookups = &key_it->second;
+  if (lookups->size() >= kMaxLookupsPerKey)
+    lookups->clear();
+
+  CachedLookup& lookup = (*lookups)[GetLookupCacheKey(url, options)];
+  lookup.cookies = cookies;
+  lookup.expiry = Time();
+  for (std::vector<CanonicalCookie*>::const_iterator it = cookies.begin();
+       it != cookies.end(); ++it) {
+    if (!(*it)->IsPersistent())
+      continue;
+    if (lookup.expiry.is_null() || (*it)->ExpiryDate() < lookup.expiry)
+      lookup.expiry = (*it)->ExpiryDate();
+  }
+}
+
+void CookieMonster::InvalidateLookupCache(const std::string& key) {
+  lock_.AssertAcquired();
+
+  LookupCache::iterator it = lookup_cache_.Peek(key);
+  if (it != lookup_cache_.end())
+    lookup_cache_.Erase(it);
+}
+
 bool CookieMonster::DeleteAnyEquivalentCookie(const std::string& key,
                                               const CanonicalCookie& ecc,
                                               bool skip_httponly,
@@ -1768,6 +1864,7 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
     store_->AddCookie(*cc);
   CookieMap::iterator inserted =
       cookies_.insert(CookieMap::value_type(key, cc));
+  InvalidateLookupCache(key);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonsterDelegate::CHANGE_COOKIE_EXPLICIT);
@@ -1888,6 +1985,7 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  InvalidateLookupCache(it->first);
   cookies_.erase(it);
   delete cc;
 }
@@ -17,6 +17,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -510,6 +511,27 @@ class NET_EXPORT CookieMonster : public CookieStore {
                          bool update_access_time,
                          std::vector<CanonicalCookie*>* cookies);
 
+  // Looks up the sorted cookies remembered for |url| and |options| by
+  // AddToLookupCache(), updating their access times.  |key| is the CookieMap
+  // key of |url|.  Returns false if they are not there, or if one of them has
+  // expired since.
+  bool FindCookiesInLookupCache(const std::string& key,
+                                const GURL& url,
+                                const CookieOptions& options,
+                                const base::Time& current,
+                                std::vector<CanonicalCookie*>* cookies);
+
+  // Remembers |cookies|, which must be all the cookies for |url| and
+  // |options| in CookieSorter order.
+  void AddToLookupCache(const std::string& key,
+                        const GURL& url,
+                        const CookieOptions& options,
+                        const std::vector<CanonicalCookie*>& cookies);
+
+  // Forgets every lookup which may include cookies stored under CookieMap key
+  // |key|.  Must be called whenever such a cookie is added or deleted.
+  void InvalidateLookupCache(const std::string& key);
+
   // Delete any cookies that are equivalent to |ecc| (same path, domain, etc).
   // If |skip_httponly| is true, httponly cookies will not be deleted.  The
   // return value with be true if |skip_httponly| skipped an httponly cookie.
@@ -621,6 +643,26 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // A lookup remembered by the lookup cache.
+  struct CachedLookup {
+    CachedLookup();
+    ~CachedLookup();
+
+    // The matching cookies, in CookieSorter order.
+    std::vector<CanonicalCookie*> cookies;
+    // When the first of |cookies| expires, or null if none of them does.
+    base::Time expiry;
+  };
+  // The lookups for the URLs under one CookieMap key, by URL and options.
+  typedef std::map<std::string, CachedLookup> CachedLookupMap;
+  typedef base::MRUCache<std::string, CachedLookupMap> LookupCache;
+
+  // The results of recent GetCookiesWithOptions() calls for the most recently
+  // used CookieMap keys, so that pages sending many requests to the same URLs
+  // skip walking and sorting their cookies.  A change to a key's cookies drops
+  // all of its lookups.
+  LookupCache lookup_cache_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
@@ -276,6 +276,45 @@ TEST_F(CookieMonsterTest, TestDomainLine) {
   timer2.Done();
 }
 
+TEST_F(CookieMonsterTest, TestQueryManyPaths) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  SetCookieCallback setCookieCallback;
+  GetCookiesCallback getCookiesCallback;
+  const int kNumPaths = 20;
+
+  // Fill one domain with cookies, a few of them on each of several paths.
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumPaths; ++i) {
+    gurls.push_back(GURL(base::StringPrintf("%s/p%02d/", kGoogleURL, i)));
+    for (int j = 0; j < 5; ++j) {
+      setCookieCallback.SetCookie(
+          cm.get(), gurls.back(), base::StringPrintf("a%02d%d=b", i, j));
+    }
+  }
+  for (int i = 0; i < 50; ++i) {
+    setCookieCallback.SetCookie(cm.get(), GURL(kGoogleURL),
+                                base::StringPrintf("b%02d=c", i));
+  }
+  EXPECT_EQ(55, CountInString(
+      getCookiesCallback.GetCookies(cm.get(), gurls[0]), '='));
+
+  // Pages mostly send requests for the same few URLs again and again.
+  base::PerfTimeLogger timer("Cookie_monster_query_many_paths");
+  for (int i = 0; i < kNumCookies; ++i) {
+    getCookiesCallback.GetCookies(cm.get(), gurls[i % kNumPaths]);
+  }
+  timer.Done();
+
+  // Setting a cookie makes the next lookups for the domain start over.
+  base::PerfTimeLogger timer2("Cookie_monster_query_many_paths_after_set");
+  for (int i = 0; i < kNumCookies; ++i) {
+    if (i % kNumPaths == 0)
+      setCookieCallback.SetCookie(cm.get(), GURL(kGoogleURL), "c=d");
+    getCookiesCallback.GetCookies(cm.get(), gurls[i % kNumPaths]);
+  }
+  timer2.Done();
+}
+
 TEST_F(CookieMonsterTest, TestImport) {
   scoped_refptr<MockPersistentCookieStore> store(new MockPersistentCookieStore);
   std::vector<CanonicalCookie*> initial_cookies;
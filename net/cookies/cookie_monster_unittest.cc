@@ -1239,6 +1239,44 @@ TEST_F(CookieMonsterTest, TestDeleteSingleCookie) {
   EXPECT_EQ("A=B; E=F", GetCookies(cm.get(), url_google_));
 }
 
+// Repeated lookups for the same URL see every change to its cookies.
+TEST_F(CookieMonsterTest, RepeatedGetCookies) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  CookieOptions options;
+  options.set_include_httponly();
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+
+  // A domain cookie set from another host of the same domain.
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_secure_,
+                        "C=D; domain=.google.izzle"));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_));
+
+  // Secure and HttpOnly cookies are only included where they apply.
+  EXPECT_TRUE(SetCookieWithOptions(cm.get(), url_google_secure_,
+                                   "E=F; secure; httponly", options));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_secure_));
+  EXPECT_EQ("A=B; C=D; E=F",
+            GetCookiesWithOptions(cm.get(), url_google_secure_, options));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_secure_));
+
+  // Longer paths go first.
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_foo_, "G=H; path=/foo"));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("G=H; A=B; C=D", GetCookies(cm.get(), url_google_foo_));
+
+  EXPECT_TRUE(FindAndDeleteCookie(cm.get(), url_google_.host(), "A"));
+  EXPECT_EQ("C=D", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("G=H; C=D", GetCookies(cm.get(), url_google_foo_));
+
+  DeleteAll(cm.get());
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_foo_));
+}
+
 TEST_F(CookieMonsterTest, SetCookieableSchemes) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   scoped_refptr<CookieMonster> cm_foo(new CookieMonster(NULL, NULL));
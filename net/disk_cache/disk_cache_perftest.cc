@@ -7,6 +7,7 @@
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/files/file_enumerator.h"
 #include "base/hash.h"
 #include "base/strings/string_util.h"
 #include "base/test/perf_time_logger.h"
@@ -22,6 +23,7 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/simple/simple_backend_impl.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -139,6 +141,16 @@ bool TimeRead(int num_entries, disk_cache::Backend* cache,
   return (expected == helper.callbacks_called());
 }
 
+// Evicts all the files of the cache in |cache_path| from the system cache.
+void EvictCacheFiles(const base::FilePath& cache_path) {
+  base::FileEnumerator enumerator(cache_path, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath file = enumerator.Next(); !file.empty();
+       file = enumerator.Next()) {
+    ASSERT_TRUE(file_util::EvictFileFromSystemCache(file));
+  }
+}
+
 int BlockSize() {
   // We can use form 1 to 4 blocks.
   return (rand() & 0x3) + 1;
@@ -206,6 +218,50 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   base::MessageLoop::current()->RunUntilIdle();
 }
 
+// The simple cache stores every entry in its own files, so the cost of small
+// entries is dominated by the number of IO operations and worker pool tasks
+// needed for each of them. TimeWrite() closes each entry right after writing
+// it, which lets the write and the close run together.
+TEST_F(DiskCacheTest, SimpleCacheBackendPerformance) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  net::TestCompletionCallback cb;
+  scoped_ptr<disk_cache::Backend> cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_SIMPLE, cache_path_, 0, false,
+      cache_thread.message_loop_proxy().get(), NULL, &cache, cb.callback());
+
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  TestEntries entries;
+  int num_entries = 1000;
+
+  EXPECT_TRUE(TimeWrite(num_entries, cache.get(), &entries));
+
+  base::MessageLoop::current()->RunUntilIdle();
+  cache.reset();
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+
+  EvictCacheFiles(cache_path_);
+
+  rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_SIMPLE, cache_path_, 0, false,
+      cache_thread.message_loop_proxy().get(), NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+  EXPECT_TRUE(TimeRead(num_entries, cache.get(), entries, true));
+
+  EXPECT_TRUE(TimeRead(num_entries, cache.get(), entries, false));
+
+  base::MessageLoop::current()->RunUntilIdle();
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
@@ -6,6 +6,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_util.h"
+#include "base/metrics/field_trial.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/threading/platform_thread.h"
@@ -19,8 +20,10 @@
 #include "net/disk_cache/disk_cache_test_util.h"
 #include "net/disk_cache/entry_impl.h"
 #include "net/disk_cache/mem_entry_impl.h"
+#include "net/disk_cache/simple/simple_backend_impl.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_entry_impl.h"
+#include "net/disk_cache/simple/simple_packed_store.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_test_util.h"
 #include "net/disk_cache/simple/simple_util.h"
@@ -3054,6 +3057,124 @@ TEST_F(DiskCacheEntryTest, SimpleCacheOptimisticWriteReleases) {
   EXPECT_TRUE(buffer1->HasOneRef());
 }
 
+// Tests that a write of stream 1 followed right away by a close, which run in
+// a single worker task, leaves an entry that reads back with valid checksums.
+TEST_F(DiskCacheEntryTest, SimpleCacheWriteThenClose) {
+  SetSimpleCacheMode();
+  InitCache();
+
+  const char key[] = "the first key";
+  const int kSize0 = 200;
+  const int kSize1 = 4096;
+  scoped_refptr<net::IOBuffer> buffer0(new net::IOBuffer(kSize0));
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize1));
+  scoped_refptr<net::IOBuffer> buffer_read(new net::IOBuffer(kSize1));
+  CacheTestFillBuffer(buffer0->data(), kSize0, false);
+  CacheTestFillBuffer(buffer1->data(), kSize1, false);
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK,
+            cache_->CreateEntry(key, &entry, net::CompletionCallback()));
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(kSize0, entry->WriteData(0, 0, buffer0.get(), kSize0,
+                                     net::CompletionCallback(), false));
+  net::TestCompletionCallback cb;
+  int rv = entry->WriteData(1, 0, buffer1.get(), kSize1, cb.callback(),
+                            false);
+  entry->Close();
+  EXPECT_EQ(kSize1, cb.GetResult(rv));
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize0, entry->GetDataSize(0));
+  EXPECT_EQ(kSize1, entry->GetDataSize(1));
+  EXPECT_EQ(kSize0, ReadData(entry, 0, 0, buffer_read.get(), kSize0));
+  EXPECT_EQ(0, memcmp(buffer0->data(), buffer_read->data(), kSize0));
+  EXPECT_EQ(kSize1, ReadData(entry, 1, 0, buffer_read.get(), kSize1));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer_read->data(), kSize1));
+
+  // Shrink stream 1, closing the entry right after the write again.
+  rv = entry->WriteData(1, 0, buffer1.get(), kSize1 / 2, cb.callback(), true);
+  entry->Close();
+  EXPECT_EQ(kSize1 / 2, cb.GetResult(rv));
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize0, entry->GetDataSize(0));
+  EXPECT_EQ(kSize1 / 2, entry->GetDataSize(1));
+  EXPECT_EQ(kSize0, ReadData(entry, 0, 0, buffer_read.get(), kSize0));
+  EXPECT_EQ(0, memcmp(buffer0->data(), buffer_read->data(), kSize0));
+  EXPECT_EQ(kSize1 / 2, ReadData(entry, 1, 0, buffer_read.get(), kSize1));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer_read->data(), kSize1 / 2));
+  entry->Close();
+}
+
+// Tests that small entries are kept in the packed store, and get files of
+// their own once they outgrow it.
+TEST_F(DiskCacheEntryTest, SimpleCachePackedEntries) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("SimpleCachePackedEntries",
+                                         "Enabled");
+  SetSimpleCacheMode();
+  InitCache();
+
+  const char key[] = "the first key";
+  const base::FilePath entry_file0_path = cache_path_.AppendASCII(
+      disk_cache::simple_util::GetFilenameFromKeyAndFileIndex(key, 0));
+  const int kSize0 = 200;
+  const int kSize1 = 1000;
+  const int kLargeSize1 =
+      2 * disk_cache::SimplePackedStore::kMaxPackedEntrySize;
+  scoped_refptr<net::IOBuffer> buffer0(new net::IOBuffer(kSize0));
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kLargeSize1));
+  scoped_refptr<net::IOBuffer> buffer_read(new net::IOBuffer(kLargeSize1));
+  CacheTestFillBuffer(buffer0->data(), kSize0, false);
+  CacheTestFillBuffer(buffer1->data(), kLargeSize1, false);
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+  EXPECT_EQ(kSize0, WriteData(entry, 0, 0, buffer0.get(), kSize0, false));
+  EXPECT_EQ(kSize1, WriteData(entry, 1, 0, buffer1.get(), kSize1, false));
+  entry->Close();
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+  EXPECT_FALSE(base::PathExists(entry_file0_path));
+  EXPECT_TRUE(base::DirectoryExists(cache_path_.AppendASCII(
+      disk_cache::SimplePackedStore::kDirectoryName)));
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize0, entry->GetDataSize(0));
+  EXPECT_EQ(kSize1, entry->GetDataSize(1));
+  EXPECT_EQ(kSize0, ReadData(entry, 0, 0, buffer_read.get(), kSize0));
+  EXPECT_EQ(0, memcmp(buffer0->data(), buffer_read->data(), kSize0));
+  EXPECT_EQ(kSize1, ReadData(entry, 1, 0, buffer_read.get(), kSize1));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer_read->data(), kSize1));
+
+  // Growing stream 1 past the packed size moves the entry to files.
+  EXPECT_EQ(kLargeSize1,
+            WriteData(entry, 1, 0, buffer1.get(), kLargeSize1, false));
+  entry->Close();
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+  EXPECT_TRUE(base::PathExists(entry_file0_path));
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize0, ReadData(entry, 0, 0, buffer_read.get(), kSize0));
+  EXPECT_EQ(0, memcmp(buffer0->data(), buffer_read->data(), kSize0));
+  EXPECT_EQ(kLargeSize1,
+            ReadData(entry, 1, 0, buffer_read.get(), kLargeSize1));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer_read->data(), kLargeSize1));
+
+  // Shrinking it packs the entry again.
+  EXPECT_EQ(kSize1, WriteData(entry, 1, 0, buffer1.get(), kSize1, true));
+  entry->Close();
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+  EXPECT_FALSE(base::PathExists(entry_file0_path));
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  EXPECT_EQ(kSize1, ReadData(entry, 1, 0, buffer_read.get(), kSize1));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer_read->data(), kSize1));
+  entry->Doom();
+  entry->Close();
+  EXPECT_NE(net::OK, OpenEntry(key, &entry));
+}
+
 TEST_F(DiskCacheEntryTest, SimpleCacheCreateDoomRace) {
   // Test sequence:
   // Create, Doom, Write, Close, Check files are not on disk anymore.
@@ -17,9 +17,11 @@ const int32 kFlashSmallEntrySize = 4 * 1024;
 const size_t kFlashMaxEntryCount = kFlashSegmentSize / kFlashSmallEntrySize - 1;
 
 // Segment summary consists of a fixed region at the end of the segment
-// containing a counter specifying the number of saved offsets followed by the
-// offsets.
-const int32 kFlashSummarySize = (1 + kFlashMaxEntryCount) * sizeof(int32);
+// containing the sequence number of the segment and a counter specifying the
+// number of saved offsets, followed by the offsets.  Sequence numbers start
+// at 1 and grow every time a segment is closed, 0 meaning that the segment
+// holds no entries.
+const int32 kFlashSummarySize = (2 + kFlashMaxEntryCount) * sizeof(int32);
 const int32 kFlashSegmentFreeSpace = kFlashSegmentSize - kFlashSummarySize;
 
 // An entry consists of a fixed number of streams.
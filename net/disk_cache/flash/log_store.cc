@@ -17,6 +17,7 @@ LogStore::LogStore(const base::FilePath& path, int32 size)
       num_segments_(size / kFlashSegmentSize),
       open_segments_(num_segments_),
       write_index_(0),
+      next_sequence_number_(1),
       current_entry_id_(-1),
       current_entry_num_bytes_left_to_write_(0),
       init_(false),
@@ -34,14 +35,21 @@ bool LogStore::Init() {
   if (!storage_.Init())
     return false;
 
-  // TODO(agayev): Once we start persisting segment metadata to disk, we will
-  // start from where we left off during the last shutdown.
-  scoped_ptr<Segment> segment(new Segment(write_index_, false, &storage_));
-  if (!segment->Init())
-    return false;
+  // Start from where we left off during the last shutdown.
+  int32 last_sequence_number = 0;
+  for (int32 index = 0; index < num_segments_; ++index) {
+    Segment segment(index, true, &storage_);
+    if (!segment.Init())
+      return false;
+    if (segment.sequence_number() > last_sequence_number) {
+      last_sequence_number = segment.sequence_number();
+      write_index_ = (index + 1) % num_segments_;
+    }
+  }
+  next_sequence_number_ = last_sequence_number + 1;
 
-  segment->AddUser();
-  open_segments_[write_index_] = segment.release();
+  if (!OpenWriteSegment())
+    return false;
   init_ = true;
   return true;
 }
@@ -53,7 +61,6 @@ bool LogStore::Close() {
     return false;
   closed_ = true;
   return true;
-  // TODO(agayev): persist metadata to disk.
 }
 
 bool LogStore::CreateEntry(int32 size, int32* id) {
@@ -72,12 +79,8 @@ bool LogStore::CreateEntry(int32 size, int32* id) {
     }
 
     write_index_ = GetNextSegmentIndex();
-    scoped_ptr<Segment> segment(new Segment(write_index_, false, &storage_));
-    if (!segment->Init())
+    if (!OpenWriteSegment())
       return false;
-
-    segment->AddUser();
-    open_segments_[write_index_] = segment.release();
   }
 
   *id = open_segments_[write_index_]->write_offset();
@@ -165,6 +168,17 @@ void LogStore::CloseEntry(int32 id) {
   }
 }
 
+bool LogStore::OpenWriteSegment() {
+  scoped_ptr<Segment> segment(new Segment(write_index_, false, &storage_));
+  if (!segment->Init())
+    return false;
+
+  segment->set_sequence_number(next_sequence_number_++);
+  segment->AddUser();
+  open_segments_[write_index_] = segment.release();
+  return true;
+}
+
 int32 LogStore::GetNextSegmentIndex() {
   DCHECK(init_ && !closed_);
   int32 next_index = (write_index_ + 1) % num_segments_;
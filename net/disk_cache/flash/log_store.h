@@ -22,6 +22,11 @@ class Segment;
 // i.e. it's not possible to overwrite data in place.  In order to update an
 // entry, a new version must be written.  Only one entry can be written to at
 // any given time, while concurrent reading of multiple entries is supported.
+//
+// Entries written to closed segments survive a restart: Init() resumes writing
+// after the most recently closed segment, so that segments keep being reused,
+// and their entries evicted, in FIFO order.  Entries of the segment being
+// written when the store was not closed are lost.
 class NET_EXPORT_PRIVATE LogStore {
  public:
   LogStore(const base::FilePath& path, int32 size);
@@ -62,6 +67,10 @@ class NET_EXPORT_PRIVATE LogStore {
   FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreSegmentSelectionIsFifo);
   FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreInUseSegmentIsSkipped);
   FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreReadFromCurrentAfterClose);
+  FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreResumeAfterReopen);
+
+  // Opens the segment at |write_index_| for writing.
+  bool OpenWriteSegment();
 
   int32 GetNextSegmentIndex();
   bool InUse(int32 segment_index) const;
@@ -78,6 +87,9 @@ class NET_EXPORT_PRIVATE LogStore {
   // |open_segments_| vector.
   int32 write_index_;
 
+  // The sequence number given to the next segment opened for writing.
+  int32 next_sequence_number_;
+
   // Ids of entries currently open, either CreatEntry'ed or OpenEntry'ed.
   std::set<int32> open_entries_;
 
@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
+#include "base/memory/scoped_ptr.h"
 #include "net/disk_cache/flash/flash_cache_test_base.h"
 #include "net/disk_cache/flash/format.h"
 #include "net/disk_cache/flash/log_store.h"
@@ -125,6 +128,46 @@ TEST_F(FlashCacheTest, LogStoreReadFromCurrentAfterClose) {
   EXPECT_TRUE(log_store.Close());
 }
 
+TEST_F(FlashCacheTest, LogStoreResumeAfterReopen) {
+  const int32 kSize = disk_cache::kFlashSegmentFreeSpace;
+  const std::vector<char> expected(kSize, 'c');
+
+  scoped_ptr<LogStore> log_store(new LogStore(path_, kStorageSize));
+  EXPECT_TRUE(log_store->Init());
+
+  int32 id1;
+  EXPECT_TRUE(log_store->CreateEntry(kSize, &id1));
+  EXPECT_TRUE(log_store->WriteData(&expected[0], kSize));
+  log_store->CloseEntry(id1);
+
+  // This entry goes to segment 1.
+  int32 id2;
+  EXPECT_TRUE(log_store->CreateEntry(kSize, &id2));
+  EXPECT_EQ(1, log_store->write_index_);
+  EXPECT_TRUE(log_store->WriteData(&expected[0], kSize));
+  log_store->CloseEntry(id2);
+  EXPECT_TRUE(log_store->Close());
+
+  // Writing resumes after the last closed segment, and both entries survive.
+  log_store.reset(new LogStore(path_, kStorageSize));
+  EXPECT_TRUE(log_store->Init());
+  EXPECT_EQ(2, log_store->write_index_);
+
+  std::vector<char> actual(kSize, 0);
+  EXPECT_TRUE(log_store->OpenEntry(id1));
+  EXPECT_TRUE(log_store->ReadData(id1, &actual[0], kSize, 0));
+  log_store->CloseEntry(id1);
+  EXPECT_EQ(expected, actual);
+
+  std::fill(actual.begin(), actual.end(), 0);
+  EXPECT_TRUE(log_store->OpenEntry(id2));
+  EXPECT_TRUE(log_store->ReadData(id2, &actual[0], kSize, 0));
+  log_store->CloseEntry(id2);
+  EXPECT_EQ(expected, actual);
+
+  EXPECT_TRUE(log_store->Close());
+}
+
 // TODO(agayev): Add a test that confirms that in-use segment is not selected as
 // the next write segment.
 
@@ -55,6 +55,12 @@ class Storage;
 //
 // ReadData can be called over the range that was previously written with
 // WriteData.  Reading from area that was not written will fail.
+//
+// Initializing a segment for writing clears its metadata on storage, so that
+// if the writer dies before calling Close(), the segment is read back as empty
+// rather than with the offsets of the entries it held before being reused.
+// The sequence number stored on Close() lets the owner of the storage find the
+// most recently written segment.
 
 class NET_EXPORT_PRIVATE Segment {
  public:
@@ -69,6 +75,11 @@ class NET_EXPORT_PRIVATE Segment {
   int32 index() const { return index_; }
   int32 write_offset() const { return write_offset_; }
 
+  // The sequence number is stored in the metadata on Close(); it is 0 for a
+  // segment that was never closed.
+  int32 sequence_number() const { return sequence_number_; }
+  void set_sequence_number(int32 sequence_number);
+
   bool HaveOffset(int32 offset) const;
   std::vector<int32> GetOffsets() const { return offsets_; }
 
@@ -108,6 +119,7 @@ class NET_EXPORT_PRIVATE Segment {
   const int32 offset_;  // Offset of the segment on |storage_|.
   const int32 summary_offset_;  // Offset of the segment summary.
   int32 write_offset_;  // Current write offset.
+  int32 sequence_number_;
   std::vector<int32> offsets_;
 
   DISALLOW_COPY_AND_ASSIGN(Segment);
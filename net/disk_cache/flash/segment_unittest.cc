@@ -150,3 +150,37 @@ TEST_F(FlashCacheTest, SegmentFillWithLargeEntries) {
   EXPECT_LT(segment->GetOffsets().size(), disk_cache::kFlashMaxEntryCount);
   EXPECT_TRUE(segment->Close());
 }
+
+TEST_F(FlashCacheTest, SegmentReuseClearsOffsets) {
+  disk_cache::Storage storage(path_, kStorageSize);
+  ASSERT_TRUE(storage.Init());
+
+  int32 index = rand() % kNumTestSegments;
+  scoped_ptr<disk_cache::Segment> segment(
+      new disk_cache::Segment(index, false, &storage));
+  EXPECT_TRUE(segment->Init());
+  segment->set_sequence_number(7);
+  SmallEntry entry;
+  int32 offset = segment->write_offset();
+  EXPECT_TRUE(segment->WriteData(entry.data, entry.size));
+  segment->StoreOffset(offset);
+  EXPECT_TRUE(segment->Close());
+
+  segment.reset(new disk_cache::Segment(index, true, &storage));
+  EXPECT_TRUE(segment->Init());
+  EXPECT_EQ(7, segment->sequence_number());
+  EXPECT_TRUE(segment->HaveOffset(offset));
+  EXPECT_TRUE(segment->Close());
+
+  // Reusing the segment for writing forgets the old entries even if it is
+  // never closed, e.g. after a crash.
+  scoped_ptr<disk_cache::Segment> writer(
+      new disk_cache::Segment(index, false, &storage));
+  EXPECT_TRUE(writer->Init());
+  segment.reset(new disk_cache::Segment(index, true, &storage));
+  EXPECT_TRUE(segment->Init());
+  EXPECT_EQ(0, segment->sequence_number());
+  EXPECT_TRUE(segment->GetOffsets().empty());
+  EXPECT_TRUE(segment->Close());
+  EXPECT_TRUE(writer->Close());
+}
@@ -0,0 +1,81 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+// Odd multipliers giving each row of the sketch its own hash function.
+const uint64 kRowSeeds[] = {
+  GG_UINT64_C(0x9e3779b97f4a7c15),
+  GG_UINT64_C(0xc2b2ae3d27d4eb4f),
+  GG_UINT64_C(0x165667b19e3779f9),
+  GG_UINT64_C(0xd6e8feb86659fd93),
+};
+
+}  // namespace
+
+namespace disk_cache {
+
+const int FrequencySketch::kMaxFrequency = 15;
+const int FrequencySketch::kSampleSizeMultiplier = 10;
+
+FrequencySketch::FrequencySketch(size_t width)
+    : width_(width),
+      sample_size_(width * kSampleSizeMultiplier),
+      additions_(0),
+      counters_(width * kDepth, 0) {
+  COMPILE_ASSERT(arraysize(kRowSeeds) == kDepth, seeds_for_every_row);
+  DCHECK_GT(width, 0U);
+}
+
+FrequencySketch::~FrequencySketch() {
+}
+
+void FrequencySketch::Increment(uint64 entry_hash) {
+  // Only the counters holding the current estimate are incremented, which
+  // keeps the overestimation caused by collisions lower.
+  const int estimate = Estimate(entry_hash);
+  if (estimate < kMaxFrequency) {
+    for (int row = 0; row < kDepth; ++row) {
+      uint8& counter = counters_[GetIndex(entry_hash, row)];
+      if (counter == estimate)
+        ++counter;
+    }
+  }
+
+  if (++additions_ >= sample_size_)
+    Age();
+}
+
+int FrequencySketch::Estimate(uint64 entry_hash) const {
+  int estimate = kMaxFrequency;
+  for (int row = 0; row < kDepth; ++row)
+    estimate = std::min<int>(estimate, counters_[GetIndex(entry_hash, row)]);
+  return estimate;
+}
+
+void FrequencySketch::Clear() {
+  std::fill(counters_.begin(), counters_.end(), 0);
+  additions_ = 0;
+}
+
+size_t FrequencySketch::GetIndex(uint64 entry_hash, int row) const {
+  const uint64 mixed = entry_hash * kRowSeeds[row];
+  return row * width_ + static_cast<size_t>((mixed >> 32) % width_);
+}
+
+void FrequencySketch::Age() {
+  for (std::vector<uint8>::iterator it = counters_.begin();
+       it != counters_.end(); ++it) {
+    *it /= 2;
+  }
+  additions_ /= 2;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,67 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+#define NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// Estimates how often each entry of a cache was used recently, in a fixed
+// amount of memory regardless of the number of entries. This is a count-min
+// sketch: every entry hash selects one small counter in each of a few rows,
+// and the estimate is the lowest of those counters, so that it can only be
+// too high when all of them collide with other entries.
+//
+// The counters saturate at kMaxFrequency, and all of them are halved once
+// the sketch has seen as many uses as it has counters in a row times
+// kSampleSizeMultiplier, so that old popularity fades away.
+//
+// Backends use the estimates to prefer evicting entries that are rarely used
+// over entries that were merely used long ago, which keeps a scan of a large
+// number of entries from pushing the working set out of the cache.
+class NET_EXPORT_PRIVATE FrequencySketch {
+ public:
+  static const int kMaxFrequency;
+  static const int kSampleSizeMultiplier;
+
+  // |width| is the number of counters in each row, and should be in the order
+  // of the number of entries of the cache.
+  explicit FrequencySketch(size_t width);
+  ~FrequencySketch();
+
+  // Records a use of the entry |entry_hash|.
+  void Increment(uint64 entry_hash);
+
+  // Returns the estimated number of recent uses of the entry |entry_hash|.
+  int Estimate(uint64 entry_hash) const;
+
+  // Forgets all the uses.
+  void Clear();
+
+ private:
+  static const int kDepth = 4;
+
+  size_t GetIndex(uint64 entry_hash, int row) const;
+
+  // Halves all the counters.
+  void Age();
+
+  const size_t width_;
+  const size_t sample_size_;
+  size_t additions_;
+
+  // The |kDepth| rows of |width_| counters, one row after the other.
+  std::vector<uint8> counters_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrequencySketch);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_FREQUENCY_SKETCH_H_
@@ -0,0 +1,57 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/frequency_sketch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(FrequencySketchTest, Basics) {
+  disk_cache::FrequencySketch sketch(1024);
+  EXPECT_EQ(0, sketch.Estimate(1));
+
+  sketch.Increment(1);
+  sketch.Increment(1);
+  sketch.Increment(2);
+  EXPECT_EQ(2, sketch.Estimate(1));
+  EXPECT_EQ(1, sketch.Estimate(2));
+  EXPECT_EQ(0, sketch.Estimate(3));
+
+  sketch.Clear();
+  EXPECT_EQ(0, sketch.Estimate(1));
+  EXPECT_EQ(0, sketch.Estimate(2));
+}
+
+TEST(FrequencySketchTest, Saturates) {
+  disk_cache::FrequencySketch sketch(1024);
+  for (int i = 0; i < 2 * disk_cache::FrequencySketch::kMaxFrequency; ++i)
+    sketch.Increment(1);
+  EXPECT_EQ(disk_cache::FrequencySketch::kMaxFrequency, sketch.Estimate(1));
+}
+
+TEST(FrequencySketchTest, NeverUnderestimates) {
+  // A sketch much smaller than the number of entries has many collisions.
+  disk_cache::FrequencySketch sketch(64);
+  for (uint64 hash = 0; hash < 100; ++hash) {
+    for (uint64 i = 0; i < hash % 4; ++i)
+      sketch.Increment(hash * GG_UINT64_C(0x100000001b3));
+  }
+  for (uint64 hash = 0; hash < 100; ++hash) {
+    EXPECT_LE(static_cast<int>(hash % 4),
+              sketch.Estimate(hash * GG_UINT64_C(0x100000001b3)));
+  }
+}
+
+TEST(FrequencySketchTest, Aging) {
+  const size_t kWidth = 16;
+  const size_t kSampleSize =
+      kWidth * disk_cache::FrequencySketch::kSampleSizeMultiplier;
+  disk_cache::FrequencySketch sketch(kWidth);
+  for (size_t i = 0; i < kSampleSize - 1; ++i)
+    sketch.Increment(1);
+  EXPECT_EQ(disk_cache::FrequencySketch::kMaxFrequency, sketch.Estimate(1));
+
+  // Completing the sample halves all the counters.
+  sketch.Increment(2);
+  EXPECT_EQ(disk_cache::FrequencySketch::kMaxFrequency / 2,
+            sketch.Estimate(1));
+}
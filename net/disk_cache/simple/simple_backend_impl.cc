@@ -32,6 +32,7 @@
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index.h"
 #include "net/disk_cache/simple/simple_index_file.h"
+#include "net/disk_cache/simple/simple_packed_store.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "net/disk_cache/simple/simple_version_upgrade.h"
@@ -182,6 +183,13 @@ void RunOperationAndCallback(
     operation_callback.Run(operation_result);
 }
 
+// Small entries are packed together only in the "Enabled" group of the
+// SimpleCachePackedEntries field trial.
+bool ShouldPackEntries() {
+  return base::FieldTrialList::FindFullName("SimpleCachePackedEntries") ==
+         "Enabled";
+}
+
 void RecordIndexLoad(net::CacheType cache_type,
                      base::TimeTicks constructed_since,
                      int result) {
@@ -205,6 +213,7 @@ SimpleBackendImpl::SimpleBackendImpl(const FilePath& path,
     : path_(path),
       cache_type_(cache_type),
       cache_thread_(cache_thread),
+      packed_store_(ShouldPackEntries() ? new SimplePackedStore(path) : NULL),
       orig_max_size_(max_bytes),
       entry_operations_mode_(
           cache_type == net::DISK_CACHE ?
@@ -227,7 +236,8 @@ int SimpleBackendImpl::Init(const CompletionCallback& completion_callback) {
   index_.reset(new SimpleIndex(MessageLoopProxy::current(), this, cache_type_,
                                make_scoped_ptr(new SimpleIndexFile(
                                    cache_thread_.get(), worker_pool_.get(),
-                                   cache_type_, path_))));
+                                   cache_type_, path_,
+                                   packed_store_.get()))));
   index_->ExecuteWhenReady(
       base::Bind(&RecordIndexLoad, cache_type_, base::TimeTicks::Now()));
 
@@ -235,7 +245,7 @@ int SimpleBackendImpl::Init(const CompletionCallback& completion_callback) {
       cache_thread_,
       FROM_HERE,
       base::Bind(&SimpleBackendImpl::InitCacheStructureOnDisk, path_,
-                 orig_max_size_),
+                 orig_max_size_, packed_store_.get() != NULL),
       base::Bind(&SimpleBackendImpl::InitializeIndex, AsWeakPtr(),
                  completion_callback));
   return net::ERR_IO_PENDING;
@@ -331,7 +341,7 @@ void SimpleBackendImpl::DoomEntries(std::vector<uint64>* entry_hashes,
   PostTaskAndReplyWithResult(
       worker_pool_, FROM_HERE,
       base::Bind(&SimpleSynchronousEntry::DoomEntrySet,
-                 mass_doom_entry_hashes_ptr, path_),
+                 mass_doom_entry_hashes_ptr, path_, packed_store_),
       base::Bind(&SimpleBackendImpl::DoomEntriesComplete,
                  AsWeakPtr(), base::Passed(&mass_doom_entry_hashes),
                  barrier_callback));
@@ -485,7 +495,8 @@ void SimpleBackendImpl::InitializeIndex(const CompletionCallback& callback,
 
 SimpleBackendImpl::DiskStatResult SimpleBackendImpl::InitCacheStructureOnDisk(
     const base::FilePath& path,
-    uint64 suggested_max_size) {
+    uint64 suggested_max_size,
+    bool pack_entries) {
   DiskStatResult result;
   result.max_size = suggested_max_size;
   result.net_error = net::OK;
@@ -494,6 +505,10 @@ SimpleBackendImpl::DiskStatResult SimpleBackendImpl::InitCacheStructureOnDisk(
                << path.LossyDisplayName();
     result.net_error = net::ERR_FAILED;
   } else {
+    // Deleting the packed entries makes the index stale, so that it is
+    // restored without them.
+    if (!pack_entries)
+      SimplePackedStore::DeleteStore(path);
     bool mtime_result =
         disk_cache::simple_util::GetMTime(path, &result.cache_dir_mtime);
     DCHECK(mtime_result);
@@ -24,6 +24,7 @@
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index.h"
 #include "net/disk_cache/simple/simple_net_log_parameters.h"
+#include "net/disk_cache/simple/simple_packed_store.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "third_party/zlib/zlib.h"
@@ -170,6 +171,7 @@ SimpleEntryImpl::SimpleEntryImpl(net::CacheType cache_type,
       cache_type_(cache_type),
       worker_pool_(backend->worker_pool()),
       path_(path),
+      packed_store_(backend->packed_store()),
       entry_hash_(entry_hash),
       use_optimistic_operations_(operations_mode == OPTIMISTIC_OPERATIONS),
       last_used_(Time::Now()),
@@ -687,6 +689,7 @@ void SimpleEntryImpl::OpenEntryInternal(bool have_index,
   Closure task = base::Bind(&SimpleSynchronousEntry::OpenEntry,
                             cache_type_,
                             path_,
+                            packed_store_,
                             entry_hash_,
                             have_index,
                             results.get());
@@ -736,6 +739,7 @@ void SimpleEntryImpl::CreateEntryInternal(bool have_index,
   Closure task = base::Bind(&SimpleSynchronousEntry::CreateEntry,
                             cache_type_,
                             path_,
+                            packed_store_,
                             key_,
                             entry_hash_,
                             have_index,
@@ -761,16 +765,7 @@ void SimpleEntryImpl::CloseInternal() {
   if (state_ == STATE_READY) {
     DCHECK(synchronous_entry_);
     state_ = STATE_IO_PENDING;
-    for (int i = 0; i < kSimpleEntryStreamCount; ++i) {
-      if (have_written_[i]) {
-        if (GetDataSize(i) == crc32s_end_offset_[i]) {
-          int32 crc = GetDataSize(i) == 0 ? crc32(0, Z_NULL, 0) : crc32s_[i];
-          crc32s_to_write->push_back(CRCRecord(i, true, crc));
-        } else {
-          crc32s_to_write->push_back(CRCRecord(i, false, 0));
-        }
-      }
-    }
+    GetCRCRecordsToWrite(crc32s_to_write.get());
   } else {
     DCHECK(STATE_UNINITIALIZED == state_ || STATE_FAILURE == state_);
   }
@@ -782,20 +777,39 @@ void SimpleEntryImpl::CloseInternal() {
                    SimpleEntryStat(last_used_, last_modified_, data_size_,
                                    sparse_data_size_),
                    base::Passed(&crc32s_to_write),
-                   stream_0_data_);
+                   stream_0_data_,
+                   doomed_);
     Closure reply = base::Bind(&SimpleEntryImpl::CloseOperationComplete, this);
     synchronous_entry_ = NULL;
     worker_pool_->PostTaskAndReply(FROM_HERE, task, reply);
+    RecordCRCCheckResults();
+  } else {
+    CloseOperationComplete();
+  }
+}
 
-    for (int i = 0; i < kSimpleEntryStreamCount; ++i) {
-      if (!have_written_[i]) {
-        SIMPLE_CACHE_UMA(ENUMERATION,
-                         "CheckCRCResult", cache_type_,
-                         crc_check_state_[i], CRC_CHECK_MAX);
+void SimpleEntryImpl::GetCRCRecordsToWrite(
+    std::vector<SimpleSynchronousEntry::CRCRecord>* crc32s_to_write) const {
+  typedef SimpleSynchronousEntry::CRCRecord CRCRecord;
+  for (int i = 0; i < kSimpleEntryStreamCount; ++i) {
+    if (have_written_[i]) {
+      if (GetDataSize(i) == crc32s_end_offset_[i]) {
+        int32 crc = GetDataSize(i) == 0 ? crc32(0, Z_NULL, 0) : crc32s_[i];
+        crc32s_to_write->push_back(CRCRecord(i, true, crc));
+      } else {
+        crc32s_to_write->push_back(CRCRecord(i, false, 0));
       }
     }
-  } else {
-    CloseOperationComplete();
+  }
+}
+
+void SimpleEntryImpl::RecordCRCCheckResults() const {
+  for (int i = 0; i < kSimpleEntryStreamCount; ++i) {
+    if (!have_written_[i]) {
+      SIMPLE_CACHE_UMA(ENUMERATION,
+                       "CheckCRCResult", cache_type_,
+                       crc_check_state_[i], CRC_CHECK_MAX);
+    }
   }
 }
 
@@ -963,6 +977,37 @@ void SimpleEntryImpl::WriteDataInternal(int stream_index,
     have_written_[0] = true;
 
   scoped_ptr<int> result(new int());
+
+  // A close queued right behind this write runs in the same worker task, so
+  // that the data, the EOF records and stream 0 can be written together.
+  if (!pending_operations_.empty() &&
+      pending_operations_.front().type() == SimpleEntryOperation::TYPE_CLOSE) {
+    pending_operations_.pop();
+    net_log_.AddEvent(net::NetLog::TYPE_SIMPLE_CACHE_ENTRY_CLOSE_BEGIN);
+    typedef SimpleSynchronousEntry::CRCRecord CRCRecord;
+    scoped_ptr<std::vector<CRCRecord> >
+        crc32s_to_write(new std::vector<CRCRecord>());
+    GetCRCRecordsToWrite(crc32s_to_write.get());
+    Closure task = base::Bind(&SimpleSynchronousEntry::WriteDataAndClose,
+                              base::Unretained(synchronous_entry_),
+                              SimpleSynchronousEntry::EntryOperationData(
+                                  stream_index, offset, buf_len, truncate,
+                                  doomed_),
+                              make_scoped_refptr(buf),
+                              base::Owned(entry_stat.release()),
+                              base::Passed(&crc32s_to_write),
+                              stream_0_data_,
+                              result.get());
+    Closure reply = base::Bind(&SimpleEntryImpl::WriteAndCloseOperationComplete,
+                               this,
+                               callback,
+                               base::Passed(&result));
+    synchronous_entry_ = NULL;
+    worker_pool_->PostTaskAndReply(FROM_HERE, task, reply);
+    RecordCRCCheckResults();
+    return;
+  }
+
   Closure task = base::Bind(&SimpleSynchronousEntry::WriteData,
                             base::Unretained(synchronous_entry_),
                             SimpleSynchronousEntry::EntryOperationData(
@@ -1077,7 +1122,8 @@ void SimpleEntryImpl::GetAvailableRangeInternal(
 void SimpleEntryImpl::DoomEntryInternal(const CompletionCallback& callback) {
   PostTaskAndReplyWithResult(
       worker_pool_, FROM_HERE,
-      base::Bind(&SimpleSynchronousEntry::DoomEntry, path_, entry_hash_),
+      base::Bind(&SimpleSynchronousEntry::DoomEntry, path_, packed_store_,
+                 entry_hash_),
       base::Bind(&SimpleEntryImpl::DoomOperationComplete, this, callback,
                  state_));
   state_ = STATE_IO_PENDING;
@@ -1256,6 +1302,32 @@ void SimpleEntryImpl::WriteOperationComplete(
   EntryOperationComplete(completion_callback, *entry_stat, result.Pass());
 }
 
+void SimpleEntryImpl::WriteAndCloseOperationComplete(
+    const CompletionCallback& completion_callback,
+    scoped_ptr<int> result) {
+  DCHECK(io_thread_checker_.CalledOnValidThread());
+  DCHECK_EQ(STATE_IO_PENDING, state_);
+  if (*result >= 0)
+    RecordWriteResult(cache_type_, WRITE_RESULT_SUCCESS);
+  else
+    RecordWriteResult(cache_type_, WRITE_RESULT_SYNC_WRITE_FAILURE);
+  if (net_log_.IsLoggingAllEvents()) {
+    net_log_.AddEvent(net::NetLog::TYPE_SIMPLE_CACHE_ENTRY_WRITE_END,
+        CreateNetLogReadWriteCompleteCallback(*result));
+  }
+
+  if (*result < 0)
+    MarkAsDoomed();
+  else if (!doomed_ && backend_.get())
+    backend_->index()->UpdateEntrySize(entry_hash_, GetDiskUsage());
+
+  if (!completion_callback.is_null()) {
+    MessageLoopProxy::current()->PostTask(FROM_HERE, base::Bind(
+        completion_callback, *result));
+  }
+  CloseOperationComplete();
+}
+
 void SimpleEntryImpl::ReadSparseOperationComplete(
     const CompletionCallback& completion_callback,
     scoped_ptr<base::Time> last_used,
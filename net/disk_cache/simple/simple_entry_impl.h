@@ -19,6 +19,7 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_entry_operation.h"
+#include "net/disk_cache/simple/simple_synchronous_entry.h"
 
 namespace base {
 class TaskRunner;
@@ -32,9 +33,6 @@ class IOBuffer;
 namespace disk_cache {
 
 class SimpleBackendImpl;
-class SimpleSynchronousEntry;
-class SimpleEntryStat;
-struct SimpleEntryCreationResults;
 
 // SimpleEntryImpl is the IO thread interface to an entry in the very simple
 // disk cache. It proxies for the SimpleSynchronousEntry, which performs IO
@@ -175,6 +173,15 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
 
   void CloseInternal();
 
+  // Adds the EOF records to write on close for the streams that were written
+  // to |crc32s_to_write|.
+  void GetCRCRecordsToWrite(
+      std::vector<SimpleSynchronousEntry::CRCRecord>* crc32s_to_write) const;
+
+  // Records the CheckCRCResult histogram of the streams that were not written,
+  // on close.
+  void RecordCRCCheckResults() const;
+
   void ReadDataInternal(int index,
                         int offset,
                         net::IOBuffer* buf,
@@ -241,6 +248,12 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
                               scoped_ptr<SimpleEntryStat> entry_stat,
                               scoped_ptr<int> result);
 
+  // Called after a write and the close queued behind it have completed in a
+  // single worker task.
+  void WriteAndCloseOperationComplete(
+      const CompletionCallback& completion_callback,
+      scoped_ptr<int> result);
+
   void ReadSparseOperationComplete(
       const CompletionCallback& completion_callback,
       scoped_ptr<base::Time> last_used,
@@ -305,6 +318,7 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
   const net::CacheType cache_type_;
   const scoped_refptr<base::TaskRunner> worker_pool_;
   const base::FilePath path_;
+  const scoped_refptr<SimplePackedStore> packed_store_;
   const uint64 entry_hash_;
   const bool use_optimistic_operations_;
   std::string key_;
@@ -23,6 +23,7 @@
 #include "base/threading/worker_pool.h"
 #include "base/time/time.h"
 #include "net/base/net_errors.h"
+#include "net/disk_cache/frequency_sketch.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index_delegate.h"
@@ -48,6 +49,16 @@ const uint32 kEvictionMarginDivisor = 20;
 
 const uint32 kBytesInKb = 1024;
 
+// The number of counters in each row of the frequency sketch. At one byte per
+// counter this costs 32 KiB, and keeps collisions rare up to a few thousand
+// entries.
+const size_t kFrequencySketchWidth = 8 * 1024;
+
+bool IsEvictionFrequencyAware() {
+  return base::FieldTrialList::FindFullName("SimpleCacheEviction") ==
+      "FrequencyAware";
+}
+
 // Utility class used for timestamp comparisons in entry metadata while sorting.
 class CompareHashesForTimestamp {
   typedef disk_cache::SimpleIndex SimpleIndex;
@@ -72,6 +83,34 @@ bool CompareHashesForTimestamp::operator()(uint64 hash1, uint64 hash2) {
   return it1->second.GetLastUsedTime() < it2->second.GetLastUsedTime();
 }
 
+// Orders the hashes by estimated frequency of use, then by timestamp.
+class CompareHashesForFrequency {
+  typedef disk_cache::SimpleIndex::EntrySet EntrySet;
+ public:
+  CompareHashesForFrequency(const EntrySet& set,
+                            const disk_cache::FrequencySketch& sketch);
+
+  bool operator()(uint64 hash1, uint64 hash2);
+ private:
+  CompareHashesForTimestamp compare_timestamps_;
+  const disk_cache::FrequencySketch& sketch_;
+};
+
+CompareHashesForFrequency::CompareHashesForFrequency(
+    const EntrySet& set,
+    const disk_cache::FrequencySketch& sketch)
+  : compare_timestamps_(set),
+    sketch_(sketch) {
+}
+
+bool CompareHashesForFrequency::operator()(uint64 hash1, uint64 hash2) {
+  const int frequency1 = sketch_.Estimate(hash1);
+  const int frequency2 = sketch_.Estimate(hash2);
+  if (frequency1 != frequency2)
+    return frequency1 < frequency2;
+  return compare_timestamps_(hash1, hash2);
+}
+
 }  // namespace
 
 namespace disk_cache {
@@ -147,6 +186,7 @@ SimpleIndex::SimpleIndex(base::SingleThreadTaskRunner* io_thread,
       low_watermark_(0),
       eviction_in_progress_(false),
       initialized_(false),
+      full_write_required_(false),
       index_file_(index_file.Pass()),
       io_thread_(io_thread),
       // Creating the callback once so it is reused every time
@@ -167,6 +207,9 @@ SimpleIndex::~SimpleIndex() {
 void SimpleIndex::Initialize(base::Time cache_mtime) {
   DCHECK(io_thread_checker_.CalledOnValidThread());
 
+  if (IsEvictionFrequencyAware())
+    frequency_sketch_.reset(new FrequencySketch(kFrequencySketchWidth));
+
   // Take the foreground and background index flush delays from the experiment
   // settings only if both are valid.
   foreground_flush_delay_ = kDefaultWriteToDiskDelayMSecs;
@@ -264,8 +307,11 @@ void SimpleIndex::Insert(uint64 entry_hash) {
   // creating the new entry, and then UpdateEntrySize will be called.
   InsertInEntrySet(
       entry_hash, EntryMetadata(base::Time::Now(), 0), &entries_set_);
+  if (frequency_sketch_)
+    frequency_sketch_->Increment(entry_hash);
   if (!initialized_)
     removed_entries_.erase(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -279,6 +325,7 @@ void SimpleIndex::Remove(uint64 entry_hash) {
 
   if (!initialized_)
     removed_entries_.insert(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -292,11 +339,14 @@ bool SimpleIndex::UseIfExists(uint64 entry_hash) {
   DCHECK(io_thread_checker_.CalledOnValidThread());
   // Always update the last used time, even if it is during initialization.
   // It will be merged later.
+  if (frequency_sketch_)
+    frequency_sketch_->Increment(entry_hash);
   EntrySet::iterator it = entries_set_.find(entry_hash);
   if (it == entries_set_.end())
     // If not initialized, always return true, forcing it to go to the disk.
     return !initialized_;
   it->second.SetLastUsedTime(base::Time::Now());
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   return true;
 }
@@ -305,7 +355,8 @@ void SimpleIndex::StartEvictionIfNeeded() {
   DCHECK(io_thread_checker_.CalledOnValidThread());
   if (eviction_in_progress_ || cache_size_ <= high_watermark_)
     return;
-  // Take all live key hashes from the index and sort them by time.
+  // Take all live key hashes from the index and sort them by time, or by
+  // frequency of use first when eviction is frequency aware.
   eviction_in_progress_ = true;
   eviction_start_time_ = base::TimeTicks::Now();
   SIMPLE_CACHE_UMA(MEMORY_KB,
@@ -320,8 +371,13 @@ void SimpleIndex::StartEvictionIfNeeded() {
        end = entries_set_.end(); it != end; ++it) {
     entry_hashes.push_back(it->first);
   }
-  std::sort(entry_hashes.begin(), entry_hashes.end(),
-            CompareHashesForTimestamp(entries_set_));
+  if (frequency_sketch_) {
+    std::sort(entry_hashes.begin(), entry_hashes.end(),
+              CompareHashesForFrequency(entries_set_, *frequency_sketch_));
+  } else {
+    std::sort(entry_hashes.begin(), entry_hashes.end(),
+              CompareHashesForTimestamp(entries_set_));
+  }
 
   // Remove as many entries from the index to get below |low_watermark_|.
   std::vector<uint64>::iterator it = entry_hashes.begin();
@@ -332,6 +388,12 @@ void SimpleIndex::StartEvictionIfNeeded() {
     DCHECK(found_meta != entries_set_.end());
     uint64 to_evict_size = found_meta->second.GetEntrySize();
     evicted_so_far_size += to_evict_size;
+    if (frequency_sketch_) {
+      SIMPLE_CACHE_UMA(ENUMERATION,
+                       "Eviction.FrequencyOfEvicted", cache_type_,
+                       frequency_sketch_->Estimate(*it),
+                       FrequencySketch::kMaxFrequency + 1);
+    }
     ++it;
   }
 
@@ -357,6 +419,7 @@ bool SimpleIndex::UpdateEntrySize(uint64 entry_hash, int entry_size) {
     return false;
 
   UpdateEntryIteratorSize(&it, entry_size);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   StartEvictionIfNeeded();
   return true;
@@ -440,6 +503,7 @@ void SimpleIndex::MergeInitializingSet(
 
   // The actual IO is asynchronous, so calling WriteToDisk() shouldn't slow the
   // merge down much.
+  full_write_required_ = load_result->flush_required;
   if (load_result->flush_required)
     WriteToDisk();
 
@@ -491,8 +555,27 @@ void SimpleIndex::WriteToDisk() {
   }
   last_write_to_disk_ = start;
 
-  index_file_->WriteToDisk(entries_set_, cache_size_,
-                           start, app_on_background_);
+  if (full_write_required_) {
+    index_file_->WriteToDisk(entries_set_, cache_size_,
+                             start, app_on_background_);
+    full_write_required_ = false;
+    changed_entries_.clear();
+    return;
+  }
+
+  EntrySet changed_entries;
+  HashList removed_hashes;
+  for (base::hash_set<uint64>::const_iterator it = changed_entries_.begin();
+       it != changed_entries_.end(); ++it) {
+    EntrySet::const_iterator found = entries_set_.find(*it);
+    if (found == entries_set_.end())
+      removed_hashes.push_back(*it);
+    else
+      changed_entries.insert(*found);
+  }
+  changed_entries_.clear();
+  index_file_->WriteChangesToDisk(changed_entries, removed_hashes,
+                                  start, app_on_background_);
 }
 
 }  // namespace disk_cache
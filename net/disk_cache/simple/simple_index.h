@@ -33,6 +33,7 @@ class PickleIterator;
 
 namespace disk_cache {
 
+class FrequencySketch;
 class SimpleIndexDelegate;
 class SimpleIndexFile;
 struct SimpleIndexLoadResult;
@@ -137,6 +138,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteQueued);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteExecuted);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWritePostponed);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, FrequencyAwareEviction);
 
   void StartEvictionIfNeeded();
   void EvictionDone(int result);
@@ -167,11 +169,26 @@ class NET_EXPORT_PRIVATE SimpleIndex
   bool eviction_in_progress_;
   base::TimeTicks eviction_start_time_;
 
+  // Counts the recent uses of the entries when eviction is frequency aware,
+  // in which case rarely used entries are evicted first. NULL when eviction
+  // is in least recently used order.
+  scoped_ptr<FrequencySketch> frequency_sketch_;
+
   // This stores all the entry_hash of entries that are removed during
   // initialization.
   base::hash_set<uint64> removed_entries_;
   bool initialized_;
 
+  // The entry_hash of the entries inserted, removed or updated since the index
+  // was last written to disk, which are all that is written unless
+  // |full_write_required_|.
+  base::hash_set<uint64> changed_entries_;
+
+  // Set when the index was recovered from the cache directory or loaded from
+  // the format of a previous version, so that there is no index on disk to
+  // apply changes to.
+  bool full_write_required_;
+
   scoped_ptr<SimpleIndexFile> index_file_;
 
   scoped_refptr<base::SingleThreadTaskRunner> io_thread_;
@@ -18,6 +18,8 @@
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index.h"
+#include "net/disk_cache/simple/simple_index_table.h"
+#include "net/disk_cache/simple/simple_packed_store.h"
 #include "net/disk_cache/simple/simple_synchronous_entry.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "third_party/zlib/zlib.h"
@@ -65,11 +67,26 @@ void UmaRecordIndexInitMethod(IndexInitMethod method,
                    method, INITIALIZE_METHOD_MAX);
 }
 
-bool WritePickleFile(Pickle* pickle, const base::FilePath& file_name) {
-  int bytes_written = file_util::WriteFile(
-      file_name, static_cast<const char*>(pickle->data()), pickle->size());
-  if (bytes_written != implicit_cast<int>(pickle->size())) {
-    base::DeleteFile(file_name, /* recursive = */ false);
+void UmaRecordIndexWriteToDiskTime(net::CacheType cache_type,
+                                   const base::TimeTicks& start_time,
+                                   bool app_on_background) {
+  if (app_on_background) {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexWriteToDiskTime.Background", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  } else {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexWriteToDiskTime.Foreground", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  }
+}
+
+// Returns the modification time of |cache_directory|, which the index records
+// to be found stale if entries are created after it is written.
+bool GetCacheDirectoryMTime(const base::FilePath& cache_directory,
+                            base::Time* out_mtime) {
+  if (!simple_util::GetMTime(cache_directory, out_mtime)) {
+    LOG(ERROR) << "Could obtain information about cache age";
     return false;
   }
   return true;
@@ -141,8 +158,6 @@ void SimpleIndexLoadResult::Reset() {
 const char SimpleIndexFile::kIndexFileName[] = "the-real-index";
 // static
 const char SimpleIndexFile::kIndexDirectory[] = "index-dir";
-// static
-const char SimpleIndexFile::kTempIndexFileName[] = "temp-index";
 
 SimpleIndexFile::IndexMetadata::IndexMetadata()
     : magic_number_(kSimpleIndexMagicNumber),
@@ -183,48 +198,64 @@ bool SimpleIndexFile::IndexMetadata::Deserialize(PickleIterator* it) {
       it->ReadUInt64(&cache_size_);
 }
 
-void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
-                                      const base::FilePath& cache_directory,
-                                      const base::FilePath& index_filename,
-                                      const base::FilePath& temp_index_filename,
-                                      scoped_ptr<Pickle> pickle,
-                                      const base::TimeTicks& start_time,
-                                      bool app_on_background) {
+void SimpleIndexFile::SyncWriteToDisk(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& index_filename,
+    scoped_ptr<SimpleIndex::EntrySet> entries,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
   // There is a chance that the index containing all the necessary data about
   // newly created entries will appear to be stale. This can happen if on-disk
   // part of a Create operation does not fit into the time budget for the index
   // flush delay. This simple approach will be reconsidered if it does not allow
   // for maintaining freshness.
   base::Time cache_dir_mtime;
-  if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
-    LOG(ERROR) << "Could obtain information about cache age";
+  if (!GetCacheDirectoryMTime(cache_directory, &cache_dir_mtime))
+    return;
+  const base::FilePath index_directory = index_filename.DirName();
+  if (!base::CreateDirectory(index_directory)) {
+    LOG(ERROR) << "Could not create a directory to hold the index file";
     return;
   }
-  SerializeFinalData(cache_dir_mtime, pickle.get());
-  if (!WritePickleFile(pickle.get(), temp_index_filename)) {
-    if (!base::CreateDirectory(temp_index_filename.DirName())) {
-      LOG(ERROR) << "Could not create a directory to hold the index file";
-      return;
-    }
-    if (!WritePickleFile(pickle.get(), temp_index_filename)) {
-      LOG(ERROR) << "Failed to write the temporary index file";
-      return;
-    }
+  if (!SimpleIndexTable::Create(index_directory, *entries, cache_dir_mtime)) {
+    LOG(ERROR) << "Failed to write the index table";
+    return;
   }
+  // The table supersedes the index file written by previous versions.
+  base::DeleteFile(index_filename, /* recursive = */ false);
 
-  // Atomically rename the temporary index file to become the real one.
-  bool result = base::ReplaceFile(temp_index_filename, index_filename, NULL);
-  DCHECK(result);
+  UmaRecordIndexWriteToDiskTime(cache_type, start_time, app_on_background);
+}
 
-  if (app_on_background) {
-    SIMPLE_CACHE_UMA(TIMES,
-                     "IndexWriteToDiskTime.Background", cache_type,
-                     (base::TimeTicks::Now() - start_time));
-  } else {
-    SIMPLE_CACHE_UMA(TIMES,
-                     "IndexWriteToDiskTime.Foreground", cache_type,
-                     (base::TimeTicks::Now() - start_time));
+// static
+void SimpleIndexFile::SyncWriteChangesToDisk(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& index_filename,
+    scoped_ptr<SimpleIndex::EntrySet> changed_entries,
+    scoped_ptr<SimpleIndex::HashList> removed_hashes,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
+  base::Time cache_dir_mtime;
+  if (!GetCacheDirectoryMTime(cache_directory, &cache_dir_mtime))
+    return;
+  // If the table cannot be updated, the cache modification time it records
+  // stays behind, and the index is recovered from the cache directory on the
+  // next start.
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_filename.DirName());
+  if (!table) {
+    LOG(ERROR) << "Could not open the index table";
+    return;
+  }
+  if (!table->ApplyChanges(*changed_entries, *removed_hashes,
+                           cache_dir_mtime)) {
+    LOG(ERROR) << "Failed to update the index table";
+    return;
   }
+
+  UmaRecordIndexWriteToDiskTime(cache_type, start_time, app_on_background);
 }
 
 bool SimpleIndexFile::IndexMetadata::CheckIndexMetadata() {
@@ -237,15 +268,15 @@ SimpleIndexFile::SimpleIndexFile(
     base::SingleThreadTaskRunner* cache_thread,
     base::TaskRunner* worker_pool,
     net::CacheType cache_type,
-    const base::FilePath& cache_directory)
+    const base::FilePath& cache_directory,
+    SimplePackedStore* packed_store)
     : cache_thread_(cache_thread),
       worker_pool_(worker_pool),
       cache_type_(cache_type),
       cache_directory_(cache_directory),
       index_file_(cache_directory_.AppendASCII(kIndexDirectory)
                       .AppendASCII(kIndexFileName)),
-      temp_index_file_(cache_directory_.AppendASCII(kIndexDirectory)
-                           .AppendASCII(kTempIndexFileName)) {
+      packed_store_(packed_store) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -256,7 +287,7 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
   base::Closure task = base::Bind(&SimpleIndexFile::SyncLoadIndexEntries,
                                   cache_type_,
                                   cache_last_modified, cache_directory_,
-                                  index_file_, out_result);
+                                  index_file_, packed_store_, out_result);
   worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
 }
 
@@ -264,15 +295,34 @@ void SimpleIndexFile::WriteToDisk(const SimpleIndex::EntrySet& entry_set,
                                   uint64 cache_size,
                                   const base::TimeTicks& start,
                                   bool app_on_background) {
-  IndexMetadata index_metadata(entry_set.size(), cache_size);
-  scoped_ptr<Pickle> pickle = Serialize(index_metadata, entry_set);
+  scoped_ptr<SimpleIndex::EntrySet> entries(
+      new SimpleIndex::EntrySet(entry_set));
   cache_thread_->PostTask(FROM_HERE, base::Bind(
       &SimpleIndexFile::SyncWriteToDisk,
       cache_type_,
       cache_directory_,
       index_file_,
-      temp_index_file_,
-      base::Passed(&pickle),
+      base::Passed(&entries),
+      base::TimeTicks::Now(),
+      app_on_background));
+}
+
+void SimpleIndexFile::WriteChangesToDisk(
+    const SimpleIndex::EntrySet& changed_entries,
+    const SimpleIndex::HashList& removed_hashes,
+    const base::TimeTicks& start,
+    bool app_on_background) {
+  scoped_ptr<SimpleIndex::EntrySet> changed_entries_copy(
+      new SimpleIndex::EntrySet(changed_entries));
+  scoped_ptr<SimpleIndex::HashList> removed_hashes_copy(
+      new SimpleIndex::HashList(removed_hashes));
+  cache_thread_->PostTask(FROM_HERE, base::Bind(
+      &SimpleIndexFile::SyncWriteChangesToDisk,
+      cache_type_,
+      cache_directory_,
+      index_file_,
+      base::Passed(&changed_entries_copy),
+      base::Passed(&removed_hashes_copy),
       base::TimeTicks::Now(),
       app_on_background));
 }
@@ -283,13 +333,27 @@ void SimpleIndexFile::SyncLoadIndexEntries(
     base::Time cache_last_modified,
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    SimplePackedStore* packed_store,
     SimpleIndexLoadResult* out_result) {
   // Load the index and find its age.
   base::Time last_cache_seen_by_index;
-  SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, out_result);
+  const base::FilePath index_directory = index_file_path.DirName();
+  SyncLoadFromTable(index_directory, &last_cache_seen_by_index, out_result);
+  base::FilePath loaded_file_path =
+      index_directory.AppendASCII(SimpleIndexTable::kJournalFileName);
+  if (!out_result->did_load) {
+    // Fall back to the index file written by previous versions, to be replaced
+    // with a table right away.
+    SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, out_result);
+    out_result->flush_required = out_result->did_load;
+    loaded_file_path = index_file_path;
+  }
 
   // Consider the index loaded if it is fresh.
-  const bool index_file_existed = base::PathExists(index_file_path);
+  const bool index_file_existed =
+      base::PathExists(index_file_path) ||
+      base::PathExists(
+          index_directory.AppendASCII(SimpleIndexTable::kTableFileName));
   if (!out_result->did_load) {
     if (index_file_existed)
       UmaRecordIndexFileState(INDEX_STATE_CORRUPT, cache_type);
@@ -297,7 +361,7 @@ void SimpleIndexFile::SyncLoadIndexEntries(
     if (cache_last_modified <= last_cache_seen_by_index) {
       base::Time latest_dir_mtime;
       simple_util::GetMTime(cache_directory, &latest_dir_mtime);
-      if (LegacyIsIndexFileStale(latest_dir_mtime, index_file_path)) {
+      if (LegacyIsIndexFileStale(latest_dir_mtime, loaded_file_path)) {
         UmaRecordIndexFileState(INDEX_STATE_FRESH_CONCURRENT_UPDATES,
                                 cache_type);
       } else {
@@ -311,7 +375,8 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 
   // Reconstruct the index by scanning the disk for entries.
   const base::TimeTicks start = base::TimeTicks::Now();
-  SyncRestoreFromDisk(cache_directory, index_file_path, out_result);
+  SyncRestoreFromDisk(cache_directory, index_file_path, packed_store,
+                      out_result);
   SIMPLE_CACHE_UMA(MEDIUM_TIMES, "IndexRestoreTime", cache_type,
                    base::TimeTicks::Now() - start);
   SIMPLE_CACHE_UMA(COUNTS, "IndexEntriesRestored", cache_type,
@@ -326,6 +391,27 @@ void SimpleIndexFile::SyncLoadIndexEntries(
   }
 }
 
+// static
+void SimpleIndexFile::SyncLoadFromTable(
+    const base::FilePath& index_directory,
+    base::Time* out_last_cache_seen_by_index,
+    SimpleIndexLoadResult* out_result) {
+  out_result->Reset();
+
+  scoped_ptr<SimpleIndexTable> table = SimpleIndexTable::Open(index_directory);
+  if (!table) {
+    SimpleIndexTable::DeleteFiles(index_directory);
+    return;
+  }
+
+#if !defined(OS_WIN)
+  out_result->entries.resize(table->entry_count() + kExtraSizeForMerge);
+#endif
+  table->GetEntries(&out_result->entries);
+  *out_last_cache_seen_by_index = table->cache_last_modified();
+  out_result->did_load = true;
+}
+
 // static
 void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
                                        base::Time* out_last_cache_seen_by_index,
@@ -432,9 +518,11 @@ void SimpleIndexFile::Deserialize(const char* data, int data_len,
 void SimpleIndexFile::SyncRestoreFromDisk(
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    SimplePackedStore* packed_store,
     SimpleIndexLoadResult* out_result) {
   VLOG(1) << "Simple Cache Index is being restored from disk.";
   base::DeleteFile(index_file_path, /* recursive = */ false);
+  SimpleIndexTable::DeleteFiles(index_file_path.DirName());
   out_result->Reset();
   SimpleIndex::EntrySet* entries = &out_result->entries;
 
@@ -444,6 +532,8 @@ void SimpleIndexFile::SyncRestoreFromDisk(
     LOG(ERROR) << "Could not reconstruct index from disk";
     return;
   }
+  if (packed_store)
+    packed_store->GetEntries(entries);
   out_result->did_load = true;
   // When we restore from disk we write the merged index file to disk right
   // away, this might save us from having to restore again next time.
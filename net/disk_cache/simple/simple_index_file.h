@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/port.h"
@@ -27,6 +28,8 @@ class TaskRunner;
 
 namespace disk_cache {
 
+class SimplePackedStore;
+
 const uint64 kSimpleIndexMagicNumber = GG_UINT64_C(0x656e74657220796f);
 
 struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
@@ -39,12 +42,18 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   bool flush_required;
 };
 
-// Simple Index File format is a pickle serialized data of IndexMetadata and
-// EntryMetadata objects. The file format is as follows: one instance of
-// serialized |IndexMetadata| followed serialized |EntryMetadata| entries
-// repeated |number_of_entries| amount of times. To know more about the format,
-// see SimpleIndexFile::Serialize() and SeeSimpleIndexFile::LoadFromDisk()
-// methods.
+// The index is stored in a SimpleIndexTable, which is written in full only
+// when the index is recovered from the cache directory and is otherwise updated
+// with the entries that changed since the last write, see
+// simple_index_table.h.
+//
+// Indexes written by previous versions are pickle serialized data of
+// IndexMetadata and EntryMetadata objects, which are still loaded so that the
+// cache directory does not have to be scanned on upgrade. The file format is as
+// follows: one instance of serialized |IndexMetadata| followed serialized
+// |EntryMetadata| entries repeated |number_of_entries| amount of times. To know
+// more about the format, see SimpleIndexFile::Serialize() and
+// SeeSimpleIndexFile::LoadFromDisk() methods.
 //
 // The non-static methods must run on the IO thread. All the real
 // work is done in the static methods, which are run on the cache thread
@@ -74,10 +83,13 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
     uint64 cache_size_;  // Total cache storage size in bytes.
   };
 
+  // |packed_store| holds the packed entries of the cache, which a restore of
+  // the index adds to those it finds in the cache directory. It may be NULL.
   SimpleIndexFile(base::SingleThreadTaskRunner* cache_thread,
                   base::TaskRunner* worker_pool,
                   net::CacheType cache_type,
-                  const base::FilePath& cache_directory);
+                  const base::FilePath& cache_directory,
+                  SimplePackedStore* packed_store);
   virtual ~SimpleIndexFile();
 
   // Get index entries based on current disk context.
@@ -91,6 +103,14 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                            const base::TimeTicks& start,
                            bool app_on_background);
 
+  // Update the index on disk with the new metadata of |changed_entries| and
+  // the removal of |removed_hashes|. Must follow a WriteToDisk() or a load
+  // that did not require a flush.
+  virtual void WriteChangesToDisk(const SimpleIndex::EntrySet& changed_entries,
+                                  const SimpleIndex::HashList& removed_hashes,
+                                  const base::TimeTicks& start,
+                                  bool app_on_background);
+
  private:
   friend class WrappedSimpleIndexFile;
 
@@ -106,8 +126,14 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                    base::Time cache_last_modified,
                                    const base::FilePath& cache_directory,
                                    const base::FilePath& index_file_path,
+                                   SimplePackedStore* packed_store,
                                    SimpleIndexLoadResult* out_result);
 
+  // Load the index table from |index_directory| returning an EntrySet.
+  static void SyncLoadFromTable(const base::FilePath& index_directory,
+                                base::Time* out_last_cache_seen_by_index,
+                                SimpleIndexLoadResult* out_result);
+
   // Load the index file from disk returning an EntrySet.
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
                                base::Time* out_last_cache_seen_by_index,
@@ -142,19 +168,29 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
       const base::FilePath& cache_path,
       const EntryFileCallback& entry_file_callback);
 
-  // Writes the index file to disk atomically.
+  // Writes a new index table with |entries| to disk atomically.
   static void SyncWriteToDisk(net::CacheType cache_type,
                               const base::FilePath& cache_directory,
                               const base::FilePath& index_filename,
-                              const base::FilePath& temp_index_filename,
-                              scoped_ptr<Pickle> pickle,
+                              scoped_ptr<SimpleIndex::EntrySet> entries,
                               const base::TimeTicks& start_time,
                               bool app_on_background);
 
+  // Applies the changes to the index table on disk.
+  static void SyncWriteChangesToDisk(
+      net::CacheType cache_type,
+      const base::FilePath& cache_directory,
+      const base::FilePath& index_filename,
+      scoped_ptr<SimpleIndex::EntrySet> changed_entries,
+      scoped_ptr<SimpleIndex::HashList> removed_hashes,
+      const base::TimeTicks& start_time,
+      bool app_on_background);
+
   // Scan the index directory for entries, returning an EntrySet of all entries
   // found.
   static void SyncRestoreFromDisk(const base::FilePath& cache_directory,
                                   const base::FilePath& index_file_path,
+                                  SimplePackedStore* packed_store,
                                   SimpleIndexLoadResult* out_result);
 
   // Determines if an index file is stale relative to the time of last
@@ -173,11 +209,10 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   const net::CacheType cache_type_;
   const base::FilePath cache_directory_;
   const base::FilePath index_file_;
-  const base::FilePath temp_index_file_;
+  const scoped_refptr<SimplePackedStore> packed_store_;
 
   static const char kIndexDirectory[];
   static const char kIndexFileName[];
-  static const char kTempIndexFileName[];
 
   DISALLOW_COPY_AND_ASSIGN(SimpleIndexFile);
 };
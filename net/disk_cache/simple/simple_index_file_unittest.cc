@@ -22,6 +22,7 @@
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_index.h"
 #include "net/disk_cache/simple/simple_index_file.h"
+#include "net/disk_cache/simple/simple_index_table.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "net/disk_cache/simple/simple_version_upgrade.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -78,7 +79,8 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
       : SimpleIndexFile(base::MessageLoopProxy::current().get(),
                         base::MessageLoopProxy::current().get(),
                         net::DISK_CACHE,
-                        index_file_directory) {}
+                        index_file_directory,
+                        NULL) {}
   virtual ~WrappedSimpleIndexFile() {
   }
 
@@ -86,6 +88,10 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
     return index_file_;
   }
 
+  base::FilePath GetIndexTablePath() const {
+    return index_file_.DirName().AppendASCII(SimpleIndexTable::kTableFileName);
+  }
+
   bool CreateIndexFileDirectory() const {
     return base::CreateDirectory(index_file_.DirName());
   }
@@ -211,12 +217,12 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
     simple_index_file.WriteToDisk(entries, kCacheSize,
                                   base::TimeTicks(), false);
     base::RunLoop().RunUntilIdle();
-    EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
+    EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexTablePath()));
   }
 
   WrappedSimpleIndexFile simple_index_file(cache_dir.path());
   base::Time fake_cache_mtime;
-  ASSERT_TRUE(simple_util::GetMTime(simple_index_file.GetIndexFilePath(),
+  ASSERT_TRUE(simple_util::GetMTime(simple_index_file.GetIndexTablePath(),
                                     &fake_cache_mtime));
   SimpleIndexLoadResult load_index_result;
   simple_index_file.LoadIndexEntries(fake_cache_mtime,
@@ -224,7 +230,7 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
                                      &load_index_result);
   base::RunLoop().RunUntilIdle();
 
-  EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexFilePath()));
+  EXPECT_TRUE(base::PathExists(simple_index_file.GetIndexTablePath()));
   ASSERT_TRUE(callback_called());
   EXPECT_TRUE(load_index_result.did_load);
   EXPECT_FALSE(load_index_result.flush_required);
@@ -234,6 +240,67 @@ TEST_F(SimpleIndexFileTest, DISABLED_WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+TEST_F(SimpleIndexFileTest, WriteChangesToDisk) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 11), &entries);
+  SimpleIndex::InsertInEntrySet(22, EntryMetadata(Time(), 22), &entries);
+  SimpleIndex::EntrySet changed_entries;
+  SimpleIndex::InsertInEntrySet(22, EntryMetadata(Time(), 23),
+                                &changed_entries);
+  SimpleIndex::InsertInEntrySet(33, EntryMetadata(Time(), 33),
+                                &changed_entries);
+  SimpleIndex::HashList removed_hashes(1, 11);
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  simple_index_file.WriteToDisk(entries, 0, base::TimeTicks(), false);
+  simple_index_file.WriteChangesToDisk(changed_entries, removed_hashes,
+                                       base::TimeTicks(), false);
+  base::RunLoop().RunUntilIdle();
+
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(simple_index_file.GetIndexTablePath().DirName());
+  ASSERT_TRUE(table.get());
+  SimpleIndex::EntrySet table_entries;
+  table->GetEntries(&table_entries);
+  EXPECT_EQ(2U, table_entries.size());
+  EXPECT_EQ(0U, table_entries.count(11));
+  ASSERT_EQ(1U, table_entries.count(22));
+  EXPECT_EQ(23, table_entries[22].GetEntrySize());
+  EXPECT_EQ(1U, table_entries.count(33));
+}
+
+// An index file written by a previous version is loaded, and replaced with
+// a table on the next flush.
+TEST_F(SimpleIndexFileTest, LoadLegacyIndexFile) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  ASSERT_TRUE(simple_index_file.CreateIndexFileDirectory());
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 11), &entries);
+  scoped_ptr<Pickle> pickle = WrappedSimpleIndexFile::Serialize(
+      SimpleIndexFile::IndexMetadata(1, 11), entries);
+  const base::Time now = base::Time::Now();
+  ASSERT_TRUE(WrappedSimpleIndexFile::SerializeFinalData(now, pickle.get()));
+  ASSERT_EQ(implicit_cast<int>(pickle->size()),
+            file_util::WriteFile(simple_index_file.GetIndexFilePath(),
+                                 static_cast<const char*>(pickle->data()),
+                                 pickle->size()));
+
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(now, GetCallback(), &load_index_result);
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_TRUE(callback_called());
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_TRUE(load_index_result.flush_required);
+  EXPECT_EQ(1U, load_index_result.entries.size());
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
@@ -321,21 +388,12 @@ TEST_F(SimpleIndexFileTest, SimpleCacheUpgrade) {
       base::Bind(&CallbackTest::Run, base::Unretained(&cb_shutdown), net::OK));
   helper.WaitUntilCacheIoFinished(1);
 
-  // Verify that the index file exists.
-  const base::FilePath& index_file_path =
-      cache_path.AppendASCII("index-dir").AppendASCII("the-real-index");
-  EXPECT_TRUE(base::PathExists(index_file_path));
-
-  // Verify that the version of the index file is correct.
-  std::string contents;
-  EXPECT_TRUE(base::ReadFileToString(index_file_path, &contents));
-  base::Time when_index_last_saw_cache;
-  SimpleIndexLoadResult deserialize_result;
-  WrappedSimpleIndexFile::Deserialize(contents.data(),
-                                      contents.size(),
-                                      &when_index_last_saw_cache,
-                                      &deserialize_result);
-  EXPECT_TRUE(deserialize_result.did_load);
+  // Verify that the index table exists, and that the version of the index
+  // table is correct.
+  const base::FilePath index_directory = cache_path.AppendASCII("index-dir");
+  EXPECT_TRUE(base::PathExists(
+      index_directory.AppendASCII(SimpleIndexTable::kTableFileName)));
+  EXPECT_TRUE(SimpleIndexTable::Open(index_directory).get());
 }
 
 #endif  // defined(OS_POSIX)
@@ -0,0 +1,589 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_index_table.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/rand_util.h"
+#include "net/disk_cache/simple/simple_backend_version.h"
+#include "third_party/zlib/zlib.h"
+
+namespace disk_cache {
+
+namespace {
+
+// The table is rebuilt, twice as large as its live entries, once the live
+// entries and the tombstones use up this fraction of its slots.
+const size_t kMaxLoadNumerator = 3;
+const size_t kMaxLoadDenominator = 4;
+
+const size_t kMinCapacity = 1024;
+const size_t kMaxCapacity = 1 << 28;
+
+// The journal is folded into the table header when it grows past this size.
+const int64 kMaxJournalLength = 64 * 1024;
+
+// A journal larger than this cannot have been written by ApplyChanges().
+const int64 kMaxJournalReadLength = 64 * 1024 * 1024;
+
+// The sizes stored in the EntryMetadata of the free slots.
+const int32 kEmptySlotSize = -1;
+const int32 kRemovedSlotSize = -2;
+
+const int kWriteChunkSize = 1024 * 1024;
+
+struct TableHeader {
+  uint64 magic_number;
+  uint32 version;
+  uint32 journal_id;
+  uint64 capacity;
+  uint64 entry_count;
+  uint64 removed_count;
+  int64 cache_last_modified;
+  uint32 reserved[3];
+  // Of all the fields above.
+  uint32 crc;
+};
+COMPILE_ASSERT(sizeof(TableHeader) == 64, table_header_size);
+
+struct JournalHeader {
+  uint64 magic_number;
+  uint32 version;
+  uint32 journal_id;
+};
+COMPILE_ASSERT(sizeof(JournalHeader) == 16, journal_header_size);
+
+enum JournalRecordType {
+  RECORD_UPDATE = 1,
+  RECORD_REMOVE = 2,
+  RECORD_COMMIT = 3,
+};
+
+struct JournalRecord {
+  uint32 type;
+  // Of the record with this field set to zero.
+  uint32 crc;
+  // The entry hash, or the cache modification time for commit records.
+  uint64 key;
+  // The EntryMetadata, or the entry and removed slot counts for commit
+  // records.
+  uint32 payload[2];
+};
+COMPILE_ASSERT(sizeof(JournalRecord) == 24, journal_record_size);
+
+uint32 CalculateCRC(const void* data, size_t length) {
+  return crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data),
+               length);
+}
+
+uint32 CalculateHeaderCRC(const TableHeader& header) {
+  return CalculateCRC(&header, offsetof(TableHeader, crc));
+}
+
+uint32 CalculateRecordCRC(const JournalRecord& record) {
+  JournalRecord copy = record;
+  copy.crc = 0;
+  return CalculateCRC(&copy, sizeof(copy));
+}
+
+JournalRecord MakeRecord(JournalRecordType type, uint64 key,
+                         uint32 payload0, uint32 payload1) {
+  JournalRecord record;
+  record.type = type;
+  record.key = key;
+  record.payload[0] = payload0;
+  record.payload[1] = payload1;
+  record.crc = CalculateRecordCRC(record);
+  return record;
+}
+
+JournalRecord MakeEntryRecord(JournalRecordType type,
+                              uint64 entry_hash,
+                              const EntryMetadata& entry_metadata) {
+  COMPILE_ASSERT(sizeof(EntryMetadata) == sizeof(JournalRecord().payload),
+                 entry_metadata_fits_in_payload);
+  uint32 payload[2];
+  memcpy(payload, &entry_metadata, sizeof(payload));
+  return MakeRecord(type, entry_hash, payload[0], payload[1]);
+}
+
+EntryMetadata GetRecordEntryMetadata(const JournalRecord& record) {
+  EntryMetadata entry_metadata;
+  memcpy(&entry_metadata, record.payload, sizeof(entry_metadata));
+  return entry_metadata;
+}
+
+bool IsSameMetadata(const EntryMetadata& a, const EntryMetadata& b) {
+  return a.GetLastUsedTime() == b.GetLastUsedTime() &&
+      a.GetEntrySize() == b.GetEntrySize();
+}
+
+size_t CapacityForEntryCount(size_t entry_count) {
+  size_t capacity = kMinCapacity;
+  while (capacity < 2 * entry_count && capacity < kMaxCapacity)
+    capacity *= 2;
+  return capacity;
+}
+
+bool WriteAll(base::File* file, int64 offset, const char* data, size_t size) {
+  while (size > 0) {
+    const int chunk = static_cast<int>(
+        std::min(size, static_cast<size_t>(kWriteChunkSize)));
+    if (file->Write(offset, data, chunk) != chunk)
+      return false;
+    offset += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+bool WriteJournalHeader(base::File* journal_file, uint32 journal_id) {
+  JournalHeader header;
+  header.magic_number = kSimpleIndexJournalMagicNumber;
+  header.version = kSimpleVersion;
+  header.journal_id = journal_id;
+  return journal_file->SetLength(0) &&
+      WriteAll(journal_file, 0, reinterpret_cast<const char*>(&header),
+               sizeof(header));
+}
+
+}  // namespace
+
+// static
+const char SimpleIndexTable::kTableFileName[] = "index-table";
+// static
+const char SimpleIndexTable::kJournalFileName[] = "index-journal";
+// static
+const char SimpleIndexTable::kTempTableFileName[] = "temp-index-table";
+
+struct SimpleIndexTable::Slot {
+  uint64 entry_hash;
+  // The entry size is kEmptySlotSize or kRemovedSlotSize in free slots.
+  EntryMetadata entry_metadata;
+};
+
+SimpleIndexTable::SimpleIndexTable(const base::FilePath& index_directory)
+    : index_directory_(index_directory),
+      journal_length_(0),
+      capacity_(0),
+      entry_count_(0),
+      removed_count_(0),
+      journal_id_(0) {
+  COMPILE_ASSERT(sizeof(Slot) == 16, slot_size);
+}
+
+SimpleIndexTable::~SimpleIndexTable() {}
+
+// static
+scoped_ptr<SimpleIndexTable> SimpleIndexTable::Open(
+    const base::FilePath& index_directory) {
+  scoped_ptr<SimpleIndexTable> table(new SimpleIndexTable(index_directory));
+  if (!table->MapTable() || !table->ReplayJournal())
+    return scoped_ptr<SimpleIndexTable>();
+  return table.Pass();
+}
+
+// static
+bool SimpleIndexTable::Create(const base::FilePath& index_directory,
+                              const SimpleIndex::EntrySet& entries,
+                              base::Time cache_last_modified) {
+  return WriteTableFiles(index_directory, entries, cache_last_modified);
+}
+
+// static
+void SimpleIndexTable::DeleteFiles(const base::FilePath& index_directory) {
+  base::DeleteFile(index_directory.AppendASCII(kTableFileName), false);
+  base::DeleteFile(index_directory.AppendASCII(kJournalFileName), false);
+}
+
+bool SimpleIndexTable::Find(uint64 entry_hash,
+                            EntryMetadata* out_entry_metadata) const {
+  bool removed = false;
+  const int64 index = FindSlot(entry_hash, &removed);
+  if (index < 0 || removed)
+    return false;
+  *out_entry_metadata = slots()[index].entry_metadata;
+  return true;
+}
+
+void SimpleIndexTable::GetEntries(SimpleIndex::EntrySet* entries) const {
+  const Slot* table_slots = slots();
+  for (size_t i = 0; i < capacity_; ++i) {
+    const int32 entry_size = table_slots[i].entry_metadata.GetEntrySize();
+    if (entry_size == kEmptySlotSize || entry_size == kRemovedSlotSize)
+      continue;
+    SimpleIndex::InsertInEntrySet(table_slots[i].entry_hash,
+                                  table_slots[i].entry_metadata,
+                                  entries);
+  }
+}
+
+bool SimpleIndexTable::ApplyChanges(
+    const SimpleIndex::EntrySet& updated_entries,
+    const SimpleIndex::HashList& removed_hashes,
+    base::Time cache_last_modified) {
+  // Each hash has at most one slot, so the counts after the batch are known
+  // ahead and can go into its commit record.
+  size_t inserted_count = 0;
+  size_t revived_count = 0;
+  for (SimpleIndex::EntrySet::const_iterator it = updated_entries.begin();
+       it != updated_entries.end(); ++it) {
+    bool removed = false;
+    if (FindSlot(it->first, &removed) < 0)
+      ++inserted_count;
+    else if (removed)
+      ++revived_count;
+  }
+  size_t erased_count = 0;
+  for (SimpleIndex::HashList::const_iterator it = removed_hashes.begin();
+       it != removed_hashes.end(); ++it) {
+    bool removed = false;
+    if (FindSlot(*it, &removed) >= 0 && !removed)
+      ++erased_count;
+  }
+
+  cache_last_modified_ = cache_last_modified;
+  if ((entry_count_ + removed_count_ + inserted_count) * kMaxLoadDenominator >
+      capacity_ * kMaxLoadNumerator) {
+    SimpleIndex::EntrySet entries;
+    GetEntries(&entries);
+    for (SimpleIndex::HashList::const_iterator it = removed_hashes.begin();
+         it != removed_hashes.end(); ++it) {
+      entries.erase(*it);
+    }
+    for (SimpleIndex::EntrySet::const_iterator it = updated_entries.begin();
+         it != updated_entries.end(); ++it) {
+      entries[it->first] = it->second;
+    }
+    return Rebuild(entries);
+  }
+
+  const size_t new_entry_count =
+      entry_count_ + inserted_count + revived_count - erased_count;
+  const size_t new_removed_count =
+      removed_count_ + erased_count - revived_count;
+
+  std::vector<JournalRecord> records;
+  records.reserve(updated_entries.size() + removed_hashes.size() + 1);
+  for (SimpleIndex::EntrySet::const_iterator it = updated_entries.begin();
+       it != updated_entries.end(); ++it) {
+    records.push_back(MakeEntryRecord(RECORD_UPDATE, it->first, it->second));
+  }
+  for (SimpleIndex::HashList::const_iterator it = removed_hashes.begin();
+       it != removed_hashes.end(); ++it) {
+    records.push_back(MakeEntryRecord(RECORD_REMOVE, *it, EntryMetadata()));
+  }
+  records.push_back(MakeRecord(
+      RECORD_COMMIT, cache_last_modified.ToInternalValue(),
+      static_cast<uint32>(new_entry_count),
+      static_cast<uint32>(new_removed_count)));
+  const size_t records_size = records.size() * sizeof(JournalRecord);
+  if (!WriteAll(&journal_file_, journal_length_,
+                reinterpret_cast<const char*>(&records[0]), records_size)) {
+    return false;
+  }
+  journal_length_ += records_size;
+
+  for (SimpleIndex::EntrySet::const_iterator it = updated_entries.begin();
+       it != updated_entries.end(); ++it) {
+    if (!PutEntry(it->first, it->second))
+      return false;
+  }
+  for (SimpleIndex::HashList::const_iterator it = removed_hashes.begin();
+       it != removed_hashes.end(); ++it) {
+    if (!RemoveEntry(*it))
+      return false;
+  }
+  DCHECK_EQ(new_entry_count, entry_count_);
+  DCHECK_EQ(new_removed_count, removed_count_);
+
+  if (journal_length_ > kMaxJournalLength)
+    return Checkpoint();
+  return true;
+}
+
+bool SimpleIndexTable::MapTable() {
+  table_file_.Initialize(index_directory_.AppendASCII(kTableFileName),
+                         base::File::FLAG_OPEN | base::File::FLAG_READ |
+                             base::File::FLAG_WRITE);
+  if (!table_file_.IsValid())
+    return false;
+  table_map_.reset(new base::MemoryMappedFile());
+  if (!table_map_->Initialize(table_file_.Duplicate()) ||
+      table_map_->length() < sizeof(TableHeader)) {
+    LOG(WARNING) << "Could not map the Simple Index table.";
+    return false;
+  }
+
+  const TableHeader* header =
+      reinterpret_cast<const TableHeader*>(table_map_->data());
+  if (header->magic_number != kSimpleIndexTableMagicNumber ||
+      header->version != kSimpleVersion ||
+      header->crc != CalculateHeaderCRC(*header)) {
+    LOG(WARNING) << "Invalid header in Simple Index table.";
+    return false;
+  }
+  const uint64 capacity = header->capacity;
+  if (capacity < kMinCapacity || capacity > kMaxCapacity ||
+      (capacity & (capacity - 1)) != 0 ||
+      table_map_->length() != sizeof(TableHeader) + capacity * sizeof(Slot) ||
+      header->entry_count + header->removed_count > capacity) {
+    LOG(WARNING) << "Invalid size of Simple Index table.";
+    return false;
+  }
+
+  capacity_ = static_cast<size_t>(capacity);
+  entry_count_ = static_cast<size_t>(header->entry_count);
+  removed_count_ = static_cast<size_t>(header->removed_count);
+  journal_id_ = header->journal_id;
+  cache_last_modified_ =
+      base::Time::FromInternalValue(header->cache_last_modified);
+  return true;
+}
+
+bool SimpleIndexTable::ReplayJournal() {
+  journal_file_.Initialize(index_directory_.AppendASCII(kJournalFileName),
+                           base::File::FLAG_OPEN_ALWAYS |
+                               base::File::FLAG_READ | base::File::FLAG_WRITE);
+  if (!journal_file_.IsValid())
+    return false;
+  const int64 length = journal_file_.GetLength();
+  if (length < 0 || length > kMaxJournalReadLength)
+    return false;
+
+  JournalHeader header;
+  if (length < static_cast<int64>(sizeof(header)) ||
+      journal_file_.Read(0, reinterpret_cast<char*>(&header),
+                         sizeof(header)) != static_cast<int>(sizeof(header)) ||
+      header.magic_number != kSimpleIndexJournalMagicNumber ||
+      header.version != kSimpleVersion ||
+      header.journal_id != journal_id_) {
+    // There is nothing to replay: the journal was started over, or was never
+    // written.
+    return ResetJournal(journal_id_);
+  }
+
+  const size_t records_length = static_cast<size_t>(length) - sizeof(header);
+  std::vector<JournalRecord> records(records_length / sizeof(JournalRecord));
+  if (!records.empty() &&
+      journal_file_.Read(sizeof(header), reinterpret_cast<char*>(&records[0]),
+                         records.size() * sizeof(JournalRecord)) !=
+          static_cast<int>(records.size() * sizeof(JournalRecord))) {
+    return false;
+  }
+
+  // Redo the batches up to the last one that was fully journaled. The
+  // operations are idempotent, so it does not matter how much of each batch
+  // had already made it to the table.
+  size_t batch_start = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const JournalRecord& record = records[i];
+    if (record.crc != CalculateRecordCRC(record))
+      break;
+    if (record.type != RECORD_COMMIT)
+      continue;
+    for (size_t j = batch_start; j < i; ++j) {
+      bool result = false;
+      if (records[j].type == RECORD_UPDATE) {
+        result = PutEntry(records[j].key, GetRecordEntryMetadata(records[j]));
+      } else if (records[j].type == RECORD_REMOVE) {
+        result = RemoveEntry(records[j].key);
+      }
+      if (!result)
+        return false;
+    }
+    entry_count_ = record.payload[0];
+    removed_count_ = record.payload[1];
+    cache_last_modified_ = base::Time::FromInternalValue(record.key);
+    batch_start = i + 1;
+  }
+
+  // Drop the batch that was being journaled when the process died, if any.
+  journal_length_ = sizeof(header) + batch_start * sizeof(JournalRecord);
+  if (journal_length_ != length && !journal_file_.SetLength(journal_length_))
+    return false;
+  return true;
+}
+
+bool SimpleIndexTable::ResetJournal(uint32 journal_id) {
+  if (!WriteJournalHeader(&journal_file_, journal_id))
+    return false;
+  journal_length_ = sizeof(JournalHeader);
+  return true;
+}
+
+bool SimpleIndexTable::Checkpoint() {
+  TableHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic_number = kSimpleIndexTableMagicNumber;
+  header.version = kSimpleVersion;
+  header.journal_id = journal_id_ + 1;
+  header.capacity = capacity_;
+  header.entry_count = entry_count_;
+  header.removed_count = removed_count_;
+  header.cache_last_modified = cache_last_modified_.ToInternalValue();
+  header.crc = CalculateHeaderCRC(header);
+  // Once the header is written, the current journal is stale. It does not
+  // matter if the process dies before the new one is started.
+  if (!WriteAll(&table_file_, 0, reinterpret_cast<const char*>(&header),
+                sizeof(header))) {
+    return false;
+  }
+  journal_id_ = header.journal_id;
+  return ResetJournal(journal_id_);
+}
+
+bool SimpleIndexTable::Rebuild(const SimpleIndex::EntrySet& entries) {
+  // The files have to be closed to be replaced on Windows.
+  table_map_.reset();
+  table_file_.Close();
+  journal_file_.Close();
+  return WriteTableFiles(index_directory_, entries, cache_last_modified_) &&
+      MapTable() && ReplayJournal();
+}
+
+// static
+bool SimpleIndexTable::WriteTableFiles(const base::FilePath& index_directory,
+                                       const SimpleIndex::EntrySet& entries,
+                                       base::Time cache_last_modified) {
+  const size_t capacity = CapacityForEntryCount(entries.size());
+  if (entries.size() * kMaxLoadDenominator > capacity * kMaxLoadNumerator) {
+    LOG(ERROR) << "Too many entries for the Simple Index table.";
+    return false;
+  }
+
+  Slot empty_slot = { 0, EntryMetadata(base::Time(), kEmptySlotSize) };
+  std::vector<Slot> table_slots(capacity, empty_slot);
+  const size_t mask = capacity - 1;
+  for (SimpleIndex::EntrySet::const_iterator it = entries.begin();
+       it != entries.end(); ++it) {
+    size_t index = it->first & mask;
+    while (table_slots[index].entry_metadata.GetEntrySize() != kEmptySlotSize)
+      index = (index + 1) & mask;
+    table_slots[index].entry_hash = it->first;
+    table_slots[index].entry_metadata = it->second;
+  }
+
+  TableHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic_number = kSimpleIndexTableMagicNumber;
+  header.version = kSimpleVersion;
+  header.journal_id = static_cast<uint32>(base::RandUint64());
+  header.capacity = capacity;
+  header.entry_count = entries.size();
+  header.removed_count = 0;
+  header.cache_last_modified = cache_last_modified.ToInternalValue();
+  header.crc = CalculateHeaderCRC(header);
+
+  const base::FilePath temp_table_path =
+      index_directory.AppendASCII(kTempTableFileName);
+  base::File temp_table_file(temp_table_path,
+                             base::File::FLAG_CREATE_ALWAYS |
+                                 base::File::FLAG_WRITE);
+  if (!temp_table_file.IsValid())
+    return false;
+  if (!WriteAll(&temp_table_file, 0, reinterpret_cast<const char*>(&header),
+                sizeof(header)) ||
+      !WriteAll(&temp_table_file, sizeof(header),
+                reinterpret_cast<const char*>(&table_slots[0]),
+                table_slots.size() * sizeof(Slot))) {
+    temp_table_file.Close();
+    base::DeleteFile(temp_table_path, false);
+    return false;
+  }
+  temp_table_file.Close();
+
+  // The old journal does not match the id of the new table, so the table is
+  // usable as soon as it is renamed.
+  if (!base::ReplaceFile(temp_table_path,
+                         index_directory.AppendASCII(kTableFileName), NULL)) {
+    base::DeleteFile(temp_table_path, false);
+    return false;
+  }
+  base::File journal_file(index_directory.AppendASCII(kJournalFileName),
+                          base::File::FLAG_CREATE_ALWAYS |
+                              base::File::FLAG_WRITE);
+  return journal_file.IsValid() &&
+      WriteJournalHeader(&journal_file, header.journal_id);
+}
+
+int64 SimpleIndexTable::FindSlot(uint64 entry_hash, bool* out_removed) const {
+  const Slot* table_slots = slots();
+  const size_t mask = capacity_ - 1;
+  size_t index = entry_hash & mask;
+  for (size_t probes = 0; probes < capacity_; ++probes) {
+    const int32 entry_size = table_slots[index].entry_metadata.GetEntrySize();
+    if (entry_size == kEmptySlotSize)
+      return -1;
+    if (table_slots[index].entry_hash == entry_hash) {
+      *out_removed = entry_size == kRemovedSlotSize;
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+  return -1;
+}
+
+bool SimpleIndexTable::PutEntry(uint64 entry_hash,
+                                const EntryMetadata& entry_metadata) {
+  const Slot slot = { entry_hash, entry_metadata };
+  bool removed = false;
+  const int64 found = FindSlot(entry_hash, &removed);
+  if (found >= 0) {
+    if (removed) {
+      ++entry_count_;
+      --removed_count_;
+    } else if (IsSameMetadata(slots()[found].entry_metadata,
+                              entry_metadata)) {
+      // Replaying the journal mostly finds the slots already up to date.
+      return true;
+    }
+    return WriteSlot(static_cast<size_t>(found), slot);
+  }
+
+  const Slot* table_slots = slots();
+  const size_t mask = capacity_ - 1;
+  size_t index = entry_hash & mask;
+  for (size_t probes = 0; probes < capacity_; ++probes) {
+    if (table_slots[index].entry_metadata.GetEntrySize() == kEmptySlotSize) {
+      ++entry_count_;
+      return WriteSlot(index, slot);
+    }
+    index = (index + 1) & mask;
+  }
+  LOG(ERROR) << "The Simple Index table is full.";
+  return false;
+}
+
+bool SimpleIndexTable::RemoveEntry(uint64 entry_hash) {
+  bool removed = false;
+  const int64 found = FindSlot(entry_hash, &removed);
+  if (found < 0 || removed)
+    return true;
+  const Slot slot = {
+    entry_hash, EntryMetadata(base::Time(), kRemovedSlotSize)
+  };
+  --entry_count_;
+  ++removed_count_;
+  return WriteSlot(static_cast<size_t>(found), slot);
+}
+
+bool SimpleIndexTable::WriteSlot(size_t index, const Slot& slot) {
+  return WriteAll(&table_file_, sizeof(TableHeader) + index * sizeof(Slot),
+                  reinterpret_cast<const char*>(&slot), sizeof(slot));
+}
+
+const SimpleIndexTable::Slot* SimpleIndexTable::slots() const {
+  return reinterpret_cast<const Slot*>(table_map_->data() +
+                                       sizeof(TableHeader));
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,148 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
+
+#include "base/basictypes.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/simple/simple_index.h"
+
+namespace disk_cache {
+
+const uint64 kSimpleIndexTableMagicNumber = GG_UINT64_C(0x9c3e58a1d2f04b67);
+const uint64 kSimpleIndexJournalMagicNumber = GG_UINT64_C(0x4a75726e616c2121);
+
+// An on-disk index that is updated in place, so that flushing the index costs
+// in proportion to the entries that changed rather than to the size of the
+// cache.
+//
+// The table file holds a header followed by an open-addressing hash table of
+// (entry hash, EntryMetadata) slots with linear probing. A removed entry
+// leaves a tombstone with its hash, which is revived if the entry comes back,
+// so that every hash has at most one slot; the tombstones are dropped when the
+// table is rebuilt. The table is read through a shared read-only
+// mapping and written with small positioned writes, which the mapping sees
+// right away.
+//
+// Every batch of changes is first appended to the journal file, terminated by
+// a commit record that carries the resulting entry counts, and only then
+// applied to the table. If the process dies in the middle of applying a
+// batch, the next Open() replays the committed batches of the journal, so the
+// table is consistent again without a scan of the cache directory. When the
+// journal grows past a few tens of KB its contents are folded into the table
+// header and it starts over. The table and the journal carry the same id, so
+// a journal left over from a crash during that step is recognized as stale.
+//
+// All methods perform blocking IO and must run on the cache thread or a
+// worker. This class is not thread-safe.
+class NET_EXPORT_PRIVATE SimpleIndexTable {
+ public:
+  static const char kTableFileName[];
+  static const char kJournalFileName[];
+  static const char kTempTableFileName[];
+
+  ~SimpleIndexTable();
+
+  // Opens the table stored in |index_directory| and replays its journal.
+  // Returns NULL if there is no table or it is corrupt.
+  static scoped_ptr<SimpleIndexTable> Open(
+      const base::FilePath& index_directory);
+
+  // Atomically replaces the table and the journal in |index_directory| with a
+  // new table holding |entries|. Returns false on IO failure, leaving the
+  // previous table in place.
+  static bool Create(const base::FilePath& index_directory,
+                     const SimpleIndex::EntrySet& entries,
+                     base::Time cache_last_modified);
+
+  // Deletes the table and the journal in |index_directory|.
+  static void DeleteFiles(const base::FilePath& index_directory);
+
+  // Returns the metadata of |entry_hash| in |out_entry_metadata|, if it is in
+  // the table.
+  bool Find(uint64 entry_hash, EntryMetadata* out_entry_metadata) const;
+
+  // Adds all the entries of the table to |entries|.
+  void GetEntries(SimpleIndex::EntrySet* entries) const;
+
+  // Journals and then applies the new metadata of |updated_entries|, the
+  // removal of |removed_hashes| and the new |cache_last_modified|, which must
+  // all be different entries. Returns false on IO failure, in which case the
+  // table should not be used anymore.
+  bool ApplyChanges(const SimpleIndex::EntrySet& updated_entries,
+                    const SimpleIndex::HashList& removed_hashes,
+                    base::Time cache_last_modified);
+
+  size_t entry_count() const { return entry_count_; }
+  size_t capacity() const { return capacity_; }
+
+  // The modification time of the cache directory when the table was last
+  // written.
+  base::Time cache_last_modified() const { return cache_last_modified_; }
+
+ private:
+  struct Slot;
+
+  explicit SimpleIndexTable(const base::FilePath& index_directory);
+
+  // Maps the table file and reads its header. Returns false if it is corrupt.
+  bool MapTable();
+
+  // Reads the journal and redoes its committed batches. Returns false on IO
+  // failure.
+  bool ReplayJournal();
+
+  // Starts a new empty journal with the id |journal_id|.
+  bool ResetJournal(uint32 journal_id);
+
+  // Writes the counters to the table header under a new journal id, and
+  // starts a journal with it.
+  bool Checkpoint();
+
+  // Writes a new table with |entries| and maps it in place of this one.
+  bool Rebuild(const SimpleIndex::EntrySet& entries);
+
+  // Writes the files of a new table with |entries| to |index_directory|.
+  static bool WriteTableFiles(const base::FilePath& index_directory,
+                              const SimpleIndex::EntrySet& entries,
+                              base::Time cache_last_modified);
+
+  // Returns the index of the slot of |entry_hash|, or -1. Sets |out_removed|
+  // if the slot is the tombstone of the entry.
+  int64 FindSlot(uint64 entry_hash, bool* out_removed) const;
+
+  // The table operations, used both for new changes and for replaying the
+  // journal. Return false on IO failure or, for PutEntry(), if the table is
+  // full.
+  bool PutEntry(uint64 entry_hash, const EntryMetadata& entry_metadata);
+  bool RemoveEntry(uint64 entry_hash);
+  bool WriteSlot(size_t index, const Slot& slot);
+
+  const Slot* slots() const;
+
+  const base::FilePath index_directory_;
+
+  base::File table_file_;
+  scoped_ptr<base::MemoryMappedFile> table_map_;
+  base::File journal_file_;
+  int64 journal_length_;
+
+  size_t capacity_;
+  size_t entry_count_;
+  size_t removed_count_;
+  uint32 journal_id_;
+  base::Time cache_last_modified_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimpleIndexTable);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_TABLE_H_
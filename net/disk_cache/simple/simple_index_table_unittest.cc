@@ -0,0 +1,307 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_index_table.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/time/time.h"
+#include "net/disk_cache/simple/simple_index.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+const uint64 kHashMultiplier = GG_UINT64_C(0x9e3779b97f4a7c15);
+
+base::Time TimeFromSeconds(int64 seconds) {
+  return base::Time::UnixEpoch() + base::TimeDelta::FromSeconds(seconds);
+}
+
+class SimpleIndexTableTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  const base::FilePath& index_directory() const { return temp_dir_.path(); }
+
+  base::FilePath table_path() const {
+    return index_directory().AppendASCII(SimpleIndexTable::kTableFileName);
+  }
+
+  base::FilePath journal_path() const {
+    return index_directory().AppendASCII(SimpleIndexTable::kJournalFileName);
+  }
+
+  int64 GetFileLength(const base::FilePath& path) {
+    int64 length = -1;
+    EXPECT_TRUE(base::GetFileSize(path, &length));
+    return length;
+  }
+
+  SimpleIndex::EntrySet GetTableEntries() {
+    SimpleIndex::EntrySet entries;
+    scoped_ptr<SimpleIndexTable> table =
+        SimpleIndexTable::Open(index_directory());
+    EXPECT_TRUE(table.get());
+    if (table.get())
+      table->GetEntries(&entries);
+    return entries;
+  }
+
+  static void ExpectSameEntries(const SimpleIndex::EntrySet& expected,
+                                const SimpleIndex::EntrySet& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (SimpleIndex::EntrySet::const_iterator it = expected.begin();
+         it != expected.end(); ++it) {
+      SimpleIndex::EntrySet::const_iterator found = actual.find(it->first);
+      ASSERT_TRUE(found != actual.end()) << it->first;
+      EXPECT_EQ(it->second.GetEntrySize(), found->second.GetEntrySize());
+      EXPECT_EQ(it->second.GetLastUsedTime(),
+                found->second.GetLastUsedTime());
+    }
+  }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(SimpleIndexTableTest, OpenMissing) {
+  EXPECT_FALSE(SimpleIndexTable::Open(index_directory()).get());
+}
+
+TEST_F(SimpleIndexTableTest, CreateThenOpen) {
+  SimpleIndex::EntrySet entries;
+  for (uint64 hash = 1; hash <= 100; ++hash) {
+    SimpleIndex::InsertInEntrySet(
+        hash * kHashMultiplier,
+        EntryMetadata(TimeFromSeconds(hash), static_cast<int>(hash * 10)),
+        &entries);
+  }
+  const base::Time kCacheLastModified = TimeFromSeconds(12345);
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(), entries,
+                                       kCacheLastModified));
+
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  EXPECT_EQ(entries.size(), table->entry_count());
+  EXPECT_EQ(kCacheLastModified, table->cache_last_modified());
+  EntryMetadata metadata;
+  ASSERT_TRUE(table->Find(3 * kHashMultiplier, &metadata));
+  EXPECT_EQ(30, metadata.GetEntrySize());
+  EXPECT_FALSE(table->Find(3, &metadata));
+
+  SimpleIndex::EntrySet loaded_entries;
+  table->GetEntries(&loaded_entries);
+  ExpectSameEntries(entries, loaded_entries);
+}
+
+TEST_F(SimpleIndexTableTest, OpenCorrupt) {
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(),
+                                       SimpleIndex::EntrySet(), base::Time()));
+  base::File file(table_path(), base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.IsValid());
+  const char kGarbage[] = "garbage";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            file.Write(8, kGarbage, sizeof(kGarbage)));
+  file.Close();
+  EXPECT_FALSE(SimpleIndexTable::Open(index_directory()).get());
+}
+
+TEST_F(SimpleIndexTableTest, ApplyChangesInPlace) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(1), 10),
+                                &entries);
+  SimpleIndex::InsertInEntrySet(2, EntryMetadata(TimeFromSeconds(2), 20),
+                                &entries);
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(), entries,
+                                       base::Time()));
+  const int64 table_length = GetFileLength(table_path());
+
+  SimpleIndex::EntrySet updated_entries;
+  SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(5), 15),
+                                &updated_entries);
+  SimpleIndex::InsertInEntrySet(3, EntryMetadata(TimeFromSeconds(3), 30),
+                                &updated_entries);
+  SimpleIndex::HashList removed_hashes;
+  removed_hashes.push_back(2);
+  removed_hashes.push_back(4);
+  const base::Time kCacheLastModified = TimeFromSeconds(100);
+  {
+    scoped_ptr<SimpleIndexTable> table =
+        SimpleIndexTable::Open(index_directory());
+    ASSERT_TRUE(table.get());
+    ASSERT_TRUE(table->ApplyChanges(updated_entries, removed_hashes,
+                                    kCacheLastModified));
+    EXPECT_EQ(2U, table->entry_count());
+  }
+  EXPECT_EQ(table_length, GetFileLength(table_path()));
+
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  EXPECT_EQ(2U, table->entry_count());
+  EXPECT_EQ(kCacheLastModified, table->cache_last_modified());
+  SimpleIndex::EntrySet loaded_entries;
+  table->GetEntries(&loaded_entries);
+  ExpectSameEntries(updated_entries, loaded_entries);
+}
+
+TEST_F(SimpleIndexTableTest, RemovedEntryComesBack) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(7, EntryMetadata(TimeFromSeconds(1), 10),
+                                &entries);
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(), entries,
+                                       base::Time()));
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  SimpleIndex::HashList removed_hashes(1, 7);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(table->ApplyChanges(SimpleIndex::EntrySet(), removed_hashes,
+                                    base::Time()));
+    ASSERT_TRUE(table->ApplyChanges(entries, SimpleIndex::HashList(),
+                                    base::Time()));
+  }
+  EXPECT_EQ(1U, table->entry_count());
+  table.reset();
+  ExpectSameEntries(entries, GetTableEntries());
+}
+
+TEST_F(SimpleIndexTableTest, Grow) {
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(),
+                                       SimpleIndex::EntrySet(), base::Time()));
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  const size_t initial_capacity = table->capacity();
+
+  SimpleIndex::EntrySet entries;
+  for (uint64 hash = 0; hash < 4 * initial_capacity; ++hash) {
+    SimpleIndex::EntrySet updated_entries;
+    const EntryMetadata metadata(TimeFromSeconds(hash),
+                                 static_cast<int>(hash));
+    SimpleIndex::InsertInEntrySet(hash, metadata, &updated_entries);
+    SimpleIndex::InsertInEntrySet(hash, metadata, &entries);
+    ASSERT_TRUE(table->ApplyChanges(updated_entries, SimpleIndex::HashList(),
+                                    base::Time()));
+  }
+  EXPECT_LT(initial_capacity, table->capacity());
+  EXPECT_EQ(entries.size(), table->entry_count());
+  table.reset();
+  ExpectSameEntries(entries, GetTableEntries());
+}
+
+TEST_F(SimpleIndexTableTest, JournalIsFoldedIntoTable) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(1), 10),
+                                &entries);
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(), entries,
+                                       base::Time()));
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  const int64 empty_journal_length = GetFileLength(journal_path());
+  int64 max_journal_length = 0;
+  for (int i = 0; i < 10000; ++i) {
+    SimpleIndex::EntrySet updated_entries;
+    SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(i), i),
+                                  &updated_entries);
+    ASSERT_TRUE(table->ApplyChanges(updated_entries, SimpleIndex::HashList(),
+                                    TimeFromSeconds(i)));
+    max_journal_length =
+        std::max(max_journal_length, GetFileLength(journal_path()));
+  }
+  EXPECT_LT(empty_journal_length, max_journal_length);
+  EXPECT_GT(10000 * 48, max_journal_length);
+  table.reset();
+
+  table = SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  EXPECT_EQ(TimeFromSeconds(9999), table->cache_last_modified());
+  EntryMetadata metadata;
+  ASSERT_TRUE(table->Find(1, &metadata));
+  EXPECT_EQ(9999, metadata.GetEntrySize());
+}
+
+// The process may die after a batch of changes is journaled but before it is
+// applied to the table. Opening the table again redoes the batch.
+TEST_F(SimpleIndexTableTest, ReplayJournal) {
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(1), 10),
+                                &entries);
+  SimpleIndex::InsertInEntrySet(2, EntryMetadata(TimeFromSeconds(2), 20),
+                                &entries);
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(), entries,
+                                       base::Time()));
+  std::string old_table;
+  ASSERT_TRUE(base::ReadFileToString(table_path(), &old_table));
+
+  SimpleIndex::EntrySet updated_entries;
+  SimpleIndex::InsertInEntrySet(3, EntryMetadata(TimeFromSeconds(3), 30),
+                                &updated_entries);
+  SimpleIndex::HashList removed_hashes(1, 1);
+  const base::Time kCacheLastModified = TimeFromSeconds(100);
+  {
+    scoped_ptr<SimpleIndexTable> table =
+        SimpleIndexTable::Open(index_directory());
+    ASSERT_TRUE(table.get());
+    ASSERT_TRUE(table->ApplyChanges(updated_entries, removed_hashes,
+                                    kCacheLastModified));
+  }
+
+  // Undo the changes to the table, but not to the journal.
+  ASSERT_EQ(static_cast<int>(old_table.size()),
+            file_util::WriteFile(table_path(), old_table.data(),
+                                 old_table.size()));
+
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  EXPECT_EQ(2U, table->entry_count());
+  EXPECT_EQ(kCacheLastModified, table->cache_last_modified());
+  EntryMetadata metadata;
+  EXPECT_FALSE(table->Find(1, &metadata));
+  EXPECT_TRUE(table->Find(2, &metadata));
+  EXPECT_TRUE(table->Find(3, &metadata));
+}
+
+// A batch that did not make it to the journal in full is dropped.
+TEST_F(SimpleIndexTableTest, TornJournal) {
+  ASSERT_TRUE(SimpleIndexTable::Create(index_directory(),
+                                       SimpleIndex::EntrySet(), base::Time()));
+  {
+    scoped_ptr<SimpleIndexTable> table =
+        SimpleIndexTable::Open(index_directory());
+    ASSERT_TRUE(table.get());
+    SimpleIndex::EntrySet updated_entries;
+    SimpleIndex::InsertInEntrySet(1, EntryMetadata(TimeFromSeconds(1), 10),
+                                  &updated_entries);
+    ASSERT_TRUE(table->ApplyChanges(updated_entries, SimpleIndex::HashList(),
+                                    base::Time()));
+  }
+  const int64 journal_length = GetFileLength(journal_path());
+  const char kGarbage[] = "half a record";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            file_util::AppendToFile(journal_path(), kGarbage,
+                                    sizeof(kGarbage)));
+
+  scoped_ptr<SimpleIndexTable> table =
+      SimpleIndexTable::Open(index_directory());
+  ASSERT_TRUE(table.get());
+  EXPECT_EQ(1U, table->entry_count());
+  EXPECT_EQ(journal_length, GetFileLength(journal_path()));
+}
+
+}  // namespace disk_cache
@@ -9,6 +9,7 @@
 #include "base/hash.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/field_trial.h"
 #include "base/pickle.h"
 #include "base/sha1.h"
 #include "base/strings/stringprintf.h"
@@ -52,10 +53,11 @@ class MockSimpleIndexFile : public SimpleIndexFile,
                             public base::SupportsWeakPtr<MockSimpleIndexFile> {
  public:
   MockSimpleIndexFile()
-      : SimpleIndexFile(NULL, NULL, net::DISK_CACHE, base::FilePath()),
+      : SimpleIndexFile(NULL, NULL, net::DISK_CACHE, base::FilePath(), NULL),
         load_result_(NULL),
         load_index_entries_calls_(0),
-        disk_writes_(0) {}
+        disk_writes_(0),
+        full_disk_writes_(0) {}
 
   virtual void LoadIndexEntries(
       base::Time cache_last_modified,
@@ -71,24 +73,42 @@ class MockSimpleIndexFile : public SimpleIndexFile,
                            const base::TimeTicks& start,
                            bool app_on_background) OVERRIDE {
     disk_writes_++;
+    full_disk_writes_++;
     disk_write_entry_set_ = entry_set;
+    disk_write_removed_hashes_.clear();
+  }
+
+  virtual void WriteChangesToDisk(const SimpleIndex::EntrySet& changed_entries,
+                                  const SimpleIndex::HashList& removed_hashes,
+                                  const base::TimeTicks& start,
+                                  bool app_on_background) OVERRIDE {
+    disk_writes_++;
+    disk_write_entry_set_ = changed_entries;
+    disk_write_removed_hashes_ = removed_hashes;
   }
 
   void GetAndResetDiskWriteEntrySet(SimpleIndex::EntrySet* entry_set) {
     entry_set->swap(disk_write_entry_set_);
   }
 
+  const SimpleIndex::HashList& disk_write_removed_hashes() const {
+    return disk_write_removed_hashes_;
+  }
+
   const base::Closure& load_callback() const { return load_callback_; }
   SimpleIndexLoadResult* load_result() const { return load_result_; }
   int load_index_entries_calls() const { return load_index_entries_calls_; }
   int disk_writes() const { return disk_writes_; }
+  int full_disk_writes() const { return full_disk_writes_; }
 
  private:
   base::Closure load_callback_;
   SimpleIndexLoadResult* load_result_;
   int load_index_entries_calls_;
   int disk_writes_;
+  int full_disk_writes_;
   SimpleIndex::EntrySet disk_write_entry_set_;
+  SimpleIndex::HashList disk_write_removed_hashes_;
 };
 
 class SimpleIndexTest  : public testing::Test, public SimpleIndexDelegate {
@@ -549,6 +569,45 @@ TEST_F(SimpleIndexTest, BasicEviction) {
   ASSERT_EQ(2u, last_doom_entry_hashes().size());
 }
 
+// Frequently used entries outlive entries that were used more recently but
+// only once when eviction is frequency aware.
+TEST_F(SimpleIndexTest, FrequencyAwareEviction) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("SimpleCacheEviction",
+                                         "FrequencyAware");
+  SetUp();
+  ASSERT_TRUE(index()->frequency_sketch_);
+
+  index()->SetMaxSize(1000);
+  ReturnIndexFile();
+
+  index()->Insert(hashes_.at<1>());
+  index()->UseIfExists(hashes_.at<1>());
+  index()->UseIfExists(hashes_.at<1>());
+  index()->UpdateEntrySize(hashes_.at<1>(), 300);
+
+  WaitForTimeChange();
+  index()->Insert(hashes_.at<2>());
+  index()->UpdateEntrySize(hashes_.at<2>(), 300);
+
+  WaitForTimeChange();
+  index()->Insert(hashes_.at<3>());
+  index()->UpdateEntrySize(hashes_.at<3>(), 300);
+  EXPECT_EQ(0, doom_entries_calls());
+
+  // The least recently used entry is the most frequently used one, so the
+  // oldest of the others goes instead.
+  index()->Insert(hashes_.at<4>());
+  index()->UpdateEntrySize(hashes_.at<4>(), 300);
+  EXPECT_EQ(1, doom_entries_calls());
+  ASSERT_EQ(1u, last_doom_entry_hashes().size());
+  EXPECT_EQ(hashes_.at<2>(), last_doom_entry_hashes()[0]);
+  EXPECT_TRUE(index()->Has(hashes_.at<1>()));
+  EXPECT_FALSE(index()->Has(hashes_.at<2>()));
+  EXPECT_TRUE(index()->Has(hashes_.at<3>()));
+  EXPECT_TRUE(index()->Has(hashes_.at<4>()));
+}
+
 // Confirm all the operations queue a disk write at some point in the
 // future.
 TEST_F(SimpleIndexTest, DiskWriteQueued) {
@@ -605,6 +664,70 @@ TEST_F(SimpleIndexTest, DiskWriteExecuted) {
   EXPECT_EQ(20, entry1.GetEntrySize());
 }
 
+// Only the entries that changed since the last write are written.
+TEST_F(SimpleIndexTest, DiskWriteChangedEntries) {
+  index()->SetMaxSize(1000);
+  const uint64 kHash1 = hashes_.at<1>();
+  const uint64 kHash2 = hashes_.at<2>();
+  const uint64 kHash3 = hashes_.at<3>();
+  InsertIntoIndexFileReturn(kHash1, base::Time::Now(), 10);
+  InsertIntoIndexFileReturn(kHash2, base::Time::Now(), 20);
+  ReturnIndexFile();
+
+  index()->UpdateEntrySize(kHash1, 15);
+  index()->Remove(kHash2);
+  index()->Insert(kHash3);
+  index()->Remove(kHash3);
+  index()->WriteToDisk();
+  EXPECT_EQ(1, index_file_->disk_writes());
+  EXPECT_EQ(0, index_file_->full_disk_writes());
+  SimpleIndex::EntrySet entry_set;
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  ASSERT_EQ(1u, entry_set.size());
+  EXPECT_EQ(kHash1, entry_set.begin()->first);
+  EXPECT_EQ(15, entry_set.begin()->second.GetEntrySize());
+  SimpleIndex::HashList removed_hashes =
+      index_file_->disk_write_removed_hashes();
+  std::sort(removed_hashes.begin(), removed_hashes.end());
+  SimpleIndex::HashList expected_removed_hashes;
+  expected_removed_hashes.push_back(kHash2);
+  expected_removed_hashes.push_back(kHash3);
+  std::sort(expected_removed_hashes.begin(), expected_removed_hashes.end());
+  EXPECT_EQ(expected_removed_hashes, removed_hashes);
+
+  // Nothing changed since.
+  index()->WriteToDisk();
+  EXPECT_EQ(2, index_file_->disk_writes());
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  EXPECT_TRUE(entry_set.empty());
+  EXPECT_TRUE(index_file_->disk_write_removed_hashes().empty());
+}
+
+// An index that had to be recovered is written in full once, and then only
+// with its changes.
+TEST_F(SimpleIndexTest, DiskWriteFullAfterRecovery) {
+  index()->SetMaxSize(1000);
+  const uint64 kHash1 = hashes_.at<1>();
+  const uint64 kHash2 = hashes_.at<2>();
+  InsertIntoIndexFileReturn(kHash1, base::Time::Now(), 10);
+  InsertIntoIndexFileReturn(kHash2, base::Time::Now(), 20);
+  index_file_->load_result()->flush_required = true;
+  ReturnIndexFile();
+
+  EXPECT_EQ(1, index_file_->full_disk_writes());
+  SimpleIndex::EntrySet entry_set;
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  EXPECT_EQ(2u, entry_set.size());
+
+  index()->UpdateEntrySize(kHash2, 25);
+  index()->WriteToDisk();
+  EXPECT_EQ(2, index_file_->disk_writes());
+  EXPECT_EQ(1, index_file_->full_disk_writes());
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  ASSERT_EQ(1u, entry_set.size());
+  EXPECT_EQ(kHash2, entry_set.begin()->first);
+}
+
 TEST_F(SimpleIndexTest, DiskWritePostponed) {
   index()->SetMaxSize(1000);
   ReturnIndexFile();
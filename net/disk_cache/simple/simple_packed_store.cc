@@ -0,0 +1,478 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_packed_store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/file_enumerator.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "third_party/zlib/zlib.h"
+
+namespace disk_cache {
+
+namespace {
+
+const uint32 kSegmentVersion = 1;
+
+const char kSegmentFilePattern[] = "segment-*";
+const char kSegmentFilePrefix[] = "segment-";
+
+struct SegmentHeader {
+  uint64 magic_number;
+  uint32 version;
+  uint32 reserved;
+};
+COMPILE_ASSERT(sizeof(SegmentHeader) == 16, segment_header_size);
+
+enum RecordFlags {
+  FLAG_REMOVED = 1 << 0,
+};
+
+// A record is this header followed by the key, stream 0 and stream 1.
+struct RecordHeader {
+  uint64 magic_number;
+  uint64 entry_hash;
+  int64 last_modified;
+  uint32 key_length;
+  int32 stream_0_size;
+  int32 stream_1_size;
+  // Written in place when the record is removed, so it is not covered by
+  // |crc|.
+  uint32 flags;
+  // Of the record, with |flags| and |crc| set to zero.
+  uint32 crc;
+  uint32 reserved;
+};
+COMPILE_ASSERT(sizeof(RecordHeader) == 48, record_header_size);
+
+uint32 GetRecordCrc(const char* record, size_t record_size) {
+  RecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  header.flags = 0;
+  header.crc = 0;
+  uint32 crc = crc32(0, Z_NULL, 0);
+  crc = crc32(crc, reinterpret_cast<const Bytef*>(&header), sizeof(header));
+  return crc32(crc,
+               reinterpret_cast<const Bytef*>(record + sizeof(header)),
+               record_size - sizeof(header));
+}
+
+// Returns the size of the valid record at the start of the |available| bytes
+// of |data|, or 0 if there is none.
+size_t CheckRecord(const char* data, size_t available, RecordHeader* header) {
+  if (available < sizeof(*header))
+    return 0;
+  std::memcpy(header, data, sizeof(*header));
+  if (header->magic_number != kSimplePackedRecordMagicNumber ||
+      header->stream_0_size < 0 || header->stream_1_size < 0) {
+    return 0;
+  }
+  const size_t record_size = sizeof(*header) + header->key_length +
+                             header->stream_0_size + header->stream_1_size;
+  if (record_size > available ||
+      record_size >
+          sizeof(*header) + SimplePackedStore::kMaxPackedEntrySize) {
+    return 0;
+  }
+  if (GetRecordCrc(data, record_size) != header->crc)
+    return 0;
+  return record_size;
+}
+
+std::string MakeRecord(uint64 entry_hash,
+                       const std::string& key,
+                       const char* stream_0,
+                       int stream_0_size,
+                       const char* stream_1,
+                       int stream_1_size,
+                       base::Time last_modified) {
+  RecordHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic_number = kSimplePackedRecordMagicNumber;
+  header.entry_hash = entry_hash;
+  header.last_modified = last_modified.ToInternalValue();
+  header.key_length = key.size();
+  header.stream_0_size = stream_0_size;
+  header.stream_1_size = stream_1_size;
+
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(key);
+  record.append(stream_0, stream_0_size);
+  record.append(stream_1, stream_1_size);
+  header.crc = GetRecordCrc(record.data(), record.size());
+  std::memcpy(&record[0], &header, sizeof(header));
+  return record;
+}
+
+}  // namespace
+
+const char SimplePackedStore::kDirectoryName[] = "packed-dir";
+
+const int SimplePackedStore::kMaxPackedEntrySize = 4 * 1024;
+
+const int64 SimplePackedStore::kMaxSegmentSize = 4 * 1024 * 1024;
+
+SimplePackedStore::Segment::Segment() : size(0), live_bytes(0) {
+}
+
+SimplePackedStore::Segment::~Segment() {
+}
+
+SimplePackedStore::SimplePackedStore(const base::FilePath& cache_path)
+    : directory_(cache_path.AppendASCII(kDirectoryName)),
+      initialized_(false) {
+}
+
+// static
+bool SimplePackedStore::DeleteStore(const base::FilePath& cache_path) {
+  return base::DeleteFile(cache_path.AppendASCII(kDirectoryName), true);
+}
+
+// static
+bool SimplePackedStore::CanPack(const std::string& key,
+                                int stream_0_size,
+                                int stream_1_size) {
+  return static_cast<int64>(key.size()) + stream_0_size + stream_1_size <=
+         kMaxPackedEntrySize;
+}
+
+bool SimplePackedStore::Has(uint64 entry_hash) {
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+  return locations_.count(entry_hash) != 0;
+}
+
+bool SimplePackedStore::Get(uint64 entry_hash,
+                            std::string* out_key,
+                            std::string* out_stream_0,
+                            std::string* out_stream_1,
+                            base::Time* out_last_modified) {
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+  LocationMap::const_iterator it = locations_.find(entry_hash);
+  if (it == locations_.end())
+    return false;
+
+  const Location location = it->second;
+  std::string record;
+  if (!ReadRecord(entry_hash, location, &record)) {
+    LOG(WARNING) << "Corrupt packed entry.";
+    RemoveLocked(entry_hash);
+    MaybeCompact(location.segment_id);
+    return false;
+  }
+
+  RecordHeader header;
+  std::memcpy(&header, record.data(), sizeof(header));
+  size_t offset = sizeof(header);
+  out_key->assign(record, offset, header.key_length);
+  offset += header.key_length;
+  out_stream_0->assign(record, offset, header.stream_0_size);
+  offset += header.stream_0_size;
+  out_stream_1->assign(record, offset, header.stream_1_size);
+  *out_last_modified = location.last_modified;
+  return true;
+}
+
+bool SimplePackedStore::Put(uint64 entry_hash,
+                            const std::string& key,
+                            const char* stream_0,
+                            int stream_0_size,
+                            const char* stream_1,
+                            int stream_1_size) {
+  DCHECK(CanPack(key, stream_0_size, stream_1_size));
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+
+  // The previous version is removed only once the new one is written, so that
+  // a crash in between leaves one of them. The segments are loaded in order,
+  // and the later record wins.
+  LocationMap::const_iterator it = locations_.find(entry_hash);
+  const bool had_previous = it != locations_.end();
+  Location previous;
+  if (had_previous)
+    previous = it->second;
+
+  const base::Time now = base::Time::Now();
+  const bool appended = AppendRecord(
+      entry_hash,
+      MakeRecord(entry_hash, key, stream_0, stream_0_size, stream_1,
+                 stream_1_size, now),
+      now);
+  if (had_previous) {
+    if (!appended)
+      locations_.erase(entry_hash);
+    FlagRemoved(previous);
+    MaybeCompact(previous.segment_id);
+  }
+  return appended;
+}
+
+void SimplePackedStore::Remove(uint64 entry_hash) {
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+  LocationMap::const_iterator it = locations_.find(entry_hash);
+  if (it == locations_.end())
+    return;
+  const uint32 segment_id = it->second.segment_id;
+  RemoveLocked(entry_hash);
+  MaybeCompact(segment_id);
+}
+
+void SimplePackedStore::GetEntries(SimpleIndex::EntrySet* entries) {
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+  for (LocationMap::const_iterator it = locations_.begin();
+       it != locations_.end(); ++it) {
+    if (entries->count(it->first))
+      continue;
+    SimpleIndex::InsertInEntrySet(
+        it->first,
+        EntryMetadata(it->second.last_modified, it->second.size),
+        entries);
+  }
+}
+
+size_t SimplePackedStore::GetSegmentCountForTesting() {
+  base::AutoLock auto_lock(lock_);
+  EnsureInitialized();
+  return segments_.size();
+}
+
+SimplePackedStore::~SimplePackedStore() {
+}
+
+void SimplePackedStore::EnsureInitialized() {
+  lock_.AssertAcquired();
+  if (initialized_)
+    return;
+  initialized_ = true;
+
+  std::vector<uint32> segment_ids;
+  base::FileEnumerator enumerator(directory_, false,
+                                  base::FileEnumerator::FILES,
+                                  kSegmentFilePattern);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    const std::string name = path.BaseName().MaybeAsASCII();
+    unsigned segment_id;
+    if (!StartsWithASCII(name, kSegmentFilePrefix, true) ||
+        !base::StringToUint(name.substr(arraysize(kSegmentFilePrefix) - 1),
+                            &segment_id)) {
+      continue;
+    }
+    segment_ids.push_back(segment_id);
+  }
+  std::sort(segment_ids.begin(), segment_ids.end());
+
+  for (size_t i = 0; i < segment_ids.size(); ++i) {
+    if (!LoadSegment(segment_ids[i])) {
+      LOG(WARNING) << "Could not load packed segment " << segment_ids[i];
+      base::DeleteFile(GetSegmentPath(segment_ids[i]), false);
+    }
+  }
+}
+
+bool SimplePackedStore::LoadSegment(uint32 segment_id) {
+  linked_ptr<Segment> segment(new Segment());
+  segment->file.Initialize(
+      GetSegmentPath(segment_id),
+      base::File::FLAG_OPEN | base::File::FLAG_READ | base::File::FLAG_WRITE);
+  if (!segment->file.IsValid())
+    return false;
+
+  const int64 length = segment->file.GetLength();
+  if (length < static_cast<int64>(sizeof(SegmentHeader)) ||
+      length > kMaxSegmentSize + static_cast<int64>(sizeof(RecordHeader)) +
+                   kMaxPackedEntrySize) {
+    return false;
+  }
+  std::string contents(length, '\0');
+  if (segment->file.Read(0, &contents[0], length) != length)
+    return false;
+
+  SegmentHeader segment_header;
+  std::memcpy(&segment_header, contents.data(), sizeof(segment_header));
+  if (segment_header.magic_number != kSimplePackedSegmentMagicNumber ||
+      segment_header.version != kSegmentVersion) {
+    return false;
+  }
+
+  segments_[segment_id] = segment;
+  size_t offset = sizeof(segment_header);
+  while (offset < contents.size()) {
+    RecordHeader header;
+    const size_t record_size = CheckRecord(
+        contents.data() + offset, contents.size() - offset, &header);
+    if (!record_size) {
+      LOG(WARNING) << "Truncating torn packed segment " << segment_id;
+      segment->file.SetLength(offset);
+      break;
+    }
+    if (!(header.flags & FLAG_REMOVED)) {
+      // Only the last copy of an entry is live.
+      if (locations_.count(header.entry_hash))
+        RemoveLocked(header.entry_hash);
+      Location location;
+      location.segment_id = segment_id;
+      location.offset = offset;
+      location.size = record_size;
+      location.last_modified =
+          base::Time::FromInternalValue(header.last_modified);
+      locations_[header.entry_hash] = location;
+      segment->live_bytes += record_size;
+    }
+    offset += record_size;
+  }
+  segment->size = offset;
+  return true;
+}
+
+SimplePackedStore::Segment* SimplePackedStore::GetSegmentForAppend(
+    size_t record_size,
+    uint32* out_segment_id) {
+  if (!segments_.empty()) {
+    SegmentMap::reverse_iterator newest = segments_.rbegin();
+    if (newest->second->size + static_cast<int64>(record_size) <=
+        kMaxSegmentSize) {
+      *out_segment_id = newest->first;
+      return newest->second.get();
+    }
+  }
+
+  const uint32 segment_id =
+      segments_.empty() ? 0 : segments_.rbegin()->first + 1;
+  if (!base::CreateDirectory(directory_))
+    return NULL;
+  linked_ptr<Segment> segment(new Segment());
+  segment->file.Initialize(GetSegmentPath(segment_id),
+                           base::File::FLAG_CREATE_ALWAYS |
+                               base::File::FLAG_READ |
+                               base::File::FLAG_WRITE);
+  if (!segment->file.IsValid())
+    return NULL;
+  SegmentHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic_number = kSimplePackedSegmentMagicNumber;
+  header.version = kSegmentVersion;
+  if (segment->file.Write(0, reinterpret_cast<const char*>(&header),
+                          sizeof(header)) != sizeof(header)) {
+    segment->file.Close();
+    base::DeleteFile(GetSegmentPath(segment_id), false);
+    return NULL;
+  }
+  segment->size = sizeof(header);
+  segments_[segment_id] = segment;
+  *out_segment_id = segment_id;
+  return segment.get();
+}
+
+bool SimplePackedStore::AppendRecord(uint64 entry_hash,
+                                     const std::string& record,
+                                     base::Time last_modified) {
+  uint32 segment_id;
+  Segment* segment = GetSegmentForAppend(record.size(), &segment_id);
+  if (!segment)
+    return false;
+  // A failed write leaves at most a torn record at the end of the segment,
+  // which the next append overwrites.
+  if (segment->file.Write(segment->size, record.data(), record.size()) !=
+      static_cast<int>(record.size())) {
+    return false;
+  }
+  Location location;
+  location.segment_id = segment_id;
+  location.offset = segment->size;
+  location.size = record.size();
+  location.last_modified = last_modified;
+  locations_[entry_hash] = location;
+  segment->size += record.size();
+  segment->live_bytes += record.size();
+  return true;
+}
+
+bool SimplePackedStore::ReadRecord(uint64 entry_hash,
+                                   const Location& location,
+                                   std::string* out_record) {
+  SegmentMap::const_iterator it = segments_.find(location.segment_id);
+  if (it == segments_.end())
+    return false;
+  out_record->resize(location.size);
+  if (it->second->file.Read(location.offset, &(*out_record)[0],
+                            location.size) !=
+      static_cast<int>(location.size)) {
+    return false;
+  }
+  RecordHeader header;
+  return CheckRecord(out_record->data(), out_record->size(), &header) ==
+             location.size &&
+         header.entry_hash == entry_hash && !(header.flags & FLAG_REMOVED);
+}
+
+void SimplePackedStore::FlagRemoved(const Location& location) {
+  SegmentMap::const_iterator it = segments_.find(location.segment_id);
+  if (it == segments_.end())
+    return;
+  Segment* segment = it->second.get();
+  const uint32 flags = FLAG_REMOVED;
+  if (segment->file.Write(location.offset + offsetof(RecordHeader, flags),
+                          reinterpret_cast<const char*>(&flags),
+                          sizeof(flags)) != sizeof(flags)) {
+    LOG(WARNING) << "Could not remove packed entry.";
+  }
+  segment->live_bytes -= location.size;
+}
+
+void SimplePackedStore::RemoveLocked(uint64 entry_hash) {
+  LocationMap::iterator it = locations_.find(entry_hash);
+  DCHECK(it != locations_.end());
+  FlagRemoved(it->second);
+  locations_.erase(it);
+}
+
+void SimplePackedStore::MaybeCompact(uint32 segment_id) {
+  SegmentMap::iterator it = segments_.find(segment_id);
+  // The newest segment is still being filled.
+  if (it == segments_.end() || segment_id == segments_.rbegin()->first)
+    return;
+  Segment* segment = it->second.get();
+  if (segment->live_bytes * 2 >= segment->size)
+    return;
+
+  std::vector<uint64> entry_hashes;
+  for (LocationMap::const_iterator location_it = locations_.begin();
+       location_it != locations_.end(); ++location_it) {
+    if (location_it->second.segment_id == segment_id)
+      entry_hashes.push_back(location_it->first);
+  }
+  for (size_t i = 0; i < entry_hashes.size(); ++i) {
+    const Location location = locations_[entry_hashes[i]];
+    std::string record;
+    // The copy lands in a newer segment, so it wins over the original if the
+    // segment cannot be deleted.
+    if (!ReadRecord(entry_hashes[i], location, &record) ||
+        !AppendRecord(entry_hashes[i], record, location.last_modified)) {
+      locations_.erase(entry_hashes[i]);
+    }
+  }
+
+  segment->file.Close();
+  base::DeleteFile(GetSegmentPath(segment_id), false);
+  segments_.erase(it);
+}
+
+base::FilePath SimplePackedStore::GetSegmentPath(uint32 segment_id) const {
+  return directory_.AppendASCII(
+      base::StringPrintf("%s%u", kSegmentFilePrefix, segment_id));
+}
+
+}  // namespace disk_cache
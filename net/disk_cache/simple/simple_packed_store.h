@@ -0,0 +1,163 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
+#define NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/simple/simple_index.h"
+
+namespace disk_cache {
+
+const uint64 kSimplePackedSegmentMagicNumber = GG_UINT64_C(0x7e8a16c05bd2f439);
+const uint64 kSimplePackedRecordMagicNumber = GG_UINT64_C(0x3f52c9a4e71b0d86);
+
+// Stores small entries of the simple cache packed together in a few segment
+// files, instead of in files of their own, so that a cache of favicons and
+// tiny responses does not cost an inode and a directory entry per entry.
+//
+// A packed entry is a record holding its key, stream 0 and stream 1; entries
+// with a stream 2 or sparse data are never packed. Records are appended to
+// the newest segment, and a new segment is started when it is full. Removing
+// an entry flags its record in place. Once less than half of an older
+// segment is live, its live records are copied to the newest segment and the
+// segment file is deleted.
+//
+// The location of every record is kept in memory. It is rebuilt from the
+// segment files the first time the store is used, which also truncates a
+// record torn by a crash.
+//
+// All methods perform blocking IO and may be called from any worker thread.
+class NET_EXPORT_PRIVATE SimplePackedStore
+    : public base::RefCountedThreadSafe<SimplePackedStore> {
+ public:
+  // The subdirectory of the cache directory holding the segment files.
+  static const char kDirectoryName[];
+
+  // Entries whose key and streams take more than this are not packed.
+  static const int kMaxPackedEntrySize;
+
+  // A new segment is started when the newest one reaches this size.
+  static const int64 kMaxSegmentSize;
+
+  explicit SimplePackedStore(const base::FilePath& cache_path);
+
+  // Deletes the packed entries of the cache in |cache_path|.
+  static bool DeleteStore(const base::FilePath& cache_path);
+
+  // Returns true if the entry is small enough to be packed.
+  static bool CanPack(const std::string& key,
+                      int stream_0_size,
+                      int stream_1_size);
+
+  bool Has(uint64 entry_hash);
+
+  // Reads the entry |entry_hash| into the out parameters, with the time it
+  // was stored in |out_last_modified|. Returns false if there is no such
+  // entry, or if its record is corrupt, in which case it is removed.
+  bool Get(uint64 entry_hash,
+           std::string* out_key,
+           std::string* out_stream_0,
+           std::string* out_stream_1,
+           base::Time* out_last_modified);
+
+  // Stores the entry |entry_hash|, replacing any previous version. Returns
+  // false on IO failure, in which case the entry is not in the store anymore.
+  bool Put(uint64 entry_hash,
+           const std::string& key,
+           const char* stream_0,
+           int stream_0_size,
+           const char* stream_1,
+           int stream_1_size);
+
+  // Removes the entry |entry_hash|, if it is in the store.
+  void Remove(uint64 entry_hash);
+
+  // Adds all the packed entries to |entries|, with the size of their record
+  // and the time they were stored.
+  void GetEntries(SimpleIndex::EntrySet* entries);
+
+  // Returns the number of segment files, for tests.
+  size_t GetSegmentCountForTesting();
+
+ private:
+  friend class base::RefCountedThreadSafe<SimplePackedStore>;
+
+  struct Location {
+    uint32 segment_id;
+    uint32 offset;
+    uint32 size;
+    base::Time last_modified;
+  };
+
+  struct Segment {
+    Segment();
+    ~Segment();
+
+    base::File file;
+    int64 size;
+    int64 live_bytes;
+  };
+
+  typedef base::hash_map<uint64, Location> LocationMap;
+  typedef std::map<uint32, linked_ptr<Segment> > SegmentMap;
+
+  ~SimplePackedStore();
+
+  // Reads the segment files, the first time the store is used.
+  void EnsureInitialized();
+
+  // Indexes the records of the segment |segment_id|. Returns false if it
+  // cannot be read.
+  bool LoadSegment(uint32 segment_id);
+
+  // Returns the newest segment, starting a new one if there is none or if it
+  // cannot take |record_size| more bytes. Returns NULL on IO failure.
+  Segment* GetSegmentForAppend(size_t record_size, uint32* out_segment_id);
+
+  // Appends |record| to the newest segment and records its location.
+  bool AppendRecord(uint64 entry_hash,
+                    const std::string& record,
+                    base::Time last_modified);
+
+  // Reads the record at |location| into |out_record|, checking its contents.
+  bool ReadRecord(uint64 entry_hash,
+                  const Location& location,
+                  std::string* out_record);
+
+  // Flags the record at |location| as removed on disk.
+  void FlagRemoved(const Location& location);
+
+  // Flags the record of |entry_hash| as removed and forgets it.
+  void RemoveLocked(uint64 entry_hash);
+
+  // Compacts the segment |segment_id| if less than half of it is live.
+  void MaybeCompact(uint32 segment_id);
+
+  base::FilePath GetSegmentPath(uint32 segment_id) const;
+
+  const base::FilePath directory_;
+
+  base::Lock lock_;
+  bool initialized_;
+  LocationMap locations_;
+  SegmentMap segments_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimplePackedStore);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_SIMPLE_SIMPLE_PACKED_STORE_H_
@@ -0,0 +1,205 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/simple/simple_packed_store.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "net/disk_cache/simple/simple_index.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+class SimplePackedStoreTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    Reopen();
+  }
+
+  // Drops the in-memory state, so that the next call reads the segments.
+  void Reopen() {
+    store_ = new SimplePackedStore(temp_dir_.path());
+  }
+
+  base::FilePath segment_path(int segment_id) const {
+    return temp_dir_.path()
+        .AppendASCII(SimplePackedStore::kDirectoryName)
+        .AppendASCII("segment-" + base::IntToString(segment_id));
+  }
+
+  bool Put(uint64 entry_hash,
+           const std::string& key,
+           const std::string& stream_0,
+           const std::string& stream_1) {
+    return store_->Put(entry_hash, key, stream_0.data(), stream_0.size(),
+                       stream_1.data(), stream_1.size());
+  }
+
+  void ExpectEntry(uint64 entry_hash,
+                   const std::string& key,
+                   const std::string& stream_0,
+                   const std::string& stream_1) {
+    std::string read_key;
+    std::string read_stream_0;
+    std::string read_stream_1;
+    base::Time last_modified;
+    ASSERT_TRUE(store_->Get(entry_hash, &read_key, &read_stream_0,
+                            &read_stream_1, &last_modified));
+    EXPECT_EQ(key, read_key);
+    EXPECT_EQ(stream_0, read_stream_0);
+    EXPECT_EQ(stream_1, read_stream_1);
+  }
+
+  bool Get(uint64 entry_hash) {
+    std::string key;
+    std::string stream_0;
+    std::string stream_1;
+    base::Time last_modified;
+    return store_->Get(entry_hash, &key, &stream_0, &stream_1,
+                       &last_modified);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  scoped_refptr<SimplePackedStore> store_;
+};
+
+TEST_F(SimplePackedStoreTest, CanPack) {
+  const int max_size = SimplePackedStore::kMaxPackedEntrySize;
+  EXPECT_TRUE(SimplePackedStore::CanPack("key", 0, 0));
+  EXPECT_TRUE(SimplePackedStore::CanPack("key", 100, max_size - 103));
+  EXPECT_FALSE(SimplePackedStore::CanPack("key", 100, max_size - 102));
+}
+
+TEST_F(SimplePackedStoreTest, PutGetRemove) {
+  EXPECT_FALSE(store_->Has(1));
+  EXPECT_FALSE(Get(1));
+
+  ASSERT_TRUE(Put(1, "key one", "headers", "body"));
+  ASSERT_TRUE(Put(2, "key two", "", ""));
+  EXPECT_TRUE(store_->Has(1));
+  EXPECT_TRUE(store_->Has(2));
+  ExpectEntry(1, "key one", "headers", "body");
+  ExpectEntry(2, "key two", "", "");
+
+  store_->Remove(1);
+  EXPECT_FALSE(store_->Has(1));
+  EXPECT_FALSE(Get(1));
+  ExpectEntry(2, "key two", "", "");
+  EXPECT_EQ(1U, store_->GetSegmentCountForTesting());
+}
+
+TEST_F(SimplePackedStoreTest, Replace) {
+  ASSERT_TRUE(Put(1, "key", "old headers", "old body"));
+  ASSERT_TRUE(Put(1, "key", "new headers", "new body"));
+  ExpectEntry(1, "key", "new headers", "new body");
+
+  Reopen();
+  ExpectEntry(1, "key", "new headers", "new body");
+  SimpleIndex::EntrySet entries;
+  store_->GetEntries(&entries);
+  EXPECT_EQ(1U, entries.size());
+}
+
+TEST_F(SimplePackedStoreTest, Reload) {
+  ASSERT_TRUE(Put(1, "key one", "headers one", "body one"));
+  ASSERT_TRUE(Put(2, "key two", "headers two", "body two"));
+  ASSERT_TRUE(Put(3, "key three", "headers three", "body three"));
+  store_->Remove(2);
+
+  Reopen();
+  ExpectEntry(1, "key one", "headers one", "body one");
+  EXPECT_FALSE(store_->Has(2));
+  ExpectEntry(3, "key three", "headers three", "body three");
+
+  SimpleIndex::EntrySet entries;
+  store_->GetEntries(&entries);
+  EXPECT_EQ(2U, entries.size());
+  EXPECT_EQ(1U, entries.count(1));
+  EXPECT_EQ(1U, entries.count(3));
+}
+
+TEST_F(SimplePackedStoreTest, TornRecord) {
+  ASSERT_TRUE(Put(1, "key one", "headers one", "body one"));
+  ASSERT_TRUE(Put(2, "key two", "headers two", "body two"));
+
+  int64 segment_size;
+  ASSERT_TRUE(base::GetFileSize(segment_path(0), &segment_size));
+  base::File segment(segment_path(0),
+                     base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_TRUE(segment.SetLength(segment_size - 3));
+  segment.Close();
+
+  Reopen();
+  ExpectEntry(1, "key one", "headers one", "body one");
+  EXPECT_FALSE(store_->Has(2));
+
+  // The torn record was truncated, so new records are readable after reload.
+  ASSERT_TRUE(Put(3, "key three", "headers three", "body three"));
+  Reopen();
+  ExpectEntry(1, "key one", "headers one", "body one");
+  ExpectEntry(3, "key three", "headers three", "body three");
+}
+
+TEST_F(SimplePackedStoreTest, CorruptRecord) {
+  ASSERT_TRUE(Put(1, "key", "headers", "body"));
+  int64 segment_size;
+  ASSERT_TRUE(base::GetFileSize(segment_path(0), &segment_size));
+  base::File segment(segment_path(0),
+                     base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  ASSERT_EQ(1, segment.Write(segment_size - 1, "X", 1));
+  segment.Close();
+
+  EXPECT_TRUE(store_->Has(1));
+  EXPECT_FALSE(Get(1));
+  EXPECT_FALSE(store_->Has(1));
+}
+
+TEST_F(SimplePackedStoreTest, Compaction) {
+  const std::string body(SimplePackedStore::kMaxPackedEntrySize - 100, 'x');
+  const int64 record_count =
+      SimplePackedStore::kMaxSegmentSize / static_cast<int64>(body.size());
+
+  // Fill a bit more than two segments.
+  for (int64 i = 0; i < 2 * record_count + 2; ++i)
+    ASSERT_TRUE(Put(i, base::Int64ToString(i), "", body));
+  ASSERT_EQ(3U, store_->GetSegmentCountForTesting());
+
+  // Removing most of the first segment moves the rest to the newest one.
+  for (int64 i = 1; i < record_count / 2 + 2; ++i)
+    store_->Remove(i);
+  EXPECT_EQ(2U, store_->GetSegmentCountForTesting());
+  EXPECT_FALSE(base::PathExists(segment_path(0)));
+  ExpectEntry(0, "0", "", body);
+  ExpectEntry(record_count, base::Int64ToString(record_count), "", body);
+
+  Reopen();
+  EXPECT_EQ(2U, store_->GetSegmentCountForTesting());
+  ExpectEntry(0, "0", "", body);
+  EXPECT_FALSE(store_->Has(1));
+  SimpleIndex::EntrySet entries;
+  store_->GetEntries(&entries);
+  EXPECT_EQ(static_cast<size_t>(2 * record_count + 2 - (record_count / 2 + 1)),
+            entries.size());
+}
+
+TEST_F(SimplePackedStoreTest, DeleteStore) {
+  ASSERT_TRUE(Put(1, "key", "headers", "body"));
+  EXPECT_TRUE(SimplePackedStore::DeleteStore(temp_dir_.path()));
+  Reopen();
+  EXPECT_FALSE(store_->Has(1));
+  EXPECT_EQ(0U, store_->GetSegmentCountForTesting());
+}
+
+}  // namespace
+
+}  // namespace disk_cache
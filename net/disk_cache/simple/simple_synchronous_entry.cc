@@ -6,7 +6,6 @@
 
 #include <algorithm>
 #include <cstring>
-#include <functional>
 #include <limits>
 
 #include "base/basictypes.h"
@@ -16,13 +15,21 @@
 #include "base/location.h"
 #include "base/sha1.h"
 #include "base/strings/stringprintf.h"
+#include "build/build_config.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/simple/simple_backend_version.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
+#include "net/disk_cache/simple/simple_packed_store.h"
 #include "net/disk_cache/simple/simple_util.h"
 #include "third_party/zlib/zlib.h"
 
+#if defined(OS_LINUX)
+#include <sys/uio.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
 using base::File;
 using base::FilePath;
 using base::Time;
@@ -52,6 +59,7 @@ enum WriteResult {
   WRITE_RESULT_LAZY_STREAM_ENTRY_DOOMED,
   WRITE_RESULT_LAZY_CREATE_FAILURE,
   WRITE_RESULT_LAZY_INITIALIZE_FAILURE,
+  WRITE_RESULT_UNPACK_FAILURE,
   WRITE_RESULT_MAX,
 };
 
@@ -109,6 +117,79 @@ bool CanOmitEmptyFile(int file_index) {
   return file_index == disk_cache::simple_util::GetFileIndexFromStreamIndex(2);
 }
 
+void FillEOFRecord(int32 stream_size,
+                   const disk_cache::SimpleSynchronousEntry::CRCRecord& crc,
+                   disk_cache::SimpleFileEOF* eof_record) {
+  eof_record->stream_size = stream_size;
+  eof_record->final_magic_number = disk_cache::kSimpleFinalMagicNumber;
+  eof_record->flags = 0;
+  if (crc.has_crc32)
+    eof_record->flags |= disk_cache::SimpleFileEOF::FLAG_HAS_CRC32;
+  eof_record->data_crc32 = crc.data_crc32;
+}
+
+struct WriteBuffer {
+  WriteBuffer() : data(NULL), size(0) {}
+  WriteBuffer(const char* data_p, int size_p) : data(data_p), size(size_p) {}
+
+  const char* data;
+  int size;
+};
+
+const int kMaxWriteBuffers = 4;
+
+// Writes the |count| buffers of |buffers| back to back at |offset| in |file|,
+// with a single system call where the platform has one. Returns true if all of
+// them were written.
+bool WriteBuffers(File* file,
+                  int64 offset,
+                  const WriteBuffer* buffers,
+                  int count) {
+  DCHECK_GE(kMaxWriteBuffers, count);
+#if defined(OS_LINUX)
+  struct iovec iov[kMaxWriteBuffers];
+  int iov_count = 0;
+  for (int i = 0; i < count; ++i) {
+    if (buffers[i].size == 0)
+      continue;
+    iov[iov_count].iov_base = const_cast<char*>(buffers[i].data);
+    iov[iov_count].iov_len = buffers[i].size;
+    ++iov_count;
+  }
+  struct iovec* next = iov;
+  while (iov_count > 0) {
+    ssize_t bytes_written = HANDLE_EINTR(
+        pwritev(file->GetPlatformFile(), next, iov_count, offset));
+    if (bytes_written <= 0)
+      return false;
+    offset += bytes_written;
+    // Skip what was written, and resume a short write where it stopped.
+    while (iov_count > 0 &&
+           static_cast<size_t>(bytes_written) >= next->iov_len) {
+      bytes_written -= next->iov_len;
+      ++next;
+      --iov_count;
+    }
+    if (iov_count > 0) {
+      next->iov_base = static_cast<char*>(next->iov_base) + bytes_written;
+      next->iov_len -= bytes_written;
+    }
+  }
+  return true;
+#else
+  for (int i = 0; i < count; ++i) {
+    if (buffers[i].size == 0)
+      continue;
+    if (file->Write(offset, buffers[i].data, buffers[i].size) !=
+        buffers[i].size) {
+      return false;
+    }
+    offset += buffers[i].size;
+  }
+  return true;
+#endif
+}
+
 }  // namespace
 
 namespace disk_cache {
@@ -188,7 +269,9 @@ SimpleSynchronousEntry::EntryOperationData::EntryOperationData(int index_p,
                                                                int buf_len_p)
     : index(index_p),
       offset(offset_p),
-      buf_len(buf_len_p) {}
+      buf_len(buf_len_p),
+      truncate(false),
+      doomed(false) {}
 
 SimpleSynchronousEntry::EntryOperationData::EntryOperationData(int index_p,
                                                                int offset_p,
@@ -205,17 +288,20 @@ SimpleSynchronousEntry::EntryOperationData::EntryOperationData(
     int64 sparse_offset_p,
     int buf_len_p)
     : sparse_offset(sparse_offset_p),
-      buf_len(buf_len_p) {}
+      buf_len(buf_len_p),
+      truncate(false),
+      doomed(false) {}
 
 // static
 void SimpleSynchronousEntry::OpenEntry(
     net::CacheType cache_type,
     const FilePath& path,
+    SimplePackedStore* packed_store,
     const uint64 entry_hash,
     bool had_index,
     SimpleEntryCreationResults *out_results) {
-  SimpleSynchronousEntry* sync_entry =
-      new SimpleSynchronousEntry(cache_type, path, "", entry_hash);
+  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(
+      cache_type, path, packed_store, "", entry_hash);
   out_results->result =
       sync_entry->InitializeForOpen(had_index,
                                     &out_results->entry_stat,
@@ -235,13 +321,14 @@ void SimpleSynchronousEntry::OpenEntry(
 void SimpleSynchronousEntry::CreateEntry(
     net::CacheType cache_type,
     const FilePath& path,
+    SimplePackedStore* packed_store,
     const std::string& key,
     const uint64 entry_hash,
     bool had_index,
     SimpleEntryCreationResults *out_results) {
   DCHECK_EQ(entry_hash, GetEntryHashKey(key));
-  SimpleSynchronousEntry* sync_entry =
-      new SimpleSynchronousEntry(cache_type, path, key, entry_hash);
+  SimpleSynchronousEntry* sync_entry = new SimpleSynchronousEntry(
+      cache_type, path, packed_store, key, entry_hash);
   out_results->result = sync_entry->InitializeForCreate(
       had_index, &out_results->entry_stat);
   if (out_results->result != net::OK) {
@@ -257,7 +344,10 @@ void SimpleSynchronousEntry::CreateEntry(
 // static
 int SimpleSynchronousEntry::DoomEntry(
     const FilePath& path,
+    SimplePackedStore* packed_store,
     uint64 entry_hash) {
+  if (packed_store)
+    packed_store->Remove(entry_hash);
   const bool deleted_well = DeleteFilesForEntryHash(path, entry_hash);
   return deleted_well ? net::OK : net::ERR_FAILED;
 }
@@ -265,10 +355,14 @@ int SimpleSynchronousEntry::DoomEntry(
 // static
 int SimpleSynchronousEntry::DoomEntrySet(
     const std::vector<uint64>* key_hashes,
-    const FilePath& path) {
-  const size_t did_delete_count = std::count_if(
-      key_hashes->begin(), key_hashes->end(), std::bind1st(
-          std::ptr_fun(SimpleSynchronousEntry::DeleteFilesForEntryHash), path));
+    const FilePath& path,
+    SimplePackedStore* packed_store) {
+  size_t did_delete_count = 0;
+  for (std::vector<uint64>::const_iterator it = key_hashes->begin();
+       it != key_hashes->end(); ++it) {
+    if (DoomEntry(path, packed_store, *it) == net::OK)
+      ++did_delete_count;
+  }
   return (did_delete_count == key_hashes->size()) ? net::OK : net::ERR_FAILED;
 }
 
@@ -279,12 +373,30 @@ void SimpleSynchronousEntry::ReadData(const EntryOperationData& in_entry_op,
                                       int* out_result) const {
   DCHECK(initialized_);
   DCHECK_NE(0, in_entry_op.index);
-  const int64 file_offset =
-      entry_stat->GetOffsetInFile(key_, in_entry_op.offset, in_entry_op.index);
-  int file_index = GetFileIndexFromStreamIndex(in_entry_op.index);
   // Zero-length reads and reads to the empty streams of omitted files should
   // be handled in the SimpleEntryImpl.
   DCHECK_LT(0, in_entry_op.buf_len);
+  if (packed_) {
+    // Stream 2 of a packed entry is empty.
+    DCHECK_EQ(1, in_entry_op.index);
+    const int bytes_read = std::max(
+        0, std::min(in_entry_op.buf_len,
+                    static_cast<int>(packed_stream_1_.size()) -
+                        in_entry_op.offset));
+    if (bytes_read > 0) {
+      memcpy(out_buf->data(), packed_stream_1_.data() + in_entry_op.offset,
+             bytes_read);
+      entry_stat->set_last_used(Time::Now());
+      *out_crc32 = crc32(crc32(0L, Z_NULL, 0),
+                         reinterpret_cast<const Bytef*>(out_buf->data()),
+                         bytes_read);
+    }
+    *out_result = bytes_read;
+    return;
+  }
+  const int64 file_offset =
+      entry_stat->GetOffsetInFile(key_, in_entry_op.offset, in_entry_op.index);
+  int file_index = GetFileIndexFromStreamIndex(in_entry_op.index);
   DCHECK(!empty_file_omitted_[file_index]);
   File* file = const_cast<File*>(&files_[file_index]);
   int bytes_read =
@@ -309,6 +421,25 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
                                        int* out_result) {
   DCHECK(initialized_);
   DCHECK_NE(0, in_entry_op.index);
+  if (packed_) {
+    const int offset = in_entry_op.offset;
+    const int end_offset = offset + in_entry_op.buf_len;
+    const int stream_1_size =
+        in_entry_op.truncate ? end_offset
+                             : std::max(out_entry_stat->data_size(1),
+                                        end_offset);
+    if (in_entry_op.index == 1 &&
+        SimplePackedStore::CanPack(key_, out_entry_stat->data_size(0),
+                                   stream_1_size)) {
+      WritePackedData(in_entry_op, in_buf, out_entry_stat, out_result);
+      return;
+    }
+    if (!Unpack(in_entry_op.doomed, *out_entry_stat)) {
+      RecordWriteResult(cache_type_, WRITE_RESULT_UNPACK_FAILURE);
+      *out_result = net::ERR_CACHE_WRITE_FAILURE;
+      return;
+    }
+  }
   int index = in_entry_op.index;
   int file_index = GetFileIndexFromStreamIndex(index);
   int offset = in_entry_op.offset;
@@ -460,6 +591,11 @@ void SimpleSynchronousEntry::WriteSparseData(
   int64 offset = in_entry_op.sparse_offset;
   int buf_len = in_entry_op.buf_len;
 
+  if (packed_ && !Unpack(in_entry_op.doomed, *out_entry_stat)) {
+    *out_result = net::ERR_CACHE_WRITE_FAILURE;
+    return;
+  }
+
   const char* buf = in_buf->data();
   int written_so_far = 0;
   int appended_so_far = 0;
@@ -599,6 +735,23 @@ void SimpleSynchronousEntry::CheckEOFRecord(int index,
                                             uint32 expected_crc32,
                                             int* out_result) const {
   DCHECK(initialized_);
+  if (packed_) {
+    // The record of the entry was checked when it was read.
+    DCHECK_EQ(1, index);
+    const uint32 packed_crc32 = ::crc32(
+        ::crc32(0L, Z_NULL, 0),
+        reinterpret_cast<const Bytef*>(packed_stream_1_.data()),
+        packed_stream_1_.size());
+    if (packed_crc32 != expected_crc32) {
+      *out_result = net::ERR_CACHE_CHECKSUM_MISMATCH;
+      RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_CRC_MISMATCH);
+      Doom();
+      return;
+    }
+    *out_result = net::OK;
+    RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_SUCCESS);
+    return;
+  }
   uint32 crc32;
   bool has_crc32;
   int stream_size;
@@ -621,89 +774,114 @@ void SimpleSynchronousEntry::CheckEOFRecord(int index,
 void SimpleSynchronousEntry::Close(
     const SimpleEntryStat& entry_stat,
     scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
-    net::GrowableIOBuffer* stream_0_data) {
+    net::GrowableIOBuffer* stream_0_data,
+    bool doomed) {
   DCHECK(stream_0_data);
-  // Write stream 0 data.
-  int stream_0_offset = entry_stat.GetOffsetInFile(key_, 0, 0);
-  if (files_[0].Write(stream_0_offset, stream_0_data->data(),
-                      entry_stat.data_size(0)) !=
-      entry_stat.data_size(0)) {
+  if (packed_) {
+    if (doomed || crc32s_to_write->empty()) {
+      RecordCloseResult(cache_type_, CLOSE_RESULT_SUCCESS);
+      delete this;
+      return;
+    }
+    if (SimplePackedStore::CanPack(key_, entry_stat.data_size(0),
+                                   entry_stat.data_size(1))) {
+      DCHECK_EQ(entry_stat.data_size(1),
+                static_cast<int>(packed_stream_1_.size()));
+      const bool stored = packed_store_->Put(
+          entry_hash_, key_, stream_0_data->data(), entry_stat.data_size(0),
+          packed_stream_1_.data(), packed_stream_1_.size());
+      RecordCloseResult(cache_type_, stored ? CLOSE_RESULT_SUCCESS
+                                            : CLOSE_RESULT_WRITE_FAILURE);
+      delete this;
+      return;
+    }
+    // Stream 0 outgrew the packed store.
+    if (!Unpack(doomed, entry_stat)) {
+      RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
+      delete this;
+      return;
+    }
+  }
+  if (!WriteFirstFileTail(entry_stat, NULL, 0, *crc32s_to_write,
+                          stream_0_data)) {
     RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
-    DVLOG(1) << "Could not write stream 0 data.";
+    DVLOG(1) << "Could not write stream 0 data or eof records.";
     Doom();
+    doomed = true;
   }
+  FinishClose(entry_stat, *crc32s_to_write, stream_0_data, doomed);
+}
 
+void SimpleSynchronousEntry::WriteDataAndClose(
+    const EntryOperationData& in_entry_op,
+    net::IOBuffer* in_buf,
+    SimpleEntryStat* entry_stat,
+    scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
+    net::GrowableIOBuffer* stream_0_data,
+    int* out_result) {
+  DCHECK(initialized_);
+  DCHECK(stream_0_data);
+  const int offset = in_entry_op.offset;
+  const int buf_len = in_entry_op.buf_len;
+  bool has_stream_0_eof = false;
+  bool has_stream_1_eof = false;
   for (std::vector<CRCRecord>::const_iterator it = crc32s_to_write->begin();
        it != crc32s_to_write->end(); ++it) {
-    const int stream_index = it->index;
-    const int file_index = GetFileIndexFromStreamIndex(stream_index);
-    if (empty_file_omitted_[file_index])
-      continue;
-
-    SimpleFileEOF eof_record;
-    eof_record.stream_size = entry_stat.data_size(stream_index);
-    eof_record.final_magic_number = kSimpleFinalMagicNumber;
-    eof_record.flags = 0;
-    if (it->has_crc32)
-      eof_record.flags |= SimpleFileEOF::FLAG_HAS_CRC32;
-    eof_record.data_crc32 = it->data_crc32;
-    int eof_offset = entry_stat.GetEOFOffsetInFile(key_, stream_index);
-    // If stream 0 changed size, the file needs to be resized, otherwise the
-    // next open will yield wrong stream sizes. On stream 1 and stream 2 proper
-    // resizing of the file is handled in SimpleSynchronousEntry::WriteData().
-    if (stream_index == 0 &&
-        !files_[file_index].SetLength(eof_offset)) {
-      RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
-      DVLOG(1) << "Could not truncate stream 0 file.";
-      Doom();
-      break;
-    }
-    if (files_[file_index].Write(eof_offset,
-                                 reinterpret_cast<const char*>(&eof_record),
-                                 sizeof(eof_record)) !=
-        sizeof(eof_record)) {
-      RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
-      DVLOG(1) << "Could not write eof record.";
-      Doom();
-      break;
-    }
+    if (it->index == 0)
+      has_stream_0_eof = true;
+    if (it->index == 1)
+      has_stream_1_eof = true;
   }
-  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
-    if (empty_file_omitted_[i])
-      continue;
 
-    files_[i].Close();
-    const int64 file_size = entry_stat.GetFileSize(key_, i);
-    SIMPLE_CACHE_UMA(CUSTOM_COUNTS,
-                     "LastClusterSize", cache_type_,
-                     file_size % 4096, 0, 4097, 50);
-    const int64 cluster_loss = file_size % 4096 ? 4096 - file_size % 4096 : 0;
-    SIMPLE_CACHE_UMA(PERCENTAGE,
-                     "LastClusterLossPercent", cache_type_,
-                     cluster_loss * 100 / (cluster_loss + file_size));
+  // After a write that reaches the end of stream 1, everything from the
+  // written data to the end of the first file is rewritten by the close. A
+  // write past the end of the stream is left to WriteData(), which zeroes the
+  // gap.
+  const int stream_1_size = entry_stat->data_size(1);
+  if (packed_ || in_entry_op.index != 1 || !has_stream_0_eof ||
+      !has_stream_1_eof ||
+      offset > stream_1_size ||
+      (!in_entry_op.truncate && offset + buf_len < stream_1_size)) {
+    WriteData(in_entry_op, in_buf, entry_stat, out_result);
+    if (*out_result < 0)
+      crc32s_to_write->clear();
+    Close(*entry_stat, crc32s_to_write.Pass(), stream_0_data,
+          in_entry_op.doomed);
+    return;
   }
 
-  if (sparse_file_open())
-    sparse_file_.Close();
-
-  if (files_created_) {
-    const int stream2_file_index = GetFileIndexFromStreamIndex(2);
-    SIMPLE_CACHE_UMA(BOOLEAN, "EntryCreatedAndStream2Omitted", cache_type_,
-                     empty_file_omitted_[stream2_file_index]);
+  DCHECK(!empty_file_omitted_[0]);
+  entry_stat->set_data_size(1, offset + buf_len);
+  if (!WriteFirstFileTail(*entry_stat, buf_len > 0 ? in_buf->data() : NULL,
+                          buf_len, *crc32s_to_write, stream_0_data)) {
+    RecordWriteResult(cache_type_, WRITE_RESULT_WRITE_FAILURE);
+    Doom();
+    *out_result = net::ERR_CACHE_WRITE_FAILURE;
+    crc32s_to_write->clear();
+    Close(*entry_stat, crc32s_to_write.Pass(), stream_0_data, true);
+    return;
   }
-  RecordCloseResult(cache_type_, CLOSE_RESULT_SUCCESS);
-  have_open_files_ = false;
-  delete this;
+
+  RecordWriteResult(cache_type_, WRITE_RESULT_SUCCESS);
+  base::Time modification_time = Time::Now();
+  entry_stat->set_last_used(modification_time);
+  entry_stat->set_last_modified(modification_time);
+  *out_result = buf_len;
+  FinishClose(*entry_stat, *crc32s_to_write, stream_0_data,
+              in_entry_op.doomed);
 }
 
 SimpleSynchronousEntry::SimpleSynchronousEntry(net::CacheType cache_type,
                                                const FilePath& path,
+                                               SimplePackedStore* packed_store,
                                                const std::string& key,
                                                const uint64 entry_hash)
     : cache_type_(cache_type),
       path_(path),
+      packed_store_(packed_store),
       entry_hash_(entry_hash),
       key_(key),
+      packed_(false),
       have_open_files_(false),
       initialized_(false) {
   for (int i = 0; i < kSimpleEntryFileCount; ++i)
@@ -900,6 +1078,12 @@ int SimpleSynchronousEntry::InitializeForOpen(
     scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
     uint32* out_stream_0_crc32) {
   DCHECK(!initialized_);
+  if (InitializeForOpenPacked(out_entry_stat, stream_0_data,
+                              out_stream_0_crc32)) {
+    RecordSyncOpenResult(cache_type_, OPEN_ENTRY_SUCCESS, had_index);
+    initialized_ = true;
+    return net::OK;
+  }
   if (!OpenFiles(had_index, out_entry_stat)) {
     DLOG(WARNING) << "Could not open platform files for entry.";
     return net::ERR_FAILED;
@@ -995,6 +1179,36 @@ int SimpleSynchronousEntry::InitializeForOpen(
   return net::OK;
 }
 
+bool SimpleSynchronousEntry::InitializeForOpenPacked(
+    SimpleEntryStat* out_entry_stat,
+    scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
+    uint32* out_stream_0_crc32) {
+  base::Time last_modified;
+  if (!packed_store_ ||
+      !packed_store_->Get(entry_hash_, &key_, &packed_stream_0_,
+                          &packed_stream_1_, &last_modified)) {
+    return false;
+  }
+  packed_ = true;
+  files_created_ = false;
+  out_entry_stat->set_last_used(last_modified);
+  out_entry_stat->set_last_modified(last_modified);
+  out_entry_stat->set_data_size(0, packed_stream_0_.size());
+  out_entry_stat->set_data_size(1, packed_stream_1_.size());
+  out_entry_stat->set_data_size(2, 0);
+  out_entry_stat->set_sparse_data_size(0);
+
+  *stream_0_data = new net::GrowableIOBuffer();
+  (*stream_0_data)->SetCapacity(packed_stream_0_.size());
+  memcpy((*stream_0_data)->data(), packed_stream_0_.data(),
+         packed_stream_0_.size());
+  *out_stream_0_crc32 = crc32(
+      crc32(0, Z_NULL, 0),
+      reinterpret_cast<const Bytef*>(packed_stream_0_.data()),
+      packed_stream_0_.size());
+  return true;
+}
+
 bool SimpleSynchronousEntry::InitializeCreatedFile(
     int file_index,
     CreateEntryResult* out_result) {
@@ -1026,6 +1240,25 @@ int SimpleSynchronousEntry::InitializeForCreate(
     bool had_index,
     SimpleEntryStat* out_entry_stat) {
   DCHECK(!initialized_);
+  if (packed_store_) {
+    // The entry files are only created once the entry outgrows the packed
+    // store, so a file entry with the same key must be looked for here.
+    if (packed_store_->Has(entry_hash_) ||
+        base::PathExists(GetFilenameFromFileIndex(0))) {
+      RecordSyncCreateResult(CREATE_ENTRY_PLATFORM_FILE_ERROR, had_index);
+      return net::ERR_FILE_EXISTS;
+    }
+    packed_ = true;
+    files_created_ = true;
+    base::Time creation_time = Time::Now();
+    out_entry_stat->set_last_modified(creation_time);
+    out_entry_stat->set_last_used(creation_time);
+    for (int i = 0; i < kSimpleEntryStreamCount; ++i)
+      out_entry_stat->set_data_size(i, 0);
+    RecordSyncCreateResult(CREATE_ENTRY_SUCCESS, had_index);
+    initialized_ = true;
+    return net::OK;
+  }
   if (!CreateFiles(had_index, out_entry_stat)) {
     DLOG(WARNING) << "Could not create platform files.";
     return net::ERR_FILE_EXISTS;
@@ -1129,9 +1362,230 @@ int SimpleSynchronousEntry::GetEOFRecordData(int index,
 }
 
 void SimpleSynchronousEntry::Doom() const {
+  if (packed_store_)
+    packed_store_->Remove(entry_hash_);
   DeleteFilesForEntryHash(path_, entry_hash_);
 }
 
+bool SimpleSynchronousEntry::WriteFirstFileTail(
+    const SimpleEntryStat& entry_stat,
+    const char* stream_1_tail,
+    int stream_1_tail_len,
+    const std::vector<CRCRecord>& crc32s_to_write,
+    net::GrowableIOBuffer* stream_0_data) {
+  // The first file ends with stream 1, its EOF record, stream 0 and its EOF
+  // record, so all of them can go in one write.
+  const CRCRecord* stream_0_crc = NULL;
+  const CRCRecord* stream_1_crc = NULL;
+  for (std::vector<CRCRecord>::const_iterator it = crc32s_to_write.begin();
+       it != crc32s_to_write.end(); ++it) {
+    if (it->index == 0)
+      stream_0_crc = &*it;
+    else if (it->index == 1)
+      stream_1_crc = &*it;
+  }
+  DCHECK(stream_1_crc || stream_1_tail_len == 0);
+
+  SimpleFileEOF eof_records[2];
+  WriteBuffer buffers[kMaxWriteBuffers];
+  int buffer_count = 0;
+  int64 file_offset = entry_stat.GetOffsetInFile(key_, 0, 0);
+  if (stream_1_crc) {
+    file_offset = entry_stat.GetEOFOffsetInFile(key_, 1) - stream_1_tail_len;
+    buffers[buffer_count++] = WriteBuffer(stream_1_tail, stream_1_tail_len);
+    FillEOFRecord(entry_stat.data_size(1), *stream_1_crc, &eof_records[1]);
+    buffers[buffer_count++] = WriteBuffer(
+        reinterpret_cast<const char*>(&eof_records[1]), sizeof(SimpleFileEOF));
+  }
+  buffers[buffer_count++] =
+      WriteBuffer(stream_0_data->data(), entry_stat.data_size(0));
+  if (stream_0_crc) {
+    FillEOFRecord(entry_stat.data_size(0), *stream_0_crc, &eof_records[0]);
+    buffers[buffer_count++] = WriteBuffer(
+        reinterpret_cast<const char*>(&eof_records[0]), sizeof(SimpleFileEOF));
+  }
+  if (!WriteBuffers(&files_[0], file_offset, buffers, buffer_count))
+    return false;
+
+  // If stream 0 changed size, the file needs to be resized, otherwise the
+  // next open will yield wrong stream sizes. On stream 1 and stream 2 proper
+  // resizing of the file is handled in SimpleSynchronousEntry::WriteData().
+  if (stream_0_crc) {
+    const int64 file_size =
+        entry_stat.GetEOFOffsetInFile(key_, 0) + sizeof(SimpleFileEOF);
+    if (!files_[0].SetLength(file_size))
+      return false;
+  }
+  return true;
+}
+
+void SimpleSynchronousEntry::FinishClose(
+    const SimpleEntryStat& entry_stat,
+    const std::vector<CRCRecord>& crc32s_to_write,
+    net::GrowableIOBuffer* stream_0_data,
+    bool doomed) {
+  // The files are deleted once the entry is in the packed store. Until then,
+  // the next open of the entry finds the files.
+  const bool packed = !doomed && !crc32s_to_write.empty() &&
+                      MaybePack(entry_stat, stream_0_data);
+  for (std::vector<CRCRecord>::const_iterator it = crc32s_to_write.begin();
+       it != crc32s_to_write.end(); ++it) {
+    const int stream_index = it->index;
+    const int file_index = GetFileIndexFromStreamIndex(stream_index);
+    if (file_index == 0 || empty_file_omitted_[file_index])
+      continue;
+
+    SimpleFileEOF eof_record;
+    FillEOFRecord(entry_stat.data_size(stream_index), *it, &eof_record);
+    int eof_offset = entry_stat.GetEOFOffsetInFile(key_, stream_index);
+    if (files_[file_index].Write(eof_offset,
+                                 reinterpret_cast<const char*>(&eof_record),
+                                 sizeof(eof_record)) !=
+        sizeof(eof_record)) {
+      RecordCloseResult(cache_type_, CLOSE_RESULT_WRITE_FAILURE);
+      DVLOG(1) << "Could not write eof record.";
+      Doom();
+      break;
+    }
+  }
+  for (int i = 0; i < kSimpleEntryFileCount; ++i) {
+    if (empty_file_omitted_[i])
+      continue;
+
+    files_[i].Close();
+    const int64 file_size = entry_stat.GetFileSize(key_, i);
+    SIMPLE_CACHE_UMA(CUSTOM_COUNTS,
+                     "LastClusterSize", cache_type_,
+                     file_size % 4096, 0, 4097, 50);
+    const int64 cluster_loss = file_size % 4096 ? 4096 - file_size % 4096 : 0;
+    SIMPLE_CACHE_UMA(PERCENTAGE,
+                     "LastClusterLossPercent", cache_type_,
+                     cluster_loss * 100 / (cluster_loss + file_size));
+  }
+
+  if (sparse_file_open())
+    sparse_file_.Close();
+
+  if (files_created_) {
+    const int stream2_file_index = GetFileIndexFromStreamIndex(2);
+    SIMPLE_CACHE_UMA(BOOLEAN, "EntryCreatedAndStream2Omitted", cache_type_,
+                     empty_file_omitted_[stream2_file_index]);
+  }
+  if (packed)
+    DeleteFilesForEntryHash(path_, entry_hash_);
+  RecordCloseResult(cache_type_, CLOSE_RESULT_SUCCESS);
+  have_open_files_ = false;
+  delete this;
+}
+
+void SimpleSynchronousEntry::WritePackedData(
+    const EntryOperationData& in_entry_op,
+    net::IOBuffer* in_buf,
+    SimpleEntryStat* out_entry_stat,
+    int* out_result) {
+  DCHECK(packed_);
+  DCHECK_EQ(1, in_entry_op.index);
+  const size_t offset = in_entry_op.offset;
+  const size_t buf_len = in_entry_op.buf_len;
+  const bool extending_by_write =
+      offset + buf_len > packed_stream_1_.size();
+  // Gaps are zeroed, as they are in files.
+  if (packed_stream_1_.size() < offset + buf_len)
+    packed_stream_1_.resize(offset + buf_len, '\0');
+  if (buf_len > 0)
+    packed_stream_1_.replace(offset, buf_len, in_buf->data(), buf_len);
+  if (in_entry_op.truncate || (buf_len == 0 && extending_by_write))
+    packed_stream_1_.resize(offset + buf_len);
+  out_entry_stat->set_data_size(1, packed_stream_1_.size());
+
+  RecordWriteResult(cache_type_, WRITE_RESULT_SUCCESS);
+  base::Time modification_time = Time::Now();
+  out_entry_stat->set_last_used(modification_time);
+  out_entry_stat->set_last_modified(modification_time);
+  *out_result = buf_len;
+}
+
+bool SimpleSynchronousEntry::Unpack(bool doomed,
+                                    const SimpleEntryStat& entry_stat) {
+  DCHECK(packed_);
+  DCHECK(!have_open_files_);
+  // Like a write to a lazily omitted stream, this would mix up a doomed entry
+  // with a newly-created entry with the same key.
+  if (doomed) {
+    DLOG(WARNING) << "Rejecting unpack of doomed cache entry.";
+    return false;
+  }
+
+  // Files may be left from a crash right after the entry was packed.
+  DeleteFilesForEntryHash(path_, entry_hash_);
+  File::Error error;
+  if (!MaybeCreateFile(0, FILE_REQUIRED, &error)) {
+    Doom();
+    return false;
+  }
+  MaybeCreateFile(1, FILE_NOT_REQUIRED, &error);
+  have_open_files_ = true;
+
+  // Write a complete first file, with the contents the packed entry had, so
+  // that the later writes and the close see an ordinary entry.
+  SimpleEntryStat file_entry_stat(entry_stat);
+  file_entry_stat.set_data_size(0, packed_stream_0_.size());
+  file_entry_stat.set_data_size(1, packed_stream_1_.size());
+  std::vector<CRCRecord> crc32s_to_write;
+  crc32s_to_write.push_back(CRCRecord(
+      0, true,
+      crc32(crc32(0, Z_NULL, 0),
+            reinterpret_cast<const Bytef*>(packed_stream_0_.data()),
+            packed_stream_0_.size())));
+  crc32s_to_write.push_back(CRCRecord(
+      1, true,
+      crc32(crc32(0, Z_NULL, 0),
+            reinterpret_cast<const Bytef*>(packed_stream_1_.data()),
+            packed_stream_1_.size())));
+  scoped_refptr<net::GrowableIOBuffer> stream_0_data(
+      new net::GrowableIOBuffer());
+  stream_0_data->SetCapacity(packed_stream_0_.size());
+  memcpy(stream_0_data->data(), packed_stream_0_.data(),
+         packed_stream_0_.size());
+  CreateEntryResult result;
+  if (!InitializeCreatedFile(0, &result) ||
+      !WriteFirstFileTail(file_entry_stat, packed_stream_1_.data(),
+                          packed_stream_1_.size(), crc32s_to_write,
+                          stream_0_data.get())) {
+    CloseFiles();
+    have_open_files_ = false;
+    Doom();
+    return false;
+  }
+
+  packed_store_->Remove(entry_hash_);
+  packed_ = false;
+  packed_stream_0_.clear();
+  packed_stream_1_.clear();
+  return true;
+}
+
+bool SimpleSynchronousEntry::MaybePack(const SimpleEntryStat& entry_stat,
+                                       net::GrowableIOBuffer* stream_0_data) {
+  if (!packed_store_ || entry_stat.data_size(2) != 0 ||
+      entry_stat.sparse_data_size() != 0 || sparse_file_open() ||
+      !SimplePackedStore::CanPack(key_, entry_stat.data_size(0),
+                                  entry_stat.data_size(1))) {
+    return false;
+  }
+  DCHECK(!empty_file_omitted_[0]);
+  const int stream_1_size = entry_stat.data_size(1);
+  std::string stream_1(stream_1_size, '\0');
+  if (stream_1_size > 0 &&
+      files_[0].Read(entry_stat.GetOffsetInFile(key_, 0, 1), &stream_1[0],
+                     stream_1_size) != stream_1_size) {
+    return false;
+  }
+  return packed_store_->Put(entry_hash_, key_, stream_0_data->data(),
+                            entry_stat.data_size(0), stream_1.data(),
+                            stream_1_size);
+}
+
 // static
 bool SimpleSynchronousEntry::DeleteFileForEntryHash(
     const FilePath& path,
@@ -27,6 +27,7 @@ class IOBuffer;
 
 namespace disk_cache {
 
+class SimplePackedStore;
 class SimpleSynchronousEntry;
 
 // This class handles the passing of data about the entry between
@@ -112,14 +113,20 @@ class SimpleSynchronousEntry {
     bool doomed;
   };
 
+  // |packed_store| is the store of the small entries of the cache, or NULL if
+  // entries are not packed. Entries are created packed, and stay so while
+  // they are small enough and have no stream 2 or sparse data; an entry is
+  // moved to its own files by the write that makes it outgrow the store.
   static void OpenEntry(net::CacheType cache_type,
                         const base::FilePath& path,
+                        SimplePackedStore* packed_store,
                         uint64 entry_hash,
                         bool had_index,
                         SimpleEntryCreationResults* out_results);
 
   static void CreateEntry(net::CacheType cache_type,
                           const base::FilePath& path,
+                          SimplePackedStore* packed_store,
                           const std::string& key,
                           uint64 entry_hash,
                           bool had_index,
@@ -129,13 +136,15 @@ class SimpleSynchronousEntry {
   // corresponding instance, if any (allowing operations to continue to be
   // executed through that instance). Returns a net error code.
   static int DoomEntry(const base::FilePath& path,
+                       SimplePackedStore* packed_store,
                        uint64 entry_hash);
 
   // Like |DoomEntry()| above. Deletes all entries corresponding to the
   // |key_hashes|. Succeeds only when all entries are deleted. Returns a net
   // error code.
   static int DoomEntrySet(const std::vector<uint64>* key_hashes,
-                          const base::FilePath& path);
+                          const base::FilePath& path,
+                          SimplePackedStore* packed_store);
 
   // N.B. ReadData(), WriteData(), CheckEOFRecord() and Close() may block on IO.
   void ReadData(const EntryOperationData& in_entry_op,
@@ -166,10 +175,22 @@ class SimpleSynchronousEntry {
                          int* out_result);
 
   // Close all streams, and add write EOF records to streams indicated by the
-  // CRCRecord entries in |crc32s_to_write|.
+  // CRCRecord entries in |crc32s_to_write|. A written entry that is small
+  // enough is stored in the packed store, unless it is |doomed|.
   void Close(const SimpleEntryStat& entry_stat,
              scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
-             net::GrowableIOBuffer* stream_0_data);
+             net::GrowableIOBuffer* stream_0_data,
+             bool doomed);
+
+  // Like WriteData() followed by Close(), for a write that was queued right
+  // before the close. When the write reaches the end of stream 1, the data,
+  // the EOF records and stream 0 are written with a single gathered write.
+  void WriteDataAndClose(const EntryOperationData& in_entry_op,
+                         net::IOBuffer* in_buf,
+                         SimpleEntryStat* entry_stat,
+                         scoped_ptr<std::vector<CRCRecord> > crc32s_to_write,
+                         net::GrowableIOBuffer* stream_0_data,
+                         int* out_result);
 
   const base::FilePath& path() const { return path_; }
   std::string key() const { return key_; }
@@ -202,6 +223,7 @@ class SimpleSynchronousEntry {
   SimpleSynchronousEntry(
       net::CacheType cache_type,
       const base::FilePath& path,
+      SimplePackedStore* packed_store,
       const std::string& key,
       uint64 entry_hash);
 
@@ -235,6 +257,13 @@ class SimpleSynchronousEntry {
                         scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
                         uint32* out_stream_0_crc32);
 
+  // Initializes the entry from its record in the packed store, if it has one.
+  // Returns false if it does not.
+  bool InitializeForOpenPacked(
+      SimpleEntryStat* out_entry_stat,
+      scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
+      uint32* out_stream_0_crc32);
+
   // Writes the header and key to a newly-created stream file. |index| is the
   // index of the stream. Returns true on success; returns false and sets
   // |*out_result| on failure.
@@ -261,6 +290,41 @@ class SimpleSynchronousEntry {
                        int* out_data_size) const;
   void Doom() const;
 
+  // Writes the end of the first file with a single gathered write: the last
+  // |stream_1_tail_len| bytes of stream 1 from |stream_1_tail|, the EOF record
+  // of stream 1, stream 0 and the EOF record of stream 0. The EOF records are
+  // written only if they are in |crc32s_to_write|, and |stream_1_tail| only
+  // goes with the EOF record of stream 1. Returns false on IO failure.
+  bool WriteFirstFileTail(const SimpleEntryStat& entry_stat,
+                          const char* stream_1_tail,
+                          int stream_1_tail_len,
+                          const std::vector<CRCRecord>& crc32s_to_write,
+                          net::GrowableIOBuffer* stream_0_data);
+
+  // Writes the EOF records in |crc32s_to_write| for the streams outside of the
+  // first file, closes all the files and deletes |this|. The entry is moved
+  // to the packed store if it was written, is not |doomed| and fits there.
+  void FinishClose(const SimpleEntryStat& entry_stat,
+                   const std::vector<CRCRecord>& crc32s_to_write,
+                   net::GrowableIOBuffer* stream_0_data,
+                   bool doomed);
+
+  // Applies a write to stream 1 of a packed entry to its in-memory copy.
+  void WritePackedData(const EntryOperationData& in_entry_op,
+                       net::IOBuffer* in_buf,
+                       SimpleEntryStat* out_entry_stat,
+                       int* out_result);
+
+  // Writes the files of a packed entry from its contents as of the last time
+  // it was stored, and removes it from the packed store. Returns false if the
+  // entry is |doomed| or on IO failure, in which case the entry is doomed.
+  bool Unpack(bool doomed, const SimpleEntryStat& entry_stat);
+
+  // Stores the entry with |stream_0_data| in the packed store if it fits
+  // there. The entry files must be open. Returns true if it was stored.
+  bool MaybePack(const SimpleEntryStat& entry_stat,
+                 net::GrowableIOBuffer* stream_0_data);
+
   // Opens the sparse data file and scans it if it exists.
   bool OpenSparseFileIfExists(int32* out_sparse_data_size);
 
@@ -310,9 +374,17 @@ class SimpleSynchronousEntry {
 
   const net::CacheType cache_type_;
   const base::FilePath path_;
+  const scoped_refptr<SimplePackedStore> packed_store_;
   const uint64 entry_hash_;
   std::string key_;
 
+  // True while the entry has no files, and its streams 0 and 1 are kept in
+  // |packed_stream_0_| and |packed_stream_1_|. Stream 0 is as of when the
+  // entry was opened, since it is kept up to date by the SimpleEntryImpl.
+  bool packed_;
+  std::string packed_stream_0_;
+  std::string packed_stream_1_;
+
   bool have_open_files_;
   bool initialized_;
 
@@ -84,7 +84,10 @@ int BackendImplV3::Init(const CompletionCallback& callback) {
   if (init_)
     return net::ERR_FAILED;
 
-  return net::ERR_IO_PENDING;
+  // The entry, eviction and worker code is still disabled by
+  // V3_NOT_JUST_YET_READY, so fail right away instead of returning
+  // ERR_IO_PENDING for a callback that is never run.
+  return net::ERR_NOT_IMPLEMENTED;
 }
 
 // ------------------------------------------------------------------------
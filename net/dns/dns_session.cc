@@ -94,6 +94,7 @@ DnsSession::DnsSession(const DnsConfig& config,
     server_stats_.push_back(new ServerStats(config_.timeout,
                                             rtt_buckets_.Pointer()));
   }
+  idle_tcp_sockets_.resize(config_.nameservers.size());
 }
 
 DnsSession::~DnsSession() {
@@ -121,7 +122,7 @@ unsigned DnsSession::NextGoodServerIndex(unsigned server_index) {
     base::Time cur_server_failure = server_stats_[index]->last_failure;
     // If number of failures on this server doesn't exceed number of allowed
     // attempts, return its index.
-    if (server_stats_[server_index]->last_failure_count < config_.attempts) {
+    if (server_stats_[index]->last_failure_count < config_.attempts) {
       return index;
     }
     // Track oldest failed server.
@@ -238,6 +239,27 @@ scoped_ptr<StreamSocket> DnsSession::CreateTCPSocket(
   return socket_pool_->CreateTCPSocket(server_index, source);
 }
 
+scoped_ptr<StreamSocket> DnsSession::AllocateTCPSocket(
+    unsigned server_index, const NetLog::Source& source) {
+  DCHECK_LT(server_index, idle_tcp_sockets_.size());
+  scoped_ptr<StreamSocket> socket(idle_tcp_sockets_[server_index]);
+  idle_tcp_sockets_[server_index] = NULL;
+  bool reused = socket.get() && socket->IsConnectedAndIdle();
+  UMA_HISTOGRAM_BOOLEAN("AsyncDNS.TCPSocketReused", reused);
+  if (reused)
+    return socket.Pass();
+  return CreateTCPSocket(server_index, source);
+}
+
+void DnsSession::FreeTCPSocket(unsigned server_index,
+                               scoped_ptr<StreamSocket> socket) {
+  DCHECK_LT(server_index, idle_tcp_sockets_.size());
+  DCHECK(socket.get());
+  if (idle_tcp_sockets_[server_index] || !socket->IsConnectedAndIdle())
+    return;
+  idle_tcp_sockets_[server_index] = socket.release();
+}
+
 // Release a socket.
 void DnsSession::FreeSocket(unsigned server_index,
                             scoped_ptr<DatagramClientSocket> socket) {
@@ -106,6 +106,17 @@ class NET_EXPORT_PRIVATE DnsSession
   scoped_ptr<StreamSocket> CreateTCPSocket(unsigned server_index,
                                            const NetLog::Source& source);
 
+  // Returns the idle TCP connection to the server kept by FreeTCPSocket(), if
+  // it is still usable, and otherwise a new socket from CreateTCPSocket().
+  // The caller should only Connect() the socket if it is not yet connected.
+  scoped_ptr<StreamSocket> AllocateTCPSocket(unsigned server_index,
+                                             const NetLog::Source& source);
+
+  // Keeps |socket|, which must be between DNS messages, for the next TCP
+  // transaction with the server, unless one is already kept.  This saves
+  // the handshake when a server keeps truncating its UDP responses.
+  void FreeTCPSocket(unsigned server_index, scoped_ptr<StreamSocket> socket);
+
  private:
   friend class base::RefCounted<DnsSession>;
   ~DnsSession();
@@ -133,6 +144,9 @@ class NET_EXPORT_PRIVATE DnsSession
   // Track runtime statistics of each DNS server.
   ScopedVector<ServerStats> server_stats_;
 
+  // Idle TCP connection to each DNS server, or NULL.
+  ScopedVector<StreamSocket> idle_tcp_sockets_;
+
   // Buckets shared for all |ServerStats::rtt_histogram|.
   struct RttBuckets : public base::BucketRanges {
     RttBuckets();
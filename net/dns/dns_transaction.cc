@@ -295,15 +295,19 @@ class DnsUDPAttempt : public DnsAttempt {
 
 class DnsTCPAttempt : public DnsAttempt {
  public:
-  DnsTCPAttempt(unsigned server_index,
+  DnsTCPAttempt(DnsSession* session,
+                unsigned server_index,
                 scoped_ptr<StreamSocket> socket,
                 scoped_ptr<DnsQuery> query)
       : DnsAttempt(server_index),
         next_state_(STATE_NONE),
+        session_(session),
         socket_(socket.Pass()),
+        socket_net_log_(socket_->NetLog()),
         query_(query.Pass()),
         length_buffer_(new IOBufferWithSize(sizeof(uint16))),
-        response_length_(0) {}
+        response_length_(0),
+        read_whole_response_(false) {}
 
   // DnsAttempt:
   virtual int Start(const CompletionCallback& callback) OVERRIDE {
@@ -311,6 +315,8 @@ class DnsTCPAttempt : public DnsAttempt {
     callback_ = callback;
     start_time_ = base::TimeTicks::Now();
     next_state_ = STATE_CONNECT_COMPLETE;
+    if (socket_->IsConnected())
+      return DoLoop(OK);
     int rv = socket_->Connect(base::Bind(&DnsTCPAttempt::OnIOComplete,
                                          base::Unretained(this)));
     if (rv == ERR_IO_PENDING) {
@@ -330,7 +336,7 @@ class DnsTCPAttempt : public DnsAttempt {
   }
 
   virtual const BoundNetLog& GetSocketNetLog() const OVERRIDE {
-    return socket_->NetLog();
+    return socket_net_log_;
   }
 
  private:
@@ -372,6 +378,9 @@ class DnsTCPAttempt : public DnsAttempt {
     } while (rv != ERR_IO_PENDING && next_state_ != STATE_NONE);
 
     set_result(rv);
+    // Only a connection which is between messages can be used again.
+    if (read_whole_response_ && socket_.get())
+      session_->FreeTCPSocket(server_index(), socket_.Pass());
     if (rv == OK) {
       DCHECK_EQ(STATE_NONE, next_state_);
       DNS_HISTOGRAM("AsyncDNS.TCPAttemptSuccess",
@@ -470,6 +479,7 @@ class DnsTCPAttempt : public DnsAttempt {
           buffer_->BytesRemaining(),
           base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
     }
+    read_whole_response_ = true;
     if (!response_->InitParse(buffer_->BytesConsumed(), *query_))
       return ERR_DNS_MALFORMED_RESPONSE;
     if (response_->flags() & dns_protocol::kFlagTC)
@@ -492,13 +502,18 @@ class DnsTCPAttempt : public DnsAttempt {
   State next_state_;
   base::TimeTicks start_time_;
 
+  scoped_refptr<DnsSession> session_;
+  // Handed back to |session_| once the response has been read.
   scoped_ptr<StreamSocket> socket_;
+  const BoundNetLog socket_net_log_;
   scoped_ptr<DnsQuery> query_;
   scoped_refptr<IOBufferWithSize> length_buffer_;
   scoped_refptr<DrainableIOBuffer> buffer_;
 
   uint16 response_length_;
   scoped_ptr<DnsResponse> response_;
+  // True once all |response_length_| bytes of the response have been read.
+  bool read_whole_response_;
 
   CompletionCallback callback_;
 
@@ -717,7 +732,7 @@ class DnsTransactionImpl : public DnsTransaction,
     unsigned server_index = previous_attempt->server_index();
 
     scoped_ptr<StreamSocket> socket(
-        session_->CreateTCPSocket(server_index, net_log_.source()));
+        session_->AllocateTCPSocket(server_index, net_log_.source()));
 
     // TODO(szym): Reuse the same id to help the server?
     uint16 id = session_->NextQueryId();
@@ -730,8 +745,8 @@ class DnsTransactionImpl : public DnsTransaction,
 
     unsigned attempt_number = attempts_.size();
 
-    DnsTCPAttempt* attempt = new DnsTCPAttempt(server_index, socket.Pass(),
-                                               query.Pass());
+    DnsTCPAttempt* attempt = new DnsTCPAttempt(session_.get(), server_index,
+                                               socket.Pass(), query.Pass());
 
     attempts_.push_back(attempt);
     ++attempts_count_;
@@ -56,6 +56,25 @@ class DnsSocketData {
   }
   ~DnsSocketData() {}
 
+  // Adds another query written to the same connection, after the responses
+  // added so far.  TCP mode only.
+  void AddQuery(uint16 id, const char* dotted_name, uint16 qtype,
+                IoMode mode) {
+    CHECK(use_tcp_);
+    CHECK(!provider_.get());
+    DnsQuery* query = new DnsQuery(id, DomainFromDot(dotted_name), qtype);
+    scoped_ptr<uint16> length(new uint16);
+    *length = base::HostToNet16(query->io_buffer()->size());
+    writes_.push_back(MockWrite(mode,
+                                reinterpret_cast<const char*>(length.get()),
+                                sizeof(uint16)));
+    lengths_.push_back(length.release());
+    writes_.push_back(MockWrite(mode,
+                                query->io_buffer()->data(),
+                                query->io_buffer()->size()));
+    extra_queries_.push_back(query);
+  }
+
   // All responses must be added before GetProvider.
 
   // Adds pre-built DnsResponse. |tcp_length| will be used in TCP mode only.
@@ -130,6 +149,7 @@ class DnsSocketData {
  private:
   scoped_ptr<DnsQuery> query_;
   bool use_tcp_;
+  ScopedVector<DnsQuery> extra_queries_;
   ScopedVector<uint16> lengths_;
   ScopedVector<DnsResponse> responses_;
   std::vector<MockWrite> writes_;
@@ -887,6 +907,29 @@ TEST_F(DnsTransactionTest, TCPLookup) {
   EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
 }
 
+TEST_F(DnsTransactionTest, TCPConnectionReused) {
+  AddAsyncQueryAndRcode(kT0HostName, kT0Qtype,
+                        dns_protocol::kRcodeNOERROR | dns_protocol::kFlagTC);
+  scoped_ptr<DnsSocketData> data(
+      new DnsSocketData(0 /* id */, kT0HostName, kT0Qtype, ASYNC, true));
+  data->AddResponseData(kT0ResponseDatagram, arraysize(kT0ResponseDatagram),
+                        ASYNC);
+  data->AddQuery(0 /* id */, kT0HostName, kT0Qtype, ASYNC);
+  data->AddResponseData(kT0ResponseDatagram, arraysize(kT0ResponseDatagram),
+                        ASYNC);
+  AddSocketData(data.Pass());
+  AddAsyncQueryAndRcode(kT0HostName, kT0Qtype,
+                        dns_protocol::kRcodeNOERROR | dns_protocol::kFlagTC);
+  // The second TCP query goes over the first connection.
+  transaction_ids_.push_back(0);
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+  TransactionHelper helper1(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper1.Run(transaction_factory_.get()));
+  EXPECT_TRUE(transaction_ids_.empty());
+}
+
 TEST_F(DnsTransactionTest, TCPFailure) {
   AddAsyncQueryAndRcode(kT0HostName, kT0Qtype,
                         dns_protocol::kRcodeNOERROR | dns_protocol::kFlagTC);
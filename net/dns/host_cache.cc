@@ -8,10 +8,25 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Keys of the dictionaries written by GetAsListValue().
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kExpirationKey[] = "expiration";
+const char kCanonicalNameKey[] = "canonical_name";
+const char kAddressesKey[] = "addresses";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist,
@@ -49,6 +64,20 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   return entries_.Get(key, now);
 }
 
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks now,
+                                               base::TimeDelta* staleness) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return NULL;
+
+  base::TimeTicks expiration;
+  const Entry* entry = entries_.GetIncludingExpired(key, &expiration);
+  if (entry)
+    *staleness = now - expiration;
+  return entry;
+}
+
 void HostCache::Set(const Key& key,
                     const Entry& entry,
                     base::TimeTicks now,
@@ -81,6 +110,89 @@ const HostCache::EntryMap& HostCache::entries() const {
   return entries_;
 }
 
+void HostCache::GetAsListValue(base::ListValue* entry_list) const {
+  DCHECK(CalledOnValidThread());
+  // TimeTicks don't survive a restart, so expirations are written as wall
+  // clock times.
+  base::TimeTicks now_ticks = base::TimeTicks::Now();
+  base::Time now = base::Time::Now();
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Entry& entry = it.value();
+    if (entry.error != OK)
+      continue;
+
+    base::DictionaryValue* entry_dict = new base::DictionaryValue();
+    entry_dict->SetString(kHostnameKey, it.key().hostname);
+    entry_dict->SetInteger(kAddressFamilyKey, it.key().address_family);
+    entry_dict->SetInteger(kFlagsKey, it.key().host_resolver_flags);
+    base::Time expiration = now + (it.expiration() - now_ticks);
+    entry_dict->SetString(kExpirationKey,
+                          base::Int64ToString(expiration.ToInternalValue()));
+    entry_dict->SetString(kCanonicalNameKey, entry.addrlist.canonical_name());
+    base::ListValue* address_list = new base::ListValue();
+    for (AddressList::const_iterator address = entry.addrlist.begin();
+         address != entry.addrlist.end(); ++address) {
+      address_list->AppendString(address->ToStringWithoutPort());
+    }
+    entry_dict->Set(kAddressesKey, address_list);
+    entry_list->Append(entry_dict);
+  }
+}
+
+bool HostCache::RestoreFromListValue(const base::ListValue& entry_list) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  base::TimeTicks now_ticks = base::TimeTicks::Now();
+  base::Time now = base::Time::Now();
+  for (size_t i = 0; i < entry_list.GetSize(); ++i) {
+    const base::DictionaryValue* entry_dict = NULL;
+    std::string hostname;
+    int address_family;
+    int flags;
+    std::string expiration_string;
+    int64 expiration_value;
+    std::string canonical_name;
+    const base::ListValue* address_list = NULL;
+    if (!entry_list.GetDictionary(i, &entry_dict) ||
+        !entry_dict->GetString(kHostnameKey, &hostname) ||
+        !entry_dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        address_family < ADDRESS_FAMILY_UNSPECIFIED ||
+        address_family > ADDRESS_FAMILY_LAST ||
+        !entry_dict->GetInteger(kFlagsKey, &flags) ||
+        !entry_dict->GetString(kExpirationKey, &expiration_string) ||
+        !base::StringToInt64(expiration_string, &expiration_value) ||
+        !entry_dict->GetString(kCanonicalNameKey, &canonical_name) ||
+        !entry_dict->GetList(kAddressesKey, &address_list)) {
+      return false;
+    }
+
+    AddressList addrlist;
+    for (size_t j = 0; j < address_list->GetSize(); ++j) {
+      std::string address_string;
+      IPAddressNumber address;
+      if (!address_list->GetString(j, &address_string) ||
+          !ParseIPLiteralToNumber(address_string, &address)) {
+        return false;
+      }
+      addrlist.push_back(IPEndPoint(address, 0));
+    }
+    if (addrlist.empty())
+      return false;
+    addrlist.set_canonical_name(canonical_name);
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    base::TimeTicks expiration;
+    if (entries_.GetIncludingExpired(key, &expiration))
+      continue;
+    base::TimeDelta ttl =
+        base::Time::FromInternalValue(expiration_value) - now;
+    entries_.Put(key, Entry(OK, addrlist), now_ticks, now_ticks + ttl);
+  }
+  return true;
+}
+
 // static
 scoped_ptr<HostCache> HostCache::CreateDefaultCache() {
   // Cache capacity is determined by the field trial.
@@ -17,6 +17,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -82,6 +86,13 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Returns a pointer to the entry for |key|, whether or not it has expired,
+  // and sets |staleness| to how long ago it expired at time |now|, which is
+  // negative if it has not.  If there is no such entry, returns NULL.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           base::TimeDelta* staleness);
+
   // Overwrites or creates an entry for |key|.
   // |entry| is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -101,6 +112,17 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
 
   const EntryMap& entries() const;
 
+  // Appends the successful entries to |entry_list|, for restoring with
+  // RestoreFromListValue() after a restart.
+  void GetAsListValue(base::ListValue* entry_list) const;
+
+  // Restores entries written by GetAsListValue(), keeping their expiration
+  // times, so that entries which expired while the browser was closed are
+  // only used where stale entries are allowed.  Does not overwrite entries
+  // already in the cache.  Returns false if |entry_list| is malformed, after
+  // restoring what it could.
+  bool RestoreFromListValue(const base::ListValue& entry_list);
+
   // Creates a default cache.
   static scoped_ptr<HostCache> CreateDefaultCache();
 
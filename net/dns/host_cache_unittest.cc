@@ -8,7 +8,10 @@
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -296,6 +299,95 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+TEST(HostCacheTest, LookupStale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+  base::TimeDelta staleness;
+
+  HostCache::Key key = Key("foobar.com");
+  HostCache::Entry entry = HostCache::Entry(OK, AddressList());
+
+  EXPECT_FALSE(cache.LookupStale(key, now, &staleness));
+  cache.Set(key, entry, now, kTTL);
+  EXPECT_TRUE(cache.LookupStale(key, now, &staleness));
+  EXPECT_EQ(-kTTL, staleness);
+
+  // Advance to t=15, when the entry expired five seconds ago.
+  now += base::TimeDelta::FromSeconds(15);
+  EXPECT_TRUE(cache.LookupStale(key, now, &staleness));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(5), staleness);
+  EXPECT_EQ(1u, cache.size());
+
+  // Lookup() doesn't return it, and removes it.
+  EXPECT_FALSE(cache.Lookup(key, now));
+  EXPECT_FALSE(cache.LookupStale(key, now, &staleness));
+}
+
+TEST(HostCacheTest, RestoreFromListValue) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  IPAddressNumber address;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &address));
+  AddressList addrlist(IPEndPoint(address, 80));
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::64", &address));
+  addrlist.push_back(IPEndPoint(address, 80));
+  addrlist.set_canonical_name("canonical.foobar.com");
+
+  HostCache::Key key1 = Key("foobar.com");
+  HostCache::Key key2 = Key("foobar2.com");
+  HostCache::Key key3 = Key("foobar3.com");
+  cache.Set(key1, HostCache::Entry(OK, addrlist), now, kTTL);
+  // An entry which has already expired.
+  cache.Set(key2, HostCache::Entry(OK, addrlist),
+            now - base::TimeDelta::FromSeconds(20), kTTL);
+  // Negative entries aren't written.
+  cache.Set(key3, HostCache::Entry(ERR_NAME_NOT_RESOLVED, AddressList()),
+            now, kTTL);
+
+  base::ListValue entry_list;
+  cache.GetAsListValue(&entry_list);
+  EXPECT_EQ(2u, entry_list.GetSize());
+
+  HostCache restored_cache(kMaxCacheEntries);
+  EXPECT_TRUE(restored_cache.RestoreFromListValue(entry_list));
+  EXPECT_EQ(2u, restored_cache.size());
+
+  base::TimeDelta staleness;
+  const HostCache::Entry* entry =
+      restored_cache.LookupStale(key1, now, &staleness);
+  ASSERT_TRUE(entry);
+  EXPECT_LT(staleness, base::TimeDelta());
+  EXPECT_EQ(2u, entry->addrlist.size());
+  EXPECT_EQ("192.168.1.1", entry->addrlist[0].ToStringWithoutPort());
+  EXPECT_EQ("2001:4860:b006::64", entry->addrlist[1].ToStringWithoutPort());
+  EXPECT_EQ("canonical.foobar.com", entry->addrlist.canonical_name());
+
+  // The expired entry comes back expired.
+  entry = restored_cache.LookupStale(key2, now, &staleness);
+  ASSERT_TRUE(entry);
+  EXPECT_GT(staleness, base::TimeDelta());
+  EXPECT_FALSE(restored_cache.Lookup(key2, now));
+
+  // Entries already in the cache aren't overwritten.
+  HostCache other_cache(kMaxCacheEntries);
+  other_cache.Set(key1, HostCache::Entry(OK, AddressList()), now, kTTL);
+  EXPECT_TRUE(other_cache.RestoreFromListValue(entry_list));
+  ASSERT_TRUE(other_cache.Lookup(key1, now));
+  EXPECT_TRUE(other_cache.Lookup(key1, now)->addrlist.empty());
+
+  // Malformed entries are rejected.
+  entry_list.Append(new base::StringValue("foobar4.com"));
+  HostCache bad_cache(kMaxCacheEntries);
+  EXPECT_FALSE(bad_cache.RestoreFromListValue(entry_list));
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
@@ -1205,6 +1205,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         priority_tracker_(priority),
         had_non_speculative_request_(false),
         had_dns_config_(false),
+        is_refresh_(false),
         num_occupied_job_slots_(0),
         dns_task_error_(OK),
         creation_time_(base::TimeTicks::Now()),
@@ -1316,7 +1317,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                                  req->request_net_log().source(),
                                  priority()));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_refresh_) {
       UpdatePriority();
     } else {
       // If we were called from a Request's callback within CompleteRequests,
@@ -1358,7 +1359,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
-    DCHECK_GT(num_active_requests(), 0u);
+    if (is_refresh_ && requests_.empty())
+      return false;
+    DCHECK(is_refresh_ || num_active_requests() > 0u);
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
                                   requests_.front()->info(),
@@ -1376,6 +1379,12 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     return key_;
   }
 
+  // Makes this Job run to completion and update the cache even if it has no
+  // active Requests.
+  void MarkAsRefresh() {
+    is_refresh_ = true;
+  }
+
   bool is_queued() const {
     return !handle_.is_null();
   }
@@ -1665,7 +1674,18 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
       handle_.Reset();
     }
 
+    bool did_complete = (entry.error != ERR_NETWORK_CHANGED) &&
+                        (entry.error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE);
+
     if (num_active_requests() == 0) {
+      // A refresh only replaces the stale entry it was started for if it
+      // succeeds, so that the stale entry can still be served while offline.
+      if (is_refresh_ && did_complete && entry.error == OK) {
+        net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
+                                          OK);
+        resolver_->CacheResult(key_, entry, ttl);
+        return;
+      }
       net_log_.AddEvent(NetLog::TYPE_CANCELLED);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1684,8 +1704,6 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                             resolver_->received_dns_config_);
     }
 
-    bool did_complete = (entry.error != ERR_NETWORK_CHANGED) &&
-                        (entry.error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE);
     if (did_complete)
       resolver_->CacheResult(key_, entry, ttl);
 
@@ -1750,6 +1768,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Distinguishes measurements taken while DnsClient was fully configured.
   bool had_dns_config_;
 
+  // True if this Job refreshes a stale cache entry, see MarkAsRefresh().
+  bool is_refresh_;
+
   // Number of slots occupied by this Job in resolver's PrioritizedDispatcher.
   unsigned num_occupied_job_slots_;
 
@@ -1882,10 +1903,13 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   // outstanding jobs map.
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
-  int rv = ResolveHelper(key, info, addresses, request_net_log);
+  bool served_stale = false;
+  int rv = ResolveHelper(key, info, addresses, request_net_log, &served_stale);
   if (rv != ERR_DNS_CACHE_MISS) {
     LogFinishRequest(source_net_log, request_net_log, info, rv);
     RecordTotalTime(HaveDnsConfig(), info.is_speculative(), base::TimeDelta());
+    if (served_stale)
+      StartRefreshJob(key, request_net_log);
     return rv;
   }
 
@@ -1929,7 +1953,8 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
 int HostResolverImpl::ResolveHelper(const Key& key,
                                     const RequestInfo& info,
                                     AddressList* addresses,
-                                    const BoundNetLog& request_net_log) {
+                                    const BoundNetLog& request_net_log,
+                                    bool* served_stale) {
   // The result of |getaddrinfo| for empty hosts is inconsistent across systems.
   // On Windows it gives the default interface's address, whereas on Linux it
   // gives an error. We will make it fail on all platforms for consistency.
@@ -1939,7 +1964,7 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
+  if (ServeFromCache(key, info, &net_error, addresses, served_stale)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
     return net_error;
   }
@@ -1967,7 +1992,7 @@ int HostResolverImpl::ResolveFromCache(const RequestInfo& info,
 
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
-  int rv = ResolveHelper(key, info, addresses, request_net_log);
+  int rv = ResolveHelper(key, info, addresses, request_net_log, NULL);
   LogFinishRequest(source_net_log, request_net_log, info, rv);
   return rv;
 }
@@ -1981,6 +2006,12 @@ void HostResolverImpl::CancelRequest(RequestHandle req_handle) {
   job->CancelRequest(req);
 }
 
+void HostResolverImpl::SetMaxStaleAge(base::TimeDelta max_stale_age) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(max_stale_age >= base::TimeDelta());
+  max_stale_age_ = max_stale_age;
+}
+
 void HostResolverImpl::SetDefaultAddressFamily(AddressFamily address_family) {
   DCHECK(CalledOnValidThread());
   default_address_family_ = address_family;
@@ -2050,14 +2081,30 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      bool* is_stale) {
   DCHECK(addresses);
   DCHECK(net_error);
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  const HostCache::Entry* cache_entry = NULL;
+  if (is_stale && max_stale_age_ > base::TimeDelta()) {
+    base::TimeDelta staleness;
+    cache_entry = cache_->LookupStale(key, base::TimeTicks::Now(), &staleness);
+    *is_stale = cache_entry && staleness >= base::TimeDelta();
+    if (*is_stale) {
+      // Only positive entries are worth serving stale.
+      if (cache_entry->error != OK || staleness > max_stale_age_) {
+        *is_stale = false;
+        return false;
+      }
+      UMA_HISTOGRAM_CUSTOM_TIMES("DNS.StaleCacheHit", staleness,
+          base::TimeDelta::FromSeconds(1), base::TimeDelta::FromDays(1), 100);
+    }
+  } else {
+    cache_entry = cache_->Lookup(key, base::TimeTicks::Now());
+  }
   if (!cache_entry)
     return false;
 
@@ -2118,6 +2165,27 @@ bool HostResolverImpl::ServeFromHosts(const Key& key,
   return !addresses->empty();
 }
 
+void HostResolverImpl::StartRefreshJob(const Key& key,
+                                       const BoundNetLog& request_net_log) {
+  if (jobs_.find(key) != jobs_.end())
+    return;
+
+  Job* job =
+      new Job(weak_ptr_factory_.GetWeakPtr(), key, IDLE, request_net_log);
+  job->MarkAsRefresh();
+  job->Schedule(false);
+
+  // Check for queue overflow.
+  if (dispatcher_.num_queued_jobs() > max_queued_jobs_) {
+    Job* evicted = static_cast<Job*>(dispatcher_.EvictOldestLowest());
+    DCHECK(evicted);
+    evicted->OnEvicted();  // Deletes |evicted|.
+    if (evicted == job)
+      return;
+  }
+  jobs_.insert(std::make_pair(key, job));
+}
+
 void HostResolverImpl::CacheResult(const Key& key,
                                    const HostCache::Entry& entry,
                                    base::TimeDelta ttl) {
@@ -123,6 +123,12 @@ class NET_EXPORT HostResolverImpl
   // Only allowed when the queue is empty.
   void SetMaxQueuedJobs(size_t value);
 
+  // Lets Resolve() serve cache entries which expired up to |max_stale_age|
+  // ago, rather than waiting for a new lookup.  Each stale hit starts a Job
+  // in the background to refresh the entry.  Zero, the default, never serves
+  // stale entries.
+  void SetMaxStaleAge(base::TimeDelta max_stale_age);
+
   // Set the DnsClient to be used for resolution. In case of failure, the
   // HostResolverProc from ProcTaskParams will be queried. If the DnsClient is
   // not pre-configured with a valid DnsConfig, a new config is fetched from
@@ -165,10 +171,13 @@ class NET_EXPORT HostResolverImpl
   // literal, cache and HOSTS lookup (if enabled), returns OK if successful,
   // ERR_NAME_NOT_RESOLVED if either hostname is invalid or IP literal is
   // incompatible, ERR_DNS_CACHE_MISS if entry was not found in cache and HOSTS.
+  // If |served_stale| is not NULL, expired cache entries may be used, and it
+  // is set to whether one was.
   int ResolveHelper(const Key& key,
                     const RequestInfo& info,
                     AddressList* addresses,
-                    const BoundNetLog& request_net_log);
+                    const BoundNetLog& request_net_log,
+                    bool* served_stale);
 
   // Tries to resolve |key| as an IP, returns true and sets |net_error| if
   // succeeds, returns false otherwise.
@@ -179,11 +188,14 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry.  If |is_stale| is not NULL, a positive entry
+  // up to |max_stale_age_| past its expiration may be served, and |is_stale|
+  // is set to whether it was.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      bool* is_stale);
 
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
@@ -200,6 +212,10 @@ class NET_EXPORT HostResolverImpl
   Key GetEffectiveKeyForRequest(const RequestInfo& info,
                                 const BoundNetLog& net_log) const;
 
+  // Starts a Job with no Requests to refresh the cache entry for |key|,
+  // unless one is already running.
+  void StartRefreshJob(const Key& key, const BoundNetLog& request_net_log);
+
   // Records the result in cache if cache is present.
   void CacheResult(const Key& key,
                    const HostCache::Entry& entry,
@@ -293,6 +309,9 @@ class NET_EXPORT HostResolverImpl
   // Allow fallback to ProcTask if DnsTask fails.
   bool fallback_to_proctask_;
 
+  // How long past their expiration cache entries may still be served.
+  base::TimeDelta max_stale_age_;
+
   DISALLOW_COPY_AND_ASSIGN(HostResolverImpl);
 };
 
@@ -1252,6 +1252,69 @@ TEST_F(HostResolverImplTest, ResolveFromCache) {
   EXPECT_TRUE(requests_[2]->HasOneAddress("192.168.1.42", 80));
 }
 
+// Test that an expired cache entry is served when allowed, and refreshed in
+// the background.
+TEST_F(HostResolverImplTest, ServeStaleEntryAndRefresh) {
+  // With one job slot, the refresh finishes before the next request starts.
+  CreateSerialResolver();
+  resolver_->SetMaxStaleAge(base::TimeDelta::FromHours(1));
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  proc_->AddRuleForAllFamilies("other.testing", "192.168.1.44");
+  proc_->SignalMultiple(3u);
+
+  Request* req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  // Make the entry expire a minute ago.
+  HostCache* cache = resolver_->GetHostCache();
+  ASSERT_EQ(1u, cache->size());
+  HostCache::EntryMap::Iterator it(cache->entries());
+  HostCache::Key key = it.key();
+  HostCache::Entry entry = it.value();
+  cache->Set(key, entry,
+             base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+             base::TimeDelta::FromMinutes(1));
+
+  // The stale entry is served at once, and a refresh is started.
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.43");
+  req = CreateRequest("just.testing", 81);
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.42", 81));
+  EXPECT_EQ(1u, num_running_dispatcher_jobs());
+
+  req = CreateRequest("other.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  req = CreateRequest("just.testing", 82);
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.43", 82));
+  EXPECT_EQ(3u, proc_->GetCaptureList().size());
+}
+
+// Test that expired cache entries are not served unless allowed.
+TEST_F(HostResolverImplTest, NoStaleEntriesByDefault) {
+  proc_->SignalMultiple(2u);
+
+  Request* req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  HostCache* cache = resolver_->GetHostCache();
+  ASSERT_EQ(1u, cache->size());
+  HostCache::EntryMap::Iterator it(cache->entries());
+  HostCache::Key key = it.key();
+  HostCache::Entry entry = it.value();
+  cache->Set(key, entry,
+             base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+             base::TimeDelta::FromMinutes(1));
+
+  req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+}
+
 // Test the retry attempts simulating host resolver proc that takes too long.
 TEST_F(HostResolverImplTest, MultipleAttempts) {
   // Total number of attempts would be 3 and we want the 3rd attempt to resolve
@@ -7,7 +7,11 @@
 // wrapped with a gzip header, and with deflate encoding the content is in
 // a raw, headerless DEFLATE stream.
 //
-// Internally GZipFilter uses zlib inflate to do decoding.
+// Internally GZipFilter uses zlib inflate to do decoding. Data is inflated
+// straight from the stream buffer into the destination buffer passed to
+// ReadFilteredData(), which is either the consumer's buffer or, within a
+// filter chain, the stream buffer of the next filter, so no intermediate copy
+// is made.
 //
 // GZipFilter is a subclass of Filter. See the latter's header file filter.h
 // for sample usage.
@@ -50,6 +50,24 @@ void DeletePath(base::FilePath path) {
   base::DeleteFile(path, false);
 }
 
+bool IsSharedWritingEnabled() {
+  return base::FieldTrialList::FindFullName("HttpCacheSharedWriting") ==
+      "Enabled";
+}
+
+bool IsStaleWhileRevalidateEnabled() {
+  return base::FieldTrialList::FindFullName("StaleWhileRevalidate") ==
+      "Enabled";
+}
+
+// The maximum number of background revalidations in progress. Revalidations
+// requested past this limit are dropped; a later request for the same stale
+// entry asks again.
+const size_t kMaxAsyncValidations = 4;
+
+// The size of the buffer used to drain the response of a revalidation.
+const int kAsyncValidationBufferSize = 16 * 1024;
+
 }  // namespace
 
 namespace net {
@@ -95,6 +113,7 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
+      will_add_shared_reader(false),
       doomed(false) {
 }
 
@@ -269,6 +288,89 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
 
 //-----------------------------------------------------------------------------
 
+// This class revalidates a stale entry in the background, with a copy of the
+// request it was served to. The transaction updates the entry as it reads the
+// response from the network, so the response is read and dropped.
+class HttpCache::AsyncValidation {
+ public:
+  AsyncValidation(const HttpRequestInfo& original_request,
+                  const std::string& key,
+                  HttpCache* cache)
+      : request_(original_request),
+        key_(key),
+        cache_(cache) {
+  }
+
+  ~AsyncValidation() {}
+
+  const std::string& key() const { return key_; }
+
+  void Start();
+
+ private:
+  void OnStarted(int result);
+  void DoRead();
+  void OnRead(int result);
+
+  // Tells the cache that this validation is done, which deletes it.
+  void Terminate();
+
+  HttpRequestInfo request_;
+  const std::string key_;
+  HttpCache* const cache_;
+  scoped_ptr<HttpCache::Transaction> transaction_;
+  scoped_refptr<IOBuffer> buf_;
+  DISALLOW_COPY_AND_ASSIGN(AsyncValidation);
+};
+
+void HttpCache::AsyncValidation::Start() {
+  request_.load_flags |= LOAD_VALIDATE_CACHE;
+  request_.load_flags &= ~(LOAD_PREFERRING_CACHE | LOAD_ONLY_FROM_CACHE |
+                           LOAD_FROM_CACHE_IF_OFFLINE);
+
+  // Revalidations run at the lowest priority, so that they do not compete
+  // for sockets with the requests that are waiting for a response.
+  transaction_.reset(new HttpCache::Transaction(IDLE, cache_));
+  int rv = transaction_->Start(
+      &request_,
+      base::Bind(&AsyncValidation::OnStarted, base::Unretained(this)),
+      BoundNetLog());
+  if (rv != ERR_IO_PENDING)
+    OnStarted(rv);
+}
+
+void HttpCache::AsyncValidation::OnStarted(int result) {
+  if (result != OK)
+    return Terminate();
+
+  buf_ = new IOBuffer(kAsyncValidationBufferSize);
+  DoRead();
+}
+
+void HttpCache::AsyncValidation::DoRead() {
+  int rv;
+  do {
+    rv = transaction_->Read(
+        buf_.get(), kAsyncValidationBufferSize,
+        base::Bind(&AsyncValidation::OnRead, base::Unretained(this)));
+  } while (rv > 0);
+
+  if (rv != ERR_IO_PENDING)
+    Terminate();
+}
+
+void HttpCache::AsyncValidation::OnRead(int result) {
+  if (result > 0)
+    return DoRead();
+  Terminate();
+}
+
+void HttpCache::AsyncValidation::Terminate() {
+  cache_->OnAsyncValidationComplete(this);
+}
+
+//-----------------------------------------------------------------------------
+
 class HttpCache::QuicServerInfoFactoryAdaptor : public QuicServerInfoFactory {
  public:
   QuicServerInfoFactoryAdaptor(HttpCache* http_cache)
@@ -290,6 +392,8 @@ HttpCache::HttpCache(const net::HttpNetworkSession::Params& params,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      shared_writing_enabled_(IsSharedWritingEnabled()),
+      use_stale_while_revalidate_(IsStaleWhileRevalidateEnabled()),
       quic_server_info_factory_(new QuicServerInfoFactoryAdaptor(this)),
       network_layer_(new HttpNetworkLayer(new HttpNetworkSession(params))) {
 }
@@ -301,6 +405,8 @@ HttpCache::HttpCache(HttpNetworkSession* session,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      shared_writing_enabled_(IsSharedWritingEnabled()),
+      use_stale_while_revalidate_(IsStaleWhileRevalidateEnabled()),
       quic_server_info_factory_(new QuicServerInfoFactoryAdaptor(this)),
       network_layer_(new HttpNetworkLayer(session)) {
 }
@@ -312,10 +418,16 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      shared_writing_enabled_(IsSharedWritingEnabled()),
+      use_stale_while_revalidate_(IsStaleWhileRevalidateEnabled()),
       network_layer_(network_layer) {
 }
 
 HttpCache::~HttpCache() {
+  // The revalidations own transactions, which have to leave their entries
+  // while the cache is still intact.
+  STLDeleteValues(&async_validations_);
+
   // If we have any active entries remaining, then we need to deactivate them.
   // We may have some pending calls to OnProcessPendingQueue, but since those
   // won't run (due to our destruction), we can simply ignore the corresponding
@@ -325,6 +437,7 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->shared_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -641,6 +754,7 @@ void HttpCache::FinalizeDoomedEntry(ActiveEntry* entry) {
   DCHECK(entry->doomed);
   DCHECK(!entry->writer);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->shared_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   ActiveEntriesSet::iterator it = doomed_entries_.find(entry);
@@ -669,6 +783,7 @@ void HttpCache::DeactivateEntry(ActiveEntry* entry) {
   DCHECK(!entry->writer);
   DCHECK(entry->disk_entry);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->shared_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   std::string key = entry->disk_entry->GetKey();
@@ -809,6 +924,15 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
+  //
+  // A transaction that would have to wait for the writer may instead read the
+  // response as the writer writes it, if the response can be shared.
+
+  if (CanAddSharedReader(entry, trans)) {
+    trans->BecomeSharedReader();
+    entry->shared_readers.push_back(trans);
+    return OK;
+  }
 
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
@@ -839,6 +963,9 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
 
 void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
+  if (RemoveSharedReader(entry, trans))
+    return;
+
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
   if (entry->will_process_pending_queue && entry->readers.empty())
@@ -851,6 +978,9 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
     bool success = false;
     if (cancel) {
       DCHECK(entry->disk_entry);
+      // The entry may be kept as truncated, but the shared readers will not
+      // get the whole response.
+      FailSharedReaders(entry);
       // This is a successful operation in the sense that we want to keep the
       // entry.
       success = trans->AddTruncatedFlag();
@@ -869,6 +999,16 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 
   entry->writer = NULL;
 
+  // The shared readers become regular readers of what was written.
+  if (!success)
+    FailSharedReaders(entry);
+  while (!entry->shared_readers.empty()) {
+    Transaction* reader = entry->shared_readers.front();
+    entry->shared_readers.pop_front();
+    entry->readers.push_back(reader);
+    reader->OnSharedWriterDone(success);
+  }
+
   if (success) {
     ProcessPendingQueue(entry);
   } else {
@@ -878,8 +1018,13 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else {
+      // The entry is destroyed when the former shared readers are done.
+      DoomActiveEntry(entry->disk_entry->GetKey());
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -892,6 +1037,9 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
+  if (RemoveSharedReader(entry, trans))
+    return;
+
   DCHECK(!entry->writer);
 
   TransactionList::iterator it =
@@ -916,6 +1064,88 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+bool HttpCache::CanAddSharedReader(ActiveEntry* entry, Transaction* trans) {
+  return shared_writing_enabled_ && entry->writer &&
+      !entry->will_process_pending_queue && !entry->doomed &&
+      entry->writer->CanShareResponse() && trans->CanReadWhileWriting();
+}
+
+void HttpCache::OnResponseDataWritten(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  if (!shared_writing_enabled_)
+    return;
+
+  for (TransactionList::iterator it = entry->shared_readers.begin();
+       it != entry->shared_readers.end(); ++it) {
+    (*it)->OnSharedWriterProgress();
+  }
+
+  // The transactions that were queued before the writer started writing the
+  // response do not have to wait for it anymore.
+  AddSharedReaderLater(entry);
+}
+
+void HttpCache::AddSharedReaderLater(ActiveEntry* entry) {
+  if (entry->will_add_shared_reader)
+    return;
+
+  TransactionList::iterator it = entry->pending_queue.begin();
+  for (; it != entry->pending_queue.end(); ++it) {
+    if (CanAddSharedReader(entry, *it))
+      break;
+  }
+  if (it == entry->pending_queue.end())
+    return;
+
+  entry->will_add_shared_reader = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&HttpCache::OnAddSharedReader, AsWeakPtr(),
+                 entry->disk_entry->GetKey()));
+}
+
+void HttpCache::PerformAsyncValidation(const HttpRequestInfo& request,
+                                       const BoundNetLog& net_log) {
+  DCHECK(use_stale_while_revalidate_);
+  std::string key = GenerateCacheKey(&request);
+  if (async_validations_.count(key))
+    return;
+
+  if (async_validations_.size() >= kMaxAsyncValidations) {
+    net_log.AddEvent(NetLog::TYPE_HTTP_CACHE_ASYNC_VALIDATION_DROPPED);
+    return;
+  }
+
+  AsyncValidation* validation = new AsyncValidation(request, key, this);
+  async_validations_[key] = validation;
+  validation->Start();
+}
+
+void HttpCache::OnAsyncValidationComplete(AsyncValidation* validation) {
+  AsyncValidationMap::iterator it = async_validations_.find(validation->key());
+  DCHECK(it != async_validations_.end());
+  DCHECK_EQ(validation, it->second);
+  async_validations_.erase(it);
+  delete validation;
+}
+
+void HttpCache::FailSharedReaders(ActiveEntry* entry) {
+  for (TransactionList::iterator it = entry->shared_readers.begin();
+       it != entry->shared_readers.end(); ++it) {
+    (*it)->OnSharedWriterDone(false);
+  }
+}
+
+bool HttpCache::RemoveSharedReader(ActiveEntry* entry, Transaction* trans) {
+  TransactionList::iterator it = std::find(entry->shared_readers.begin(),
+                                           entry->shared_readers.end(), trans);
+  if (it == entry->shared_readers.end())
+    return false;
+
+  entry->shared_readers.erase(it);
+  return true;
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1031,6 +1261,32 @@ void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   }
 }
 
+void HttpCache::OnAddSharedReader(const std::string& key) {
+  // The entry may be gone, and the writer may be done.
+  ActiveEntry* entry = FindActiveEntry(key);
+  if (!entry)
+    return;
+  entry->will_add_shared_reader = false;
+
+  TransactionList::iterator it = entry->pending_queue.begin();
+  for (; it != entry->pending_queue.end(); ++it) {
+    if (CanAddSharedReader(entry, *it))
+      break;
+  }
+  if (it == entry->pending_queue.end())
+    return;
+
+  // Like OnProcessPendingQueue, notify a single transaction at a time, because
+  // its callback may destroy other transactions.
+  Transaction* trans = *it;
+  entry->pending_queue.erase(it);
+  trans->BecomeSharedReader();
+  entry->shared_readers.push_back(trans);
+  AddSharedReaderLater(entry);
+
+  trans->io_callback().Run(OK);
+}
+
 void HttpCache::OnIOComplete(int result, PendingOp* pending_op) {
   WorkItemOperation op = pending_op->writer->operation();
 
@@ -15,6 +15,7 @@
 #define NET_HTTP_HTTP_CACHE_H_
 
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 
@@ -43,10 +44,12 @@ class Entry;
 
 namespace net {
 
+class BoundNetLog;
 class CertVerifier;
 class HostResolver;
 class HttpAuthHandlerFactory;
 class HttpNetworkSession;
+class HttpRequestInfo;
 class HttpResponseInfo;
 class HttpServerProperties;
 class IOBuffer;
@@ -218,6 +221,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
  private:
   // Types --------------------------------------------------------------------
 
+  class AsyncValidation;
   class MetadataWriter;
   class QuicServerInfoFactoryAdaptor;
   class Transaction;
@@ -235,8 +239,11 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     disk_cache::Entry* disk_entry;
     Transaction*       writer;
     TransactionList    readers;
+    // Readers of the response that |writer| is still writing.
+    TransactionList    shared_readers;
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
+    bool               will_add_shared_reader;
     bool               doomed;
   };
 
@@ -244,6 +251,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   typedef base::hash_map<std::string, PendingOp*> PendingOpsMap;
   typedef std::set<ActiveEntry*> ActiveEntriesSet;
   typedef base::hash_map<std::string, int> PlaybackCacheMap;
+  typedef std::map<std::string, AsyncValidation*> AsyncValidationMap;
 
   // Methods ------------------------------------------------------------------
 
@@ -340,6 +348,39 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Returns true if |trans| can read the response that the writer of |entry|
+  // is writing, without waiting for the writer to finish.
+  bool CanAddSharedReader(ActiveEntry* entry, Transaction* trans);
+
+  // Called by the writer of |entry| when it has appended response data to the
+  // entry. Wakes up the shared readers waiting for data, and lets the pending
+  // transactions that can read the response start reading it.
+  void OnResponseDataWritten(ActiveEntry* entry);
+
+  // Posts a task to add the first pending transaction of |entry| that can
+  // read the response being written to the shared readers.
+  void AddSharedReaderLater(ActiveEntry* entry);
+
+  // Tells the shared readers of |entry| that the writer will not write the
+  // whole response, so that they fail when they run out of data.
+  void FailSharedReaders(ActiveEntry* entry);
+
+  // Removes |trans| from the shared readers of |entry|, if it is one of them.
+  bool RemoveSharedReader(ActiveEntry* entry, Transaction* trans);
+
+  // Revalidates the entry of |request| with a background transaction, while
+  // the stale response is served. Does nothing if the entry is already being
+  // revalidated, or if too many revalidations are in progress.
+  void PerformAsyncValidation(const HttpRequestInfo& request,
+                              const BoundNetLog& net_log);
+
+  // Called by |validation| when it is done, to delete it.
+  void OnAsyncValidationComplete(AsyncValidation* validation);
+
+  bool use_stale_while_revalidate() const {
+    return use_stale_while_revalidate_;
+  }
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -362,6 +403,8 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   void OnProcessPendingQueue(ActiveEntry* entry);
 
+  void OnAddSharedReader(const std::string& key);
+
   // Callbacks ----------------------------------------------------------------
 
   // Processes BackendCallback notifications.
@@ -390,6 +433,13 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   Mode mode_;
 
+  // Whether transactions can read a response while it is being written.
+  const bool shared_writing_enabled_;
+
+  // Whether stale responses that allow it are served while they are
+  // revalidated in the background.
+  const bool use_stale_while_revalidate_;
+
   const scoped_ptr<QuicServerInfoFactoryAdaptor> quic_server_info_factory_;
 
   scoped_ptr<HttpTransactionFactory> network_layer_;
@@ -407,6 +457,9 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  // The background revalidations in progress, indexed by cache key.
+  AsyncValidationMap async_validations_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpCache);
 };
 
@@ -16,6 +16,7 @@
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
@@ -203,6 +204,9 @@ HttpCache::Transaction::Transaction(
       done_reading_(false),
       vary_mismatch_(false),
       couldnt_conditionalize_request_(false),
+      shared_reader_(false),
+      waiting_for_writer_(false),
+      shared_response_incomplete_(false),
       io_buf_len_(0),
       read_offset_(0),
       effective_load_flags_(0),
@@ -286,6 +290,50 @@ LoadState HttpCache::Transaction::GetWriterLoadState() const {
   return LOAD_STATE_WAITING_FOR_CACHE;
 }
 
+bool HttpCache::Transaction::CanShareResponse() const {
+  if (mode_ != WRITE || !entry_ || !reading_ || !network_trans_.get() ||
+      partial_.get() || truncated_ || !response_.headers.get()) {
+    return false;
+  }
+  if (response_.headers->response_code() != 200 ||
+      response_.vary_data.is_valid()) {
+    return false;
+  }
+  return !response_.headers->RequiresValidation(
+      response_.request_time, response_.response_time, Time::Now());
+}
+
+bool HttpCache::Transaction::CanReadWhileWriting() const {
+  if (mode_ != READ && mode_ != READ_WRITE)
+    return false;
+  if (partial_.get() || (effective_load_flags_ & LOAD_VALIDATE_CACHE))
+    return false;
+  return request_->method == "GET";
+}
+
+void HttpCache::Transaction::BecomeSharedReader() {
+  DCHECK(CanReadWhileWriting());
+  mode_ = READ;
+  shared_reader_ = true;
+}
+
+void HttpCache::Transaction::OnSharedWriterProgress() {
+  if (!waiting_for_writer_)
+    return;
+
+  // We are called by the writer, so resume reading from a fresh task.
+  waiting_for_writer_ = false;
+  base::MessageLoop::current()->PostTask(FROM_HERE,
+                                         base::Bind(io_callback_, OK));
+}
+
+void HttpCache::Transaction::OnSharedWriterDone(bool complete) {
+  shared_reader_ = false;
+  if (!complete)
+    shared_response_incomplete_ = true;
+  OnSharedWriterProgress();
+}
+
 const BoundNetLog& HttpCache::Transaction::net_log() const {
   return net_log_;
 }
@@ -449,6 +497,7 @@ void HttpCache::Transaction::StopCaching() {
   if (cache_.get() && entry_ && (mode_ & WRITE) && network_trans_.get() &&
       !is_sparse_ && !range_requested_) {
     mode_ = NONE;
+    cache_->FailSharedReaders(entry_);
   }
 }
 
@@ -1596,6 +1645,14 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   if (result > 0) {
     read_offset_ += result;
   } else if (result == 0) {  // End of file.
+    if (shared_reader_) {
+      // Wait for the writer to append more data, or to finish.
+      waiting_for_writer_ = true;
+      next_state_ = STATE_CACHE_READ_DATA;
+      return ERR_IO_PENDING;
+    }
+    if (shared_response_incomplete_)
+      return ERR_CACHE_READ_FAILURE;
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
@@ -1641,6 +1698,9 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  if (entry_ && result > 0)
+    cache_->OnResponseDataWritten(entry_);
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1820,6 +1880,12 @@ int HttpCache::Transaction::BeginCacheValidation() {
 
   bool skip_validation = !RequiresValidation();
 
+  if (!skip_validation && CanStaleWhileRevalidate()) {
+    net_log_.AddEvent(NetLog::TYPE_HTTP_CACHE_ASYNC_VALIDATION);
+    cache_->PerformAsyncValidation(*request_, net_log_);
+    skip_validation = true;
+  }
+
   if (truncated_) {
     // Truncated entries can cause partial gets, so we shouldn't record this
     // load in histograms.
@@ -2003,6 +2069,25 @@ bool HttpCache::Transaction::RequiresValidation() {
   return false;
 }
 
+bool HttpCache::Transaction::CanStaleWhileRevalidate() {
+  if (!cache_->use_stale_while_revalidate() || cache_->mode() != NORMAL)
+    return false;
+
+  // Byte ranges and truncated entries are validated with the network request
+  // that fetches the missing data.
+  if (partial_.get() || truncated_ || vary_mismatch_)
+    return false;
+
+  if (effective_load_flags_ & LOAD_VALIDATE_CACHE)
+    return false;
+
+  if (request_->method != "GET")
+    return false;
+
+  return response_.headers->CanStaleWhileRevalidate(
+      response_.request_time, response_.response_time, Time::Now());
+}
+
 bool HttpCache::Transaction::ConditionalizeRequest() {
   DCHECK(response_.headers.get());
 
@@ -101,6 +101,27 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Returns true if the transactions waiting for the entry of this writer can
+  // read the response while it is being written: the writer is reading a
+  // complete 200 response from the network, which a new request could use
+  // without validating it.
+  bool CanShareResponse() const;
+
+  // Returns true if this transaction would read the response stored in its
+  // entry as is, so that it can read it while another transaction writes it.
+  bool CanReadWhileWriting() const;
+
+  // Makes this transaction a reader of the response that the writer of its
+  // entry is writing.
+  void BecomeSharedReader();
+
+  // Called on a shared reader when the writer has appended data to the entry.
+  void OnSharedWriterProgress();
+
+  // Called on a shared reader when the writer is done with the entry, with
+  // |complete| set to false if the response was not entirely written.
+  void OnSharedWriterDone(bool complete);
+
   const BoundNetLog& net_log() const;
 
   // HttpTransaction methods:
@@ -302,6 +323,10 @@ class HttpCache::Transaction : public HttpTransaction {
   // Called to determine if we need to validate the cache entry before using it.
   bool RequiresValidation();
 
+  // Called when the cache entry requires validation, to determine if it can
+  // be used while it is revalidated in the background instead.
+  bool CanStaleWhileRevalidate();
+
   // Called to make the request conditional (to ask the server if the cached
   // copy is valid).  Returns true if able to make the request conditional.
   bool ConditionalizeRequest();
@@ -412,6 +437,9 @@ class HttpCache::Transaction : public HttpTransaction {
   bool done_reading_;  // All available data was read.
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
   bool couldnt_conditionalize_request_;
+  bool shared_reader_;  // The writer is still writing what we read.
+  bool waiting_for_writer_;  // We read all the data written so far.
+  bool shared_response_incomplete_;  // The writer did not write it all.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
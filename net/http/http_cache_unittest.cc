@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/memory/scoped_vector.h"
+#include "base/metrics/field_trial.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -117,6 +118,17 @@ void ReadAndVerifyTransaction(net::HttpTransaction* trans,
   EXPECT_EQ(expected, content);
 }
 
+// Reads up to |buf_len| bytes from |trans|, waiting for the result.
+int ReadSome(net::HttpTransaction* trans, int buf_len, std::string* result) {
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(buf_len));
+  net::TestCompletionCallback callback;
+  int rv = trans->Read(buf.get(), buf_len, callback.callback());
+  rv = callback.GetResult(rv);
+  if (rv > 0)
+    result->append(buf->data(), rv);
+  return rv;
+}
+
 void RunTransactionTestBase(net::HttpCache* cache,
                             const MockTransaction& trans_info,
                             const MockHttpRequest& request,
@@ -1194,6 +1206,57 @@ TEST(HttpCache, SimpleGET_LoadValidateCache_Implicit) {
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 }
 
+// Tests that a stale response that allows it is served from the cache while
+// it is revalidated in the background.
+TEST(HttpCache, SimpleGET_StaleWhileRevalidate) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("StaleWhileRevalidate", "Enabled");
+
+  MockHttpCache cache;
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=0, stale-while-revalidate=3600\n"
+      "Etag: \"foopy\"\n";
+
+  // Write to the cache.
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // The stale response is used right away.
+  net::HttpResponseInfo response;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response);
+  EXPECT_TRUE(response.was_cached);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // And the entry is revalidated after that.
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that stale responses are validated before they are used, unless
+// stale-while-revalidate is enabled.
+TEST(HttpCache, SimpleGET_StaleWhileRevalidateDisabled) {
+  MockHttpCache cache;
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers =
+      "Cache-Control: max-age=0, stale-while-revalidate=3600\n"
+      "Etag: \"foopy\"\n";
+
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  net::HttpResponseInfo response;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response);
+  EXPECT_FALSE(response.was_cached);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
 static void PreserveRequestHeaders_Handler(
     const net::HttpRequestInfo* request,
     std::string* response_status,
@@ -1305,6 +1368,98 @@ TEST(HttpCache, SimpleGET_ManyReaders) {
   }
 }
 
+// Tests that with shared writing, a reader streams the response from the
+// entry while the writer is still receiving it from the network.
+TEST(HttpCache, SimpleGET_SharedWriting) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("HttpCacheSharedWriting", "Enabled");
+
+  MockHttpCache cache;
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer.trans));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  ASSERT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  Context reader;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&reader.trans));
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::ERR_IO_PENDING, reader.result);
+
+  // The reader joins the entry once the writer has stored some data.
+  std::string written;
+  EXPECT_EQ(10, ReadSome(writer.trans.get(), 10, &written));
+  EXPECT_EQ(net::OK, reader.callback.WaitForResult());
+
+  std::string read;
+  EXPECT_EQ(10, ReadSome(reader.trans.get(), 10, &read));
+  EXPECT_EQ(written, read);
+
+  // Reading past what was written waits for the writer.
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback read_callback;
+  int rv = reader.trans->Read(buf.get(), 256, read_callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(read_callback.have_result());
+
+  std::string rest;
+  EXPECT_EQ(net::OK, ReadTransaction(writer.trans.get(), &rest));
+  written.append(rest);
+  EXPECT_EQ(kSimpleGET_Transaction.data, written);
+
+  rv = read_callback.WaitForResult();
+  ASSERT_GT(rv, 0);
+  read.append(buf->data(), rv);
+  std::string remaining;
+  EXPECT_EQ(net::OK, ReadTransaction(reader.trans.get(), &remaining));
+  read.append(remaining);
+  EXPECT_EQ(kSimpleGET_Transaction.data, read);
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a shared reader fails if the writer does not finish the response.
+TEST(HttpCache, SimpleGET_SharedWritingWriterCancelled) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("HttpCacheSharedWriting", "Enabled");
+
+  MockHttpCache cache;
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer.trans));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  ASSERT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  Context reader;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&reader.trans));
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  EXPECT_EQ(net::ERR_IO_PENDING, reader.result);
+
+  std::string written;
+  EXPECT_EQ(10, ReadSome(writer.trans.get(), 10, &written));
+  EXPECT_EQ(net::OK, reader.callback.WaitForResult());
+
+  std::string read;
+  EXPECT_EQ(10, ReadSome(reader.trans.get(), 10, &read));
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  net::TestCompletionCallback read_callback;
+  int rv = reader.trans->Read(buf.get(), 256, read_callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, read_callback.WaitForResult());
+}
+
 // This is a test for http://code.google.com/p/chromium/issues/detail?id=4769.
 // If cancelling a request is racing with another request for the same resource
 // finishing, we have to make sure that we remove both transactions from the
@@ -325,6 +325,17 @@ TEST(HttpChunkedDecoderTest, MultipleExtraDataBlocks) {
 }
 
 // Test when the line with the chunk length is too long.
+TEST(HttpChunkedDecoderTest, ExtraDataFollowsDecodedData) {
+  HttpChunkedDecoder decoder;
+  std::string input = "5\r\nhello\r\n1\r\n \r\n5\r\nworld\r\n0\r\n\r\nextra";
+  int n = decoder.FilterBuf(&input[0], static_cast<int>(input.size()));
+  ASSERT_EQ(11, n);
+  EXPECT_TRUE(decoder.reached_eof());
+  ASSERT_EQ(5, decoder.bytes_after_eof());
+  EXPECT_EQ("hello world", input.substr(0, n));
+  EXPECT_EQ("extra", input.substr(n, decoder.bytes_after_eof()));
+}
+
 TEST(HttpChunkedDecoderTest, LongChunkLengthLine) {
   int big_chunk_length = HttpChunkedDecoder::kMaxLineBufLen;
   scoped_ptr<char[]> big_chunk(new char[big_chunk_length + 1]);
@@ -81,12 +81,14 @@ HttpNetworkSession::Params::Params()
       spdy_initial_max_concurrent_streams(0),
       spdy_max_concurrent_streams_limit(0),
       time_func(&base::TimeTicks::Now),
+      enable_connection_demand_preconnects(false),
       enable_quic(false),
       enable_quic_https(false),
       enable_quic_port_selection(true),
       quic_clock(NULL),
       quic_random(NULL),
       quic_max_packet_length(kDefaultMaxPacketSize),
+      quic_max_server_configs_to_preload(0),
       enable_user_alternate_protocol_ports(false),
       quic_crypto_client_stream_factory(NULL) {
   quic_supported_versions.push_back(QUIC_VERSION_13);
@@ -142,6 +144,10 @@ HttpNetworkSession::HttpNetworkSession(const Params& params)
   DCHECK(proxy_service_);
   DCHECK(ssl_config_service_.get());
   CHECK(http_server_properties_);
+  if (params.enable_quic && params.quic_max_server_configs_to_preload > 0) {
+    quic_stream_factory_.PreloadServerConfigs(
+        params.quic_max_server_configs_to_preload);
+  }
 }
 
 HttpNetworkSession::~HttpNetworkSession() {
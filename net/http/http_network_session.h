@@ -88,6 +88,9 @@ class NET_EXPORT HttpNetworkSession
     size_t spdy_max_concurrent_streams_limit;
     SpdySessionPool::TimeFunc time_func;
     std::string trusted_spdy_proxy;
+    // Whether the stream factory should learn how many connections each
+    // origin needs at once, and preconnect that many when it is next used.
+    bool enable_connection_demand_preconnects;
     bool enable_quic;
     bool enable_quic_https;
     bool enable_quic_port_selection;
@@ -95,6 +98,9 @@ class NET_EXPORT HttpNetworkSession
     QuicClock* quic_clock;  // Will be owned by QuicStreamFactory.
     QuicRandom* quic_random;
     size_t quic_max_packet_length;
+    // The number of QUIC server configs to start loading from the disk cache
+    // when the session is created.
+    size_t quic_max_server_configs_to_preload;
     bool enable_user_alternate_protocol_ports;
     QuicCryptoClientStreamFactory* quic_crypto_client_stream_factory;
     QuicVersionVector quic_supported_versions;
@@ -121,6 +121,19 @@ bool ShouldShowHttpHeaderValue(const std::string& header_name) {
   return true;
 }
 
+// Returns a hash of a header name which doesn't depend on its case, for
+// FindHeader() to skip the headers which can't match without comparing them.
+template <typename Iterator>
+uint32 HashHeaderName(Iterator begin, Iterator end) {
+  // FNV-1a.
+  uint32 hash = 2166136261u;
+  for (; begin != end; ++begin) {
+    hash ^= static_cast<unsigned char>(base::ToLowerASCII(*begin));
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 }  // namespace
 
 const char HttpResponseHeaders::kContentRange[] = "Content-Range";
@@ -134,6 +147,9 @@ struct HttpResponseHeaders::ParsedHeader {
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
   std::string::const_iterator value_end;
+
+  // HashHeaderName() of the name, computed once when the headers are parsed.
+  uint32 name_hash;
 };
 
 //-----------------------------------------------------------------------------
@@ -718,8 +734,9 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const base::StringPiece& search) const {
+  uint32 search_hash = HashHeaderName(search.begin(), search.end());
   for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+    if (parsed_[i].is_continuation() || parsed_[i].name_hash != search_hash)
       continue;
     const std::string::const_iterator& name_begin = parsed_[i].name_begin;
     const std::string::const_iterator& name_end = parsed_[i].name_end;
@@ -759,6 +776,7 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
   header.name_end = name_end;
   header.value_begin = value_begin;
   header.value_end = value_end;
+  header.name_hash = HashHeaderName(name_begin, name_end);
   parsed_.push_back(header);
 }
 
@@ -919,6 +937,36 @@ bool HttpResponseHeaders::RequiresValidation(const Time& request_time,
   return lifetime <= GetCurrentAge(request_time, response_time, current_time);
 }
 
+// From RFC 5861 section 3:
+//
+//   When present in an HTTP response, the stale-while-revalidate Cache-Control
+//   extension indicates that caches MAY serve the response in which it
+//   appears after it becomes stale, up to the indicated number of seconds.
+//
+// Responses that must not be reused without validation are never served
+// stale.
+//
+bool HttpResponseHeaders::CanStaleWhileRevalidate(
+    const Time& request_time,
+    const Time& response_time,
+    const Time& current_time) const {
+  if (HasHeaderValue("cache-control", "no-cache") ||
+      HasHeaderValue("cache-control", "no-store") ||
+      HasHeaderValue("cache-control", "must-revalidate") ||
+      HasHeaderValue("pragma", "no-cache") ||
+      HasHeaderValue("vary", "*"))
+    return false;
+
+  TimeDelta stale_while_revalidate;
+  if (!GetStaleWhileRevalidateValue(&stale_while_revalidate) ||
+      stale_while_revalidate <= TimeDelta())
+    return false;
+
+  TimeDelta lifetime = GetFreshnessLifetime(response_time);
+  TimeDelta age = GetCurrentAge(request_time, response_time, current_time);
+  return lifetime <= age && age < lifetime + stale_while_revalidate;
+}
+
 // From RFC 2616 section 13.2.4:
 //
 // The max-age directive takes priority over Expires, so if max-age is present
@@ -1064,32 +1112,38 @@ TimeDelta HttpResponseHeaders::GetCurrentAge(const Time& request_time,
   return current_age;
 }
 
-bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
-  std::string name = "cache-control";
-  std::string value;
-
-  const char kMaxAgePrefix[] = "max-age=";
-  const size_t kMaxAgePrefixLen = arraysize(kMaxAgePrefix) - 1;
+bool HttpResponseHeaders::GetCacheControlDirective(const std::string& directive,
+                                                   TimeDelta* result) const {
+  const size_t directive_size = directive.size();
 
+  std::string value;
   void* iter = NULL;
-  while (EnumerateHeader(&iter, name, &value)) {
-    if (value.size() > kMaxAgePrefixLen) {
-      if (LowerCaseEqualsASCII(value.begin(),
-                               value.begin() + kMaxAgePrefixLen,
-                               kMaxAgePrefix)) {
-        int64 seconds;
-        base::StringToInt64(StringPiece(value.begin() + kMaxAgePrefixLen,
-                                        value.end()),
-                            &seconds);
-        *result = TimeDelta::FromSeconds(seconds);
-        return true;
-      }
+  while (EnumerateHeader(&iter, "cache-control", &value)) {
+    if (value.size() > directive_size &&
+        LowerCaseEqualsASCII(value.begin(),
+                             value.begin() + directive_size,
+                             directive.c_str())) {
+      int64 seconds;
+      base::StringToInt64(StringPiece(value.begin() + directive_size,
+                                      value.end()),
+                          &seconds);
+      *result = TimeDelta::FromSeconds(seconds);
+      return true;
     }
   }
 
   return false;
 }
 
+bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
+  return GetCacheControlDirective("max-age=", result);
+}
+
+bool HttpResponseHeaders::GetStaleWhileRevalidateValue(
+    TimeDelta* result) const {
+  return GetCacheControlDirective("stale-while-revalidate=", result);
+}
+
 bool HttpResponseHeaders::GetAgeValue(TimeDelta* result) const {
   std::string value;
   if (!EnumerateHeader(NULL, "Age", &value))
@@ -199,6 +199,14 @@ class NET_EXPORT HttpResponseHeaders
                           const base::Time& response_time,
                           const base::Time& current_time) const;
 
+  // Returns true if the response cannot be reused without validation, but may
+  // still be reused while it is revalidated in the background, as allowed by
+  // the stale-while-revalidate extension of RFC 5861.  See RequiresValidation
+  // for a description of this method's parameters.
+  bool CanStaleWhileRevalidate(const base::Time& request_time,
+                               const base::Time& response_time,
+                               const base::Time& current_time) const;
+
   // Returns the amount of time the server claims the response is fresh from
   // the time the response was generated.  See section 13.2.4 of RFC 2616.  See
   // RequiresValidation for a description of the response_time parameter.
@@ -214,6 +222,7 @@ class NET_EXPORT HttpResponseHeaders
   // value is not present, then false is returned.  Otherwise, true is returned
   // and the out param is assigned to the corresponding value.
   bool GetMaxAgeValue(base::TimeDelta* value) const;
+  bool GetStaleWhileRevalidateValue(base::TimeDelta* value) const;
   bool GetAgeValue(base::TimeDelta* value) const;
   bool GetDateValue(base::Time* value) const;
   bool GetLastModifiedValue(base::Time* value) const;
@@ -334,6 +343,12 @@ class NET_EXPORT HttpResponseHeaders
   // index |from|.  Returns string::npos if not found.
   size_t FindHeader(size_t from, const base::StringPiece& name) const;
 
+  // Finds the Cache-Control directive |directive|, which takes a number of
+  // seconds as its argument, e.g. "max-age=".  Returns false if it is not
+  // present.
+  bool GetCacheControlDirective(const std::string& directive,
+                                base::TimeDelta* result) const;
+
   // Add a header->value pair to our list.  If we already have header in our
   // list, append the value to it.
   void AddHeader(std::string::const_iterator name_begin,
@@ -0,0 +1,105 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumIterations = 10000;
+const int kWarmupRuns = 1;
+const int kNumRuns = 10;
+
+// Returns the headers of a typical response, with |extra_headers| more
+// made-up ones to make them as long as those of some sites.
+std::string MakeResponse(int extra_headers) {
+  std::string response =
+      "HTTP/1.1 200 OK\r\n"
+      "Date: Tue, 04 Mar 2014 10:00:00 GMT\r\n"
+      "Server: Apache\r\n"
+      "Cache-Control: private, max-age=0, must-revalidate\r\n"
+      "Expires: Tue, 04 Mar 2014 10:00:00 GMT\r\n"
+      "Last-Modified: Mon, 03 Mar 2014 10:00:00 GMT\r\n"
+      "ETag: \"4f2a-1234567890\"\r\n"
+      "Vary: Accept-Encoding\r\n"
+      "Content-Encoding: gzip\r\n"
+      "Content-Type: text/html; charset=UTF-8\r\n"
+      "Set-Cookie: a=b; path=/; HttpOnly\r\n"
+      "Set-Cookie: c=d; path=/; expires=Wed, 05 Mar 2014 10:00:00 GMT\r\n";
+  for (int i = 0; i < extra_headers; ++i)
+    base::StringAppendF(&response, "X-Header-%d: value %d\r\n", i, i);
+  response.append("Content-Length: 1234\r\n\r\n");
+  return response;
+}
+
+void LocateEndOfHeaders(const std::string& response) {
+  int length = static_cast<int>(response.size());
+  for (int i = 0; i < kNumIterations; ++i)
+    EXPECT_EQ(length, HttpUtil::LocateEndOfHeaders(response.data(), length));
+}
+
+void Parse(const std::string& raw_headers) {
+  for (int i = 0; i < kNumIterations; ++i) {
+    scoped_refptr<HttpResponseHeaders> headers(
+        new HttpResponseHeaders(raw_headers));
+    EXPECT_EQ(200, headers->response_code());
+  }
+}
+
+void GetNormalizedHeaders(
+    const scoped_refptr<HttpResponseHeaders>& headers) {
+  // The lookups of a response on its way through the cache and the network
+  // stack, most of which are for headers it doesn't have.
+  const char* const kNames[] = {
+    "cache-control", "pragma", "vary", "content-length", "content-range",
+    "content-encoding", "transfer-encoding", "connection", "location",
+    "www-authenticate", "strict-transport-security", "x-frame-options",
+  };
+
+  std::string value;
+  for (int i = 0; i < kNumIterations; ++i) {
+    for (size_t j = 0; j < arraysize(kNames); ++j)
+      headers->GetNormalizedHeader(kNames[j], &value);
+  }
+}
+
+}  // namespace
+
+TEST(HttpResponseHeadersPerfTest, LocateEndOfHeaders) {
+  base::LogPerfTimeOfRuns("HTTP locating the end of headers",
+                          base::Bind(&LocateEndOfHeaders, MakeResponse(20)),
+                          kWarmupRuns, kNumRuns);
+}
+
+TEST(HttpResponseHeadersPerfTest, Parse) {
+  std::string response = MakeResponse(20);
+  std::string raw_headers = HttpUtil::AssembleRawHeaders(
+      response.data(), static_cast<int>(response.size()));
+
+  base::LogPerfTimeOfRuns("HTTP response headers parsing",
+                          base::Bind(&Parse, raw_headers),
+                          kWarmupRuns, kNumRuns);
+}
+
+TEST(HttpResponseHeadersPerfTest, GetNormalizedHeader) {
+  std::string response = MakeResponse(20);
+  scoped_refptr<HttpResponseHeaders> headers(new HttpResponseHeaders(
+      HttpUtil::AssembleRawHeaders(response.data(),
+                                   static_cast<int>(response.size()))));
+
+  base::LogPerfTimeOfRuns("HTTP response headers lookups",
+                          base::Bind(&GetNormalizedHeaders, headers),
+                          kWarmupRuns, kNumRuns);
+}
+
+}  // namespace net
@@ -872,6 +872,74 @@ TEST(HttpResponseHeadersTest, RequiresValidation) {
   }
 }
 
+TEST(HttpResponseHeadersTest, CanStaleWhileRevalidate) {
+  const struct {
+    const char* headers;
+    bool can_stale_while_revalidate;
+  } tests[] = {
+    // fresh: no need to revalidate
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=10000, stale-while-revalidate=10000\n"
+      "\n",
+      false
+    },
+    // stale, within the stale-while-revalidate window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=100, stale-while-revalidate=10000\n"
+      "\n",
+      true
+    },
+    // stale, past the stale-while-revalidate window
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=100, stale-while-revalidate=100\n"
+      "\n",
+      false
+    },
+    // expired already, within the window
+    { "HTTP/1.1 200 OK\n"
+      "date: Wed, 28 Nov 2007 00:40:11 GMT\n"
+      "expires: Wed, 28 Nov 2007 00:00:00 GMT\n"
+      "cache-control: stale-while-revalidate=10000\n"
+      "\n",
+      true
+    },
+    // stale, without stale-while-revalidate
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=100\n"
+      "\n",
+      false
+    },
+    // must-revalidate forbids serving a stale response
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: max-age=100, stale-while-revalidate=10000\n"
+      "cache-control: must-revalidate\n"
+      "\n",
+      false
+    },
+    // no-cache forbids serving a stored response without validation
+    { "HTTP/1.1 200 OK\n"
+      "cache-control: no-cache, stale-while-revalidate=10000\n"
+      "\n",
+      false
+    },
+  };
+  base::Time request_time, response_time, current_time;
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:09 GMT", &request_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:40:12 GMT", &response_time);
+  base::Time::FromString("Wed, 28 Nov 2007 00:45:20 GMT", &current_time);
+
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(tests); ++i) {
+    std::string headers(tests[i].headers);
+    HeadersToRaw(&headers);
+    scoped_refptr<net::HttpResponseHeaders> parsed(
+        new net::HttpResponseHeaders(headers));
+
+    EXPECT_EQ(tests[i].can_stale_while_revalidate,
+              parsed->CanStaleWhileRevalidate(request_time, response_time,
+                                              current_time)) << i;
+  }
+}
+
 TEST(HttpResponseHeadersTest, Update) {
   const struct {
     const char* orig_headers;
@@ -144,6 +144,17 @@ class NET_EXPORT HttpServerProperties {
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const = 0;
 
+  // Records that |host_port_pair| has been seen to need |num_connections|
+  // connections at once.
+  virtual void SetConcurrentConnectionDemand(
+      const HostPortPair& host_port_pair,
+      int num_connections) = 0;
+
+  // Returns the number of connections |host_port_pair| has been seen to need
+  // at once, or 0 if it is not known.
+  virtual int GetConcurrentConnectionDemand(
+      const HostPortPair& host_port_pair) = 0;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) = 0;
 
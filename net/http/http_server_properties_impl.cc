@@ -21,6 +21,7 @@ static const int kDefaultNumHostsToRemember = 200;
 HttpServerPropertiesImpl::HttpServerPropertiesImpl()
     : pipeline_capability_map_(
         new CachedPipelineCapabilityMap(kDefaultNumHostsToRemember)),
+      connection_demand_map_(kDefaultNumHostsToRemember),
       weak_ptr_factory_(this) {
   canoncial_suffixes_.push_back(".c.youtube.com");
   canoncial_suffixes_.push_back(".googlevideo.com");
@@ -150,6 +151,7 @@ void HttpServerPropertiesImpl::Clear() {
   alternate_protocol_map_.clear();
   spdy_settings_map_.clear();
   pipeline_capability_map_->Clear();
+  connection_demand_map_.Clear();
 }
 
 bool HttpServerPropertiesImpl::SupportsSpdy(
@@ -326,6 +328,22 @@ HttpServerPropertiesImpl::GetServerNetworkStats(
   return &it->second;
 }
 
+void HttpServerPropertiesImpl::SetConcurrentConnectionDemand(
+    const HostPortPair& host_port_pair,
+    int num_connections) {
+  DCHECK_GE(num_connections, 0);
+  connection_demand_map_.Put(host_port_pair, num_connections);
+}
+
+int HttpServerPropertiesImpl::GetConcurrentConnectionDemand(
+    const HostPortPair& host_port_pair) {
+  ConnectionDemandMap::const_iterator it =
+      connection_demand_map_.Get(host_port_pair);
+  if (it == connection_demand_map_.end())
+    return 0;
+  return it->second;
+}
+
 HttpPipelinedHostCapability HttpServerPropertiesImpl::GetPipelineCapability(
     const HostPortPair& origin) {
   HttpPipelinedHostCapability capability = PIPELINE_UNKNOWN;
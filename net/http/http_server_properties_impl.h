@@ -133,6 +133,13 @@ class NET_EXPORT HttpServerPropertiesImpl
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetConcurrentConnectionDemand(
+      const HostPortPair& host_port_pair,
+      int num_connections) OVERRIDE;
+
+  virtual int GetConcurrentConnectionDemand(
+      const HostPortPair& host_port_pair) OVERRIDE;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) OVERRIDE;
 
@@ -147,6 +154,7 @@ class NET_EXPORT HttpServerPropertiesImpl
  private:
   typedef base::MRUCache<
       HostPortPair, HttpPipelinedHostCapability> CachedPipelineCapabilityMap;
+  typedef base::MRUCache<HostPortPair, int> ConnectionDemandMap;
   // |spdy_servers_table_| has flattened representation of servers (host/port
   // pair) that either support or not support SPDY protocol.
   typedef base::hash_map<std::string, bool> SpdyServerHostPortTable;
@@ -163,6 +171,7 @@ class NET_EXPORT HttpServerPropertiesImpl
   SpdySettingsMap spdy_settings_map_;
   ServerNetworkStatsMap server_network_stats_map_;
   scoped_ptr<CachedPipelineCapabilityMap> pipeline_capability_map_;
+  ConnectionDemandMap connection_demand_map_;
   // Contains a map of servers which could share the same alternate protocol.
   // Map from a Canonical host/port (host is some postfix of host names) to an
   // actual origin, which has a plausible alternate protocol mapping.
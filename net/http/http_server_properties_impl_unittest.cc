@@ -433,6 +433,24 @@ TEST_F(SpdySettingsServerPropertiesTest, Clear) {
   EXPECT_EQ(0U, impl_.GetSpdySettings(spdy_server_docs).size());
 }
 
+typedef HttpServerPropertiesImplTest ConnectionDemandServerPropertiesTest;
+
+TEST_F(ConnectionDemandServerPropertiesTest, SetConcurrentConnectionDemand) {
+  HostPortPair test_host_port_pair("foo", 80);
+  EXPECT_EQ(0, impl_.GetConcurrentConnectionDemand(test_host_port_pair));
+
+  impl_.SetConcurrentConnectionDemand(test_host_port_pair, 4);
+  EXPECT_EQ(4, impl_.GetConcurrentConnectionDemand(test_host_port_pair));
+  impl_.SetConcurrentConnectionDemand(test_host_port_pair, 2);
+  EXPECT_EQ(2, impl_.GetConcurrentConnectionDemand(test_host_port_pair));
+
+  HostPortPair test_host_port_pair2("foo", 443);
+  EXPECT_EQ(0, impl_.GetConcurrentConnectionDemand(test_host_port_pair2));
+
+  impl_.Clear();
+  EXPECT_EQ(0, impl_.GetConcurrentConnectionDemand(test_host_port_pair));
+}
+
 }  // namespace
 
 }  // namespace net
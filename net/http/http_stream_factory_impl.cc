@@ -4,6 +4,7 @@
 
 #include "net/http/http_stream_factory_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/logging.h"
@@ -116,6 +117,8 @@ HttpStreamRequest* HttpStreamFactoryImpl::RequestStreamInternal(
                                  delegate,
                                  websocket_handshake_stream_create_helper,
                                  net_log);
+  OnRequestStarted(request_info, priority, server_ssl_config,
+                   proxy_ssl_config);
 
   GURL alternate_url;
   PortAlternateProtocolPair alternate =
@@ -252,6 +255,63 @@ PortAlternateProtocolPair HttpStreamFactoryImpl::GetAlternateProtocolRequestFor(
   return alternate;
 }
 
+void HttpStreamFactoryImpl::OnRequestStarted(
+    const HttpRequestInfo& request_info,
+    RequestPriority priority,
+    const SSLConfig& server_ssl_config,
+    const SSLConfig& proxy_ssl_config) {
+  if (for_websockets_ ||
+      !session_->params().enable_connection_demand_preconnects) {
+    return;
+  }
+
+  HostPortPair origin = HostPortPair::FromURL(request_info.url);
+  OriginDemand& demand = origin_demand_map_[origin];
+  ++demand.num_requests;
+  demand.peak_num_requests =
+      std::max(demand.peak_num_requests, demand.num_requests);
+  if (demand.num_requests > 1)
+    return;
+
+  // Only the first request of a burst preconnects.  A SPDY server multiplexes
+  // the burst over one connection anyway.
+  base::WeakPtr<HttpServerProperties> http_server_properties =
+      session_->http_server_properties();
+  if (!http_server_properties || http_server_properties->SupportsSpdy(origin))
+    return;
+  int num_connections =
+      http_server_properties->GetConcurrentConnectionDemand(origin);
+  if (num_connections > 1) {
+    PreconnectStreams(num_connections, request_info, priority,
+                      server_ssl_config, proxy_ssl_config);
+  }
+}
+
+void HttpStreamFactoryImpl::OnRequestFinished(const GURL& url) {
+  OriginDemandMap::iterator it =
+      origin_demand_map_.find(HostPortPair::FromURL(url));
+  if (it == origin_demand_map_.end())
+    return;
+  DCHECK_GT(it->second.num_requests, 0);
+  if (--it->second.num_requests > 0)
+    return;
+
+  // Average with what was learned before, so that one unusual page doesn't
+  // decide how many connections are opened next time.
+  int peak_num_requests = it->second.peak_num_requests;
+  HostPortPair origin = it->first;
+  origin_demand_map_.erase(it);
+  base::WeakPtr<HttpServerProperties> http_server_properties =
+      session_->http_server_properties();
+  if (!http_server_properties)
+    return;
+  int previous = http_server_properties->GetConcurrentConnectionDemand(origin);
+  int num_connections = previous == 0 ?
+      peak_num_requests : (previous + peak_num_requests + 1) / 2;
+  http_server_properties->SetConcurrentConnectionDemand(origin,
+                                                        num_connections);
+}
+
 void HttpStreamFactoryImpl::OrphanJob(Job* job, const Request* request) {
   DCHECK(ContainsKey(request_map_, job));
   DCHECK_EQ(request_map_[job], request);
@@ -79,6 +79,16 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
   typedef std::map<HttpPipelinedHost::Key,
                    RequestVector> HttpPipeliningRequestMap;
 
+  // The stream requests in flight for an origin, and the most there have
+  // been at once since the origin was last idle.
+  struct OriginDemand {
+    OriginDemand() : num_requests(0), peak_num_requests(0) {}
+
+    int num_requests;
+    int peak_num_requests;
+  };
+  typedef std::map<HostPortPair, OriginDemand> OriginDemandMap;
+
   HttpStreamRequest* RequestStreamInternal(
       const HttpRequestInfo& info,
       RequestPriority priority,
@@ -92,6 +102,18 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
       const GURL& original_url,
       GURL* alternate_url) const;
 
+  // Called when a Request for |request_info| is created.  If the origin was
+  // idle, and has been seen to need more than one connection at once,
+  // preconnects that many so the handshakes overlap.
+  void OnRequestStarted(const HttpRequestInfo& request_info,
+                        RequestPriority priority,
+                        const SSLConfig& server_ssl_config,
+                        const SSLConfig& proxy_ssl_config);
+
+  // Called when a Request for |url| is destroyed.  Once the origin is idle
+  // again, records the connection demand it saw in HttpServerProperties.
+  void OnRequestFinished(const GURL& url);
+
   // Detaches |job| from |request|.
   void OrphanJob(Job* job, const Request* request);
 
@@ -138,6 +160,10 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl :
 
   HttpPipelinedHostPool http_pipelined_host_pool_;
 
+  // Connection demand of the origins with requests in flight.  Only used when
+  // |enable_connection_demand_preconnects| is set.
+  OriginDemandMap origin_demand_map_;
+
   // These jobs correspond to jobs orphaned by Requests and now owned by
   // HttpStreamFactoryImpl. Since they are no longer tied to Requests, they will
   // not be canceled when Requests are canceled. Therefore, in
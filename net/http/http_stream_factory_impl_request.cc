@@ -51,6 +51,8 @@ HttpStreamFactoryImpl::Request::~Request() {
   RemoveRequestFromHttpPipeliningRequestMap();
 
   STLDeleteElements(&jobs_);
+
+  factory_->OnRequestFinished(url_);
 }
 
 void HttpStreamFactoryImpl::Request::SetSpdySessionKey(
@@ -824,6 +824,98 @@ TEST_P(HttpStreamFactoryTest, RequestHttpStream) {
   EXPECT_TRUE(waiter.used_proxy_info().is_direct());
 }
 
+// Overlapping stream requests for an origin are remembered as the number of
+// connections it needs at once.
+TEST_P(HttpStreamFactoryTest, LearnsConcurrentConnectionDemand) {
+  SpdySessionDependencies session_deps(
+      GetParam(), ProxyService::CreateDirect());
+
+  StaticSocketDataProvider socket_data1;
+  socket_data1.set_connect_data(MockConnect(ASYNC, OK));
+  session_deps.socket_factory->AddSocketDataProvider(&socket_data1);
+  StaticSocketDataProvider socket_data2;
+  socket_data2.set_connect_data(MockConnect(ASYNC, OK));
+  session_deps.socket_factory->AddSocketDataProvider(&socket_data2);
+
+  HttpNetworkSession::Params params =
+      SpdySessionDependencies::CreateSessionParams(&session_deps);
+  params.enable_connection_demand_preconnects = true;
+  scoped_refptr<HttpNetworkSession> session(new HttpNetworkSession(params));
+
+  HttpRequestInfo request_info;
+  request_info.method = "GET";
+  request_info.url = GURL("http://www.google.com");
+  request_info.load_flags = 0;
+
+  SSLConfig ssl_config;
+  StreamRequestWaiter waiter1;
+  scoped_ptr<HttpStreamRequest> request1(
+      session->http_stream_factory()->RequestStream(
+          request_info,
+          DEFAULT_PRIORITY,
+          ssl_config,
+          ssl_config,
+          &waiter1,
+          BoundNetLog()));
+  StreamRequestWaiter waiter2;
+  scoped_ptr<HttpStreamRequest> request2(
+      session->http_stream_factory()->RequestStream(
+          request_info,
+          DEFAULT_PRIORITY,
+          ssl_config,
+          ssl_config,
+          &waiter2,
+          BoundNetLog()));
+  waiter1.WaitForStream();
+  waiter2.WaitForStream();
+  EXPECT_TRUE(waiter1.stream_done());
+  EXPECT_TRUE(waiter2.stream_done());
+
+  HostPortPair origin("www.google.com", 80);
+  HttpServerProperties* http_server_properties =
+      session->http_server_properties().get();
+  request1.reset();
+  // Nothing is recorded while a request is still in flight.
+  EXPECT_EQ(0, http_server_properties->GetConcurrentConnectionDemand(origin));
+  request2.reset();
+  EXPECT_EQ(2, http_server_properties->GetConcurrentConnectionDemand(origin));
+}
+
+// Without |enable_connection_demand_preconnects|, nothing is learned.
+TEST_P(HttpStreamFactoryTest, ConnectionDemandNotLearnedByDefault) {
+  SpdySessionDependencies session_deps(
+      GetParam(), ProxyService::CreateDirect());
+
+  StaticSocketDataProvider socket_data;
+  socket_data.set_connect_data(MockConnect(ASYNC, OK));
+  session_deps.socket_factory->AddSocketDataProvider(&socket_data);
+
+  scoped_refptr<HttpNetworkSession> session(
+      SpdySessionDependencies::SpdyCreateSession(&session_deps));
+
+  HttpRequestInfo request_info;
+  request_info.method = "GET";
+  request_info.url = GURL("http://www.google.com");
+  request_info.load_flags = 0;
+
+  SSLConfig ssl_config;
+  StreamRequestWaiter waiter;
+  scoped_ptr<HttpStreamRequest> request(
+      session->http_stream_factory()->RequestStream(
+          request_info,
+          DEFAULT_PRIORITY,
+          ssl_config,
+          ssl_config,
+          &waiter,
+          BoundNetLog()));
+  waiter.WaitForStream();
+  EXPECT_TRUE(waiter.stream_done());
+  request.reset();
+
+  EXPECT_EQ(0, session->http_server_properties()->GetConcurrentConnectionDemand(
+      HostPortPair("www.google.com", 80)));
+}
+
 TEST_P(HttpStreamFactoryTest, RequestHttpStreamOverSSL) {
   SpdySessionDependencies session_deps(
       GetParam(), ProxyService::CreateDirect());
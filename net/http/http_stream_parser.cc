@@ -179,6 +179,7 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
       read_buf_(read_buffer),
       read_buf_unused_offset_(0),
       response_header_start_offset_(-1),
+      response_header_search_offset_(0),
       received_bytes_(0),
       response_body_length_(-1),
       response_body_read_(0),
@@ -610,6 +611,7 @@ int HttpStreamParser::DoReadHeadersComplete(int result) {
         // response and reject it in the event that we're setting up a CONNECT
         // tunnel.
         response_header_start_offset_ = -1;
+        response_header_search_offset_ = 0;
         response_body_length_ = -1;
         io_state_ = STATE_REQUEST_SENT;
       } else {
@@ -770,9 +772,17 @@ int HttpStreamParser::ParseResponseHeaders() {
   }
 
   if (response_header_start_offset_ >= 0) {
+    // Don't search again the bytes of earlier reads, other than those which
+    // may begin an end-of-headers marker split across reads.
+    int search_offset = std::max(response_header_start_offset_,
+                                 response_header_search_offset_);
     end_offset = HttpUtil::LocateEndOfHeaders(read_buf_->StartOfBuffer(),
                                               read_buf_->offset(),
-                                              response_header_start_offset_);
+                                              search_offset);
+    if (end_offset == -1) {
+      response_header_search_offset_ =
+          std::max(response_header_start_offset_, read_buf_->offset() - 2);
+    }
   } else if (read_buf_->offset() >= 8) {
     // Enough data to decide that this is an HTTP/0.9 response.
     // 8 bytes = (4 bytes of junk) + "http".length()
@@ -188,6 +188,10 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   // -1 if not found yet.
   int response_header_start_offset_;
 
+  // The amount beyond |read_buf_unused_offset_| where the search for the end
+  // of the headers resumes after the next read.
+  int response_header_search_offset_;
+
   // The amount of received data.  If connection is reused then intermediate
   // value may be bigger than final.
   int64 received_bytes_;
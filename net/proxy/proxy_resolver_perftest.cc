@@ -5,13 +5,16 @@
 #include "base/base_paths.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
+#include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "base/test/perf_time_logger.h"
 #include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver_v8.h"
+#include "net/proxy/proxy_resolver_v8_tracing.h"
 #include "net/test/spawned_test_server/spawned_test_server.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -77,7 +80,7 @@ int PacPerfTest::NumQueries() const {
 const int kNumIterations = 500;
 
 // Helper class to run through all the performance tests using the specified
-// proxy resolver implementation.
+// proxy resolver implementation. Asynchronous resolvers need a message loop.
 class PacPerfSuiteRunner {
  public:
   // |resolver_name| is the label used when logging the results.
@@ -109,10 +112,11 @@ class PacPerfSuiteRunner {
     if (!resolver_->expects_pac_bytes()) {
       GURL pac_url =
           test_server_.GetURL(std::string("files/") + script_name);
+      net::TestCompletionCallback callback;
       int rv = resolver_->SetPacScript(
           net::ProxyResolverScriptData::FromURL(pac_url),
-          net::CompletionCallback());
-      EXPECT_EQ(net::OK, rv);
+          callback.callback());
+      EXPECT_EQ(net::OK, callback.GetResult(rv));
     } else {
       LoadPacScriptIntoResolver(script_name);
     }
@@ -122,10 +126,11 @@ class PacPerfSuiteRunner {
     // the PAC script.
     {
       net::ProxyInfo proxy_info;
+      net::TestCompletionCallback callback;
       int result = resolver_->GetProxyForURL(
-          GURL("http://www.warmup.com"), &proxy_info, net::CompletionCallback(),
+          GURL("http://www.warmup.com"), &proxy_info, callback.callback(),
           NULL, net::BoundNetLog());
-      ASSERT_EQ(net::OK, result);
+      ASSERT_EQ(net::OK, callback.GetResult(result));
     }
 
     // Start the perf timer.
@@ -138,13 +143,14 @@ class PacPerfSuiteRunner {
 
       // Resolve.
       net::ProxyInfo proxy_info;
+      net::TestCompletionCallback callback;
       int result = resolver_->GetProxyForURL(
-          GURL(query.query_url), &proxy_info, net::CompletionCallback(), NULL,
+          GURL(query.query_url), &proxy_info, callback.callback(), NULL,
           net::BoundNetLog());
 
       // Check that the result was correct. Note that ToPacString() and
       // ASSERT_EQ() are fast, so they won't skew the results.
-      ASSERT_EQ(net::OK, result);
+      ASSERT_EQ(net::OK, callback.GetResult(result));
       ASSERT_EQ(query.expected_result, proxy_info.ToPacString());
     }
 
@@ -170,10 +176,11 @@ class PacPerfSuiteRunner {
     ASSERT_TRUE(ok);
 
     // Load the PAC script into the ProxyResolver.
+    net::TestCompletionCallback callback;
     int rv = resolver_->SetPacScript(
         net::ProxyResolverScriptData::FromUTF8(file_contents),
-        net::CompletionCallback());
-    EXPECT_EQ(net::OK, rv);
+        callback.callback());
+    EXPECT_EQ(net::OK, callback.GetResult(rv));
   }
 
   net::ProxyResolver* resolver_;
@@ -227,3 +234,26 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
   PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8");
   runner.RunAllTests();
 }
+
+TEST(ProxyResolverPerfTest, ProxyResolverV8Tracing) {
+  // This has to be done on the main thread.
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  base::MessageLoop message_loop;
+  net::MockHostResolver host_resolver;
+  net::ProxyResolverV8Tracing resolver(&host_resolver, NULL, NULL);
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8Tracing");
+  runner.RunAllTests();
+}
+
+TEST(ProxyResolverPerfTest, ProxyResolverV8TracingWithResultCache) {
+  // This has to be done on the main thread.
+  net::ProxyResolverV8::RememberDefaultIsolate();
+
+  base::MessageLoop message_loop;
+  net::MockHostResolver host_resolver;
+  net::ProxyResolverV8Tracing resolver(&host_resolver, NULL, NULL);
+  resolver.EnableResultCache();
+  PacPerfSuiteRunner runner(&resolver, "ProxyResolverV8TracingWithResultCache");
+  runner.RunAllTests();
+}
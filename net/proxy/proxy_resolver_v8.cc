@@ -336,6 +336,65 @@ bool IsInNetEx(const std::string& ip_address, const std::string& ip_prefix) {
   return IPNumberMatchesPrefix(address, prefix, prefix_length_in_bits);
 }
 
+bool IsIdentifierChar(char c) {
+  return IsAsciiAlpha(c) || IsAsciiDigit(c) || c == '_' || c == '$';
+}
+
+// Returns true if |name| appears in |source| as a whole identifier.
+bool ContainsIdentifier(const std::string& source, const std::string& name) {
+  for (size_t pos = source.find(name); pos != std::string::npos;
+       pos = source.find(name, pos + 1)) {
+    const size_t end = pos + name.size();
+    if ((pos == 0 || !IsIdentifierChar(source[pos - 1])) &&
+        (end == source.size() || !IsIdentifierChar(source[end])))
+      return true;
+  }
+  return false;
+}
+
+// Guesses from the |source| of FindProxyForURL() whether it reads its first
+// argument, the URL. Returns true when in doubt, since the URL carries the
+// path and query which the host argument doesn't.
+bool FunctionReadsFirstArgument(const base::string16& source16) {
+  if (!IsStringASCII(source16))
+    return true;
+  const std::string source = UTF16ToASCII(source16);
+
+  const size_t params_start = source.find('(');
+  if (params_start == std::string::npos)
+    return true;
+  const size_t params_end = source.find(')', params_start);
+  if (params_end == std::string::npos)
+    return true;
+  const size_t body_start = source.find('{', params_end);
+  if (body_start == std::string::npos)
+    return true;
+
+  const std::string params =
+      source.substr(params_start + 1, params_end - params_start - 1);
+  std::string first_param;
+  TrimWhitespaceASCII(params.substr(0, params.find(',')), TRIM_ALL,
+                      &first_param);
+  const std::string body = source.substr(body_start);
+  return (!first_param.empty() && ContainsIdentifier(body, first_param)) ||
+         ContainsIdentifier(body, "arguments") ||
+         ContainsIdentifier(body, "eval");
+}
+
+// Returns true if |script| might read the clock or random numbers, which
+// would make the results of FindProxyForURL() change over time.
+bool ScriptMayReadTime(const base::string16& script) {
+  const char* const kTimeNames[] = {
+    "Date", "dateRange", "timeRange", "weekdayRange", "random",
+  };
+  for (size_t i = 0; i < arraysize(kTimeNames); ++i) {
+    if (script.find(base::ASCIIToUTF16(kTimeNames[i])) !=
+        base::string16::npos)
+      return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 // ProxyResolverV8::Context ---------------------------------------------------
@@ -344,7 +403,9 @@ class ProxyResolverV8::Context {
  public:
   Context(ProxyResolverV8* parent, v8::Isolate* isolate)
       : parent_(parent),
-        isolate_(isolate) {
+        isolate_(isolate),
+        reads_url_(true),
+        reads_time_(true) {
     DCHECK(isolate);
   }
 
@@ -501,9 +562,21 @@ class ProxyResolverV8::Context {
       return ERR_PAC_SCRIPT_FAILED;
     }
 
+    {
+      // The script may have replaced the toString() of functions.
+      v8::TryCatch try_catch;
+      v8::Local<v8::String> source = function->ToString();
+      if (!try_catch.HasCaught() && !source.IsEmpty())
+        reads_url_ = FunctionReadsFirstArgument(V8StringToUTF16(source));
+    }
+    reads_time_ = ScriptMayReadTime(pac_script->utf16());
+
     return OK;
   }
 
+  bool reads_url() const { return reads_url_; }
+  bool reads_time() const { return reads_time_; }
+
   void PurgeMemory() {
     v8::Locker locked(isolate_);
     v8::Isolate::Scope isolate_scope(isolate_);
@@ -708,6 +781,10 @@ class ProxyResolverV8::Context {
   v8::Isolate* isolate_;
   v8::Persistent<v8::External> v8_this_;
   v8::Persistent<v8::Context> v8_context_;
+
+  // Guessed from the source of the script by InitV8().
+  bool reads_url_;
+  bool reads_time_;
 };
 
 // ProxyResolverV8 ------------------------------------------------------------
@@ -756,6 +833,14 @@ void ProxyResolverV8::PurgeMemory() {
     context_->PurgeMemory();
 }
 
+bool ProxyResolverV8::ScriptReadsUrl() const {
+  return !context_ || context_->reads_url();
+}
+
+bool ProxyResolverV8::ScriptReadsTime() const {
+  return !context_ || context_->reads_time();
+}
+
 int ProxyResolverV8::SetPacScript(
     const scoped_refptr<ProxyResolverScriptData>& script_data,
     const CompletionCallback& /*callback*/) {
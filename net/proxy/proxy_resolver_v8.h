@@ -77,6 +77,17 @@ class NET_EXPORT_PRIVATE ProxyResolverV8 : public ProxyResolver {
   JSBindings* js_bindings() const { return js_bindings_; }
   void set_js_bindings(JSBindings* js_bindings) { js_bindings_ = js_bindings; }
 
+  // Whether FindProxyForURL() may read its |url| argument, which holds the
+  // path and query of the URL, rather than only its |host| argument. This is
+  // guessed from the source of the function after SetPacScript() succeeds,
+  // and is true when in doubt.
+  bool ScriptReadsUrl() const;
+
+  // Whether the PAC script may read the clock or random numbers, in which
+  // case the results of FindProxyForURL() change over time. Also guessed,
+  // from the text of the whole script.
+  bool ScriptReadsTime() const;
+
   // ProxyResolver implementation:
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
@@ -54,6 +54,16 @@ const size_t kMaxUniqueResolveDnsPerExec = 20;
 // hit this. (In fact normal scripts should not even have alerts() or errors).
 const size_t kMaxAlertsAndErrorsBytes = 2048;
 
+// The number of results of FindProxyForURL() kept by the result cache.
+const size_t kMaxCachedResults = 256;
+
+// How long results are kept. Results which only depend on the host are kept
+// longer than those which depend on the path, which mostly differs between
+// requests, or on DNS, whose results are kept for about a minute by the
+// host cache.
+const int kHostResultTtlSeconds = 300;
+const int kUrlOrDnsResultTtlSeconds = 60;
+
 // Returns event parameters for a PAC error message (line number + message).
 base::Value* NetLogErrorCallback(int line_number,
                                  const base::string16* message,
@@ -246,6 +256,11 @@ class ProxyResolverV8Tracing::Job
 
   scoped_refptr<ProxyResolverScriptData> script_data_;
 
+  // What ProxyResolverV8 guessed of the script. Written on the worker thread,
+  // read on the origin thread.
+  bool script_reads_url_;
+  bool script_reads_time_;
+
   // -------------------------------------------------------
   // State specific to GET_PROXY_FOR_URL.
   // -------------------------------------------------------
@@ -255,6 +270,12 @@ class ProxyResolverV8Tracing::Job
   ProxyInfo results_;
   BoundNetLog bound_net_log_;
 
+  // Whether |results_| may be kept in the parent's result cache. This is not
+  // the case when the script had to run with blocking DNS, or raised alerts
+  // or errors which should still be logged for later requests. Written on the
+  // worker thread, read on the origin thread.
+  bool results_cacheable_;
+
   // ---------------------------------------------------------------------------
   // State for ExecuteNonBlocking()
   // ---------------------------------------------------------------------------
@@ -354,6 +375,9 @@ ProxyResolverV8Tracing::Job::Job(ProxyResolverV8Tracing* parent)
     : origin_loop_(base::MessageLoopProxy::current()),
       parent_(parent),
       event_(true, false),
+      script_reads_url_(true),
+      script_reads_time_(true),
+      results_cacheable_(false),
       last_num_dns_(0),
       pending_dns_(NULL),
       metrics_num_executions_(0),
@@ -509,6 +533,8 @@ void ProxyResolverV8Tracing::Job::NotifyCallerOnOriginLoop(int result) {
   if (operation_ == GET_PROXY_FOR_URL) {
     RecordMetrics();
     *user_results_ = results_;
+    if (result == OK && results_cacheable_)
+      parent_->AddToResultCache(url_, results_, !dns_cache_.empty());
   }
 
   // There is only ever 1 outstanding SET_PAC_SCRIPT job. It needs to be
@@ -516,6 +542,8 @@ void ProxyResolverV8Tracing::Job::NotifyCallerOnOriginLoop(int result) {
   if (operation_ == SET_PAC_SCRIPT) {
     DCHECK_EQ(parent_->set_pac_script_job_.get(), this);
     parent_->set_pac_script_job_ = NULL;
+    parent_->script_reads_url_ = script_reads_url_;
+    parent_->script_reads_time_ = script_reads_time_;
   }
 
   CompletionCallback callback = callback_;
@@ -659,6 +687,7 @@ void ProxyResolverV8Tracing::Job::ExecuteNonBlocking() {
   if (abandoned_)
     return;
 
+  results_cacheable_ = alerts_and_errors_.empty();
   DispatchBufferedAlertsAndErrors();
   NotifyCaller(result);
 }
@@ -677,6 +706,10 @@ int ProxyResolverV8Tracing::Job::ExecuteProxyResolver() {
     case SET_PAC_SCRIPT:
       result = v8_resolver()->SetPacScript(
           script_data_, CompletionCallback());
+      if (result == OK) {
+        script_reads_url_ = v8_resolver()->ScriptReadsUrl();
+        script_reads_time_ = v8_resolver()->ScriptReadsTime();
+      }
       break;
     case GET_PROXY_FOR_URL:
       result = v8_resolver()->GetProxyForURL(
@@ -1097,7 +1130,11 @@ ProxyResolverV8Tracing::ProxyResolverV8Tracing(
       host_resolver_(host_resolver),
       error_observer_(error_observer),
       net_log_(net_log),
-      num_outstanding_callbacks_(0) {
+      num_outstanding_callbacks_(0),
+      result_cache_enabled_(false),
+      script_reads_url_(true),
+      script_reads_time_(true),
+      result_cache_(kMaxCachedResults) {
   DCHECK(host_resolver);
   // Start up the thread.
   thread_.reset(new base::Thread("Proxy resolver"));
@@ -1118,6 +1155,11 @@ ProxyResolverV8Tracing::~ProxyResolverV8Tracing() {
   thread_->Stop();
 }
 
+void ProxyResolverV8Tracing::EnableResultCache() {
+  DCHECK(CalledOnValidThread());
+  result_cache_enabled_ = true;
+}
+
 int ProxyResolverV8Tracing::GetProxyForURL(const GURL& url,
                                            ProxyInfo* results,
                                            const CompletionCallback& callback,
@@ -1127,6 +1169,17 @@ int ProxyResolverV8Tracing::GetProxyForURL(const GURL& url,
   DCHECK(!callback.is_null());
   DCHECK(!set_pac_script_job_.get());
 
+  if (result_cache_enabled_ && !script_reads_time_) {
+    ResultCache::iterator it = result_cache_.Get(MakeResultCacheKey(url));
+    if (it != result_cache_.end()) {
+      if (it->second.expiration > base::TimeTicks::Now()) {
+        *results = it->second.info;
+        return OK;
+      }
+      result_cache_.Erase(it);
+    }
+  }
+
   scoped_refptr<Job> job = new Job(this);
 
   if (request)
@@ -1153,6 +1206,7 @@ void ProxyResolverV8Tracing::CancelSetPacScript() {
 }
 
 void ProxyResolverV8Tracing::PurgeMemory() {
+  result_cache_.Clear();
   thread_->message_loop()->PostTask(
       FROM_HERE,
       base::Bind(&ProxyResolverV8::PurgeMemory,
@@ -1173,10 +1227,34 @@ int ProxyResolverV8Tracing::SetPacScript(
   DCHECK(!set_pac_script_job_.get());
   CHECK_EQ(0, num_outstanding_callbacks_);
 
+  result_cache_.Clear();
+  script_reads_url_ = true;
+  script_reads_time_ = true;
+
   set_pac_script_job_ = new Job(this);
   set_pac_script_job_->StartSetPacScript(script_data, callback);
 
   return ERR_IO_PENDING;
 }
 
+std::string ProxyResolverV8Tracing::MakeResultCacheKey(const GURL& url) const {
+  // FindProxyForURL() is passed the URL and its host.
+  return script_reads_url_ ? url.spec() : url.host();
+}
+
+void ProxyResolverV8Tracing::AddToResultCache(const GURL& url,
+                                              const ProxyInfo& info,
+                                              bool used_dns) {
+  DCHECK(CalledOnValidThread());
+  if (!result_cache_enabled_ || script_reads_time_)
+    return;
+
+  CachedResult entry;
+  entry.info = info;
+  entry.expiration = base::TimeTicks::Now() + base::TimeDelta::FromSeconds(
+      (script_reads_url_ || used_dns) ? kUrlOrDnsResultTtlSeconds
+                                      : kHostResultTtlSeconds);
+  result_cache_.Put(MakeResultCacheKey(url), entry);
+}
+
 }  // namespace net
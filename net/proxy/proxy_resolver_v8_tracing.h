@@ -5,11 +5,16 @@
 #ifndef NET_PROXY_PROXY_RESOLVER_V8_TRACING_H_
 #define NET_PROXY_PROXY_RESOLVER_V8_TRACING_H_
 
+#include <string>
+
 #include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
+#include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver.h"
 
 namespace base {
@@ -44,6 +49,15 @@ class NET_EXPORT_PRIVATE ProxyResolverV8Tracing
 
   virtual ~ProxyResolverV8Tracing();
 
+  // Has GetProxyForURL() keep the results of the script, and complete
+  // synchronously with a kept result while it is expected to still be the
+  // same. Results are kept per host when the script only reads the host of
+  // URLs, and per URL otherwise. Results which depended on DNS are kept for
+  // a shorter time, and no results are kept for scripts which may read the
+  // clock. Like the rest of the tracing, this assumes that scripts have no
+  // side effects.
+  void EnableResultCache();
+
   // ProxyResolver implementation:
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
@@ -61,6 +75,19 @@ class NET_EXPORT_PRIVATE ProxyResolverV8Tracing
  private:
   class Job;
 
+  struct CachedResult {
+    ProxyInfo info;
+    base::TimeTicks expiration;
+  };
+  typedef base::MRUCache<std::string, CachedResult> ResultCache;
+
+  // Returns the key of the results for |url| in |result_cache_|.
+  std::string MakeResultCacheKey(const GURL& url) const;
+
+  // Keeps |info| as the result for |url|. |used_dns| tells whether the script
+  // resolved any hosts to get it.
+  void AddToResultCache(const GURL& url, const ProxyInfo& info, bool used_dns);
+
   // The worker thread on which the ProxyResolverV8 will be run.
   scoped_ptr<base::Thread> thread_;
   scoped_ptr<ProxyResolverV8> v8_resolver_;
@@ -77,6 +104,14 @@ class NET_EXPORT_PRIVATE ProxyResolverV8Tracing
   // The number of outstanding (non-cancelled) jobs.
   int num_outstanding_callbacks_;
 
+  bool result_cache_enabled_;
+
+  // What ProxyResolverV8 guessed of the current script.
+  bool script_reads_url_;
+  bool script_reads_time_;
+
+  ResultCache result_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyResolverV8Tracing);
 };
 
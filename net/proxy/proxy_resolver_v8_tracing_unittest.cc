@@ -127,6 +127,72 @@ TEST_F(ProxyResolverV8TracingTest, Simple) {
   EXPECT_EQ(0u, request_log.GetSize());
 }
 
+TEST_F(ProxyResolverV8TracingTest, ResultCache) {
+  MockCachingHostResolver host_resolver;
+  host_resolver.rules()->AddRule("foo", "166.155.144.11");
+  ProxyResolverV8Tracing resolver(&host_resolver, new MockErrorObserver, NULL);
+  resolver.EnableResultCache();
+
+  // The script only reads the host, so its results are kept per host.
+  TestCompletionCallback init_callback;
+  EXPECT_EQ(ERR_IO_PENDING, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) {\n"
+          "  return 'PROXY ' + dnsResolve(host) + ':99';\n"
+          "}"),
+      init_callback.callback()));
+  EXPECT_EQ(OK, init_callback.WaitForResult());
+
+  TestCompletionCallback callback;
+  ProxyInfo proxy_info;
+  int rv = resolver.GetProxyForURL(
+      GURL("http://foo/req1"), &proxy_info, callback.callback(), NULL,
+      BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ("166.155.144.11:99", proxy_info.proxy_server().ToURI());
+  EXPECT_EQ(1u, host_resolver.num_resolve());
+
+  // Another URL of the same host gets the kept result right away.
+  ProxyInfo cached_proxy_info;
+  rv = resolver.GetProxyForURL(
+      GURL("http://foo/req2"), &cached_proxy_info, callback.callback(), NULL,
+      BoundNetLog());
+  EXPECT_EQ(OK, rv);
+  EXPECT_EQ("166.155.144.11:99", cached_proxy_info.proxy_server().ToURI());
+  EXPECT_EQ(1u, host_resolver.num_resolve());
+
+  // Setting the script again drops the kept results. This script reads the
+  // URL, so its results are kept per URL.
+  EXPECT_EQ(ERR_IO_PENDING, resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) {\n"
+          "  return url.indexOf('req1') >= 0 ? 'PROXY a:99' : 'PROXY b:99';\n"
+          "}"),
+      init_callback.callback()));
+  EXPECT_EQ(OK, init_callback.WaitForResult());
+
+  rv = resolver.GetProxyForURL(
+      GURL("http://foo/req1"), &proxy_info, callback.callback(), NULL,
+      BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ("a:99", proxy_info.proxy_server().ToURI());
+
+  rv = resolver.GetProxyForURL(
+      GURL("http://foo/req2"), &proxy_info, callback.callback(), NULL,
+      BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ("b:99", proxy_info.proxy_server().ToURI());
+
+  rv = resolver.GetProxyForURL(
+      GURL("http://foo/req1"), &proxy_info, callback.callback(), NULL,
+      BoundNetLog());
+  EXPECT_EQ(OK, rv);
+  EXPECT_EQ("a:99", proxy_info.proxy_server().ToURI());
+}
+
 TEST_F(ProxyResolverV8TracingTest, JavascriptError) {
   CapturingNetLog log;
   CapturingBoundNetLog request_log;
@@ -624,5 +624,54 @@ TEST(ProxyResolverV8Test, Terminate) {
   EXPECT_EQ("kittens:88", proxy_info.proxy_server().ToURI());
 }
 
+// Test guessing from the script whether FindProxyForURL() reads the URL, or
+// the time.
+TEST(ProxyResolverV8Test, ScriptReadsUrlOrTime) {
+  const struct {
+    const char* script;
+    bool reads_url;
+    bool reads_time;
+  } kTests[] = {
+    { "function FindProxyForURL(url, host) { return 'DIRECT'; }",
+      false, false },
+    { "function FindProxyForURL(url, host) {\n"
+      "  return host == 'foo' ? 'PROXY foo:80' : 'DIRECT';\n"
+      "}",
+      false, false },
+    // The URL is read, or passed on to another function.
+    { "function FindProxyForURL(url, host) {\n"
+      "  return shExpMatch(url, '*.pdf') ? 'DIRECT' : 'PROXY foo:80';\n"
+      "}",
+      true, false },
+    { "function FindProxyForURL(u, h) { return arguments[0]; }",
+      true, false },
+    // Names which only contain that of the URL argument don't count.
+    { "function FindProxyForURL(url, host) {\n"
+      "  var urls = 1; return 'DIRECT';\n"
+      "}",
+      false, false },
+    { "var FindProxyForURL = function(url, host) { return 'DIRECT'; };",
+      false, false },
+    { "function FindProxyForURL(url, host) {\n"
+      "  return timeRange(9, 17) ? 'PROXY foo:80' : 'DIRECT';\n"
+      "}",
+      false, true },
+    { "function FindProxyForURL(url, host) {\n"
+      "  return Math.random() < 0.5 ? 'PROXY foo:80' : 'PROXY bar:80';\n"
+      "}",
+      false, true },
+  };
+
+  for (size_t i = 0; i < arraysize(kTests); ++i) {
+    SCOPED_TRACE(kTests[i].script);
+    ProxyResolverV8WithMockBindings resolver;
+    EXPECT_EQ(OK, resolver.SetPacScript(
+        ProxyResolverScriptData::FromUTF8(kTests[i].script),
+        CompletionCallback()));
+    EXPECT_EQ(kTests[i].reads_url, resolver.ScriptReadsUrl());
+    EXPECT_EQ(kTests[i].reads_time, resolver.ScriptReadsTime());
+  }
+}
+
 }  // namespace
 }  // namespace net
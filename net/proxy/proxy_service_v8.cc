@@ -28,8 +28,9 @@ ProxyService* CreateProxyServiceUsingV8ProxyResolver(
   ProxyResolverErrorObserver* error_observer = new NetworkDelegateErrorObserver(
       network_delegate, base::MessageLoopProxy::current().get());
 
-  ProxyResolver* proxy_resolver =
+  ProxyResolverV8Tracing* proxy_resolver =
       new ProxyResolverV8Tracing(host_resolver, error_observer, net_log);
+  proxy_resolver->EnableResultCache();
 
   ProxyService* proxy_service =
       new ProxyService(proxy_config_service, proxy_resolver, net_log);
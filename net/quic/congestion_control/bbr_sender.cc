@@ -0,0 +1,389 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logging.h"
+
+using std::max;
+using std::min;
+
+namespace net {
+
+namespace {
+const QuicByteCount kMaxSegmentSize = kMaxPacketSize;
+const QuicByteCount kDefaultReceiveWindow = 64000;
+const QuicByteCount kMinimumCongestionWindow = 4 * kMaxSegmentSize;
+const int kInitialRttMs = 100;  // At a typical RTT 100 ms.
+// Packets may be sent this much before their paced send time, since the
+// alarm which sends them can not be more precise.
+const int kAlarmGranularityMs = 1;
+
+// 2/ln(2), the smallest gain which lets STARTUP double its sending rate
+// every round trip.
+const float kStartupGain = 2.885f;
+const float kDrainGain = 1.0f / kStartupGain;
+const float kProbeBandwidthCongestionWindowGain = 2.0f;
+// Probes for more bandwidth for one min RTT, drains the queue that may have
+// built up for the next, then cruises at the estimate for the rest.
+const float kPacingGainCycle[] = { 1.25f, 0.75f, 1, 1, 1, 1, 1, 1 };
+const int kGainCycleLength = arraysize(kPacingGainCycle);
+
+// The bandwidth estimate is the max delivery rate over this many rounds.
+const int64 kBandwidthWindowRounds = 10;
+// STARTUP ends once three rounds fail to grow the bandwidth by 25%.
+const float kStartupGrowthTarget = 1.25f;
+const int kRoundsWithoutGrowthBeforeExitingStartup = 3;
+
+// The min RTT is measured again once it is this old.
+const int kMinRttExpirySeconds = 10;
+const int kProbeRttTimeMs = 200;
+
+// Constants used for RTT calculation.
+const float kAlpha = 0.125f;
+const float kOneMinusAlpha = (1 - kAlpha);
+const float kBeta = 0.25f;
+const float kOneMinusBeta = (1 - kBeta);
+}  // namespace
+
+BbrSender::SentPacket::SentPacket(QuicByteCount bytes,
+                                  QuicByteCount delivered,
+                                  QuicTime delivered_time)
+    : bytes(bytes),
+      delivered(delivered),
+      delivered_time(delivered_time) {
+}
+
+BbrSender::BbrSender(const QuicClock* clock)
+    : clock_(clock),
+      mode_(STARTUP),
+      bytes_in_flight_(0),
+      receive_window_(kDefaultReceiveWindow),
+      initial_congestion_window_(kDefaultInitialWindow * kMaxSegmentSize),
+      delivered_(0),
+      delivered_time_(QuicTime::Zero()),
+      round_count_(0),
+      largest_sent_sequence_number_(0),
+      end_of_round_sequence_number_(0),
+      min_rtt_(QuicTime::Delta::Zero()),
+      min_rtt_timestamp_(QuicTime::Zero()),
+      smoothed_rtt_(QuicTime::Delta::Zero()),
+      mean_deviation_(QuicTime::Delta::Zero()),
+      pacing_gain_(kStartupGain),
+      congestion_window_gain_(kStartupGain),
+      next_send_time_(QuicTime::Zero()),
+      is_at_full_bandwidth_(false),
+      full_bandwidth_(QuicBandwidth::Zero()),
+      rounds_without_bandwidth_growth_(0),
+      cycle_index_(0),
+      cycle_start_(QuicTime::Zero()),
+      exit_probe_rtt_at_(QuicTime::Zero()),
+      exit_probe_rtt_round_(0) {
+}
+
+BbrSender::~BbrSender() {
+}
+
+void BbrSender::SetFromConfig(const QuicConfig& config, bool is_server) {
+  if (is_server) {
+    // Set the initial window size.
+    initial_congestion_window_ =
+        config.server_initial_congestion_window() * kMaxSegmentSize;
+  }
+}
+
+void BbrSender::OnIncomingQuicCongestionFeedbackFrame(
+    const QuicCongestionFeedbackFrame& feedback,
+    QuicTime feedback_receive_time) {
+  receive_window_ = feedback.tcp.receive_window;
+}
+
+void BbrSender::OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                              QuicByteCount acked_bytes) {
+  SentPacketMap::iterator it = sent_packets_.find(acked_sequence_number);
+  if (it == sent_packets_.end()) {
+    // The packet was sent before this sender took over the connection.
+    return;
+  }
+  const QuicTime now = clock_->ApproximateNow();
+  DCHECK_GE(bytes_in_flight_, it->second.bytes);
+  bytes_in_flight_ -= it->second.bytes;
+  delivered_ += it->second.bytes;
+  delivered_time_ = now;
+
+  bool is_round_start = false;
+  if (acked_sequence_number > end_of_round_sequence_number_) {
+    ++round_count_;
+    end_of_round_sequence_number_ = largest_sent_sequence_number_;
+    is_round_start = true;
+  }
+
+  // The delivery rate over the interval the packet was in flight.
+  const QuicTime::Delta interval = now.Subtract(it->second.delivered_time);
+  if (!interval.IsZero()) {
+    AddBandwidthSample(QuicBandwidth::FromBytesAndTimeDelta(
+        delivered_ - it->second.delivered, interval));
+  }
+  sent_packets_.erase(it);
+
+  if (is_round_start && mode_ == STARTUP) {
+    CheckIfFullBandwidthReached();
+    if (is_at_full_bandwidth_) {
+      DVLOG(1) << "Leaving STARTUP at "
+               << BandwidthEstimate().ToKBitsPerSecond() << " kbps";
+      mode_ = DRAIN;
+      pacing_gain_ = kDrainGain;
+    }
+  }
+  if (mode_ == DRAIN && bytes_in_flight_ <= GetTargetCongestionWindow(1)) {
+    EnterProbeBandwidthMode(now);
+  }
+  if (mode_ == PROBE_BW) {
+    UpdateGainCyclePhase(now);
+  }
+  MaybeEnterOrExitProbeRtt(now);
+}
+
+void BbrSender::OnPacketLost(QuicPacketSequenceNumber sequence_number,
+                             QuicTime /*ack_receive_time*/) {
+  // Loss is not a congestion signal for a model based sender; the packet is
+  // abandoned right after this.
+  DVLOG(1) << "Lost packet " << sequence_number;
+}
+
+bool BbrSender::OnPacketSent(QuicTime sent_time,
+                             QuicPacketSequenceNumber sequence_number,
+                             QuicByteCount bytes,
+                             TransmissionType transmission_type,
+                             HasRetransmittableData is_retransmittable) {
+  // Only update bytes_in_flight_ for data packets.
+  if (is_retransmittable != HAS_RETRANSMITTABLE_DATA) {
+    return false;
+  }
+
+  if (bytes_in_flight_ == 0) {
+    // Do not let a delivery rate sample span the time the connection was idle.
+    delivered_time_ = sent_time;
+  }
+  sent_packets_.insert(std::make_pair(
+      sequence_number, SentPacket(bytes, delivered_, delivered_time_)));
+  bytes_in_flight_ += bytes;
+  largest_sent_sequence_number_ =
+      max(sequence_number, largest_sent_sequence_number_);
+  next_send_time_ = QuicTime::Max(next_send_time_, sent_time).Add(
+      PacingRate().TransferTime(bytes));
+  return true;
+}
+
+void BbrSender::OnRetransmissionTimeout(bool packets_retransmitted) {
+  bytes_in_flight_ = 0;
+  sent_packets_.clear();
+}
+
+void BbrSender::OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                  QuicByteCount abandoned_bytes) {
+  SentPacketMap::iterator it = sent_packets_.find(sequence_number);
+  if (it == sent_packets_.end()) {
+    return;
+  }
+  DCHECK_GE(bytes_in_flight_, it->second.bytes);
+  bytes_in_flight_ -= it->second.bytes;
+  sent_packets_.erase(it);
+}
+
+QuicTime::Delta BbrSender::TimeUntilSend(
+    QuicTime now,
+    TransmissionType transmission_type,
+    HasRetransmittableData has_retransmittable_data,
+    IsHandshake handshake) {
+  if (transmission_type == TLP_RETRANSMISSION ||
+      has_retransmittable_data == NO_RETRANSMITTABLE_DATA ||
+      handshake == IS_HANDSHAKE) {
+    // As with TCP, acks, handshake packets and tail loss probes are sent
+    // immediately.
+    return QuicTime::Delta::Zero();
+  }
+  if (bytes_in_flight_ >= min(receive_window_, GetCongestionWindow())) {
+    return QuicTime::Delta::Infinite();
+  }
+  const QuicTime send_deadline =
+      now.Add(QuicTime::Delta::FromMilliseconds(kAlarmGranularityMs));
+  if (next_send_time_ <= send_deadline) {
+    return QuicTime::Delta::Zero();
+  }
+  return next_send_time_.Subtract(now);
+}
+
+QuicBandwidth BbrSender::BandwidthEstimate() const {
+  if (bandwidth_samples_.empty()) {
+    return QuicBandwidth::Zero();
+  }
+  return bandwidth_samples_.front().second;
+}
+
+QuicBandwidth BbrSender::PacingRate() const {
+  QuicBandwidth bandwidth = BandwidthEstimate();
+  if (bandwidth.IsZero()) {
+    // Until there is an estimate, pace the initial window over one RTT.
+    bandwidth = QuicBandwidth::FromBytesAndTimeDelta(
+        initial_congestion_window_, MinRtt());
+  }
+  return bandwidth.Scale(pacing_gain_);
+}
+
+void BbrSender::UpdateRtt(QuicTime::Delta rtt) {
+  if (rtt.IsInfinite() || rtt.IsZero()) {
+    DVLOG(1) << "Ignoring rtt, because it's "
+             << (rtt.IsZero() ? "Zero" : "Infinite");
+    return;
+  }
+  // RTT can't be negative.
+  DCHECK_LT(0, rtt.ToMicroseconds());
+
+  if (min_rtt_.IsZero() || rtt <= min_rtt_) {
+    min_rtt_ = rtt;
+    min_rtt_timestamp_ = clock_->ApproximateNow();
+  }
+  // First time call.
+  if (smoothed_rtt_.IsZero()) {
+    smoothed_rtt_ = rtt;
+    mean_deviation_ = QuicTime::Delta::FromMicroseconds(
+        rtt.ToMicroseconds() / 2);
+  } else {
+    mean_deviation_ = QuicTime::Delta::FromMicroseconds(
+        kOneMinusBeta * mean_deviation_.ToMicroseconds() +
+        kBeta *
+            std::abs(smoothed_rtt_.ToMicroseconds() - rtt.ToMicroseconds()));
+    smoothed_rtt_ = QuicTime::Delta::FromMicroseconds(
+        kOneMinusAlpha * smoothed_rtt_.ToMicroseconds() +
+        kAlpha * rtt.ToMicroseconds());
+  }
+}
+
+QuicTime::Delta BbrSender::SmoothedRtt() const {
+  if (smoothed_rtt_.IsZero()) {
+    return QuicTime::Delta::FromMilliseconds(kInitialRttMs);
+  }
+  return smoothed_rtt_;
+}
+
+QuicTime::Delta BbrSender::RetransmissionDelay() const {
+  return QuicTime::Delta::FromMicroseconds(
+      smoothed_rtt_.ToMicroseconds() + 4 * mean_deviation_.ToMicroseconds());
+}
+
+QuicByteCount BbrSender::GetCongestionWindow() const {
+  if (mode_ == PROBE_RTT) {
+    return kMinimumCongestionWindow;
+  }
+  if (BandwidthEstimate().IsZero()) {
+    return initial_congestion_window_;
+  }
+  QuicByteCount congestion_window =
+      GetTargetCongestionWindow(congestion_window_gain_);
+  if (mode_ == STARTUP) {
+    congestion_window = max(congestion_window, initial_congestion_window_);
+  }
+  return max(congestion_window, kMinimumCongestionWindow);
+}
+
+QuicTime::Delta BbrSender::MinRtt() const {
+  if (min_rtt_.IsZero()) {
+    return SmoothedRtt();
+  }
+  return min_rtt_;
+}
+
+QuicByteCount BbrSender::GetTargetCongestionWindow(float gain) const {
+  return static_cast<QuicByteCount>(
+      gain * BandwidthEstimate().ToBytesPerPeriod(MinRtt()));
+}
+
+void BbrSender::AddBandwidthSample(QuicBandwidth sample) {
+  // Older samples which are no larger can never be the max again.
+  while (!bandwidth_samples_.empty() &&
+         bandwidth_samples_.back().second <= sample) {
+    bandwidth_samples_.pop_back();
+  }
+  bandwidth_samples_.push_back(std::make_pair(round_count_, sample));
+  while (bandwidth_samples_.front().first + kBandwidthWindowRounds <=
+         round_count_) {
+    bandwidth_samples_.pop_front();
+  }
+}
+
+void BbrSender::CheckIfFullBandwidthReached() {
+  const QuicBandwidth bandwidth = BandwidthEstimate();
+  if (bandwidth >= full_bandwidth_.Scale(kStartupGrowthTarget)) {
+    full_bandwidth_ = bandwidth;
+    rounds_without_bandwidth_growth_ = 0;
+    return;
+  }
+  ++rounds_without_bandwidth_growth_;
+  if (rounds_without_bandwidth_growth_ >=
+      kRoundsWithoutGrowthBeforeExitingStartup) {
+    is_at_full_bandwidth_ = true;
+  }
+}
+
+void BbrSender::EnterProbeBandwidthMode(QuicTime now) {
+  mode_ = PROBE_BW;
+  congestion_window_gain_ = kProbeBandwidthCongestionWindowGain;
+  // Start cruising, rather than draining right after DRAIN.
+  cycle_index_ = 2;
+  cycle_start_ = now;
+  pacing_gain_ = kPacingGainCycle[cycle_index_];
+}
+
+void BbrSender::UpdateGainCyclePhase(QuicTime now) {
+  if (now.Subtract(cycle_start_) <= MinRtt()) {
+    return;
+  }
+  cycle_index_ = (cycle_index_ + 1) % kGainCycleLength;
+  cycle_start_ = now;
+  pacing_gain_ = kPacingGainCycle[cycle_index_];
+}
+
+void BbrSender::MaybeEnterOrExitProbeRtt(QuicTime now) {
+  const bool min_rtt_expired = !min_rtt_.IsZero() &&
+      now > min_rtt_timestamp_.Add(
+          QuicTime::Delta::FromSeconds(kMinRttExpirySeconds));
+  if (mode_ != PROBE_RTT && min_rtt_expired) {
+    DVLOG(1) << "Entering PROBE_RTT";
+    mode_ = PROBE_RTT;
+    pacing_gain_ = 1;
+    exit_probe_rtt_at_ = QuicTime::Zero();
+    // Take whatever is measured with the window drained as the new min RTT.
+    min_rtt_ = QuicTime::Delta::Zero();
+  }
+  if (mode_ != PROBE_RTT) {
+    return;
+  }
+
+  if (!exit_probe_rtt_at_.IsInitialized()) {
+    // Wait for the window to drain before starting the probe's timer.
+    if (bytes_in_flight_ <= kMinimumCongestionWindow) {
+      exit_probe_rtt_at_ =
+          now.Add(QuicTime::Delta::FromMilliseconds(kProbeRttTimeMs));
+      exit_probe_rtt_round_ = round_count_ + 1;
+    }
+    return;
+  }
+  if (now < exit_probe_rtt_at_ || round_count_ < exit_probe_rtt_round_) {
+    return;
+  }
+  min_rtt_timestamp_ = now;
+  if (is_at_full_bandwidth_) {
+    EnterProbeBandwidthMode(now);
+  } else {
+    mode_ = STARTUP;
+    pacing_gain_ = kStartupGain;
+    congestion_window_gain_ = kStartupGain;
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,167 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A model based send algorithm in the style of BBR.  Rather than reacting to
+// loss or delay, it estimates the bottleneck bandwidth as the windowed max of
+// the delivery rate, and the round trip propagation time as the windowed min
+// of the RTT.  It paces packets at a multiple of the bandwidth estimate and
+// caps the bytes in flight at a multiple of the bandwidth-delay product, so
+// random loss on long paths does not collapse its sending rate.
+
+#ifndef NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+#define NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+
+#include <deque>
+#include <map>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "net/base/net_export.h"
+#include "net/quic/congestion_control/send_algorithm_interface.h"
+#include "net/quic/quic_bandwidth.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/quic_time.h"
+
+namespace net {
+
+class NET_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
+ public:
+  enum Mode {
+    // Doubles the sending rate every round trip until the bandwidth estimate
+    // stops growing.
+    STARTUP,
+    // Drains the queue which built up during STARTUP.
+    DRAIN,
+    // Cycles the sending rate around the bandwidth estimate to probe for
+    // more bandwidth.
+    PROBE_BW,
+    // Shrinks the congestion window to measure the propagation delay again.
+    PROBE_RTT,
+  };
+
+  explicit BbrSender(const QuicClock* clock);
+  virtual ~BbrSender();
+
+  // Start implementation of SendAlgorithmInterface.
+  virtual void SetFromConfig(const QuicConfig& config, bool is_server) OVERRIDE;
+  virtual void OnIncomingQuicCongestionFeedbackFrame(
+      const QuicCongestionFeedbackFrame& feedback,
+      QuicTime feedback_receive_time) OVERRIDE;
+  virtual void OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                             QuicByteCount acked_bytes) OVERRIDE;
+  virtual void OnPacketLost(QuicPacketSequenceNumber sequence_number,
+                            QuicTime ack_receive_time) OVERRIDE;
+  virtual bool OnPacketSent(QuicTime sent_time,
+                            QuicPacketSequenceNumber sequence_number,
+                            QuicByteCount bytes,
+                            TransmissionType transmission_type,
+                            HasRetransmittableData is_retransmittable) OVERRIDE;
+  virtual void OnRetransmissionTimeout(bool packets_retransmitted) OVERRIDE;
+  virtual void OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                 QuicByteCount abandoned_bytes) OVERRIDE;
+  virtual QuicTime::Delta TimeUntilSend(
+      QuicTime now,
+      TransmissionType transmission_type,
+      HasRetransmittableData has_retransmittable_data,
+      IsHandshake handshake) OVERRIDE;
+  virtual QuicBandwidth BandwidthEstimate() const OVERRIDE;
+  virtual void UpdateRtt(QuicTime::Delta rtt_sample) OVERRIDE;
+  virtual QuicTime::Delta SmoothedRtt() const OVERRIDE;
+  virtual QuicTime::Delta RetransmissionDelay() const OVERRIDE;
+  virtual QuicByteCount GetCongestionWindow() const OVERRIDE;
+  // End implementation of SendAlgorithmInterface.
+
+  Mode mode() const { return mode_; }
+
+  // Returns the rate at which packets are currently paced.
+  QuicBandwidth PacingRate() const;
+
+ private:
+  // The state of the connection when a packet was sent, which an ack of the
+  // packet turns into a delivery rate sample.
+  struct SentPacket {
+    SentPacket(QuicByteCount bytes,
+               QuicByteCount delivered,
+               QuicTime delivered_time);
+
+    QuicByteCount bytes;
+    // |delivered_| and |delivered_time_| when the packet was sent.
+    QuicByteCount delivered;
+    QuicTime delivered_time;
+  };
+
+  typedef std::map<QuicPacketSequenceNumber, SentPacket> SentPacketMap;
+  // Delivery rate samples which may still be the max, each with the round
+  // it was taken in.  The bandwidths are decreasing from front to back.
+  typedef std::deque<std::pair<int64, QuicBandwidth> > BandwidthSampleQueue;
+
+  // Returns the propagation delay estimate, or the initial RTT if there has
+  // been no sample yet.
+  QuicTime::Delta MinRtt() const;
+
+  // Returns |gain| times the estimated bandwidth-delay product.
+  QuicByteCount GetTargetCongestionWindow(float gain) const;
+
+  void AddBandwidthSample(QuicBandwidth sample);
+  // Called at the end of each round while in STARTUP.
+  void CheckIfFullBandwidthReached();
+  void EnterProbeBandwidthMode(QuicTime now);
+  void UpdateGainCyclePhase(QuicTime now);
+  void MaybeEnterOrExitProbeRtt(QuicTime now);
+
+  const QuicClock* clock_;
+  Mode mode_;
+
+  SentPacketMap sent_packets_;
+  // Bytes in flight, aka bytes on the wire.
+  QuicByteCount bytes_in_flight_;
+  // Receiver side advertised window.
+  QuicByteCount receive_window_;
+  // Set from the config on the server.
+  QuicByteCount initial_congestion_window_;
+
+  // Total bytes acked, and when the last of them were acked.
+  QuicByteCount delivered_;
+  QuicTime delivered_time_;
+
+  // A round ends when a packet sent after the start of the round is acked.
+  int64 round_count_;
+  QuicPacketSequenceNumber largest_sent_sequence_number_;
+  QuicPacketSequenceNumber end_of_round_sequence_number_;
+
+  BandwidthSampleQueue bandwidth_samples_;
+
+  // The min RTT and when it was measured.
+  QuicTime::Delta min_rtt_;
+  QuicTime min_rtt_timestamp_;
+  // Smoothed RTT and mean deviation for the retransmission delay.
+  QuicTime::Delta smoothed_rtt_;
+  QuicTime::Delta mean_deviation_;
+
+  float pacing_gain_;
+  float congestion_window_gain_;
+  // The earliest time the next packet may be sent at the pacing rate.
+  QuicTime next_send_time_;
+
+  // STARTUP ends after the bandwidth estimate stops growing for several
+  // rounds.
+  bool is_at_full_bandwidth_;
+  QuicBandwidth full_bandwidth_;
+  int rounds_without_bandwidth_growth_;
+
+  // The index into the pacing gain cycle of PROBE_BW, and when it started.
+  int cycle_index_;
+  QuicTime cycle_start_;
+
+  // When PROBE_RTT may end, or zero until the window has drained.
+  QuicTime exit_probe_rtt_at_;
+  int64 exit_probe_rtt_round_;
+
+  DISALLOW_COPY_AND_ASSIGN(BbrSender);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
@@ -0,0 +1,218 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <deque>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/quic/congestion_control/tcp_receiver.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+
+const QuicByteCount kPacketSize = kMaxPacketSize;
+const int64 kBottleneckKBitsPerSecond = 5000;
+const int kMinRttMs = 100;
+
+// Sends as fast as the sender allows through a bottleneck link with a fixed
+// bandwidth and propagation delay, and a queue which never overflows.
+class BbrSenderTest : public ::testing::Test {
+ protected:
+  BbrSenderTest()
+      : sender_(new BbrSender(&clock_)),
+        bottleneck_bandwidth_(
+            QuicBandwidth::FromKBitsPerSecond(kBottleneckKBitsPerSecond)),
+        min_rtt_(QuicTime::Delta::FromMilliseconds(kMinRttMs)),
+        bottleneck_free_time_(QuicTime::Zero()),
+        sequence_number_(1),
+        loss_interval_(0),
+        saw_probe_rtt_(false) {
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1000));
+    TcpReceiver receiver;
+    QuicCongestionFeedbackFrame feedback;
+    receiver.GenerateCongestionFeedback(&feedback);
+    sender_->OnIncomingQuicCongestionFeedbackFrame(feedback, clock_.Now());
+  }
+
+  // Runs the connection for |duration|.
+  void Run(QuicTime::Delta duration) {
+    const QuicTime end = clock_.Now().Add(duration);
+    while (clock_.Now() < end) {
+      DeliverAcks();
+      SendPackets();
+      saw_probe_rtt_ |= sender_->mode() == BbrSender::PROBE_RTT;
+
+      QuicTime next_event = clock_.Now().Add(
+          QuicTime::Delta::FromMilliseconds(1));
+      if (!packets_in_flight_.empty() &&
+          packets_in_flight_.front().ack_time < next_event) {
+        next_event = packets_in_flight_.front().ack_time;
+      }
+      clock_.AdvanceTime(next_event.Subtract(clock_.Now()));
+    }
+  }
+
+  void SendPackets() {
+    while (sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                  HAS_RETRANSMITTABLE_DATA,
+                                  NOT_HANDSHAKE).IsZero()) {
+      sender_->OnPacketSent(clock_.Now(), sequence_number_, kPacketSize,
+                            NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA);
+      bottleneck_free_time_ =
+          QuicTime::Max(bottleneck_free_time_, clock_.Now()).Add(
+              bottleneck_bandwidth_.TransferTime(kPacketSize));
+      InFlightPacket packet(sequence_number_, clock_.Now(),
+                            bottleneck_free_time_.Add(min_rtt_));
+      packet.lost =
+          loss_interval_ > 0 && sequence_number_ % loss_interval_ == 0;
+      packets_in_flight_.push_back(packet);
+      ++sequence_number_;
+    }
+  }
+
+  void DeliverAcks() {
+    while (!packets_in_flight_.empty() &&
+           packets_in_flight_.front().ack_time <= clock_.Now()) {
+      const InFlightPacket& packet = packets_in_flight_.front();
+      if (packet.lost) {
+        // Detected as soon as the next packet is acked.
+        sender_->OnPacketLost(packet.sequence_number, clock_.Now());
+        sender_->OnPacketAbandoned(packet.sequence_number, kPacketSize);
+      } else {
+        sender_->UpdateRtt(clock_.Now().Subtract(packet.sent_time));
+        sender_->OnPacketAcked(packet.sequence_number, kPacketSize);
+      }
+      packets_in_flight_.pop_front();
+    }
+  }
+
+  void ExpectBandwidthNearBottleneck() {
+    const int64 estimate = sender_->BandwidthEstimate().ToKBitsPerSecond();
+    EXPECT_LE(kBottleneckKBitsPerSecond * 9 / 10, estimate);
+    EXPECT_GE(kBottleneckKBitsPerSecond * 11 / 10, estimate);
+  }
+
+  struct InFlightPacket {
+    InFlightPacket(QuicPacketSequenceNumber sequence_number,
+                   QuicTime sent_time,
+                   QuicTime ack_time)
+        : sequence_number(sequence_number),
+          sent_time(sent_time),
+          ack_time(ack_time),
+          lost(false) {
+    }
+
+    QuicPacketSequenceNumber sequence_number;
+    QuicTime sent_time;
+    QuicTime ack_time;
+    bool lost;
+  };
+
+  MockClock clock_;
+  scoped_ptr<BbrSender> sender_;
+  const QuicBandwidth bottleneck_bandwidth_;
+  QuicTime::Delta min_rtt_;
+  QuicTime bottleneck_free_time_;
+  std::deque<InFlightPacket> packets_in_flight_;
+  QuicPacketSequenceNumber sequence_number_;
+  // Every |loss_interval_|'th packet is lost, if it is not zero.
+  QuicPacketSequenceNumber loss_interval_;
+  bool saw_probe_rtt_;
+};
+
+TEST_F(BbrSenderTest, InitialWindowIsPaced) {
+  EXPECT_EQ(BbrSender::STARTUP, sender_->mode());
+  EXPECT_EQ(kDefaultInitialWindow * kPacketSize,
+            sender_->GetCongestionWindow());
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsZero());
+  sender_->OnPacketSent(clock_.Now(), 1, kPacketSize, NOT_RETRANSMISSION,
+                        HAS_RETRANSMITTABLE_DATA);
+  sender_->OnPacketSent(clock_.Now(), 2, kPacketSize, NOT_RETRANSMISSION,
+                        HAS_RETRANSMITTABLE_DATA);
+
+  // The next packet waits for the pacing rate.
+  QuicTime::Delta delay = sender_->TimeUntilSend(clock_.Now(),
+      NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE);
+  EXPECT_FALSE(delay.IsZero());
+  EXPECT_FALSE(delay.IsInfinite());
+
+  // Acks, handshake packets and tail loss probes are not paced.
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      NO_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsZero());
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, IS_HANDSHAKE).IsZero());
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), TLP_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsZero());
+}
+
+TEST_F(BbrSenderTest, CongestionWindowLimitsSending) {
+  for (QuicPacketSequenceNumber i = 1; i <= kDefaultInitialWindow; ++i) {
+    sender_->OnPacketSent(clock_.Now(), i, kPacketSize, NOT_RETRANSMISSION,
+                          HAS_RETRANSMITTABLE_DATA);
+  }
+  clock_.AdvanceTime(QuicTime::Delta::FromSeconds(1));
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsInfinite());
+
+  sender_->OnPacketAcked(1, kPacketSize);
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsZero());
+}
+
+TEST_F(BbrSenderTest, EstimatesBottleneckBandwidth) {
+  Run(QuicTime::Delta::FromSeconds(5));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  ExpectBandwidthNearBottleneck();
+  // The window leaves room for the bandwidth-delay product, but not for an
+  // unbounded queue.
+  const QuicByteCount bdp = bottleneck_bandwidth_.ToBytesPerPeriod(min_rtt_);
+  EXPECT_LE(bdp, sender_->GetCongestionWindow());
+  EXPECT_GE(3 * bdp, sender_->GetCongestionWindow());
+}
+
+TEST_F(BbrSenderTest, KeepsBandwidthDespiteRandomLoss) {
+  // Lose 1% of the packets, which would keep a loss based sender far below
+  // the bottleneck bandwidth at this RTT.
+  loss_interval_ = 100;
+  Run(QuicTime::Delta::FromSeconds(5));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  ExpectBandwidthNearBottleneck();
+}
+
+TEST_F(BbrSenderTest, ProbesRttAfterRouteChange) {
+  Run(QuicTime::Delta::FromSeconds(1));
+  // A longer path means the min RTT is never measured again by chance.
+  min_rtt_ = QuicTime::Delta::FromMilliseconds(kMinRttMs + 20);
+  Run(QuicTime::Delta::FromSeconds(8));
+  EXPECT_FALSE(saw_probe_rtt_);
+  Run(QuicTime::Delta::FromSeconds(3));
+  EXPECT_TRUE(saw_probe_rtt_);
+  // The sender returns to PROBE_BW with its bandwidth estimate intact.
+  EXPECT_EQ(BbrSender::PROBE_BW, sender_->mode());
+  ExpectBandwidthNearBottleneck();
+}
+
+TEST_F(BbrSenderTest, RetransmissionTimeoutClearsBytesInFlight) {
+  for (QuicPacketSequenceNumber i = 1; i <= kDefaultInitialWindow; ++i) {
+    sender_->OnPacketSent(clock_.Now(), i, kPacketSize, NOT_RETRANSMISSION,
+                          HAS_RETRANSMITTABLE_DATA);
+  }
+  clock_.AdvanceTime(QuicTime::Delta::FromSeconds(1));
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsInfinite());
+
+  sender_->OnRetransmissionTimeout(true);
+  EXPECT_TRUE(sender_->TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+      HAS_RETRANSMITTABLE_DATA, NOT_HANDSHAKE).IsZero());
+  // Acks of packets sent before the timeout are ignored.
+  sender_->OnPacketAcked(1, kPacketSize);
+}
+
+}  // namespace test
+}  // namespace net
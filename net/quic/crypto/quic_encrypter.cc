@@ -4,6 +4,8 @@
 
 #include "net/quic/crypto/quic_encrypter.h"
 
+#include "base/memory/scoped_ptr.h"
+
 #include "net/quic/crypto/aes_128_gcm_12_encrypter.h"
 #include "net/quic/crypto/null_encrypter.h"
 
@@ -22,4 +24,17 @@ QuicEncrypter* QuicEncrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicEncrypter::EncryptPacketInto(QuicPacketSequenceNumber sequence_number,
+                                      base::StringPiece associated_data,
+                                      base::StringPiece plaintext,
+                                      char* output) {
+  scoped_ptr<QuicData> ciphertext(
+      EncryptPacket(sequence_number, associated_data, plaintext));
+  if (ciphertext.get() == NULL) {
+    return false;
+  }
+  memcpy(output, ciphertext->data(), ciphertext->length());
+  return true;
+}
+
 }  // namespace net
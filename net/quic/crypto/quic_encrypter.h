@@ -58,6 +58,16 @@ class NET_EXPORT_PRIVATE QuicEncrypter {
                                   base::StringPiece associated_data,
                                   base::StringPiece plaintext) = 0;
 
+  // Like EncryptPacket, but writes the ciphertext and MAC to |output|, which
+  // must have room for |GetCiphertextSize(plaintext.size())| bytes, instead of
+  // allocating a buffer for them.  |output| must not overlap |plaintext|.
+  // Returns false on error.  The default implementation copies the result of
+  // EncryptPacket.
+  virtual bool EncryptPacketInto(QuicPacketSequenceNumber sequence_number,
+                                 base::StringPiece associated_data,
+                                 base::StringPiece plaintext,
+                                 char* output);
+
   // GetKeySize() and GetNoncePrefixSize() tell the HKDF class how many bytes
   // of key material needs to be derived from the master secret.
   // NOTE: the sizes returned by GetKeySize() and GetNoncePrefixSize() are
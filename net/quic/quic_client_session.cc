@@ -141,6 +141,11 @@ QuicClientSession::~QuicClientSession() {
   UMA_HISTOGRAM_COUNTS("Net.QuicSession.NumTotalStreams", num_total_streams_);
   UMA_HISTOGRAM_COUNTS("Net.QuicNumSentClientHellos",
                        crypto_stream_->num_sent_client_hellos());
+  const QuicConnectionStats& stats = connection()->GetStats();
+  if (stats.zero_rtt_attempted) {
+    UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.ZeroRttSucceeded",
+                          stats.zero_rtt_succeeded);
+  }
   if (!IsCryptoHandshakeConfirmed())
     return;
 
@@ -1167,8 +1167,23 @@ bool QuicConnection::WritePacket(QueuedPacket packet) {
   DCHECK_LE(sequence_number_of_last_sent_packet_, sequence_number);
   sequence_number_of_last_sent_packet_ = sequence_number;
 
-  QuicEncryptedPacket* encrypted = framer_.EncryptPacket(
-      packet.encryption_level, sequence_number, *packet.packet);
+  // The connection close packet outlives this call, and packets which are
+  // only allowed for tests may not fit in |encryption_buffer_|, so only they
+  // get a buffer of their own.
+  QuicEncryptedPacket* encrypted = NULL;
+  if (packet.type != CONNECTION_CLOSE &&
+      packet.packet->length() <= framer_.GetMaxPlaintextSize(kMaxPacketSize)) {
+    size_t encrypted_length = framer_.EncryptPacket(
+        packet.encryption_level, sequence_number, *packet.packet,
+        encryption_buffer_, arraysize(encryption_buffer_));
+    if (encrypted_length != 0) {
+      encrypted = new QuicEncryptedPacket(encryption_buffer_,
+                                          encrypted_length);
+    }
+  } else {
+    encrypted = framer_.EncryptPacket(
+        packet.encryption_level, sequence_number, *packet.packet);
+  }
   if (encrypted == NULL) {
     LOG(DFATAL) << ENDPOINT << "Failed to encrypt packet number "
                 << sequence_number;
@@ -1243,11 +1258,30 @@ bool QuicConnection::WritePacket(QueuedPacket packet) {
   }
 
   if (OnPacketSent(result)) {
+    // Outside of a bundle, nothing else is written right after this packet,
+    // so a writer in batch mode has to send it now.
+    if (!packet_generator_.InBatchMode())
+      FlushPacketWriter();
     return true;
   }
   return false;
 }
 
+void QuicConnection::FlushPacketWriter() {
+  if (!writer_->IsBatchMode())
+    return;
+
+  WriteResult result = writer_->Flush();
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    // The writer keeps the packets it could not send, and sends them when it
+    // is flushed once the socket is writable again.
+    visitor_->OnWriteBlocked();
+  } else if (result.status == WRITE_STATUS_ERROR && connected_) {
+    DVLOG(1) << "Write failed with error code: " << result.error_code;
+    CloseConnection(QUIC_PACKET_WRITE_ERROR, false);
+  }
+}
+
 bool QuicConnection::ShouldDiscardPacket(
     EncryptionLevel level,
     QuicPacketSequenceNumber sequence_number,
@@ -1723,6 +1757,8 @@ QuicConnection::ScopedPacketBundler::~ScopedPacketBundler() {
   if (!already_in_batch_mode_) {
     DVLOG(1) << "Leaving Batch Mode.";
     connection_->packet_generator_.FinishBatchOperations();
+    // Send the packets of the bundle together.
+    connection_->FlushPacketWriter();
   }
   DCHECK_EQ(already_in_batch_mode_,
             connection_->packet_generator_.InBatchMode());
@@ -252,6 +252,7 @@ class NET_EXPORT_PRIVATE QuicConnection
 
   // Returns statistics tracked for this connection.
   const QuicConnectionStats& GetStats();
+  QuicConnectionStats* mutable_stats() { return &stats_; }
 
   // Processes an incoming UDP packet (consisting of a QuicEncryptedPacket) from
   // the peer.  If processing this packet permits a packet to be revived from
@@ -503,6 +504,9 @@ class NET_EXPORT_PRIVATE QuicConnection
   // will not be consulted.
   bool WritePacket(QueuedPacket packet);
 
+  // Sends the packets held by |writer_| if it is in batch mode.
+  void FlushPacketWriter();
+
   // Make sure an ack we got from our peer is sane.
   bool ValidateAckFrame(const QuicAckFrame& incoming_ack);
 
@@ -630,6 +634,11 @@ class NET_EXPORT_PRIVATE QuicConnection
   // Contains the connection close packet if the connection has been closed.
   scoped_ptr<QuicEncryptedPacket> connection_close_packet_;
 
+  // Packets are encrypted into this buffer before they are written.  Every
+  // writer is done with a packet once WritePacket returns, so the buffer is
+  // reused for each packet rather than allocating one per packet.
+  char encryption_buffer_[kMaxPacketSize];
+
   FecGroupMap group_map_;
 
   QuicReceivedPacketManager received_packet_manager_;
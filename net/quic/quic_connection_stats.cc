@@ -24,6 +24,8 @@ QuicConnectionStats::QuicConnectionStats()
       crypto_retransmit_count(0),
       tlp_count(0),
       rto_count(0),
+      zero_rtt_attempted(false),
+      zero_rtt_succeeded(false),
       rtt(0),
       estimated_bandwidth(0) {
 }
@@ -47,6 +49,8 @@ ostream& operator<<(ostream& os, const QuicConnectionStats& s) {
      << ", crypto retransmit count: " << s.crypto_retransmit_count
      << ", rto count: " << s.rto_count
      << ", tlp count: " << s.tlp_count
+     << ", zero rtt attempted: " << s.zero_rtt_attempted
+     << ", zero rtt succeeded: " << s.zero_rtt_succeeded
      << ", rtt(us): " << s.rtt
      << ", estimated_bandwidth: " << s.estimated_bandwidth
      << "}\n";
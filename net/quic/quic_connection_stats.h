@@ -50,6 +50,11 @@ struct NET_EXPORT_PRIVATE QuicConnectionStats {
   uint32 tlp_count;
   uint32 rto_count;
 
+  // Set on the client when its first hello was a full hello built from a
+  // cached server config, and when the server accepted that hello.
+  bool zero_rtt_attempted;
+  bool zero_rtt_succeeded;
+
   uint32 rtt;  // In microseconds
   uint64 estimated_bandwidth;
   // TODO(satyamshekhar): Add window_size, mss and mtu.
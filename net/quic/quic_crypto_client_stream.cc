@@ -230,6 +230,9 @@ void QuicCryptoClientStream::DoHandshakeLoop(
         } else {
           cert_verify_result_.reset();
         }
+        if (num_client_hellos_ == 1) {
+          session()->connection()->mutable_stats()->zero_rtt_attempted = true;
+        }
         next_state_ = STATE_RECV_SHLO;
         DVLOG(1) << "Client: Sending " << out.DebugString();
         SendHandshakeMessage(out);
@@ -394,6 +397,9 @@ void QuicCryptoClientStream::DoHandshakeLoop(
         session()->connection()->SetDefaultEncryptionLevel(
             ENCRYPTION_FORWARD_SECURE);
 
+        if (num_client_hellos_ == 1) {
+          session()->connection()->mutable_stats()->zero_rtt_succeeded = true;
+        }
         handshake_confirmed_ = true;
         session()->OnCryptoHandshakeEvent(QuicSession::HANDSHAKE_CONFIRMED);
         return;
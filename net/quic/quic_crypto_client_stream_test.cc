@@ -133,6 +133,26 @@ TEST_F(QuicCryptoClientStreamTest, ExpiredServerConfig) {
   ASSERT_EQ(1u, connection_->packets_.size());
 }
 
+TEST_F(QuicCryptoClientStreamTest, ZeroRttWithCachedServerConfig) {
+  // Without a cached server config the handshake takes a round trip.
+  CompleteCryptoHandshake();
+  EXPECT_FALSE(connection_->GetStats().zero_rtt_attempted);
+  EXPECT_FALSE(connection_->GetStats().zero_rtt_succeeded);
+
+  connection_ = new PacketSavingConnection(false);
+  session_.reset(new TestSession(connection_, DefaultQuicConfig()));
+  stream_.reset(new QuicCryptoClientStream(kServerHostname, session_.get(),
+                                           &crypto_config_));
+  session_->SetCryptoStream(stream_.get());
+  session_->config()->SetDefaults();
+
+  // The cached config lets the first client hello be a full one.
+  EXPECT_TRUE(stream_->CryptoConnect());
+  EXPECT_TRUE(stream_->encryption_established());
+  EXPECT_TRUE(connection_->GetStats().zero_rtt_attempted);
+  EXPECT_FALSE(connection_->GetStats().zero_rtt_succeeded);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
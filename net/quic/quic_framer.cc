@@ -1709,19 +1709,44 @@ QuicEncryptedPacket* QuicFramer::EncryptPacket(
     const QuicPacket& packet) {
   DCHECK(encrypter_[level].get() != NULL);
 
-  scoped_ptr<QuicData> out(encrypter_[level]->EncryptPacket(
-      packet_sequence_number, packet.AssociatedData(), packet.Plaintext()));
-  if (out.get() == NULL) {
-    RaiseError(QUIC_ENCRYPTION_FAILURE);
+  size_t len = packet.BeforePlaintext().length() +
+      encrypter_[level]->GetCiphertextSize(packet.Plaintext().length());
+  scoped_ptr<char[]> buffer(new char[len]);
+  if (EncryptPacket(level, packet_sequence_number, packet, buffer.get(),
+                    len) == 0) {
     return NULL;
   }
+  return new QuicEncryptedPacket(buffer.release(), len, true);
+}
+
+size_t QuicFramer::EncryptPacket(
+    EncryptionLevel level,
+    QuicPacketSequenceNumber packet_sequence_number,
+    const QuicPacket& packet,
+    char* buffer,
+    size_t buffer_len) {
+  DCHECK(encrypter_[level].get() != NULL);
+
   StringPiece header_data = packet.BeforePlaintext();
-  size_t len =  header_data.length() + out->length();
-  char* buffer = new char[len];
-  // TODO(rch): eliminate this buffer copy by passing in a buffer to Encrypt().
+  size_t len = header_data.length() +
+      encrypter_[level]->GetCiphertextSize(packet.Plaintext().length());
+  if (len > buffer_len) {
+    LOG(DFATAL) << "Encrypted packet of " << len << " bytes does not fit in a "
+                << buffer_len << " byte buffer";
+    RaiseError(QUIC_ENCRYPTION_FAILURE);
+    return 0;
+  }
+
+  // The header goes out in the clear, and the sealed payload is written
+  // straight after it.
   memcpy(buffer, header_data.data(), header_data.length());
-  memcpy(buffer + header_data.length(), out->data(), out->length());
-  return new QuicEncryptedPacket(buffer, len, true);
+  if (!encrypter_[level]->EncryptPacketInto(
+          packet_sequence_number, packet.AssociatedData(), packet.Plaintext(),
+          buffer + header_data.length())) {
+    RaiseError(QUIC_ENCRYPTION_FAILURE);
+    return 0;
+  }
+  return len;
 }
 
 size_t QuicFramer::GetMaxPlaintextSize(size_t ciphertext_size) {
@@ -347,6 +347,15 @@ class NET_EXPORT_PRIVATE QuicFramer {
                                      QuicPacketSequenceNumber sequence_number,
                                      const QuicPacket& packet);
 
+  // Encrypts |packet| into |buffer|, which is |buffer_len| bytes long, and
+  // returns the length of the encrypted packet.  Returns 0 on failure,
+  // including when |buffer| is too small.
+  size_t EncryptPacket(EncryptionLevel level,
+                       QuicPacketSequenceNumber sequence_number,
+                       const QuicPacket& packet,
+                       char* buffer,
+                       size_t buffer_len);
+
   // Returns the maximum length of plaintext that can be encrypted
   // to ciphertext no larger than |ciphertext_size|.
   size_t GetMaxPlaintextSize(size_t ciphertext_size);
@@ -4534,6 +4534,50 @@ TEST_P(QuicFramerTest, EncryptPacket) {
   EXPECT_TRUE(CheckEncryption(sequence_number, raw.get()));
 }
 
+TEST_P(QuicFramerTest, EncryptPacketIntoBuffer) {
+  QuicPacketSequenceNumber sequence_number = GG_UINT64_C(0x123456789ABC);
+  unsigned char packet[] = {
+    // public flags (8 byte guid)
+    0x3C,
+    // guid
+    0x10, 0x32, 0x54, 0x76,
+    0x98, 0xBA, 0xDC, 0xFE,
+    // packet sequence number
+    0xBC, 0x9A, 0x78, 0x56,
+    0x34, 0x12,
+    // private flags (fec group & fec packet)
+    0x06,
+    // first fec protected packet offset
+    0x01,
+
+    // redundancy
+    'a',  'b',  'c',  'd',
+    'e',  'f',  'g',  'h',
+    'i',  'j',  'k',  'l',
+    'm',  'n',  'o',  'p',
+  };
+
+  scoped_ptr<QuicPacket> raw(
+      QuicPacket::NewDataPacket(AsChars(packet), arraysize(packet), false,
+                                PACKET_8BYTE_GUID, !kIncludeVersion,
+                                PACKET_6BYTE_SEQUENCE_NUMBER));
+  char buffer[kMaxPacketSize];
+  size_t encrypted_length = framer_.EncryptPacket(
+      ENCRYPTION_NONE, sequence_number, *raw, buffer, arraysize(buffer));
+  ASSERT_EQ(arraysize(packet), encrypted_length);
+  EXPECT_TRUE(CheckEncryption(sequence_number, raw.get()));
+  // The test encrypter leaves the plaintext as it is.
+  test::CompareCharArraysWithHexError(
+      "encrypted packet", buffer, encrypted_length,
+      AsChars(packet), arraysize(packet));
+
+  // A buffer which is too small is not written past.
+  EXPECT_DFATAL(EXPECT_EQ(0u, framer_.EncryptPacket(
+                    ENCRYPTION_NONE, sequence_number, *raw, buffer,
+                    arraysize(packet) - 1)),
+                "does not fit");
+}
+
 TEST_P(QuicFramerTest, EncryptPacketWithVersionFlag) {
   QuicPacketSequenceNumber sequence_number = GG_UINT64_C(0x123456789ABC);
   unsigned char packet[] = {
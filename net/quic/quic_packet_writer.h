@@ -22,7 +22,9 @@ class NET_EXPORT_PRIVATE QuicPacketWriter {
   // Sends the packet out to the peer.  If the write succeeded, the result's
   // status is WRITE_STATUS_OK and bytes_written is populated. If the write
   // failed, the result's status is WRITE_STATUS_BLOCKED or WRITE_STATUS_ERROR
-  // and error_code is populated.
+  // and error_code is populated.  The writer must not keep a pointer to
+  // |buffer| once WritePacket returns, because the caller reuses it for the
+  // next packet.
   virtual WriteResult WritePacket(
       const char* buffer, size_t buf_len,
       const IPAddressNumber& self_address,
@@ -39,6 +41,17 @@ class NET_EXPORT_PRIVATE QuicPacketWriter {
   // Records that the socket has become writable, for example when an EPOLLOUT
   // is received or an asynchronous write completes.
   virtual void SetWritable() = 0;
+
+  // Returns true if the writer holds the packets passed to WritePacket, and
+  // only sends them when Flush is called, so that it can send several of them
+  // with one system call.  The held packets are reported as written already.
+  virtual bool IsBatchMode() const { return false; }
+
+  // Sends the packets held by a writer in batch mode.  If the socket becomes
+  // write blocked, the result's status is WRITE_STATUS_BLOCKED and the writer
+  // keeps the packets it could not send, until it is flushed again after
+  // SetWritable.
+  virtual WriteResult Flush() { return WriteResult(WRITE_STATUS_OK, 0); }
 };
 
 }  // namespace net
@@ -5,11 +5,14 @@
 #include "net/quic/quic_sent_packet_manager.h"
 
 #include "base/stl_util.h"
+#include "net/quic/crypto/crypto_handshake_message.h"
+#include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/test_tools/quic_sent_packet_manager_peer.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+using std::string;
 using std::vector;
 using testing::_;
 using testing::Return;
@@ -1276,6 +1279,25 @@ TEST_F(QuicSentPacketManagerTest, GetTransmissionDelay) {
   }
 }
 
+TEST_F(QuicSentPacketManagerTest, NegotiateBbr) {
+  ValueRestore<bool> old_flag(&FLAGS_enable_quic_bbr, true);
+  QuicConfig client_config;
+  client_config.SetDefaults();
+  CryptoHandshakeMessage client_hello;
+  client_config.ToHandshakeMessage(&client_hello);
+
+  QuicConfig config;
+  config.SetDefaults();
+  string error_details;
+  ASSERT_EQ(QUIC_NO_ERROR,
+            config.ProcessClientHello(client_hello, &error_details));
+  EXPECT_EQ(kTBBR, config.congestion_control());
+
+  manager_.SetFromConfig(config);
+  EXPECT_TRUE(manager_.using_bbr());
+  EXPECT_FALSE(manager_.using_pacing());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
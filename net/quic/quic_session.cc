@@ -359,8 +359,13 @@ QuicConsumedData QuicSession::WritevData(
     QuicAckNotifier::DelegateInterface* ack_notifier_delegate) {
   IOVector data;
   data.AppendIovec(iov, iov_count);
-  return connection_->SendStreamData(id, data, offset, fin,
-                                     ack_notifier_delegate);
+  QuicConsumedData consumed_data =
+      connection_->SendStreamData(id, data, offset, fin,
+                                  ack_notifier_delegate);
+  // Charge the stream for what it wrote, so that streams of the same
+  // priority get their share before it writes again.
+  write_blocked_streams_.RecordBytesWritten(id, consumed_data.bytes_consumed);
+  return consumed_data;
 }
 
 size_t QuicSession::WriteHeaders(QuicStreamId id,
@@ -431,6 +436,7 @@ void QuicSession::CloseStreamInner(QuicStreamId stream_id,
   }
   stream_map_.erase(it);
   stream->OnClose();
+  write_blocked_streams_.RemoveStream(stream_id);
 }
 
 void QuicSession::AddZombieStream(QuicStreamId stream_id) {
@@ -484,6 +484,29 @@ void QuicStreamFactory::CloseAllSessions(int error) {
   DCHECK(all_sessions_.empty());
 }
 
+void QuicStreamFactory::PreloadServerConfigs(size_t max_servers) {
+  if (!quic_server_info_factory_ || !http_server_properties_)
+    return;
+
+  const AlternateProtocolMap& alternate_protocols =
+      http_server_properties_->alternate_protocol_map();
+  size_t num_preloaded = 0;
+  for (AlternateProtocolMap::const_iterator it = alternate_protocols.begin();
+       it != alternate_protocols.end() && num_preloaded < max_servers; ++it) {
+    if (it->second.protocol != QUIC)
+      continue;
+    HostPortProxyPair host_port_proxy_pair(it->first, ProxyServer::Direct());
+    if (ContainsKey(all_crypto_configs_, host_port_proxy_pair))
+      continue;
+    // Creating the config starts reading its QuicServerInfo from the disk
+    // cache, which is then ready by the time a connection needs it.
+    GetOrCreateCryptoConfig(host_port_proxy_pair);
+    ++num_preloaded;
+  }
+  UMA_HISTOGRAM_COUNTS("Net.QuicSession.NumPreloadedServerConfigs",
+                       num_preloaded);
+}
+
 base::Value* QuicStreamFactory::QuicStreamFactoryInfoToValue() const {
   base::ListValue* list = new base::ListValue();
 
@@ -133,6 +133,11 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // Closes all current sessions.
   void CloseAllSessions(int error);
 
+  // Starts loading the persisted server configs of up to |max_servers| of the
+  // servers which |http_server_properties_| knows to support QUIC, so that the
+  // first connection to each of them can skip the handshake round trip.
+  void PreloadServerConfigs(size_t max_servers);
+
   base::Value* QuicStreamFactoryInfoToValue() const;
 
   // NetworkChangeNotifier::IPAddressObserver methods:
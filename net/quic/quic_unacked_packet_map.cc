@@ -4,10 +4,10 @@
 
 #include "net/quic/quic_unacked_packet_map.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
-#include "base/stl_util.h"
 #include "net/quic/quic_connection_stats.h"
-#include "net/quic/quic_utils_chromium.h"
 
 using std::max;
 
@@ -15,6 +15,15 @@ namespace net {
 
 #define ENDPOINT (is_server_ ? "Server: " : " Client: ")
 
+namespace {
+
+bool CompareSequenceNumbers(const QuicUnackedPacketMap::Entry& a,
+                            const QuicUnackedPacketMap::Entry& b) {
+  return a.first < b.first;
+}
+
+}  // namespace
+
 QuicUnackedPacketMap::TransmissionInfo::TransmissionInfo()
     : retransmittable_frames(NULL),
       sequence_number_length(PACKET_1BYTE_SEQUENCE_NUMBER),
@@ -53,8 +62,34 @@ QuicUnackedPacketMap::TransmissionInfo::TransmissionInfo(
   all_transmissions->insert(sequence_number);
 }
 
+QuicUnackedPacketMap::const_iterator::const_iterator(
+    const QuicUnackedPacketMap* map,
+    QuicPacketSequenceNumber sequence_number)
+    : map_(map),
+      sequence_number_(sequence_number) {
+}
+
+const QuicUnackedPacketMap::Entry&
+QuicUnackedPacketMap::const_iterator::operator*() const {
+  DCHECK(map_->IsUnacked(sequence_number_));
+  return map_->unacked_packets_[map_->LowerBoundIndex(sequence_number_)];
+}
+
+const QuicUnackedPacketMap::Entry*
+QuicUnackedPacketMap::const_iterator::operator->() const {
+  return &**this;
+}
+
+QuicUnackedPacketMap::const_iterator&
+QuicUnackedPacketMap::const_iterator::operator++() {
+  DCHECK_NE(0u, sequence_number_);
+  sequence_number_ = map_->NextUnacked(sequence_number_);
+  return *this;
+}
+
 QuicUnackedPacketMap::QuicUnackedPacketMap(bool is_server)
     : largest_sent_packet_(0),
+      num_unacked_packets_(0),
       bytes_in_flight_(0),
       is_server_(is_server) {
 }
@@ -62,6 +97,9 @@ QuicUnackedPacketMap::QuicUnackedPacketMap(bool is_server)
 QuicUnackedPacketMap::~QuicUnackedPacketMap() {
   for (UnackedPacketMap::iterator it = unacked_packets_.begin();
        it != unacked_packets_.end(); ++it) {
+    if (it->second.all_transmissions == NULL) {
+      continue;
+    }
     delete it->second.retransmittable_frames;
     // Only delete all_transmissions once, for the newest packet.
     if (it->first == *it->second.all_transmissions->rbegin()) {
@@ -70,35 +108,114 @@ QuicUnackedPacketMap::~QuicUnackedPacketMap() {
   }
 }
 
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::begin() const {
+  if (unacked_packets_.empty()) {
+    return end();
+  }
+  return const_iterator(this, unacked_packets_.front().first);
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::LowerBound(
+    QuicPacketSequenceNumber sequence_number) const {
+  if (IsUnacked(sequence_number)) {
+    return const_iterator(this, sequence_number);
+  }
+  return const_iterator(this, NextUnacked(sequence_number));
+}
+
+size_t QuicUnackedPacketMap::LowerBoundIndex(
+    QuicPacketSequenceNumber sequence_number) const {
+  if (unacked_packets_.empty() ||
+      sequence_number <= unacked_packets_.front().first) {
+    return 0;
+  }
+  const size_t offset = sequence_number - unacked_packets_.front().first;
+  if (offset < unacked_packets_.size() &&
+      unacked_packets_[offset].first == sequence_number) {
+    return offset;
+  }
+  // Some sequence numbers were never added, so search for it.
+  UnackedPacketMap::const_iterator it = std::lower_bound(
+      unacked_packets_.begin(), unacked_packets_.end(),
+      Entry(sequence_number, TransmissionInfo()), CompareSequenceNumbers);
+  return it - unacked_packets_.begin();
+}
+
+QuicUnackedPacketMap::TransmissionInfo*
+QuicUnackedPacketMap::FindTransmissionInfo(
+    QuicPacketSequenceNumber sequence_number) {
+  size_t index = LowerBoundIndex(sequence_number);
+  if (index == unacked_packets_.size() ||
+      unacked_packets_[index].first != sequence_number ||
+      unacked_packets_[index].second.all_transmissions == NULL) {
+    return NULL;
+  }
+  return &unacked_packets_[index].second;
+}
+
+const QuicUnackedPacketMap::TransmissionInfo*
+QuicUnackedPacketMap::FindTransmissionInfo(
+    QuicPacketSequenceNumber sequence_number) const {
+  return const_cast<QuicUnackedPacketMap*>(this)->FindTransmissionInfo(
+      sequence_number);
+}
+
+QuicPacketSequenceNumber QuicUnackedPacketMap::NextUnacked(
+    QuicPacketSequenceNumber sequence_number) const {
+  for (size_t index = LowerBoundIndex(sequence_number + 1);
+       index < unacked_packets_.size(); ++index) {
+    if (unacked_packets_[index].second.all_transmissions != NULL) {
+      return unacked_packets_[index].first;
+    }
+  }
+  return 0;
+}
+
+void QuicUnackedPacketMap::TrimAbsentEntries() {
+  while (!unacked_packets_.empty() &&
+         unacked_packets_.front().second.all_transmissions == NULL) {
+    unacked_packets_.pop_front();
+  }
+  while (!unacked_packets_.empty() &&
+         unacked_packets_.back().second.all_transmissions == NULL) {
+    unacked_packets_.pop_back();
+  }
+}
+
 // TODO(ianswett): Combine this method with OnPacketSent once packets are always
 // sent in order and the connection tracks RetransmittableFrames for longer.
 void QuicUnackedPacketMap::AddPacket(
     const SerializedPacket& serialized_packet) {
   if (!unacked_packets_.empty()) {
-    bool is_old_packet = unacked_packets_.rbegin()->first >=
+    bool is_old_packet = unacked_packets_.back().first >=
         serialized_packet.sequence_number;
     LOG_IF(DFATAL, is_old_packet) << "Old packet serialized: "
                                   << serialized_packet.sequence_number
                                   << " vs: "
-                                  << unacked_packets_.rbegin()->first;
+                                  << unacked_packets_.back().first;
+    if (is_old_packet) {
+      return;
+    }
   }
 
-  unacked_packets_[serialized_packet.sequence_number] =
+  unacked_packets_.push_back(Entry(
+      serialized_packet.sequence_number,
       TransmissionInfo(serialized_packet.retransmittable_frames,
                        serialized_packet.sequence_number,
-                       serialized_packet.sequence_number_length);
+                       serialized_packet.sequence_number_length)));
+  ++num_unacked_packets_;
 }
 
 void QuicUnackedPacketMap::OnRetransmittedPacket(
     QuicPacketSequenceNumber old_sequence_number,
     QuicPacketSequenceNumber new_sequence_number) {
-  DCHECK(ContainsKey(unacked_packets_, old_sequence_number));
+  DCHECK(IsUnacked(old_sequence_number));
   DCHECK(unacked_packets_.empty() ||
-         unacked_packets_.rbegin()->first < new_sequence_number);
+         unacked_packets_.back().first < new_sequence_number);
 
   // TODO(ianswett): Discard and lose the packet lazily instead of immediately.
   TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, old_sequence_number);
+      FindTransmissionInfo(old_sequence_number);
   RetransmittableFrames* frames = transmission_info->retransmittable_frames;
   LOG_IF(DFATAL, frames == NULL) << "Attempt to retransmit packet with no "
                                  << "retransmittable frames: "
@@ -107,26 +224,27 @@ void QuicUnackedPacketMap::OnRetransmittedPacket(
   // We keep the old packet in the unacked packet list until it, or one of
   // the retransmissions of it are acked.
   transmission_info->retransmittable_frames = NULL;
-  unacked_packets_[new_sequence_number] =
+  unacked_packets_.push_back(Entry(
+      new_sequence_number,
       TransmissionInfo(frames,
                        new_sequence_number,
                        transmission_info->sequence_number_length,
-                       transmission_info->all_transmissions);
+                       transmission_info->all_transmissions)));
+  ++num_unacked_packets_;
 }
 
 void QuicUnackedPacketMap::ClearPreviousRetransmissions(size_t num_to_clear) {
-  UnackedPacketMap::iterator it = unacked_packets_.begin();
-  while (it != unacked_packets_.end() && num_to_clear > 0) {
-    QuicPacketSequenceNumber sequence_number = it->first;
+  while (!unacked_packets_.empty() && num_to_clear > 0) {
+    // The front entry is never absent.
+    const Entry& entry = unacked_packets_.front();
     // If this is a pending packet, or has retransmittable data, then there is
     // no point in clearing out any further packets, because they would not
     // affect the high water mark.
-    if (it->second.pending || it->second.retransmittable_frames != NULL) {
+    if (entry.second.pending || entry.second.retransmittable_frames != NULL) {
       break;
     }
 
-    ++it;
-    RemovePacket(sequence_number);
+    RemovePacket(entry.first);
     --num_to_clear;
   }
 }
@@ -134,7 +252,7 @@ void QuicUnackedPacketMap::ClearPreviousRetransmissions(size_t num_to_clear) {
 bool QuicUnackedPacketMap::HasRetransmittableFrames(
     QuicPacketSequenceNumber sequence_number) const {
   const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
+      FindTransmissionInfo(sequence_number);
   if (transmission_info == NULL) {
     return false;
   }
@@ -144,45 +262,47 @@ bool QuicUnackedPacketMap::HasRetransmittableFrames(
 
 void QuicUnackedPacketMap::NackPacket(QuicPacketSequenceNumber sequence_number,
                                       size_t min_nacks) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindTransmissionInfo(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "NackPacket called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
 
-  it->second.nack_count = max(min_nacks, it->second.nack_count + 1);
+  transmission_info->nack_count =
+      max(min_nacks, transmission_info->nack_count + 1);
 }
 
 void QuicUnackedPacketMap::RemovePacket(
     QuicPacketSequenceNumber sequence_number) {
   DVLOG(1) << __FUNCTION__ << " " << sequence_number;
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindTransmissionInfo(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  const TransmissionInfo& transmission_info = it->second;
-  transmission_info.all_transmissions->erase(sequence_number);
-  if (transmission_info.all_transmissions->empty()) {
-    delete transmission_info.all_transmissions;
+  transmission_info->all_transmissions->erase(sequence_number);
+  if (transmission_info->all_transmissions->empty()) {
+    delete transmission_info->all_transmissions;
   }
-  if (transmission_info.retransmittable_frames != NULL) {
-    delete transmission_info.retransmittable_frames;
+  if (transmission_info->retransmittable_frames != NULL) {
+    delete transmission_info->retransmittable_frames;
   }
-  unacked_packets_.erase(it);
+  // Leave an absent entry behind.
+  *transmission_info = TransmissionInfo();
+  --num_unacked_packets_;
+  TrimAbsentEntries();
 }
 
 void QuicUnackedPacketMap::NeuterPacket(
     QuicPacketSequenceNumber sequence_number) {
-  DVLOG(1) << __FUNCTION__ << " " << sequence_number << " pending? "
-           << unacked_packets_[sequence_number].pending;
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindTransmissionInfo(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  TransmissionInfo* transmission_info = &it->second;
+  DVLOG(1) << __FUNCTION__ << " " << sequence_number << " pending? "
+           << transmission_info->pending;
   if (transmission_info->all_transmissions->size() > 1) {
     transmission_info->all_transmissions->erase(sequence_number);
     transmission_info->all_transmissions = new SequenceNumberSet();
@@ -196,28 +316,32 @@ void QuicUnackedPacketMap::NeuterPacket(
 
 bool QuicUnackedPacketMap::IsUnacked(
     QuicPacketSequenceNumber sequence_number) const {
-  return ContainsKey(unacked_packets_, sequence_number);
+  return FindTransmissionInfo(sequence_number) != NULL;
 }
 
 bool QuicUnackedPacketMap::IsPending(
     QuicPacketSequenceNumber sequence_number) const {
   const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
+      FindTransmissionInfo(sequence_number);
   return transmission_info != NULL && transmission_info->pending;
 }
 
 void QuicUnackedPacketMap::SetNotPending(
     QuicPacketSequenceNumber sequence_number) {
-  if (unacked_packets_[sequence_number].pending) {
-    LOG_IF(DFATAL,
-           bytes_in_flight_ < unacked_packets_[sequence_number].bytes_sent);
-    bytes_in_flight_ -= unacked_packets_[sequence_number].bytes_sent;
-    unacked_packets_[sequence_number].pending = false;
+  TransmissionInfo* transmission_info = FindTransmissionInfo(sequence_number);
+  if (transmission_info == NULL) {
+    LOG(DFATAL) << "packet is not unacked: " << sequence_number;
+    return;
+  }
+  if (transmission_info->pending) {
+    LOG_IF(DFATAL, bytes_in_flight_ < transmission_info->bytes_sent);
+    bytes_in_flight_ -= transmission_info->bytes_sent;
+    transmission_info->pending = false;
   }
 }
 
 bool QuicUnackedPacketMap::HasUnackedPackets() const {
-  return !unacked_packets_.empty();
+  return num_unacked_packets_ > 0;
 }
 
 bool QuicUnackedPacketMap::HasPendingPackets() const {
@@ -233,7 +357,11 @@ bool QuicUnackedPacketMap::HasPendingPackets() const {
 const QuicUnackedPacketMap::TransmissionInfo&
     QuicUnackedPacketMap::GetTransmissionInfo(
         QuicPacketSequenceNumber sequence_number) const {
-  return unacked_packets_.find(sequence_number)->second;
+  const TransmissionInfo* transmission_info =
+      FindTransmissionInfo(sequence_number);
+  DCHECK(transmission_info != NULL) << "packet is not unacked: "
+                                    << sequence_number;
+  return *transmission_info;
 }
 
 QuicTime QuicUnackedPacketMap::GetLastPacketSentTime() const {
@@ -263,7 +391,7 @@ QuicTime QuicUnackedPacketMap::GetFirstPendingPacketSentTime() const {
 }
 
 size_t QuicUnackedPacketMap::GetNumUnackedPackets() const {
-  return unacked_packets_.size();
+  return num_unacked_packets_;
 }
 
 bool QuicUnackedPacketMap::HasMultiplePendingPackets() const {
@@ -308,13 +436,12 @@ QuicUnackedPacketMap::GetLeastUnackedSentPacket() const {
     return 0;
   }
 
-  return unacked_packets_.begin()->first;
+  return unacked_packets_.front().first;
 }
 
 SequenceNumberSet QuicUnackedPacketMap::GetUnackedPackets() const {
   SequenceNumberSet unacked_packets;
-  for (UnackedPacketMap::const_iterator it = unacked_packets_.begin();
-       it != unacked_packets_.end(); ++it) {
+  for (const_iterator it = begin(); it != end(); ++it) {
     unacked_packets.insert(it->first);
   }
   return unacked_packets;
@@ -324,19 +451,19 @@ void QuicUnackedPacketMap::SetPending(QuicPacketSequenceNumber sequence_number,
                                       QuicTime sent_time,
                                       QuicByteCount bytes_sent) {
   DCHECK_LT(0u, sequence_number);
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindTransmissionInfo(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "OnPacketSent called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
-  DCHECK(!it->second.pending);
+  DCHECK(!transmission_info->pending);
 
   largest_sent_packet_ = max(sequence_number, largest_sent_packet_);
   bytes_in_flight_ += bytes_sent;
-  it->second.sent_time = sent_time;
-  it->second.bytes_sent = bytes_sent;
-  it->second.pending = true;
+  transmission_info->sent_time = sent_time;
+  transmission_info->bytes_sent = bytes_sent;
+  transmission_info->pending = true;
 }
 
 }  // namespace net
@@ -5,7 +5,9 @@
 #ifndef NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 #define NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 
-#include "net/base/linked_hash_map.h"
+#include <deque>
+#include <utility>
+
 #include "net/quic/quic_protocol.h"
 
 namespace net {
@@ -116,13 +118,40 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // in the ack frame for new acks.
   void ClearPreviousRetransmissions(size_t num_to_clear);
 
-  typedef linked_hash_map<QuicPacketSequenceNumber,
-                          TransmissionInfo> UnackedPacketMap;
+  typedef std::pair<QuicPacketSequenceNumber, TransmissionInfo> Entry;
+
+  // Iterates over the unacked packets in increasing sequence number order.
+  // An iterator stays valid while packets are added or removed unless the
+  // packet it points to is itself removed, in which case it may still be
+  // incremented.
+  class NET_EXPORT_PRIVATE const_iterator {
+   public:
+    const_iterator(const QuicUnackedPacketMap* map,
+                   QuicPacketSequenceNumber sequence_number);
+
+    const Entry& operator*() const;
+    const Entry* operator->() const;
+    const_iterator& operator++();
+
+    bool operator==(const const_iterator& other) const {
+      return sequence_number_ == other.sequence_number_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    const QuicUnackedPacketMap* map_;
+    // The sequence number of the current packet, or 0 at the end.
+    QuicPacketSequenceNumber sequence_number_;
+  };
 
-  typedef UnackedPacketMap::const_iterator const_iterator;
+  const_iterator begin() const;
+  const_iterator end() const { return const_iterator(this, 0); }
 
-  const_iterator begin() const { return unacked_packets_.begin(); }
-  const_iterator end() const { return unacked_packets_.end(); }
+  // Returns an iterator to the first unacked packet whose sequence number is
+  // not less than |sequence_number|.
+  const_iterator LowerBound(QuicPacketSequenceNumber sequence_number) const;
 
   // Returns true if there are unacked packets that are pending.
   bool HasPendingPackets() const;
@@ -154,6 +183,31 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   void NeuterPacket(QuicPacketSequenceNumber sequence_number);
 
  private:
+  // Packets are stored in increasing sequence number order.  Removing a
+  // packet leaves an absent entry, one whose all_transmissions is NULL, in
+  // its place, so while sequence numbers are consecutive a packet is found by
+  // its distance from the front rather than by a search.  Absent entries at
+  // either end are trimmed, so the front entry is always an unacked packet.
+  typedef std::deque<Entry> UnackedPacketMap;
+
+  // Returns the index of the first entry whose sequence number is not less
+  // than |sequence_number|.
+  size_t LowerBoundIndex(QuicPacketSequenceNumber sequence_number) const;
+
+  // Returns the entry for |sequence_number|, or NULL if it is not unacked.
+  TransmissionInfo* FindTransmissionInfo(
+      QuicPacketSequenceNumber sequence_number);
+  const TransmissionInfo* FindTransmissionInfo(
+      QuicPacketSequenceNumber sequence_number) const;
+
+  // Returns the sequence number of the first unacked packet after
+  // |sequence_number|, or 0 if there is none.
+  QuicPacketSequenceNumber NextUnacked(
+      QuicPacketSequenceNumber sequence_number) const;
+
+  // Drops absent entries from both ends of |unacked_packets_|.
+  void TrimAbsentEntries();
+
   QuicPacketSequenceNumber largest_sent_packet_;
 
   // Newly serialized retransmittable and fec packets are added to this map,
@@ -166,6 +220,9 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // set to NULL.
   UnackedPacketMap unacked_packets_;
 
+  // The number of entries in |unacked_packets_| which are not absent.
+  size_t num_unacked_packets_;
+
   size_t bytes_in_flight_;
 
   bool is_server_;
@@ -0,0 +1,83 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_time_logger.h"
+#include "net/quic/quic_unacked_packet_map.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+// Roughly a 100Mbps, 200ms path worth of full sized packets.
+const QuicPacketSequenceNumber kNumPackets = 2000;
+const int kNumRounds = 50;
+// Every kLossInterval'th packet is missing from the acks, and is given up on
+// once it has been nacked kNumNacksBeforeLoss times.
+const QuicPacketSequenceNumber kLossInterval = 100;
+const size_t kNumNacksBeforeLoss = 3;
+
+void SendPackets(QuicUnackedPacketMap* unacked_packets,
+                 QuicPacketSequenceNumber first,
+                 QuicPacketSequenceNumber last) {
+  for (QuicPacketSequenceNumber i = first; i <= last; ++i) {
+    unacked_packets->AddPacket(SerializedPacket(
+        i, PACKET_6BYTE_SEQUENCE_NUMBER, NULL, 0,
+        new RetransmittableFrames()));
+    unacked_packets->SetPending(i, QuicTime::Zero(), kMaxPacketSize);
+  }
+}
+
+// Handles an ack of every packet up to |largest_observed| which is not a
+// multiple of kLossInterval, the way QuicSentPacketManager does.  Returns the
+// number of packets which were lost.
+size_t ProcessAck(QuicUnackedPacketMap* unacked_packets,
+                  QuicPacketSequenceNumber largest_observed) {
+  size_t num_lost = 0;
+  QuicUnackedPacketMap::const_iterator it = unacked_packets->begin();
+  while (it != unacked_packets->end() && it->first <= largest_observed) {
+    QuicPacketSequenceNumber sequence_number = it->first;
+    if (sequence_number % kLossInterval == 0) {
+      unacked_packets->NackPacket(sequence_number, 0);
+      if (it->second.nack_count < kNumNacksBeforeLoss) {
+        ++it;
+        continue;
+      }
+      ++num_lost;
+    }
+    unacked_packets->SetNotPending(sequence_number);
+    unacked_packets->RemovePacket(sequence_number);
+    it = unacked_packets->LowerBound(sequence_number);
+  }
+  return num_lost;
+}
+
+TEST(QuicUnackedPacketMapPerfTest, ProcessAcks) {
+  QuicUnackedPacketMap unacked_packets(true);
+  QuicPacketSequenceNumber next_sequence_number = 1;
+  size_t num_lost = 0;
+
+  base::PerfTimeLogger timer("QUIC unacked packet map ack processing");
+  for (int round = 0; round < kNumRounds; ++round) {
+    SendPackets(&unacked_packets, next_sequence_number,
+                next_sequence_number + kNumPackets - 1);
+    next_sequence_number += kNumPackets;
+    // Ack the round's packets a few at a time, as they would arrive.
+    for (QuicPacketSequenceNumber acked = next_sequence_number - kNumPackets;
+         acked < next_sequence_number; acked += 2) {
+      num_lost += ProcessAck(&unacked_packets, acked + 1);
+    }
+  }
+  timer.Done();
+
+  // All but the last few nacked packets have been lost.
+  EXPECT_EQ(kNumRounds * kNumPackets / kLossInterval,
+            num_lost + unacked_packets.GetNumUnackedPackets());
+  EXPECT_GT(static_cast<size_t>(kNumNacksBeforeLoss),
+            unacked_packets.GetNumUnackedPackets());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
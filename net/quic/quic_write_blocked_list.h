@@ -7,16 +7,18 @@
 
 #include "net/base/net_export.h"
 #include "net/quic/quic_protocol.h"
-#include "net/spdy/write_blocked_list.h"
+#include "net/spdy/spdy_write_scheduler.h"
 
 namespace net {
 
 // Keeps tracks of the QUIC streams that have data to write, sorted by
 // priority.  QUIC stream priority order is:
 // Crypto stream > Headers stream > Data streams by requested priority.
+// Data streams of the same priority share bandwidth by the bytes they
+// report through RecordBytesWritten().
 class NET_EXPORT_PRIVATE QuicWriteBlockedList {
  private:
-  typedef WriteBlockedList<QuicStreamId> QuicWriteBlockedListBase;
+  typedef SpdyWriteScheduler<QuicStreamId> QuicWriteBlockedListBase;
 
  public:
   static const QuicPriority kHighestPriority;
@@ -28,11 +30,11 @@ class NET_EXPORT_PRIVATE QuicWriteBlockedList {
   bool HasWriteBlockedStreams() const {
     return crypto_stream_blocked_ ||
         headers_stream_blocked_ ||
-        base_write_blocked_list_.HasWriteBlockedStreams();
+        base_write_blocked_list_.HasReadyStreams();
   }
 
   size_t NumBlockedStreams() const {
-    size_t num_blocked = base_write_blocked_list_.NumBlockedStreams();
+    size_t num_blocked = base_write_blocked_list_.NumReadyStreams();
     if (crypto_stream_blocked_) {
       ++num_blocked;
     }
@@ -51,9 +53,7 @@ class NET_EXPORT_PRIVATE QuicWriteBlockedList {
       headers_stream_blocked_ = false;
       return kHeadersStreamId;
     } else {
-      SpdyPriority priority =
-          base_write_blocked_list_.GetHighestPriorityWriteBlockedList();
-      return base_write_blocked_list_.PopFront(priority);
+      return base_write_blocked_list_.PopNextReadyStream();
     }
   }
 
@@ -71,11 +71,22 @@ class NET_EXPORT_PRIVATE QuicWriteBlockedList {
       // TODO(avd) Add DCHECK(!headers_stream_blocked_);
       headers_stream_blocked_ = true;
     } else {
-      base_write_blocked_list_.PushBack(
+      base_write_blocked_list_.MarkStreamReady(
           stream_id, static_cast<SpdyPriority>(priority));
     }
   }
 
+  // Charges |bytes| written by |stream_id| against it.  Does nothing for the
+  // crypto and headers streams, which always go first.
+  void RecordBytesWritten(QuicStreamId stream_id, size_t bytes) {
+    base_write_blocked_list_.RecordBytesWritten(stream_id, bytes);
+  }
+
+  // Forgets |stream_id|, which has closed.
+  void RemoveStream(QuicStreamId stream_id) {
+    base_write_blocked_list_.UnregisterStream(stream_id);
+  }
+
  private:
   QuicWriteBlockedListBase base_write_blocked_list_;
   bool crypto_stream_blocked_;
@@ -101,6 +101,30 @@ TEST(QuicWriteBlockedListTest, NoHeadersStreamInVersion12) {
   }
 }
 
+TEST(QuicWriteBlockedListTest, SamePriorityStreamsShareBytes) {
+  QuicWriteBlockedList write_blocked_list;
+  write_blocked_list.PushBack(5, 3, QUIC_VERSION_13);
+  write_blocked_list.PushBack(7, 3, QUIC_VERSION_13);
+
+  // Stream 5 writes a lot, so stream 7 gets to catch up before it goes
+  // again.
+  EXPECT_EQ(5u, write_blocked_list.PopFront());
+  write_blocked_list.RecordBytesWritten(5, 4000);
+  write_blocked_list.PushBack(5, 3, QUIC_VERSION_13);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(7u, write_blocked_list.PopFront());
+    write_blocked_list.RecordBytesWritten(7, 1000);
+    write_blocked_list.PushBack(7, 3, QUIC_VERSION_13);
+  }
+  EXPECT_EQ(5u, write_blocked_list.PopFront());
+  EXPECT_EQ(1u, write_blocked_list.NumBlockedStreams());
+
+  // A closed stream is no longer blocked.
+  write_blocked_list.RemoveStream(7);
+  EXPECT_EQ(0u, write_blocked_list.NumBlockedStreams());
+  EXPECT_FALSE(write_blocked_list.HasWriteBlockedStreams());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
@@ -17,6 +17,7 @@
 #include "base/memory/singleton.h"
 #include "base/metrics/histogram.h"
 #include "base/synchronization/lock.h"
+#include "base/values.h"
 #include "crypto/ec_private_key.h"
 #include "crypto/openssl_util.h"
 #include "net/base/net_errors.h"
@@ -219,6 +220,21 @@ int NoOpVerifyCallback(X509_STORE_CTX*, void *) {
   return 1;
 }
 
+// Returns NetLog parameters for the lookup of |cache_key| in the session
+// cache, using the per-key |stats| recorded by the cache.
+base::Value* NetLogSessionCacheLookupCallback(
+    const std::string* cache_key,
+    bool hit,
+    SSLSessionCacheOpenSSL::LookupStats stats,
+    NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetString("cache_key", *cache_key);
+  dict->SetBoolean("hit", hit);
+  dict->SetInteger("lookups", static_cast<int>(stats.lookups));
+  dict->SetInteger("hits", static_cast<int>(stats.hits));
+  return dict;
+}
+
 // Utility to construct the appropriate set & clear masks for use the OpenSSL
 // options and mode configuration functions. (SSL_set_options etc)
 struct SslSetClearMask {
@@ -659,8 +675,15 @@ bool SSLClientSocketOpenSSL::Init() {
   if (!SSL_set_tlsext_host_name(ssl_, host_and_port_.host().c_str()))
     return false;
 
-  trying_cached_session_ = context->session_cache()->SetSSLSessionWithKey(
-      ssl_, GetSocketSessionCacheKey(*this));
+  std::string cache_key = GetSocketSessionCacheKey(*this);
+  trying_cached_session_ =
+      context->session_cache()->SetSSLSessionWithKey(ssl_, cache_key);
+  net_log_.AddEvent(
+      NetLog::TYPE_SSL_SESSION_CACHE_LOOKUP,
+      base::Bind(&NetLogSessionCacheLookupCallback,
+                 &cache_key,
+                 trying_cached_session_,
+                 context->session_cache()->GetLookupStats(cache_key)));
 
   BIO* ssl_bio = NULL;
   // 0 => use default buffer sizes.
@@ -11,6 +11,7 @@
 #include <openssl/ssl.h>
 
 #include "base/containers/hash_tables.h"
+#include "base/containers/mru_cache.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/synchronization/lock.h"
@@ -127,6 +128,10 @@ namespace net {
 //   of |key_index_|. If is used to efficiently remove sessions from the cache,
 //   as well as check for the existence of a session ID value in the cache.
 //
+//   |stats_| maps cache keys to the lookup statistics reported by
+//   GetLookupStats(). It is kept separately from |key_index_| so that the
+//   misses for keys without a session are counted too.
+//
 //   SSL_SESSION objects are reference-counted, and owned by the cache. This
 //   means that their reference count is incremented when they are added, and
 //   decremented when they are removed.
@@ -154,7 +159,10 @@ class SSLSessionCacheOpenSSLImpl {
   // string, according to the client's preferences.
   SSLSessionCacheOpenSSLImpl(SSL_CTX* ctx,
                              const SSLSessionCacheOpenSSL::Config& config)
-      : ctx_(ctx), config_(config), expiration_check_(0) {
+      : ctx_(ctx),
+        config_(config),
+        stats_(config.max_entries),
+        expiration_check_(0) {
     DCHECK(ctx);
 
     // NO_INTERNAL_STORE disables OpenSSL's builtin cache, and
@@ -206,34 +214,26 @@ class SSLSessionCacheOpenSSLImpl {
   // the cache key. Avoid a call to the configuration's |key_func| function.
   bool SetSSLSessionWithKey(SSL* ssl, const std::string& cache_key) {
     base::AutoLock locked(lock_);
+    bool hit = SetSSLSessionWithKeyLocked(ssl, cache_key);
+
+    LookupStatsMap::iterator it = stats_.Get(cache_key);
+    if (it == stats_.end())
+      it = stats_.Put(cache_key, SSLSessionCacheOpenSSL::LookupStats());
+    it->second.lookups++;
+    if (hit)
+      it->second.hits++;
+    return hit;
+  }
 
-    DCHECK_EQ(config_.key_func(ssl), cache_key);
-
-    if (++expiration_check_ >= config_.expiration_check_count) {
-      expiration_check_ = 0;
-      FlushExpiredSessionsLocked();
-    }
-
-    KeyIndex::iterator it = key_index_.find(cache_key);
-    if (it == key_index_.end())
-      return false;
-
-    SSL_SESSION* session = *it->second;
-    DCHECK(session);
-
-    DVLOG(2) << "Lookup session: " << session << " for " << cache_key;
-
-    void* session_is_good =
-        SSL_SESSION_get_ex_data(session, GetSSLSessionExIndex());
-    if (!session_is_good)
-      return false;  // Session has not yet been marked good. Treat as a miss.
-
-    // Move to front of MRU list.
-    ordering_.push_front(session);
-    ordering_.erase(it->second);
-    it->second = ordering_.begin();
-
-    return SSL_set_session(ssl, session) == 1;
+  // Return the lookup statistics for |cache_key|, without changing their
+  // MRU order.
+  SSLSessionCacheOpenSSL::LookupStats GetLookupStats(
+      const std::string& cache_key) {
+    base::AutoLock locked(lock_);
+    LookupStatsMap::iterator it = stats_.Peek(cache_key);
+    if (it == stats_.end())
+      return SSLSessionCacheOpenSSL::LookupStats();
+    return it->second;
   }
 
   void MarkSSLSessionAsGood(SSL* ssl) {
@@ -249,6 +249,7 @@ class SSLSessionCacheOpenSSLImpl {
   // Flush all entries from the cache.
   void Flush() {
     base::AutoLock lock(lock_);
+    stats_.Clear();
     id_index_.clear();
     key_index_.clear();
     while (!ordering_.empty()) {
@@ -265,6 +266,42 @@ class SSLSessionCacheOpenSSLImpl {
   typedef base::hash_map<std::string, MRUSessionList::iterator> KeyIndex;
   // Type for a dictionary from SessionId values to key index nodes.
   typedef base::hash_map<SessionId, KeyIndex::iterator> SessionIdIndex;
+  // Type for the MRU dictionary from unique cache keys to lookup statistics.
+  typedef base::MRUCache<std::string, SSLSessionCacheOpenSSL::LookupStats>
+      LookupStatsMap;
+
+  // Look for a cached session for |cache_key| and associate it with |ssl|.
+  // Lock must be held.
+  bool SetSSLSessionWithKeyLocked(SSL* ssl, const std::string& cache_key) {
+    lock_.AssertAcquired();
+    DCHECK_EQ(config_.key_func(ssl), cache_key);
+
+    if (++expiration_check_ >= config_.expiration_check_count) {
+      expiration_check_ = 0;
+      FlushExpiredSessionsLocked();
+    }
+
+    KeyIndex::iterator it = key_index_.find(cache_key);
+    if (it == key_index_.end())
+      return false;
+
+    SSL_SESSION* session = *it->second;
+    DCHECK(session);
+
+    DVLOG(2) << "Lookup session: " << session << " for " << cache_key;
+
+    void* session_is_good =
+        SSL_SESSION_get_ex_data(session, GetSSLSessionExIndex());
+    if (!session_is_good)
+      return false;  // Session has not yet been marked good. Treat as a miss.
+
+    // Move to front of MRU list.
+    ordering_.push_front(session);
+    ordering_.erase(it->second);
+    it->second = ordering_.begin();
+
+    return SSL_set_session(ssl, session) == 1;
+  }
 
   // Return the key associated with a given session, or the empty string if
   // none exist. This shall only be used for debugging.
@@ -474,6 +511,7 @@ class SSLSessionCacheOpenSSLImpl {
   MRUSessionList ordering_;
   KeyIndex key_index_;
   SessionIdIndex id_index_;
+  LookupStatsMap stats_;
 
   size_t expiration_check_;
 };
@@ -503,6 +541,11 @@ void SSLSessionCacheOpenSSL::MarkSSLSessionAsGood(SSL* ssl) {
   return impl_->MarkSSLSessionAsGood(ssl);
 }
 
+SSLSessionCacheOpenSSL::LookupStats SSLSessionCacheOpenSSL::GetLookupStats(
+    const std::string& cache_key) const {
+  return impl_->GetLookupStats(cache_key);
+}
+
 void SSLSessionCacheOpenSSL::Flush() { impl_->Flush(); }
 
 }  // namespace net
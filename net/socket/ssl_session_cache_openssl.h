@@ -66,6 +66,15 @@ class NET_EXPORT SSLSessionCacheOpenSSL {
     int timeout_seconds;
   };
 
+  // Counts of the SetSSLSession() and SetSSLSessionWithKey() calls made for
+  // a given cache key, and of those which found a session to resume.
+  struct LookupStats {
+    LookupStats() : lookups(0), hits(0) {}
+
+    size_t lookups;
+    size_t hits;
+  };
+
   SSLSessionCacheOpenSSL() : impl_(NULL) {}
 
   // Construct a new cache instance.
@@ -121,6 +130,11 @@ class NET_EXPORT SSLSessionCacheOpenSSL {
   // only validated sessions are resumed.
   void MarkSSLSessionAsGood(SSL* ssl);
 
+  // Return the lookup statistics recorded for |cache_key|. Statistics are
+  // kept for at most the configuration's |max_entries| most recently used
+  // keys, and are cleared by Flush().
+  LookupStats GetLookupStats(const std::string& cache_key) const;
+
   // Flush removes all entries from the cache. This is typically called when
   // the system's certificate store has changed.
   void Flush();
@@ -237,6 +237,27 @@ TEST_F(SSLSessionCacheOpenSSLTest, SetSSLSessionWithKey) {
   EXPECT_TRUE(cache_.SetSSLSessionWithKey(ssl2.get(), key));
 }
 
+TEST_F(SSLSessionCacheOpenSSLTest, LookupStats) {
+  const std::string key("hello");
+  ScopedSSL ssl(NewSSL(key));
+  EXPECT_FALSE(cache_.SetSSLSessionWithKey(ssl.get(), key));
+  AddToCache(ssl.get());
+  cache_.MarkSSLSessionAsGood(ssl.get());
+  ssl.reset(NULL);
+
+  ScopedSSL ssl2(NewSSL(key));
+  EXPECT_TRUE(cache_.SetSSLSessionWithKey(ssl2.get(), key));
+
+  SSLSessionCacheOpenSSL::LookupStats stats = cache_.GetLookupStats(key);
+  EXPECT_EQ(2U, stats.lookups);
+  EXPECT_EQ(1U, stats.hits);
+  EXPECT_EQ(0U, cache_.GetLookupStats("world").lookups);
+
+  // Flushing the cache also resets its statistics.
+  cache_.Flush();
+  EXPECT_EQ(0U, cache_.GetLookupStats(key).lookups);
+}
+
 TEST_F(SSLSessionCacheOpenSSLTest, CheckSessionReplacement) {
   // Check that if two SSL connections have the same key, only one
   // corresponding session can be stored in the cache.
@@ -5,6 +5,7 @@
 #include "net/socket/transport_client_socket_pool.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "base/compiler_specific.h"
 #include "base/lazy_instance.h"
@@ -35,6 +36,13 @@ const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
 namespace {
 
+// The number of destinations AddressFamilyPreferences remembers.
+const size_t kMaxRaceStatsDestinations = 200;
+
+// Once a family has won this many more races, the counts are halved, so that
+// a change of network is picked up after a few connects.
+const int kMaxRaceWins = 8;
+
 // Returns true iff all addresses in |list| are in the IPv6 family.
 bool AddressListOnlyContainsIPv6(const AddressList& list) {
   DCHECK(!list.empty());
@@ -46,8 +54,60 @@ bool AddressListOnlyContainsIPv6(const AddressList& list) {
   return true;
 }
 
+// Returns true iff |list| has addresses of more than one family.
+bool AddressListContainsBothFamilies(const AddressList& list) {
+  DCHECK(!list.empty());
+  AddressFamily family = list.front().GetFamily();
+  for (AddressList::const_iterator iter = list.begin(); iter != list.end();
+       ++iter) {
+    if (iter->GetFamily() != family)
+      return true;
+  }
+  return false;
+}
+
+AddressFamily OtherFamily(AddressFamily family) {
+  return family == ADDRESS_FAMILY_IPV4 ?
+      ADDRESS_FAMILY_IPV6 : ADDRESS_FAMILY_IPV4;
+}
+
 }  // namespace
 
+AddressFamilyPreferences::AddressFamilyPreferences()
+    : race_stats_(kMaxRaceStatsDestinations) {}
+
+AddressFamilyPreferences::~AddressFamilyPreferences() {}
+
+AddressFamily AddressFamilyPreferences::GetPreferredFamily(
+    const HostPortPair& destination) const {
+  RaceStatsMap::const_iterator it = race_stats_.Peek(destination);
+  if (it == race_stats_.end())
+    return ADDRESS_FAMILY_UNSPECIFIED;
+  if (it->second.ipv4_wins > it->second.ipv6_wins)
+    return ADDRESS_FAMILY_IPV4;
+  if (it->second.ipv6_wins > it->second.ipv4_wins)
+    return ADDRESS_FAMILY_IPV6;
+  return ADDRESS_FAMILY_UNSPECIFIED;
+}
+
+void AddressFamilyPreferences::RecordRaceWinner(
+    const HostPortPair& destination,
+    AddressFamily family) {
+  DCHECK(family == ADDRESS_FAMILY_IPV4 || family == ADDRESS_FAMILY_IPV6);
+  RaceStatsMap::iterator it = race_stats_.Get(destination);
+  if (it == race_stats_.end())
+    it = race_stats_.Put(destination, RaceStats());
+  RaceStats* stats = &it->second;
+  if (family == ADDRESS_FAMILY_IPV4)
+    ++stats->ipv4_wins;
+  else
+    ++stats->ipv6_wins;
+  if (std::abs(stats->ipv4_wins - stats->ipv6_wins) > kMaxRaceWins) {
+    stats->ipv4_wins /= 2;
+    stats->ipv6_wins /= 2;
+  }
+}
+
 // This lock protects |g_last_connect_time|.
 static base::LazyInstance<base::Lock>::Leaky
     g_last_connect_time_lock = LAZY_INSTANCE_INITIALIZER;
@@ -88,6 +148,7 @@ TransportConnectJob::TransportConnectJob(
     base::TimeDelta timeout_duration,
     ClientSocketFactory* client_socket_factory,
     HostResolver* host_resolver,
+    AddressFamilyPreferences* family_preferences,
     Delegate* delegate,
     NetLog* net_log)
     : ConnectJob(group_name, timeout_duration, priority, delegate,
@@ -95,6 +156,7 @@ TransportConnectJob::TransportConnectJob(
       params_(params),
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
+      family_preferences_(family_preferences),
       next_state_(STATE_NONE),
       interval_between_connects_(CONNECT_INTERVAL_GT_20MS) {
 }
@@ -121,8 +183,15 @@ LoadState TransportConnectJob::GetLoadState() const {
 
 // static
 void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
+  MakeAddressListStartWithFamily(list, ADDRESS_FAMILY_IPV4);
+}
+
+// static
+void TransportConnectJob::MakeAddressListStartWithFamily(
+    AddressList* list,
+    AddressFamily family) {
   for (AddressList::iterator i = list->begin(); i != list->end(); ++i) {
-    if (i->GetFamily() == ADDRESS_FAMILY_IPV4) {
+    if (i->GetFamily() == family) {
       std::rotate(list->begin(), i, list->end());
       break;
     }
@@ -193,6 +262,15 @@ int TransportConnectJob::DoResolveHostComplete(int result) {
     if (result == OK)
       next_state_ = STATE_TRANSPORT_CONNECT;
   }
+
+  // Start with the family that has been winning races to this destination,
+  // rather than the one the resolver put first.
+  if (result == OK && family_preferences_) {
+    AddressFamily preferred_family = family_preferences_->GetPreferredFamily(
+        params_->destination().host_port_pair());
+    if (preferred_family != ADDRESS_FAMILY_UNSPECIFIED)
+      MakeAddressListStartWithFamily(&addresses_, preferred_family);
+  }
   return result;
 }
 
@@ -221,12 +299,10 @@ int TransportConnectJob::DoTransportConnect() {
         addresses_, net_log().net_log(), net_log().source());
   int rv = transport_socket_->Connect(
       base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
-  if (rv == ERR_IO_PENDING &&
-      addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6 &&
-      !AddressListOnlyContainsIPv6(addresses_)) {
+  if (rv == ERR_IO_PENDING && AddressListContainsBothFamilies(addresses_)) {
     fallback_timer_.Start(FROM_HERE,
         base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
+        this, &TransportConnectJob::DoFallbackTransportConnect);
   }
   return rv;
 }
@@ -303,6 +379,8 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
                                    100);
       }
     }
+    if (AddressListContainsBothFamilies(addresses_))
+      RecordRaceWinner(addresses_.front().GetFamily());
     SetSocket(transport_socket_.Pass());
     fallback_timer_.Stop();
   } else {
@@ -314,7 +392,7 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
   return result;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnect() {
+void TransportConnectJob::DoFallbackTransportConnect() {
   // The timer should only fire while we're waiting for the main connect to
   // succeed.
   if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
@@ -326,20 +404,21 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
   DCHECK(!fallback_addresses_.get());
 
   fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddressListStartWithIPv4(fallback_addresses_.get());
+  MakeAddressListStartWithFamily(fallback_addresses_.get(),
+                                 OtherFamily(addresses_.front().GetFamily()));
   fallback_transport_socket_ =
       client_socket_factory_->CreateTransportClientSocket(
           *fallback_addresses_, net_log().net_log(), net_log().source());
   fallback_connect_start_time_ = base::TimeTicks::Now();
   int rv = fallback_transport_socket_->Connect(
       base::Bind(
-          &TransportConnectJob::DoIPv6FallbackTransportConnectComplete,
+          &TransportConnectJob::DoFallbackTransportConnectComplete,
           base::Unretained(this)));
   if (rv != ERR_IO_PENDING)
-    DoIPv6FallbackTransportConnectComplete(rv);
+    DoFallbackTransportConnectComplete(rv);
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
+void TransportConnectJob::DoFallbackTransportConnectComplete(int result) {
   // This should only happen when we're waiting for the main connect to succeed.
   if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
     NOTREACHED();
@@ -369,11 +448,15 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
         base::TimeDelta::FromMinutes(10),
         100);
 
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+    AddressFamily fallback_family = fallback_addresses_->front().GetFamily();
+    if (fallback_family == ADDRESS_FAMILY_IPV4) {
+      UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
+          connect_duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10),
+          100);
+    }
+    RecordRaceWinner(fallback_family);
     SetSocket(fallback_transport_socket_.Pass());
     next_state_ = STATE_NONE;
     transport_socket_.reset();
@@ -385,6 +468,13 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
   NotifyDelegateOfCompletion(result);  // Deletes |this|
 }
 
+void TransportConnectJob::RecordRaceWinner(AddressFamily family) {
+  if (family_preferences_) {
+    family_preferences_->RecordRaceWinner(
+        params_->destination().host_port_pair(), family);
+  }
+}
+
 int TransportConnectJob::ConnectInternal() {
   next_state_ = STATE_RESOLVE_HOST;
   return DoLoop(OK);
@@ -402,6 +492,7 @@ scoped_ptr<ConnectJob>
                               ConnectionTimeout(),
                               client_socket_factory_,
                               host_resolver_,
+                              family_preferences_,
                               delegate,
                               net_log_));
 }
@@ -423,7 +514,9 @@ TransportClientSocketPool::TransportClientSocketPool(
             ClientSocketPool::unused_idle_socket_timeout(),
             ClientSocketPool::used_idle_socket_timeout(),
             new TransportConnectJobFactory(client_socket_factory,
-                                           host_resolver, net_log)) {
+                                           host_resolver,
+                                           &family_preferences_,
+                                           net_log)) {
   base_.EnableConnectBackupJobs();
 }
 
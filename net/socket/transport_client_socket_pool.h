@@ -8,10 +8,12 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
+#include "net/base/address_family.h"
 #include "net/base/host_port_pair.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/single_request_host_resolver.h"
@@ -55,6 +57,34 @@ class NET_EXPORT_PRIVATE TransportSocketParams
   DISALLOW_COPY_AND_ASSIGN(TransportSocketParams);
 };
 
+// Remembers, for each destination, which address family won the recent
+// connect races to it, so that the next connect can try that family first.
+class NET_EXPORT_PRIVATE AddressFamilyPreferences {
+ public:
+  AddressFamilyPreferences();
+  ~AddressFamilyPreferences();
+
+  // Returns the family which has won more of the recent races to
+  // |destination|, or ADDRESS_FAMILY_UNSPECIFIED if neither has.
+  AddressFamily GetPreferredFamily(const HostPortPair& destination) const;
+
+  // Records that a connect to |destination| over |family| won a race.
+  void RecordRaceWinner(const HostPortPair& destination, AddressFamily family);
+
+ private:
+  struct RaceStats {
+    RaceStats() : ipv4_wins(0), ipv6_wins(0) {}
+
+    int ipv4_wins;
+    int ipv6_wins;
+  };
+  typedef base::MRUCache<HostPortPair, RaceStats> RaceStatsMap;
+
+  RaceStatsMap race_stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddressFamilyPreferences);
+};
+
 // TransportConnectJob handles the host resolution necessary for socket creation
 // and the transport (likely TCP) connect. TransportConnectJob also has fallback
 // logic for IPv6 connect() timeouts (which may happen due to networks / routers
@@ -63,6 +93,10 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
 // fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
 // a headstart) and return the one that completes first to the socket pool.
+//
+// If |family_preferences| is given, the family which has been winning races
+// to the destination goes first, and the other family is raced against it
+// after the same delay.  The winner is recorded there for later connects.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   TransportConnectJob(const std::string& group_name,
@@ -71,6 +105,7 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
                       base::TimeDelta timeout_duration,
                       ClientSocketFactory* client_socket_factory,
                       HostResolver* host_resolver,
+                      AddressFamilyPreferences* family_preferences,
                       Delegate* delegate,
                       NetLog* net_log);
   virtual ~TransportConnectJob();
@@ -82,6 +117,10 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
+  // Rolls |addrlist| forward until the first address of |family|, if any.
+  static void MakeAddressListStartWithFamily(AddressList* addrlist,
+                                             AddressFamily family);
+
   static const int kIPv6FallbackTimerInMs;
 
  private:
@@ -110,8 +149,11 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoTransportConnectComplete(int result);
 
   // Not part of the state machine.
-  void DoIPv6FallbackTransportConnect();
-  void DoIPv6FallbackTransportConnectComplete(int result);
+  void DoFallbackTransportConnect();
+  void DoFallbackTransportConnectComplete(int result);
+
+  // Records |family| as the winner of the race, if there was one.
+  void RecordRaceWinner(AddressFamily family);
 
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
@@ -121,6 +163,7 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   scoped_refptr<TransportSocketParams> params_;
   ClientSocketFactory* const client_socket_factory_;
   SingleRequestHostResolver resolver_;
+  AddressFamilyPreferences* const family_preferences_;
   AddressList addresses_;
   State next_state_;
 
@@ -195,9 +238,11 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
    public:
     TransportConnectJobFactory(ClientSocketFactory* client_socket_factory,
                          HostResolver* host_resolver,
+                         AddressFamilyPreferences* family_preferences,
                          NetLog* net_log)
         : client_socket_factory_(client_socket_factory),
           host_resolver_(host_resolver),
+          family_preferences_(family_preferences),
           net_log_(net_log) {}
 
     virtual ~TransportConnectJobFactory() {}
@@ -214,11 +259,15 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
    private:
     ClientSocketFactory* const client_socket_factory_;
     HostResolver* const host_resolver_;
+    AddressFamilyPreferences* const family_preferences_;
     NetLog* net_log_;
 
     DISALLOW_COPY_AND_ASSIGN(TransportConnectJobFactory);
   };
 
+  // Must outlive |base_|, whose ConnectJobs use it.
+  AddressFamilyPreferences family_preferences_;
+
   PoolBase base_;
 
   DISALLOW_COPY_AND_ASSIGN(TransportClientSocketPool);
@@ -5,7 +5,10 @@
 #ifndef NET_SPDY_HPACK_CONSTANTS_H_
 #define NET_SPDY_HPACK_CONSTANTS_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
+#include "net/base/net_export.h"
 
 // All section references below are to
 // http://tools.ietf.org/html/draft-ietf-httpbis-header-compression-05
@@ -20,10 +23,24 @@ struct HpackPrefix {
   size_t bit_size;
 };
 
+// An HpackHuffmanSymbol is the |length| least significant bits of
+// |code|, which encode the octet or EOS numbered |id|.
+struct HpackHuffmanSymbol {
+  uint32 code;
+  uint8 length;
+  uint16 id;
+};
+
+class HpackHuffmanTable;
+
 // The marker for a string literal that is stored unmodified (i.e.,
 // without Huffman encoding) (from 4.1.2).
 const HpackPrefix kStringLiteralIdentityEncoded = { 0x0, 1 };
 
+// The marker for a string literal that is Huffman encoded (from
+// 4.1.2).
+const HpackPrefix kStringLiteralHuffmanEncoded = { 0x1, 1 };
+
 // The opcode for an indexed header field (from 4.2).
 const HpackPrefix kIndexedOpcode = { 0x1, 1 };
 
@@ -35,6 +52,15 @@ const HpackPrefix kLiteralNoIndexOpcode = { 0x01, 2 };
 // (from 4.3.2).
 const HpackPrefix kLiteralIncrementalIndexOpcode = { 0x00, 2 };
 
+// Returns the symbols of the HPACK Huffman code, ordered by id. This
+// is the code from Appendix B of RFC 7541, which replaced the separate
+// request and response codes of earlier drafts.
+NET_EXPORT_PRIVATE std::vector<HpackHuffmanSymbol> HpackHuffmanCode();
+
+// Returns a table initialized with HpackHuffmanCode(), which is shared
+// by all encoders and decoders.
+NET_EXPORT_PRIVATE const HpackHuffmanTable& ObtainHpackHuffmanTable();
+
 }  // namespace net
 
 #endif  // NET_SPDY_HPACK_CONSTANTS_H_
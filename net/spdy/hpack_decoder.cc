@@ -6,6 +6,7 @@
 
 #include "base/basictypes.h"
 #include "net/spdy/hpack_constants.h"
+#include "net/spdy/hpack_huffman_table.h"
 #include "net/spdy/hpack_output_stream.h"
 
 namespace net {
@@ -125,8 +126,10 @@ bool HpackDecoder::DecodeNextName(
   if (!input_stream->DecodeNextUint32(&index_or_zero))
     return false;
 
-  if (index_or_zero == 0)
-    return input_stream->DecodeNextStringLiteral(next_name);
+  if (index_or_zero == 0) {
+    return DecodeNextStringLiteral(input_stream, &huffman_name_buffer_,
+                                   next_name);
+  }
 
   uint32 index = index_or_zero;
   if (index > context_.GetEntryCount())
@@ -138,7 +141,22 @@ bool HpackDecoder::DecodeNextName(
 
 bool HpackDecoder::DecodeNextValue(
     HpackInputStream* input_stream, StringPiece* next_name) {
-  return input_stream->DecodeNextStringLiteral(next_name);
+  return DecodeNextStringLiteral(input_stream, &huffman_value_buffer_,
+                                 next_name);
+}
+
+bool HpackDecoder::DecodeNextStringLiteral(HpackInputStream* input_stream,
+                                           std::string* huffman_buffer,
+                                           StringPiece* str) {
+  if (input_stream->MatchPrefixAndConsume(kStringLiteralHuffmanEncoded)) {
+    if (!input_stream->DecodeNextHuffmanString(ObtainHpackHuffmanTable(),
+                                               huffman_buffer)) {
+      return false;
+    }
+    *str = *huffman_buffer;
+    return true;
+  }
+  return input_stream->DecodeNextStringLiteral(str);
 }
 
 }  // namespace net
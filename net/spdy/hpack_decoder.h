@@ -44,6 +44,11 @@ class NET_EXPORT_PRIVATE HpackDecoder {
   const uint32 max_string_literal_size_;
   HpackEncodingContext context_;
 
+  // Storage for the most recently decoded names and values which were
+  // Huffman encoded.
+  std::string huffman_name_buffer_;
+  std::string huffman_value_buffer_;
+
   // Tries to process the next header representation and maybe emit
   // headers into |header_list| according to it. Returns true if
   // successful, or false if an error was encountered.
@@ -56,6 +61,13 @@ class NET_EXPORT_PRIVATE HpackDecoder {
   bool DecodeNextValue(HpackInputStream* input_stream,
                        base::StringPiece* next_name);
 
+  // Decodes a string literal of either encoding. A Huffman encoded
+  // literal is decoded into |huffman_buffer|, which |str| then points
+  // into.
+  bool DecodeNextStringLiteral(HpackInputStream* input_stream,
+                               std::string* huffman_buffer,
+                               base::StringPiece* str);
+
   DISALLOW_COPY_AND_ASSIGN(HpackDecoder);
 };
 
@@ -31,6 +31,19 @@ TEST(HpackDecoderTest, DecodeNextNameLiteral) {
   EXPECT_FALSE(input_stream.HasMoreData());
 }
 
+// Decoding an encoded name with a valid Huffman encoded string
+// literal should work.
+TEST(HpackDecoderTest, DecodeNextNameHuffmanLiteral) {
+  HpackDecoder decoder(kuint32max);
+  HpackInputStream input_stream(
+      kuint32max, StringPiece("\x00\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f", 10));
+
+  StringPiece string_piece;
+  EXPECT_TRUE(decoder.DecodeNextNameForTest(&input_stream, &string_piece));
+  EXPECT_EQ("custom-key", string_piece);
+  EXPECT_FALSE(input_stream.HasMoreData());
+}
+
 // Decoding an encoded name with a valid index should work.
 TEST(HpackDecoderTest, DecodeNextNameIndexed) {
   HpackDecoder decoder(kuint32max);
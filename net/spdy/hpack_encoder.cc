@@ -11,7 +11,8 @@ namespace net {
 using std::string;
 
 HpackEncoder::HpackEncoder(uint32 max_string_literal_size)
-    : max_string_literal_size_(max_string_literal_size) {}
+    : max_string_literal_size_(max_string_literal_size),
+      huffman_table_(NULL) {}
 
 HpackEncoder::~HpackEncoder() {}
 
@@ -19,6 +20,7 @@ bool HpackEncoder::EncodeHeaderSet(const std::map<string, string>& header_set,
                                    string* output) {
   // TOOD(akalin): Do more sophisticated encoding.
   HpackOutputStream output_stream(max_string_literal_size_);
+  output_stream.set_huffman_table(huffman_table_);
   for (std::map<string, string>::const_iterator it = header_set.begin();
        it != header_set.end(); ++it) {
     // TODO(akalin): Clarify in the spec that encoding with the name
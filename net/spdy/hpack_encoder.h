@@ -12,6 +12,7 @@
 #include "base/macros.h"
 #include "net/base/net_export.h"
 #include "net/spdy/hpack_encoding_context.h"
+#include "net/spdy/hpack_huffman_table.h"
 
 namespace net {
 
@@ -23,6 +24,14 @@ class NET_EXPORT_PRIVATE HpackEncoder {
   explicit HpackEncoder(uint32 max_string_literal_size);
   ~HpackEncoder();
 
+  // If |huffman_table| is non-NULL, string literals are Huffman
+  // encoded with it whenever that makes them shorter. It must outlive
+  // this object. ObtainHpackHuffmanTable() returns the table of the
+  // HPACK specification.
+  void set_huffman_table(const HpackHuffmanTable* huffman_table) {
+    huffman_table_ = huffman_table;
+  }
+
   // Encodes the given header set into the given string. Returns
   // whether or not the encoding was successful.
   bool EncodeHeaderSet(const std::map<std::string, std::string>& header_set,
@@ -30,6 +39,7 @@ class NET_EXPORT_PRIVATE HpackEncoder {
 
  private:
   const uint32 max_string_literal_size_;
+  const HpackHuffmanTable* huffman_table_;
   HpackEncodingContext context_;
 
   DISALLOW_COPY_AND_ASSIGN(HpackEncoder);
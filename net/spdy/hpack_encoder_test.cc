@@ -7,6 +7,7 @@
 #include <map>
 #include <string>
 
+#include "net/spdy/hpack_decoder.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -39,6 +40,30 @@ TEST(HpackEncoderTest, Basic) {
             "\x40\x05name3\x06value3", encoded_header_set2);
 }
 
+// Test that string literals are Huffman encoded when the encoder has
+// a table, and that the decoder reads them back.
+TEST(HpackEncoderTest, HuffmanEncoding) {
+  HpackEncoder encoder(kuint32max);
+  encoder.set_huffman_table(&ObtainHpackHuffmanTable());
+
+  std::map<string, string> header_set;
+  header_set["custom-key"] = "custom-value";
+
+  string encoded_header_set;
+  EXPECT_TRUE(encoder.EncodeHeaderSet(header_set, &encoded_header_set));
+  EXPECT_EQ("\x40"
+            "\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f"
+            "\x89\x25\xa8\x49\xe9\x5b\xb8\xe8\xb4\xbf",
+            encoded_header_set);
+
+  HpackDecoder decoder(kuint32max);
+  HpackHeaderPairVector header_list;
+  EXPECT_TRUE(decoder.DecodeHeaderSet(encoded_header_set, &header_list));
+  ASSERT_EQ(1u, header_list.size());
+  EXPECT_EQ("custom-key", header_list[0].first);
+  EXPECT_EQ("custom-value", header_list[0].second);
+}
+
 // Test that trying to encode a header set with a too-long header
 // field will fail.
 TEST(HpackEncoderTest, HeaderTooLarge) {
@@ -0,0 +1,215 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/hpack_huffman_table.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace net {
+
+using base::StringPiece;
+using std::string;
+
+namespace {
+
+// The number of octets, which all have symbols, not counting EOS.
+const size_t kNumOctetSymbols = 256;
+
+// Orders symbols by code length and then by id, which is the order of
+// their codes in a canonical Huffman code.
+struct SymbolLengthAndIdLessThan {
+  bool operator()(const HpackHuffmanSymbol& a,
+                  const HpackHuffmanSymbol& b) const {
+    if (a.length != b.length)
+      return a.length < b.length;
+    return a.id < b.id;
+  }
+};
+
+}  // namespace
+
+HpackHuffmanTable::HpackHuffmanTable() : eos_id_(0) {}
+
+HpackHuffmanTable::~HpackHuffmanTable() {}
+
+bool HpackHuffmanTable::Initialize(const HpackHuffmanSymbol* symbols,
+                                   size_t symbol_count) {
+  CHECK(!IsInitialized());
+  if (symbol_count != kNumOctetSymbols + 1)
+    return false;
+
+  std::vector<HpackHuffmanSymbol> sorted_symbols(symbols,
+                                                 symbols + symbol_count);
+  size_t count_by_length[kMaxCodeLength + 1] = { 0 };
+  for (size_t i = 0; i < symbol_count; ++i) {
+    const HpackHuffmanSymbol& symbol = symbols[i];
+    if (symbol.id != i || symbol.length == 0 ||
+        symbol.length > kMaxCodeLength ||
+        (symbol.length < 32 && (symbol.code >> symbol.length) != 0)) {
+      return false;
+    }
+    ++count_by_length[symbol.length];
+  }
+  std::sort(sorted_symbols.begin(), sorted_symbols.end(),
+            SymbolLengthAndIdLessThan());
+
+  // Assign the canonical codes of each length in turn.
+  uint64 next_code = 0;
+  size_t next_index = 0;
+  first_code_[0] = 0;
+  first_index_[0] = 0;
+  code_limit_[0] = 0;
+  for (size_t length = 1; length <= kMaxCodeLength; ++length) {
+    next_code <<= 1;
+    first_code_[length] = static_cast<uint32>(next_code);
+    first_index_[length] = next_index;
+    next_code += count_by_length[length];
+    next_index += count_by_length[length];
+    code_limit_[length] = next_code << (kMaxCodeLength - length);
+    if (next_code > (GG_UINT64_C(1) << length))
+      return false;
+  }
+  // Every window of bits must start with some code.
+  if (code_limit_[kMaxCodeLength] != GG_UINT64_C(1) << kMaxCodeLength)
+    return false;
+
+  ids_by_code_.resize(symbol_count);
+  for (size_t i = 0; i < symbol_count; ++i) {
+    const HpackHuffmanSymbol& symbol = sorted_symbols[i];
+    size_t index_in_length = i - first_index_[symbol.length];
+    if (symbol.code != first_code_[symbol.length] + index_in_length)
+      return false;
+    ids_by_code_[i] = symbol.id;
+  }
+
+  decode_table_.assign(1 << kDecodeTableBits, DecodeEntry());
+  for (size_t i = 0; i < symbol_count; ++i) {
+    const HpackHuffmanSymbol& symbol = symbols[i];
+    if (symbol.length > kDecodeTableBits)
+      continue;
+    // Short codes must be octets, which fit in a DecodeEntry.
+    if (symbol.id >= kNumOctetSymbols)
+      return false;
+    size_t unused_bits = kDecodeTableBits - symbol.length;
+    size_t first_entry = symbol.code << unused_bits;
+    for (size_t j = 0; j < (1u << unused_bits); ++j) {
+      decode_table_[first_entry + j].length = symbol.length;
+      decode_table_[first_entry + j].id = static_cast<uint8>(symbol.id);
+    }
+  }
+
+  codes_.resize(symbol_count);
+  code_lengths_.resize(symbol_count);
+  for (size_t i = 0; i < symbol_count; ++i) {
+    codes_[i] = symbols[i].code;
+    code_lengths_[i] = symbols[i].length;
+  }
+  eos_id_ = static_cast<uint16>(symbol_count - 1);
+  return true;
+}
+
+bool HpackHuffmanTable::IsInitialized() const {
+  return !codes_.empty();
+}
+
+void HpackHuffmanTable::EncodeString(StringPiece in, string* out) const {
+  DCHECK(IsInitialized());
+  out->reserve(out->size() + EncodedSize(in));
+
+  // The pending bits are the lower |bit_count| bits of |bits|. Codes are
+  // at most 32 bits long, so flushing whenever a full 32 bits are
+  // pending keeps them within the accumulator.
+  uint64 bits = 0;
+  size_t bit_count = 0;
+  for (size_t i = 0; i < in.size(); ++i) {
+    uint8 octet = static_cast<uint8>(in[i]);
+    bits = (bits << code_lengths_[octet]) | codes_[octet];
+    bit_count += code_lengths_[octet];
+    if (bit_count >= 32) {
+      char flushed[4];
+      bit_count -= 32;
+      uint32 word = static_cast<uint32>(bits >> bit_count);
+      flushed[0] = static_cast<char>(word >> 24);
+      flushed[1] = static_cast<char>(word >> 16);
+      flushed[2] = static_cast<char>(word >> 8);
+      flushed[3] = static_cast<char>(word);
+      out->append(flushed, arraysize(flushed));
+    }
+  }
+
+  // Pad to an octet boundary with the most significant bits of EOS,
+  // which are all ones.
+  size_t padding = (8 - bit_count % 8) % 8;
+  bits = (bits << padding) | ((1 << padding) - 1);
+  bit_count += padding;
+  while (bit_count > 0) {
+    bit_count -= 8;
+    out->push_back(static_cast<char>(bits >> bit_count));
+  }
+}
+
+size_t HpackHuffmanTable::EncodedSize(StringPiece in) const {
+  DCHECK(IsInitialized());
+  size_t bit_count = 0;
+  for (size_t i = 0; i < in.size(); ++i)
+    bit_count += code_lengths_[static_cast<uint8>(in[i])];
+  return (bit_count + 7) / 8;
+}
+
+bool HpackHuffmanTable::DecodeString(StringPiece in,
+                                     size_t out_capacity,
+                                     string* out) const {
+  DCHECK(IsInitialized());
+  out->clear();
+  out->reserve(std::min(out_capacity, in.size() * 8 / 5));
+
+  // The next |bit_count| bits of |in| are the most significant bits of
+  // |bits|, followed by zeroes.
+  uint64 bits = 0;
+  size_t bit_count = 0;
+  size_t next_octet = 0;
+  for (;;) {
+    // Refill so that at least kMaxCodeLength bits are pending, unless
+    // |in| runs out first.
+    while (bit_count <= 56 && next_octet < in.size()) {
+      bits |= static_cast<uint64>(static_cast<uint8>(in[next_octet++])) <<
+          (56 - bit_count);
+      bit_count += 8;
+    }
+    if (bit_count == 0)
+      return true;
+
+    uint32 window = static_cast<uint32>(bits >> 32);
+    size_t length;
+    uint16 id;
+    const DecodeEntry& entry =
+        decode_table_[window >> (kMaxCodeLength - kDecodeTableBits)];
+    if (entry.length != 0) {
+      length = entry.length;
+      id = entry.id;
+    } else {
+      length = kDecodeTableBits + 1;
+      while (window >= code_limit_[length])
+        ++length;
+      uint32 code = window >> (kMaxCodeLength - length);
+      id = ids_by_code_[first_index_[length] + code - first_code_[length]];
+    }
+
+    if (length > bit_count) {
+      // Only padding may remain: fewer than eight bits of EOS, which
+      // are all ones.
+      return bit_count < 8 && (window >> (kMaxCodeLength - bit_count)) ==
+          (1u << bit_count) - 1;
+    }
+    if (id == eos_id_ || out->size() == out_capacity)
+      return false;
+    out->push_back(static_cast<char>(id));
+    bits <<= length;
+    bit_count -= length;
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,96 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_HPACK_HUFFMAN_TABLE_H_
+#define NET_SPDY_HPACK_HUFFMAN_TABLE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "net/base/net_export.h"
+#include "net/spdy/hpack_constants.h"  // For HpackHuffmanSymbol.
+
+namespace net {
+
+// An HpackHuffmanTable encodes and decodes string literals with a
+// canonical Huffman code, such as the one returned by
+// HpackHuffmanCode().
+//
+// Rather than walking the code one bit at a time, the decoder looks up
+// the next kDecodeTableBits bits in a table, which resolves every code
+// at most that long in one step. Longer codes are resolved by
+// comparing the next 32 bits against the first code of each length,
+// which canonical codes allow. The encoder packs codes into a 64-bit
+// accumulator and writes out whole octets.
+class NET_EXPORT_PRIVATE HpackHuffmanTable {
+ public:
+  // The number of bits resolved by a single lookup in |decode_table_|.
+  static const size_t kDecodeTableBits = 8;
+
+  HpackHuffmanTable();
+  ~HpackHuffmanTable();
+
+  // Prepares the table for the code given by |symbols|, which must
+  // hold |symbol_count| symbols ordered by id. The octets have ids 0
+  // to 255 and the last symbol is EOS. Returns false if the code is not
+  // a complete canonical Huffman code, in which case the table must not
+  // be used.
+  bool Initialize(const HpackHuffmanSymbol* symbols, size_t symbol_count);
+
+  // Returns whether Initialize() has succeeded.
+  bool IsInitialized() const;
+
+  // Appends the encoding of |in| to |out|, padded to an octet boundary
+  // with the most significant bits of EOS.
+  void EncodeString(base::StringPiece in, std::string* out) const;
+
+  // Returns the number of octets EncodeString() would append for |in|.
+  size_t EncodedSize(base::StringPiece in) const;
+
+  // Decodes |in| into |out|, which is cleared first. Returns false if
+  // |in| decodes to more than |out_capacity| octets, contains EOS, or
+  // is not padded with at most seven bits of EOS.
+  bool DecodeString(base::StringPiece in,
+                    size_t out_capacity,
+                    std::string* out) const;
+
+ private:
+  // The longest code this table can hold, which is the width of the
+  // window compared against the first codes of each length.
+  static const size_t kMaxCodeLength = 32;
+
+  // An entry of |decode_table_|. |length| is zero if the code starting
+  // with the entry's index is longer than kDecodeTableBits.
+  struct DecodeEntry {
+    uint8 length;
+    uint8 id;
+  };
+
+  // Encoding is indexed by symbol id.
+  std::vector<uint32> codes_;
+  std::vector<uint8> code_lengths_;
+
+  std::vector<DecodeEntry> decode_table_;
+
+  // Symbol ids ordered by code, with the codes of each length starting
+  // at |first_index_[length]|.
+  std::vector<uint16> ids_by_code_;
+  uint32 first_code_[kMaxCodeLength + 1];
+  size_t first_index_[kMaxCodeLength + 1];
+  // One more than the last code of each length, shifted to the top of
+  // a 32-bit window. A window is below |code_limit_[length]| exactly
+  // when the code it starts with is at most |length| bits long.
+  uint64 code_limit_[kMaxCodeLength + 1];
+
+  uint16 eos_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(HpackHuffmanTable);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_HPACK_HUFFMAN_TABLE_H_
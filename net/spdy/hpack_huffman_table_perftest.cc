@@ -0,0 +1,141 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/test/perf_time_logger.h"
+#include "net/spdy/hpack_constants.h"
+#include "net/spdy/hpack_decoder.h"
+#include "net/spdy/hpack_encoder.h"
+#include "net/spdy/hpack_huffman_table.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+using std::string;
+
+const int kNumIterations = 2000;
+
+// Headers of a typical page load: the request and response of the page
+// itself, and of a script and an image it loads.
+const char* const kHeaderCorpus[][2] = {
+  { ":method", "GET" },
+  { ":scheme", "https" },
+  { ":authority", "www.example.com" },
+  { ":path", "/search?q=hpack+huffman&ie=UTF-8&oe=UTF-8&client=chrome" },
+  { "user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                  "(KHTML, like Gecko) Chrome/34.0.1847.116 Safari/537.36" },
+  { "accept", "text/html,application/xhtml+xml,application/xml;q=0.9,"
+              "image/webp,*/*;q=0.8" },
+  { "accept-encoding", "gzip,deflate,sdch" },
+  { "accept-language", "en-US,en;q=0.8" },
+  { "cookie", "PREF=ID=1a2b3c4d5e6f7a8b:U=0123456789abcdef:FF=0:TM=1396000000"
+              ":LM=1396000001:S=AbCdEfGhIjKlMnOp; NID=67=aBcDeFgHiJkLmNoPqRs"
+              "TuVwXyZ0123456789-_aBcDeFgHiJkLmNoPqRsTuVwXyZ" },
+  { "referer", "https://www.example.com/" },
+  { ":status", "200" },
+  { "date", "Mon, 21 Apr 2014 20:13:21 GMT" },
+  { "expires", "-1" },
+  { "cache-control", "private, max-age=0" },
+  { "content-type", "text/html; charset=UTF-8" },
+  { "set-cookie", "NID=67=ZyXwVuTsRqPoNmLkJiHgFeDcBa9876543210; "
+                  "expires=Tue, 21-Oct-2014 20:13:21 GMT; path=/; "
+                  "domain=.example.com; HttpOnly" },
+  { "content-encoding", "gzip" },
+  { "server", "gws" },
+  { "x-xss-protection", "1; mode=block" },
+  { "x-frame-options", "SAMEORIGIN" },
+  { "alternate-protocol", "443:quic" },
+  { ":path", "/xjs/_/js/k=xjs.s.en_US.abcdefGhIjk.O/m=c,sb_sri,cr,jp,hv,"
+             "lc,vm,tbui,mb,wobnm,cfm,abd,bihu,kp,lu,m,tnv,amcl/am=AAAA/"
+             "rt=j/d=1/sv=1/rs=AItRSTN0aBcDeFgHiJkLmNoPqRsTuVwXy" },
+  { "accept", "*/*" },
+  { "content-type", "text/javascript; charset=UTF-8" },
+  { "last-modified", "Thu, 17 Apr 2014 01:23:45 GMT" },
+  { "etag", "\"1a2b3c4d5e6f\"" },
+  { ":path", "/images/srpr/logo11w.png" },
+  { "accept", "image/webp,*/*;q=0.8" },
+  { "content-type", "image/png" },
+  { "content-length", "14022" },
+};
+
+// Encodes and decodes every header of the corpus, as names and values.
+TEST(HpackHuffmanTablePerfTest, EncodeAndDecodeStrings) {
+  const HpackHuffmanTable& table = ObtainHpackHuffmanTable();
+  std::vector<string> encoded_strings;
+  size_t total_size = 0;
+  for (size_t i = 0; i < arraysize(kHeaderCorpus); ++i) {
+    for (size_t j = 0; j < 2; ++j) {
+      string encoded;
+      table.EncodeString(kHeaderCorpus[i][j], &encoded);
+      encoded_strings.push_back(encoded);
+      total_size += strlen(kHeaderCorpus[i][j]);
+    }
+  }
+
+  string encoded;
+  base::PerfTimeLogger encode_timer("HPACK Huffman encoding");
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    for (size_t i = 0; i < arraysize(kHeaderCorpus); ++i) {
+      for (size_t j = 0; j < 2; ++j) {
+        encoded.clear();
+        table.EncodeString(kHeaderCorpus[i][j], &encoded);
+      }
+    }
+  }
+  encode_timer.Done();
+
+  string decoded;
+  size_t decoded_size = 0;
+  base::PerfTimeLogger decode_timer("HPACK Huffman decoding");
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    decoded_size = 0;
+    for (size_t i = 0; i < encoded_strings.size(); ++i) {
+      EXPECT_TRUE(table.DecodeString(encoded_strings[i], kuint32max,
+                                     &decoded));
+      decoded_size += decoded.size();
+    }
+  }
+  decode_timer.Done();
+
+  EXPECT_EQ(total_size, decoded_size);
+}
+
+// Encodes and decodes the corpus as header sets, as a connection would.
+TEST(HpackHuffmanTablePerfTest, EncodeAndDecodeHeaderSets) {
+  std::map<string, string> header_set;
+  for (size_t i = 0; i < arraysize(kHeaderCorpus); ++i)
+    header_set[kHeaderCorpus[i][0]] = kHeaderCorpus[i][1];
+
+  HpackEncoder encoder(kuint32max);
+  encoder.set_huffman_table(&ObtainHpackHuffmanTable());
+  string encoded_header_set;
+  base::PerfTimeLogger encode_timer("HPACK header set encoding");
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    encoded_header_set.clear();
+    EXPECT_TRUE(encoder.EncodeHeaderSet(header_set, &encoded_header_set));
+  }
+  encode_timer.Done();
+
+  HpackDecoder decoder(kuint32max);
+  HpackHeaderPairVector header_list;
+  base::PerfTimeLogger decode_timer("HPACK header set decoding");
+  for (int iteration = 0; iteration < kNumIterations; ++iteration) {
+    header_list.clear();
+    EXPECT_TRUE(decoder.DecodeHeaderSet(encoded_header_set, &header_list));
+  }
+  decode_timer.Done();
+
+  EXPECT_EQ(header_set.size(), header_list.size());
+}
+
+}  // namespace
+
+}  // namespace net
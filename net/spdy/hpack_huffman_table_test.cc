@@ -0,0 +1,165 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/hpack_huffman_table.h"
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "net/spdy/hpack_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+using base::StringPiece;
+using std::string;
+
+string HexToBytes(const string& hex) {
+  std::vector<uint8> bytes;
+  EXPECT_TRUE(base::HexStringToBytes(hex, &bytes));
+  return string(bytes.begin(), bytes.end());
+}
+
+string Encode(StringPiece str) {
+  string encoded;
+  ObtainHpackHuffmanTable().EncodeString(str, &encoded);
+  EXPECT_EQ(encoded.size(), ObtainHpackHuffmanTable().EncodedSize(str));
+  return encoded;
+}
+
+bool Decode(StringPiece encoded, string* decoded) {
+  return ObtainHpackHuffmanTable().DecodeString(
+      encoded, kuint32max, decoded);
+}
+
+// The HPACK code should be accepted.
+TEST(HpackHuffmanTableTest, InitializeHpackCode) {
+  std::vector<HpackHuffmanSymbol> code = HpackHuffmanCode();
+  HpackHuffmanTable table;
+  EXPECT_FALSE(table.IsInitialized());
+  EXPECT_TRUE(table.Initialize(&code[0], code.size()));
+  EXPECT_TRUE(table.IsInitialized());
+}
+
+// Codes which are out of canonical order should be rejected.
+TEST(HpackHuffmanTableTest, InitializeNonCanonicalCode) {
+  std::vector<HpackHuffmanSymbol> code = HpackHuffmanCode();
+  // '0' and '1' are consecutive 5 bit codes.
+  std::swap(code['0'].code, code['1'].code);
+  HpackHuffmanTable table;
+  EXPECT_FALSE(table.Initialize(&code[0], code.size()));
+}
+
+// Codes which leave some bit sequences undecodable should be rejected.
+TEST(HpackHuffmanTableTest, InitializeIncompleteCode) {
+  std::vector<HpackHuffmanSymbol> code = HpackHuffmanCode();
+  // Lengthening the last code leaves a gap after it.
+  code.back().code <<= 1;
+  code.back().length += 1;
+  HpackHuffmanTable table;
+  EXPECT_FALSE(table.Initialize(&code[0], code.size()));
+}
+
+// Codes without one symbol for each octet and EOS should be rejected.
+TEST(HpackHuffmanTableTest, InitializeWrongSymbolCount) {
+  std::vector<HpackHuffmanSymbol> code = HpackHuffmanCode();
+  HpackHuffmanTable table;
+  EXPECT_FALSE(table.Initialize(&code[0], code.size() - 1));
+}
+
+// Test the request examples of Appendix C.4 of RFC 7541.
+TEST(HpackHuffmanTableTest, SpecRequestExamples) {
+  const char* kExamples[][2] = {
+    { "www.example.com", "f1e3c2e5f23a6ba0ab90f4ff" },
+    { "no-cache", "a8eb10649cbf" },
+    { "custom-key", "25a849e95ba97d7f" },
+    { "custom-value", "25a849e95bb8e8b4bf" },
+  };
+  for (size_t i = 0; i < arraysize(kExamples); ++i) {
+    string encoded = HexToBytes(kExamples[i][1]);
+    EXPECT_EQ(encoded, Encode(kExamples[i][0]));
+    string decoded;
+    EXPECT_TRUE(Decode(encoded, &decoded));
+    EXPECT_EQ(kExamples[i][0], decoded);
+  }
+}
+
+// Test the response examples of Appendix C.6 of RFC 7541, which use
+// some of the longer codes.
+TEST(HpackHuffmanTableTest, SpecResponseExamples) {
+  const char* kExamples[][2] = {
+    { "302", "6402" },
+    { "private", "aec3771a4b" },
+    { "Mon, 21 Oct 2013 20:13:21 GMT",
+      "d07abe941054d444a8200595040b8166e082a62d1bff" },
+    { "https://www.example.com", "9d29ad171863c78f0b97c8e9ae82ae43d3" },
+    { "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+      "94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587"
+      "316065c003ed4ee5b1063d5007" },
+  };
+  for (size_t i = 0; i < arraysize(kExamples); ++i) {
+    string encoded = HexToBytes(kExamples[i][1]);
+    EXPECT_EQ(encoded, Encode(kExamples[i][0]));
+    string decoded;
+    EXPECT_TRUE(Decode(encoded, &decoded));
+    EXPECT_EQ(kExamples[i][0], decoded);
+  }
+}
+
+// Every octet, including those with the longest codes, should survive
+// a round trip, both alone and in one long string.
+TEST(HpackHuffmanTableTest, RoundTripAllOctets) {
+  string all_octets;
+  for (int i = 0; i < 256; ++i) {
+    string octet(1, static_cast<char>(i));
+    string decoded;
+    EXPECT_TRUE(Decode(Encode(octet), &decoded));
+    EXPECT_EQ(octet, decoded);
+    all_octets.append(octet);
+  }
+  string decoded;
+  EXPECT_TRUE(Decode(Encode(all_octets), &decoded));
+  EXPECT_EQ(all_octets, decoded);
+}
+
+TEST(HpackHuffmanTableTest, EmptyString) {
+  EXPECT_EQ("", Encode(""));
+  string decoded("stale");
+  EXPECT_TRUE(Decode("", &decoded));
+  EXPECT_EQ("", decoded);
+}
+
+// Padding must be at most seven bits of EOS.
+TEST(HpackHuffmanTableTest, DecodeInvalidPadding) {
+  string decoded;
+  // "302" followed by a full octet of padding.
+  EXPECT_FALSE(Decode(HexToBytes("6402ff"), &decoded));
+  // "a" padded with ones, and then with zeroes.
+  EXPECT_TRUE(Decode(HexToBytes("1f"), &decoded));
+  EXPECT_EQ("a", decoded);
+  EXPECT_FALSE(Decode(HexToBytes("18"), &decoded));
+}
+
+// EOS must not appear in the encoded string.
+TEST(HpackHuffmanTableTest, DecodeEos) {
+  string decoded;
+  EXPECT_FALSE(Decode(HexToBytes("fffffffc"), &decoded));
+}
+
+// Decoding should fail rather than grow the output past its capacity.
+TEST(HpackHuffmanTableTest, DecodeCapacity) {
+  string encoded = Encode("custom-value");
+  string decoded;
+  EXPECT_TRUE(ObtainHpackHuffmanTable().DecodeString(encoded, 12, &decoded));
+  EXPECT_FALSE(ObtainHpackHuffmanTable().DecodeString(encoded, 11, &decoded));
+}
+
+}  // namespace
+
+}  // namespace net
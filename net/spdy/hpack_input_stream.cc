@@ -90,8 +90,6 @@ bool HpackInputStream::DecodeNextUint32(uint32* I) {
   return !has_more;
 }
 
-// TODO(akalin): Figure out how to handle the storage for
-// Huffman-encoded sequences.
 bool HpackInputStream::DecodeNextStringLiteral(StringPiece* str) {
   if (MatchPrefixAndConsume(kStringLiteralIdentityEncoded)) {
     uint32 size = 0;
@@ -109,9 +107,24 @@ bool HpackInputStream::DecodeNextStringLiteral(StringPiece* str) {
     return true;
   }
 
-  // TODO(akalin): Handle Huffman-encoded sequences.
+  // Huffman-encoded sequences need storage, so they are decoded by
+  // DecodeNextHuffmanString() instead.
 
   return false;
 }
 
+bool HpackInputStream::DecodeNextHuffmanString(const HpackHuffmanTable& table,
+                                               std::string* str) {
+  uint32 encoded_size = 0;
+  if (!DecodeNextUint32(&encoded_size))
+    return false;
+
+  if (encoded_size > buffer_.size())
+    return false;
+
+  StringPiece encoded(buffer_.data(), encoded_size);
+  buffer_.remove_prefix(encoded_size);
+  return table.DecodeString(encoded, max_string_literal_size_, str);
+}
+
 }  // namespace net
@@ -13,6 +13,7 @@
 #include "base/strings/string_piece.h"
 #include "net/base/net_export.h"
 #include "net/spdy/hpack_constants.h"  // For HpackPrefix.
+#include "net/spdy/hpack_huffman_table.h"
 
 // All section references below are to
 // http://tools.ietf.org/html/draft-ietf-httpbis-header-compression-05
@@ -48,6 +49,11 @@ class NET_EXPORT_PRIVATE HpackInputStream {
   bool DecodeNextUint32(uint32* I);
   bool DecodeNextStringLiteral(base::StringPiece* str);
 
+  // Decodes a string literal whose Huffman encoded prefix has already
+  // been consumed into |str|.
+  bool DecodeNextHuffmanString(const HpackHuffmanTable& table,
+                               std::string* str);
+
   // Accessors for testing.
 
   void SetBitOffsetForTest(size_t bit_offset) {
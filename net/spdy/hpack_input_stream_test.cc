@@ -485,6 +485,46 @@ TEST(HpackInputStreamTest, DecodeNextStringLiteralInvalidSize) {
   EXPECT_FALSE(input_stream.DecodeNextStringLiteralForTest(&string_piece));
 }
 
+// Decoding a valid Huffman encoded string literal should work, once
+// its prefix has been matched.
+TEST(HpackInputStreamTest, DecodeNextHuffmanString) {
+  HpackInputStream input_stream(kuint32max,
+                                "\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f");
+
+  EXPECT_TRUE(input_stream.MatchPrefixAndConsume(
+      kStringLiteralHuffmanEncoded));
+  string str;
+  EXPECT_TRUE(input_stream.DecodeNextHuffmanString(ObtainHpackHuffmanTable(),
+                                                   &str));
+  EXPECT_EQ("custom-key", str);
+  EXPECT_FALSE(input_stream.HasMoreData());
+}
+
+// Decoding a Huffman encoded string literal which decodes to more than
+// |max_string_literal_size_| octets should fail.
+TEST(HpackInputStreamTest, DecodeNextHuffmanStringSizeLimit) {
+  HpackInputStream input_stream(9, "\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f");
+
+  EXPECT_TRUE(input_stream.MatchPrefixAndConsume(
+      kStringLiteralHuffmanEncoded));
+  string str;
+  EXPECT_FALSE(input_stream.DecodeNextHuffmanString(ObtainHpackHuffmanTable(),
+                                                    &str));
+}
+
+// Decoding a Huffman encoded string literal with size larger than the
+// remainder of the buffer should fail.
+TEST(HpackInputStreamTest, DecodeNextHuffmanStringInvalidSize) {
+  HpackInputStream input_stream(kuint32max,
+                                "\x89\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f");
+
+  EXPECT_TRUE(input_stream.MatchPrefixAndConsume(
+      kStringLiteralHuffmanEncoded));
+  string str;
+  EXPECT_FALSE(input_stream.DecodeNextHuffmanString(ObtainHpackHuffmanTable(),
+                                                    &str));
+}
+
 }  // namespace
 
 }  // namespace net
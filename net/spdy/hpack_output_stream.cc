@@ -14,6 +14,7 @@ using std::string;
 
 HpackOutputStream::HpackOutputStream(uint32 max_string_literal_size)
     : max_string_literal_size_(max_string_literal_size),
+      huffman_table_(NULL),
       bit_offset_(0) {}
 
 HpackOutputStream::~HpackOutputStream() {}
@@ -88,10 +89,18 @@ void HpackOutputStream::AppendUint32(uint32 I) {
 
 bool HpackOutputStream::AppendStringLiteral(base::StringPiece str) {
   DCHECK_EQ(bit_offset_, 0u);
-  // TODO(akalin): Implement Huffman encoding.
-  AppendPrefix(kStringLiteralIdentityEncoded);
   if (str.size() > max_string_literal_size_)
     return false;
+  if (huffman_table_) {
+    size_t encoded_size = huffman_table_->EncodedSize(str);
+    if (encoded_size < str.size()) {
+      AppendPrefix(kStringLiteralHuffmanEncoded);
+      AppendUint32(static_cast<uint32>(encoded_size));
+      huffman_table_->EncodeString(str, &buffer_);
+      return true;
+    }
+  }
+  AppendPrefix(kStringLiteralIdentityEncoded);
   AppendUint32(static_cast<uint32>(str.size()));
   buffer_.append(str.data(), str.size());
   return true;
@@ -14,6 +14,7 @@
 #include "net/base/net_export.h"
 #include "net/spdy/hpack_constants.h"  // For HpackPrefix.
 #include "net/spdy/hpack_encoding_context.h"
+#include "net/spdy/hpack_huffman_table.h"
 
 // All section references below are to
 // http://tools.ietf.org/html/draft-ietf-httpbis-header-compression-05
@@ -30,6 +31,13 @@ class NET_EXPORT_PRIVATE HpackOutputStream {
   explicit HpackOutputStream(uint32 max_string_literal_size);
   ~HpackOutputStream();
 
+  // If |huffman_table| is non-NULL, string literals are Huffman
+  // encoded with it whenever that makes them shorter. It must outlive
+  // this object.
+  void set_huffman_table(const HpackHuffmanTable* huffman_table) {
+    huffman_table_ = huffman_table;
+  }
+
   // Corresponds to 4.2.
   void AppendIndexedHeader(uint32 index_or_zero);
 
@@ -86,6 +94,8 @@ class NET_EXPORT_PRIVATE HpackOutputStream {
 
   const uint32 max_string_literal_size_;
 
+  const HpackHuffmanTable* huffman_table_;
+
   // The internal bit buffer.
   std::string buffer_;
 
@@ -258,6 +258,21 @@ TEST(HpackOutputStreamTest, AppendStringLiteralNoHuffmanEncoding) {
   EXPECT_EQ(string("\x7f\x00", 2) + literal, str);
 }
 
+// Test that a string literal is Huffman encoded when given a table
+// and the encoding is shorter, and stored unmodified otherwise.
+TEST(HpackOutputStreamTest, AppendStringLiteralHuffmanEncoding) {
+  HpackOutputStream output_stream(kuint32max);
+  output_stream.set_huffman_table(&ObtainHpackHuffmanTable());
+
+  EXPECT_TRUE(output_stream.AppendStringLiteralForTest("custom-key"));
+  // Octets with long codes are not worth encoding.
+  EXPECT_TRUE(output_stream.AppendStringLiteralForTest("\xff"));
+
+  string str;
+  output_stream.TakeString(&str);
+  EXPECT_EQ("\x88\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f" "\x01\xff", str);
+}
+
 // Test that trying to encode a too-long string literal will fail.
 TEST(HpackOutputStreamTest, AppendStringLiteralTooLong) {
   HpackOutputStream output_stream(kuint32max - 1);
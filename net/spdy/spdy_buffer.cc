@@ -29,6 +29,31 @@ scoped_ptr<SpdyFrame> MakeSpdyFrame(const char* data, size_t size) {
 
 }  // namespace
 
+class SpdyBuffer::SharedFrame
+    : public base::RefCountedThreadSafe<SharedFrame> {
+ public:
+  explicit SharedFrame(scoped_ptr<SpdyFrame> frame) : frame_(frame.Pass()) {}
+
+  SharedFrame(const scoped_refptr<IOBuffer>& backing_buffer,
+              scoped_ptr<SpdyFrame> frame)
+      : frame_(frame.Pass()),
+        backing_buffer_(backing_buffer) {}
+
+  const SpdyFrame& frame() const { return *frame_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedFrame>;
+
+  ~SharedFrame() {}
+
+  const scoped_ptr<SpdyFrame> frame_;
+  // The buffer that |frame_| points into, if |frame_| does not own its
+  // data.
+  const scoped_refptr<IOBuffer> backing_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedFrame);
+};
+
 // This class is an IOBuffer implementation that simply holds a
 // reference to a SharedFrame object and a fixed offset. Used by
 // SpdyBuffer::GetIOBufferForRemainingData().
@@ -36,7 +61,7 @@ class SpdyBuffer::SharedFrameIOBuffer : public IOBuffer {
  public:
   SharedFrameIOBuffer(const scoped_refptr<SharedFrame>& shared_frame,
                       size_t offset)
-      : IOBuffer(shared_frame->data->data() + offset),
+      : IOBuffer(shared_frame->frame().data() + offset),
         shared_frame_(shared_frame),
         offset_(offset) {}
 
@@ -53,17 +78,26 @@ class SpdyBuffer::SharedFrameIOBuffer : public IOBuffer {
 };
 
 SpdyBuffer::SpdyBuffer(scoped_ptr<SpdyFrame> frame)
-    : shared_frame_(new SharedFrame()),
-      offset_(0) {
-  shared_frame_->data = frame.Pass();
-}
+    : shared_frame_(new SharedFrame(frame.Pass())),
+      offset_(0) {}
 
 // The given data may not be strictly a SPDY frame; we (ab)use
 // |frame_| just as a container.
 SpdyBuffer::SpdyBuffer(const char* data, size_t size) :
-    shared_frame_(new SharedFrame()),
-    offset_(0) {
-  shared_frame_->data = MakeSpdyFrame(data, size);
+    shared_frame_(new SharedFrame(MakeSpdyFrame(data, size))),
+    offset_(0) {}
+
+SpdyBuffer::SpdyBuffer(const scoped_refptr<IOBuffer>& backing_buffer,
+                       const char* data,
+                       size_t size)
+    : shared_frame_(new SharedFrame(
+          backing_buffer,
+          scoped_ptr<SpdyFrame>(new SpdyFrame(const_cast<char*>(data), size,
+                                              false /* owns_buffer */)))),
+      offset_(0) {
+  DCHECK(backing_buffer.get());
+  DCHECK_GT(size, 0u);
+  DCHECK_GE(data, backing_buffer->data());
 }
 
 SpdyBuffer::~SpdyBuffer() {
@@ -72,11 +106,11 @@ SpdyBuffer::~SpdyBuffer() {
 }
 
 const char* SpdyBuffer::GetRemainingData() const {
-  return shared_frame_->data->data() + offset_;
+  return shared_frame_->frame().data() + offset_;
 }
 
 size_t SpdyBuffer::GetRemainingSize() const {
-  return shared_frame_->data->size() - offset_;
+  return shared_frame_->frame().size() - offset_;
 }
 
 void SpdyBuffer::AddConsumeCallback(const ConsumeCallback& consume_callback) {
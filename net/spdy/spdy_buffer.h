@@ -53,6 +53,16 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   // non-NULL and |size| must be non-zero.
   SpdyBuffer(const char* data, size_t size);
 
+  // Construct without a copy, as a view of |size| bytes at |data|,
+  // which must lie within |backing_buffer|. |backing_buffer| is
+  // referenced until this object and any IOBuffer returned by
+  // GetIOBufferForRemainingData() are destroyed, so it must not be
+  // written to while it is referenced by anything else. |size| must be
+  // non-zero.
+  SpdyBuffer(const scoped_refptr<IOBuffer>& backing_buffer,
+             const char* data,
+             size_t size);
+
   // If there are bytes remaining in the buffer, triggers a call to
   // any consume callbacks with a DISCARD source.
   ~SpdyBuffer();
@@ -86,9 +96,9 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
  private:
   void ConsumeHelper(size_t consume_size, ConsumeSource consume_source);
 
-  // Ref-count the passed-in SpdyFrame to support the semantics of
-  // |GetIOBufferForRemainingData()|.
-  typedef base::RefCountedData<scoped_ptr<SpdyFrame> > SharedFrame;
+  // Ref-count the passed-in SpdyFrame, along with any buffer it points
+  // into, to support the semantics of |GetIOBufferForRemainingData()|.
+  class SharedFrame;
 
   class SharedFrameIOBuffer;
 
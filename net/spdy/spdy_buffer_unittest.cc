@@ -55,6 +55,30 @@ TEST_F(SpdyBufferTest, DataConstructor) {
   EXPECT_EQ(std::string(kData, kDataSize), BufferToString(buffer));
 }
 
+// Construct a SpdyBuffer as a view into an IOBuffer and make sure it
+// points into the IOBuffer without a copy, and keeps it alive.
+TEST_F(SpdyBufferTest, BackingBufferConstructor) {
+  scoped_refptr<IOBuffer> backing_buffer(new IOBuffer(kDataSize + 2));
+  std::memcpy(backing_buffer->data() + 2, kData, kDataSize);
+  scoped_ptr<SpdyBuffer> buffer(
+      new SpdyBuffer(backing_buffer, backing_buffer->data() + 2, kDataSize));
+
+  EXPECT_EQ(backing_buffer->data() + 2, buffer->GetRemainingData());
+  EXPECT_EQ(kDataSize, buffer->GetRemainingSize());
+  EXPECT_FALSE(backing_buffer->HasOneRef());
+
+  // The IOBuffer for the remaining data keeps |backing_buffer| alive
+  // after |buffer| is gone.
+  scoped_refptr<IOBuffer> io_buffer = buffer->GetIOBufferForRemainingData();
+  buffer.reset();
+  EXPECT_FALSE(backing_buffer->HasOneRef());
+  EXPECT_EQ(std::string(kData, kDataSize),
+            std::string(io_buffer->data(), kDataSize));
+
+  io_buffer = NULL;
+  EXPECT_TRUE(backing_buffer->HasOneRef());
+}
+
 void IncrementBy(size_t* x,
                  SpdyBuffer::ConsumeSource expected_consume_source,
                  size_t delta,
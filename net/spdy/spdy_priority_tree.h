@@ -0,0 +1,549 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_SPDY_PRIORITY_TREE_H_
+#define NET_SPDY_SPDY_PRIORITY_TREE_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/logging.h"
+
+namespace net {
+
+// This data structure implements the HTTP/2 stream dependency tree: every
+// node depends on exactly one parent, which is either another node or the
+// implicit root NodeId(), and carries a weight between kMinWeight and
+// kMaxWeight.  Nodes can be added, removed and reprioritized following the
+// rules of the HTTP/2 draft, including exclusive dependencies.
+//
+// Individual nodes can be marked as ready to write, and the tree can then be
+// queried for the next node to write.  A ready node always goes before its
+// descendants.  Siblings share bandwidth in proportion to their weights, as
+// measured by the bytes reported to RecordBytesWritten(); siblings which have
+// been charged the same amount are picked in the order they became ready.
+//
+// The NodeId type must be POD that supports comparison and hashing (most
+// likely, it will be a number), and NodeId() must never name a real node.
+template <typename NodeId>
+class SpdyPriorityTree {
+ public:
+  static const int kMinWeight = 1;
+  static const int kMaxWeight = 256;
+  static const int kDefaultWeight = 16;
+
+  SpdyPriorityTree();
+  ~SpdyPriorityTree();
+
+  // Return the number of nodes currently in the tree, not counting the root.
+  int num_nodes() const;
+
+  // Return the number of nodes currently marked as ready to write.
+  int num_ready_nodes() const;
+
+  // Return true if the tree contains a node with the given ID.
+  bool NodeExists(NodeId node_id) const;
+
+  // Add a new node depending on |parent_id|, which may be NodeId() for the
+  // root.  If |exclusive| is true, the new node becomes the sole child of the
+  // parent and adopts its former children.  Returns true on success.  Returns
+  // false and has no effect if the node already exists, if the parent doesn't
+  // exist, or if |weight| is out of range.
+  bool AddNode(NodeId node_id, NodeId parent_id, int weight, bool exclusive);
+
+  // Remove an existing node from the tree.  Its children move to its parent,
+  // sharing its weight in proportion to their own.  Returns true on success,
+  // or false if the node doesn't exist.
+  bool RemoveNode(NodeId node_id);
+
+  // Remove every node from the tree.
+  void Clear();
+
+  // Get the weight of the given node, or 0 if it doesn't exist.
+  int GetWeight(NodeId node_id) const;
+
+  // Get the parent of the given node.  If the node doesn't exist, or depends
+  // on the root, returns NodeId().
+  NodeId GetParent(NodeId node_id) const;
+
+  // Return true if |child_id| depends directly on |parent_id|.
+  bool HasChild(NodeId parent_id, NodeId child_id) const;
+
+  // Set the weight of the given node.  Returns true on success, or false if
+  // the node doesn't exist or |weight| is out of range.
+  bool SetWeight(NodeId node_id, int weight);
+
+  // Make the given node depend on |parent_id|, which may be NodeId() for the
+  // root.  If the new parent is a descendant of the node, the parent is first
+  // moved to depend on the node's former parent.  If |exclusive| is true, the
+  // node also adopts the other children of its new parent.  Returns true on
+  // success.  Returns false and has no effect if either node doesn't exist, or
+  // if they are the same node.
+  bool SetParent(NodeId node_id, NodeId parent_id, bool exclusive);
+
+  // Check if a node is marked as ready to write.  Returns false if the node
+  // doesn't exist.
+  bool IsMarkedReadyToWrite(NodeId node_id) const;
+  // Mark the node as ready or not ready to write.  Returns true on success, or
+  // false if the node doesn't exist.
+  bool MarkReadyToWrite(NodeId node_id);
+  bool MarkNoLongerReadyToWrite(NodeId node_id);
+  // Return the ID of the next node that we should write, or return NodeId() if
+  // no node in the tree is ready to write.
+  NodeId NextNodeToWrite() const;
+
+  // Charge |bytes| written on behalf of the given node against it and each of
+  // its ancestors, which pushes them back relative to their siblings.  Returns
+  // true on success, or false if the node doesn't exist.
+  bool RecordBytesWritten(NodeId node_id, size_t bytes);
+
+  // Return true if all internal invariants hold (useful for unit tests).
+  // Unless there are bugs, this should always return true.
+  bool ValidateInvariantsForTests() const;
+
+ private:
+  struct Node {
+    Node()
+        : parent_id(),
+          weight(kDefaultWeight),
+          ready(false),
+          num_ready_descendants(0),
+          pass(0),
+          virtual_time(0),
+          ready_sequence(0) {}
+    NodeId parent_id;
+    int weight;
+    std::vector<NodeId> children;
+    bool ready;
+    // The number of ready nodes in this node's subtree, not counting itself.
+    int num_ready_descendants;
+    // Where this node stands relative to its siblings, in units of bytes
+    // written scaled by kMaxWeight / weight.  The lowest goes first.
+    uint64 pass;
+    // The pass of the child most recently charged for a write.  Children
+    // which become ready start no earlier than this, so they can't claim
+    // bandwidth for the time they were idle.
+    uint64 virtual_time;
+    // Breaks ties between siblings with the same pass.
+    uint64 ready_sequence;
+  };
+
+  typedef base::hash_map<NodeId, Node> NodeMap;
+
+  // Return true if the node or any of its descendants is ready to write.
+  static bool IsActive(const Node& node);
+  // Bring a node which has just become active up to its parent's virtual
+  // time.
+  void Activate(Node* node);
+  // Add |delta| ready nodes to the subtrees of |node_id| and its ancestors,
+  // starting with |node_id|, activating those which become active.
+  void AddReadyDescendants(NodeId node_id, int delta);
+  // Unlink the given node, and its subtree, from its parent.
+  void Detach(NodeId node_id);
+  // Link the given detached node, and its subtree, to the end of the children
+  // of |parent_id|.
+  void Attach(NodeId node_id, NodeId parent_id);
+  // Move the given child of |new_parent_id|'s parent to |new_parent_id|.
+  void MoveToSibling(NodeId node_id, NodeId new_parent_id);
+  // Get the given node, or return NULL if it doesn't exist.
+  const Node* FindNode(NodeId node_id) const;
+
+  NodeMap all_nodes_;  // maps from node IDs to Node objects, including root
+  uint64 next_ready_sequence_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyPriorityTree);
+};
+
+template <typename NodeId>
+const int SpdyPriorityTree<NodeId>::kMinWeight;
+template <typename NodeId>
+const int SpdyPriorityTree<NodeId>::kMaxWeight;
+template <typename NodeId>
+const int SpdyPriorityTree<NodeId>::kDefaultWeight;
+
+template <typename NodeId>
+SpdyPriorityTree<NodeId>::SpdyPriorityTree() : next_ready_sequence_(0) {
+  all_nodes_[NodeId()];
+}
+
+template <typename NodeId>
+SpdyPriorityTree<NodeId>::~SpdyPriorityTree() {}
+
+template <typename NodeId>
+int SpdyPriorityTree<NodeId>::num_nodes() const {
+  return all_nodes_.size() - 1;
+}
+
+template <typename NodeId>
+int SpdyPriorityTree<NodeId>::num_ready_nodes() const {
+  return FindNode(NodeId())->num_ready_descendants;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::NodeExists(NodeId node_id) const {
+  return node_id != NodeId() && all_nodes_.count(node_id) != 0;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::AddNode(
+    NodeId node_id, NodeId parent_id, int weight, bool exclusive) {
+  if (node_id == NodeId() || all_nodes_.count(node_id) != 0 ||
+      all_nodes_.count(parent_id) == 0) {
+    return false;
+  }
+  if (weight < kMinWeight || weight > kMaxWeight) {
+    return false;
+  }
+
+  const std::vector<NodeId> siblings = all_nodes_[parent_id].children;
+  Node* new_node = &all_nodes_[node_id];
+  new_node->weight = weight;
+  Attach(node_id, parent_id);
+  if (exclusive) {
+    for (size_t i = 0; i < siblings.size(); ++i) {
+      MoveToSibling(siblings[i], node_id);
+    }
+  }
+  return true;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::RemoveNode(NodeId node_id) {
+  if (!NodeExists(node_id)) {
+    return false;
+  }
+  Node* node = &all_nodes_[node_id];
+  const NodeId parent_id = node->parent_id;
+  Node* parent = &all_nodes_[parent_id];
+  if (node->ready) {
+    MarkNoLongerReadyToWrite(node_id);
+  }
+
+  // The children take the node's place among its siblings.
+  int total_child_weight = 0;
+  for (size_t i = 0; i < node->children.size(); ++i) {
+    total_child_weight += all_nodes_[node->children[i]].weight;
+  }
+  typename std::vector<NodeId>::iterator position =
+      std::find(parent->children.begin(), parent->children.end(), node_id);
+  DCHECK(position != parent->children.end());
+  position = parent->children.erase(position);
+  for (size_t i = 0; i < node->children.size(); ++i) {
+    Node* child = &all_nodes_[node->children[i]];
+    child->parent_id = parent_id;
+    child->weight = std::max(
+        kMinWeight, node->weight * child->weight / total_child_weight);
+    // Carry over how far ahead of the node's virtual time the child was.
+    uint64 lead = child->pass > node->virtual_time ?
+        child->pass - node->virtual_time : 0;
+    child->pass = parent->virtual_time + lead;
+  }
+  parent->children.insert(position, node->children.begin(),
+                          node->children.end());
+  all_nodes_.erase(node_id);
+  return true;
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::Clear() {
+  all_nodes_.clear();
+  all_nodes_[NodeId()];
+}
+
+template <typename NodeId>
+int SpdyPriorityTree<NodeId>::GetWeight(NodeId node_id) const {
+  if (!NodeExists(node_id)) {
+    return 0;
+  }
+  return FindNode(node_id)->weight;
+}
+
+template <typename NodeId>
+NodeId SpdyPriorityTree<NodeId>::GetParent(NodeId node_id) const {
+  if (!NodeExists(node_id)) {
+    return NodeId();
+  }
+  return FindNode(node_id)->parent_id;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::HasChild(NodeId parent_id,
+                                        NodeId child_id) const {
+  return NodeExists(child_id) && GetParent(child_id) == parent_id;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::SetWeight(NodeId node_id, int weight) {
+  if (!NodeExists(node_id) || weight < kMinWeight || weight > kMaxWeight) {
+    return false;
+  }
+  all_nodes_[node_id].weight = weight;
+  return true;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::SetParent(
+    NodeId node_id, NodeId parent_id, bool exclusive) {
+  if (!NodeExists(node_id) || all_nodes_.count(parent_id) == 0 ||
+      node_id == parent_id) {
+    return false;
+  }
+
+  // If the new parent is a descendant of the node, it first moves up to
+  // take the node's place, which avoids creating a cycle.
+  for (NodeId ancestor_id = parent_id; ancestor_id != NodeId();
+       ancestor_id = all_nodes_[ancestor_id].parent_id) {
+    if (ancestor_id == node_id) {
+      Detach(parent_id);
+      Attach(parent_id, all_nodes_[node_id].parent_id);
+      break;
+    }
+  }
+
+  if (all_nodes_[node_id].parent_id != parent_id) {
+    Detach(node_id);
+    Attach(node_id, parent_id);
+  }
+  if (exclusive) {
+    const std::vector<NodeId> siblings = all_nodes_[parent_id].children;
+    for (size_t i = 0; i < siblings.size(); ++i) {
+      if (siblings[i] != node_id) {
+        MoveToSibling(siblings[i], node_id);
+      }
+    }
+  }
+  return true;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::IsMarkedReadyToWrite(NodeId node_id) const {
+  return NodeExists(node_id) && FindNode(node_id)->ready;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::MarkReadyToWrite(NodeId node_id) {
+  if (!NodeExists(node_id)) {
+    return false;
+  }
+  Node* node = &all_nodes_[node_id];
+  if (node->ready) {
+    return true;
+  }
+  if (!IsActive(*node)) {
+    Activate(node);
+  }
+  node->ready = true;
+  AddReadyDescendants(node->parent_id, 1);
+  return true;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::MarkNoLongerReadyToWrite(NodeId node_id) {
+  if (!NodeExists(node_id)) {
+    return false;
+  }
+  Node* node = &all_nodes_[node_id];
+  if (!node->ready) {
+    return true;
+  }
+  node->ready = false;
+  AddReadyDescendants(node->parent_id, -1);
+  return true;
+}
+
+template <typename NodeId>
+NodeId SpdyPriorityTree<NodeId>::NextNodeToWrite() const {
+  NodeId node_id = NodeId();
+  const Node* node = FindNode(node_id);
+  while (node->num_ready_descendants > 0) {
+    const Node* best_child = NULL;
+    NodeId best_child_id = NodeId();
+    for (size_t i = 0; i < node->children.size(); ++i) {
+      const Node* child = FindNode(node->children[i]);
+      if (!IsActive(*child)) {
+        continue;
+      }
+      if (best_child == NULL || child->pass < best_child->pass ||
+          (child->pass == best_child->pass &&
+           child->ready_sequence < best_child->ready_sequence)) {
+        best_child = child;
+        best_child_id = node->children[i];
+      }
+    }
+    DCHECK(best_child);
+    if (best_child->ready) {
+      return best_child_id;
+    }
+    node = best_child;
+  }
+  return NodeId();
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::RecordBytesWritten(NodeId node_id,
+                                                  size_t bytes) {
+  if (!NodeExists(node_id)) {
+    return false;
+  }
+  while (node_id != NodeId()) {
+    Node* node = &all_nodes_[node_id];
+    Node* parent = &all_nodes_[node->parent_id];
+    parent->virtual_time = std::max(parent->virtual_time, node->pass);
+    node->pass += static_cast<uint64>(bytes) * kMaxWeight / node->weight;
+    node_id = node->parent_id;
+  }
+  return true;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::IsActive(const Node& node) {
+  return node.ready || node.num_ready_descendants > 0;
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::Activate(Node* node) {
+  const Node* parent = FindNode(node->parent_id);
+  node->pass = std::max(node->pass, parent->virtual_time);
+  node->ready_sequence = next_ready_sequence_++;
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::AddReadyDescendants(NodeId node_id,
+                                                   int delta) {
+  if (delta == 0) {
+    return;
+  }
+  for (;;) {
+    Node* node = &all_nodes_[node_id];
+    bool was_active = IsActive(*node);
+    node->num_ready_descendants += delta;
+    DCHECK_GE(node->num_ready_descendants, 0);
+    if (node_id == NodeId()) {
+      return;
+    }
+    if (!was_active) {
+      Activate(node);
+    }
+    node_id = node->parent_id;
+  }
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::Detach(NodeId node_id) {
+  Node* node = &all_nodes_[node_id];
+  std::vector<NodeId>* siblings = &all_nodes_[node->parent_id].children;
+  siblings->erase(std::find(siblings->begin(), siblings->end(), node_id));
+  int num_ready = node->num_ready_descendants + (node->ready ? 1 : 0);
+  AddReadyDescendants(node->parent_id, -num_ready);
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::Attach(NodeId node_id, NodeId parent_id) {
+  Node* node = &all_nodes_[node_id];
+  Node* parent = &all_nodes_[parent_id];
+  node->parent_id = parent_id;
+  parent->children.push_back(node_id);
+  // The node's standing among its old siblings means nothing to its new
+  // ones, so it starts afresh.
+  node->pass = parent->virtual_time;
+  node->ready_sequence = next_ready_sequence_++;
+  int num_ready = node->num_ready_descendants + (node->ready ? 1 : 0);
+  AddReadyDescendants(parent_id, num_ready);
+}
+
+template <typename NodeId>
+void SpdyPriorityTree<NodeId>::MoveToSibling(NodeId node_id,
+                                             NodeId new_parent_id) {
+  Node* node = &all_nodes_[node_id];
+  Node* new_parent = &all_nodes_[new_parent_id];
+  DCHECK_EQ(node->parent_id, new_parent->parent_id);
+  std::vector<NodeId>* siblings = &all_nodes_[node->parent_id].children;
+  siblings->erase(std::find(siblings->begin(), siblings->end(), node_id));
+  node->parent_id = new_parent_id;
+  new_parent->children.push_back(node_id);
+  node->pass = new_parent->virtual_time;
+  node->ready_sequence = next_ready_sequence_++;
+  // The ready nodes stay within the old parent's subtree, so only the new
+  // parent's count changes.
+  int num_ready = node->num_ready_descendants + (node->ready ? 1 : 0);
+  if (num_ready > 0) {
+    if (!IsActive(*new_parent)) {
+      Activate(new_parent);
+    }
+    new_parent->num_ready_descendants += num_ready;
+  }
+}
+
+template <typename NodeId>
+const typename SpdyPriorityTree<NodeId>::Node*
+SpdyPriorityTree<NodeId>::FindNode(NodeId node_id) const {
+  typename NodeMap::const_iterator iter = all_nodes_.find(node_id);
+  if (iter == all_nodes_.end()) {
+    return NULL;
+  }
+  return &iter->second;
+}
+
+template <typename NodeId>
+bool SpdyPriorityTree<NodeId>::ValidateInvariantsForTests() const {
+  const Node* root = FindNode(NodeId());
+  if (root == NULL || root->ready) {
+    return false;
+  }
+  int num_children = 0;
+  for (typename NodeMap::const_iterator iter = all_nodes_.begin();
+       iter != all_nodes_.end(); ++iter) {
+    const NodeId node_id = iter->first;
+    const Node& node = iter->second;
+    if (node_id != NodeId()) {
+      const Node* parent = FindNode(node.parent_id);
+      if (parent == NULL ||
+          std::count(parent->children.begin(), parent->children.end(),
+                     node_id) != 1) {
+        return false;
+      }
+      if (node.weight < kMinWeight || node.weight > kMaxWeight) {
+        return false;
+      }
+    }
+
+    int num_ready_descendants = 0;
+    for (size_t i = 0; i < node.children.size(); ++i) {
+      const Node* child = FindNode(node.children[i]);
+      if (child == NULL || child->parent_id != node_id) {
+        return false;
+      }
+      num_ready_descendants +=
+          child->num_ready_descendants + (child->ready ? 1 : 0);
+      ++num_children;
+    }
+    if (num_ready_descendants != node.num_ready_descendants) {
+      return false;
+    }
+  }
+  // Every node but the root is somebody's child exactly once.  Together with
+  // the parent links being consistent, this means there are no cycles
+  // reachable from the root, and no nodes unreachable from it.
+  if (num_children != num_nodes()) {
+    return false;
+  }
+  for (typename NodeMap::const_iterator iter = all_nodes_.begin();
+       iter != all_nodes_.end(); ++iter) {
+    NodeId node_id = iter->first;
+    int depth = 0;
+    while (node_id != NodeId()) {
+      if (++depth > num_nodes()) {
+        return false;
+      }
+      node_id = FindNode(node_id)->parent_id;
+    }
+  }
+  return true;
+}
+
+}  // namespace net
+
+#endif  // NET_SPDY_SPDY_PRIORITY_TREE_H_
@@ -0,0 +1,289 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_priority_tree.h"
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+typedef SpdyPriorityTree<uint32> IntPriorityTree;
+
+const int kDefaultWeight = IntPriorityTree::kDefaultWeight;
+
+// Writes |bytes| for whichever node goes next, and returns it.
+uint32 WriteNextNode(IntPriorityTree* tree, size_t bytes) {
+  uint32 node_id = tree->NextNodeToWrite();
+  EXPECT_TRUE(tree->RecordBytesWritten(node_id, bytes));
+  return node_id;
+}
+
+}  // namespace
+
+TEST(SpdyPriorityTreeTest, AddAndRemoveNodes) {
+  IntPriorityTree tree;
+  EXPECT_EQ(0, tree.num_nodes());
+  EXPECT_FALSE(tree.NodeExists(1));
+
+  EXPECT_TRUE(tree.AddNode(1, 0, 100, false));
+  EXPECT_EQ(1, tree.num_nodes());
+  ASSERT_TRUE(tree.NodeExists(1));
+  EXPECT_EQ(100, tree.GetWeight(1));
+  EXPECT_EQ(0u, tree.GetParent(1));
+  EXPECT_FALSE(tree.NodeExists(5));
+
+  EXPECT_TRUE(tree.AddNode(5, 1, 50, false));
+  EXPECT_FALSE(tree.AddNode(5, 0, 200, false));
+  EXPECT_EQ(2, tree.num_nodes());
+  ASSERT_TRUE(tree.NodeExists(5));
+  EXPECT_EQ(50, tree.GetWeight(5));
+  EXPECT_EQ(1u, tree.GetParent(5));
+  EXPECT_TRUE(tree.HasChild(1, 5));
+
+  // The parent node 19 doesn't exist, so this should fail:
+  EXPECT_FALSE(tree.AddNode(7, 19, kDefaultWeight, false));
+  // Weights are limited to 1 through 256:
+  EXPECT_FALSE(tree.AddNode(7, 1, 0, false));
+  EXPECT_FALSE(tree.AddNode(7, 1, 257, false));
+  // The root always exists:
+  EXPECT_FALSE(tree.AddNode(0, 1, kDefaultWeight, false));
+  EXPECT_FALSE(tree.NodeExists(7));
+
+  // Removing node 1 moves node 5 to the root, with all of node 1's
+  // weight.
+  EXPECT_TRUE(tree.RemoveNode(1));
+  EXPECT_FALSE(tree.RemoveNode(1));
+  EXPECT_EQ(1, tree.num_nodes());
+  EXPECT_FALSE(tree.NodeExists(1));
+  EXPECT_EQ(0u, tree.GetParent(5));
+  EXPECT_EQ(100, tree.GetWeight(5));
+  EXPECT_EQ(0, tree.GetWeight(1));
+
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+// Removing a node divides its weight among its children in proportion
+// to their own weights.
+TEST(SpdyPriorityTreeTest, RemoveNodeSharesWeight) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, 64, false);
+  tree.AddNode(2, 1, 30, false);
+  tree.AddNode(3, 1, 10, false);
+  tree.AddNode(4, 0, kDefaultWeight, false);
+
+  EXPECT_TRUE(tree.RemoveNode(1));
+  EXPECT_EQ(0u, tree.GetParent(2));
+  EXPECT_EQ(0u, tree.GetParent(3));
+  EXPECT_EQ(48, tree.GetWeight(2));
+  EXPECT_EQ(16, tree.GetWeight(3));
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+// An exclusive dependency makes the new node the only child of its
+// parent.
+TEST(SpdyPriorityTreeTest, AddExclusiveNode) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 1, kDefaultWeight, false);
+  tree.AddNode(3, 1, kDefaultWeight, false);
+
+  EXPECT_TRUE(tree.AddNode(4, 1, kDefaultWeight, true));
+  EXPECT_TRUE(tree.HasChild(1, 4));
+  EXPECT_TRUE(tree.HasChild(4, 2));
+  EXPECT_TRUE(tree.HasChild(4, 3));
+  EXPECT_FALSE(tree.HasChild(1, 2));
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+TEST(SpdyPriorityTreeTest, SetParent) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 1, kDefaultWeight, false);
+  tree.AddNode(3, 0, kDefaultWeight, false);
+  tree.AddNode(4, 3, kDefaultWeight, false);
+
+  EXPECT_TRUE(tree.SetParent(2, 3, false));
+  EXPECT_TRUE(tree.HasChild(3, 2));
+  EXPECT_TRUE(tree.HasChild(3, 4));
+  EXPECT_FALSE(tree.HasChild(1, 2));
+
+  // Exclusively, node 2 adopts its new sibling.
+  EXPECT_TRUE(tree.SetParent(2, 3, true));
+  EXPECT_TRUE(tree.HasChild(3, 2));
+  EXPECT_TRUE(tree.HasChild(2, 4));
+
+  EXPECT_FALSE(tree.SetParent(2, 2, false));
+  EXPECT_FALSE(tree.SetParent(2, 19, false));
+  EXPECT_FALSE(tree.SetParent(19, 2, false));
+  EXPECT_TRUE(tree.SetParent(2, 0, false));
+  EXPECT_EQ(0u, tree.GetParent(2));
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+// Making a node depend on its own descendant first moves the
+// descendant into the node's place.
+TEST(SpdyPriorityTreeTest, SetParentToDescendant) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 1, kDefaultWeight, false);
+  tree.AddNode(3, 2, kDefaultWeight, false);
+  tree.AddNode(4, 3, kDefaultWeight, false);
+
+  EXPECT_TRUE(tree.SetParent(1, 3, false));
+  EXPECT_EQ(0u, tree.GetParent(3));
+  EXPECT_EQ(3u, tree.GetParent(1));
+  EXPECT_EQ(1u, tree.GetParent(2));
+  EXPECT_EQ(3u, tree.GetParent(4));
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+TEST(SpdyPriorityTreeTest, MarkReadyToWrite) {
+  IntPriorityTree tree;
+  EXPECT_EQ(0u, tree.NextNodeToWrite());
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  EXPECT_FALSE(tree.IsMarkedReadyToWrite(1));
+  EXPECT_FALSE(tree.MarkReadyToWrite(19));
+
+  EXPECT_TRUE(tree.MarkReadyToWrite(1));
+  EXPECT_TRUE(tree.MarkReadyToWrite(1));
+  EXPECT_TRUE(tree.IsMarkedReadyToWrite(1));
+  EXPECT_EQ(1, tree.num_ready_nodes());
+  EXPECT_EQ(1u, tree.NextNodeToWrite());
+
+  EXPECT_TRUE(tree.MarkNoLongerReadyToWrite(1));
+  EXPECT_FALSE(tree.IsMarkedReadyToWrite(1));
+  EXPECT_EQ(0, tree.num_ready_nodes());
+  EXPECT_EQ(0u, tree.NextNodeToWrite());
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+// A ready node goes before any of its descendants.
+TEST(SpdyPriorityTreeTest, ParentGoesFirst) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 1, kDefaultWeight, false);
+  tree.AddNode(3, 2, kDefaultWeight, false);
+  tree.MarkReadyToWrite(3);
+  tree.MarkReadyToWrite(2);
+  EXPECT_EQ(2u, WriteNextNode(&tree, 1000));
+  EXPECT_EQ(2u, WriteNextNode(&tree, 1000));
+
+  tree.MarkNoLongerReadyToWrite(2);
+  EXPECT_EQ(3u, tree.NextNodeToWrite());
+  tree.MarkReadyToWrite(1);
+  EXPECT_EQ(1u, tree.NextNodeToWrite());
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+// Siblings which have written nothing go in the order they became
+// ready.
+TEST(SpdyPriorityTreeTest, SiblingsGoInReadyOrder) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 0, kDefaultWeight, false);
+  tree.AddNode(3, 0, kDefaultWeight, false);
+  tree.MarkReadyToWrite(3);
+  tree.MarkReadyToWrite(1);
+  tree.MarkReadyToWrite(2);
+
+  EXPECT_EQ(3u, tree.NextNodeToWrite());
+  tree.MarkNoLongerReadyToWrite(3);
+  EXPECT_EQ(1u, tree.NextNodeToWrite());
+  tree.MarkNoLongerReadyToWrite(1);
+  EXPECT_EQ(2u, tree.NextNodeToWrite());
+}
+
+// Siblings share bandwidth in proportion to their weights.
+TEST(SpdyPriorityTreeTest, SiblingsShareByWeight) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, 64, false);
+  tree.AddNode(2, 0, 32, false);
+  tree.AddNode(3, 0, 32, false);
+  tree.MarkReadyToWrite(1);
+  tree.MarkReadyToWrite(2);
+  tree.MarkReadyToWrite(3);
+
+  size_t bytes_written[4] = { 0 };
+  for (int i = 0; i < 400; ++i)
+    bytes_written[WriteNextNode(&tree, 1000)] += 1000;
+  EXPECT_EQ(200000u, bytes_written[1]);
+  EXPECT_EQ(100000u, bytes_written[2]);
+  EXPECT_EQ(100000u, bytes_written[3]);
+}
+
+// A big writer doesn't starve a sibling which writes little at a time.
+TEST(SpdyPriorityTreeTest, SmallWriterIsNotStarved) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 0, kDefaultWeight, false);
+  tree.MarkReadyToWrite(1);
+  tree.MarkReadyToWrite(2);
+
+  EXPECT_EQ(1u, WriteNextNode(&tree, 16000));
+  for (int i = 0; i < 16; ++i)
+    EXPECT_EQ(2u, WriteNextNode(&tree, 1000));
+  EXPECT_EQ(1u, WriteNextNode(&tree, 16000));
+}
+
+// A node which was not ready doesn't get to catch up on the bandwidth
+// it didn't use.
+TEST(SpdyPriorityTreeTest, IdleNodeDoesNotCatchUp) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 0, kDefaultWeight, false);
+  tree.MarkReadyToWrite(1);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(1u, WriteNextNode(&tree, 1000));
+
+  tree.MarkReadyToWrite(2);
+  EXPECT_EQ(2u, WriteNextNode(&tree, 1000));
+  EXPECT_EQ(1u, WriteNextNode(&tree, 1000));
+  EXPECT_EQ(2u, WriteNextNode(&tree, 1000));
+  EXPECT_EQ(1u, WriteNextNode(&tree, 1000));
+}
+
+// Descendants are charged to the subtree of their ancestor, so a
+// subtree of many nodes gets no more than its ancestor's share.
+TEST(SpdyPriorityTreeTest, SubtreesShareByWeight) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 0, kDefaultWeight, false);
+  tree.AddNode(3, 2, kDefaultWeight, false);
+  tree.AddNode(4, 2, kDefaultWeight, false);
+  tree.MarkReadyToWrite(1);
+  tree.MarkReadyToWrite(3);
+  tree.MarkReadyToWrite(4);
+
+  size_t bytes_written[5] = { 0 };
+  for (int i = 0; i < 400; ++i)
+    bytes_written[WriteNextNode(&tree, 1000)] += 1000;
+  EXPECT_EQ(200000u, bytes_written[1]);
+  EXPECT_EQ(100000u, bytes_written[3]);
+  EXPECT_EQ(100000u, bytes_written[4]);
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+}
+
+TEST(SpdyPriorityTreeTest, RemoveReadyNode) {
+  IntPriorityTree tree;
+  tree.AddNode(1, 0, kDefaultWeight, false);
+  tree.AddNode(2, 1, kDefaultWeight, false);
+  tree.MarkReadyToWrite(1);
+  tree.MarkReadyToWrite(2);
+  EXPECT_EQ(2, tree.num_ready_nodes());
+
+  EXPECT_TRUE(tree.RemoveNode(1));
+  EXPECT_EQ(1, tree.num_ready_nodes());
+  EXPECT_EQ(2u, tree.NextNodeToWrite());
+  ASSERT_TRUE(tree.ValidateInvariantsForTests());
+
+  tree.Clear();
+  EXPECT_EQ(0, tree.num_nodes());
+  EXPECT_EQ(0, tree.num_ready_nodes());
+  EXPECT_EQ(0u, tree.NextNodeToWrite());
+}
+
+}  // namespace net
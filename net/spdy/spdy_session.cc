@@ -1222,6 +1222,9 @@ int SpdySession::DoRead() {
   CHECK(connection_);
   CHECK(connection_->socket());
   read_state_ = READ_STATE_DO_READ_COMPLETE;
+  // DATA frames from earlier reads may still point into |read_buffer_|.
+  if (!read_buffer_->HasOneRef())
+    read_buffer_ = new IOBuffer(kReadBufferSize);
   return connection_->socket()->Read(
       read_buffer_.get(),
       kReadBufferSize,
@@ -1385,6 +1388,10 @@ int SpdySession::DoWrite() {
     DCHECK_GE(in_flight_write_frame_size_,
               buffered_spdy_framer_->GetFrameMinimumSize());
     in_flight_write_stream_ = stream;
+    // Charge DATA frames to their stream, so that a large upload doesn't
+    // crowd out other streams of the same priority.
+    if (frame_type == DATA && stream.get())
+      write_queue_.RecordBytesWritten(stream, in_flight_write_frame_size_);
   }
 
   write_state_ = WRITE_STATE_DO_WRITE_COMPLETE;
@@ -1921,7 +1928,14 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   scoped_ptr<SpdyBuffer> buffer;
   if (data) {
     DCHECK_GT(len, 0u);
-    buffer.reset(new SpdyBuffer(data, len));
+    // The framer hands over DATA payloads as they are read, so they can be
+    // passed on without a copy.
+    if (data >= read_buffer_->data() &&
+        data + len <= read_buffer_->data() + kReadBufferSize) {
+      buffer.reset(new SpdyBuffer(read_buffer_, data, len));
+    } else {
+      buffer.reset(new SpdyBuffer(data, len));
+    }
 
     if (flow_control_state_ == FLOW_CONTROL_STREAM_AND_SESSION) {
       DecreaseRecvWindowSize(static_cast<int32>(len));
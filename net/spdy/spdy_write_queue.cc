@@ -13,26 +13,37 @@
 
 namespace net {
 
-SpdyWriteQueue::PendingWrite::PendingWrite() : frame_producer(NULL) {}
+SpdyWriteQueue::PendingWrite::PendingWrite()
+    : frame_producer(NULL), has_stream(false), sequence_number(0) {}
 
 SpdyWriteQueue::PendingWrite::PendingWrite(
     SpdyFrameType frame_type,
     SpdyBufferProducer* frame_producer,
-    const base::WeakPtr<SpdyStream>& stream)
+    const base::WeakPtr<SpdyStream>& stream,
+    uint64 sequence_number)
     : frame_type(frame_type),
       frame_producer(frame_producer),
       stream(stream),
-      has_stream(stream.get() != NULL) {}
+      has_stream(stream.get() != NULL),
+      sequence_number(sequence_number) {}
 
 SpdyWriteQueue::PendingWrite::~PendingWrite() {}
 
-SpdyWriteQueue::SpdyWriteQueue() {}
+SpdyWriteQueue::StreamWrites::StreamWrites() : priority(DEFAULT_PRIORITY) {}
+
+SpdyWriteQueue::StreamWrites::~StreamWrites() {}
+
+SpdyWriteQueue::SpdyWriteQueue()
+    : next_scheduler_id_(1),
+      next_sequence_number_(0) {}
 
 SpdyWriteQueue::~SpdyWriteQueue() {
   Clear();
 }
 
 bool SpdyWriteQueue::IsEmpty() const {
+  if (scheduler_.HasReadyStreams())
+    return false;
   for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; i++) {
     if (!queue_[i].empty())
       return false;
@@ -46,30 +57,73 @@ void SpdyWriteQueue::Enqueue(RequestPriority priority,
                              const base::WeakPtr<SpdyStream>& stream) {
   CHECK_GE(priority, MINIMUM_PRIORITY);
   CHECK_LE(priority, MAXIMUM_PRIORITY);
-  if (stream.get())
-    DCHECK_EQ(stream->priority(), priority);
-  queue_[priority].push_back(
-      PendingWrite(frame_type, frame_producer.release(), stream));
+  PendingWrite pending_write(frame_type, frame_producer.release(), stream,
+                             next_sequence_number_++);
+  if (!stream.get()) {
+    queue_[priority].push_back(pending_write);
+    return;
+  }
+
+  DCHECK_EQ(stream->priority(), priority);
+  SchedulerId& scheduler_id = scheduler_ids_[stream.get()];
+  if (scheduler_id == 0)
+    scheduler_id = next_scheduler_id_++;
+  StreamWrites* stream_writes = &stream_writes_[scheduler_id];
+  stream_writes->priority = priority;
+  stream_writes->writes.push_back(pending_write);
+  scheduler_.MarkStreamReady(scheduler_id, ToSchedulerPriority(priority));
 }
 
 bool SpdyWriteQueue::Dequeue(SpdyFrameType* frame_type,
                              scoped_ptr<SpdyBufferProducer>* frame_producer,
                              base::WeakPtr<SpdyStream>* stream) {
+  // The stream which gets to write next among the streams of the
+  // highest priority with pending writes, if any.
+  SchedulerId scheduler_id = 0;
+  StreamWrites* stream_writes = NULL;
+  if (scheduler_.HasReadyStreams()) {
+    scheduler_id = scheduler_.GetNextReadyStream();
+    stream_writes = &stream_writes_[scheduler_id];
+    DCHECK(!stream_writes->writes.empty());
+  }
+
   for (int i = MAXIMUM_PRIORITY; i >= MINIMUM_PRIORITY; --i) {
-    if (!queue_[i].empty()) {
-      PendingWrite pending_write = queue_[i].front();
-      queue_[i].pop_front();
-      *frame_type = pending_write.frame_type;
-      frame_producer->reset(pending_write.frame_producer);
-      *stream = pending_write.stream;
-      if (pending_write.has_stream)
-        DCHECK(stream->get());
-      return true;
+    std::deque<PendingWrite>* queue = NULL;
+    if (!queue_[i].empty())
+      queue = &queue_[i];
+    // Writes without a stream and the chosen stream's writes go in the
+    // order they were enqueued.
+    if (stream_writes && stream_writes->priority == i &&
+        (!queue || stream_writes->writes.front().sequence_number <
+                       queue->front().sequence_number)) {
+      queue = &stream_writes->writes;
     }
+    if (!queue)
+      continue;
+
+    PendingWrite pending_write = queue->front();
+    queue->pop_front();
+    if (stream_writes && queue == &stream_writes->writes && queue->empty())
+      scheduler_.MarkStreamNotReady(scheduler_id);
+    *frame_type = pending_write.frame_type;
+    frame_producer->reset(pending_write.frame_producer);
+    *stream = pending_write.stream;
+    if (pending_write.has_stream)
+      DCHECK(stream->get());
+    return true;
   }
   return false;
 }
 
+void SpdyWriteQueue::RecordBytesWritten(
+    const base::WeakPtr<SpdyStream>& stream,
+    size_t bytes) {
+  std::map<SpdyStream*, SchedulerId>::const_iterator it =
+      scheduler_ids_.find(stream.get());
+  if (it != scheduler_ids_.end())
+    scheduler_.RecordBytesWritten(it->second, bytes);
+}
+
 void SpdyWriteQueue::RemovePendingWritesForStream(
     const base::WeakPtr<SpdyStream>& stream) {
   RequestPriority priority = stream->priority();
@@ -77,62 +131,66 @@ void SpdyWriteQueue::RemovePendingWritesForStream(
   CHECK_LE(priority, MAXIMUM_PRIORITY);
 
   DCHECK(stream.get());
-  if (DCHECK_IS_ON()) {
-    // |stream| should not have pending writes in a queue not matching
-    // its priority.
-    for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i) {
-      if (priority == i)
-        continue;
-      for (std::deque<PendingWrite>::const_iterator it = queue_[i].begin();
-           it != queue_[i].end(); ++it) {
-        DCHECK_NE(it->stream.get(), stream.get());
-      }
-    }
-  }
-
-  // Do the actual deletion and removal, preserving FIFO-ness.
-  std::deque<PendingWrite>* queue = &queue_[priority];
-  std::deque<PendingWrite>::iterator out_it = queue->begin();
-  for (std::deque<PendingWrite>::const_iterator it = queue->begin();
-       it != queue->end(); ++it) {
-    if (it->stream.get() == stream.get()) {
-      delete it->frame_producer;
-    } else {
-      *out_it = *it;
-      ++out_it;
-    }
-  }
-  queue->erase(out_it, queue->end());
+  std::map<SpdyStream*, SchedulerId>::iterator it =
+      scheduler_ids_.find(stream.get());
+  if (it == scheduler_ids_.end())
+    return;
+
+  // |stream| should not have pending writes at a priority not matching
+  // its own.
+  StreamWritesMap::iterator writes_it = stream_writes_.find(it->second);
+  DCHECK(writes_it != stream_writes_.end());
+  DCHECK(writes_it->second.writes.empty() ||
+         writes_it->second.priority == priority);
+  DeletePendingWrites(&writes_it->second.writes);
+  stream_writes_.erase(writes_it);
+  scheduler_.UnregisterStream(it->second);
+  scheduler_ids_.erase(it);
 }
 
 void SpdyWriteQueue::RemovePendingWritesForStreamsAfter(
     SpdyStreamId last_good_stream_id) {
-  for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i) {
-    // Do the actual deletion and removal, preserving FIFO-ness.
-    std::deque<PendingWrite>* queue = &queue_[i];
-    std::deque<PendingWrite>::iterator out_it = queue->begin();
-    for (std::deque<PendingWrite>::const_iterator it = queue->begin();
-         it != queue->end(); ++it) {
-      if (it->stream.get() && (it->stream->stream_id() > last_good_stream_id ||
-                               it->stream->stream_id() == 0)) {
-        delete it->frame_producer;
-      } else {
-        *out_it = *it;
-        ++out_it;
-      }
+  for (std::map<SpdyStream*, SchedulerId>::const_iterator it =
+           scheduler_ids_.begin();
+       it != scheduler_ids_.end(); ++it) {
+    StreamWrites* stream_writes = &stream_writes_[it->second];
+    if (stream_writes->writes.empty())
+      continue;
+    // All writes of a stream refer to it through the same WeakPtr.
+    SpdyStream* stream = stream_writes->writes.front().stream.get();
+    if (stream && (stream->stream_id() > last_good_stream_id ||
+                   stream->stream_id() == 0)) {
+      DeletePendingWrites(&stream_writes->writes);
+      scheduler_.MarkStreamNotReady(it->second);
     }
-    queue->erase(out_it, queue->end());
   }
 }
 
 void SpdyWriteQueue::Clear() {
-  for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i) {
-    for (std::deque<PendingWrite>::iterator it = queue_[i].begin();
-         it != queue_[i].end(); ++it) {
-      delete it->frame_producer;
-    }
-    queue_[i].clear();
+  for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i)
+    DeletePendingWrites(&queue_[i]);
+  for (StreamWritesMap::iterator it = stream_writes_.begin();
+       it != stream_writes_.end(); ++it) {
+    DeletePendingWrites(&it->second.writes);
   }
+  stream_writes_.clear();
+  scheduler_ids_.clear();
+  scheduler_.Clear();
+}
+
+// static
+void SpdyWriteQueue::DeletePendingWrites(std::deque<PendingWrite>* writes) {
+  for (std::deque<PendingWrite>::iterator it = writes->begin();
+       it != writes->end(); ++it) {
+    delete it->frame_producer;
+  }
+  writes->clear();
+}
+
+// static
+SpdyPriority SpdyWriteQueue::ToSchedulerPriority(RequestPriority priority) {
+  // SpdyPriority counts down from the highest priority.
+  return static_cast<SpdyPriority>(MAXIMUM_PRIORITY - priority);
 }
 
 }  // namespace net
@@ -6,13 +6,16 @@
 #define NET_SPDY_SPDY_WRITE_QUEUE_H_
 
 #include <deque>
+#include <map>
 
 #include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/net_export.h"
 #include "net/base/request_priority.h"
 #include "net/spdy/spdy_protocol.h"
+#include "net/spdy/spdy_write_scheduler.h"
 
 namespace net {
 
@@ -21,7 +24,10 @@ class SpdyBufferProducer;
 class SpdyStream;
 
 // A queue of SpdyBufferProducers to produce frames to write. Ordered
-// by priority, and then FIFO.
+// by priority. Within a priority, the writes of each stream are FIFO,
+// and streams share bandwidth through a SpdyWriteScheduler by the DATA
+// bytes reported with RecordBytesWritten(); writes that are not
+// associated with a stream keep their place in line.
 class NET_EXPORT_PRIVATE SpdyWriteQueue {
  public:
   SpdyWriteQueue();
@@ -49,6 +55,13 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
                scoped_ptr<SpdyBufferProducer>* frame_producer,
                base::WeakPtr<SpdyStream>* stream);
 
+  // Charges |bytes| of DATA written for the given stream against it,
+  // so that other streams of its priority go first until they have
+  // written as much. Does nothing if |stream| has no pending writes
+  // and never had any.
+  void RecordBytesWritten(const base::WeakPtr<SpdyStream>& stream,
+                          size_t bytes);
+
   // Removes all pending writes for the given stream, which must be
   // non-NULL.
   void RemovePendingWritesForStream(const base::WeakPtr<SpdyStream>& stream);
@@ -70,17 +83,54 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
     base::WeakPtr<SpdyStream> stream;
     // Whether |stream| was non-NULL when enqueued.
     bool has_stream;
+    // The order in which writes were enqueued.
+    uint64 sequence_number;
 
     PendingWrite();
     PendingWrite(SpdyFrameType frame_type,
                  SpdyBufferProducer* frame_producer,
-                 const base::WeakPtr<SpdyStream>& stream);
+                 const base::WeakPtr<SpdyStream>& stream,
+                 uint64 sequence_number);
     ~PendingWrite();
   };
 
-  // The actual write queue, binned by priority.
+  // The id of a stream within |scheduler_|. Streams are identified by
+  // their address rather than their stream id, since they are not
+  // assigned one until their SYN_STREAM is dequeued.
+  typedef uint32 SchedulerId;
+
+  // The pending writes of a stream, which all have its priority.
+  struct StreamWrites {
+    StreamWrites();
+    ~StreamWrites();
+
+    RequestPriority priority;
+    std::deque<PendingWrite> writes;
+  };
+
+  typedef base::hash_map<SchedulerId, StreamWrites> StreamWritesMap;
+
+  // Deletes the frame producers of |writes| and empties it.
+  static void DeletePendingWrites(std::deque<PendingWrite>* writes);
+
+  // Converts |priority| to the SpdyPriority used by |scheduler_|.
+  static SpdyPriority ToSchedulerPriority(RequestPriority priority);
+
+  // The writes which are not associated with a stream, binned by
+  // priority.
   std::deque<PendingWrite> queue_[NUM_PRIORITIES];
 
+  // The writes associated with each stream, and the scheduler ids of
+  // the streams. Streams stay here until their writes are removed.
+  StreamWritesMap stream_writes_;
+  std::map<SpdyStream*, SchedulerId> scheduler_ids_;
+  SchedulerId next_scheduler_id_;
+
+  // Holds the streams with pending writes as ready.
+  SpdyWriteScheduler<SchedulerId> scheduler_;
+
+  uint64 next_sequence_number_;
+
   DISALLOW_COPY_AND_ASSIGN(SpdyWriteQueue);
 };
 
@@ -151,6 +151,48 @@ TEST_F(SpdyWriteQueueTest, DequeuesFIFO) {
   EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
 }
 
+// Enqueue DATA frames for two streams with the same priority, where one
+// has already written a lot. The other stream's frames should be
+// dequeued first until it has caught up, while writes without a stream
+// keep their place in line.
+TEST_F(SpdyWriteQueueTest, DequeuesByBytesWritten) {
+  SpdyWriteQueue write_queue;
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(DEFAULT_PRIORITY));
+  scoped_ptr<SpdyStream> stream2(MakeTestStream(DEFAULT_PRIORITY));
+
+  write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(1),
+                      stream1->GetWeakPtr());
+  write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(2),
+                      stream2->GetWeakPtr());
+  write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(3),
+                      stream1->GetWeakPtr());
+  write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(4),
+                      stream2->GetWeakPtr());
+  write_queue.Enqueue(DEFAULT_PRIORITY, DATA, IntToProducer(5),
+                      stream2->GetWeakPtr());
+  write_queue.Enqueue(DEFAULT_PRIORITY, RST_STREAM, IntToProducer(6),
+                      base::WeakPtr<SpdyStream>());
+
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> frame_producer;
+  base::WeakPtr<SpdyStream> stream;
+  ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+  EXPECT_EQ(1, ProducerToInt(frame_producer.Pass()));
+  EXPECT_EQ(stream1, stream.get());
+  write_queue.RecordBytesWritten(stream, 3000);
+
+  const int kExpectedOrder[] = { 2, 4, 5, 3, 6 };
+  for (size_t i = 0; i < arraysize(kExpectedOrder); ++i) {
+    ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+    EXPECT_EQ(kExpectedOrder[i], ProducerToInt(frame_producer.Pass()));
+    if (stream.get())
+      write_queue.RecordBytesWritten(stream, 1000);
+  }
+  EXPECT_TRUE(write_queue.IsEmpty());
+  EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+}
+
 // Enqueue a bunch of writes and then call
 // RemovePendingWritesForStream() on one of the streams. No dequeued
 // write should be for that stream.
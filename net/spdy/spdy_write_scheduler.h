@@ -0,0 +1,185 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_SPDY_WRITE_SCHEDULER_H_
+#define NET_SPDY_SPDY_WRITE_SCHEDULER_H_
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/logging.h"
+#include "net/spdy/spdy_priority_tree.h"
+#include "net/spdy/spdy_protocol.h"
+#include "net/spdy/write_blocked_list.h"
+
+namespace net {
+
+// Decides which of the streams with data to write goes next.  Streams of a
+// higher SpdyPriority always go before those of a lower one, so that
+// render-blocking resources get the link first.  Streams of the same
+// priority form an HTTP/2 dependency tree (see SpdyPriorityTree), and share
+// bandwidth by weight, once they report the bytes they write through
+// RecordBytesWritten().  Otherwise they go in the order they became ready.
+//
+// Unlike WriteBlockedList, a stream is ready at most once, however many times
+// it is marked.  Streams are registered when they are first marked ready, and
+// must be unregistered when they close.
+template <typename StreamIdType>
+class SpdyWriteScheduler {
+ public:
+  SpdyWriteScheduler() : num_ready_streams_(0) {}
+  ~SpdyWriteScheduler() {}
+
+  // Marks the given stream ready to write, registering it at |priority|,
+  // depending on no other stream, if it is unknown.  A known stream marked at
+  // a different priority moves there, losing its dependencies.
+  void MarkStreamReady(StreamIdType stream_id, SpdyPriority priority) {
+    DCHECK(stream_id != StreamIdType());
+    priority = WriteBlockedList<StreamIdType>::ClampPriority(priority);
+    typename PriorityMap::iterator it = stream_priorities_.find(stream_id);
+    if (it != stream_priorities_.end() && it->second != priority) {
+      UnregisterStream(stream_id);
+      it = stream_priorities_.end();
+    }
+    if (it == stream_priorities_.end()) {
+      stream_priorities_[stream_id] = priority;
+      bool added = trees_[priority].AddNode(
+          stream_id, StreamIdType(),
+          SpdyPriorityTree<StreamIdType>::kDefaultWeight, false);
+      DCHECK(added);
+    }
+    if (!trees_[priority].IsMarkedReadyToWrite(stream_id)) {
+      trees_[priority].MarkReadyToWrite(stream_id);
+      ++num_ready_streams_;
+    }
+  }
+
+  // Marks the given stream, if known, as having nothing to write.
+  void MarkStreamNotReady(StreamIdType stream_id) {
+    typename PriorityMap::const_iterator it =
+        stream_priorities_.find(stream_id);
+    if (it == stream_priorities_.end()) {
+      return;
+    }
+    SpdyPriorityTree<StreamIdType>* tree = &trees_[it->second];
+    if (tree->IsMarkedReadyToWrite(stream_id)) {
+      tree->MarkNoLongerReadyToWrite(stream_id);
+      --num_ready_streams_;
+    }
+  }
+
+  bool IsStreamReady(StreamIdType stream_id) const {
+    typename PriorityMap::const_iterator it =
+        stream_priorities_.find(stream_id);
+    return it != stream_priorities_.end() &&
+        trees_[it->second].IsMarkedReadyToWrite(stream_id);
+  }
+
+  // Makes the given stream depend on |parent_id| with |weight|, as with
+  // SpdyPriorityTree::SetParent().  |parent_id| may be StreamIdType() for
+  // no dependency.  Returns false and has no effect if either stream is
+  // unknown, if they have different priorities, or if |weight| is out of
+  // range.
+  bool SetStreamDependency(StreamIdType stream_id,
+                           StreamIdType parent_id,
+                           int weight,
+                           bool exclusive) {
+    typename PriorityMap::const_iterator it =
+        stream_priorities_.find(stream_id);
+    if (it == stream_priorities_.end()) {
+      return false;
+    }
+    SpdyPriorityTree<StreamIdType>* tree = &trees_[it->second];
+    if (parent_id == stream_id ||
+        (parent_id != StreamIdType() && !tree->NodeExists(parent_id))) {
+      return false;
+    }
+    if (weight < SpdyPriorityTree<StreamIdType>::kMinWeight ||
+        weight > SpdyPriorityTree<StreamIdType>::kMaxWeight) {
+      return false;
+    }
+    tree->SetWeight(stream_id, weight);
+    return tree->SetParent(stream_id, parent_id, exclusive);
+  }
+
+  // Forgets the given stream, which has closed.  Streams depending on it
+  // take its place.
+  void UnregisterStream(StreamIdType stream_id) {
+    typename PriorityMap::iterator it = stream_priorities_.find(stream_id);
+    if (it == stream_priorities_.end()) {
+      return;
+    }
+    if (trees_[it->second].IsMarkedReadyToWrite(stream_id)) {
+      --num_ready_streams_;
+    }
+    trees_[it->second].RemoveNode(stream_id);
+    stream_priorities_.erase(it);
+  }
+
+  bool HasReadyStreams() const {
+    return num_ready_streams_ > 0;
+  }
+
+  size_t NumReadyStreams() const {
+    return num_ready_streams_;
+  }
+
+  // Returns the priority of the most important ready stream.  There must be
+  // one.
+  SpdyPriority GetHighestReadyPriority() const {
+    for (SpdyPriority i = kHighestPriority; i <= kLowestPriority; ++i) {
+      if (trees_[i].num_ready_nodes() > 0) {
+        return i;
+      }
+    }
+    LOG(DFATAL) << "No ready streams";
+    return kHighestPriority;
+  }
+
+  // Returns the stream which should write next, leaving it ready.  There
+  // must be one.
+  StreamIdType GetNextReadyStream() const {
+    return trees_[GetHighestReadyPriority()].NextNodeToWrite();
+  }
+
+  // Returns the stream which should write next, and marks it not ready.
+  // There must be one.
+  StreamIdType PopNextReadyStream() {
+    StreamIdType stream_id = GetNextReadyStream();
+    MarkStreamNotReady(stream_id);
+    return stream_id;
+  }
+
+  // Charges |bytes| written by the given stream against it, so that the
+  // other streams of its priority catch up.  Does nothing if the stream is
+  // unknown.
+  void RecordBytesWritten(StreamIdType stream_id, size_t bytes) {
+    typename PriorityMap::const_iterator it =
+        stream_priorities_.find(stream_id);
+    if (it != stream_priorities_.end()) {
+      trees_[it->second].RecordBytesWritten(stream_id, bytes);
+    }
+  }
+
+  // Forgets every stream.
+  void Clear() {
+    for (SpdyPriority i = kHighestPriority; i <= kLowestPriority; ++i) {
+      trees_[i].Clear();
+    }
+    stream_priorities_.clear();
+    num_ready_streams_ = 0;
+  }
+
+ private:
+  typedef base::hash_map<StreamIdType, SpdyPriority> PriorityMap;
+
+  PriorityMap stream_priorities_;
+  SpdyPriorityTree<StreamIdType> trees_[kLowestPriority + 1];
+  size_t num_ready_streams_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyWriteScheduler);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_SPDY_WRITE_SCHEDULER_H_
@@ -0,0 +1,116 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_write_scheduler.h"
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+typedef SpdyWriteScheduler<uint32> IntWriteScheduler;
+
+TEST(SpdyWriteSchedulerTest, HigherPriorityGoesFirst) {
+  IntWriteScheduler scheduler;
+  EXPECT_FALSE(scheduler.HasReadyStreams());
+  scheduler.MarkStreamReady(1, 4);
+  scheduler.MarkStreamReady(2, 0);
+  scheduler.MarkStreamReady(3, 7);
+  EXPECT_TRUE(scheduler.HasReadyStreams());
+  EXPECT_EQ(3u, scheduler.NumReadyStreams());
+  EXPECT_EQ(0, scheduler.GetHighestReadyPriority());
+
+  // A lower priority stream doesn't go first however little it has
+  // written.
+  scheduler.RecordBytesWritten(2, 100000);
+  EXPECT_EQ(2u, scheduler.PopNextReadyStream());
+  EXPECT_EQ(1u, scheduler.PopNextReadyStream());
+  EXPECT_EQ(3u, scheduler.PopNextReadyStream());
+  EXPECT_FALSE(scheduler.HasReadyStreams());
+}
+
+// Unlike WriteBlockedList, marking a stream ready again has no effect.
+TEST(SpdyWriteSchedulerTest, MarkStreamReadyTwice) {
+  IntWriteScheduler scheduler;
+  scheduler.MarkStreamReady(1, 3);
+  scheduler.MarkStreamReady(2, 3);
+  scheduler.MarkStreamReady(1, 3);
+  EXPECT_EQ(2u, scheduler.NumReadyStreams());
+  EXPECT_EQ(1u, scheduler.PopNextReadyStream());
+  EXPECT_EQ(2u, scheduler.PopNextReadyStream());
+  EXPECT_FALSE(scheduler.HasReadyStreams());
+}
+
+// Streams of the same priority share by the bytes they write.
+TEST(SpdyWriteSchedulerTest, SamePriorityShares) {
+  IntWriteScheduler scheduler;
+  scheduler.MarkStreamReady(1, 3);
+  scheduler.MarkStreamReady(2, 3);
+
+  EXPECT_EQ(1u, scheduler.GetNextReadyStream());
+  scheduler.RecordBytesWritten(1, 16000);
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(2u, scheduler.GetNextReadyStream());
+    scheduler.RecordBytesWritten(2, 1000);
+  }
+  EXPECT_EQ(1u, scheduler.GetNextReadyStream());
+}
+
+TEST(SpdyWriteSchedulerTest, SetStreamDependency) {
+  IntWriteScheduler scheduler;
+  scheduler.MarkStreamReady(1, 3);
+  scheduler.MarkStreamReady(2, 3);
+  scheduler.MarkStreamReady(3, 5);
+
+  // Stream 1 must wait for stream 2.
+  EXPECT_TRUE(scheduler.SetStreamDependency(1, 2, 16, false));
+  EXPECT_EQ(2u, scheduler.PopNextReadyStream());
+  EXPECT_EQ(1u, scheduler.PopNextReadyStream());
+
+  // Dependencies don't cross priorities, and need known streams.
+  EXPECT_FALSE(scheduler.SetStreamDependency(3, 1, 16, false));
+  EXPECT_FALSE(scheduler.SetStreamDependency(4, 1, 16, false));
+  EXPECT_FALSE(scheduler.SetStreamDependency(1, 1, 16, false));
+  EXPECT_FALSE(scheduler.SetStreamDependency(1, 0, 0, false));
+  EXPECT_TRUE(scheduler.SetStreamDependency(1, 0, 16, false));
+}
+
+TEST(SpdyWriteSchedulerTest, UnregisterStream) {
+  IntWriteScheduler scheduler;
+  scheduler.MarkStreamReady(1, 3);
+  scheduler.MarkStreamReady(2, 3);
+  scheduler.UnregisterStream(1);
+  scheduler.UnregisterStream(1);
+  EXPECT_FALSE(scheduler.IsStreamReady(1));
+  EXPECT_EQ(1u, scheduler.NumReadyStreams());
+  EXPECT_EQ(2u, scheduler.PopNextReadyStream());
+
+  // Unknown streams are ignored.
+  scheduler.MarkStreamNotReady(1);
+  scheduler.RecordBytesWritten(1, 1000);
+  EXPECT_FALSE(scheduler.HasReadyStreams());
+}
+
+// A stream marked ready at a new priority moves there.
+TEST(SpdyWriteSchedulerTest, ChangePriority) {
+  IntWriteScheduler scheduler;
+  scheduler.MarkStreamReady(1, 3);
+  scheduler.MarkStreamReady(2, 2);
+  scheduler.MarkStreamReady(1, 1);
+  EXPECT_EQ(2u, scheduler.NumReadyStreams());
+  EXPECT_EQ(1, scheduler.GetHighestReadyPriority());
+  EXPECT_EQ(1u, scheduler.PopNextReadyStream());
+  EXPECT_EQ(2u, scheduler.PopNextReadyStream());
+
+  scheduler.MarkStreamReady(3, 2);
+  scheduler.Clear();
+  EXPECT_FALSE(scheduler.HasReadyStreams());
+  EXPECT_FALSE(scheduler.IsStreamReady(3));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
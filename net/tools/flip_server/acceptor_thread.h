@@ -5,6 +5,8 @@
 #ifndef NET_TOOLS_FLIP_SERVER_ACCEPTOR_THREAD_H_
 #define NET_TOOLS_FLIP_SERVER_ACCEPTOR_THREAD_H_
 
+#include <time.h>
+
 #include <list>
 #include <string>
 #include <vector>
@@ -46,7 +48,13 @@ class SMAcceptorThread : public base::SimpleThread,
                          public EpollCallbackInterface,
                          public SMConnectionPoolInterface {
  public:
-  SMAcceptorThread(FlipAcceptor* acceptor, MemoryCache* memory_cache);
+  // Accepts the connections of |acceptor| from |listen_fd|, which is either
+  // the acceptor's own socket, shared with its other threads, or a socket of
+  // the thread's own bound to the same address with SO_REUSEPORT. Several
+  // threads may share |memory_cache|, which they only read.
+  SMAcceptorThread(FlipAcceptor* acceptor,
+                   int listen_fd,
+                   MemoryCache* memory_cache);
   virtual ~SMAcceptorThread();
 
   // EpollCallbackInteface interface
@@ -80,6 +88,7 @@ class SMAcceptorThread : public base::SimpleThread,
  private:
   EpollServer epoll_server_;
   FlipAcceptor* acceptor_;
+  int listen_fd_;
   SSLState* ssl_state_;
   bool use_ssl_;
   int idle_socket_timeout_s_;
@@ -88,6 +97,9 @@ class SMAcceptorThread : public base::SimpleThread,
   std::vector<SMConnection*> tmp_unused_server_connections_;
   std::vector<SMConnection*> allocated_server_connections_;
   std::list<SMConnection*> active_server_connections_;
+  // The oldest last read time of the active connections, as of the last
+  // time they were checked for having been idle for too long.
+  time_t oldest_connection_time_;
   Notification quitting_;
   MemoryCache* memory_cache_;
 };
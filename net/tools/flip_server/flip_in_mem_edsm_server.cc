@@ -18,6 +18,7 @@
 #include "net/tools/balsa/split.h"
 #include "net/tools/flip_server/acceptor_thread.h"
 #include "net/tools/flip_server/constants.h"
+#include "net/tools/flip_server/create_listener.h"
 #include "net/tools/flip_server/flip_config.h"
 #include "net/tools/flip_server/output_ordering.h"
 #include "net/tools/flip_server/sm_connection.h"
@@ -43,6 +44,10 @@ int32 FLAGS_accept_backlog_size = 1024;
 //  SO_REUSEPORT);
 bool FLAGS_reuseport = false;
 
+// The number of threads accepting and serving the connections of each
+//  acceptor. Without --reuseport they all accept from its one socket.
+int32 FLAGS_threads_per_acceptor = 1;
+
 // Flag to force spdy, even if NPN is not negotiated.
 bool FLAGS_force_spdy = false;
 
@@ -198,6 +203,11 @@ int main(int argc, char** argv) {
         "\t--ssl-session-expiry=<seconds> (default is 300)\n"
         "\t--ssl-disable-compression\n"
         "\t--idle-timeout=<seconds> (default is 300)\n"
+        "\t--threads-per-acceptor=<n> (default is 1)\n"
+        "\t--reuseport\n"
+        "\t  * Each of the threads of an acceptor listens on a socket of its"
+        " own,\n"
+        "\t    so that the kernel spreads the connections over them.\n"
         "\t--pidfile=<filepath> (default /var/run/flip-server.pid)\n"
         "\t--help\n");
     exit(0);
@@ -260,6 +270,16 @@ int main(int argc, char** argv) {
         atoi(cl.GetSwitchValueASCII("idle-timeout").c_str());
   }
 
+  if (cl.HasSwitch("threads-per-acceptor")) {
+    FLAGS_threads_per_acceptor =
+        atoi(cl.GetSwitchValueASCII("threads-per-acceptor").c_str());
+    if (FLAGS_threads_per_acceptor < 1)
+      FLAGS_threads_per_acceptor = 1;
+  }
+
+  if (cl.HasSwitch("reuseport"))
+    FLAGS_reuseport = true;
+
   if (cl.HasSwitch("force_spdy"))
     net::SMConnection::set_force_spdy(true);
 
@@ -284,6 +304,7 @@ int main(int argc, char** argv) {
                                                                     : "false");
   LOG(INFO) << "Reuseport               : " << (FLAGS_reuseport ? "true"
                                                                 : "false");
+  LOG(INFO) << "Threads per acceptor    : " << FLAGS_threads_per_acceptor;
   LOG(INFO) << "Force SPDY              : " << (FLAGS_force_spdy ? "true"
                                                                  : "false");
   LOG(INFO) << "SSL session expiry      : "
@@ -382,18 +403,36 @@ int main(int argc, char** argv) {
   for (i = 0; i < g_proxy_config.acceptors_.size(); i++) {
     net::FlipAcceptor* acceptor = g_proxy_config.acceptors_[i];
 
-    sm_worker_threads_.push_back(new net::SMAcceptorThread(
-        acceptor, (net::MemoryCache*)acceptor->memory_cache_));
-    // Note that spdy_memory_cache is not threadsafe, it is merely
-    // thread compatible. Thus, if ever we are to spawn multiple threads,
-    // we either must make the MemoryCache threadsafe, or use
-    // a separate MemoryCache for each thread.
-    //
-    // The latter is what is currently being done as we spawn
-    // a separate thread for each http and spdy server acceptor.
-
-    sm_worker_threads_.back()->InitWorker();
-    sm_worker_threads_.back()->Start();
+    for (int thread = 0; thread < FLAGS_threads_per_acceptor; ++thread) {
+      int listen_fd = acceptor->listen_fd_;
+      // The acceptor's socket was bound with SO_REUSEPORT too, so the other
+      // threads can bind sockets of their own to its address.
+      if (FLAGS_reuseport && thread > 0) {
+        if (net::CreateListeningSocket(acceptor->listen_ip_,
+                                       acceptor->listen_port_,
+                                       true,
+                                       acceptor->accept_backlog_size_,
+                                       true,
+                                       true,
+                                       wait_for_iface,
+                                       acceptor->disable_nagle_,
+                                       &listen_fd) != 0) {
+          LOG(ERROR) << "Unable to create listening socket for thread "
+                     << thread << " of " << acceptor->listen_ip_ << ":"
+                     << acceptor->listen_port_;
+          listen_fd = acceptor->listen_fd_;
+        } else {
+          net::FlipSetNonBlocking(listen_fd);
+        }
+      }
+
+      // The memory caches are filled before the threads start and are only
+      // read from then on, so all the threads of an acceptor share its cache.
+      sm_worker_threads_.push_back(new net::SMAcceptorThread(
+          acceptor, listen_fd, (net::MemoryCache*)acceptor->memory_cache_));
+      sm_worker_threads_.back()->InitWorker();
+      sm_worker_threads_.back()->Start();
+    }
   }
 
   while (!wantExit) {
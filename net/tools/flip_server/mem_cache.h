@@ -109,6 +109,9 @@ class MemCacheIter {
   size_t bytes_sent;
 };
 
+// Holds the responses the SPDY and HTTP servers serve. The files are loaded
+// by AddFiles() before the acceptor threads start; after that the cache is
+// only read, so the threads of an acceptor all share one.
 class MemoryCache {
  public:
   typedef std::map<std::string, FileData*> Files;
@@ -0,0 +1,113 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <errno.h>
+
+#include <vector>
+
+#include "base/logging.h"
+#include "net/tools/quic/quic_socket_utils.h"
+
+namespace net {
+namespace tools {
+
+const size_t QuicBatchPacketWriter::kMaxBufferedPackets = 16;
+
+QuicBatchPacketWriter::BufferedPacket::BufferedPacket(
+    const char* buffer,
+    size_t buf_len,
+    const IPAddressNumber& self_address,
+    const IPEndPoint& peer_address)
+    : data(buffer, buf_len),
+      self_address(self_address),
+      peer_address(peer_address) {}
+
+QuicBatchPacketWriter::BufferedPacket::~BufferedPacket() {}
+
+QuicBatchPacketWriter::QuicBatchPacketWriter(int fd)
+    : fd_(fd),
+      write_blocked_(false) {}
+
+QuicBatchPacketWriter::~QuicBatchPacketWriter() {}
+
+WriteResult QuicBatchPacketWriter::WritePacket(
+    const char* buffer, size_t buf_len,
+    const net::IPAddressNumber& self_address,
+    const net::IPEndPoint& peer_address) {
+  DCHECK(!IsWriteBlocked());
+  if (buffered_packets_.size() >= kMaxBufferedPackets) {
+    // The caller keeps the packet if the socket is blocked.
+    WriteResult result = Flush();
+    if (result.status != WRITE_STATUS_OK)
+      return result;
+  }
+
+  buffered_packets_.push_back(
+      BufferedPacket(buffer, buf_len, self_address, peer_address));
+  return WriteResult(WRITE_STATUS_OK, buf_len);
+}
+
+bool QuicBatchPacketWriter::IsWriteBlockedDataBuffered() const {
+  return false;
+}
+
+bool QuicBatchPacketWriter::IsWriteBlocked() const {
+  return write_blocked_;
+}
+
+void QuicBatchPacketWriter::SetWritable() {
+  write_blocked_ = false;
+}
+
+bool QuicBatchPacketWriter::IsBatchMode() const {
+  return true;
+}
+
+WriteResult QuicBatchPacketWriter::Flush() {
+  if (buffered_packets_.empty())
+    return WriteResult(WRITE_STATUS_OK, 0);
+  if (write_blocked_)
+    return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+
+  std::vector<QuicSocketUtils::PacketToWrite> packets(
+      buffered_packets_.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const BufferedPacket& buffered_packet = buffered_packets_[i];
+    packets[i].buffer = buffered_packet.data.data();
+    packets[i].buf_len = buffered_packet.data.size();
+    packets[i].self_address = buffered_packet.self_address;
+    packets[i].peer_address = buffered_packet.peer_address;
+  }
+
+  int bytes_written = 0;
+  size_t packets_sent = 0;
+  while (packets_sent < packets.size()) {
+    size_t packets_written = 0;
+    WriteResult result = QuicSocketUtils::WritePackets(
+        fd_, &packets[packets_sent], packets.size() - packets_sent,
+        &packets_written);
+    packets_sent += packets_written;
+    if (result.status == WRITE_STATUS_BLOCKED) {
+      write_blocked_ = true;
+      buffered_packets_.erase(buffered_packets_.begin(),
+                              buffered_packets_.begin() + packets_sent);
+      return result;
+    }
+    if (result.status == WRITE_STATUS_ERROR) {
+      // The packets were reported as written already; like a packet whose
+      // write fails, they are lost.
+      buffered_packets_.clear();
+      return result;
+    }
+    bytes_written += result.bytes_written;
+  }
+
+  buffered_packets_.clear();
+  return WriteResult(WRITE_STATUS_OK, bytes_written);
+}
+
+}  // namespace tools
+}  // namespace net
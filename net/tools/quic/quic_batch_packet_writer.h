@@ -0,0 +1,67 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+
+#include <deque>
+#include <string>
+
+#include "base/basictypes.h"
+#include "net/base/ip_endpoint.h"
+#include "net/quic/quic_packet_writer.h"
+
+namespace net {
+
+struct WriteResult;
+
+namespace tools {
+
+// Packet writer which holds the packets it is given until it is flushed, and
+// then sends them together with QuicSocketUtils WritePackets.
+class QuicBatchPacketWriter : public QuicPacketWriter {
+ public:
+  // The most packets held at once.  Writing one more flushes the others.
+  static const size_t kMaxBufferedPackets;
+
+  explicit QuicBatchPacketWriter(int fd);
+  virtual ~QuicBatchPacketWriter();
+
+  // QuicPacketWriter
+  virtual WriteResult WritePacket(
+      const char* buffer, size_t buf_len,
+      const net::IPAddressNumber& self_address,
+      const net::IPEndPoint& peer_address) OVERRIDE;
+  virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
+  virtual bool IsWriteBlocked() const OVERRIDE;
+  virtual void SetWritable() OVERRIDE;
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
+
+  size_t buffered_packet_count() const { return buffered_packets_.size(); }
+
+ private:
+  struct BufferedPacket {
+    BufferedPacket(const char* buffer,
+                   size_t buf_len,
+                   const IPAddressNumber& self_address,
+                   const IPEndPoint& peer_address);
+    ~BufferedPacket();
+
+    std::string data;
+    IPAddressNumber self_address;
+    IPEndPoint peer_address;
+  };
+
+  int fd_;
+  bool write_blocked_;
+  std::deque<BufferedPacket> buffered_packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBatchPacketWriter);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
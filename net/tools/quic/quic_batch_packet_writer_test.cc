@@ -0,0 +1,149 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_util.h"
+#include "net/quic/quic_protocol.h"
+#include "net/tools/quic/quic_socket_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace tools {
+namespace test {
+namespace {
+
+class QuicBatchPacketWriterTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(ParseIPLiteralToNumber("127.0.0.1", &loopback_));
+
+    send_fd_ = CreateSocket(&send_address_);
+    receive_fd_ = CreateSocket(&receive_address_);
+    ASSERT_NE(-1, send_fd_);
+    ASSERT_NE(-1, receive_fd_);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    close(send_fd_);
+    close(receive_fd_);
+  }
+
+  // Returns a non-blocking UDP socket bound to a port of the loopback
+  // address, and sets |address| to the address it is bound to.
+  int CreateSocket(IPEndPoint* address) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    if (fd < 0)
+      return -1;
+    if (QuicSocketUtils::SetGetAddressInfo(fd, AF_INET) != 0)
+      return -1;
+
+    IPEndPoint any_port(loopback_, 0);
+    sockaddr_storage raw_address;
+    socklen_t address_len = sizeof(raw_address);
+    any_port.ToSockAddr(reinterpret_cast<sockaddr*>(&raw_address),
+                        &address_len);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&raw_address), address_len) != 0)
+      return -1;
+
+    address_len = sizeof(raw_address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&raw_address),
+                    &address_len) != 0 ||
+        !address->FromSockAddr(reinterpret_cast<sockaddr*>(&raw_address),
+                               address_len)) {
+      return -1;
+    }
+    return fd;
+  }
+
+  // Reads all the packets available on |receive_fd_|.
+  std::vector<std::string> ReadPackets() {
+    std::vector<std::string> result;
+    char buffers[4][kMaxPacketSize];
+    QuicSocketUtils::PacketToRead packets[4];
+    for (size_t i = 0; i < arraysize(packets); ++i) {
+      packets[i].buffer = buffers[i];
+      packets[i].buf_len = arraysize(buffers[i]);
+    }
+
+    int packets_read;
+    while ((packets_read = QuicSocketUtils::ReadPackets(
+                receive_fd_, packets, arraysize(packets), NULL)) > 0) {
+      for (int i = 0; i < packets_read; ++i) {
+        EXPECT_EQ(send_address_, packets[i].peer_address);
+        EXPECT_EQ(loopback_, packets[i].self_address);
+        result.push_back(
+            std::string(packets[i].buffer, packets[i].bytes_read));
+      }
+    }
+    return result;
+  }
+
+  IPAddressNumber loopback_;
+  int send_fd_;
+  int receive_fd_;
+  IPEndPoint send_address_;
+  IPEndPoint receive_address_;
+};
+
+TEST_F(QuicBatchPacketWriterTest, HoldsPacketsUntilFlushed) {
+  QuicBatchPacketWriter writer(send_fd_);
+  EXPECT_TRUE(writer.IsBatchMode());
+
+  for (int i = 0; i < 3; ++i) {
+    std::string packet = "packet " + base::IntToString(i);
+    WriteResult result = writer.WritePacket(packet.data(), packet.size(),
+                                            loopback_, receive_address_);
+    EXPECT_EQ(WRITE_STATUS_OK, result.status);
+    EXPECT_EQ(static_cast<int>(packet.size()), result.bytes_written);
+  }
+  EXPECT_EQ(3u, writer.buffered_packet_count());
+  EXPECT_TRUE(ReadPackets().empty());
+
+  WriteResult result = writer.Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(24, result.bytes_written);
+  EXPECT_EQ(0u, writer.buffered_packet_count());
+
+  std::vector<std::string> packets = ReadPackets();
+  ASSERT_EQ(3u, packets.size());
+  EXPECT_EQ("packet 0", packets[0]);
+  EXPECT_EQ("packet 1", packets[1]);
+  EXPECT_EQ("packet 2", packets[2]);
+}
+
+TEST_F(QuicBatchPacketWriterTest, FlushesWhenFull) {
+  QuicBatchPacketWriter writer(send_fd_);
+  std::string packet = "data";
+  for (size_t i = 0; i < QuicBatchPacketWriter::kMaxBufferedPackets + 1; ++i) {
+    EXPECT_EQ(WRITE_STATUS_OK,
+              writer.WritePacket(packet.data(), packet.size(), loopback_,
+                                 receive_address_).status);
+  }
+  EXPECT_EQ(1u, writer.buffered_packet_count());
+  EXPECT_EQ(QuicBatchPacketWriter::kMaxBufferedPackets, ReadPackets().size());
+
+  EXPECT_EQ(WRITE_STATUS_OK, writer.Flush().status);
+  EXPECT_EQ(1u, ReadPackets().size());
+}
+
+TEST_F(QuicBatchPacketWriterTest, FlushWithoutPackets) {
+  QuicBatchPacketWriter writer(send_fd_);
+  WriteResult result = writer.Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(0, result.bytes_written);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace tools
+}  // namespace net
@@ -11,8 +11,10 @@
 #include "base/stl_util.h"
 #include "net/quic/quic_blocked_writer_interface.h"
 #include "net/quic/quic_utils.h"
+#include "net/tools/quic/quic_batch_packet_writer.h"
 #include "net/tools/quic/quic_default_packet_writer.h"
 #include "net/tools/quic/quic_epoll_connection_helper.h"
+#include "net/tools/quic/quic_guid_router.h"
 #include "net/tools/quic/quic_packet_writer_wrapper.h"
 #include "net/tools/quic/quic_socket_utils.h"
 
@@ -143,7 +145,9 @@ QuicDispatcher::QuicDispatcher(const QuicConfig& config,
       supported_versions_(supported_versions),
       current_packet_(NULL),
       framer_(supported_versions, /*unused*/ QuicTime::Zero(), true),
-      framer_visitor_(new QuicFramerVisitor(this)) {
+      framer_visitor_(new QuicFramerVisitor(this)),
+      guid_router_(NULL),
+      guid_router_owner_(0) {
   framer_.set_visitor(framer_visitor_.get());
 }
 
@@ -181,6 +185,15 @@ bool QuicDispatcher::OnUnauthenticatedPublicHeader(
   QuicGuid guid = header.guid;
   SessionMap::iterator it = session_map_.find(guid);
   if (it == session_map_.end()) {
+    // The client may have moved to an address which the kernel maps to this
+    // dispatcher's socket rather than to that of the session's owner.
+    size_t owner;
+    if (guid_router_ != NULL && guid_router_->FindOwner(guid, &owner) &&
+        owner != guid_router_owner_) {
+      guid_router_->ForwardPacket(owner, current_server_address_,
+                                  current_client_address_, *current_packet_);
+      return false;
+    }
     if (header.reset_flag) {
       return false;
     }
@@ -215,6 +228,9 @@ bool QuicDispatcher::OnUnauthenticatedPublicHeader(
     }
     DVLOG(1) << "Created new session for " << guid;
     session_map_.insert(make_pair(guid, session));
+    if (guid_router_ != NULL) {
+      guid_router_->AddGuid(guid, guid_router_owner_);
+    }
   } else {
     session = it->second;
   }
@@ -239,6 +255,9 @@ void QuicDispatcher::CleanUpSession(SessionMap::iterator it) {
   QuicEncryptedPacket* connection_close_packet =
           connection->ReleaseConnectionClosePacket();
   write_blocked_list_.erase(connection);
+  if (guid_router_ != NULL) {
+    guid_router_->RemoveGuid(it->first);
+  }
   time_wait_list_manager_->AddGuidToTimeWait(it->first,
                                              connection->version(),
                                              connection_close_packet);
@@ -253,6 +272,10 @@ void QuicDispatcher::OnCanWrite() {
   // We got an EPOLLOUT: the socket should not be blocked.
   writer_->SetWritable();
 
+  // Send the packets a writer in batch mode kept when it became blocked.
+  if (writer_->Flush().status == WRITE_STATUS_BLOCKED)
+    return;
+
   // Give each writer one attempt to write.
   int num_writers = write_blocked_list_.size();
   for (int i = 0; i < num_writers; ++i) {
@@ -312,6 +335,8 @@ void QuicDispatcher::OnWriteBlocked(QuicBlockedWriterInterface* writer) {
 }
 
 QuicPacketWriter* QuicDispatcher::CreateWriter(int fd) {
+  if (FLAGS_quic_batch_io)
+    return new QuicBatchPacketWriter(fd);
   return new QuicDefaultPacketWriter(fd);
 }
 
@@ -43,6 +43,7 @@ class QuicSession;
 
 namespace tools {
 
+class QuicGuidRouter;
 class QuicPacketWriterWrapper;
 
 namespace test {
@@ -100,6 +101,15 @@ class QuicDispatcher : public QuicServerSessionVisitor {
 
   WriteBlockedList* write_blocked_list() { return &write_blocked_list_; }
 
+  // Shares the connections of this dispatcher with the other dispatchers
+  // using |router|, as the dispatcher with index |owner|.  Packets for a GUID
+  // owned by another dispatcher are forwarded to it.  |router| is not owned
+  // and must outlive the dispatcher.
+  void set_guid_router(QuicGuidRouter* router, size_t owner) {
+    guid_router_ = router;
+    guid_router_owner_ = owner;
+  }
+
  protected:
   // Instantiates a new low-level packet writer. Caller takes ownership of the
   // returned object.
@@ -207,6 +217,11 @@ class QuicDispatcher : public QuicServerSessionVisitor {
   QuicFramer framer_;
   scoped_ptr<QuicFramerVisitor> framer_visitor_;
 
+  // Routes packets to the dispatcher which owns their GUID, if this is one of
+  // several dispatchers.  Not owned.
+  QuicGuidRouter* guid_router_;
+  size_t guid_router_owner_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicDispatcher);
 };
 
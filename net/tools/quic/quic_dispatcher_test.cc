@@ -14,6 +14,7 @@
 #include "net/quic/quic_utils.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 #include "net/tools/epoll_server/epoll_server.h"
+#include "net/tools/quic/quic_guid_router.h"
 #include "net/tools/quic/quic_packet_writer_wrapper.h"
 #include "net/tools/quic/quic_time_wait_list_manager.h"
 #include "net/tools/quic/test_tools/quic_dispatcher_peer.h"
@@ -200,6 +201,36 @@ TEST_F(QuicDispatcherTest, Shutdown) {
   dispatcher_.Shutdown();
 }
 
+TEST_F(QuicDispatcherTest, ForwardsPacketsForOtherOwners) {
+  QuicGuidRouter router(2);
+  dispatcher_.set_guid_router(&router, 0);
+  IPEndPoint addr(net::test::Loopback4(), 1);
+
+  // A session this dispatcher creates is registered as its own.
+  EXPECT_CALL(dispatcher_, CreateQuicSession(1, _, addr))
+      .WillOnce(testing::Return(CreateSession(
+          &dispatcher_, 1, addr, &session1_)));
+  ProcessPacket(addr, 1, true, "foo");
+  size_t owner = 1;
+  EXPECT_TRUE(router.FindOwner(1, &owner));
+  EXPECT_EQ(0u, owner);
+
+  // Packets for another dispatcher's connection are handed to it, even ones
+  // which could start a new session.
+  router.AddGuid(2, 1);
+  EXPECT_CALL(dispatcher_, CreateQuicSession(2, _, _)).Times(0);
+  ProcessPacket(addr, 2, false, "bar");
+  ProcessPacket(addr, 2, true, "baz");
+  EXPECT_EQ(2u, router.NumForwardedPackets(1));
+  EXPECT_EQ(0u, router.NumForwardedPackets(0));
+
+  // Closing the session releases its GUID.
+  EXPECT_CALL(*reinterpret_cast<MockConnection*>(session1_->connection()),
+              SendConnectionClose(QUIC_PEER_GOING_AWAY));
+  dispatcher_.Shutdown();
+  EXPECT_FALSE(router.FindOwner(1, &owner));
+}
+
 class MockTimeWaitListManager : public QuicTimeWaitListManager {
  public:
   MockTimeWaitListManager(QuicPacketWriter* writer,
@@ -0,0 +1,98 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_guid_router.h"
+
+#include "base/logging.h"
+#include "net/tools/epoll_server/epoll_server.h"
+#include "net/tools/quic/quic_dispatcher.h"
+
+namespace net {
+namespace tools {
+
+QuicGuidRouter::Owner::Owner() : epoll_server(NULL) {
+}
+
+QuicGuidRouter::QuicGuidRouter(size_t num_owners)
+    : owners_(num_owners) {
+}
+
+QuicGuidRouter::~QuicGuidRouter() {
+  for (size_t i = 0; i < owners_.size(); ++i) {
+    for (size_t j = 0; j < owners_[i].packets.size(); ++j) {
+      delete owners_[i].packets[j].packet;
+    }
+  }
+}
+
+void QuicGuidRouter::SetEpollServer(size_t owner, EpollServer* epoll_server) {
+  base::AutoLock lock(lock_);
+  DCHECK_LT(owner, owners_.size());
+  owners_[owner].epoll_server = epoll_server;
+}
+
+bool QuicGuidRouter::FindOwner(QuicGuid guid, size_t* owner) const {
+  base::AutoLock lock(lock_);
+  OwnerMap::const_iterator it = owner_map_.find(guid);
+  if (it == owner_map_.end()) {
+    return false;
+  }
+  *owner = it->second;
+  return true;
+}
+
+void QuicGuidRouter::AddGuid(QuicGuid guid, size_t owner) {
+  base::AutoLock lock(lock_);
+  DCHECK_LT(owner, owners_.size());
+  owner_map_[guid] = owner;
+}
+
+void QuicGuidRouter::RemoveGuid(QuicGuid guid) {
+  base::AutoLock lock(lock_);
+  owner_map_.erase(guid);
+}
+
+void QuicGuidRouter::ForwardPacket(size_t owner,
+                                   const IPEndPoint& server_address,
+                                   const IPEndPoint& client_address,
+                                   const QuicEncryptedPacket& packet) {
+  ForwardedPacket forwarded;
+  forwarded.server_address = server_address;
+  forwarded.client_address = client_address;
+  forwarded.packet = packet.Clone();
+
+  base::AutoLock lock(lock_);
+  DCHECK_LT(owner, owners_.size());
+  owners_[owner].packets.push_back(forwarded);
+  // The owner clears its epoll server under the lock before destroying it.
+  if (owners_[owner].epoll_server != NULL) {
+    owners_[owner].epoll_server->Wake();
+  }
+}
+
+void QuicGuidRouter::DispatchForwardedPackets(size_t owner,
+                                              QuicDispatcher* dispatcher) {
+  ForwardedPacketList packets;
+  {
+    base::AutoLock lock(lock_);
+    DCHECK_LT(owner, owners_.size());
+    packets.swap(owners_[owner].packets);
+  }
+
+  for (size_t i = 0; i < packets.size(); ++i) {
+    dispatcher->ProcessPacket(packets[i].server_address,
+                              packets[i].client_address,
+                              *packets[i].packet);
+    delete packets[i].packet;
+  }
+}
+
+size_t QuicGuidRouter::NumForwardedPackets(size_t owner) const {
+  base::AutoLock lock(lock_);
+  DCHECK_LT(owner, owners_.size());
+  return owners_[owner].packets.size();
+}
+
+}  // namespace tools
+}  // namespace net
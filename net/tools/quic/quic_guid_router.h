@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Routes packets between the dispatchers of a server which runs one
+// dispatcher per thread.  Each dispatcher has its own SO_REUSEPORT socket, and
+// the kernel picks the socket for a packet from its 4-tuple, so a client whose
+// address changes may reach a dispatcher which does not own its connection.
+// The router records which dispatcher owns each GUID so that such packets can
+// be handed to the owner.
+
+#ifndef NET_TOOLS_QUIC_QUIC_GUID_ROUTER_H_
+#define NET_TOOLS_QUIC_QUIC_GUID_ROUTER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/synchronization/lock.h"
+#include "net/base/ip_endpoint.h"
+#include "net/quic/quic_protocol.h"
+
+namespace net {
+
+class EpollServer;
+
+namespace tools {
+
+class QuicDispatcher;
+
+// All methods may be called from any thread.
+class QuicGuidRouter {
+ public:
+  // |num_owners| is the number of dispatchers, which are identified by an
+  // index in [0, num_owners).
+  explicit QuicGuidRouter(size_t num_owners);
+  ~QuicGuidRouter();
+
+  // Sets the epoll server to wake when a packet is forwarded to |owner|.
+  void SetEpollServer(size_t owner, EpollServer* epoll_server);
+
+  // Returns true and sets |owner| if some dispatcher owns |guid|.
+  bool FindOwner(QuicGuid guid, size_t* owner) const;
+
+  // Records that |owner| owns |guid|.
+  void AddGuid(QuicGuid guid, size_t owner);
+
+  // Forgets the owner of |guid|.
+  void RemoveGuid(QuicGuid guid);
+
+  // Queues a copy of |packet| for |owner|, and wakes its epoll server.
+  void ForwardPacket(size_t owner,
+                     const IPEndPoint& server_address,
+                     const IPEndPoint& client_address,
+                     const QuicEncryptedPacket& packet);
+
+  // Passes the packets queued for |owner| to |dispatcher|.  Must be called on
+  // the thread of |owner|.
+  void DispatchForwardedPackets(size_t owner, QuicDispatcher* dispatcher);
+
+  // Returns the number of packets queued for |owner|.
+  size_t NumForwardedPackets(size_t owner) const;
+
+ private:
+  struct ForwardedPacket {
+    IPEndPoint server_address;
+    IPEndPoint client_address;
+    QuicEncryptedPacket* packet;  // Owned.
+  };
+
+  typedef base::hash_map<QuicGuid, size_t> OwnerMap;
+  typedef std::vector<ForwardedPacket> ForwardedPacketList;
+
+  struct Owner {
+    Owner();
+
+    EpollServer* epoll_server;  // Not owned.
+    ForwardedPacketList packets;
+  };
+
+  // Protects all of the members below.
+  mutable base::Lock lock_;
+
+  OwnerMap owner_map_;
+  std::vector<Owner> owners_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicGuidRouter);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_GUID_ROUTER_H_
@@ -0,0 +1,66 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_guid_router.h"
+
+#include "net/quic/crypto/quic_crypto_server_config.h"
+#include "net/quic/crypto/quic_random.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+#include "net/tools/epoll_server/epoll_server.h"
+#include "net/tools/quic/test_tools/mock_quic_dispatcher.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using testing::_;
+
+namespace net {
+namespace tools {
+namespace test {
+namespace {
+
+TEST(QuicGuidRouterTest, FindOwner) {
+  QuicGuidRouter router(2);
+  size_t owner = 0;
+  EXPECT_FALSE(router.FindOwner(1, &owner));
+
+  router.AddGuid(1, 1);
+  router.AddGuid(2, 0);
+  EXPECT_TRUE(router.FindOwner(1, &owner));
+  EXPECT_EQ(1u, owner);
+  EXPECT_TRUE(router.FindOwner(2, &owner));
+  EXPECT_EQ(0u, owner);
+
+  router.RemoveGuid(1);
+  EXPECT_FALSE(router.FindOwner(1, &owner));
+  EXPECT_TRUE(router.FindOwner(2, &owner));
+}
+
+TEST(QuicGuidRouterTest, DispatchForwardedPackets) {
+  QuicConfig config;
+  QuicCryptoServerConfig crypto_config("blah", QuicRandom::GetInstance());
+  EpollServer eps;
+  MockQuicDispatcher dispatcher(config, crypto_config, &eps);
+
+  QuicGuidRouter router(2);
+  router.SetEpollServer(1, &eps);
+
+  IPEndPoint server_address(net::test::Loopback4(), 443);
+  IPEndPoint client_address(net::test::Loopback4(), 1);
+  char data[] = "packet";
+  QuicEncryptedPacket packet(data, arraysize(data));
+  router.ForwardPacket(1, server_address, client_address, packet);
+  router.ForwardPacket(1, server_address, client_address, packet);
+  EXPECT_EQ(0u, router.NumForwardedPackets(0));
+  EXPECT_EQ(2u, router.NumForwardedPackets(1));
+
+  EXPECT_CALL(dispatcher, ProcessPacket(server_address, client_address, _))
+      .Times(2);
+  router.DispatchForwardedPackets(1, &dispatcher);
+  EXPECT_EQ(0u, router.NumForwardedPackets(1));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace tools
+}  // namespace net
@@ -0,0 +1,119 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_multi_threaded_server.h"
+
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/synchronization/cancellation_flag.h"
+#include "base/threading/simple_thread.h"
+#include "net/tools/quic/quic_server.h"
+
+namespace net {
+namespace tools {
+
+// Runs the event loop of one server until it is told to quit.
+class QuicMultiThreadedServer::ServerThread : public base::SimpleThread {
+ public:
+  explicit ServerThread(QuicServer* server)
+      : SimpleThread("quic_server_thread"),
+        server_(server) {
+  }
+
+  virtual void Run() OVERRIDE {
+    while (!quit_.IsSet()) {
+      server_->WaitForEvents();
+    }
+    server_->Shutdown();
+  }
+
+  // The thread notices within one epoll timeout.
+  void Quit() { quit_.Set(); }
+
+ private:
+  QuicServer* server_;
+  base::CancellationFlag quit_;
+
+  DISALLOW_COPY_AND_ASSIGN(ServerThread);
+};
+
+QuicMultiThreadedServer::QuicMultiThreadedServer(size_t num_threads)
+    : guid_router_(num_threads) {
+  DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i) {
+    servers_.push_back(new QuicServer());
+  }
+  Initialize();
+}
+
+QuicMultiThreadedServer::QuicMultiThreadedServer(
+    size_t num_threads,
+    const QuicConfig& config,
+    const QuicVersionVector& supported_versions)
+    : guid_router_(num_threads) {
+  DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i) {
+    servers_.push_back(new QuicServer(config, supported_versions));
+  }
+  Initialize();
+}
+
+void QuicMultiThreadedServer::Initialize() {
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    servers_[i]->SetGuidRouter(&guid_router_, i);
+  }
+}
+
+QuicMultiThreadedServer::~QuicMultiThreadedServer() {
+  DCHECK(threads_.empty());
+  STLDeleteElements(&servers_);
+}
+
+bool QuicMultiThreadedServer::Listen(const IPEndPoint& address) {
+  if (!servers_[0]->Listen(address)) {
+    return false;
+  }
+  // If the kernel picked the port, the other servers have to share it.
+  IPEndPoint shared_address(address.address(), servers_[0]->port());
+  for (size_t i = 1; i < servers_.size(); ++i) {
+    if (!servers_[i]->Listen(shared_address)) {
+      return false;
+    }
+  }
+
+  for (size_t i = 1; i < servers_.size(); ++i) {
+    ServerThread* thread = new ServerThread(servers_[i]);
+    thread->Start();
+    threads_.push_back(thread);
+  }
+  return true;
+}
+
+void QuicMultiThreadedServer::WaitForEvents() {
+  servers_[0]->WaitForEvents();
+}
+
+void QuicMultiThreadedServer::Shutdown() {
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->Quit();
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i]->Join();
+  }
+  STLDeleteElements(&threads_);
+  servers_[0]->Shutdown();
+}
+
+void QuicMultiThreadedServer::SetStrikeRegisterNoStartupPeriod() {
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    servers_[i]->SetStrikeRegisterNoStartupPeriod();
+  }
+}
+
+int QuicMultiThreadedServer::port() {
+  return servers_[0]->port();
+}
+
+}  // namespace tools
+}  // namespace net
@@ -0,0 +1,76 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// A toy server which runs several QuicServers, each on its own thread and
+// with its own epoll server and dispatcher.  The servers share a port with
+// SO_REUSEPORT, so the kernel spreads the clients across them, and a
+// QuicGuidRouter hands off packets which reach the wrong server.
+
+#ifndef NET_TOOLS_QUIC_QUIC_MULTI_THREADED_SERVER_H_
+#define NET_TOOLS_QUIC_QUIC_MULTI_THREADED_SERVER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/base/ip_endpoint.h"
+#include "net/quic/quic_config.h"
+#include "net/quic/quic_protocol.h"
+#include "net/tools/quic/quic_guid_router.h"
+
+namespace net {
+namespace tools {
+
+class QuicServer;
+
+class QuicMultiThreadedServer {
+ public:
+  // Runs |num_threads| servers, including the one that runs on the thread
+  // calling WaitForEvents().
+  explicit QuicMultiThreadedServer(size_t num_threads);
+  QuicMultiThreadedServer(size_t num_threads,
+                          const QuicConfig& config,
+                          const QuicVersionVector& supported_versions);
+
+  ~QuicMultiThreadedServer();
+
+  // Start listening on the specified address, and start the threads of all
+  // but the first server.
+  bool Listen(const IPEndPoint& address);
+
+  // Wait up to 50ms, and handle any events which occur for the first server.
+  void WaitForEvents();
+
+  // Stops the threads, and shuts down all of the servers.
+  void Shutdown();
+
+  void SetStrikeRegisterNoStartupPeriod();
+
+  size_t num_servers() const { return servers_.size(); }
+
+  QuicServer* server(size_t index) { return servers_[index]; }
+
+  QuicGuidRouter* guid_router() { return &guid_router_; }
+
+  int port();
+
+ private:
+  class ServerThread;
+
+  void Initialize();
+
+  // Shared by all of the servers.
+  QuicGuidRouter guid_router_;
+
+  std::vector<QuicServer*> servers_;  // Owned.
+  // The threads of |servers_[1]| onwards.
+  std::vector<ServerThread*> threads_;  // Owned.
+
+  DISALLOW_COPY_AND_ASSIGN(QuicMultiThreadedServer);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_MULTI_THREADED_SERVER_H_
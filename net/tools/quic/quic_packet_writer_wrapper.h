@@ -31,6 +31,8 @@ class QuicPacketWriterWrapper : public net::QuicPacketWriter {
   virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
   virtual bool IsWriteBlocked() const OVERRIDE;
   virtual void SetWritable() OVERRIDE;
+  virtual bool IsBatchMode() const OVERRIDE;
+  virtual WriteResult Flush() OVERRIDE;
 
   // Takes ownership of |writer|.
   void set_writer(QuicPacketWriter* writer);
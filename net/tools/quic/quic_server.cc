@@ -18,6 +18,7 @@
 #include "net/quic/quic_crypto_stream.h"
 #include "net/quic/quic_data_reader.h"
 #include "net/quic/quic_protocol.h"
+#include "net/tools/quic/quic_guid_router.h"
 #include "net/tools/quic/quic_in_memory_cache.h"
 #include "net/tools/quic/quic_socket_utils.h"
 
@@ -27,6 +28,10 @@
 #define SO_RXQ_OVFL 40
 #endif
 
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+
 const int kEpollFlags = EPOLLIN | EPOLLOUT | EPOLLET;
 static const char kSourceAddressTokenSecret[] = "secret";
 
@@ -38,7 +43,9 @@ QuicServer::QuicServer()
       fd_(-1),
       packets_dropped_(0),
       overflow_supported_(false),
-      use_recvmmsg_(false),
+      use_recvmmsg_(FLAGS_quic_batch_io),
+      guid_router_(NULL),
+      guid_router_owner_(0),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()),
       supported_versions_(QuicSupportedVersions()) {
   // Use hardcoded crypto parameters for now.
@@ -55,7 +62,9 @@ QuicServer::QuicServer(const QuicConfig& config,
       fd_(-1),
       packets_dropped_(0),
       overflow_supported_(false),
-      use_recvmmsg_(false),
+      use_recvmmsg_(FLAGS_quic_batch_io),
+      guid_router_(NULL),
+      guid_router_owner_(0),
       config_(config),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()),
       supported_versions_(supported_versions) {
@@ -81,6 +90,12 @@ void QuicServer::Initialize() {
 QuicServer::~QuicServer() {
 }
 
+void QuicServer::SetGuidRouter(QuicGuidRouter* router, size_t owner) {
+  DCHECK(dispatcher_.get() == NULL);
+  guid_router_ = router;
+  guid_router_owner_ = owner;
+}
+
 bool QuicServer::Listen(const IPEndPoint& address) {
   port_ = address.port();
   int address_family = address.GetSockAddrFamily();
@@ -121,6 +136,16 @@ bool QuicServer::Listen(const IPEndPoint& address) {
     return false;
   }
 
+  if (guid_router_ != NULL) {
+    int reuse_port = 1;
+    rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT,
+                    &reuse_port, sizeof(reuse_port));
+    if (rc < 0) {
+      LOG(ERROR) << "SO_REUSEPORT not supported: " << strerror(errno);
+      return false;
+    }
+  }
+
   sockaddr_storage raw_addr;
   socklen_t raw_addr_len = sizeof(raw_addr);
   CHECK(address.ToSockAddr(reinterpret_cast<sockaddr*>(&raw_addr),
@@ -150,18 +175,30 @@ bool QuicServer::Listen(const IPEndPoint& address) {
   dispatcher_.reset(new QuicDispatcher(
       config_, crypto_config_, supported_versions_, &epoll_server_));
   dispatcher_->Initialize(fd_);
+  if (guid_router_ != NULL) {
+    dispatcher_->set_guid_router(guid_router_, guid_router_owner_);
+    guid_router_->SetEpollServer(guid_router_owner_, &epoll_server_);
+  }
 
   return true;
 }
 
 void QuicServer::WaitForEvents() {
   epoll_server_.WaitForEventsAndExecuteCallbacks();
+  if (guid_router_ != NULL) {
+    // Handle the packets the other servers received for our connections.
+    guid_router_->DispatchForwardedPackets(guid_router_owner_,
+                                           dispatcher_.get());
+  }
 }
 
 void QuicServer::Shutdown() {
   // Before we shut down the epoll server, give all active sessions a chance to
   // notify clients that they're closing.
   dispatcher_->Shutdown();
+  if (guid_router_ != NULL) {
+    guid_router_->SetEpollServer(guid_router_owner_, NULL);
+  }
 
   close(fd_);
   fd_ = -1;
@@ -175,9 +212,14 @@ void QuicServer::OnEvent(int fd, EpollEvent* event) {
     DVLOG(1) << "EPOLLIN";
     bool read = true;
     while (read) {
-        read = ReadAndDispatchSinglePacket(
-            fd_, port_, dispatcher_.get(),
-            overflow_supported_ ? &packets_dropped_ : NULL);
+      uint32* packets_dropped = overflow_supported_ ? &packets_dropped_ : NULL;
+      if (use_recvmmsg_) {
+        read = ReadAndDispatchPackets(fd_, port_, dispatcher_.get(),
+                                      packets_dropped);
+      } else {
+        read = ReadAndDispatchSinglePacket(fd_, port_, dispatcher_.get(),
+                                           packets_dropped);
+      }
     }
   }
   if (event->in_events & EPOLLOUT) {
@@ -218,5 +260,38 @@ bool QuicServer::ReadAndDispatchSinglePacket(int fd,
   return true;
 }
 
+/* static */
+bool QuicServer::ReadAndDispatchPackets(int fd,
+                                        int port,
+                                        QuicDispatcher* dispatcher,
+                                        uint32* packets_dropped) {
+  const size_t kNumPacketsPerRead = 16;
+  // Allocate some extra space so we can send an error if the client goes over
+  // the limit.
+  char buffers[kNumPacketsPerRead][2 * kMaxPacketSize];
+
+  QuicSocketUtils::PacketToRead packets[kNumPacketsPerRead];
+  for (size_t i = 0; i < kNumPacketsPerRead; ++i) {
+    packets[i].buffer = buffers[i];
+    packets[i].buf_len = arraysize(buffers[i]);
+  }
+
+  int packets_read = QuicSocketUtils::ReadPackets(
+      fd, packets, kNumPacketsPerRead, packets_dropped);
+  if (packets_read <= 0) {
+    return false;  // We failed to read.
+  }
+
+  for (int i = 0; i < packets_read; ++i) {
+    QuicEncryptedPacket packet(packets[i].buffer, packets[i].bytes_read,
+                               false);
+    IPEndPoint server_address(packets[i].self_address, port);
+    dispatcher->ProcessPacket(server_address, packets[i].peer_address,
+                              packet);
+  }
+
+  return true;
+}
+
 }  // namespace tools
 }  // namespace net
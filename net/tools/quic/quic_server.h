@@ -26,6 +26,7 @@ class QuicServerPeer;
 }  // namespace test
 
 class QuicDispatcher;
+class QuicGuidRouter;
 
 class QuicServer : public EpollCallbackInterface {
  public:
@@ -62,8 +63,21 @@ class QuicServer : public EpollCallbackInterface {
                                           QuicDispatcher* dispatcher,
                                           uint32* packets_dropped);
 
+  // Like ReadAndDispatchSinglePacket, but reads several packets with a single
+  // call.  Returns true if any packet is read.
+  static bool ReadAndDispatchPackets(int fd, int port,
+                                     QuicDispatcher* dispatcher,
+                                     uint32* packets_dropped);
+
   virtual void OnShutdown(EpollServer* eps, int fd) OVERRIDE {}
 
+  // Makes this server one of several that share a port.  The server's socket
+  // is bound with SO_REUSEPORT, and its dispatcher uses |router|, as the
+  // dispatcher with index |owner|, to hand off packets for connections owned
+  // by the other servers.  Must be called before Listen().  |router| is not
+  // owned and must outlive the server.
+  void SetGuidRouter(QuicGuidRouter* router, size_t owner);
+
   void SetStrikeRegisterNoStartupPeriod() {
     crypto_config_.set_strike_register_no_startup_period();
   }
@@ -103,6 +117,11 @@ class QuicServer : public EpollCallbackInterface {
   // If true, use recvmmsg for reading.
   bool use_recvmmsg_;
 
+  // Shares connections with the other servers on the same port, if any.
+  // Not owned.
+  QuicGuidRouter* guid_router_;
+  size_t guid_router_owner_;
+
   // config_ contains non-crypto parameters that are negotiated in the crypto
   // handshake.
   QuicConfig config_;
@@ -14,12 +14,18 @@
 #include "base/strings/string_number_conversions.h"
 #include "net/base/ip_endpoint.h"
 #include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/quic_multi_threaded_server.h"
 #include "net/tools/quic/quic_server.h"
+#include "net/tools/quic/quic_socket_utils.h"
 
 // The port the quic server will listen on.
 
 int32 FLAGS_port = 6121;
 
+// The number of threads to serve with.  Each one has its own socket on the
+// port.
+int32 FLAGS_num_threads = 1;
+
 int main(int argc, char *argv[]) {
   CommandLine::Init(argc, argv);
   CommandLine* line = CommandLine::ForCurrentProcess();
@@ -36,7 +42,9 @@ int main(int argc, char *argv[]) {
         "-h, --help                  show this help message and exit\n"
         "--port=<port>               specify the port to listen on\n"
         "--quic_in_memory_cache_dir  directory containing response data\n"
-        "                            to load\n";
+        "                            to load\n"
+        "--quic_batch_io             read and write packets in batches\n"
+        "--num_threads=<threads>     specify the number of server threads\n";
     std::cout << help_str;
     exit(0);
   }
@@ -46,6 +54,10 @@ int main(int argc, char *argv[]) {
         line->GetSwitchValueASCII("quic_in_memory_cache_dir");
   }
 
+  if (line->HasSwitch("quic_batch_io")) {
+    net::tools::FLAGS_quic_batch_io = true;
+  }
+
   if (line->HasSwitch("port")) {
     int port;
     if (base::StringToInt(line->GetSwitchValueASCII("port"), &port)) {
@@ -53,11 +65,31 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (line->HasSwitch("num_threads")) {
+    int num_threads;
+    if (base::StringToInt(line->GetSwitchValueASCII("num_threads"),
+                          &num_threads) && num_threads > 0) {
+      FLAGS_num_threads = num_threads;
+    }
+  }
+
   base::AtExitManager exit_manager;
 
   net::IPAddressNumber ip;
   CHECK(net::ParseIPLiteralToNumber("::", &ip));
 
+  if (FLAGS_num_threads > 1) {
+    net::tools::QuicMultiThreadedServer server(FLAGS_num_threads);
+
+    if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
+      return 1;
+    }
+
+    while (1) {
+      server.WaitForEvents();
+    }
+  }
+
   net::tools::QuicServer server;
 
   if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
@@ -9,6 +9,7 @@
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
+#include <algorithm>
 #include <string>
 
 #include "base/basictypes.h"
@@ -22,6 +23,8 @@
 namespace net {
 namespace tools {
 
+bool FLAGS_quic_batch_io = false;
+
 // static
 IPAddressNumber QuicSocketUtils::GetAddressFromMsghdr(struct msghdr *hdr) {
   if (hdr->msg_controllen > 0) {
@@ -79,48 +82,54 @@ int QuicSocketUtils::SetGetAddressInfo(int fd, int address_family) {
   }
 }
 
-// static
-int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
-                                uint32* dropped_packets,
-                                IPAddressNumber* self_address,
-                                IPEndPoint* peer_address) {
-  CHECK(peer_address != NULL);
-  const int kSpaceForOverflowAndIp =
-      CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
-  char cbuf[kSpaceForOverflowAndIp];
-  memset(cbuf, 0, arraysize(cbuf));
+namespace {
 
-  iovec iov = {buffer, buf_len};
-  struct sockaddr_storage raw_address;
-  msghdr hdr;
+// Space for the SO_RXQ_OVFL and IP_PKTINFO or IPV6_PKTINFO control messages
+// of a received packet.
+const int kSpaceForOverflowAndIp =
+    CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
 
-  hdr.msg_name = &raw_address;
-  hdr.msg_namelen = sizeof(sockaddr_storage);
-  hdr.msg_iov = &iov;
-  hdr.msg_iovlen = 1;
-  hdr.msg_flags = 0;
+const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
+const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
+// kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
+const int kSpaceForIp =
+    (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
 
-  struct cmsghdr *cmsg = (struct cmsghdr *) cbuf;
-  cmsg->cmsg_len = arraysize(cbuf);
-  hdr.msg_control = cmsg;
-  hdr.msg_controllen = arraysize(cbuf);
+// The most packets ReadPackets and WritePackets pass to the kernel at once.
+const size_t kMaxPacketsPerCall = 64;
 
-  int bytes_read = recvmsg(fd, &hdr, 0);
+// Sets up |hdr| to receive a packet into |iov|.  |raw_address| and |cbuf|,
+// which holds kSpaceForOverflowAndIp bytes, must outlive |hdr|.
+void InitReceiveMsghdr(iovec* iov,
+                       sockaddr_storage* raw_address,
+                       char* cbuf,
+                       msghdr* hdr) {
+  memset(cbuf, 0, kSpaceForOverflowAndIp);
 
-  // Return before setting dropped packets: if we get EAGAIN, it will
-  // be 0.
-  if (bytes_read < 0 && errno != 0) {
-    if (errno != EAGAIN) {
-      LOG(ERROR) << "Error reading " << strerror(errno);
-    }
-    return -1;
-  }
+  hdr->msg_name = raw_address;
+  hdr->msg_namelen = sizeof(sockaddr_storage);
+  hdr->msg_iov = iov;
+  hdr->msg_iovlen = 1;
+  hdr->msg_flags = 0;
+
+  struct cmsghdr *cmsg = (struct cmsghdr *) cbuf;
+  cmsg->cmsg_len = kSpaceForOverflowAndIp;
+  hdr->msg_control = cmsg;
+  hdr->msg_controllen = kSpaceForOverflowAndIp;
+}
 
+// Extracts the addresses of the packet received with |hdr|, and the number
+// of dropped packets, if requested.
+void ParseReceiveMsghdr(msghdr* hdr,
+                        const sockaddr_storage& raw_address,
+                        uint32* dropped_packets,
+                        IPAddressNumber* self_address,
+                        IPEndPoint* peer_address) {
   if (dropped_packets != NULL) {
-    GetOverflowFromMsghdr(&hdr, dropped_packets);
+    QuicSocketUtils::GetOverflowFromMsghdr(hdr, dropped_packets);
   }
   if (self_address != NULL) {
-    *self_address = QuicSocketUtils::GetAddressFromMsghdr(&hdr);
+    *self_address = QuicSocketUtils::GetAddressFromMsghdr(hdr);
   }
 
   if (raw_address.ss_family == AF_INET) {
@@ -132,43 +141,34 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
         reinterpret_cast<const sockaddr*>(&raw_address),
         sizeof(struct sockaddr_in6)));
   }
-
-  return bytes_read;
 }
 
-// static
-WriteResult QuicSocketUtils::WritePacket(int fd,
-                                         const char* buffer,
-                                         size_t buf_len,
-                                         const IPAddressNumber& self_address,
-                                         const IPEndPoint& peer_address) {
-  sockaddr_storage raw_address;
-  socklen_t address_len = sizeof(raw_address);
+// Sets up |hdr| to send |iov| from |self_address| to |peer_address|.
+// |raw_address| and |cbuf|, which holds kSpaceForIp bytes, must outlive |hdr|.
+void InitSendMsghdr(iovec* iov,
+                    const IPAddressNumber& self_address,
+                    const IPEndPoint& peer_address,
+                    sockaddr_storage* raw_address,
+                    char* cbuf,
+                    msghdr* hdr) {
+  socklen_t address_len = sizeof(*raw_address);
   CHECK(peer_address.ToSockAddr(
-      reinterpret_cast<struct sockaddr*>(&raw_address),
+      reinterpret_cast<struct sockaddr*>(raw_address),
       &address_len));
-  iovec iov = {const_cast<char*>(buffer), buf_len};
 
-  msghdr hdr;
-  hdr.msg_name = &raw_address;
-  hdr.msg_namelen = address_len;
-  hdr.msg_iov = &iov;
-  hdr.msg_iovlen = 1;
-  hdr.msg_flags = 0;
-
-  const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
-  const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
-  // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
-  const int kSpaceForIp =
-      (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
-  char cbuf[kSpaceForIp];
+  hdr->msg_name = raw_address;
+  hdr->msg_namelen = address_len;
+  hdr->msg_iov = iov;
+  hdr->msg_iovlen = 1;
+  hdr->msg_flags = 0;
+
   if (self_address.empty()) {
-    hdr.msg_control = 0;
-    hdr.msg_controllen = 0;
+    hdr->msg_control = 0;
+    hdr->msg_controllen = 0;
   } else if (GetAddressFamily(self_address) == ADDRESS_FAMILY_IPV4) {
-    hdr.msg_control = cbuf;
-    hdr.msg_controllen = kSpaceForIp;
-    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    hdr->msg_control = cbuf;
+    hdr->msg_controllen = kSpaceForIp;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
 
     cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
     cmsg->cmsg_level = IPPROTO_IP;
@@ -177,11 +177,11 @@ WriteResult QuicSocketUtils::WritePacket(int fd,
     memset(pktinfo, 0, sizeof(in_pktinfo));
     pktinfo->ipi_ifindex = 0;
     memcpy(&pktinfo->ipi_spec_dst, &self_address[0], self_address.size());
-    hdr.msg_controllen = cmsg->cmsg_len;
+    hdr->msg_controllen = cmsg->cmsg_len;
   } else {
-    hdr.msg_control = cbuf;
-    hdr.msg_controllen = kSpaceForIp;
-    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    hdr->msg_control = cbuf;
+    hdr->msg_controllen = kSpaceForIp;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
 
     cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
     cmsg->cmsg_level = IPPROTO_IPV6;
@@ -189,15 +189,128 @@ WriteResult QuicSocketUtils::WritePacket(int fd,
     in6_pktinfo* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
     memset(pktinfo, 0, sizeof(in6_pktinfo));
     memcpy(&pktinfo->ipi6_addr, &self_address[0], self_address.size());
-    hdr.msg_controllen = cmsg->cmsg_len;
+    hdr->msg_controllen = cmsg->cmsg_len;
   }
+}
+
+WriteResult WriteResultFromErrno() {
+  return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK) ?
+      WRITE_STATUS_BLOCKED : WRITE_STATUS_ERROR, errno);
+}
+
+}  // namespace
+
+// static
+int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
+                                uint32* dropped_packets,
+                                IPAddressNumber* self_address,
+                                IPEndPoint* peer_address) {
+  CHECK(peer_address != NULL);
+  char cbuf[kSpaceForOverflowAndIp];
+  iovec iov = {buffer, buf_len};
+  struct sockaddr_storage raw_address;
+  msghdr hdr;
+  InitReceiveMsghdr(&iov, &raw_address, cbuf, &hdr);
+
+  int bytes_read = recvmsg(fd, &hdr, 0);
+
+  // Return before setting dropped packets: if we get EAGAIN, it will
+  // be 0.
+  if (bytes_read < 0 && errno != 0) {
+    if (errno != EAGAIN) {
+      LOG(ERROR) << "Error reading " << strerror(errno);
+    }
+    return -1;
+  }
+
+  ParseReceiveMsghdr(&hdr, raw_address, dropped_packets, self_address,
+                     peer_address);
+  return bytes_read;
+}
+
+// static
+int QuicSocketUtils::ReadPackets(int fd, PacketToRead* packets, size_t count,
+                                 uint32* dropped_packets) {
+  count = std::min(count, kMaxPacketsPerCall);
+  mmsghdr hdrs[kMaxPacketsPerCall];
+  iovec iovs[kMaxPacketsPerCall];
+  sockaddr_storage raw_addresses[kMaxPacketsPerCall];
+  char cbufs[kMaxPacketsPerCall][kSpaceForOverflowAndIp];
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = packets[i].buffer;
+    iovs[i].iov_len = packets[i].buf_len;
+    InitReceiveMsghdr(&iovs[i], &raw_addresses[i], cbufs[i],
+                      &hdrs[i].msg_hdr);
+    hdrs[i].msg_len = 0;
+  }
+
+  int packets_read = recvmmsg(fd, hdrs, count, 0, NULL);
+  if (packets_read < 0) {
+    if (errno != EAGAIN) {
+      LOG(ERROR) << "Error reading " << strerror(errno);
+    }
+    return -1;
+  }
+
+  for (int i = 0; i < packets_read; ++i) {
+    packets[i].bytes_read = hdrs[i].msg_len;
+    // The packets are read in order, so the last overflow count is the
+    // current one.
+    ParseReceiveMsghdr(&hdrs[i].msg_hdr, raw_addresses[i], dropped_packets,
+                       &packets[i].self_address, &packets[i].peer_address);
+  }
+  return packets_read;
+}
+
+// static
+WriteResult QuicSocketUtils::WritePacket(int fd,
+                                         const char* buffer,
+                                         size_t buf_len,
+                                         const IPAddressNumber& self_address,
+                                         const IPEndPoint& peer_address) {
+  sockaddr_storage raw_address;
+  iovec iov = {const_cast<char*>(buffer), buf_len};
+  char cbuf[kSpaceForIp];
+  msghdr hdr;
+  InitSendMsghdr(&iov, self_address, peer_address, &raw_address, cbuf, &hdr);
 
   int rc = sendmsg(fd, &hdr, 0);
   if (rc >= 0) {
     return WriteResult(WRITE_STATUS_OK, rc);
   }
-  return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK) ?
-      WRITE_STATUS_BLOCKED : WRITE_STATUS_ERROR, errno);
+  return WriteResultFromErrno();
+}
+
+// static
+WriteResult QuicSocketUtils::WritePackets(int fd,
+                                          const PacketToWrite* packets,
+                                          size_t count,
+                                          size_t* packets_written) {
+  *packets_written = 0;
+  count = std::min(count, kMaxPacketsPerCall);
+  mmsghdr hdrs[kMaxPacketsPerCall];
+  iovec iovs[kMaxPacketsPerCall];
+  sockaddr_storage raw_addresses[kMaxPacketsPerCall];
+  char cbufs[kMaxPacketsPerCall][kSpaceForIp];
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = const_cast<char*>(packets[i].buffer);
+    iovs[i].iov_len = packets[i].buf_len;
+    InitSendMsghdr(&iovs[i], packets[i].self_address, packets[i].peer_address,
+                   &raw_addresses[i], cbufs[i], &hdrs[i].msg_hdr);
+    hdrs[i].msg_len = 0;
+  }
+
+  int rc = sendmmsg(fd, hdrs, count, 0);
+  if (rc < 0) {
+    return WriteResultFromErrno();
+  }
+
+  int bytes_written = 0;
+  for (int i = 0; i < rc; ++i) {
+    bytes_written += hdrs[i].msg_len;
+  }
+  *packets_written = rc;
+  return WriteResult(WRITE_STATUS_OK, bytes_written);
 }
 
 }  // namespace tools
@@ -17,8 +17,32 @@
 namespace net {
 namespace tools {
 
+// If true, the server reads and writes packets in batches with recvmmsg and
+// sendmmsg, instead of with a system call per packet.
+extern bool FLAGS_quic_batch_io;
+
 class QuicSocketUtils {
  public:
+  // A packet to send with WritePackets.
+  struct PacketToWrite {
+    const char* buffer;
+    size_t buf_len;
+    IPAddressNumber self_address;
+    IPEndPoint peer_address;
+  };
+
+  // A buffer to receive a packet into with ReadPackets.
+  struct PacketToRead {
+    // Set by the caller.
+    char* buffer;
+    size_t buf_len;
+
+    // Set by ReadPackets for the packets it reads.
+    int bytes_read;
+    IPAddressNumber self_address;
+    IPEndPoint peer_address;
+  };
+
   // If the msghdr contains IP_PKTINFO or IPV6_PKTINFO, this will return the
   // IPAddressNumber in that header.  Returns an uninitialized IPAddress on
   // failure.
@@ -47,6 +71,12 @@ class QuicSocketUtils {
                         IPAddressNumber* self_address,
                         IPEndPoint* peer_address);
 
+  // Reads up to |count| packets into |packets| with a single call.  Returns
+  // the number of packets read, or -1 if none could be read.  See ReadPacket
+  // for a description of |dropped_packets|.
+  static int ReadPackets(int fd, PacketToRead* packets, size_t count,
+                         uint32* dropped_packets);
+
   // Writes buf_len to the socket. If writing is successful, sets the result's
   // status to WRITE_STATUS_OK and sets bytes_written.  Otherwise sets the
   // result's status to WRITE_STATUS_BLOCKED or WRITE_STATUS_ERROR and sets
@@ -54,6 +84,14 @@ class QuicSocketUtils {
   static WriteResult WritePacket(int fd, const char* buffer, size_t buf_len,
                                  const IPAddressNumber& self_address,
                                  const IPEndPoint& peer_address);
+
+  // Writes the |count| packets of |packets| with a single call, and sets
+  // |packets_written| to the number of packets sent, which may be less than
+  // |count|.  If some packets are sent, sets the result's status to
+  // WRITE_STATUS_OK and sets bytes_written.  Otherwise the result is as for
+  // WritePacket.
+  static WriteResult WritePackets(int fd, const PacketToWrite* packets,
+                                  size_t count, size_t* packets_written);
 };
 
 }  // namespace tools
@@ -215,6 +215,15 @@ bool QuicTimeWaitListManager::WriteToWire(QueuedPacket* queued_packet) {
       queued_packet->packet()->length(),
       queued_packet->server_address().address(),
       queued_packet->client_address());
+  if (result.status == WRITE_STATUS_OK && writer_->IsBatchMode()) {
+    // Nothing is bundled with the packet, so send it now.
+    result = writer_->Flush();
+    if (result.status == WRITE_STATUS_BLOCKED) {
+      // The writer keeps the packet until the socket is writable again.
+      visitor_->OnWriteBlocked(this);
+      return true;
+    }
+  }
   if (result.status == WRITE_STATUS_BLOCKED) {
     // If blocked and unbuffered, return false to retry sending.
     DCHECK(writer_->IsWriteBlocked());
@@ -0,0 +1,140 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_log.h"
+#include "base/time/time.h"
+#include "net/base/request_priority.h"
+#include "net/socket/socket_test_util.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace net {
+
+namespace {
+
+const int kNumRequests = 500;
+const int kBodySize = 16 * 1024;
+// Bodies arrive in reads of this size, as they would off the network.
+const int kReadSize = 4 * 1024;
+
+// Returns the |percentile|-th percentile of |samples| in milliseconds.
+double PercentileInMs(std::vector<base::TimeDelta> samples, int percentile) {
+  if (samples.empty())
+    return 0;
+  std::sort(samples.begin(), samples.end());
+  size_t index = (samples.size() - 1) * percentile / 100;
+  return samples[index].InMillisecondsF();
+}
+
+// Measures requests made through URLRequestHttpJob, the HttpCache, the
+// socket pools and HttpNetworkTransaction, with mock sockets standing in for
+// the network. All responses for a host are served over one keep-alive
+// connection, with each read completing asynchronously.
+class URLRequestPerfTest : public testing::Test {
+ protected:
+  URLRequestPerfTest()
+      : headers_(base::StringPrintf("HTTP/1.1 200 OK\r\n"
+                                    "Content-Length: %d\r\n"
+                                    "Cache-Control: max-age=3600\r\n\r\n",
+                                    kBodySize)),
+        body_(kBodySize, 'x'),
+        context_(true) {
+    context_.set_client_socket_factory(&socket_factory_);
+    context_.Init();
+  }
+
+  // Adds a keep-alive connection serving |num_responses| cacheable responses.
+  void AddConnection(int num_responses) {
+    reads_.push_back(std::vector<MockRead>());
+    std::vector<MockRead>* reads = &reads_.back();
+    for (int i = 0; i < num_responses; ++i) {
+      reads->push_back(MockRead(ASYNC, headers_.c_str(), headers_.size()));
+      for (int offset = 0; offset < kBodySize; offset += kReadSize) {
+        reads->push_back(MockRead(ASYNC, body_.c_str() + offset,
+                                  std::min(kReadSize, kBodySize - offset)));
+      }
+    }
+    reads->push_back(MockRead(SYNCHRONOUS, OK));
+
+    StaticSocketDataProvider* data =
+        new StaticSocketDataProvider(&(*reads)[0], reads->size(), NULL, 0);
+    socket_data_.push_back(data);
+    socket_factory_.AddSocketDataProvider(data);
+  }
+
+  // Requests |num_requests| distinct URLs one after another, and logs the
+  // throughput, latency and IO thread CPU time under |test_name|.
+  void RunRequests(const std::string& test_name, int num_requests) {
+    std::vector<base::TimeDelta> latencies;
+    base::TimeTicks thread_start;
+    if (base::TimeTicks::IsThreadNowSupported())
+      thread_start = base::TimeTicks::ThreadNow();
+    base::TimeTicks start = base::TimeTicks::Now();
+
+    for (int i = 0; i < num_requests; ++i) {
+      base::TimeTicks request_start = base::TimeTicks::Now();
+      TestDelegate delegate;
+      URLRequest request(
+          GURL(base::StringPrintf("http://www.example.com/%d", i)),
+          DEFAULT_PRIORITY, &delegate, &context_);
+      request.Start();
+      base::RunLoop().Run();
+      latencies.push_back(base::TimeTicks::Now() - request_start);
+
+      ASSERT_TRUE(request.status().is_success());
+      ASSERT_EQ(kBodySize, delegate.bytes_received());
+    }
+
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    base::LogPerfResult((test_name + "_requests_per_second").c_str(),
+                        num_requests / elapsed.InSecondsF(), "requests/s");
+    base::LogPerfResult((test_name + "_latency_p50").c_str(),
+                        PercentileInMs(latencies, 50), "ms");
+    base::LogPerfResult((test_name + "_latency_p99").c_str(),
+                        PercentileInMs(latencies, 99), "ms");
+    if (base::TimeTicks::IsThreadNowSupported()) {
+      base::TimeDelta cpu = base::TimeTicks::ThreadNow() - thread_start;
+      base::LogPerfResult(
+          (test_name + "_io_thread_cpu").c_str(),
+          cpu.InMicroseconds() / static_cast<double>(num_requests),
+          "us/request");
+    }
+  }
+
+  base::MessageLoopForIO message_loop_;
+  const std::string headers_;
+  const std::string body_;
+  // MockReads point into these, so they must outlive the sockets held by
+  // |context_|.
+  std::list<std::vector<MockRead> > reads_;
+  ScopedVector<StaticSocketDataProvider> socket_data_;
+  MockClientSocketFactory socket_factory_;
+  TestURLRequestContext context_;
+};
+
+TEST_F(URLRequestPerfTest, NetworkRequests) {
+  AddConnection(kNumRequests);
+  RunRequests("URLRequest_network", kNumRequests);
+}
+
+TEST_F(URLRequestPerfTest, CachedRequests) {
+  AddConnection(kNumRequests);
+  RunRequests("URLRequest_cache_fill", kNumRequests);
+  RunRequests("URLRequest_cache_hit", kNumRequests);
+}
+
+}  // namespace
+
+}  // namespace net
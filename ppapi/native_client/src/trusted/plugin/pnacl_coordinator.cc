@@ -403,6 +403,14 @@ void PnaclCoordinator::NexeReadDidOpen(int32_t pp_error) {
     return;
   }
 
+  if (is_cache_hit_ == PP_TRUE) {
+    // Compare to TotalUncachedTime, which is reported on a miss.
+    int64_t total_time = NaClGetTimeOfDayMicroseconds() - pnacl_init_time_;
+    HistogramTime(plugin_->uma_interface(),
+                  "NaCl.Perf.PNaClLoadTime.TotalCachedTime",
+                  total_time / NACL_MICROS_PER_MILLI);
+  }
+
   translate_notify_callback_.Run(pp_error);
 }
 
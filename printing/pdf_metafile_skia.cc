@@ -120,8 +120,9 @@ bool PdfMetafileSkia::GetData(void* dst_buffer,
   if (dst_buffer_size < GetDataSize())
     return false;
 
-  SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-  memcpy(dst_buffer, data->bytes(), dst_buffer_size);
+  // Copy straight out of the stream, which would otherwise be copied whole
+  // first, adding the size of the document to the peak memory of printing.
+  data_->pdf_stream_.copyTo(dst_buffer);
   return true;
 }
 
@@ -228,21 +229,17 @@ PdfMetafileSkia::PdfMetafileSkia()
 
 PdfMetafileSkia* PdfMetafileSkia::GetMetafileForCurrentPage() {
   SkPDFDocument pdf_doc(SkPDFDocument::kDraftMode_Flags);
-  SkDynamicMemoryWStream pdf_stream;
   if (!pdf_doc.appendPage(data_->current_page_.get()))
     return NULL;
 
-  if (!pdf_doc.emitPDF(&pdf_stream))
-    return NULL;
-
-  SkAutoDataUnref data(pdf_stream.copyToData());
-  if (data->size() == 0)
+  // Emit the page straight into the stream of the new metafile instead of
+  // copying it there.
+  scoped_ptr<PdfMetafileSkia> metafile(new PdfMetafileSkia);
+  if (!pdf_doc.emitPDF(&metafile->data_->pdf_stream_) ||
+      metafile->GetDataSize() == 0) {
     return NULL;
-
-  PdfMetafileSkia* metafile = new PdfMetafileSkia;
-  metafile->InitFromData(data->bytes(),
-                         base::checked_cast<uint32>(data->size()));
-  return metafile;
+  }
+  return metafile.release();
 }
 
 }  // namespace printing
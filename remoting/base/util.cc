@@ -6,6 +6,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
@@ -20,6 +22,18 @@ namespace remoting {
 
 enum { kBytesPerPixelRGB32 = 4 };
 
+namespace {
+
+int64 RectArea(const webrtc::DesktopRect& rect) {
+  return static_cast<int64>(rect.width()) * rect.height();
+}
+
+bool IsAbove(const webrtc::DesktopRect& a, const webrtc::DesktopRect& b) {
+  return a.top() < b.top();
+}
+
+}  // namespace
+
 // Do not write LOG messages in this routine since it is called from within
 // our LOG message handler. Bad things will happen.
 std::string GetTimestampString() {
@@ -208,6 +222,36 @@ webrtc::DesktopRect ScaleRect(const webrtc::DesktopRect& rect,
   return webrtc::DesktopRect::MakeLTRB(left, top, right, bottom);
 }
 
+void CoalesceRects(int rect_cost, std::vector<webrtc::DesktopRect>* rects) {
+  // With the rectangles sorted by their tops, a rectangle further below one
+  // than |rect_cost| pixels can't be merged with it, nor can those after it.
+  std::stable_sort(rects->begin(), rects->end(), IsAbove);
+
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < rects->size(); ++i) {
+      size_t j = i + 1;
+      while (j < rects->size() &&
+             (*rects)[j].top() - (*rects)[i].bottom() <= rect_cost) {
+        const webrtc::DesktopRect& a = (*rects)[i];
+        const webrtc::DesktopRect& b = (*rects)[j];
+        webrtc::DesktopRect bounds = webrtc::DesktopRect::MakeLTRB(
+            std::min(a.left(), b.left()), a.top(),
+            std::max(a.right(), b.right()), std::max(a.bottom(), b.bottom()));
+        if (RectArea(bounds) - RectArea(a) - RectArea(b) <= rect_cost) {
+          // |bounds| has the top of |a|, so the order is kept.
+          (*rects)[i] = bounds;
+          rects->erase(rects->begin() + j);
+          merged = true;
+        } else {
+          ++j;
+        }
+      }
+    }
+  }
+}
+
 void CopyRGB32Rect(const uint8* source_buffer,
                    int source_stride,
                    const webrtc::DesktopRect& source_buffer_rect,
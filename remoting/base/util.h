@@ -6,6 +6,7 @@
 #define REMOTING_BASE_UTIL_H_
 
 #include <string>
+#include <vector>
 
 #include "media/base/video_frame.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_geometry.h"
@@ -75,6 +76,13 @@ webrtc::DesktopRect ScaleRect(const webrtc::DesktopRect& rect,
                               const webrtc::DesktopSize& in_size,
                               const webrtc::DesktopSize& out_size);
 
+// Replaces rectangles of |rects| close to each other with their bounding
+// rectangle, while that adds at most |rect_cost| pixels. Processing a
+// rectangle is taken to cost as much as processing |rect_cost| pixels, so
+// this balances the overhead of each rectangle against the pixels which
+// haven't changed. The result may contain overlapping rectangles.
+void CoalesceRects(int rect_cost, std::vector<webrtc::DesktopRect>* rects);
+
 // Copy content of a rectangle in a RGB32 image.
 void CopyRGB32Rect(const uint8* source_buffer,
                    int source_stride,
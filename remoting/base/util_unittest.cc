@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <vector>
 
 #include "remoting/base/util.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -182,6 +183,47 @@ TEST(YuvToRgbTest, ClippingAndScaling) {
   }
 }
 
+TEST(CoalesceRectsTest, Basic) {
+  std::vector<webrtc::DesktopRect> rects;
+  // Two blocks a block apart, which are merged, and one far below them.
+  rects.push_back(webrtc::DesktopRect::MakeXYWH(0, 0, 32, 32));
+  rects.push_back(webrtc::DesktopRect::MakeXYWH(64, 0, 32, 32));
+  rects.push_back(webrtc::DesktopRect::MakeXYWH(0, 1000, 32, 32));
+  CoalesceRects(32 * 32, &rects);
+  ASSERT_EQ(2u, rects.size());
+  EXPECT_TRUE(rects[0].equals(webrtc::DesktopRect::MakeXYWH(0, 0, 96, 32)));
+  EXPECT_TRUE(rects[1].equals(webrtc::DesktopRect::MakeXYWH(0, 1000, 32, 32)));
+
+  // Nothing is merged if rectangles cost nothing.
+  rects.clear();
+  rects.push_back(webrtc::DesktopRect::MakeXYWH(0, 0, 32, 32));
+  rects.push_back(webrtc::DesktopRect::MakeXYWH(64, 0, 32, 32));
+  CoalesceRects(0, &rects);
+  EXPECT_EQ(2u, rects.size());
+}
+
+TEST(CoalesceRectsTest, Speed) {
+  // Changes scattered over a 4K screen in 32x32 blocks, as while typing in
+  // several windows, with every third block in each row and in every other
+  // row of blocks.
+  std::vector<webrtc::DesktopRect> blocks;
+  for (int y = 0; y < 2160; y += 64) {
+    for (int x = 0; x < 3840; x += 96)
+      blocks.push_back(webrtc::DesktopRect::MakeXYWH(x, y, 32, 32));
+  }
+  std::vector<webrtc::DesktopRect> rects(blocks);
+  CoalesceRects(32 * 32, &rects);
+  EXPECT_GT(blocks.size() / 10, rects.size());
+
+  // Every block is still covered.
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    bool covered = false;
+    for (size_t j = 0; j < rects.size() && !covered; ++j)
+      covered = DoesRectContain(rects[j], blocks[i]);
+    EXPECT_TRUE(covered) << blocks[i].left() << "," << blocks[i].top();
+  }
+}
+
 TEST(ReplaceLfByCrLfTest, Basic) {
   EXPECT_EQ("ab", ReplaceLfByCrLf("ab"));
   EXPECT_EQ("\r\nab", ReplaceLfByCrLf("\nab"));
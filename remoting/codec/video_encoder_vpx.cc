@@ -4,6 +4,8 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/sys_info.h"
@@ -29,39 +31,77 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
-ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
+// Each rectangle converted takes about as long as converting this many more
+// pixels, and adds a dirty rectangle for the client to paint.
+const int kRectCostPixels = 32 * 32;
+
+// Frames are encoded with one more thread for each this many pixels, up to
+// kMaxEncoderThreads, which is also the most token partitions VP8 has.
+const int kPixelsPerEncoderThread = 1024 * 1024;
+const int kMaxEncoderThreads = 8;
+
+// The quantizers used for most frames, and for those of which less than
+// 1/kSmallUpdateFraction of the screen has changed. Small updates, such as
+// typing, are cheap enough to encode sharper.
+const unsigned int kMinQuantizer = 20;
+const unsigned int kMaxQuantizer = 30;
+const unsigned int kSmallUpdateMinQuantizer = 10;
+const unsigned int kSmallUpdateMaxQuantizer = 20;
+const int kSmallUpdateFraction = 16;
+
+int GetEncoderThreadCount(const webrtc::DesktopSize& size) {
+  // Going to multiple threads on low end windows systems can really hurt
+  // performance. http://crbug.com/99179
+  int processors = base::SysInfo::NumberOfProcessors();
+  if (processors <= 2)
+    return 1;
+
+  // Using 2 threads gives a great boost in performance for most systems with
+  // adequate processing power. High resolution screens use more, leaving a
+  // core to capture the next frame on.
+  int threads = size.width() * size.height() / kPixelsPerEncoderThread;
+  return std::max(2, std::min(threads,
+                              std::min(processors - 1, kMaxEncoderThreads)));
+}
+
+ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size,
+                              vpx_codec_enc_cfg_t* config) {
   ScopedVpxCodec codec(new vpx_codec_ctx_t);
 
   // Configure the encoder.
-  vpx_codec_enc_cfg_t config;
   const vpx_codec_iface_t* algo = vpx_codec_vp8_cx();
   CHECK(algo);
-  vpx_codec_err_t ret = vpx_codec_enc_config_default(algo, &config, 0);
+  vpx_codec_err_t ret = vpx_codec_enc_config_default(algo, config, 0);
   if (ret != VPX_CODEC_OK)
     return ScopedVpxCodec();
 
-  config.rc_target_bitrate = size.width() * size.height() *
-      config.rc_target_bitrate / config.g_w / config.g_h;
-  config.g_w = size.width();
-  config.g_h = size.height();
-  config.g_pass = VPX_RC_ONE_PASS;
+  config->rc_target_bitrate = size.width() * size.height() *
+      config->rc_target_bitrate / config->g_w / config->g_h;
+  config->g_w = size.width();
+  config->g_h = size.height();
+  config->g_pass = VPX_RC_ONE_PASS;
 
   // Value of 2 means using the real time profile. This is basically a
   // redundant option since we explicitly select real time mode when doing
   // encoding.
-  config.g_profile = 2;
+  config->g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
-  config.rc_min_quantizer = 20;
-  config.rc_max_quantizer = 30;
-  config.g_timebase.num = 1;
-  config.g_timebase.den = 20;
-
-  if (vpx_codec_enc_init(codec.get(), algo, &config, 0))
+  config->g_threads = GetEncoderThreadCount(size);
+  config->rc_min_quantizer = kMinQuantizer;
+  config->rc_max_quantizer = kMaxQuantizer;
+  config->g_timebase.num = 1;
+  config->g_timebase.den = 20;
+
+  if (vpx_codec_enc_init(codec.get(), algo, config, 0))
+    return ScopedVpxCodec();
+
+  // Threads only write the tokens of a frame in parallel if it has a
+  // partition for each of them.
+  int token_partitions = 0;
+  while ((2 << token_partitions) <= static_cast<int>(config->g_threads))
+    ++token_partitions;
+  if (vpx_codec_control(codec.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        token_partitions))
     return ScopedVpxCodec();
 
   // Value of 16 will have the smallest CPU load. This turns off subpixel
@@ -108,6 +148,17 @@ scoped_ptr<VideoPacket> VideoEncoderVpx::Encode(
   // Update active map based on updated region.
   PrepareActiveMap(updated_region);
 
+  // Encode small updates sharper than large ones.
+  int64 updated_area = 0;
+  for (webrtc::DesktopRegion::Iterator r(updated_region); !r.IsAtEnd();
+       r.Advance()) {
+    updated_area += r.rect().width() * r.rect().height();
+  }
+  bool small_update = updated_area * kSmallUpdateFraction <
+      static_cast<int64>(image_->w) * image_->h;
+  SetQuantizers(small_update ? kSmallUpdateMinQuantizer : kMinQuantizer,
+                small_update ? kSmallUpdateMaxQuantizer : kMaxQuantizer);
+
   // Apply active map to the encoder.
   vpx_active_map_t act_map;
   act_map.rows = active_map_height_;
@@ -185,6 +236,7 @@ VideoEncoderVpx::VideoEncoderVpx(const InitializeCodecCallback& init_codec)
 
 bool VideoEncoderVpx::Initialize(const webrtc::DesktopSize& size) {
   codec_.reset();
+  config_.reset(new vpx_codec_enc_cfg_t());
 
   image_.reset(new vpx_image_t());
   memset(image_.get(), 0, sizeof(vpx_image_t));
@@ -242,11 +294,24 @@ bool VideoEncoderVpx::Initialize(const webrtc::DesktopSize& size) {
   image_->stride[2] = uv_width;
 
   // Initialize the codec.
-  codec_ = init_codec_.Run(size);
+  codec_ = init_codec_.Run(size, config_.get());
 
   return codec_;
 }
 
+void VideoEncoderVpx::SetQuantizers(unsigned int min_quantizer,
+                                    unsigned int max_quantizer) {
+  if (config_->rc_min_quantizer == min_quantizer &&
+      config_->rc_max_quantizer == max_quantizer) {
+    return;
+  }
+
+  config_->rc_min_quantizer = min_quantizer;
+  config_->rc_max_quantizer = max_quantizer;
+  if (vpx_codec_enc_config_set(codec_.get(), config_.get()))
+    LOG(ERROR) << "Unable to set quantizers";
+}
+
 void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
                                    webrtc::DesktopRegion* updated_region) {
   if (frame.updated_region().is_empty()) {
@@ -265,6 +330,10 @@ void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
         rect.left(), rect.top(), rect.right(), rect.bottom())));
   }
   DCHECK(!aligned_rects.empty());
+
+  // Many small rectangles, such as those of scattered text, are converted as
+  // fewer larger ones instead.
+  CoalesceRects(kRectCostPixels, &aligned_rects);
   updated_region->Clear();
   updated_region->AddRects(&aligned_rects[0], aligned_rects.size());
 
@@ -283,9 +352,13 @@ void VideoEncoderVpx::PrepareImage(const webrtc::DesktopFrame& frame,
   uint8* y_data = image_->planes[0];
   uint8* u_data = image_->planes[1];
   uint8* v_data = image_->planes[2];
-  for (webrtc::DesktopRegion::Iterator r(*updated_region); !r.IsAtEnd();
-       r.Advance()) {
-    const webrtc::DesktopRect& rect = r.rect();
+  // The rectangles of the region are split wherever the others start or end,
+  // so convert the coalesced ones, even though some may overlap.
+  for (size_t i = 0; i < aligned_rects.size(); ++i) {
+    webrtc::DesktopRect rect = aligned_rects[i];
+    rect.IntersectWith(webrtc::DesktopRect::MakeWH(image_->w, image_->h));
+    if (rect.is_empty())
+      continue;
     ConvertRGB32ToYUVWithRect(
         rgb_data, y_data, u_data, v_data,
         rect.left(), rect.top(), rect.width(), rect.height(),
@@ -9,6 +9,7 @@
 #include "remoting/codec/scoped_vpx_codec.h"
 #include "remoting/codec/video_encoder.h"
 
+typedef struct vpx_codec_enc_cfg vpx_codec_enc_cfg_t;
 typedef struct vpx_image vpx_image_t;
 
 namespace webrtc {
@@ -30,7 +31,10 @@ class VideoEncoderVpx : public VideoEncoder {
       const webrtc::DesktopFrame& frame) OVERRIDE;
 
  private:
-  typedef base::Callback<ScopedVpxCodec(const webrtc::DesktopSize&)>
+  // Creates a codec for frames of the given size, writing the configuration
+  // it was created with to the vpx_codec_enc_cfg_t.
+  typedef base::Callback<ScopedVpxCodec(const webrtc::DesktopSize&,
+                                        vpx_codec_enc_cfg_t*)>
       InitializeCodecCallback;
 
   VideoEncoderVpx(const InitializeCodecCallback& init_codec);
@@ -47,9 +51,13 @@ class VideoEncoderVpx : public VideoEncoder {
   // given to the encoder to speed up encoding.
   void PrepareActiveMap(const webrtc::DesktopRegion& updated_region);
 
+  // Changes the quantizers the codec chooses from, if they differ.
+  void SetQuantizers(unsigned int min_quantizer, unsigned int max_quantizer);
+
   InitializeCodecCallback init_codec_;
 
   ScopedVpxCodec codec_;
+  scoped_ptr<vpx_codec_enc_cfg_t> config_;
   scoped_ptr<vpx_image_t> image_;
   scoped_ptr<uint8[]> active_map_;
   int active_map_width_;
@@ -4,6 +4,8 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <string.h>
+
 #include <limits>
 #include <vector>
 
@@ -47,6 +49,27 @@ TEST(VideoEncoderVpxTest, TestSizeChangeNoLeak) {
   EXPECT_TRUE(packet);
 }
 
+// Test that a high resolution frame, which is encoded with several threads,
+// and a small update to it can be encoded.
+TEST(VideoEncoderVpxTest, TestHighResolutionFrame) {
+  scoped_ptr<VideoEncoderVpx> encoder(VideoEncoderVpx::CreateForVP8());
+
+  webrtc::DesktopSize size(3840, 2160);
+  scoped_ptr<webrtc::DesktopFrame> frame(new webrtc::BasicDesktopFrame(size));
+  memset(frame->data(), 0x7f, frame->stride() * size.height());
+  frame->mutable_updated_region()->SetRect(webrtc::DesktopRect::MakeSize(size));
+  scoped_ptr<VideoPacket> packet = encoder->Encode(*frame);
+  ASSERT_TRUE(packet);
+  EXPECT_FALSE(packet->data().empty());
+
+  frame->mutable_updated_region()->SetRect(
+      webrtc::DesktopRect::MakeXYWH(64, 64, 128, 32));
+  packet = encoder->Encode(*frame);
+  ASSERT_TRUE(packet);
+  EXPECT_FALSE(packet->data().empty());
+  EXPECT_EQ(1, packet->dirty_rects_size());
+}
+
 // Test that the DPI information is correctly propagated from the
 // media::ScreenCaptureData to the VideoPacket.
 TEST(VideoEncoderVpxTest, TestDpiPropagation) {
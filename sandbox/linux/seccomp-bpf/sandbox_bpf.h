@@ -247,6 +247,15 @@ class SandboxBPF {
                                  Ranges::const_iterator start,
                                  Ranges::const_iterator stop);
 
+  // Returns a BPF program snippet that checks for the most frequently made
+  // system calls before falling through to "jumptable", if the policy
+  // allows them unconditionally and the jump table built from "ranges" is
+  // deep enough for the checks to pay off. The snippet must only be run
+  // once the system call number has been loaded.
+  Instruction* AssembleFastPath(CodeGen* gen,
+                                const Ranges& ranges,
+                                Instruction* jumptable);
+
   // Returns a BPF program snippet that makes the BPF filter program exit
   // with the given ErrorCode "err". N.B. the ErrorCode may very well be a
   // conditional expression; if so, this function will recursively call
@@ -21,6 +21,7 @@
 #include <ostream>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "sandbox/linux/seccomp-bpf/bpf_tests.h"
 #include "sandbox/linux/seccomp-bpf/syscall.h"
@@ -159,6 +160,83 @@ BPF_TEST(SandboxBPF, ApplyBasicWhitelistPolicy, WhitelistGetpidPolicy) {
   BPF_ASSERT(errno == ENOMEM);
 }
 
+// A policy that denies administrative system calls scattered over the
+// syscall table, and so compiles to a jump table about as deep as those of
+// the real sandbox policies.
+ErrorCode ScatteredBlacklistPolicy(SandboxBPF*, int sysno, void*) {
+  if (!SandboxBPF::IsValidSyscallNumber(sysno))
+    return ErrorCode(ENOSYS);
+  switch (sysno) {
+    case __NR_acct:
+    case __NR_chroot:
+    case __NR_delete_module:
+    case __NR_init_module:
+    case __NR_kexec_load:
+    case __NR_mount:
+    case __NR_pivot_root:
+    case __NR_ptrace:
+    case __NR_quotactl:
+    case __NR_reboot:
+    case __NR_setdomainname:
+    case __NR_sethostname:
+    case __NR_setns:
+    case __NR_settimeofday:
+    case __NR_swapoff:
+    case __NR_swapon:
+    case __NR_syslog:
+    case __NR_umount2:
+    case __NR_unshare:
+    case __NR_vhangup:
+      return ErrorCode(EPERM);
+    default:
+      return ErrorCode(ErrorCode::ERR_ALLOWED);
+  }
+}
+
+SANDBOX_TEST(SandboxBPF, FastPathForFrequentSyscalls) {
+  SandboxBPF sandbox;
+  sandbox.SetSandboxPolicyDeprecated(ScatteredBlacklistPolicy, NULL);
+  scoped_ptr<SandboxBPF::Program> program(
+      sandbox.AssembleFilter(true /* force_verification */));
+
+  // futex() is compared for equality ahead of the binary search, which only
+  // ever uses BPF_JGE.
+  bool has_fast_path = false;
+  for (size_t i = 0; i < program->size(); ++i) {
+    const struct sock_filter& insn = (*program)[i];
+    if (insn.code == BPF_JMP + BPF_JEQ + BPF_K &&
+        insn.k == static_cast<uint32_t>(__NR_futex)) {
+      has_fast_path = true;
+    }
+  }
+  SANDBOX_ASSERT(has_fast_path);
+}
+
+// Reports the time a system call takes under a policy, both for a system
+// call on the fast path and for one found by the jump table.
+BPF_TEST(SandboxBPF, SyscallOverhead, ScatteredBlacklistPolicy) {
+  const int kIterations = 100000;
+
+  int futex_word = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    SandboxSyscall(__NR_futex, &futex_word, FUTEX_WAKE, 1, 0, 0, 0);
+  base::TimeDelta fast_path_time = base::TimeTicks::Now() - start;
+
+  start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    SandboxSyscall(__NR_getppid);
+  base::TimeDelta jump_table_time = base::TimeTicks::Now() - start;
+
+  std::cout << "futex(): "
+            << fast_path_time.InMicrosecondsF() * 1000 / kIterations
+            << " ns per call; getppid(): "
+            << jump_table_time.InMicrosecondsF() * 1000 / kIterations
+            << " ns per call\n";
+
+  BPF_ASSERT(SandboxSyscall(__NR_reboot, 0, 0, 0, 0) == -EPERM);
+}
+
 // A simple blacklist policy, with a SIGSYS handler
 
 intptr_t EnomemHandler(const struct arch_seccomp_data& args, void* aux) {
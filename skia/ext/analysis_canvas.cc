@@ -76,7 +76,9 @@ AnalysisDevice::AnalysisDevice(const SkBitmap& bitmap)
       is_forced_not_transparent_(false),
       is_solid_color_(true),
       is_transparent_(true),
-      has_text_(false) {}
+      has_text_(false),
+      slow_path_count_(0),
+      text_draw_count_(0) {}
 
 AnalysisDevice::~AnalysisDevice() {}
 
@@ -96,6 +98,14 @@ bool AnalysisDevice::HasText() const {
   return has_text_;
 }
 
+int AnalysisDevice::GetSlowPathCount() const {
+  return slow_path_count_;
+}
+
+int AnalysisDevice::GetTextDrawCount() const {
+  return text_draw_count_;
+}
+
 void AnalysisDevice::SetForceNotSolid(bool flag) {
   is_forced_not_solid_ = flag;
   if (is_forced_not_solid_)
@@ -199,6 +209,8 @@ void AnalysisDevice::drawPath(const SkDraw& draw,
                               bool path_is_mutable) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  if (paint.isAntiAlias() && !path.isConvex())
+    ++slow_path_count_;
 }
 
 void AnalysisDevice::drawBitmap(const SkDraw& draw,
@@ -239,6 +251,7 @@ void AnalysisDevice::drawText(const SkDraw& draw,
   is_solid_color_ = false;
   is_transparent_ = false;
   has_text_ = true;
+  ++text_draw_count_;
 }
 
 void AnalysisDevice::drawPosText(const SkDraw& draw,
@@ -251,6 +264,7 @@ void AnalysisDevice::drawPosText(const SkDraw& draw,
   is_solid_color_ = false;
   is_transparent_ = false;
   has_text_ = true;
+  ++text_draw_count_;
 }
 
 void AnalysisDevice::drawTextOnPath(const SkDraw& draw,
@@ -262,6 +276,7 @@ void AnalysisDevice::drawTextOnPath(const SkDraw& draw,
   is_solid_color_ = false;
   is_transparent_ = false;
   has_text_ = true;
+  ++text_draw_count_;
 }
 
 void AnalysisDevice::drawVertices(const SkDraw& draw,
@@ -303,6 +318,14 @@ bool AnalysisCanvas::HasText() const {
   return (static_cast<AnalysisDevice*>(getDevice()))->HasText();
 }
 
+int AnalysisCanvas::GetSlowPathCount() const {
+  return (static_cast<AnalysisDevice*>(getDevice()))->GetSlowPathCount();
+}
+
+int AnalysisCanvas::GetTextDrawCount() const {
+  return (static_cast<AnalysisDevice*>(getDevice()))->GetTextDrawCount();
+}
+
 bool AnalysisCanvas::abortDrawing() {
   // Early out as soon as we have detected that the tile has text.
   return HasText();
@@ -28,6 +28,11 @@ class SK_API AnalysisCanvas : public SkCanvas, public SkDrawPictureCallback {
   // Returns true when a SkColor can be used to represent result.
   bool GetColorIfSolid(SkColor* color) const;
   bool HasText() const;
+  // Returns the number of anti-aliased, concave paths drawn. These are
+  // costly to rasterize on the GPU.
+  int GetSlowPathCount() const;
+  // Returns the number of text draw calls.
+  int GetTextDrawCount() const;
 
   // SkDrawPictureCallback override.
   virtual bool abortDrawing() OVERRIDE;
@@ -68,6 +73,8 @@ class SK_API AnalysisDevice : public SkBitmapDevice {
 
   bool GetColorIfSolid(SkColor* color) const;
   bool HasText() const;
+  int GetSlowPathCount() const;
+  int GetTextDrawCount() const;
 
   void SetForceNotSolid(bool flag);
   void SetForceNotTransparent(bool flag);
@@ -154,6 +161,10 @@ class SK_API AnalysisDevice : public SkBitmapDevice {
   SkColor color_;
   bool is_transparent_;
   bool has_text_;
+  // Unlike the flags above, these aren't reset by clear(), since the draws
+  // still have to be replayed.
+  int slow_path_count_;
+  int text_draw_count_;
 };
 
 }  // namespace skia
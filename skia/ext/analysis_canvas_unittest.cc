@@ -404,4 +404,44 @@ TEST(AnalysisCanvasTest, HasText) {
   }
 }
 
+TEST(AnalysisCanvasTest, GpuRasterizationCosts) {
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kNo_Config, 100, 100);
+  skia::AnalysisDevice device(bitmap);
+  skia::AnalysisCanvas canvas(&device);
+  EXPECT_EQ(0, canvas.GetSlowPathCount());
+  EXPECT_EQ(0, canvas.GetTextDrawCount());
+
+  // A concave path.
+  SkPath path;
+  path.moveTo(SkIntToScalar(0), SkIntToScalar(0));
+  path.lineTo(SkIntToScalar(50), SkIntToScalar(10));
+  path.lineTo(SkIntToScalar(100), SkIntToScalar(0));
+  path.lineTo(SkIntToScalar(50), SkIntToScalar(100));
+  path.close();
+
+  SkPaint paint;
+  canvas.drawPath(path, paint);
+  EXPECT_EQ(0, canvas.GetSlowPathCount());
+
+  paint.setAntiAlias(true);
+  canvas.drawPath(path, paint);
+  EXPECT_EQ(1, canvas.GetSlowPathCount());
+
+  // Convex paths are cheap, even when anti-aliased.
+  SkPath convex_path;
+  convex_path.addRect(SkRect::MakeWH(SkIntToScalar(10), SkIntToScalar(10)));
+  canvas.drawPath(convex_path, paint);
+  EXPECT_EQ(1, canvas.GetSlowPathCount());
+
+  canvas.drawText("A", 1, SkIntToScalar(25), SkIntToScalar(25), paint);
+  canvas.drawText("B", 1, SkIntToScalar(50), SkIntToScalar(25), paint);
+  EXPECT_EQ(2, canvas.GetTextDrawCount());
+
+  // Clearing the canvas doesn't undo the cost of earlier draws.
+  canvas.clear(SK_ColorWHITE);
+  EXPECT_EQ(1, canvas.GetSlowPathCount());
+  EXPECT_EQ(2, canvas.GetTextDrawCount());
+}
+
 }  // namespace skia
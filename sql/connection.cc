@@ -12,6 +12,7 @@
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -214,8 +215,14 @@ Connection::Connection()
     : db_(NULL),
       page_size_(0),
       cache_size_(0),
+      mmap_size_(0),
       exclusive_locking_(false),
+      wal_mode_(false),
       restrict_to_user_(false),
+      statement_cache_(CachedStatementMap::NO_AUTO_EVICT),
+      statement_cache_size_(0),
+      statement_cache_hits_(0),
+      statement_cache_misses_(0),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
@@ -266,7 +273,14 @@ void Connection::CloseInternal(bool forced) {
   // sqlite3_close() needs all prepared statements to be finalized.
 
   // Release cached statements.
-  statement_cache_.clear();
+  statement_cache_.Clear();
+  if (statement_cache_hits_ || statement_cache_misses_) {
+    AddTaggedHistogram("Sqlite.StatementCacheHitRate",
+                       statement_cache_hits_ * 100 /
+                           (statement_cache_hits_ + statement_cache_misses_));
+  }
+  statement_cache_hits_ = 0;
+  statement_cache_misses_ = 0;
 
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
@@ -552,13 +566,16 @@ bool Connection::Delete(const base::FilePath& path) {
 
   base::FilePath journal_path(path.value() + FILE_PATH_LITERAL("-journal"));
   base::FilePath wal_path(path.value() + FILE_PATH_LITERAL("-wal"));
+  base::FilePath shm_path(path.value() + FILE_PATH_LITERAL("-shm"));
 
   base::DeleteFile(journal_path, false);
   base::DeleteFile(wal_path, false);
+  base::DeleteFile(shm_path, false);
   base::DeleteFile(path, false);
 
   return !base::PathExists(journal_path) &&
       !base::PathExists(wal_path) &&
+      !base::PathExists(shm_path) &&
       !base::PathExists(path);
 }
 
@@ -690,13 +707,13 @@ bool Connection::ExecuteWithTimeout(const char* sql, base::TimeDelta timeout) {
 }
 
 bool Connection::HasCachedStatement(const StatementID& id) const {
-  return statement_cache_.find(id) != statement_cache_.end();
+  return statement_cache_.Peek(id) != statement_cache_.end();
 }
 
 scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     const StatementID& id,
     const char* sql) {
-  CachedStatementMap::iterator i = statement_cache_.find(id);
+  CachedStatementMap::iterator i = statement_cache_.Get(id);
   if (i != statement_cache_.end()) {
     // Statement is in the cache. It should still be active (we're the only
     // one invalidating cached statements, and we'll remove it from the cache
@@ -704,12 +721,19 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     // case it still has some stuff bound.
     DCHECK(i->second->is_valid());
     sqlite3_reset(i->second->stmt());
+    ++statement_cache_hits_;
     return i->second;
   }
 
+  ++statement_cache_misses_;
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
-    statement_cache_[id] = statement;  // Only cache valid statements.
+  if (statement->is_valid()) {
+    // Only cache valid statements. Statements evicted while in use stay
+    // valid until their last reference goes away.
+    if (statement_cache_size_)
+      statement_cache_.ShrinkToSize(statement_cache_size_ - 1);
+    statement_cache_.Put(id, statement);
+  }
   return statement;
 }
 
@@ -917,8 +941,10 @@ bool Connection::OpenInternal(const std::string& file_name,
       // be fatal unless the file doesn't exist.
       base::FilePath journal_path(file_name + FILE_PATH_LITERAL("-journal"));
       base::FilePath wal_path(file_name + FILE_PATH_LITERAL("-wal"));
+      base::FilePath shm_path(file_name + FILE_PATH_LITERAL("-shm"));
       base::SetPosixFilePermissions(journal_path, mode);
       base::SetPosixFilePermissions(wal_path, mode);
+      base::SetPosixFilePermissions(shm_path, mode);
     }
   }
 #endif  // defined(OS_POSIX)
@@ -977,7 +1003,23 @@ bool Connection::OpenInternal(const std::string& file_name,
   // TODO(shess): Figure out if PERSIST and journal_size_limit really
   // matter.  In theory, it keeps pages pre-allocated, so if
   // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  // WAL - append to the -wal file to commit, see set_wal_mode().  With
+  // synchronous=NORMAL, commits don't sync, only checkpoints do.  A power
+  // loss can drop the last transactions, but won't corrupt the database.
+  bool use_wal = false;
+  if (wal_mode_ && !in_memory_ && !file_name.empty()) {
+    {
+      Statement journal_mode(GetUniqueStatement("PRAGMA journal_mode = WAL"));
+      use_wal = journal_mode.Step() &&
+          LowerCaseEqualsASCII(journal_mode.ColumnString(0), "wal");
+    }
+    if (use_wal)
+      ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+    else
+      DLOG(WARNING) << "Could not enable WAL mode: " << GetErrorMessage();
+  }
+  if (!use_wal)
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
   ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
 
   const base::TimeDelta kBusyTimeout =
@@ -1000,6 +1042,13 @@ bool Connection::OpenInternal(const std::string& file_name,
     ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
   }
 
+  // Versions of sqlite without memory mapped I/O silently ignore this.
+  if (mmap_size_ != 0) {
+    const std::string sql =
+        "PRAGMA mmap_size=" + base::Int64ToString(mmap_size_);
+    ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
+  }
+
   if (!ExecuteWithTimeout("PRAGMA secure_delete=ON", kBusyTimeout)) {
     bool was_poisoned = poisoned_;
     Close();
@@ -1011,6 +1060,25 @@ bool Connection::OpenInternal(const std::string& file_name,
   return true;
 }
 
+bool Connection::CheckpointWAL() {
+  AssertIOAllowed();
+
+  if (!db_) {
+    DLOG_IF(FATAL, !poisoned_) << "Cannot checkpoint null db";
+    return false;
+  }
+
+  int log_frames = 0;
+  int checkpointed_frames = 0;
+  int rc = sqlite3_wal_checkpoint_v2(db_, NULL, SQLITE_CHECKPOINT_PASSIVE,
+                                     &log_frames, &checkpointed_frames);
+  // |log_frames| is -1 if the database is not in WAL mode.
+  if (rc != SQLITE_OK || log_frames < 0)
+    return false;
+  AddTaggedHistogram("Sqlite.CheckpointedFrames", checkpointed_frames);
+  return true;
+}
+
 void Connection::DoRollback() {
   Statement rollback(GetCachedStatement(SQL_FROM_HERE, "ROLLBACK"));
   rollback.Run();
@@ -13,6 +13,7 @@
 #include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/containers/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/thread_restrictions.h"
@@ -105,6 +106,19 @@ class SQL_EXPORT Connection {
   // called before Open() to have an effect.
   void set_cache_size(int cache_size) { cache_size_ = cache_size; }
 
+  // Sets the number of bytes of the database file that sqlite may access
+  // through a memory mapping instead of read() and write() calls. This must
+  // be called before Open() to have an effect, and requires sqlite 3.7.17 or
+  // later; older versions ignore it.
+  void set_mmap_size(int64 mmap_size) { mmap_size_ = mmap_size; }
+
+  // Limits the number of statements kept by GetCachedStatement(). When the
+  // cache is full, the least recently used statement is released to make
+  // room. Zero, the default, means no limit.
+  void set_statement_cache_size(size_t size) {
+    statement_cache_size_ = size;
+  }
+
   // Call to put the database in exclusive locking mode. There is no "back to
   // normal" flag because of some additional requirements sqlite puts on this
   // transaition (requires another access to the DB) and because we don't
@@ -117,6 +131,18 @@ class SQL_EXPORT Connection {
   // This must be called before Open() to have an effect.
   void set_exclusive_locking() { exclusive_locking_ = true; }
 
+  // Call to use a write-ahead log instead of a rollback journal. Commits
+  // then only append to the -wal file, without waiting for it to reach the
+  // disk, and readers don't block the writer. The log is copied back into
+  // the database by checkpoints, which sqlite runs once the log gets large,
+  // and which CheckpointWAL() runs at a time of the caller's choosing.
+  // Databases which were opened in WAL mode before are put back in
+  // rollback-journal mode when this isn't called.
+  //
+  // This must be called before Open() to have an effect, and is ignored for
+  // in-memory and temporary databases.
+  void set_wal_mode() { wal_mode_ = true; }
+
   // Call to cause Open() to restrict access permissions of the
   // database file to only the owner.
   // TODO(shess): Currently only supported on OS_POSIX, is a noop on
@@ -206,6 +232,13 @@ class SQL_EXPORT Connection {
   // usage by half.
   void TrimMemory(bool aggressively);
 
+  // Copies as much of the write-ahead log into the database as can be done
+  // without waiting for other readers or writers, so that later commits
+  // don't have to. This blocks on I/O, so callers should run it when the
+  // database is otherwise idle. Returns false if the database isn't in WAL
+  // mode, or if the checkpoint failed.
+  bool CheckpointWAL();
+
   // Raze the database to the ground.  This approximates creating a
   // fresh database from scratch, within the constraints of SQLite's
   // locking protocol (locks and open handles can make doing this with
@@ -322,6 +355,11 @@ class SQL_EXPORT Connection {
   // cached.
   bool HasCachedStatement(const StatementID& id) const;
 
+  // Number of GetCachedStatement() calls which found, or had to prepare, the
+  // statement since the database was opened.
+  size_t statement_cache_hits() const { return statement_cache_hits_; }
+  size_t statement_cache_misses() const { return statement_cache_misses_; }
+
   // Returns a statement for the given SQL using the statement cache. It can
   // take a nontrivial amount of work to parse and compile a statement, so
   // keeping commonly-used ones around for future use is important for
@@ -555,14 +593,19 @@ class SQL_EXPORT Connection {
   // use the default value.
   int page_size_;
   int cache_size_;
+  int64 mmap_size_;
   bool exclusive_locking_;
+  bool wal_mode_;
   bool restrict_to_user_;
 
-  // All cached statements. Keeping a reference to these statements means that
-  // they'll remain active.
-  typedef std::map<StatementID, scoped_refptr<StatementRef> >
+  // All cached statements, most recently used first. Keeping a reference to
+  // these statements means that they'll remain active.
+  typedef base::MRUCache<StatementID, scoped_refptr<StatementRef> >
       CachedStatementMap;
   CachedStatementMap statement_cache_;
+  size_t statement_cache_size_;
+  size_t statement_cache_hits_;
+  size_t statement_cache_misses_;
 
   // A list of all StatementRefs we've given out. Each ref must register with
   // us when it's created or destroyed. This allows us to potentially close
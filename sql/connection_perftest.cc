@@ -0,0 +1,173 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays the lookups the history backend makes while navigating against a
+// database with the history schema, to compare statement cache and page
+// cache settings.
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "sql/connection.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+const int kUrlCount = 10000;
+const int kVisitsPerUrl = 5;
+const int kNavigations = 20000;
+
+// Same as HISTORY_URL_ROW_FIELDS in chrome/browser/history/url_database.h.
+#define URL_ROW_FIELDS \
+    " urls.id, urls.url, urls.title, urls.visit_count, urls.typed_count, " \
+    "urls.last_visit_time, urls.hidden "
+
+std::string UrlForIndex(int i) {
+  return base::StringPrintf("http://www.host%d.com/path/%d", i % 500, i);
+}
+
+class SQLConnectionPerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_path_ = temp_dir_.path().AppendASCII("History");
+
+    sql::Connection db;
+    ASSERT_TRUE(db.Open(db_path_));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE urls(id INTEGER PRIMARY KEY,url LONGVARCHAR,"
+        "title LONGVARCHAR,visit_count INTEGER DEFAULT 0 NOT NULL,"
+        "typed_count INTEGER DEFAULT 0 NOT NULL,"
+        "last_visit_time INTEGER NOT NULL,hidden INTEGER DEFAULT 0 NOT NULL,"
+        "favicon_id INTEGER DEFAULT 0 NOT NULL)"));
+    ASSERT_TRUE(db.Execute("CREATE INDEX urls_url_index ON urls (url)"));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE visits(id INTEGER PRIMARY KEY,url INTEGER NOT NULL,"
+        "visit_time INTEGER NOT NULL,from_visit INTEGER,"
+        "transition INTEGER DEFAULT 0 NOT NULL,segment_id INTEGER,"
+        "visit_duration INTEGER DEFAULT 0 NOT NULL)"));
+    ASSERT_TRUE(db.Execute("CREATE INDEX visits_url_index ON visits (url)"));
+    ASSERT_TRUE(db.Execute("CREATE INDEX visits_time_index "
+                           "ON visits (visit_time)"));
+
+    sql::Transaction transaction(&db);
+    ASSERT_TRUE(transaction.Begin());
+    for (int i = 0; i < kUrlCount; ++i) {
+      sql::Statement url(db.GetCachedStatement(SQL_FROM_HERE,
+          "INSERT INTO urls (id, url, title, visit_count, last_visit_time) "
+          "VALUES (?,?,?,?,?)"));
+      url.BindInt(0, i + 1);
+      url.BindString(1, UrlForIndex(i));
+      url.BindString(2, base::StringPrintf("Page %d", i));
+      url.BindInt(3, kVisitsPerUrl);
+      url.BindInt64(4, i);
+      ASSERT_TRUE(url.Run());
+      for (int j = 0; j < kVisitsPerUrl; ++j) {
+        sql::Statement visit(db.GetCachedStatement(SQL_FROM_HERE,
+            "INSERT INTO visits (url, visit_time, transition) "
+            "VALUES (?,?,?)"));
+        visit.BindInt(0, i + 1);
+        visit.BindInt64(1, j * kUrlCount + i);
+        visit.BindInt(2, j);
+        ASSERT_TRUE(visit.Run());
+      }
+    }
+    ASSERT_TRUE(transaction.Commit());
+  }
+
+  // Runs the statements of a navigation to the URL at |index|: the URL row
+  // lookup, its visits, the visit insertion and the row update, and the
+  // prefix match of the omnibox.
+  void Navigate(sql::Connection* db, int index, int64 time) {
+    sql::Statement url(db->GetCachedStatement(SQL_FROM_HERE,
+        "SELECT" URL_ROW_FIELDS "FROM urls WHERE url=?"));
+    url.BindString(0, UrlForIndex(index));
+    ASSERT_TRUE(url.Step());
+    int64 url_id = url.ColumnInt64(0);
+    int visit_count = url.ColumnInt(3);
+
+    sql::Statement visits(db->GetCachedStatement(SQL_FROM_HERE,
+        "SELECT id,url,visit_time,from_visit,transition,segment_id,"
+        "visit_duration FROM visits WHERE url=? ORDER BY visit_time LIMIT 10"));
+    visits.BindInt64(0, url_id);
+    while (visits.Step()) {
+    }
+
+    sql::Statement add_visit(db->GetCachedStatement(SQL_FROM_HERE,
+        "INSERT INTO visits (url, visit_time, transition) VALUES (?,?,?)"));
+    add_visit.BindInt64(0, url_id);
+    add_visit.BindInt64(1, time);
+    add_visit.BindInt(2, 0);
+    ASSERT_TRUE(add_visit.Run());
+
+    sql::Statement update(db->GetCachedStatement(SQL_FROM_HERE,
+        "UPDATE urls SET visit_count=?,last_visit_time=? WHERE id=?"));
+    update.BindInt(0, visit_count + 1);
+    update.BindInt64(1, time);
+    update.BindInt64(2, url_id);
+    ASSERT_TRUE(update.Run());
+
+    sql::Statement prefix(db->GetCachedStatement(SQL_FROM_HERE,
+        "SELECT" URL_ROW_FIELDS "FROM urls WHERE url >= ? AND url < ? "
+        "AND hidden = 0 ORDER BY typed_count DESC, visit_count DESC, "
+        "last_visit_time DESC LIMIT 3"));
+    std::string host = base::StringPrintf("http://www.host%d", index % 500);
+    prefix.BindString(0, host);
+    prefix.BindString(1, host + "\xff");
+    while (prefix.Step()) {
+    }
+  }
+
+  // Replays |kNavigations| navigations with the given settings, and prints
+  // the time they took.
+  void RunNavigations(const std::string& trace,
+                      size_t statement_cache_size,
+                      int cache_size) {
+    sql::Connection db;
+    db.set_page_size(4096);
+    db.set_statement_cache_size(statement_cache_size);
+    db.set_cache_size(cache_size);
+    ASSERT_TRUE(db.Open(db_path_));
+
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    sql::Transaction transaction(&db);
+    ASSERT_TRUE(transaction.Begin());
+    for (int i = 0; i < kNavigations; ++i) {
+      // Revisit popular pages more often, like real browsing does.
+      int index = (i * 7919) % (i % 4 ? 100 : kUrlCount);
+      Navigate(&db, index, kUrlCount * kVisitsPerUrl + i);
+    }
+    ASSERT_TRUE(transaction.Commit());
+    base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+
+    perf_test::PrintResult("navigation_time", "", trace,
+                           elapsed.InMicroseconds() /
+                               static_cast<double>(kNavigations),
+                           "us", true);
+    size_t lookups =
+        db.statement_cache_hits() + db.statement_cache_misses();
+    perf_test::PrintResult("statement_cache_hit_rate", "", trace,
+                           lookups ? 100.0 * db.statement_cache_hits() /
+                                         lookups : 0.0,
+                           "%", false);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath db_path_;
+};
+
+TEST_F(SQLConnectionPerfTest, HistoryNavigations) {
+  // History uses an unbounded statement cache and 1000 pages.
+  RunNavigations("history_settings", 0, 1000);
+  // Too small a statement cache recompiles statements on every navigation.
+  RunNavigations("statement_cache_2", 2, 1000);
+  // The page cache the smaller databases use.
+  RunNavigations("page_cache_32", 0, 32);
+}
+
+}  // namespace
@@ -167,6 +167,33 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, StatementCacheSize) {
+  sql::StatementID id1("foo", 1);
+  sql::StatementID id2("foo", 2);
+  sql::StatementID id3("foo", 3);
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  db().set_statement_cache_size(2);
+  const size_t hits = db().statement_cache_hits();
+  const size_t misses = db().statement_cache_misses();
+
+  ASSERT_TRUE(db().GetCachedStatement(id1, "SELECT a FROM foo")->is_valid());
+  ASSERT_TRUE(db().GetCachedStatement(id2, "SELECT b FROM foo")->is_valid());
+  EXPECT_TRUE(db().HasCachedStatement(id1));
+  EXPECT_TRUE(db().HasCachedStatement(id2));
+
+  // Using |id1| makes |id2| the least recently used statement, so it is the
+  // one released to make room for |id3|.
+  ASSERT_TRUE(db().GetCachedStatement(id1, "SELECT a FROM foo")->is_valid());
+  ASSERT_TRUE(db().GetCachedStatement(id3, "SELECT a, b FROM foo")->is_valid());
+  EXPECT_TRUE(db().HasCachedStatement(id1));
+  EXPECT_FALSE(db().HasCachedStatement(id2));
+  EXPECT_TRUE(db().HasCachedStatement(id3));
+
+  EXPECT_EQ(hits + 1, db().statement_cache_hits());
+  EXPECT_EQ(misses + 3, db().statement_cache_misses());
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -663,6 +690,38 @@ TEST_F(SQLConnectionTest, Delete) {
   EXPECT_FALSE(base::PathExists(journal));
 }
 
+std::string JournalMode(sql::Connection* db) {
+  sql::Statement s(db->GetUniqueStatement("PRAGMA journal_mode"));
+  return s.Step() ? s.ColumnString(0) : std::string();
+}
+
+TEST_F(SQLConnectionTest, WALMode) {
+  // An open database is not in WAL mode, and can't be checkpointed.
+  EXPECT_EQ("persist", JournalMode(&db()));
+  EXPECT_FALSE(db().CheckpointWAL());
+  db().Close();
+
+  sql::Connection wal_db;
+  wal_db.set_wal_mode();
+  ASSERT_TRUE(wal_db.Open(db_path()));
+  EXPECT_EQ("wal", JournalMode(&wal_db));
+  ASSERT_TRUE(wal_db.Execute("CREATE TABLE x (x)"));
+  ASSERT_TRUE(wal_db.Execute("INSERT INTO x VALUES (1)"));
+  base::FilePath wal(db_path().value() + FILE_PATH_LITERAL("-wal"));
+  EXPECT_TRUE(base::PathExists(wal));
+  EXPECT_TRUE(wal_db.CheckpointWAL());
+  wal_db.Close();
+
+  // Without set_wal_mode(), the database goes back to a rollback journal.
+  ASSERT_TRUE(db().Open(db_path()));
+  EXPECT_EQ("persist", JournalMode(&db()));
+  EXPECT_TRUE(db().DoesTableExist("x"));
+  db().Close();
+
+  sql::Connection::Delete(db_path());
+  EXPECT_FALSE(base::PathExists(wal));
+}
+
 #if defined(OS_POSIX)
 // Test that set_restrict_to_user() trims database permissions so that
 // only the owner (and root) can read.
@@ -175,6 +175,11 @@ bool Recovery::Init(const base::FilePath& db_path) {
   // is necessary for the final backup which rewrites things.  It
   // might be reasonable to close then re-open the handle.
   ignore_result(db_->Execute("PRAGMA writable_schema=1"));
+  // A database in WAL mode may keep its log index in private memory, where
+  // the attached version can't see it, and can't leave exclusive locking
+  // mode.  Leaving WAL mode copies the log into the database first.
+  if (db_->wal_mode_)
+    ignore_result(db_->Execute("PRAGMA journal_mode=PERSIST"));
   ignore_result(db_->Execute("PRAGMA locking_mode=NORMAL"));
   ignore_result(db_->Execute("SELECT COUNT(*) FROM sqlite_master"));
 
@@ -4,6 +4,8 @@
 
 #include "sync/engine/update_applicator.h"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #include "base/logging.h"
@@ -19,6 +21,56 @@ namespace syncer {
 
 using syncable::ID;
 
+namespace {
+
+// Orders |handles| so that each update comes after the update of its new
+// parent, if that is one of |handles|, or before it if |children_first|.
+// Updates in parent loops keep their relative order, at the end.
+void SortByHierarchy(syncable::BaseTransaction* trans,
+                     const std::vector<int64>& handles,
+                     bool children_first,
+                     std::vector<int64>* sorted) {
+  std::map<syncable::Id, size_t> index_by_id;
+  std::vector<syncable::Id> parent_ids;
+  parent_ids.reserve(handles.size());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    syncable::Entry entry(trans, syncable::GET_BY_HANDLE, handles[i]);
+    index_by_id[entry.GetId()] = i;
+    parent_ids.push_back(entry.GetServerParentId());
+  }
+
+  std::vector<std::vector<size_t> > children(handles.size());
+  std::vector<size_t> order;
+  order.reserve(handles.size());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    std::map<syncable::Id, size_t>::const_iterator parent =
+        index_by_id.find(parent_ids[i]);
+    if (parent == index_by_id.end() || parent->second == i)
+      order.push_back(i);
+    else
+      children[parent->second].push_back(i);
+  }
+
+  std::vector<bool> ordered(handles.size(), false);
+  for (size_t next = 0; next < order.size(); ++next) {
+    ordered[order[next]] = true;
+    const std::vector<size_t>& next_children = children[order[next]];
+    order.insert(order.end(), next_children.begin(), next_children.end());
+  }
+  for (size_t i = 0; i < handles.size(); ++i) {
+    if (!ordered[i])
+      order.push_back(i);
+  }
+
+  size_t start = sorted->size();
+  for (size_t i = 0; i < order.size(); ++i)
+    sorted->push_back(handles[order[i]]);
+  if (children_first)
+    std::reverse(sorted->begin() + start, sorted->end());
+}
+
+}  // namespace
+
 UpdateApplicator::UpdateApplicator(Cryptographer* cryptographer)
     : cryptographer_(cryptographer),
       updates_applied_(0),
@@ -46,7 +98,25 @@ UpdateApplicator::~UpdateApplicator() {
 void UpdateApplicator::AttemptApplications(
     syncable::WriteTransaction* trans,
     const std::vector<int64>& handles) {
-  std::vector<int64> to_apply = handles;
+  // The passes are only needed for the updates that come before those they
+  // depend on.  An initial sync downloads the items in no particular order,
+  // so apply new and moved items after their parents, and then deletions
+  // before the deletions of their parents, to apply most updates in the
+  // first pass.
+  std::vector<int64> live_handles;
+  std::vector<int64> deleted_handles;
+  for (std::vector<int64>::const_iterator i = handles.begin();
+       i != handles.end(); ++i) {
+    syncable::Entry entry(trans, syncable::GET_BY_HANDLE, *i);
+    if (entry.GetServerIsDel())
+      deleted_handles.push_back(*i);
+    else
+      live_handles.push_back(*i);
+  }
+  std::vector<int64> to_apply;
+  to_apply.reserve(handles.size());
+  SortByHierarchy(trans, live_handles, false, &to_apply);
+  SortByHierarchy(trans, deleted_handles, true, &to_apply);
 
   DVLOG(1) << "UpdateApplicator running over " << to_apply.size() << " items.";
   while (!to_apply.empty()) {
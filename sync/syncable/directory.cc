@@ -8,6 +8,7 @@
 
 #include "base/base64.h"
 #include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "sync/internal_api/public/base/unique_position.h"
@@ -171,6 +172,8 @@ DirOpenResult Directory::OpenImpl(
   kernel_ = new Kernel(name, info, delegate, transaction_observer);
   delete_journal_.reset(new DeleteJournal(&delete_journals));
   InitializeIndices(&tmp_handles_map);
+  UMA_HISTOGRAM_COUNTS("Sync.DirectoryEntryCount",
+                       kernel_->metahandles_map.size());
 
   // Write back the share info to reserve some space in 'next_id'.  This will
   // prevent local ID reuse in the case of an early crash.  See the comments in
@@ -502,7 +505,14 @@ bool Directory::SaveChanges() {
   // Snapshot and save.
   SaveChangesSnapshot snapshot;
   TakeSnapshotForSaveChanges(&snapshot);
+  base::TimeTicks start = base::TimeTicks::Now();
   success = store_->SaveChanges(snapshot);
+  if (!snapshot.dirty_metas.empty()) {
+    UMA_HISTOGRAM_TIMES("Sync.DirectorySaveChangesTime",
+                        base::TimeTicks::Now() - start);
+    UMA_HISTOGRAM_COUNTS("Sync.DirectorySaveChangesEntries",
+                         snapshot.dirty_metas.size());
+  }
 
   // Handle success or failure.
   if (success)
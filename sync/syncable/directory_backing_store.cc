@@ -34,6 +34,10 @@ namespace syncable {
 // modifies all the columns in the entry table.
 static const string::size_type kUpdateStatementBufferSize = 2048;
 
+// The number of metahandles deleted by one statement.  Well under SQLite's
+// default limit of 999 host parameters.
+static const size_t kDeleteBatchSize = 64;
+
 // Increment this version whenever updating DB tables.
 const int32 kCurrentDBVersion = 86;
 
@@ -175,9 +179,45 @@ bool DirectoryBackingStore::DeleteEntries(EntryTable from,
   if (handles.empty())
     return true;
 
+  // Purges after a type is disabled can delete thousands of entries, so
+  // delete them kDeleteBatchSize at a time, and only the remainder one by
+  // one.
+  MetahandleSet::const_iterator i = handles.begin();
+  if (handles.size() >= kDeleteBatchSize) {
+    std::string sql = "DELETE FROM ";
+    sql.append(from == METAS_TABLE ? "metas" : "deleted_metas");
+    sql.append(" WHERE metahandle IN (?");
+    for (size_t j = 1; j < kDeleteBatchSize; ++j)
+      sql.append(", ?");
+    sql.append(")");
+
+    sql::Statement batch_statement;
+    // Call GetCachedStatement() separately to get different statements for
+    // different tables.
+    switch (from) {
+      case METAS_TABLE:
+        batch_statement.Assign(
+            db_->GetCachedStatement(SQL_FROM_HERE, sql.c_str()));
+        break;
+      case DELETE_JOURNAL_TABLE:
+        batch_statement.Assign(
+            db_->GetCachedStatement(SQL_FROM_HERE, sql.c_str()));
+        break;
+    }
+
+    for (size_t remaining = handles.size(); remaining >= kDeleteBatchSize;
+         remaining -= kDeleteBatchSize) {
+      for (size_t j = 0; j < kDeleteBatchSize; ++j, ++i)
+        batch_statement.BindInt64(static_cast<int>(j), *i);
+      if (!batch_statement.Run())
+        return false;
+      batch_statement.Reset(true);
+    }
+  }
+  if (i == handles.end())
+    return true;
+
   sql::Statement statement;
-  // Call GetCachedStatement() separately to get different statements for
-  // different tables.
   switch (from) {
     case METAS_TABLE:
       statement.Assign(db_->GetCachedStatement(
@@ -189,8 +229,7 @@ bool DirectoryBackingStore::DeleteEntries(EntryTable from,
       break;
   }
 
-  for (MetahandleSet::const_iterator i = handles.begin(); i != handles.end();
-       ++i) {
+  for (; i != handles.end(); ++i) {
     statement.BindInt64(0, *i);
     if (!statement.Run())
       return false;
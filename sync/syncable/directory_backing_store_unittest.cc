@@ -4,6 +4,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/file_util.h"
@@ -3488,6 +3489,45 @@ TEST_F(DirectoryBackingStoreTest, DeleteEntries) {
   EXPECT_EQ(0U, handles_map.size());
 }
 
+// Deletes more entries than fit in one statement, including some that aren't
+// in the database, to exercise both the batched and the single deletes.
+TEST_F(DirectoryBackingStoreTest, DeleteEntriesInBatches) {
+  sql::Connection connection;
+  ASSERT_TRUE(connection.OpenInMemory());
+
+  SetUpCurrentDatabaseAndCheckVersion(&connection);
+  scoped_ptr<TestDirectoryBackingStore> dbs(
+      new TestDirectoryBackingStore(GetUsername(), &connection));
+  Directory::MetahandlesMap handles_map;
+  JournalIndex  delete_journals;
+  Directory::KernelLoadInfo kernel_load_info;
+  STLValueDeleter<Directory::MetahandlesMap> index_deleter(&handles_map);
+
+  dbs->Load(&handles_map, &delete_journals, &kernel_load_info);
+  ASSERT_LT(1U, handles_map.size()) << "Test requires handles_map to delete.";
+
+  // Keep the first entry.
+  int64 survivor = handles_map.begin()->first;
+  MetahandleSet to_delete;
+  int64 max_handle = 0;
+  for (Directory::MetahandlesMap::iterator it = handles_map.begin();
+       it != handles_map.end(); ++it) {
+    if (it->first != survivor)
+      to_delete.insert(it->first);
+    max_handle = std::max(max_handle, it->first);
+  }
+  for (int64 i = 1; i <= 200; ++i)
+    to_delete.insert(max_handle + i);
+
+  EXPECT_TRUE(dbs->DeleteEntries(TestDirectoryBackingStore::METAS_TABLE,
+                                 to_delete));
+
+  STLDeleteValues(&handles_map);
+  dbs->LoadEntries(&handles_map);
+  ASSERT_EQ(1U, handles_map.size());
+  EXPECT_EQ(survivor, handles_map.begin()->first);
+}
+
 TEST_F(DirectoryBackingStoreTest, GenerateCacheGUID) {
   const std::string& guid1 = TestDirectoryBackingStore::GenerateCacheGUID();
   const std::string& guid2 = TestDirectoryBackingStore::GenerateCacheGUID();
@@ -7,7 +7,12 @@
 #include "base/lazy_instance.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "env_chromium_stdio.h"
+#include "leveldb/cache.h"
+#include "leveldb/db.h"
+#include "leveldb/filter_policy.h"
 #include "third_party/re2/re2/re2.h"
 
 #if defined(OS_WIN)
@@ -109,6 +114,35 @@ class IDBEnvWin : public ChromiumEnvWin {
 ::base::LazyInstance<ChromiumEnvStdio>::Leaky default_env =
     LAZY_INSTANCE_INITIALIZER;
 
+// Bits per key of the Bloom filters, which gives about 1% false positives.
+const int kBloomFilterBitsPerKey = 10;
+
+class SharedBlockCacheHolder {
+ public:
+  SharedBlockCacheHolder() : cache_(NewLRUCache(kSharedBlockCacheSize)) {}
+  Cache* cache() { return cache_; }
+
+ private:
+  Cache* cache_;
+};
+
+class BloomFilterPolicyHolder {
+ public:
+  BloomFilterPolicyHolder()
+      : policy_(NewBloomFilterPolicy(kBloomFilterBitsPerKey)) {}
+  const FilterPolicy* policy() { return policy_; }
+
+ private:
+  const FilterPolicy* policy_;
+};
+
+// Both are leaked, databases may still use them at shutdown.
+::base::LazyInstance<SharedBlockCacheHolder>::Leaky shared_block_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+::base::LazyInstance<BloomFilterPolicyHolder>::Leaky bloom_filter_policy =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // unnamed namespace
 
 const char* MethodIDToString(MethodID method) {
@@ -329,6 +363,34 @@ std::string FilePathToString(const base::FilePath& file_path) {
 #endif
 }
 
+Cache* SharedBlockCache() {
+  return shared_block_cache.Get().cache();
+}
+
+const FilterPolicy* BloomFilterPolicy() {
+  return bloom_filter_policy.Get().policy();
+}
+
+int GetReadAmplification(DB* db) {
+  int read_amplification = 0;
+  // GetProperty() fails past the last level.
+  for (int level = 0;; ++level) {
+    std::string num_files;
+    if (!db->GetProperty(
+            base::StringPrintf("leveldb.num-files-at-level%d", level),
+            &num_files)) {
+      break;
+    }
+    int files = 0;
+    base::StringToInt(num_files, &files);
+    if (level == 0)
+      read_amplification += files;
+    else if (files > 0)
+      ++read_amplification;
+  }
+  return read_amplification;
+}
+
 base::FilePath ChromiumEnv::CreateFilePath(const std::string& file_path) {
 #if defined(OS_WIN)
   return base::FilePath(base::UTF8ToUTF16(file_path));
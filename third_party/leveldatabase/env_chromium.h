@@ -15,6 +15,12 @@
 #include "port/port_chromium.h"
 #include "util/mutexlock.h"
 
+namespace leveldb {
+class Cache;
+class DB;
+class FilterPolicy;
+}
+
 namespace leveldb_env {
 
 enum MethodID {
@@ -74,6 +80,34 @@ bool IsIOError(const leveldb::Status& status);
 bool IsCorruption(const leveldb::Status& status);
 std::string FilePathToString(const base::FilePath& file_path);
 
+// The settings below are tuned for SSDs, and callers opt into them by
+// setting them on their leveldb::Options.
+
+// Total size of the block cache returned by SharedBlockCache().
+#if defined(OS_ANDROID)
+const size_t kSharedBlockCacheSize = 8 * 1024 * 1024;
+#else
+const size_t kSharedBlockCacheSize = 32 * 1024 * 1024;
+#endif
+
+// Write buffer size that makes fewer and larger level-0 tables than
+// LevelDB's 4MB default, so that there are fewer compactions.
+const size_t kLargeWriteBufferSize = 8 * 1024 * 1024;
+
+// Returns a block cache shared by all the databases of the process that use
+// it, so that their cached blocks stay within kSharedBlockCacheSize however
+// many of them are open.
+leveldb::Cache* SharedBlockCache();
+
+// Returns a Bloom filter policy, so that reads of missing keys don't have to
+// go to disk for every table. Filters hash the bytes of the keys, so only
+// use it with comparators for which keys are equal only if their bytes are.
+const leveldb::FilterPolicy* BloomFilterPolicy();
+
+// Returns the number of tables that a read of a missing key may have to look
+// at in |db|: every level-0 table plus one for each non-empty deeper level.
+int GetReadAmplification(leveldb::DB* db);
+
 class UMALogger {
  public:
   virtual void RecordErrorAt(MethodID method) const = 0;
@@ -255,4 +255,35 @@ TEST(ChromiumEnv, GetChildrenPriorResults) {
   EXPECT_EQ(1, result.size());
 }
 
+TEST(ChromiumEnv, SharedTuning) {
+  Options options;
+  options.create_if_missing = true;
+  options.block_cache = SharedBlockCache();
+  options.filter_policy = BloomFilterPolicy();
+  options.write_buffer_size = kLargeWriteBufferSize;
+
+  base::ScopedTempDir scoped_temp_dir;
+  scoped_temp_dir.CreateUniqueTempDir();
+  base::FilePath dir = scoped_temp_dir.path();
+
+  DB* db;
+  Status status = DB::Open(options, dir.AsUTF8Unsafe(), &db);
+  EXPECT_TRUE(status.ok()) << status.ToString();
+  scoped_ptr<DB> scoped_db(db);
+  EXPECT_EQ(0, GetReadAmplification(db));
+
+  status = db->Put(WriteOptions(), "key", "value");
+  EXPECT_TRUE(status.ok()) << status.ToString();
+  db->CompactRange(NULL, NULL);
+  // All the data is in one table after a full compaction.
+  EXPECT_EQ(1, GetReadAmplification(db));
+
+  std::string value;
+  status = db->Get(ReadOptions(), "key", &value);
+  EXPECT_TRUE(status.ok()) << status.ToString();
+  EXPECT_EQ("value", value);
+  status = db->Get(ReadOptions(), "missing", &value);
+  EXPECT_TRUE(status.IsNotFound()) << status.ToString();
+}
+
 int main(int argc, char** argv) { return base::TestSuite(argc, argv).Run(); }
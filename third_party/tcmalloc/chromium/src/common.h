@@ -94,6 +94,10 @@ static const size_t kMaxSize    = 8u * kPageSize;
 // For all span-lengths < kMaxPages we keep an exact-size list.
 static const size_t kMaxPages = 1 << (20 - kPageShift);
 
+// The size of the transparent huge pages of the kernel, which system memory
+// is allocated and released in when FLAGS_malloc_hugepages is set.
+static const size_t kHugePageSize = 2 << 20;
+
 // Default bound on the total amount of thread caches.
 #ifdef TCMALLOC_SMALL_BUT_SLOW
 // Make the overall thread cache no bigger than that of a single thread
@@ -50,6 +50,8 @@ DEFINE_double(tcmalloc_release_rate,
               "to return memory slower.  Reasonable rates are in the "
               "range [0,10]");
 
+DECLARE_bool(malloc_hugepages);
+
 namespace tcmalloc {
 
 PageHeap::PageHeap()
@@ -467,8 +469,16 @@ bool PageHeap::GrowHeap(Length n) {
   ASSERT(kMaxPages >= kMinSystemAlloc);
   if (n > kMaxValidPages) return false;
   Length ask = (n>kMinSystemAlloc) ? n : static_cast<Length>(kMinSystemAlloc);
+  size_t alignment = kPageSize;
+  if (FLAGS_malloc_hugepages) {
+    // Grow in whole, aligned huge pages so that all of the new memory can be
+    // backed by them.
+    const Length hugepage_pages = kHugePageSize >> kPageShift;
+    ask = ((ask + hugepage_pages - 1) / hugepage_pages) * hugepage_pages;
+    alignment = kHugePageSize;
+  }
   size_t actual_size;
-  void* ptr = TCMalloc_SystemAlloc(ask << kPageShift, &actual_size, kPageSize);
+  void* ptr = TCMalloc_SystemAlloc(ask << kPageShift, &actual_size, alignment);
   if (ptr == NULL) {
     if (n < ask) {
       // Try growing just "n" pages
@@ -280,6 +280,11 @@ DEFINE_bool(malloc_random_allocator,
             EnvToBool("TCMALLOC_ASLR", false),
 #endif
             "Whether to randomize the address space via mmap().");
+DEFINE_bool(malloc_hugepages,
+            EnvToBool("TCMALLOC_HUGEPAGES", false),
+            "Whether to ask the kernel to back the heap with transparent "
+            "huge pages.  The heap then grows in huge page aligned chunks, "
+            "and only whole huge pages are released to the system.");
 
 // static allocators
 class SbrkSysAllocator : public SysAllocator {
@@ -626,6 +631,19 @@ void* TCMalloc_SystemAlloc(size_t size, size_t *actual_size,
 
   void* result = sys_alloc->Alloc(size, actual_size, alignment);
   if (result != NULL) {
+#ifdef MADV_HUGEPAGE
+    if (FLAGS_malloc_hugepages) {
+      // Only whole huge pages can be backed by one, so skip the partial ones
+      // at the ends.  Failures only mean small pages are used.
+      const size_t hugepage_mask = kHugePageSize - 1;
+      size_t start = reinterpret_cast<size_t>(result);
+      size_t end = start + (actual_size ? *actual_size : size);
+      start = (start + hugepage_mask) & ~hugepage_mask;
+      end &= ~hugepage_mask;
+      if (end > start)
+        madvise(reinterpret_cast<char*>(start), end - start, MADV_HUGEPAGE);
+    }
+#endif
     if (actual_size) {
       CheckAddressBits<kAddressBits>(
           reinterpret_cast<uintptr_t>(result) + *actual_size - 1);
@@ -660,7 +678,12 @@ void TCMalloc_SystemRelease(void* start, size_t length) {
     return;
   }
   if (pagesize == 0) pagesize = getpagesize();
-  const size_t pagemask = pagesize - 1;
+  // Releasing part of a huge page splits it into small pages, so only
+  // release whole ones when the heap is backed by them.  The rest stays
+  // committed until its neighbours are released too.
+  const size_t release_unit = FLAGS_malloc_hugepages ? kHugePageSize
+                                                     : pagesize;
+  const size_t pagemask = release_unit - 1;
 
   size_t new_start = reinterpret_cast<size_t>(start);
   size_t end = new_start + length;
@@ -668,7 +691,7 @@ void TCMalloc_SystemRelease(void* start, size_t length) {
 
   // Round up the starting address and round down the ending address
   // to be page aligned:
-  new_start = (new_start + pagesize - 1) & ~pagemask;
+  new_start = (new_start + release_unit - 1) & ~pagemask;
   new_end = new_end & ~pagemask;
 
   ASSERT((new_start & pagemask) == 0);
@@ -156,6 +156,13 @@ SourceDir SourceDirForPath(const base::FilePath& source_root,
 // directory.
 SourceDir SourceDirForCurrentDirectory(const base::FilePath& source_root);
 
+// Writes |data| to the given file unless the file already holds exactly
+// |data|. Leaving unchanged files alone keeps their timestamps, so ninja
+// doesn't treat them as modified. Returns false if the file couldn't be
+// written.
+bool WriteFileIfChanged(const base::FilePath& file_path,
+                        const std::string& data);
+
 // -----------------------------------------------------------------------------
 
 // These functions return the various flavors of output and gen directories.
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -303,6 +305,37 @@ TEST(FilesystemUtils, SourceDirForPath) {
 #endif
 }
 
+TEST(FilesystemUtils, WriteFileIfChanged) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath file_path = temp_dir.path().AppendASCII("foo.ninja");
+
+  // A new file is written.
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "build foo: bar\n"));
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(file_path, &contents));
+  EXPECT_EQ("build foo: bar\n", contents);
+
+  // Backdate the file so that a rewrite would show.
+  base::Time old_time = base::Time::Now() - base::TimeDelta::FromDays(1);
+  ASSERT_TRUE(base::TouchFile(file_path, old_time, old_time));
+  base::File::Info info;
+  ASSERT_TRUE(base::GetFileInfo(file_path, &info));
+  base::Time backdated_time = info.last_modified;
+
+  // The same contents leave the file alone.
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "build foo: bar\n"));
+  ASSERT_TRUE(base::GetFileInfo(file_path, &info));
+  EXPECT_EQ(backdated_time, info.last_modified);
+
+  // Contents of the same size that differ are written.
+  EXPECT_TRUE(WriteFileIfChanged(file_path, "build foo: baz\n"));
+  ASSERT_TRUE(base::ReadFileToString(file_path, &contents));
+  EXPECT_EQ("build foo: baz\n", contents);
+  ASSERT_TRUE(base::GetFileInfo(file_path, &info));
+  EXPECT_NE(backdated_time, info.last_modified);
+}
+
 TEST(FilesystemUtils, GetToolchainDirs) {
   BuildSettings build_settings;
   build_settings.SetBuildDir(SourceDir("//out/Debug/"));
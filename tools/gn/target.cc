@@ -29,18 +29,20 @@ void MergeDirectDependentConfigsFrom(const Target* from_target,
 
 // Like MergeDirectDependentConfigsFrom above except does the "all dependent"
 // ones. This additionally adds all configs to the all_dependent_configs_ of
-// the dest target given in *all_dest.
+// the dest target given in *all_dest, de-duped with unique_all_configs.
 void MergeAllDependentConfigsFrom(const Target* from_target,
                                   ConfigSet* unique_configs,
                                   LabelConfigVector* dest,
+                                  ConfigSet* unique_all_configs,
                                   LabelConfigVector* all_dest) {
   const LabelConfigVector& all = from_target->all_dependent_configs();
   for (size_t i = 0; i < all.size(); i++) {
-    // Always add it to all_dependent_configs_ since it might not be in that
-    // list even if we've seen it applied to this target before. This may
-    // introduce some duplicates in all_dependent_configs_, but those will
-    // we removed when they're actually applied to a target.
-    all_dest->push_back(all[i]);
+    // Add it to all_dependent_configs_ even if we've seen it applied to this
+    // target before, since it might not be in that list. Each target passes
+    // the list on to all of its dependents, so keeping duplicates would grow
+    // the lists with every level of the dependency tree.
+    if (unique_all_configs->insert(all[i].ptr).second)
+      all_dest->push_back(all[i]);
     if (unique_configs->find(all[i].ptr) == unique_configs->end()) {
       // One we haven't seen yet, also apply it to ourselves.
       dest->push_back(all[i]);
@@ -152,11 +154,15 @@ bool Target::IsLinkable() const {
 }
 
 void Target::PullDependentTargetInfo(std::set<const Config*>* unique_configs) {
+  ConfigSet unique_all_configs;
+  for (size_t i = 0; i < all_dependent_configs_.size(); i++)
+    unique_all_configs.insert(all_dependent_configs_[i].ptr);
+
   // Gather info from our dependents we need.
   for (size_t dep_i = 0; dep_i < deps_.size(); dep_i++) {
     const Target* dep = deps_[dep_i].ptr;
     MergeAllDependentConfigsFrom(dep, unique_configs, &configs_,
-                                 &all_dependent_configs_);
+                                 &unique_all_configs, &all_dependent_configs_);
     MergeDirectDependentConfigsFrom(dep, unique_configs, &configs_);
 
     // Direct dependent libraries.
@@ -169,10 +175,8 @@ void Target::PullDependentTargetInfo(std::set<const Config*>* unique_configs) {
     // boundaries.
     if (dep->output_type() != SHARED_LIBRARY &&
         dep->output_type() != EXECUTABLE) {
-      const std::set<const Target*> inherited = dep->inherited_libraries();
-      for (std::set<const Target*>::const_iterator i = inherited.begin();
-           i != inherited.end(); ++i)
-        inherited_libraries_.insert(*i);
+      const std::set<const Target*>& inherited = dep->inherited_libraries();
+      inherited_libraries_.insert(inherited.begin(), inherited.end());
 
       // Inherited library settings.
       all_lib_dirs_.append(dep->all_lib_dirs());
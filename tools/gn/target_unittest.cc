@@ -169,3 +169,34 @@ TEST_F(TargetTest, DependentConfigs) {
   ASSERT_EQ(1u, a_fwd.all_dependent_configs().size());
   EXPECT_EQ(&all, a_fwd.all_dependent_configs()[0].ptr);
 }
+
+// Tests that an all_dependent_config reaching a target through several deps
+// is only passed on once.
+TEST_F(TargetTest, AllDependentConfigsDiamond) {
+  // Set up a diamond of a -> b -> d and a -> c -> d.
+  Target a(&settings_, Label(SourceDir("//foo/"), "a"));
+  a.set_output_type(Target::EXECUTABLE);
+  Target b(&settings_, Label(SourceDir("//foo/"), "b"));
+  b.set_output_type(Target::STATIC_LIBRARY);
+  Target c(&settings_, Label(SourceDir("//foo/"), "c"));
+  c.set_output_type(Target::STATIC_LIBRARY);
+  Target d(&settings_, Label(SourceDir("//foo/"), "d"));
+  d.set_output_type(Target::STATIC_LIBRARY);
+  a.deps().push_back(LabelTargetPair(&b));
+  a.deps().push_back(LabelTargetPair(&c));
+  b.deps().push_back(LabelTargetPair(&d));
+  c.deps().push_back(LabelTargetPair(&d));
+
+  Config all(&settings_, Label(SourceDir("//foo/"), "all"));
+  d.all_dependent_configs().push_back(LabelConfigPair(&all));
+
+  d.OnResolved();
+  b.OnResolved();
+  c.OnResolved();
+  a.OnResolved();
+
+  ASSERT_EQ(1u, a.configs().size());
+  EXPECT_EQ(&all, a.configs()[0].ptr);
+  ASSERT_EQ(1u, a.all_dependent_configs().size());
+  EXPECT_EQ(&all, a.all_dependent_configs()[0].ptr);
+}
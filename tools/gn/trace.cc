@@ -112,6 +112,46 @@ void SummarizeScriptExecs(std::vector<const TraceItem*>& execs,
   SummarizeCoalesced(execs, out);
 }
 
+const char* GetTypeName(TraceItem::Type type) {
+  switch (type) {
+    case TraceItem::TRACE_FILE_LOAD:
+      return "File loads";
+    case TraceItem::TRACE_FILE_PARSE:
+      return "File parses";
+    case TraceItem::TRACE_FILE_EXECUTE:
+      return "File executions";
+    case TraceItem::TRACE_FILE_WRITE:
+      return "File writes";
+    case TraceItem::TRACE_SCRIPT_EXECUTE:
+      return "Script executions";
+    case TraceItem::TRACE_DEFINE_TARGET:
+      return "Target definitions";
+  }
+  return "";
+}
+
+// Totals each kind of event, to tell which phase of the run to look at first.
+// Events run in parallel on the worker threads, so the totals can add up to
+// more than the run took.
+void SummarizeTotals(const std::vector<TraceItem*>& events,
+                     std::ostream& out) {
+  out << "Total times: (total time in ms over all threads, # events, kind)\n";
+
+  std::map<TraceItem::Type, Coalesced> totals;
+  for (size_t i = 0; i < events.size(); i++) {
+    Coalesced& c = totals[events[i]->type()];
+    c.total_duration += events[i]->delta().InMillisecondsF();
+    c.count++;
+  }
+
+  for (std::map<TraceItem::Type, Coalesced>::iterator iter = totals.begin();
+       iter != totals.end(); ++iter) {
+    out << base::StringPrintf(" %8.2f  %d  ",
+                              iter->second.total_duration, iter->second.count);
+    out << GetTypeName(iter->first) << std::endl;
+  }
+}
+
 }  // namespace
 
 TraceItem::TraceItem(Type type,
@@ -206,6 +246,8 @@ std::string SummarizeTraces() {
   }
 
   std::ostringstream out;
+  SummarizeTotals(events, out);
+  out << std::endl;
   SummarizeParses(parses, out);
   out << std::endl;
   SummarizeFileExecs(file_execs, out);
@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <vector>
+
 #include "base/at_exit.h"
 #include "base/bind.h"
 #include "base/command_line.h"
@@ -19,6 +22,8 @@
 #include "ui/aura/root_window.h"
 #include "ui/aura/test/test_focus_client.h"
 #include "ui/aura/test/test_screen.h"
+#include "ui/aura/test/test_window_delegate.h"
+#include "ui/aura/test/test_windows.h"
 #include "ui/aura/window.h"
 #include "ui/base/hit_test.h"
 #include "ui/compositor/compositor.h"
@@ -280,6 +285,51 @@ class SoftwareScrollBench : public BenchCompositorObserver {
   DISALLOW_COPY_AND_ASSIGN(SoftwareScrollBench);
 };
 
+// Times finding the event handler under points spread over the screen, as
+// for each mouse move, in a tree of windows like that of a busy desktop.
+void RunHitTestBench(aura::Window* root_window, int iterations) {
+  const int kContainers = 10;
+  const int kWindowsPerContainer = 20;
+  const int kChildrenPerWindow = 10;
+
+  aura::test::TestWindowDelegate delegate;
+  gfx::Rect screen_bounds(root_window->bounds().size());
+  std::vector<aura::Window*> containers;
+  for (int i = 0; i < kContainers; ++i) {
+    aura::Window* container =
+        aura::test::CreateTestWindowWithBounds(screen_bounds, root_window);
+    containers.push_back(container);
+    for (int j = 0; j < kWindowsPerContainer; ++j) {
+      gfx::Rect bounds((i * 97 + j * 53) % screen_bounds.width(),
+                       (i * 61 + j * 37) % screen_bounds.height(),
+                       400, 300);
+      aura::Window* window = aura::test::CreateTestWindowWithDelegate(
+          &delegate, 0, bounds, container);
+      for (int k = 0; k < kChildrenPerWindow; ++k) {
+        aura::test::CreateTestWindowWithDelegate(
+            &delegate, 0, gfx::Rect(k * 40, 30, 40, 40), window);
+      }
+    }
+  }
+
+  int hits = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < iterations; ++i) {
+    gfx::Point point(i * 31 % screen_bounds.width(),
+                     i * 17 % screen_bounds.height());
+    if (root_window->GetEventHandlerForPoint(point))
+      ++hits;
+  }
+  base::TimeDelta elapsed = TimeTicks::Now() - start;
+  LOG(INFO) << "Hit tests: " << iterations << " in "
+            << elapsed.InMillisecondsF() << " ms ("
+            << elapsed.InMicroseconds() / std::max(iterations, 1)
+            << " us each, " << hits << " hits)";
+
+  for (size_t i = 0; i < containers.size(); ++i)
+    delete containers[i];
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -310,6 +360,16 @@ int main(int argc, char** argv) {
       new aura::test::TestFocusClient);
   aura::client::SetFocusClient(dispatcher->window(), focus_client.get());
 
+  CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch("bench-hit-test")) {
+    int iterations =
+        atoi(command_line->GetSwitchValueASCII("iterations").c_str());
+    RunHitTestBench(dispatcher->window(), iterations ? iterations : 100000);
+    focus_client.reset();
+    dispatcher.reset();
+    return 0;
+  }
+
   // add layers
   ColoredLayer background(SK_ColorRED);
   background.SetBounds(dispatcher->window()->bounds());
@@ -321,7 +381,6 @@ int main(int argc, char** argv) {
 
   Layer content_layer(ui::LAYER_NOT_DRAWN);
 
-  CommandLine* command_line = CommandLine::ForCurrentProcess();
   bool force = command_line->HasSwitch("force-render-surface");
   content_layer.SetForceRenderSurface(force);
   gfx::Rect bounds(window.bounds().size());
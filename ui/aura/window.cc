@@ -993,6 +993,11 @@ Window* Window::GetWindowForPoint(const gfx::Point& local_point,
   if (!return_tightest && delegate_)
     return this;
 
+  // The client may not allow events to be processed by certain subtrees.
+  client::EventClient* client = NULL;
+  if (for_event_handling && !children_.empty())
+    client = client::GetEventClient(GetRootWindow());
+
   for (Windows::const_reverse_iterator it = children_.rbegin(),
            rend = children_.rend();
        it != rend; ++it) {
@@ -1001,8 +1006,6 @@ Window* Window::GetWindowForPoint(const gfx::Point& local_point,
     if (for_event_handling) {
       if (child->ignore_events_)
         continue;
-      // The client may not allow events to be processed by certain subtrees.
-      client::EventClient* client = client::GetEventClient(GetRootWindow());
       if (client && !client->CanProcessEventsWithinSubtree(child))
         continue;
       if (delegate_ && !delegate_->ShouldDescendIntoChildForEventHandling(
@@ -256,10 +256,18 @@ class UI_BASE_EXPORT ResourceBundle {
   // Returns SCALE_FACTOR_100P if no resource is loaded.
   ScaleFactor GetMaxScaleFactor() const;
 
+  // Returns |bitmap| as a pre-decoded image resource, which loads without a
+  // PNG decode, for the tools which build data packs. |bitmap| must be
+  // kARGB_8888_Config.
+  static std::string EncodeDecodedImage(const SkBitmap& bitmap,
+                                        bool fell_back_to_1x);
+
  private:
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetPathForLocalePack);
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetImageNamed);
   FRIEND_TEST_ALL_PREFIXES(ResourceBundleTest, DelegateGetNativeImageNamed);
+  FRIEND_TEST_ALL_PREFIXES(ResourceBundleImageTest,
+                           ReadDecodedImageRejectsBadSizes);
 
   friend class ResourceBundleImageTest;
   friend class ResourceBundleTest;
@@ -347,6 +355,14 @@ class UI_BASE_EXPORT ResourceBundle {
                         SkBitmap* bitmap,
                         bool* fell_back_to_1x);
 
+  // Reads a pre-decoded image resource, as written by EncodeDecodedImage(),
+  // into |bitmap|. Returns false if |buf| isn't one. Loading one of these
+  // costs a copy of the pixels instead of a PNG decode.
+  static bool ReadDecodedImage(const unsigned char* buf,
+                               size_t size,
+                               SkBitmap* bitmap,
+                               bool* fell_back_to_1x);
+
   // Returns an empty image for when a resource cannot be loaded. This is a
   // bright red bitmap.
   gfx::Image& GetEmptyImage();
@@ -521,6 +521,73 @@ TEST_F(ResourceBundleImageTest, GetImageNamedFallback1x) {
   EXPECT_EQ(20, image_rep.pixel_height());
 }
 
+// Test that pre-decoded image resources load like PNGs, including those
+// marked as having fallen back to 1x.
+TEST_F(ResourceBundleImageTest, GetImageNamedPredecoded) {
+  std::vector<ScaleFactor> supported_factors;
+  supported_factors.push_back(SCALE_FACTOR_100P);
+  supported_factors.push_back(SCALE_FACTOR_200P);
+  test::ScopedSetSupportedScaleFactors scoped_supported(supported_factors);
+  base::FilePath data_path = dir_path().AppendASCII("sample.pak");
+  base::FilePath data_2x_path = dir_path().AppendASCII("sample_2x.pak");
+
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config, 10, 10);
+  bitmap.allocPixels();
+  bitmap.eraseColor(SK_ColorBLUE);
+  std::string data = ResourceBundle::EncodeDecodedImage(bitmap, false);
+  std::string data_2x = ResourceBundle::EncodeDecodedImage(bitmap, true);
+  std::map<uint16, base::StringPiece> resources;
+  resources[3u] = data;
+  DataPack::WritePack(data_path, resources, ui::DataPack::BINARY);
+  resources[3u] = data_2x;
+  DataPack::WritePack(data_2x_path, resources, ui::DataPack::BINARY);
+
+  ResourceBundle* resource_bundle = CreateResourceBundleWithEmptyLocalePak();
+  resource_bundle->AddDataPackFromPath(data_path, SCALE_FACTOR_100P);
+  resource_bundle->AddDataPackFromPath(data_2x_path, SCALE_FACTOR_200P);
+
+  gfx::ImageSkia* image_skia = resource_bundle->GetImageSkiaNamed(3);
+  gfx::ImageSkiaRep image_rep =
+      image_skia->GetRepresentation(GetImageScale(ui::SCALE_FACTOR_100P));
+  EXPECT_EQ(10, image_rep.pixel_width());
+  EXPECT_EQ(10, image_rep.pixel_height());
+  {
+    SkAutoLockPixels lock(image_rep.sk_bitmap());
+    EXPECT_EQ(SK_ColorBLUE, image_rep.sk_bitmap().getColor(5, 5));
+  }
+
+  // The 2x resource is 1x data, so it is resized.
+  image_rep =
+      image_skia->GetRepresentation(GetImageScale(ui::SCALE_FACTOR_200P));
+  EXPECT_EQ(20, image_rep.pixel_width());
+  EXPECT_EQ(20, image_rep.pixel_height());
+}
+
+TEST_F(ResourceBundleImageTest, ReadDecodedImageRejectsBadSizes) {
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config, 4, 4);
+  bitmap.allocPixels();
+  bitmap.eraseColor(SK_ColorWHITE);
+  std::string data = ResourceBundle::EncodeDecodedImage(bitmap, false);
+
+  SkBitmap result;
+  bool fell_back_to_1x = false;
+  EXPECT_TRUE(ResourceBundle::ReadDecodedImage(
+      reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+      &result, &fell_back_to_1x));
+  EXPECT_EQ(4, result.width());
+
+  // Truncated pixels.
+  EXPECT_FALSE(ResourceBundle::ReadDecodedImage(
+      reinterpret_cast<const unsigned char*>(data.data()), data.size() - 1,
+      &result, &fell_back_to_1x));
+  // Truncated header.
+  EXPECT_FALSE(ResourceBundle::ReadDecodedImage(
+      reinterpret_cast<const unsigned char*>(data.data()), 8, &result,
+      &fell_back_to_1x));
+}
+
 #if defined(OS_WIN)
 // Tests GetImageNamed() behaves properly when the size of a scaled image
 // requires rounding as a result of using a non-integer scale factor.
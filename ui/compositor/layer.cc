@@ -40,6 +40,29 @@ const ui::Layer* GetRoot(const ui::Layer* layer) {
   return layer;
 }
 
+int GetDepth(const ui::Layer* layer) {
+  int depth = 0;
+  for (; layer->parent(); layer = layer->parent())
+    ++depth;
+  return depth;
+}
+
+// Returns the nearest layer which is |a| or an ancestor of it and is |b| or
+// an ancestor of it, or NULL if they are in different trees.
+const ui::Layer* GetCommonAncestor(const ui::Layer* a, const ui::Layer* b) {
+  int depth_a = GetDepth(a);
+  int depth_b = GetDepth(b);
+  for (; depth_a > depth_b; --depth_a)
+    a = a->parent();
+  for (; depth_b > depth_a; --depth_b)
+    b = b->parent();
+  while (a != b) {
+    a = a->parent();
+    b = b->parent();
+  }
+  return a;
+}
+
 }  // namespace
 
 namespace ui {
@@ -382,13 +405,16 @@ void Layer::ConvertPointToLayer(const Layer* source,
   if (source == target)
     return;
 
-  const Layer* root_layer = GetRoot(source);
-  CHECK_EQ(root_layer, GetRoot(target));
+  // Going through the nearest common ancestor rather than the root spares
+  // transforming the point through the layers above it, which for a parent
+  // and a child, as when targeting events, are all of them.
+  const Layer* ancestor = GetCommonAncestor(source, target);
+  CHECK(ancestor);
 
-  if (source != root_layer)
-    source->ConvertPointForAncestor(root_layer, point);
-  if (target != root_layer)
-    target->ConvertPointFromAncestor(root_layer, point);
+  if (source != ancestor)
+    source->ConvertPointForAncestor(ancestor, point);
+  if (target != ancestor)
+    target->ConvertPointFromAncestor(ancestor, point);
 }
 
 bool Layer::GetTargetTransformRelativeTo(const Layer* ancestor,
@@ -511,6 +511,36 @@ TEST_F(LayerWithDelegateTest, ConvertPointToLayer_Medium) {
   EXPECT_EQ(point2_in_l3_coords, point2_in_l1_coords);
 }
 
+// L1
+//  +-- L2 (scaled)
+//       +-- L3
+// Converting between a layer and its child isn't rounded through the scale
+// of the layers above them.
+TEST_F(LayerWithDelegateTest, ConvertPointToLayer_ScaledAncestor) {
+  scoped_ptr<Layer> l1(CreateColorLayer(SK_ColorRED,
+                                        gfx::Rect(20, 20, 400, 400)));
+  scoped_ptr<Layer> l2(CreateColorLayer(SK_ColorBLUE,
+                                        gfx::Rect(10, 10, 350, 350)));
+  scoped_ptr<Layer> l3(CreateColorLayer(SK_ColorYELLOW,
+                                        gfx::Rect(6, 6, 100, 100)));
+  gfx::Transform scale;
+  scale.Scale(0.5, 0.5);
+  l2->SetTransform(scale);
+  l1->Add(l2.get());
+  l2->Add(l3.get());
+  DrawTree(l1.get());
+
+  gfx::Point point1_in_l2_coords(3, 3);
+  Layer::ConvertPointToLayer(l2.get(), l3.get(), &point1_in_l2_coords);
+  gfx::Point point1_in_l3_coords(-3, -3);
+  EXPECT_EQ(point1_in_l3_coords, point1_in_l2_coords);
+
+  gfx::Point point2_in_l3_coords(3, 3);
+  Layer::ConvertPointToLayer(l3.get(), l2.get(), &point2_in_l3_coords);
+  gfx::Point point2_in_l2_coords(9, 9);
+  EXPECT_EQ(point2_in_l2_coords, point2_in_l3_coords);
+}
+
 TEST_F(LayerWithRealCompositorTest, Delegate) {
   scoped_ptr<Layer> l1(CreateColorLayer(SK_ColorBLACK,
                                         gfx::Rect(20, 20, 400, 400)));
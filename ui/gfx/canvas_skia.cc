@@ -4,9 +4,12 @@
 
 #include "ui/gfx/canvas.h"
 
+#include "base/containers/mru_cache.h"
 #include "base/i18n/rtl.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/threading/thread_local.h"
 #include "ui/gfx/font_list.h"
 #include "ui/gfx/insets.h"
 #include "ui/gfx/range/range.h"
@@ -154,6 +157,45 @@ void UpdateRenderText(const Rect& rect,
   render_text->SetStyle(UNDERLINE, (font_style & Font::UNDERLINE) != 0);
 }
 
+// The single line strings drawn most recently on a thread are kept laid out,
+// since views draw the same labels again on every paint of their layers, and
+// laying out the text is most of the cost of drawing it.
+struct LaidOutTextKey {
+  base::string16 text;
+  std::string font_description;
+  int flags;
+  int width;
+
+  bool operator<(const LaidOutTextKey& other) const {
+    if (flags != other.flags)
+      return flags < other.flags;
+    if (width != other.width)
+      return width < other.width;
+    if (text != other.text)
+      return text < other.text;
+    return font_description < other.font_description;
+  }
+};
+
+const size_t kLaidOutTextCacheSize = 64;
+
+// The RenderTexts have their text elided and their accelerator underlined
+// already. The caches of the threads which draw text aren't freed when the
+// threads exit, which is only at shutdown for the UI thread.
+typedef base::OwningMRUCache<LaidOutTextKey, RenderText*> LaidOutTextCache;
+
+base::LazyInstance<base::ThreadLocalPointer<LaidOutTextCache> >::Leaky
+    g_laid_out_text_cache = LAZY_INSTANCE_INITIALIZER;
+
+LaidOutTextCache* GetLaidOutTextCache() {
+  LaidOutTextCache* cache = g_laid_out_text_cache.Pointer()->Get();
+  if (!cache) {
+    cache = new LaidOutTextCache(kLaidOutTextCacheSize);
+    g_laid_out_text_cache.Pointer()->Set(cache);
+  }
+  return cache;
+}
+
 }  // namespace
 
 // static
@@ -286,38 +328,54 @@ void Canvas::DrawStringRectWithShadows(const base::string16& text,
     }
   } else {
     Range range = StripAcceleratorChars(flags, &adjusted_text);
-    bool elide_text = ((flags & NO_ELLIPSIS) == 0);
+
+    LaidOutTextCache* cache = GetLaidOutTextCache();
+    LaidOutTextKey key;
+    key.text = adjusted_text;
+    key.font_description = font_list.GetFontDescriptionString();
+    key.flags = flags;
+    key.width = text_bounds.width();
+    LaidOutTextCache::iterator it = cache->Get(key);
+    if (it == cache->end()) {
+      bool elide_text = ((flags & NO_ELLIPSIS) == 0);
 
 #if defined(OS_LINUX)
-    // On Linux, eliding really means fading the end of the string. But only
-    // for LTR text. RTL text is still elided (on the left) with "...".
-    if (elide_text) {
-      render_text->SetText(adjusted_text);
-      if (render_text->GetTextDirection() == base::i18n::LEFT_TO_RIGHT) {
-        render_text->set_fade_tail(true);
-        elide_text = false;
+      // On Linux, eliding really means fading the end of the string. But only
+      // for LTR text. RTL text is still elided (on the left) with "...".
+      if (elide_text) {
+        render_text->SetText(adjusted_text);
+        if (render_text->GetTextDirection() == base::i18n::LEFT_TO_RIGHT) {
+          render_text->set_fade_tail(true);
+          elide_text = false;
+        }
       }
-    }
 #endif
 
-    if (elide_text) {
-      ElideTextAndAdjustRange(font_list,
-                              text_bounds.width(),
-                              &adjusted_text,
-                              &range);
-    }
+      if (elide_text) {
+        ElideTextAndAdjustRange(font_list,
+                                text_bounds.width(),
+                                &adjusted_text,
+                                &range);
+      }
 
-    UpdateRenderText(rect, adjusted_text, font_list, flags, color,
-                     render_text.get());
+      UpdateRenderText(rect, adjusted_text, font_list, flags, color,
+                       render_text.get());
+      if (range.IsValid())
+        render_text->ApplyStyle(UNDERLINE, true, range);
+
+      it = cache->Put(key, render_text.release());
+    } else {
+      it->second->SetColor(color);
+      it->second->SetTextShadows(shadows);
+    }
+    RenderText* laid_out_render_text = it->second;
 
-    const int text_height = render_text->GetStringSize().height();
+    const int text_height = laid_out_render_text->GetStringSize().height();
     // Center the text vertically.
     rect += Vector2d(0, (text_bounds.height() - text_height) / 2);
     rect.set_height(text_height);
-    render_text->SetDisplayRect(rect);
-    if (range.IsValid())
-      render_text->ApplyStyle(UNDERLINE, true, range);
-    render_text->Draw(this);
+    laid_out_render_text->SetDisplayRect(rect);
+    laid_out_render_text->Draw(this);
   }
 
   canvas_->restore();
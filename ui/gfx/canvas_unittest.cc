@@ -60,4 +60,34 @@ TEST_F(CanvasTest, MAYBE_StringSizeWithLineHeight) {
   EXPECT_EQ(3 * 1000 + one_line_size.height(), four_line_size.height());
 }
 
+// Drawing a string again, as views do on every paint, uses the new color.
+TEST_F(CanvasTest, DrawStringAgainWithAnotherColor) {
+  const base::string16 text = base::ASCIIToUTF16("Hello");
+  const Rect bounds(0, 0, 100, 30);
+  Canvas canvas(bounds.size(), 1.0f, true);
+  SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+  for (size_t i = 0; i < arraysize(colors); ++i) {
+    canvas.DrawColor(SK_ColorWHITE);
+    canvas.DrawStringRectWithFlags(text, font_list_, colors[i], bounds,
+                                   Canvas::NO_SUBPIXEL_RENDERING);
+  }
+
+  // Only blue was drawn over the white last.
+  const SkBitmap& bitmap = canvas.ExtractImageRep().sk_bitmap();
+  SkAutoLockPixels lock(bitmap);
+  int text_pixels = 0;
+  int red_pixels = 0;
+  for (int y = 0; y < bitmap.height(); ++y) {
+    for (int x = 0; x < bitmap.width(); ++x) {
+      SkColor pixel = bitmap.getColor(x, y);
+      if (pixel != SK_ColorWHITE)
+        ++text_pixels;
+      if (SkColorGetR(pixel) > SkColorGetB(pixel))
+        ++red_pixels;
+    }
+  }
+  EXPECT_GT(text_pixels, 0);
+  EXPECT_EQ(0, red_pixels);
+}
+
 }  // namespace gfx
@@ -4,8 +4,14 @@
 
 #include "ui/gfx/codec/png_codec.h"
 
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "build/build_config.h"
 #include "third_party/libpng/png.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
@@ -14,6 +20,13 @@
 #include "ui/gfx/size.h"
 #include "ui/gfx/skia_util.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PNG_CODEC_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace gfx {
 
 namespace {
@@ -21,7 +34,22 @@ namespace {
 // Converts BGRA->RGBA and RGBA->BGRA.
 void ConvertBetweenBGRAandRGBA(const unsigned char* input, int pixel_width,
                                unsigned char* output, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
+  int x = 0;
+#if defined(PNG_CODEC_USE_SSE2)
+  // Swaps the first and third bytes of four pixels at a time.
+  const __m128i green_alpha_mask = _mm_set1_epi32(0xff00ff00);
+  const __m128i byte_mask = _mm_set1_epi32(0xff);
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[x * 4]));
+    __m128i swapped = _mm_or_si128(
+        _mm_and_si128(pixels, green_alpha_mask),
+        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), byte_mask),
+                     _mm_slli_epi32(_mm_and_si128(pixels, byte_mask), 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[x * 4]), swapped);
+  }
+#endif
+  for (; x < pixel_width; x++) {
     const unsigned char* pixel_in = &input[x * 4];
     unsigned char* pixel_out = &output[x * 4];
     pixel_out[0] = pixel_in[2];
@@ -757,6 +785,15 @@ bool InternalEncodeSkBitmap(const SkBitmap& input,
       output);
 }
 
+scoped_refptr<base::RefCountedBytes> FastEncodeBGRASkBitmapOnWorker(
+    const SkBitmap& input,
+    bool discard_transparency) {
+  std::vector<unsigned char> output;
+  if (!InternalEncodeSkBitmap(input, discard_transparency, Z_BEST_SPEED,
+                              &output))
+    return scoped_refptr<base::RefCountedBytes>();
+  return base::RefCountedBytes::TakeVector(&output);
+}
 
 }  // namespace
 
@@ -807,6 +844,25 @@ bool PNGCodec::FastEncodeBGRASkBitmap(const SkBitmap& input,
                                 output);
 }
 
+// static
+void PNGCodec::FastEncodeBGRASkBitmapAsync(const SkBitmap& input,
+                                           bool discard_transparency,
+                                           const EncodeCallback& callback) {
+  // The caller may draw into |input| while it is being encoded.
+  SkBitmap copy;
+  if (input.empty() || input.isNull() ||
+      !input.deepCopyTo(&copy, input.getConfig())) {
+    callback.Run(scoped_refptr<base::RefCountedBytes>());
+    return;
+  }
+  copy.setImmutable();
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(),
+      FROM_HERE,
+      base::Bind(&FastEncodeBGRASkBitmapOnWorker, copy, discard_transparency),
+      callback);
+}
+
 PNGCodec::Comment::Comment(const std::string& k, const std::string& t)
     : key(k), text(t) {
 }
@@ -9,10 +9,16 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/callback_forward.h"
+#include "base/memory/ref_counted.h"
 #include "ui/gfx/gfx_export.h"
 
 class SkBitmap;
 
+namespace base {
+class RefCountedBytes;
+}
+
 namespace gfx {
 
 class Size;
@@ -94,6 +100,18 @@ class GFX_EXPORT PNGCodec {
                                      bool discard_transparency,
                                      std::vector<unsigned char>* output);
 
+  // Runs with the encoded PNG, or with NULL if the encode failed.
+  typedef base::Callback<void(scoped_refptr<base::RefCountedBytes>)>
+      EncodeCallback;
+
+  // Like FastEncodeBGRASkBitmap(), but encodes a copy of |input| on the worker
+  // pool, so that taking a screenshot or a thumbnail doesn't block the calling
+  // thread, and runs |callback| on the calling thread when done. The calling
+  // thread must have a message loop.
+  static void FastEncodeBGRASkBitmapAsync(const SkBitmap& input,
+                                          bool discard_transparency,
+                                          const EncodeCallback& callback);
+
   // Call PNGCodec::Encode on the supplied SkBitmap |input|, which is assumed
   // to be kA8_Config, 8 bits per pixel. The bitmap is encoded as a grayscale
   // PNG with alpha used for color intensity. The |output| param is passed
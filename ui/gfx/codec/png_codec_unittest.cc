@@ -5,7 +5,12 @@
 #include <algorithm>
 #include <cmath>
 
+#include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/libpng/png.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -265,6 +270,13 @@ void MakeTestBGRASkBitmap(int w, int h, SkBitmap* bmp) {
     src_data[i] = SkPreMultiplyARGB(i % 255, i % 250, i % 245, i % 240);
 }
 
+void OnEncoded(const base::Closure& quit_closure,
+               scoped_refptr<base::RefCountedBytes>* result,
+               scoped_refptr<base::RefCountedBytes> encoded) {
+  *result = encoded;
+  quit_closure.Run();
+}
+
 void MakeTestA8SkBitmap(int w, int h, SkBitmap* bmp) {
   bmp->setConfig(SkBitmap::kA8_Config, w, h);
   bmp->allocPixels();
@@ -1187,4 +1199,65 @@ TEST(PNGCodec, EncodeDecodeWithVaryingCompressionLevels) {
 }
 
 
+TEST(PNGCodec, EncodeMostlyOpaqueBGRASkBitmap) {
+  // An odd width leaves pixels at the end of each row for the conversion to
+  // do one at a time, and the translucent pixels make some blocks of pixels
+  // unpremultiply.
+  const int w = 23, h = 5;
+  SkBitmap original_bitmap;
+  original_bitmap.setConfig(SkBitmap::kARGB_8888_Config, w, h);
+  original_bitmap.allocPixels();
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int alpha = (x + y) % 7 == 0 ? 0x80 : 0xff;
+      original_bitmap.getAddr32(0, y)[x] =
+          SkPreMultiplyARGB(alpha, x * 11, y * 13, x * y);
+    }
+  }
+
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(
+      PNGCodec::FastEncodeBGRASkBitmap(original_bitmap, false, &encoded));
+
+  SkBitmap decoded_bitmap;
+  EXPECT_TRUE(PNGCodec::Decode(&encoded.front(), encoded.size(),
+                               &decoded_bitmap));
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      uint32_t original_pixel = original_bitmap.getAddr32(0, y)[x];
+      uint32_t decoded_pixel = decoded_bitmap.getAddr32(0, y)[x];
+      if (SkGetPackedA32(original_pixel) == 0xff)
+        EXPECT_EQ(original_pixel, decoded_pixel) << x << ", " << y;
+      else
+        EXPECT_TRUE(ColorsClose(original_pixel, decoded_pixel));
+    }
+  }
+}
+
+TEST(PNGCodec, FastEncodeBGRASkBitmapAsync) {
+  base::MessageLoop message_loop;
+  const int w = 20, h = 20;
+  SkBitmap original_bitmap;
+  MakeTestBGRASkBitmap(w, h, &original_bitmap);
+
+  scoped_refptr<base::RefCountedBytes> encoded;
+  base::RunLoop run_loop;
+  PNGCodec::FastEncodeBGRASkBitmapAsync(
+      original_bitmap, false,
+      base::Bind(&OnEncoded, run_loop.QuitClosure(), &encoded));
+  run_loop.Run();
+
+  ASSERT_TRUE(encoded.get());
+  std::vector<unsigned char> expected;
+  EXPECT_TRUE(
+      PNGCodec::FastEncodeBGRASkBitmap(original_bitmap, false, &expected));
+  EXPECT_EQ(expected, encoded->data());
+
+  // Empty bitmaps fail right away.
+  PNGCodec::FastEncodeBGRASkBitmapAsync(
+      SkBitmap(), false,
+      base::Bind(&OnEncoded, base::Bind(&base::DoNothing), &encoded));
+  EXPECT_FALSE(encoded.get());
+}
+
 }  // namespace gfx
@@ -1886,6 +1886,42 @@ TEST_F(RenderTextTest, Win_BreakRunsByUnicodeBlocks) {
   EXPECT_EQ(Range(2, 3), render_text->runs_[1]->range);
   EXPECT_EQ(Range(3, 5), render_text->runs_[2]->range);
 }
+
+// Ensure runs copied from the shaped run cache match the runs they were
+// copied from.
+TEST_F(RenderTextTest, Win_ShapedRunCache) {
+  const base::string16 text = WideToUTF16(L"Cached \x05d0\x05d1 runs");
+  scoped_ptr<RenderTextWin> shaped(
+      static_cast<RenderTextWin*>(RenderText::CreateInstance()));
+  shaped->SetText(text);
+  shaped->EnsureLayout();
+
+  scoped_ptr<RenderTextWin> cached(
+      static_cast<RenderTextWin*>(RenderText::CreateInstance()));
+  cached->SetText(text);
+  cached->EnsureLayout();
+  EXPECT_EQ(shaped->GetStringSize(), cached->GetStringSize());
+  ASSERT_EQ(shaped->runs_.size(), cached->runs_.size());
+  for (size_t i = 0; i < shaped->runs_.size(); ++i) {
+    SCOPED_TRACE(base::StringPrintf("runs_[%" PRIuS "]", i));
+    const internal::TextRun* run = shaped->runs_[i];
+    const internal::TextRun* cached_run = cached->runs_[i];
+    EXPECT_EQ(run->range, cached_run->range);
+    EXPECT_EQ(run->font.GetFontName(), cached_run->font.GetFontName());
+    EXPECT_EQ(run->width, cached_run->width);
+    ASSERT_EQ(run->glyph_count, cached_run->glyph_count);
+    for (int j = 0; j < run->glyph_count; ++j) {
+      EXPECT_EQ(run->glyphs[j], cached_run->glyphs[j]);
+      EXPECT_EQ(run->advance_widths[j], cached_run->advance_widths[j]);
+    }
+  }
+
+  // Editing the text keeps the widths of the runs left as they were.
+  cached->SetText(text + ASCIIToUTF16(" edited"));
+  cached->EnsureLayout();
+  ASSERT_LE(2U, cached->runs_.size());
+  EXPECT_EQ(shaped->runs_[0]->width, cached->runs_[0]->width);
+}
 #endif  // defined(OS_WIN)
 
 }  // namespace gfx
@@ -6,12 +6,15 @@
 
 #include <algorithm>
 
+#include "base/containers/mru_cache.h"
 #include "base/i18n/break_iterator.h"
 #include "base/i18n/char_iterator.h"
 #include "base/i18n/rtl.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/thread_local.h"
 #include "base/win/windows_version.h"
 #include "third_party/icu/source/common/unicode/uchar.h"
 #include "ui/gfx/canvas.h"
@@ -37,6 +40,115 @@ const size_t kMaxRuns = 10000;
 // The maximum number of glyphs per run; ScriptShape fails on larger values.
 const size_t kMaxGlyphs = 65535;
 
+// The number of shaped runs kept per thread, and the length of the longest
+// run kept; longer runs would take up too much of the cache.
+const size_t kShapedRunCacheSize = 256;
+const size_t kMaxCachedRunLength = 512;
+
+// The runs shaped most recently on a thread are kept, with their fonts and
+// glyph placements, since the text of views is laid out again each time its
+// style, color or width changes, and editing text only changes some of its
+// runs. Shaping and placing the glyphs is most of the cost of a layout.
+struct ShapedRunKey {
+  base::string16 text;
+  std::string font_name;
+  int font_size;
+  int font_style;
+  SCRIPT_ANALYSIS script_analysis;
+
+  bool operator<(const ShapedRunKey& other) const {
+    if (font_size != other.font_size)
+      return font_size < other.font_size;
+    if (font_style != other.font_style)
+      return font_style < other.font_style;
+    const int analysis_order = memcmp(&script_analysis,
+                                      &other.script_analysis,
+                                      sizeof(script_analysis));
+    if (analysis_order != 0)
+      return analysis_order < 0;
+    if (text != other.text)
+      return text < other.text;
+    return font_name < other.font_name;
+  }
+};
+
+struct ShapedRun {
+  Font font;
+  // Differs from that of the key if no font had glyphs for the run.
+  SCRIPT_ANALYSIS script_analysis;
+  std::vector<WORD> glyphs;
+  std::vector<WORD> logical_clusters;
+  std::vector<SCRIPT_VISATTR> visible_attributes;
+  std::vector<int> advance_widths;
+  std::vector<GOFFSET> offsets;
+  ABC abc_widths;
+};
+
+typedef base::OwningMRUCache<ShapedRunKey, ShapedRun*> ShapedRunCache;
+
+base::LazyInstance<base::ThreadLocalPointer<ShapedRunCache> >::Leaky
+    g_shaped_run_cache = LAZY_INSTANCE_INITIALIZER;
+
+ShapedRunCache* GetShapedRunCache() {
+  ShapedRunCache* cache = g_shaped_run_cache.Pointer()->Get();
+  if (!cache) {
+    cache = new ShapedRunCache(kShapedRunCacheSize);
+    g_shaped_run_cache.Pointer()->Set(cache);
+  }
+  return cache;
+}
+
+// Copies the glyphs of |run| to a new ShapedRun.
+ShapedRun* SaveShapedRun(const internal::TextRun& run) {
+  ShapedRun* shaped_run = new ShapedRun;
+  shaped_run->font = run.font;
+  shaped_run->script_analysis = run.script_analysis;
+  shaped_run->glyphs.assign(run.glyphs.get(),
+                            run.glyphs.get() + run.glyph_count);
+  shaped_run->logical_clusters.assign(
+      run.logical_clusters.get(),
+      run.logical_clusters.get() + run.range.length());
+  shaped_run->visible_attributes.assign(
+      run.visible_attributes.get(),
+      run.visible_attributes.get() + run.glyph_count);
+  if (run.glyph_count > 0) {
+    shaped_run->advance_widths.assign(
+        run.advance_widths.get(),
+        run.advance_widths.get() + run.glyph_count);
+    shaped_run->offsets.assign(run.offsets.get(),
+                               run.offsets.get() + run.glyph_count);
+  }
+  shaped_run->abc_widths = run.abc_widths;
+  return shaped_run;
+}
+
+// Gives |run| the glyphs of |shaped_run|, which has the same text.
+void RestoreShapedRun(const ShapedRun& shaped_run, internal::TextRun* run) {
+  DCHECK_EQ(run->range.length(), shaped_run.logical_clusters.size());
+  run->font = shaped_run.font;
+  run->script_analysis = shaped_run.script_analysis;
+  run->glyph_count = static_cast<int>(shaped_run.glyphs.size());
+  run->glyphs.reset(new WORD[run->glyph_count]);
+  std::copy(shaped_run.glyphs.begin(), shaped_run.glyphs.end(),
+            run->glyphs.get());
+  run->logical_clusters.reset(new WORD[run->range.length()]);
+  std::copy(shaped_run.logical_clusters.begin(),
+            shaped_run.logical_clusters.end(), run->logical_clusters.get());
+  run->visible_attributes.reset(new SCRIPT_VISATTR[run->glyph_count]);
+  std::copy(shaped_run.visible_attributes.begin(),
+            shaped_run.visible_attributes.end(),
+            run->visible_attributes.get());
+  if (run->glyph_count > 0) {
+    run->advance_widths.reset(new int[run->glyph_count]);
+    std::copy(shaped_run.advance_widths.begin(),
+              shaped_run.advance_widths.end(), run->advance_widths.get());
+    run->offsets.reset(new GOFFSET[run->glyph_count]);
+    std::copy(shaped_run.offsets.begin(), shaped_run.offsets.end(),
+              run->offsets.get());
+  }
+  run->abc_widths = shaped_run.abc_widths;
+}
+
 // Callback to |EnumEnhMetaFile()| to intercept font creation.
 int CALLBACK MetaFileEnumProc(HDC hdc,
                               HANDLETABLE* table,
@@ -997,28 +1109,51 @@ void RenderTextWin::LayoutVisualText() {
   // ensures that the text baseline does not shift.
   int ascent = font_list().GetBaseline();
   int descent = font_list().GetHeight() - font_list().GetBaseline();
+  ShapedRunCache* cache = GetShapedRunCache();
+  const base::string16& layout_text = GetLayoutText();
   for (size_t i = 0; i < runs_.size(); ++i) {
     internal::TextRun* run = runs_[i];
-    LayoutTextRun(run);
+    // Runs which were shaped before, such as those left as they were by an
+    // edit, are copied from the cache.
+    const bool cacheable = run->range.length() <= kMaxCachedRunLength;
+    ShapedRunKey key;
+    ShapedRunCache::iterator it = cache->end();
+    if (cacheable) {
+      key.text = layout_text.substr(run->range.start(), run->range.length());
+      key.font_name = run->font.GetFontName();
+      key.font_size = run->font.GetFontSize();
+      key.font_style = run->font_style;
+      key.script_analysis = run->script_analysis;
+      it = cache->Get(key);
+    }
+
+    if (it != cache->end()) {
+      RestoreShapedRun(*it->second, run);
+    } else {
+      LayoutTextRun(run);
+
+      if (run->glyph_count > 0) {
+        run->advance_widths.reset(new int[run->glyph_count]);
+        run->offsets.reset(new GOFFSET[run->glyph_count]);
+        hr = ScriptPlace(cached_hdc_,
+                         &run->script_cache,
+                         run->glyphs.get(),
+                         run->glyph_count,
+                         run->visible_attributes.get(),
+                         &(run->script_analysis),
+                         run->advance_widths.get(),
+                         run->offsets.get(),
+                         &(run->abc_widths));
+        DCHECK(SUCCEEDED(hr));
+      }
+
+      if (cacheable)
+        cache->Put(key, SaveShapedRun(*run));
+    }
 
     ascent = std::max(ascent, run->font.GetBaseline());
     descent = std::max(descent,
                        run->font.GetHeight() - run->font.GetBaseline());
-
-    if (run->glyph_count > 0) {
-      run->advance_widths.reset(new int[run->glyph_count]);
-      run->offsets.reset(new GOFFSET[run->glyph_count]);
-      hr = ScriptPlace(cached_hdc_,
-                       &run->script_cache,
-                       run->glyphs.get(),
-                       run->glyph_count,
-                       run->visible_attributes.get(),
-                       &(run->script_analysis),
-                       run->advance_widths.get(),
-                       run->offsets.get(),
-                       &(run->abc_widths));
-      DCHECK(SUCCEEDED(hr));
-    }
   }
 
   // Build the array of bidirectional embedding levels.
@@ -4,6 +4,7 @@
 
 #include "ui/gfx/skia_util.h"
 
+#include "build/build_config.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
@@ -17,8 +18,69 @@
 #include "ui/gfx/shadow_value.h"
 #include "ui/gfx/transform.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SKIA_UTIL_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace gfx {
 
+namespace {
+
+// Converts the |length| bytes of Skia pixels at |skia| one pixel at a time.
+void ConvertSkiaToRGBAScalar(const unsigned char* skia,
+                             unsigned char* rgba,
+                             int length) {
+  for (int i = 0; i < length; i += 4) {
+    const uint32_t pixel_in = *reinterpret_cast<const uint32_t*>(&skia[i]);
+
+    // Pack the components here.
+    int alpha = SkGetPackedA32(pixel_in);
+    if (alpha != 0 && alpha != 255) {
+      SkColor unmultiplied = SkUnPreMultiply::PMColorToColor(pixel_in);
+      rgba[i + 0] = SkColorGetR(unmultiplied);
+      rgba[i + 1] = SkColorGetG(unmultiplied);
+      rgba[i + 2] = SkColorGetB(unmultiplied);
+      rgba[i + 3] = alpha;
+    } else {
+      rgba[i + 0] = SkGetPackedR32(pixel_in);
+      rgba[i + 1] = SkGetPackedG32(pixel_in);
+      rgba[i + 2] = SkGetPackedB32(pixel_in);
+      rgba[i + 3] = alpha;
+    }
+  }
+}
+
+#if defined(SKIA_UTIL_USE_SSE2)
+// Converts the four Skia pixels at |skia| to RGBA if they are all opaque,
+// which screenshots and thumbnails mostly are, so that nothing is to be
+// unpremultiplied. Returns false, and leaves |rgba| alone, otherwise.
+bool ConvertOpaqueSkiaToRGBA(const unsigned char* skia, unsigned char* rgba) {
+  const __m128i byte_mask = _mm_set1_epi32(0xff);
+  const __m128i alpha_mask =
+      _mm_set1_epi32(static_cast<int>(0xffu << SK_A32_SHIFT));
+  __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(skia));
+  __m128i opaque =
+      _mm_cmpeq_epi32(_mm_and_si128(pixels, alpha_mask), alpha_mask);
+  if (_mm_movemask_epi8(opaque) != 0xffff)
+    return false;
+
+  // Move each component to its RGBA place, in little endian words.
+  __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, SK_R32_SHIFT), byte_mask);
+  __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, SK_G32_SHIFT), byte_mask);
+  __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, SK_B32_SHIFT), byte_mask);
+  __m128i result = _mm_or_si128(
+      _mm_or_si128(r, _mm_slli_epi32(g, 8)),
+      _mm_or_si128(_mm_slli_epi32(b, 16), _mm_set1_epi32(0xff000000)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba), result);
+  return true;
+}
+#endif  // defined(SKIA_UTIL_USE_SSE2)
+
+}  // namespace
+
 SkRect RectToSkRect(const Rect& rect) {
   SkRect r;
   r.iset(rect.x(), rect.y(), rect.right(), rect.bottom());
@@ -161,24 +223,14 @@ void ConvertSkiaToRGBA(const unsigned char* skia,
                        int pixel_width,
                        unsigned char* rgba) {
   int total_length = pixel_width * 4;
-  for (int i = 0; i < total_length; i += 4) {
-    const uint32_t pixel_in = *reinterpret_cast<const uint32_t*>(&skia[i]);
-
-    // Pack the components here.
-    int alpha = SkGetPackedA32(pixel_in);
-    if (alpha != 0 && alpha != 255) {
-      SkColor unmultiplied = SkUnPreMultiply::PMColorToColor(pixel_in);
-      rgba[i + 0] = SkColorGetR(unmultiplied);
-      rgba[i + 1] = SkColorGetG(unmultiplied);
-      rgba[i + 2] = SkColorGetB(unmultiplied);
-      rgba[i + 3] = alpha;
-    } else {
-      rgba[i + 0] = SkGetPackedR32(pixel_in);
-      rgba[i + 1] = SkGetPackedG32(pixel_in);
-      rgba[i + 2] = SkGetPackedB32(pixel_in);
-      rgba[i + 3] = alpha;
-    }
+  int i = 0;
+#if defined(SKIA_UTIL_USE_SSE2)
+  for (; i + 16 <= total_length; i += 16) {
+    if (!ConvertOpaqueSkiaToRGBA(&skia[i], &rgba[i]))
+      ConvertSkiaToRGBAScalar(&skia[i], &rgba[i], 16);
   }
+#endif
+  ConvertSkiaToRGBAScalar(&skia[i], &rgba[i], total_length - i);
 }
 
 }  // namespace gfx
@@ -96,6 +96,8 @@ bool GLImageShm::Initialize(gfx::GpuMemoryBufferHandle buffer) {
 }
 
 void GLImageShm::Destroy() {
+  if (shared_memory_ && shared_memory_->memory())
+    shared_memory_->Unmap();
 }
 
 gfx::Size GLImageShm::GetSize() {
@@ -107,11 +109,15 @@ bool GLImageShm::BindTexImage(unsigned target) {
   DCHECK(shared_memory_);
   DCHECK(ValidFormat(internalformat_));
 
-  size_t size = size_.GetArea() * BytesPerPixel(internalformat_);
-  DCHECK(!shared_memory_->memory());
-  if (!shared_memory_->Map(size)) {
-    DVLOG(0) << "Failed to map shared memory.";
-    return false;
+  // The buffer stays mapped between binds, as the image is typically bound
+  // again every time its contents change, and mapping it each time costs
+  // page faults on top of the upload.
+  if (!shared_memory_->memory()) {
+    size_t size = size_.GetArea() * BytesPerPixel(internalformat_);
+    if (!shared_memory_->Map(size)) {
+      DVLOG(0) << "Failed to map shared memory.";
+      return false;
+    }
   }
 
   DCHECK(shared_memory_->memory());
@@ -124,8 +130,6 @@ bool GLImageShm::BindTexImage(unsigned target) {
                DataFormat(internalformat_),
                DataType(internalformat_),
                shared_memory_->memory());
-
-  shared_memory_->Unmap();
   return true;
 }
 
@@ -88,9 +88,10 @@ GURL::GURL(const std::string& url_string, RetainWhiteSpaceSelector) {
 
 GURL::GURL(const char* canonical_spec, size_t canonical_spec_len,
            const url_parse::Parsed& parsed, bool is_valid)
-    : spec_(canonical_spec, canonical_spec_len),
-      is_valid_(is_valid),
+    : is_valid_(is_valid),
       parsed_(parsed) {
+  std::string spec(canonical_spec, canonical_spec_len);
+  TakeSpec(&spec);
   InitializeFromCanonicalSpec();
 }
 
@@ -98,7 +99,7 @@ GURL::GURL(std::string canonical_spec,
            const url_parse::Parsed& parsed, bool is_valid)
     : is_valid_(is_valid),
       parsed_(parsed) {
-  spec_.swap(canonical_spec);
+  TakeSpec(&canonical_spec);
   InitializeFromCanonicalSpec();
 }
 
@@ -106,15 +107,17 @@ template<typename STR>
 void GURL::InitCanonical(const STR& input_spec, bool trim_path_end) {
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  spec_.reserve(input_spec.size() + 32);
-  url_canon::StdStringCanonOutput output(&spec_);
+  std::string spec;
+  spec.reserve(input_spec.size() + 32);
+  url_canon::StdStringCanonOutput output(&spec);
   is_valid_ = url_util::Canonicalize(
       input_spec.data(), static_cast<int>(input_spec.length()), trim_path_end,
       NULL, &output, &parsed_);
 
   output.Complete();  // Must be done before using string.
+  TakeSpec(&spec);
   if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_.reset(new GURL(spec_.data(), parsed_.Length(),
+    inner_url_.reset(new GURL(spec_string().data(), parsed_.Length(),
                               *parsed_.inner_parsed(), true));
   }
 }
@@ -122,7 +125,7 @@ void GURL::InitCanonical(const STR& input_spec, bool trim_path_end) {
 void GURL::InitializeFromCanonicalSpec() {
   if (is_valid_ && SchemeIsFileSystem()) {
     inner_url_.reset(
-        new GURL(spec_.data(), parsed_.Length(),
+        new GURL(spec_string().data(), parsed_.Length(),
                  *parsed_.inner_parsed(), true));
   }
 
@@ -135,17 +138,18 @@ void GURL::InitializeFromCanonicalSpec() {
     // We can't do this check on the inner_url of a filesystem URL, as
     // canonical_spec actually points to the start of the outer URL, so we'd
     // end up with infinite recursion in this constructor.
-    if (!url_util::FindAndCompareScheme(spec_.data(), spec_.length(),
+    if (!url_util::FindAndCompareScheme(spec_string().data(),
+                                        spec_string().length(),
                                         "filesystem", &scheme) ||
         scheme.begin == parsed_.scheme.begin) {
       // We need to retain trailing whitespace on path URLs, as the |parsed_|
       // spec we originally received may legitimately contain trailing white-
       // space on the path or  components e.g. if the #ref has been
       // removed from a "foo:hello #ref" URL (see http://crbug.com/291747).
-      GURL test_url(spec_, RETAIN_TRAILING_PATH_WHITEPACE);
+      GURL test_url(spec_string(), RETAIN_TRAILING_PATH_WHITEPACE);
 
       DCHECK(test_url.is_valid_ == is_valid_);
-      DCHECK(test_url.spec_ == spec_);
+      DCHECK(test_url.spec_string() == spec_string());
 
       DCHECK(test_url.parsed_.scheme == parsed_.scheme);
       DCHECK(test_url.parsed_.username == parsed_.username);
@@ -168,9 +172,22 @@ GURL& GURL::operator=(GURL other) {
   return *this;
 }
 
+void GURL::TakeSpec(std::string* spec) {
+  // Empty specs aren't allocated, so that empty URLs stay cheap to create.
+  if (spec->empty())
+    spec_ = NULL;
+  else
+    spec_ = base::RefCountedString::TakeString(spec);
+}
+
+// static
+const std::string& GURL::EmptySpec() {
+  return EmptyStringForGURL();
+}
+
 const std::string& GURL::spec() const {
-  if (is_valid_ || spec_.empty())
-    return spec_;
+  if (is_valid_ || !spec_.get())
+    return spec_string();
 
   DCHECK(false) << "Trying to get the spec of an invalid URL!";
   return EmptyStringForGURL();
@@ -195,22 +212,24 @@ GURL GURL::ResolveWithCharsetConverter(
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  std::string spec;
+  spec.reserve(spec_string().size() + 32);
+  url_canon::StdStringCanonOutput output(&spec);
 
   if (!url_util::ResolveRelative(
-          spec_.data(), static_cast<int>(spec_.length()), parsed_,
-          relative.data(), static_cast<int>(relative.length()),
+          spec_string().data(), static_cast<int>(spec_string().length()),
+          parsed_, relative.data(), static_cast<int>(relative.length()),
           charset_converter, &output, &result.parsed_)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
+  result.TakeSpec(&spec);
   result.is_valid_ = true;
   if (result.SchemeIsFileSystem()) {
     result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
+        new GURL(result.spec_string().data(), result.parsed_.Length(),
                  *result.parsed_.inner_parsed(), true));
   }
   return result;
@@ -228,22 +247,24 @@ GURL GURL::ResolveWithCharsetConverter(
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  std::string spec;
+  spec.reserve(spec_string().size() + 32);
+  url_canon::StdStringCanonOutput output(&spec);
 
   if (!url_util::ResolveRelative(
-          spec_.data(), static_cast<int>(spec_.length()), parsed_,
-          relative.data(), static_cast<int>(relative.length()),
+          spec_string().data(), static_cast<int>(spec_string().length()),
+          parsed_, relative.data(), static_cast<int>(relative.length()),
           charset_converter, &output, &result.parsed_)) {
     // Error resolving, return an empty URL.
     return GURL();
   }
 
   output.Complete();
+  result.TakeSpec(&spec);
   result.is_valid_ = true;
   if (result.SchemeIsFileSystem()) {
     result.inner_url_.reset(
-        new GURL(result.spec_.data(), result.parsed_.Length(),
+        new GURL(result.spec_string().data(), result.parsed_.Length(),
                  *result.parsed_.inner_parsed(), true));
   }
   return result;
@@ -260,16 +281,19 @@ GURL GURL::ReplaceComponents(
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  std::string spec;
+  spec.reserve(spec_string().size() + 32);
+  url_canon::StdStringCanonOutput output(&spec);
 
   result.is_valid_ = url_util::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+      spec_string().data(), static_cast<int>(spec_string().length()), parsed_,
+      replacements, NULL, &output, &result.parsed_);
 
   output.Complete();
+  result.TakeSpec(&spec);
   if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(spec_.data(), result.parsed_.Length(),
+    result.inner_url_.reset(new GURL(spec_string().data(),
+                                     result.parsed_.Length(),
                                      *result.parsed_.inner_parsed(), true));
   }
   return result;
@@ -286,16 +310,19 @@ GURL GURL::ReplaceComponents(
 
   // Reserve enough room in the output for the input, plus some extra so that
   // we have room if we have to escape a few things without reallocating.
-  result.spec_.reserve(spec_.size() + 32);
-  url_canon::StdStringCanonOutput output(&result.spec_);
+  std::string spec;
+  spec.reserve(spec_string().size() + 32);
+  url_canon::StdStringCanonOutput output(&spec);
 
   result.is_valid_ = url_util::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+      spec_string().data(), static_cast<int>(spec_string().length()), parsed_,
+      replacements, NULL, &output, &result.parsed_);
 
   output.Complete();
+  result.TakeSpec(&spec);
   if (result.is_valid_ && result.SchemeIsFileSystem()) {
-    result.inner_url_.reset(new GURL(spec_.data(), result.parsed_.Length(),
+    result.inner_url_.reset(new GURL(spec_string().data(),
+                                     result.parsed_.Length(),
                                      *result.parsed_.inner_parsed(), true));
   }
   return result;
@@ -336,23 +363,25 @@ GURL GURL::GetWithEmptyPath() const {
   other.parsed_.query.reset();
   other.parsed_.ref.reset();
 
-  // Set the path, since the path is longer than one, we can just set the
-  // first character and resize.
-  other.spec_[other.parsed_.path.begin] = '/';
+  // Set the path. The spec is shared with this URL, so build a new one out of
+  // everything before the path and a slash.
+  std::string spec(spec_string(), 0, other.parsed_.path.begin);
+  spec.push_back('/');
   other.parsed_.path.len = 1;
-  other.spec_.resize(other.parsed_.path.begin + 1);
+  other.TakeSpec(&spec);
   return other;
 }
 
 bool GURL::IsStandard() const {
-  return url_util::IsStandard(spec_.data(), parsed_.scheme);
+  return url_util::IsStandard(spec_string().data(), parsed_.scheme);
 }
 
 bool GURL::SchemeIs(const char* lower_ascii_scheme) const {
   if (parsed_.scheme.len <= 0)
     return lower_ascii_scheme == NULL;
-  return url_util::LowerCaseEqualsASCII(spec_.data() + parsed_.scheme.begin,
-                                        spec_.data() + parsed_.scheme.end(),
+  const char* spec = spec_string().data();
+  return url_util::LowerCaseEqualsASCII(spec + parsed_.scheme.begin,
+                                        spec + parsed_.scheme.end(),
                                         lower_ascii_scheme);
 }
 
@@ -366,21 +395,22 @@ bool GURL::SchemeIsWSOrWSS() const {
 
 int GURL::IntPort() const {
   if (parsed_.port.is_nonempty())
-    return url_parse::ParsePort(spec_.data(), parsed_.port);
+    return url_parse::ParsePort(spec_string().data(), parsed_.port);
   return url_parse::PORT_UNSPECIFIED;
 }
 
 int GURL::EffectiveIntPort() const {
   int int_port = IntPort();
   if (int_port == url_parse::PORT_UNSPECIFIED && IsStandard())
-    return url_canon::DefaultPortForScheme(spec_.data() + parsed_.scheme.begin,
-                                           parsed_.scheme.len);
+    return url_canon::DefaultPortForScheme(
+        spec_string().data() + parsed_.scheme.begin, parsed_.scheme.len);
   return int_port;
 }
 
 std::string GURL::ExtractFileName() const {
   url_parse::Component file_component;
-  url_parse::ExtractFileName(spec_.data(), parsed_.path, &file_component);
+  url_parse::ExtractFileName(spec_string().data(), parsed_.path,
+                             &file_component);
   return ComponentString(file_component);
 }
 
@@ -389,7 +419,7 @@ std::string GURL::PathForRequest() const {
   if (parsed_.ref.len >= 0) {
     // Clip off the reference when it exists. The reference starts after the #
     // sign, so we have to subtract one to also remove it.
-    return std::string(spec_, parsed_.path.begin,
+    return std::string(spec_string(), parsed_.path.begin,
                        parsed_.ref.begin - parsed_.path.begin - 1);
   }
   // Compute the actual path length, rather than depending on the spec's
@@ -399,13 +429,14 @@ std::string GURL::PathForRequest() const {
   if (parsed_.query.is_valid())
     path_len = parsed_.query.end() - parsed_.path.begin;
 
-  return std::string(spec_, parsed_.path.begin, path_len);
+  return std::string(spec_string(), parsed_.path.begin, path_len);
 }
 
 std::string GURL::HostNoBrackets() const {
   // If host looks like an IPv6 literal, strip the square brackets.
   url_parse::Component h(parsed_.host);
-  if (h.len >= 2 && spec_[h.begin] == '[' && spec_[h.end() - 1] == ']') {
+  if (h.len >= 2 && spec_string()[h.begin] == '[' &&
+      spec_string()[h.end() - 1] == ']') {
     h.begin++;
     h.len -= 2;
   }
@@ -417,12 +448,12 @@ std::string GURL::GetContent() const {
 }
 
 bool GURL::HostIsIPAddress() const {
-  if (!is_valid_ || spec_.empty())
+  if (!is_valid_ || !spec_.get())
      return false;
 
   url_canon::RawCanonOutputT<char, 128> ignored_output;
   url_canon::CanonHostInfo host_info;
-  url_canon::CanonicalizeIPAddress(spec_.c_str(), parsed_.host,
+  url_canon::CanonicalizeIPAddress(spec_string().c_str(), parsed_.host,
                                    &ignored_output, &host_info);
   return host_info.IsIPAddress();
 }
@@ -475,7 +506,7 @@ bool GURL::DomainIs(const char* lower_ascii_domain,
   // Check whether the host name is end with a dot. If yes, treat it
   // the same as no-dot unless the input comparison domain is end
   // with dot.
-  const char* last_pos = spec_.data() + parsed_.host.end() - 1;
+  const char* last_pos = spec_string().data() + parsed_.host.end() - 1;
   int host_len = parsed_.host.len;
   if ('.' == *last_pos && '.' != lower_ascii_domain[domain_len - 1]) {
     last_pos--;
@@ -487,7 +518,7 @@ bool GURL::DomainIs(const char* lower_ascii_domain,
     return false;
 
   // Compare this url whether belong specific domain.
-  const char* start_pos = spec_.data() + parsed_.host.begin +
+  const char* start_pos = spec_string().data() + parsed_.host.begin +
                           host_len - domain_len;
 
   if (!url_util::LowerCaseEqualsASCII(start_pos,
@@ -8,6 +8,8 @@
 #include <iosfwd>
 #include <string>
 
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
 #include "url/url_canon.h"
@@ -23,8 +25,8 @@ class URL_EXPORT GURL {
   // Creates an empty, invalid URL.
   GURL();
 
-  // Copy construction is relatively inexpensive, with most of the time going
-  // to reallocating the string. It does not re-parse.
+  // Copy construction is inexpensive: the copy shares the immutable spec of
+  // |other| rather than reallocating it, and it does not re-parse.
   GURL(const GURL& other);
 
   // The narrow version requires the input be UTF-8. Invalid UTF-8 input will
@@ -46,7 +48,7 @@ class URL_EXPORT GURL {
   // from WebURL without copying the string. When we call this constructor
   // we pass in a temporary std::string, which lets the compiler skip the
   // copy and just move the std::string into the function argument. In the
-  // implementation, we use swap to move the data into the GURL itself,
+  // implementation, we swap the data into the shared spec of the GURL,
   // which means we end up with zero copies.
   GURL(std::string canonical_spec,
        const url_parse::Parsed& parsed, bool is_valid);
@@ -68,7 +70,7 @@ class URL_EXPORT GURL {
   // invalid, and is_valid() will return false for them. This is provided
   // because some users may want to treat the empty case differently.
   bool is_empty() const {
-    return spec_.empty();
+    return !spec_.get();
   }
 
   // Returns the raw spec, i.e., the full text of the URL, in canonical UTF-8,
@@ -94,7 +96,7 @@ class URL_EXPORT GURL {
   //
   // The returned string is guaranteed to be valid UTF-8.
   const std::string& possibly_invalid_spec() const {
-    return spec_;
+    return spec_string();
   }
 
   // Getter for the raw parsed structure. This allows callers to locate parts
@@ -111,18 +113,19 @@ class URL_EXPORT GURL {
 
   // Defiant equality operator!
   bool operator==(const GURL& other) const {
-    return spec_ == other.spec_;
+    return spec_.get() == other.spec_.get() ||
+           spec_string() == other.spec_string();
   }
   bool operator!=(const GURL& other) const {
-    return spec_ != other.spec_;
+    return !(*this == other);
   }
 
   // Allows GURL to used as a key in STL (for example, a std::set or std::map).
   bool operator<(const GURL& other) const {
-    return spec_ < other.spec_;
+    return spec_string() < other.spec_string();
   }
   bool operator>(const GURL& other) const {
-    return spec_ > other.spec_;
+    return spec_string() > other.spec_string();
   }
 
   // Resolves a URL that's possibly relative to this object's URL, and returns
@@ -371,15 +374,24 @@ class URL_EXPORT GURL {
 
   void InitializeFromCanonicalSpec();
 
+  // Makes the contents of |spec| the spec of this URL, leaving |spec| empty.
+  void TakeSpec(std::string* spec);
+
+  const std::string& spec_string() const {
+    return spec_.get() ? spec_->data() : EmptySpec();
+  }
+  static const std::string& EmptySpec();
+
   // Returns the substring of the input identified by the given component.
   std::string ComponentString(const url_parse::Component& comp) const {
     if (comp.len <= 0)
       return std::string();
-    return std::string(spec_, comp.begin, comp.len);
+    return std::string(spec_string(), comp.begin, comp.len);
   }
 
-  // The actual text of the URL, in canonical ASCII form.
-  std::string spec_;
+  // The actual text of the URL, in canonical ASCII form. It is never modified
+  // once set, so copies of the URL share it. NULL for an empty spec.
+  scoped_refptr<base::RefCountedString> spec_;
 
   // Set when the given URL is valid. Otherwise, we may still have a spec and
   // components, but they may not identify valid resources (for example, an
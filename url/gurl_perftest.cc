@@ -0,0 +1,52 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_log.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+const int kURLCount = 1000;
+const int kCopies = 100;
+
+// Copies URLs the way navigation and history code passes them around, and
+// counts the spec buffers the copies needed on top of the originals.
+TEST(GURLPerfTest, Copy) {
+  std::vector<GURL> urls;
+  for (int i = 0; i < kURLCount; i++) {
+    urls.push_back(GURL(base::StringPrintf(
+        "http://www.example%d.com/some/path/to/a/page.html?id=%d#section",
+        i % 10, i)));
+  }
+
+  std::vector<GURL> copies;
+  copies.reserve(kURLCount * kCopies);
+  base::PerfTimeLogger timer("GURL_copy");
+  for (int i = 0; i < kCopies; i++) {
+    for (size_t j = 0; j < urls.size(); j++)
+      copies.push_back(urls[j]);
+  }
+  timer.Done();
+
+  std::set<const char*> buffers;
+  for (size_t i = 0; i < copies.size(); i++)
+    buffers.insert(copies[i].spec().data());
+  for (size_t i = 0; i < urls.size(); i++)
+    buffers.erase(urls[i].spec().data());
+  base::LogPerfResult("GURL_copy_spec_allocations",
+                      static_cast<double>(buffers.size()), "allocations");
+  base::LogPerfResult(
+      "GURL_copy_spec_allocations_saved",
+      static_cast<double>(copies.size() - buffers.size()), "allocations");
+  EXPECT_TRUE(buffers.empty());
+}
+
+}  // namespace
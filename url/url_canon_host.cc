@@ -71,6 +71,14 @@ const int kTempHostBufferLen = 1024;
 typedef RawCanonOutputT<char, kTempHostBufferLen> StackBuffer;
 typedef RawCanonOutputT<base::char16, kTempHostBufferLen> StackBufferW;
 
+// Returns true if |ch| is a valid host character that is already in canonical
+// form, so that it can be copied to the output as is.
+template<typename CHAR>
+inline bool IsCanonicalHostChar(CHAR ch) {
+  unsigned int c = static_cast<unsigned int>(ch);
+  return c != 0 && c < 0x80 && kHostCharLookup[c] == c;
+}
+
 // Scans a host name and fills in the output flags according to what we find.
 // |has_non_ascii| will be true if there are any non-7-bit characters, and
 // |has_escaped| will be true if there is a percent sign.
@@ -118,6 +126,17 @@ bool DoSimpleHost(const INCHAR* host,
 
   bool success = true;
   for (int i = 0; i < host_len; ++i) {
+    if (IsCanonicalHostChar(host[i])) {
+      // Common case: copy the run of characters which are already lower case
+      // and valid at once, rather than looking them up one at a time.
+      int run_end = i + 1;
+      while (run_end < host_len && IsCanonicalHostChar(host[run_end]))
+        run_end++;
+      AppendRun(host, i, run_end, output);
+      i = run_end - 1;
+      continue;
+    }
+
     unsigned int source = host[i];
     if (source == '%') {
       // Unescape first, if possible.
@@ -144,9 +163,8 @@ bool DoSimpleHost(const INCHAR* host,
         // This character is valid but should be escaped.
         AppendEscapedChar(source, output);
       } else {
-        // Common case, the given character is valid in a hostname, the lookup
-        // table tells us the canonical representation of that character (lower
-        // cased).
+        // The given character is valid in a hostname, the lookup table tells
+        // us the canonical representation of that character (lower cased).
         output->push_back(replacement);
       }
     } else {
@@ -135,6 +135,21 @@ inline void AppendEscapedChar(UINCHAR ch,
   output->push_back(kHexCharLookup[ch & 0xf]);
 }
 
+// Appends the characters of |str| in [begin, end), which must not need any
+// conversion, to the output. Same-width input is copied at once, since most
+// components are long runs of such characters.
+template<typename CHAR>
+inline void AppendRun(const CHAR* str, int begin, int end,
+                      CanonOutputT<CHAR>* output) {
+  output->Append(&str[begin], end - begin);
+}
+template<typename INCHAR, typename OUTCHAR>
+inline void AppendRun(const INCHAR* str, int begin, int end,
+                      CanonOutputT<OUTCHAR>* output) {
+  for (int i = begin; i < end; i++)
+    output->push_back(static_cast<OUTCHAR>(str[i]));
+}
+
 // The character we'll substitute for undecodable or invalid characters.
 extern const base::char16 kUnicodeReplacementCharacter;
 
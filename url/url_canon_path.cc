@@ -75,6 +75,14 @@ const unsigned char kPathCharLookup[0x100] = {
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE};
 
+// Returns true if |ch| can be copied to the canonical path without any
+// special handling.
+template<typename UCHAR, typename CHAR>
+inline bool IsPlainPathChar(CHAR ch) {
+  UCHAR uch = static_cast<UCHAR>(ch);
+  return uch < 0x80 && !(kPathCharLookup[uch] & SPECIAL);
+}
+
 enum DotDisposition {
   // The given dot is just part of a filename and is not special.
   NOT_A_DIRECTORY,
@@ -285,8 +293,13 @@ bool DoPartialPath(const CHAR* spec,
           AppendEscapedChar(out_ch, output);
         }
       } else {
-        // Nothing special about this character, just append it.
-        output->push_back(out_ch);
+        // Nothing special about this character. This is the common case, so
+        // append the whole run of such characters starting here at once.
+        int run_end = i + 1;
+        while (run_end < end && IsPlainPathChar<UCHAR>(spec[run_end]))
+          run_end++;
+        AppendRun(spec, i, run_end, output);
+        i = run_end - 1;
       }
     }
   }
@@ -369,6 +369,8 @@ TEST(URLCanonTest, Host) {
   IPAddressCase host_cases[] = {
        // Basic canonicalization, uppercase should be converted to lowercase.
     {"GoOgLe.CoM", L"GoOgLe.CoM", "google.com", url_parse::Component(0, 10), CanonHostInfo::NEUTRAL, -1, ""},
+      // Runs of canonical characters around characters that need changes.
+    {"www.ExAmple%41.com", L"www.ExAmple%41.com", "www.examplea.com", url_parse::Component(0, 16), CanonHostInfo::NEUTRAL, -1, ""},
       // Spaces and some other characters should be escaped.
     {"Goo%20 goo%7C|.com", L"Goo%20 goo%7C|.com", "goo%20%20goo%7C%7C.com", url_parse::Component(0, 22), CanonHostInfo::NEUTRAL, -1, ""},
       // Exciting different types of spaces!
@@ -1137,6 +1139,10 @@ TEST(URLCanonTest, Path) {
     {"/%7Ffp3%3Eju%3Dduvgw%3Dd", L"/%7Ffp3%3Eju%3Dduvgw%3Dd", "/%7Ffp3%3Eju%3Dduvgw%3Dd", url_parse::Component(0, 24), true},
       // @ should be passed through unchanged (escaped or unescaped).
     {"/@asdf%40", L"/@asdf%40", "/@asdf%40", url_parse::Component(0, 9), true},
+      // Long runs of plain characters broken up by characters which need
+      // special handling.
+    {"/aaaa/bbbb%41cc/d.e\\f", L"/aaaa/bbbb%41cc/d.e\\f", "/aaaa/bbbbAcc/d.e/f", url_parse::Component(0, 19), true},
+    {"/abc def/./g\x01h", L"/abc def/./g\x01h", "/abc%20def/g%01h", url_parse::Component(0, 16), true},
 
     // ----- encoding tests -----
       // Basic conversions
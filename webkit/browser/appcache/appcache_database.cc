@@ -23,7 +23,9 @@ namespace appcache {
 // Schema -------------------------------------------------------------------
 namespace {
 
-#if defined(APPCACHE_USE_SIMPLE_CACHE)
+// Version 6 stores the responses in a Simple cache, which can't be read as
+// a blockfile one, so there is no upgrade path to it.
+#if !defined(APPCACHE_USE_BLOCKFILE_CACHE)
 const int kCurrentVersion = 6;
 const int kCompatibleVersion = 6;
 #else
@@ -1012,6 +1014,9 @@ bool AppCacheDatabase::LazyOpen(bool create_if_needed) {
   meta_table_.reset(new sql::MetaTable);
 
   db_->set_histogram_tag("AppCache");
+  // Only the database thread ever opens the file, so keep it locked rather
+  // than taking the lock again for every transaction of an update.
+  db_->set_exclusive_locking();
 
   bool opened = false;
   if (use_in_memory_db) {
@@ -1107,7 +1112,7 @@ bool AppCacheDatabase::CreateSchema() {
 }
 
 bool AppCacheDatabase::UpgradeSchema() {
-#if defined(APPCACHE_USE_SIMPLE_CACHE)
+#if !defined(APPCACHE_USE_BLOCKFILE_CACHE)
   return DeleteExistingAndCreateNewDatabase();
 #else
   if (meta_table_->GetVersionNumber() == 3) {
@@ -736,7 +736,7 @@ TEST(AppCacheDatabaseTest, OriginUsage) {
   EXPECT_EQ(5000, usage_map[kOtherOrigin]);
 }
 
-#if defined(APPCACHE_USE_SIMPLE_CACHE)
+#if !defined(APPCACHE_USE_BLOCKFILE_CACHE)
 // There is no such upgrade path in this case.
 #else
 TEST(AppCacheDatabaseTest, UpgradeSchema3to5) {
@@ -957,9 +957,9 @@ TEST(AppCacheDatabaseTest, UpgradeSchema3to5) {
     EXPECT_FALSE(fallbacks[i].namespace_.is_pattern);
   }
 }
-#endif  // !APPCACHE_USE_SIMPLE_CACHE
+#endif  // APPCACHE_USE_BLOCKFILE_CACHE
 
-#if defined(APPCACHE_USE_SIMPLE_CACHE)
+#if !defined(APPCACHE_USE_BLOCKFILE_CACHE)
 // There is no such upgrade path in this case.
 #else
 TEST(AppCacheDatabaseTest, UpgradeSchema4to5) {
@@ -1199,6 +1199,6 @@ TEST(AppCacheDatabaseTest, UpgradeSchema4to5) {
     EXPECT_FALSE(whitelists[i].is_pattern);
   }
 }
-#endif  // !APPCACHE_USE_SIMPLE_CACHE
+#endif  // APPCACHE_USE_BLOCKFILE_CACHE
 
 }  // namespace appcache
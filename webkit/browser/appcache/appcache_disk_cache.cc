@@ -295,10 +295,12 @@ int AppCacheDiskCache::Init(net::CacheType cache_type,
   is_disabled_ = false;
   create_backend_callback_ = new CreateBackendCallbackShim(this);
 
-#if defined(APPCACHE_USE_SIMPLE_CACHE)
+  // The Simple backend opens and writes the many small responses of an
+  // update faster. Builds can opt out until their old caches are gone.
+#if !defined(APPCACHE_USE_BLOCKFILE_CACHE)
   const net::BackendType backend_type = net::CACHE_BACKEND_SIMPLE;
 #else
-  const net::BackendType backend_type = net::CACHE_BACKEND_DEFAULT;
+  const net::BackendType backend_type = net::CACHE_BACKEND_BLOCKFILE;
 #endif
   int rv = disk_cache::CreateCacheBackend(
       cache_type, backend_type, cache_directory, cache_size,
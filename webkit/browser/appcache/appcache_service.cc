@@ -28,6 +28,9 @@ namespace appcache {
 
 namespace {
 
+// Matches the number of connections per host of the socket pools.
+const size_t kDefaultMaxConcurrentUpdateFetches = 6;
+
 void DeferredCallback(const net::CompletionCallback& callback, int rv) {
   callback.Run(rv);
 }
@@ -436,6 +439,7 @@ AppCacheStorageReference::~AppCacheStorageReference() {}
 
 AppCacheService::AppCacheService(quota::QuotaManagerProxy* quota_manager_proxy)
     : appcache_policy_(NULL), quota_client_(NULL), handler_factory_(NULL),
+      max_concurrent_update_fetches_(kDefaultMaxConcurrentUpdateFetches),
       quota_manager_proxy_(quota_manager_proxy),
       request_context_(NULL),
       force_keep_session_state_(false) {
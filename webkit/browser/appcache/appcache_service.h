@@ -9,6 +9,7 @@
 #include <set>
 
 #include "base/gtest_prod_util.h"
+#include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
@@ -172,6 +173,16 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheService {
     handler_factory_ = factory;
   }
 
+  // The number of requests each update job keeps in flight for the entries
+  // listed in the manifest. Master entries get as many requests again.
+  size_t max_concurrent_update_fetches() const {
+    return max_concurrent_update_fetches_;
+  }
+  void set_max_concurrent_update_fetches(size_t count) {
+    DCHECK_GT(count, 0u);
+    max_concurrent_update_fetches_ = count;
+  }
+
   quota::SpecialStoragePolicy* special_storage_policy() const {
     return special_storage_policy_.get();
   }
@@ -223,6 +234,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheService {
   AppCachePolicy* appcache_policy_;
   AppCacheQuotaClient* quota_client_;
   AppCacheExecutableHandlerFactory* handler_factory_;
+  size_t max_concurrent_update_fetches_;
   scoped_ptr<AppCacheStorage> storage_;
   scoped_refptr<quota::SpecialStoragePolicy> special_storage_policy_;
   scoped_refptr<quota::QuotaManagerProxy> quota_manager_proxy_;
@@ -23,7 +23,6 @@
 namespace appcache {
 
 static const int kBufferSize = 32768;
-static const size_t kMaxConcurrentUrlFetches = 2;
 static const int kMax503Retries = 3;
 
 static std::string FormatUrlErrorMessage(
@@ -112,7 +111,7 @@ AppCacheUpdateJob::URLFetcher::URLFetcher(const GURL& url,
       retry_503_attempts_(0),
       buffer_(new net::IOBuffer(kBufferSize)),
       request_(job->service_->request_context()
-                   ->CreateRequest(url, net::DEFAULT_PRIORITY, this)),
+                   ->CreateRequest(url, GetRequestPriority(), this)),
       result_(UPDATE_OK) {}
 
 AppCacheUpdateJob::URLFetcher::~URLFetcher() {
@@ -314,11 +313,20 @@ bool AppCacheUpdateJob::URLFetcher::MaybeRetryRequest() {
   ++retry_503_attempts_;
   result_ = UPDATE_OK;
   request_ = job_->service_->request_context()->CreateRequest(
-      url_, net::DEFAULT_PRIORITY, this);
+      url_, GetRequestPriority(), this);
   Start();
   return true;
 }
 
+net::RequestPriority AppCacheUpdateJob::URLFetcher::GetRequestPriority()
+    const {
+  // Master entries are the pages being loaded, and the manifest gates the
+  // whole update, so they go ahead of the other entries.
+  if (fetch_type_ == URL_FETCH)
+    return net::DEFAULT_PRIORITY;
+  return net::MEDIUM;
+}
+
 AppCacheUpdateJob::AppCacheUpdateJob(AppCacheService* service,
                                      AppCacheGroup* group)
     : service_(service),
@@ -998,7 +1006,8 @@ void AppCacheUpdateJob::FetchUrls() {
   // Fetch each URL in the list according to section 6.9.4 step 17.1-17.3.
   // Fetch up to the concurrent limit. Other fetches will be triggered as each
   // each fetch completes.
-  while (pending_url_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (pending_url_fetches_.size() <
+             service_->max_concurrent_update_fetches() &&
          !urls_to_fetch_.empty()) {
     UrlToFetch url_to_fetch = urls_to_fetch_.front();
     urls_to_fetch_.pop_front();
@@ -1117,7 +1126,8 @@ void AppCacheUpdateJob::FetchMasterEntries() {
 
   // Fetch each master entry in the list, up to the concurrent limit.
   // Additional fetches will be triggered as each fetch completes.
-  while (master_entry_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (master_entry_fetches_.size() <
+             service_->max_concurrent_update_fetches() &&
          !master_entries_to_fetch_.empty()) {
     const GURL& url = *master_entries_to_fetch_.begin();
 
@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/completion_callback.h"
+#include "net/base/request_priority.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/url_request.h"
 #include "url/gurl.h"
@@ -142,6 +143,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheUpdateJob
     bool ConsumeResponseData(int bytes_read);
     void OnResponseCompleted();
     bool MaybeRetryRequest();
+    net::RequestPriority GetRequestPriority() const;
 
     GURL url_;
     AppCacheUpdateJob* job_;
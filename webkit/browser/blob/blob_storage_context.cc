@@ -4,10 +4,19 @@
 
 #include "webkit/browser/blob/blob_storage_context.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
+#include "base/file_util.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
+#include "base/task_runner_util.h"
 #include "url/gurl.h"
 #include "webkit/browser/blob/blob_data_handle.h"
 #include "webkit/common/blob/blob_data.h"
@@ -36,22 +45,43 @@ GURL ClearBlobUrlRef(const GURL& url) {
 // way to come up with a better limit.
 static const int64 kMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
 
+// When spilling to disk is enabled, blob data is kept in memory until it
+// uses a twentieth of the physical memory, or this much if that's less.
+static const int64 kMaxMemoryUsageBeforeSpilling = 100 * 1024 * 1024;
+
+// The trailing bytes of a blob are spilled once there are this many of them,
+// so that files aren't written for each IPC of a large blob.
+static const int64 kMinSpillBytes = 1024 * 1024;
+
+// Runs on the file thread.
+bool WriteSpillFile(const base::FilePath& path,
+                    const scoped_refptr<base::RefCountedString>& bytes) {
+  if (!base::CreateDirectory(path.DirName()))
+    return false;
+  int size = static_cast<int>(bytes->data().size());
+  return file_util::WriteFile(path, bytes->data().data(), size) == size;
+}
+
 }  // namespace
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry()
-    : refcount(0), flags(0) {
+    : refcount(0), flags(0), unspilled_bytes_start(0),
+      unspilled_bytes_length(0) {
 }
 
 BlobStorageContext::BlobMapEntry::BlobMapEntry(
     int refcount, int flags, BlobData* data)
-    : refcount(refcount), flags(flags), data(data) {
+    : refcount(refcount), flags(flags), data(data), unspilled_bytes_start(0),
+      unspilled_bytes_length(0) {
 }
 
 BlobStorageContext::BlobMapEntry::~BlobMapEntry() {
 }
 
 BlobStorageContext::BlobStorageContext()
-    : memory_usage_(0) {
+    : memory_usage_(0),
+      spill_threshold_(kMaxMemoryUsage),
+      next_spill_file_id_(0) {
 }
 
 BlobStorageContext::~BlobStorageContext() {
@@ -114,6 +144,23 @@ void BlobStorageContext::RevokePublicBlobURL(const GURL& blob_url) {
   public_blob_urls_.erase(blob_url);
 }
 
+void BlobStorageContext::EnableDiskSpilling(
+    const base::FilePath& spill_directory,
+    base::SequencedTaskRunner* file_task_runner) {
+  DCHECK(!spill_directory.empty());
+  DCHECK(file_task_runner);
+  spill_directory_ = spill_directory;
+  file_task_runner_ = file_task_runner;
+  spill_threshold_ = std::min(kMaxMemoryUsageBeforeSpilling,
+                              base::SysInfo::AmountOfPhysicalMemory() / 20);
+
+  // The files left behind by a crash are no longer referenced.
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(base::IgnoreResult(&base::DeleteFile),
+                 spill_directory_, true));
+}
+
 void BlobStorageContext::StartBuildingBlob(const std::string& uuid) {
   DCHECK(!IsInUse(uuid) && !uuid.empty());
   blob_map_[uuid] = BlobMapEntry(1, BEING_BUILT, new BlobData(uuid));
@@ -129,6 +176,7 @@ void BlobStorageContext::AppendBlobDataItem(
     return;
   BlobData* target_blob_data = found->second.data.get();
   DCHECK(target_blob_data);
+  size_t first_new_item = target_blob_data->items().size();
 
   bool exceeded_memory = false;
 
@@ -179,15 +227,18 @@ void BlobStorageContext::AppendBlobDataItem(
       break;
   }
 
-  // If we're using too much memory, drop this blob's data.
-  // TODO(michaeln): Blob memory storage does not yet spill over to disk,
-  // as a stop gap, we'll prevent memory usage over a max amount.
+  // If we're using too much memory, drop this blob's data. Only the bytes
+  // of blobs being built are spilled to disk, so the data of finished blobs
+  // can still use up to a max amount.
   if (exceeded_memory) {
     memory_usage_ -= target_blob_data->GetMemoryUsage();
     found->second.flags |= EXCEEDED_MEMORY;
     found->second.data = new BlobData(uuid);
     return;
   }
+
+  if (file_task_runner_.get())
+    MaybeSpillBytesItems(&found->second, first_new_item);
 }
 
 void BlobStorageContext::FinishBuildingBlob(
@@ -285,6 +336,61 @@ bool BlobStorageContext::AppendBytesItem(
   return true;
 }
 
+void BlobStorageContext::MaybeSpillBytesItems(BlobMapEntry* entry,
+                                              size_t first_new_item) {
+  BlobData* target_blob_data = entry->data.get();
+  const std::vector<BlobData::Item>& items = target_blob_data->items();
+  for (size_t i = first_new_item; i < items.size(); ++i) {
+    if (items[i].type() == BlobData::Item::TYPE_BYTES) {
+      entry->unspilled_bytes_length += items[i].length();
+    } else {
+      entry->unspilled_bytes_start = i + 1;
+      entry->unspilled_bytes_length = 0;
+    }
+  }
+  if (entry->unspilled_bytes_length < kMinSpillBytes ||
+      memory_usage_ <= spill_threshold_) {
+    return;
+  }
+
+  // Replace the bytes with a file item. Blobs being built can't be read, so
+  // the file is written before it is opened by a reader, whose file tasks
+  // run after the write.
+  std::string bytes;
+  bytes.reserve(static_cast<size_t>(entry->unspilled_bytes_length));
+  for (size_t i = entry->unspilled_bytes_start; i < items.size(); ++i) {
+    DCHECK(!items[i].offset());
+    bytes.append(items[i].bytes(), static_cast<size_t>(items[i].length()));
+  }
+  int64 length = entry->unspilled_bytes_length;
+  target_blob_data->RemoveItemsFrom(entry->unspilled_bytes_start);
+  base::FilePath path =
+      spill_directory_.AppendASCII(base::Int64ToString(next_spill_file_id_++));
+  target_blob_data->AppendFile(path, 0, length, base::Time());
+  // The file is deleted once no blob refers to it anymore.
+  scoped_refptr<ShareableFileReference> shareable_file =
+      ShareableFileReference::GetOrCreate(
+          path, ShareableFileReference::DELETE_ON_FINAL_RELEASE,
+          file_task_runner_.get());
+  target_blob_data->AttachShareableFileReference(shareable_file.get());
+  entry->unspilled_bytes_start = items.size();
+  entry->unspilled_bytes_length = 0;
+
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&WriteSpillFile, path,
+                 make_scoped_refptr(base::RefCountedString::TakeString(
+                     &bytes))),
+      base::Bind(&BlobStorageContext::OnSpillFileWritten, AsWeakPtr(),
+                 length));
+}
+
+void BlobStorageContext::OnSpillFileWritten(int64 length, bool success) {
+  memory_usage_ -= length;
+  UMA_HISTOGRAM_BOOLEAN("Storage.Blob.SpillFileWritten", success);
+}
+
 void BlobStorageContext::AppendFileItem(
     BlobData* target_blob_data,
     const base::FilePath& file_path, uint64 offset, uint64 length,
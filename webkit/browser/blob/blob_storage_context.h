@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 
+#include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -18,7 +19,7 @@
 class GURL;
 
 namespace base {
-class FilePath;
+class SequencedTaskRunner;
 class Time;
 }
 
@@ -47,6 +48,18 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   bool RegisterPublicBlobURL(const GURL& url, const std::string& uuid);
   void RevokePublicBlobURL(const GURL& url);
 
+  // Lets the context move the bytes of the blobs being built to files in
+  // |spill_directory| once blob data uses more than its share of the
+  // physical memory. The directory is emptied first. The files are written
+  // and deleted on |file_task_runner|, which must also be the one the blob
+  // readers use, so that they only open files that have been written.
+  void EnableDiskSpilling(const base::FilePath& spill_directory,
+                          base::SequencedTaskRunner* file_task_runner);
+
+  void SetSpillThresholdForTesting(int64 threshold) {
+    spill_threshold_ = threshold;
+  }
+
  private:
   friend class BlobDataHandle;
   friend class BlobStorageHost;
@@ -62,6 +75,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
     int flags;
     scoped_refptr<BlobData> data;
 
+    // The trailing TYPE_BYTES items of a blob being built, which are
+    // candidates for spilling to disk.
+    size_t unspilled_bytes_start;
+    int64 unspilled_bytes_length;
+
     BlobMapEntry();
     BlobMapEntry(int refcount, int flags, BlobData* data);
     ~BlobMapEntry();
@@ -85,6 +103,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
                           uint64 length);
   bool AppendBytesItem(BlobData* target_blob_data,
                        const char* data, int64 length);
+
+  // Moves the trailing TYPE_BYTES items of |entry| to a file if they are
+  // large enough and blob data uses too much memory.
+  void MaybeSpillBytesItems(BlobMapEntry* entry, size_t first_new_item);
+  void OnSpillFileWritten(int64 length, bool success);
   void AppendFileItem(BlobData* target_blob_data,
                       const base::FilePath& file_path,
                       uint64 offset, uint64 length,
@@ -103,9 +126,16 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
 
   // Used to keep track of how much memory is being utitlized for blob data,
   // we count only the items of TYPE_DATA which are held in memory and not
-  // items of TYPE_FILE.
+  // items of TYPE_FILE. The bytes being spilled to disk are counted until
+  // they are written.
   int64 memory_usage_;
 
+  // The memory usage above which bytes are spilled to files, if enabled.
+  int64 spill_threshold_;
+  base::FilePath spill_directory_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  int64 next_spill_file_id_;
+
   DISALLOW_COPY_AND_ASSIGN(BlobStorageContext);
 };
 
@@ -2,10 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webkit/browser/blob/blob_data_handle.h"
@@ -203,6 +206,59 @@ TEST(BlobStorageContextTest, EarlyContextDeletion) {
   EXPECT_FALSE(host.RevokePublicBlobURL(kUrl));
 }
 
+TEST(BlobStorageContextTest, SpillToDisk) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath spill_directory = temp_dir.path().AppendASCII("spill");
+  base::MessageLoop fake_io_message_loop;
+  BlobStorageContext context;
+  context.EnableDiskSpilling(spill_directory,
+                             base::MessageLoopProxy::current().get());
+  context.SetSpillThresholdForTesting(0);
+  BlobStorageHost host(&context);
+
+  // Small blobs stay in memory.
+  const std::string kSmallId("small");
+  SetupBasicBlob(&host, kSmallId);
+  scoped_ptr<BlobDataHandle> small_handle =
+      context.GetBlobDataFromUUID(kSmallId);
+  ASSERT_TRUE(small_handle);
+  ASSERT_EQ(1u, small_handle->data()->items().size());
+  EXPECT_EQ(BlobData::Item::TYPE_BYTES,
+            small_handle->data()->items()[0].type());
+
+  // The bytes of large blobs are moved to a file.
+  const std::string kLargeId("large");
+  const std::string kBytes(2 * 1024 * 1024, 'x');
+  EXPECT_TRUE(host.StartBuildingBlob(kLargeId));
+  BlobData::Item item;
+  item.SetToBytes("1", 1);
+  EXPECT_TRUE(host.AppendBlobDataItem(kLargeId, item));
+  item.SetToBytes(kBytes.data(), kBytes.size());
+  EXPECT_TRUE(host.AppendBlobDataItem(kLargeId, item));
+  EXPECT_TRUE(host.FinishBuildingBlob(kLargeId, "text/plain"));
+  scoped_ptr<BlobDataHandle> large_handle =
+      context.GetBlobDataFromUUID(kLargeId);
+  ASSERT_TRUE(large_handle);
+  ASSERT_EQ(1u, large_handle->data()->items().size());
+  const BlobData::Item& spilled = large_handle->data()->items()[0];
+  EXPECT_EQ(BlobData::Item::TYPE_FILE, spilled.type());
+  EXPECT_EQ(kBytes.size() + 1, spilled.length());
+  base::FilePath spill_file = spilled.path();
+  EXPECT_EQ(spill_directory, spill_file.DirName());
+
+  fake_io_message_loop.RunUntilIdle();
+  std::string contents;
+  EXPECT_TRUE(base::ReadFileToString(spill_file, &contents));
+  EXPECT_EQ("1" + kBytes, contents);
+
+  // The file is deleted with the blob.
+  large_handle.reset();
+  EXPECT_TRUE(host.DecrementBlobRefCount(kLargeId));
+  fake_io_message_loop.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(spill_file));
+}
+
 // TODO(michaeln): tests for the depcrecated url stuff
 
 }  // namespace webkit_blob
@@ -4,6 +4,8 @@
 
 #include "webkit/browser/fileapi/copy_or_move_operation_delegate.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "net/base/io_buffer.h"
@@ -351,8 +353,14 @@ class SnapshotCopyOrMoveImpl
   DISALLOW_COPY_AND_ASSIGN(SnapshotCopyOrMoveImpl);
 };
 
-// The size of buffer for StreamCopyHelper.
+// The initial and maximum sizes of the buffer for StreamCopyHelper.
 const int kReadBufferSize = 32768;
+const int kMaxReadBufferSize = 1024 * 1024;
+
+// Files up to this size are copied between native local file systems in a
+// single task on the file thread. Larger ones are streamed so that their
+// progress is reported and the copy can be cancelled.
+const int64 kMaxNativeCopyFileSize = 4 * 1024 * 1024;
 
 // To avoid too many progress callbacks, it should be called less
 // frequently than 50ms.
@@ -422,6 +430,22 @@ class StreamCopyOrMoveImpl
       return;
     }
 
+    base::FilePath platform_path;
+    if (src_url_.type() == kFileSystemTypeNativeLocal &&
+        dest_url_.type() == kFileSystemTypeNativeLocal &&
+        file_info.size <= kMaxNativeCopyFileSize &&
+        operation_runner_->SyncGetPlatformPath(src_url_, &platform_path) ==
+            base::File::FILE_OK) {
+      // Both ends are plain files on disk, so let base::CopyFile do the whole
+      // copy instead of bouncing buffers through this thread.
+      file_progress_callback_.Run(0);
+      operation_runner_->CopyInForeignFile(
+          platform_path, dest_url_,
+          base::Bind(&StreamCopyOrMoveImpl::RunAfterNativeCopy,
+                     weak_factory_.GetWeakPtr(), callback, file_info));
+      return;
+    }
+
     // To use FileStreamWriter, we need to ensure the destination file exists.
     operation_runner_->CreateFile(
         dest_url_, false /* exclusive */,
@@ -451,6 +475,7 @@ class StreamCopyOrMoveImpl
             reader_.Pass(), writer_.Pass(),
             need_flush,
             kReadBufferSize,
+            kMaxReadBufferSize,
             file_progress_callback_,
             base::TimeDelta::FromMilliseconds(
                 kMinProgressCallbackInvocationSpanInMilliseconds)));
@@ -459,6 +484,15 @@ class StreamCopyOrMoveImpl
                    weak_factory_.GetWeakPtr(), callback, last_modified));
   }
 
+  void RunAfterNativeCopy(
+      const CopyOrMoveOperationDelegate::StatusCallback& callback,
+      const base::File::Info& file_info,
+      base::File::Error error) {
+    if (error == base::File::FILE_OK)
+      file_progress_callback_.Run(file_info.size);
+    RunAfterStreamCopy(callback, file_info.last_modified, error);
+  }
+
   void RunAfterStreamCopy(
       const CopyOrMoveOperationDelegate::StatusCallback& callback,
       const base::Time& last_modified,
@@ -536,12 +570,14 @@ CopyOrMoveOperationDelegate::StreamCopyHelper::StreamCopyHelper(
     scoped_ptr<FileStreamWriter> writer,
     bool need_flush,
     int buffer_size,
+    int max_buffer_size,
     const FileSystemOperation::CopyFileProgressCallback&
         file_progress_callback,
     const base::TimeDelta& min_progress_callback_invocation_span)
     : reader_(reader.Pass()),
       writer_(writer.Pass()),
       need_flush_(need_flush),
+      max_buffer_size_(std::max(buffer_size, max_buffer_size)),
       file_progress_callback_(file_progress_callback),
       io_buffer_(new net::IOBufferWithSize(buffer_size)),
       num_copied_bytes_(0),
@@ -597,7 +633,15 @@ void CopyOrMoveOperationDelegate::StreamCopyHelper::DidRead(
     return;
   }
 
-  Write(callback, new net::DrainableIOBuffer(io_buffer_.get(), result));
+  scoped_refptr<net::DrainableIOBuffer> buffer =
+      new net::DrainableIOBuffer(io_buffer_.get(), result);
+  // A full read means there is likely more to come, so read more at a time
+  // to save round trips to the file thread. |buffer| keeps the old one alive.
+  if (result == io_buffer_->size() && io_buffer_->size() < max_buffer_size_) {
+    io_buffer_ = new net::IOBufferWithSize(
+        std::min(io_buffer_->size() * 2, max_buffer_size_));
+  }
+  Write(callback, buffer);
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::Write(
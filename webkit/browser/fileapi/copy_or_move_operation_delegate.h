@@ -42,6 +42,8 @@ class CopyOrMoveOperationDelegate
   };
 
   // Helper to copy a file by reader and writer streams.
+  // The buffer starts at |buffer_size| bytes, and doubles up to
+  // |max_buffer_size| bytes each time a read fills it.
   // Export for testing.
   class WEBKIT_STORAGE_BROWSER_EXPORT StreamCopyHelper {
    public:
@@ -50,6 +52,7 @@ class CopyOrMoveOperationDelegate
         scoped_ptr<FileStreamWriter> writer,
         bool need_flush,
         int buffer_size,
+        int max_buffer_size,
         const FileSystemOperation::CopyFileProgressCallback&
             file_progress_callback,
         const base::TimeDelta& min_progress_callback_invocation_span);
@@ -79,6 +82,7 @@ class CopyOrMoveOperationDelegate
     scoped_ptr<webkit_blob::FileStreamReader> reader_;
     scoped_ptr<FileStreamWriter> writer_;
     const bool need_flush_;
+    const int max_buffer_size_;
     FileSystemOperation::CopyFileProgressCallback file_progress_callback_;
     scoped_refptr<net::IOBufferWithSize> io_buffer_;
     int64 num_copied_bytes_;
@@ -74,6 +74,7 @@ const char kChildLookupSeparator[] = ":";
 const char kLastFileIdKey[] = "LAST_FILE_ID";
 const char kLastIntegerKey[] = "LAST_INTEGER";
 const int64 kMinimumReportIntervalHours = 1;
+const size_t kMaxCachedChildIds = 10000;
 const char kInitStatusHistogramLabel[] = "FileSystem.DirectoryDatabaseInit";
 const char kDatabaseRepairHistogramLabel[] =
     "FileSystem.DirectoryDatabaseRepair";
@@ -427,6 +428,11 @@ bool SandboxDirectoryDatabase::GetChildWithName(
     return false;
   DCHECK(child_id);
   std::string child_key = GetChildLookupKey(parent_id, name);
+  ChildIdCache::const_iterator found = child_id_cache_.find(child_key);
+  if (found != child_id_cache_.end()) {
+    *child_id = found->second;
+    return true;
+  }
   std::string child_id_string;
   leveldb::Status status =
       db_->Get(leveldb::ReadOptions(), child_key, &child_id_string);
@@ -437,6 +443,7 @@ bool SandboxDirectoryDatabase::GetChildWithName(
       LOG(ERROR) << "Hit database corruption!";
       return false;
     }
+    CacheChildId(child_key, *child_id);
     return true;
   }
   HandleError(FROM_HERE, status);
@@ -480,6 +487,8 @@ bool SandboxDirectoryDatabase::ListChildren(
       LOG(ERROR) << "Hit database corruption!";
       return false;
     }
+    // The key is the child's lookup key, so it can be cached as is.
+    CacheChildId(iter->key().ToString(), child_id);
     children->push_back(child_id);
     iter->Next();
   }
@@ -719,6 +728,10 @@ bool SandboxDirectoryDatabase::Init(RecoveryOption recovery_option) {
   if (db_)
     return true;
 
+  // The database may have been repaired or recreated since the ids were
+  // cached.
+  child_id_cache_.clear();
+
   std::string path =
       FilePathToString(filesystem_data_directory_.Append(
           kDirectoryDatabaseName));
@@ -800,6 +813,8 @@ bool SandboxDirectoryDatabase::IsDirectory(FileId file_id) {
 bool SandboxDirectoryDatabase::IsFileSystemConsistent() {
   if (!Init(FAIL_ON_CORRUPTION))
     return false;
+  // Check what is in the database rather than what was cached.
+  child_id_cache_.clear();
   DatabaseCheckHelper helper(this, db_.get(), filesystem_data_directory_);
   return helper.IsFileSystemConsistent();
 }
@@ -894,6 +909,7 @@ bool SandboxDirectoryDatabase::AddFileInfoHelper(
   } else {
     std::string child_key = GetChildLookupKey(info.parent_id, info.name);
     batch->Put(child_key, id_string);
+    child_id_cache_.erase(child_key);
   }
   Pickle pickle;
   if (!PickleFromFileInfo(info, &pickle))
@@ -922,8 +938,10 @@ bool SandboxDirectoryDatabase::RemoveFileInfoHelper(
       return false;
     }
   }
-  batch->Delete(GetChildLookupKey(info.parent_id, info.name));
+  std::string child_key = GetChildLookupKey(info.parent_id, info.name);
+  batch->Delete(child_key);
   batch->Delete(GetFileLookupKey(file_id));
+  child_id_cache_.erase(child_key);
   return true;
 }
 
@@ -933,6 +951,16 @@ void SandboxDirectoryDatabase::HandleError(
   LOG(ERROR) << "SandboxDirectoryDatabase failed at: "
              << from_here.ToString() << " with error: " << status.ToString();
   db_.reset();
+  child_id_cache_.clear();
+}
+
+void SandboxDirectoryDatabase::CacheChildId(const std::string& child_key,
+                                            FileId child_id) {
+  // Start over rather than track the use of the entries; the working set of
+  // an app is usually much smaller than the limit.
+  if (child_id_cache_.size() >= kMaxCachedChildIds)
+    child_id_cache_.clear();
+  child_id_cache_[child_key] = child_id;
 }
 
 }  // namespace fileapi
@@ -5,6 +5,7 @@
 #ifndef WEBKIT_BROWSER_FILEAPI_SANDBOX_DIRECTORY_DATABASE_H_
 #define WEBKIT_BROWSER_FILEAPI_SANDBOX_DIRECTORY_DATABASE_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -68,7 +69,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE SandboxDirectoryDatabase {
       FileId* child_id);
   bool GetFileWithPath(const base::FilePath& path, FileId* file_id);
   // ListChildren will succeed, returning 0 children, if parent_id doesn't
-  // exist.
+  // exist.  The children found are remembered for GetChildWithName, so that
+  // looking up the entries of a listed directory needs no further reads.
   bool ListChildren(FileId parent_id, std::vector<FileId>* children);
   bool GetFileInfo(FileId file_id, FileInfo* info);
   base::File::Error AddFileInfo(const FileInfo& info, FileId* file_id);
@@ -108,6 +110,10 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE SandboxDirectoryDatabase {
   friend class ObfuscatedFileUtil;
   friend class SandboxDirectoryDatabaseTest;
 
+  // Maps child lookup keys, i.e. a parent id and a child name, to the id of
+  // the child.
+  typedef std::map<std::string, FileId> ChildIdCache;
+
   bool Init(RecoveryOption recovery_option);
   bool RepairDatabase(const std::string& db_path);
   void ReportInitStatus(const leveldb::Status& status);
@@ -118,11 +124,18 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE SandboxDirectoryDatabase {
   bool RemoveFileInfoHelper(FileId file_id, leveldb::WriteBatch* batch);
   void HandleError(const tracked_objects::Location& from_here,
                    const leveldb::Status& status);
+  void CacheChildId(const std::string& child_key, FileId child_id);
 
   const base::FilePath filesystem_data_directory_;
   leveldb::Env* env_override_;
   scoped_ptr<leveldb::DB> db_;
   base::Time last_reported_time_;
+
+  // Caches the ids found by GetChildWithName and ListChildren, as resolving a
+  // path otherwise takes a LevelDB read per component.  Entries are dropped
+  // when their child is added, moved or removed, and all of them when |db_|
+  // is reopened.
+  ChildIdCache child_id_cache_;
   DISALLOW_COPY_AND_ASSIGN(SandboxDirectoryDatabase);
 };
 
@@ -0,0 +1,137 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "webkit/browser/fileapi/sandbox_directory_database.h"
+
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace fileapi {
+
+namespace {
+
+typedef SandboxDirectoryDatabase::FileId FileId;
+typedef SandboxDirectoryDatabase::FileInfo FileInfo;
+
+const int kIterations = 20;
+
+}  // namespace
+
+// Resolves paths and lists directories the way ObfuscatedFileUtil does, with
+// a freshly opened database ("cold") and with one that was used before
+// ("warm").
+class SandboxDirectoryDatabasePerfTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    ReopenDatabase();
+  }
+
+ protected:
+  void ReopenDatabase() {
+    db_.reset();
+    db_.reset(new SandboxDirectoryDatabase(temp_dir_.path(), NULL));
+  }
+
+  FileId AddEntry(FileId parent_id,
+                  const std::string& name,
+                  bool is_directory) {
+    FileInfo info;
+    info.parent_id = parent_id;
+    info.name = base::FilePath::FromUTF8Unsafe(name).value();
+    if (!is_directory)
+      info.data_path = base::FilePath::FromUTF8Unsafe("00/" + name);
+    FileId file_id = 0;
+    EXPECT_EQ(base::File::FILE_OK, db_->AddFileInfo(info, &file_id));
+    return file_id;
+  }
+
+  void PrintOpsPerSecond(const std::string& trace,
+                         int ops,
+                         const base::TimeDelta& elapsed) {
+    perf_test::PrintResult("ops_per_sec", "", trace,
+                           ops / elapsed.InSecondsF(), "ops/s", true);
+  }
+
+  // Resolves the path of a file |depth| directories deep, like the nested
+  // caches of PNaCl translations.
+  void RunDeepPathBenchmark(int depth) {
+    base::FilePath path;
+    FileId parent_id = 0;
+    for (int i = 0; i < depth; ++i) {
+      std::string name = base::StringPrintf("dir%d", i);
+      parent_id = AddEntry(parent_id, name, true);
+      path = path.AppendASCII(name);
+    }
+    AddEntry(parent_id, "file", false);
+    path = path.AppendASCII("file");
+
+    const int kLookups = 1000;
+    base::TimeDelta cold;
+    base::TimeDelta warm;
+    for (int i = 0; i < kIterations; ++i) {
+      ReopenDatabase();
+      FileId file_id;
+      base::TimeTicks start = base::TimeTicks::Now();
+      ASSERT_TRUE(db_->GetFileWithPath(path, &file_id));
+      cold += base::TimeTicks::Now() - start;
+      start = base::TimeTicks::Now();
+      for (int j = 0; j < kLookups; ++j)
+        ASSERT_TRUE(db_->GetFileWithPath(path, &file_id));
+      warm += base::TimeTicks::Now() - start;
+    }
+    std::string trace = base::StringPrintf("depth_%d", depth);
+    PrintOpsPerSecond(trace + "_cold", kIterations, cold);
+    PrintOpsPerSecond(trace + "_warm", kIterations * kLookups, warm);
+  }
+
+  // Lists a directory of |file_count| files and looks each of them up, like
+  // an app scanning its files to compute their quota usage.
+  void RunListAndLookupBenchmark(int file_count) {
+    FileId dir_id = AddEntry(0, "dir", true);
+    std::vector<base::FilePath> paths;
+    for (int i = 0; i < file_count; ++i) {
+      std::string name = base::StringPrintf("file%d", i);
+      AddEntry(dir_id, name, false);
+      paths.push_back(base::FilePath::FromUTF8Unsafe("dir/" + name));
+    }
+
+    base::TimeDelta elapsed;
+    for (int i = 0; i < kIterations; ++i) {
+      ReopenDatabase();
+      base::TimeTicks start = base::TimeTicks::Now();
+      std::vector<FileId> children;
+      ASSERT_TRUE(db_->ListChildren(dir_id, &children));
+      ASSERT_EQ(static_cast<size_t>(file_count), children.size());
+      for (size_t j = 0; j < paths.size(); ++j) {
+        FileId file_id;
+        ASSERT_TRUE(db_->GetFileWithPath(paths[j], &file_id));
+        FileInfo info;
+        ASSERT_TRUE(db_->GetFileInfo(file_id, &info));
+      }
+      elapsed += base::TimeTicks::Now() - start;
+    }
+    PrintOpsPerSecond(base::StringPrintf("list_and_lookup_%d", file_count),
+                      kIterations * (file_count + 1), elapsed);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  scoped_ptr<SandboxDirectoryDatabase> db_;
+};
+
+TEST_F(SandboxDirectoryDatabasePerfTest, DeepPath) {
+  RunDeepPathBenchmark(16);
+}
+
+TEST_F(SandboxDirectoryDatabasePerfTest, ListAndLookup) {
+  RunListAndLookupBenchmark(1000);
+}
+
+}  // namespace fileapi
@@ -110,6 +110,10 @@ class SandboxDirectoryDatabaseTest : public testing::Test {
     return base_.path();
   }
 
+  size_t CachedChildIdCount() {
+    return db()->child_id_cache_.size();
+  }
+
   // Makes link from |parent_id| to |child_id| with |name|.
   void MakeHierarchyLink(FileId parent_id,
                          FileId child_id,
@@ -369,6 +373,47 @@ TEST_F(SandboxDirectoryDatabaseTest, TestListChildren) {
   }
 }
 
+TEST_F(SandboxDirectoryDatabaseTest, TestChildIdCache) {
+  FileId dir_id;
+  FileId file_id;
+  CreateDirectory(0, FPL("foo"), &dir_id);
+  CreateDirectory(dir_id, FPL("bar"), &file_id);
+  EXPECT_EQ(0u, CachedChildIdCount());
+
+  FileId check_file_id;
+  EXPECT_TRUE(db()->GetFileWithPath(
+      base::FilePath(FPL("foo")).Append(FPL("bar")), &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+  EXPECT_EQ(2u, CachedChildIdCount());
+
+  // Renaming drops the old name.
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(file_id, &info));
+  info.name = FPL("baz");
+  EXPECT_TRUE(db()->UpdateFileInfo(file_id, info));
+  EXPECT_FALSE(db()->GetChildWithName(dir_id, FPL("bar"), &check_file_id));
+  EXPECT_TRUE(db()->GetChildWithName(dir_id, FPL("baz"), &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  // Removing drops the entry, and a new file with the same name is found.
+  EXPECT_TRUE(db()->RemoveFileInfo(file_id));
+  EXPECT_FALSE(db()->GetChildWithName(dir_id, FPL("baz"), &check_file_id));
+  FileId new_file_id;
+  CreateDirectory(dir_id, FPL("baz"), &new_file_id);
+  EXPECT_NE(file_id, new_file_id);
+  EXPECT_TRUE(db()->GetChildWithName(dir_id, FPL("baz"), &check_file_id));
+  EXPECT_EQ(new_file_id, check_file_id);
+
+  // Listing a directory caches its children.
+  InitDatabase();
+  std::vector<FileId> children;
+  EXPECT_TRUE(db()->ListChildren(dir_id, &children));
+  EXPECT_EQ(1u, children.size());
+  EXPECT_EQ(1u, CachedChildIdCount());
+  EXPECT_TRUE(db()->GetChildWithName(dir_id, FPL("baz"), &check_file_id));
+  EXPECT_EQ(new_file_id, check_file_id);
+}
+
 TEST_F(SandboxDirectoryDatabaseTest, TestUpdateModificationTime) {
   FileInfo info0;
   FileId file_id;
@@ -23,6 +23,10 @@ namespace quota {
 struct UsageInfo;
 typedef std::vector<UsageInfo> UsageInfoEntries;
 
+// The usage of the origins of each quota client of a storage type, keyed by
+// QuotaClient::ID.
+typedef std::map<int, std::map<GURL, int64> > UsageSnapshot;
+
 // Common callback types that are used throughout in the quota module.
 typedef base::Callback<void(int64 usage,
                             int64 unlimited_usage)> GlobalUsageCallback;
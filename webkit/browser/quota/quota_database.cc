@@ -23,17 +23,26 @@ namespace {
 
 // Definitions for database schema.
 
-const int kCurrentVersion = 4;
+const int kCurrentVersion = 5;
 const int kCompatibleVersion = 2;
 
 const char kHostQuotaTable[] = "HostQuotaTable";
 const char kOriginInfoTable[] = "OriginInfoTable";
+const char kOriginUsageTable[] = "OriginUsageTable";
+// An empty origin marks a client that has no origins.
+const char kOriginUsageTableColumns[] =
+    "(origin TEXT NOT NULL,"
+    " type INTEGER NOT NULL,"
+    " client_id INTEGER NOT NULL,"
+    " usage INTEGER DEFAULT 0,"
+    " UNIQUE(origin, type, client_id))";
 const char kIsOriginTableBootstrapped[] = "IsOriginTableBootstrapped";
 
 bool VerifyValidQuotaConfig(const char* key) {
   return (key != NULL &&
           (!strcmp(key, QuotaDatabase::kDesiredAvailableSpaceKey) ||
-           !strcmp(key, QuotaDatabase::kTemporaryQuotaOverrideKey)));
+           !strcmp(key, QuotaDatabase::kTemporaryQuotaOverrideKey) ||
+           !strcmp(key, QuotaDatabase::kUsageSnapshotTimeKey)));
 }
 
 const int kCommitIntervalMs = 30000;
@@ -44,6 +53,7 @@ const int kCommitIntervalMs = 30000;
 const char QuotaDatabase::kDesiredAvailableSpaceKey[] = "DesiredAvailableSpace";
 const char QuotaDatabase::kTemporaryQuotaOverrideKey[] =
     "TemporaryQuotaOverride";
+const char QuotaDatabase::kUsageSnapshotTimeKey[] = "UsageSnapshotTime";
 
 const QuotaDatabase::TableSchema QuotaDatabase::kTables[] = {
   { kHostQuotaTable,
@@ -58,6 +68,7 @@ const QuotaDatabase::TableSchema QuotaDatabase::kTables[] = {
     " last_access_time INTEGER DEFAULT 0,"
     " last_modified_time INTEGER DEFAULT 0,"
     " UNIQUE(origin, type))" },
+  { kOriginUsageTable, kOriginUsageTableColumns },
 };
 
 // static
@@ -78,6 +89,10 @@ const QuotaDatabase::IndexSchema QuotaDatabase::kIndexes[] = {
     kOriginInfoTable,
     "(last_modified_time)",
     false },
+  { "OriginUsageTypeIndex",
+    kOriginUsageTable,
+    "(type)",
+    false },
 };
 
 struct QuotaDatabase::QuotaTableImporter {
@@ -391,6 +406,84 @@ bool QuotaDatabase::SetOriginDatabaseBootstrapped(bool bootstrap_flag) {
   return meta_table_->SetValue(kIsOriginTableBootstrapped, bootstrap_flag);
 }
 
+bool QuotaDatabase::GetUsageSnapshot(
+    StorageType type, UsageSnapshot* snapshot) {
+  DCHECK(snapshot);
+  snapshot->clear();
+  if (!LazyOpen(false))
+    return false;
+
+  const char* kSql = "SELECT client_id, origin, usage FROM OriginUsageTable"
+                     " WHERE type = ?";
+
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+  statement.BindInt(0, static_cast<int>(type));
+
+  while (statement.Step()) {
+    std::map<GURL, int64>& origins = (*snapshot)[statement.ColumnInt(0)];
+    std::string origin = statement.ColumnString(1);
+    if (!origin.empty())
+      origins[GURL(origin)] = statement.ColumnInt64(2);
+  }
+
+  return statement.Succeeded();
+}
+
+bool QuotaDatabase::SetUsageSnapshot(
+    StorageType type, const UsageSnapshot& snapshot) {
+  if (!LazyOpen(true))
+    return false;
+
+  const char* kDeleteSql = "DELETE FROM OriginUsageTable WHERE type = ?";
+  sql::Statement delete_statement(
+      db_->GetCachedStatement(SQL_FROM_HERE, kDeleteSql));
+  delete_statement.BindInt(0, static_cast<int>(type));
+  if (!delete_statement.Run())
+    return false;
+
+  for (UsageSnapshot::const_iterator client = snapshot.begin();
+       client != snapshot.end(); ++client) {
+    const std::map<GURL, int64>& origins = client->second;
+    if (origins.empty() &&
+        !InsertOriginUsage(std::string(), type, client->first, 0)) {
+      return false;
+    }
+    for (std::map<GURL, int64>::const_iterator origin = origins.begin();
+         origin != origins.end(); ++origin) {
+      if (!InsertOriginUsage(origin->first.spec(), type, client->first,
+                             origin->second)) {
+        return false;
+      }
+    }
+  }
+
+  ScheduleCommit();
+  return true;
+}
+
+bool QuotaDatabase::InsertOriginUsage(
+    const std::string& origin, StorageType type, int client_id, int64 usage) {
+  const char* kSql =
+      "INSERT INTO OriginUsageTable"
+      " (origin, type, client_id, usage) VALUES (?, ?, ?, ?)";
+  sql::Statement statement(db_->GetCachedStatement(SQL_FROM_HERE, kSql));
+  statement.BindString(0, origin);
+  statement.BindInt(1, static_cast<int>(type));
+  statement.BindInt(2, client_id);
+  statement.BindInt64(3, usage);
+  return statement.Run();
+}
+
+bool QuotaDatabase::InvalidateUsageSnapshots() {
+  if (!LazyOpen(false))
+    return true;
+
+  if (!meta_table_->SetValue(kUsageSnapshotTimeKey, static_cast<int64>(0)))
+    return false;
+  Commit();
+  return true;
+}
+
 void QuotaDatabase::Commit() {
   if (!db_)
     return;
@@ -587,6 +680,21 @@ bool QuotaDatabase::UpgradeSchema(int current_version) {
     Commit();
     return true;
   }
+  if (current_version == 4) {
+    sql::Transaction transaction(db_.get());
+    if (!transaction.Begin())
+      return false;
+    std::string sql("CREATE TABLE ");
+    sql += kOriginUsageTable;
+    sql += kOriginUsageTableColumns;
+    if (!db_->Execute(sql.c_str()) ||
+        !db_->Execute("CREATE INDEX OriginUsageTypeIndex"
+                      " ON OriginUsageTable(type)")) {
+      return false;
+    }
+    meta_table_->SetVersionNumber(kCurrentVersion);
+    return transaction.Commit();
+  }
   return false;
 }
 
@@ -16,6 +16,7 @@
 #include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "url/gurl.h"
+#include "webkit/browser/quota/quota_callbacks.h"
 #include "webkit/browser/webkit_storage_browser_export.h"
 #include "webkit/common/quota/quota_types.h"
 
@@ -36,6 +37,7 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
   // Constants for {Get,Set}QuotaConfigValue keys.
   static const char kDesiredAvailableSpaceKey[];
   static const char kTemporaryQuotaOverrideKey[];
+  static const char kUsageSnapshotTimeKey[];
 
   // If 'path' is empty, an in memory database will be used.
   explicit QuotaDatabase(const base::FilePath& path);
@@ -87,6 +89,16 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
   bool IsOriginDatabaseBootstrapped();
   bool SetOriginDatabaseBootstrapped(bool bootstrap_flag);
 
+  // Reads the usage snapshot of |type| last written by SetUsageSnapshot into
+  // |snapshot|. A client is in the snapshot only if all its origins are, so
+  // clients without origins map to an empty map.
+  bool GetUsageSnapshot(StorageType type, UsageSnapshot* snapshot);
+  bool SetUsageSnapshot(StorageType type, const UsageSnapshot& snapshot);
+
+  // Clears kUsageSnapshotTimeKey, which tells that the usage snapshots are
+  // stale, and commits right away so that a crash can't leave them valid.
+  bool InvalidateUsageSnapshots();
+
  private:
   struct WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaTableEntry {
     QuotaTableEntry();
@@ -147,6 +159,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT_PRIVATE QuotaDatabase {
                            StorageType type,
                            int* used_count);
 
+  bool InsertOriginUsage(const std::string& origin,
+                         StorageType type,
+                         int client_id,
+                         int64 usage);
+
   bool LazyOpen(bool create_if_needed);
   bool EnsureDatabaseVersion();
   bool ResetSchema();
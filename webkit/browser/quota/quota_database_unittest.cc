@@ -18,6 +18,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/gurl.h"
 #include "webkit/browser/quota/mock_special_storage_policy.h"
+#include "webkit/browser/quota/quota_client.h"
 #include "webkit/browser/quota/quota_database.h"
 
 namespace quota {
@@ -124,6 +125,39 @@ class QuotaDatabaseTest : public testing::Test {
     EXPECT_EQ(kValue2, value);
   }
 
+  void UsageSnapshots(const base::FilePath& kDbFile) {
+    QuotaDatabase db(kDbFile);
+    ASSERT_TRUE(db.LazyOpen(true));
+
+    const GURL kOrigin1("http://a/");
+    const GURL kOrigin2("http://b/");
+    UsageSnapshot snapshot;
+    snapshot[QuotaClient::kFileSystem][kOrigin1] = 10;
+    snapshot[QuotaClient::kFileSystem][kOrigin2] = 20;
+    snapshot[QuotaClient::kDatabase];
+    EXPECT_TRUE(db.SetUsageSnapshot(kStorageTypeTemporary, snapshot));
+
+    UsageSnapshot read_snapshot;
+    EXPECT_TRUE(db.GetUsageSnapshot(kStorageTypeTemporary, &read_snapshot));
+    EXPECT_EQ(snapshot, read_snapshot);
+    EXPECT_TRUE(db.GetUsageSnapshot(kStorageTypePersistent, &read_snapshot));
+    EXPECT_TRUE(read_snapshot.empty());
+
+    // Setting a snapshot replaces the previous one of the same type.
+    UsageSnapshot new_snapshot;
+    new_snapshot[QuotaClient::kFileSystem][kOrigin2] = 30;
+    EXPECT_TRUE(db.SetUsageSnapshot(kStorageTypeTemporary, new_snapshot));
+    EXPECT_TRUE(db.GetUsageSnapshot(kStorageTypeTemporary, &read_snapshot));
+    EXPECT_EQ(new_snapshot, read_snapshot);
+
+    const char* kTimeKey = QuotaDatabase::kUsageSnapshotTimeKey;
+    int64 time = 0;
+    EXPECT_TRUE(db.SetQuotaConfigValue(kTimeKey, 12345));
+    EXPECT_TRUE(db.InvalidateUsageSnapshots());
+    EXPECT_TRUE(db.GetQuotaConfigValue(kTimeKey, &time));
+    EXPECT_EQ(0, time);
+  }
+
   void OriginLastAccessTimeLRU(const base::FilePath& kDbFile) {
     QuotaDatabase db(kDbFile);
     ASSERT_TRUE(db.LazyOpen(true));
@@ -507,6 +541,14 @@ TEST_F(QuotaDatabaseTest, GlobalQuota) {
   GlobalQuota(base::FilePath());
 }
 
+TEST_F(QuotaDatabaseTest, UsageSnapshots) {
+  base::ScopedTempDir data_dir;
+  ASSERT_TRUE(data_dir.CreateUniqueTempDir());
+  const base::FilePath kDbFile = data_dir.path().AppendASCII(kDBFileName);
+  UsageSnapshots(kDbFile);
+  UsageSnapshots(base::FilePath());
+}
+
 TEST_F(QuotaDatabaseTest, OriginLastAccessTimeLRU) {
   base::ScopedTempDir data_dir;
   ASSERT_TRUE(data_dir.CreateUniqueTempDir());
@@ -42,6 +42,11 @@ const int64 kMBytes = 1024 * 1024;
 const int kMinutesInMilliSeconds = 60 * 1000;
 
 const int64 kReportHistogramInterval = 60 * 60 * 1000;  // 1 hour
+const int64 kUsageSnapshotInterval = 5 * kMinutesInMilliSeconds;
+
+// The usage snapshots are dropped once they are this old, so that the usage
+// gets gathered from the clients again in case a change was missed.
+const int kMaxUsageSnapshotAgeInDays = 7;
 const double kTemporaryQuotaRatioToAvail = 1.0 / 3.0;  // 33%
 
 }  // namespace
@@ -131,17 +136,63 @@ bool SetPersistentHostQuotaOnDBThread(const std::string& host,
   return false;
 }
 
+const StorageType kUsageSnapshotTypes[] = {
+  kStorageTypeTemporary,
+  kStorageTypePersistent,
+  kStorageTypeSyncable,
+};
+
 bool InitializeOnDBThread(int64* temporary_quota_override,
                           int64* desired_available_space,
+                          int64* usage_snapshot_time,
+                          std::map<StorageType, UsageSnapshot>* snapshots,
                           QuotaDatabase* database) {
   DCHECK(database);
   database->GetQuotaConfigValue(QuotaDatabase::kTemporaryQuotaOverrideKey,
                                 temporary_quota_override);
   database->GetQuotaConfigValue(QuotaDatabase::kDesiredAvailableSpaceKey,
                                 desired_available_space);
+
+  // The time is cleared when the usage changes after the snapshots are
+  // written.
+  database->GetQuotaConfigValue(QuotaDatabase::kUsageSnapshotTimeKey,
+                                usage_snapshot_time);
+  base::Time snapshot_time =
+      base::Time::FromInternalValue(*usage_snapshot_time);
+  if (*usage_snapshot_time <= 0 || snapshot_time > base::Time::Now() ||
+      base::Time::Now() - snapshot_time >
+          base::TimeDelta::FromDays(kMaxUsageSnapshotAgeInDays)) {
+    *usage_snapshot_time = 0;
+    return true;
+  }
+  for (size_t i = 0; i < arraysize(kUsageSnapshotTypes); ++i) {
+    StorageType type = kUsageSnapshotTypes[i];
+    if (!database->GetUsageSnapshot(type, &(*snapshots)[type]))
+      snapshots->erase(type);
+  }
   return true;
 }
 
+bool InvalidateUsageSnapshotsOnDBThread(QuotaDatabase* database) {
+  DCHECK(database);
+  return database->InvalidateUsageSnapshots();
+}
+
+bool WriteUsageSnapshotsOnDBThread(
+    const std::map<StorageType, UsageSnapshot>* snapshots,
+    base::Time snapshot_time,
+    QuotaDatabase* database) {
+  DCHECK(database);
+  for (std::map<StorageType, UsageSnapshot>::const_iterator iter =
+           snapshots->begin();
+       iter != snapshots->end(); ++iter) {
+    if (!database->SetUsageSnapshot(iter->first, iter->second))
+      return false;
+  }
+  return database->SetQuotaConfigValue(QuotaDatabase::kUsageSnapshotTimeKey,
+                                       snapshot_time.ToInternalValue());
+}
+
 bool GetLRUOriginOnDBThread(StorageType type,
                             std::set<GURL>* exceptions,
                             SpecialStoragePolicy* policy,
@@ -807,6 +858,7 @@ QuotaManager::QuotaManager(bool is_incognito,
     temporary_quota_override_(-1),
     desired_available_space_(-1),
     special_storage_policy_(special_storage_policy),
+    usage_snapshots_dirty_(false),
     get_disk_space_fn_(&CallSystemGetAmountOfFreeDiskSpace),
     weak_factory_(this) {
 }
@@ -1176,6 +1228,8 @@ bool QuotaManager::ResetUsageTracker(StorageType type) {
 }
 
 QuotaManager::~QuotaManager() {
+  if (usage_snapshots_dirty_)
+    WriteUsageSnapshots();
   proxy_->manager_ = NULL;
   std::for_each(clients_.begin(), clients_.end(),
                 std::mem_fun(&QuotaClient::OnQuotaManagerDestroyed));
@@ -1208,17 +1262,29 @@ void QuotaManager::LazyInitialize() {
   syncable_usage_tracker_.reset(new UsageTracker(
       clients_, kStorageTypeSyncable, special_storage_policy_.get()));
 
+  // Incognito profiles have nothing persisted to start from.
+  if (!is_incognito_) {
+    for (size_t i = 0; i < arraysize(kUsageSnapshotTypes); ++i)
+      GetUsageTracker(kUsageSnapshotTypes[i])->WaitForUsageSnapshot();
+  }
+
   int64* temporary_quota_override = new int64(-1);
   int64* desired_available_space = new int64(-1);
+  int64* usage_snapshot_time = new int64(0);
+  UsageSnapshotMap* usage_snapshots = new UsageSnapshotMap;
   PostTaskAndReplyWithResultForDBThread(
       FROM_HERE,
       base::Bind(&InitializeOnDBThread,
                  base::Unretained(temporary_quota_override),
-                 base::Unretained(desired_available_space)),
+                 base::Unretained(desired_available_space),
+                 base::Unretained(usage_snapshot_time),
+                 base::Unretained(usage_snapshots)),
       base::Bind(&QuotaManager::DidInitialize,
                  weak_factory_.GetWeakPtr(),
                  base::Owned(temporary_quota_override),
-                 base::Owned(desired_available_space)));
+                 base::Owned(desired_available_space),
+                 base::Owned(usage_snapshot_time),
+                 base::Owned(usage_snapshots)));
 }
 
 void QuotaManager::RegisterClient(QuotaClient* client) {
@@ -1279,6 +1345,7 @@ void QuotaManager::NotifyStorageModifiedInternal(
   LazyInitialize();
   DCHECK(GetUsageTracker(type));
   GetUsageTracker(type)->UpdateUsageCache(client_id, origin, delta);
+  MarkUsageSnapshotsDirty();
 
   PostTaskAndReplyWithResultForDBThread(
       FROM_HERE,
@@ -1513,12 +1580,32 @@ void QuotaManager::DidSetPersistentHostQuota(const std::string& host,
 
 void QuotaManager::DidInitialize(int64* temporary_quota_override,
                                  int64* desired_available_space,
+                                 int64* usage_snapshot_time,
+                                 UsageSnapshotMap* usage_snapshots,
                                  bool success) {
   temporary_quota_override_ = *temporary_quota_override;
   desired_available_space_ = *desired_available_space;
   temporary_quota_initialized_ = true;
   DidDatabaseWork(success);
 
+  if (!is_incognito_) {
+    for (size_t i = 0; i < arraysize(kUsageSnapshotTypes); ++i) {
+      StorageType type = kUsageSnapshotTypes[i];
+      GetUsageTracker(type)->SetUsageSnapshot((*usage_snapshots)[type]);
+    }
+    UMA_HISTOGRAM_BOOLEAN("Quota.UsageSnapshotLoaded",
+                          *usage_snapshot_time != 0);
+    if (*usage_snapshot_time) {
+      usage_snapshot_time_ =
+          base::Time::FromInternalValue(*usage_snapshot_time);
+    } else {
+      // The clients are asked for their usage in this session, and the
+      // snapshots get written once they know about it.
+      usage_snapshot_time_ = base::Time::Now();
+      MarkUsageSnapshotsDirty();
+    }
+  }
+
   histogram_timer_.Start(FROM_HERE,
                          base::TimeDelta::FromMilliseconds(
                              kReportHistogramInterval),
@@ -1544,6 +1631,41 @@ void QuotaManager::DidGetLRUOrigin(const GURL* origin,
   lru_origin_callback_.Reset();
 }
 
+void QuotaManager::MarkUsageSnapshotsDirty() {
+  if (is_incognito_ || usage_snapshots_dirty_)
+    return;
+  usage_snapshots_dirty_ = true;
+  PostTaskAndReplyWithResultForDBThread(
+      FROM_HERE,
+      base::Bind(&InvalidateUsageSnapshotsOnDBThread),
+      base::Bind(&QuotaManager::DidDatabaseWork,
+                 weak_factory_.GetWeakPtr()));
+  usage_snapshot_timer_.Start(
+      FROM_HERE, base::TimeDelta::FromMilliseconds(kUsageSnapshotInterval),
+      this, &QuotaManager::WriteUsageSnapshots);
+}
+
+void QuotaManager::WriteUsageSnapshots() {
+  DCHECK(usage_snapshots_dirty_);
+  usage_snapshots_dirty_ = false;
+  usage_snapshot_timer_.Stop();
+  if (db_disabled_)
+    return;
+
+  UsageSnapshotMap* usage_snapshots = new UsageSnapshotMap;
+  for (size_t i = 0; i < arraysize(kUsageSnapshotTypes); ++i) {
+    StorageType type = kUsageSnapshotTypes[i];
+    GetUsageTracker(type)->GetUsageSnapshot(&(*usage_snapshots)[type]);
+  }
+  PostTaskAndReplyWithResultForDBThread(
+      FROM_HERE,
+      base::Bind(&WriteUsageSnapshotsOnDBThread,
+                 base::Owned(usage_snapshots),
+                 usage_snapshot_time_),
+      base::Bind(&QuotaManager::DidDatabaseWork,
+                 weak_factory_.GetWeakPtr()));
+}
+
 void QuotaManager::DidGetInitialTemporaryGlobalQuota(
     QuotaStatusCode status, int64 quota_unused) {
   if (eviction_disabled_)
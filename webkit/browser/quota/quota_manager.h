@@ -293,6 +293,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
   typedef QuotaEvictionHandler::UsageAndQuotaCallback
       UsageAndQuotaDispatcherCallback;
 
+  typedef std::map<StorageType, UsageSnapshot> UsageSnapshotMap;
+
   // This initialization method is lazily called on the IO thread
   // when the first quota manager API is called.
   // Initialize must be called after all quota clients are added to the
@@ -332,6 +334,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   void DidOriginDataEvicted(QuotaStatusCode status);
 
+  // Methods for the usage snapshots, which let the usage trackers start
+  // from the usage of the last session instead of asking every client.
+  void MarkUsageSnapshotsDirty();
+  void WriteUsageSnapshots();
+
   void ReportHistogram();
   void DidGetTemporaryGlobalUsageForHistogram(int64 usage,
                                               int64 unlimited_usage);
@@ -361,6 +368,8 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
                                  bool success);
   void DidInitialize(int64* temporary_quota_override,
                      int64* desired_available_space,
+                     int64* usage_snapshot_time,
+                     UsageSnapshotMap* usage_snapshots,
                      bool success);
   void DidGetLRUOrigin(const GURL* origin,
                        bool success);
@@ -420,6 +429,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT QuotaManager
 
   base::RepeatingTimer<QuotaManager> histogram_timer_;
 
+  // True if the usage changed since the snapshots were last written, in
+  // which case the ones on disk are marked as stale.
+  bool usage_snapshots_dirty_;
+  // When the usage in the snapshots was last gathered from the clients.
+  base::Time usage_snapshot_time_;
+  base::OneShotTimer<QuotaManager> usage_snapshot_timer_;
+
   // Pointer to the function used to get the available disk space. This is
   // overwritten by QuotaManagerTest in order to attain a deterministic reported
   // value. The default value points to base::SysInfo::AmountOfFreeDiskSpace.
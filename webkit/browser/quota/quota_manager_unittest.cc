@@ -1658,6 +1658,58 @@ TEST_F(QuotaManagerTest, DeleteOriginDataMultiple) {
   EXPECT_EQ(predelete_bar_pers, usage());
 }
 
+TEST_F(QuotaManagerTest, UsageSnapshotAcrossRestarts) {
+  static const MockOriginData kData[] = {
+    { "http://foo.com/",  kTemp, 10 },
+    { "http://bar.com/",  kTemp, 20 },
+  };
+  MockStorageClient* client = CreateClient(kData, ARRAYSIZE_UNSAFE(kData),
+      QuotaClient::kFileSystem);
+  RegisterClient(client);
+
+  GetGlobalUsage(kTemp);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(30, usage());
+
+  client->ModifyOriginAndNotify(GURL("http://foo.com/"), kTemp, 5);
+  base::RunLoop().RunUntilIdle();
+
+  // Destroying the manager writes the snapshots.
+  quota_manager_ = NULL;
+  base::RunLoop().RunUntilIdle();
+  ResetQuotaManager(false /* is_incognito */);
+
+  // The new client reports different usage, which isn't asked for since the
+  // snapshot is used instead.
+  static const MockOriginData kNewData[] = {
+    { "http://foo.com/",  kTemp, 1000 },
+  };
+  client = CreateClient(kNewData, ARRAYSIZE_UNSAFE(kNewData),
+      QuotaClient::kFileSystem);
+  RegisterClient(client);
+
+  GetGlobalUsage(kTemp);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(35, usage());
+
+  GetHostUsage("foo.com", kTemp);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(15, usage());
+
+  // Changes made since the snapshot was loaded are written on shutdown.
+  client->ModifyOriginAndNotify(GURL("http://foo.com/"), kTemp, 1);
+  base::RunLoop().RunUntilIdle();
+  quota_manager_ = NULL;
+  base::RunLoop().RunUntilIdle();
+  ResetQuotaManager(false /* is_incognito */);
+  RegisterClient(CreateClient(kNewData, ARRAYSIZE_UNSAFE(kNewData),
+      QuotaClient::kFileSystem));
+
+  GetGlobalUsage(kTemp);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(36, usage());
+}
+
 TEST_F(QuotaManagerTest, GetCachedOrigins) {
   static const MockOriginData kData[] = {
     { "http://a.com/",   kTemp,       1 },
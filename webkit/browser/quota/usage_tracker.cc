@@ -74,6 +74,7 @@ UsageTracker::UsageTracker(const QuotaClientList& clients,
                            StorageType type,
                            SpecialStoragePolicy* special_storage_policy)
     : type_(type),
+      waiting_for_snapshot_(false),
       weak_factory_(this) {
   for (QuotaClientList::const_iterator iter = clients.begin();
       iter != clients.end();
@@ -97,6 +98,13 @@ ClientUsageTracker* UsageTracker::GetClientTracker(QuotaClient::ID client_id) {
 }
 
 void UsageTracker::GetGlobalLimitedUsage(const UsageCallback& callback) {
+  if (waiting_for_snapshot_) {
+    calls_waiting_for_snapshot_.push_back(base::Bind(
+        &UsageTracker::GetGlobalLimitedUsage, weak_factory_.GetWeakPtr(),
+        callback));
+    return;
+  }
+
   if (global_usage_callbacks_.HasCallbacks()) {
     global_usage_callbacks_.Add(base::Bind(
         &DidGetGlobalUsageForLimitedGlobalUsage, callback));
@@ -129,6 +137,12 @@ void UsageTracker::GetGlobalLimitedUsage(const UsageCallback& callback) {
 }
 
 void UsageTracker::GetGlobalUsage(const GlobalUsageCallback& callback) {
+  if (waiting_for_snapshot_) {
+    calls_waiting_for_snapshot_.push_back(base::Bind(
+        &UsageTracker::GetGlobalUsage, weak_factory_.GetWeakPtr(), callback));
+    return;
+  }
+
   if (!global_usage_callbacks_.Add(callback))
     return;
 
@@ -156,6 +170,13 @@ void UsageTracker::GetGlobalUsage(const GlobalUsageCallback& callback) {
 
 void UsageTracker::GetHostUsage(const std::string& host,
                                 const UsageCallback& callback) {
+  if (waiting_for_snapshot_) {
+    calls_waiting_for_snapshot_.push_back(base::Bind(
+        &UsageTracker::GetHostUsage, weak_factory_.GetWeakPtr(), host,
+        callback));
+    return;
+  }
+
   if (!host_usage_callbacks_.Add(host, callback))
     return;
 
@@ -183,6 +204,14 @@ void UsageTracker::GetHostUsage(const std::string& host,
 
 void UsageTracker::UpdateUsageCache(
     QuotaClient::ID client_id, const GURL& origin, int64 delta) {
+  if (waiting_for_snapshot_) {
+    // The snapshot doesn't include this change yet.
+    calls_waiting_for_snapshot_.push_back(base::Bind(
+        &UsageTracker::UpdateUsageCache, weak_factory_.GetWeakPtr(),
+        client_id, origin, delta));
+    return;
+  }
+
   ClientUsageTracker* client_tracker = GetClientTracker(client_id);
   DCHECK(client_tracker);
   client_tracker->UpdateUsageCache(origin, delta);
@@ -210,12 +239,54 @@ void UsageTracker::GetCachedOrigins(std::set<GURL>* origins) const {
 void UsageTracker::SetUsageCacheEnabled(QuotaClient::ID client_id,
                                         const GURL& origin,
                                         bool enabled) {
+  if (waiting_for_snapshot_) {
+    calls_waiting_for_snapshot_.push_back(base::Bind(
+        &UsageTracker::SetUsageCacheEnabled, weak_factory_.GetWeakPtr(),
+        client_id, origin, enabled));
+    return;
+  }
+
   ClientUsageTracker* client_tracker = GetClientTracker(client_id);
   DCHECK(client_tracker);
 
   client_tracker->SetUsageCacheEnabled(origin, enabled);
 }
 
+void UsageTracker::WaitForUsageSnapshot() {
+  waiting_for_snapshot_ = true;
+}
+
+void UsageTracker::SetUsageSnapshot(const UsageSnapshot& snapshot) {
+  for (UsageSnapshot::const_iterator iter = snapshot.begin();
+       iter != snapshot.end(); ++iter) {
+    ClientUsageTracker* client_tracker =
+        GetClientTracker(static_cast<QuotaClient::ID>(iter->first));
+    // The client may no longer be registered.
+    if (client_tracker)
+      client_tracker->SetUsageSnapshot(iter->second);
+  }
+
+  waiting_for_snapshot_ = false;
+  std::vector<base::Closure> calls;
+  calls.swap(calls_waiting_for_snapshot_);
+  for (std::vector<base::Closure>::const_iterator iter = calls.begin();
+       iter != calls.end(); ++iter)
+    iter->Run();
+}
+
+void UsageTracker::GetUsageSnapshot(UsageSnapshot* snapshot) const {
+  DCHECK(snapshot);
+  snapshot->clear();
+  if (waiting_for_snapshot_)
+    return;
+  for (ClientTrackerMap::const_iterator iter = client_tracker_map_.begin();
+       iter != client_tracker_map_.end(); ++iter) {
+    std::map<GURL, int64> usage;
+    if (iter->second->GetUsageSnapshot(&usage))
+      (*snapshot)[iter->first].swap(usage);
+  }
+}
+
 void UsageTracker::AccumulateClientGlobalLimitedUsage(AccumulateInfo* info,
                                                       int64 limited_usage) {
   info->usage += limited_usage;
@@ -431,6 +502,34 @@ void ClientUsageTracker::SetUsageCacheEnabled(const GURL& origin,
   }
 }
 
+void ClientUsageTracker::SetUsageSnapshot(
+    const std::map<GURL, int64>& usage) {
+  for (std::map<GURL, int64>::const_iterator iter = usage.begin();
+       iter != usage.end(); ++iter) {
+    if (!IsUsageCacheEnabledForOrigin(iter->first))
+      continue;
+    AddCachedOrigin(iter->first, iter->second);
+    AddCachedHost(net::GetHostOrSpecFromURL(iter->first));
+  }
+  global_usage_retrieved_ = true;
+}
+
+bool ClientUsageTracker::GetUsageSnapshot(
+    std::map<GURL, int64>* usage) const {
+  DCHECK(usage);
+  // Hosts being gathered may already have some of their origins cached, but
+  // not all of them.
+  if (!global_usage_retrieved_ || host_usage_accumulators_.HasAnyCallbacks())
+    return false;
+
+  usage->clear();
+  for (HostUsageMap::const_iterator host_iter = cached_usage_by_host_.begin();
+       host_iter != cached_usage_by_host_.end(); ++host_iter) {
+    usage->insert(host_iter->second.begin(), host_iter->second.end());
+  }
+  return true;
+}
+
 void ClientUsageTracker::AccumulateLimitedOriginUsage(
     AccumulateInfo* info,
     const UsageCallback& callback,
@@ -9,6 +9,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/callback.h"
@@ -55,6 +56,19 @@ class WEBKIT_STORAGE_BROWSER_EXPORT UsageTracker : public QuotaTaskObserver {
                             const GURL& origin,
                             bool enabled);
 
+  // Makes the usage queries and updates wait until SetUsageSnapshot is
+  // called, so that they can use the usage persisted by the last session
+  // instead of asking the clients.
+  void WaitForUsageSnapshot();
+
+  // Seeds the cache of each client in |snapshot| with the usage of all its
+  // origins, then runs the calls that waited for the snapshot.
+  void SetUsageSnapshot(const UsageSnapshot& snapshot);
+
+  // Fills |snapshot| with the cached usage of the clients whose cache knows
+  // about all their origins.
+  void GetUsageSnapshot(UsageSnapshot* snapshot) const;
+
  private:
   struct AccumulateInfo {
     AccumulateInfo() : pending_clients(0), usage(0), unlimited_usage(0) {}
@@ -82,6 +96,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT UsageTracker : public QuotaTaskObserver {
   GlobalUsageCallbackQueue global_usage_callbacks_;
   HostUsageCallbackMap host_usage_callbacks_;
 
+  bool waiting_for_snapshot_;
+  std::vector<base::Closure> calls_waiting_for_snapshot_;
+
   base::WeakPtrFactory<UsageTracker> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(UsageTracker);
 };
@@ -115,6 +132,12 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   bool IsUsageCacheEnabledForOrigin(const GURL& origin) const;
   void SetUsageCacheEnabled(const GURL& origin, bool enabled);
 
+  // Caches |usage| as the usage of all the origins of the client.
+  void SetUsageSnapshot(const std::map<GURL, int64>& usage);
+
+  // Returns false if the cache doesn't know about all the origins.
+  bool GetUsageSnapshot(std::map<GURL, int64>* usage) const;
+
  private:
   typedef CallbackQueueMap<HostUsageAccumulator, std::string,
                            Tuple2<int64, int64> > HostUsageAccumulatorMap;
@@ -287,6 +287,44 @@ TEST_F(UsageTrackerTest, CacheDisabledClientTest) {
   EXPECT_EQ(500, host_usage);
 }
 
+TEST_F(UsageTrackerTest, UsageSnapshot) {
+  const GURL origin1("http://example.com");
+  const GURL origin2("http://example.com:8080");
+  const std::string host(net::GetHostOrSpecFromURL(origin1));
+
+  // The client isn't asked for usage it has when a snapshot is used.
+  UpdateUsageWithoutNotification(origin1, 1000);
+
+  // The calls wait for the snapshot, and run in order once it is set.
+  usage_tracker()->WaitForUsageSnapshot();
+  UpdateUsage(origin1, 10);
+  bool done = false;
+  int64 usage = 0;
+  int64 unlimited_usage = 0;
+  usage_tracker()->GetGlobalUsage(base::Bind(
+      &DidGetGlobalUsage, &done, &usage, &unlimited_usage));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(done);
+
+  UsageSnapshot snapshot;
+  snapshot[QuotaClient::kFileSystem][origin1] = 100;
+  snapshot[QuotaClient::kFileSystem][origin2] = 200;
+  usage_tracker()->SetUsageSnapshot(snapshot);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(310, usage);
+  EXPECT_EQ(0, unlimited_usage);
+
+  int64 host_usage = 0;
+  GetHostUsage(host, &host_usage);
+  EXPECT_EQ(310, host_usage);
+
+  UsageSnapshot new_snapshot;
+  usage_tracker()->GetUsageSnapshot(&new_snapshot);
+  snapshot[QuotaClient::kFileSystem][origin1] = 110;
+  EXPECT_EQ(snapshot, new_snapshot);
+}
+
 TEST_F(UsageTrackerTest, LimitedGlobalUsageTest) {
   const GURL kNormal("http://normal");
   const GURL kUnlimited("http://unlimited");
@@ -50,6 +50,11 @@ void BlobData::AppendFileSystemFile(
                                         expected_modification_time);
 }
 
+void BlobData::RemoveItemsFrom(size_t index) {
+  DCHECK_LE(index, items_.size());
+  items_.erase(items_.begin() + index, items_.end());
+}
+
 int64 BlobData::GetMemoryUsage() const {
   int64 memory = 0;
   for (std::vector<Item>::const_iterator iter = items_.begin();
@@ -40,6 +40,9 @@ class WEBKIT_STORAGE_COMMON_EXPORT BlobData
   void AppendFileSystemFile(const GURL& url, uint64 offset, uint64 length,
                             const base::Time& expected_modification_time);
 
+  // Removes the items from |index| on.
+  void RemoveItemsFrom(size_t index);
+
   void AttachShareableFileReference(ShareableFileReference* reference) {
     shareable_files_.push_back(reference);
   }